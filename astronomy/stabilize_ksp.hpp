@@ -1,13 +1,27 @@
 #pragma once
 
+#include <map>
+#include <string>
+
+#include "physics/kepler_orbit.hpp"
 #include "physics/solar_system.hpp"
 
 namespace principia {
 namespace astronomy {
 namespace stabilize_ksp_internal {
 
+using physics::KeplerianElements;
 using physics::SolarSystem;
 
+// The elements of the bodies that must be changed in the given
+// |solar_system|, which is expected to be the stock KSP, to make the Jool
+// system stable, indexed by name.  The result is a function of the stock
+// elements only, so it may be computed once and applied to other instances of
+// the stock system with |ReplaceElements|.
+template<typename Frame>
+std::map<std::string, KeplerianElements<Frame>> StabilizedKSPElements(
+    SolarSystem<Frame> const& solar_system);
+
 // Patches the given |solar_system|, which is expected to be the stock KSP, to
 // make the Jool system stable.
 template<typename Frame>
@@ -15,6 +29,7 @@ void StabilizeKSP(SolarSystem<Frame>& solar_system);
 
 }  // namespace stabilize_ksp_internal
 
+using stabilize_ksp_internal::StabilizedKSPElements;
 using stabilize_ksp_internal::StabilizeKSP;
 
 }  // namespace astronomy
@@ -2,7 +2,6 @@
 
 #include "astronomy/stabilize_ksp.hpp"
 
-#include "physics/kepler_orbit.hpp"
 #include "quantities/numbers.hpp"
 #include "quantities/si.hpp"
 
@@ -11,11 +10,11 @@ namespace astronomy {
 namespace stabilize_ksp_internal {
 
 using geometry::Position;
-using physics::KeplerianElements;
 using quantities::si::Degree;
 
 template<typename Frame>
-void StabilizeKSP(SolarSystem<Frame>& solar_system) {
+std::map<std::string, KeplerianElements<Frame>> StabilizedKSPElements(
+    SolarSystem<Frame> const& solar_system) {
   KeplerianElements<Frame> laythe_elements =
       solar_system.MakeKeplerianElements(
           solar_system.keplerian_initial_state_message("Laythe").elements());
@@ -42,9 +41,16 @@ void StabilizeKSP(SolarSystem<Frame>& solar_system) {
   bop_elements.inclination = 180 * Degree - bop_elements.inclination;
   *bop_elements.mean_motion = *pol_elements.mean_motion / 0.7;
 
-  solar_system.ReplaceElements("Vall", vall_elements);
-  solar_system.ReplaceElements("Tylo", tylo_elements);
-  solar_system.ReplaceElements("Bop", bop_elements);
+  return {{"Vall", vall_elements},
+          {"Tylo", tylo_elements},
+          {"Bop", bop_elements}};
+}
+
+template<typename Frame>
+void StabilizeKSP(SolarSystem<Frame>& solar_system) {
+  for (auto const& [name, elements] : StabilizedKSPElements(solar_system)) {
+    solar_system.ReplaceElements(name, elements);
+  }
 }
 
 }  // namespace stabilize_ksp_internal
@@ -3,7 +3,9 @@
 
 #include "astronomy/time_scales.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -287,15 +289,17 @@ constexpr ExperimentalEOPC02Entry const* LookupUT1(
                             : LookupUT1(ut1, begin, size / 2));
 }
 
-constexpr EOPC04Entry const* LookupUT1(quantities::Time const& ut1,
-                                       EOPC04Entry const* begin,
-                                       std::ptrdiff_t const size) {
-  return CHECKING(size > 0,
-                  size == 1
-                      ? CHECKING(begin->ut1() <= ut1, begin)
-                      : (begin + size / 2)->ut1() <= ut1
-                            ? LookupUT1(ut1, begin + size / 2, size - size / 2)
-                            : LookupUT1(ut1, begin, size / 2));
+// Returns the index of the last entry of |eop_c04| whose UT1 is less than or
+// equal to the given |ut1|, starting the search at index |i|, which must be
+// close to the result.
+constexpr std::ptrdiff_t EOPC04IndexNear(quantities::Time const& ut1,
+                                         std::ptrdiff_t const i) {
+  return eop_c04[i].ut1() > ut1
+             ? CHECKING(i > 0, EOPC04IndexNear(ut1, i - 1))
+             : i + 1 < static_cast<std::ptrdiff_t>(eop_c04.size()) &&
+                       eop_c04[i + 1].ut1() <= ut1
+                   ? EOPC04IndexNear(ut1, i + 1)
+                   : i;
 }
 
 constexpr ExperimentalEOPC02Entry const* LookupInExperimentalEOPC02(
@@ -303,9 +307,20 @@ constexpr ExperimentalEOPC02Entry const* LookupInExperimentalEOPC02(
   return LookupUT1(ut1, &experimental_eop_c02[0], experimental_eop_c02.size());
 }
 
+// The entries of |eop_c04| are daily, and their UT1s are within a second of
+// their UTC midnights, which are 86400 s apart on our |TimeScale|.  Therefore
+// the entry for |ut1| is found by indexing, and at most one step of
+// correction, instead of a binary search, each step of which is costly in
+// constexpr evaluation.
 constexpr EOPC04Entry const* LookupInEOPC04(
     quantities::Time const& ut1) {
-  return LookupUT1(ut1, &eop_c04[0], eop_c04.size());
+  return CHECKING(
+      eop_c04.front().ut1() <= ut1,
+      &eop_c04[EOPC04IndexNear(
+          ut1,
+          std::min(static_cast<std::ptrdiff_t>(eop_c04.size()) - 1,
+                   static_cast<std::ptrdiff_t>(
+                       (ut1 - eop_c04.front().ut1()) / Day)))]);
 }
 
 // Linear interpolation on the UT1 range [low->ut1(), (low + 1)->ut1()].
@@ -315,6 +315,18 @@ TEST_F(TimeScalesTest, UT1Continuity) {
               Lt(0.5 * Milli(Second)));
 }
 
+TEST_F(TimeScalesTest, EOPC04Lookup) {
+  for (int i = 0; i < eop_c04.size(); ++i) {
+    EXPECT_EQ(&eop_c04[i], LookupInEOPC04(eop_c04[i].ut1())) << i;
+    EXPECT_EQ(&eop_c04[i],
+              LookupInEOPC04(eop_c04[i].ut1() + 0.5 * Day)) << i;
+    if (i > 0) {
+      EXPECT_EQ(&eop_c04[i - 1],
+                LookupInEOPC04(eop_c04[i].ut1() - 1 * Milli(Second))) << i;
+    }
+  }
+}
+
 // Check the times of the lunar eclipses in LunarEclipseTest.
 TEST_F(TimeScalesTest, LunarEclipses) {
   EXPECT_THAT(AbsoluteError("1950-04-02T20:44:34.0"_TT,
@@ -260,7 +260,7 @@ Population::Population(Genome const& luca,
 void Population::ComputeAllFitnesses() {
   // The fitness computation is expensive, do it in parallel on all genomes.
   {
-    Bundle bundle(8);
+    Bundle bundle(8, Bundle::Scheduling::WorkStealing);
 
     fitnesses_.resize(current_.size(), 0.0);
     traces_.resize(current_.size(), "");
@@ -531,7 +531,7 @@ std::vector<double> EvaluatePopulation(
     std::vector<std::string>& info) {
   std::vector<double> log_pdf(population.size());
   info.resize(population.size());
-  Bundle bundle(8);
+  Bundle bundle(8, Bundle::Scheduling::WorkStealing);
   for (int i = 0; i < population.size(); ++i) {
     auto const& parameters = population[i];
     bundle.Add([&compute_log_pdf, i, &log_pdf, &parameters, &info]() {
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "base/macros.hpp"
+#include "base/not_null.hpp"
+#include "google/protobuf/arena.h"
+
+namespace principia {
+namespace base {
+namespace internal_arena_pool {
+
+// A thread-safe pool of protocol buffer arenas, so that operations which build
+// large messages, e.g., the serialization and deserialization of the plugin,
+// may run concurrently while reusing the blocks of the arenas.  An arena is
+// leased for an operation with |Lease| and given back with |Return|, possibly
+// from a different thread, using the same |operation| key.  At most
+// |max_arenas| free arenas are retained.  The initial block size of the
+// arenas created by the pool is the largest space ever used by an operation,
+// clamped to [min_block_size, max_block_size], so that later operations of
+// the same kind fit in a single block.  That block is owned by the pool and
+// survives |Return|, so a reused arena doesn't go back to the heap.
+class ArenaPool final {
+ public:
+  ArenaPool(int max_arenas,
+            std::int64_t min_block_size,
+            std::int64_t max_block_size);
+  ~ArenaPool();
+
+  // Returns an arena for the operation identified by |operation|, which must
+  // not have one already.  The arena is empty.
+  not_null<google::protobuf::Arena*> Lease(void const* operation);
+
+  // Gives back the arena leased for |operation|, destroying the messages that
+  // it holds.
+  void Return(void const* operation);
+
+  // The number of free arenas currently held by the pool.
+  int free_arenas() const;
+
+  // The initial block size of the arenas that the pool creates.
+  std::int64_t initial_block_size() const;
+
+ private:
+  // An arena together with its first block.  The arena is destroyed before the
+  // block.
+  struct Entry {
+    std::unique_ptr<char[]> block;
+    std::int64_t block_size;
+    std::unique_ptr<google::protobuf::Arena> arena;
+  };
+
+  Entry NewEntryLocked() const REQUIRES(lock_);
+  std::int64_t InitialBlockSizeLocked() const REQUIRES(lock_);
+
+  int const max_arenas_;
+  std::int64_t const min_block_size_;
+  std::int64_t const max_block_size_;
+
+  mutable std::mutex lock_;
+  std::vector<Entry> free_ GUARDED_BY(lock_);
+  std::map<void const*, Entry> leased_ GUARDED_BY(lock_);
+  // The largest space used by an operation so far.
+  std::int64_t max_space_used_ GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace internal_arena_pool
+
+using internal_arena_pool::ArenaPool;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/arena_pool_body.hpp"
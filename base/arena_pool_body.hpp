@@ -0,0 +1,91 @@
+#pragma once
+
+#include "base/arena_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_arena_pool {
+
+inline ArenaPool::ArenaPool(int const max_arenas,
+                            std::int64_t const min_block_size,
+                            std::int64_t const max_block_size)
+    : max_arenas_(max_arenas),
+      min_block_size_(min_block_size),
+      max_block_size_(max_block_size) {
+  CHECK_LE(0, max_arenas_);
+  CHECK_LT(0, min_block_size_);
+  CHECK_LE(min_block_size_, max_block_size_);
+}
+
+inline ArenaPool::~ArenaPool() {
+  std::lock_guard<std::mutex> l(lock_);
+  CHECK(leased_.empty()) << leased_.size() << " arenas were not returned";
+}
+
+inline not_null<google::protobuf::Arena*> ArenaPool::Lease(
+    void const* const operation) {
+  std::lock_guard<std::mutex> l(lock_);
+  Entry entry;
+  if (free_.empty()) {
+    entry = NewEntryLocked();
+  } else {
+    entry = std::move(free_.back());
+    free_.pop_back();
+  }
+  not_null<google::protobuf::Arena*> const result = entry.arena.get();
+  bool const inserted = leased_.emplace(operation, std::move(entry)).second;
+  CHECK(inserted) << "Operation " << operation << " already has an arena";
+  return result;
+}
+
+inline void ArenaPool::Return(void const* const operation) {
+  std::lock_guard<std::mutex> l(lock_);
+  auto const it = leased_.find(operation);
+  CHECK(it != leased_.end()) << "Operation " << operation << " has no arena";
+  Entry entry = std::move(it->second);
+  leased_.erase(it);
+  max_space_used_ =
+      std::max<std::int64_t>(max_space_used_, entry.arena->SpaceUsed());
+  entry.arena->Reset();
+  // An arena whose first block is smaller than what the operations need is
+  // dropped, so that its replacement gets a larger block.
+  if (free_.size() < static_cast<std::size_t>(max_arenas_) &&
+      entry.block_size >= InitialBlockSizeLocked()) {
+    free_.push_back(std::move(entry));
+  }
+}
+
+inline int ArenaPool::free_arenas() const {
+  std::lock_guard<std::mutex> l(lock_);
+  return free_.size();
+}
+
+inline std::int64_t ArenaPool::initial_block_size() const {
+  std::lock_guard<std::mutex> l(lock_);
+  return InitialBlockSizeLocked();
+}
+
+inline ArenaPool::Entry ArenaPool::NewEntryLocked() const {
+  Entry entry;
+  entry.block_size = InitialBlockSizeLocked();
+  entry.block = std::make_unique<char[]>(entry.block_size);
+  google::protobuf::ArenaOptions options;
+  options.initial_block = entry.block.get();
+  options.initial_block_size = entry.block_size;
+  options.max_block_size = max_block_size_;
+  entry.arena = std::make_unique<google::protobuf::Arena>(options);
+  return entry;
+}
+
+inline std::int64_t ArenaPool::InitialBlockSizeLocked() const {
+  return std::clamp(max_space_used_, min_block_size_, max_block_size_);
+}
+
+}  // namespace internal_arena_pool
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,75 @@
+#include "base/arena_pool.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace principia {
+
+using ::google::protobuf::Arena;
+
+namespace base {
+
+TEST(ArenaPoolTest, Reuse) {
+  ArenaPool pool(/*max_arenas=*/2,
+                 /*min_block_size=*/1 << 10,
+                 /*max_block_size=*/1 << 20);
+  EXPECT_EQ(0, pool.free_arenas());
+  EXPECT_EQ(1 << 10, pool.initial_block_size());
+
+  int const operation1 = 0;
+  int const operation2 = 0;
+  int const operation3 = 0;
+
+  not_null<Arena*> const arena1 = pool.Lease(&operation1);
+  Arena::CreateArray<char>(arena1, 100);
+  pool.Return(&operation1);
+  EXPECT_EQ(1, pool.free_arenas());
+
+  // The arena that was returned is reused.
+  not_null<Arena*> const arena2 = pool.Lease(&operation2);
+  EXPECT_EQ(arena1, arena2);
+  EXPECT_EQ(0, pool.free_arenas());
+
+  // An operation that needs more than the first block raises the initial
+  // block size, and the arena that is too small is dropped.
+  Arena::CreateArray<char>(arena2, 10'000);
+  pool.Return(&operation2);
+  EXPECT_LE(10'000, pool.initial_block_size());
+  EXPECT_EQ(0, pool.free_arenas());
+
+  // The pool retains at most two arenas.
+  pool.Lease(&operation1);
+  pool.Lease(&operation2);
+  pool.Lease(&operation3);
+  pool.Return(&operation1);
+  pool.Return(&operation2);
+  pool.Return(&operation3);
+  EXPECT_EQ(2, pool.free_arenas());
+}
+
+TEST(ArenaPoolTest, Concurrency) {
+  ArenaPool pool(/*max_arenas=*/4,
+                 /*min_block_size=*/1 << 10,
+                 /*max_block_size=*/1 << 20);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&pool]() {
+      for (int j = 0; j < 100; ++j) {
+        int const operation = j;
+        not_null<Arena*> const arena = pool.Lease(&operation);
+        Arena::Create<std::string>(arena, 1000, 'x');
+        pool.Return(&operation);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_LE(pool.free_arenas(), 4);
+}
+
+}  // namespace base
+}  // namespace principia
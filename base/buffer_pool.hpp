@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "base/array.hpp"
+#include "base/macros.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_buffer_pool {
+
+// A thread-safe pool of byte buffers, used to avoid allocating and freeing a
+// buffer for each of the many chunks of a serialization or deserialization.
+// Buffers are leased with |Lease| and given back with |Return|, possibly from
+// a different thread.  At most |max_buffers| free buffers are retained, so the
+// memory held by the pool is bounded by |max_buffers| times the size of the
+// largest buffer ever leased.
+class BufferPool final {
+ public:
+  explicit BufferPool(int max_buffers);
+
+  // Returns a buffer of at least |size| bytes, which is a free buffer of the
+  // pool if there is one that is large enough.  The contents of the buffer
+  // are unspecified.
+  UniqueArray<std::uint8_t> Lease(std::int64_t size);
+
+  // Gives |buffer| to the pool.  The pool takes ownership of it, and frees it
+  // if it already holds |max_buffers| free buffers.
+  void Return(UniqueArray<std::uint8_t> buffer);
+
+  // The number of free buffers currently held by the pool.
+  int free_buffers() const;
+
+ private:
+  int const max_buffers_;
+  mutable std::mutex lock_;
+  std::vector<UniqueArray<std::uint8_t>> free_ GUARDED_BY(lock_);
+};
+
+}  // namespace internal_buffer_pool
+
+using internal_buffer_pool::BufferPool;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/buffer_pool_body.hpp"
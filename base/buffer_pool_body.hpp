@@ -0,0 +1,50 @@
+#pragma once
+
+#include "base/buffer_pool.hpp"
+
+#include <iterator>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_buffer_pool {
+
+inline BufferPool::BufferPool(int const max_buffers)
+    : max_buffers_(max_buffers) {
+  CHECK_LE(0, max_buffers_);
+}
+
+inline UniqueArray<std::uint8_t> BufferPool::Lease(std::int64_t const size) {
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    // The pool is small, so a linear search is fine.  Take the most recently
+    // returned buffer that is large enough, it is the most likely to be in the
+    // cache.
+    for (auto it = free_.rbegin(); it != free_.rend(); ++it) {
+      if (it->size >= size) {
+        UniqueArray<std::uint8_t> buffer = std::move(*it);
+        free_.erase(std::next(it).base());
+        return buffer;
+      }
+    }
+  }
+  return UniqueArray<std::uint8_t>(size);
+}
+
+inline void BufferPool::Return(UniqueArray<std::uint8_t> buffer) {
+  std::lock_guard<std::mutex> l(lock_);
+  if (free_.size() < static_cast<std::size_t>(max_buffers_)) {
+    free_.push_back(std::move(buffer));
+  }
+}
+
+inline int BufferPool::free_buffers() const {
+  std::lock_guard<std::mutex> l(lock_);
+  return free_.size();
+}
+
+}  // namespace internal_buffer_pool
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,42 @@
+#include "base/buffer_pool.hpp"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+TEST(BufferPoolTest, Reuse) {
+  BufferPool pool(/*max_buffers=*/2);
+  EXPECT_EQ(0, pool.free_buffers());
+
+  auto buffer1 = pool.Lease(10);
+  EXPECT_EQ(10, buffer1.size);
+  std::uint8_t* const data1 = buffer1.data.get();
+  pool.Return(std::move(buffer1));
+  EXPECT_EQ(1, pool.free_buffers());
+
+  // A smaller buffer reuses the one that was returned.
+  auto buffer2 = pool.Lease(5);
+  EXPECT_EQ(data1, buffer2.data.get());
+  EXPECT_EQ(10, buffer2.size);
+  EXPECT_EQ(0, pool.free_buffers());
+
+  // A larger buffer is freshly allocated.
+  pool.Return(std::move(buffer2));
+  auto buffer3 = pool.Lease(20);
+  EXPECT_EQ(20, buffer3.size);
+  EXPECT_EQ(1, pool.free_buffers());
+
+  // The pool retains at most two buffers.
+  auto buffer4 = pool.Lease(7);
+  auto buffer5 = pool.Lease(7);
+  pool.Return(std::move(buffer3));
+  pool.Return(std::move(buffer4));
+  pool.Return(std::move(buffer5));
+  EXPECT_EQ(2, pool.free_buffers());
+}
+
+}  // namespace base
+}  // namespace principia
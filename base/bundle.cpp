@@ -1,8 +1,10 @@
 ﻿
 #include "base/bundle.hpp"
 
+#include <algorithm>
 #include <functional>
 #include <list>
+#include <utility>
 
 #include "base/map_util.hpp"
 #include "base/status.hpp"
@@ -14,9 +16,18 @@ namespace base {
 
 thread_local std::function<bool()> AbortRequested = [] { return false; };
 
-Bundle::Bundle(int const workers)
+thread_local Bundle* Bundle::current_bundle_ = nullptr;
+thread_local int Bundle::current_worker_ = -1;
+
+Bundle::Bundle(int const workers, Scheduling const scheduling)
     : max_workers_(workers),
       master_abort_(&AbortRequested) {
+  CHECK_LT(0, max_workers_);
+  int const number_of_queues =
+      scheduling == Scheduling::SharedQueue ? 1 : max_workers_;
+  for (int i = 0; i < number_of_queues; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
   workers_.reserve(max_workers_);
 }
 
@@ -46,36 +57,58 @@ Status Bundle::JoinBefore(std::chrono::steady_clock::time_point t) {
   return Join();
 }
 
-void Bundle::Add(Task task) {
+void Bundle::Add(Task task, int const priority) {
   {
     std::unique_lock<std::mutex> lock(lock_);
     CHECK(wait_on_empty_);
     if (workers_.size() < max_workers_) {
-      workers_.emplace_back(&Bundle::Toil, this);
+      workers_.emplace_back(&Bundle::Toil, this, workers_.size());
     }
-    tasks_.emplace(task);
+    ++queued_tasks_;
+  }
+  Queue& queue =
+      current_bundle_ == this
+          ? *queues_[current_worker_ % queues_.size()]
+          : *queues_[next_queue_.fetch_add(1) % queues_.size()];
+  {
+    std::lock_guard<std::mutex> l(queue.lock);
+    queue.tasks.push_back(
+        {priority, next_sequence_number_.fetch_add(1), std::move(task)});
+    std::push_heap(queue.tasks.begin(), queue.tasks.end());
   }
   tasks_not_empty_or_terminate_.notify_one();
 }
 
-void Bundle::Toil() {
+bool Bundle::PrioritizedTask::operator<(PrioritizedTask const& right) const {
+  return priority < right.priority ||
+         (priority == right.priority &&
+          sequence_number > right.sequence_number);
+}
+
+void Bundle::Toil(int const index) {
+  current_bundle_ = this;
+  current_worker_ = index;
   Task current_task;
   AbortRequested = std::bind(&Bundle::BundleShouldAbort, this);
   for (;;) {
-    {
+    // The call to |BundleShouldAbort| checks for deadline expiry and master
+    // abort.
+    if (BundleShouldAbort()) {
+      return;
+    }
+    if (!TryDequeue(index, current_task)) {
       std::unique_lock<std::mutex> lock(lock_);
       tasks_not_empty_or_terminate_.wait(
           lock,
           [this] {
-            return !tasks_.empty() || !wait_on_empty_ || Aborting();
+            return queued_tasks_ > 0 || !wait_on_empty_ || Aborting();
           });
-      // The call to |BundleShouldAbort| checks for deadline expiry and master
-      // abort.
-      if (tasks_.empty() || BundleShouldAbort()) {
+      if (queued_tasks_ == 0 && !wait_on_empty_) {
         return;
       }
-      current_task = std::move(tasks_.front());
-      tasks_.pop();
+      // Either a task was added, possibly not yet enqueued, or the |Bundle| is
+      // aborting.  Try again.
+      continue;
     }
     Status const status = current_task();
     if (!status.ok()) {
@@ -84,6 +117,48 @@ void Bundle::Toil() {
   }
 }
 
+bool Bundle::TryDequeue(int const index, Task& task) {
+  auto const pop = [&task, this](Queue& queue) {
+    std::lock_guard<std::mutex> l(queue.lock);
+    if (queue.tasks.empty()) {
+      return false;
+    }
+    std::pop_heap(queue.tasks.begin(), queue.tasks.end());
+    task = std::move(queue.tasks.back().task);
+    queue.tasks.pop_back();
+    --queued_tasks_;
+    return true;
+  };
+
+  if (pop(*queues_[index % queues_.size()])) {
+    return true;
+  }
+  if (queues_.size() == 1) {
+    return false;
+  }
+
+  // Steal from the queue whose top has the highest priority.  That queue may
+  // have changed by the time we pop it, which only matters for the order of the
+  // tasks.
+  Queue* victim = nullptr;
+  std::optional<std::pair<int, std::int64_t>> victim_top;
+  for (auto const& queue : queues_) {
+    std::lock_guard<std::mutex> l(queue->lock);
+    if (queue->tasks.empty()) {
+      continue;
+    }
+    PrioritizedTask const& top = queue->tasks.front();
+    if (!victim_top.has_value() ||
+        top.priority > victim_top->first ||
+        (top.priority == victim_top->first &&
+         top.sequence_number < victim_top->second)) {
+      victim = queue.get();
+      victim_top = {top.priority, top.sequence_number};
+    }
+  }
+  return victim != nullptr && pop(*victim);
+}
+
 // On the |workers_|, |AbortRequested| is set to |BundleShouldAbort|.  That
 // function checks whether the |Bundle| is already |Aborting()|, and
 // additionally checks whether the |deadline_| of the |Bundle| has expired, if
@@ -91,7 +166,7 @@ void Bundle::Toil() {
 // called with an appropriate |Status|.
 // |*master_abort| is |AbortRequested| on the master thread, thus ensuring that
 // a master abort trickles down.  In order for this to happen even if the
-// |tasks_| do not call |AbortRequested|, |BundleShouldAbort| is also called
+// tasks do not call |AbortRequested|, |BundleShouldAbort| is also called
 // before dequeuing a new task.
 bool Bundle::BundleShouldAbort() {
   if (!Aborting()) {
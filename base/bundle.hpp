@@ -1,8 +1,10 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
-#include <queue>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -28,11 +30,26 @@ extern thread_local std::function<bool()> AbortRequested;
 // We refer to the thread on which the |Bundle| is created as its master thread.
 // The |Bundle| itself cooperatively aborts if |AbortRequested()| on its master
 // thread.
+// The tasks have priorities: a worker always starts the task of highest
+// priority that it can find, and the tasks of equal priority in the order in
+// which they were added.
 class Bundle final {
  public:
   using Task = std::function<Status()>;
 
-  explicit Bundle(int workers);
+  enum class Scheduling {
+    // All the workers take their tasks from a single queue.  This gives strict
+    // priority ordering.
+    SharedQueue,
+    // Each worker has its own queue, and steals from the queue whose first task
+    // has the highest priority when its own is empty.  The tasks added by a
+    // worker go to its own queue, the others are distributed round-robin.  This
+    // avoids contention when there are many small tasks, at the cost of
+    // priorities being only approximately respected across the workers.
+    WorkStealing,
+  };
+
+  explicit Bundle(int workers, Scheduling scheduling = Scheduling::SharedQueue);
 
   // Returns the first non-OK status encountered, or OK.  All worker threads are
   // joined; no calls to member functions may follow this call.
@@ -44,13 +61,36 @@ class Bundle final {
   Status JoinBefore(std::chrono::steady_clock::time_point t);
 
   // If a |task| returns an erroneous |Status|, the |Bundle| is aborted and
-  // |Join| returns that status.
-  void Add(Task task);
+  // |Join| returns that status.  Tasks with a higher |priority| are started
+  // first.
+  void Add(Task task, int priority = 0);
 
  private:
+  struct PrioritizedTask final {
+    // Orders the tasks for a max-heap: the top is the task of highest priority
+    // that was added first.
+    bool operator<(PrioritizedTask const& right) const;
+
+    int priority;
+    std::int64_t sequence_number;
+    Task task;
+  };
+
+  struct Queue final {
+    std::mutex lock;
+    // A max-heap.
+    std::vector<PrioritizedTask> tasks GUARDED_BY(lock);
+  };
+
   // The |workers_| |Toil|.  This function returns when
-  // |(tasks_.empty() && !wait_on_empty_) ||Aborting()|.
-  void Toil();
+  // |(queued_tasks_ == 0 && !wait_on_empty_) || Aborting()|.  |index| is that
+  // of the worker, which takes its tasks from |queues_[index]| first.
+  void Toil(int index);
+
+  // Removes from |queues_| a task of highest priority, looking first at the
+  // queue of the worker with the given |index|.  Returns false if no task was
+  // found.
+  bool TryDequeue(int index, Task& task);
 
   // The |workers_| have their |AbortRequested| set to |BundleShouldAbort|.
   bool BundleShouldAbort();
@@ -66,12 +106,18 @@ class Bundle final {
   // Thread-safe |deadline_ && std::chrono::steady_clock::now() > deadline_|.
   bool DeadlineExceeded();
 
-  // |status_lock_| should not be held when locking |lock_|.
+  // If the current thread is a worker of some |Bundle|, that |Bundle| and the
+  // index of the worker.
+  static thread_local Bundle* current_bundle_;
+  static thread_local int current_worker_;
+
+  // |status_lock_| should not be held when locking |lock_|.  The locks of the
+  // |queues_| are never held together with |lock_|.
   std::mutex lock_;
   // Notified once when a task is available for execution.  Notified to all
   // waiting workers when either |wait_on_empty_| is flopped or |status_| is set
   // to an error.
-  // Workers wait on this when no |tasks_| are available.
+  // Workers wait on this when no tasks are available.
   std::condition_variable tasks_not_empty_or_terminate_;
   std::shared_mutex status_lock_;
   // If |!status_.ok()|, currently-running tasks should cooperatively abort, and
@@ -85,7 +131,17 @@ class Bundle final {
   // |Join|.
   Monostable wait_on_empty_ GUARDED_BY(lock_);
 
-  std::queue<Task> tasks_ GUARDED_BY(lock_);
+  // One queue for |Scheduling::SharedQueue|, one per worker for
+  // |Scheduling::WorkStealing|.
+  // Filled at construction.
+  std::vector<std::unique_ptr<Queue>> queues_;
+  // The number of tasks in the |queues_|.  Incremented under |lock_| before
+  // the task is enqueued, to avoid lost wake-ups; decremented without it when a
+  // task is dequeued.
+  std::atomic<std::int64_t> queued_tasks_ = 0;
+  std::atomic<std::int64_t> next_sequence_number_ = 0;
+  std::atomic<std::uint64_t> next_queue_ = 0;
+
   std::vector<std::thread> workers_ GUARDED_BY(lock_);
 
   int const max_workers_;
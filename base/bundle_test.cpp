@@ -2,6 +2,7 @@
 #include "base/bundle.hpp"
 
 #include <atomic>
+#include <mutex>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -12,6 +13,7 @@
 
 namespace principia {
 
+using ::testing::ElementsAre;
 using ::testing::Eq;
 
 using namespace std::chrono_literals;  // NOLINT(build/namespaces)
@@ -136,6 +138,66 @@ TEST_F(BundleTest, Deadline) {
               Eq(workers * workers_per_dependent_bundle));
 }
 
+TEST_F(BundleTest, Priorities) {
+  std::atomic<bool> released = false;
+  std::mutex lock;
+  std::vector<int> order;
+  auto const record = [&lock, &order](int const priority) {
+    return [&lock, &order, priority]() {
+      std::lock_guard<std::mutex> l(lock);
+      order.push_back(priority);
+      return Status::OK;
+    };
+  };
+  for (auto const scheduling :
+       {Bundle::Scheduling::SharedQueue, Bundle::Scheduling::WorkStealing}) {
+    released = false;
+    order.clear();
+    Bundle bundle(/*workers=*/1, scheduling);
+    // Keep the worker busy while the other tasks are queued.
+    bundle.Add(
+        [&released]() {
+          while (!released) {
+            std::this_thread::sleep_for(1ms);
+          }
+          return Status::OK;
+        },
+        /*priority=*/10);
+    bundle.Add(record(0), /*priority=*/0);
+    bundle.Add(record(2), /*priority=*/2);
+    bundle.Add(record(-1), /*priority=*/-1);
+    bundle.Add(record(1), /*priority=*/1);
+    bundle.Add(record(2), /*priority=*/2);
+    released = true;
+    EXPECT_OK(bundle.Join());
+    EXPECT_THAT(order, ElementsAre(2, 2, 1, 0, -1));
+  }
+}
+
+TEST_F(BundleTest, WorkStealing) {
+  constexpr int tasks = 100'000;
+  Bundle bundle(workers, Bundle::Scheduling::WorkStealing);
+  std::atomic<std::int64_t> sum = 0;
+  // Half of the tasks are added by other tasks, and go to the queue of the
+  // worker that executes them.
+  for (int i = 0; i < tasks / 2; ++i) {
+    bundle.Add([&bundle, &sum, i]() {
+      sum += i;
+      bundle.Add([&sum, i]() {
+        sum += i;
+        return Status::OK;
+      });
+      return Status::OK;
+    });
+  }
+  // Wait until all the nested tasks have been added before joining.
+  while (sum < static_cast<std::int64_t>(tasks / 2) * (tasks / 2 - 1)) {
+    std::this_thread::sleep_for(10ms);
+  }
+  EXPECT_OK(bundle.Join());
+  EXPECT_THAT(sum, Eq(static_cast<std::int64_t>(tasks / 2) * (tasks / 2 - 1)));
+}
+
 TEST_F(BundleTest, DISABLED_NonCooperativeDeadline) {
   for (int i = 0; i < 10 * workers; ++i) {
     // Waiters with no cooperative abort.
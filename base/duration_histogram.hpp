@@ -0,0 +1,61 @@
+﻿
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace principia {
+namespace base {
+namespace internal_duration_histogram {
+
+// A histogram of durations in the manner of HdrHistogram: the width of the
+// buckets is proportional to their lower bound, so that a duration is known
+// with a relative error of at most 2^-sub_bucket_bits (about 3%) whatever its
+// magnitude, with a small, fixed number of buckets.  The durations below
+// 2^sub_bucket_bits nanoseconds are exact; those above |max_duration| are
+// clamped.  Recording is O(1) and doesn't allocate.
+class DurationHistogram final {
+ public:
+  static constexpr int sub_bucket_bits = 5;
+  static constexpr int sub_buckets = 1 << sub_bucket_bits;
+  // The number of octaves above the exact buckets; this covers about 18
+  // minutes.
+  static constexpr int octaves = 41 - sub_bucket_bits;
+  static constexpr int buckets = sub_buckets * (octaves + 1);
+  static constexpr std::chrono::nanoseconds max_duration{
+      (std::int64_t{1} << (octaves + sub_bucket_bits)) - 1};
+
+  // The bucket where |duration| is recorded.
+  static int Bucket(std::chrono::nanoseconds duration);
+  // The largest duration recorded in |bucket|.
+  static std::chrono::nanoseconds BucketUpperBound(int bucket);
+
+  void Record(std::chrono::nanoseconds duration);
+  // Adds |count| durations to |bucket|; used to merge histograms maintained
+  // elsewhere, e.g., with atomic counters.
+  void Add(int bucket, std::int64_t count);
+  void Add(DurationHistogram const& other);
+  void Reset();
+
+  std::int64_t count() const;
+
+  // The smallest bucket upper bound below which at least a fraction |quantile|
+  // of the durations lie; |Quantile(0.5)| is the median and |Quantile(1)| the
+  // maximum, up to the resolution of the buckets.  Returns zero if the
+  // histogram is empty.
+  std::chrono::nanoseconds Quantile(double quantile) const;
+
+ private:
+  std::array<std::int64_t, buckets> counts_{};
+  std::int64_t count_ = 0;
+};
+
+}  // namespace internal_duration_histogram
+
+using internal_duration_histogram::DurationHistogram;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/duration_histogram_body.hpp"
@@ -0,0 +1,86 @@
+﻿
+#pragma once
+
+#include "base/duration_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace principia {
+namespace base {
+namespace internal_duration_histogram {
+
+inline int DurationHistogram::Bucket(std::chrono::nanoseconds const duration) {
+  std::int64_t const value =
+      std::clamp(duration.count(), std::int64_t{0}, max_duration.count());
+  if (value < sub_buckets) {
+    return static_cast<int>(value);
+  }
+  // The number of bits to drop so that |value| keeps |sub_bucket_bits + 1|
+  // significant bits.
+  int shift = 0;
+  while ((value >> shift) >= 2 * sub_buckets) {
+    ++shift;
+  }
+  return sub_buckets * (shift + 1) +
+         static_cast<int>((value >> shift) - sub_buckets);
+}
+
+inline std::chrono::nanoseconds DurationHistogram::BucketUpperBound(
+    int const bucket) {
+  if (bucket < sub_buckets) {
+    return std::chrono::nanoseconds(bucket);
+  }
+  int const shift = bucket / sub_buckets - 1;
+  std::int64_t const top = sub_buckets + bucket % sub_buckets;
+  return std::chrono::nanoseconds(((top + 1) << shift) - 1);
+}
+
+inline void DurationHistogram::Record(
+    std::chrono::nanoseconds const duration) {
+  Add(Bucket(duration), 1);
+}
+
+inline void DurationHistogram::Add(int const bucket, std::int64_t const count) {
+  counts_[bucket] += count;
+  count_ += count;
+}
+
+inline void DurationHistogram::Add(DurationHistogram const& other) {
+  for (int bucket = 0; bucket < buckets; ++bucket) {
+    counts_[bucket] += other.counts_[bucket];
+  }
+  count_ += other.count_;
+}
+
+inline void DurationHistogram::Reset() {
+  counts_.fill(0);
+  count_ = 0;
+}
+
+inline std::int64_t DurationHistogram::count() const {
+  return count_;
+}
+
+inline std::chrono::nanoseconds DurationHistogram::Quantile(
+    double const quantile) const {
+  if (count_ == 0) {
+    return std::chrono::nanoseconds{};
+  }
+  std::int64_t const rank = std::clamp(
+      static_cast<std::int64_t>(std::ceil(quantile * count_)),
+      std::int64_t{1},
+      count_);
+  std::int64_t cumulative_count = 0;
+  for (int bucket = 0; bucket < buckets; ++bucket) {
+    cumulative_count += counts_[bucket];
+    if (cumulative_count >= rank) {
+      return BucketUpperBound(bucket);
+    }
+  }
+  return max_duration;
+}
+
+}  // namespace internal_duration_histogram
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,79 @@
+﻿
+#include "base/duration_histogram.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Le;
+
+using namespace std::chrono_literals;  // NOLINT(build/namespaces)
+
+class DurationHistogramTest : public ::testing::Test {};
+
+TEST_F(DurationHistogramTest, Buckets) {
+  // The small durations are exact.
+  for (std::int64_t n = 0; n < DurationHistogram::sub_buckets; ++n) {
+    EXPECT_THAT(DurationHistogram::BucketUpperBound(
+                    DurationHistogram::Bucket(std::chrono::nanoseconds(n))),
+                Eq(std::chrono::nanoseconds(n)));
+  }
+  // The buckets are contiguous and increasing, and their relative width is
+  // bounded.
+  for (int bucket = 1; bucket < DurationHistogram::buckets; ++bucket) {
+    auto const lower_bound =
+        DurationHistogram::BucketUpperBound(bucket - 1) + 1ns;
+    auto const upper_bound = DurationHistogram::BucketUpperBound(bucket);
+    EXPECT_THAT(DurationHistogram::Bucket(lower_bound), Eq(bucket));
+    EXPECT_THAT(DurationHistogram::Bucket(upper_bound), Eq(bucket));
+    EXPECT_THAT((upper_bound - lower_bound).count(),
+                Le(lower_bound.count() >> DurationHistogram::sub_bucket_bits));
+  }
+  EXPECT_THAT(
+      DurationHistogram::BucketUpperBound(DurationHistogram::buckets - 1),
+      Eq(DurationHistogram::max_duration));
+  // Long and negative durations are clamped.
+  EXPECT_THAT(DurationHistogram::Bucket(1h),
+              Eq(DurationHistogram::buckets - 1));
+  EXPECT_THAT(DurationHistogram::Bucket(-1ns), Eq(0));
+}
+
+TEST_F(DurationHistogramTest, Quantiles) {
+  DurationHistogram histogram;
+  EXPECT_THAT(histogram.count(), Eq(0));
+  EXPECT_THAT(histogram.Quantile(0.5), Eq(0ns));
+
+  for (int i = 1; i <= 1000; ++i) {
+    histogram.Record(i * 1us);
+  }
+  EXPECT_THAT(histogram.count(), Eq(1000));
+  EXPECT_THAT(histogram.Quantile(0.5), AllOf(Ge(500us), Le(516us)));
+  EXPECT_THAT(histogram.Quantile(0.99), AllOf(Ge(990us), Le(1021us)));
+  EXPECT_THAT(histogram.Quantile(0.999), AllOf(Ge(999us), Le(1031us)));
+  EXPECT_THAT(histogram.Quantile(1), AllOf(Ge(1000us), Le(1032us)));
+
+  // Merging preserves the quantiles of the union.
+  DurationHistogram other;
+  for (int i = 1; i <= 1000; ++i) {
+    other.Record(1s);
+  }
+  histogram.Add(other);
+  EXPECT_THAT(histogram.count(), Eq(2000));
+  EXPECT_THAT(histogram.Quantile(0.25), AllOf(Ge(500us), Le(516us)));
+  EXPECT_THAT(histogram.Quantile(0.75), AllOf(Ge(1s), Le(1032ms)));
+
+  histogram.Reset();
+  EXPECT_THAT(histogram.count(), Eq(0));
+  EXPECT_THAT(histogram.Quantile(1), Eq(0ns));
+}
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/macros.hpp"
+#include "base/status.hpp"
+#include "base/status_or.hpp"
+
+#if !OS_MACOSX
+
+namespace principia {
+namespace base {
+namespace internal_ensemble {
+
+// Executes a number of independent runs, typically integrations of perturbed
+// initial states or of the same system with different integrators, on a
+// |Bundle|.  Each run reduces its computation to a |Result| which is small
+// compared to the state of the run (e.g., some errors rather than an
+// ephemeris), so that the memory used is governed by the number of concurrent
+// runs.  The results may be checkpointed to a file, so that a long ensemble
+// which was interrupted may be resumed without executing again the runs that
+// had completed.
+template<typename Result>
+class Ensemble final {
+ public:
+  // Computes the result of the run with the given index.  The runs should check
+  // |AbortRequested()| when appropriate.
+  using Run = std::function<StatusOr<Result>(int index)>;
+  // Serialize and deserialize a result for checkpointing.  The encoded form is
+  // arbitrary bytes.
+  using Encoder = std::function<std::string(Result const& result)>;
+  using Decoder = std::function<Result(std::string const& bytes)>;
+
+  // At most |concurrent_runs| runs are executed at the same time.
+  explicit Ensemble(int concurrent_runs);
+
+  // Returns the number of runs that may be executed concurrently without using
+  // more than |memory_budget| bytes if each of them uses |memory_per_run|
+  // bytes, and without oversubscribing the cores.  The result is at least 1.
+  static int ConcurrentRuns(std::int64_t memory_budget,
+                            std::int64_t memory_per_run);
+
+  // Appends the result of each run to the file at |path| as soon as it
+  // completes.  If that file exists, the runs that it records are not executed
+  // again by |Execute|: their results are read from the file.  The file may be
+  // truncated, in which case its last record is ignored.  The caller is
+  // responsible for removing the file when the ensemble is changed.
+  void SetCheckpoint(std::filesystem::path const& path,
+                     Encoder encoder,
+                     Decoder decoder);
+
+  // Executes |run| for the indices in [0, number_of_runs[ and returns their
+  // results indexed like the runs, or the first error returned by a run, in
+  // which case the other runs are aborted.
+  StatusOr<std::vector<Result>> Execute(int number_of_runs, Run const& run);
+
+ private:
+  // Reads the complete records of the checkpoint into |results| and returns
+  // their length in bytes.
+  std::int64_t ReadCheckpoint(
+      std::vector<std::optional<Result>>& results) const;
+
+  int const concurrent_runs_;
+
+  std::optional<std::filesystem::path> checkpoint_;
+  Encoder encoder_;
+  Decoder decoder_;
+
+  // Serializes the writes to the checkpoint and to the results.
+  std::mutex lock_;
+};
+
+}  // namespace internal_ensemble
+
+using internal_ensemble::Ensemble;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/ensemble_body.hpp"
+
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "base/ensemble.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+#include "base/array.hpp"
+#include "base/bundle.hpp"
+#include "base/hexadecimal.hpp"
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_ensemble {
+
+// A record of the checkpoint is a line made of the index of a run, a space,
+// and the hexadecimal encoding of its result.
+
+template<typename Result>
+Ensemble<Result>::Ensemble(int const concurrent_runs)
+    : concurrent_runs_(concurrent_runs) {
+  CHECK_LT(0, concurrent_runs_);
+}
+
+template<typename Result>
+int Ensemble<Result>::ConcurrentRuns(std::int64_t const memory_budget,
+                                     std::int64_t const memory_per_run) {
+  CHECK_LT(0, memory_per_run);
+  std::int64_t const cores = std::thread::hardware_concurrency();
+  return static_cast<int>(std::max<std::int64_t>(
+      1, std::min(cores, memory_budget / memory_per_run)));
+}
+
+template<typename Result>
+void Ensemble<Result>::SetCheckpoint(std::filesystem::path const& path,
+                                     Encoder encoder,
+                                     Decoder decoder) {
+  checkpoint_ = path;
+  encoder_ = std::move(encoder);
+  decoder_ = std::move(decoder);
+}
+
+template<typename Result>
+StatusOr<std::vector<Result>> Ensemble<Result>::Execute(
+    int const number_of_runs,
+    Run const& run) {
+  std::vector<std::optional<Result>> results(number_of_runs);
+  std::ofstream checkpoint;
+  if (checkpoint_) {
+    std::int64_t const length = ReadCheckpoint(results);
+    if (std::filesystem::exists(*checkpoint_)) {
+      // Drop the truncated record, if any, so that it doesn't get prefixed to
+      // the next one.
+      std::filesystem::resize_file(*checkpoint_, length);
+    }
+    checkpoint.open(*checkpoint_, std::ios::app | std::ios::binary);
+    CHECK(checkpoint.good()) << *checkpoint_;
+  }
+
+  Bundle bundle(concurrent_runs_);
+  for (int i = 0; i < number_of_runs; ++i) {
+    if (results[i].has_value()) {
+      continue;
+    }
+    bundle.Add([this, i, &checkpoint, &results, &run]() -> Status {
+      StatusOr<Result> const result = run(i);
+      RETURN_IF_ERROR(result.status());
+      std::lock_guard<std::mutex> l(lock_);
+      if (checkpoint_) {
+        std::string const bytes = encoder_(result.ValueOrDie());
+        UniqueArray<char> const hexadecimal = HexadecimalEncode(
+            Array<std::uint8_t const>(
+                reinterpret_cast<std::uint8_t const*>(bytes.data()),
+                bytes.size()),
+            /*null_terminated=*/false);
+        checkpoint << i << ' ';
+        checkpoint.write(hexadecimal.data.get(), hexadecimal.size);
+        checkpoint << '\n';
+        checkpoint.flush();
+        CHECK(checkpoint.good()) << *checkpoint_;
+      }
+      results[i] = result.ValueOrDie();
+      return Status::OK;
+    });
+  }
+  RETURN_IF_ERROR(bundle.Join());
+
+  std::vector<Result> all_results;
+  all_results.reserve(number_of_runs);
+  for (auto& result : results) {
+    all_results.push_back(std::move(*result));
+  }
+  return all_results;
+}
+
+template<typename Result>
+std::int64_t Ensemble<Result>::ReadCheckpoint(
+    std::vector<std::optional<Result>>& results) const {
+  std::ifstream checkpoint(*checkpoint_, std::ios::binary);
+  if (!checkpoint.good()) {
+    return 0;
+  }
+  std::int64_t length = 0;
+  int number_of_records = 0;
+  std::string line;
+  while (std::getline(checkpoint, line)) {
+    // A line that isn't terminated is the last record, which may have been
+    // truncated by an interruption.
+    if (checkpoint.eof()) {
+      break;
+    }
+    auto const space = line.find(' ');
+    CHECK_NE(std::string::npos, space) << *checkpoint_ << ": " << line;
+    int const index = std::stoi(line.substr(0, space));
+    CHECK_LE(0, index) << *checkpoint_ << ": " << line;
+    CHECK_LT(index, results.size()) << *checkpoint_ << ": " << line;
+    UniqueArray<std::uint8_t> const bytes = HexadecimalDecode(
+        Array<char const>(line.data() + space + 1, line.size() - space - 1));
+    results[index] = decoder_(
+        std::string(reinterpret_cast<char const*>(bytes.data.get()),
+                    bytes.size));
+    ++number_of_records;
+    length += line.size() + 1;
+  }
+  LOG(INFO) << "Read " << number_of_records << " results from "
+            << *checkpoint_;
+  return length;
+}
+
+}  // namespace internal_ensemble
+}  // namespace base
+}  // namespace principia
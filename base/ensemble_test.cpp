@@ -0,0 +1,119 @@
+
+#include "base/ensemble.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "testing_utilities/matchers.hpp"
+
+#if !OS_MACOSX
+
+namespace principia {
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+
+namespace base {
+
+class EnsembleTest : public ::testing::Test {
+ protected:
+  EnsembleTest()
+      : checkpoint_(std::filesystem::temp_directory_path() /
+                    "principia_ensemble_test.checkpoint") {
+    std::filesystem::remove(checkpoint_);
+  }
+
+  ~EnsembleTest() override {
+    std::filesystem::remove(checkpoint_);
+  }
+
+  void SetCheckpoint(Ensemble<int>& ensemble) {
+    ensemble.SetCheckpoint(
+        checkpoint_,
+        [](int const result) { return std::to_string(result); },
+        [](std::string const& bytes) { return std::stoi(bytes); });
+  }
+
+  // Squares its index and counts the runs.
+  Ensemble<int>::Run Square() {
+    return [this](int const index) -> StatusOr<int> {
+      ++runs_;
+      return index * index;
+    };
+  }
+
+  std::filesystem::path const checkpoint_;
+  std::atomic<int> runs_ = 0;
+};
+
+TEST_F(EnsembleTest, Execute) {
+  Ensemble<int> ensemble(/*concurrent_runs=*/3);
+  auto const results = ensemble.Execute(/*number_of_runs=*/5, Square());
+  EXPECT_OK(results.status());
+  EXPECT_THAT(results.ValueOrDie(), ElementsAre(0, 1, 4, 9, 16));
+  EXPECT_THAT(runs_, Eq(5));
+}
+
+TEST_F(EnsembleTest, Error) {
+  Ensemble<int> ensemble(/*concurrent_runs=*/3);
+  auto const results = ensemble.Execute(
+      /*number_of_runs=*/5,
+      [](int const index) -> StatusOr<int> {
+        if (index == 2) {
+          return Status(Error::OUT_OF_RANGE, "2");
+        }
+        return index;
+      });
+  EXPECT_THAT(results.status().error(), Eq(Error::OUT_OF_RANGE));
+}
+
+TEST_F(EnsembleTest, ConcurrentRuns) {
+  EXPECT_THAT(Ensemble<int>::ConcurrentRuns(/*memory_budget=*/10,
+                                            /*memory_per_run=*/100),
+              Eq(1));
+  EXPECT_THAT(Ensemble<int>::ConcurrentRuns(/*memory_budget=*/1'000'000,
+                                            /*memory_per_run=*/1),
+              Eq(static_cast<int>(std::thread::hardware_concurrency())));
+}
+
+TEST_F(EnsembleTest, Resume) {
+  {
+    Ensemble<int> ensemble(/*concurrent_runs=*/2);
+    SetCheckpoint(ensemble);
+    EXPECT_OK(ensemble.Execute(/*number_of_runs=*/3, Square()).status());
+    EXPECT_THAT(runs_, Eq(3));
+  }
+  // Simulate an interruption in the middle of the writing of a record.  The
+  // hexadecimal encoding of "100" is 313030.
+  {
+    std::ofstream checkpoint(checkpoint_, std::ios::app | std::ios::binary);
+    checkpoint << "3 3130";
+  }
+  {
+    Ensemble<int> ensemble(/*concurrent_runs=*/2);
+    SetCheckpoint(ensemble);
+    auto const results = ensemble.Execute(/*number_of_runs=*/5, Square());
+    EXPECT_OK(results.status());
+    EXPECT_THAT(results.ValueOrDie(), ElementsAre(0, 1, 4, 9, 16));
+    EXPECT_THAT(runs_, Eq(5));
+  }
+  {
+    Ensemble<int> ensemble(/*concurrent_runs=*/2);
+    SetCheckpoint(ensemble);
+    auto const results = ensemble.Execute(/*number_of_runs=*/5, Square());
+    EXPECT_OK(results.status());
+    EXPECT_THAT(results.ValueOrDie(), ElementsAre(0, 1, 4, 9, 16));
+    EXPECT_THAT(runs_, Eq(5));
+  }
+}
+
+}  // namespace base
+}  // namespace principia
+
+#endif
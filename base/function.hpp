@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <type_traits>
+
+#include "base/not_null.hpp"
 
 namespace principia {
 namespace base {
@@ -11,6 +15,9 @@ class Functor {
  public:
   virtual ~Functor() = default;
   virtual Result Call(Args&&...) = 0;
+  // Move-constructs this functor at |storage|, which must be large enough and
+  // suitably aligned.
+  virtual not_null<Functor*> MoveTo(void* storage) = 0;
 };
 
 template<typename F, typename Result, typename... Args>
@@ -18,6 +25,7 @@ class ConcreteFunctor final : public Functor<Result, Args...> {
  public:
   explicit ConcreteFunctor(F functor);
   Result Call(Args&&... args) final;
+  not_null<Functor<Result, Args...>*> MoveTo(void* storage) final;
  private:
   F functor_;
 };
@@ -25,6 +33,9 @@ class ConcreteFunctor final : public Functor<Result, Args...> {
 template<typename Signature>
 class function;
 
+// A move-only analogue of |std::function|.  Callables whose captures are at
+// most three pointers are stored in the |function| itself; larger ones, or
+// ones that may throw when moved, are allocated on the heap.
 template<typename Result, typename... Args>
 class function<Result(Args...)> {
  public:
@@ -33,18 +44,59 @@ class function<Result(Args...)> {
   template<typename F>
   function(F functor);
 
-  function(function&&) = default;  // NOLINT(whitespace/operators)
-  function& operator=(function&&) = default;
+  function(function&& other);
+  function& operator=(function&& other);
+
+  ~function();
 
   Result operator()(Args&&... args) const;
 
  private:
-  std::unique_ptr<Functor<Result, Args...>> functor_;
+  static constexpr std::size_t small_size = 4 * sizeof(void*);
+
+  template<typename F>
+  static constexpr bool is_small =
+      sizeof(ConcreteFunctor<F, Result, Args...>) <= small_size &&
+      alignof(ConcreteFunctor<F, Result, Args...>) <=
+          alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<F>;
+
+  bool is_small_functor() const;
+
+  // Takes the functor of |other|, which must not be |*this|, and leaves
+  // |other| empty.
+  void MoveFrom(function& other);
+  void Destroy();
+
+  alignas(std::max_align_t) std::byte storage_[small_size];
+  Functor<Result, Args...>* functor_ = nullptr;
+};
+
+// A non-owning reference to a callable, for callbacks that are invoked
+// synchronously and not retained.  It never allocates and is cheap to copy.
+// The callable must outlive the |function_ref|.
+template<typename Signature>
+class function_ref;
+
+template<typename Result, typename... Args>
+class function_ref<Result(Args...)> final {
+ public:
+  template<typename F,
+           typename = std::enable_if_t<
+               !std::is_same_v<std::decay_t<F>, function_ref>>>
+  function_ref(F&& functor);  // NOLINT(runtime/explicit)
+
+  Result operator()(Args... args) const;
+
+ private:
+  void* functor_;
+  Result (*call_)(void* functor, Args... args);
 };
 
 }  // namespace internal_function
 
 using internal_function::function;
+using internal_function::function_ref;
 
 }  // namespace base
 }  // namespace principia
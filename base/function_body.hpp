@@ -1,5 +1,6 @@
 #pragma once
 
+#include <new>
 #include <utility>
 
 #include "base/function.hpp"
@@ -17,20 +18,93 @@ Result ConcreteFunctor<F, Result, Args...>::Call(Args&&... args) {
   return functor_(std::forward<Args>(args)...);
 }
 
+template<typename F, typename Result, typename... Args>
+not_null<Functor<Result, Args...>*>
+ConcreteFunctor<F, Result, Args...>::MoveTo(void* const storage) {
+  return new (storage) ConcreteFunctor(std::move(functor_));
+}
+
 template<typename Result, typename... Args>
 function<Result(Args...)>::function() {}
 
 template<typename Result, typename... Args>
 template<typename F>
-function<Result(Args...)>::function(F functor)
-    : functor_(std::make_unique<ConcreteFunctor<F, Result, Args...>>(
-          std::move(functor))) {}
+function<Result(Args...)>::function(F functor) {
+  if constexpr (is_small<F>) {
+    functor_ = new (&storage_) ConcreteFunctor<F, Result, Args...>(
+        std::move(functor));
+  } else {
+    functor_ = new ConcreteFunctor<F, Result, Args...>(std::move(functor));
+  }
+}
+
+template<typename Result, typename... Args>
+function<Result(Args...)>::function(function&& other) {
+  MoveFrom(other);
+}
+
+template<typename Result, typename... Args>
+function<Result(Args...)>& function<Result(Args...)>::operator=(
+    function&& other) {
+  if (this != &other) {
+    Destroy();
+    MoveFrom(other);
+  }
+  return *this;
+}
+
+template<typename Result, typename... Args>
+function<Result(Args...)>::~function() {
+  Destroy();
+}
 
 template<typename Result, typename... Args>
 Result function<Result(Args...)>::operator()(Args&&... args) const {
   return functor_->Call(std::forward<Args>(args)...);
 }
 
+template<typename Result, typename... Args>
+bool function<Result(Args...)>::is_small_functor() const {
+  return static_cast<void const*>(functor_) ==
+         static_cast<void const*>(&storage_);
+}
+
+template<typename Result, typename... Args>
+void function<Result(Args...)>::MoveFrom(function& other) {
+  if (other.is_small_functor()) {
+    functor_ = other.functor_->MoveTo(&storage_);
+    other.Destroy();
+  } else {
+    functor_ = other.functor_;
+    other.functor_ = nullptr;
+  }
+}
+
+template<typename Result, typename... Args>
+void function<Result(Args...)>::Destroy() {
+  if (is_small_functor()) {
+    functor_->~Functor();
+  } else {
+    delete functor_;
+  }
+  functor_ = nullptr;
+}
+
+template<typename Result, typename... Args>
+template<typename F, typename>
+function_ref<Result(Args...)>::function_ref(F&& functor)
+    : functor_(const_cast<void*>(
+          static_cast<void const*>(std::addressof(functor)))),
+      call_([](void* const functor, Args... args) -> Result {
+        return (*static_cast<std::remove_reference_t<F>*>(functor))(
+            std::forward<Args>(args)...);
+      }) {}
+
+template<typename Result, typename... Args>
+Result function_ref<Result(Args...)>::operator()(Args... args) const {
+  return call_(functor_, std::forward<Args>(args)...);
+}
+
 }  // namespace internal_function
 }  // namespace base
 }  // namespace principia
@@ -1,7 +1,9 @@
 ﻿
 #include "base/function.hpp"
 
+#include <array>
 #include <memory>
+#include <string>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -35,5 +37,49 @@ TEST_F(FunctionTest, MovableFunction) {
   EXPECT_THAT(*μ(std::make_unique<int>(0)), Eq(2));
 }
 
+TEST_F(FunctionTest, SmallAndLargeFunctions) {
+  // A small functor is stored inline and must survive moves of the
+  // |function|.
+  auto small = std::make_unique<int>(3);
+  function<int()> f = [p = small.get()]() { return ++*p; };
+  function<int()> g = std::move(f);
+  EXPECT_THAT(g(), Eq(4));
+  f = std::move(g);
+  EXPECT_THAT(f(), Eq(5));
+
+  // A large functor is allocated on the heap.
+  std::array<std::string, 4> large{"a", "b", "c", "d"};
+  function<std::string(int)> h = [large](int const i) { return large[i]; };
+  function<std::string(int)> k = std::move(h);
+  EXPECT_THAT(k(2), Eq("c"));
+
+  // Assigning a large functor over a small one and conversely.
+  f = [large]() { return static_cast<int>(large.size()); };
+  EXPECT_THAT(f(), Eq(4));
+  f = [p = small.get()]() { return *p; };
+  EXPECT_THAT(f(), Eq(5));
+}
+
+TEST_F(FunctionTest, FunctionRef) {
+  int calls = 0;
+  auto const add = [&calls](int const x, int const& y) {
+    ++calls;
+    return x + y;
+  };
+  function_ref<int(int, int const&)> const f = add;
+  int const y = 2;
+  EXPECT_THAT(f(1, y), Eq(3));
+  function_ref<int(int, int const&)> const g = f;
+  EXPECT_THAT(g(3, y), Eq(5));
+  EXPECT_THAT(calls, Eq(2));
+
+  // A mutable functor is called through the reference.
+  int count = 0;
+  auto increment = [&count]() mutable { return ++count; };
+  function_ref<int()> const h = increment;
+  h();
+  EXPECT_THAT(h(), Eq(2));
+}
+
 }  // namespace base
 }  // namespace principia
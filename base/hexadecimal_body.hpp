@@ -3,6 +3,8 @@
 
 #include "base/hexadecimal.hpp"
 
+#include <emmintrin.h>
+
 #include <cstdint>
 #include <cstring>
 
@@ -37,6 +39,77 @@ constexpr std::uint8_t const hexadecimal_digits_to_nibble[256] = {
 #undef SKIP_48
 #endif
 
+// The number of bytes processed by one iteration of the SSE2 loops.
+constexpr std::int64_t sse2_encoded_bytes = 16;
+constexpr std::int64_t sse2_decoded_bytes = 16;
+
+// Encodes the 16 bytes at |input| into the 32 characters at |output|.
+inline void HexadecimalEncodeSSE2Block(std::uint8_t const* const input,
+                                       char* const output) {
+  __m128i const low_nibble_mask = _mm_set1_epi8(0x0F);
+  __m128i const bytes =
+      _mm_loadu_si128(reinterpret_cast<__m128i const*>(input));
+  __m128i const high_nibbles =
+      _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble_mask);
+  __m128i const low_nibbles = _mm_and_si128(bytes, low_nibble_mask);
+  // Maps each nibble n to '0' + n, plus 'A' - '9' - 1 if n > 9.
+  auto const to_digits = [](__m128i const nibbles) {
+    __m128i const letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(
+        _mm_add_epi8(nibbles, _mm_set1_epi8('0')),
+        _mm_and_si128(letters, _mm_set1_epi8('A' - '9' - 1)));
+  };
+  // The high nibble of each byte comes first.
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(output),
+      to_digits(_mm_unpacklo_epi8(high_nibbles, low_nibbles)));
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(output + 16),
+      to_digits(_mm_unpackhi_epi8(high_nibbles, low_nibbles)));
+}
+
+// Decodes the 32 characters at |input| into the 16 bytes at |output|.  Gives
+// the same results as |hexadecimal_digits_to_nibble|, including for invalid
+// characters.
+inline void HexadecimalDecodeSSE2Block(char const* const input,
+                                       std::uint8_t* const output) {
+  // Maps each character to its nibble, or to 0 if it is not a hexadecimal
+  // digit.  The comparisons are signed, so the characters above 0x7F are not
+  // in any of the ranges.
+  auto const to_nibbles = [](__m128i const characters) {
+    auto const in_range = [characters](char const first, char const last) {
+      return _mm_and_si128(
+          _mm_cmpgt_epi8(characters, _mm_set1_epi8(first - 1)),
+          _mm_cmplt_epi8(characters, _mm_set1_epi8(last + 1)));
+    };
+    auto const offset_if_in_range = [&characters, &in_range](char const first,
+                                                            char const last,
+                                                            char const value) {
+      return _mm_and_si128(
+          in_range(first, last),
+          _mm_sub_epi8(characters, _mm_set1_epi8(first - value)));
+    };
+    return _mm_or_si128(
+        offset_if_in_range('0', '9', 0),
+        _mm_or_si128(offset_if_in_range('A', 'F', 10),
+                     offset_if_in_range('a', 'f', 10)));
+  };
+  // In each 16-bit lane the first character is in the low byte.  The result
+  // byte is in the low byte of the lane.
+  auto const to_bytes = [](__m128i const nibbles) {
+    return _mm_or_si128(
+        _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+        _mm_srli_epi16(nibbles, 8));
+  };
+  __m128i const first =
+      _mm_loadu_si128(reinterpret_cast<__m128i const*>(input));
+  __m128i const second =
+      _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + 16));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                   _mm_packus_epi16(to_bytes(to_nibbles(first)),
+                                    to_bytes(to_nibbles(second))));
+}
+
 void HexadecimalEncode(Array<std::uint8_t const> input, Array<char> output) {
   CHECK_NOTNULL(input.data);
   CHECK_NOTNULL(output.data);
@@ -50,13 +123,21 @@ void HexadecimalEncode(Array<std::uint8_t const> input, Array<char> output) {
         static_cast<void*>(&output.data[input.size << 1]) <= input.data)
       << "bad overlap";
   CHECK_GE(output.size, input.size << 1) << "output too small";
-  // We want the result to start at |output.data[0]|.
-  output.data = output.data + ((input.size - 1) << 1);
-  input.data = input.data + input.size - 1;
-  for (std::uint8_t const* const input_rend = input.data - input.size;
-       input.data != input_rend;
-       --input.data, output.data -= 2) {
-    std::memcpy(output.data, &byte_to_hexadecimal_digits[*input.data << 1], 2);
+  // The bytes that don't fill a block are encoded first, then the blocks.
+  // Each block is entirely read before it is written, and
+  // written at a position that is not before its own, so the above overlap
+  // conditions remain sufficient.
+  std::int64_t const blocks_size =
+      input.size - input.size % sse2_encoded_bytes;
+  for (std::int64_t i = input.size - 1; i >= blocks_size; --i) {
+    std::memcpy(&output.data[i << 1],
+                &byte_to_hexadecimal_digits[input.data[i] << 1],
+                2);
+  }
+  for (std::int64_t i = blocks_size - sse2_encoded_bytes;
+       i >= 0;
+       i -= sse2_encoded_bytes) {
+    HexadecimalEncodeSSE2Block(&input.data[i], &output.data[i << 1]);
   }
 }
 UniqueArray<char> HexadecimalEncode(Array<std::uint8_t const> const input,
@@ -89,7 +170,19 @@ void HexadecimalDecode(Array<char const> input, Array<std::uint8_t> output) {
         &input.data[input.size] <= static_cast<void*>(output.data))
       << "bad overlap";
   CHECK_GE(output.size, input.size / 2) << "output too small";
-  for (char const* const input_end = input.data + input.size;
+  // Each block is entirely read before it is written, and written at a
+  // position that is not after its own, so the above overlap conditions
+  // remain sufficient.
+  for (char const* const blocks_end =
+           input.data + input.size / (2 * sse2_decoded_bytes) *
+                            (2 * sse2_decoded_bytes);
+       input.data != blocks_end;
+       input.data += 2 * sse2_decoded_bytes,
+       output.data += sse2_decoded_bytes) {
+    HexadecimalDecodeSSE2Block(input.data, output.data);
+  }
+  for (char const* const input_end =
+           input.data + input.size % (2 * sse2_decoded_bytes);
        input.data != input_end;
        input.data += 2, ++output.data) {
     *output.data = (hexadecimal_digits_to_nibble[*input.data] << 4) |
@@ -167,9 +167,30 @@ inline void noreturn() { std::exit(0); }
 // 64-bit architectures.
 #define PRINCIPIA_USE_SSE3_INTRINSICS !_DEBUG
 
+// AVX2 is only used if the compiler targets it (/arch:AVX2, -mavx2).  The
+// layout of |R3Element| depends on this macro, so all the translation units
+// of a binary must be compiled with the same architecture.
+#if !_DEBUG && defined(__AVX2__)
+#  define PRINCIPIA_USE_AVX2_INTRINSICS 1
+#else
+#  define PRINCIPIA_USE_AVX2_INTRINSICS 0
+#endif
+
+// Fused multiply-add is only used if the compiler targets it (/arch:AVX2 on
+// MSVC, -mfma elsewhere).  It changes the rounding of the results, so it is not
+// emulated in software on processors which lack it.
+#if !_DEBUG && \
+    (defined(__FMA__) || (PRINCIPIA_COMPILER_MSVC && defined(__AVX2__)))
+#  define PRINCIPIA_USE_FMA_INTRINSICS 1
+#else
+#  define PRINCIPIA_USE_FMA_INTRINSICS 0
+#endif
+
 // Thread-safety analysis.
 #if PRINCIPIA_COMPILER_CLANG || PRINCIPIA_COMPILER_CLANG_CL
 #  define THREAD_ANNOTATION_ATTRIBUTE__(x) __attribute__((x))
+#  define CAPABILITY(x) \
+       THREAD_ANNOTATION_ATTRIBUTE__(capability(x))
 #  define EXCLUDES(...) \
        THREAD_ANNOTATION_ATTRIBUTE__(locks_excluded(__VA_ARGS__))
 #  define GUARDED_BY(...) \
@@ -179,6 +200,7 @@ inline void noreturn() { std::exit(0); }
 #  define REQUIRES_SHARED(...) \
        THREAD_ANNOTATION_ATTRIBUTE__(requires_shared_capability(__VA_ARGS__))
 #else
+#  define CAPABILITY(x)
 #  define EXCLUDES(x)
 #  define GUARDED_BY(x)
 #  define REQUIRES(x)
@@ -0,0 +1,95 @@
+﻿
+#include "base/mapped_file.hpp"
+
+#include "base/macros.hpp"
+#include "glog/logging.h"
+
+#if OS_WIN
+#define NOGDI
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace principia {
+namespace base {
+namespace internal_mapped_file {
+
+// The handles of the file and of the mapping are closed as soon as the view is
+// mapped: the view keeps the mapping alive until it is unmapped.
+MappedFile::MappedFile(std::filesystem::path const& path) {
+#if OS_WIN
+  HANDLE const file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  /*lpSecurityAttributes=*/nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN,
+                                  /*hTemplateFile=*/nullptr);
+  CHECK(file != INVALID_HANDLE_VALUE)
+      << path << ": CreateFileW failed: " << GetLastError();
+  LARGE_INTEGER size;
+  CHECK(GetFileSizeEx(file, &size))
+      << path << ": GetFileSizeEx failed: " << GetLastError();
+  size_ = size.QuadPart;
+  // A file of size 0 cannot be mapped.
+  if (size_ > 0) {
+    HANDLE const mapping = CreateFileMappingW(file,
+                                              /*lpAttributes=*/nullptr,
+                                              PAGE_READONLY,
+                                              /*dwMaximumSizeHigh=*/0,
+                                              /*dwMaximumSizeLow=*/0,
+                                              /*lpName=*/nullptr);
+    CHECK(mapping != nullptr)
+        << path << ": CreateFileMappingW failed: " << GetLastError();
+    data_ = static_cast<std::uint8_t const*>(
+        MapViewOfFile(mapping,
+                      FILE_MAP_READ,
+                      /*dwFileOffsetHigh=*/0,
+                      /*dwFileOffsetLow=*/0,
+                      /*dwNumberOfBytesToMap=*/0));
+    CHECK(data_ != nullptr)
+        << path << ": MapViewOfFile failed: " << GetLastError();
+    CloseHandle(mapping);
+  }
+  CloseHandle(file);
+#else
+  int const file = open(path.c_str(), O_RDONLY);
+  PCHECK(file >= 0) << path;
+  struct stat status;
+  PCHECK(fstat(file, &status) == 0) << path;
+  size_ = status.st_size;
+  // A file of size 0 cannot be mapped.
+  if (size_ > 0) {
+    void* const data =
+        mmap(/*addr=*/nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+    PCHECK(data != MAP_FAILED) << path;
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<std::uint8_t const*>(data);
+  }
+  close(file);
+#endif
+}
+
+MappedFile::~MappedFile() {
+  if (data_ == nullptr) {
+    return;
+  }
+#if OS_WIN
+  UnmapViewOfFile(data_);
+#else
+  munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+}
+
+Array<std::uint8_t const> MappedFile::bytes() const {
+  return Array<std::uint8_t const>(data_, size_);
+}
+
+}  // namespace internal_mapped_file
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,40 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "base/array.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_mapped_file {
+
+// A read-only view of the entire contents of a file, mapped in memory.  The
+// pages are brought in by the operating system as they are accessed, so this
+// is appropriate for reading large files sequentially without copying them
+// into buffers.  The file must not be modified while it is mapped.
+class MappedFile final {
+ public:
+  // Fails if the file cannot be opened or mapped.
+  explicit MappedFile(std::filesystem::path const& path);
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+
+  // The contents of the file, valid for the lifetime of this object.  Empty if
+  // the file is empty.
+  Array<std::uint8_t const> bytes() const;
+
+ private:
+  std::uint8_t const* data_ = nullptr;
+  std::int64_t size_ = 0;
+};
+
+}  // namespace internal_mapped_file
+
+using internal_mapped_file::MappedFile;
+
+}  // namespace base
+}  // namespace principia
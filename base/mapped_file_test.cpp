@@ -0,0 +1,55 @@
+﻿
+#include "base/mapped_file.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::Eq;
+
+class MappedFileTest : public ::testing::Test {
+ protected:
+  MappedFileTest()
+      : path_(std::filesystem::temp_directory_path() /
+              (std::string(testing::UnitTest::GetInstance()
+                               ->current_test_info()
+                               ->name()) +
+               ".mapped")) {}
+
+  ~MappedFileTest() override {
+    std::filesystem::remove(path_);
+  }
+
+  void Write(std::string const& contents) {
+    std::ofstream stream(path_, std::ios::out | std::ios::binary);
+    stream << contents;
+  }
+
+  std::filesystem::path const path_;
+};
+
+TEST_F(MappedFileTest, Contents) {
+  std::string const contents("Mapped\0file\n", 12);
+  Write(contents);
+  MappedFile const file(path_);
+  auto const bytes = file.bytes();
+  ASSERT_THAT(bytes.size, Eq(contents.size()));
+  EXPECT_THAT(std::string(reinterpret_cast<char const*>(bytes.data),
+                          bytes.size),
+              Eq(contents));
+}
+
+TEST_F(MappedFileTest, Empty) {
+  Write("");
+  MappedFile const file(path_);
+  EXPECT_THAT(file.bytes().size, Eq(0));
+}
+
+}  // namespace base
+}  // namespace principia
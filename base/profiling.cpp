@@ -0,0 +1,263 @@
+
+#include "base/profiling.hpp"
+
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "base/macros.hpp"
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_profiling {
+
+namespace {
+
+// The counters of one thread.  They are only incremented by their thread, so
+// the atomic operations are uncontended, but they may be read or reset by any
+// thread.
+class ThreadCounters final {
+ public:
+  ThreadCounters();
+  ~ThreadCounters();
+
+  // |parent| is the phase of the enclosing scope, if any.
+  void Record(ProfilingPhase phase,
+              std::optional<ProfilingPhase> parent,
+              std::chrono::nanoseconds duration,
+              std::chrono::nanoseconds self_duration);
+  void AddTo(std::array<ProfilingStatistics, profiling_phases>& statistics)
+      const;
+  void Reset();
+
+ private:
+  struct PhaseCounters final {
+    std::atomic<std::int64_t> calls{};
+    std::atomic<std::int64_t> nanoseconds{};
+    std::atomic<std::int64_t> self_nanoseconds{};
+    std::array<std::atomic<std::int64_t>, DurationHistogram::buckets>
+        histogram{};
+    std::array<std::atomic<std::int64_t>, profiling_phases> nested_calls{};
+  };
+
+  std::array<PhaseCounters, profiling_phases> phases_;
+};
+
+std::mutex lock;
+std::set<ThreadCounters*> live_threads GUARDED_BY(lock);
+// The statistics of the threads that have exited since the last reset.
+std::array<ProfilingStatistics, profiling_phases> exited_threads
+    GUARDED_BY(lock);
+
+// The innermost scope in progress on the current thread.
+thread_local ProfilingScope* current_scope = nullptr;
+
+ThreadCounters::ThreadCounters() {
+  std::lock_guard<std::mutex> l(lock);
+  live_threads.insert(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+  std::lock_guard<std::mutex> l(lock);
+  AddTo(exited_threads);
+  live_threads.erase(this);
+}
+
+void ThreadCounters::Record(ProfilingPhase const phase,
+                            std::optional<ProfilingPhase> const parent,
+                            std::chrono::nanoseconds const duration,
+                            std::chrono::nanoseconds const self_duration) {
+  PhaseCounters& counters = phases_[static_cast<int>(phase)];
+  counters.calls.fetch_add(1, std::memory_order_relaxed);
+  counters.nanoseconds.fetch_add(duration.count(), std::memory_order_relaxed);
+  counters.self_nanoseconds.fetch_add(self_duration.count(),
+                                      std::memory_order_relaxed);
+  counters.histogram[DurationHistogram::Bucket(duration)].fetch_add(
+      1, std::memory_order_relaxed);
+  if (parent.has_value()) {
+    phases_[static_cast<int>(*parent)]
+        .nested_calls[static_cast<int>(phase)]
+        .fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void ThreadCounters::AddTo(
+    std::array<ProfilingStatistics, profiling_phases>& statistics) const {
+  for (int i = 0; i < profiling_phases; ++i) {
+    PhaseCounters const& counters = phases_[i];
+    ProfilingStatistics& phase_statistics = statistics[i];
+    phase_statistics.calls += counters.calls.load(std::memory_order_relaxed);
+    phase_statistics.duration += std::chrono::nanoseconds(
+        counters.nanoseconds.load(std::memory_order_relaxed));
+    phase_statistics.self_duration += std::chrono::nanoseconds(
+        counters.self_nanoseconds.load(std::memory_order_relaxed));
+    for (int bucket = 0; bucket < DurationHistogram::buckets; ++bucket) {
+      phase_statistics.histogram.Add(
+          bucket, counters.histogram[bucket].load(std::memory_order_relaxed));
+    }
+    for (int j = 0; j < profiling_phases; ++j) {
+      phase_statistics.nested_calls[j] +=
+          counters.nested_calls[j].load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void ThreadCounters::Reset() {
+  for (PhaseCounters& counters : phases_) {
+    counters.calls.store(0, std::memory_order_relaxed);
+    counters.nanoseconds.store(0, std::memory_order_relaxed);
+    counters.self_nanoseconds.store(0, std::memory_order_relaxed);
+    for (auto& count : counters.histogram) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    for (auto& count : counters.nested_calls) {
+      count.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+ThreadCounters& CurrentThreadCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+}  // namespace
+
+std::atomic<bool> Profiler::enabled_ = false;
+
+char const* ProfilingPhaseName(ProfilingPhase const phase) {
+  switch (phase) {
+    case ProfilingPhase::EphemerisProlong:
+      return "Ephemeris::Prolong";
+    case ProfilingPhase::EphemerisFlowWithAdaptiveStep:
+      return "Ephemeris::FlowWithAdaptiveStep";
+    case ProfilingPhase::EphemerisFlowWithFixedStep:
+      return "Ephemeris::FlowWithFixedStep";
+    case ProfilingPhase::EphemerisGravitationalAcceleration:
+      return "Ephemeris gravitational acceleration";
+    case ProfilingPhase::ContinuousTrajectoryFit:
+      return "ContinuousTrajectory fitting";
+    case ProfilingPhase::ContinuousTrajectoryEvaluate:
+      return "ContinuousTrajectory evaluation";
+    case ProfilingPhase::PluginAdvanceTime:
+      return "Plugin::AdvanceTime";
+    case ProfilingPhase::PluginCatchUpLaggingVessels:
+      return "Plugin::CatchUpLaggingVessels";
+    case ProfilingPhase::RendererRenderBarycentricTrajectoryInPlotting:
+      return "Renderer::RenderBarycentricTrajectoryInPlotting";
+    case ProfilingPhase::RendererRenderPlottingTrajectoryInWorld:
+      return "Renderer::RenderPlottingTrajectoryInWorld";
+  }
+  LOG(FATAL) << "Unexpected phase " << static_cast<int>(phase);
+  base::noreturn();
+}
+
+void Profiler::SetEnabled(bool const enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+std::array<ProfilingStatistics, profiling_phases> Profiler::Statistics() {
+  std::lock_guard<std::mutex> l(lock);
+  std::array<ProfilingStatistics, profiling_phases> statistics =
+      exited_threads;
+  for (ThreadCounters const* const counters : live_threads) {
+    counters->AddTo(statistics);
+  }
+  return statistics;
+}
+
+void Profiler::Reset() {
+  std::lock_guard<std::mutex> l(lock);
+  exited_threads = {};
+  for (ThreadCounters* const counters : live_threads) {
+    counters->Reset();
+  }
+}
+
+std::string Profiler::Report() {
+  auto const statistics = Statistics();
+  auto const seconds = [](std::chrono::nanoseconds const duration) {
+    return std::chrono::duration<double>(duration).count();
+  };
+  std::stringstream report;
+  report << "Profiling " << (enabled() ? "enabled" : "disabled") << "\n";
+  for (int i = 0; i < profiling_phases; ++i) {
+    auto const& phase_statistics = statistics[i];
+    report << ProfilingPhaseName(static_cast<ProfilingPhase>(i)) << ": "
+           << phase_statistics.calls << " calls, "
+           << seconds(phase_statistics.duration) << " s";
+    if (phase_statistics.calls > 0) {
+      auto const& histogram = phase_statistics.histogram;
+      report << ", self " << seconds(phase_statistics.self_duration) << " s"
+             << u8", μ = "
+             << seconds(phase_statistics.duration) / phase_statistics.calls
+             << " s, p50 = " << seconds(histogram.Quantile(0.5))
+             << " s, p99 = " << seconds(histogram.Quantile(0.99))
+             << " s, p99.9 = " << seconds(histogram.Quantile(0.999))
+             << " s, max = " << seconds(histogram.Quantile(1)) << " s";
+    }
+    report << "\n";
+  }
+
+  // The call tree, starting from the calls made outside of any phase.  A phase
+  // nested in itself, directly or not, is not expanded again.
+  report << "Call tree:\n";
+  std::array<bool, profiling_phases> on_path{};
+  std::function<void(int, std::int64_t, int)> print_subtree =
+      [&](int const phase, std::int64_t const calls, int const depth) {
+        report << std::string(2 * depth, ' ')
+               << ProfilingPhaseName(static_cast<ProfilingPhase>(phase))
+               << ": " << calls << " calls\n";
+        if (on_path[phase]) {
+          return;
+        }
+        on_path[phase] = true;
+        for (int nested = 0; nested < profiling_phases; ++nested) {
+          std::int64_t const nested_calls =
+              statistics[phase].nested_calls[nested];
+          if (nested_calls > 0) {
+            print_subtree(nested, nested_calls, depth + 1);
+          }
+        }
+        on_path[phase] = false;
+      };
+  for (int phase = 0; phase < profiling_phases; ++phase) {
+    std::int64_t top_level_calls = statistics[phase].calls;
+    for (int parent = 0; parent < profiling_phases; ++parent) {
+      top_level_calls -= statistics[parent].nested_calls[phase];
+    }
+    if (top_level_calls > 0) {
+      print_subtree(phase, top_level_calls, /*depth=*/1);
+    }
+  }
+  return report.str();
+}
+
+ProfilingScope* Profiler::Enter(ProfilingScope* const scope) {
+  ProfilingScope* const parent = current_scope;
+  current_scope = scope;
+  return parent;
+}
+
+void Profiler::Exit(ProfilingScope& scope,
+                    std::chrono::nanoseconds const duration) {
+  DCHECK_EQ(current_scope, &scope);
+  std::optional<ProfilingPhase> parent_phase;
+  if (scope.parent_ != nullptr) {
+    scope.parent_->nested_duration_ += duration;
+    parent_phase = scope.parent_->phase_;
+  }
+  CurrentThreadCounters().Record(scope.phase_,
+                                 parent_phase,
+                                 duration,
+                                 duration - scope.nested_duration_);
+  current_scope = scope.parent_;
+}
+
+}  // namespace internal_profiling
+}  // namespace base
+}  // namespace principia
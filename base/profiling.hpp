@@ -0,0 +1,134 @@
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "base/duration_histogram.hpp"
+#include "base/macros.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_profiling {
+
+// The phases of the computation whose duration may be measured by
+// |PRINCIPIA_PROFILE_SCOPE|.
+enum class ProfilingPhase : int {
+  EphemerisProlong,
+  EphemerisFlowWithAdaptiveStep,
+  EphemerisFlowWithFixedStep,
+  EphemerisGravitationalAcceleration,
+  ContinuousTrajectoryFit,
+  ContinuousTrajectoryEvaluate,
+  PluginAdvanceTime,
+  PluginCatchUpLaggingVessels,
+  RendererRenderBarycentricTrajectoryInPlotting,
+  RendererRenderPlottingTrajectoryInWorld,
+};
+constexpr int profiling_phases =
+    static_cast<int>(ProfilingPhase::RendererRenderPlottingTrajectoryInWorld) +
+    1;
+
+PHYSICS_DLL char const* ProfilingPhaseName(ProfilingPhase phase);
+
+struct ProfilingStatistics final {
+  std::int64_t calls = 0;
+  std::chrono::nanoseconds duration{};
+  // The part of |duration| not spent in nested phases.
+  std::chrono::nanoseconds self_duration{};
+  // The distribution of the durations of the calls.
+  DurationHistogram histogram;
+  // The number of calls of each phase made while this phase was the innermost
+  // one in progress on the same thread.
+  std::array<std::int64_t, profiling_phases> nested_calls{};
+};
+
+class ProfilingScope;
+
+// A process-wide record of the time spent in each |ProfilingPhase|.  The
+// durations are inclusive: a phase entered while another one is in progress
+// counts for both.  The scopes form a hierarchy on each thread, so the time
+// spent in a phase itself and the call tree of the phases are also recorded.
+// The counters are per-thread, so recording doesn't contend; when profiling is
+// disabled, which is the default, a scope costs a relaxed atomic load.  All the
+// functions are thread-safe.
+class PHYSICS_DLL Profiler final {
+ public:
+  Profiler() = delete;
+
+  static void SetEnabled(bool enabled);
+  static bool enabled();
+
+  // The statistics recorded by all threads, including those that have exited,
+  // since the beginning of the process or the last call to |Reset|.
+  static std::array<ProfilingStatistics, profiling_phases> Statistics();
+  static void Reset();
+
+  // A human-readable summary of |Statistics()|, one line per phase with the
+  // quantiles of the durations, followed by the call tree.
+  static std::string Report();
+
+ private:
+  // Makes |scope| the innermost scope of the current thread and returns the
+  // previous one, or null.
+  static ProfilingScope* Enter(ProfilingScope* scope);
+  // Records the |duration| of |scope|, which must be the innermost scope of
+  // the current thread, and makes its parent the innermost scope.
+  static void Exit(ProfilingScope& scope, std::chrono::nanoseconds duration);
+
+  static std::atomic<bool> enabled_;
+
+  friend class ProfilingScope;
+};
+
+// Records in the |Profiler| the duration of its lifetime, if profiling is
+// enabled when it is constructed.  Use through |PRINCIPIA_PROFILE_SCOPE|.
+class ProfilingScope final {
+ public:
+  explicit ProfilingScope(ProfilingPhase phase);
+  ~ProfilingScope();
+
+  ProfilingScope(ProfilingScope const&) = delete;
+  ProfilingScope(ProfilingScope&&) = delete;
+  ProfilingScope& operator=(ProfilingScope const&) = delete;
+  ProfilingScope& operator=(ProfilingScope&&) = delete;
+
+ private:
+  ProfilingPhase const phase_;
+  std::optional<std::chrono::steady_clock::time_point> start_;
+  // The enclosing scope on this thread, if any, and the time spent in the
+  // scopes nested in this one.
+  ProfilingScope* parent_ = nullptr;
+  std::chrono::nanoseconds nested_duration_{};
+
+  friend class Profiler;
+};
+
+}  // namespace internal_profiling
+
+using internal_profiling::Profiler;
+using internal_profiling::ProfilingPhase;
+using internal_profiling::ProfilingPhaseName;
+using internal_profiling::ProfilingScope;
+using internal_profiling::ProfilingStatistics;
+using internal_profiling::profiling_phases;
+
+}  // namespace base
+}  // namespace principia
+
+#define PRINCIPIA_PROFILING_SCOPE_NAME2(line) principia_profiling_scope_##line
+#define PRINCIPIA_PROFILING_SCOPE_NAME(line) \
+  PRINCIPIA_PROFILING_SCOPE_NAME2(line)
+
+// Measures the time until the end of the enclosing scope, attributing it to
+// |ProfilingPhase::phase|.
+#define PRINCIPIA_PROFILE_SCOPE(phase)                                  \
+  ::principia::base::ProfilingScope const                               \
+      PRINCIPIA_PROFILING_SCOPE_NAME(__LINE__)(                         \
+          ::principia::base::ProfilingPhase::phase)
+
+#include "base/profiling_body.hpp"
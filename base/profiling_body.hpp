@@ -0,0 +1,30 @@
+
+#pragma once
+
+#include "base/profiling.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_profiling {
+
+inline bool Profiler::enabled() {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+inline ProfilingScope::ProfilingScope(ProfilingPhase const phase)
+    : phase_(phase) {
+  if (Profiler::enabled()) {
+    parent_ = Profiler::Enter(this);
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+inline ProfilingScope::~ProfilingScope() {
+  if (start_.has_value()) {
+    Profiler::Exit(*this, std::chrono::steady_clock::now() - *start_);
+  }
+}
+
+}  // namespace internal_profiling
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,144 @@
+
+#include "base/profiling.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::Ge;
+using ::testing::HasSubstr;
+using ::testing::Lt;
+
+using namespace std::chrono_literals;  // NOLINT(build/namespaces)
+
+class ProfilingTest : public ::testing::Test {
+ protected:
+  ProfilingTest() {
+    Profiler::Reset();
+  }
+
+  ~ProfilingTest() override {
+    Profiler::SetEnabled(false);
+  }
+
+  static ProfilingStatistics StatisticsOf(ProfilingPhase const phase) {
+    return Profiler::Statistics()[static_cast<int>(phase)];
+  }
+};
+
+TEST_F(ProfilingTest, Disabled) {
+  EXPECT_FALSE(Profiler::enabled());
+  {
+    PRINCIPIA_PROFILE_SCOPE(EphemerisProlong);
+  }
+  EXPECT_EQ(0, StatisticsOf(ProfilingPhase::EphemerisProlong).calls);
+}
+
+TEST_F(ProfilingTest, Enabled) {
+  Profiler::SetEnabled(true);
+  for (int i = 0; i < 3; ++i) {
+    PRINCIPIA_PROFILE_SCOPE(EphemerisProlong);
+    std::this_thread::sleep_for(1ms);
+  }
+  {
+    PRINCIPIA_PROFILE_SCOPE(EphemerisFlowWithAdaptiveStep);
+    PRINCIPIA_PROFILE_SCOPE(EphemerisProlong);
+  }
+  auto const prolong = StatisticsOf(ProfilingPhase::EphemerisProlong);
+  EXPECT_EQ(4, prolong.calls);
+  EXPECT_THAT(prolong.duration, Ge(3ms));
+  EXPECT_EQ(1,
+            StatisticsOf(ProfilingPhase::EphemerisFlowWithAdaptiveStep).calls);
+  EXPECT_EQ(0, StatisticsOf(ProfilingPhase::EphemerisFlowWithFixedStep).calls);
+  EXPECT_THAT(Profiler::Report(), HasSubstr("Ephemeris::Prolong: 4 calls"));
+
+  Profiler::Reset();
+  EXPECT_EQ(0, StatisticsOf(ProfilingPhase::EphemerisProlong).calls);
+}
+
+TEST_F(ProfilingTest, Hierarchy) {
+  Profiler::SetEnabled(true);
+  for (int i = 0; i < 2; ++i) {
+    PRINCIPIA_PROFILE_SCOPE(PluginAdvanceTime);
+    std::this_thread::sleep_for(1ms);
+    {
+      PRINCIPIA_PROFILE_SCOPE(PluginCatchUpLaggingVessels);
+      std::this_thread::sleep_for(2ms);
+      PRINCIPIA_PROFILE_SCOPE(EphemerisProlong);
+      std::this_thread::sleep_for(3ms);
+    }
+    PRINCIPIA_PROFILE_SCOPE(EphemerisProlong);
+  }
+  {
+    PRINCIPIA_PROFILE_SCOPE(EphemerisProlong);
+  }
+
+  auto const statistics = Profiler::Statistics();
+  auto const& advance_time =
+      statistics[static_cast<int>(ProfilingPhase::PluginAdvanceTime)];
+  auto const& catch_up =
+      statistics[static_cast<int>(ProfilingPhase::PluginCatchUpLaggingVessels)];
+  auto const& prolong =
+      statistics[static_cast<int>(ProfilingPhase::EphemerisProlong)];
+  EXPECT_EQ(2, advance_time.calls);
+  EXPECT_EQ(
+      2,
+      advance_time.nested_calls[static_cast<int>(
+          ProfilingPhase::PluginCatchUpLaggingVessels)]);
+  EXPECT_EQ(2,
+            advance_time.nested_calls[static_cast<int>(
+                ProfilingPhase::EphemerisProlong)]);
+  EXPECT_EQ(2,
+            catch_up.nested_calls[static_cast<int>(
+                ProfilingPhase::EphemerisProlong)]);
+  EXPECT_EQ(5, prolong.calls);
+
+  // The self durations exclude the nested phases.
+  EXPECT_THAT(advance_time.duration, Ge(12ms));
+  EXPECT_THAT(advance_time.self_duration, Ge(2ms));
+  EXPECT_THAT(advance_time.self_duration, Lt(advance_time.duration - 10ms));
+  EXPECT_THAT(catch_up.self_duration, Ge(4ms));
+  EXPECT_THAT(catch_up.self_duration, Lt(catch_up.duration - 6ms));
+
+  // The histograms have the durations of the calls.
+  EXPECT_EQ(2, catch_up.histogram.count());
+  EXPECT_THAT(catch_up.histogram.Quantile(0.5), Ge(5ms));
+  EXPECT_EQ(5, prolong.histogram.count());
+
+  std::string const report = Profiler::Report();
+  EXPECT_THAT(report, HasSubstr("Plugin::AdvanceTime: 2 calls"));
+  EXPECT_THAT(report, HasSubstr("p99.9 = "));
+  EXPECT_THAT(report,
+              HasSubstr("Call tree:\n"
+                        "  Ephemeris::Prolong: 1 calls\n"
+                        "  Plugin::AdvanceTime: 2 calls\n"
+                        "    Ephemeris::Prolong: 2 calls\n"
+                        "    Plugin::CatchUpLaggingVessels: 2 calls\n"
+                        "      Ephemeris::Prolong: 2 calls\n"));
+}
+
+TEST_F(ProfilingTest, Threads) {
+  Profiler::SetEnabled(true);
+  std::thread thread1([]() {
+    PRINCIPIA_PROFILE_SCOPE(ContinuousTrajectoryFit);
+  });
+  std::thread thread2([]() {
+    PRINCIPIA_PROFILE_SCOPE(ContinuousTrajectoryFit);
+  });
+  {
+    PRINCIPIA_PROFILE_SCOPE(ContinuousTrajectoryFit);
+  }
+  thread1.join();
+  thread2.join();
+  // The counts of the threads that have exited are retained.
+  EXPECT_EQ(3, StatisticsOf(ProfilingPhase::ContinuousTrajectoryFit).calls);
+}
+
+}  // namespace base
+}  // namespace principia
@@ -6,6 +6,7 @@
 #include <algorithm>
 
 #include "base/sink_source.hpp"
+#include "base/thread_configuration.hpp"
 
 namespace principia {
 namespace base {
@@ -109,6 +110,7 @@ inline void PullSerializer::Start(
   CHECK(thread_ == nullptr);
   message_ = message;
   thread_ = std::make_unique<std::thread>([this](){
+    ConfigureCurrentThread();
     CHECK(message_->SerializeToZeroCopyStream(&stream_));
     // Put a sentinel at the end of the serialized stream so that the client
     // knows that this is the end.
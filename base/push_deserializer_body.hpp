@@ -6,6 +6,7 @@
 #include <algorithm>
 
 #include "base/sink_source.hpp"
+#include "base/thread_configuration.hpp"
 #include "glog/logging.h"
 #include "google/protobuf/io/coded_stream_inl.h"
 
@@ -111,6 +112,7 @@ inline void PushDeserializer::Start(
   CHECK(thread_ == nullptr);
   message_ = message;
   thread_ = std::make_unique<std::thread>([this, done]() {
+    ConfigureCurrentThread();
     // It is a well-known annoyance that, in order to set the total byte limit,
     // we have to copy code from MessageLite::ParseFromZeroCopyStream.  Blame
     // Kenton.
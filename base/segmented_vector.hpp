@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace principia {
+namespace base {
+namespace internal_segmented_vector {
+
+// A sequence container whose elements are appended by one thread while other
+// threads read them.  The elements are stored in segments of |segment_size|
+// elements which are never reallocated, and the size is published atomically
+// once the new element is constructed, so a reader that obtained a size (or an
+// end iterator) may access all the elements before it without synchronizing
+// with the writer.
+// Only |emplace_back| may be called concurrently with the const member
+// functions, and only by one thread at a time.  The other non-const member
+// functions require exclusive access, e.g., by holding a lock that the readers
+// also take.  References and iterators are only invalidated by erasing the
+// elements that they designate.
+template<typename T, std::int64_t segment_size = 64>
+class SegmentedVector final {
+ public:
+  using value_type = T;
+  using size_type = std::int64_t;
+
+  class const_iterator final {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::int64_t;
+    using pointer = T const*;
+    using reference = T const&;
+
+    const_iterator() = default;
+
+    reference operator*() const;
+    pointer operator->() const;
+    reference operator[](difference_type n) const;
+
+    const_iterator& operator++();
+    const_iterator& operator--();
+    const_iterator operator++(int);
+    const_iterator operator--(int);
+    const_iterator& operator+=(difference_type n);
+    const_iterator& operator-=(difference_type n);
+    const_iterator operator+(difference_type n) const;
+    const_iterator operator-(difference_type n) const;
+    difference_type operator-(const_iterator const& right) const;
+
+    bool operator==(const_iterator const& right) const;
+    bool operator!=(const_iterator const& right) const;
+    bool operator<(const_iterator const& right) const;
+    bool operator>(const_iterator const& right) const;
+    bool operator<=(const_iterator const& right) const;
+    bool operator>=(const_iterator const& right) const;
+
+   private:
+    const_iterator(SegmentedVector const* vector, std::int64_t index);
+
+    SegmentedVector const* vector_ = nullptr;
+    std::int64_t index_ = 0;
+
+    friend class SegmentedVector;
+  };
+  using iterator = const_iterator;
+
+  SegmentedVector() = default;
+  ~SegmentedVector();
+
+  // The iterators designate a specific vector, so this class can be neither
+  // copied nor moved.
+  SegmentedVector(SegmentedVector const&) = delete;
+  SegmentedVector(SegmentedVector&&) = delete;
+  SegmentedVector& operator=(SegmentedVector const&) = delete;
+  SegmentedVector& operator=(SegmentedVector&&) = delete;
+
+  // These functions may be called concurrently with |emplace_back|.  The
+  // iterators returned by |end| and |cend| designate the end of the vector at
+  // the time of the call.
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+  bool empty() const;
+  size_type size() const;
+
+  T const& operator[](size_type index) const;
+  T const& front() const;
+  T const& back() const;
+
+  // Constructs an element at the end of the vector and publishes it to the
+  // readers.  Never moves the existing elements.
+  template<typename... Args>
+  void emplace_back(Args&&... args);
+
+  // These functions require exclusive access.
+  void pop_front();
+  void pop_back();
+
+  // The number of bytes allocated for the elements.  Only useful for
+  // benchmarking or analyzing performance.  Must not be called concurrently
+  // with |emplace_back|.
+  std::int64_t memory_footprint() const;
+
+ private:
+  struct Segment final {
+    std::aligned_storage_t<sizeof(T), alignof(T)> slots[segment_size];
+  };
+  // The segments in order; the null entries at the end are available for
+  // growth.  A directory is never resized once published.
+  using Directory = std::vector<Segment*>;
+
+  // The address of the element at |position|, counted from the beginning of
+  // the first segment.
+  T* slot_address(std::int64_t position) const;
+
+  // Frees the directories that were superseded by |directory_|.  Requires
+  // exclusive access, since readers may still be using them otherwise.
+  void FreeSupersededDirectories();
+
+  // |directories_.back()| is the directory currently published in
+  // |directory_|; the other ones have been superseded but may still be in use
+  // by readers.
+  std::vector<std::unique_ptr<Directory>> directories_;
+  std::atomic<Directory*> directory_{nullptr};
+  // The position of the first element in the first segment.  Only changed with
+  // exclusive access.
+  std::int64_t first_ = 0;
+  std::atomic<size_type> size_{0};
+  std::int64_t number_of_segments_ = 0;
+};
+
+}  // namespace internal_segmented_vector
+
+using internal_segmented_vector::SegmentedVector;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/segmented_vector_body.hpp"
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "base/segmented_vector.hpp"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_segmented_vector {
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator::reference
+SegmentedVector<T, segment_size>::const_iterator::operator*() const {
+  return (*vector_)[index_];
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator::pointer
+SegmentedVector<T, segment_size>::const_iterator::operator->() const {
+  return &(*vector_)[index_];
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator::reference
+SegmentedVector<T, segment_size>::const_iterator::operator[](
+    difference_type const n) const {
+  return (*vector_)[index_ + n];
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator&
+SegmentedVector<T, segment_size>::const_iterator::operator++() {
+  ++index_;
+  return *this;
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator&
+SegmentedVector<T, segment_size>::const_iterator::operator--() {
+  --index_;
+  return *this;
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator
+SegmentedVector<T, segment_size>::const_iterator::operator++(int) {
+  const_iterator const initial = *this;
+  ++index_;
+  return initial;
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator
+SegmentedVector<T, segment_size>::const_iterator::operator--(int) {
+  const_iterator const initial = *this;
+  --index_;
+  return initial;
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator&
+SegmentedVector<T, segment_size>::const_iterator::operator+=(
+    difference_type const n) {
+  index_ += n;
+  return *this;
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator&
+SegmentedVector<T, segment_size>::const_iterator::operator-=(
+    difference_type const n) {
+  index_ -= n;
+  return *this;
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator
+SegmentedVector<T, segment_size>::const_iterator::operator+(
+    difference_type const n) const {
+  return const_iterator(vector_, index_ + n);
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator
+SegmentedVector<T, segment_size>::const_iterator::operator-(
+    difference_type const n) const {
+  return const_iterator(vector_, index_ - n);
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator::difference_type
+SegmentedVector<T, segment_size>::const_iterator::operator-(
+    const_iterator const& right) const {
+  DCHECK_EQ(vector_, right.vector_);
+  return index_ - right.index_;
+}
+
+template<typename T, std::int64_t segment_size>
+bool SegmentedVector<T, segment_size>::const_iterator::operator==(
+    const_iterator const& right) const {
+  DCHECK_EQ(vector_, right.vector_);
+  return index_ == right.index_;
+}
+
+template<typename T, std::int64_t segment_size>
+bool SegmentedVector<T, segment_size>::const_iterator::operator!=(
+    const_iterator const& right) const {
+  return !(*this == right);
+}
+
+template<typename T, std::int64_t segment_size>
+bool SegmentedVector<T, segment_size>::const_iterator::operator<(
+    const_iterator const& right) const {
+  DCHECK_EQ(vector_, right.vector_);
+  return index_ < right.index_;
+}
+
+template<typename T, std::int64_t segment_size>
+bool SegmentedVector<T, segment_size>::const_iterator::operator>(
+    const_iterator const& right) const {
+  return right < *this;
+}
+
+template<typename T, std::int64_t segment_size>
+bool SegmentedVector<T, segment_size>::const_iterator::operator<=(
+    const_iterator const& right) const {
+  return !(right < *this);
+}
+
+template<typename T, std::int64_t segment_size>
+bool SegmentedVector<T, segment_size>::const_iterator::operator>=(
+    const_iterator const& right) const {
+  return !(*this < right);
+}
+
+template<typename T, std::int64_t segment_size>
+SegmentedVector<T, segment_size>::const_iterator::const_iterator(
+    SegmentedVector const* const vector,
+    std::int64_t const index)
+    : vector_(vector),
+      index_(index) {}
+
+template<typename T, std::int64_t segment_size>
+SegmentedVector<T, segment_size>::~SegmentedVector() {
+  std::int64_t const size = size_.load(std::memory_order_relaxed);
+  for (std::int64_t position = first_; position < first_ + size; ++position) {
+    slot_address(position)->~T();
+  }
+  if (!directories_.empty()) {
+    for (Segment* const segment : *directories_.back()) {
+      delete segment;
+    }
+  }
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator
+SegmentedVector<T, segment_size>::begin() const {
+  return const_iterator(this, 0);
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator
+SegmentedVector<T, segment_size>::end() const {
+  return const_iterator(this, size());
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator
+SegmentedVector<T, segment_size>::cbegin() const {
+  return begin();
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::const_iterator
+SegmentedVector<T, segment_size>::cend() const {
+  return end();
+}
+
+template<typename T, std::int64_t segment_size>
+bool SegmentedVector<T, segment_size>::empty() const {
+  return size() == 0;
+}
+
+template<typename T, std::int64_t segment_size>
+typename SegmentedVector<T, segment_size>::size_type
+SegmentedVector<T, segment_size>::size() const {
+  // Synchronizes with the release in |emplace_back|, so that the elements
+  // before the returned size are visible.
+  return size_.load(std::memory_order_acquire);
+}
+
+template<typename T, std::int64_t segment_size>
+T const& SegmentedVector<T, segment_size>::operator[](
+    size_type const index) const {
+  DCHECK_LE(0, index);
+  DCHECK_LT(index, size());
+  return *slot_address(first_ + index);
+}
+
+template<typename T, std::int64_t segment_size>
+T const& SegmentedVector<T, segment_size>::front() const {
+  return (*this)[0];
+}
+
+template<typename T, std::int64_t segment_size>
+T const& SegmentedVector<T, segment_size>::back() const {
+  return (*this)[size() - 1];
+}
+
+template<typename T, std::int64_t segment_size>
+template<typename... Args>
+void SegmentedVector<T, segment_size>::emplace_back(Args&&... args) {
+  // Only this thread modifies the size and the directory, so relaxed loads are
+  // sufficient.
+  std::int64_t const size = size_.load(std::memory_order_relaxed);
+  std::int64_t const position = first_ + size;
+  std::int64_t const s = position / segment_size;
+  Directory* directory = directory_.load(std::memory_order_relaxed);
+  if (directory == nullptr ||
+      s == static_cast<std::int64_t>(directory->size())) {
+    // The directory is full.  Readers may be using it, so we publish a larger
+    // copy and keep the old one until we have exclusive access.
+    auto larger_directory = std::make_unique<Directory>(
+        directory == nullptr ? 1 : 2 * directory->size(), nullptr);
+    if (directory != nullptr) {
+      std::copy(directory->begin(), directory->end(),
+                larger_directory->begin());
+    }
+    directory = larger_directory.get();
+    directories_.push_back(std::move(larger_directory));
+    directory_.store(directory, std::memory_order_release);
+  }
+  // No reader accesses this entry before the size is published below.
+  Segment*& segment = (*directory)[s];
+  if (segment == nullptr) {
+    segment = new Segment;
+    ++number_of_segments_;
+  }
+  new (&segment->slots[position % segment_size])
+      T(std::forward<Args>(args)...);
+  size_.store(size + 1, std::memory_order_release);
+}
+
+template<typename T, std::int64_t segment_size>
+void SegmentedVector<T, segment_size>::pop_front() {
+  std::int64_t const size = size_.load(std::memory_order_relaxed);
+  CHECK_LT(0, size);
+  slot_address(first_)->~T();
+  ++first_;
+  size_.store(size - 1, std::memory_order_relaxed);
+  FreeSupersededDirectories();
+  if (first_ == segment_size) {
+    // The first segment is empty, free it and shift the others.
+    Directory& directory = *directories_.back();
+    delete directory.front();
+    --number_of_segments_;
+    std::move(directory.begin() + 1, directory.end(), directory.begin());
+    directory.back() = nullptr;
+    first_ = 0;
+  }
+}
+
+template<typename T, std::int64_t segment_size>
+void SegmentedVector<T, segment_size>::pop_back() {
+  std::int64_t const size = size_.load(std::memory_order_relaxed);
+  CHECK_LT(0, size);
+  std::int64_t const position = first_ + size - 1;
+  slot_address(position)->~T();
+  size_.store(size - 1, std::memory_order_relaxed);
+  FreeSupersededDirectories();
+  if (position % segment_size == 0) {
+    // The last segment is empty, free it.
+    Segment*& segment = (*directories_.back())[position / segment_size];
+    delete segment;
+    segment = nullptr;
+    --number_of_segments_;
+  }
+}
+
+template<typename T, std::int64_t segment_size>
+std::int64_t SegmentedVector<T, segment_size>::memory_footprint() const {
+  std::int64_t footprint = number_of_segments_ * sizeof(Segment);
+  for (auto const& directory : directories_) {
+    footprint += directory->capacity() * sizeof(Segment*);
+  }
+  return footprint;
+}
+
+template<typename T, std::int64_t segment_size>
+T* SegmentedVector<T, segment_size>::slot_address(
+    std::int64_t const position) const {
+  // Synchronizes with the release in |emplace_back|, so that the readers see
+  // a directory that contains the segment of |position|.
+  Directory const& directory = *directory_.load(std::memory_order_acquire);
+  return std::launder(reinterpret_cast<T*>(
+      &directory[position / segment_size]->slots[position % segment_size]));
+}
+
+template<typename T, std::int64_t segment_size>
+void SegmentedVector<T, segment_size>::FreeSupersededDirectories() {
+  if (directories_.size() > 1) {
+    directories_.erase(directories_.begin(), directories_.end() - 1);
+  }
+}
+
+}  // namespace internal_segmented_vector
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,123 @@
+#include "base/segmented_vector.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+class SegmentedVectorTest : public testing::Test {
+ protected:
+  using Vector = SegmentedVector<std::unique_ptr<int>, /*segment_size=*/4>;
+
+  Vector vector_;
+};
+
+TEST_F(SegmentedVectorTest, Empty) {
+  EXPECT_TRUE(vector_.empty());
+  EXPECT_EQ(0, vector_.size());
+  EXPECT_EQ(vector_.begin(), vector_.end());
+  EXPECT_EQ(0, vector_.memory_footprint());
+}
+
+TEST_F(SegmentedVectorTest, EmplaceBack) {
+  for (int i = 0; i < 10; ++i) {
+    vector_.emplace_back(std::make_unique<int>(i));
+  }
+  EXPECT_EQ(10, vector_.size());
+  EXPECT_EQ(0, *vector_.front());
+  EXPECT_EQ(9, *vector_.back());
+  int expected = 0;
+  for (auto const& element : vector_) {
+    EXPECT_EQ(expected, *element);
+    ++expected;
+  }
+  EXPECT_EQ(10, expected);
+  EXPECT_LE(10 * sizeof(std::unique_ptr<int>), vector_.memory_footprint());
+}
+
+TEST_F(SegmentedVectorTest, StableReferences) {
+  vector_.emplace_back(std::make_unique<int>(42));
+  std::unique_ptr<int> const* const first = &vector_.front();
+  for (int i = 0; i < 100; ++i) {
+    vector_.emplace_back(std::make_unique<int>(i));
+  }
+  EXPECT_EQ(first, &vector_.front());
+  EXPECT_EQ(42, **first);
+}
+
+TEST_F(SegmentedVectorTest, RandomAccess) {
+  for (int i = 0; i < 20; ++i) {
+    vector_.emplace_back(std::make_unique<int>(2 * i));
+  }
+  auto const it = std::partition_point(
+      vector_.begin(), vector_.end(), [](auto const& element) {
+        return *element < 15;
+      });
+  EXPECT_EQ(8, it - vector_.begin());
+  EXPECT_EQ(16, **it);
+  EXPECT_EQ(14, *it[-1]);
+  EXPECT_EQ(38, **(vector_.end() - 1));
+}
+
+TEST_F(SegmentedVectorTest, Pop) {
+  for (int i = 0; i < 100; ++i) {
+    vector_.emplace_back(std::make_unique<int>(i));
+  }
+  for (int i = 0; i < 90; ++i) {
+    vector_.pop_front();
+  }
+  EXPECT_EQ(10, vector_.size());
+  EXPECT_EQ(90, *vector_.front());
+  EXPECT_EQ(95, *vector_[5]);
+
+  // Replace the last element.
+  vector_.pop_back();
+  vector_.emplace_back(std::make_unique<int>(1000));
+  EXPECT_EQ(1000, *vector_.back());
+
+  // Empty the vector and reuse it.
+  for (int i = 0; i < 10; ++i) {
+    vector_.pop_back();
+  }
+  EXPECT_TRUE(vector_.empty());
+  vector_.emplace_back(std::make_unique<int>(7));
+  EXPECT_EQ(7, *vector_.front());
+}
+
+// The readers check the elements while the writer appends them.
+TEST(SegmentedVectorConcurrencyTest, ConcurrentReaders) {
+  constexpr std::int64_t size = 100'000;
+  SegmentedVector<std::int64_t, /*segment_size=*/16> vector;
+  std::thread writer([&vector]() {
+    for (std::int64_t i = 0; i < size; ++i) {
+      vector.emplace_back(i);
+    }
+  });
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r) {
+    readers.emplace_back([&vector]() {
+      while (vector.size() < size) {
+        auto const end = vector.end();
+        auto const begin = end - std::min<std::int64_t>(end - vector.begin(),
+                                                        100);
+        for (auto it = begin; it != end; ++it) {
+          ASSERT_EQ(it - vector.begin(), *it);
+        }
+      }
+    });
+  }
+  writer.join();
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(size - 1, vector.back());
+}
+
+}  // namespace base
+}  // namespace principia
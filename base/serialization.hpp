@@ -1,7 +1,8 @@
 #pragma once
 
 #include "base/array.hpp"
-
+#include "base/not_null.hpp"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/message_lite.h"
 
 namespace principia {
@@ -13,6 +14,12 @@ inline UniqueArray<std::uint8_t> SerializeAsBytes(
 template<typename Message>
 Message ParseFromBytes(Array<std::uint8_t const> bytes);
 
+// Same as above, but the message and its submessages are allocated on |arena|,
+// which owns them.
+template<typename Message>
+not_null<Message*> ParseFromBytes(Array<std::uint8_t const> bytes,
+                                  not_null<google::protobuf::Arena*> arena);
+
 }  // namespace base
 }  // namespace principia
 
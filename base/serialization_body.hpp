@@ -20,5 +20,15 @@ Message ParseFromBytes(Array<std::uint8_t const> bytes) {
   return message;
 }
 
+template<typename Message>
+not_null<Message*> ParseFromBytes(
+    Array<std::uint8_t const> const bytes,
+    not_null<google::protobuf::Arena*> const arena) {
+  not_null<Message*> const message =
+      google::protobuf::Arena::CreateMessage<Message>(arena);
+  CHECK(message->ParseFromArray(bytes.data, bytes.size));
+  return message;
+}
+
 }  // namespace base
 }  // namespace principia
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "base/macros.hpp"
+#include "base/shared_lock_guard.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_sharded_shared_mutex {
+
+// A reader-writer mutex for data that is read very often, on many threads, and
+// rarely written.  With a single |shared_mutex|, each shared locking writes to
+// the cache line of the mutex, which then bounces between the cores of the
+// readers.  Here the mutex is split in |slots| slots, each in its own cache
+// line, and a thread always takes shared locks on the same slot, so readers on
+// different threads (mostly) don't touch the same cache line.  An exclusive
+// lock locks all the slots, so writers are slower.
+// This class meets the requirements of SharedMutex, and may be used with
+// |shared_lock_guard| and |std::lock_guard|.
+class CAPABILITY("mutex") ShardedSharedMutex final {
+ public:
+  static constexpr std::size_t slots = 16;
+
+  ShardedSharedMutex() = default;
+  ShardedSharedMutex(ShardedSharedMutex const&) = delete;
+  ShardedSharedMutex& operator=(ShardedSharedMutex const&) = delete;
+
+  void lock();
+  void unlock();
+
+#if HAS_SHARED_MUTEX
+  void lock_shared();
+  void unlock_shared();
+#endif
+
+ private:
+  // The size of a cache line on the processors that we care about.
+  struct alignas(64) Slot {
+    shared_mutex mutex;
+  };
+
+  // The slot used by the current thread.  Threads are assigned slots in a
+  // round-robin manner the first time that they call this function.
+  Slot& ThisThreadSlot();
+
+  std::array<Slot, slots> slots_;
+};
+
+}  // namespace internal_sharded_shared_mutex
+
+using internal_sharded_shared_mutex::ShardedSharedMutex;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/sharded_shared_mutex_body.hpp"
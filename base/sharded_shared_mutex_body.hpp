@@ -0,0 +1,47 @@
+#pragma once
+
+#include "base/sharded_shared_mutex.hpp"
+
+#include <atomic>
+
+namespace principia {
+namespace base {
+namespace internal_sharded_shared_mutex {
+
+inline void ShardedSharedMutex::lock() {
+  // Always lock in the same order to avoid deadlocks between writers.
+  for (auto& slot : slots_) {
+    slot.mutex.lock();
+  }
+}
+
+inline void ShardedSharedMutex::unlock() {
+  for (auto it = slots_.rbegin(); it != slots_.rend(); ++it) {
+    it->mutex.unlock();
+  }
+}
+
+#if HAS_SHARED_MUTEX
+
+inline void ShardedSharedMutex::lock_shared() {
+  ThisThreadSlot().mutex.lock_shared();
+}
+
+inline void ShardedSharedMutex::unlock_shared() {
+  ThisThreadSlot().mutex.unlock_shared();
+}
+
+#endif
+
+inline ShardedSharedMutex::Slot& ShardedSharedMutex::ThisThreadSlot() {
+  static std::atomic<std::size_t> next_index{0};
+  // The index is per thread, not per mutex, so that a thread finds its slot
+  // without touching any shared state.
+  thread_local std::size_t const index =
+      next_index.fetch_add(1, std::memory_order_relaxed) % slots;
+  return slots_[index];
+}
+
+}  // namespace internal_sharded_shared_mutex
+}  // namespace base
+}  // namespace principia
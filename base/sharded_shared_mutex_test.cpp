@@ -0,0 +1,76 @@
+#include "base/sharded_shared_mutex.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+#if HAS_SHARED_MUTEX
+
+TEST(ShardedSharedMutexTest, ConcurrentReaders) {
+  ShardedSharedMutex mutex;
+  std::atomic<int> readers{0};
+  std::atomic<int> max_readers{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&mutex, &readers, &max_readers]() {
+      shared_lock_guard<ShardedSharedMutex> l(mutex);
+      int const current = ++readers;
+      int max = max_readers;
+      while (current > max &&
+             !max_readers.compare_exchange_weak(max, current)) {}
+      // Wait until all the readers hold the mutex, which would deadlock if
+      // they excluded each other.
+      while (readers < 4) {}
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(4, max_readers);
+}
+
+#endif
+
+TEST(ShardedSharedMutexTest, WritersExcludeReaders) {
+  ShardedSharedMutex mutex;
+  // Two values that the writers keep equal.
+  std::int64_t a = 0;
+  std::int64_t b = 0;
+  std::atomic<bool> torn{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&mutex, &a, &b, &torn]() {
+      for (int j = 0; j < 10'000; ++j) {
+        shared_lock_guard<ShardedSharedMutex> l(mutex);
+        if (a != b) {
+          torn = true;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([&mutex, &a, &b]() {
+      for (int j = 0; j < 1'000; ++j) {
+        std::lock_guard<ShardedSharedMutex> l(mutex);
+        ++a;
+        ++b;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(torn);
+  EXPECT_EQ(2'000, a);
+  EXPECT_EQ(2'000, b);
+}
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "base/array.hpp"
+#include "base/not_null.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_snapshot {
+
+// Helpers for reading and writing flat binary snapshots, i.e., images of an
+// object that may be used without parsing, for instance from a memory-mapped
+// file.  The values are stored in native byte order and without padding.  The
+// reader copies the values out of the bytes, so the bytes need not be aligned.
+// The clients are responsible for versioning their snapshots.
+
+class SnapshotWriter final {
+ public:
+  // The data is appended to |bytes|.
+  explicit SnapshotWriter(not_null<std::vector<std::uint8_t>*> bytes);
+
+  template<typename T>
+  void Write(T const& value);
+  void WriteBytes(Array<std::uint8_t const> bytes);
+
+  // Overwrites a value previously written at |offset|, e.g., a size that was
+  // not known when the value was written.
+  template<typename T>
+  void WriteAt(std::int64_t offset, T const& value);
+
+  // The offset at which the next value will be written.
+  std::int64_t offset() const;
+
+ private:
+  not_null<std::vector<std::uint8_t>*> const bytes_;
+};
+
+class SnapshotReader final {
+ public:
+  explicit SnapshotReader(Array<std::uint8_t const> bytes);
+
+  // Fails if there are not enough bytes left.
+  template<typename T>
+  T Read();
+  Array<std::uint8_t const> ReadBytes(std::int64_t size);
+
+  // The number of bytes that have not been read yet.
+  std::int64_t remaining() const;
+
+ private:
+  Array<std::uint8_t const> bytes_;
+  std::int64_t offset_ = 0;
+};
+
+}  // namespace internal_snapshot
+
+using internal_snapshot::SnapshotReader;
+using internal_snapshot::SnapshotWriter;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/snapshot_body.hpp"
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "base/snapshot.hpp"
+
+#include <cstring>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_snapshot {
+
+inline SnapshotWriter::SnapshotWriter(
+    not_null<std::vector<std::uint8_t>*> const bytes)
+    : bytes_(bytes) {}
+
+template<typename T>
+void SnapshotWriter::Write(T const& value) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values may be snapshotted");
+  auto const* const value_bytes =
+      reinterpret_cast<std::uint8_t const*>(&value);
+  bytes_->insert(bytes_->end(), value_bytes, value_bytes + sizeof(T));
+}
+
+inline void SnapshotWriter::WriteBytes(Array<std::uint8_t const> const bytes) {
+  bytes_->insert(bytes_->end(), bytes.data, bytes.data + bytes.size);
+}
+
+template<typename T>
+void SnapshotWriter::WriteAt(std::int64_t const offset, T const& value) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values may be snapshotted");
+  CHECK_LE(0, offset);
+  CHECK_LE(offset + static_cast<std::int64_t>(sizeof(T)), this->offset());
+  std::memcpy(bytes_->data() + offset, &value, sizeof(T));
+}
+
+inline std::int64_t SnapshotWriter::offset() const {
+  return bytes_->size();
+}
+
+inline SnapshotReader::SnapshotReader(Array<std::uint8_t const> const bytes)
+    : bytes_(bytes) {}
+
+template<typename T>
+T SnapshotReader::Read() {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values may be snapshotted");
+  CHECK_LE(static_cast<std::int64_t>(sizeof(T)), remaining())
+      << "Truncated snapshot";
+  T value;
+  std::memcpy(&value, bytes_.data + offset_, sizeof(T));
+  offset_ += sizeof(T);
+  return value;
+}
+
+inline Array<std::uint8_t const> SnapshotReader::ReadBytes(
+    std::int64_t const size) {
+  CHECK_LE(0, size);
+  CHECK_LE(size, remaining()) << "Truncated snapshot";
+  Array<std::uint8_t const> const bytes(bytes_.data + offset_, size);
+  offset_ += size;
+  return bytes;
+}
+
+inline std::int64_t SnapshotReader::remaining() const {
+  return bytes_.size - offset_;
+}
+
+}  // namespace internal_snapshot
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,40 @@
+#include "base/snapshot.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+using ::testing::ElementsAre;
+
+namespace principia {
+namespace base {
+
+TEST(SnapshotTest, RoundTrip) {
+  std::vector<std::uint8_t> bytes;
+  SnapshotWriter writer(&bytes);
+  writer.Write<std::uint8_t>(7);
+  EXPECT_EQ(1, writer.offset());
+  writer.Write<std::int64_t>(0);
+  writer.Write(3.5);
+  std::uint8_t const raw[] = {1, 2, 3};
+  writer.WriteBytes(Array<std::uint8_t const>(raw, 3));
+  writer.WriteAt<std::int64_t>(1, -42);
+  EXPECT_EQ(1 + 8 + 8 + 3, writer.offset());
+
+  // The values are not aligned in |bytes|.
+  SnapshotReader reader(Array<std::uint8_t const>(bytes.data(), bytes.size()));
+  EXPECT_EQ(7, reader.Read<std::uint8_t>());
+  EXPECT_EQ(-42, reader.Read<std::int64_t>());
+  EXPECT_EQ(3.5, reader.Read<double>());
+  EXPECT_EQ(3, reader.remaining());
+  auto const read_raw = reader.ReadBytes(3);
+  EXPECT_THAT(std::vector<std::uint8_t>(read_raw.data,
+                                        read_raw.data + read_raw.size),
+              ElementsAre(1, 2, 3));
+  EXPECT_EQ(0, reader.remaining());
+}
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,111 @@
+﻿
+#include "base/thread_configuration.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <mutex>
+
+#include "glog/logging.h"
+
+#if OS_WIN
+#define NOGDI
+#define NOMINMAX
+#include <windows.h>
+#elif OS_MACOSX
+#include <pthread.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace principia {
+namespace base {
+namespace internal_thread_configuration {
+
+namespace {
+
+std::mutex lock;
+ThreadConfiguration configuration GUARDED_BY(lock);
+
+}  // namespace
+
+ThreadConfiguration GetThreadConfiguration() {
+  std::lock_guard<std::mutex> l(lock);
+  return configuration;
+}
+
+void SetThreadConfiguration(ThreadConfiguration const& new_configuration) {
+  std::lock_guard<std::mutex> l(lock);
+  configuration = new_configuration;
+}
+
+std::int64_t ConfiguredPoolSize(std::int64_t const pool_size) {
+  ThreadConfiguration const current = GetThreadConfiguration();
+  return current.max_pool_size > 0
+             ? std::min(pool_size, current.max_pool_size)
+             : pool_size;
+}
+
+void ConfigureCurrentThread() {
+  ThreadConfiguration const current = GetThreadConfiguration();
+#if OS_WIN
+  if (current.low_priority &&
+      !SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL)) {
+    LOG(WARNING) << "SetThreadPriority failed: " << GetLastError();
+  }
+  if (current.reserved_cores_mask != 0) {
+    DWORD_PTR process_mask;
+    DWORD_PTR system_mask;
+    if (!GetProcessAffinityMask(
+            GetCurrentProcess(), &process_mask, &system_mask)) {
+      LOG(WARNING) << "GetProcessAffinityMask failed: " << GetLastError();
+      return;
+    }
+    DWORD_PTR const thread_mask =
+        process_mask & ~static_cast<DWORD_PTR>(current.reserved_cores_mask);
+    if (thread_mask == 0) {
+      LOG(WARNING) << "All the cores are reserved";
+    } else if (!SetThreadAffinityMask(GetCurrentThread(), thread_mask)) {
+      LOG(WARNING) << "SetThreadAffinityMask failed: " << GetLastError();
+    }
+  }
+#elif OS_MACOSX
+  if (current.low_priority &&
+      pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0) != 0) {
+    LOG(WARNING) << "pthread_set_qos_class_self_np failed";
+  }
+#else
+  // On Linux the nice value is per-thread, and |setpriority| with a thread id
+  // only affects that thread.
+  if (current.low_priority &&
+      setpriority(PRIO_PROCESS, syscall(SYS_gettid), /*prio=*/10) != 0) {
+    LOG(WARNING) << "setpriority failed: " << errno;
+  }
+  if (current.reserved_cores_mask != 0) {
+    cpu_set_t cpu_set;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) !=
+        0) {
+      LOG(WARNING) << "pthread_getaffinity_np failed";
+      return;
+    }
+    for (int core = 0; core < 64; ++core) {
+      if (current.reserved_cores_mask & (std::uint64_t{1} << core)) {
+        CPU_CLR(core, &cpu_set);
+      }
+    }
+    if (CPU_COUNT(&cpu_set) == 0) {
+      LOG(WARNING) << "All the cores are reserved";
+    } else if (pthread_setaffinity_np(
+                   pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+      LOG(WARNING) << "pthread_setaffinity_np failed";
+    }
+  }
+#endif
+}
+
+}  // namespace internal_thread_configuration
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,49 @@
+﻿
+#pragma once
+
+#include <cstdint>
+
+#include "base/macros.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_thread_configuration {
+
+// How the threads that run background computations are scheduled, so that they
+// don't compete with the main and render threads of the game.  The default
+// configuration leaves the threads alone.
+struct ThreadConfiguration final {
+  // If positive, the maximum number of threads of the pools whose size is
+  // computed from the number of cores.
+  std::int64_t max_pool_size = 0;
+  // If true, the threads run at a priority below normal.
+  bool low_priority = false;
+  // Bit i is set if the threads must not run on core i.  Ignored on macOS,
+  // which doesn't support affinity, and if it would exclude all the cores on
+  // which the process may run.
+  std::uint64_t reserved_cores_mask = 0;
+};
+
+// The process-wide configuration.  Changing it only affects the threads
+// started afterwards.  These functions are thread-safe.
+PHYSICS_DLL ThreadConfiguration GetThreadConfiguration();
+PHYSICS_DLL void SetThreadConfiguration(
+    ThreadConfiguration const& configuration);
+
+// Returns |pool_size| capped by the configuration.
+PHYSICS_DLL std::int64_t ConfiguredPoolSize(std::int64_t pool_size);
+
+// Applies the configuration to the calling thread; must be called at the
+// beginning of each background thread.  Failures are logged, not fatal.
+PHYSICS_DLL void ConfigureCurrentThread();
+
+}  // namespace internal_thread_configuration
+
+using internal_thread_configuration::ConfigureCurrentThread;
+using internal_thread_configuration::ConfiguredPoolSize;
+using internal_thread_configuration::GetThreadConfiguration;
+using internal_thread_configuration::SetThreadConfiguration;
+using internal_thread_configuration::ThreadConfiguration;
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,80 @@
+﻿
+#include "base/thread_configuration.hpp"
+
+#include <thread>
+
+#include "base/macros.hpp"
+#include "base/work_stealing_scheduler.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#if OS_LINUX
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace principia {
+namespace base {
+
+using ::testing::Eq;
+
+class ThreadConfigurationTest : public ::testing::Test {
+ protected:
+  ~ThreadConfigurationTest() override {
+    SetThreadConfiguration(ThreadConfiguration());
+  }
+};
+
+TEST_F(ThreadConfigurationTest, PoolSize) {
+  EXPECT_THAT(ConfiguredPoolSize(8), Eq(8));
+  ThreadConfiguration configuration;
+  configuration.max_pool_size = 3;
+  SetThreadConfiguration(configuration);
+  EXPECT_THAT(GetThreadConfiguration().max_pool_size, Eq(3));
+  EXPECT_THAT(ConfiguredPoolSize(8), Eq(3));
+  EXPECT_THAT(ConfiguredPoolSize(2), Eq(2));
+}
+
+TEST_F(ThreadConfigurationTest, Scheduler) {
+  ThreadConfiguration configuration;
+  configuration.low_priority = true;
+  // Reserving all the cores is ignored.
+  configuration.reserved_cores_mask = ~std::uint64_t{0};
+  SetThreadConfiguration(configuration);
+  WorkStealingScheduler scheduler(/*pool_size=*/2);
+  auto future = scheduler.Add([]() {
+#if OS_LINUX
+    return getpriority(PRIO_PROCESS, syscall(SYS_gettid));
+#else
+    return 10;
+#endif
+  });
+  EXPECT_THAT(future.get(), Eq(10));
+#if OS_LINUX
+  // The threads started before the configuration changed are not affected.
+  EXPECT_THAT(getpriority(PRIO_PROCESS, syscall(SYS_gettid)), Eq(0));
+#endif
+}
+
+#if OS_LINUX
+TEST_F(ThreadConfigurationTest, Affinity) {
+  if (std::thread::hardware_concurrency() < 2) {
+    GTEST_SKIP() << "Needs at least two cores";
+  }
+  ThreadConfiguration configuration;
+  configuration.reserved_cores_mask = 1;
+  SetThreadConfiguration(configuration);
+  WorkStealingScheduler scheduler(/*pool_size=*/1);
+  auto future = scheduler.Add([]() {
+    cpu_set_t cpu_set;
+    CHECK_EQ(0, sched_getaffinity(0, sizeof(cpu_set), &cpu_set));
+    return CPU_ISSET(0, &cpu_set) != 0;
+  });
+  EXPECT_FALSE(future.get());
+}
+#endif
+
+}  // namespace base
+}  // namespace principia
@@ -1,49 +1,40 @@
 #pragma once
 
-#include <condition_variable>
-#include <deque>
-#include <functional>
-#include <future>
-#include <list>
-#include <mutex>
-#include <thread>
+#include <cstdint>
+#include <memory>
+
+#include "base/not_null.hpp"
+#include "base/work_stealing_scheduler.hpp"
 
 namespace principia {
 namespace base {
 
-// A pool of threads that are created at construction and to which functions can
-// be added for asynchronous execution.  This class is thread-safe.
+// A pool of threads to which functions returning a |T| can be added for
+// asynchronous execution.  The functions are executed by a
+// |WorkStealingScheduler| which is either owned by the pool or shared with
+// other clients.  This class is thread-safe.
 template<typename T>
 class ThreadPool final {
  public:
-  // Constructs a pool with the given number of threads.
+  // Constructs a pool with its own scheduler having the given number of
+  // threads.
   explicit ThreadPool(std::int64_t pool_size);
 
-  ~ThreadPool();
+  // Constructs a pool that executes its functions on |scheduler|, which must
+  // outlive the pool.
+  explicit ThreadPool(not_null<WorkStealingScheduler*> scheduler);
 
   // Adds a call to the execution queue, and returns a future that the client
   // may use to wait until execution of |function| has completed and to extract
   // the result.
-  std::future<T> Add(std::function<T()> function);
+  template<typename Function>
+  Future<T> Add(Function&& function);
+
+  not_null<WorkStealingScheduler*> scheduler() const;
 
  private:
-  // The queue element contains a |function| to execute and a |promise| used to
-  // communicate the result to the caller.
-  struct Call {
-    std::function<T()> function;
-    std::promise<T> promise;
-  };
-
-  // The loop executed on each thread to extract an element from the queue,
-  // execute it, and set its result in the promise.
-  void DequeueCallAndExecute();
-
-  std::mutex lock_;
-  bool shutdown_ = false;
-  std::deque<Call> calls_;
-  std::condition_variable has_calls_or_shutdown_;
-
-  std::list<std::thread> threads_;
+  std::unique_ptr<WorkStealingScheduler> const owned_scheduler_;
+  not_null<WorkStealingScheduler*> const scheduler_;
 };
 
 }  // namespace base
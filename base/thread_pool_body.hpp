@@ -3,83 +3,32 @@
 
 #include "base/thread_pool.hpp"
 
+#include <type_traits>
+#include <utility>
+
 namespace principia {
 namespace base {
-namespace internal_thread_pool {
 
-// A helper function that is specialized for void because void is not really a
-// type.
 template<typename T>
-void ExecuteAndSetValue(std::function<T()> const& function,
-                        std::promise<T>& promise) {
-  promise.set_value(function());
-}
-
-template<>
-inline void ExecuteAndSetValue<void>(std::function<void()> const& function,
-                                     std::promise<void>& promise) {
-  function();
-  promise.set_value();
-}
-
-}  // namespace internal_thread_pool
+ThreadPool<T>::ThreadPool(std::int64_t const pool_size)
+    : owned_scheduler_(std::make_unique<WorkStealingScheduler>(pool_size)),
+      scheduler_(owned_scheduler_.get()) {}
 
 template<typename T>
-ThreadPool<T>::ThreadPool(std::int64_t const pool_size) {
-  for (std::int64_t i = 0; i < pool_size; ++i) {
-    threads_.emplace_back(std::bind(&ThreadPool::DequeueCallAndExecute, this));
-  }
-}
+ThreadPool<T>::ThreadPool(not_null<WorkStealingScheduler*> const scheduler)
+    : scheduler_(scheduler) {}
 
 template<typename T>
-ThreadPool<T>::~ThreadPool() {
-  {
-    std::lock_guard<std::mutex> l(lock_);
-    shutdown_ = true;
-  }
-  has_calls_or_shutdown_.notify_all();
-  for (auto& thread : threads_) {
-    thread.join();
-  }
+template<typename Function>
+Future<T> ThreadPool<T>::Add(Function&& function) {
+  static_assert(std::is_same_v<std::invoke_result_t<Function>, T>,
+                "The function must return the type of the pool");
+  return scheduler_->Add(std::forward<Function>(function));
 }
 
 template<typename T>
-std::future<T> ThreadPool<T>::Add(std::function<T()> function) {
-  std::future<T> result;
-  {
-    std::lock_guard<std::mutex> l(lock_);
-    calls_.push_back({std::move(function), std::promise<T>()});
-    result = calls_.back().promise.get_future();
-  }
-  has_calls_or_shutdown_.notify_one();
-  return result;
-}
-
-template<typename T>
-void ThreadPool<T>::DequeueCallAndExecute() {
-  for (;;) {
-    Call this_call;
-
-    // Wait until either the queue contains an element or this class is shutting
-    // down.
-    {
-      std::unique_lock<std::mutex> l(lock_);
-      has_calls_or_shutdown_.wait(l,
-                                  [this] {
-                                      return shutdown_ || !calls_.empty();
-                                  });
-      if (shutdown_) {
-        break;
-      }
-      this_call = std::move(calls_.front());
-      calls_.pop_front();
-    }
-
-    // Execute the function without holding the |lock_| as it might take some
-    // time.
-    internal_thread_pool::ExecuteAndSetValue(this_call.function,
-                                             this_call.promise);
-  }
+not_null<WorkStealingScheduler*> ThreadPool<T>::scheduler() const {
+  return scheduler_;
 }
 
 }  // namespace base
@@ -1,6 +1,7 @@
 
 #include "base/thread_pool.hpp"
 
+#include <atomic>
 #include <vector>
 
 #include "glog/logging.h"
@@ -25,7 +26,7 @@ TEST_F(ThreadPoolTest, ParallelExecution) {
 
   std::mutex lock;
   std::vector<std::int64_t> numbers;
-  std::vector<std::future<void>> futures;
+  std::vector<Future<void>> futures;
   for (std::int64_t i = 0; i < number_of_calls; ++i) {
     futures.push_back(pool_.Add([i, &lock, &numbers]() {
       std::lock_guard<std::mutex> l(lock);
@@ -46,5 +47,21 @@ TEST_F(ThreadPoolTest, ParallelExecution) {
   EXPECT_FALSE(monotonically_increasing);
 }
 
+// Check that pools of different types may share a scheduler.
+TEST_F(ThreadPoolTest, SharedScheduler) {
+  WorkStealingScheduler scheduler(/*pool_size=*/2);
+  ThreadPool<int> int_pool(&scheduler);
+  ThreadPool<void> void_pool(&scheduler);
+  EXPECT_EQ(&scheduler, int_pool.scheduler());
+  EXPECT_EQ(&scheduler, void_pool.scheduler());
+
+  std::atomic<int> count = 0;
+  auto f1 = int_pool.Add([]() { return 1; });
+  auto f2 = void_pool.Add([&count]() { ++count; });
+  f2.wait();
+  EXPECT_EQ(1, f1.get());
+  EXPECT_EQ(1, count);
+}
+
 }  // namespace base
 }  // namespace principia
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "base/macros.hpp"
+#include "base/not_null.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_work_stealing_scheduler {
+
+class WorkStealingScheduler;
+
+// A move-only, type-erased, nullary callable.  Callables whose size and
+// alignment fit in |inline_size| bytes are stored inline, so that constructing,
+// queuing and executing a |Task| doesn't allocate.  Larger callables are stored
+// on the heap.
+class Task final {
+ public:
+  static constexpr std::size_t inline_size = 8 * sizeof(void*);
+
+  Task() = default;
+  template<typename Callable,
+           typename = std::enable_if_t<
+               !std::is_same_v<std::decay_t<Callable>, Task>>>
+  explicit Task(Callable&& callable);
+
+  Task(Task&& other);
+  Task& operator=(Task&& other);
+  ~Task();
+
+  explicit operator bool() const;
+
+  // Executes the callable.  A |Task| should be executed at most once.
+  void operator()();
+
+ private:
+  struct Operations {
+    void (*invoke)(void* storage);
+    // Move-constructs the callable at |to| and destroys the one at |from|.
+    void (*relocate)(void* from, void* to);
+    void (*destroy)(void* storage);
+  };
+
+  template<typename Callable>
+  static constexpr bool is_stored_inline =
+      sizeof(Callable) <= inline_size &&
+      alignof(Callable) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<Callable>;
+
+  template<typename Callable>
+  static Operations const inline_operations_;
+  template<typename Callable>
+  static Operations const heap_operations_;
+
+  alignas(std::max_align_t) unsigned char storage_[inline_size];
+  Operations const* operations_ = nullptr;
+};
+
+// A placeholder for the value of a |SharedState<void>|.
+struct Void final {};
+
+// The state shared between a |Future| and the task that produces its result.
+template<typename T>
+class SharedState final {
+ public:
+  explicit SharedState(not_null<WorkStealingScheduler*> scheduler);
+
+  not_null<WorkStealingScheduler*> scheduler() const;
+
+  // Executes |callable| and publishes its result.  Any continuations are handed
+  // over to the scheduler.
+  template<typename Callable>
+  void Fulfil(Callable& callable);
+
+  bool ready() const;
+  void Wait() const;
+
+  // Returns the result, which must be ready.  May only be called once.
+  T Take();
+
+  // Schedules |continuation| once the result is ready, or immediately if it
+  // already is.
+  void AddContinuation(Task continuation);
+
+ private:
+  using Value = std::conditional_t<std::is_void_v<T>, Void, T>;
+
+  not_null<WorkStealingScheduler*> const scheduler_;
+
+  mutable std::mutex lock_;
+  mutable std::condition_variable ready_;
+  std::optional<Value> value_ GUARDED_BY(lock_);
+  std::vector<Task> continuations_ GUARDED_BY(lock_);
+};
+
+template<typename T>
+class Future;
+
+// The type of the future returned by |Future<T>::Then(continuation)|.
+template<typename T, typename Continuation>
+struct ContinuationResultGenerator {
+  using Type = std::invoke_result_t<Continuation, T>;
+};
+
+template<typename Continuation>
+struct ContinuationResultGenerator<void, Continuation> {
+  using Type = std::invoke_result_t<Continuation>;
+};
+
+// A handle on the result of a task executed by a |WorkStealingScheduler|.  Its
+// interface is a subset of that of |std::future|, with the addition that
+// continuations may be attached to it.
+template<typename T>
+class Future final {
+ public:
+  Future() = default;
+
+  Future(Future&&) = default;
+  Future& operator=(Future&&) = default;
+
+  bool valid() const;
+  bool is_ready() const;
+
+  // Blocks until the result is available.  When called on a worker thread of
+  // the scheduler, executes other tasks while waiting, so that tasks may wait
+  // on each other without exhausting the pool.
+  void wait() const;
+
+  // Waits until the result is available and returns it.  May only be called
+  // once.
+  T get();
+
+  // Arranges for |continuation| to be executed on the scheduler with the result
+  // of this future when it becomes available.  |*this| becomes invalid.
+  template<typename Continuation>
+  Future<typename ContinuationResultGenerator<T, Continuation>::Type> Then(
+      Continuation&& continuation) &&;
+
+ private:
+  explicit Future(std::shared_ptr<SharedState<T>> state);
+
+  std::shared_ptr<SharedState<T>> state_;
+
+  template<typename U>
+  friend class Future;
+  friend class WorkStealingScheduler;
+};
+
+// A pool of threads, each with its own deque of tasks.  A worker executes the
+// tasks of its own deque in LIFO order and, when it runs out, steals tasks in
+// FIFO order from the other deques, so that a long task does not hold up the
+// ones queued behind it.  Tasks added from outside the pool are distributed
+// round-robin over the deques; tasks (and continuations) added from a worker
+// go to its own deque.  This class is thread-safe and a single instance may be
+// shared by many clients.
+class WorkStealingScheduler final {
+ public:
+  // Constructs a scheduler with the given number of threads, which must be
+  // positive.
+  explicit WorkStealingScheduler(std::int64_t pool_size);
+
+  // Executes all the tasks that are queued (including continuations) and joins
+  // the threads.
+  ~WorkStealingScheduler();
+
+  // Queues |function| for asynchronous execution, and returns a future that
+  // the client may use to wait until execution of |function| has completed
+  // and to extract the result.
+  template<typename Function>
+  Future<std::invoke_result_t<Function>> Add(Function&& function);
+
+  std::int64_t pool_size() const;
+
+  // Blocks until all the tasks added so far, including the continuations and
+  // the tasks that they add, have been executed.  Must not be called from a
+  // worker of this scheduler.
+  void WaitUntilIdle();
+
+  // Cumulative counters describing the behaviour of the scheduler since its
+  // construction, for use by benchmarks.  Clients interested in a particular
+  // phase should take the difference of two snapshots.  The counters are
+  // maintained with relaxed atomics, so a snapshot taken while tasks are
+  // executing may be slightly inconsistent.
+  struct Statistics final {
+    // The number of tasks executed, and how many of them were stolen from the
+    // deque of another worker.
+    std::int64_t executed_tasks = 0;
+    std::int64_t stolen_tasks = 0;
+    // The number of times a thread found a lock of the scheduler held by
+    // another thread and had to block.
+    std::int64_t contended_locks = 0;
+    // The total time that the tasks spent in a deque before starting to
+    // execute, and the total time spent executing them.  The execution of a
+    // task that waits on a future includes that of the tasks that it executes
+    // while waiting.
+    std::chrono::steady_clock::duration queue_wait{};
+    std::chrono::steady_clock::duration busy{};
+  };
+
+  Statistics statistics() const;
+
+ private:
+  struct QueuedTask final {
+    Task task;
+    std::chrono::steady_clock::time_point queued_at;
+  };
+
+  struct Worker final {
+    std::mutex lock;
+    std::deque<QueuedTask> tasks GUARDED_BY(lock);
+  };
+
+  // Locks |mutex|, counting the cases where it is already held.
+  std::unique_lock<std::mutex> CountingLock(std::mutex& mutex);
+
+  void Schedule(Task task);
+
+  // Executes one task, taken from the back of the deque of the worker with the
+  // given |index| or, if it is empty, stolen from the front of another deque.
+  // Returns false if no task was found.
+  bool TryExecuteOneTask(std::int64_t index);
+
+  // The loop executed by the worker with the given |index|.
+  void Work(std::int64_t index);
+
+  // If the current thread is a worker of some scheduler, that scheduler and the
+  // index of the worker.  Null and meaningless, respectively, otherwise.
+  static inline thread_local WorkStealingScheduler* current_scheduler_ =
+      nullptr;
+  static inline thread_local std::int64_t current_worker_ = -1;
+
+  std::vector<not_null<std::unique_ptr<Worker>>> workers_;
+  std::atomic<std::uint64_t> next_worker_ = 0;
+
+  // Incremented under |lock_| to avoid lost wake-ups, decremented without it.
+  std::atomic<std::int64_t> queued_tasks_ = 0;
+  // The tasks that are queued or executing.  Incremented under |lock_|,
+  // decremented without it but |lock_| is taken before notifying |idle_|.
+  std::atomic<std::int64_t> pending_tasks_ = 0;
+  std::mutex lock_;
+  std::condition_variable has_tasks_or_shutdown_;
+  std::condition_variable idle_;
+  bool shutdown_ GUARDED_BY(lock_) = false;
+
+  std::vector<std::thread> threads_;
+
+  std::atomic<std::int64_t> executed_tasks_ = 0;
+  std::atomic<std::int64_t> stolen_tasks_ = 0;
+  std::atomic<std::int64_t> contended_locks_ = 0;
+  std::atomic<std::chrono::steady_clock::rep> queue_wait_ = 0;
+  std::atomic<std::chrono::steady_clock::rep> busy_ = 0;
+
+  template<typename T>
+  friend class SharedState;
+};
+
+}  // namespace internal_work_stealing_scheduler
+
+using internal_work_stealing_scheduler::Future;
+using internal_work_stealing_scheduler::WorkStealingScheduler;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/work_stealing_scheduler_body.hpp"
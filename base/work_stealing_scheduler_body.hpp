@@ -0,0 +1,381 @@
+#pragma once
+
+#include "base/work_stealing_scheduler.hpp"
+
+#include <chrono>
+#include <new>
+#include <utility>
+
+#include "base/thread_configuration.hpp"
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_work_stealing_scheduler {
+
+template<typename Callable>
+Task::Operations const Task::inline_operations_ = {
+    /*invoke=*/[](void* const storage) {
+      (*static_cast<Callable*>(storage))();
+    },
+    /*relocate=*/[](void* const from, void* const to) {
+      Callable* const from_callable = static_cast<Callable*>(from);
+      new (to) Callable(std::move(*from_callable));
+      from_callable->~Callable();
+    },
+    /*destroy=*/[](void* const storage) {
+      static_cast<Callable*>(storage)->~Callable();
+    }};
+
+template<typename Callable>
+Task::Operations const Task::heap_operations_ = {
+    /*invoke=*/[](void* const storage) {
+      (**static_cast<Callable**>(storage))();
+    },
+    /*relocate=*/[](void* const from, void* const to) {
+      *static_cast<Callable**>(to) = *static_cast<Callable**>(from);
+    },
+    /*destroy=*/[](void* const storage) {
+      delete *static_cast<Callable**>(storage);
+    }};
+
+template<typename Callable, typename>
+Task::Task(Callable&& callable) {
+  using C = std::decay_t<Callable>;
+  if constexpr (is_stored_inline<C>) {
+    new (storage_) C(std::forward<Callable>(callable));
+    operations_ = &inline_operations_<C>;
+  } else {
+    *reinterpret_cast<C**>(storage_) = new C(std::forward<Callable>(callable));
+    operations_ = &heap_operations_<C>;
+  }
+}
+
+inline Task::Task(Task&& other) : operations_(other.operations_) {
+  if (operations_ != nullptr) {
+    operations_->relocate(other.storage_, storage_);
+    other.operations_ = nullptr;
+  }
+}
+
+inline Task& Task::operator=(Task&& other) {
+  if (this != &other) {
+    if (operations_ != nullptr) {
+      operations_->destroy(storage_);
+    }
+    operations_ = other.operations_;
+    if (operations_ != nullptr) {
+      operations_->relocate(other.storage_, storage_);
+      other.operations_ = nullptr;
+    }
+  }
+  return *this;
+}
+
+inline Task::~Task() {
+  if (operations_ != nullptr) {
+    operations_->destroy(storage_);
+  }
+}
+
+inline Task::operator bool() const {
+  return operations_ != nullptr;
+}
+
+inline void Task::operator()() {
+  CHECK_NOTNULL(operations_)->invoke(storage_);
+}
+
+template<typename T>
+SharedState<T>::SharedState(not_null<WorkStealingScheduler*> const scheduler)
+    : scheduler_(scheduler) {}
+
+template<typename T>
+not_null<WorkStealingScheduler*> SharedState<T>::scheduler() const {
+  return scheduler_;
+}
+
+template<typename T>
+template<typename Callable>
+void SharedState<T>::Fulfil(Callable& callable) {
+  // Execute the function without holding |lock_| as it might take some time.
+  std::optional<Value> value;
+  if constexpr (std::is_void_v<T>) {
+    callable();
+    value.emplace();
+  } else {
+    value.emplace(callable());
+  }
+
+  std::vector<Task> continuations;
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    CHECK(!value_.has_value());
+    value_ = std::move(value);
+    continuations.swap(continuations_);
+  }
+  ready_.notify_all();
+  for (auto& continuation : continuations) {
+    scheduler_->Schedule(std::move(continuation));
+  }
+}
+
+template<typename T>
+bool SharedState<T>::ready() const {
+  std::lock_guard<std::mutex> l(lock_);
+  return value_.has_value();
+}
+
+template<typename T>
+void SharedState<T>::Wait() const {
+  WorkStealingScheduler* const current_scheduler =
+      WorkStealingScheduler::current_scheduler_;
+  if (current_scheduler == nullptr) {
+    std::unique_lock<std::mutex> l(lock_);
+    ready_.wait(l, [this]() { return value_.has_value(); });
+    return;
+  }
+
+  // On a worker thread, help with the queued tasks, as one of them may be the
+  // one that we are waiting for.  If there is nothing to do, there is no
+  // guarantee that we'll be notified when new tasks are added, so we only
+  // sleep for a short while.
+  static constexpr std::chrono::microseconds nap{100};
+  while (!ready()) {
+    if (!current_scheduler->TryExecuteOneTask(
+            WorkStealingScheduler::current_worker_)) {
+      std::unique_lock<std::mutex> l(lock_);
+      ready_.wait_for(l, nap, [this]() { return value_.has_value(); });
+    }
+  }
+}
+
+template<typename T>
+T SharedState<T>::Take() {
+  std::lock_guard<std::mutex> l(lock_);
+  CHECK(value_.has_value());
+  if constexpr (std::is_void_v<T>) {
+    return;
+  } else {
+    return std::move(*value_);
+  }
+}
+
+template<typename T>
+void SharedState<T>::AddContinuation(Task continuation) {
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    if (!value_.has_value()) {
+      continuations_.push_back(std::move(continuation));
+      return;
+    }
+  }
+  scheduler_->Schedule(std::move(continuation));
+}
+
+template<typename T>
+bool Future<T>::valid() const {
+  return state_ != nullptr;
+}
+
+template<typename T>
+bool Future<T>::is_ready() const {
+  CHECK(valid());
+  return state_->ready();
+}
+
+template<typename T>
+void Future<T>::wait() const {
+  CHECK(valid());
+  state_->Wait();
+}
+
+template<typename T>
+T Future<T>::get() {
+  CHECK(valid());
+  state_->Wait();
+  auto const state = std::move(state_);
+  return state->Take();
+}
+
+template<typename T>
+template<typename Continuation>
+Future<typename ContinuationResultGenerator<T, Continuation>::Type>
+Future<T>::Then(Continuation&& continuation) && {
+  using U = typename ContinuationResultGenerator<T, Continuation>::Type;
+  CHECK(valid());
+  auto const source = std::move(state_);
+  auto const result = std::make_shared<SharedState<U>>(source->scheduler());
+  source->AddContinuation(Task(
+      [source,
+       result,
+       continuation = std::forward<Continuation>(continuation)]() mutable {
+        auto apply = [&source, &continuation]() -> U {
+          if constexpr (std::is_void_v<T>) {
+            return continuation();
+          } else {
+            return continuation(source->Take());
+          }
+        };
+        result->Fulfil(apply);
+      }));
+  return Future<U>(result);
+}
+
+template<typename T>
+Future<T>::Future(std::shared_ptr<SharedState<T>> state)
+    : state_(std::move(state)) {}
+
+inline WorkStealingScheduler::WorkStealingScheduler(
+    std::int64_t const pool_size) {
+  CHECK_LT(0, pool_size);
+  workers_.reserve(pool_size);
+  for (std::int64_t i = 0; i < pool_size; ++i) {
+    workers_.push_back(make_not_null_unique<Worker>());
+  }
+  threads_.reserve(pool_size);
+  for (std::int64_t i = 0; i < pool_size; ++i) {
+    threads_.emplace_back(&WorkStealingScheduler::Work, this, i);
+  }
+}
+
+inline WorkStealingScheduler::~WorkStealingScheduler() {
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    shutdown_ = true;
+  }
+  has_tasks_or_shutdown_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+template<typename Function>
+Future<std::invoke_result_t<Function>> WorkStealingScheduler::Add(
+    Function&& function) {
+  using T = std::invoke_result_t<Function>;
+  auto const state = std::make_shared<SharedState<T>>(this);
+  Schedule(Task([state, function = std::forward<Function>(function)]() mutable {
+    state->Fulfil(function);
+  }));
+  return Future<T>(state);
+}
+
+inline std::int64_t WorkStealingScheduler::pool_size() const {
+  return workers_.size();
+}
+
+inline void WorkStealingScheduler::WaitUntilIdle() {
+  CHECK(current_scheduler_ != this);
+  std::unique_lock<std::mutex> l(lock_);
+  idle_.wait(l, [this] { return pending_tasks_ == 0; });
+}
+
+inline WorkStealingScheduler::Statistics
+WorkStealingScheduler::statistics() const {
+  using Duration = std::chrono::steady_clock::duration;
+  Statistics statistics;
+  statistics.executed_tasks = executed_tasks_.load(std::memory_order_relaxed);
+  statistics.stolen_tasks = stolen_tasks_.load(std::memory_order_relaxed);
+  statistics.contended_locks =
+      contended_locks_.load(std::memory_order_relaxed);
+  statistics.queue_wait =
+      Duration(queue_wait_.load(std::memory_order_relaxed));
+  statistics.busy = Duration(busy_.load(std::memory_order_relaxed));
+  return statistics;
+}
+
+inline std::unique_lock<std::mutex> WorkStealingScheduler::CountingLock(
+    std::mutex& mutex) {
+  std::unique_lock<std::mutex> l(mutex, std::try_to_lock);
+  if (!l.owns_lock()) {
+    contended_locks_.fetch_add(1, std::memory_order_relaxed);
+    l.lock();
+  }
+  return l;
+}
+
+inline void WorkStealingScheduler::Schedule(Task task) {
+  std::int64_t const index =
+      current_scheduler_ == this
+          ? current_worker_
+          : next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                workers_.size();
+  // The counters must be incremented before the task is published: once it
+  // is in a deque, another worker may steal it and decrement them.
+  {
+    auto const l = CountingLock(lock_);
+    ++queued_tasks_;
+    ++pending_tasks_;
+  }
+  {
+    Worker& worker = *workers_[index];
+    auto const l = CountingLock(worker.lock);
+    worker.tasks.push_back({std::move(task), std::chrono::steady_clock::now()});
+  }
+  has_tasks_or_shutdown_.notify_one();
+}
+
+inline bool WorkStealingScheduler::TryExecuteOneTask(std::int64_t const index) {
+  QueuedTask queued_task;
+  {
+    Worker& worker = *workers_[index];
+    auto const l = CountingLock(worker.lock);
+    if (!worker.tasks.empty()) {
+      queued_task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+    }
+  }
+  for (std::int64_t i = 1; !queued_task.task && i < workers_.size(); ++i) {
+    Worker& victim = *workers_[(index + i) % workers_.size()];
+    auto const l = CountingLock(victim.lock);
+    if (!victim.tasks.empty()) {
+      queued_task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      stolen_tasks_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (!queued_task.task) {
+    return false;
+  }
+  --queued_tasks_;
+  auto const start = std::chrono::steady_clock::now();
+  queued_task.task();
+  auto const stop = std::chrono::steady_clock::now();
+  executed_tasks_.fetch_add(1, std::memory_order_relaxed);
+  queue_wait_.fetch_add((start - queued_task.queued_at).count(),
+                        std::memory_order_relaxed);
+  busy_.fetch_add((stop - start).count(), std::memory_order_relaxed);
+  if (--pending_tasks_ == 0) {
+    {
+      auto const l = CountingLock(lock_);
+    }
+    idle_.notify_all();
+  }
+  return true;
+}
+
+inline void WorkStealingScheduler::Work(std::int64_t const index) {
+  ConfigureCurrentThread();
+  current_scheduler_ = this;
+  current_worker_ = index;
+  for (;;) {
+    if (TryExecuteOneTask(index)) {
+      continue;
+    }
+    // Wait until either some deque contains a task or this class is shutting
+    // down.  Upon shutdown, the workers keep going until all the tasks have
+    // been executed.
+    std::unique_lock<std::mutex> l(lock_);
+    has_tasks_or_shutdown_.wait(l, [this] {
+      return shutdown_ || queued_tasks_ > 0;
+    });
+    if (shutdown_ && queued_tasks_ == 0) {
+      break;
+    }
+  }
+}
+
+}  // namespace internal_work_stealing_scheduler
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,183 @@
+#include "base/work_stealing_scheduler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::Eq;
+
+class WorkStealingSchedulerTest : public ::testing::Test {
+ protected:
+  WorkStealingSchedulerTest() : scheduler_(/*pool_size=*/4) {}
+
+  WorkStealingScheduler scheduler_;
+};
+
+TEST_F(WorkStealingSchedulerTest, Results) {
+  std::vector<Future<int>> futures;
+  for (int i = 0; i < 1000; ++i) {
+    futures.push_back(scheduler_.Add([i]() { return i * i; }));
+  }
+  for (int i = 0; i < futures.size(); ++i) {
+    EXPECT_THAT(futures[i].get(), Eq(i * i));
+    EXPECT_FALSE(futures[i].valid());
+  }
+}
+
+TEST_F(WorkStealingSchedulerTest, MoveOnly) {
+  auto future = scheduler_.Add([]() { return std::make_unique<int>(42); });
+  EXPECT_THAT(*future.get(), Eq(42));
+}
+
+TEST_F(WorkStealingSchedulerTest, Continuations) {
+  std::atomic<int> side_effects = 0;
+  auto f1 = scheduler_.Add([]() { return 3; });
+  auto f2 = std::move(f1).Then([](int const i) { return 2.5 * i; });
+  EXPECT_FALSE(f1.valid());
+  auto f3 = std::move(f2).Then([&side_effects](double const d) {
+    side_effects += static_cast<int>(d);
+  });
+  auto f4 = std::move(f3).Then([&side_effects]() {
+    return std::make_unique<int>(side_effects);
+  });
+  EXPECT_THAT(*f4.get(), Eq(7));
+}
+
+// A continuation attached after the task has completed is still executed.
+TEST_F(WorkStealingSchedulerTest, LateContinuation) {
+  auto f1 = scheduler_.Add([]() { return 6; });
+  f1.wait();
+  EXPECT_TRUE(f1.is_ready());
+  auto f2 = std::move(f1).Then([](int const i) { return i * 7; });
+  EXPECT_THAT(f2.get(), Eq(42));
+}
+
+// Tasks which wait on other tasks don't deadlock even if they occupy all the
+// threads, because waiting workers execute queued tasks.
+TEST_F(WorkStealingSchedulerTest, NestedWaits) {
+  WorkStealingScheduler scheduler(/*pool_size=*/1);
+  std::vector<Future<int>> outer;
+  for (int i = 0; i < 10; ++i) {
+    outer.push_back(scheduler.Add([i, &scheduler]() {
+      auto inner = scheduler.Add([i]() { return i + 1; });
+      return 2 * inner.get();
+    }));
+  }
+  int sum = 0;
+  for (auto& future : outer) {
+    sum += future.get();
+  }
+  EXPECT_THAT(sum, Eq(110));
+}
+
+// The destructor executes the tasks that are still queued.
+TEST_F(WorkStealingSchedulerTest, Drain) {
+  std::vector<int> executed;
+  std::mutex lock;
+  {
+    WorkStealingScheduler scheduler(/*pool_size=*/1);
+    for (int i = 0; i < 5; ++i) {
+      scheduler.Add([i, &executed, &lock]() {
+        std::lock_guard<std::mutex> l(lock);
+        executed.push_back(i);
+      });
+    }
+  }
+  EXPECT_THAT(executed.size(), Eq(5));
+}
+
+// Waiting until idle covers the continuations and the tasks that the tasks
+// add.
+TEST_F(WorkStealingSchedulerTest, WaitUntilIdle) {
+  std::atomic<int> executed = 0;
+  for (int i = 0; i < 10; ++i) {
+    scheduler_.Add([this, &executed]() {
+      ++executed;
+      scheduler_.Add([&executed]() { ++executed; });
+    }).Then([&executed]() { ++executed; });
+  }
+  scheduler_.WaitUntilIdle();
+  EXPECT_THAT(executed, Eq(30));
+  // Nothing is pending.
+  scheduler_.WaitUntilIdle();
+}
+
+// Tasks added concurrently by several threads and by the workers, some of
+// them stolen, are all complete when |WaitUntilIdle| returns, even if other
+// threads wait concurrently.
+TEST_F(WorkStealingSchedulerTest, WaitUntilIdleStress) {
+  constexpr int producers = 4;
+  constexpr int tasks_per_producer = 100;
+  std::atomic<int> running = 0;
+  std::atomic<int> executed = 0;
+  for (int round = 0; round < 100; ++round) {
+    executed = 0;
+    std::atomic<bool> producing = true;
+    std::thread waiter([this, &producing]() {
+      while (producing) {
+        scheduler_.WaitUntilIdle();
+      }
+    });
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; ++i) {
+      threads.emplace_back([this, &running, &executed]() {
+        for (int j = 0; j < tasks_per_producer; ++j) {
+          scheduler_.Add([this, &running, &executed]() {
+            ++running;
+            // This task goes to the deque of the current worker, from which
+            // the other workers may steal it.
+            scheduler_.Add([&running, &executed]() {
+              ++running;
+              ++executed;
+              --running;
+            });
+            ++executed;
+            --running;
+          });
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    scheduler_.WaitUntilIdle();
+    EXPECT_THAT(running, Eq(0));
+    EXPECT_THAT(executed, Eq(2 * producers * tasks_per_producer));
+    producing = false;
+    waiter.join();
+  }
+}
+
+// With a single worker, the statistics of a task are complete once the next
+// task has started executing.  Since the worker executes its deque in LIFO
+// order, the last task is only added once the others have completed.
+TEST_F(WorkStealingSchedulerTest, Statistics) {
+  WorkStealingScheduler scheduler(/*pool_size=*/1);
+  std::vector<Future<void>> futures;
+  for (int i = 0; i < 100; ++i) {
+    futures.push_back(scheduler.Add([]() {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }));
+  }
+  for (auto const& future : futures) {
+    future.wait();
+  }
+  scheduler.Add([]() {}).wait();
+  auto const statistics = scheduler.statistics();
+  EXPECT_LE(100, statistics.executed_tasks);
+  EXPECT_THAT(statistics.stolen_tasks, Eq(0));
+  EXPECT_LE(std::chrono::microseconds(100 * 100), statistics.busy);
+  EXPECT_LE(std::chrono::steady_clock::duration::zero(),
+            statistics.queue_wait);
+}
+
+}  // namespace base
+}  // namespace principia
@@ -50,10 +50,19 @@ class BenchmarkAutomation {
           Console.WriteLine(
               "Running benchmarks with arguments from " + file.Name);
           Console.WriteLine(command_line);
+          // The results are also written in JSON, to be compared with a
+          // baseline using the compare_benchmarks command of the tools.
+          String baseline_output_file =
+              Path.Combine(jenkins_directory.FullName,
+                           "benchmark_results_" +
+                               Path.GetFileNameWithoutExtension(file.Name) +
+                               ".json");
           Process process = new Process {
             StartInfo = new ProcessStartInfo {
               FileName = benchmark_executable,
-              Arguments = command_line,
+              Arguments = command_line +
+                          " --principia_baseline_out=\"" +
+                          baseline_output_file + "\"",
               UseShellExecute = false,
               RedirectStandardOutput = true,
               CreateNoWindow = true
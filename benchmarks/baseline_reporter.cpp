@@ -0,0 +1,244 @@
+
+#include "benchmarks/baseline_reporter.hpp"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <ostream>
+
+#include "base/macros.hpp"
+#include "base/version.hpp"
+#include "glog/logging.h"
+
+#if PRINCIPIA_COMPILER_MSVC || PRINCIPIA_COMPILER_CLANG_CL
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace principia {
+namespace benchmarks {
+
+namespace {
+
+// The registers EAX, EBX, ECX, EDX after CPUID with the given leaf and
+// subleaf.
+std::array<std::uint32_t, 4> CPUID(std::uint32_t const leaf,
+                                   std::uint32_t const subleaf) {
+  std::array<std::uint32_t, 4> registers{};
+#if PRINCIPIA_COMPILER_MSVC || PRINCIPIA_COMPILER_CLANG_CL
+  int cpu_info[4];
+  __cpuidex(cpu_info, leaf, subleaf);
+  for (int i = 0; i < 4; ++i) {
+    registers[i] = static_cast<std::uint32_t>(cpu_info[i]);
+  }
+#else
+  __cpuid_count(leaf, subleaf,
+                registers[0], registers[1], registers[2], registers[3]);
+#endif
+  return registers;
+}
+
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+constexpr bool sse3_intrinsics = true;
+#else
+constexpr bool sse3_intrinsics = false;
+#endif
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+constexpr bool avx2_intrinsics = true;
+#else
+constexpr bool avx2_intrinsics = false;
+#endif
+
+constexpr int eax = 0;
+constexpr int ebx = 1;
+constexpr int ecx = 2;
+constexpr int edx = 3;
+
+struct CPUFeature final {
+  char const* name;
+  std::uint32_t leaf;
+  int register_index;
+  int bit;
+};
+
+constexpr std::array<CPUFeature, 11> cpu_features{{
+    {"sse2", 1, edx, 26},
+    {"sse3", 1, ecx, 0},
+    {"ssse3", 1, ecx, 9},
+    {"fma", 1, ecx, 12},
+    {"sse4.1", 1, ecx, 19},
+    {"sse4.2", 1, ecx, 20},
+    {"popcnt", 1, ecx, 23},
+    {"avx", 1, ecx, 28},
+    {"avx2", 7, ebx, 5},
+    {"bmi2", 7, ebx, 8},
+    {"avx512f", 7, ebx, 16},
+}};
+
+// Writes |s| as a JSON string.  Benchmark names are printable ASCII or UTF-8,
+// so only the quotes and backslashes need escaping.
+void WriteString(std::string const& s, std::ostream& out) {
+  out << '"';
+  for (char const c : s) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+template<typename T, typename F>
+void WriteArray(std::vector<T> const& values,
+                F const& write,
+                std::ostream& out) {
+  out << "[";
+  for (int i = 0; i < values.size(); ++i) {
+    if (i > 0) {
+      out << ", ";
+    }
+    write(values[i], out);
+  }
+  out << "]";
+}
+
+double NanosecondsPerTimeUnit(benchmark::TimeUnit const time_unit) {
+  switch (time_unit) {
+    case benchmark::kNanosecond:
+      return 1;
+    case benchmark::kMicrosecond:
+      return 1e3;
+    case benchmark::kMillisecond:
+      return 1e6;
+  }
+  LOG(FATAL) << "Unexpected time unit " << time_unit;
+  base::noreturn();
+}
+
+bool IsAggregate(std::string const& benchmark_name) {
+  for (std::string const suffix : {"_mean", "_median", "_stddev", "_cv"}) {
+    if (benchmark_name.size() >= suffix.size() &&
+        benchmark_name.compare(benchmark_name.size() - suffix.size(),
+                               suffix.size(),
+                               suffix) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+std::vector<std::string> CPUFeatures() {
+  std::uint32_t const max_leaf = CPUID(0, 0)[eax];
+  std::vector<std::string> features;
+  for (auto const& feature : cpu_features) {
+    if (feature.leaf <= max_leaf &&
+        (CPUID(feature.leaf, 0)[feature.register_index] >> feature.bit) & 1) {
+      features.push_back(feature.name);
+    }
+  }
+  return features;
+}
+
+BaselineReporter::BaselineReporter(std::filesystem::path const& path)
+    : path_(path) {}
+
+bool BaselineReporter::ReportContext(Context const& context) {
+  num_cpus_ = context.num_cpus;
+  mhz_per_cpu_ = context.mhz_per_cpu;
+  cpu_scaling_enabled_ = context.cpu_scaling_enabled;
+  return console_reporter_.ReportContext(context);
+}
+
+void BaselineReporter::ReportRuns(std::vector<Run> const& reports) {
+  console_reporter_.ReportRuns(reports);
+  for (auto const& report : reports) {
+    if (!report.error_occurred && !IsAggregate(report.benchmark_name)) {
+      runs_.push_back(report);
+    }
+  }
+}
+
+void BaselineReporter::Finalize() {
+  console_reporter_.Finalize();
+
+  // Group the repetitions of each benchmark, preserving the order in which the
+  // benchmarks ran.
+  std::vector<std::string> names;
+  std::map<std::string, std::vector<Run const*>> repetitions;
+  for (auto const& run : runs_) {
+    auto& runs_of_benchmark = repetitions[run.benchmark_name];
+    if (runs_of_benchmark.empty()) {
+      names.push_back(run.benchmark_name);
+    }
+    runs_of_benchmark.push_back(&run);
+  }
+
+  std::ofstream out(path_);
+  CHECK(out.good()) << path_;
+  auto const write_string = [](std::string const& s, std::ostream& out) {
+    WriteString(s, out);
+  };
+  auto const write_number = [](double const x, std::ostream& out) {
+    out << x;
+  };
+  out.precision(17);
+  out << "{\n";
+  out << "  \"build\": {\n";
+  out << "    \"version\": ";
+  WriteString(base::Version, out);
+  out << ",\n    \"date\": ";
+  WriteString(base::BuildDate, out);
+  out << ",\n    \"compiler\": ";
+  WriteString(base::CompilerName, out);
+  out << ",\n    \"compiler_version\": ";
+  WriteString(base::CompilerVersion, out);
+  out << ",\n    \"operating_system\": ";
+  WriteString(base::OperatingSystem, out);
+  out << ",\n    \"architecture\": ";
+  WriteString(base::Architecture, out);
+  out << ",\n    \"sse3_intrinsics\": "
+      << (sse3_intrinsics ? "true" : "false");
+  out << ",\n    \"avx2_intrinsics\": "
+      << (avx2_intrinsics ? "true" : "false");
+  out << "\n  },\n";
+  out << "  \"cpu\": {\n";
+  out << "    \"count\": " << num_cpus_;
+  out << ",\n    \"mhz\": " << mhz_per_cpu_;
+  out << ",\n    \"scaling_enabled\": "
+      << (cpu_scaling_enabled_ ? "true" : "false");
+  out << ",\n    \"features\": ";
+  WriteArray(CPUFeatures(), write_string, out);
+  out << "\n  },\n";
+  out << "  \"benchmarks\": [";
+  for (int i = 0; i < names.size(); ++i) {
+    std::vector<double> iterations;
+    std::vector<double> real_times;
+    std::vector<double> cpu_times;
+    for (Run const* const run : repetitions[names[i]]) {
+      double const ns = NanosecondsPerTimeUnit(run->time_unit);
+      iterations.push_back(run->iterations);
+      real_times.push_back(run->GetAdjustedRealTime() * ns);
+      cpu_times.push_back(run->GetAdjustedCPUTime() * ns);
+    }
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"name\": ";
+    WriteString(names[i], out);
+    out << ", \"iterations\": ";
+    WriteArray(iterations, write_number, out);
+    out << ", \"real_time\": ";
+    WriteArray(real_times, write_number, out);
+    out << ", \"cpu_time\": ";
+    WriteArray(cpu_times, write_number, out);
+    out << "}";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+  CHECK(out.good()) << path_;
+}
+
+}  // namespace benchmarks
+}  // namespace principia
@@ -0,0 +1,41 @@
+﻿
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace principia {
+namespace benchmarks {
+
+// The features of the processor reported by CPUID that matter for the
+// performance of Principia, e.g., "sse3", "avx2", "fma".
+std::vector<std::string> CPUFeatures();
+
+// A reporter that prints the results on the console like the default one, so
+// that the output scraped by benchmark_automation is unchanged, and that also
+// writes them to a JSON file, together with the build and processor metadata
+// needed to decide whether two runs may be compared.  The repetitions of a
+// benchmark are written individually, the aggregates are not.  Times are in
+// nanoseconds per iteration.
+class BaselineReporter : public benchmark::BenchmarkReporter {
+ public:
+  explicit BaselineReporter(std::filesystem::path const& path);
+
+  bool ReportContext(Context const& context) override;
+  void ReportRuns(std::vector<Run> const& reports) override;
+  void Finalize() override;
+
+ private:
+  benchmark::ConsoleReporter console_reporter_;
+  std::filesystem::path const path_;
+  int num_cpus_ = 0;
+  double mhz_per_cpu_ = 0;
+  bool cpu_scaling_enabled_ = false;
+  std::vector<Run> runs_;
+};
+
+}  // namespace benchmarks
+}  // namespace principia
@@ -0,0 +1,286 @@
+﻿
+// .\Release\x64\benchmarks.exe --benchmark_repetitions=3 --benchmark_filter=DiscreteTrajectory  // NOLINT(whitespace/line_length)
+
+#include "physics/discrete_trajectory.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "astronomy/frames.hpp"
+#include "benchmark/benchmark.h"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+
+using astronomy::ICRFJ2000Equator;
+using geometry::Displacement;
+using geometry::Instant;
+using geometry::Velocity;
+using quantities::Angle;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Sin;
+using quantities::Time;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Radian;
+using quantities::si::Second;
+
+namespace physics {
+
+namespace {
+
+// The parameters of the histories of the vessels.
+constexpr std::int64_t max_dense_intervals = 10'000;
+constexpr Length downsampling_tolerance = 10 * Metre;
+constexpr Time step = 10 * Second;
+
+// The number of lookups or evaluations per iteration of the benchmarks that
+// measure them.
+constexpr int queries = 1000;
+
+// Returns the degrees of freedom at the |size| first multiples of |step| of a
+// circular low orbit, as computed by the integration of a vessel history.
+std::vector<DegreesOfFreedom<ICRFJ2000Equator>> CircularOrbit(
+    std::int64_t const size) {
+  Length const r = 700 * Kilo(Metre);
+  AngularFrequency const ω = 2 * π * Radian / (2000 * Second);
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> degrees_of_freedom;
+  degrees_of_freedom.reserve(size);
+  for (std::int64_t k = 0; k < size; ++k) {
+    Angle const θ = ω * k * step;
+    degrees_of_freedom.emplace_back(
+        ICRFJ2000Equator::origin +
+            Displacement<ICRFJ2000Equator>({r * Cos(θ), r * Sin(θ), 0 * r}),
+        Velocity<ICRFJ2000Equator>({-r * ω * Sin(θ) / Radian,
+                                    r * ω * Cos(θ) / Radian,
+                                    0 * r * ω / Radian}));
+  }
+  return degrees_of_freedom;
+}
+
+// Appends to |trajectory| the points of |degrees_of_freedom| with indices in
+// [first, last[, the point of index k being at time k * |step| after J2000.
+void AppendPoints(
+    std::vector<DegreesOfFreedom<ICRFJ2000Equator>> const& degrees_of_freedom,
+    std::int64_t const first,
+    std::int64_t const last,
+    DiscreteTrajectory<ICRFJ2000Equator>& trajectory) {
+  Instant const t0;
+  for (std::int64_t k = first; k < last; ++k) {
+    trajectory.Append(t0 + k * step, degrees_of_freedom[k]);
+  }
+}
+
+// Times spread over the first |size| points, in random order, either exactly
+// at points or between points.
+std::vector<Instant> RandomTimes(std::int64_t const size,
+                                 bool const at_points) {
+  std::mt19937_64 random(42);
+  std::uniform_int_distribution<std::int64_t> distribution(0, size - 2);
+  Instant const t0;
+  std::vector<Instant> times;
+  for (int i = 0; i < queries; ++i) {
+    double const index = distribution(random) + (at_points ? 0 : 0.5);
+    times.push_back(t0 + index * step);
+  }
+  return times;
+}
+
+}  // namespace
+
+void BM_DiscreteTrajectoryAppend(benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  auto const degrees_of_freedom = CircularOrbit(size);
+  while (state.KeepRunning()) {
+    auto trajectory =
+        std::make_unique<DiscreteTrajectory<ICRFJ2000Equator>>();
+    AppendPoints(degrees_of_freedom, 0, size, *trajectory);
+    // Don't time the destruction.
+    state.PauseTiming();
+    trajectory.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_DiscreteTrajectoryAppendWithDownsampling(benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  auto const degrees_of_freedom = CircularOrbit(size);
+  std::int64_t retained = 0;
+  while (state.KeepRunning()) {
+    DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+    trajectory.SetDownsampling(max_dense_intervals, downsampling_tolerance);
+    AppendPoints(degrees_of_freedom, 0, size, trajectory);
+    retained = trajectory.Size();
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+  state.SetLabel(std::to_string(retained) + " points retained");
+}
+
+// Iterates over the leaf of a chain of |range_y| nested forks, each of which
+// holds an equal share of the |range_x| points.
+void BM_DiscreteTrajectoryIterateForkTree(benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  std::int64_t const depth = state.range_y();
+  auto const degrees_of_freedom = CircularOrbit(size);
+  DiscreteTrajectory<ICRFJ2000Equator> root;
+  DiscreteTrajectory<ICRFJ2000Equator>* leaf = &root;
+  for (std::int64_t i = 0; i <= depth; ++i) {
+    if (i > 0) {
+      leaf = leaf->NewForkAtLast();
+    }
+    AppendPoints(degrees_of_freedom,
+                 /*first=*/i * size / (depth + 1),
+                 /*last=*/(i + 1) * size / (depth + 1),
+                 *leaf);
+  }
+  Length total;
+  while (state.KeepRunning()) {
+    for (auto it = leaf->Begin(); it != leaf->End(); ++it) {
+      total += (it.degrees_of_freedom().position() - ICRFJ2000Equator::origin)
+                   .Norm();
+    }
+  }
+  benchmark::DoNotOptimize(total);
+  state.SetItemsProcessed(state.iterations() * leaf->Size());
+}
+
+void BM_DiscreteTrajectoryFind(benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+  AppendPoints(CircularOrbit(size), 0, size, trajectory);
+  auto const times = RandomTimes(size, /*at_points=*/true);
+  while (state.KeepRunning()) {
+    for (Instant const& t : times) {
+      benchmark::DoNotOptimize(trajectory.Find(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries);
+}
+
+void BM_DiscreteTrajectoryLowerBound(benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+  AppendPoints(CircularOrbit(size), 0, size, trajectory);
+  auto const times = RandomTimes(size, /*at_points=*/false);
+  while (state.KeepRunning()) {
+    for (Instant const& t : times) {
+      benchmark::DoNotOptimize(trajectory.LowerBound(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries);
+}
+
+// Evaluates the trajectory at random times, each of which needs a lookup.
+void BM_DiscreteTrajectoryEvaluateDegreesOfFreedomRandom(
+    benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+  AppendPoints(CircularOrbit(size), 0, size, trajectory);
+  auto const times = RandomTimes(size, /*at_points=*/false);
+  while (state.KeepRunning()) {
+    for (Instant const& t : times) {
+      benchmark::DoNotOptimize(trajectory.EvaluateDegreesOfFreedom(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries);
+}
+
+// Evaluates the trajectory at increasing times covering its entire span, as
+// when it is swept to compare it with another trajectory, either directly or
+// with an |EvaluationCursor| depending on |range_y|.
+void BM_DiscreteTrajectoryEvaluateDegreesOfFreedomSweep(
+    benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  bool const use_cursor = state.range_y() != 0;
+  DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+  AppendPoints(CircularOrbit(size), 0, size, trajectory);
+  Instant const t_min = trajectory.t_min();
+  Time const Δt = (trajectory.t_max() - t_min) / queries;
+  while (state.KeepRunning()) {
+    if (use_cursor) {
+      DiscreteTrajectory<ICRFJ2000Equator>::EvaluationCursor cursor(trajectory);
+      for (int i = 0; i < queries; ++i) {
+        benchmark::DoNotOptimize(
+            cursor.EvaluateDegreesOfFreedom(t_min + i * Δt));
+      }
+    } else {
+      for (int i = 0; i < queries; ++i) {
+        benchmark::DoNotOptimize(
+            trajectory.EvaluateDegreesOfFreedom(t_min + i * Δt));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries);
+  state.SetLabel(use_cursor ? "cursor" : "direct");
+}
+
+// Forks in the middle of the trajectory, copying half of the points, and
+// deletes the fork.
+void BM_DiscreteTrajectoryNewForkWithCopyAndDeleteFork(
+    benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+  AppendPoints(CircularOrbit(size), 0, size, trajectory);
+  Instant const middle = Instant() + (size / 2) * step;
+  while (state.KeepRunning()) {
+    DiscreteTrajectory<ICRFJ2000Equator>* fork =
+        trajectory.NewForkWithCopy(middle);
+    trajectory.DeleteFork(fork);
+  }
+  state.SetItemsProcessed(state.iterations() * (size - size / 2 - 1));
+}
+
+// Forgets the first half of the trajectory.  Only |ForgetBefore| is timed.
+void BM_DiscreteTrajectoryForgetBefore(benchmark::State& state) {
+  std::int64_t const size = state.range_x();
+  auto const degrees_of_freedom = CircularOrbit(size);
+  Instant const middle = Instant() + (size / 2) * step;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    auto trajectory =
+        std::make_unique<DiscreteTrajectory<ICRFJ2000Equator>>();
+    AppendPoints(degrees_of_freedom, 0, size, *trajectory);
+    state.ResumeTiming();
+    trajectory->ForgetBefore(middle);
+    state.PauseTiming();
+    trajectory.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * (size / 2));
+}
+
+BENCHMARK(BM_DiscreteTrajectoryAppend)
+    ->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Arg(10'000'000);
+BENCHMARK(BM_DiscreteTrajectoryAppendWithDownsampling)
+    ->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Arg(10'000'000);
+BENCHMARK(BM_DiscreteTrajectoryIterateForkTree)
+    ->ArgPair(10'000, 0)->ArgPair(10'000, 100)
+    ->ArgPair(1'000'000, 0)->ArgPair(1'000'000, 100);
+BENCHMARK(BM_DiscreteTrajectoryFind)
+    ->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Arg(10'000'000);
+BENCHMARK(BM_DiscreteTrajectoryLowerBound)
+    ->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Arg(10'000'000);
+BENCHMARK(BM_DiscreteTrajectoryEvaluateDegreesOfFreedomRandom)
+    ->Arg(10'000)->Arg(1'000'000);
+BENCHMARK(BM_DiscreteTrajectoryEvaluateDegreesOfFreedomSweep)
+    ->ArgPair(10'000, 0)->ArgPair(10'000, 1)
+    ->ArgPair(1'000'000, 0)->ArgPair(1'000'000, 1);
+BENCHMARK(BM_DiscreteTrajectoryNewForkWithCopyAndDeleteFork)
+    ->Arg(10'000)->Arg(100'000)->Arg(1'000'000);
+BENCHMARK(BM_DiscreteTrajectoryForgetBefore)
+    ->Arg(10'000)->Arg(100'000)->Arg(1'000'000);
+
+}  // namespace physics
+}  // namespace principia
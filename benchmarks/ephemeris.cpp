@@ -2,6 +2,7 @@
 // .\Release\x64\benchmarks.exe --benchmark_repetitions=3 --benchmark_filter=Ephemeris                                                                     // NOLINT(whitespace/line_length)
 
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <list>
 #include <memory>
@@ -12,6 +13,7 @@
 #include "astronomy/stabilize_ksp.hpp"
 #include "base/not_null.hpp"
 #include "base/thread_pool.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "benchmark/benchmark.h"
 #include "geometry/named_quantities.hpp"
 #include "geometry/quaternion.hpp"
@@ -39,9 +41,11 @@ namespace principia {
 using astronomy::ICRFJ2000Ecliptic;
 using astronomy::ICRFJ2000Equator;
 using astronomy::ICRFJ200EquatorialToEcliptic;
+using base::Future;
 using base::make_not_null_unique;
 using base::not_null;
 using base::ThreadPool;
+using base::WorkStealingScheduler;
 using geometry::Displacement;
 using geometry::Identity;
 using geometry::Instant;
@@ -143,8 +147,14 @@ void BM_EphemerisKSPSystem(benchmark::State& state) {
   state.SetLabel(quantities::DebugString(error / AstronomicalUnit) + " ua");
 }
 
+// The second argument is the number of threads used to compute the
+// accelerations between the massive bodies, or 0 for the serial computation.
 void EphemerisSolarSystemBenchmark(SolarSystemFactory::Accuracy const accuracy,
                                    benchmark::State& state) {
+  std::unique_ptr<WorkStealingScheduler> scheduler;
+  if (state.range_y() > 0) {
+    scheduler = std::make_unique<WorkStealingScheduler>(state.range_y());
+  }
   Length error;
   while (state.KeepRunning()) {
     state.PauseTiming();
@@ -154,6 +164,7 @@ void EphemerisSolarSystemBenchmark(SolarSystemFactory::Accuracy const accuracy,
     auto const ephemeris =
         at_спутник_1_launch->MakeEphemeris(FittingTolerance(state.range_x()),
                                            EphemerisParameters());
+    ephemeris->SetMassiveBodiesScheduler(scheduler.get());
 
     state.ResumeTiming();
     ephemeris->Prolong(final_time);
@@ -193,8 +204,11 @@ void EphemerisL4ProbeBenchmark(SolarSystemFactory::Accuracy const accuracy,
   // Compute the total degree of the underlying polynomials.  Useful for
   // benchmarking the effect of the fitting tolerance.
   double total_degree = 0;
+  std::int64_t polynomials_memory_footprint = 0;
   for (auto const& body : ephemeris->bodies()) {
     total_degree += ephemeris->trajectory(body)->average_degree();
+    polynomials_memory_footprint +=
+        ephemeris->trajectory(body)->polynomials_memory_footprint();
   }
 
   while (state.KeepRunning()) {
@@ -261,7 +275,9 @@ void EphemerisL4ProbeBenchmark(SolarSystemFactory::Accuracy const accuracy,
                  " ua, " +
                  quantities::DebugString(earth_error / AstronomicalUnit) +
                  " ua, degree " +
-                 std::to_string(total_degree));
+                 std::to_string(total_degree) + ", " +
+                 std::to_string(polynomials_memory_footprint / 1024) +
+                 " KiB of polynomials");
 }
 
 template<Flow* flow>
@@ -387,7 +403,7 @@ void BM_EphemerisMultithreadingBenchmark(benchmark::State& state) {
     final_time += step;
     state.ResumeTiming();
 
-    std::vector<std::future<void>> futures;
+    std::vector<Future<void>> futures;
     for (auto& instance : instances) {
       futures.push_back(pool.Add([&ephemeris, &instance, final_time]() {
         ephemeris->FlowWithFixedStep(final_time, *instance);
@@ -537,9 +553,15 @@ BENCHMARK(BM_EphemerisMultithreadingBenchmark)
     ->ArgPair(3, 4)
     ->ArgPair(3, 5);
 BENCHMARK(BM_EphemerisKSPSystem)->Arg(-3);
-BENCHMARK(BM_EphemerisSolarSystemMajorBodiesOnly)->Arg(-3);
-BENCHMARK(BM_EphemerisSolarSystemMinorAndMajorBodies)->Arg(-3);
-BENCHMARK(BM_EphemerisSolarSystemAllBodiesAndOblateness)->Arg(-3);
+BENCHMARK(BM_EphemerisSolarSystemMajorBodiesOnly)
+    ->ArgPair(-3, 0)
+    ->ArgPair(-3, 4);
+BENCHMARK(BM_EphemerisSolarSystemMinorAndMajorBodies)
+    ->ArgPair(-3, 0)
+    ->ArgPair(-3, 4);
+BENCHMARK(BM_EphemerisSolarSystemAllBodiesAndOblateness)
+    ->ArgPair(-3, 0)
+    ->ArgPair(-3, 4);
 BENCHMARK_TEMPLATE1(BM_EphemerisL4ProbeMajorBodiesOnly,
                     &FlowEphemerisWithAdaptiveStep)->Arg(-3);
 BENCHMARK_TEMPLATE1(BM_EphemerisL4ProbeMinorAndMajorBodies,
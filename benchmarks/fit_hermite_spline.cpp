@@ -0,0 +1,127 @@
+﻿
+// .\Release\x64\benchmarks.exe --benchmark_repetitions=10 --benchmark_filter=FitHermiteSpline  // NOLINT(whitespace/line_length)
+
+#include "numerics/fit_hermite_spline.hpp"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "astronomy/frames.hpp"
+#include "benchmark/benchmark.h"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+
+using astronomy::ICRFJ2000Equator;
+using geometry::Displacement;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using quantities::Angle;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Sin;
+using quantities::Speed;
+using quantities::Time;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Radian;
+using quantities::si::Second;
+
+namespace numerics {
+
+namespace {
+
+struct Sample {
+  Instant t;
+  Position<ICRFJ2000Equator> q;
+  Velocity<ICRFJ2000Equator> v;
+};
+
+// A vessel history in a slightly eccentric, inclined low orbit, sampled every
+// 10 s as by the integration of the history, with the downsampling tolerance of
+// the vessels.
+constexpr Length tolerance = 10 * Metre;
+
+std::vector<Sample> VesselHistory(std::int64_t const size) {
+  Length const a = 700 * Kilo(Metre);
+  double const e = 0.01;
+  Angle const i = 0.5 * Radian;
+  Time const period = 2000 * Second;
+  AngularFrequency const ω = 2 * π * Radian / period;
+  Time const step = 10 * Second;
+  Instant const t0;
+
+  std::vector<Sample> samples;
+  samples.reserve(size);
+  for (std::int64_t k = 0; k < size; ++k) {
+    Instant const t = t0 + k * step;
+    // To first order in the eccentricity.
+    Angle const M = ω * (t - t0);
+    Angle const θ = M + 2 * e * Sin(M) * Radian;
+    Length const r = a * (1 - e * Cos(M));
+    AngularFrequency const θʹ = ω * (1 + 2 * e * Cos(M));
+    Speed const rʹ = a * e * Sin(M) * ω / Radian;
+    Displacement<ICRFJ2000Equator> const u(
+        {Cos(θ) * Metre, Sin(θ) * Cos(i) * Metre, Sin(θ) * Sin(i) * Metre});
+    Velocity<ICRFJ2000Equator> const uʹ(
+        {-Sin(θ) * θʹ / Radian * Metre,
+         Cos(θ) * Cos(i) * θʹ / Radian * Metre,
+         Cos(θ) * Sin(i) * θʹ / Radian * Metre});
+    samples.push_back(
+        {t,
+         ICRFJ2000Equator::origin + r / Metre * u,
+         rʹ / Metre * u + r / Metre * uʹ});
+  }
+  return samples;
+}
+
+}  // namespace
+
+void BM_FitHermiteSplineIterators(benchmark::State& state) {
+  std::vector<Sample> const samples = VesselHistory(state.range_x());
+  std::int64_t size = 0;
+  while (state.KeepRunning()) {
+    auto const tail = FitHermiteSpline<Instant, Position<ICRFJ2000Equator>>(
+        samples,
+        [](auto&& sample) -> auto&& { return sample.t; },
+        [](auto&& sample) -> auto&& { return sample.q; },
+        [](auto&& sample) -> auto&& { return sample.v; },
+        tolerance);
+    size = tail.size();
+  }
+  state.SetLabel(std::to_string(size) + " points retained");
+}
+
+void BM_FitHermiteSplineArrays(benchmark::State& state) {
+  std::vector<Sample> const samples = VesselHistory(state.range_x());
+  std::vector<Instant> arguments;
+  std::vector<Position<ICRFJ2000Equator>> values;
+  std::vector<Velocity<ICRFJ2000Equator>> derivatives;
+  for (auto const& sample : samples) {
+    arguments.push_back(sample.t);
+    values.push_back(sample.q);
+    derivatives.push_back(sample.v);
+  }
+  std::int64_t size = 0;
+  while (state.KeepRunning()) {
+    auto const tail = FitHermiteSpline<Instant, Position<ICRFJ2000Equator>>(
+        arguments, values, derivatives, tolerance);
+    size = tail.size();
+  }
+  state.SetLabel(std::to_string(size) + " points retained");
+}
+
+BENCHMARK(BM_FitHermiteSplineIterators)->Arg(1'000)->Arg(10'000);
+BENCHMARK(BM_FitHermiteSplineArrays)->Arg(1'000)->Arg(10'000);
+
+}  // namespace numerics
+}  // namespace principia
@@ -1,9 +1,42 @@
 ﻿
+#include <cstring>
+#include <optional>
+#include <string>
+
 #include "benchmark/benchmark.h"
+#include "benchmarks/baseline_reporter.hpp"
 #include "glog/logging.h"
 
+namespace {
+
+// With --principia_baseline_out=<file>, the results are also written to <file>
+// in JSON, for comparison by `tools.exe compare_benchmarks`.
+constexpr char baseline_out_flag[] = "--principia_baseline_out=";
+
+}  // namespace
+
 int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
+
+  // Remove our flag before the benchmark library sees the arguments.
+  std::optional<std::string> baseline_out;
+  int remaining_argc = 1;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i],
+                     baseline_out_flag,
+                     sizeof(baseline_out_flag) - 1) == 0) {
+      baseline_out = argv[i] + sizeof(baseline_out_flag) - 1;
+    } else {
+      argv[remaining_argc++] = argv[i];
+    }
+  }
+  argc = remaining_argc;
+
   benchmark::Initialize(&argc, argv);
-  benchmark::RunSpecifiedBenchmarks();
+  if (baseline_out.has_value()) {
+    principia::benchmarks::BaselineReporter reporter(*baseline_out);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+  } else {
+    benchmark::RunSpecifiedBenchmarks();
+  }
 }
@@ -8,6 +8,7 @@
 // BM_NewhallApproximation/8         657        624    2000000
 // BM_NewhallApproximation/16        754        741    2000000
 
+#include <array>
 #include <memory>
 #include <random>
 #include <vector>
@@ -101,6 +102,51 @@ void BM_NewhallApproximationDisplacement(benchmark::State& state) {
   }
 }
 
+// Compares the fitting of a fixed degree from samples in |std::vector|s and in
+// |std::array|s.
+template<int degree, bool use_arrays>
+void BM_NewhallApproximationFixedDegree(benchmark::State& state) {
+  using D = Displacement<ICRFJ2000Ecliptic>;
+  using V = Variation<D>;
+  std::mt19937_64 random(42);
+  std::vector<D> p_vector;
+  std::vector<V> v_vector;
+  std::array<D, newhall_divisions + 1> p_array;
+  std::array<V, newhall_divisions + 1> v_array;
+  Instant const t0;
+  Instant const t_min = t0 + static_cast<double>(random()) * Second;
+  Instant const t_max = t_min + static_cast<double>(random()) * Second;
+
+  D error_estimate;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    p_vector.clear();
+    v_vector.clear();
+    for (int i = 0; i <= newhall_divisions; ++i) {
+      p_array[i] = D({static_cast<double>(random()) * Metre,
+                      static_cast<double>(random()) * Metre,
+                      static_cast<double>(random()) * Metre});
+      v_array[i] = V({static_cast<double>(random()) * Metre / Second,
+                      static_cast<double>(random()) * Metre / Second,
+                      static_cast<double>(random()) * Metre / Second});
+      p_vector.push_back(p_array[i]);
+      v_vector.push_back(v_array[i]);
+    }
+    state.ResumeTiming();
+    if constexpr (use_arrays) {
+      auto const polynomial =
+          NewhallApproximationInMonomialBasis<D, degree, EstrinEvaluator>(
+              p_array, v_array, t_min, t_max, error_estimate);
+      benchmark::DoNotOptimize(polynomial);
+    } else {
+      auto const polynomial =
+          NewhallApproximationInMonomialBasis<D, degree, EstrinEvaluator>(
+              p_vector, v_vector, t_min, t_max, error_estimate);
+      benchmark::DoNotOptimize(polynomial);
+    }
+  }
+}
+
 using ResultЧебышёвDouble =
     ЧебышёвSeries<double>;
 using ResultЧебышёвDisplacement =
@@ -132,6 +178,12 @@ BENCHMARK_TEMPLATE2(
     ResultMonomialDisplacement,
     (&NewhallApproximationInMonomialBasis<Displacement<ICRFJ2000Ecliptic>,EstrinEvaluator>))  // NOLINT
     ->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE2(BM_NewhallApproximationFixedDegree, 4, false);
+BENCHMARK_TEMPLATE2(BM_NewhallApproximationFixedDegree, 4, true);
+BENCHMARK_TEMPLATE2(BM_NewhallApproximationFixedDegree, 8, false);
+BENCHMARK_TEMPLATE2(BM_NewhallApproximationFixedDegree, 8, true);
+BENCHMARK_TEMPLATE2(BM_NewhallApproximationFixedDegree, 16, false);
+BENCHMARK_TEMPLATE2(BM_NewhallApproximationFixedDegree, 16, true);
 
 }  // namespace numerics
 }  // namespace principia
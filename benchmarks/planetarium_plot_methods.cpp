@@ -142,12 +142,14 @@ class Satellites {
     return goes_8_trajectory_;
   }
 
+  // With a small |angular_resolution| more bodies participate in hiding.
   Planetarium MakePlanetarium(
-      Perspective<Navigation, Camera> const& perspective) const {
-    // No dark area, human visual acuity, wide field of view.
+      Perspective<Navigation, Camera> const& perspective,
+      Angle const& angular_resolution) const {
+    // No dark area, wide field of view.
     Planetarium::Parameters parameters(
         /*sphere_radius_multiplier=*/1,
-        /*angular_resolution=*/0.4 * ArcMinute,
+        angular_resolution,
         /*field_of_view=*/90 * Degree);
     return Planetarium(parameters,
                        perspective,
@@ -180,9 +182,11 @@ class Satellites {
 }  // namespace
 
 void RunBenchmark(benchmark::State& state,
-                  Perspective<Navigation, Camera> const& perspective) {
+                  Perspective<Navigation, Camera> const& perspective,
+                  Angle const& angular_resolution = 0.4 * ArcMinute) {
   Satellites satellites;
-  Planetarium planetarium = satellites.MakePlanetarium(perspective);
+  Planetarium planetarium =
+      satellites.MakePlanetarium(perspective, angular_resolution);
   RP2Lines<Length, Camera> lines;
   int total_lines = 0;
   int iterations = 0;
@@ -234,10 +238,26 @@ void BM_PlanetariumPlotMethod2FarEquatorialPerspective(
   RunBenchmark(state, EquatorialPerspective(far));
 }
 
+void BM_PlanetariumPlotMethod2NearPolarPerspectiveFineResolution(
+    benchmark::State& state) {
+  RunBenchmark(state,
+               PolarPerspective(near),
+               /*angular_resolution=*/0.04 * ArcMinute);
+}
+
+void BM_PlanetariumPlotMethod2FarEquatorialPerspectiveFineResolution(
+    benchmark::State& state) {
+  RunBenchmark(state,
+               EquatorialPerspective(far),
+               /*angular_resolution=*/0.04 * ArcMinute);
+}
+
 BENCHMARK(BM_PlanetariumPlotMethod2NearPolarPerspective);
 BENCHMARK(BM_PlanetariumPlotMethod2FarPolarPerspective);
 BENCHMARK(BM_PlanetariumPlotMethod2NearEquatorialPerspective);
 BENCHMARK(BM_PlanetariumPlotMethod2FarEquatorialPerspective);
+BENCHMARK(BM_PlanetariumPlotMethod2NearPolarPerspectiveFineResolution);
+BENCHMARK(BM_PlanetariumPlotMethod2FarEquatorialPerspectiveFineResolution);
 
 }  // namespace geometry
 }  // namespace principia
@@ -1,6 +1,8 @@
 ﻿
 #include <random>
+#include <sstream>
 #include <tuple>
+#include <vector>
 
 #include "astronomy/frames.hpp"
 #include "benchmark/benchmark.h"
@@ -16,8 +18,10 @@ namespace principia {
 
 using astronomy::ICRFJ2000Ecliptic;
 using geometry::Displacement;
+using geometry::Instant;
 using geometry::Multivector;
 using geometry::R3Element;
+using geometry::Velocity;
 using quantities::Length;
 using quantities::Quantity;
 using quantities::SIUnit;
@@ -221,6 +225,104 @@ void BM_EvaluatePolynomialInMonomialBasisDisplacement(benchmark::State& state) {
   }
 }
 
+// Evaluates the value and the derivative of a polynomial with values in
+// |Displacement| over an affine argument, like those of |ContinuousTrajectory|.
+// The three variants evaluate the value and the derivative separately, jointly,
+// or only the value for a batch of arguments.
+enum class EvaluationMode {
+  Separate,
+  Joint,
+  Batch,
+};
+
+template<int degree,
+         template<typename, typename, int> class Evaluator,
+         EvaluationMode mode>
+void EvaluatePolynomialInMonomialBasisWithDerivative(benchmark::State& state) {
+  using P = PolynomialInMonomialBasis<Displacement<ICRFJ2000Ecliptic>,
+                                      Instant,
+                                      degree,
+                                      Evaluator>;
+  std::mt19937_64 random(42);
+  typename P::Coefficients coefficients;
+  RandomTupleGenerator<typename P::Coefficients, 0>::Fill(coefficients,
+                                                          random);
+  Instant const t0;
+  P const p(coefficients, t0);
+
+  auto const min = ValueGenerator<Time>::Get(random);
+  auto const max = ValueGenerator<Time>::Get(random);
+  auto const Δargument = (max - min) * 1e-9;
+  std::vector<Instant> arguments;
+  for (int i = 0; i < evaluations_per_iteration; ++i) {
+    arguments.push_back(t0 + min + i * Δargument);
+  }
+  std::vector<Displacement<ICRFJ2000Ecliptic>> values;
+  auto value_result = Displacement<ICRFJ2000Ecliptic>{};
+  auto derivative_result = Velocity<ICRFJ2000Ecliptic>{};
+
+  while (state.KeepRunning()) {
+    if constexpr (mode == EvaluationMode::Batch) {
+      p.Evaluate(arguments, values);
+      value_result += values.back();
+    } else {
+      for (auto const& argument : arguments) {
+        if constexpr (mode == EvaluationMode::Separate) {
+          value_result += p.P::Evaluate(argument);
+          derivative_result += p.P::EvaluateDerivative(argument);
+        } else {
+          Displacement<ICRFJ2000Ecliptic> value;
+          Velocity<ICRFJ2000Ecliptic> derivative;
+          p.P::EvaluateWithDerivative(argument, value, derivative);
+          value_result += value;
+          derivative_result += derivative;
+        }
+      }
+    }
+  }
+
+  // This weird call to |SetLabel| has no effect except that it uses the
+  // results and therefore prevents the loop from being optimized away.
+  std::stringstream ss;
+  ss << value_result << derivative_result;
+  state.SetLabel(ss.str().substr(0, 0));
+}
+
+#define PRINCIPIA_POLYNOMIAL_DEGREE_CASE(value)                              \
+  case value:                                                                \
+    EvaluatePolynomialInMonomialBasisWithDerivative<value, Evaluator, mode>( \
+        state);                                                              \
+    break
+
+template<template<typename, typename, int> class Evaluator,
+         EvaluationMode mode>
+void BM_EvaluatePolynomialInMonomialBasisWithDerivative(
+    benchmark::State& state) {
+  int const degree = state.range_x();
+  switch (degree) {
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(3);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(4);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(5);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(6);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(7);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(8);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(9);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(10);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(11);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(12);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(13);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(14);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(15);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(16);
+    PRINCIPIA_POLYNOMIAL_DEGREE_CASE(17);
+    default:
+      LOG(FATAL) << "Degree " << degree
+                 << " in BM_EvaluatePolynomialInMonomialBasisWithDerivative";
+  }
+}
+
+#undef PRINCIPIA_POLYNOMIAL_DEGREE_CASE
+
 BENCHMARK_TEMPLATE1(BM_EvaluatePolynomialInMonomialBasisDouble,
                     EstrinEvaluator)
     ->Arg(4)->Arg(8)->Arg(12)->Arg(16);
@@ -246,5 +348,24 @@ BENCHMARK_TEMPLATE1(BM_EvaluatePolynomialInMonomialBasisDisplacement,
                     HornerEvaluator)
     ->Arg(4)->Arg(8)->Arg(12)->Arg(16);
 
+BENCHMARK_TEMPLATE2(BM_EvaluatePolynomialInMonomialBasisWithDerivative,
+                    EstrinEvaluator, EvaluationMode::Separate)
+    ->DenseRange(3, 17);
+BENCHMARK_TEMPLATE2(BM_EvaluatePolynomialInMonomialBasisWithDerivative,
+                    EstrinEvaluator, EvaluationMode::Joint)
+    ->DenseRange(3, 17);
+BENCHMARK_TEMPLATE2(BM_EvaluatePolynomialInMonomialBasisWithDerivative,
+                    EstrinEvaluator, EvaluationMode::Batch)
+    ->DenseRange(3, 17);
+BENCHMARK_TEMPLATE2(BM_EvaluatePolynomialInMonomialBasisWithDerivative,
+                    HornerEvaluator, EvaluationMode::Separate)
+    ->DenseRange(3, 17);
+BENCHMARK_TEMPLATE2(BM_EvaluatePolynomialInMonomialBasisWithDerivative,
+                    HornerEvaluator, EvaluationMode::Joint)
+    ->DenseRange(3, 17);
+BENCHMARK_TEMPLATE2(BM_EvaluatePolynomialInMonomialBasisWithDerivative,
+                    HornerEvaluator, EvaluationMode::Batch)
+    ->DenseRange(3, 17);
+
 }  // namespace numerics
 }  // namespace principia
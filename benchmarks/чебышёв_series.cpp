@@ -208,6 +208,46 @@ void BM_EvaluateDisplacement(benchmark::State& state) {
   state.SetLabel(ss.str().substr(0, 0));
 }
 
+// Evaluates the value and the derivative of the series at
+// |evaluations_per_iteration| times in one call.
+void BM_EvaluateDisplacementWithDerivativeBatch(benchmark::State& state) {
+  int const degree = state.range_x();
+  std::mt19937_64 random(42);
+  std::vector<Displacement<ICRFJ2000Ecliptic>> coefficients;
+  for (int i = 0; i <= degree; ++i) {
+    coefficients.push_back(
+        Displacement<ICRFJ2000Ecliptic>(
+            {static_cast<double>(random()) * Metre,
+             static_cast<double>(random()) * Metre,
+             static_cast<double>(random()) * Metre}));
+  }
+  Instant const t0;
+  Instant const t_min = t0 + static_cast<double>(random()) * Second;
+  Instant const t_max = t_min + static_cast<double>(random()) * Second;
+  ЧебышёвSeries<Displacement<ICRFJ2000Ecliptic>> const series(
+    coefficients, t_min, t_max);
+
+  std::vector<Instant> times;
+  Time const Δt = (t_max - t_min) / evaluations_per_iteration;
+  for (int i = 0; i < evaluations_per_iteration; ++i) {
+    times.push_back(t_min + i * Δt);
+  }
+  std::vector<Displacement<ICRFJ2000Ecliptic>> values;
+  std::vector<Variation<Displacement<ICRFJ2000Ecliptic>>> derivatives;
+  Displacement<ICRFJ2000Ecliptic> result{};
+
+  while (state.KeepRunning()) {
+    series.EvaluateWithDerivative(times, values, derivatives);
+    result += values.back();
+  }
+
+  // This weird call to |SetLabel| has no effect except that it uses |result|
+  // and therefore prevents the loop from being optimized away.
+  std::stringstream ss;
+  ss << result << derivatives.back();
+  state.SetLabel(ss.str().substr(0, 0));
+}
+
 BENCHMARK(BM_EvaluateDouble)->
     Arg(4)->Arg(8)->Arg(15)->Arg(16)->Arg(17)->Arg(18)->Arg(19);
 BENCHMARK(BM_EvaluateQuantity)->
@@ -218,6 +258,8 @@ BENCHMARK(BM_EvaluateVectorDouble)->
     Arg(4)->Arg(8)->Arg(15)->Arg(16)->Arg(17)->Arg(18)->Arg(19);
 BENCHMARK(BM_EvaluateDisplacement)->
     Arg(4)->Arg(8)->Arg(15)->Arg(16)->Arg(17)->Arg(18)->Arg(19);
+BENCHMARK(BM_EvaluateDisplacementWithDerivativeBatch)->
+    Arg(4)->Arg(8)->Arg(15)->Arg(16)->Arg(17)->Arg(18)->Arg(19);
 
 }  // namespace numerics
 }  // namespace principia
@@ -1,6 +1,8 @@
 ﻿
 #pragma once
 
+#include <vector>
+
 #include "geometry/point.hpp"
 #include "geometry/grassmann.hpp"
 #include "serialization/geometry.pb.h"
@@ -26,6 +28,10 @@ class AffineMap final {
 
   AffineMap<ToFrame, FromFrame, Scalar, LinearMap> Inverse() const;
   Point<ToVector> operator()(Point<FromVector> const& point) const;
+  // Applies this map to each of the |points|.  Only available if |LinearMap|
+  // may be applied to a vector of vectors.
+  std::vector<Point<ToVector>> operator()(
+      std::vector<Point<FromVector>> const& points) const;
 
   static AffineMap Identity();
 
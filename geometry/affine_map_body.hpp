@@ -41,6 +41,26 @@ AffineMap<FromFrame, ToFrame, Scalar, LinearMap>::operator()(
           linear_map_(point - from_origin_) + to_origin_);
 }
 
+template<typename FromFrame, typename ToFrame, typename Scalar,
+         template<typename, typename> class LinearMap>
+std::vector<
+    Point<typename AffineMap<FromFrame, ToFrame, Scalar, LinearMap>::ToVector>>
+AffineMap<FromFrame, ToFrame, Scalar, LinearMap>::operator()(
+    std::vector<Point<FromVector>> const& points) const {
+  std::vector<FromVector> displacements;
+  displacements.reserve(points.size());
+  for (auto const& point : points) {
+    displacements.push_back(point - from_origin_);
+  }
+  std::vector<ToVector> const images = linear_map_(displacements);
+  std::vector<Point<ToVector>> result;
+  result.reserve(images.size());
+  for (auto const& image : images) {
+    result.push_back(Point<ToVector>(image + to_origin_));
+  }
+  return result;
+}
+
 template<typename FromFrame, typename ToFrame, typename Scalar,
          template<typename, typename> class LinearMap>
 AffineMap<FromFrame, ToFrame, Scalar, LinearMap>
@@ -1,6 +1,8 @@
 ﻿
 #pragma once
 
+#include <vector>
+
 #include "base/mappable.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/linear_map.hpp"
@@ -50,6 +52,15 @@ class OrthogonalMap : public LinearMap<FromFrame, ToFrame> {
   Trivector<Scalar, ToFrame> operator()(
       Trivector<Scalar, FromFrame> const& trivector) const;
 
+  // Applies this map to each of the |vectors|.  The matrix of the map is
+  // derived from the one cached by |rotation()|, and applying it is cheaper
+  // than applying the quaternion, so this is faster than mapping the vectors
+  // one at a time.  The results may differ from those of the above operator in
+  // the last bits.
+  template<typename Scalar>
+  std::vector<Vector<Scalar, ToFrame>> operator()(
+      std::vector<Vector<Scalar, FromFrame>> const& vectors) const;
+
   template<typename T>
   typename base::Mappable<OrthogonalMap, T>::type operator()(T const& t) const;
 
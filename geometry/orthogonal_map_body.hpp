@@ -5,6 +5,7 @@
 #include "geometry/linear_map.hpp"
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/r3_element.hpp"
+#include "geometry/r3x3_matrix.hpp"
 #include "geometry/sign.hpp"
 
 namespace principia {
@@ -49,6 +50,20 @@ Trivector<Scalar, ToFrame> OrthogonalMap<FromFrame, ToFrame>::operator()(
   return determinant_ * trivector;
 }
 
+template<typename FromFrame, typename ToFrame>
+template<typename Scalar>
+std::vector<Vector<Scalar, ToFrame>> OrthogonalMap<FromFrame, ToFrame>::
+operator()(std::vector<Vector<Scalar, FromFrame>> const& vectors) const {
+  // Reuse the matrix cached by the rotation, if any.
+  R3x3Matrix<double> const matrix = determinant_ * rotation_.matrix();
+  std::vector<Vector<Scalar, ToFrame>> result;
+  result.reserve(vectors.size());
+  for (auto const& vector : vectors) {
+    result.emplace_back(matrix * vector.coordinates());
+  }
+  return result;
+}
+
 template<typename FromFrame, typename ToFrame>
 template<typename T>
 typename base::Mappable<OrthogonalMap<FromFrame, ToFrame>, T>::type
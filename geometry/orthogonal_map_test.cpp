@@ -11,6 +11,7 @@
 #include "quantities/si.hpp"
 #include "serialization/geometry.pb.h"
 #include "testing_utilities/almost_equals.hpp"
+#include "testing_utilities/numerics.hpp"
 
 namespace principia {
 namespace geometry {
@@ -19,7 +20,9 @@ namespace internal_orthogonal_map {
 using quantities::si::Degree;
 using quantities::si::Metre;
 using testing::Eq;
+using testing::Lt;
 using testing_utilities::AlmostEquals;
+using testing_utilities::RelativeError;
 
 class OrthogonalMapTest : public testing::Test {
  protected:
@@ -75,6 +78,21 @@ TEST_F(OrthogonalMapTest, AppliedToVector) {
                                                 2.0 * Metre)), 1, 2));
 }
 
+TEST_F(OrthogonalMapTest, AppliedToVectors) {
+  std::vector<Vector<quantities::Length, World>> const vectors = {
+      vector_,
+      Vector<quantities::Length, World>(
+          R3Element<quantities::Length>(-4.0 * Metre, 0.5 * Metre, 7.0 * Metre))};
+  for (auto const& orthogonal : {orthogonal_a_, orthogonal_b_}) {
+    auto const images = orthogonal(vectors);
+    ASSERT_EQ(2, images.size());
+    for (int i = 0; i < vectors.size(); ++i) {
+      EXPECT_THAT(RelativeError(orthogonal(vectors[i]), images[i]),
+                  Lt(1e-15));
+    }
+  }
+}
+
 TEST_F(OrthogonalMapTest, AppliedToBivector) {
   EXPECT_THAT(orthogonal_a_(bivector_),
               AlmostEquals(Bivector<quantities::Length, World>(
@@ -41,6 +41,9 @@ class Perspective final {
       RigidTransformation<FromFrame, ToFrame> const& to_camera,
       Length const& focal);
 
+  RigidTransformation<ToFrame, FromFrame> const& from_camera() const;
+  RigidTransformation<FromFrame, ToFrame> const& to_camera() const;
+  Position<FromFrame> const& camera() const;
   Length const& focal() const;
 
   // Returns the ℝP² element resulting from the projection of |point|.  This
@@ -78,11 +81,18 @@ class Perspective final {
       Segment<FromFrame> const& segment,
       std::vector<Sphere<FromFrame>> const& spheres) const;
 
+  // Same as above, but the segments are returned in |visible_segments|, whose
+  // previous contents are discarded.  Callers that process many segments may
+  // pass the same vector to each call to avoid allocating.
+  void VisibleSegments(Segment<FromFrame> const& segment,
+                       std::vector<Sphere<FromFrame>> const& spheres,
+                       Segments<FromFrame>& visible_segments) const;
+
  private:
-  RigidTransformation<ToFrame, FromFrame> const from_camera_;
-  RigidTransformation<FromFrame, ToFrame> const to_camera_;
-  Position<FromFrame> const camera_;
-  Length const focal_;
+  RigidTransformation<ToFrame, FromFrame> from_camera_;
+  RigidTransformation<FromFrame, ToFrame> to_camera_;
+  Position<FromFrame> camera_;
+  Length focal_;
 };
 
 }  // namespace internal_perspective
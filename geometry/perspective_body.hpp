@@ -10,6 +10,7 @@
 
 #include "geometry/barycentre_calculator.hpp"
 #include "numerics/root_finders.hpp"
+#include "quantities/elementary_functions.hpp"
 #include "quantities/named_quantities.hpp"
 
 namespace principia {
@@ -20,6 +21,7 @@ using geometry::InnerProduct;
 using numerics::SolveQuadraticEquation;
 using quantities::Pow;
 using quantities::Product;
+using quantities::Sqrt;
 using quantities::Square;
 
 template<typename FromFrame, typename ToFrame>
@@ -40,6 +42,23 @@ Perspective<FromFrame, ToFrame>::Perspective(
       camera_(from_camera_(ToFrame::origin)),
       focal_(focal) {}
 
+template<typename FromFrame, typename ToFrame>
+RigidTransformation<ToFrame, FromFrame> const&
+Perspective<FromFrame, ToFrame>::from_camera() const {
+  return from_camera_;
+}
+
+template<typename FromFrame, typename ToFrame>
+RigidTransformation<FromFrame, ToFrame> const&
+Perspective<FromFrame, ToFrame>::to_camera() const {
+  return to_camera_;
+}
+
+template<typename FromFrame, typename ToFrame>
+Position<FromFrame> const& Perspective<FromFrame, ToFrame>::camera() const {
+  return camera_;
+}
+
 template<typename FromFrame, typename ToFrame>
 Length const& Perspective<FromFrame, ToFrame>::focal() const {
   return focal_;
@@ -359,13 +378,23 @@ template<typename FromFrame, typename ToFrame>
 Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
     Segment<FromFrame> const& segment,
     std::vector<Sphere<FromFrame>> const& spheres) const {
+  Segments<FromFrame> segments;
+  VisibleSegments(segment, spheres, segments);
+  return segments;
+}
+
+template<typename FromFrame, typename ToFrame>
+void Perspective<FromFrame, ToFrame>::VisibleSegments(
+    Segment<FromFrame> const& segment,
+    std::vector<Sphere<FromFrame>> const& spheres,
+    Segments<FromFrame>& segments) const {
   // This algorithm takes the input segment, applies the hiding by the first
   // sphere (which can result in 0, 1, or 2 segments), applies the hiding by the
   // second sphere to the resulting segments, and so on.  To reduce memory
   // allocation this is done in place in the following vector, for which we
   // reserve the maximum possible size.  As hiding proceeds, segments are taken
   // from the vector and replaced or appended as needed.
-  Segments<FromFrame> segments;
+  segments.clear();
   segments.reserve(spheres.size() + 1);
   segments.push_back(segment);
 
@@ -385,11 +414,62 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   int out_begin = 1;
   int out_end = 1;
 
+  // The segment lies in the ball of centre M (its midpoint) and radius ρ,
+  // which is seen from the camera K in a cone of half-angle θ.  This is used
+  // below to cheaply exclude the spheres that cannot hide any part of the
+  // segment.  All the segments produced by hiding lie in that ball so the
+  // exclusion remains valid throughout the outer loop.
+  Position<FromFrame> const& K = camera_;
+  Position<FromFrame> const M =
+      Barycentre<Position<FromFrame>, double>(segment, {0.5, 0.5});
+  Displacement<FromFrame> const KM = M - K;
+  Length const KM_norm = KM.Norm();
+  Length const ρ = 0.5 * (segment.second - segment.first).Norm();
+  // If the camera is in the ball no exclusion takes place.
+  bool const camera_is_outside_ball = KM_norm > ρ;
+  double const sin_θ = camera_is_outside_ball ? ρ / KM_norm : 1.0;
+  double const cos_θ = Sqrt(1.0 - sin_θ * sin_θ);
+
+  // Returns false if |sphere| cannot hide any part of the segment, either
+  // because the ball is entirely in front of it, or because the sphere is seen
+  // in a cone of half-angle φ that doesn't intersect the cone of the ball.  May
+  // return true even if there is no hiding.
+  auto const may_hide = [&K, &KM, KM_norm, ρ, sin_θ, cos_θ,
+                         camera_is_outside_ball](
+                            Sphere<FromFrame> const& sphere) {
+    if (!camera_is_outside_ball) {
+      return true;
+    }
+    Displacement<FromFrame> const KC = sphere.centre() - K;
+    auto const KC² = KC.Norm²();
+    if (KC² <= sphere.radius²()) {
+      // The camera is inside the sphere.
+      return true;
+    }
+    Length const KC_norm = Sqrt(KC²);
+    if (KM_norm + ρ <= KC_norm - sphere.radius()) {
+      return false;
+    }
+    double const sin_φ = sphere.radius() / KC_norm;
+    double const cos_φ = Sqrt(1.0 - sin_φ * sin_φ);
+    // The cones are disjoint iff the angle between KM and KC is at least
+    // θ + φ.  Note that θ + φ < π since both angles are less than π / 2.
+    double const cos_θ_plus_φ = cos_θ * cos_φ - sin_θ * sin_φ;
+    return InnerProduct(KM, KC) > cos_θ_plus_φ * KM_norm * KC_norm;
+  };
+
   // At the beginning and end of the outer loop below all the active segments
   // are stored in a contiguous slice of the vector segments.  That slice
   // doesn't start at 0 iff at least one call to VisibleSegments returned 0
   // segments.
   for (auto const& sphere : spheres) {
+    if (in_begin == in_end) {
+      // Everything is hidden.
+      break;
+    }
+    if (!may_hide(sphere)) {
+      continue;
+    }
     for (int i = in_end - 1; i >= in_begin; --i) {
       auto const& old_segment = segments[i];
       auto const new_segments_for_sphere = VisibleSegments(old_segment, sphere);
@@ -410,7 +490,6 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   if (in_begin > 0) {
     segments.erase(segments.begin(), segments.begin() + in_begin);
   }
-  return segments;
 }
 
 }  // namespace internal_perspective
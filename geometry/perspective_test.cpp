@@ -1,5 +1,9 @@
 ﻿
+#include <algorithm>
+#include <iterator>
 #include <limits>
+#include <random>
+#include <vector>
 
 #include "geometry/affine_map.hpp"
 #include "geometry/frame.hpp"
@@ -34,6 +38,7 @@ using ::testing::ElementsAre;
 using ::testing::IsEmpty;
 using ::testing::Pair;
 using ::testing::SizeIs;
+using ::testing::UnorderedElementsAreArray;
 using ::testing::_;
 
 class PerspectiveTest : public ::testing::Test {
@@ -59,6 +64,7 @@ TEST_F(PerspectiveTest, Basic) {
       world_to_camera_rotation.Forget());
   Perspective<World, Camera> perspective(world_to_camera_transformation,
                                          /*focal=*/10 * Metre);
+  EXPECT_EQ(camera_origin, perspective.camera());
 
   // Check that points in the camera z axis get projected to the origin of ℝP².
   Displacement<World> const camera_z_axis = world_to_camera_rotation.Inverse()(
@@ -606,6 +612,50 @@ TEST_F(VisibleSegmentsTest, MultipleSpheres) {
   EXPECT_THAT(perspective_.VisibleSegments(segment, {sphere_, sphere2}),
               SizeIs(3));
 }
+
+// Checks that excluding the spheres that cannot hide a segment doesn't change
+// the result compared to hiding by each sphere in turn.
+TEST_F(VisibleSegmentsTest, ManySpheres) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(-10.0, 10.0);
+  std::uniform_real_distribution<> radius_distribution(0.1, 1.0);
+  auto random_position = [&distribution, &random]() {
+    return World::origin + Displacement<World>({distribution(random) * Metre,
+                                                distribution(random) * Metre,
+                                                distribution(random) * Metre});
+  };
+
+  std::vector<Sphere<World>> spheres;
+  for (int i = 0; i < 20; ++i) {
+    spheres.emplace_back(random_position(),
+                         radius_distribution(random) * Metre);
+  }
+
+  int hidden = 0;
+  for (int i = 0; i < 1000; ++i) {
+    Segment<World> const segment{random_position(), random_position()};
+    Segments<World> expected_segments = {segment};
+    for (auto const& sphere : spheres) {
+      Segments<World> new_segments;
+      for (auto const& expected_segment : expected_segments) {
+        auto const visible_segments =
+            perspective_.VisibleSegments(expected_segment, sphere);
+        std::copy(visible_segments.begin(),
+                  visible_segments.end(),
+                  std::back_inserter(new_segments));
+      }
+      expected_segments = std::move(new_segments);
+    }
+    if (expected_segments != Segments<World>{segment}) {
+      ++hidden;
+    }
+    EXPECT_THAT(perspective_.VisibleSegments(segment, spheres),
+                UnorderedElementsAreArray(expected_segments));
+  }
+  // Make sure that the test exercises hiding.
+  EXPECT_LT(100, hidden);
+}
+
 }  // namespace internal_perspective
 }  // namespace geometry
 }  // namespace principia
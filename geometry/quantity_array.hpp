@@ -0,0 +1,138 @@
+﻿
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "base/not_constructible.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/point.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace geometry {
+namespace internal_quantity_array {
+
+using base::not_constructible;
+using quantities::Quantity;
+
+// Describes how an element of type |T| is decomposed into |components| doubles,
+// which are its coordinates in SI units.  Specialized for |double|,
+// |Quantity|, the |Multivector|s with coordinates in an |R3Element|, and the
+// |Point|s of such |Multivector|s, whose coordinates are taken with respect to
+// the default-constructed point, e.g., |Frame::origin| for a |Position|.
+template<typename T>
+struct QuantityArrayTraits;
+
+template<>
+struct QuantityArrayTraits<double> : not_constructible {
+  static constexpr int components = 1;
+  static std::array<double, 1> Decompose(double x);
+  static double Compose(std::array<double, 1> const& doubles);
+};
+
+template<typename Dimensions>
+struct QuantityArrayTraits<Quantity<Dimensions>> : not_constructible {
+  static constexpr int components = 1;
+  static std::array<double, 1> Decompose(Quantity<Dimensions> const& x);
+  static Quantity<Dimensions> Compose(std::array<double, 1> const& doubles);
+};
+
+template<typename Scalar, typename Frame, int rank>
+struct QuantityArrayTraits<Multivector<Scalar, Frame, rank>>
+    : not_constructible {
+  static_assert(rank == 1 || rank == 2,
+                "Only vectors and bivectors have three coordinates");
+  static constexpr int components = 3;
+  static std::array<double, 3> Decompose(
+      Multivector<Scalar, Frame, rank> const& x);
+  static Multivector<Scalar, Frame, rank> Compose(
+      std::array<double, 3> const& doubles);
+};
+
+template<typename Vector>
+struct QuantityArrayTraits<Point<Vector>> : not_constructible {
+  static constexpr int components = QuantityArrayTraits<Vector>::components;
+  static std::array<double, components> Decompose(Point<Vector> const& x);
+  static Point<Vector> Compose(std::array<double, components> const& doubles);
+};
+
+// An array of elements of type |T| stored as a structure of arrays: the
+// coordinates of the elements, in SI units, are stored in one contiguous array
+// of doubles per component, e.g., the x, y and z coordinates of a |Position|.
+// This avoids the padding of |R3Element| and lets kernels process consecutive
+// elements with SIMD instructions.  The elements are only accessed by value
+// through this class, which preserves their dimensions and frames; the raw
+// arrays are only exposed by |data|, for use by such kernels.
+template<typename T>
+class QuantityArray final {
+ public:
+  static constexpr int components = QuantityArrayTraits<T>::components;
+
+  // A view on a range of consecutive elements of a |QuantityArray|.  It is
+  // invalidated by the operations that change the size of the array.
+  template<typename Double>
+  class View final {
+   public:
+    std::int64_t size() const;
+
+    T operator[](std::int64_t index) const;
+
+    // Returns the coordinates of the elements along |component|, in SI units.
+    Double* data(int component) const;
+
+   private:
+    View(std::array<Double*, components> const& data, std::int64_t size);
+
+    std::array<Double*, components> data_;
+    std::int64_t size_;
+
+    friend class QuantityArray;
+  };
+  using ConstView = View<double const>;
+  using MutableView = View<double>;
+
+  QuantityArray() = default;
+  // An array of |size| zeroes.
+  explicit QuantityArray(std::int64_t size);
+
+  bool empty() const;
+  std::int64_t size() const;
+
+  // Resizing preserves the elements in the common prefix; new elements are
+  // zero.  The capacity is never decreased, so that an array reused with the
+  // same size doesn't allocate.
+  void resize(std::int64_t size);
+  void reserve(std::int64_t capacity);
+  void clear();
+
+  // Sets all the elements to zero.
+  void assign_zero();
+
+  void push_back(T const& element);
+
+  T operator[](std::int64_t index) const;
+  void Set(std::int64_t index, T const& element);
+
+  // Returns the coordinates of the elements along |component|, in SI units.
+  double* data(int component);
+  double const* data(int component) const;
+
+  // Views on the elements in [begin, end[.
+  ConstView view(std::int64_t begin, std::int64_t end) const;
+  MutableView view(std::int64_t begin, std::int64_t end);
+
+ private:
+  std::array<std::vector<double>, components> coordinates_;
+};
+
+}  // namespace internal_quantity_array
+
+using internal_quantity_array::QuantityArray;
+using internal_quantity_array::QuantityArrayTraits;
+
+}  // namespace geometry
+}  // namespace principia
+
+#include "geometry/quantity_array_body.hpp"
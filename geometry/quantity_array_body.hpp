@@ -0,0 +1,206 @@
+﻿
+#pragma once
+
+#include "geometry/quantity_array.hpp"
+
+#include "geometry/r3_element.hpp"
+#include "glog/logging.h"
+
+namespace principia {
+namespace geometry {
+namespace internal_quantity_array {
+
+using quantities::SIUnit;
+
+inline std::array<double, 1> QuantityArrayTraits<double>::Decompose(
+    double const x) {
+  return {x};
+}
+
+inline double QuantityArrayTraits<double>::Compose(
+    std::array<double, 1> const& doubles) {
+  return doubles[0];
+}
+
+template<typename Dimensions>
+std::array<double, 1> QuantityArrayTraits<Quantity<Dimensions>>::Decompose(
+    Quantity<Dimensions> const& x) {
+  return {x / SIUnit<Quantity<Dimensions>>()};
+}
+
+template<typename Dimensions>
+Quantity<Dimensions> QuantityArrayTraits<Quantity<Dimensions>>::Compose(
+    std::array<double, 1> const& doubles) {
+  return doubles[0] * SIUnit<Quantity<Dimensions>>();
+}
+
+template<typename Scalar, typename Frame, int rank>
+std::array<double, 3>
+QuantityArrayTraits<Multivector<Scalar, Frame, rank>>::Decompose(
+    Multivector<Scalar, Frame, rank> const& x) {
+  R3Element<Scalar> const& coordinates = x.coordinates();
+  return {coordinates.x / SIUnit<Scalar>(),
+          coordinates.y / SIUnit<Scalar>(),
+          coordinates.z / SIUnit<Scalar>()};
+}
+
+template<typename Scalar, typename Frame, int rank>
+Multivector<Scalar, Frame, rank>
+QuantityArrayTraits<Multivector<Scalar, Frame, rank>>::Compose(
+    std::array<double, 3> const& doubles) {
+  return Multivector<Scalar, Frame, rank>({doubles[0] * SIUnit<Scalar>(),
+                                           doubles[1] * SIUnit<Scalar>(),
+                                           doubles[2] * SIUnit<Scalar>()});
+}
+
+template<typename Vector>
+std::array<double, QuantityArrayTraits<Point<Vector>>::components>
+QuantityArrayTraits<Point<Vector>>::Decompose(Point<Vector> const& x) {
+  return QuantityArrayTraits<Vector>::Decompose(x - Point<Vector>());
+}
+
+template<typename Vector>
+Point<Vector> QuantityArrayTraits<Point<Vector>>::Compose(
+    std::array<double, components> const& doubles) {
+  return Point<Vector>() + QuantityArrayTraits<Vector>::Compose(doubles);
+}
+
+template<typename T>
+template<typename Double>
+std::int64_t QuantityArray<T>::View<Double>::size() const {
+  return size_;
+}
+
+template<typename T>
+template<typename Double>
+T QuantityArray<T>::View<Double>::operator[](std::int64_t const index) const {
+  DCHECK_LE(0, index);
+  DCHECK_LT(index, size_);
+  std::array<double, components> doubles;
+  for (int c = 0; c < components; ++c) {
+    doubles[c] = data_[c][index];
+  }
+  return QuantityArrayTraits<T>::Compose(doubles);
+}
+
+template<typename T>
+template<typename Double>
+Double* QuantityArray<T>::View<Double>::data(int const component) const {
+  return data_[component];
+}
+
+template<typename T>
+template<typename Double>
+QuantityArray<T>::View<Double>::View(
+    std::array<Double*, components> const& data,
+    std::int64_t const size)
+    : data_(data),
+      size_(size) {}
+
+template<typename T>
+QuantityArray<T>::QuantityArray(std::int64_t const size) {
+  resize(size);
+}
+
+template<typename T>
+bool QuantityArray<T>::empty() const {
+  return coordinates_[0].empty();
+}
+
+template<typename T>
+std::int64_t QuantityArray<T>::size() const {
+  return coordinates_[0].size();
+}
+
+template<typename T>
+void QuantityArray<T>::resize(std::int64_t const size) {
+  for (auto& coordinates : coordinates_) {
+    coordinates.resize(size);
+  }
+}
+
+template<typename T>
+void QuantityArray<T>::reserve(std::int64_t const capacity) {
+  for (auto& coordinates : coordinates_) {
+    coordinates.reserve(capacity);
+  }
+}
+
+template<typename T>
+void QuantityArray<T>::clear() {
+  for (auto& coordinates : coordinates_) {
+    coordinates.clear();
+  }
+}
+
+template<typename T>
+void QuantityArray<T>::assign_zero() {
+  for (auto& coordinates : coordinates_) {
+    coordinates.assign(coordinates.size(), 0);
+  }
+}
+
+template<typename T>
+void QuantityArray<T>::push_back(T const& element) {
+  auto const doubles = QuantityArrayTraits<T>::Decompose(element);
+  for (int c = 0; c < components; ++c) {
+    coordinates_[c].push_back(doubles[c]);
+  }
+}
+
+template<typename T>
+T QuantityArray<T>::operator[](std::int64_t const index) const {
+  return view(0, size())[index];
+}
+
+template<typename T>
+void QuantityArray<T>::Set(std::int64_t const index, T const& element) {
+  DCHECK_LE(0, index);
+  DCHECK_LT(index, size());
+  auto const doubles = QuantityArrayTraits<T>::Decompose(element);
+  for (int c = 0; c < components; ++c) {
+    coordinates_[c][index] = doubles[c];
+  }
+}
+
+template<typename T>
+double* QuantityArray<T>::data(int const component) {
+  return coordinates_[component].data();
+}
+
+template<typename T>
+double const* QuantityArray<T>::data(int const component) const {
+  return coordinates_[component].data();
+}
+
+template<typename T>
+typename QuantityArray<T>::ConstView QuantityArray<T>::view(
+    std::int64_t const begin,
+    std::int64_t const end) const {
+  CHECK_LE(0, begin);
+  CHECK_LE(begin, end);
+  CHECK_LE(end, size());
+  std::array<double const*, components> data;
+  for (int c = 0; c < components; ++c) {
+    data[c] = coordinates_[c].data() + begin;
+  }
+  return ConstView(data, end - begin);
+}
+
+template<typename T>
+typename QuantityArray<T>::MutableView QuantityArray<T>::view(
+    std::int64_t const begin,
+    std::int64_t const end) {
+  CHECK_LE(0, begin);
+  CHECK_LE(begin, end);
+  CHECK_LE(end, size());
+  std::array<double*, components> data;
+  for (int c = 0; c < components; ++c) {
+    data[c] = coordinates_[c].data() + begin;
+  }
+  return MutableView(data, end - begin);
+}
+
+}  // namespace internal_quantity_array
+}  // namespace geometry
+}  // namespace principia
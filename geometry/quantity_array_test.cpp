@@ -0,0 +1,102 @@
+﻿
+#include "geometry/quantity_array.hpp"
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gtest/gtest.h"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+
+namespace principia {
+
+using quantities::Acceleration;
+using quantities::GravitationalParameter;
+using quantities::Pow;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Second;
+
+namespace geometry {
+
+class QuantityArrayTest : public testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      serialization::Frame::TEST, true>;
+};
+
+TEST_F(QuantityArrayTest, Quantities) {
+  QuantityArray<GravitationalParameter> μ;
+  EXPECT_TRUE(μ.empty());
+  μ.push_back(3 * Pow<3>(Metre) / Pow<2>(Second));
+  μ.push_back(5 * Pow<3>(Kilo(Metre)) / Pow<2>(Second));
+  EXPECT_EQ(2, μ.size());
+  EXPECT_EQ(3 * Pow<3>(Metre) / Pow<2>(Second), μ[0]);
+  EXPECT_EQ(5 * Pow<3>(Kilo(Metre)) / Pow<2>(Second), μ[1]);
+  EXPECT_EQ(3, μ.data(0)[0]);
+  EXPECT_EQ(5e9, μ.data(0)[1]);
+
+  μ.Set(0, 7 * Pow<3>(Metre) / Pow<2>(Second));
+  EXPECT_EQ(7 * Pow<3>(Metre) / Pow<2>(Second), μ[0]);
+
+  μ.resize(3);
+  EXPECT_EQ(3, μ.size());
+  EXPECT_EQ(5 * Pow<3>(Kilo(Metre)) / Pow<2>(Second), μ[1]);
+  EXPECT_EQ(GravitationalParameter(), μ[2]);
+
+  μ.clear();
+  EXPECT_TRUE(μ.empty());
+}
+
+TEST_F(QuantityArrayTest, Vectors) {
+  QuantityArray<Vector<Acceleration, World>> a(2);
+  EXPECT_EQ(Vector<Acceleration, World>(), a[0]);
+  a.Set(1, Vector<Acceleration, World>({1 * Metre / Pow<2>(Second),
+                                        2 * Metre / Pow<2>(Second),
+                                        3 * Metre / Pow<2>(Second)}));
+  EXPECT_EQ(Vector<Acceleration, World>({1 * Metre / Pow<2>(Second),
+                                         2 * Metre / Pow<2>(Second),
+                                         3 * Metre / Pow<2>(Second)}),
+            a[1]);
+  EXPECT_EQ(1, a.data(0)[1]);
+  EXPECT_EQ(2, a.data(1)[1]);
+  EXPECT_EQ(3, a.data(2)[1]);
+
+  a.data(2)[0] = 4;
+  EXPECT_EQ(Vector<Acceleration, World>({0 * Metre / Pow<2>(Second),
+                                         0 * Metre / Pow<2>(Second),
+                                         4 * Metre / Pow<2>(Second)}),
+            a[0]);
+
+  a.assign_zero();
+  EXPECT_EQ(2, a.size());
+  EXPECT_EQ(Vector<Acceleration, World>(), a[1]);
+}
+
+TEST_F(QuantityArrayTest, PointsAndViews) {
+  QuantityArray<Position<World>> q;
+  for (int i = 0; i < 5; ++i) {
+    q.push_back(World::origin +
+                Displacement<World>({i * Metre, 2 * i * Metre, 3 * i * Metre}));
+  }
+  EXPECT_EQ(World::origin, q[0]);
+  EXPECT_EQ(8, q.data(1)[4]);
+
+  auto const view = q.view(2, 4);
+  EXPECT_EQ(2, view.size());
+  EXPECT_EQ(World::origin +
+                Displacement<World>({2 * Metre, 4 * Metre, 6 * Metre}),
+            view[0]);
+  EXPECT_EQ(9, view.data(2)[1]);
+
+  auto const mutable_view = q.view(3, 5);
+  mutable_view.data(0)[1] = -1;
+  EXPECT_EQ(World::origin +
+                Displacement<World>({-1 * Metre, 8 * Metre, 12 * Metre}),
+            q[4]);
+}
+
+}  // namespace geometry
+}  // namespace principia
@@ -1,11 +1,13 @@
 ﻿
 #pragma once
 
+#include <immintrin.h>
 #include <pmmintrin.h>
 
 #include <iostream>
 #include <string>
 
+#include "base/macros.hpp"
 #include "base/not_null.hpp"
 #include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
@@ -29,12 +31,17 @@ struct SphericalCoordinates;
 // An |R3Element<Scalar>| is an element of Scalar³. |Scalar| should be a vector
 // space over ℝ, represented by |double|. |R3Element| is the underlying data
 // type for more advanced strongly typed structures suchas |Multivector|.
+// When AVX2 is available, the coordinates are held in a single |__m256d|, whose
+// last lane is kept at zero.
 template<typename Scalar>
-struct alignas(16) R3Element final {
+struct alignas(PRINCIPIA_USE_AVX2_INTRINSICS ? 32 : 16) R3Element final {
  public:
   R3Element();
   R3Element(Scalar const& x, Scalar const& y, Scalar const& z);
   R3Element(__m128d xy, __m128d zt);
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  explicit R3Element(__m256d xyzt);
+#endif
 
   Scalar&       operator[](int index);
   Scalar const& operator[](int index) const;
@@ -70,6 +77,9 @@ struct alignas(16) R3Element final {
       __m128d xy;
       __m128d zt;
     };
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+    __m256d xyzt;
+#endif
   };
 };
 
@@ -3,6 +3,7 @@
 
 #include "geometry/r3_element.hpp"
 
+#include <immintrin.h>
 #include <pmmintrin.h>
 
 #include <string>
@@ -31,7 +32,12 @@ using quantities::ToM128D;
 
 // We want zero initialization here, so the default constructor won't do.
 template<typename Scalar>
-R3Element<Scalar>::R3Element() : x(), y(), z() {
+R3Element<Scalar>::R3Element()
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+    : xyzt(_mm256_setzero_pd()) {
+#else
+    : x(), y(), z() {
+#endif
   static_assert(std::is_standard_layout<R3Element>::value,
                 "R3Element has a nonstandard layout");
 }
@@ -39,17 +45,37 @@ R3Element<Scalar>::R3Element() : x(), y(), z() {
 template<typename Scalar>
 R3Element<Scalar>::R3Element(Scalar const& x,
                              Scalar const& y,
-                             Scalar const& z) : x(x), y(y), z(z) {
+                             Scalar const& z)
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+    : xyzt(_mm256_setr_pd(x / SIUnit<Scalar>(),
+                          y / SIUnit<Scalar>(),
+                          z / SIUnit<Scalar>(),
+                          0)) {
+#else
+    : x(x), y(y), z(z) {
+#endif
   static_assert(std::is_standard_layout<R3Element>::value,
                 "R3Element has a nonstandard layout");
 }
 
 template<typename Scalar>
 R3Element<Scalar>::R3Element(__m128d const xy, __m128d const zt)
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+    : xyzt(_mm256_set_m128d(_mm_move_sd(_mm_setzero_pd(), zt), xy)) {
+#else
     : xy(xy), zt(zt) {
+#endif
+  static_assert(std::is_standard_layout<R3Element>::value,
+                "R3Element has a nonstandard layout");
+}
+
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+template<typename Scalar>
+R3Element<Scalar>::R3Element(__m256d const xyzt) : xyzt(xyzt) {
   static_assert(std::is_standard_layout<R3Element>::value,
                 "R3Element has a nonstandard layout");
 }
+#endif
 
 template<typename Scalar>
 Scalar& R3Element<Scalar>::operator[](int const index) {
@@ -85,7 +111,9 @@ Scalar const& R3Element<Scalar>::operator[](
 template<typename Scalar>
 R3Element<Scalar>& R3Element<Scalar>::operator+=(
     R3Element<Scalar> const& right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  xyzt = _mm256_add_pd(xyzt, right.xyzt);
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   xy = _mm_add_pd(xy, right.xy);
   zt = _mm_add_sd(zt, right.zt);
 #else
@@ -99,7 +127,9 @@ R3Element<Scalar>& R3Element<Scalar>::operator+=(
 template<typename Scalar>
 R3Element<Scalar>& R3Element<Scalar>::operator-=(
     R3Element<Scalar> const& right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  xyzt = _mm256_sub_pd(xyzt, right.xyzt);
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   xy = _mm_sub_pd(xy, right.xy);
   zt = _mm_sub_sd(zt, right.zt);
 #else
@@ -112,7 +142,9 @@ R3Element<Scalar>& R3Element<Scalar>::operator-=(
 
 template<typename Scalar>
 R3Element<Scalar>& R3Element<Scalar>::operator*=(double const right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  xyzt = _mm256_mul_pd(xyzt, _mm256_broadcastsd_pd(ToM128D(right)));
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   __m128d const right_128d = ToM128D(right);
   xy = _mm_mul_pd(xy, right_128d);
   zt = _mm_mul_sd(zt, right_128d);
@@ -126,7 +158,9 @@ R3Element<Scalar>& R3Element<Scalar>::operator*=(double const right) {
 
 template<typename Scalar>
 R3Element<Scalar>& R3Element<Scalar>::operator/=(double const right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  xyzt = _mm256_div_pd(xyzt, _mm256_broadcastsd_pd(ToM128D(right)));
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   __m128d const right_128d = ToM128D(right);
   xy = _mm_div_pd(xy, right_128d);
   zt = _mm_div_sd(zt, right_128d);
@@ -145,7 +179,11 @@ Scalar R3Element<Scalar>::Norm() const {
 
 template<typename Scalar>
 Square<Scalar> R3Element<Scalar>::Norm²() const {
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  return Dot(*this, *this);
+#else
   return x * x + y * y + z * z;
+#endif
 }
 
 template<typename Scalar>
@@ -220,7 +258,9 @@ R3Element<Scalar> operator-(R3Element<Scalar> const& right) {
 template<typename Scalar>
 R3Element<Scalar> operator+(R3Element<Scalar> const& left,
                             R3Element<Scalar> const& right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  return R3Element<Scalar>(_mm256_add_pd(left.xyzt, right.xyzt));
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   return R3Element<Scalar>(_mm_add_pd(left.xy, right.xy),
                            _mm_add_sd(left.zt, right.zt));
 #else
@@ -233,7 +273,9 @@ R3Element<Scalar> operator+(R3Element<Scalar> const& left,
 template<typename Scalar>
 R3Element<Scalar> operator-(R3Element<Scalar> const& left,
                             R3Element<Scalar> const& right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  return R3Element<Scalar>(_mm256_sub_pd(left.xyzt, right.xyzt));
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   return R3Element<Scalar>(_mm_sub_pd(left.xy, right.xy),
                            _mm_sub_sd(left.zt, right.zt));
 #else
@@ -247,7 +289,10 @@ template<typename LScalar, typename RScalar, typename>
 R3Element<Product<LScalar, RScalar>> operator*(
     LScalar const& left,
     R3Element<RScalar> const& right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  return R3Element<Product<LScalar, RScalar>>(
+      _mm256_mul_pd(right.xyzt, _mm256_broadcastsd_pd(ToM128D(left))));
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   __m128d const left_128d = ToM128D(left);
   return R3Element<Product<LScalar, RScalar>>(_mm_mul_pd(right.xy, left_128d),
                                               _mm_mul_sd(right.zt, left_128d));
@@ -261,7 +306,10 @@ R3Element<Product<LScalar, RScalar>> operator*(
 template<typename LScalar, typename RScalar, typename>
 R3Element<Product<LScalar, RScalar>> operator*(R3Element<LScalar> const& left,
                                                RScalar const& right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  return R3Element<Product<LScalar, RScalar>>(
+      _mm256_mul_pd(left.xyzt, _mm256_broadcastsd_pd(ToM128D(right))));
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   __m128d const right_128d = ToM128D(right);
   return R3Element<Product<LScalar, RScalar>>(_mm_mul_pd(left.xy, right_128d),
                                               _mm_mul_sd(left.zt, right_128d));
@@ -275,7 +323,10 @@ R3Element<Product<LScalar, RScalar>> operator*(R3Element<LScalar> const& left,
 template<typename LScalar, typename RScalar, typename>
 R3Element<Quotient<LScalar, RScalar>> operator/(R3Element<LScalar> const& left,
                                                 RScalar const& right) {
-#if PRINCIPIA_USE_SSE3_INTRINSICS
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  return R3Element<Quotient<LScalar, RScalar>>(
+      _mm256_div_pd(left.xyzt, _mm256_broadcastsd_pd(ToM128D(right))));
+#elif PRINCIPIA_USE_SSE3_INTRINSICS
   __m128d const right_128d = ToM128D(right);
   return R3Element<Quotient<LScalar, RScalar>>(_mm_div_pd(left.xy, right_128d),
                                                _mm_div_sd(left.zt, right_128d));
@@ -341,16 +392,39 @@ template<typename LScalar, typename RScalar>
 R3Element<Product<LScalar, RScalar>> Cross(
     R3Element<LScalar> const& left,
     R3Element<RScalar> const& right) {
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  // The lanes are permuted to {y, z, x, t} and {z, x, y, t}.  The products are
+  // rounded before the subtraction, without FMA, so that the result is the
+  // same as without AVX2.
+  constexpr int yzxt = _MM_SHUFFLE(3, 0, 2, 1);
+  constexpr int zxyt = _MM_SHUFFLE(3, 1, 0, 2);
+  return R3Element<Product<LScalar, RScalar>>(_mm256_sub_pd(
+      _mm256_mul_pd(_mm256_permute4x64_pd(left.xyzt, yzxt),
+                    _mm256_permute4x64_pd(right.xyzt, zxyt)),
+      _mm256_mul_pd(_mm256_permute4x64_pd(left.xyzt, zxyt),
+                    _mm256_permute4x64_pd(right.xyzt, yzxt))));
+#else
   return R3Element<Product<LScalar, RScalar>>(
       left.y * right.z - left.z * right.y,
       left.z * right.x - left.x * right.z,
       left.x * right.y - left.y * right.x);
+#endif
 }
 
 template<typename LScalar, typename RScalar>
 Product<LScalar, RScalar> Dot(R3Element<LScalar> const& left,
                               R3Element<RScalar> const& right) {
+#if PRINCIPIA_USE_AVX2_INTRINSICS
+  // The sum is computed in the same order as without AVX2, i.e.,
+  // (x + y) + z, so that the result is the same.
+  __m256d const products = _mm256_mul_pd(left.xyzt, right.xyzt);
+  __m128d const xy = _mm256_castpd256_pd128(products);
+  __m128d const zt = _mm256_extractf128_pd(products, 1);
+  __m128d const sum = _mm_add_sd(_mm_add_sd(xy, _mm_unpackhi_pd(xy, xy)), zt);
+  return _mm_cvtsd_f64(sum) * SIUnit<Product<LScalar, RScalar>>();
+#else
   return left.x * right.x + left.y * right.y + left.z * right.z;
+#endif
 }
 
 inline R3Element<double> BasisVector(int const i) {
@@ -22,6 +22,7 @@
 namespace principia {
 
 using quantities::Length;
+using quantities::Product;
 using quantities::Speed;
 using quantities::Sqrt;
 using quantities::Time;
@@ -126,6 +127,21 @@ TEST_F(R3ElementTest, MixedProduct) {
   EXPECT_THAT((u_ * t) / t, AlmostEquals(u_, 1));
 }
 
+// The results must not depend on the instruction set, so they are compared
+// bitwise to the naïve evaluation.
+TEST_F(R3ElementTest, ComponentwiseEvaluation) {
+  EXPECT_EQ(v_.x * w_.x + v_.y * w_.y + v_.z * w_.z, Dot(v_, w_));
+  EXPECT_EQ(a_.x * a_.x + a_.y * a_.y + a_.z * a_.z, a_.Norm²());
+  EXPECT_EQ(R3Element<Product<Speed, Speed>>(v_.y * w_.z - v_.z * w_.y,
+                                             v_.z * w_.x - v_.x * w_.z,
+                                             v_.x * w_.y - v_.y * w_.x),
+            Cross(v_, w_));
+  Time const t = 7 * Second;
+  EXPECT_EQ(R3Element<Length>(v_.x * t, v_.y * t, v_.z * t), v_ * t);
+  EXPECT_EQ(R3Element<Speed>(v_.x / π, v_.y / π, v_.z / π), v_ / π);
+  EXPECT_EQ(R3Element<Speed>(v_.x - w_.x, v_.y - w_.y, v_.z - w_.z), v_ - w_);
+}
+
 #ifdef _DEBUG
 TEST_F(R3ElementDeathTest, OrthogonalizeError) {
   R3Element<Speed> v1 = {1 * Knot, -2 * Knot, 5 * Knot};
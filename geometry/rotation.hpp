@@ -1,6 +1,11 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
 #include "base/mappable.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/linear_map.hpp"
@@ -72,6 +77,10 @@ class Rotation : public LinearMap<FromFrame, ToFrame> {
  public:
   explicit Rotation(Quaternion const& quaternion);
 
+  // The cached matrix, if any, is copied along with the quaternion.
+  Rotation(Rotation const& other);
+  Rotation& operator=(Rotation const& other);
+
   // A rotation of |angle| around |axis|; no coordinate change is involved, this
   // is an active rotation.
   template<typename Scalar,
@@ -209,6 +218,12 @@ class Rotation : public LinearMap<FromFrame, ToFrame> {
   Trivector<Scalar, ToFrame> operator()(
       Trivector<Scalar, FromFrame> const& trivector) const;
 
+  // Applies this rotation to each of the |vectors| using its |matrix()|.  The
+  // results may differ from those of the above operator in the last bits.
+  template<typename Scalar>
+  std::vector<Vector<Scalar, ToFrame>> operator()(
+      std::vector<Vector<Scalar, FromFrame>> const& vectors) const;
+
   template<typename T>
   typename base::Mappable<Rotation, T>::type operator()(T const& t) const;
 
@@ -218,6 +233,13 @@ class Rotation : public LinearMap<FromFrame, ToFrame> {
 
   Quaternion const& quaternion() const;
 
+  // The matrix of this rotation, whose columns are the images of the basis
+  // vectors of |FromFrame|.  It is computed from the quaternion the first time
+  // it is needed, and cached, so that a rotation that is applied to many
+  // vectors, possibly by several batch calls, is converted only once.  This
+  // function may be called concurrently on the same object.
+  R3x3Matrix<double> matrix() const;
+
   void WriteToMessage(not_null<serialization::LinearMap*> message) const;
   static Rotation ReadFromMessage(serialization::LinearMap const& message);
 
@@ -230,6 +252,17 @@ class Rotation : public LinearMap<FromFrame, ToFrame> {
 
   Quaternion quaternion_;
 
+  // The cache of |matrix()|.  |matrix_| is only written by the thread that
+  // moves |matrix_state_| from |Absent| to |Computing|, and only read once
+  // |matrix_state_| is |Present|.
+  enum class MatrixState : std::uint8_t {
+    Absent,
+    Computing,
+    Present,
+  };
+  mutable std::atomic<MatrixState> matrix_state_{MatrixState::Absent};
+  mutable std::optional<R3x3Matrix<double>> matrix_;
+
   // For constructing a rotation using a quaternion.
   template<typename From, typename To>
   friend class Permutation;
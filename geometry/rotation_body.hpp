@@ -4,11 +4,13 @@
 #include "geometry/rotation.hpp"
 
 #include <algorithm>
+#include <vector>
 
 #include "geometry/grassmann.hpp"
 #include "geometry/linear_map.hpp"
 #include "geometry/quaternion.hpp"
 #include "geometry/r3_element.hpp"
+#include "geometry/r3x3_matrix.hpp"
 #include "geometry/sign.hpp"
 #include "quantities/elementary_functions.hpp"
 
@@ -64,6 +66,24 @@ FORCE_INLINE(inline) Quaternion ToQuaternion(R3x3Matrix<double> const& matrix) {
   return Quaternion(real_part, imaginary_part);
 }
 
+// The inverse of the above: the matrix of the rotation defined by the unit
+// |quaternion|.
+FORCE_INLINE(inline) R3x3Matrix<double> ToMatrix(Quaternion const& quaternion) {
+  double const w = quaternion.real_part();
+  double const x = quaternion.imaginary_part().x;
+  double const y = quaternion.imaginary_part().y;
+  double const z = quaternion.imaginary_part().z;
+  return R3x3Matrix<double>({1 - 2 * (y * y + z * z),
+                             2 * (x * y - w * z),
+                             2 * (x * z + w * y)},
+                            {2 * (x * y + w * z),
+                             1 - 2 * (x * x + z * z),
+                             2 * (y * z - w * x)},
+                            {2 * (x * z - w * y),
+                             2 * (y * z + w * x),
+                             1 - 2 * (x * x + y * y)});
+}
+
 // Returns a rotation of |angle| around |axis|.  |axis| must be normalized.
 inline Quaternion AngleAxis(Angle const& angle, R3Element<double> const& axis) {
   quantities::Angle const half_angle = 0.5 * angle;
@@ -82,6 +102,34 @@ template<typename FromFrame, typename ToFrame>
 Rotation<FromFrame, ToFrame>::Rotation(Quaternion const& quaternion)
     : quaternion_(quaternion) {}
 
+template<typename FromFrame, typename ToFrame>
+Rotation<FromFrame, ToFrame>::Rotation(Rotation const& other)
+    : LinearMap<FromFrame, ToFrame>(other),
+      quaternion_(other.quaternion_) {
+  if (other.matrix_state_.load(std::memory_order_acquire) ==
+      MatrixState::Present) {
+    matrix_ = other.matrix_;
+    matrix_state_.store(MatrixState::Present, std::memory_order_relaxed);
+  }
+}
+
+template<typename FromFrame, typename ToFrame>
+Rotation<FromFrame, ToFrame>& Rotation<FromFrame, ToFrame>::operator=(
+    Rotation const& other) {
+  if (this != &other) {
+    quaternion_ = other.quaternion_;
+    if (other.matrix_state_.load(std::memory_order_acquire) ==
+        MatrixState::Present) {
+      matrix_ = other.matrix_;
+      matrix_state_.store(MatrixState::Present, std::memory_order_relaxed);
+    } else {
+      matrix_.reset();
+      matrix_state_.store(MatrixState::Absent, std::memory_order_relaxed);
+    }
+  }
+  return *this;
+}
+
 template<typename FromFrame, typename ToFrame>
 template<typename Scalar, typename F, typename T, typename>
 Rotation<FromFrame, ToFrame>::Rotation(quantities::Angle const& angle,
@@ -207,6 +255,19 @@ Trivector<Scalar, ToFrame> Rotation<FromFrame, ToFrame>::operator()(
   return trivector;
 }
 
+template<typename FromFrame, typename ToFrame>
+template<typename Scalar>
+std::vector<Vector<Scalar, ToFrame>> Rotation<FromFrame, ToFrame>::operator()(
+    std::vector<Vector<Scalar, FromFrame>> const& vectors) const {
+  R3x3Matrix<double> const matrix = this->matrix();
+  std::vector<Vector<Scalar, ToFrame>> result;
+  result.reserve(vectors.size());
+  for (auto const& vector : vectors) {
+    result.emplace_back(matrix * vector.coordinates());
+  }
+  return result;
+}
+
 template<typename FromFrame, typename ToFrame>
 template<typename T>
 typename base::Mappable<Rotation<FromFrame, ToFrame>, T>::type
@@ -229,6 +290,24 @@ Quaternion const& Rotation<FromFrame, ToFrame>::quaternion() const {
   return quaternion_;
 }
 
+template<typename FromFrame, typename ToFrame>
+R3x3Matrix<double> Rotation<FromFrame, ToFrame>::matrix() const {
+  if (matrix_state_.load(std::memory_order_acquire) == MatrixState::Present) {
+    return *matrix_;
+  }
+  R3x3Matrix<double> const matrix = ToMatrix(quaternion_);
+  // If another thread is already filling the cache, we don't wait for it, we
+  // just return the matrix that we computed.
+  MatrixState absent = MatrixState::Absent;
+  if (matrix_state_.compare_exchange_strong(absent,
+                                            MatrixState::Computing,
+                                            std::memory_order_relaxed)) {
+    matrix_ = matrix;
+    matrix_state_.store(MatrixState::Present, std::memory_order_release);
+  }
+  return matrix;
+}
+
 template<typename FromFrame, typename ToFrame>
 void Rotation<FromFrame, ToFrame>::WriteToMessage(
     not_null<serialization::LinearMap*> const message) const {
@@ -13,6 +13,7 @@
 #include "serialization/geometry.pb.h"
 #include "testing_utilities/almost_equals.hpp"
 #include "testing_utilities/componentwise.hpp"
+#include "testing_utilities/numerics.hpp"
 #include "testing_utilities/vanishes_before.hpp"
 
 namespace principia {
@@ -27,6 +28,7 @@ using quantities::si::Radian;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
 using testing_utilities::Componentwise;
+using testing_utilities::RelativeError;
 using testing_utilities::VanishesBefore;
 using ::testing::Eq;
 using ::testing::Gt;
@@ -159,6 +161,42 @@ TEST_F(RotationTest, Composition) {
                                                 -3.0 * Metre)), 4, 6));
 }
 
+TEST_F(RotationTest, Matrix) {
+  for (auto const& rotation : {rotation_a_, rotation_b_, rotation_c_}) {
+    R3x3Matrix<double> const matrix = rotation.matrix();
+    for (auto const& e : {e1_, e2_, e3_}) {
+      EXPECT_THAT(RelativeError(rotation(e).coordinates(),
+                                matrix * e.coordinates()),
+                  Lt(1e-15));
+    }
+    // The cached matrix is returned, and it survives copies.
+    EXPECT_THAT(rotation.matrix(), Eq(matrix));
+    Rot copy = Rot::Identity();
+    copy = rotation;
+    EXPECT_THAT(Rot(rotation).matrix(), Eq(matrix));
+    EXPECT_THAT(copy.matrix(), Eq(matrix));
+    copy = Rot::Identity();
+    EXPECT_THAT(copy.matrix(), Eq(Rot::Identity().matrix()));
+  }
+}
+
+TEST_F(RotationTest, AppliedToVectors) {
+  std::vector<Vector<quantities::Length, World>> const vectors = {
+      vector_,
+      Vector<quantities::Length, World>(
+          R3Element<quantities::Length>(-4.0 * Metre,
+                                        0.5 * Metre,
+                                        7.0 * Metre))};
+  Rot const rotation_ab = rotation_a_ * rotation_b_;
+  for (auto const& rotation : {rotation_a_, rotation_b_, rotation_ab}) {
+    auto const images = rotation(vectors);
+    ASSERT_EQ(2, images.size());
+    for (int i = 0; i < vectors.size(); ++i) {
+      EXPECT_THAT(RelativeError(rotation(vectors[i]), images[i]), Lt(1e-15));
+    }
+  }
+}
+
 TEST_F(RotationTest, Forget) {
   Orth const orthogonal_a = rotation_a_.Forget();
   EXPECT_THAT(orthogonal_a(vector_),
@@ -2,12 +2,15 @@
 #pragma once
 
 #include "base/not_constructible.hpp"
+#include "base/snapshot.hpp"
 
 namespace principia {
 namespace geometry {
 namespace internal_serialization {
 
 using base::not_constructible;
+using base::SnapshotReader;
+using base::SnapshotWriter;
 
 // A helper class that serializes a |double|, a |Quantity|, a |Point| or a
 // |Multivector| to a protobuf structure like:
@@ -60,10 +63,18 @@ struct PointOrMultivectorSerializer : not_constructible {};
 template<typename T, typename Message>
 struct QuantityOrMultivectorSerializer : not_constructible {};
 
+// A helper class that writes a |double|, a |Quantity|, a |Point| or a
+// |Multivector| to a flat binary snapshot as its coordinates in SI units, and
+// reads it back.  The values themselves are not snapshotted because they are
+// not trivially copyable with all compilers (e.g., |Point| with MSVC).
+template<typename T>
+struct DoubleOrQuantityOrPointOrMultivectorSnapshotter : not_constructible {};
+
 }  // namespace internal_serialization
 
 using internal_serialization::DoubleOrQuantityOrPointOrMultivectorSerializer;
 using internal_serialization::DoubleOrQuantityOrMultivectorSerializer;
+using internal_serialization::DoubleOrQuantityOrPointOrMultivectorSnapshotter;
 using internal_serialization::PointOrMultivectorSerializer;
 using internal_serialization::QuantityOrMultivectorSerializer;
 
@@ -6,6 +6,7 @@
 #include "base/not_null.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/point.hpp"
+#include "geometry/r3_element.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/serialization.hpp"
 
@@ -16,6 +17,7 @@ namespace internal_serialization {
 using base::not_null;
 using quantities::DoubleOrQuantitySerializer;
 using quantities::Quantity;
+using quantities::SIUnit;
 
 template<typename Message>
 class DoubleOrQuantityOrPointOrMultivectorSerializer<double, Message>
@@ -87,6 +89,78 @@ template<typename Dimensions, typename Message>
 class QuantityOrMultivectorSerializer<Quantity<Dimensions>, Message>
     : public DoubleOrQuantitySerializer<Quantity<Dimensions>, Message> {};
 
+template<>
+struct DoubleOrQuantityOrPointOrMultivectorSnapshotter<double>
+    : not_constructible {
+  static void WriteToSnapshot(double const t, SnapshotWriter& writer) {
+    writer.Write(t);
+  }
+
+  static double ReadFromSnapshot(SnapshotReader& reader) {
+    return reader.Read<double>();
+  }
+};
+
+template<typename Dimensions>
+struct DoubleOrQuantityOrPointOrMultivectorSnapshotter<Quantity<Dimensions>>
+    : not_constructible {
+  using T = Quantity<Dimensions>;
+  static void WriteToSnapshot(T const& t, SnapshotWriter& writer) {
+    writer.Write(t / SIUnit<T>());
+  }
+
+  static T ReadFromSnapshot(SnapshotReader& reader) {
+    return reader.Read<double>() * SIUnit<T>();
+  }
+};
+
+template<typename Scalar, typename Frame, int rank>
+struct DoubleOrQuantityOrPointOrMultivectorSnapshotter<
+    Multivector<Scalar, Frame, rank>> : not_constructible {
+  using T = Multivector<Scalar, Frame, rank>;
+  using ScalarSnapshotter =
+      DoubleOrQuantityOrPointOrMultivectorSnapshotter<Scalar>;
+  static void WriteToSnapshot(T const& t, SnapshotWriter& writer) {
+    if constexpr (rank == 3) {
+      ScalarSnapshotter::WriteToSnapshot(t.coordinates(), writer);
+    } else {
+      ScalarSnapshotter::WriteToSnapshot(t.coordinates().x, writer);
+      ScalarSnapshotter::WriteToSnapshot(t.coordinates().y, writer);
+      ScalarSnapshotter::WriteToSnapshot(t.coordinates().z, writer);
+    }
+  }
+
+  static T ReadFromSnapshot(SnapshotReader& reader) {
+    if constexpr (rank == 3) {
+      return T(ScalarSnapshotter::ReadFromSnapshot(reader));
+    } else {
+      // The order of evaluation of the arguments of a constructor is
+      // unspecified, so read the coordinates one by one.
+      Scalar const x = ScalarSnapshotter::ReadFromSnapshot(reader);
+      Scalar const y = ScalarSnapshotter::ReadFromSnapshot(reader);
+      Scalar const z = ScalarSnapshotter::ReadFromSnapshot(reader);
+      return T(R3Element<Scalar>(x, y, z));
+    }
+  }
+};
+
+// A point is snapshotted as its difference with the default-constructed point,
+// e.g., the J2000 epoch for an |Instant| or the origin for a |Position|.
+template<typename Vector>
+struct DoubleOrQuantityOrPointOrMultivectorSnapshotter<Point<Vector>>
+    : not_constructible {
+  using T = Point<Vector>;
+  using VectorSnapshotter =
+      DoubleOrQuantityOrPointOrMultivectorSnapshotter<Vector>;
+  static void WriteToSnapshot(T const& t, SnapshotWriter& writer) {
+    VectorSnapshotter::WriteToSnapshot(t - T(), writer);
+  }
+
+  static T ReadFromSnapshot(SnapshotReader& reader) {
+    return T() + VectorSnapshotter::ReadFromSnapshot(reader);
+  }
+};
+
 }  // namespace internal_serialization
 }  // namespace geometry
 }  // namespace principia
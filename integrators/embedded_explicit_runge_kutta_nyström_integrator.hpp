@@ -61,6 +61,7 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
   using ODE = SpecialSecondOrderDifferentialEquation<Position>;
   using typename Integrator<ODE>::AppendState;
   using typename AdaptiveStepSizeIntegrator<ODE>::Parameters;
+  using typename AdaptiveStepSizeIntegrator<ODE>::StepSizeController;
   using typename AdaptiveStepSizeIntegrator<ODE>::ToleranceToErrorRatio;
 
   static constexpr auto higher_order = Method::higher_order;
@@ -89,6 +90,19 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
     void WriteToMessage(
         not_null<serialization::IntegratorInstance*> message) const override;
 
+    // Evaluates the continuous extension of the method on the step that was
+    // just accepted, i.e., at a time |t| between the times of the last two
+    // states passed to |append_state|, and stores the result in |positions|
+    // and |velocities|, which are resized as needed.  Must only be called
+    // from |append_state|.  The extension is the quintic Hermite interpolant
+    // of the positions, velocities and accelerations at the ends of the step,
+    // which are all known for a method having the first-same-as-last
+    // property, so it doesn't require additional evaluations.  Its error is
+    // O(h⁶), smaller than the local error of the method.
+    void DenseOutput(Instant const& t,
+                     std::vector<Position>& positions,
+                     std::vector<typename ODE::Velocity>& velocities) const;
+
    private:
     Instance(IntegrationProblem<ODE> const& problem,
              AppendState const& append_state,
@@ -97,6 +111,23 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
              EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator);
 
     EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator_;
+
+    // Buffers for |Solve|.  They are sized for the dimension of the problem at
+    // construction and reused across calls, so that the steps don't allocate.
+    // State before the last, truncated step.
+    typename ODE::SystemState final_state_;
+    // Position increment (high-order).
+    std::vector<typename ODE::Displacement> Δq_hat_;
+    // Velocity increment (high-order).
+    std::vector<typename ODE::Velocity> Δv_hat_;
+    // Difference between the low- and high-order approximations.
+    typename ODE::SystemStateError error_estimate_;
+    // Current Runge-Kutta-Nyström stage.
+    std::vector<Position> q_stage_;
+    // Accelerations at each stage.
+    // TODO(egg): this is a rectangular container, use something more
+    // appropriate.
+    std::vector<std::vector<typename ODE::Acceleration>> g_;
     friend class EmbeddedExplicitRungeKuttaNyströmIntegrator;
   };
 
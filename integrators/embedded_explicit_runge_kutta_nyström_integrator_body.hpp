@@ -6,7 +6,6 @@
 #include <algorithm>
 #include <cmath>
 #include <ctime>
-#include <optional>
 #include <vector>
 
 #include "geometry/sign.hpp"
@@ -20,10 +19,17 @@ namespace internal_embedded_explicit_runge_kutta_nyström_integrator {
 using base::make_not_null_unique;
 using geometry::Sign;
 using numerics::DoublePrecision;
+using numerics::Increment;
 using quantities::DebugString;
 using quantities::Difference;
 using quantities::Quotient;
 
+// The gains of the proportional-integral step size controller, see Gustafsson
+// (1991), Control theoretic techniques for stepsize selection in explicit
+// Runge-Kutta methods.
+constexpr double pi_proportional_gain = 0.7;
+constexpr double pi_integral_gain = 0.4;
+
 template<typename Method, typename Position>
 EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 EmbeddedExplicitRungeKuttaNyströmIntegrator() {
@@ -59,13 +65,17 @@ Instance::Solve(Instant const& t_final) {
   auto& current_state = this->current_state_;
   auto& first_use = this->first_use_;
   auto& parameters = this->parameters_;
+  auto& statistics = this->statistics_;
+  auto& last_tolerance_to_error_ratio = this->last_tolerance_to_error_ratio_;
   auto const& equation = this->equation_;
 
   // |current_state| gets updated as the integration progresses to allow
   // restartability.
 
-  // State before the last, truncated step.
-  std::optional<typename ODE::SystemState> final_state;
+  // State before the last, truncated step.  Copied to a buffer to avoid
+  // allocating.
+  typename ODE::SystemState& final_state = final_state_;
+  bool has_final_state = false;
 
   // Argument checks.
   int const dimension = current_state.positions.size();
@@ -88,9 +98,9 @@ Instance::Solve(Instant const& t_final) {
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment (high-order).
-  std::vector<Displacement> Δq_hat(dimension);
+  std::vector<Displacement>& Δq_hat = Δq_hat_;
   // Velocity increment (high-order).
-  std::vector<Velocity> Δv_hat(dimension);
+  std::vector<Velocity>& Δv_hat = Δv_hat_;
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q_hat = current_state.positions;
@@ -99,15 +109,20 @@ Instance::Solve(Instant const& t_final) {
   std::vector<DoublePrecision<Velocity>>& v_hat = current_state.velocities;
 
   // Difference between the low- and high-order approximations.
-  typename ODE::SystemStateError error_estimate;
-  error_estimate.position_error.resize(dimension);
-  error_estimate.velocity_error.resize(dimension);
+  typename ODE::SystemStateError& error_estimate = error_estimate_;
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
   // Accelerations at each stage.
-  // TODO(egg): this is a rectangular container, use something more appropriate.
-  std::vector<std::vector<Acceleration>> g(stages_);
+  std::vector<std::vector<Acceleration>>& g = g_;
+
+  // The buffers are sized at construction, these are no-ops unless the
+  // dimension of |current_state| has changed.
+  Δq_hat.resize(dimension);
+  Δv_hat.resize(dimension);
+  error_estimate.position_error.resize(dimension);
+  error_estimate.velocity_error.resize(dimension);
+  q_stage.resize(dimension);
   for (auto& g_stage : g) {
     g_stage.resize(dimension);
   }
@@ -126,6 +141,14 @@ Instance::Solve(Instant const& t_final) {
 
   Status status;
 
+  // The exponent used by the step size control.
+  // TODO(egg): find out whether there's a smarter way to compute that root,
+  // especially since we make the order compile-time.
+  double const exponent = 1.0 / (lower_order + 1);
+
+  // True if the error of the last attempted step was too large.
+  bool last_attempt_rejected = false;
+
   // No step size control on the first step.  If this instance is being
   // restarted we already have a value of |h| suitable for the next step, based
   // on the computation of |tolerance_to_error_ratio_| during the last
@@ -137,10 +160,28 @@ Instance::Solve(Instant const& t_final) {
     // tolerable.
     do {
       // Adapt step size.
-      // TODO(egg): find out whether there's a smarter way to compute that root,
-      // especially since we make the order compile-time.
-      h *= parameters.safety_factor *
-               std::pow(tolerance_to_error_ratio, 1.0 / (lower_order + 1));
+      if (last_attempt_rejected) {
+        ++statistics.rejected_steps;
+        h *= parameters.safety_factor *
+                 std::pow(tolerance_to_error_ratio, exponent);
+      } else {
+        // The PI controller is only meaningful if the ratios are finite, e.g.,
+        // not for the exact steps of a trivial equation.
+        if (parameters.step_size_controller == StepSizeController::PI &&
+            last_tolerance_to_error_ratio.has_value() &&
+            std::isfinite(tolerance_to_error_ratio) &&
+            std::isfinite(*last_tolerance_to_error_ratio)) {
+          h *= parameters.safety_factor *
+                   std::pow(tolerance_to_error_ratio,
+                            pi_proportional_gain * exponent) *
+                   std::pow(*last_tolerance_to_error_ratio,
+                            -pi_integral_gain * exponent);
+        } else {
+          h *= parameters.safety_factor *
+                   std::pow(tolerance_to_error_ratio, exponent);
+        }
+        last_tolerance_to_error_ratio = tolerance_to_error_ratio;
+      }
       // TODO(egg): should we check whether it vanishes in double precision
       // instead?
       if (t.value + (t.error + h) == t.value) {
@@ -161,6 +202,7 @@ Instance::Solve(Instant const& t_final) {
           // end, and terminate if the step is accepted.
           h = time_to_end;
           final_state = current_state;
+          has_final_state = true;
         }
       }
 
@@ -176,6 +218,7 @@ Instance::Solve(Instant const& t_final) {
                            h * (c[i] * v_hat[k].value + h * Σj_a_ij_g_jk);
         }
         status.Update(equation.compute_acceleration(t_stage, q_stage, g[i]));
+        ++statistics.function_evaluations;
       }
 
       // Increment computation and step size control.
@@ -203,11 +246,13 @@ Instance::Solve(Instant const& t_final) {
       }
       tolerance_to_error_ratio =
           this->tolerance_to_error_ratio_(h, error_estimate);
-    } while (tolerance_to_error_ratio < 1.0);
+      last_attempt_rejected = tolerance_to_error_ratio < 1.0;
+    } while (last_attempt_rejected);
 
     if (!parameters.last_step_is_exact && t.value + (t.error + h) > t_final) {
       // We did overshoot.  Drop the point that we just computed and exit.
       final_state = current_state;
+      has_final_state = true;
       break;
     }
 
@@ -219,12 +264,11 @@ Instance::Solve(Instant const& t_final) {
 
     // Increment the solution with the high-order approximation.
     t.Increment(h);
-    for (int k = 0; k < dimension; ++k) {
-      q_hat[k].Increment(Δq_hat[k]);
-      v_hat[k].Increment(Δv_hat[k]);
-    }
+    Increment(q_hat, Δq_hat);
+    Increment(v_hat, Δv_hat);
     append_state(current_state);
     ++step_count;
+    ++statistics.steps;
     if (step_count == parameters.max_steps && !at_end) {
       return Status(termination_condition::ReachedMaximalStepCount,
                     "Reached maximum step count " +
@@ -235,8 +279,8 @@ Instance::Solve(Instant const& t_final) {
     }
   }
   // The resolution is restartable from the last non-truncated state.
-  CHECK(final_state);
-  current_state = *final_state;
+  CHECK(has_final_state);
+  current_state = final_state;
   return status;
 }
 
@@ -270,6 +314,65 @@ Instance::WriteToMessage(
                       extension);
 }
 
+template<typename Method, typename Position>
+void EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
+Instance::DenseOutput(Instant const& t,
+                      std::vector<Position>& positions,
+                      std::vector<typename ODE::Velocity>& velocities) const {
+  static_assert(first_same_as_last,
+                "Dense output requires the first-same-as-last property");
+  using Velocity = typename ODE::Velocity;
+
+  auto const& current_state = this->current_state_;
+  int const dimension = current_state.positions.size();
+  // The step that was just accepted.
+  Time const& h = this->time_step_;
+  // The state at the end of the step.
+  std::vector<DoublePrecision<Position>> const& q_hat =
+      current_state.positions;
+  std::vector<DoublePrecision<Velocity>> const& v_hat =
+      current_state.velocities;
+  // The FSAL swap at the end of the step has put the accelerations at the
+  // beginning and at the end of the step at the back and at the front of |g_|,
+  // respectively.
+  auto const& g_initial = g_.back();
+  auto const& g_final = g_.front();
+
+  // The position of |t| in the step, 0 at the beginning and 1 at the end.
+  double const s =
+      1 + ((t - current_state.time.value) - current_state.time.error) / h;
+  double const s² = s * s;
+  double const s³ = s² * s;
+
+  // The quintic Hermite basis and its derivatives.  The coefficient of the
+  // position at the beginning of the step is not used since the interpolant
+  // is computed relative to the end of the step, hence the term in |h3|
+  // below.
+  double const h1 = s * (1 + s² * (-6 + s * (8 - 3 * s)));
+  double const h2 = 0.5 * s² * (1 + s * (-3 + s * (3 - s)));
+  double const h3 = s³ * (10 + s * (-15 + 6 * s)) - 1;
+  double const h4 = s³ * (-4 + s * (7 - 3 * s));
+  double const h5 = 0.5 * s³ * (1 + s * (-2 + s));
+  double const h1_prime = 1 + s² * (-18 + s * (32 - 15 * s));
+  double const h2_prime = 0.5 * s * (2 + s * (-9 + s * (12 - 5 * s)));
+  double const h3_prime = 30 * s² * (1 + s * (-2 + s));
+  double const h4_prime = s² * (-12 + s * (28 - 15 * s));
+  double const h5_prime = 0.5 * s² * (3 + s * (-8 + 5 * s));
+
+  positions.resize(dimension);
+  velocities.resize(dimension);
+  for (int k = 0; k < dimension; ++k) {
+    Velocity const v_initial = v_hat[k].value - Δv_hat_[k];
+    positions[k] = q_hat[k].value +
+                   (h * (h1 * v_initial + h4 * v_hat[k].value +
+                         h * (h2 * g_initial[k] + h5 * g_final[k])) +
+                    h3 * Δq_hat_[k]);
+    velocities[k] = h1_prime * v_initial + h4_prime * v_hat[k].value +
+                    h * (h2_prime * g_initial[k] + h5_prime * g_final[k]) +
+                    h3_prime * Δq_hat_[k] / h;
+  }
+}
+
 template<typename Method, typename Position>
 EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 Instance::Instance(
@@ -280,7 +383,17 @@ Instance::Instance(
     EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator)
     : AdaptiveStepSizeIntegrator<ODE>::Instance(
           problem, append_state, tolerance_to_error_ratio, parameters),
-      integrator_(integrator) {}
+      integrator_(integrator),
+      Δq_hat_(problem.initial_state.positions.size()),
+      Δv_hat_(problem.initial_state.positions.size()),
+      q_stage_(problem.initial_state.positions.size()),
+      g_(stages_,
+         std::vector<typename ODE::Acceleration>(
+             problem.initial_state.positions.size())) {
+  int const dimension = problem.initial_state.positions.size();
+  error_estimate_.position_error.resize(dimension);
+  error_estimate_.velocity_error.resize(dimension);
+}
 
 template<typename Method, typename Position>
 not_null<std::unique_ptr<typename Integrator<
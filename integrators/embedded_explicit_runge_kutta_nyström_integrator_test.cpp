@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <optional>
 #include <vector>
 
 #include "base/macros.hpp"
@@ -263,6 +264,164 @@ TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, MaxSteps) {
   }
 }
 
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, Statistics) {
+  AdaptiveStepSizeIntegrator<ODE> const& integrator =
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          methods::DormandالمكاوىPrince1986RKN434FM,
+          Length>();
+  Length const x_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Time const period = 2 * π * Second;
+  Instant const t_initial;
+  Instant const t_final = t_initial + 10 * period;
+  Length const length_tolerance = 1 * Milli(Metre);
+  Speed const speed_tolerance = 1 * Milli(Metre) / Second;
+
+  int evaluations = 0;
+  int rejections = 0;
+  auto const step_size_callback = [&rejections](bool tolerable) {
+    if (!tolerable) {
+      ++rejections;
+    }
+  };
+
+  std::vector<ODE::SystemState> solution;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                _1, _2, _3, &evaluations);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  problem.initial_state = {{x_initial}, {v_initial}, t_initial};
+  auto const append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+  auto const tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio,
+                _1, _2,
+                length_tolerance,
+                speed_tolerance,
+                step_size_callback);
+
+  std::vector<AdaptiveStepStatistics> statistics;
+  for (auto const step_size_controller :
+       {AdaptiveStepSizeIntegrator<ODE>::StepSizeController::Elementary,
+        AdaptiveStepSizeIntegrator<ODE>::StepSizeController::PI}) {
+    evaluations = 0;
+    rejections = 0;
+    solution.clear();
+    AdaptiveStepSizeIntegrator<ODE>::Parameters const parameters(
+        /*first_time_step=*/t_final - t_initial,
+        /*safety_factor=*/0.9,
+        /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+        /*last_step_is_exact=*/true,
+        step_size_controller);
+    auto const instance = integrator.NewInstance(problem,
+                                                 append_state,
+                                                 tolerance_to_error_ratio,
+                                                 parameters);
+    auto const outcome = instance->Solve(t_final);
+    EXPECT_EQ(termination_condition::Done, outcome.error());
+    EXPECT_EQ(t_final, solution.back().time.value);
+    EXPECT_THAT(AbsoluteError(x_initial, solution.back().positions[0].value),
+                Lt(1e-2 * Metre));
+
+    auto const& instance_statistics =
+        dynamic_cast<AdaptiveStepSizeIntegrator<ODE>::Instance const&>(
+            *instance).statistics();
+    EXPECT_EQ(solution.size(), instance_statistics.steps);
+    EXPECT_EQ(rejections, instance_statistics.rejected_steps);
+    EXPECT_EQ(evaluations, instance_statistics.function_evaluations);
+    statistics.push_back(instance_statistics);
+  }
+  // The step sizes chosen by the PI controller don't oscillate as much, so
+  // there are fewer rejections.
+  EXPECT_LE(statistics[1].rejected_steps, statistics[0].rejected_steps);
+}
+
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, DenseOutput) {
+  using Integrator = EmbeddedExplicitRungeKuttaNyströmIntegrator<
+                         methods::DormandالمكاوىPrince1986RKN434FM,
+                         Length>;
+  Integrator const integrator;
+  Length const x_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Speed const v_amplitude = 1 * Metre / Second;
+  Time const period = 2 * π * Second;
+  AngularFrequency const ω = 1 * Radian / Second;
+  Instant const t_initial;
+  Instant const t_final = t_initial + 10 * period;
+  Length const length_tolerance = 1 * Milli(Metre);
+  Speed const speed_tolerance = 1 * Milli(Metre) / Second;
+
+  auto const step_size_callback = [](bool tolerable) {};
+
+  auto const position_error = [=](Instant const& t, Length const& q) {
+    return AbsoluteError(x_initial * Cos(ω * (t - t_initial)), q);
+  };
+  auto const velocity_error = [=](Instant const& t, Speed const& v) {
+    return AbsoluteError(-v_amplitude * Sin(ω * (t - t_initial)), v);
+  };
+
+  // For each step, the dense output in the middle of the step must not be
+  // significantly less accurate than the states at the ends of the step, and
+  // the dense output at the end of the step must match the state.
+  Integrator::Instance const* dense_instance = nullptr;
+  std::optional<ODE::SystemState> previous_state;
+  std::vector<Length> positions;
+  std::vector<Speed> velocities;
+  int steps = 0;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                _1, _2, _3, /*evaluations=*/nullptr);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  problem.initial_state = {{x_initial}, {v_initial}, t_initial};
+  previous_state = problem.initial_state;
+  auto const append_state = [&](ODE::SystemState const& state) {
+    Instant const& t0 = previous_state->time.value;
+    Instant const& t1 = state.time.value;
+    Instant const t_middle = t0 + (t1 - t0) / 2;
+    dense_instance->DenseOutput(t_middle, positions, velocities);
+    EXPECT_THAT(
+        position_error(t_middle, positions[0]),
+        Lt(std::max(position_error(t0, previous_state->positions[0].value),
+                    position_error(t1, state.positions[0].value)) +
+           1e-5 * Metre));
+    EXPECT_THAT(
+        velocity_error(t_middle, velocities[0]),
+        Lt(std::max(velocity_error(t0, previous_state->velocities[0].value),
+                    velocity_error(t1, state.velocities[0].value)) +
+           1e-5 * Metre / Second));
+    dense_instance->DenseOutput(t1, positions, velocities);
+    EXPECT_THAT(AbsoluteError(state.positions[0].value, positions[0]),
+                Lt(1e-12 * Metre));
+    EXPECT_THAT(AbsoluteError(state.velocities[0].value, velocities[0]),
+                Lt(1e-12 * Metre / Second));
+    previous_state = state;
+    ++steps;
+  };
+  AdaptiveStepSizeIntegrator<ODE>::Parameters const parameters(
+      /*first_time_step=*/t_final - t_initial,
+      /*safety_factor=*/0.9);
+  auto const tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio,
+                _1, _2,
+                length_tolerance,
+                speed_tolerance,
+                step_size_callback);
+
+  auto const instance = integrator.NewInstance(problem,
+                                               append_state,
+                                               tolerance_to_error_ratio,
+                                               parameters);
+  dense_instance = dynamic_cast<Integrator::Instance const*>(&*instance);
+  auto const outcome = instance->Solve(t_final);
+  EXPECT_EQ(termination_condition::Done, outcome.error());
+  EXPECT_EQ(132, steps);
+}
+
 TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, Singularity) {
   // Integrating the position of an ideal rocket,
   //   x"(t) = m' I_sp / m(t),
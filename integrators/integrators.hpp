@@ -1,8 +1,11 @@
 #ifndef PRINCIPIA_INTEGRATORS_INTEGRATORS_HPP_
 #define PRINCIPIA_INTEGRATORS_INTEGRATORS_HPP_
 
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "base/not_null.hpp"
 #include "base/status.hpp"
@@ -108,6 +111,23 @@ class FixedStepSizeIntegrator : public Integrator<ODE_> {
               AppendState const& append_state,
               Time const& step) const = 0;
 
+  // The number of states preceding the initial state of a problem that
+  // |NewInstance| may use to avoid a startup integration.  Zero for one-step
+  // integrators.
+  virtual int history_size() const;
+
+  // Same as |NewInstance|, but |history| holds states preceding
+  // |problem.initial_state|, in increasing order of time at intervals of
+  // |step|.  At most the last |history_size()| of them are used, and they are
+  // taken as if they had been computed by this integrator.  The default
+  // implementation ignores |history|.
+  virtual not_null<std::unique_ptr<typename Integrator<ODE>::Instance>>
+  NewInstanceWithHistory(
+      IntegrationProblem<ODE> const& problem,
+      std::vector<typename ODE::SystemState> const& history,
+      AppendState const& append_state,
+      Time const& step) const;
+
   virtual void WriteToMessage(
       not_null<serialization::FixedStepSizeIntegrator*> message) const = 0;
   static FixedStepSizeIntegrator const& ReadFromMessage(
@@ -131,6 +151,19 @@ template<typename Equation>
 FixedStepSizeIntegrator<Equation> const&
 ParseFixedStepSizeIntegrator(std::string const& integrator_kind);
 
+// The work done by an instance of an |AdaptiveStepSizeIntegrator|.
+struct AdaptiveStepStatistics final {
+  // The number of accepted steps.
+  std::int64_t steps = 0;
+  // The number of attempts that were recomputed with a smaller step size
+  // because their error was too large.
+  std::int64_t rejected_steps = 0;
+  // The number of evaluations of the right-hand side of the equation.
+  std::int64_t function_evaluations = 0;
+
+  AdaptiveStepStatistics& operator+=(AdaptiveStepStatistics const& right);
+};
+
 // An integrator using an adaptive step size.
 template<typename ODE_>
 class AdaptiveStepSizeIntegrator : public Integrator<ODE_> {
@@ -150,12 +183,37 @@ class AdaptiveStepSizeIntegrator : public Integrator<ODE_> {
           double(Time const& current_step_size,
                   typename ODE::SystemStateError const& error)>;
 
+  // The rule used to choose the next step size from the values of
+  // |ToleranceToErrorRatio|.  The order of the error estimate is that of the
+  // lower-order method, p, plus 1.
+  enum class StepSizeController {
+    // h ← h * safety_factor * r^(1/(p+1)), where r is the ratio for the
+    // last step.
+    Elementary,
+    // The proportional-integral controller of Gustafsson (1991), Control
+    // theoretic techniques for stepsize selection in explicit Runge-Kutta
+    // methods: after an accepted step,
+    //   h ← h * safety_factor * r^(0.7/(p+1)) * r₋₁^(-0.4/(p+1)),
+    // where r₋₁ is the ratio for the previous accepted step.  This damps the
+    // oscillations of the step size, and reduces the number of rejections,
+    // when the step size is limited by stability or by the changes of the
+    // error.  After a rejection, or for the first step, this is the same as
+    // |Elementary|.
+    PI,
+  };
+
   struct Parameters final {
     Parameters(Time first_time_step,
                double safety_factor,
                std::int64_t max_steps,
                bool last_step_is_exact);
 
+    Parameters(Time first_time_step,
+               double safety_factor,
+               std::int64_t max_steps,
+               bool last_step_is_exact,
+               StepSizeController step_size_controller);
+
     // |max_steps| is infinite and the last step is exact.
     Parameters(Time first_time_step,
                double safety_factor);
@@ -180,6 +238,7 @@ class AdaptiveStepSizeIntegrator : public Integrator<ODE_> {
     // |state.time.value == t_final| (unless |max_steps| is reached).  Otherwise
     // it may have |state.time.value < t_final|.
     bool const last_step_is_exact;
+    StepSizeController const step_size_controller;
   };
 
   // The last call to |append_state| will have |state.time.value == t_final|.
@@ -188,6 +247,9 @@ class AdaptiveStepSizeIntegrator : public Integrator<ODE_> {
     // The integrator corresponding to this instance.
     virtual AdaptiveStepSizeIntegrator const& integrator() const = 0;
 
+    // The work done by all the calls to |Solve| so far.  Not serialized.
+    AdaptiveStepStatistics const& statistics() const;
+
     void WriteToMessage(
         not_null<serialization::IntegratorInstance*> message) const override;
     static not_null<std::unique_ptr<typename Integrator<ODE>::Instance>>
@@ -206,6 +268,10 @@ class AdaptiveStepSizeIntegrator : public Integrator<ODE_> {
     Parameters const parameters_;
     Time time_step_;
     bool first_use_ = true;
+    AdaptiveStepStatistics statistics_;
+    // The value of |tolerance_to_error_ratio_| for the last accepted step, used
+    // by |StepSizeController::PI|.  Not serialized.
+    std::optional<double> last_tolerance_to_error_ratio_;
   };
 
   // The factory function for |Instance|, above.  It ensures that the instance
@@ -243,6 +309,7 @@ AdaptiveStepSizeIntegrator<Equation> const& ParseAdaptiveStepSizeIntegrator(
 }  // namespace internal_integrators
 
 using internal_integrators::AdaptiveStepSizeIntegrator;
+using internal_integrators::AdaptiveStepStatistics;
 using internal_integrators::FixedStepSizeIntegrator;
 using internal_integrators::Integrator;
 using internal_integrators::ParseAdaptiveStepSizeIntegrator;
@@ -40,6 +40,14 @@ namespace principia {
 namespace integrators {
 namespace internal_integrators {
 
+inline AdaptiveStepStatistics& AdaptiveStepStatistics::operator+=(
+    AdaptiveStepStatistics const& right) {
+  steps += right.steps;
+  rejected_steps += right.rejected_steps;
+  function_evaluations += right.function_evaluations;
+  return *this;
+}
+
 template<typename ODE, typename Method, bool first_same_as_last>
 class SprkAsSrknDeserializer;
 
@@ -165,6 +173,21 @@ FixedStepSizeIntegrator<ODE_>::Instance::Instance(
   CHECK_NE(Time(), step_);
 }
 
+template<typename ODE_>
+int FixedStepSizeIntegrator<ODE_>::history_size() const {
+  return 0;
+}
+
+template<typename ODE_>
+not_null<std::unique_ptr<typename Integrator<ODE_>::Instance>>
+FixedStepSizeIntegrator<ODE_>::NewInstanceWithHistory(
+    IntegrationProblem<ODE> const& problem,
+    std::vector<typename ODE::SystemState> const& history,
+    AppendState const& append_state,
+    Time const& step) const {
+  return NewInstance(problem, append_state, step);
+}
+
 template<typename ODE_>
 FixedStepSizeIntegrator<ODE_> const&
 FixedStepSizeIntegrator<ODE_>::ReadFromMessage(
@@ -269,10 +292,24 @@ AdaptiveStepSizeIntegrator<ODE_>::Parameters::Parameters(
     double const safety_factor,
     std::int64_t const max_steps,
     bool const last_step_is_exact)
+    : Parameters(first_time_step,
+                 safety_factor,
+                 max_steps,
+                 last_step_is_exact,
+                 StepSizeController::Elementary) {}
+
+template<typename ODE_>
+AdaptiveStepSizeIntegrator<ODE_>::Parameters::Parameters(
+    Time const first_time_step,
+    double const safety_factor,
+    std::int64_t const max_steps,
+    bool const last_step_is_exact,
+    StepSizeController const step_size_controller)
     : first_time_step(first_time_step),
       safety_factor(safety_factor),
       max_steps(max_steps),
-      last_step_is_exact(last_step_is_exact) {}
+      last_step_is_exact(last_step_is_exact),
+      step_size_controller(step_size_controller) {}
 
 template<typename ODE_>
 AdaptiveStepSizeIntegrator<ODE_>::Parameters::Parameters(
@@ -291,6 +328,9 @@ void AdaptiveStepSizeIntegrator<ODE_>::Parameters::WriteToMessage(
   message->set_safety_factor(safety_factor);
   message->set_max_steps(max_steps);
   message->set_last_step_is_exact(last_step_is_exact);
+  if (step_size_controller == StepSizeController::PI) {
+    message->set_pi_step_size_controller(true);
+  }
 }
 
 template<typename ODE_>
@@ -302,7 +342,10 @@ AdaptiveStepSizeIntegrator<ODE_>::Parameters::ReadFromMessage(
   Parameters result(Time::ReadFromMessage(message.first_time_step()),
                     message.safety_factor(),
                     message.max_steps(),
-                    is_pre_cartan ? true : message.last_step_is_exact());
+                    is_pre_cartan ? true : message.last_step_is_exact(),
+                    message.pi_step_size_controller()
+                        ? StepSizeController::PI
+                        : StepSizeController::Elementary);
   return result;
 }
 
@@ -359,6 +402,12 @@ AdaptiveStepSizeIntegrator<ODE_>::Instance::ReadFromMessage(
   return instance;
 }
 
+template<typename ODE_>
+AdaptiveStepStatistics const&
+AdaptiveStepSizeIntegrator<ODE_>::Instance::statistics() const {
+  return statistics_;
+}
+
 template<typename ODE_>
 AdaptiveStepSizeIntegrator<ODE_>::Instance::Instance(
     IntegrationProblem<ODE> const& problem,
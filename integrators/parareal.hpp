@@ -0,0 +1,113 @@
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "base/status.hpp"
+#include "base/work_stealing_scheduler.hpp"
+#include "integrators/integrators.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace integrators {
+
+namespace termination_condition {
+// The parallel-in-time iterations did not converge.  The problem may be
+// integrated sequentially instead.
+constexpr base::Error NotConverged = base::Error::OUT_OF_RANGE;
+}  // namespace termination_condition
+
+namespace internal_parareal {
+
+using base::Status;
+using base::WorkStealingScheduler;
+using geometry::Instant;
+using quantities::Time;
+
+// The Parareal method of Lions, Maday and Turinici (2001), Résolution d'EDP
+// par un schéma en temps « pararéel », integrates a problem in parallel in
+// time.  The integration interval is split in slices.  A cheap |coarse|
+// integrator propagates the state sequentially across the slices, and an
+// expensive |fine| integrator corrects it on each slice, the slices being
+// integrated in parallel.  The iterations stop when the corrections of the
+// states at the beginning of the slices are smaller than a tolerance.  After k
+// iterations, the first k slices are exactly those of the sequential fine
+// integration; elsewhere the results differ from it by the tolerance.  |ODE|
+// must be a |SpecialSecondOrderDifferentialEquation|.
+template<typename ODE>
+class Parareal final {
+ public:
+  using AppendState = typename Integrator<ODE>::AppendState;
+
+  // This functor is called with the correction made by an iteration to the
+  // state at the beginning of a slice.  It returns the ratio of a tolerance to
+  // some norm of the correction.  The iterations stop when the result is at
+  // least 1 for all the slices.
+  using ToleranceToErrorRatio =
+      std::function<double(typename ODE::SystemStateError const& correction)>;
+
+  struct Parameters final {
+    Parameters(FixedStepSizeIntegrator<ODE> const& coarse_integrator,
+               std::int64_t coarse_steps_per_slice,
+               FixedStepSizeIntegrator<ODE> const& fine_integrator,
+               Time const& fine_step,
+               std::int64_t fine_steps_per_slice,
+               int max_iterations);
+
+    FixedStepSizeIntegrator<ODE> const& coarse_integrator;
+    // The coarse step is a fraction of the duration of a slice.
+    std::int64_t const coarse_steps_per_slice;
+    FixedStepSizeIntegrator<ODE> const& fine_integrator;
+    Time const fine_step;
+    std::int64_t const fine_steps_per_slice;
+    // The integration fails with |NotConverged| after |max_iterations|
+    // iterations that do not meet the tolerance.
+    int const max_iterations;
+  };
+
+  Parareal(Parameters const& parameters,
+           ToleranceToErrorRatio const& tolerance_to_error_ratio);
+
+  // Integrates |problem| from its initial state up to the largest time of the
+  // form |initial_time + n * fine_step| less than or equal to |t_final|.
+  // If the iterations converge, |append_state| is called, in order, with the
+  // states computed by the fine integrator, |final_state| is set to the last
+  // of these states and the result is OK.  Otherwise |append_state| is not
+  // called and the result is |NotConverged|.  If |scheduler| is not null, the
+  // slices are integrated in parallel on it.  The |problem.equation| must be
+  // callable concurrently.
+  Status Solve(IntegrationProblem<ODE> const& problem,
+               Instant const& t_final,
+               AppendState const& append_state,
+               typename ODE::SystemState& final_state,
+               WorkStealingScheduler* scheduler) const;
+
+ private:
+  using SystemState = typename ODE::SystemState;
+
+  // Integrates |equation| from |initial_state| over |steps| steps of length
+  // |step| with |integrator| and stores the result in |final_state|.  The
+  // intermediate states are appended to |states| if it is not null.
+  static Status Integrate(FixedStepSizeIntegrator<ODE> const& integrator,
+                          ODE const& equation,
+                          SystemState const& initial_state,
+                          Time const& step,
+                          std::int64_t steps,
+                          std::vector<SystemState>* states,
+                          SystemState& final_state);
+
+  Parameters const parameters_;
+  ToleranceToErrorRatio const tolerance_to_error_ratio_;
+};
+
+}  // namespace internal_parareal
+
+using internal_parareal::Parareal;
+
+}  // namespace integrators
+}  // namespace principia
+
+#include "integrators/parareal_body.hpp"
@@ -0,0 +1,255 @@
+
+#pragma once
+
+#include "integrators/parareal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "numerics/double_precision.hpp"
+
+namespace principia {
+namespace integrators {
+namespace internal_parareal {
+
+using base::Future;
+using numerics::DoublePrecision;
+
+template<typename ODE>
+Parareal<ODE>::Parameters::Parameters(
+    FixedStepSizeIntegrator<ODE> const& coarse_integrator,
+    std::int64_t const coarse_steps_per_slice,
+    FixedStepSizeIntegrator<ODE> const& fine_integrator,
+    Time const& fine_step,
+    std::int64_t const fine_steps_per_slice,
+    int const max_iterations)
+    : coarse_integrator(coarse_integrator),
+      coarse_steps_per_slice(coarse_steps_per_slice),
+      fine_integrator(fine_integrator),
+      fine_step(fine_step),
+      fine_steps_per_slice(fine_steps_per_slice),
+      max_iterations(max_iterations) {
+  CHECK_LT(0, coarse_steps_per_slice);
+  CHECK_LT(Time(), fine_step);
+  CHECK_LT(0, fine_steps_per_slice);
+  CHECK_LT(0, max_iterations);
+}
+
+template<typename ODE>
+Parareal<ODE>::Parareal(Parameters const& parameters,
+                        ToleranceToErrorRatio const& tolerance_to_error_ratio)
+    : parameters_(parameters),
+      tolerance_to_error_ratio_(tolerance_to_error_ratio) {}
+
+template<typename ODE>
+Status Parareal<ODE>::Solve(IntegrationProblem<ODE> const& problem,
+                            Instant const& t_final,
+                            AppendState const& append_state,
+                            typename ODE::SystemState& final_state,
+                            WorkStealingScheduler* const scheduler) const {
+  using Position = typename ODE::Position;
+  using Velocity = typename ODE::Velocity;
+
+  ODE const& equation = problem.equation;
+  SystemState const& initial_state = problem.initial_state;
+  Time const& fine_step = parameters_.fine_step;
+  std::int64_t const fine_steps_per_slice = parameters_.fine_steps_per_slice;
+
+  std::int64_t const fine_steps = static_cast<std::int64_t>(std::floor(
+      ((t_final - initial_state.time.value) - initial_state.time.error) /
+      fine_step));
+  CHECK_LT(0, fine_steps);
+  int const number_of_slices =
+      (fine_steps + fine_steps_per_slice - 1) / fine_steps_per_slice;
+  int const dimension = initial_state.positions.size();
+
+  // The number of fine steps in the given slice.  The last slice may be
+  // shorter than the others.
+  auto const slice_fine_steps = [fine_steps,
+                                 fine_steps_per_slice](int const slice) {
+    return std::min(fine_steps_per_slice,
+                    fine_steps - slice * fine_steps_per_slice);
+  };
+
+  // |times[i]| is the time at the beginning of slice i.  It is computed like
+  // the fine integrator does, so that the slices join exactly.
+  std::vector<DoublePrecision<Instant>> times;
+  times.reserve(number_of_slices + 1);
+  {
+    DoublePrecision<Instant> t = initial_state.time;
+    for (int slice = 0; slice < number_of_slices; ++slice) {
+      times.push_back(t);
+      for (std::int64_t i = 0; i < slice_fine_steps(slice); ++i) {
+        t.Increment(fine_step);
+      }
+    }
+    times.push_back(t);
+  }
+
+  // Computes into |final_state| the coarse propagation of |initial_state|
+  // over |slice|.
+  auto const coarse = [this, &equation, &slice_fine_steps, &times](
+                          int const slice,
+                          SystemState const& initial_state,
+                          SystemState& final_state) {
+    std::int64_t const steps = std::max<std::int64_t>(
+        1,
+        slice_fine_steps(slice) * parameters_.coarse_steps_per_slice /
+            parameters_.fine_steps_per_slice);
+    Time const step = slice_fine_steps(slice) * parameters_.fine_step / steps;
+    Integrate(parameters_.coarse_integrator,
+              equation,
+              initial_state,
+              step,
+              steps,
+              /*states=*/nullptr,
+              final_state);
+    final_state.time = times[slice + 1];
+  };
+
+  // |states[i]| is the current estimate of the state at the beginning of slice
+  // i, |states[number_of_slices]| the one at the end of the integration.  For
+  // i ≥ 1, |coarse_states[i]| and |fine_states[i]| are the coarse and fine
+  // propagations of |states[i - 1]| over slice i - 1.
+  std::vector<SystemState> states(number_of_slices + 1);
+  std::vector<SystemState> coarse_states(number_of_slices + 1);
+  std::vector<SystemState> fine_states(number_of_slices + 1);
+  // The states computed by the fine integrator on each slice.
+  std::vector<std::vector<SystemState>> fine_trajectories(number_of_slices);
+  std::vector<Status> fine_statuses(number_of_slices);
+
+  // The initial guess is the coarse propagation.
+  states[0] = initial_state;
+  for (int slice = 0; slice < number_of_slices; ++slice) {
+    coarse(slice, states[slice], coarse_states[slice + 1]);
+    states[slice + 1] = coarse_states[slice + 1];
+  }
+
+  // The states in [0, exact] are those of the sequential fine integration.
+  int exact = 0;
+  SystemState coarse_state;
+  typename ODE::SystemStateError correction;
+  correction.position_error.resize(dimension);
+  correction.velocity_error.resize(dimension);
+  for (int iteration = 0; iteration < parameters_.max_iterations;
+       ++iteration) {
+    // The fine propagation of the slices that are not yet exact, in parallel.
+    auto const fine = [this,
+                       &equation,
+                       &fine_statuses,
+                       &fine_trajectories,
+                       &fine_states,
+                       &slice_fine_steps,
+                       &states](int const slice) {
+      fine_trajectories[slice].clear();
+      fine_statuses[slice] = Integrate(parameters_.fine_integrator,
+                                       equation,
+                                       states[slice],
+                                       parameters_.fine_step,
+                                       slice_fine_steps(slice),
+                                       &fine_trajectories[slice],
+                                       fine_states[slice + 1]);
+    };
+    std::vector<Future<void>> futures;
+    if (scheduler != nullptr) {
+      futures.reserve(number_of_slices - exact - 1);
+      for (int slice = exact + 1; slice < number_of_slices; ++slice) {
+        futures.push_back(scheduler->Add([&fine, slice]() { fine(slice); }));
+      }
+      fine(exact);
+      for (auto const& future : futures) {
+        future.wait();
+      }
+    } else {
+      for (int slice = exact; slice < number_of_slices; ++slice) {
+        fine(slice);
+      }
+    }
+
+    // The slice following the exact ones starts from an exact state, so its
+    // fine propagation is exact.
+    ++exact;
+    states[exact] = fine_states[exact];
+
+    // The sequential correction of the other slices.
+    bool converged = true;
+    for (int slice = exact; slice < number_of_slices; ++slice) {
+      SystemState& state = states[slice + 1];
+      SystemState& previous_coarse_state = coarse_states[slice + 1];
+      SystemState const& fine_state = fine_states[slice + 1];
+      coarse(slice, states[slice], coarse_state);
+      for (int k = 0; k < dimension; ++k) {
+        Position const q = coarse_state.positions[k].value +
+                           (fine_state.positions[k].value -
+                            previous_coarse_state.positions[k].value);
+        Velocity const v = coarse_state.velocities[k].value +
+                           (fine_state.velocities[k].value -
+                            previous_coarse_state.velocities[k].value);
+        correction.position_error[k] = q - state.positions[k].value;
+        correction.velocity_error[k] = v - state.velocities[k].value;
+        state.positions[k] = DoublePrecision<Position>(q);
+        state.velocities[k] = DoublePrecision<Velocity>(v);
+      }
+      state.time = times[slice + 1];
+      converged &= tolerance_to_error_ratio_(correction) >= 1.0;
+      // The new coarse state replaces the previous one, whose storage is
+      // reused for the next slice.
+      std::swap(previous_coarse_state, coarse_state);
+    }
+
+    if (converged) {
+      Status status;
+      for (int slice = 0; slice < number_of_slices; ++slice) {
+        status.Update(fine_statuses[slice]);
+        for (auto const& state : fine_trajectories[slice]) {
+          append_state(state);
+        }
+      }
+      final_state = fine_states[number_of_slices];
+      return status;
+    }
+  }
+
+  return Status(termination_condition::NotConverged,
+                "Parareal did not converge after " +
+                    std::to_string(parameters_.max_iterations) +
+                    " iterations for " + std::to_string(number_of_slices) +
+                    " slices");
+}
+
+template<typename ODE>
+Status Parareal<ODE>::Integrate(
+    FixedStepSizeIntegrator<ODE> const& integrator,
+    ODE const& equation,
+    SystemState const& initial_state,
+    Time const& step,
+    std::int64_t const steps,
+    std::vector<SystemState>* const states,
+    SystemState& final_state) {
+  IntegrationProblem<ODE> problem;
+  problem.equation = equation;
+  problem.initial_state = initial_state;
+  auto const instance = integrator.NewInstance(
+      problem,
+      /*append_state=*/[states](SystemState const& state) {
+        if (states != nullptr) {
+          states->push_back(state);
+        }
+      },
+      step);
+  // Aim for the middle of the step following the last one, so that rounding
+  // doesn't change the number of steps.
+  Status const status = instance->Solve(
+      initial_state.time.value +
+      (initial_state.time.error + (steps + 0.5) * step));
+  final_state = instance->state();
+  return status;
+}
+
+}  // namespace internal_parareal
+}  // namespace integrators
+}  // namespace principia
@@ -0,0 +1,143 @@
+
+#include "integrators/parareal.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/work_stealing_scheduler.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/methods.hpp"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/integration.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+namespace integrators {
+namespace internal_parareal {
+
+using base::WorkStealingScheduler;
+using quantities::Abs;
+using quantities::Length;
+using quantities::Speed;
+using quantities::si::Metre;
+using quantities::si::Second;
+using testing_utilities::AbsoluteError;
+using testing_utilities::ComputeHarmonicOscillatorAcceleration1D;
+using ::std::placeholders::_1;
+using ::std::placeholders::_2;
+using ::std::placeholders::_3;
+using ::testing::IsEmpty;
+using ::testing::Lt;
+
+using ODE = SpecialSecondOrderDifferentialEquation<Length>;
+
+class PararealTest : public ::testing::Test {
+ protected:
+  PararealTest()
+      : integrator_(SymplecticRungeKuttaNyströmIntegrator<
+                    methods::McLachlanAtela1992Order5Optimal,
+                    Length>()),
+        t_final_(t_initial_ + 100 * Second) {
+    problem_.equation.compute_acceleration =
+        std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                  _1, _2, _3, /*evaluations=*/nullptr);
+    problem_.initial_state = {{1 * Metre}, {0 * Metre / Second}, t_initial_};
+
+    // The sequential fine integration.
+    auto const instance = integrator_.NewInstance(
+        problem_,
+        /*append_state=*/[this](ODE::SystemState const& state) {
+          expected_states_.push_back(state);
+        },
+        fine_step_);
+    instance->Solve(t_final_);
+  }
+
+  static double ToleranceToErrorRatio(
+      ODE::SystemStateError const& correction) {
+    return std::min(length_tolerance_ / Abs(correction.position_error[0]),
+                    speed_tolerance_ / Abs(correction.velocity_error[0]));
+  }
+
+  static constexpr Length length_tolerance_ = 1e-10 * Metre;
+  static constexpr Speed speed_tolerance_ = 1e-10 * Metre / Second;
+
+  FixedStepSizeIntegrator<ODE> const& integrator_;
+  Time const fine_step_ = 0.1 * Second;
+  Instant const t_initial_;
+  Instant const t_final_;
+  IntegrationProblem<ODE> problem_;
+  std::vector<ODE::SystemState> expected_states_;
+};
+
+TEST_F(PararealTest, Convergence) {
+  // With as many iterations as slices, the iterations always converge.
+  int const slices = 20;
+  Parareal<ODE> const parareal(
+      Parareal<ODE>::Parameters(/*coarse_integrator=*/integrator_,
+                                /*coarse_steps_per_slice=*/5,
+                                /*fine_integrator=*/integrator_,
+                                fine_step_,
+                                /*fine_steps_per_slice=*/50,
+                                /*max_iterations=*/slices),
+      &ToleranceToErrorRatio);
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+
+  std::vector<ODE::SystemState> states;
+  ODE::SystemState final_state;
+  auto const status = parareal.Solve(
+      problem_,
+      t_final_,
+      /*append_state=*/[&states](ODE::SystemState const& state) {
+        states.push_back(state);
+      },
+      final_state,
+      &scheduler);
+  EXPECT_OK(status);
+
+  ASSERT_EQ(expected_states_.size(), states.size());
+  for (int i = 0; i < states.size(); ++i) {
+    EXPECT_EQ(expected_states_[i].time, states[i].time);
+    EXPECT_THAT(AbsoluteError(expected_states_[i].positions[0].value,
+                              states[i].positions[0].value),
+                Lt(1e-8 * Metre));
+    EXPECT_THAT(AbsoluteError(expected_states_[i].velocities[0].value,
+                              states[i].velocities[0].value),
+                Lt(1e-8 * Metre / Second));
+  }
+  // The first slice is that of the sequential integration.
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(expected_states_[i], states[i]);
+  }
+  EXPECT_EQ(states.back(), final_state);
+}
+
+TEST_F(PararealTest, NotConverged) {
+  Parareal<ODE> const parareal(
+      Parareal<ODE>::Parameters(/*coarse_integrator=*/integrator_,
+                                /*coarse_steps_per_slice=*/1,
+                                /*fine_integrator=*/integrator_,
+                                fine_step_,
+                                /*fine_steps_per_slice=*/50,
+                                /*max_iterations=*/1),
+      &ToleranceToErrorRatio);
+
+  std::vector<ODE::SystemState> states;
+  ODE::SystemState final_state;
+  auto const status = parareal.Solve(
+      problem_,
+      t_final_,
+      /*append_state=*/[&states](ODE::SystemState const& state) {
+        states.push_back(state);
+      },
+      final_state,
+      /*scheduler=*/nullptr);
+  EXPECT_EQ(termination_condition::NotConverged, status.error());
+  EXPECT_THAT(states, IsEmpty());
+}
+
+}  // namespace internal_parareal
+}  // namespace integrators
+}  // namespace principia
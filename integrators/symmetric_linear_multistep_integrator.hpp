@@ -9,7 +9,8 @@
 #ifndef PRINCIPIA_INTEGRATORS_SYMMETRIC_LINEAR_MULTISTEP_INTEGRATOR_HPP_
 #define PRINCIPIA_INTEGRATORS_SYMMETRIC_LINEAR_MULTISTEP_INTEGRATOR_HPP_
 
-#include <list>
+#include <array>
+#include <memory>
 #include <vector>
 
 #include "base/status.hpp"
@@ -53,6 +54,8 @@ class SymmetricLinearMultistepIntegrator
     // The data for a previous step of the integration.  The |Displacement|s
     // here are really |Position|s, but we do complex computations on them and
     // it would be very inconvenient to cast these computations as barycentres.
+    // The steps are overwritten in place when they leave the history, so that
+    // their vectors are allocated once.
     struct Step final {
       std::vector<DoublePrecision<typename ODE::Displacement>> displacements;
       std::vector<typename ODE::Acceleration> accelerations;
@@ -76,12 +79,12 @@ class SymmetricLinearMultistepIntegrator
              AppendState const& append_state,
              Time const& step,
              int startup_step_index,
-             std::list<Step> const& previous_steps,
+             std::vector<Step> const& previous_steps,
              SymmetricLinearMultistepIntegrator const& integrator);
 
     // Performs the startup integration, i.e., computes enough states to either
-    // reach |t_final| or to reach a point where |instance.previous_steps_| has
-    // |order - 1| elements.  During startup |instance.current_state_| is
+    // reach |t_final| or to reach a point where the history has |order|
+    // elements.  During startup |instance.current_state_| is
     // updated more frequently than once every |instance.step_|.
     void StartupSolve(Instant const& t_final);
 
@@ -89,12 +92,28 @@ class SymmetricLinearMultistepIntegrator
     // method based on the accelerations computed by the main integrator.
     void ComputeVelocityUsingCohenHubbardOesterwinter();
 
+    // The |i|th step of the history, 0 being the oldest.
+    Step const& previous_step(int i) const;
+    // Appends a step to the history, dropping the oldest one if the history is
+    // full, and returns it.  The result is the storage of the dropped step, to
+    // be overwritten by the caller.
+    Step& AppendPreviousStep();
+
+    // Overwrites |step| with |state| and the accelerations at |state|.
     static void FillStepFromSystemState(ODE const& equation,
                                         typename ODE::SystemState const& state,
                                         Step& step);
 
     int startup_step_index_ = 0;
-    std::list<Step> previous_steps_;  // At most |order_| elements.
+    // A ring buffer holding the last |number_of_previous_steps_| steps, at most
+    // |order|, starting at |oldest_previous_step_|.  Copying it, e.g., in
+    // |Clone|, copies the steps, which is cheap compared to the integration.
+    std::array<Step, order> previous_steps_;
+    int number_of_previous_steps_ = 0;
+    int oldest_previous_step_ = 0;
+    // Scratch space for |ComputeVelocityUsingCohenHubbardOesterwinter|, kept
+    // here to avoid allocating at each step.
+    std::vector<typename ODE::Acceleration> weighted_accelerations_;
     SymmetricLinearMultistepIntegrator const& integrator_;
     friend class SymmetricLinearMultistepIntegrator;
   };
@@ -107,6 +126,16 @@ class SymmetricLinearMultistepIntegrator
       AppendState const& append_state,
       Time const& step) const override;
 
+  // The history replaces the startup integration, entirely if it has
+  // |order - 1| states.
+  int history_size() const override;
+  not_null<std::unique_ptr<typename Integrator<ODE>::Instance>>
+  NewInstanceWithHistory(
+      IntegrationProblem<ODE> const& problem,
+      std::vector<typename ODE::SystemState> const& history,
+      AppendState const& append_state,
+      Time const& step) const override;
+
   void WriteToMessage(
       not_null<serialization::FixedStepSizeIntegrator*> message) const override;
 
@@ -4,7 +4,8 @@
 #include "integrators/symmetric_linear_multistep_integrator.hpp"
 
 #include <algorithm>
-#include <list>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "geometry/serialization.hpp"
@@ -38,25 +39,25 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
   auto const& step = this->step_;
   auto const& equation = this->equation_;
 
-  if (previous_steps_.size() < order) {
+  if (number_of_previous_steps_ < order) {
     StartupSolve(t_final);
 
     // If |t_final| is not large enough, we may not have generated enough
     // points.  Bail out, we'll continue the next time |Solve| is called.
-    if (previous_steps_.size() < order) {
+    if (number_of_previous_steps_ < order) {
       return Status::OK;
     }
   }
-  CHECK_EQ(previous_steps_.size(), order);
+  CHECK_EQ(number_of_previous_steps_, order);
 
   // Argument checks.
-  int const dimension = previous_steps_.back().displacements.size();
+  int const dimension = previous_step(order - 1).displacements.size();
 
   // Time step.
   CHECK_LT(Time(), step);
   Time const& h = step;
   // Current time.
-  DoublePrecision<Instant> t = previous_steps_.back().time;
+  DoublePrecision<Instant> t = previous_step(order - 1).time;
   // Order.
   int const k = order;
 
@@ -66,29 +67,29 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
   DoubleDisplacements Σj_minus_ɑj_qj(dimension);
   std::vector<Acceleration> Σj_βj_numerator_aj(dimension);
   while (h <= (t_final - t.value) - t.error) {
-    // We take advantage of the symmetry to iterate on the list of previous
-    // steps from both ends.
-    auto front_it = previous_steps_.begin();
-    auto back_it = previous_steps_.rbegin();
+    // We take advantage of the symmetry to iterate on the history from both
+    // ends.
 
     // This block corresponds to j = 0.  We must not pair it with j = k.
     {
-      DoubleDisplacements const& qj = front_it->displacements;
-      std::vector<Acceleration> const& aj = front_it->accelerations;
+      DoubleDisplacements const& qj = previous_step(0).displacements;
+      std::vector<Acceleration> const& aj = previous_step(0).accelerations;
       double const ɑj = ɑ[0];
       double const βj_numerator = β_numerator[0];
       for (int d = 0; d < dimension; ++d) {
         Σj_minus_ɑj_qj[d] = Scale(-ɑj, qj[d]);
         Σj_βj_numerator_aj[d] = βj_numerator * aj[d];
       }
-      ++front_it;
     }
     // The generic value of j, paired with k - j.
     for (int j = 1; j < k / 2; ++j) {
-      DoubleDisplacements const& qj = front_it->displacements;
-      DoubleDisplacements const& qk_minus_j = back_it->displacements;
-      std::vector<Acceleration> const& aj = front_it->accelerations;
-      std::vector<Acceleration> const& ak_minus_j = back_it->accelerations;
+      Step const& step_j = previous_step(j);
+      Step const& step_k_minus_j = previous_step(k - j);
+      DoubleDisplacements const& qj = step_j.displacements;
+      DoubleDisplacements const& qk_minus_j = step_k_minus_j.displacements;
+      std::vector<Acceleration> const& aj = step_j.accelerations;
+      std::vector<Acceleration> const& ak_minus_j =
+          step_k_minus_j.accelerations;
       double const ɑj = ɑ[j];
       double const βj_numerator = β_numerator[j];
       for (int d = 0; d < dimension; ++d) {
@@ -96,13 +97,11 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
         Σj_minus_ɑj_qj[d] -= Scale(ɑj, qk_minus_j[d]);
         Σj_βj_numerator_aj[d] += βj_numerator * (aj[d] + ak_minus_j[d]);
       }
-      ++front_it;
-      ++back_it;
     }
     // This block corresponds to j = k / 2.  We must not pair it with j = k / 2.
     {
-      DoubleDisplacements const& qj = front_it->displacements;
-      std::vector<Acceleration> const& aj = front_it->accelerations;
+      DoubleDisplacements const& qj = previous_step(k / 2).displacements;
+      std::vector<Acceleration> const& aj = previous_step(k / 2).accelerations;
       double const ɑj = ɑ[k / 2];
       double const βj_numerator = β_numerator[k / 2];
       for (int d = 0; d < dimension; ++d) {
@@ -111,10 +110,12 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
       }
     }
 
-    // Create a new step in the instance.
+    // Create a new step in the storage of the oldest one, which has been used
+    // above and is no longer needed.  Its vectors already have the right
+    // capacity, so the integration doesn't allocate at each step.
     t.Increment(h);
-    previous_steps_.emplace_back();
-    Step& current_step = previous_steps_.back();
+    Step& current_step = AppendPreviousStep();
+    current_step.displacements.clear();
     current_step.time = t;
     current_step.accelerations.resize(dimension);
     current_step.displacements.reserve(dimension);
@@ -135,7 +136,6 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
     status.Update(equation.compute_acceleration(t.value,
                                                 positions,
                                                 current_step.accelerations));
-    previous_steps_.pop_front();
 
     ComputeVelocityUsingCohenHubbardOesterwinter();
 
@@ -173,8 +173,8 @@ Instance::WriteToMessage(
           ->MutableExtension(
               serialization::SymmetricLinearMultistepIntegratorInstance::
                   extension);
-  for (auto const& previous_step : previous_steps_) {
-    previous_step.WriteToMessage(extension->add_previous_steps());
+  for (int i = 0; i < number_of_previous_steps_; ++i) {
+    previous_step(i).WriteToMessage(extension->add_previous_steps());
   }
   extension->set_startup_step_index(startup_step_index_);
 }
@@ -230,10 +230,9 @@ SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Instance(
     SymmetricLinearMultistepIntegrator const& integrator)
     : FixedStepSizeIntegrator<ODE>::Instance(problem, append_state, step),
       integrator_(integrator) {
-  previous_steps_.emplace_back();
   FillStepFromSystemState(this->equation_,
                           this->current_state_,
-                          this->previous_steps_.back());
+                          AppendPreviousStep());
 }
 
 template<typename Method, typename Position>
@@ -242,12 +241,16 @@ SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Instance(
     AppendState const& append_state,
     Time const& step,
     int const startup_step_index,
-    std::list<Step> const& previous_steps,
+    std::vector<Step> const& previous_steps,
     SymmetricLinearMultistepIntegrator const& integrator)
     : FixedStepSizeIntegrator<ODE>::Instance(problem, append_state, step),
       startup_step_index_(startup_step_index),
-      previous_steps_(previous_steps),
-      integrator_(integrator) {}
+      integrator_(integrator) {
+  CHECK_LE(previous_steps.size(), order);
+  for (Step const& previous_step : previous_steps) {
+    AppendPreviousStep() = previous_step;
+  }
+}
 
 template<typename Method, typename Position>
 void SymmetricLinearMultistepIntegrator<Method, Position>::
@@ -258,24 +261,23 @@ Instance::StartupSolve(Instant const& t_final) {
 
   Time const startup_step = step / startup_step_divisor;
 
-  CHECK(!previous_steps_.empty());
-  CHECK_LT(previous_steps_.size(), order);
+  CHECK_LT(0, number_of_previous_steps_);
+  CHECK_LT(number_of_previous_steps_, order);
 
   auto const startup_append_state =
       [this](typename ODE::SystemState const& state) {
         // Stop changing anything once we're done with the startup.  We may be
         // called one more time by the |startup_integrator_|.
-        if (previous_steps_.size() < order) {
+        if (number_of_previous_steps_ < order) {
           this->current_state_ = state;
           // The startup integrator has a smaller step.  We do not record all
           // the states it computes, but only those that are a multiple of the
           // main integrator step.
           if (++startup_step_index_ % startup_step_divisor == 0) {
-            CHECK_LT(previous_steps_.size(), order);
-            previous_steps_.emplace_back();
+            CHECK_LT(number_of_previous_steps_, order);
             FillStepFromSystemState(this->equation_,
                                     this->current_state_,
-                                    previous_steps_.back());
+                                    AppendPreviousStep());
             // This call must happen last for a subtle reason: the callback may
             // want to |Clone| this instance (see |Ephemeris::Checkpoint|) in
             // which cases it is necessary that all the member variables be
@@ -292,10 +294,10 @@ Instance::StartupSolve(Instant const& t_final) {
 
   startup_instance->Solve(
       std::min(current_state.time.value +
-                   (order - previous_steps_.size()) * step + step / 2.0,
+                   (order - number_of_previous_steps_) * step + step / 2.0,
                t_final));
 
-  CHECK_LE(previous_steps_.size(), order);
+  CHECK_LE(number_of_previous_steps_, order);
 }
 
 template<typename Method, typename Position>
@@ -313,29 +315,67 @@ Instance::ComputeVelocityUsingCohenHubbardOesterwinter() {
   auto const& cohen_hubbard_oesterwinter =
       integrator_.cohen_hubbard_oesterwinter_;
 
-  int const dimension = previous_steps_.back().displacements.size();
+  int const newest = number_of_previous_steps_ - 1;
+  int const dimension = previous_step(newest).displacements.size();
   auto& current_state = this->current_state_;
   auto const& step = this->step_;
 
+  // The history is traversed once, from the newest step to the oldest, and for
+  // each step the coefficient is applied to the accelerations of all the
+  // bodies.  The innermost loop therefore runs over contiguous arrays and
+  // vectorizes, and the sums are computed in the same order as if each body
+  // were handled separately.
+  std::vector<DoublePrecision<Displacement>> const& last_displacements =
+      previous_step(newest).displacements;
+  std::vector<DoublePrecision<Displacement>> const&
+      penultimate_displacements = previous_step(newest - 1).displacements;
+
+  weighted_accelerations_.assign(dimension, Acceleration());
+  for (int i = 0; i < cohen_hubbard_oesterwinter.numerators.size; ++i) {
+    double const numerator = cohen_hubbard_oesterwinter.numerators[i];
+    std::vector<Acceleration> const& accelerations =
+        previous_step(newest - i).accelerations;
+    for (int d = 0; d < dimension; ++d) {
+      weighted_accelerations_[d] += numerator * accelerations[d];
+    }
+  }
+
   current_state.velocities.reserve(dimension);
   for (int d = 0; d < dimension; ++d) {
     DoublePrecision<Velocity>& velocity = current_state.velocities[d];
-    auto it = previous_steps_.rbegin();
 
     // Compute the displacement difference using double precision.
-    DoublePrecision<Displacement> displacement_change =
-        it->displacements[d] - std::next(it)->displacements[d];
+    DoublePrecision<Displacement> const displacement_change =
+        last_displacements[d] - penultimate_displacements[d];
     velocity = DoublePrecision<Velocity>(
         (displacement_change.value + displacement_change.error) / step);
 
-    Acceleration weighted_accelerations;
-    for (int i = 0; i < cohen_hubbard_oesterwinter.numerators.size; ++i, ++it) {
-      weighted_accelerations +=
-          cohen_hubbard_oesterwinter.numerators[i] * it->accelerations[d];
-    }
+    velocity.value += weighted_accelerations_[d] * step /
+                      cohen_hubbard_oesterwinter.denominator;
+  }
+}
 
-    velocity.value +=
-        weighted_accelerations * step / cohen_hubbard_oesterwinter.denominator;
+template<typename Method, typename Position>
+typename SymmetricLinearMultistepIntegrator<Method, Position>::Instance::
+    Step const&
+SymmetricLinearMultistepIntegrator<Method, Position>::Instance::previous_step(
+    int const i) const {
+  DCHECK_LE(0, i);
+  DCHECK_LT(i, number_of_previous_steps_);
+  return previous_steps_[(oldest_previous_step_ + i) % order];
+}
+
+template<typename Method, typename Position>
+typename SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Step&
+SymmetricLinearMultistepIntegrator<Method, Position>::Instance::
+AppendPreviousStep() {
+  if (number_of_previous_steps_ < order) {
+    return previous_steps_[(oldest_previous_step_ +
+                            number_of_previous_steps_++) % order];
+  } else {
+    Step& result = previous_steps_[oldest_previous_step_];
+    oldest_previous_step_ = (oldest_previous_step_ + 1) % order;
+    return result;
   }
 }
 
@@ -346,6 +386,7 @@ Instance::FillStepFromSystemState(ODE const& equation,
                                   Step& step) {
   std::vector<typename ODE::Position> positions;
   step.time = state.time;
+  step.displacements.clear();
   for (auto const& position : state.positions) {
     step.displacements.push_back(position - DoublePrecision<Position>());
     positions.push_back(position.value);
@@ -381,6 +422,43 @@ SymmetricLinearMultistepIntegrator<Method, Position>::NewInstance(
       new Instance(problem, append_state, step, *this));
 }
 
+template<typename Method, typename Position>
+int SymmetricLinearMultistepIntegrator<Method, Position>::history_size() const {
+  return order - 1;
+}
+
+template<typename Method, typename Position>
+not_null<std::unique_ptr<typename Integrator<
+    SpecialSecondOrderDifferentialEquation<Position>>::Instance>>
+SymmetricLinearMultistepIntegrator<Method, Position>::NewInstanceWithHistory(
+    IntegrationProblem<ODE> const& problem,
+    std::vector<typename ODE::SystemState> const& history,
+    AppendState const& append_state,
+    Time const& step) const {
+  // The accelerations are recomputed, so that the steps are exactly those that
+  // this integrator would have produced from the same states.
+  std::vector<typename Instance::Step> previous_steps;
+  std::int64_t const first_state =
+      std::max<std::int64_t>(0, history.size() - history_size());
+  for (std::int64_t i = first_state; i < history.size(); ++i) {
+    CHECK_LT(history[i].time.value, problem.initial_state.time.value);
+    Instance::FillStepFromSystemState(problem.equation,
+                                      history[i],
+                                      previous_steps.emplace_back());
+  }
+  Instance::FillStepFromSystemState(problem.equation,
+                                    problem.initial_state,
+                                    previous_steps.emplace_back());
+  // Cannot use |make_not_null_unique| because the constructor of |Instance| is
+  // private.
+  return std::unique_ptr<Instance>(new Instance(problem,
+                                                append_state,
+                                                step,
+                                                /*startup_step_index=*/0,
+                                                previous_steps,
+                                                *this));
+}
+
 template<typename Method, typename Position>
 void SymmetricLinearMultistepIntegrator<Method, Position>::WriteToMessage(
     not_null<serialization::FixedStepSizeIntegrator*> message) const {
@@ -402,7 +480,7 @@ SymmetricLinearMultistepIntegrator<Method, Position>::ReadFromMessage(
   auto const& extension = message.GetExtension(
       serialization::SymmetricLinearMultistepIntegratorInstance::extension);
 
-  std::list<typename Instance::Step> previous_steps;
+  std::vector<typename Instance::Step> previous_steps;
   for (auto const& previous_step : extension.previous_steps()) {
     previous_steps.push_back(Instance::Step::ReadFromMessage(previous_step));
   }
@@ -395,6 +395,93 @@ TEST_P(SymmetricLinearMultistepIntegratorTest, LongIntegration) {
 #endif
 }
 
+// Tests that a clone, which shares the previous steps of its original,
+// continues the integration exactly like it.
+TEST_P(SymmetricLinearMultistepIntegratorTest, Clone) {
+  LOG(INFO) << GetParam();
+  Length const q_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Instant const t_initial;
+  Time const step = 0.2 * Second;
+
+  std::vector<ODE::SystemState> solution;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                _1, _2, _3, /*evaluations=*/nullptr);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  problem.initial_state = {{q_initial}, {v_initial}, t_initial};
+  auto const append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+
+  auto const instance =
+      GetParam().integrator.NewInstance(problem, append_state, step);
+  instance->Solve(t_initial + 100.5 * step);
+  auto const clone = instance->Clone();
+
+  solution.clear();
+  instance->Solve(t_initial + 200.5 * step);
+  std::vector<ODE::SystemState> const expected_solution = solution;
+
+  solution.clear();
+  clone->Solve(t_initial + 200.5 * step);
+  EXPECT_EQ(100, expected_solution.size());
+  EXPECT_EQ(expected_solution, solution);
+}
+
+// Tests that an instance created with the history of another one continues
+// the integration without a startup.
+TEST_P(SymmetricLinearMultistepIntegratorTest, History) {
+  LOG(INFO) << GetParam();
+  Length const q_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Instant const t_initial;
+  Time const step = 0.2 * Second;
+
+  int evaluations = 0;
+  std::vector<ODE::SystemState> solution;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                _1, _2, _3, &evaluations);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  problem.initial_state = {{q_initial}, {v_initial}, t_initial};
+  auto const append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+
+  auto const& integrator = GetParam().integrator;
+  auto const instance = integrator.NewInstance(problem, append_state, step);
+  instance->Solve(t_initial + 100.5 * step);
+  problem.initial_state = solution.back();
+  std::vector<ODE::SystemState> const history(solution.begin(),
+                                              solution.end() - 1);
+
+  solution.clear();
+  instance->Solve(t_initial + 200.5 * step);
+  std::vector<ODE::SystemState> const expected_solution = solution;
+
+  solution.clear();
+  evaluations = 0;
+  auto const continuation = integrator.NewInstanceWithHistory(
+      problem, history, append_state, step);
+  continuation->Solve(t_initial + 200.5 * step);
+  // One evaluation per step of the history and per new step.
+  EXPECT_EQ(integrator.history_size() + 1 + 100, evaluations);
+  ASSERT_EQ(100, expected_solution.size());
+  ASSERT_EQ(100, solution.size());
+  for (int i = 0; i < solution.size(); ++i) {
+    EXPECT_EQ(expected_solution[i].time.value, solution[i].time.value);
+    EXPECT_THAT(solution[i].positions[0].value,
+                AlmostEquals(expected_solution[i].positions[0].value, 0, 2));
+    EXPECT_THAT(solution[i].velocities[0].value,
+                AlmostEquals(expected_solution[i].velocities[0].value, 0, 2));
+  }
+}
+
 // Tests that serialization and deserialization work.
 TEST_P(SymmetricLinearMultistepIntegratorTest, Serialization) {
   LOG(INFO) << GetParam();
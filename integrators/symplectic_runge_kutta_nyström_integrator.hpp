@@ -9,6 +9,10 @@
 #ifndef PRINCIPIA_INTEGRATORS_SYMPLECTIC_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_
 #define PRINCIPIA_INTEGRATORS_SYMPLECTIC_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_
 
+#include <utility>
+#include <vector>
+
+#include "base/macros.hpp"
 #include "base/status.hpp"
 #include "integrators/methods.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
@@ -95,7 +99,33 @@ class SymplecticRungeKuttaNyströmIntegrator
              Time const& step,
              SymplecticRungeKuttaNyströmIntegrator const& integrator);
 
+    // Performs the stages |first_stage + i...| of a step of size |h|.  The
+    // stage loop is unrolled at compile time, so that the coefficients of each
+    // stage are constants.
+    template<int first_stage, int... i>
+    FORCE_INLINE() void PerformStages(std::integer_sequence<int, i...>,
+                                      Time const& h,
+                                      Status& status);
+
+    // Performs the stage |i| of a step of size |h|, i.e., computes
+    // exp(aᵢ h A) exp(bᵢ h B), accumulating the increments in |Δq_| and |Δv_|.
+    // The exp(aᵢ h A) is skipped if aᵢ vanishes, as in the last stage of the
+    // BAB case.
+    template<int i>
+    FORCE_INLINE() void PerformStage(Time const& h, Status& status);
+
     SymplecticRungeKuttaNyströmIntegrator const& integrator_;
+
+    // Buffers for |Solve|.  They are sized for the dimension of the problem at
+    // construction and reused across calls, so that the steps don't allocate.
+    // Position increment.
+    std::vector<typename ODE::Displacement> Δq_;
+    // Velocity increment.
+    std::vector<typename ODE::Velocity> Δv_;
+    // Current Runge-Kutta-Nyström stage.
+    std::vector<Position> q_stage_;
+    // Accelerations at the current stage.
+    std::vector<typename ODE::Acceleration> g_;
     friend class SymplecticRungeKuttaNyströmIntegrator;
   };
 
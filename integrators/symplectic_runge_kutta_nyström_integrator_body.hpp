@@ -3,6 +3,7 @@
 
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 
+#include <utility>
 #include <vector>
 
 #include "geometry/sign.hpp"
@@ -17,6 +18,7 @@ namespace internal_symplectic_runge_kutta_nyström_integrator {
 using base::make_not_null_unique;
 using geometry::Sign;
 using numerics::DoublePrecision;
+using numerics::Increment;
 using numerics::ULPDistance;
 using quantities::Abs;
 
@@ -29,7 +31,6 @@ Instance::Solve(Instant const& t_final) {
 
   auto const& a = integrator_.a_;
   auto const& b = integrator_.b_;
-  auto const& c = integrator_.c_;
 
   auto& current_state = this->current_state_;
   auto& append_state = this->append_state_;
@@ -59,9 +60,9 @@ Instance::Solve(Instant const& t_final) {
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment.
-  std::vector<Displacement> Δq(dimension);
+  std::vector<Displacement>& Δq = Δq_;
   // Velocity increment.
-  std::vector<Velocity> Δv(dimension);
+  std::vector<Velocity>& Δv = Δv_;
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q = current_state.positions;
@@ -70,9 +71,16 @@ Instance::Solve(Instant const& t_final) {
   std::vector<DoublePrecision<Velocity>>& v = current_state.velocities;
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
   // Accelerations at the current stage.
-  std::vector<Acceleration> g(dimension);
+  std::vector<Acceleration>& g = g_;
+
+  // The buffers are sized at construction, these are no-ops unless the
+  // dimension of |current_state| has changed.
+  Δq.resize(dimension);
+  Δv.resize(dimension);
+  q_stage.resize(dimension);
+  g.resize(dimension);
 
   // The first full stage of the step, i.e. the first stage where
   // exp(bᵢ h B) exp(aᵢ h A) must be entirely computed.
@@ -96,46 +104,73 @@ Instance::Solve(Instant const& t_final) {
     std::fill(Δq.begin(), Δq.end(), Displacement{});
     std::fill(Δv.begin(), Δv.end(), Velocity{});
 
-    if (first_stage == 1) {
+    if constexpr (first_stage == 1) {
+      Time const h_a₀ = h * a[0];
       for (int k = 0; k < dimension; ++k) {
-        if (composition == BAB) {
+        if constexpr (composition == BAB) {
           // exp(b₀ h B)
           Δv[k] += h * b[0] * g[k];
         }
         // exp(a₀ h A)
-        Δq[k] += h * a[0] * (v[k].value + Δv[k]);
+        Δq[k] += h_a₀ * (v[k].value + Δv[k]);
       }
     }
 
-    for (int i = first_stage; i < stages_; ++i) {
-      for (int k = 0; k < dimension; ++k) {
-        q_stage[k] = q[k].value + Δq[k];
-      }
-      status.Update(equation.compute_acceleration(
-          t.value + (t.error + c[i] * h), q_stage, g));
-      for (int k = 0; k < dimension; ++k) {
-        // exp(bᵢ h B)
-        Δv[k] += h * b[i] * g[k];
-        // NOTE(egg): in the BAB case, at the last stage, this will be an
-        // exercise in adding 0.  I don't think the optimizer can know that.  Do
-        // we care?
-        // exp(aᵢ h A)
-        Δq[k] += h * a[i] * (v[k].value + Δv[k]);
-      }
-    }
+    PerformStages<first_stage>(
+        std::make_integer_sequence<int, stages_ - first_stage>(), h, status);
 
     // Increment the solution.
     t.Increment(h);
-    for (int k = 0; k < dimension; ++k) {
-      q[k].Increment(Δq[k]);
-      v[k].Increment(Δv[k]);
-    }
+    Increment(q, Δq);
+    Increment(v, Δv);
     append_state(current_state);
   }
 
   return status;
 }
 
+template<typename Method, typename Position>
+template<int first_stage, int... i>
+void SymplecticRungeKuttaNyströmIntegrator<Method, Position>::
+Instance::PerformStages(std::integer_sequence<int, i...>,
+                        Time const& h,
+                        Status& status) {
+  (PerformStage<first_stage + i>(h, status), ...);
+}
+
+template<typename Method, typename Position>
+template<int i>
+void SymplecticRungeKuttaNyströmIntegrator<Method, Position>::
+Instance::PerformStage(Time const& h, Status& status) {
+  constexpr double aᵢ = a_[i];
+  constexpr double bᵢ = b_[i];
+
+  auto const& equation = this->equation_;
+  DoublePrecision<Instant> const& t = this->current_state_.time;
+  auto const& q = this->current_state_.positions;
+  auto const& v = this->current_state_.velocities;
+  int const dimension = q.size();
+
+  // These products are those that the expressions below would compute first,
+  // so hoisting them doesn't change the results.
+  Time const h_aᵢ = h * aᵢ;
+  Time const h_bᵢ = h * bᵢ;
+
+  for (int k = 0; k < dimension; ++k) {
+    q_stage_[k] = q[k].value + Δq_[k];
+  }
+  status.Update(equation.compute_acceleration(
+      t.value + (t.error + integrator_.c_[i] * h), q_stage_, g_));
+  for (int k = 0; k < dimension; ++k) {
+    // exp(bᵢ h B)
+    Δv_[k] += h_bᵢ * g_[k];
+    if constexpr (aᵢ != 0.0) {
+      // exp(aᵢ h A)
+      Δq_[k] += h_aᵢ * (v[k].value + Δv_[k]);
+    }
+  }
+}
+
 template<typename Method, typename Position>
 SymplecticRungeKuttaNyströmIntegrator<Method, Position> const&
 SymplecticRungeKuttaNyströmIntegrator<Method, Position>::
@@ -174,7 +209,11 @@ Instance::Instance(IntegrationProblem<ODE> const& problem,
     : FixedStepSizeIntegrator<ODE>::Instance(problem,
                                              std::move(append_state),
                                              step),
-      integrator_(integrator) {}
+      integrator_(integrator),
+      Δq_(problem.initial_state.positions.size()),
+      Δv_(problem.initial_state.positions.size()),
+      q_stage_(problem.initial_state.positions.size()),
+      g_(problem.initial_state.positions.size()) {}
 
 template<typename Method, typename Position>
 SymplecticRungeKuttaNyströmIntegrator<Method, Position>::
@@ -1,15 +1,21 @@
 ﻿
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <type_traits>
 
 #include "base/not_constructible.hpp"
 #include "base/not_null.hpp"
+#include "journal/tracer.hpp"
 
 namespace principia {
 namespace journal {
+
+class Recorder;
+
 namespace internal_method {
 
 using base::not_constructible;
@@ -28,6 +34,10 @@ using base::not_null;
 //
 //    using Message = serialization::SerializePlugin;
 //
+//    // True if the method may be omitted from a journal that must be
+//    // replayable, see |Recorder::Selection|.
+//    static constexpr bool is_query = ...;
+//
 //    // The following functions must be omitted if In/Out/Return is omitted.
 //    static void Fill(In const& in, not_null<Message*> message);
 //    static void Fill(Out const& out, not_null<Message*> message);
@@ -91,10 +101,17 @@ class Method final {
   typename P::Return Return(typename P::Return const& result);
 
  private:
+  // Returns the recorder to which this method must be written, or null if it
+  // must not be recorded.
+  static Recorder* ActiveRecorder();
+
   std::function<void(not_null<typename Profile::Message*> message)> out_filler_;
   std::function<void(not_null<typename Profile::Message*> message)>
       return_filler_;
   bool returned_ = false;
+  // Set if a |Tracer| was active when this object was constructed.
+  std::optional<Tracer::Clock::time_point> const trace_start_ =
+      Tracer::StartIfActivated();
 };
 
 }  // namespace internal_method
@@ -5,42 +5,73 @@
 
 #include <list>
 
+#include "google/protobuf/arena.h"
 #include "journal/recorder.hpp"
+#include "journal/tracer.hpp"
 
 namespace principia {
 namespace journal {
 namespace internal_method {
 
+// The messages recorded by |Method| are written as soon as they are filled, so
+// they are allocated on a thread-local arena that is reset afterwards, instead
+// of allocating their submessages on the heap.
+class RecordedMethod final {
+ public:
+  RecordedMethod()
+      : method_(google::protobuf::Arena::CreateMessage<serialization::Method>(
+            &arena())) {}
+
+  ~RecordedMethod() {
+    arena().Reset();
+  }
+
+  serialization::Method& operator*() const {
+    return *method_;
+  }
+
+ private:
+  static google::protobuf::Arena& arena() {
+    thread_local google::protobuf::Arena arena;
+    return arena;
+  }
+
+  not_null<serialization::Method*> const method_;
+};
+
 template<typename Profile>
 Method<Profile>::Method() {
-  if (Recorder::active_recorder_ != nullptr) {
-    serialization::Method method;
+  if (Recorder* const recorder = ActiveRecorder(); recorder != nullptr) {
+    RecordedMethod const recorded_method;
+    serialization::Method& method = *recorded_method;
     auto* const message_in =
         method.MutableExtension(Profile::Message::extension);
-    Recorder::active_recorder_->WriteAtConstruction(method);
+    recorder->WriteAtConstruction(method);
   }
 }
 
 template<typename Profile>
 template<typename P, typename>
 Method<Profile>::Method(typename P::In const& in) {
-  if (Recorder::active_recorder_ != nullptr) {
-    serialization::Method method;
+  if (Recorder* const recorder = ActiveRecorder(); recorder != nullptr) {
+    RecordedMethod const recorded_method;
+    serialization::Method& method = *recorded_method;
     auto* const message_in =
         method.MutableExtension(Profile::Message::extension);
     Profile::Fill(in, message_in);
-    Recorder::active_recorder_->WriteAtConstruction(method);
+    recorder->WriteAtConstruction(method);
   }
 }
 
 template<typename Profile>
 template<typename P, typename>
 Method<Profile>::Method(typename P::Out const& out) {
-  if (Recorder::active_recorder_ != nullptr) {
-    serialization::Method method;
+  if (Recorder* const recorder = ActiveRecorder(); recorder != nullptr) {
+    RecordedMethod const recorded_method;
+    serialization::Method& method = *recorded_method;
     auto* const message_in =
         method.MutableExtension(Profile::Message::extension);
-    Recorder::active_recorder_->WriteAtConstruction(method);
+    recorder->WriteAtConstruction(method);
     out_filler_ = [this, out](
         not_null<typename Profile::Message*> const message) {
       Profile::Fill(out, message);
@@ -51,12 +82,13 @@ Method<Profile>::Method(typename P::Out const& out) {
 template<typename Profile>
 template<typename P, typename>
 Method<Profile>::Method(typename P::In const& in, typename P::Out const& out) {
-  if (Recorder::active_recorder_ != nullptr) {
-    serialization::Method method;
+  if (Recorder* const recorder = ActiveRecorder(); recorder != nullptr) {
+    RecordedMethod const recorded_method;
+    serialization::Method& method = *recorded_method;
     auto* const message_in =
         method.MutableExtension(Profile::Message::extension);
     Profile::Fill(in, message_in);
-    Recorder::active_recorder_->WriteAtConstruction(method);
+    recorder->WriteAtConstruction(method);
     out_filler_ = [this, out](
         not_null<typename Profile::Message*> const message) {
       Profile::Fill(out, message);
@@ -67,8 +99,9 @@ Method<Profile>::Method(typename P::In const& in, typename P::Out const& out) {
 template<typename Profile>
 Method<Profile>::~Method() {
   CHECK(returned_);
-  if (Recorder::active_recorder_ != nullptr) {
-    serialization::Method method;
+  if (Recorder* const recorder = ActiveRecorder(); recorder != nullptr) {
+    RecordedMethod const recorded_method;
+    serialization::Method& method = *recorded_method;
     auto* const extension =
         method.MutableExtension(Profile::Message::extension);
     if (out_filler_ != nullptr) {
@@ -77,8 +110,10 @@ Method<Profile>::~Method() {
     if (return_filler_ != nullptr) {
       return_filler_(extension);
     }
-    Recorder::active_recorder_->WriteAtDestruction(method);
+    recorder->WriteAtDestruction(method);
   }
+  Tracer::RecordIfActivated(Profile::Message::descriptor()->name(),
+                            trace_start_);
 }
 
 template<typename Profile>
@@ -94,7 +129,7 @@ typename P::Return Method<Profile>::Return(
     typename P::Return const& result) {
   CHECK(!returned_);
   returned_ = true;
-  if (Recorder::active_recorder_ != nullptr) {
+  if (ActiveRecorder() != nullptr) {
     return_filler_ =
         [this, result](not_null<typename Profile::Message*> const message) {
           Profile::Fill(result, message);
@@ -103,6 +138,16 @@ typename P::Return Method<Profile>::Return(
   return result;
 }
 
+template<typename Profile>
+Recorder* Method<Profile>::ActiveRecorder() {
+  Recorder* const recorder = Recorder::active_recorder_;
+  if (recorder != nullptr && Profile::is_query &&
+      recorder->selection_ == Recorder::Selection::REPLAYABLE) {
+    return nullptr;
+  }
+  return recorder;
+}
+
 }  // namespace internal_method
 }  // namespace journal
 }  // namespace principia
@@ -1,27 +1,43 @@
 ﻿
 #include "journal/player.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/array.hpp"
-#include "base/get_line.hpp"
 #include "base/hexadecimal.hpp"
 #include "journal/profiles.hpp"
+#include "journal/recorder.hpp"
 #include "glog/logging.h"
 
 namespace principia {
 
-using base::GetLine;
 using base::HexadecimalDecode;
 using base::UniqueArray;
 
 namespace journal {
 
 Player::Player(std::filesystem::path const& path)
-    : stream_(path, std::ios::in) {
-  CHECK(!stream_.fail());
+    : path_(path),
+      file_(path),
+      bytes_(file_.bytes()) {
+  std::int64_t const header_size = std::strlen(binary_journal_header);
+  binary_ = bytes_.size >= header_size &&
+            std::memcmp(bytes_.data, binary_journal_header, header_size) == 0;
+  position_ = binary_ ? header_size : 0;
+  StartDecoder();
+}
+
+Player::~Player() {
+  StopDecoder();
 }
 
 bool Player::Play() {
@@ -49,6 +65,7 @@ bool Player::Play() {
   if (after - before > std::chrono::milliseconds(100)) {
     LOG(ERROR) << "Long method:\n" << method_in->DebugString();
   }
+  RecordLatency(*method_in, after - before);
 
   last_method_in_.swap(method_in);
   last_method_out_return_.swap(method_out_return);
@@ -56,6 +73,35 @@ bool Player::Play() {
   return true;
 }
 
+bool Player::SeekToMethod(std::int64_t const method) {
+  CHECK(binary_) << "Only binary journals are seekable: " << path_;
+
+  // Find the last checkpoint at or before |method|.
+  std::int64_t checkpoint_method = 0;
+  std::int64_t checkpoint_offset = std::strlen(binary_journal_header);
+  std::ifstream index(JournalIndexPath(path_), std::ios::in);
+  std::int64_t indexed_method;
+  std::int64_t indexed_offset;
+  while (index >> indexed_method >> indexed_offset &&
+         indexed_method <= method) {
+    checkpoint_method = indexed_method;
+    checkpoint_offset = indexed_offset;
+  }
+
+  StopDecoder();
+  CHECK_LE(checkpoint_offset, bytes_.size);
+  position_ = checkpoint_offset;
+  bool found = true;
+  for (std::int64_t m = checkpoint_method; m < method; ++m) {
+    if (!SkipBinary() || !SkipBinary()) {
+      found = false;
+      break;
+    }
+  }
+  StartDecoder();
+  return found;
+}
+
 serialization::Method const& Player::last_method_in() const {
   return *last_method_in_;
 }
@@ -64,18 +110,190 @@ serialization::Method const& Player::last_method_out_return() const {
   return *last_method_out_return_;
 }
 
+Player::LatencyMap const& Player::latencies() const {
+  return latencies_;
+}
+
+std::string Player::LatencyReport() const {
+  std::vector<std::pair<std::string, Latencies>> sorted(latencies_.begin(),
+                                                        latencies_.end());
+  std::sort(sorted.begin(),
+            sorted.end(),
+            [](auto const& left, auto const& right) {
+              return left.second.total > right.second.total;
+            });
+  std::stringstream report;
+  for (auto const& [name, latencies] : sorted) {
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    report << name << ": count " << latencies.count << ", total "
+           << Microseconds(latencies.total).count() << " µs, mean "
+           << Microseconds(latencies.total).count() / latencies.count
+           << " µs, max " << Microseconds(latencies.max).count()
+           << " µs, histogram [µs]:";
+    // Only print the populated range of the histogram.
+    auto const& histogram = latencies.histogram;
+    int first = 0;
+    while (histogram[first] == 0) {
+      ++first;
+    }
+    int last = static_cast<int>(histogram.size()) - 1;
+    while (histogram[last] == 0) {
+      --last;
+    }
+    for (int i = first; i <= last; ++i) {
+      report << " " << (std::int64_t{1} << i) << ":" << histogram[i];
+    }
+    report << "\n";
+  }
+  return report.str();
+}
+
+void Player::RecordLatency(serialization::Method const& method_in,
+                           std::chrono::nanoseconds const latency) {
+  // The method has no fields, only the extension of its profile.
+  std::vector<google::protobuf::FieldDescriptor const*> fields;
+  method_in.GetReflection()->ListFields(method_in, &fields);
+  CHECK_EQ(1, fields.size()) << method_in.DebugString();
+  auto& latencies = latencies_[fields[0]->extension_scope()->name()];
+
+  ++latencies.count;
+  latencies.total += latency;
+  latencies.max = std::max(latencies.max, latency);
+  std::int64_t const microseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  int bucket = 0;
+  while (bucket < static_cast<int>(latencies.histogram.size()) - 1 &&
+         (std::int64_t{2} << bucket) <= microseconds) {
+    ++bucket;
+  }
+  ++latencies.histogram[bucket];
+}
+
 std::unique_ptr<serialization::Method> Player::Read() {
-  std::string const line = GetLine(stream_);
-  if (line.empty()) {
+  std::unique_lock<std::mutex> l(decoded_queue_lock_);
+  decoded_queue_not_empty_.wait(
+      l, [this]() { return end_of_journal_ || !decoded_queue_.empty(); });
+  if (decoded_queue_.empty()) {
+    return nullptr;
+  }
+  std::unique_ptr<serialization::Method> method =
+      std::move(decoded_queue_.front());
+  decoded_queue_.pop_front();
+  l.unlock();
+  decoded_queue_not_full_.notify_one();
+  return method;
+}
+
+void Player::StartDecoder() {
+  CHECK(!decoder_.joinable());
+  decoder_ = std::thread([this]() { Decode(); });
+}
+
+void Player::StopDecoder() {
+  {
+    std::lock_guard<std::mutex> l(decoded_queue_lock_);
+    stopping_decoder_ = true;
+  }
+  decoded_queue_not_full_.notify_one();
+  decoder_.join();
+  std::lock_guard<std::mutex> l(decoded_queue_lock_);
+  decoded_queue_.clear();
+  end_of_journal_ = false;
+  stopping_decoder_ = false;
+}
+
+void Player::Decode() {
+  for (;;) {
+    // Parse outside of the lock, so that the caller of |Read| is not blocked.
+    std::unique_ptr<serialization::Method> method = DecodeOne();
+    {
+      std::unique_lock<std::mutex> l(decoded_queue_lock_);
+      decoded_queue_not_full_.wait(l, [this]() {
+        return stopping_decoder_ ||
+               static_cast<std::int64_t>(decoded_queue_.size()) <
+                   decoded_queue_capacity;
+      });
+      if (stopping_decoder_) {
+        return;
+      }
+      if (method == nullptr) {
+        end_of_journal_ = true;
+      } else {
+        decoded_queue_.push_back(std::move(method));
+      }
+    }
+    decoded_queue_not_empty_.notify_one();
+    if (method == nullptr) {
+      return;
+    }
+  }
+}
+
+std::unique_ptr<serialization::Method> Player::DecodeOne() {
+  return binary_ ? DecodeBinary() : DecodeHexadecimal();
+}
+
+bool Player::ReadBinarySize(std::uint32_t& size) {
+  if (position_ == bytes_.size) {
+    return false;
+  }
+  CHECK_LE(position_ + static_cast<std::int64_t>(sizeof(std::uint32_t)),
+           bytes_.size)
+      << "Truncated journal";
+  size = 0;
+  for (std::size_t i = 0; i < sizeof(std::uint32_t); ++i) {
+    size |= static_cast<std::uint32_t>(bytes_.data[position_ + i]) << (8 * i);
+  }
+  position_ += sizeof(std::uint32_t);
+  return true;
+}
+
+std::unique_ptr<serialization::Method> Player::DecodeBinary() {
+  std::uint32_t size;
+  if (!ReadBinarySize(size)) {
+    return nullptr;
+  }
+  CHECK_LE(position_ + size, bytes_.size) << "Truncated journal";
+  // The message is parsed directly from the mapped file, without copying.
+  auto method = std::make_unique<serialization::Method>();
+  CHECK(method->ParseFromArray(&bytes_.data[position_],
+                               static_cast<int>(size)));
+  position_ += size;
+  return method;
+}
+
+std::unique_ptr<serialization::Method> Player::DecodeHexadecimal() {
+  char const* const begin =
+      reinterpret_cast<char const*>(&bytes_.data[position_]);
+  char const* const end =
+      reinterpret_cast<char const*>(&bytes_.data[bytes_.size]);
+  char const* const newline = std::find(begin, end, '\n');
+  position_ += newline - begin + (newline == end ? 0 : 1);
+  // Journals written in text mode on Windows have CRLF line endings.
+  char const* line_end = newline;
+  if (line_end != begin && line_end[-1] == '\r') {
+    --line_end;
+  }
+  if (line_end == begin) {
     return nullptr;
   }
 
-  auto const bytes = HexadecimalDecode({line.c_str(), strlen(line.c_str())});
+  auto const bytes = HexadecimalDecode({begin, line_end - begin});
   auto method = std::make_unique<serialization::Method>();
   CHECK(method->ParseFromArray(bytes.data.get(), static_cast<int>(bytes.size)));
 
   return method;
 }
 
+bool Player::SkipBinary() {
+  std::uint32_t size;
+  if (!ReadBinarySize(size)) {
+    return false;
+  }
+  CHECK_LE(position_ + size, bytes_.size) << "Truncated journal";
+  position_ += size;
+  return true;
+}
+
 }  // namespace journal
 }  // namespace principia
@@ -1,11 +1,21 @@
 ﻿
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <filesystem>
-#include <fstream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
+#include "base/array.hpp"
+#include "base/macros.hpp"
+#include "base/mapped_file.hpp"
 #include "serialization/journal.pb.h"
 
 namespace principia {
@@ -15,25 +25,111 @@ class Player final {
  public:
   using PointerMap = std::map<std::uint64_t, void*>;
 
+  // The time spent replaying the methods of one profile.
+  struct Latencies final {
+    std::int64_t count = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+    // The element at index i counts the methods whose latency is in
+    // [2^i µs, 2^(i+1) µs[; the first element also counts those faster than
+    // 1 µs, the last one those slower than 2^(size-1) µs.
+    std::array<std::int64_t, 32> histogram{};
+  };
+  // Keyed by the name of the profile, e.g., "AdvanceTime".
+  using LatencyMap = std::map<std::string, Latencies>;
+
+  // The format of the journal written by the recorder is detected
+  // automatically.  The journal is mapped in memory, and a background thread
+  // decodes and parses the messages ahead of their execution.
   explicit Player(std::filesystem::path const& path);
+  ~Player();
 
   // Replays the next message in the journal.  Returns false at end of journal.
   bool Play();
 
+  // Positions the player so that the next call to |Play| replays the method
+  // at index |method| (counting pairs of messages from 0), without replaying
+  // the methods before it: the objects that they created are unknown to the
+  // player.  Uses the index of the journal, if there is one, and skips the
+  // unindexed messages without parsing them.  Returns false if the journal
+  // has fewer methods.  Only supported for binary journals.
+  bool SeekToMethod(std::int64_t method);
+
   // Return the last replayed messages.
   serialization::Method const& last_method_in() const;
   serialization::Method const& last_method_out_return() const;
 
+  // The latencies of the methods replayed so far.
+  LatencyMap const& latencies() const;
+
+  // A human-readable report of |latencies()|, one profile per line, sorted by
+  // decreasing total time.
+  std::string LatencyReport() const;
+
  private:
-  // Reads one message from the stream.  Returns a |nullptr| at end of stream.
+  // The maximum number of messages that |decoder_| parses ahead of |Read|.
+  static constexpr std::int64_t decoded_queue_capacity = 1024;
+
+  // Returns the next message parsed by |decoder_|, blocking if necessary.
+  // Returns a |nullptr| at end of journal.
   std::unique_ptr<serialization::Method> Read();
 
+  // Starts |decoder_| at |position_|.
+  void StartDecoder();
+  // Stops |decoder_| and discards the messages that it has parsed.
+  // |position_| is then meaningless.
+  void StopDecoder();
+
+  // Runs on |decoder_|: parses the messages and pushes them to
+  // |decoded_queue_| until the end of the journal or until stopped.
+  void Decode();
+
+  // Parses the message at |position_| and advances past it.  Returns a
+  // |nullptr| at end of journal.
+  std::unique_ptr<serialization::Method> DecodeOne();
+
+  // Adds |latency| to the statistics of the profile of |method_in|.
+  void RecordLatency(serialization::Method const& method_in,
+                     std::chrono::nanoseconds latency);
+
   template<typename Profile>
   bool RunIfAppropriate(serialization::Method const& method_in,
                         serialization::Method const& method_out_return);
 
+  // Reads the size that precedes a message written by a recorder in binary
+  // format at |position_|, and advances past it.  Returns false at end of
+  // journal.
+  bool ReadBinarySize(std::uint32_t& size);
+
+  // Parses one message written by a recorder in binary format.
+  std::unique_ptr<serialization::Method> DecodeBinary();
+
+  // Parses one line written by a recorder in hexadecimal format.
+  std::unique_ptr<serialization::Method> DecodeHexadecimal();
+
+  // Skips one message written by a recorder in binary format.  Returns false
+  // at end of journal.
+  bool SkipBinary();
+
   PointerMap pointer_map_;
-  std::ifstream stream_;
+  std::filesystem::path const path_;
+  base::MappedFile const file_;
+  base::Array<std::uint8_t const> const bytes_;
+  // True if the journal was written by a recorder in binary format.
+  bool binary_ = false;
+  // The offset in |bytes_| of the next message to decode.  Only accessed by
+  // |decoder_| while it runs.
+  std::int64_t position_ = 0;
+  LatencyMap latencies_;
+
+  std::mutex decoded_queue_lock_;
+  std::condition_variable decoded_queue_not_empty_;
+  std::condition_variable decoded_queue_not_full_;
+  std::deque<std::unique_ptr<serialization::Method>> decoded_queue_
+      GUARDED_BY(decoded_queue_lock_);
+  bool end_of_journal_ GUARDED_BY(decoded_queue_lock_) = false;
+  bool stopping_decoder_ GUARDED_BY(decoded_queue_lock_) = false;
+  std::thread decoder_;
 
   std::unique_ptr<serialization::Method> last_method_in_;
   std::unique_ptr<serialization::Method> last_method_out_return_;
@@ -18,6 +18,8 @@
 namespace principia {
 namespace journal {
 
+// Replays a recorded session and reports the latency of each interface
+// method, so that regressions on real workloads may be tracked.
 void BM_PlayForReal(benchmark::State& state) {
   while (state.KeepRunning()) {
     Player player(
@@ -28,6 +30,7 @@ void BM_PlayForReal(benchmark::State& state) {
       LOG_IF(ERROR, (count % 100'000) == 0)
           << count << " journal entries replayed";
     }
+    LOG(ERROR) << "Latencies:\n" << player.LatencyReport();
   }
 }
 
@@ -82,6 +85,58 @@ TEST_F(PlayerTest, PlayTiny) {
     ++count;
   }
   EXPECT_EQ(2, count);
+
+  auto const& latencies = player.latencies();
+  EXPECT_EQ(2, latencies.size());
+  for (std::string const name : {"NewPlugin", "DeletePlugin"}) {
+    auto const it = latencies.find(name);
+    ASSERT_NE(latencies.end(), it) << name;
+    EXPECT_EQ(1, it->second.count);
+    std::int64_t histogram_count = 0;
+    for (std::int64_t const c : it->second.histogram) {
+      histogram_count += c;
+    }
+    EXPECT_EQ(1, histogram_count);
+    EXPECT_EQ(it->second.total, it->second.max);
+  }
+  EXPECT_NE(std::string::npos, player.LatencyReport().find("NewPlugin"));
+}
+
+TEST_F(PlayerTest, SeekToMethod) {
+  std::int64_t const count = 2 * Recorder::index_interval + 123;
+  std::thread recorder([this, count]() {
+    Recorder* const r(new Recorder(test_name_ + ".journal.bin",
+                                   Recorder::Format::BINARY));
+    Recorder::Activate(r);
+    for (std::int64_t i = 0; i < count; ++i) {
+      Method<NewPlugin> m({"MJD1", "MJD2", static_cast<double>(i)});
+      m.Return(plugin_.get());
+    }
+    Recorder::Deactivate();
+  });
+  recorder.join();
+
+  Player player(test_name_ + ".journal.bin");
+  for (std::int64_t const method : {std::int64_t{0},
+                                    std::int64_t{17},
+                                    Recorder::index_interval,
+                                    Recorder::index_interval + 42,
+                                    count - 1}) {
+    ASSERT_TRUE(player.SeekToMethod(method)) << method;
+    auto const method_in = player.Read();
+    ASSERT_NE(nullptr, method_in);
+    EXPECT_EQ(method,
+              method_in->GetExtension(serialization::NewPlugin::extension)
+                  .in()
+                  .planetarium_rotation_in_degrees());
+    auto const method_out_return = player.Read();
+    ASSERT_NE(nullptr, method_out_return);
+    EXPECT_TRUE(method_out_return->GetExtension(
+        serialization::NewPlugin::extension).has_return_());
+  }
+  EXPECT_TRUE(player.SeekToMethod(count));
+  EXPECT_EQ(nullptr, player.Read());
+  EXPECT_FALSE(player.SeekToMethod(count + 1));
 }
 
 TEST_F(PlayerTest, DISABLED_Benchmarks) {
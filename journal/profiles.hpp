@@ -31,6 +31,7 @@ using interface::Status;
 using interface::WXYZ;
 using interface::XY;
 using interface::XYZ;
+using ksp_plugin::FreefallFuture;
 using ksp_plugin::NavigationFrame;
 using ksp_plugin::PileUpFuture;
 using ksp_plugin::Planetarium;
@@ -1,7 +1,10 @@
 ﻿
 #include "journal/recorder.hpp"
 
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <thread>
 
 #include "base/array.hpp"
 #include "base/hexadecimal.hpp"
@@ -16,22 +19,70 @@ using base::UniqueArray;
 
 namespace journal {
 
-Recorder::Recorder(std::filesystem::path const& path)
-    : stream_(path, std::ios::out) {
+std::filesystem::path JournalIndexPath(std::filesystem::path const& path) {
+  std::filesystem::path index_path = path;
+  index_path += ".index";
+  return index_path;
+}
+
+Recorder::Recorder(std::filesystem::path const& path, Format const format)
+    : Recorder(path, Options{format}) {}
+
+Recorder::Recorder(std::filesystem::path const& path, Options const& options)
+    : format_(options.format),
+      selection_(options.selection),
+      rolling_window_(options.rolling_window),
+      stream_(path,
+              format_ == Format::BINARY ? std::ios::out | std::ios::binary
+                                        : std::ios::out) {
   CHECK(!stream_.fail()) << path;
+  CHECK(!rolling_window_.has_value() || format_ == Format::BINARY)
+      << "A rolling window requires the binary format";
+  if (format_ == Format::BINARY) {
+    stream_ << binary_journal_header;
+    offset_ = std::strlen(binary_journal_header);
+    index_stream_.open(JournalIndexPath(path), std::ios::out);
+    CHECK(!index_stream_.fail()) << JournalIndexPath(path);
+    if (rolling_window_.has_value()) {
+      CHECK_LT(std::chrono::steady_clock::duration::zero(), *rolling_window_);
+      Recorder* expected = nullptr;
+      CHECK(rolling_recorder_.compare_exchange_strong(expected, this))
+          << "There is already a recorder with a rolling window";
+      google::InstallFailureFunction(&WriteRollingWindowAndAbort);
+    } else {
+      writer_ = std::thread([this]() { WriteBuffers(); });
+    }
+  }
 }
 
 Recorder::~Recorder() {
+  if (rolling_window_.has_value()) {
+    rolling_recorder_ = nullptr;
+    {
+      std::lock_guard<std::mutex> l(buffer_lock_);
+      WriteRollingWindowLocked();
+    }
+    index_stream_.close();
+  } else if (format_ == Format::BINARY) {
+    {
+      std::lock_guard<std::mutex> l(buffer_lock_);
+      stopping_ = true;
+    }
+    buffer_not_empty_.notify_one();
+    writer_.join();
+    index_stream_.close();
+  }
   stream_.close();
 }
 
 void Recorder::WriteAtConstruction(serialization::Method const& method) {
   lock_.lock();
-  WriteLocked(method);
+  WriteLocked(method, /*first_of_pair=*/true);
+  ++methods_;
 }
 
 void Recorder::WriteAtDestruction(serialization::Method const& method) {
-  WriteLocked(method);
+  WriteLocked(method, /*first_of_pair=*/false);
   lock_.unlock();
 }
 
@@ -50,15 +101,122 @@ bool Recorder::IsActivated() {
   return active_recorder_ != nullptr;
 }
 
-void Recorder::WriteLocked(serialization::Method const& method) {
-  CHECK_LT(0, method.ByteSize()) << method.DebugString();
+void Recorder::WriteLocked(serialization::Method const& method,
+                           bool const first_of_pair) {
+  if (rolling_window_.has_value()) {
+    std::lock_guard<std::mutex> l(buffer_lock_);
+    // A new segment is only started at a pair, so that the retained messages
+    // always start with a complete pair.
+    auto const now = std::chrono::steady_clock::now();
+    if (first_of_pair &&
+        (segments_.empty() ||
+         now - segments_.back().start >=
+             *rolling_window_ / segments_per_window)) {
+      segments_.push_back({now, methods_, {}});
+      // Drop the segments that are entirely outside of the window.
+      while (segments_.size() > 1 &&
+             segments_[1].start <= now - *rolling_window_) {
+        segments_.pop_front();
+      }
+    }
+    AppendMessage(method, segments_.back().bytes);
+    return;
+  }
+  if (format_ == Format::BINARY) {
+    {
+      std::lock_guard<std::mutex> l(buffer_lock_);
+      if (first_of_pair && methods_ % index_interval == 0) {
+        index_.push_back({methods_, offset_});
+      }
+      std::size_t const offset = buffer_.size();
+      AppendMessage(method, buffer_);
+      offset_ += buffer_.size() - offset;
+    }
+    buffer_not_empty_.notify_one();
+    return;
+  }
   auto const hexadecimal = HexadecimalEncode(SerializeAsBytes(method).get(),
                                              /*null_terminated=*/true);
   stream_ << hexadecimal.data.get() << "\n";
   stream_.flush();
 }
 
+void Recorder::AppendMessage(serialization::Method const& method,
+                             std::vector<std::uint8_t>& bytes) {
+  int const size = method.ByteSize();
+  CHECK_LT(0, size) << method.DebugString();
+  std::size_t const offset = bytes.size();
+  bytes.resize(offset + sizeof(std::uint32_t) + size);
+  std::uint8_t* const data = &bytes[offset];
+  for (std::size_t i = 0; i < sizeof(std::uint32_t); ++i) {
+    data[i] = static_cast<std::uint8_t>(size >> (8 * i));
+  }
+  // The sizes were cached by |ByteSize| above.
+  method.SerializeWithCachedSizesToArray(&data[sizeof(std::uint32_t)]);
+}
+
+void Recorder::WriteRollingWindowLocked() {
+  if (rolling_window_written_) {
+    return;
+  }
+  rolling_window_written_ = true;
+  // The methods are numbered from the beginning of the retained segments, and
+  // each segment gets an index entry.
+  std::int64_t offset = std::strlen(binary_journal_header);
+  for (auto const& segment : segments_) {
+    index_stream_ << segment.first_method - segments_.front().first_method
+                  << " " << offset << "\n";
+    stream_.write(reinterpret_cast<char const*>(segment.bytes.data()),
+                  segment.bytes.size());
+    offset += segment.bytes.size();
+  }
+  stream_.flush();
+  index_stream_.flush();
+}
+
+void Recorder::WriteRollingWindowAndAbort() {
+  Recorder* const recorder = rolling_recorder_;
+  // Don't risk a deadlock if the failure happened while |buffer_lock_| was
+  // held.
+  if (recorder != nullptr && recorder->buffer_lock_.try_lock()) {
+    recorder->WriteRollingWindowLocked();
+    recorder->buffer_lock_.unlock();
+  }
+  std::abort();
+}
+
+void Recorder::WriteBuffers() {
+  std::vector<std::uint8_t> batch;
+  std::vector<IndexEntry> index;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> l(buffer_lock_);
+      buffer_not_empty_.wait(
+          l, [this]() { return stopping_ || !buffer_.empty(); });
+      if (buffer_.empty()) {
+        return;
+      }
+      // Swapping keeps the capacity of both buffers, so that in the steady
+      // state no allocation takes place.
+      batch.swap(buffer_);
+      index.swap(index_);
+    }
+    stream_.write(reinterpret_cast<char const*>(batch.data()), batch.size());
+    stream_.flush();
+    CHECK(!stream_.fail());
+    batch.clear();
+    // The index is written after the journal so that it never designates
+    // messages that are not in the file.
+    for (auto const& entry : index) {
+      index_stream_ << entry.method << " " << entry.offset << "\n";
+    }
+    index_stream_.flush();
+    index.clear();
+  }
+}
+
 thread_local Recorder* Recorder::active_recorder_ = nullptr;
+std::atomic<Recorder*> Recorder::rolling_recorder_ = nullptr;
 
 }  // namespace journal
 }  // namespace principia
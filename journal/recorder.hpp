@@ -1,10 +1,19 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
 
+#include "base/macros.hpp"
 #include "base/not_null.hpp"
 #include "serialization/journal.pb.h"
 
@@ -13,9 +22,62 @@ namespace journal {
 
 FORWARD_DECLARE_FROM(method, template<typename Profile> class, Method);
 
+// The first line of a journal written in |Format::BINARY|.  It contains
+// characters that are not hexadecimal digits, so it cannot be confused with
+// the first line of a journal written in |Format::HEXADECIMAL|.
+constexpr char binary_journal_header[] = "PRINCIPIA BINARY JOURNAL\n";
+
+// The index of a journal written in |Format::BINARY| is a text file with one
+// line "<method number> <byte offset>" per checkpoint.  The method number
+// counts pairs of messages, and the offset is that of the first message of
+// the pair in the journal.
+std::filesystem::path JournalIndexPath(std::filesystem::path const& path);
+
 class Recorder final {
  public:
-  explicit Recorder(std::filesystem::path const& path);
+  enum class Format {
+    // Each message is written as a line of hexadecimal digits, and the stream
+    // is flushed after each message.
+    HEXADECIMAL,
+    // Each message is written as its size in bytes, as a 32-bit little-endian
+    // integer, followed by its serialized bytes.  The writes happen on a
+    // background thread which flushes the stream once per batch of messages.
+    // This is much cheaper for the caller, but the messages recorded shortly
+    // before a crash may be lost.  An index is written next to the journal,
+    // see |JournalIndexPath|, with a checkpoint every |index_interval|
+    // methods.
+    BINARY,
+  };
+
+  // Which methods are recorded.
+  enum class Selection {
+    ALL,
+    // The queries, i.e., the methods whose profile has |is_query| set, are not
+    // recorded.  They don't change the state of the plugin and don't produce
+    // or consume pointers, so the journal can still be replayed, but it is
+    // much smaller and cheaper to write, since the queries are the bulk of the
+    // calls (e.g., when plotting).
+    REPLAYABLE,
+  };
+
+  struct Options final {
+    Format format = Format::HEXADECIMAL;
+    Selection selection = Selection::ALL;
+    // Only supported in |Format::BINARY|.  If set, the messages are kept in
+    // memory instead of being written as they are recorded, and only those of
+    // (roughly) the last |rolling_window| are retained.  They are written when
+    // the recorder is destroyed or when a CHECK fails.  The journal starts in
+    // the middle of the session, so it cannot be replayed from the beginning,
+    // but it may be read, or replayed after |Player::SeekToMethod| with the
+    // method numbers counted from the start of the retained messages.
+    std::optional<std::chrono::steady_clock::duration> rolling_window;
+  };
+
+  static constexpr std::int64_t index_interval = 10'000;
+
+  explicit Recorder(std::filesystem::path const& path,
+                    Format format = Format::HEXADECIMAL);
+  Recorder(std::filesystem::path const& path, Options const& options);
   ~Recorder();
 
   // Locking is used to ensure that the pairs of writes don't get intermixed.
@@ -27,12 +89,69 @@ class Recorder final {
   static bool IsActivated();
 
  private:
-  void WriteLocked(serialization::Method const& method);
+  // A part of the rolling window, starting at a pair of messages.
+  struct Segment final {
+    std::chrono::steady_clock::time_point start;
+    // The number of the first method of the segment.
+    std::int64_t first_method;
+    std::vector<std::uint8_t> bytes;
+  };
+
+  // The rolling window is made of that many segments, so that it is trimmed
+  // in increments of |rolling_window / segments_per_window|.
+  static constexpr std::int64_t segments_per_window = 16;
+
+  // |first_of_pair| is true if |method| is the first message of a pair.
+  void WriteLocked(serialization::Method const& method, bool first_of_pair);
 
+  // Appends the size of |method| followed by its serialization to |bytes|.
+  static void AppendMessage(serialization::Method const& method,
+                            std::vector<std::uint8_t>& bytes);
+
+  // Writes the retained |segments_| to the journal and to its index.
+  void WriteRollingWindowLocked();
+
+  // Installed as the failure function of glog: writes the rolling window of
+  // |rolling_recorder_|, if any, and aborts.
+  [[noreturn]] static void WriteRollingWindowAndAbort();
+
+  // Runs on |writer_| in |Format::BINARY|: writes the messages accumulated in
+  // |buffer_| until |stopping_| is set and the buffer is empty.
+  void WriteBuffers();
+
+  struct IndexEntry final {
+    std::int64_t method;
+    std::int64_t offset;
+  };
+
+  Format const format_;
+  Selection const selection_;
+  std::optional<std::chrono::steady_clock::duration> const rolling_window_;
   std::mutex lock_;
   std::ofstream stream_;
 
+  // Only used in |Format::BINARY|.
+  std::ofstream index_stream_;
+  // The number of methods started, and the number of bytes written to the
+  // journal, including those that are still in |buffer_|.
+  std::int64_t methods_ GUARDED_BY(lock_) = 0;
+  std::int64_t offset_ GUARDED_BY(lock_) = 0;
+  std::mutex buffer_lock_;
+  std::condition_variable buffer_not_empty_;
+  std::vector<std::uint8_t> buffer_ GUARDED_BY(buffer_lock_);
+  // Written to |index_stream_| once the corresponding messages are flushed.
+  std::vector<IndexEntry> index_ GUARDED_BY(buffer_lock_);
+  bool stopping_ GUARDED_BY(buffer_lock_) = false;
+  std::thread writer_;
+
+  // Only used with a |rolling_window_|.  The messages are only written once.
+  std::deque<Segment> segments_ GUARDED_BY(buffer_lock_);
+  bool rolling_window_written_ GUARDED_BY(buffer_lock_) = false;
+
   static thread_local Recorder* active_recorder_;
+  // The recorder with a rolling window, if any, which is written when a CHECK
+  // fails, on whatever thread.
+  static std::atomic<Recorder*> rolling_recorder_;
 
   template<typename>
   friend class Method;
@@ -1,9 +1,11 @@
 ﻿
 #include "journal/recorder.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <list>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "base/array.hpp"
@@ -44,6 +46,10 @@ class RecorderTest : public testing::Test {
     return methods;
   }
 
+  static std::unique_ptr<serialization::Method> Read(Player& player) {
+    return player.Read();
+  }
+
 
   std::string const test_name_;
   std::unique_ptr<ksp_plugin::Plugin> plugin_;
@@ -126,5 +132,118 @@ TEST_F(RecorderTest, Recording) {
   }
 }
 
+TEST_F(RecorderTest, BinaryRecording) {
+  // Replace the recorder of the fixture with a binary one.
+  Recorder::Deactivate();
+  std::string const path = test_name_ + ".journal.bin";
+  Recorder::Activate(new Recorder(path, Recorder::Format::BINARY));
+  for (int i = 0; i < 100; ++i) {
+    Method<NewPlugin> m({"1 s", "2 s", static_cast<double>(i)});
+    m.Return(plugin_.get());
+  }
+  // Deactivating destroys the recorder, which writes all pending messages.
+  Recorder::Deactivate();
+  recorder_ = new Recorder(test_name_ + ".journal.hex");
+  Recorder::Activate(recorder_);
+
+  std::vector<serialization::Method> const methods = ReadAll(path);
+  ASSERT_EQ(200, methods.size());
+  for (int i = 0; i < 100; ++i) {
+    {
+      auto const& method = methods[2 * i];
+      EXPECT_TRUE(method.HasExtension(serialization::NewPlugin::extension));
+      auto const& extension =
+          method.GetExtension(serialization::NewPlugin::extension);
+      EXPECT_TRUE(extension.has_in());
+      EXPECT_EQ("1 s", extension.in().game_epoch());
+      EXPECT_EQ(i, extension.in().planetarium_rotation_in_degrees());
+    }
+    {
+      auto const& method = methods[2 * i + 1];
+      EXPECT_TRUE(method.HasExtension(serialization::NewPlugin::extension));
+      auto const& extension =
+          method.GetExtension(serialization::NewPlugin::extension);
+      EXPECT_TRUE(extension.has_return_());
+      EXPECT_NE(0, extension.return_().result());
+    }
+  }
+}
+
+TEST_F(RecorderTest, ReplayableSelection) {
+  static_assert(CurrentTime::is_query);
+  static_assert(!NewPlugin::is_query);
+  static_assert(!IteratorIncrement::is_query);
+
+  Recorder::Deactivate();
+  std::string const path = test_name_ + ".journal.bin";
+  Recorder::Options options;
+  options.format = Recorder::Format::BINARY;
+  options.selection = Recorder::Selection::REPLAYABLE;
+  Recorder::Activate(new Recorder(path, options));
+  for (int i = 0; i < 10; ++i) {
+    {
+      Method<NewPlugin> m({"1 s", "2 s", static_cast<double>(i)});
+      m.Return(plugin_.get());
+    }
+    {
+      Method<CurrentTime> m({plugin_.get()});
+      m.Return(3.0);
+    }
+  }
+  Recorder::Deactivate();
+  recorder_ = new Recorder(test_name_ + ".journal.hex");
+  Recorder::Activate(recorder_);
+
+  std::vector<serialization::Method> const methods = ReadAll(path);
+  ASSERT_EQ(20, methods.size());
+  for (auto const& method : methods) {
+    EXPECT_TRUE(method.HasExtension(serialization::NewPlugin::extension));
+  }
+}
+
+TEST_F(RecorderTest, RollingWindow) {
+  Recorder::Deactivate();
+  std::string const path = test_name_ + ".journal.bin";
+  Recorder::Options options;
+  options.format = Recorder::Format::BINARY;
+  options.rolling_window = std::chrono::milliseconds(16);
+  Recorder::Activate(new Recorder(path, options));
+  auto const record = [this](int const first, int const last) {
+    for (int i = first; i < last; ++i) {
+      Method<NewPlugin> m({"1 s", "2 s", static_cast<double>(i)});
+      m.Return(plugin_.get());
+    }
+  };
+  // The segment that starts with method 10 is the last one that begins
+  // outside of the window when method 11 is recorded, so it is retained.
+  record(0, 10);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  record(10, 11);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  record(11, 21);
+  // Deactivating destroys the recorder, which writes the rolling window.
+  Recorder::Deactivate();
+  recorder_ = new Recorder(test_name_ + ".journal.hex");
+  Recorder::Activate(recorder_);
+
+  std::vector<serialization::Method> const methods = ReadAll(path);
+  ASSERT_EQ(22, methods.size());
+  for (int i = 0; i < 11; ++i) {
+    auto const& extension =
+        methods[2 * i].GetExtension(serialization::NewPlugin::extension);
+    EXPECT_EQ(10 + i, extension.in().planetarium_rotation_in_degrees());
+  }
+
+  // The methods are numbered from the start of the window.
+  Player player(path);
+  ASSERT_TRUE(player.SeekToMethod(1));
+  auto const method_in = Read(player);
+  ASSERT_NE(nullptr, method_in);
+  EXPECT_EQ(11,
+            method_in->GetExtension(serialization::NewPlugin::extension)
+                .in()
+                .planetarium_rotation_in_degrees());
+}
+
 }  // namespace journal
 }  // namespace principia
@@ -0,0 +1,98 @@
+﻿
+#include "journal/tracer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace journal {
+
+using base::not_null;
+
+Tracer::Tracer(std::int64_t const capacity)
+    : origin_(Clock::now()) {
+  CHECK_LT(0, capacity);
+  events_.resize(capacity);
+}
+
+void Tracer::Record(std::string const& method,
+                    Clock::time_point const& start,
+                    Clock::time_point const& end) {
+  Event const event{&method, std::this_thread::get_id(), start, end};
+  std::lock_guard<std::mutex> l(lock_);
+  events_[next_ % events_.size()] = event;
+  ++next_;
+}
+
+void Tracer::WriteChromeTrace(std::ostream& out) const {
+  // The timestamps and durations are in microseconds.
+  auto const microseconds = [](Clock::duration const& duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+  std::hash<std::thread::id> const thread_hash;
+
+  std::lock_guard<std::mutex> l(lock_);
+  std::int64_t const size = std::min<std::int64_t>(next_, events_.size());
+  out << "{\"traceEvents\":[\n";
+  out << std::fixed << std::setprecision(3);
+  for (std::int64_t i = next_ - size; i < next_; ++i) {
+    Event const& event = events_[i % events_.size()];
+    // The method names are identifiers, so they need no escaping.
+    out << "{\"name\":\"" << *event.method
+        << "\",\"cat\":\"interface\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+        << thread_hash(event.thread)
+        << ",\"ts\":" << microseconds(event.start - origin_)
+        << ",\"dur\":" << microseconds(event.end - event.start) << "}"
+        << (i + 1 < next_ ? ",\n" : "\n");
+  }
+  out << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void Tracer::WriteChromeTrace(std::filesystem::path const& path) const {
+  std::ofstream stream(path);
+  CHECK(!stream.fail()) << path;
+  WriteChromeTrace(stream);
+  stream.close();
+  CHECK(!stream.fail()) << path;
+}
+
+void Tracer::Activate(not_null<std::unique_ptr<Tracer>> tracer) {
+  CHECK(active_tracer_ == nullptr);
+  active_tracer_.store(tracer.release());
+}
+
+not_null<std::unique_ptr<Tracer>> Tracer::Deactivate() {
+  CHECK(active_tracer_ != nullptr);
+  return std::unique_ptr<Tracer>(active_tracer_.exchange(nullptr));
+}
+
+bool Tracer::IsActivated() {
+  return active_tracer_ != nullptr;
+}
+
+std::optional<Tracer::Clock::time_point> Tracer::StartIfActivated() {
+  if (active_tracer_.load(std::memory_order_relaxed) == nullptr) {
+    return std::nullopt;
+  }
+  return Clock::now();
+}
+
+void Tracer::RecordIfActivated(std::string const& method,
+                               std::optional<Clock::time_point> const& start) {
+  if (start.has_value()) {
+    Tracer* const tracer = active_tracer_.load(std::memory_order_relaxed);
+    if (tracer != nullptr) {
+      tracer->Record(method, *start, Clock::now());
+    }
+  }
+}
+
+std::atomic<Tracer*> Tracer::active_tracer_ = nullptr;
+
+}  // namespace journal
+}  // namespace principia
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/macros.hpp"
+#include "base/not_null.hpp"
+
+namespace principia {
+namespace journal {
+
+FORWARD_DECLARE_FROM(method, template<typename Profile> class, Method);
+
+// Records the wall-clock intervals during which the interface functions run,
+// in a ring buffer that keeps the most recent calls.  The result may be
+// exported in the Chrome trace event format, for viewing with chrome://tracing
+// or similar tools.  Contrary to the |Recorder|, the |Tracer| is shared by all
+// threads, and it records the calls made on any of them.
+class Tracer final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr std::int64_t default_capacity = 1 << 20;
+
+  explicit Tracer(std::int64_t capacity = default_capacity);
+
+  // Records that |method| ran from |start| to |end| on the current thread.
+  // |method| must outlive the |Tracer|.  Thread-safe.
+  void Record(std::string const& method,
+              Clock::time_point const& start,
+              Clock::time_point const& end);
+
+  // Writes the recorded calls, from the oldest to the most recent, as a JSON
+  // object in the Chrome trace event format.  The timestamps are relative to
+  // the construction of the |Tracer|.  Thread-safe.
+  void WriteChromeTrace(std::ostream& out) const;
+  void WriteChromeTrace(std::filesystem::path const& path) const;
+
+  // The tracer must not be activated or deactivated while interface functions
+  // run on other threads.
+  static void Activate(base::not_null<std::unique_ptr<Tracer>> tracer);
+  static base::not_null<std::unique_ptr<Tracer>> Deactivate();
+  static bool IsActivated();
+
+ private:
+  struct Event final {
+    std::string const* method;
+    std::thread::id thread;
+    Clock::time_point start;
+    Clock::time_point end;
+  };
+
+  // Returns the current time if a tracer is active, nullopt otherwise.
+  static std::optional<Clock::time_point> StartIfActivated();
+  // Records the call to |method| in the active tracer if there is one and
+  // |start| is not nullopt.
+  static void RecordIfActivated(
+      std::string const& method,
+      std::optional<Clock::time_point> const& start);
+
+  Clock::time_point const origin_;
+  mutable std::mutex lock_;
+  // A ring buffer, of which |events_[next_ % events_.size()]| is the oldest
+  // element once |next_ >= events_.size()|.
+  std::vector<Event> events_ GUARDED_BY(lock_);
+  std::int64_t next_ GUARDED_BY(lock_) = 0;
+
+  static std::atomic<Tracer*> active_tracer_;
+
+  template<typename>
+  friend class Method;
+};
+
+}  // namespace journal
+}  // namespace principia
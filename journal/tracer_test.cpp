@@ -0,0 +1,74 @@
+﻿
+#include "journal/tracer.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "journal/method.hpp"
+#include "journal/profiles.hpp"
+
+namespace principia {
+namespace journal {
+
+using ::testing::AllOf;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+class TracerTest : public testing::Test {
+ protected:
+  static std::string ChromeTrace(Tracer const& tracer) {
+    std::stringstream trace;
+    tracer.WriteChromeTrace(trace);
+    return trace.str();
+  }
+
+  std::string const first_ = "First";
+  std::string const second_ = "Second";
+  std::string const third_ = "Third";
+};
+
+TEST_F(TracerTest, ChromeTrace) {
+  Tracer tracer(/*capacity=*/10);
+  auto const start = Tracer::Clock::now();
+  tracer.Record(first_, start, start + std::chrono::milliseconds(2));
+  tracer.Record(second_, start, start + std::chrono::microseconds(5));
+  std::string const trace = ChromeTrace(tracer);
+  EXPECT_THAT(trace, HasSubstr("{\"traceEvents\":[\n"));
+  EXPECT_THAT(trace, HasSubstr("{\"name\":\"First\",\"cat\":\"interface\","
+                               "\"ph\":\"X\",\"pid\":0,\"tid\":"));
+  EXPECT_THAT(trace, HasSubstr(",\"dur\":2000.000},\n{\"name\":\"Second\""));
+  EXPECT_THAT(trace, HasSubstr(",\"dur\":5.000}\n]"));
+}
+
+TEST_F(TracerTest, RingBuffer) {
+  Tracer tracer(/*capacity=*/2);
+  auto const start = Tracer::Clock::now();
+  tracer.Record(first_, start, start);
+  tracer.Record(second_, start, start);
+  tracer.Record(third_, start, start);
+  std::string const trace = ChromeTrace(tracer);
+  EXPECT_THAT(trace,
+              AllOf(Not(HasSubstr("First")),
+                    HasSubstr("\"Second\""),
+                    HasSubstr("\"Third\"")));
+  EXPECT_LT(trace.find("Second"), trace.find("Third"));
+}
+
+TEST_F(TracerTest, Method) {
+  EXPECT_FALSE(Tracer::IsActivated());
+  Tracer::Activate(std::make_unique<Tracer>());
+  EXPECT_TRUE(Tracer::IsActivated());
+  {
+    Method<SayHello> m;
+    m.Return("Hello");
+  }
+  auto const tracer = Tracer::Deactivate();
+  EXPECT_FALSE(Tracer::IsActivated());
+  EXPECT_THAT(ChromeTrace(*tracer), HasSubstr("{\"name\":\"SayHello\""));
+}
+
+}  // namespace journal
+}  // namespace principia
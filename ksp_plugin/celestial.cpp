@@ -22,21 +22,37 @@ ContinuousTrajectory<Barycentric> const& Celestial::trajectory() const {
   return *trajectory_;
 }
 
+void Celestial::CacheDegreesOfFreedom(Instant const& current_time) {
+  CHECK(is_initialized());
+  cached_degrees_of_freedom_ =
+      trajectory().EvaluateDegreesOfFreedom(current_time);
+  cached_time_ = current_time;
+}
+
 DegreesOfFreedom<Barycentric> Celestial::current_degrees_of_freedom(
     Instant const& current_time) const {
   CHECK(is_initialized());
+  if (cached_time_ == current_time) {
+    return *cached_degrees_of_freedom_;
+  }
   return trajectory().EvaluateDegreesOfFreedom(current_time);
 }
 
 Position<Barycentric> Celestial::current_position(
     Instant const& current_time) const {
   CHECK(is_initialized());
+  if (cached_time_ == current_time) {
+    return cached_degrees_of_freedom_->position();
+  }
   return trajectory().EvaluatePosition(current_time);
 }
 
 Velocity<Barycentric> Celestial::current_velocity(
     Instant const& current_time) const {
   CHECK(is_initialized());
+  if (cached_time_ == current_time) {
+    return cached_degrees_of_freedom_->velocity();
+  }
   return trajectory().EvaluateVelocity(current_time);
 }
 
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include "base/not_null.hpp"
 #include "ksp_plugin/frames.hpp"
@@ -40,6 +41,13 @@ class Celestial {
   void set_trajectory(
       not_null<ContinuousTrajectory<Barycentric> const*> trajectory);
   ContinuousTrajectory<Barycentric> const& trajectory() const;
+
+  // Evaluates the trajectory at |current_time| and caches the result, so that
+  // the functions below don't evaluate it again for that time.  May be called
+  // concurrently for distinct celestials, but not concurrently with the
+  // functions below.
+  void CacheDegreesOfFreedom(Instant const& current_time);
+
   virtual DegreesOfFreedom<Barycentric> current_degrees_of_freedom(
       Instant const& current_time) const;
   virtual Position<Barycentric> current_position(
@@ -58,6 +66,9 @@ class Celestial {
   // be null for the sun.
   Celestial const* parent_ = nullptr;
   ContinuousTrajectory<Barycentric> const* trajectory_ = nullptr;
+  // The degrees of freedom at |cached_time_|, set by |CacheDegreesOfFreedom|.
+  std::optional<Instant> cached_time_;
+  std::optional<DegreesOfFreedom<Barycentric>> cached_degrees_of_freedom_;
 };
 
 }  // namespace internal_celestial
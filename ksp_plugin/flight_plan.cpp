@@ -1,23 +1,45 @@
 ﻿
 #include "ksp_plugin/flight_plan.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <random>
 #include <vector>
 
+#include "geometry/grassmann.hpp"
+#include "geometry/r3_element.hpp"
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 #include "integrators/methods.hpp"
+#include "physics/apsides.hpp"
+#include "physics/body_centred_non_rotating_dynamic_frame.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/si.hpp"
 #include "testing_utilities/make_not_null.hpp"
 
 namespace principia {
 namespace ksp_plugin {
 namespace internal_flight_plan {
 
+using base::Future;
 using base::make_not_null_unique;
-using geometry::Position;
+using geometry::Displacement;
+using geometry::InnerProduct;
+using geometry::Normalize;
+using geometry::R3Element;
+using geometry::Vector;
 using geometry::Velocity;
 using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
 using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
+using physics::BodyCentredNonRotatingDynamicFrame;
+using physics::ComputeApsides;
+using physics::Frenet;
+using quantities::Pow;
+using quantities::Sqrt;
+using quantities::Square;
 using quantities::si::Metre;
+using quantities::si::Radian;
 using quantities::si::Second;
 
 FlightPlan::FlightPlan(
@@ -101,6 +123,7 @@ void FlightPlan::ForgetBefore(Instant const& time,
     on_empty();
     return;
   }
+  ForgetSegmentSplineIndices(/*first_segment=*/0);
 
   // Detach the first coast to keep, truncate its beginning, and reattach it
   // to a new root.
@@ -142,6 +165,18 @@ bool FlightPlan::ReplaceLast(Burn burn) {
                                          manœuvres_.back().initial_mass());
   if (manœuvre.FitsBetween(start_of_penultimate_coast(), desired_final_time_) &&
       !manœuvre.IsSingular()) {
+    if (manœuvre.initial_time() == manœuvres_.back().initial_time()) {
+      // The penultimate coast already ends at the beginning of the manœuvre
+      // and it is never anomalous, so it doesn't need to be recomputed.  This
+      // is the common case of a change to the Δv or to the frame of the last
+      // burn.  Only the last burn and the last coast are recomputed.
+      manœuvres_.pop_back();
+      PopLastSegment();  // Last coast.
+      PopLastSegment();  // Last burn.
+      CHECK_EQ(0, anomalous_segments_);
+      Append(std::move(manœuvre));
+      return true;
+    }
     DiscreteTrajectory<Barycentric>* recomputed_penultimate_coast =
         CoastIfReachesManœuvreInitialTime(penultimate_coast(), manœuvre);
     if (recomputed_penultimate_coast != nullptr) {
@@ -156,6 +191,191 @@ bool FlightPlan::ReplaceLast(Burn burn) {
   return false;
 }
 
+std::vector<std::optional<FlightPlan::Alternative>>
+FlightPlan::IntegrateAlternativesToLast(
+    std::vector<Burn> burns,
+    not_null<WorkStealingScheduler*> const scheduler) const {
+  CHECK(!manœuvres_.empty());
+  NavigationManœuvre const& last_manœuvre = manœuvres_.back();
+  // The penultimate coast is the antepenultimate segment.
+  DiscreteTrajectory<Barycentric> const& penultimate_coast =
+      *segments_[segments_.size() - 3];
+
+  // The alternatives are created on this thread, and are not resized
+  // afterwards, so that the tasks may refer to their elements.
+  std::vector<std::optional<Alternative>> alternatives(burns.size());
+  std::vector<Future<void>> futures;
+  futures.reserve(burns.size());
+  for (int i = 0; i < burns.size(); ++i) {
+    auto manœuvre = MakeNavigationManœuvre(std::move(burns[i]),
+                                           last_manœuvre.initial_mass());
+    if (!manœuvre.FitsBetween(start_of_penultimate_coast(),
+                              desired_final_time_) ||
+        manœuvre.IsSingular()) {
+      continue;
+    }
+    // As in |ReplaceLast|, the penultimate coast need not be recomputed if
+    // the manœuvre starts at the same time as the last one.
+    auto const start = manœuvre.initial_time() == last_manœuvre.initial_time()
+                           ? penultimate_coast.last()
+                           : penultimate_coast.Fork();
+    auto root = make_not_null_unique<DiscreteTrajectory<Barycentric>>();
+    root->Append(start.time(), start.degrees_of_freedom());
+    alternatives[i].emplace(
+        Alternative{std::move(manœuvre), std::move(root), {}});
+    futures.push_back(scheduler->Add(
+        [this, &alternative = *alternatives[i]]() {
+          IntegrateAlternative(alternative);
+        }));
+  }
+  for (auto const& future : futures) {
+    future.wait();
+  }
+  return alternatives;
+}
+
+FlightPlan::Dispersion FlightPlan::ComputeDispersion(
+    DispersionParameters const& parameters,
+    not_null<MassiveBody const*> const centre,
+    not_null<WorkStealingScheduler*> const scheduler) const {
+  CHECK_LE(0, parameters.samples);
+
+  // The frames of the manœuvres are copied through their serialization.
+  std::vector<serialization::DynamicFrame> frames(manœuvres_.size());
+  for (int i = 0; i < manœuvres_.size(); ++i) {
+    manœuvres_[i].frame()->WriteToMessage(&frames[i]);
+  }
+
+  // The perturbations are drawn on this thread, in a fixed order, so that the
+  // results don't depend on the scheduling.
+  std::mt19937_64 random(parameters.seed);
+  std::normal_distribution<double> normal;
+  auto const random_vector = [&normal, &random]() {
+    double const x = normal(random);
+    double const y = normal(random);
+    double const z = normal(random);
+    return R3Element<double>(x, y, z);
+  };
+
+  struct PerturbedFlightPlan {
+    DegreesOfFreedom<Barycentric> initial_degrees_of_freedom;
+    std::vector<NavigationManœuvre> manœuvres;
+    // False if the perturbed manœuvres cannot be executed.
+    bool is_valid = true;
+    std::optional<Dispersion::Sample> sample;
+  };
+  std::vector<PerturbedFlightPlan> perturbed_flight_plans;
+  perturbed_flight_plans.reserve(parameters.samples);
+  for (int s = 0; s < parameters.samples; ++s) {
+    auto const position_error = random_vector();
+    auto const velocity_error = random_vector();
+    PerturbedFlightPlan perturbed_flight_plan{
+        {initial_degrees_of_freedom_.position() +
+             Displacement<Barycentric>(parameters.position_error *
+                                       position_error),
+         initial_degrees_of_freedom_.velocity() +
+             Velocity<Barycentric>(parameters.velocity_error *
+                                   velocity_error)},
+        {}};
+    Mass mass = initial_mass_;
+    Instant end_of_previous_manœuvre = initial_time_;
+    for (int i = 0; i < manœuvres_.size(); ++i) {
+      NavigationManœuvre const& manœuvre = manœuvres_[i];
+      auto const pointing_error = random_vector();
+      double const Δv_error = normal(random);
+      double const timing_error = normal(random);
+
+      // The planned manœuvres are reproduced exactly in the absence of errors.
+      Vector<double, Frenet<Navigation>> direction = manœuvre.direction();
+      if (parameters.pointing_error != Angle() &&
+          direction != Vector<double, Frenet<Navigation>>()) {
+        // For small errors, adding an orthogonal vector is the same as rotating
+        // about the orthogonal axes.
+        Vector<double, Frenet<Navigation>> error(pointing_error);
+        error -= InnerProduct(error, direction) * direction;
+        direction =
+            Normalize(direction + (parameters.pointing_error / Radian) * error);
+      }
+      NavigationManœuvre perturbed_manœuvre(
+          manœuvre.thrust(),
+          mass,
+          manœuvre.specific_impulse(),
+          direction,
+          NavigationFrame::ReadFromMessage(frames[i], ephemeris_),
+          manœuvre.is_inertially_fixed());
+      perturbed_manœuvre.set_initial_time(
+          manœuvre.initial_time() + parameters.timing_error * timing_error);
+      if (parameters.relative_Δv_error == 0) {
+        perturbed_manœuvre.set_duration(manœuvre.duration());
+      } else {
+        perturbed_manœuvre.set_Δv(
+            manœuvre.Δv() * (1 + parameters.relative_Δv_error * Δv_error));
+      }
+      if (perturbed_manœuvre.IsSingular() ||
+          !perturbed_manœuvre.FitsBetween(end_of_previous_manœuvre,
+                                          desired_final_time_)) {
+        perturbed_flight_plan.is_valid = false;
+      } else {
+        mass = perturbed_manœuvre.final_mass();
+        end_of_previous_manœuvre = perturbed_manœuvre.final_time();
+      }
+      perturbed_flight_plan.manœuvres.push_back(std::move(perturbed_manœuvre));
+    }
+    perturbed_flight_plans.push_back(std::move(perturbed_flight_plan));
+  }
+
+  std::vector<Future<void>> futures;
+  futures.reserve(perturbed_flight_plans.size());
+  for (auto& perturbed_flight_plan : perturbed_flight_plans) {
+    if (perturbed_flight_plan.is_valid) {
+      futures.push_back(
+          scheduler->Add([this, centre, &perturbed_flight_plan]() {
+            perturbed_flight_plan.sample = IntegrateDispersionSample(
+                perturbed_flight_plan.initial_degrees_of_freedom,
+                perturbed_flight_plan.manœuvres,
+                centre);
+          }));
+    }
+  }
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  Dispersion dispersion;
+  for (auto& perturbed_flight_plan : perturbed_flight_plans) {
+    if (perturbed_flight_plan.sample.has_value()) {
+      dispersion.samples.push_back(*perturbed_flight_plan.sample);
+    } else {
+      ++dispersion.anomalous_samples;
+    }
+  }
+  if (dispersion.samples.empty()) {
+    return dispersion;
+  }
+  double const n = dispersion.samples.size();
+  Length Σ_distance;
+  Displacement<Barycentric> Σ_position;
+  for (auto const& sample : dispersion.samples) {
+    Σ_distance += sample.closest_approach_distance;
+    Σ_position +=
+        sample.final_degrees_of_freedom.position() - Barycentric::origin;
+  }
+  dispersion.mean_closest_approach_distance = Σ_distance / n;
+  dispersion.mean_final_position = Barycentric::origin + Σ_position / n;
+  Square<Length> Σ_distance_deviation²;
+  Square<Length> Σ_position_deviation²;
+  for (auto const& sample : dispersion.samples) {
+    Σ_distance_deviation² += Pow<2>(sample.closest_approach_distance -
+                                    dispersion.mean_closest_approach_distance);
+    Σ_position_deviation² += (sample.final_degrees_of_freedom.position() -
+                              dispersion.mean_final_position).Norm²();
+  }
+  dispersion.closest_approach_distance_standard_deviation =
+      Sqrt(Σ_distance_deviation² / n);
+  dispersion.final_position_dispersion = Sqrt(Σ_position_deviation² / n);
+  return dispersion;
+}
+
 bool FlightPlan::SetDesiredFinalTime(Instant const& desired_final_time) {
   if (start_of_last_coast() > desired_final_time) {
     return false;
@@ -191,6 +411,14 @@ int FlightPlan::number_of_segments() const {
   return segments_.size();
 }
 
+std::int64_t FlightPlan::number_of_points() const {
+  return root_->subtree_size();
+}
+
+std::int64_t FlightPlan::memory_footprint() const {
+  return sizeof(*this) + root_->subtree_memory_footprint();
+}
+
 void FlightPlan::GetSegment(
     int const index,
     DiscreteTrajectory<Barycentric>::Iterator& begin,
@@ -209,6 +437,33 @@ void FlightPlan::GetAllSegments(
   CHECK(begin != end);
 }
 
+TrajectorySplineIndex<Navigation> const& FlightPlan::GetSegmentSplineIndex(
+    int const index,
+    not_null<MassiveBody const*> const centre) const {
+  CHECK_LE(0, index);
+  CHECK_LT(index, number_of_segments());
+  std::pair<int, MassiveBody const*> const key(index, centre);
+  auto it = segment_spline_indices_.find(key);
+  if (it == segment_spline_indices_.end()) {
+    BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation> const
+        body_centred_inertial(ephemeris_, centre);
+    DiscreteTrajectory<Navigation> segment;
+    for (auto segment_it = segments_[index]->Fork();
+         segment_it != segments_[index]->End();
+         ++segment_it) {
+      segment.Append(segment_it.time(),
+                     body_centred_inertial.ToThisFrameAtTime(segment_it.time())(
+                         segment_it.degrees_of_freedom()));
+    }
+    it = segment_spline_indices_
+             .emplace(key,
+                      TrajectorySplineIndex<Navigation>(segment.Begin(),
+                                                        segment.End()))
+             .first;
+  }
+  return it->second;
+}
+
 void FlightPlan::WriteToMessage(
     not_null<serialization::FlightPlan*> const message) const {
   initial_mass_.WriteToMessage(message->mutable_initial_mass());
@@ -223,6 +478,16 @@ void FlightPlan::WriteToMessage(
   }
 }
 
+void FlightPlan::WriteSegmentsToMessage(
+    not_null<serialization::FlightPlan*> const message) const {
+  std::vector<DiscreteTrajectory<Barycentric>*> const forks(segments_.begin(),
+                                                            segments_.end());
+  root_->WriteToMessage(message->mutable_segments(), forks);
+  DiscreteTrajectory<Barycentric>::PackTimelines(message->mutable_segments());
+  message->set_anomalous_segments(anomalous_segments_);
+  message->set_ephemeris_fingerprint(ephemeris_->Fingerprint());
+}
+
 std::unique_ptr<FlightPlan> FlightPlan::ReadFromMessage(
     serialization::FlightPlan const& message,
     not_null<Ephemeris<Barycentric>*> const ephemeris) {
@@ -240,6 +505,64 @@ std::unique_ptr<FlightPlan> FlightPlan::ReadFromMessage(
           DegreesOfFreedom<Barycentric>::ReadFromMessage(
               message.initial_degrees_of_freedom()));
 
+  std::vector<NavigationManœuvre> manœuvres;
+  for (int i = 0; i < message.manoeuvre_size(); ++i) {
+    auto const& manoeuvre = message.manoeuvre(i);
+    manœuvres.push_back(
+        NavigationManœuvre::ReadFromMessage(manoeuvre, ephemeris));
+  }
+
+  if (message.has_segments() &&
+      message.ephemeris_fingerprint() == ephemeris->Fingerprint()) {
+    std::vector<DiscreteTrajectory<Barycentric>*> segments(
+        2 * manœuvres.size() + 1, nullptr);
+    std::vector<DiscreteTrajectory<Barycentric>**> forks;
+    for (auto& segment : segments) {
+      forks.push_back(&segment);
+    }
+    auto root = DiscreteTrajectory<Barycentric>::ReadFromMessage(
+        message.segments(), forks);
+
+    // The checks are cheap compared to an integration: the root must be the
+    // initial state, and each burn that is not anomalous must start at its
+    // manœuvre.
+    int const anomalous_segments = message.anomalous_segments();
+    bool persisted_segments_are_valid =
+        anomalous_segments >= 0 && anomalous_segments <= 2 &&
+        root->Size() == 1 &&
+        root->Begin().time() == initial_time &&
+        root->Begin().degrees_of_freedom() == *initial_degrees_of_freedom &&
+        std::all_of(segments.begin(),
+                    segments.end(),
+                    [](DiscreteTrajectory<Barycentric> const* const segment) {
+                      return segment != nullptr;
+                    });
+    for (int i = 0; persisted_segments_are_valid && i < manœuvres.size();
+         ++i) {
+      int const burn = 2 * i + 1;
+      if (burn < segments.size() - anomalous_segments &&
+          segments[burn]->Fork().time() != manœuvres[i].initial_time()) {
+        persisted_segments_are_valid = false;
+      }
+    }
+
+    if (persisted_segments_are_valid) {
+      return std::unique_ptr<FlightPlan>(new FlightPlan(
+          Mass::ReadFromMessage(message.initial_mass()),
+          initial_time,
+          *initial_degrees_of_freedom,
+          Instant::ReadFromMessage(message.desired_final_time()),
+          ephemeris,
+          *adaptive_step_parameters,
+          std::move(root),
+          std::vector<not_null<DiscreteTrajectory<Barycentric>*>>(
+              segments.begin(), segments.end()),
+          std::move(manœuvres),
+          anomalous_segments));
+    }
+    LOG(WARNING) << "Recomputing the persisted segments of a flight plan";
+  }
+
   auto flight_plan = std::make_unique<FlightPlan>(
       Mass::ReadFromMessage(message.initial_mass()),
       initial_time,
@@ -247,12 +570,7 @@ std::unique_ptr<FlightPlan> FlightPlan::ReadFromMessage(
       Instant::ReadFromMessage(message.desired_final_time()),
       ephemeris,
       *adaptive_step_parameters);
-
-  for (int i = 0; i < message.manoeuvre_size(); ++i) {
-    auto const& manoeuvre = message.manoeuvre(i);
-    flight_plan->manœuvres_.push_back(
-        NavigationManœuvre::ReadFromMessage(manoeuvre, ephemeris));
-  }
+  flight_plan->manœuvres_ = std::move(manœuvres);
   // We need to forcefully prolong, otherwise we might exceed the ephemeris
   // step limit while recomputing the segments and fail the check.
   flight_plan->ephemeris_->Prolong(flight_plan->desired_final_time_);
@@ -273,6 +591,35 @@ FlightPlan::FlightPlan()
           /*length_integration_tolerance=*/1 * Metre,
           /*speed_integration_tolerance=*/1 * Metre / Second) {}
 
+FlightPlan::FlightPlan(
+    Mass const& initial_mass,
+    Instant const& initial_time,
+    DegreesOfFreedom<Barycentric> const& initial_degrees_of_freedom,
+    Instant const& desired_final_time,
+    not_null<Ephemeris<Barycentric>*> const ephemeris,
+    Ephemeris<Barycentric>::AdaptiveStepParameters const&
+        adaptive_step_parameters,
+    not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> root,
+    std::vector<not_null<DiscreteTrajectory<Barycentric>*>> segments,
+    std::vector<NavigationManœuvre> manœuvres,
+    int const anomalous_segments)
+    : initial_mass_(initial_mass),
+      initial_time_(initial_time),
+      initial_degrees_of_freedom_(initial_degrees_of_freedom),
+      desired_final_time_(desired_final_time),
+      root_(std::move(root)),
+      segments_(std::move(segments)),
+      manœuvres_(std::move(manœuvres)),
+      ephemeris_(ephemeris),
+      adaptive_step_parameters_(adaptive_step_parameters),
+      anomalous_segments_(anomalous_segments) {
+  CHECK(desired_final_time_ >= initial_time_);
+  CHECK_EQ(2 * manœuvres_.size() + 1, segments_.size());
+  for (int i = 0; i < manœuvres_.size(); ++i) {
+    manœuvres_[i].set_coasting_trajectory(segments_[2 * i]);
+  }
+}
+
 void FlightPlan::Append(NavigationManœuvre manœuvre) {
   manœuvres_.emplace_back(std::move(manœuvre));
   {
@@ -306,76 +653,161 @@ bool FlightPlan::RecomputeSegments() {
 }
 
 void FlightPlan::BurnLastSegment(NavigationManœuvre const& manœuvre) {
+  ForgetSegmentSplineIndices(segments_.size() - 1);
+  if (anomalous_segments_ > 0) {
+    return;
+  } else if (!BurnSegment(manœuvre, segments_.back())) {
+    anomalous_segments_ = 1;
+  }
+}
+
+void FlightPlan::CoastLastSegment(Instant const& desired_final_time) {
+  ForgetSegmentSplineIndices(segments_.size() - 1);
   if (anomalous_segments_ > 0) {
     return;
-  } else if (manœuvre.initial_time() < manœuvre.final_time()) {
+  } else if (!CoastSegment(desired_final_time, segments_.back())) {
+    anomalous_segments_ = 1;
+  }
+}
+
+bool FlightPlan::BurnSegment(
+    NavigationManœuvre const& manœuvre,
+    not_null<DiscreteTrajectory<Barycentric>*> const segment) const {
+  if (manœuvre.initial_time() < manœuvre.final_time()) {
     if (manœuvre.is_inertially_fixed()) {
-      bool const reached_desired_final_time =
-          ephemeris_->FlowWithAdaptiveStep(segments_.back(),
-                                           manœuvre.IntrinsicAcceleration(),
-                                           manœuvre.final_time(),
-                                           adaptive_step_parameters_,
-                                           max_ephemeris_steps_per_frame,
-                                           /*last_point_only=*/false).ok();
-      if (!reached_desired_final_time) {
-        anomalous_segments_ = 1;
-      }
+      return ephemeris_->FlowWithAdaptiveStep(segment,
+                                              manœuvre.IntrinsicAcceleration(),
+                                              manœuvre.final_time(),
+                                              adaptive_step_parameters_,
+                                              max_ephemeris_steps_per_frame,
+                                              /*last_point_only=*/false).ok();
     } else {
       // We decompose the manœuvre in smaller unguided manœuvres (movements),
-      // which are unguided.
+      // which are unguided.  The direction of each movement is computed once,
+      // at its beginning, using the frame of |manœuvre|.
       // TODO(egg): eventually we should just compute the direction in the
       // right-hand-side of the integrator, but for that we need the velocity,
       // which means we need general Runge-Kutta integrators.
       constexpr int movements = 100;
-      Mass remaining_mass = manœuvre.initial_mass();
-      serialization::DynamicFrame serialized_manœuvre_frame;
-      manœuvre.frame()->WriteToMessage(&serialized_manœuvre_frame);
+      Time const movement_duration = manœuvre.duration() / movements;
       for (int i = 0; i < movements; ++i) {
-        NavigationManœuvre movement(manœuvre.thrust(),
-                                    remaining_mass,
-                                    manœuvre.specific_impulse(),
-                                    manœuvre.direction(),
-                                    NavigationFrame::ReadFromMessage(
-                                        serialized_manœuvre_frame, ephemeris_),
-                                    /*is_inertially_fixed=*/true);
-        movement.set_duration(manœuvre.duration() / movements);
-        movement.set_initial_time(segments_.back()->last().time());
-        movement.set_coasting_trajectory(segments_.back());
-        remaining_mass = movement.final_mass();
+        auto const movement_initial = segment->last();
         bool const reached_desired_final_time =
-            ephemeris_->FlowWithAdaptiveStep(segments_.back(),
-                                             movement.IntrinsicAcceleration(),
-                                             movement.final_time(),
-                                             adaptive_step_parameters_,
-                                             max_ephemeris_steps_per_frame,
-                                             /*last_point_only=*/false).ok();
+            ephemeris_->FlowWithAdaptiveStep(
+                segment,
+                manœuvre.IntrinsicAccelerationFixedAt(
+                    movement_initial.time(),
+                    movement_initial.degrees_of_freedom()),
+                movement_initial.time() + movement_duration,
+                adaptive_step_parameters_,
+                max_ephemeris_steps_per_frame,
+                /*last_point_only=*/false).ok();
         if (!reached_desired_final_time) {
-          anomalous_segments_ = 1;
-          return;
+          return false;
         }
       }
     }
   }
+  return true;
 }
 
-void FlightPlan::CoastLastSegment(Instant const& desired_final_time) {
-  if (anomalous_segments_ > 0) {
-    return;
-  } else {
-    bool const reached_desired_final_time =
-        ephemeris_->FlowWithAdaptiveStep(
-                        segments_.back(),
-                        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-                        desired_final_time,
-                        adaptive_step_parameters_,
-                        max_ephemeris_steps_per_frame,
-                        /*last_point_only=*/false).ok();
-    if (!reached_desired_final_time) {
-      anomalous_segments_ = 1;
+bool FlightPlan::CoastSegment(
+    Instant const& desired_final_time,
+    not_null<DiscreteTrajectory<Barycentric>*> const segment) const {
+  return ephemeris_->FlowWithAdaptiveStep(
+                         segment,
+                         Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+                         desired_final_time,
+                         adaptive_step_parameters_,
+                         max_ephemeris_steps_per_frame,
+                         /*last_point_only=*/false).ok();
+}
+
+void FlightPlan::IntegrateAlternative(Alternative& alternative) const {
+  auto& segments = alternative.segments;
+  int& anomalous_segments = alternative.anomalous_segments;
+  // Same as |AddSegment|, for the segments of |alternative|.
+  auto const add_segment = [&anomalous_segments, &segments]() {
+    segments.emplace_back(segments.back()->NewForkAtLast());
+    if (anomalous_segments > 0) {
+      ++anomalous_segments;
     }
+  };
+
+  segments.emplace_back(
+      alternative.root->NewForkWithoutCopy(alternative.root->Begin().time()));
+  if (!CoastSegment(alternative.manœuvre.initial_time(), segments.back())) {
+    anomalous_segments = 1;
+  }
+  alternative.manœuvre.set_coasting_trajectory(segments.back());
+  add_segment();
+  if (anomalous_segments == 0 &&
+      !BurnSegment(alternative.manœuvre, segments.back())) {
+    anomalous_segments = 1;
+  }
+  add_segment();
+  if (anomalous_segments == 0 &&
+      !CoastSegment(desired_final_time_, segments.back())) {
+    anomalous_segments = 1;
   }
 }
 
+std::optional<FlightPlan::Dispersion::Sample>
+FlightPlan::IntegrateDispersionSample(
+    DegreesOfFreedom<Barycentric> const& initial_degrees_of_freedom,
+    std::vector<NavigationManœuvre>& manœuvres,
+    not_null<MassiveBody const*> const centre) const {
+  // Same as the constructor and |Append|, without the bookkeeping.
+  DiscreteTrajectory<Barycentric> root;
+  root.Append(initial_time_, initial_degrees_of_freedom);
+  not_null<DiscreteTrajectory<Barycentric>*> segment =
+      root.NewForkWithoutCopy(initial_time_);
+  for (auto& manœuvre : manœuvres) {
+    if (!CoastSegment(manœuvre.initial_time(), segment)) {
+      return std::nullopt;
+    }
+    manœuvre.set_coasting_trajectory(segment);
+    segment = segment->NewForkAtLast();
+    if (!BurnSegment(manœuvre, segment)) {
+      return std::nullopt;
+    }
+    segment = segment->NewForkAtLast();
+  }
+  if (!CoastSegment(desired_final_time_, segment)) {
+    return std::nullopt;
+  }
+
+  auto const& centre_trajectory = *ephemeris_->trajectory(centre);
+  DiscreteTrajectory<Barycentric> apoapsides;
+  DiscreteTrajectory<Barycentric> periapsides;
+  ComputeApsides(centre_trajectory,
+                 segment->Fork(),
+                 segment->End(),
+                 apoapsides,
+                 periapsides);
+  Dispersion::Sample sample{segment->last().time(),
+                            segment->last().degrees_of_freedom(),
+                            segment->last().time(),
+                            std::numeric_limits<double>::infinity() * Metre};
+  auto const consider = [&centre_trajectory, &sample](
+                            Instant const& time,
+                            DegreesOfFreedom<Barycentric> const&
+                                degrees_of_freedom) {
+    Length const distance = (degrees_of_freedom.position() -
+                             centre_trajectory.EvaluatePosition(time)).Norm();
+    if (distance < sample.closest_approach_distance) {
+      sample.closest_approach_time = time;
+      sample.closest_approach_distance = distance;
+    }
+  };
+  consider(segment->Fork().time(), segment->Fork().degrees_of_freedom());
+  consider(segment->last().time(), segment->last().degrees_of_freedom());
+  for (auto it = periapsides.Begin(); it != periapsides.End(); ++it) {
+    consider(it.time(), it.degrees_of_freedom());
+  }
+  return sample;
+}
+
 void FlightPlan::ReplaceLastSegment(
     not_null<DiscreteTrajectory<Barycentric>*> const segment) {
   CHECK_EQ(segment->parent(), segments_.back()->parent());
@@ -395,6 +827,7 @@ void FlightPlan::AddSegment() {
 }
 
 void FlightPlan::ResetLastSegment() {
+  ForgetSegmentSplineIndices(segments_.size() - 1);
   segments_.back()->ForgetAfter(segments_.back()->Fork().time());
   if (anomalous_segments_ == 1) {
     // If there was one anomalous segment, it was the last one, which was
@@ -404,6 +837,7 @@ void FlightPlan::ResetLastSegment() {
 }
 
 void FlightPlan::PopLastSegment() {
+  ForgetSegmentSplineIndices(segments_.size() - 1);
   DiscreteTrajectory<Barycentric>* trajectory = segments_.back();
   CHECK(!trajectory->is_root());
   trajectory->parent()->DeleteFork(trajectory);
@@ -413,6 +847,17 @@ void FlightPlan::PopLastSegment() {
   }
 }
 
+void FlightPlan::ForgetSegmentSplineIndices(int const first_segment) {
+  for (auto it = segment_spline_indices_.begin();
+       it != segment_spline_indices_.end();) {
+    if (it->first.first >= first_segment) {
+      it = segment_spline_indices_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 DiscreteTrajectory<Barycentric>* FlightPlan::CoastIfReachesManœuvreInitialTime(
     DiscreteTrajectory<Barycentric>& coast,
     NavigationManœuvre const& manœuvre) {
@@ -1,9 +1,15 @@
 ﻿
 #pragma once
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "base/not_null.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "geometry/named_quantities.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "ksp_plugin/burn.hpp"
@@ -12,6 +18,8 @@
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
+#include "physics/massive_body.hpp"
+#include "physics/trajectory_spline_index.hpp"
 #include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
 #include "serialization/ksp_plugin.pb.h"
@@ -21,19 +29,85 @@ namespace ksp_plugin {
 namespace internal_flight_plan {
 
 using base::not_null;
+using base::WorkStealingScheduler;
 using geometry::Instant;
+using geometry::Position;
 using integrators::AdaptiveStepSizeIntegrator;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
+using physics::MassiveBody;
+using physics::TrajectorySplineIndex;
+using quantities::Angle;
 using quantities::Length;
 using quantities::Mass;
 using quantities::Speed;
+using quantities::Time;
 
 // A stack of |Burn|s that manages a chain of trajectories obtained by executing
 // the corresponding |NavigationManœuvre|s.
 class FlightPlan {
  public:
+  // An alternative to the last manœuvre of a flight plan, with its own
+  // trajectories; see |IntegrateAlternativesToLast|.
+  struct Alternative {
+    NavigationManœuvre manœuvre;
+    // Contains a single point, not part of |segments|.  Owns all the
+    // |segments|.
+    not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> root;
+    // The coast until |manœuvre|, the burn, and the final coast, each a fork of
+    // the previous one.  If |manœuvre| starts at the same time as the last
+    // manœuvre of the flight plan, the penultimate coast is reused: |root| is
+    // at the beginning of |manœuvre| and the first coast has no points of its
+    // own.  The final state is the last point of the last segment.
+    std::vector<not_null<DiscreteTrajectory<Barycentric>*>> segments;
+    // The last |anomalous_segments| of |segments| are anomalous, with the same
+    // meaning as for the flight plan.
+    int anomalous_segments = 0;
+  };
+
+  // The uncertainties used by |ComputeDispersion|.  The errors are independent
+  // and normally distributed with the given standard deviations.
+  struct DispersionParameters final {
+    int samples = 0;
+    // The relative error on the Δv of each manœuvre.
+    double relative_Δv_error = 0;
+    // The error on the direction of each manœuvre, about each of the two axes
+    // orthogonal to its planned direction.
+    Angle pointing_error;
+    // The error on the initial time of each manœuvre.
+    Time timing_error;
+    // The errors on each coordinate of the initial position and velocity.
+    Length position_error;
+    Speed velocity_error;
+    // The seed of the pseudo-random generator.  The results only depend on the
+    // seed, not on the scheduling.
+    std::uint64_t seed = 0;
+  };
+
+  // The result of |ComputeDispersion|.
+  struct Dispersion final {
+    struct Sample final {
+      Instant final_time;
+      DegreesOfFreedom<Barycentric> final_degrees_of_freedom;
+      // The point of the last coast nearest to the centre, either a periapsis
+      // or an end of the coast.
+      Instant closest_approach_time;
+      Length closest_approach_distance;
+    };
+    // The samples whose manœuvres could be executed and whose integration
+    // reached the desired final time, in the order in which they were drawn.
+    std::vector<Sample> samples;
+    // The number of the other samples.
+    int anomalous_samples = 0;
+    // The statistics of the |samples|.  The dispersion of the final positions
+    // is the root mean square of their distances to their mean.
+    Length mean_closest_approach_distance;
+    Length closest_approach_distance_standard_deviation;
+    Position<Barycentric> mean_final_position;
+    Length final_position_dispersion;
+  };
+
   // Creates a |FlightPlan| with no burns starting at |initial_time| with
   // |initial_degrees_of_freedom| and with the given |initial_mass|.  The
   // trajectories are computed using the given |integrator| in the given
@@ -71,9 +145,33 @@ class FlightPlan {
 
   // |size()| must be greater than 0.
   virtual void RemoveLast();
-  // |size()| must be greater than 0.
+  // |size()| must be greater than 0.  If |burn| starts at the same time as the
+  // last burn, the earlier segments are not recomputed.
   virtual bool ReplaceLast(Burn burn);
 
+  // |size()| must be greater than 0.  Integrates the trajectories that would
+  // result from each of the |burns| replacing the last burn, concurrently on
+  // the |scheduler|; this object is not modified.  An element of the result is
+  // null if the corresponding burn could not replace the last one for the
+  // reasons listed for |Append|, excluding the integration failures, which are
+  // reported as anomalous segments.  Must not be called on a worker thread of
+  // the |scheduler|.
+  virtual std::vector<std::optional<Alternative>> IntegrateAlternativesToLast(
+      std::vector<Burn> burns,
+      not_null<WorkStealingScheduler*> scheduler) const;
+
+  // Integrates |parameters.samples| perturbations of this flight plan,
+  // concurrently on the |scheduler|, and returns the spread of their final
+  // states and of their closest approaches to |centre| during the last coast.
+  // Each sample has its initial state and its manœuvres perturbed as specified
+  // by |parameters|; the masses are propagated through the perturbed
+  // manœuvres.  This object is not modified.  Must not be called on a worker
+  // thread of the |scheduler|.
+  virtual Dispersion ComputeDispersion(
+      DispersionParameters const& parameters,
+      not_null<MassiveBody const*> centre,
+      not_null<WorkStealingScheduler*> scheduler) const;
+
   // Returns false and has no effect if |desired_final_time| is before the end
   // of the last manœuvre or before |initial_time_|.
   virtual bool SetDesiredFinalTime(Instant const& desired_final_time);
@@ -100,10 +198,33 @@ class FlightPlan {
       DiscreteTrajectory<Barycentric>::Iterator& begin,
       DiscreteTrajectory<Barycentric>::Iterator& end) const;
 
+  // |index| must be in [0, number_of_segments()[.  Returns an index of the
+  // given trajectory segment expressed in the non-rotating frame centred on
+  // |centre|, for finding the points of the segment nearest to a position.  The
+  // index is built on the first call and kept until the segment changes.
+  virtual TrajectorySplineIndex<Navigation> const& GetSegmentSplineIndex(
+      int index,
+      not_null<MassiveBody const*> centre) const;
+
+  // The number of points of the segments, and the number of bytes allocated
+  // for them.  Only useful for analyzing memory usage.
+  virtual std::int64_t number_of_points() const;
+  virtual std::int64_t memory_footprint() const;
+
   void WriteToMessage(not_null<serialization::FlightPlan*> message) const;
 
+  // Adds the segments of this object to a |message| produced by
+  // |WriteToMessage|, in the compact trajectory encoding, together with the
+  // fingerprint of the ephemeris.  This makes the |message| much larger, but
+  // spares |ReadFromMessage| the recomputation of the segments.
+  void WriteSegmentsToMessage(
+      not_null<serialization::FlightPlan*> message) const;
+
   // This may return a null pointer if the flight plan contained in the
-  // |message| is anomalous.
+  // |message| is anomalous.  The segments persisted by
+  // |WriteSegmentsToMessage| are reused if they were computed with the same
+  // |ephemeris| and are consistent with the manœuvres; otherwise they are
+  // recomputed.
   static std::unique_ptr<FlightPlan> ReadFromMessage(
       serialization::FlightPlan const& message,
       not_null<Ephemeris<Barycentric>*> ephemeris);
@@ -115,6 +236,20 @@ class FlightPlan {
   FlightPlan();
 
  private:
+  // For deserialization: adopts the |root|, its |segments| and the
+  // |manœuvres| without integrating anything.
+  FlightPlan(Mass const& initial_mass,
+             Instant const& initial_time,
+             DegreesOfFreedom<Barycentric> const& initial_degrees_of_freedom,
+             Instant const& desired_final_time,
+             not_null<Ephemeris<Barycentric>*> ephemeris,
+             Ephemeris<Barycentric>::AdaptiveStepParameters const&
+                 adaptive_step_parameters,
+             not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> root,
+             std::vector<not_null<DiscreteTrajectory<Barycentric>*>> segments,
+             std::vector<NavigationManœuvre> manœuvres,
+             int anomalous_segments);
+
   // Appends |manœuvre| to |manœuvres_|, adds a burn and a coast segment.
   // |manœuvre| must fit between |start_of_last_coast()| and
   // |desired_final_time_|, the last coast segment must end at
@@ -132,6 +267,26 @@ class FlightPlan {
   // acceleration.
   void CoastLastSegment(Instant const& desired_final_time);
 
+  // The implementations of the above functions, operating on an arbitrary
+  // |segment|.  Return false if the integration didn't reach its end.  These
+  // functions don't modify this object and may be called concurrently.
+  bool BurnSegment(NavigationManœuvre const& manœuvre,
+                   not_null<DiscreteTrajectory<Barycentric>*> segment) const;
+  bool CoastSegment(Instant const& desired_final_time,
+                    not_null<DiscreteTrajectory<Barycentric>*> segment) const;
+
+  // Computes the |segments| of |alternative|, whose |root| must have been set.
+  void IntegrateAlternative(Alternative& alternative) const;
+
+  // Integrates a flight plan starting at |initial_time_| with
+  // |initial_degrees_of_freedom| and executing the |manœuvres|, which must fit
+  // between |initial_time_| and |desired_final_time_| and not overlap.  Returns
+  // null if an integration failed.  The trajectories are not kept.
+  std::optional<Dispersion::Sample> IntegrateDispersionSample(
+      DegreesOfFreedom<Barycentric> const& initial_degrees_of_freedom,
+      std::vector<NavigationManœuvre>& manœuvres,
+      not_null<MassiveBody const*> centre) const;
+
   // Replaces the last segment with |segment|.  |segment| must be forked from
   // the same trajectory as the last segment, and at the same time.  |segment|
   // must not be anomalous.
@@ -145,6 +300,10 @@ class FlightPlan {
   // Deletes the last segment and removes it from |segments_|.
   void PopLastSegment();
 
+  // Removes from |segment_spline_indices_| the indices of the segments
+  // starting at |first_segment|, which are about to change.
+  void ForgetSegmentSplineIndices(int first_segment);
+
   // If the integration of a coast from the fork of |coast| until
   // |manœuvre.initial_time()| reaches the end, returns the integrated
   // trajectory.  Otherwise, returns null.
@@ -179,6 +338,9 @@ class FlightPlan {
   // |anomalous_segments_| is at most 2: the penultimate coast is never
   // anomalous.
   int anomalous_segments_ = 0;
+  // The indices built by |GetSegmentSplineIndex|, keyed by segment and centre.
+  mutable std::map<std::pair<int, MassiveBody const*>,
+                   TrajectorySplineIndex<Navigation>> segment_spline_indices_;
 };
 
 }  // namespace internal_flight_plan
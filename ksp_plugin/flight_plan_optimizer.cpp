@@ -0,0 +1,159 @@
+﻿
+#include "ksp_plugin/flight_plan_optimizer.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "geometry/grassmann.hpp"
+#include "physics/apsides.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/physics.pb.h"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_flight_plan_optimizer {
+
+using base::Error;
+using geometry::Vector;
+using physics::ComputeApsides;
+using physics::DiscreteTrajectory;
+using quantities::Abs;
+using quantities::Speed;
+using quantities::Time;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Second;
+
+// The increment of the Δv used to compute the derivatives, relative to the
+// norm of the Δv, and its minimum.
+constexpr double relative_increment = 1e-4;
+constexpr Speed minimal_increment = 1 * Milli(Metre) / Second;
+
+FlightPlanOptimizer::FlightPlanOptimizer(
+    not_null<FlightPlan*> const flight_plan,
+    not_null<Ephemeris<Barycentric>*> const ephemeris,
+    not_null<WorkStealingScheduler*> const scheduler)
+    : flight_plan_(flight_plan),
+      ephemeris_(ephemeris),
+      scheduler_(scheduler) {}
+
+Status FlightPlanOptimizer::Optimize(Residual const& residual,
+                                     Length const& tolerance,
+                                     int const max_iterations) {
+  CHECK_LT(0, flight_plan_->number_of_manœuvres());
+  // The flight plan is only modified before returning, so this reference
+  // remains valid during the iteration.
+  NavigationManœuvre const& manœuvre = flight_plan_->GetManœuvre(
+      flight_plan_->number_of_manœuvres() - 1);
+  std::vector<Vector<double, Frenet<Navigation>>> const basis{
+      Vector<double, Frenet<Navigation>>({1, 0, 0}),
+      Vector<double, Frenet<Navigation>>({0, 1, 0}),
+      Vector<double, Frenet<Navigation>>({0, 0, 1})};
+
+  Velocity<Frenet<Navigation>> Δv = manœuvre.Δv() * manœuvre.direction();
+  for (int iteration = 0; iteration < max_iterations; ++iteration) {
+    // The first burn is the current estimate, the others are used for the
+    // derivatives.
+    Speed const increment =
+        std::max(relative_increment * Δv.Norm(), minimal_increment);
+    std::vector<Burn> burns;
+    burns.push_back(MakeBurn(manœuvre, Δv));
+    for (auto const& direction : basis) {
+      burns.push_back(MakeBurn(manœuvre, Δv + increment * direction));
+    }
+    auto const alternatives =
+        flight_plan_->IntegrateAlternativesToLast(std::move(burns), scheduler_);
+
+    std::vector<Length> residuals;
+    for (auto const& alternative : alternatives) {
+      std::optional<Length> const r =
+          alternative.has_value() ? residual(*alternative) : std::nullopt;
+      if (!r.has_value()) {
+        return Status(Error::OUT_OF_RANGE,
+                      "Residual undefined near Δv " + DebugString(Δv));
+      }
+      residuals.push_back(*r);
+    }
+
+    if (Abs(residuals[0]) <= tolerance) {
+      if (flight_plan_->ReplaceLast(MakeBurn(manœuvre, Δv))) {
+        return Status::OK;
+      } else {
+        return Status(Error::FAILED_PRECONDITION,
+                      "Cannot replace the last manœuvre with Δv " +
+                          DebugString(Δv));
+      }
+    }
+
+    Vector<Time, Frenet<Navigation>> const gradient(
+        {(residuals[1] - residuals[0]) / increment,
+         (residuals[2] - residuals[0]) / increment,
+         (residuals[3] - residuals[0]) / increment});
+    if (gradient == Vector<Time, Frenet<Navigation>>()) {
+      return Status(Error::OUT_OF_RANGE,
+                    "Residual independent of Δv near " + DebugString(Δv));
+    }
+    // There is one equation for three unknowns, so we take the Newton step of
+    // minimal norm, which is along the gradient.
+    Δv -= residuals[0] * gradient / gradient.Norm²();
+  }
+  return Status(Error::ABORTED,
+                "No convergence after " + std::to_string(max_iterations) +
+                    " iterations");
+}
+
+FlightPlanOptimizer::Residual FlightPlanOptimizer::DistanceOfClosestApproach(
+    Trajectory<Barycentric> const& reference,
+    Length const& distance) {
+  return [&reference, distance](
+             FlightPlan::Alternative const& alternative)
+             -> std::optional<Length> {
+    if (alternative.anomalous_segments > 0) {
+      return std::nullopt;
+    }
+    DiscreteTrajectory<Barycentric> const& final_coast =
+        *alternative.segments.back();
+    DiscreteTrajectory<Barycentric> apoapsides;
+    DiscreteTrajectory<Barycentric> periapsides;
+    ComputeApsides(reference,
+                   final_coast.Fork(),
+                   final_coast.End(),
+                   apoapsides,
+                   periapsides);
+    std::optional<Length> closest_approach;
+    for (auto it = periapsides.Begin(); it != periapsides.End(); ++it) {
+      Length const approach =
+          (it.degrees_of_freedom().position() -
+           reference.EvaluatePosition(it.time())).Norm();
+      if (!closest_approach.has_value() || approach < *closest_approach) {
+        closest_approach = approach;
+      }
+    }
+    if (!closest_approach.has_value()) {
+      return std::nullopt;
+    }
+    return *closest_approach - distance;
+  };
+}
+
+Burn FlightPlanOptimizer::MakeBurn(
+    NavigationManœuvre const& manœuvre,
+    Velocity<Frenet<Navigation>> const& Δv) const {
+  // The frame is not copyable, so we go through its serialized form.
+  serialization::DynamicFrame serialized_frame;
+  manœuvre.frame()->WriteToMessage(&serialized_frame);
+  return {manœuvre.thrust(),
+          manœuvre.specific_impulse(),
+          NavigationFrame::ReadFromMessage(serialized_frame, ephemeris_),
+          manœuvre.initial_time(),
+          Δv,
+          manœuvre.is_inertially_fixed()};
+}
+
+}  // namespace internal_flight_plan_optimizer
+}  // namespace ksp_plugin
+}  // namespace principia
@@ -0,0 +1,86 @@
+﻿
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include "base/not_null.hpp"
+#include "base/status.hpp"
+#include "base/work_stealing_scheduler.hpp"
+#include "geometry/named_quantities.hpp"
+#include "ksp_plugin/burn.hpp"
+#include "ksp_plugin/flight_plan.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/trajectory.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_flight_plan_optimizer {
+
+using base::not_null;
+using base::Status;
+using base::WorkStealingScheduler;
+using geometry::Velocity;
+using physics::Ephemeris;
+using physics::Frenet;
+using physics::Trajectory;
+using quantities::Length;
+
+// Adjusts the Δv of the last manœuvre of a |FlightPlan| to bring a scalar
+// function of the resulting trajectory to zero, using Newton's method.  The
+// derivatives of the function with respect to the Δv are computed by finite
+// differences: the four integrations of each iteration are independent, and
+// are done concurrently by |FlightPlan::IntegrateAlternativesToLast|.
+class FlightPlanOptimizer {
+ public:
+  // A function of the trajectory obtained with an alternative last manœuvre,
+  // whose zero is sought.  Returns null if the function is not defined for
+  // |alternative|.
+  using Residual = std::function<std::optional<Length>(
+      FlightPlan::Alternative const& alternative)>;
+
+  // The |ephemeris| must be the one used by the |flight_plan|.
+  FlightPlanOptimizer(not_null<FlightPlan*> flight_plan,
+                      not_null<Ephemeris<Barycentric>*> ephemeris,
+                      not_null<WorkStealingScheduler*> scheduler);
+
+  // Replaces the last manœuvre of the flight plan with one that has the same
+  // parameters except for its Δv, chosen so that the absolute value of
+  // |residual| is at most |tolerance|.  The flight plan must have at least one
+  // manœuvre.  Returns an error, and leaves the flight plan unchanged, if the
+  // residual is not defined for some of the Δvs that are tried or if the
+  // iteration doesn't converge within |max_iterations|.
+  Status Optimize(Residual const& residual,
+                  Length const& tolerance,
+                  int max_iterations = default_max_iterations);
+
+  // Returns a residual which is the difference between the distance of closest
+  // approach to |reference| after the last manœuvre and |distance|.  The
+  // |reference| may be the trajectory of a celestial, in which case this is the
+  // lowest periapsis, or the prediction of a target vessel.  The residual is
+  // not defined if the final coast is anomalous or has no periapsis.
+  static Residual DistanceOfClosestApproach(
+      Trajectory<Barycentric> const& reference,
+      Length const& distance);
+
+  static constexpr int default_max_iterations = 10;
+
+ private:
+  // Returns a burn with the same parameters as |manœuvre| but with the given
+  // |Δv|.
+  Burn MakeBurn(NavigationManœuvre const& manœuvre,
+                Velocity<Frenet<Navigation>> const& Δv) const;
+
+  not_null<FlightPlan*> const flight_plan_;
+  not_null<Ephemeris<Barycentric>*> const ephemeris_;
+  not_null<WorkStealingScheduler*> const scheduler_;
+};
+
+}  // namespace internal_flight_plan_optimizer
+
+using internal_flight_plan_optimizer::FlightPlanOptimizer;
+
+}  // namespace ksp_plugin
+}  // namespace principia
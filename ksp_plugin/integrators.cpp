@@ -1,9 +1,14 @@
 ﻿
 #include "ksp_plugin/integrators.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
+#include <optional>
+#include <string>
 
 #include "geometry/named_quantities.hpp"
+#include "glog/logging.h"
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 #include "integrators/methods.hpp"
 #include "integrators/symmetric_linear_multistep_integrator.hpp"
@@ -13,6 +18,7 @@ namespace principia {
 namespace ksp_plugin {
 namespace internal_integrators {
 
+using geometry::Instant;
 using geometry::Position;
 using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
 using integrators::SymmetricLinearMultistepIntegrator;
@@ -20,9 +26,19 @@ using integrators::SymplecticRungeKuttaNyströmIntegrator;
 using integrators::methods::BlanesMoan2002SRKN14A;
 using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
 using integrators::methods::Quinlan1999Order8A;
+using integrators::methods::QuinlanTremaine1990Order12;
+using integrators::methods::QuinlanTremaine1990Order14;
+using quantities::Infinity;
 using quantities::si::Minute;
 using quantities::si::Second;
 
+// The number of times at which the positions of the bodies are compared by
+// |SelectEphemerisParameters|.
+constexpr int ephemeris_parameters_probe_samples = 100;
+// The ratio of the smallest step of the candidates to the step of the
+// reference integration.
+constexpr double ephemeris_parameters_reference_step_ratio = 4;
+
 Ephemeris<Barycentric>::FixedStepParameters DefaultEphemerisParameters() {
   return Ephemeris<Barycentric>::FixedStepParameters(
       SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN14A,
@@ -58,6 +74,87 @@ Ephemeris<Barycentric>::AdaptiveStepParameters DefaultPredictionParameters() {
       /*speed_integration_tolerance=*/1 * Metre / Second);
 }
 
+std::vector<Ephemeris<Barycentric>::FixedStepParameters>
+EphemerisParametersCandidates(Time const& max_step) {
+  std::vector<Ephemeris<Barycentric>::FixedStepParameters> candidates;
+  for (int const divisor : {1, 2, 4}) {
+    candidates.emplace_back(
+        SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                           Position<Barycentric>>(),
+        /*step=*/max_step / divisor);
+    candidates.emplace_back(
+        SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN14A,
+                                              Position<Barycentric>>(),
+        /*step=*/max_step / divisor);
+  }
+  return candidates;
+}
+
+Ephemeris<Barycentric>::FixedStepParameters SelectEphemerisParameters(
+    SolarSystem<Barycentric> const& solar_system,
+    std::vector<Ephemeris<Barycentric>::FixedStepParameters> const& candidates,
+    Length const& fitting_tolerance,
+    Time const& probe_duration) {
+  CHECK(!candidates.empty());
+  Instant const t_final = solar_system.epoch() + probe_duration;
+
+  Time min_step = candidates.front().step();
+  for (auto const& candidate : candidates) {
+    min_step = std::min(min_step, candidate.step());
+  }
+  auto const reference = solar_system.MakeEphemeris(
+      fitting_tolerance,
+      Ephemeris<Barycentric>::FixedStepParameters(
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order14,
+                                             Position<Barycentric>>(),
+          /*step=*/min_step / ephemeris_parameters_reference_step_ratio));
+  reference->Prolong(t_final);
+
+  std::optional<int> fastest_accurate;
+  std::chrono::steady_clock::duration fastest_accurate_duration;
+  int most_accurate = 0;
+  Length most_accurate_error = Infinity<Length>;
+  for (int i = 0; i < candidates.size(); ++i) {
+    auto const start = std::chrono::steady_clock::now();
+    auto const ephemeris =
+        solar_system.MakeEphemeris(fitting_tolerance, candidates[i]);
+    ephemeris->Prolong(t_final);
+    auto const duration = std::chrono::steady_clock::now() - start;
+
+    Length error;
+    for (int j = 1; j <= ephemeris_parameters_probe_samples; ++j) {
+      Instant const t = solar_system.epoch() +
+                        probe_duration * j / ephemeris_parameters_probe_samples;
+      for (std::string const& name : solar_system.names()) {
+        error = std::max(
+            error,
+            (solar_system.trajectory(*ephemeris, name).EvaluatePosition(t) -
+             solar_system.trajectory(*reference, name).EvaluatePosition(t))
+                .Norm());
+      }
+    }
+    LOG(INFO) << "Ephemeris candidate " << i << " with step "
+              << candidates[i].step() << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     duration).count()
+              << " ms with an error of " << error;
+
+    if (error < most_accurate_error) {
+      most_accurate = i;
+      most_accurate_error = error;
+    }
+    if (error <= fitting_tolerance &&
+        (!fastest_accurate || duration < fastest_accurate_duration)) {
+      fastest_accurate = i;
+      fastest_accurate_duration = duration;
+    }
+  }
+
+  int const selected = fastest_accurate.value_or(most_accurate);
+  LOG(INFO) << "Selected ephemeris candidate " << selected;
+  return candidates[selected];
+}
+
 }  // namespace internal_integrators
 }  // namespace ksp_plugin
 }  // namespace principia
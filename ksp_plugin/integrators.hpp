@@ -1,7 +1,10 @@
 #pragma once
 
+#include <vector>
+
 #include "ksp_plugin/frames.hpp"
 #include "physics/ephemeris.hpp"
+#include "physics/solar_system.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
 
@@ -10,11 +13,19 @@ namespace ksp_plugin {
 namespace internal_integrators {
 
 using physics::Ephemeris;
+using physics::SolarSystem;
 using quantities::Length;
+using quantities::Time;
+using quantities::si::Day;
 using quantities::si::Metre;
 using quantities::si::Milli;
 
 constexpr Length default_ephemeris_fitting_tolerance = 1 * Milli(Metre);
+// How far ahead of the current time the ephemeris is prolonged in the
+// background.
+constexpr Time default_ephemeris_prolongation_horizon = 1 * Day;
+// The duration of the trial integrations of |SelectEphemerisParameters|.
+constexpr Time ephemeris_parameters_probe_duration = 30 * Day;
 
 // Factories for parameters used to control integration.
 Ephemeris<Barycentric>::FixedStepParameters DefaultEphemerisParameters();
@@ -22,13 +33,35 @@ Ephemeris<Barycentric>::FixedStepParameters DefaultHistoryParameters();
 Ephemeris<Barycentric>::AdaptiveStepParameters DefaultPredictionParameters();
 Ephemeris<Barycentric>::AdaptiveStepParameters DefaultPsychohistoryParameters();
 
+// The parameters among which |SelectEphemerisParameters| chooses when the
+// ephemeris integrator is selected automatically: the Quinlan–Tremaine and
+// Blanes–Moan integrators with steps of at most |max_step|.
+std::vector<Ephemeris<Barycentric>::FixedStepParameters>
+EphemerisParametersCandidates(Time const& max_step);
+
+// Integrates |solar_system| over |probe_duration| with each of the
+// |candidates|, fitting the ephemeris with |fitting_tolerance|, and with a
+// reference integrator of higher order and smaller step.  Returns the fastest
+// candidate on this machine for which the positions of the bodies differ from
+// the reference by at most |fitting_tolerance|, or the most accurate candidate
+// if there is none.
+Ephemeris<Barycentric>::FixedStepParameters SelectEphemerisParameters(
+    SolarSystem<Barycentric> const& solar_system,
+    std::vector<Ephemeris<Barycentric>::FixedStepParameters> const& candidates,
+    Length const& fitting_tolerance,
+    Time const& probe_duration);
+
 }  // namespace internal_integrators
 
 using internal_integrators::default_ephemeris_fitting_tolerance;
+using internal_integrators::default_ephemeris_prolongation_horizon;
 using internal_integrators::DefaultEphemerisParameters;
 using internal_integrators::DefaultHistoryParameters;
 using internal_integrators::DefaultPredictionParameters;
 using internal_integrators::DefaultPsychohistoryParameters;
+using internal_integrators::ephemeris_parameters_probe_duration;
+using internal_integrators::EphemerisParametersCandidates;
+using internal_integrators::SelectEphemerisParameters;
 
 }  // namespace ksp_plugin
 }  // namespace principia
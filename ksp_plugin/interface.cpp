@@ -2,6 +2,7 @@
 #include "ksp_plugin/interface.hpp"
 
 #include <cctype>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <filesystem>
@@ -9,6 +10,7 @@
 #include <limits>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -21,20 +23,26 @@
 
 #include "astronomy/epoch.hpp"
 #include "astronomy/time_scales.hpp"
+#include "base/arena_pool.hpp"
 #include "base/array.hpp"
+#include "base/base32768.hpp"
+#include "base/buffer_pool.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/macros.hpp"
 #include "base/not_null.hpp"
 #include "base/optional_logging.hpp"
 #include "base/pull_serializer.hpp"
 #include "base/push_deserializer.hpp"
+#include "base/thread_configuration.hpp"
 #include "base/version.hpp"
 #include "gipfeli/gipfeli.h"
 #include "google/protobuf/arena.h"
 #include "journal/method.hpp"
 #include "journal/profiles.hpp"
 #include "journal/recorder.hpp"
+#include "journal/tracer.hpp"
 #include "ksp_plugin/identification.hpp"
+#include "ksp_plugin/integrators.hpp"
 #include "ksp_plugin/iterators.hpp"
 #include "ksp_plugin/part.hpp"
 #include "physics/kepler_orbit.hpp"
@@ -49,13 +57,21 @@ namespace interface {
 
 using astronomy::J2000;
 using astronomy::ParseTT;
+using base::ArenaPool;
 using base::Array;
+using base::Base32768Decode;
+using base::Base32768DecodedLength;
+using base::Base32768Encode;
+using base::BufferPool;
 using base::check_not_null;
 using base::HexadecimalDecode;
+using base::HexadecimalDecodedLength;
 using base::HexadecimalEncode;
 using base::make_not_null_unique;
 using base::PullSerializer;
 using base::PushDeserializer;
+using base::SetThreadConfiguration;
+using base::ThreadConfiguration;
 using base::UniqueArray;
 using geometry::Displacement;
 using geometry::RadiusLatitudeLongitude;
@@ -67,8 +83,10 @@ using integrators::ParseAdaptiveStepSizeIntegrator;
 using integrators::ParseFixedStepSizeIntegrator;
 using ksp_plugin::AliceSun;
 using ksp_plugin::Barycentric;
+using ksp_plugin::EphemerisParametersCandidates;
 using ksp_plugin::Part;
 using ksp_plugin::PartId;
+using ksp_plugin::PredictionLevelOfDetail;
 using ksp_plugin::TypedIterator;
 using ksp_plugin::VesselSet;
 using ksp_plugin::World;
@@ -96,7 +114,6 @@ using quantities::si::Radian;
 using quantities::si::Second;
 using quantities::si::Tonne;
 using ::google::protobuf::Arena;
-using ::google::protobuf::ArenaOptions;
 
 namespace {
 
@@ -104,12 +121,24 @@ constexpr char gipfeli[] = "gipfeli";
 constexpr int chunk_size = 64 << 10;
 constexpr int number_of_chunks = 8;
 
-static not_null<Arena*> arena = []() {
-  ArenaOptions options;
-  options.initial_block_size = chunk_size;
-  options.max_block_size = 16 * chunk_size;
-  return new Arena(options);
-}();
+// The arenas holding the messages of the plugin serializations and
+// deserializations, keyed by their serializer or deserializer, so that
+// concurrent operations don't share an arena.
+static not_null<ArenaPool*> arenas =
+    new ArenaPool(/*max_arenas=*/2,
+                  /*min_block_size=*/chunk_size,
+                  /*max_block_size=*/16 * chunk_size);
+
+// The buffers holding the decoded chunks of a plugin deserialization.  They are
+// returned to the pool by the deserializer once it has consumed them, so we
+// only need as many buffers as there are chunks in flight.
+static not_null<BufferPool*> deserialization_buffers =
+    new BufferPool(/*max_buffers=*/number_of_chunks + 1);
+
+// The name of the integrator in the ephemeris parameters which requests that
+// the integrator be selected automatically.  The step is then the largest step
+// considered.
+constexpr char automatic_fixed_step_size_integrator[] = "AUTOMATIC";
 
 Ephemeris<Barycentric>::FixedStepParameters MakeFixedStepParameters(
     ConfigurationFixedStepParameters const& parameters) {
@@ -198,6 +227,116 @@ std::unique_ptr<google::compression::Compressor> NewCompressor(
   }
 }
 
+// Pulls the next chunk of the serialization of |plugin|, creating and starting
+// a serializer if |*serializer| is null.  At the end of the serialization,
+// deletes the serializer and returns an empty array.
+Array<std::uint8_t> PullPluginSerialization(
+    Plugin const* const plugin,
+    PullSerializer** const serializer,
+    char const* const compressor) {
+  // Create and start a serializer if the caller didn't provide one.
+  if (*serializer == nullptr) {
+    LOG(INFO) << "Begin plugin serialization";
+    *serializer = new PullSerializer(chunk_size,
+                                     number_of_chunks,
+                                     NewCompressor(compressor));
+    not_null<serialization::Plugin*> const message =
+        Arena::CreateMessage<serialization::Plugin>(arenas->Lease(*serializer));
+    plugin->WriteToMessage(message);
+    (*serializer)->Start(message);
+  }
+
+  // Pull a chunk.
+  Array<std::uint8_t> bytes;
+  bytes = (*serializer)->Pull();
+
+  // If this is the end of the serialization, delete the serializer.
+  if (bytes.size == 0) {
+    LOG(INFO) << "End plugin serialization";
+    void const* const operation = *serializer;
+    TakeOwnership(serializer);
+    arenas->Return(operation);
+  }
+  return bytes;
+}
+
+// Pushes the first |size| decoded bytes of |buffer| to the deserializer of a
+// plugin, creating and starting one if |*deserializer| is null.  The |buffer|
+// must come from |deserialization_buffers|, it is returned to it once consumed.
+// If |size| is 0, deletes the deserializer, which ensures that |*plugin| is
+// filled.
+void PushPluginDeserialization(UniqueArray<std::uint8_t> buffer,
+                               std::int64_t const size,
+                               PushDeserializer** const deserializer,
+                               Plugin const** const plugin,
+                               char const* const compressor) {
+  // Create and start a deserializer if the caller didn't provide one.
+  if (*deserializer == nullptr) {
+    LOG(INFO) << "Begin plugin deserialization";
+    *deserializer = new PushDeserializer(chunk_size,
+                                         number_of_chunks,
+                                         NewCompressor(compressor));
+    not_null<serialization::Plugin*> const message =
+        Arena::CreateMessage<serialization::Plugin>(
+            arenas->Lease(*deserializer));
+    (*deserializer)->Start(
+        message,
+        [plugin](google::protobuf::Message const& message) {
+          *plugin = Plugin::ReadFromMessage(
+              static_cast<serialization::Plugin const&>(message)).release();
+        });
+  }
+
+  CHECK_LE(size, buffer.size);
+  if (size == 0) {
+    deserialization_buffers->Return(std::move(buffer));
+    (*deserializer)->Push(UniqueArray<std::uint8_t>());
+  } else {
+    Array<std::uint8_t> const bytes(buffer.data.release(), size);
+    (*deserializer)->Push(
+        bytes,
+        /*done=*/[data = bytes.data, capacity = buffer.size]() {
+          deserialization_buffers->Return(UniqueArray<std::uint8_t>(
+              std::unique_ptr<std::uint8_t[]>(data), capacity));
+        });
+  }
+
+  // If the data was empty, delete the deserializer.  This ensures that
+  // |*plugin| is filled.
+  if (size == 0) {
+    LOG(INFO) << "End plugin deserialization";
+    void const* const operation = *deserializer;
+    TakeOwnership(deserializer);
+    arenas->Return(operation);
+  }
+}
+
+// Formats the |Plugin::MemoryUsage| of |plugin| with one line per item and
+// the totals.
+std::string MemoryReport(Plugin const& plugin) {
+  using Item = Plugin::MemoryReport::Item;
+  Plugin::MemoryReport const report = plugin.MemoryUsage();
+  std::stringstream result;
+  auto const add_items = [&result](std::string const& title,
+                                   std::string const& elements,
+                                   auto const& items) {
+    Item total;
+    for (auto const& pair : items) {
+      Item const& item = pair.second;
+      result << title << " " << pair.first << ": " << item.elements << " "
+             << elements << ", " << item.bytes << " bytes\n";
+      total.elements += item.elements;
+      total.bytes += item.bytes;
+    }
+    result << title << " total: " << total.elements << " " << elements
+           << ", " << total.bytes << " bytes\n";
+  };
+  add_items("Celestial", "polynomials", report.celestials);
+  add_items("Vessel history", "points", report.vessel_histories);
+  add_items("Flight plan", "points", report.flight_plans);
+  return result.str();
+}
+
 }  // namespace
 
 // If |activate| is true and there is no active journal, create one and
@@ -206,6 +345,15 @@ std::unique_ptr<google::compression::Compressor> NewCompressor(
 // state.  |verbose| causes methods to be output in the INFO log before being
 // executed.
 void principia__ActivateRecorder(bool const activate) {
+  principia__ActivateRecorderWithOptions(activate,
+                                         /*replayable_only=*/false,
+                                         /*rolling_window_in_minutes=*/0);
+}
+
+void principia__ActivateRecorderWithOptions(
+    bool const activate,
+    bool const replayable_only,
+    int const rolling_window_in_minutes) {
   // NOTE: Do not journal!  You'd end up with half a message in the journal and
   // that would cause trouble.
   if (activate && !journal::Recorder::IsActivated()) {
@@ -215,14 +363,41 @@ void principia__ActivateRecorder(bool const activate) {
     std::tm* const localtime = std::localtime(&time);
     std::stringstream name;
     name << std::put_time(localtime, "JOURNAL.%Y%m%d-%H%M%S");
+    journal::Recorder::Options options;
+    options.format = journal::Recorder::Format::BINARY;
+    if (replayable_only) {
+      options.selection = journal::Recorder::Selection::REPLAYABLE;
+    }
+    if (rolling_window_in_minutes > 0) {
+      options.rolling_window = std::chrono::minutes(rolling_window_in_minutes);
+    }
     journal::Recorder* const recorder = new journal::Recorder(
-        std::filesystem::path("glog") / "Principia" / name.str());
+        std::filesystem::path("glog") / "Principia" / name.str(), options);
     journal::Recorder::Activate(recorder);
   } else if (!activate && journal::Recorder::IsActivated()) {
     journal::Recorder::Deactivate();
   }
 }
 
+void principia__ActivateTracer(bool const activate) {
+  // Not journaled, like |principia__ActivateRecorder|.
+  if (activate && !journal::Tracer::IsActivated()) {
+    journal::Tracer::Activate(std::make_unique<journal::Tracer>());
+  } else if (!activate && journal::Tracer::IsActivated()) {
+    auto const tracer = journal::Tracer::Deactivate();
+    // Build a name somewhat similar to that of the log files.
+    auto const now = std::chrono::system_clock::now();
+    std::time_t const time = std::chrono::system_clock::to_time_t(now);
+    std::tm* const localtime = std::localtime(&time);
+    std::stringstream name;
+    name << std::put_time(localtime, "TRACE.%Y%m%d-%H%M%S.json");
+    std::filesystem::path const path =
+        std::filesystem::path("glog") / "Principia" / name.str();
+    tracer->WriteChromeTrace(path);
+    LOG(INFO) << "Wrote the trace of the interface calls to " << path;
+  }
+}
+
 void principia__AdvanceTime(Plugin* const plugin,
                             double const t,
                             double const planetarium_rotation) {
@@ -372,34 +547,54 @@ void principia__DeserializePluginHexadecimal(
   CHECK_NOTNULL(deserializer);
   CHECK_NOTNULL(plugin);
 
-  // Create and start a deserializer if the caller didn't provide one.
-  if (*deserializer == nullptr) {
-    LOG(INFO) << "Begin plugin deserialization";
-    *deserializer = new PushDeserializer(chunk_size,
-                                         number_of_chunks,
-                                         NewCompressor(compressor));
-    not_null<serialization::Plugin*> const message =
-        Arena::CreateMessage<serialization::Plugin>(arena);
-    (*deserializer)->Start(
-        message,
-        [plugin](google::protobuf::Message const& message) {
-          *plugin = Plugin::ReadFromMessage(
-              static_cast<serialization::Plugin const&>(message)).release();
-        });
+  // Decode the hexadecimal representation.
+  Array<char const> const input(serialization, serialization_size);
+  std::int64_t const size = HexadecimalDecodedLength(input);
+  auto buffer = deserialization_buffers->Lease(size);
+  if (size > 0) {
+    HexadecimalDecode(input, buffer.get());
   }
+  PushPluginDeserialization(
+      std::move(buffer),
+      size,
+      deserializer,
+      plugin,
+      compressor);
+  return m.Return();
+}
 
-  // Decode the hexadecimal representation.
-  auto bytes = HexadecimalDecode({serialization, serialization_size});
-  auto const bytes_size = bytes.size;
-  (*deserializer)->Push(std::move(bytes));
+// Same as above, but |serialization| is a null-terminated base 32768
+// representation.  The caller must perform an extra call with an empty
+// |serialization| to indicate the end of the input stream.
+void principia__DeserializePluginBase32768(
+    char16_t const* const serialization,
+    PushDeserializer** const deserializer,
+    Plugin const** const plugin,
+    char const* const compressor) {
+  journal::Method<journal::DeserializePluginBase32768> m({serialization,
+                                                          deserializer,
+                                                          plugin,
+                                                          compressor},
+                                                         {deserializer,
+                                                          plugin});
+  CHECK_NOTNULL(serialization);
+  CHECK_NOTNULL(deserializer);
+  CHECK_NOTNULL(plugin);
 
-  // If the data was empty, delete the deserializer.  This ensures that
-  // |*plugin| is filled.
-  if (bytes_size == 0) {
-    LOG(INFO) << "End plugin deserialization";
-    TakeOwnership(deserializer);
-    arena->Reset();
+  std::int64_t const serialization_size =
+      std::char_traits<char16_t>::length(serialization);
+  Array<char16_t const> const input(serialization, serialization_size);
+  std::int64_t const size = Base32768DecodedLength(input);
+  auto buffer = deserialization_buffers->Lease(size);
+  if (size > 0) {
+    Base32768Decode(input, buffer.get());
   }
+  PushPluginDeserialization(
+      std::move(buffer),
+      size,
+      deserializer,
+      plugin,
+      compressor);
   return m.Return();
 }
 
@@ -458,6 +653,84 @@ QP principia__GetPartActualDegreesOfFreedom(Plugin const* const plugin,
                             origin.main_body_centre_in_world))))));
 }
 
+void principia__GetCelestialStates(Plugin const* const plugin,
+                                   int const* const celestial_indices,
+                                   int const celestial_indices_size,
+                                   CelestialState* const states) {
+  CHECK_NOTNULL(plugin);
+  CHECK_LE(0, celestial_indices_size);
+  if (celestial_indices_size == 0) {
+    return;
+  }
+  CHECK_NOTNULL(celestial_indices);
+  CHECK_NOTNULL(states);
+  auto const celestial_states = plugin->CelestialStates(
+      std::vector<int>(celestial_indices,
+                       celestial_indices + celestial_indices_size));
+  for (int i = 0; i < celestial_indices_size; ++i) {
+    auto const& celestial_state = celestial_states[i];
+    states[i].rotation = ToWXYZ(celestial_state.rotation.quaternion());
+    states[i].from_parent = celestial_state.from_parent.has_value()
+                                ? ToQP(*celestial_state.from_parent)
+                                : QP{{0, 0, 0}, {0, 0, 0}};
+  }
+}
+
+void principia__GetVesselStates(Plugin const* const plugin,
+                                char const* const* const vessel_guids,
+                                int const vessel_guids_size,
+                                VesselState* const states) {
+  CHECK_NOTNULL(plugin);
+  CHECK_LE(0, vessel_guids_size);
+  if (vessel_guids_size == 0) {
+    return;
+  }
+  CHECK_NOTNULL(vessel_guids);
+  CHECK_NOTNULL(states);
+  auto const vessel_states = plugin->VesselStates(
+      std::vector<GUID>(vessel_guids, vessel_guids + vessel_guids_size));
+  for (int i = 0; i < vessel_guids_size; ++i) {
+    states[i].parent_index = vessel_states[i].parent_index;
+    states[i].from_parent = ToQP(vessel_states[i].from_parent);
+  }
+}
+
+void principia__GetPartsActualDegreesOfFreedom(Plugin const* const plugin,
+                                               uint32_t const* const part_ids,
+                                               int const part_ids_size,
+                                               Origin const origin,
+                                               QP* const degrees_of_freedom) {
+  CHECK_NOTNULL(plugin);
+  CHECK_LE(0, part_ids_size);
+  if (part_ids_size == 0) {
+    return;
+  }
+  CHECK_NOTNULL(part_ids);
+  CHECK_NOTNULL(degrees_of_freedom);
+  // The transformation is the same for all the parts, so it is only computed
+  // once.
+  auto const barycentric_to_world = plugin->BarycentricToWorld(
+      origin.reference_part_is_unmoving,
+      origin.reference_part_id,
+      origin.reference_part_is_at_origin
+          ? std::nullopt
+          : std::make_optional(
+                FromXYZ<Position<World>>(origin.main_body_centre_in_world)));
+  for (int i = 0; i < part_ids_size; ++i) {
+    degrees_of_freedom[i] = ToQP(plugin->GetPartActualDegreesOfFreedom(
+        part_ids[i], barycentric_to_world));
+  }
+}
+
+char const* principia__GetMemoryReport(Plugin const* const plugin) {
+  CHECK_NOTNULL(plugin);
+  std::string const report = MemoryReport(*plugin);
+  // Ownership will be transfered to the marshmallow.
+  UniqueArray<char> allocated_report(report.size() + 1);
+  std::memcpy(allocated_report.data.get(), report.data(), report.size() + 1);
+  return allocated_report.data.release();
+}
+
 int principia__GetStderrLogging() {
   journal::Method<journal::GetStderrLogging> m;
   return m.Return(FLAGS_stderrthreshold);
@@ -516,6 +789,21 @@ void principia__IncrementPartIntrinsicForce(Plugin* const plugin,
   return m.Return();
 }
 
+void principia__IncrementPartsIntrinsicForces(Plugin* const plugin,
+                                              PartForce const* const forces,
+                                              int const forces_size) {
+  journal::Method<journal::IncrementPartsIntrinsicForces> m(
+      {plugin, forces, forces_size});
+  CHECK_NOTNULL(plugin);
+  for (int i = 0; i < forces_size; ++i) {
+    plugin->IncrementPartIntrinsicForce(
+        forces[i].part_id,
+        Vector<Force, World>(FromXYZ(forces[i].force_in_kilonewtons) *
+                             Kilo(Newton)));
+  }
+  return m.Return();
+}
+
 // Sets stderr to log INFO, and redirects stderr, which Unity does not log, to
 // "<KSP directory>/stderr.log".  This provides an easily accessible file
 // containing a sufficiently verbose log of the latest session, instead of
@@ -574,7 +862,14 @@ void principia__InitializeEphemerisParameters(
   journal::Method<journal::InitializeEphemerisParameters> m(
       {plugin, parameters});
   CHECK_NOTNULL(plugin);
-  plugin->InitializeEphemerisParameters(MakeFixedStepParameters(parameters));
+  if (std::strcmp(parameters.fixed_step_size_integrator,
+                  automatic_fixed_step_size_integrator) == 0) {
+    plugin->InitializeEphemerisParametersCandidates(
+        EphemerisParametersCandidates(
+            ParseQuantity<Time>(parameters.integration_step_size)));
+  } else {
+    plugin->InitializeEphemerisParameters(MakeFixedStepParameters(parameters));
+  }
   return m.Return();
 }
 
@@ -772,6 +1067,11 @@ void principia__LogInfo(char const* const text) {
   return m.Return();
 }
 
+void principia__LogMemoryReport(Plugin const* const plugin) {
+  CHECK_NOTNULL(plugin);
+  LOG(INFO) << "Memory usage:\n" << MemoryReport(*plugin);
+}
+
 void principia__LogWarning(char const* const text) {
   journal::Method<journal::LogWarning> m({text});
   LOG(WARNING) << text;
@@ -825,6 +1125,13 @@ void principia__PrepareToReportCollisions(Plugin* const plugin) {
   return m.Return();
 }
 
+void principia__PutVesselToSleep(Plugin* const plugin,
+                                 char const* const vessel_guid) {
+  journal::Method<journal::PutVesselToSleep> m({plugin, vessel_guid});
+  CHECK_NOTNULL(plugin)->PutVesselToSleep(vessel_guid);
+  return m.Return();
+}
+
 void principia__ReportGroundCollision(Plugin const* const plugin,
                                       uint32_t const part_id) {
   journal::Method<journal::ReportGroundCollision> m({plugin, part_id});
@@ -859,28 +1166,9 @@ char const* principia__SerializePluginHexadecimal(
   CHECK_NOTNULL(plugin);
   CHECK_NOTNULL(serializer);
 
-  // Create and start a serializer if the caller didn't provide one.
-  if (*serializer == nullptr) {
-    LOG(INFO) << "Begin plugin serialization";
-    *serializer = new PullSerializer(chunk_size,
-                                     number_of_chunks,
-                                     NewCompressor(compressor));
-    not_null<serialization::Plugin*> const message =
-        Arena::CreateMessage<serialization::Plugin>(arena);
-    plugin->WriteToMessage(message);
-    (*serializer)->Start(message);
-  }
-
-  // Pull a chunk.
-  Array<std::uint8_t> bytes;
-  bytes = (*serializer)->Pull();
-
-  // If this is the end of the serialization, delete the serializer and return a
-  // nullptr.
+  Array<std::uint8_t> const bytes =
+      PullPluginSerialization(plugin, serializer, compressor);
   if (bytes.size == 0) {
-    LOG(INFO) << "End plugin serialization";
-    TakeOwnership(serializer);
-    arena->Reset();
     return m.Return(nullptr);
   }
 
@@ -889,6 +1177,27 @@ char const* principia__SerializePluginHexadecimal(
   return m.Return(hexadecimal.data.release());
 }
 
+// Same as above, but the chunks are returned in base 32768, which is 3.75
+// times denser than hexadecimal when the string is stored as UTF-16.
+char16_t const* principia__SerializePluginBase32768(
+    Plugin const* const plugin,
+    PullSerializer** const serializer,
+    char const* const compressor) {
+  journal::Method<journal::SerializePluginBase32768> m({plugin, serializer},
+                                                       {serializer});
+  CHECK_NOTNULL(plugin);
+  CHECK_NOTNULL(serializer);
+
+  Array<std::uint8_t> const bytes =
+      PullPluginSerialization(plugin, serializer, compressor);
+  if (bytes.size == 0) {
+    return m.Return(nullptr);
+  }
+
+  auto base32768 = Base32768Encode(bytes, /*null_terminated=*/true);
+  return m.Return(base32768.data.release());
+}
+
 // Sets the maximum number of seconds which logs may be buffered for.
 void principia__SetBufferDuration(int const seconds) {
   journal::Method<journal::SetBufferDuration> m({seconds});
@@ -926,6 +1235,52 @@ void principia__SetPartApparentDegreesOfFreedom(
   return m.Return();
 }
 
+void principia__SetPartsApparentDegreesOfFreedom(
+    Plugin* const plugin,
+    PartDegreesOfFreedom const* const degrees_of_freedom,
+    int const degrees_of_freedom_size,
+    QP const main_body_degrees_of_freedom) {
+  journal::Method<journal::SetPartsApparentDegreesOfFreedom> m(
+      {plugin,
+       degrees_of_freedom,
+       degrees_of_freedom_size,
+       main_body_degrees_of_freedom});
+  CHECK_NOTNULL(plugin);
+  auto const main_body =
+      FromQP<DegreesOfFreedom<World>>(main_body_degrees_of_freedom);
+  for (int i = 0; i < degrees_of_freedom_size; ++i) {
+    plugin->SetPartApparentDegreesOfFreedom(
+        degrees_of_freedom[i].part_id,
+        FromQP<DegreesOfFreedom<World>>(
+            degrees_of_freedom[i].degrees_of_freedom),
+        main_body);
+  }
+  return m.Return();
+}
+
+void principia__SetPredictionFrameBudget(Plugin* const plugin,
+                                         double const seconds) {
+  journal::Method<journal::SetPredictionFrameBudget> m({plugin, seconds});
+  CHECK_NOTNULL(plugin);
+  // An infinite budget means that the predictions are not limited in time.
+  if (std::isfinite(seconds)) {
+    plugin->SetPredictionFrameBudget(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(seconds)));
+  } else {
+    plugin->SetPredictionFrameBudget(std::nullopt);
+  }
+  return m.Return();
+}
+
+void principia__SetPersistFlightPlanSegments(Plugin* const plugin,
+                                             bool const persist) {
+  journal::Method<journal::SetPersistFlightPlanSegments> m({plugin, persist});
+  CHECK_NOTNULL(plugin);
+  plugin->SetPersistFlightPlanSegments(persist);
+  return m.Return();
+}
+
 // Make it so that all log messages of at least |min_severity| are logged to
 // stderr (in addition to logging to the usual log file(s)).
 void principia__SetStderrLogging(int const min_severity) {
@@ -944,6 +1299,24 @@ void principia__SetSuppressedLogging(int const min_severity) {
   return m.Return();
 }
 
+// Configures the threads that the plugin starts afterwards, in particular those
+// started when a plugin is constructed or deserialized.  |max_pool_size| caps
+// the number of worker threads if it is positive; |reserved_cores_mask| has
+// bit i set if core i is reserved for the game.
+void principia__SetThreadConfiguration(int const max_pool_size,
+                                       bool const low_priority,
+                                       std::int64_t const reserved_cores_mask) {
+  journal::Method<journal::SetThreadConfiguration> m(
+      {max_pool_size, low_priority, reserved_cores_mask});
+  ThreadConfiguration configuration;
+  configuration.max_pool_size = max_pool_size;
+  configuration.low_priority = low_priority;
+  configuration.reserved_cores_mask =
+      static_cast<std::uint64_t>(reserved_cores_mask);
+  SetThreadConfiguration(configuration);
+  return m.Return();
+}
+
 // Show all VLOG(m) messages for |m <= level|.
 void principia__SetVerboseLogging(int const level) {
   journal::Method<journal::SetVerboseLogging> m({level});
@@ -988,5 +1361,13 @@ void principia__UpdatePrediction(Plugin const* const plugin,
   return m.Return();
 }
 
+void principia__UpdateSecondaryPrediction(Plugin const* const plugin,
+                                          char const* const vessel_guid) {
+  journal::Method<journal::UpdateSecondaryPrediction> m({plugin, vessel_guid});
+  CHECK_NOTNULL(plugin);
+  plugin->UpdatePrediction(vessel_guid, PredictionLevelOfDetail::Medium);
+  return m.Return();
+}
+
 }  // namespace interface
 }  // namespace principia
@@ -42,6 +42,7 @@ using geometry::Velocity;
 using ksp_plugin::AliceSun;
 using ksp_plugin::Barycentric;
 using ksp_plugin::Camera;
+using ksp_plugin::FreefallFuture;
 using ksp_plugin::Iterator;
 using ksp_plugin::NavigationFrame;
 using ksp_plugin::PileUp;
@@ -68,12 +69,133 @@ std::unique_ptr<T[]> TakeOwnershipArray(T** pointer);
 extern "C" PRINCIPIA_DLL
 void CDECL principia__ActivateRecorder(bool activate);
 
+// Same as |principia__ActivateRecorder|, but the journal that is created, if
+// any, only contains the methods needed for replay if |replayable_only| is
+// true, and only those of the last |rolling_window_in_minutes| if it is
+// positive.  In the latter case the journal is only written when the recorder
+// is deactivated or when a CHECK fails.
+extern "C" PRINCIPIA_DLL
+void CDECL principia__ActivateRecorderWithOptions(
+    bool activate,
+    bool replayable_only,
+    int rolling_window_in_minutes);
+
+// Starts recording the duration of the calls to the interface functions, or
+// stops and writes them in the Chrome trace event format next to the logs.
+extern "C" PRINCIPIA_DLL
+void CDECL principia__ActivateTracer(bool activate);
+
 extern "C" PRINCIPIA_DLL
 void CDECL principia__InitGoogleLogging();
 
+// Stores into |states[i]| the rotation and the degrees of freedom relative to
+// its parent of the celestial |celestial_indices[i]|, as returned by
+// |principia__CelestialRotation| and |principia__CelestialFromParent|, for i in
+// [0, celestial_indices_size[.  The trajectories of the celestials are only
+// evaluated once per frame.  This function is not journaled as it only exists
+// to avoid interop calls per celestial; it must not have any side effect.
+extern "C" PRINCIPIA_DLL
+void CDECL principia__GetCelestialStates(Plugin const* plugin,
+                                         int const* celestial_indices,
+                                         int celestial_indices_size,
+                                         CelestialState* states);
+
+// Stores into |states[i]| the index of the parent and the degrees of freedom
+// relative to it of the vessel |vessel_guids[i]|, for i in
+// [0, vessel_guids_size[.  The parents of the vessels are maintained by the
+// plugin; unlike |principia__VesselFromParent|, this function doesn't change
+// them.  This function is not journaled as it only exists to avoid interop
+// calls per vessel; it must not have any side effect.
+extern "C" PRINCIPIA_DLL
+void CDECL principia__GetVesselStates(Plugin const* plugin,
+                                      char const* const* vessel_guids,
+                                      int vessel_guids_size,
+                                      VesselState* states);
+
+// Stores into |degrees_of_freedom[i]| the result of
+// |principia__GetPartActualDegreesOfFreedom| for |part_ids[i]|, for i in
+// [0, part_ids_size[.  The transformation to |World| defined by |origin| is
+// only computed once.  This function is not journaled as it only exists to
+// avoid an interop call per part; it must not have any side effect.
+extern "C" PRINCIPIA_DLL
+void CDECL principia__GetPartsActualDegreesOfFreedom(
+    Plugin const* plugin,
+    uint32_t const* part_ids,
+    int part_ids_size,
+    Origin origin,
+    QP* degrees_of_freedom);
+
+// Copies all the points of the |RP2Lines| held by |iterator| into |xy|, and
+// for each line the index in |xy| one past its last point into |line_ends|.
+// The position of |iterator| is irrelevant.  Returns the number of points and
+// sets |*line_count| to the number of lines.  If the buffers are too small
+// (|xy_size| or |line_ends_size| is less than these numbers) nothing is
+// written; the caller must retry with larger buffers.  This function is not
+// journaled as it only exists to avoid an interop call per point; it must
+// not have any side effect.
+extern "C" PRINCIPIA_DLL
+int CDECL principia__IteratorGetRP2LinesXY(Iterator const* iterator,
+                                           XY* xy,
+                                           int xy_size,
+                                           int* line_ends,
+                                           int line_ends_size,
+                                           int* line_count);
+
+// Copies the positions of the points of the |DiscreteTrajectory<World>| held
+// by |iterator| into |xyz|, keeping only one point every |stride| points and
+// always keeping the last one.  The positions are written relative to
+// |floating_origin|, typically a point near the camera, in single precision.
+// The subtraction is done in double precision, so the points near the origin
+// keep their full accuracy.  The position of |iterator| is irrelevant.
+// Returns the number of points kept.  If |xyz_size| is less than that number
+// nothing is written; the caller must retry with a larger buffer.  This
+// function is not journaled as it only exists to avoid an interop call per
+// point; it must not have any side effect.
+extern "C" PRINCIPIA_DLL
+int CDECL principia__IteratorGetDiscreteTrajectoryFloatXYZs(
+    Iterator const* iterator,
+    XYZ floating_origin,
+    int stride,
+    FloatXYZ* xyz,
+    int xyz_size);
+
+// Control of the |base::Profiler|, which measures the time spent in the
+// ephemeris, continuous trajectories, plugin and renderer.  These functions are
+// not journaled as they have no effect on the plugin.  The result of
+// |principia__ProfilerGetReport| is owned by the caller.
+extern "C" PRINCIPIA_DLL
+void CDECL principia__ProfilerSetEnabled(bool enabled);
+extern "C" PRINCIPIA_DLL
+void CDECL principia__ProfilerReset();
+extern "C" PRINCIPIA_DLL
+char const* CDECL principia__ProfilerGetReport();
+extern "C" PRINCIPIA_DLL
+void CDECL principia__ProfilerLogReport();
+
+// Copies the statistics of the phases of the |base::Profiler| into
+// |statistics|, in the order of |base::ProfilingPhase|, for display in game.
+// Returns the number of phases.  If |statistics_size| is less than that number
+// nothing is written; the caller must retry with a larger buffer.  The result
+// of |principia__ProfilerGetPhaseName| is owned by the plugin.
+extern "C" PRINCIPIA_DLL
+int CDECL principia__ProfilerGetSnapshot(TimingStatistics* statistics,
+                                         int statistics_size);
+extern "C" PRINCIPIA_DLL
+char const* CDECL principia__ProfilerGetPhaseName(int phase);
+
+// A report of the memory used by the trajectories of the |plugin|, see
+// |Plugin::MemoryUsage|.  These functions are not journaled as they have no
+// effect on the plugin.  The result of |principia__GetMemoryReport| is owned by
+// the caller.
+extern "C" PRINCIPIA_DLL
+char const* CDECL principia__GetMemoryReport(Plugin const* plugin);
+extern "C" PRINCIPIA_DLL
+void CDECL principia__LogMemoryReport(Plugin const* plugin);
+
 bool operator==(AdaptiveStepParameters const& left,
                 AdaptiveStepParameters const& right);
 bool operator==(Burn const& left, Burn const& right);
+bool operator==(FloatXYZ const& left, FloatXYZ const& right);
 bool operator==(NavigationFrameParameters const& left,
                 NavigationFrameParameters const& right);
 bool operator==(NavigationManoeuvre const& left,
@@ -115,6 +237,11 @@ AdaptiveStepParameters ToAdaptiveStepParameters(
     physics::Ephemeris<Barycentric>::AdaptiveStepParameters const&
         adaptive_step_parameters);
 
+AdaptiveStepStatistics ToAdaptiveStepStatistics(
+    integrators::AdaptiveStepStatistics const& adaptive_step_statistics);
+
+FloatXYZ ToFloatXYZ(Displacement<World> const& displacement);
+
 KeplerianElements ToKeplerianElements(
     physics::KeplerianElements<Barycentric> const& keplerian_elements);
 
@@ -123,6 +123,12 @@ inline bool operator==(Burn const& left, Burn const& right) {
          left.delta_v == right.delta_v;
 }
 
+inline bool operator==(FloatXYZ const& left, FloatXYZ const& right) {
+  return NaNIndependentEq(left.x, right.x) &&
+         NaNIndependentEq(left.y, right.y) &&
+         NaNIndependentEq(left.z, right.z);
+}
+
 inline bool operator==(NavigationFrameParameters const& left,
                        NavigationFrameParameters const& right) {
   return left.extension == right.extension &&
@@ -239,6 +245,20 @@ inline AdaptiveStepParameters ToAdaptiveStepParameters(
               (Metre / Second)};
 }
 
+inline AdaptiveStepStatistics ToAdaptiveStepStatistics(
+    integrators::AdaptiveStepStatistics const& adaptive_step_statistics) {
+  return {adaptive_step_statistics.steps,
+          adaptive_step_statistics.rejected_steps,
+          adaptive_step_statistics.function_evaluations};
+}
+
+inline FloatXYZ ToFloatXYZ(Displacement<World> const& displacement) {
+  R3Element<double> const coordinates = displacement.coordinates() / Metre;
+  return {static_cast<float>(coordinates.x),
+          static_cast<float>(coordinates.y),
+          static_cast<float>(coordinates.z)};
+}
+
 inline KeplerianElements ToKeplerianElements(
     physics::KeplerianElements<Barycentric> const& keplerian_elements) {
   return {*keplerian_elements.eccentricity,
@@ -1,14 +1,15 @@
 ﻿
 #include "ksp_plugin/interface.hpp"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/array.hpp"
 #include "base/status.hpp"
 #include "base/status_or.hpp"
 #include "journal/method.hpp"
 #include "journal/profiles.hpp"
-#include "physics/apsides.hpp"
 
 namespace principia {
 namespace interface {
@@ -18,11 +19,10 @@ using base::StatusOr;
 using base::UniqueArray;
 using geometry::AngularVelocity;
 using ksp_plugin::FlightPlan;
+using ksp_plugin::Freefall;
 using ksp_plugin::Navigation;
 using ksp_plugin::Vessel;
 using physics::BodyCentredNonRotatingDynamicFrame;
-using physics::ComputeApsides;
-using physics::DiscreteTrajectory;
 using physics::RigidMotion;
 using physics::RigidTransformation;
 
@@ -47,6 +47,15 @@ Status OK() {
   return MakeStatus(base::Status::OK);
 }
 
+Freefall FromExternalFreefall(Plugin const& plugin,
+                              QP const& world_body_centred_initial_qp,
+                              double const t_initial,
+                              double const t_final) {
+  return {FromQP<DegreesOfFreedom<World>>(world_body_centred_initial_qp),
+          FromGameTime(plugin, t_initial),
+          FromGameTime(plugin, t_final)};
+}
+
 }  // namespace
 
 Status principia__ExternalFlowFreefall(
@@ -67,8 +76,97 @@ Status principia__ExternalFlowFreefall(
     return m.Return(
         MakeStatus(Error::INVALID_ARGUMENT, "|plugin| must not be null"));
   }
-  return m.Return(MakeStatus(Error::UNIMPLEMENTED,
-                             "|ExternalFlowFreefall| is not yet implemented"));
+  if (!plugin->HasCelestial(central_body_index)) {
+    return m.Return(MakeStatus(
+        Error::NOT_FOUND,
+        "No celestial with index " + std::to_string(central_body_index)));
+  }
+  auto const future = plugin->FlowFreefalls(
+      central_body_index,
+      {FromExternalFreefall(*plugin,
+                            world_body_centred_initial_degrees_of_freedom,
+                            t_initial,
+                            t_final)});
+  future->wait();
+  auto const& result = future->results.front();
+  if (!result.ok()) {
+    return m.Return(MakeStatus(result.status()));
+  }
+  *world_body_centred_final_degrees_of_freedom = ToQP(result.ValueOrDie());
+  return m.Return(OK());
+}
+
+FreefallFuture* principia__ExternalFlowFreefalls(
+    Plugin const* const plugin,
+    int const central_body_index,
+    ExternalFreefall const* const freefalls,
+    int const freefalls_size) {
+  journal::Method<journal::ExternalFlowFreefalls> m{
+      {plugin, central_body_index, freefalls, freefalls_size}};
+  CHECK_NOTNULL(plugin);
+  std::vector<Freefall> plugin_freefalls;
+  plugin_freefalls.reserve(freefalls_size);
+  for (int i = 0; i < freefalls_size; ++i) {
+    ExternalFreefall const& freefall = freefalls[i];
+    plugin_freefalls.push_back(FromExternalFreefall(
+        *plugin,
+        freefall.world_body_centred_initial_degrees_of_freedom,
+        freefall.t_initial,
+        freefall.t_final));
+  }
+  if (!plugin->HasCelestial(central_body_index)) {
+    // Don't start anything, but let the client find the error in the results.
+    auto future = std::make_unique<FreefallFuture>(freefalls_size);
+    for (auto& result : future->results) {
+      result = base::Status(
+          Error::NOT_FOUND,
+          "No celestial with index " + std::to_string(central_body_index));
+    }
+    return m.Return(future.release());
+  }
+  return m.Return(
+      plugin->FlowFreefalls(central_body_index, plugin_freefalls).release());
+}
+
+bool principia__ExternalFreefallFutureIsReady(
+    Plugin const* const plugin,
+    FreefallFuture const* const future) {
+  journal::Method<journal::ExternalFreefallFutureIsReady> m{{plugin, future}};
+  return m.Return(CHECK_NOTNULL(future)->is_ready());
+}
+
+Status principia__ExternalGetFreefallResult(
+    Plugin const* const plugin,
+    FreefallFuture const* const future,
+    int const index,
+    QP* const world_body_centred_final_degrees_of_freedom) {
+  journal::Method<journal::ExternalGetFreefallResult> m{
+      {plugin, future, index},
+      {world_body_centred_final_degrees_of_freedom}};
+  CHECK_NOTNULL(future);
+  if (index < 0 || index >= future->results.size()) {
+    return m.Return(MakeStatus(
+        Error::OUT_OF_RANGE,
+        "|index| " + std::to_string(index) + " out of range, there are " +
+            std::to_string(future->results.size()) + " freefalls"));
+  }
+  future->wait();
+  auto const& result = future->results[index];
+  if (!result.ok()) {
+    return m.Return(MakeStatus(result.status()));
+  }
+  *world_body_centred_final_degrees_of_freedom = ToQP(result.ValueOrDie());
+  return m.Return(OK());
+}
+
+void principia__ExternalDeleteFreefallFuture(Plugin const* const plugin,
+                                             FreefallFuture** const future) {
+  journal::Method<journal::ExternalDeleteFreefallFuture> m{{plugin, future},
+                                                          {future}};
+  CHECK_NOTNULL(future);
+  // Waits for the integrations.
+  TakeOwnership(future);
+  return m.Return();
 }
 
 Status principia__ExternalGetNearestPlannedCoastDegreesOfFreedom(
@@ -127,17 +225,10 @@ Status principia__ExternalGetNearestPlannedCoastDegreesOfFreedom(
                                    std::to_string(manoeuvre_index) + " of " +
                                    vessel.ShortDebugString()));
   }
-  DiscreteTrajectory<Barycentric>::Iterator coast_begin;
-  DiscreteTrajectory<Barycentric>::Iterator coast_end;
-  flight_plan.GetSegment(segment_index, coast_begin, coast_end);
   auto const body_centred_inertial =
       plugin->NewBodyCentredNonRotatingNavigationFrame(central_body_index);
-  DiscreteTrajectory<Navigation> coast;
-  for (auto it = coast_begin; it != coast_end; ++it) {
-    coast.Append(it.time(),
-                 body_centred_inertial->ToThisFrameAtTime(it.time())(
-                     it.degrees_of_freedom()));
-  }
+  auto const& coast_index = flight_plan.GetSegmentSplineIndex(
+      segment_index, plugin->GetCelestial(central_body_index).body());
 
   Instant const current_time = plugin->CurrentTime();
   // The given |World| position and requested |World| degrees of freedom are
@@ -160,35 +251,9 @@ Status principia__ExternalGetNearestPlannedCoastDegreesOfFreedom(
   Position<Navigation> reference_position =
       from_world_body_centred_inertial.rigid_transformation()(
           FromXYZ<Position<World>>(world_body_centred_reference_position));
-  DiscreteTrajectory<Navigation> immobile_reference;
-  immobile_reference.Append(coast.Begin().time(),
-                            {reference_position, Velocity<Navigation>{}});
-  if (coast.Size() > 1) {
-    immobile_reference.Append(coast.last().time(),
-                              {reference_position, Velocity<Navigation>{}});
-  }
-  DiscreteTrajectory<Navigation> apoapsides;
-  DiscreteTrajectory<Navigation> periapsides;
-  ComputeApsides(/*reference=*/immobile_reference,
-                 coast.Begin(),
-                 coast.End(),
-                 apoapsides,
-                 periapsides);
-  if (periapsides.Empty()) {
-    bool const begin_is_nearest =
-        (coast.Begin().degrees_of_freedom().position() -
-         reference_position).Norm²() <
-        (coast.last().degrees_of_freedom().position() -
-         reference_position).Norm²();
-    *world_body_centred_nearest_degrees_of_freedom =
-        ToQP(to_world_body_centred_inertial(
-            begin_is_nearest ? coast.Begin().degrees_of_freedom()
-                             : coast.last().degrees_of_freedom()));
-  } else {
-    *world_body_centred_nearest_degrees_of_freedom =
-        ToQP(to_world_body_centred_inertial(
-            periapsides.Begin().degrees_of_freedom()));
-  }
+  *world_body_centred_nearest_degrees_of_freedom =
+      ToQP(to_world_body_centred_inertial(
+          coast_index.Nearest(reference_position)));
   return m.Return(OK());
 }
 
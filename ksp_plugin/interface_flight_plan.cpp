@@ -16,6 +16,7 @@
 #include "physics/body_surface_dynamic_frame.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
+#include "physics/shared_dynamic_frame.hpp"
 #include "quantities/constants.hpp"
 #include "quantities/si.hpp"
 
@@ -44,6 +45,7 @@ using physics::BodySurfaceDynamicFrame;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
 using physics::Frenet;
+using physics::SharedDynamicFrame;
 using quantities::Speed;
 using quantities::constants::StandardGravity;
 using quantities::si::Kilo;
@@ -85,12 +87,21 @@ Burn GetBurn(Plugin const& plugin,
   parameters.primary_index = -1;
   parameters.secondary_index = -1;
 
+  // The frames returned by the plugin share an underlying frame, which is the
+  // one that we need to identify.
+  NavigationFrame const* frame = manœuvre.frame();
+  if (auto* const shared_frame =
+          dynamic_cast<SharedDynamicFrame<Barycentric, Navigation> const*>(
+              frame)) {
+    frame = &shared_frame->frame();
+  }
+
   int number_of_subclasses = 0;
 
   {
     auto const* barycentric_rotating_dynamic_frame = dynamic_cast<
         BarycentricRotatingDynamicFrame<Barycentric, Navigation> const*>(
-            &*manœuvre.frame());
+            frame);
     if (barycentric_rotating_dynamic_frame != nullptr) {
       ++number_of_subclasses;
       parameters.extension =
@@ -105,7 +116,7 @@ Burn GetBurn(Plugin const& plugin,
   {
     auto const* body_centred_body_direction_dynamic_frame = dynamic_cast<
         BodyCentredBodyDirectionDynamicFrame<Barycentric, Navigation> const*>(
-            &*manœuvre.frame());
+            frame);
     if (body_centred_body_direction_dynamic_frame != nullptr) {
       ++number_of_subclasses;
       parameters.extension = serialization::
@@ -120,7 +131,7 @@ Burn GetBurn(Plugin const& plugin,
   {
     auto const* body_centred_non_rotating_dynamic_frame = dynamic_cast<
         BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation> const*>(
-            &*manœuvre.frame());
+            frame);
     if (body_centred_non_rotating_dynamic_frame != nullptr) {
       ++number_of_subclasses;
       parameters.extension = serialization::BodyCentredNonRotatingDynamicFrame::
@@ -133,7 +144,7 @@ Burn GetBurn(Plugin const& plugin,
   {
     auto const* body_surface_dynamic_frame = dynamic_cast<
         BodySurfaceDynamicFrame<Barycentric, Navigation> const*>(
-            &*manœuvre.frame());
+            frame);
     if (body_surface_dynamic_frame != nullptr) {
       ++number_of_subclasses;
       parameters.extension =
@@ -327,6 +338,22 @@ int principia__FlightPlanNumberOfSegments(Plugin const* const plugin,
   return m.Return(GetFlightPlan(*plugin, vessel_guid).number_of_segments());
 }
 
+bool principia__FlightPlanOptimizeClosestApproach(
+    Plugin const* const plugin,
+    char const* const vessel_guid,
+    int const celestial_index,
+    double const distance,
+    double const tolerance) {
+  journal::Method<journal::FlightPlanOptimizeClosestApproach> m(
+      {plugin, vessel_guid, celestial_index, distance, tolerance});
+  CHECK_NOTNULL(plugin);
+  return m.Return(plugin->OptimizeFlightPlanClosestApproach(vessel_guid,
+                                                            celestial_index,
+                                                            distance * Metre,
+                                                            tolerance * Metre).
+                      ok());
+}
+
 void principia__FlightPlanRemoveLast(Plugin const* const plugin,
                                      char const* const vessel_guid) {
   journal::Method<journal::FlightPlanRemoveLast> m({plugin, vessel_guid});
@@ -17,6 +17,7 @@ namespace principia {
 namespace interface {
 
 using base::check_not_null;
+using geometry::Position;
 using geometry::RP2Line;
 using geometry::RP2Lines;
 using geometry::RP2Point;
@@ -28,6 +29,48 @@ using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using quantities::Length;
 
+namespace {
+
+// Writes to |xyz| the result of |convert| applied to the positions of one
+// point every |stride| points of the |DiscreteTrajectory<World>| held by
+// |iterator|, and of the last one, see
+// |principia__IteratorGetDiscreteTrajectoryFloatXYZs|.
+template<typename Interchange, typename Convert>
+int FillStridedPositions(Iterator const* const iterator,
+                         int const stride,
+                         Convert const& convert,
+                         Interchange* const xyz,
+                         int const xyz_size) {
+  CHECK_NOTNULL(iterator);
+  CHECK_LT(0, stride);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<DiscreteTrajectory<World>> const*>(iterator));
+  DiscreteTrajectory<World> const& trajectory = typed_iterator->trajectory();
+
+  int const size = trajectory.Size();
+  if (size == 0) {
+    return 0;
+  }
+  // The points at indices 0, stride, 2 * stride... and the last one.
+  int const point_count = (size - 1) / stride + 1 + ((size - 1) % stride != 0);
+  if (point_count > xyz_size) {
+    return point_count;
+  }
+
+  int index = 0;
+  int i = 0;
+  for (auto it = trajectory.Begin(); it != trajectory.End(); ++it, ++i) {
+    if (i % stride == 0 || i == size - 1) {
+      xyz[index] = convert(it.degrees_of_freedom().position());
+      ++index;
+    }
+  }
+  CHECK_EQ(point_count, index);
+  return point_count;
+}
+
+}  // namespace
+
 bool principia__IteratorAtEnd(Iterator const* const iterator) {
   journal::Method<journal::IteratorAtEnd> m({iterator});
   return m.Return(CHECK_NOTNULL(iterator)->AtEnd());
@@ -75,6 +118,25 @@ XYZ principia__IteratorGetDiscreteTrajectoryXYZ(
       }));
 }
 
+int principia__IteratorGetDiscreteTrajectoryFloatXYZs(
+    Iterator const* const iterator,
+    XYZ const floating_origin,
+    int const stride,
+    FloatXYZ* const xyz,
+    int const xyz_size) {
+  // NOTE: Do not journal!  The buffer is owned by the caller and cannot be
+  // replayed.
+  Position<World> const origin = FromXYZ<Position<World>>(floating_origin);
+  return FillStridedPositions(
+      iterator,
+      stride,
+      [origin](Position<World> const& position) {
+        return ToFloatXYZ(position - origin);
+      },
+      xyz,
+      xyz_size);
+}
+
 Iterator* principia__IteratorGetRP2LinesIterator(
     Iterator const* const iterator) {
   journal::Method<journal::IteratorGetRP2LinesIterator> m({iterator});
@@ -98,6 +160,40 @@ XY principia__IteratorGetRP2LineXY(Iterator const* const iterator) {
       }));
 }
 
+int principia__IteratorGetRP2LinesXY(Iterator const* const iterator,
+                                     XY* const xy,
+                                     int const xy_size,
+                                     int* const line_ends,
+                                     int const line_ends_size,
+                                     int* const line_count) {
+  // NOTE: Do not journal!  The buffers are owned by the caller and cannot be
+  // replayed.
+  CHECK_NOTNULL(iterator);
+  CHECK_NOTNULL(line_count);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<RP2Lines<Length, Camera>> const*>(iterator));
+  RP2Lines<Length, Camera> const& rp2_lines = typed_iterator->container();
+
+  int point_count = 0;
+  for (auto const& rp2_line : rp2_lines) {
+    point_count += rp2_line.size();
+  }
+  *line_count = rp2_lines.size();
+  if (point_count > xy_size || *line_count > line_ends_size) {
+    return point_count;
+  }
+
+  int index = 0;
+  for (int i = 0; i < rp2_lines.size(); ++i) {
+    for (auto const& rp2_point : rp2_lines[i]) {
+      xy[index] = ToXY(rp2_point);
+      ++index;
+    }
+    line_ends[i] = index;
+  }
+  return point_count;
+}
+
 char const* principia__IteratorGetVesselGuid(Iterator const* const iterator) {
   journal::Method<journal::IteratorGetVesselGuid> m({iterator});
   auto const typed_iterator = check_not_null(
@@ -7,13 +7,14 @@
 #include <string>
 #include <type_traits>
 
+#include "base/duration_histogram.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
 
 namespace principia {
 namespace interface {
 
-using quantities::Infinity;
+using base::DurationHistogram;
 using quantities::Time;
 using quantities::si::Nano;
 using quantities::si::Second;
@@ -29,8 +30,9 @@ struct Monitor {
 
   int window_index = 0;
   Time total_Δt;
-  Time min_Δt = Infinity<Time>();
-  Time max_Δt = -Infinity<Time>();
+  DurationHistogram window_Δt;
+  // The statistics of the last complete window.
+  TimingStatistics last_window{};
 };
 
 static_assert(
@@ -62,25 +64,40 @@ void principia__MonitorStop(int const i) {
   Monitor& monitor = monitors[i];
   if (monitor.is_running) {
     monitor.is_running = false;
-    auto const Δt =
-        std::chrono::nanoseconds(
-            std::chrono::steady_clock::now() - monitor.start_time).count() *
-        Nano(Second);
-    monitor.min_Δt = std::min(monitor.min_Δt, Δt);
-    monitor.max_Δt = std::max(monitor.max_Δt, Δt);
+    auto const duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - monitor.start_time);
+    auto const Δt = duration.count() * Nano(Second);
+    monitor.window_Δt.Record(duration);
     monitor.total_Δt += Δt;
     ++monitor.window_index %= window_size;
     if (monitor.window_index == 0) {
+      auto const quantile = [&monitor](double const q) {
+        return monitor.window_Δt.Quantile(q).count() * Nano(Second);
+      };
+      Time const mean_Δt = monitor.total_Δt / window_size;
+      monitor.last_window = {/*calls=*/window_size,
+                             /*total=*/monitor.total_Δt / Second,
+                             /*self=*/monitor.total_Δt / Second,
+                             /*mean=*/mean_Δt / Second,
+                             /*p50=*/quantile(0.5) / Second,
+                             /*p99=*/quantile(0.99) / Second,
+                             /*p999=*/quantile(0.999) / Second,
+                             /*max=*/quantile(1) / Second};
       LOG(INFO) << "[Monitor " << i
                 << (monitor.name == nullptr ? "" : (": " + *monitor.name))
-                << "] min = " << monitor.min_Δt << ", max = " << monitor.max_Δt
-                << u8", μ = " << monitor.total_Δt / window_size;
-      monitor.min_Δt = Infinity<Time>();
-      monitor.max_Δt = -Infinity<Time>();
+                << u8"] μ = " << mean_Δt << ", p50 = " << quantile(0.5)
+                << ", p99 = " << quantile(0.99)
+                << ", p99.9 = " << quantile(0.999)
+                << ", max = " << quantile(1);
+      monitor.window_Δt.Reset();
       monitor.total_Δt = Time();
     }
   }
 }
 
+TimingStatistics principia__MonitorGetStatistics(int const i) {
+  return monitors[i].last_window;
+}
+
 }  // namespace interface
 }  // namespace principia
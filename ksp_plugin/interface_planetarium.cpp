@@ -1,6 +1,8 @@
 
 #include "ksp_plugin/interface.hpp"
 
+#include <utility>
+
 #include "geometry/affine_map.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -40,6 +42,7 @@ using quantities::si::ArcMinute;
 using quantities::si::Kilo;
 using quantities::si::Metre;
 using quantities::si::Radian;
+using quantities::si::Second;
 
 namespace {
 
@@ -63,26 +66,18 @@ RP2Lines<Length, Camera> PlotMethodN(
   }
 }
 
-}  // namespace
-
-Planetarium* principia__PlanetariumCreate(
-    Plugin const* const plugin,
-    XYZ const sun_world_position,
-    XYZ const xyz_opengl_camera_x_in_world,
-    XYZ const xyz_opengl_camera_y_in_world,
-    XYZ const xyz_opengl_camera_z_in_world,
-    XYZ const xyz_camera_position_in_world,
-    double const focal,
-    double const field_of_view) {
-  journal::Method<journal::PlanetariumCreate> m({plugin,
-                                                 sun_world_position,
-                                                 xyz_opengl_camera_x_in_world,
-                                                 xyz_opengl_camera_y_in_world,
-                                                 xyz_opengl_camera_z_in_world,
-                                                 xyz_camera_position_in_world,
-                                                 focal,
-                                                 field_of_view});
-  Renderer const& renderer = CHECK_NOTNULL(plugin)->renderer();
+// Returns the parameters and the perspective of a planetarium for the given
+// camera of the game.
+std::pair<Planetarium::Parameters, Perspective<Navigation, Camera>>
+ParametersAndPerspective(Plugin const& plugin,
+                         XYZ const sun_world_position,
+                         XYZ const xyz_opengl_camera_x_in_world,
+                         XYZ const xyz_opengl_camera_y_in_world,
+                         XYZ const xyz_opengl_camera_z_in_world,
+                         XYZ const xyz_camera_position_in_world,
+                         double const focal,
+                         double const field_of_view) {
+  Renderer const& renderer = plugin.renderer();
 
   Multivector<double, World, 1> const opengl_camera_x_in_world(
       FromXYZ(xyz_opengl_camera_x_in_world));
@@ -105,27 +100,93 @@ Planetarium* principia__PlanetariumCreate(
                                  camera_to_world_rotation.Forget());
   RigidTransformation<World, Navigation> const
       world_to_plotting_affine_map =
-          renderer.WorldToPlotting(plugin->CurrentTime(),
+          renderer.WorldToPlotting(plugin.CurrentTime(),
                                    FromXYZ<Position<World>>(sun_world_position),
-                                   plugin->PlanetariumRotation());
+                                   plugin.PlanetariumRotation());
 
   // The radius multiplier is appropriate for Olympus Mons, the largest mountain
   // in the solar system.
   // The angular resolution of the human eye is from
-  // https://en.wikipedia.org/wiki/Visual_acuity#Physiology
+  // https://en.wikipedia.org/wiki/Visual_acuity#Physiology.  The points of the
+  // lines that are not discernible at that resolution are removed, which
+  // reduces the number of vertices that go through the interface.
   constexpr Length const olympus_mons_peak = 21'230 * Metre;
   constexpr Length const mars_mean_radius = 3389.50 * Kilo(Metre);
   Planetarium::Parameters parameters(
       /*sphere_radius_multiplier=*/1.0 + olympus_mons_peak / mars_mean_radius,
       /*angular_resolution=*/0.4 * ArcMinute,
-      field_of_view * Radian);
+      field_of_view * Radian,
+      /*simplification_tolerance=*/0.4 * ArcMinute);
   Perspective<Navigation, Camera> perspective(
       world_to_plotting_affine_map * camera_to_world_affine_map,
       focal * Metre);
+  return {parameters, perspective};
+}
+
+}  // namespace
 
+Planetarium* principia__PlanetariumCreate(
+    Plugin const* const plugin,
+    XYZ const sun_world_position,
+    XYZ const xyz_opengl_camera_x_in_world,
+    XYZ const xyz_opengl_camera_y_in_world,
+    XYZ const xyz_opengl_camera_z_in_world,
+    XYZ const xyz_camera_position_in_world,
+    double const focal,
+    double const field_of_view) {
+  journal::Method<journal::PlanetariumCreate> m({plugin,
+                                                 sun_world_position,
+                                                 xyz_opengl_camera_x_in_world,
+                                                 xyz_opengl_camera_y_in_world,
+                                                 xyz_opengl_camera_z_in_world,
+                                                 xyz_camera_position_in_world,
+                                                 focal,
+                                                 field_of_view});
+  auto const [parameters, perspective] =
+      ParametersAndPerspective(*CHECK_NOTNULL(plugin),
+                               sun_world_position,
+                               xyz_opengl_camera_x_in_world,
+                               xyz_opengl_camera_y_in_world,
+                               xyz_opengl_camera_z_in_world,
+                               xyz_camera_position_in_world,
+                               focal,
+                               field_of_view);
   return m.Return(plugin->NewPlanetarium(parameters, perspective).release());
 }
 
+void principia__PlanetariumUpdate(
+    Planetarium* const planetarium,
+    Plugin const* const plugin,
+    XYZ const sun_world_position,
+    XYZ const xyz_opengl_camera_x_in_world,
+    XYZ const xyz_opengl_camera_y_in_world,
+    XYZ const xyz_opengl_camera_z_in_world,
+    XYZ const xyz_camera_position_in_world,
+    double const focal,
+    double const field_of_view) {
+  journal::Method<journal::PlanetariumUpdate> m({planetarium,
+                                                 plugin,
+                                                 sun_world_position,
+                                                 xyz_opengl_camera_x_in_world,
+                                                 xyz_opengl_camera_y_in_world,
+                                                 xyz_opengl_camera_z_in_world,
+                                                 xyz_camera_position_in_world,
+                                                 focal,
+                                                 field_of_view});
+  CHECK_NOTNULL(planetarium);
+  auto const [parameters, perspective] =
+      ParametersAndPerspective(*CHECK_NOTNULL(plugin),
+                               sun_world_position,
+                               xyz_opengl_camera_x_in_world,
+                               xyz_opengl_camera_y_in_world,
+                               xyz_opengl_camera_z_in_world,
+                               xyz_camera_position_in_world,
+                               focal,
+                               field_of_view);
+  plugin->UpdatePlanetarium(parameters, perspective, planetarium);
+  return m.Return();
+}
+
 void principia__PlanetariumDelete(
     Planetarium const** const planetarium) {
   journal::Method<journal::PlanetariumDelete> m({planetarium}, {planetarium});
@@ -147,11 +208,20 @@ Iterator* principia__PlanetariumPlotFlightPlanSegment(
                                                                 index});
   CHECK_NOTNULL(plugin);
   CHECK_NOTNULL(planetarium);
-  Vessel const& vessel = *plugin->GetVessel(vessel_guid);
-  CHECK(vessel.has_flight_plan()) << vessel_guid;
+  CHECK(plugin->GetVessel(vessel_guid)->has_flight_plan()) << vessel_guid;
+  // The snapshot was taken when |planetarium| was created; the flight plan may
+  // have been created or changed since, in which case we plot what the
+  // snapshot has and the next frame catches up.
+  auto const snapshot = plugin->render_snapshot();
+  CHECK(snapshot != nullptr);
+  if (!snapshot->has_vessel(vessel_guid) ||
+      index >= snapshot->number_of_flight_plan_segments(vessel_guid)) {
+    return m.Return(new TypedIterator<RP2Lines<Length, Camera>>({}));
+  }
   DiscreteTrajectory<Barycentric>::Iterator segment_begin;
   DiscreteTrajectory<Barycentric>::Iterator segment_end;
-  vessel.flight_plan().GetSegment(index, segment_begin, segment_end);
+  snapshot->GetFlightPlanSegment(
+      vessel_guid, index, segment_begin, segment_end);
   RP2Lines<Length, Camera> rp2_lines;
   // TODO(egg): this is ugly; we should centralize rendering.
   // If this is a burn and we cannot render the beginning of the burn, we
@@ -164,12 +234,31 @@ Iterator* principia__PlanetariumPlotFlightPlanSegment(
                              method,
                              segment_begin,
                              segment_end,
-                             plugin->CurrentTime(),
+                             snapshot->time(),
                              /*reverse=*/false);
   }
   return m.Return(new TypedIterator<RP2Lines<Length, Camera>>(rp2_lines));
 }
 
+Iterator* principia__PlanetariumPlotCelestialPastTrajectory(
+    Planetarium const* const planetarium,
+    Plugin const* const plugin,
+    int const celestial_index,
+    double const max_history_length) {
+  journal::Method<journal::PlanetariumPlotCelestialPastTrajectory> m(
+      {planetarium, plugin, celestial_index, max_history_length});
+  CHECK_NOTNULL(plugin);
+  CHECK_NOTNULL(planetarium);
+  Instant const now = plugin->CurrentTime();
+  auto const rp2_lines = planetarium->PlotContinuousTrajectory(
+      plugin->GetCelestial(celestial_index).trajectory(),
+      /*first_time=*/now - max_history_length * Second,
+      /*last_time=*/now,
+      now,
+      /*reverse=*/true);
+  return m.Return(new TypedIterator<RP2Lines<Length, Camera>>(rp2_lines));
+}
+
 Iterator* principia__PlanetariumPlotPrediction(
     Planetarium const* const planetarium,
     Plugin const* const plugin,
@@ -181,12 +270,17 @@ Iterator* principia__PlanetariumPlotPrediction(
                                                          vessel_guid});
   CHECK_NOTNULL(plugin);
   CHECK_NOTNULL(planetarium);
-  auto const& prediction = plugin->GetVessel(vessel_guid)->prediction();
+  auto const snapshot = plugin->render_snapshot();
+  CHECK(snapshot != nullptr);
+  if (!snapshot->has_vessel(vessel_guid)) {
+    return m.Return(new TypedIterator<RP2Lines<Length, Camera>>({}));
+  }
+  auto const& prediction = snapshot->prediction(vessel_guid);
   auto const rp2_lines = PlotMethodN(*planetarium,
                                      method,
-                                     prediction.Fork(),
+                                     prediction.Begin(),
                                      prediction.End(),
-                                     plugin->CurrentTime(),
+                                     snapshot->time(),
                                      /*reverse=*/false);
   return m.Return(new TypedIterator<RP2Lines<Length, Camera>>(rp2_lines));
 }
@@ -208,13 +302,25 @@ Iterator* principia__PlanetariumPlotPsychohistory(
   if (plugin->renderer().HasTargetVessel()) {
     return m.Return(new TypedIterator<RP2Lines<Length, Camera>>({}));
   } else {
-    auto const& psychohistory = plugin->GetVessel(vessel_guid)->psychohistory();
-    auto const rp2_lines = PlotMethodN(*planetarium,
-                                       method,
-                                       psychohistory.Begin(),
+    Vessel const& vessel = *plugin->GetVessel(vessel_guid);
+    auto const& psychohistory = vessel.psychohistory();
+    // The psychohistory only grows at its end from frame to frame, so method 2
+    // plots it incrementally.
+    auto const rp2_lines =
+        method == 2
+            ? planetarium->PlotMethod2(psychohistory.Begin(),
                                        psychohistory.End(),
+                                       vessel.psychohistory_stable_time(),
+                                       vessel.history_version(),
                                        plugin->CurrentTime(),
-                                       /*reverse=*/true);
+                                       /*reverse=*/true,
+                                       vessel.psychohistory_plotting_cache())
+            : PlotMethodN(*planetarium,
+                          method,
+                          psychohistory.Begin(),
+                          psychohistory.End(),
+                          plugin->CurrentTime(),
+                          /*reverse=*/true);
     return m.Return(new TypedIterator<RP2Lines<Length, Camera>>(rp2_lines));
   }
 }
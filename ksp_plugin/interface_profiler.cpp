@@ -0,0 +1,82 @@
+﻿
+#include "ksp_plugin/interface.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include "base/array.hpp"
+#include "base/profiling.hpp"
+#include "glog/logging.h"
+
+namespace principia {
+namespace interface {
+
+using base::Profiler;
+using base::ProfilingPhase;
+using base::ProfilingPhaseName;
+using base::ProfilingStatistics;
+using base::UniqueArray;
+using base::profiling_phases;
+
+namespace {
+
+TimingStatistics ToTimingStatistics(ProfilingStatistics const& statistics) {
+  auto const seconds = [](std::chrono::nanoseconds const duration) {
+    return std::chrono::duration<double>(duration).count();
+  };
+  auto const& histogram = statistics.histogram;
+  return {/*calls=*/statistics.calls,
+          /*total=*/seconds(statistics.duration),
+          /*self=*/seconds(statistics.self_duration),
+          /*mean=*/statistics.calls == 0
+              ? 0
+              : seconds(statistics.duration) / statistics.calls,
+          /*p50=*/seconds(histogram.Quantile(0.5)),
+          /*p99=*/seconds(histogram.Quantile(0.99)),
+          /*p999=*/seconds(histogram.Quantile(0.999)),
+          /*max=*/seconds(histogram.Quantile(1))};
+}
+
+}  // namespace
+
+// No journalling, like for the monitors: these functions only change the state
+// of the profiler and have no effect on the plugin.
+
+void principia__ProfilerSetEnabled(bool const enabled) {
+  Profiler::SetEnabled(enabled);
+}
+
+void principia__ProfilerReset() {
+  Profiler::Reset();
+}
+
+char const* principia__ProfilerGetReport() {
+  std::string const report = Profiler::Report();
+  // Ownership will be transfered to the marshmallow.
+  UniqueArray<char> allocated_report(report.size() + 1);
+  std::memcpy(allocated_report.data.get(), report.data(), report.size() + 1);
+  return allocated_report.data.release();
+}
+
+int principia__ProfilerGetSnapshot(TimingStatistics* const statistics,
+                                   int const statistics_size) {
+  if (statistics_size >= profiling_phases) {
+    auto const all_statistics = Profiler::Statistics();
+    for (int i = 0; i < profiling_phases; ++i) {
+      statistics[i] = ToTimingStatistics(all_statistics[i]);
+    }
+  }
+  return profiling_phases;
+}
+
+char const* principia__ProfilerGetPhaseName(int const phase) {
+  return ProfilingPhaseName(static_cast<ProfilingPhase>(phase));
+}
+
+void principia__ProfilerLogReport() {
+  LOG(INFO) << "Profiling statistics:\n" << Profiler::Report();
+}
+
+}  // namespace interface
+}  // namespace principia
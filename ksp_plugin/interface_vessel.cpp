@@ -35,6 +35,14 @@ XYZ principia__VesselBinormal(Plugin const* const plugin,
   return m.Return(ToXYZ(plugin->VesselBinormal(vessel_guid)));
 }
 
+XYZ principia__VesselBinormalWithHandle(Plugin const* const plugin,
+                                        int const vessel_handle) {
+  journal::Method<journal::VesselBinormalWithHandle> m({plugin, vessel_handle});
+  CHECK_NOTNULL(plugin);
+  return m.Return(ToXYZ(
+      plugin->VesselBinormal(*plugin->GetVesselWithHandle(vessel_handle))));
+}
+
 // Calls |plugin->VesselFromParent| with the arguments given.
 // |plugin| must not be null.  No transfer of ownership.
 QP principia__VesselFromParent(Plugin const* const plugin,
@@ -46,6 +54,27 @@ QP principia__VesselFromParent(Plugin const* const plugin,
   return m.Return(ToQP(plugin->VesselFromParent(parent_index, vessel_guid)));
 }
 
+// Same as |principia__VesselFromParent|, for the vessel designated by
+// |vessel_handle|.
+QP principia__VesselFromParentWithHandle(Plugin const* const plugin,
+                                         int const parent_index,
+                                         int const vessel_handle) {
+  journal::Method<journal::VesselFromParentWithHandle> m(
+      {plugin, parent_index, vessel_handle});
+  CHECK_NOTNULL(plugin);
+  return m.Return(ToQP(plugin->VesselFromParent(
+      parent_index, *plugin->GetVesselWithHandle(vessel_handle))));
+}
+
+// Returns a handle that may be passed to the |...WithHandle| functions instead
+// of |vessel_guid|.  The vessel must be in the plugin.
+int principia__VesselGetHandle(Plugin* const plugin,
+                               char const* const vessel_guid) {
+  journal::Method<journal::VesselGetHandle> m({plugin, vessel_guid});
+  CHECK_NOTNULL(plugin);
+  return m.Return(plugin->GetVesselHandle(vessel_guid));
+}
+
 AdaptiveStepParameters principia__VesselGetPredictionAdaptiveStepParameters(
     Plugin const* const plugin,
     char const* const vessel_guid) {
@@ -56,6 +85,25 @@ AdaptiveStepParameters principia__VesselGetPredictionAdaptiveStepParameters(
       plugin->GetVessel(vessel_guid)->prediction_adaptive_step_parameters()));
 }
 
+AdaptiveStepStatistics principia__VesselGetPredictionStatistics(
+    Plugin const* const plugin,
+    char const* const vessel_guid) {
+  journal::Method<journal::VesselGetPredictionStatistics> m(
+      {plugin, vessel_guid});
+  CHECK_NOTNULL(plugin);
+  return m.Return(ToAdaptiveStepStatistics(
+      plugin->GetVessel(vessel_guid)->prediction_statistics()));
+}
+
+// Returns false if the vessel designated by |vessel_handle| has been removed
+// from the plugin, in which case the handle must not be used anymore.
+bool principia__VesselHandleIsValid(Plugin const* const plugin,
+                                    int const vessel_handle) {
+  journal::Method<journal::VesselHandleIsValid> m({plugin, vessel_handle});
+  CHECK_NOTNULL(plugin);
+  return m.Return(plugin->HasVesselWithHandle(vessel_handle));
+}
+
 XYZ principia__VesselNormal(Plugin const* const plugin,
                             char const* const vessel_guid) {
   journal::Method<journal::VesselNormal> m({plugin, vessel_guid});
@@ -63,6 +111,14 @@ XYZ principia__VesselNormal(Plugin const* const plugin,
   return m.Return(ToXYZ(plugin->VesselNormal(vessel_guid)));
 }
 
+XYZ principia__VesselNormalWithHandle(Plugin const* const plugin,
+                                      int const vessel_handle) {
+  journal::Method<journal::VesselNormalWithHandle> m({plugin, vessel_handle});
+  CHECK_NOTNULL(plugin);
+  return m.Return(ToXYZ(
+      plugin->VesselNormal(*plugin->GetVesselWithHandle(vessel_handle))));
+}
+
 void principia__VesselSetPredictionAdaptiveStepParameters(
     Plugin const* const plugin,
     char const* const vessel_guid,
@@ -83,6 +139,14 @@ XYZ principia__VesselTangent(Plugin const* const plugin,
   return m.Return(ToXYZ(plugin->VesselTangent(vessel_guid)));
 }
 
+XYZ principia__VesselTangentWithHandle(Plugin const* const plugin,
+                                       int const vessel_handle) {
+  journal::Method<journal::VesselTangentWithHandle> m({plugin, vessel_handle});
+  CHECK_NOTNULL(plugin);
+  return m.Return(ToXYZ(
+      plugin->VesselTangent(*plugin->GetVesselWithHandle(vessel_handle))));
+}
+
 XYZ principia__VesselVelocity(Plugin const* const plugin,
                               char const* const vessel_guid) {
   journal::Method<journal::VesselVelocity> m({plugin, vessel_guid});
@@ -90,5 +154,13 @@ XYZ principia__VesselVelocity(Plugin const* const plugin,
   return m.Return(ToXYZ(plugin->VesselVelocity(vessel_guid)));
 }
 
+XYZ principia__VesselVelocityWithHandle(Plugin const* const plugin,
+                                        int const vessel_handle) {
+  journal::Method<journal::VesselVelocityWithHandle> m({plugin, vessel_handle});
+  CHECK_NOTNULL(plugin);
+  return m.Return(ToXYZ(
+      plugin->VesselVelocity(*plugin->GetVesselWithHandle(vessel_handle))));
+}
+
 }  // namespace interface
 }  // namespace principia
@@ -42,6 +42,9 @@ class TypedIterator : public Iterator {
   void Reset() override;
   int Size() const override;
 
+  // The entire container, irrespective of the position of the iterator.
+  Container const& container() const;
+
  private:
   Container container_;
   typename Container::const_iterator iterator_;
@@ -69,6 +72,9 @@ class TypedIterator<DiscreteTrajectory<World>> : public Iterator {
   DiscreteTrajectory<World>::Iterator iterator() const;
   not_null<Plugin const*> plugin() const;
 
+  // The entire trajectory, irrespective of the position of the iterator.
+  DiscreteTrajectory<World> const& trajectory() const;
+
  private:
   not_null<std::unique_ptr<DiscreteTrajectory<World>>> trajectory_;
   DiscreteTrajectory<World>::Iterator iterator_;
@@ -40,6 +40,11 @@ int TypedIterator<Container>::Size() const {
   return container_.size();
 }
 
+template<typename Container>
+Container const& TypedIterator<Container>::container() const {
+  return container_;
+}
+
 inline TypedIterator<DiscreteTrajectory<World>>::TypedIterator(
     not_null<std::unique_ptr<DiscreteTrajectory<World>>> trajectory,
     not_null<Plugin const*> const plugin)
@@ -83,5 +88,10 @@ inline not_null<Plugin const*> TypedIterator<
   return plugin_;
 }
 
+inline DiscreteTrajectory<World> const& TypedIterator<
+    DiscreteTrajectory<World>>::trajectory() const {
+  return *trajectory_;
+}
+
 }  // namespace ksp_plugin
 }  // namespace principia
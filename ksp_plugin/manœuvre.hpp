@@ -5,6 +5,7 @@
 
 #include "geometry/named_quantities.hpp"
 #include "geometry/orthogonal_map.hpp"
+#include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/dynamic_frame.hpp"
 #include "physics/ephemeris.hpp"
@@ -19,6 +20,7 @@ using base::not_null;
 using geometry::Instant;
 using geometry::OrthogonalMap;
 using geometry::Vector;
+using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::DynamicFrame;
 using physics::Ephemeris;
@@ -115,6 +117,18 @@ class Manœuvre {
   typename Ephemeris<InertialFrame>::IntrinsicAcceleration
   IntrinsicAcceleration() const;
 
+  // Intensity and timing must have been set.  The acceleration of this
+  // manœuvre, but with the |direction()| taken in the Frenet frame at |time| of
+  // a trajectory having the given |degrees_of_freedom|.  This is used to
+  // approximate a manœuvre that is not inertially fixed by a sequence of
+  // inertially fixed pieces, without building a manœuvre (and thus a frame)
+  // for each of them.  The coasting trajectory is not used.  The result is
+  // valid until |*this| is destroyed.
+  typename Ephemeris<InertialFrame>::IntrinsicAcceleration
+  IntrinsicAccelerationFixedAt(
+      Instant const& time,
+      DegreesOfFreedom<InertialFrame> const& degrees_of_freedom) const;
+
   // Intensity and timing must have been set.  |coasting_trajectory| is neither
   // written nor read.
   void WriteToMessage(not_null<serialization::Manoeuvre*> message) const;
@@ -123,6 +137,18 @@ class Manœuvre {
       not_null<Ephemeris<InertialFrame>*> ephemeris);
 
  private:
+  // The Frenet frame at |time| of a trajectory having the given
+  // |degrees_of_freedom|.
+  OrthogonalMap<Frenet<Frame>, InertialFrame> FrenetFrame(
+      Instant const& time,
+      DegreesOfFreedom<InertialFrame> const& degrees_of_freedom) const;
+
+  // The acceleration along |inertial_direction| with the thrust and mass flow
+  // of this manœuvre.
+  typename Ephemeris<InertialFrame>::IntrinsicAcceleration
+  IntrinsicAcceleration(
+      Vector<double, InertialFrame> const& inertial_direction) const;
+
   Force const thrust_;
   Mass const initial_mass_;
   SpecificImpulse const specific_impulse_;
@@ -164,14 +164,7 @@ OrthogonalMap<Frenet<Frame>, InertialFrame>
   typename DiscreteTrajectory<InertialFrame>::Iterator const it =
       coasting_trajectory_->Find(initial_time());
   CHECK(it != coasting_trajectory_->End());
-  RigidMotion<InertialFrame, Frame> const to_frame_at_initial_time =
-      frame_->ToThisFrameAtTime(initial_time());
-  OrthogonalMap<Frame, InertialFrame> const from_frame_at_initial_time =
-      to_frame_at_initial_time.orthogonal_map().Inverse();
-  Rotation<Frenet<Frame>, Frame> const from_frenet_frame = frame_->FrenetFrame(
-      initial_time(),
-      to_frame_at_initial_time(it.degrees_of_freedom()));
-  return from_frame_at_initial_time * from_frenet_frame.Forget();
+  return FrenetFrame(initial_time(), it.degrees_of_freedom());
 }
 
 template<typename InertialFrame, typename Frame>
@@ -182,16 +175,16 @@ bool Manœuvre<InertialFrame, Frame>::is_inertially_fixed() const {
 template<typename InertialFrame, typename Frame>
 typename Ephemeris<InertialFrame>::IntrinsicAcceleration
     Manœuvre<InertialFrame, Frame>::IntrinsicAcceleration() const {
-  Vector<double, InertialFrame> const inertial_direction = InertialDirection();
-  return [this, inertial_direction](
-             Instant const& time) -> Vector<Acceleration, InertialFrame> {
-    if (time >= initial_time() && time <= final_time()) {
-      return inertial_direction * thrust_ /
-             (initial_mass_ - (time - initial_time()) * mass_flow());
-    } else {
-      return Vector<Acceleration, InertialFrame>();
-    }
-  };
+  return IntrinsicAcceleration(InertialDirection());
+}
+
+template<typename InertialFrame, typename Frame>
+typename Ephemeris<InertialFrame>::IntrinsicAcceleration
+Manœuvre<InertialFrame, Frame>::IntrinsicAccelerationFixedAt(
+    Instant const& time,
+    DegreesOfFreedom<InertialFrame> const& degrees_of_freedom) const {
+  return IntrinsicAcceleration(
+      FrenetFrame(time, degrees_of_freedom)(direction_));
 }
 
 template<typename InertialFrame, typename Frame>
@@ -224,6 +217,36 @@ Manœuvre<InertialFrame, Frame> Manœuvre<InertialFrame, Frame>::ReadFromMessage
   return manœuvre;
 }
 
+template<typename InertialFrame, typename Frame>
+OrthogonalMap<Frenet<Frame>, InertialFrame>
+Manœuvre<InertialFrame, Frame>::FrenetFrame(
+    Instant const& time,
+    DegreesOfFreedom<InertialFrame> const& degrees_of_freedom) const {
+  RigidMotion<InertialFrame, Frame> const to_frame_at_time =
+      frame_->ToThisFrameAtTime(time);
+  OrthogonalMap<Frame, InertialFrame> const from_frame_at_time =
+      to_frame_at_time.orthogonal_map().Inverse();
+  Rotation<Frenet<Frame>, Frame> const from_frenet_frame = frame_->FrenetFrame(
+      time,
+      to_frame_at_time(degrees_of_freedom));
+  return from_frame_at_time * from_frenet_frame.Forget();
+}
+
+template<typename InertialFrame, typename Frame>
+typename Ephemeris<InertialFrame>::IntrinsicAcceleration
+Manœuvre<InertialFrame, Frame>::IntrinsicAcceleration(
+    Vector<double, InertialFrame> const& inertial_direction) const {
+  return [this, inertial_direction](
+             Instant const& time) -> Vector<Acceleration, InertialFrame> {
+    if (time >= initial_time() && time <= final_time()) {
+      return inertial_direction * thrust_ /
+             (initial_mass_ - (time - initial_time()) * mass_flow());
+    } else {
+      return Vector<Acceleration, InertialFrame>();
+    }
+  };
+}
+
 }  // namespace internal_manœuvre
 }  // namespace ksp_plugin
 }  // namespace principia
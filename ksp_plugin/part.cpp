@@ -80,16 +80,19 @@ Part::degrees_of_freedom() const {
 }
 
 DiscreteTrajectory<Barycentric>::Iterator Part::history_begin() {
+  CopyPileUpTail();
   // Make sure that we skip the point of the prehistory.
   auto it = history_->Fork();
   return ++it;
 }
 
 DiscreteTrajectory<Barycentric>::Iterator Part::history_end() {
+  CopyPileUpTail();
   return history_->End();
 }
 
 DiscreteTrajectory<Barycentric>::Iterator Part::psychohistory_begin() {
+  CopyPileUpTail();
   if (psychohistory_ == nullptr) {
     psychohistory_ = history_->NewForkAtLast();
   }
@@ -99,6 +102,7 @@ DiscreteTrajectory<Barycentric>::Iterator Part::psychohistory_begin() {
 }
 
 DiscreteTrajectory<Barycentric>::Iterator Part::psychohistory_end() {
+  CopyPileUpTail();
   if (psychohistory_ == nullptr) {
     psychohistory_ = history_->NewForkAtLast();
   }
@@ -108,6 +112,7 @@ DiscreteTrajectory<Barycentric>::Iterator Part::psychohistory_end() {
 void Part::AppendToHistory(
     Instant const& time,
     DegreesOfFreedom<Barycentric> const& degrees_of_freedom) {
+  CopyPileUpTail();
   if (psychohistory_ != nullptr) {
     history_->DeleteFork(psychohistory_);
   }
@@ -117,13 +122,44 @@ void Part::AppendToHistory(
 void Part::AppendToPsychohistory(
     Instant const& time,
     DegreesOfFreedom<Barycentric> const& degrees_of_freedom) {
+  CopyPileUpTail();
   if (psychohistory_ == nullptr) {
     psychohistory_ = history_->NewForkAtLast();
   }
   psychohistory_->Append(time, degrees_of_freedom);
 }
 
+void Part::AppendToHistories(
+    std::shared_ptr<PileUpTail const> const& tail,
+    RelativeDegreesOfFreedom<Barycentric> const& offset) {
+  CopyPileUpTail();
+  bool trajectories_are_empty = history_begin() == history_end();
+  if (psychohistory_ != nullptr) {
+    auto it = psychohistory_->Fork();
+    ++it;
+    trajectories_are_empty &= it == psychohistory_->End();
+  }
+  pile_up_tail_ = tail;
+  pile_up_tail_offset_ = offset;
+  // If the trajectories are not empty, the new points cannot be shared and
+  // must be appended after theirs.
+  if (!trajectories_are_empty) {
+    CopyPileUpTail();
+  }
+}
+
+PileUpTail const* Part::pile_up_tail() const {
+  return pile_up_tail_.get();
+}
+
+RelativeDegreesOfFreedom<Barycentric> const&
+Part::pile_up_tail_offset() const {
+  CHECK(pile_up_tail_ != nullptr) << ShortDebugString();
+  return pile_up_tail_offset_;
+}
+
 void Part::ClearHistory() {
+  pile_up_tail_.reset();
   if (psychohistory_ != nullptr) {
     history_->DeleteFork(psychohistory_);
   }
@@ -157,6 +193,7 @@ void Part::reset_containing_pile_up() {
 void Part::WriteToMessage(not_null<serialization::Part*> const message,
                           PileUp::SerializationIndexForPileUp const&
                               serialization_index_for_pile_up) const {
+  CopyPileUpTail();
   message->set_part_id(part_id_);
   message->set_name(name_);
   mass_.WriteToMessage(message->mutable_mass());
@@ -215,6 +252,27 @@ void Part::FillContainingPileUpFromMessage(
   }
 }
 
+void Part::CopyPileUpTail() const {
+  if (pile_up_tail_ == nullptr) {
+    return;
+  }
+  // Reset the tail first, the trajectories are appended to directly.
+  auto const tail = std::move(pile_up_tail_);
+  pile_up_tail_.reset();
+  if (!tail->history.empty() && psychohistory_ != nullptr) {
+    history_->DeleteFork(psychohistory_);
+  }
+  for (auto const& [time, degrees_of_freedom] : tail->history) {
+    history_->Append(time, degrees_of_freedom + pile_up_tail_offset_);
+  }
+  if (!tail->psychohistory.empty() && psychohistory_ == nullptr) {
+    psychohistory_ = history_->NewForkAtLast();
+  }
+  for (auto const& [time, degrees_of_freedom] : tail->psychohistory) {
+    psychohistory_->Append(time, degrees_of_freedom + pile_up_tail_offset_);
+  }
+}
+
 std::string Part::ShortDebugString() const {
   Array<std::uint8_t const> id_bytes(
       reinterpret_cast<std::uint8_t const*>(&part_id_), sizeof(part_id_));
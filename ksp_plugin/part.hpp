@@ -31,6 +31,7 @@ using geometry::Vector;
 using geometry::Velocity;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
+using physics::RelativeDegreesOfFreedom;
 using quantities::Force;
 using quantities::Mass;
 
@@ -89,6 +90,21 @@ class Part final {
       Instant const& time,
       DegreesOfFreedom<Barycentric> const& degrees_of_freedom);
 
+  // Appends the points of |tail->history| and |tail->psychohistory|, offset
+  // by |offset|, to the history and psychohistory of this part, as if by
+  // |AppendToHistory| and |AppendToPsychohistory|.  If the trajectories of the
+  // part are empty, the points are only copied into them when they are
+  // accessed; until then, |pile_up_tail| returns the |tail|.
+  void AppendToHistories(std::shared_ptr<PileUpTail const> const& tail,
+                         RelativeDegreesOfFreedom<Barycentric> const& offset);
+
+  // If the history and psychohistory of this part consist exactly of the
+  // points of a |PileUpTail| that have not been copied yet, returns that tail;
+  // otherwise returns null.  The points of the part are those of the tail
+  // offset by |pile_up_tail_offset()|.
+  PileUpTail const* pile_up_tail() const;
+  RelativeDegreesOfFreedom<Barycentric> const& pile_up_tail_offset() const;
+
   // Clears the history and psychohistory.
   void ClearHistory();
 
@@ -121,6 +137,10 @@ class Part final {
   std::string ShortDebugString() const;
 
  private:
+  // Copies the points of the |pile_up_tail_|, if any, into the |history_| and
+  // |psychohistory_|, and resets it.
+  void CopyPileUpTail() const;
+
   PartId const part_id_;
   std::string const name_;
   Mass mass_;
@@ -143,7 +163,15 @@ class Part final {
   // The |psychohistory_| is destroyed by |AppendToHistory| and is recreated
   // as needed by |AppendToPsychohistory| or by |tail|.  That's because
   // |NewForkAtLast| is relatively expensive so we only call it when necessary.
-  DiscreteTrajectory<Barycentric>* psychohistory_ = nullptr;
+  mutable DiscreteTrajectory<Barycentric>* psychohistory_ = nullptr;
+
+  // Points appended by |AppendToHistories| that have not been copied into the
+  // |history_| and |psychohistory_| yet.  These trajectories are empty when
+  // the |pile_up_tail_| is not null.  This avoids copying the points of a
+  // pile-up into each of its parts when they are consumed by
+  // |Vessel::AdvanceTime| directly from the tail.
+  mutable std::shared_ptr<PileUpTail const> pile_up_tail_;
+  RelativeDegreesOfFreedom<Barycentric> pile_up_tail_offset_;
 
   // TODO(egg): we may want to keep track of the moment of inertia, angular
   // momentum, etc.
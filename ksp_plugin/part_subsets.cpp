@@ -37,11 +37,20 @@ void Subset<Part>::Properties::MergeWith(Properties& other) {
     missing_ -= other.parts_.size();
     CHECK_GE(missing_, 0);
   } else {
-    for (auto const part : parts_) {
-      part->reset_containing_pile_up();
+    // Either all the parts of a subset are in the same existing |PileUp|, or
+    // none of them is piled up, so the parts only need to be walked if their
+    // |PileUp| is being broken.  This ensures that each part is walked at most
+    // once per collection, instead of at each union, which was quadratic in
+    // the number of parts of a vessel that is not a |PileUp|.
+    if (SubsetOfExistingPileUp()) {
+      for (auto const part : parts_) {
+        part->reset_containing_pile_up();
+      }
     }
-    for (auto const part : other.parts_) {
-      part->reset_containing_pile_up();
+    if (other.SubsetOfExistingPileUp()) {
+      for (auto const part : other.parts_) {
+        part->reset_containing_pile_up();
+      }
     }
   }
   parts_.splice(parts_.end(), other.parts_);
@@ -1,9 +1,11 @@
 ﻿
 #include "ksp_plugin/pile_up.hpp"
 
+#include <algorithm>
 #include <functional>
 #include <list>
 #include <map>
+#include <vector>
 
 #include "base/map_util.hpp"
 #include "geometry/identity.hpp"
@@ -66,9 +68,9 @@ PileUp::PileUp(
           Identity<Barycentric, RigidPileUp>().Forget()},
       AngularVelocity<Barycentric>{},
       barycentre.velocity()};
+  actual_part_degrees_of_freedom_.reserve(parts_.size());
   for (not_null<Part*> const part : parts_) {
-    actual_part_degrees_of_freedom_.emplace(
-        part,
+    actual_part_degrees_of_freedom_.push_back(
         barycentric_to_pile_up(part->degrees_of_freedom()));
   }
   psychohistory_ = history_->NewForkAtLast();
@@ -76,6 +78,9 @@ PileUp::PileUp(
 
 PileUp::~PileUp() {
   LOG(INFO) << "Destroying pile up at " << this;
+  if (speculation_.valid()) {
+    speculation_.wait();
+  }
   if (deletion_callback_ != nullptr) {
     deletion_callback_();
   }
@@ -87,6 +92,7 @@ void PileUp::set_mass(Mass const& mass) {
 
 void PileUp::set_intrinsic_force(
     Vector<Force, Barycentric> const& intrinsic_force) {
+  std::lock_guard<std::mutex> l(*lock_);
   intrinsic_force_ = intrinsic_force;
 }
 
@@ -117,9 +123,10 @@ void PileUp::NudgeParts() const {
       AngularVelocity<Barycentric>(),
       actual_centre_of_mass.velocity()};
   auto const pile_up_to_barycentric = barycentric_to_pile_up.Inverse();
+  auto actual_it = actual_part_degrees_of_freedom_.cbegin();
   for (not_null<Part*> const part : parts_) {
-    part->set_degrees_of_freedom(pile_up_to_barycentric(
-        FindOrDie(actual_part_degrees_of_freedom_, part)));
+    part->set_degrees_of_freedom(pile_up_to_barycentric(*actual_it));
+    ++actual_it;
   }
 }
 
@@ -134,19 +141,75 @@ Status PileUp::DeformAndAdvanceTime(Instant const& t) {
   return status;
 }
 
+std::shared_future<Status> PileUp::DeformAndAdvanceTimeOnce(
+    Instant const& t,
+    ThreadPool<Status>& thread_pool) {
+  if (deform_and_advance_time_once_t_ != t) {
+    deform_and_advance_time_once_t_ = t;
+    deform_and_advance_time_once_future_ =
+        thread_pool.Add([this, t]() { return DeformAndAdvanceTime(t); })
+            .share();
+  }
+  return deform_and_advance_time_once_future_;
+}
+
+void PileUp::Speculate(Instant const& t) {
+  std::lock_guard<std::mutex> l(*lock_);
+  if (intrinsic_force_ != Vector<Force, Barycentric>{} ||
+      fixed_instance_ == nullptr ||
+      history_->last().time() >= t) {
+    return;
+  }
+  // The status is dropped: if the integration fails, it fails again when
+  // |AdvanceTime| reaches the same point, and the error is reported then.
+  ephemeris_->FlowWithFixedStep(t, *fixed_instance_);
+}
+
+void PileUp::SpeculateAsynchronously(Instant const& t,
+                                     ThreadPool<Status>& thread_pool) {
+  speculation_ = thread_pool.Add([this, t]() {
+    Speculate(t);
+    return Status::OK;
+  });
+}
+
 void PileUp::WriteToMessage(not_null<serialization::PileUp*> message) const {
+  std::lock_guard<std::mutex> l(*lock_);
   for (not_null<Part*> const part : parts_) {
     message->add_part_id(part->part_id());
   }
   mass_.WriteToMessage(message->mutable_mass());
   intrinsic_force_.WriteToMessage(message->mutable_intrinsic_force());
-  history_->WriteToMessage(message->mutable_history(),
-                           /*forks=*/{psychohistory_});
-  for (auto const& pair : actual_part_degrees_of_freedom_) {
-    auto const part = pair.first;
-    auto const& degrees_of_freedom = pair.second;
-    degrees_of_freedom.WriteToMessage(&(
+  // The points of the |history_| after the fork of the |psychohistory_|, if
+  // any, were computed by |Speculate| and are not serialized: they would not be
+  // recognized as speculative after deserialization.  The copy is cheap since
+  // |AdvanceTime| forgets the points of the |history_| before the fork.
+  Instant const psychohistory_fork_time = psychohistory_->Fork().time();
+  if (history_->last().time() > psychohistory_fork_time) {
+    auto const history =
+        make_not_null_unique<DiscreteTrajectory<Barycentric>>();
+    for (auto it = history_->Begin(); it.time() <= psychohistory_fork_time;
+         ++it) {
+      history->Append(it.time(), it.degrees_of_freedom());
+    }
+    DiscreteTrajectory<Barycentric>* const psychohistory =
+        history->NewForkAtLast();
+    auto const psychohistory_end = psychohistory_->End();
+    auto it = psychohistory_->Fork();
+    for (++it; it != psychohistory_end; ++it) {
+      psychohistory->Append(it.time(), it.degrees_of_freedom());
+    }
+    history->WriteToMessage(message->mutable_history(),
+                            /*forks=*/{psychohistory});
+  } else {
+    history_->WriteToMessage(message->mutable_history(),
+                             /*forks=*/{psychohistory_});
+  }
+  auto actual_it = actual_part_degrees_of_freedom_.cbegin();
+  for (not_null<Part*> const part : parts_) {
+    actual_it->WriteToMessage(&(
         (*message->mutable_actual_part_degrees_of_freedom())[part->part_id()]));
+    ++actual_it;
   }
   for (auto const& pair : apparent_part_degrees_of_freedom_) {
     auto const part = pair.first;
@@ -234,12 +297,11 @@ not_null<std::unique_ptr<PileUp>> PileUp::ReadFromMessage(
   pile_up->mass_ = Mass::ReadFromMessage(message.mass());
   pile_up->intrinsic_force_ =
       Vector<Force, Barycentric>::ReadFromMessage(message.intrinsic_force());
-  for (auto const& pair : message.actual_part_degrees_of_freedom()) {
-    std::uint32_t const part_id = pair.first;
-    serialization::Pair const& degrees_of_freedom = pair.second;
-    pile_up->actual_part_degrees_of_freedom_.emplace(
-        part_id_to_part(part_id),
-        DegreesOfFreedom<RigidPileUp>::ReadFromMessage(degrees_of_freedom));
+  pile_up->actual_part_degrees_of_freedom_.reserve(pile_up->parts_.size());
+  for (not_null<Part*> const part : pile_up->parts_) {
+    pile_up->actual_part_degrees_of_freedom_.push_back(
+        DegreesOfFreedom<RigidPileUp>::ReadFromMessage(FindOrDie(
+            message.actual_part_degrees_of_freedom(), part->part_id())));
   }
   for (auto const& pair : message.apparent_part_degrees_of_freedom()) {
     std::uint32_t const part_id = pair.first;
@@ -307,12 +369,9 @@ void PileUp::DeformPileUpIfNeeded() {
 
   // Now update the positions of the parts in the pile-up frame.
   actual_part_degrees_of_freedom_.clear();
-  for (auto const& pair : apparent_part_degrees_of_freedom_) {
-    auto const part = pair.first;
-    auto const& apparent_part_degrees_of_freedom = pair.second;
-    actual_part_degrees_of_freedom_.emplace(
-        part,
-        apparent_bubble_to_pile_up_motion(apparent_part_degrees_of_freedom));
+  for (not_null<Part*> const part : parts_) {
+    actual_part_degrees_of_freedom_.push_back(apparent_bubble_to_pile_up_motion(
+        FindOrDie(apparent_part_degrees_of_freedom_, part)));
   }
   apparent_part_degrees_of_freedom_.clear();
 }
@@ -321,20 +380,64 @@ Status PileUp::AdvanceTime(Instant const& t) {
   CHECK_NOTNULL(psychohistory_);
 
   Status status;
-  auto const history_last = history_->last();
+  // The points of the |history_| after the fork of the |psychohistory_|, if
+  // any, were computed by |Speculate| and have not been appended to the parts.
+  // They are not valid if there is an intrinsic force.
+  Instant const psychohistory_fork_time = psychohistory_->Fork().time();
+  if (intrinsic_force_ != Vector<Force, Barycentric>{}) {
+    history_->ForgetAfter(psychohistory_fork_time);
+  }
+  auto const history_last = history_->Find(psychohistory_fork_time);
   if (intrinsic_force_ == Vector<Force, Barycentric>{}) {
     // Remove the fork.
     history_->DeleteFork(psychohistory_);
-    if (fixed_instance_ == nullptr) {
+    if (fixed_instance_ == nullptr && ballistic_history_begin_) {
+      // We are coasting after an intrinsic acceleration.  Integrate to the
+      // points of the fixed-step grid that fall before |t|; they are retained
+      // in the |history_| (see below) until there are enough of them to
+      // restart the |fixed_instance_| without a startup.
+      Time const& step = fixed_step_parameters_.step();
+      int const history_size = fixed_step_parameters_.history_size();
+      std::int64_t grid_points = history_->Size() - 1;
+      while (grid_points < history_size) {
+        Instant const next =
+            *ballistic_history_begin_ + (grid_points + 1) * step;
+        if (next > t) {
+          break;
+        }
+        CHECK_OK(ephemeris_->FlowWithAdaptiveStep(
+                     history_.get(),
+                     Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+                     next,
+                     adaptive_step_parameters_,
+                     Ephemeris<Barycentric>::unlimited_max_ephemeris_steps,
+                     /*last_point_only=*/true));
+        ++grid_points;
+      }
+      if (grid_points == history_size) {
+        fixed_instance_ = ephemeris_->NewInstanceWithHistory(
+            {history_.get()},
+            Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+            fixed_step_parameters_);
+        ballistic_history_begin_.reset();
+      }
+    } else if (fixed_instance_ == nullptr) {
       fixed_instance_ = ephemeris_->NewInstance(
           {history_.get()},
           Ephemeris<Barycentric>::NoIntrinsicAccelerations,
           fixed_step_parameters_);
     }
-    CHECK_LT(history_->last().time(), t);
-    status = ephemeris_->FlowWithFixedStep(t, *fixed_instance_);
-    psychohistory_ = history_->NewForkAtLast();
-    if (history_->last().time() < t) {
+    if (fixed_instance_ != nullptr && history_->last().time() < t) {
+      status = ephemeris_->FlowWithFixedStep(t, *fixed_instance_);
+    }
+    // Fork at the last point before |t|, the points after it, if any, were
+    // speculated.
+    auto fork_point = history_->LowerBound(t);
+    if (fork_point == history_->End() || fork_point.time() > t) {
+      --fork_point;
+    }
+    psychohistory_ = history_->NewForkWithoutCopy(fork_point.time());
+    if (psychohistory_->last().time() < t) {
       // Do not clear the |fixed_instance_| here, we will use it for the next
       // fixed-step integration.
       // TODO(phl): Consider not setting |last_point_only| below as we would be
@@ -377,49 +480,57 @@ Status PileUp::AdvanceTime(Instant const& t) {
                  Ephemeris<Barycentric>::unlimited_max_ephemeris_steps,
                  /*last_point_only=*/false));
     psychohistory_ = history_->NewForkAtLast();
+    ballistic_history_begin_ = history_->last().time();
   }
 
   CHECK_NOTNULL(psychohistory_);
 
   // Append the |history_| authoritatively to the parts' tails and the
   // |psychohistory_| non-authoritatively.
+  auto const tail = std::make_shared<PileUpTail>();
   auto const history_end = history_->End();
   auto const psychohistory_end = psychohistory_->End();
+  Instant const new_psychohistory_fork_time = psychohistory_->Fork().time();
   auto it = history_last;
-  for (++it; it != history_end; ++it) {
-    AppendToPart<&Part::AppendToHistory>(it);
+  for (++it; it != history_end && it.time() <= new_psychohistory_fork_time;
+       ++it) {
+    tail->history.emplace_back(it.time(), it.degrees_of_freedom());
   }
   it = psychohistory_->Fork();
   for (++it; it != psychohistory_end; ++it) {
-    AppendToPart<&Part::AppendToPsychohistory>(it);
+    tail->psychohistory.emplace_back(it.time(), it.degrees_of_freedom());
   }
-  history_->ForgetBefore(psychohistory_->Fork().time());
+  AppendToParts(tail);
+  // Keep the points that will be the history of the next |fixed_instance_|.
+  history_->ForgetBefore(
+      ballistic_history_begin_
+          ? std::min(*ballistic_history_begin_, psychohistory_->Fork().time())
+          : psychohistory_->Fork().time());
 
   return status;
 }
 
-template<PileUp::AppendToPartTrajectory append_to_part_trajectory>
-void PileUp::AppendToPart(DiscreteTrajectory<Barycentric>::Iterator it) const {
-  auto const& pile_up_dof = it.degrees_of_freedom();
-  RigidMotion<Barycentric, RigidPileUp> const barycentric_to_pile_up(
-      RigidTransformation<Barycentric, RigidPileUp>(
-          pile_up_dof.position(),
-          RigidPileUp::origin,
-          Identity<Barycentric, RigidPileUp>().Forget()),
-      AngularVelocity<Barycentric>{},
-      pile_up_dof.velocity());
-  auto const pile_up_to_barycentric = barycentric_to_pile_up.Inverse();
+void PileUp::AppendToParts(
+    std::shared_ptr<PileUpTail const> const& tail) const {
+  // The axes of |RigidPileUp| are those of |Barycentric| and it doesn't
+  // rotate, so the degrees of freedom of a part are those of the pile-up
+  // offset by the degrees of freedom of the part in |RigidPileUp|.
+  Identity<RigidPileUp, Barycentric> const pile_up_to_barycentric;
+  auto actual_it = actual_part_degrees_of_freedom_.cbegin();
   for (not_null<Part*> const part : parts_) {
-    (static_cast<Part*>(part)->*append_to_part_trajectory)(
-        it.time(),
-        pile_up_to_barycentric(
-            FindOrDie(actual_part_degrees_of_freedom_, part)));
+    RelativeDegreesOfFreedom<Barycentric> const offset(
+        pile_up_to_barycentric(actual_it->position() - RigidPileUp::origin),
+        pile_up_to_barycentric(actual_it->velocity()));
+    part->AppendToHistories(tail, offset);
+    ++actual_it;
   }
 }
 
 PileUpFuture::PileUpFuture(not_null<PileUp const*> const pile_up,
-                           std::future<Status> future)
+                           not_null<Vessel*> const vessel,
+                           std::shared_future<Status> future)
     : pile_up(pile_up),
+      vessel(vessel),
       future(std::move(future)) {}
 
 }  // namespace internal_pile_up
@@ -5,10 +5,16 @@
 #include <future>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "base/not_null.hpp"
 #include "base/status.hpp"
+#include "base/thread_pool.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "geometry/grassmann.hpp"
 #include "integrators/integrators.hpp"
 #include "physics/discrete_trajectory.hpp"
@@ -25,8 +31,10 @@ FORWARD_DECLARE_FROM(part, class, Part);
 
 namespace internal_pile_up {
 
+using base::Future;
 using base::not_null;
 using base::Status;
+using base::ThreadPool;
 using geometry::Frame;
 using geometry::Instant;
 using geometry::Vector;
@@ -39,6 +47,16 @@ using physics::RelativeDegreesOfFreedom;
 using quantities::Force;
 using quantities::Mass;
 
+// The points computed for the centre of mass of a |PileUp| by one call to
+// |PileUp::DeformAndAdvanceTime|, authoritative in |history| and
+// non-authoritative in |psychohistory|.  They are shared by all the parts of
+// the pile-up, each of which offsets them by its own (constant) degrees of
+// freedom, instead of being copied into the trajectory of each part.
+struct PileUpTail {
+  std::vector<std::pair<Instant, DegreesOfFreedom<Barycentric>>> history;
+  std::vector<std::pair<Instant, DegreesOfFreedom<Barycentric>>> psychohistory;
+};
+
 // A |PileUp| handles a connected component of the graph of |Parts| under
 // physical contact.  It advances the history and psychohistory of its component
 // |Parts|, modeling them as a massless body at their centre of mass.
@@ -74,9 +92,34 @@ class PileUp {
   // Deforms the pile-up, advances the time, and nudges the parts, in sequence.
   // Does nothing if the psychohistory is already advanced beyond |t|.  Several
   // executions of this method may happen concurrently on multiple threads, but
-  // not concurrently with any other method of this class.
+  // not concurrently with any other method of this class except |Speculate|.
   Status DeformAndAdvanceTime(Instant const& t);
 
+  // Speculates that the next call to |DeformAndAdvanceTime| will be for a time
+  // close to |t|: if the pile-up is coasting with its |fixed_instance_|, the
+  // |history_| is integrated ahead to the last point of the fixed-step grid
+  // before |t|.  These points are only appended to the parts when the time
+  // reaches them, so the speculation doesn't change the results, it only
+  // removes work from the next call to |DeformAndAdvanceTime|.  Does nothing if
+  // the pile-up has an intrinsic force.
+  void Speculate(Instant const& t);
+
+  // Executes |Speculate(t)| asynchronously on |thread_pool|.  The execution may
+  // overlap with any method of this class; the destructor waits for it to
+  // complete.  This method must not be called concurrently with itself.
+  void SpeculateAsynchronously(Instant const& t,
+                               ThreadPool<Status>& thread_pool);
+
+  // Executes |DeformAndAdvanceTime(t)| asynchronously on |thread_pool|.  The
+  // first call for a given |t| adds the execution to |thread_pool|, the
+  // subsequent calls for the same |t| return a future sharing its result, so
+  // that the vessels of a pile-up that are caught up together wait for a
+  // single integration instead of contending for the pile-up.  This method
+  // must not be called concurrently with itself.
+  std::shared_future<Status> DeformAndAdvanceTimeOnce(
+      Instant const& t,
+      ThreadPool<Status>& thread_pool);
+
   // We'd like to return |not_null<std::shared_ptr<PileUp> const&|, but the
   // compiler gets confused when defining the corresponding lambda, and thinks
   // that we return a local variable even though we capture by reference.
@@ -94,11 +137,6 @@ class PileUp {
       std::function<void()> deletion_callback);
 
  private:
-  // A pointer to a member function of |Part| used to append a point to either
-  // trajectory (history or psychohistory).
-  using AppendToPartTrajectory =
-      void (Part::*)(Instant const&, DegreesOfFreedom<Barycentric> const&);
-
   // For deserialization.
   PileUp(std::list<not_null<Part*>>&& parts,
          Ephemeris<Barycentric>::AdaptiveStepParameters const&
@@ -133,12 +171,21 @@ class PileUp {
   // |DeformPileUpIfNeeded|.
   void NudgeParts() const;
 
-  template<AppendToPartTrajectory append_to_part_trajectory>
-  void AppendToPart(DiscreteTrajectory<Barycentric>::Iterator it) const;
+  // Appends the |tail| to the trajectories of all the parts, each offset by
+  // its degrees of freedom in |RigidPileUp|.  The cost is independent of the
+  // number of points in the |tail|.
+  void AppendToParts(std::shared_ptr<PileUpTail const> const& tail) const;
 
   // Wrapped in a |unique_ptr| to be moveable.
   not_null<std::unique_ptr<std::mutex>> lock_;
 
+  // The argument and result of the last call to |DeformAndAdvanceTimeOnce|.
+  std::optional<Instant> deform_and_advance_time_once_t_;
+  std::shared_future<Status> deform_and_advance_time_once_future_;
+
+  // The execution started by the last call to |SpeculateAsynchronously|.
+  Future<Status> speculation_;
+
   std::list<not_null<Part*>> parts_;
   not_null<Ephemeris<Barycentric>*> ephemeris_;
   Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters_;
@@ -152,17 +199,21 @@ class PileUp {
   // The |history_| is the past trajectory of the pile-up.  It is normally
   // integrated with a fixed step using |fixed_instance_|, except in the
   // presence of intrinsic acceleration.  It is authoritative in the sense that
-  // it is never going to change.
+  // it is never going to change.  After a call to |Speculate| it may extend
+  // beyond the fork of the |psychohistory_|, in which case the points after
+  // that fork have not been appended to the parts yet, and are discarded if an
+  // intrinsic force is applied.
   not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> history_;
 
   // The |psychohistory_| is the recent past trajectory of the pile-up.  Since
   // we need to draw something between the last point of the |history_| and the
   // current time, we must have a bit of trajectory that may not cover an entire
-  // fixed step.  This part is the |psychohistory_|, and it is forked at the end
-  // of the |history_|.  It is not authoritative in the sense that it may not
-  // match the |history_| that we'll ultimately compute.  The name comes from
-  // the fact that we are trying to predict the future, but since we are not as
-  // good as Hari Seldon we only do it over a short period of time.
+  // fixed step.  This part is the |psychohistory_|, and it is forked at the
+  // last point of the |history_| before the current time.  It is not
+  // authoritative in the sense that it may not match the |history_| that we'll
+  // ultimately compute.  The name comes from the fact that we are trying to
+  // predict the future, but since we are not as good as Hari Seldon we only do
+  // it over a short period of time.
   DiscreteTrajectory<Barycentric>* psychohistory_ = nullptr;
 
   // When present, this instance is used to integrate the trajectory of this
@@ -173,6 +224,15 @@ class PileUp {
       Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance>
       fixed_instance_;
 
+  // Set when the intrinsic acceleration vanishes, to the time at which it did.
+  // The |fixed_instance_| is then not restarted right away: the |history_| is
+  // integrated with an adaptive step to the points of the fixed-step grid that
+  // starts at that time, and these points are kept until there are enough of
+  // them to serve as the history of the new |fixed_instance_|.  This avoids
+  // the costly startup of multistep integrators after each burn.  Not
+  // serialized, a deserialized pile-up goes through the startup.
+  std::optional<Instant> ballistic_history_begin_;
+
   // The |PileUp| is seen as a (currently non-rotating) rigid body; the degrees
   // of freedom of the parts in the frame of that body can be set, however their
   // motion is not integrated; this is simply applied as an offset from the
@@ -184,7 +244,10 @@ class PileUp {
                             serialization::Frame::RIGID_PILE_UP,
                             /*frame_is_inertial=*/false>;
 
-  PartTo<DegreesOfFreedom<RigidPileUp>> actual_part_degrees_of_freedom_;
+  // The degrees of freedom of the parts in |RigidPileUp|, in the order of
+  // |parts_|, so that they can be used for each point of the trajectories
+  // without looking up the parts.
+  std::vector<DegreesOfFreedom<RigidPileUp>> actual_part_degrees_of_freedom_;
   PartTo<DegreesOfFreedom<ApparentBubble>> apparent_part_degrees_of_freedom_;
 
   // Called in the destructor.
@@ -193,17 +256,23 @@ class PileUp {
   friend class TestablePileUp;
 };
 
-// A convenient data object to track a pile-up and the result of integrating it.
+// A convenient data object to track a pile-up and the result of integrating it
+// on behalf of one of its vessels.  The |future| may be shared with the
+// |PileUpFuture|s of the other vessels of the pile-up.
 struct PileUpFuture {
-  PileUpFuture(not_null<PileUp const*> pile_up, std::future<Status> future);
+  PileUpFuture(not_null<PileUp const*> pile_up,
+               not_null<Vessel*> vessel,
+               std::shared_future<Status> future);
   not_null<PileUp const*> pile_up;
-  std::future<Status> future;
+  not_null<Vessel*> vessel;
+  std::shared_future<Status> future;
 };
 
 }  // namespace internal_pile_up
 
 using internal_pile_up::PileUp;
 using internal_pile_up::PileUpFuture;
+using internal_pile_up::PileUpTail;
 
 }  // namespace ksp_plugin
 }  // namespace principia
@@ -2,9 +2,13 @@
 #include "ksp_plugin/planetarium.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <mutex>
 #include <optional>
+#include <utility>
 #include <vector>
 
+#include "geometry/grassmann.hpp"
 #include "geometry/point.hpp"
 #include "physics/massive_body.hpp"
 #include "quantities/elementary_functions.hpp"
@@ -13,28 +17,37 @@ namespace principia {
 namespace ksp_plugin {
 namespace internal_planetarium {
 
-using geometry::Position;
-using geometry::RP2Line;
+using base::Future;
+using geometry::AngleBetween;
 using geometry::Sign;
+using geometry::Vector;
 using geometry::Velocity;
 using physics::MassiveBody;
+using quantities::ArcSin;
+using quantities::FastFourthRoot;
+using quantities::Inverse;
 using quantities::Pow;
 using quantities::Sin;
-using quantities::Sqrt;
 using quantities::Tan;
 using quantities::Time;
 
 namespace {
 constexpr int max_plot_method_2_steps = 10'000;
+// The number of segments of a discrete trajectory whose bounding sphere is
+// tested against the field of view by |ComputePlottableSegments|.
+constexpr std::int64_t field_of_view_culling_chunk_size = 64;
 }  // namespace
 
 Planetarium::Parameters::Parameters(double const sphere_radius_multiplier,
                                     Angle const& angular_resolution,
-                                    Angle const& field_of_view)
+                                    Angle const& field_of_view,
+                                    Angle const& simplification_tolerance)
     : sphere_radius_multiplier_(sphere_radius_multiplier),
       sin²_angular_resolution_(Pow<2>(Sin(angular_resolution))),
       tan_angular_resolution_(Tan(angular_resolution)),
-      tan_field_of_view_(Tan(field_of_view)) {}
+      tan_field_of_view_(Tan(field_of_view)),
+      field_of_view_(field_of_view),
+      tan_simplification_tolerance_(Tan(simplification_tolerance)) {}
 
 Planetarium::Planetarium(
     Parameters const& parameters,
@@ -46,6 +59,17 @@ Planetarium::Planetarium(
       ephemeris_(ephemeris),
       plotting_frame_(plotting_frame) {}
 
+void Planetarium::UpdatePerspective(
+    Parameters const& parameters,
+    Perspective<Navigation, Camera> const& perspective,
+    not_null<NavigationFrame const*> const plotting_frame) {
+  parameters_ = parameters;
+  perspective_ = perspective;
+  plotting_frame_ = plotting_frame;
+  std::lock_guard<std::mutex> l(plottable_spheres_lock_);
+  plottable_spheres_time_.reset();
+}
+
 RP2Lines<Length, Camera> Planetarium::PlotMethod0(
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
     DiscreteTrajectory<Barycentric>::Iterator const& end,
@@ -55,7 +79,7 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod0(
       begin.trajectory()->LowerBound(plotting_frame_->t_min());
   auto const plottable_end =
       begin.trajectory()->LowerBound(plotting_frame_->t_max());
-  auto const plottable_spheres = ComputePlottableSpheres(now);
+  auto const plottable_spheres = PlottableSpheres(now);
   auto const plottable_segments = ComputePlottableSegments(plottable_spheres,
                                                            plottable_begin,
                                                            plottable_end);
@@ -138,24 +162,185 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
     DiscreteTrajectory<Barycentric>::Iterator const& end,
     Instant const& now,
     bool const reverse) const {
-  RP2Lines<Length, Camera> lines;
   if (begin == end) {
+    return {};
+  }
+  auto last = end;
+  --last;
+
+  auto const begin_time = std::max(begin.time(), plotting_frame_->t_min());
+  auto const last_time = std::min(last.time(), plotting_frame_->t_max());
+  PlottedLines plotted;
+  AppendPlotMethod2(*begin.trajectory(),
+                    /*initial_time=*/reverse ? last_time : begin_time,
+                    /*final_time=*/reverse ? begin_time : last_time,
+                    PlottableSpheres(now),
+                    plotted);
+  return Simplify(std::move(plotted.lines));
+}
+
+std::vector<RP2Lines<Length, Camera>> Planetarium::PlotMethod2(
+    std::vector<TrajectoryToPlot> const& trajectories,
+    Instant const& now,
+    WorkStealingScheduler* const scheduler) const {
+  std::vector<RP2Lines<Length, Camera>> lines(trajectories.size());
+  if (trajectories.empty()) {
     return lines;
   }
+
+  // Compute the spheres before fanning out, so that the tasks don't contend
+  // for their computation.
+  PlottableSpheres(now);
+
+  auto plot = [this, &trajectories, &lines, &now](std::size_t const i) {
+    TrajectoryToPlot const& trajectory = trajectories[i];
+    lines[i] = PlotMethod2(
+        trajectory.begin, trajectory.end, now, trajectory.reverse);
+  };
+
+  if (scheduler == nullptr) {
+    for (std::size_t i = 0; i < trajectories.size(); ++i) {
+      plot(i);
+    }
+    return lines;
+  }
+
+  // The first trajectory is plotted on this thread while the scheduler takes
+  // care of the others.
+  std::vector<Future<void>> futures;
+  futures.reserve(trajectories.size() - 1);
+  for (std::size_t i = 1; i < trajectories.size(); ++i) {
+    futures.push_back(scheduler->Add([&plot, i]() { plot(i); }));
+  }
+  plot(0);
+  for (auto const& future : futures) {
+    future.wait();
+  }
+  return lines;
+}
+
+RP2Lines<Length, Camera> Planetarium::PlotMethod2(
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    Instant const& stable_time,
+    std::int64_t const version,
+    Instant const& now,
+    bool const reverse,
+    PlottingCache& cache) const {
+  if (begin == end) {
+    cache.Invalidate();
+    return {};
+  }
   auto last = end;
   --last;
 
-  double const tan²_angular_resolution =
-      Pow<2>(parameters_.tan_angular_resolution_);
-  auto const plottable_spheres = ComputePlottableSpheres(now);
   auto const& trajectory = *begin.trajectory();
+  auto const& root = *trajectory.root();
+  auto const plottable_spheres = PlottableSpheres(now);
   auto const begin_time = std::max(begin.time(), plotting_frame_->t_min());
   auto const last_time = std::min(last.time(), plotting_frame_->t_max());
-  auto const final_time = reverse ? begin_time : last_time;
-  auto previous_time = reverse ? last_time : begin_time;
-  Sign const direction = reverse ? Sign(-1) : Sign(1);
+  if (last_time <= begin_time) {
+    cache.Invalidate();
+    return {};
+  }
+
+  // Only the part of the trajectory up to |cacheable_time| is cached.
+  Instant const cacheable_time = std::clamp(stable_time, begin_time, last_time);
+
+  if (!CacheIsValid(cache,
+                    root,
+                    version,
+                    begin_time,
+                    reverse,
+                    plottable_spheres) ||
+      cacheable_time < cache.cached_time_) {
+    cache.root_ = &root;
+    cache.version_ = version;
+    cache.plotting_frame_ = plotting_frame_;
+    cache.perspective_.emplace(perspective_);
+    cache.plottable_spheres_ = std::vector<Sphere<Navigation>>(
+        plottable_spheres.begin(), plottable_spheres.end());
+    cache.reverse_ = reverse;
+    cache.begin_time_ = begin_time;
+    cache.cached_time_ = begin_time;
+    cache.plotted_ = PlottedLines();
+  }
+
+  // Extend the cached lines up to |cacheable_time|, and plot the rest of the
+  // trajectory afresh.  When plotting in reverse the new lines come before the
+  // cached ones.
+  PlottedLines tail;
+  if (reverse) {
+    PlottedLines extension;
+    AppendPlotMethod2(trajectory,
+                      /*initial_time=*/cacheable_time,
+                      /*final_time=*/cache.cached_time_,
+                      plottable_spheres,
+                      extension);
+    cache.plotted_ = Join(std::move(extension), cache.plotted_);
+    AppendPlotMethod2(trajectory,
+                      /*initial_time=*/last_time,
+                      /*final_time=*/cacheable_time,
+                      plottable_spheres,
+                      tail);
+    cache.cached_time_ = cacheable_time;
+    return Simplify(Join(std::move(tail), cache.plotted_).lines);
+  } else {
+    AppendPlotMethod2(trajectory,
+                      /*initial_time=*/cache.cached_time_,
+                      /*final_time=*/cacheable_time,
+                      plottable_spheres,
+                      cache.plotted_);
+    AppendPlotMethod2(trajectory,
+                      /*initial_time=*/cacheable_time,
+                      /*final_time=*/last_time,
+                      plottable_spheres,
+                      tail);
+    cache.cached_time_ = cacheable_time;
+    return Simplify(Join(cache.plotted_, tail).lines);
+  }
+}
+
+void Planetarium::PlottingCache::Invalidate() {
+  root_ = nullptr;
+}
+
+RP2Lines<Length, Camera> Planetarium::PlotContinuousTrajectory(
+    ContinuousTrajectory<Barycentric> const& trajectory,
+    Instant const& first_time,
+    Instant const& last_time,
+    Instant const& now,
+    bool const reverse) const {
+  auto const begin_time = std::max({first_time,
+                                    trajectory.t_min(),
+                                    plotting_frame_->t_min()});
+  auto const end_time = std::min({last_time,
+                                  trajectory.t_max(),
+                                  plotting_frame_->t_max()});
+  if (end_time <= begin_time) {
+    return {};
+  }
+  PlottedLines plotted;
+  AppendPlotMethod2(trajectory,
+                    /*initial_time=*/reverse ? end_time : begin_time,
+                    /*final_time=*/reverse ? begin_time : end_time,
+                    PlottableSpheres(now),
+                    plotted);
+  return Simplify(std::move(plotted.lines));
+}
+
+void Planetarium::AppendPlotMethod2(
+    Trajectory<Barycentric> const& trajectory,
+    Instant const& initial_time,
+    Instant const& final_time,
+    std::vector<Sphere<Navigation>> const& plottable_spheres,
+    PlottedLines& plotted) const {
+  double const tan²_angular_resolution =
+      Pow<2>(parameters_.tan_angular_resolution_);
+  Sign const direction = final_time < initial_time ? Sign(-1) : Sign(1);
+  auto previous_time = initial_time;
   if (direction * (final_time - previous_time) <= Time{}) {
-    return lines;
+    return;
   }
   RigidMotion<Barycentric, Navigation> to_plotting_frame_at_t =
       plotting_frame_->ToThisFrameAtTime(previous_time);
@@ -167,14 +352,17 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
   Velocity<Navigation> previous_velocity =
       initial_degrees_of_freedom.velocity();
   Time Δt = final_time - previous_time;
+  plotted.min_distance_to_camera =
+      std::min(plotted.min_distance_to_camera,
+               (previous_position - perspective_.camera()).Norm());
 
   Instant t;
   double estimated_tan²_error;
   std::optional<DegreesOfFreedom<Barycentric>>
       degrees_of_freedom_in_barycentric;
   Position<Navigation> position;
-
-  std::optional<Position<Navigation>> last_endpoint;
+  // Reused across steps to avoid allocating for each of them.
+  Segments<Navigation> visible_segments;
 
   int steps_accepted = 0;
 
@@ -187,7 +375,8 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
       // errors are quadratic in time (in other words, two square roots because
       // the squared errors are quartic in time).
       // A safety factor prevents catastrophic retries.
-      Δt *= 0.9 * Sqrt(Sqrt(tan²_angular_resolution / estimated_tan²_error));
+      Δt *= 0.9 *
+            FastFourthRoot(tan²_angular_resolution / estimated_tan²_error);
     estimate_tan²_error:
       t = previous_time + Δt;
       if (direction * (t - final_time) > Time{}) {
@@ -212,47 +401,252 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
     } while (estimated_tan²_error > tan²_angular_resolution);
     ++steps_accepted;
 
-    // TODO(egg): also limit to field of view.
+    Segment<Navigation> const segment(previous_position, position);
     auto const segment_behind_focal_plane =
-        perspective_.SegmentBehindFocalPlane(
-            Segment<Navigation>(previous_position, position));
+        IsOutsideFieldOfView(segment)
+            ? std::nullopt
+            : perspective_.SegmentBehindFocalPlane(segment);
 
     previous_time = t;
     previous_position = position;
     previous_velocity =
         to_plotting_frame_at_t(*degrees_of_freedom_in_barycentric).velocity();
+    plotted.min_distance_to_camera =
+        std::min(plotted.min_distance_to_camera,
+                 (position - perspective_.camera()).Norm());
 
     if (!segment_behind_focal_plane) {
       continue;
     }
 
-    auto const visible_segments = perspective_.VisibleSegments(
-                                      *segment_behind_focal_plane,
-                                      plottable_spheres);
+    perspective_.VisibleSegments(*segment_behind_focal_plane,
+                                 plottable_spheres,
+                                 visible_segments);
     for (auto const& segment : visible_segments) {
-      if (last_endpoint != segment.first) {
-        lines.emplace_back();
-        lines.back().push_back(perspective_(segment.first));
+      if (plotted.last_endpoint != segment.first) {
+        plotted.lines.emplace_back();
+        plotted.lines.back().push_back(perspective_(segment.first));
       }
-      lines.back().push_back(perspective_(segment.second));
-      last_endpoint = segment.second;
+      if (!plotted.first_endpoint) {
+        plotted.first_endpoint = segment.first;
+      }
+      plotted.lines.back().push_back(perspective_(segment.second));
+      plotted.last_endpoint = segment.second;
     }
   }
+}
+
+RP2Lines<Length, Camera> Planetarium::Simplify(
+    RP2Lines<Length, Camera> lines) const {
+  if (parameters_.tan_simplification_tolerance_ == 0) {
+    return lines;
+  }
+  Length const tolerance =
+      perspective_.focal() * parameters_.tan_simplification_tolerance_;
+  for (auto& line : lines) {
+    SimplifyLine(tolerance * tolerance, line);
+  }
   return lines;
 }
 
-std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
+void Planetarium::SimplifyLine(Square<Length> const& tolerance²,
+                               RP2Line<Length, Camera>& line) {
+  int const size = line.size();
+  if (size <= 2) {
+    return;
+  }
+  // The coordinates are copied to contiguous arrays so that the search for the
+  // farthest point below is a tight loop that the compiler may vectorize.
+  std::vector<Length> x;
+  std::vector<Length> y;
+  x.reserve(size);
+  y.reserve(size);
+  for (auto const& point : line) {
+    if (point.is_at_infinity()) {
+      return;
+    }
+    x.push_back(point.x());
+    y.push_back(point.y());
+  }
+
+  std::vector<bool> keep(size, false);
+  keep.front() = true;
+  keep.back() = true;
+  // The ranges [first, last] that remain to be simplified.  Their endpoints
+  // are kept.
+  std::vector<std::pair<int, int>> ranges = {{0, size - 1}};
+  while (!ranges.empty()) {
+    auto const [first, last] = ranges.back();
+    ranges.pop_back();
+    Length const chord_x = x[last] - x[first];
+    Length const chord_y = y[last] - y[first];
+    Square<Length> const chord² = chord_x * chord_x + chord_y * chord_y;
+    // The distance is to the chord, not to its supporting line, so that a line
+    // that turns back on itself is not collapsed.  A degenerate chord, e.g.,
+    // for a closed line, yields the distance to its endpoint.
+    Inverse<Square<Length>> const inverse_chord² =
+        chord² == Square<Length>() ? Inverse<Square<Length>>() : 1 / chord²;
+    Square<Length> max_distance²;
+    int farthest = first;
+    for (int i = first + 1; i < last; ++i) {
+      Length const dx = x[i] - x[first];
+      Length const dy = y[i] - y[first];
+      double const s = std::clamp(
+          (dx * chord_x + dy * chord_y) * inverse_chord², 0.0, 1.0);
+      Length const ex = dx - s * chord_x;
+      Length const ey = dy - s * chord_y;
+      Square<Length> const distance² = ex * ex + ey * ey;
+      if (distance² > max_distance²) {
+        max_distance² = distance²;
+        farthest = i;
+      }
+    }
+    if (max_distance² > tolerance²) {
+      keep[farthest] = true;
+      if (farthest - first > 1) {
+        ranges.emplace_back(first, farthest);
+      }
+      if (last - farthest > 1) {
+        ranges.emplace_back(farthest, last);
+      }
+    }
+  }
+
+  int kept = 0;
+  for (int i = 0; i < size; ++i) {
+    if (keep[i]) {
+      line[kept++] = line[i];
+    }
+  }
+  line.erase(line.begin() + kept, line.end());
+}
+
+bool Planetarium::IsOutsideFieldOfView(
+    Segment<Navigation> const& segment) const {
+  // The segment is contained in the ball centred at its midpoint whose diameter
+  // is the segment.
+  Displacement<Navigation> const half_segment =
+      (segment.second - segment.first) / 2;
+  return IsOutsideFieldOfView(
+      Sphere<Navigation>(segment.first + half_segment, half_segment.Norm()));
+}
+
+bool Planetarium::IsOutsideFieldOfView(Sphere<Navigation> const& ball) const {
+  // The ball is seen from the camera within a cone of half-angle
+  // |ball_half_angle| which may not intersect the field of view.
+  Displacement<Navigation> const camera_to_centre =
+      ball.centre() - perspective_.camera();
+  Length const distance = camera_to_centre.Norm();
+  if (distance <= ball.radius()) {
+    return false;
+  }
+  Vector<double, Navigation> const axis =
+      perspective_.from_camera().linear_map()(
+          Vector<double, Camera>({0.0, 0.0, 1.0}));
+  Angle const ball_half_angle = ArcSin(ball.radius() / distance);
+  return AngleBetween(camera_to_centre, axis) >
+         parameters_.field_of_view_ + ball_half_angle;
+}
+
+Planetarium::PlottedLines Planetarium::Join(PlottedLines front,
+                                            PlottedLines const& back) {
+  if (back.lines.empty()) {
+    return front;
+  }
+  auto back_line = back.lines.begin();
+  if (front.lines.empty()) {
+    front.first_endpoint = back.first_endpoint;
+  } else if (front.last_endpoint == back.first_endpoint) {
+    // Skip the first point of |back|, which is the last point of |front|.
+    front.lines.back().insert(front.lines.back().end(),
+                              std::next(back_line->begin()),
+                              back_line->end());
+    ++back_line;
+  }
+  front.lines.insert(front.lines.end(), back_line, back.lines.end());
+  front.last_endpoint = back.last_endpoint;
+  front.min_distance_to_camera =
+      std::min(front.min_distance_to_camera, back.min_distance_to_camera);
+  return front;
+}
+
+bool Planetarium::CacheIsValid(
+    PlottingCache const& cache,
+    DiscreteTrajectory<Barycentric> const& root,
+    std::int64_t const version,
+    Instant const& begin_time,
+    bool const reverse,
+    std::vector<Sphere<Navigation>> const& plottable_spheres) const {
+  if (cache.root_ != &root ||
+      cache.version_ != version ||
+      cache.plotting_frame_ != plotting_frame_ ||
+      cache.reverse_ != reverse ||
+      cache.begin_time_ != begin_time ||
+      !cache.perspective_.has_value() ||
+      cache.perspective_->focal() != perspective_.focal() ||
+      cache.plottable_spheres_.size() != plottable_spheres.size()) {
+    return false;
+  }
+  double const tan_angular_resolution = parameters_.tan_angular_resolution_;
+  double const tan²_angular_resolution = Pow<2>(tan_angular_resolution);
+
+  // A translation of the camera moves the cached points by at most the
+  // angular resolution if it is small compared to their distance.
+  if ((cache.perspective_->camera() - perspective_.camera()).Norm() >
+      tan_angular_resolution * cache.plotted_.min_distance_to_camera) {
+    return false;
+  }
+  // Likewise for a rotation of the camera, which must hardly change the
+  // images of the axes.
+  auto const& cached_to_camera = cache.perspective_->to_camera().linear_map();
+  auto const& to_camera = perspective_.to_camera().linear_map();
+  for (auto const& axis : {Vector<double, Navigation>({1, 0, 0}),
+                           Vector<double, Navigation>({0, 1, 0}),
+                           Vector<double, Navigation>({0, 0, 1})}) {
+    if ((cached_to_camera(axis) - to_camera(axis)).Norm²() >
+        tan²_angular_resolution) {
+      return false;
+    }
+  }
+
+  // The hiding by the spheres must hardly change.
+  for (int i = 0; i < plottable_spheres.size(); ++i) {
+    Sphere<Navigation> const& cached_sphere = cache.plottable_spheres_[i];
+    Sphere<Navigation> const& sphere = plottable_spheres[i];
+    if (cached_sphere.radius() != sphere.radius() ||
+        (cached_sphere.centre() - sphere.centre()).Norm() >
+            tan_angular_resolution *
+                (sphere.centre() - perspective_.camera()).Norm()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<Sphere<Navigation>> Planetarium::PlottableSpheres(
     Instant const& now) const {
+  std::lock_guard<std::mutex> l(plottable_spheres_lock_);
+  if (plottable_spheres_time_ != now) {
+    ComputePlottableSpheres(now, plottable_spheres_);
+    plottable_spheres_time_ = now;
+  }
+  return plottable_spheres_;
+}
+
+void Planetarium::ComputePlottableSpheres(
+    Instant const& now,
+    std::vector<Sphere<Navigation>>& plottable_spheres) const {
   RigidMotion<Barycentric, Navigation> const rigid_motion_at_now =
       plotting_frame_->ToThisFrameAtTime(now);
-  std::vector<Sphere<Navigation>> plottable_spheres;
+  plottable_spheres.clear();
 
   auto const& bodies = ephemeris_->bodies();
-  for (not_null<MassiveBody const*> const body : bodies) {
-    auto const trajectory = ephemeris_->trajectory(body);
-    Length const mean_radius = body->mean_radius();
-    Position<Barycentric> const centre_in_barycentric =
-        trajectory->EvaluatePosition(now);
+  std::vector<Position<Barycentric>> centres_in_barycentric;
+  ephemeris_->EvaluateAllPositions(now, centres_in_barycentric);
+  for (int i = 0; i < bodies.size(); ++i) {
+    Length const mean_radius = bodies[i]->mean_radius();
+    Position<Barycentric> const& centre_in_barycentric =
+        centres_in_barycentric[i];
     Sphere<Navigation> plottable_sphere(
         rigid_motion_at_now.rigid_transformation()(centre_in_barycentric),
         parameters_.sphere_radius_multiplier_ * mean_radius);
@@ -263,7 +657,6 @@ std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
       plottable_spheres.emplace_back(std::move(plottable_sphere));
     }
   }
-  return plottable_spheres;
 }
 
 Segments<Navigation> Planetarium::ComputePlottableSegments(
@@ -271,46 +664,58 @@ Segments<Navigation> Planetarium::ComputePlottableSegments(
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
     DiscreteTrajectory<Barycentric>::Iterator const& end) const {
   Segments<Navigation> all_segments;
-  if (begin == end) {
-    return all_segments;
+  // Reused across segments to avoid allocating for each of them.
+  Segments<Navigation> segments;
+
+  // Transform the points of the trajectory to the plotting frame.
+  std::vector<Position<Navigation>> positions;
+  for (auto it = begin; it != end; ++it) {
+    RigidMotion<Barycentric, Navigation> const rigid_motion_at_t =
+        plotting_frame_->ToThisFrameAtTime(it.time());
+    positions.push_back(rigid_motion_at_t(it.degrees_of_freedom()).position());
   }
-  auto it1 = begin;
-  Instant t1 = it1.time();
-  RigidMotion<Barycentric, Navigation> rigid_motion_at_t1 =
-      plotting_frame_->ToThisFrameAtTime(t1);
-  Position<Navigation> p1 =
-      rigid_motion_at_t1(it1.degrees_of_freedom()).position();
-
-  auto it2 = it1;
-  while (++it2 != end) {
-    // Processing one segment of the trajectory.
-    Instant const t2 = it2.time();
-
-    // Transform the degrees of freedom to the plotting frame.
-    RigidMotion<Barycentric, Navigation> const rigid_motion_at_t2 =
-        plotting_frame_->ToThisFrameAtTime(t2);
-    Position<Navigation> const p2 =
-        rigid_motion_at_t2(it2.degrees_of_freedom()).position();
-
-    // Find the part of the segment that is behind the focal plane.  We don't
-    // care about things that are in front of the focal plane.
-    const Segment<Navigation> segment = {p1, p2};
-    auto const segment_behind_focal_plane =
-        perspective_.SegmentBehindFocalPlane(segment);
-    if (segment_behind_focal_plane) {
-      // Find the part(s) of the segment that are not hidden by spheres.  These
-      // are the ones we want to plot.
-      auto segments = perspective_.VisibleSegments(*segment_behind_focal_plane,
-                                                   plottable_spheres);
-      std::move(segments.begin(),
-                segments.end(),
-                std::back_inserter(all_segments));
+
+  // Process the segments in chunks, and skip the chunks whose bounding sphere
+  // is outside the field of view without looking at their segments.  When
+  // zoomed in on a long trajectory, most chunks are skipped.
+  std::int64_t const last = static_cast<std::int64_t>(positions.size()) - 1;
+  for (std::int64_t chunk_begin = 0;
+       chunk_begin < last;
+       chunk_begin += field_of_view_culling_chunk_size) {
+    std::int64_t const chunk_end =
+        std::min(chunk_begin + field_of_view_culling_chunk_size, last);
+    Position<Navigation> const& origin = positions[chunk_begin];
+    Displacement<Navigation> sum;
+    for (std::int64_t i = chunk_begin + 1; i <= chunk_end; ++i) {
+      sum += positions[i] - origin;
+    }
+    Position<Navigation> const centre =
+        origin + sum / static_cast<double>(chunk_end - chunk_begin + 1);
+    Length radius;
+    for (std::int64_t i = chunk_begin; i <= chunk_end; ++i) {
+      radius = std::max(radius, (positions[i] - centre).Norm());
+    }
+    if (IsOutsideFieldOfView(Sphere<Navigation>(centre, radius))) {
+      continue;
     }
 
-    it1 = it2;
-    t1 = t2;
-    rigid_motion_at_t1 = rigid_motion_at_t2;
-    p1 = p2;
+    for (std::int64_t i = chunk_begin; i < chunk_end; ++i) {
+      // Find the part of the segment that is behind the focal plane.  We don't
+      // care about things that are in front of the focal plane.
+      const Segment<Navigation> segment = {positions[i], positions[i + 1]};
+      auto const segment_behind_focal_plane =
+          perspective_.SegmentBehindFocalPlane(segment);
+      if (segment_behind_focal_plane) {
+        // Find the part(s) of the segment that are not hidden by spheres.
+        // These are the ones we want to plot.
+        perspective_.VisibleSegments(*segment_behind_focal_plane,
+                                     plottable_spheres,
+                                     segments);
+        std::move(segments.begin(),
+                  segments.end(),
+                  std::back_inserter(all_segments));
+      }
+    }
   }
 
   return all_segments;
@@ -1,19 +1,26 @@
 ﻿
 #pragma once
 
+#include <mutex>
+#include <optional>
 #include <vector>
 
+#include "base/macros.hpp"
 #include "base/not_null.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/perspective.hpp"
 #include "geometry/rp2_point.hpp"
 #include "geometry/sphere.hpp"
 #include "ksp_plugin/frames.hpp"
+#include "physics/continuous_trajectory.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
 #include "physics/rigid_motion.hpp"
+#include "physics/trajectory.hpp"
+#include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
 
 namespace principia {
@@ -21,21 +28,28 @@ namespace ksp_plugin {
 namespace internal_planetarium {
 
 using base::not_null;
+using base::WorkStealingScheduler;
 using geometry::Displacement;
 using geometry::Instant;
 using geometry::OrthogonalMap;
 using geometry::Perspective;
+using geometry::Position;
+using geometry::RP2Line;
 using geometry::RP2Lines;
 using geometry::RP2Point;
 using geometry::Segment;
 using geometry::Segments;
 using geometry::Sphere;
+using physics::ContinuousTrajectory;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
 using physics::RigidMotion;
+using physics::Trajectory;
 using quantities::Angle;
+using quantities::Infinity;
 using quantities::Length;
+using quantities::Square;
 
 // A planetarium is an ephemeris together with a perspective.  In this setting
 // it is possible to draw trajectories in the projective plane.
@@ -47,18 +61,35 @@ class Planetarium {
     // where we don't draw trajectories.  |angular_resolution| defines the limit
     // beyond which spheres don't participate in hiding.  |field_of_view|
     // is the half-angle of a cone outside of which not plotting takes place.
+    // If |simplification_tolerance| is nonzero, the lines returned by
+    // |PlotMethod2| are simplified: a point is removed if it is seen within
+    // that angle of the line that remains, see |Simplify|.
     explicit Parameters(double sphere_radius_multiplier,
                         Angle const& angular_resolution,
-                        Angle const& field_of_view);
+                        Angle const& field_of_view,
+                        Angle const& simplification_tolerance = Angle());
 
    private:
-    double const sphere_radius_multiplier_;
-    double const sin²_angular_resolution_;
-    double const tan_angular_resolution_;
-    double const tan_field_of_view_;
+    double sphere_radius_multiplier_;
+    double sin²_angular_resolution_;
+    double tan_angular_resolution_;
+    double tan_field_of_view_;
+    Angle field_of_view_;
+    double tan_simplification_tolerance_;
     friend class Planetarium;
   };
 
+  // A trajectory to be plotted by the batch |PlotMethod2| below.
+  struct TrajectoryToPlot final {
+    DiscreteTrajectory<Barycentric>::Iterator begin;
+    DiscreteTrajectory<Barycentric>::Iterator end;
+    bool reverse;
+  };
+
+  // The state needed to plot a trajectory incrementally from frame to frame,
+  // see the |PlotMethod2| overload that takes a cache.
+  class PlottingCache;
+
   // TODO(phl): All this Navigation is weird.  Should it be named Plotting?
   // In particular Navigation vs. NavigationFrame is a mess.
   Planetarium(Parameters const& parameters,
@@ -66,6 +97,15 @@ class Planetarium {
               not_null<Ephemeris<Barycentric> const*> ephemeris,
               not_null<NavigationFrame const*> plotting_frame);
 
+  // Replaces the parameters, perspective and plotting frame of this
+  // planetarium, e.g., when the camera moves, so that a planetarium may be
+  // kept from frame to frame instead of being recreated.  The buffers of the
+  // planetarium are retained, and the plottable spheres are recomputed by the
+  // next plot.  Must not be called concurrently with the plotting methods.
+  void UpdatePerspective(Parameters const& parameters,
+                         Perspective<Navigation, Camera> const& perspective,
+                         not_null<NavigationFrame const*> plotting_frame);
+
   // A no-op method that just returns all the points in the trajectory defined
   // by |begin| and |end|.
   RP2Lines<Length, Camera> PlotMethod0(
@@ -88,23 +128,162 @@ class Planetarium {
       Instant const& now,
       bool reverse) const;
 
+  // Plots each of the |trajectories| as above.  The element of the result at
+  // index i contains the lines for |trajectories[i]|.  If |scheduler| is not
+  // null, the trajectories are plotted in parallel on it.  The trajectories
+  // must not change during the call.
+  std::vector<RP2Lines<Length, Camera>> PlotMethod2(
+      std::vector<TrajectoryToPlot> const& trajectories,
+      Instant const& now,
+      WorkStealingScheduler* scheduler) const;
+
+  // Same as the first |PlotMethod2|, but reuses the lines stored in |cache| by
+  // a previous call, and only plots the points that were appended since then.
+  // Only the lines up to |stable_time| are cached: the caller guarantees that
+  // the points of the trajectory up to that time don't change as long as the
+  // root of the trajectory and the |version| don't change.  The |cache| is
+  // used, and then updated, if the root, the |version|, the time of |begin|,
+  // the plotting frame and |reverse| are unchanged, and if the camera and the
+  // plottable spheres have not moved by more than the angular resolution.
+  // Otherwise the trajectory is entirely replotted.  The |cache| must not be
+  // used concurrently.
+  RP2Lines<Length, Camera> PlotMethod2(
+      DiscreteTrajectory<Barycentric>::Iterator const& begin,
+      DiscreteTrajectory<Barycentric>::Iterator const& end,
+      Instant const& stable_time,
+      std::int64_t version,
+      Instant const& now,
+      bool reverse,
+      PlottingCache& cache) const;
+
+  // Plots the |trajectory| of a celestial from |first_time| to |last_time|
+  // (clipped to the times where it and the plotting frame are defined) with
+  // the adaptive sampling of |PlotMethod2|: the steps are chosen so that the
+  // curve, extrapolated with its velocity in the plotting frame, is seen
+  // within the angular resolution of the segments.  Unlike a discrete
+  // trajectory, a continuous one is evaluated at the times chosen by the
+  // method, so the sampling is as fine as needed, e.g., for the orbit of a
+  // moon in a rotating frame, and no finer.
+  RP2Lines<Length, Camera> PlotContinuousTrajectory(
+      ContinuousTrajectory<Barycentric> const& trajectory,
+      Instant const& first_time,
+      Instant const& last_time,
+      Instant const& now,
+      bool reverse) const;
+
  private:
+  // Lines in the order in which they were plotted, together with the
+  // positions of their first and last endpoints in the plotting frame.
+  struct PlottedLines final {
+    RP2Lines<Length, Camera> lines;
+    std::optional<Position<Navigation>> first_endpoint;
+    std::optional<Position<Navigation>> last_endpoint;
+    // The smallest distance from the camera to a plotted position.
+    Length min_distance_to_camera = Infinity<Length>();
+  };
+
+  // Appends to |plotted| the lines obtained by plotting |trajectory| with
+  // method 2 from |initial_time| to |final_time| (backwards if |final_time| is
+  // before |initial_time|).  The first line is continued if it starts at the
+  // last endpoint of |plotted|.  The |trajectory| is only evaluated at the
+  // times chosen by the method, so it may be discrete or continuous.
+  void AppendPlotMethod2(
+      Trajectory<Barycentric> const& trajectory,
+      Instant const& initial_time,
+      Instant const& final_time,
+      std::vector<Sphere<Navigation>> const& plottable_spheres,
+      PlottedLines& plotted) const;
+
+  // Returns |lines| where each line has been simplified by the Douglas-Peucker
+  // algorithm, so that the removed points are within the simplification
+  // tolerance, measured in the focal plane, of the segments that replace them.
+  // The endpoints of the lines are preserved.  Returns |lines| unchanged if the
+  // simplification tolerance is zero.
+  RP2Lines<Length, Camera> Simplify(RP2Lines<Length, Camera> lines) const;
+
+  // Simplifies |line| in place with the given squared |tolerance|.
+  static void SimplifyLine(Square<Length> const& tolerance²,
+                           RP2Line<Length, Camera>& line);
+
+  // Returns true if |segment| is certainly entirely outside the cone of the
+  // field of view.  May return false for some segments that are outside of it.
+  bool IsOutsideFieldOfView(Segment<Navigation> const& segment) const;
+  // Same as above for a |ball|.
+  bool IsOutsideFieldOfView(Sphere<Navigation> const& ball) const;
+
+  // Returns the lines of |front| followed by those of |back|, joining the last
+  // line of |front| with the first line of |back| if they have a common
+  // endpoint.
+  static PlottedLines Join(PlottedLines front, PlottedLines const& back);
+
+  // Returns true if the lines in |cache| may be reused for plotting the
+  // trajectory with the given |root| and |version| from |begin_time| in the
+  // given direction.
+  bool CacheIsValid(
+      PlottingCache const& cache,
+      DiscreteTrajectory<Barycentric> const& root,
+      std::int64_t version,
+      Instant const& begin_time,
+      bool reverse,
+      std::vector<Sphere<Navigation>> const& plottable_spheres) const;
+
+
+  // Returns the spheres computed by |ComputePlottableSpheres(now)|, which are
+  // only recomputed when |now| differs from that of the previous call or when
+  // the perspective has been updated since.  This ensures that the spheres are
+  // computed once for all the trajectories plotted in a frame.  Thread-safe.
+  std::vector<Sphere<Navigation>> PlottableSpheres(Instant const& now) const;
+
   // Computes the coordinates of the spheres that represent the |ephemeris_|
   // bodies.  These coordinates are in the |plotting_frame_| at time |now|.
-  std::vector<Sphere<Navigation>> ComputePlottableSpheres(
-      Instant const& now) const;
+  // The previous contents of |plottable_spheres| are replaced, but its
+  // storage is reused.
+  void ComputePlottableSpheres(
+      Instant const& now,
+      std::vector<Sphere<Navigation>>& plottable_spheres) const;
 
   // Computes the segments of the trajectory defined by |begin| and |end| that
-  // are not hidden by the |plottable_spheres|.
+  // are not hidden by the |plottable_spheres|.  Chunks of segments that are
+  // certainly outside the field of view are omitted.
   Segments<Navigation> ComputePlottableSegments(
       const std::vector<Sphere<Navigation>>& plottable_spheres,
       DiscreteTrajectory<Barycentric>::Iterator const& begin,
       DiscreteTrajectory<Barycentric>::Iterator const& end) const;
 
-  Parameters const parameters_;
-  Perspective<Navigation, Camera> const perspective_;
+  Parameters parameters_;
+  Perspective<Navigation, Camera> perspective_;
   not_null<Ephemeris<Barycentric> const*> const ephemeris_;
-  not_null<NavigationFrame const*> const plotting_frame_;
+  not_null<NavigationFrame const*> plotting_frame_;
+
+  mutable std::mutex plottable_spheres_lock_;
+  mutable std::optional<Instant> plottable_spheres_time_
+      GUARDED_BY(plottable_spheres_lock_);
+  mutable std::vector<Sphere<Navigation>> plottable_spheres_
+      GUARDED_BY(plottable_spheres_lock_);
+};
+
+class Planetarium::PlottingCache final {
+ public:
+  PlottingCache() = default;
+
+  // Forces the next plot using this cache to replot the entire trajectory.
+  void Invalidate();
+
+ private:
+  // The root of the plotted trajectory, which, unlike the trajectory itself,
+  // is not recreated from frame to frame.
+  DiscreteTrajectory<Barycentric> const* root_ = nullptr;
+  std::int64_t version_ = 0;
+  NavigationFrame const* plotting_frame_ = nullptr;
+  std::optional<Perspective<Navigation, Camera>> perspective_;
+  std::vector<Sphere<Navigation>> plottable_spheres_;
+  bool reverse_ = false;
+  Instant begin_time_;
+  // The lines in |plotted_| cover the trajectory between |begin_time_| and
+  // |cached_time_|.
+  Instant cached_time_;
+  PlottedLines plotted_;
+  friend class Planetarium;
 };
 
 }  // namespace internal_planetarium
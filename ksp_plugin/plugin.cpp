@@ -2,13 +2,17 @@
 #include "ksp_plugin/plugin.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <ios>
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
@@ -25,8 +29,10 @@
 #include "base/map_util.hpp"
 #include "base/not_null.hpp"
 #include "base/optional_logging.hpp"
+#include "base/profiling.hpp"
 #include "base/serialization.hpp"
 #include "base/status.hpp"
+#include "base/thread_configuration.hpp"
 #include "base/unique_ptr_logging.hpp"
 #include "geometry/affine_map.hpp"
 #include "geometry/barycentre_calculator.hpp"
@@ -35,6 +41,8 @@
 #include "geometry/permutation.hpp"
 #include "glog/logging.h"
 #include "glog/stl_logging.h"
+#include "google/protobuf/arena.h"
+#include "ksp_plugin/flight_plan_optimizer.hpp"
 #include "ksp_plugin/integrators.hpp"
 #include "ksp_plugin/part_subsets.hpp"
 #include "physics/apsides.hpp"
@@ -46,6 +54,7 @@
 #include "physics/dynamic_frame.hpp"
 #include "physics/frame_field.hpp"
 #include "physics/massive_body.hpp"
+#include "physics/shared_dynamic_frame.hpp"
 #include "physics/solar_system.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
@@ -54,15 +63,16 @@ namespace principia {
 namespace ksp_plugin {
 namespace internal_plugin {
 
-using astronomy::InfiniteFuture;
 using astronomy::ParseTT;
 using astronomy::KSPStockSystemFingerprint;
 using astronomy::KSPStabilizedSystemFingerprint;
-using astronomy::StabilizeKSP;
+using astronomy::StabilizedKSPElements;
 using base::check_not_null;
+using base::ConfiguredPoolSize;
 using base::dynamic_cast_not_null;
 using base::Error;
 using base::FindOrDie;
+using base::Future;
 using base::Fingerprint2011;
 using base::make_not_null_unique;
 using base::OFStream;
@@ -93,24 +103,153 @@ using physics::Frenet;
 using physics::KeplerianElements;
 using physics::MassiveBody;
 using physics::RigidMotion;
+using physics::SharedDynamicFrame;
 using physics::SolarSystem;
 using quantities::Force;
+using quantities::GravitationalParameter;
 using quantities::Infinity;
 using quantities::Length;
+using quantities::SpecificEnergy;
+using quantities::Speed;
 using quantities::si::Kilogram;
 using quantities::si::Milli;
 using quantities::si::Minute;
 using quantities::si::Radian;
+using ::google::protobuf::Arena;
 using ::operator<<;
 
+// The number of chunks in which the pile-ups, and then the vessels, are split
+// by |CatchUpLaggingVessels|, per thread of the scheduler.  More than one chunk
+// per thread lets the scheduler balance chunks that take different times.
+constexpr std::int64_t chunks_per_thread = 4;
+
+// The share of the frame budget of a |PredictionLevelOfDetail::Full|
+// prediction, relative to that of a |PredictionLevelOfDetail::Medium| one.
+constexpr int full_prediction_weight = 4;
+
+// How the parameters of the plugin are relaxed for the
+// |PredictionLevelOfDetail::Medium| predictions.
+constexpr std::int64_t medium_prediction_steps_divisor = 4;
+constexpr double medium_prediction_tolerance_factor = 10;
+
+// The longest interval between two checks of the parent of a vessel by
+// |UpdateVesselParents|.  The time to the nearest boundary of a sphere of
+// influence is estimated from the current speeds, which is only reliable over
+// a fraction of an orbit.
+constexpr Time max_time_between_parent_checks = 10 * Minute;
+
+// The elements that stabilize the stock KSP system, once they have been checked
+// to yield |KSPStabilizedSystemFingerprint|.  They only depend on the stock
+// elements, so the plugins created later in the process apply them without
+// computing and checking them again.
+std::mutex stabilized_ksp_elements_lock;
+std::optional<std::map<std::string, KeplerianElements<Barycentric>>>
+    stabilized_ksp_elements GUARDED_BY(stabilized_ksp_elements_lock);
+
+// Integrates the |freefalls| with the given |indices|, which all start at the
+// same time and are sorted by final time, and stores their results in
+// |results|.  See |Plugin::FlowFreefalls|.
+void FlowFreefallGroup(
+    not_null<Ephemeris<Barycentric>*> const ephemeris,
+    Ephemeris<Barycentric>::AdaptiveStepParameters const& parameters,
+    NavigationFrame const& body_centred_inertial,
+    RigidMotion<Navigation, World> const& to_world,
+    std::vector<Freefall> const& freefalls,
+    std::vector<std::int64_t> const& indices,
+    std::vector<StatusOr<DegreesOfFreedom<World>>>& results) {
+  Instant const& t_initial = freefalls[indices.front()].t_initial;
+  ephemeris->Prolong(t_initial);
+  RigidMotion<World, Barycentric> const from_world =
+      body_centred_inertial.FromThisFrameAtTime(t_initial) *
+      to_world.Inverse();
+
+  // |live| holds the positions in |indices| of the freefalls that have not
+  // reached their final time yet; they all end at the same time.
+  std::vector<std::unique_ptr<DiscreteTrajectory<Barycentric>>> trajectories;
+  std::vector<std::int64_t> live;
+  for (std::int64_t k = 0; k < indices.size(); ++k) {
+    trajectories.push_back(std::make_unique<DiscreteTrajectory<Barycentric>>());
+    trajectories.back()->Append(
+        t_initial,
+        from_world(freefalls[indices[k]].initial_degrees_of_freedom));
+    live.push_back(k);
+  }
+
+  while (!live.empty()) {
+    Instant const t_final = freefalls[indices[live.front()]].t_final;
+    std::vector<not_null<DiscreteTrajectory<Barycentric>*>> flowed;
+    for (std::int64_t const k : live) {
+      flowed.push_back(trajectories[k].get());
+    }
+    Status const status = ephemeris->FlowManyWithAdaptiveStep(
+        flowed,
+        Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+        t_final,
+        std::vector<Ephemeris<Barycentric>::AdaptiveStepParameters>(
+            flowed.size(), parameters),
+        Ephemeris<Barycentric>::unlimited_max_ephemeris_steps,
+        /*last_point_only=*/true);
+
+    RigidMotion<Barycentric, World> const to_world_at_t_final =
+        to_world * body_centred_inertial.ToThisFrameAtTime(t_final);
+    std::vector<std::int64_t> still_live;
+    for (std::int64_t const k : live) {
+      // The status of the joint integration pertains to the entire system, so
+      // if it failed, e.g., because one of the freefalls collided, integrate
+      // the freefalls separately to find out which ones are affected.
+      Status const freefall_status =
+          status.ok() ? status
+                      : ephemeris->FlowWithAdaptiveStep(
+                            trajectories[k].get(),
+                            Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+                            t_final,
+                            parameters,
+                            Ephemeris<Barycentric>::
+                                unlimited_max_ephemeris_steps,
+                            /*last_point_only=*/true);
+      std::int64_t const i = indices[k];
+      if (!freefall_status.ok()) {
+        results[i] = freefall_status;
+      } else if (freefalls[i].t_final == t_final) {
+        results[i] = to_world_at_t_final(
+            trajectories[k]->last().degrees_of_freedom());
+      } else {
+        still_live.push_back(k);
+      }
+    }
+    live = std::move(still_live);
+  }
+}
+
+FreefallFuture::FreefallFuture(std::int64_t const size) : results(size) {}
+
+FreefallFuture::~FreefallFuture() {
+  wait();
+}
+
+bool FreefallFuture::is_ready() const {
+  return std::all_of(groups.begin(),
+                     groups.end(),
+                     [](Future<void> const& group) {
+                       return group.is_ready();
+                     });
+}
+
+void FreefallFuture::wait() const {
+  for (auto const& group : groups) {
+    group.wait();
+  }
+}
+
 Plugin::Plugin(std::string const& game_epoch,
                std::string const& solar_system_epoch,
                Angle const& planetarium_rotation)
     : history_parameters_(DefaultHistoryParameters()),
       psychohistory_parameters_(DefaultPsychohistoryParameters()),
       prediction_parameters_(DefaultPredictionParameters()),
-      vessel_thread_pool_(
-          /*pool_size=*/2 * std::thread::hardware_concurrency()),
+      scheduler_(/*pool_size=*/ConfiguredPoolSize(std::max(
+          2 * static_cast<int>(std::thread::hardware_concurrency()), 1))),
+      vessel_thread_pool_(&scheduler_),
       planetarium_rotation_(planetarium_rotation),
       game_epoch_(ParseTT(game_epoch)),
       current_time_(ParseTT(solar_system_epoch)) {
@@ -120,6 +259,10 @@ Plugin::Plugin(std::string const& game_epoch,
 }
 
 Plugin::~Plugin() {
+  // The asynchronous computations reference the vessels, the pile-ups, the
+  // renderer, the ephemeris, etc., so they must complete before anything is
+  // destroyed.
+  scheduler_.WaitUntilIdle();
   // We must manually destroy the vessels, triggering the destruction of the
   // parts, which have callbacks to remove themselves from |part_id_to_vessel_|,
   // which must therefore still exist.  This also causes the parts to be
@@ -163,6 +306,14 @@ void Plugin::InitializeEphemerisParameters(
   ephemeris_parameters_ = parameters;
 }
 
+void Plugin::InitializeEphemerisParametersCandidates(
+    std::vector<Ephemeris<Barycentric>::FixedStepParameters> const&
+        candidates) {
+  CHECK(initializing_);
+  CHECK(!candidates.empty());
+  ephemeris_parameters_candidates_ = candidates;
+}
+
 void Plugin::InitializeHistoryParameters(
     Ephemeris<Barycentric>::FixedStepParameters const& parameters) {
   CHECK(initializing_);
@@ -192,18 +343,29 @@ void Plugin::EndInitialization() {
 
     if (system_fingerprint == KSPStockSystemFingerprint) {
       LOG(WARNING) << "This appears to be the dreaded KSP stock system!";
-      StabilizeKSP(solar_system);
-      auto const hierarchical_system = solar_system.MakeHierarchicalSystem();
-      serialization::HierarchicalSystem message;
-      hierarchical_system->WriteToMessage(&message);
-      uint64_t const system_fingerprint =
-          Fingerprint2011(SerializeAsBytes(message).get());
-      LOG(INFO) << "System fingerprint after stabilization is " << std::hex
-                << std::uppercase << system_fingerprint;
-      CHECK_EQ(KSPStabilizedSystemFingerprint, system_fingerprint)
-          << "Attempt at stabilizing the KSP system failed!\n"
-          << gravity_model_.DebugString() << "\n"
-          << initial_state_.DebugString();
+      std::lock_guard<std::mutex> l(stabilized_ksp_elements_lock);
+      if (stabilized_ksp_elements.has_value()) {
+        for (auto const& [name, elements] : *stabilized_ksp_elements) {
+          solar_system.ReplaceElements(name, elements);
+        }
+      } else {
+        auto elements = StabilizedKSPElements(solar_system);
+        for (auto const& [name, body_elements] : elements) {
+          solar_system.ReplaceElements(name, body_elements);
+        }
+        auto const hierarchical_system = solar_system.MakeHierarchicalSystem();
+        serialization::HierarchicalSystem message;
+        hierarchical_system->WriteToMessage(&message);
+        uint64_t const system_fingerprint =
+            Fingerprint2011(SerializeAsBytes(message).get());
+        LOG(INFO) << "System fingerprint after stabilization is " << std::hex
+                  << std::uppercase << system_fingerprint;
+        CHECK_EQ(KSPStabilizedSystemFingerprint, system_fingerprint)
+            << "Attempt at stabilizing the KSP system failed!\n"
+            << gravity_model_.DebugString() << "\n"
+            << initial_state_.DebugString();
+        stabilized_ksp_elements = std::move(elements);
+      }
       LOG(INFO) << "This is the stabilized KSP system, all hail retrobop!";
     } else if (system_fingerprint == KSPStabilizedSystemFingerprint) {
       LOG(INFO) << "This is the stabilized KSP system, and we didn't have to "
@@ -216,10 +378,19 @@ void Plugin::EndInitialization() {
     }
   }
 
-  // Construct the ephemeris.
+  // Construct the ephemeris, selecting its parameters if so requested.
+  if (!ephemeris_parameters_candidates_.empty()) {
+    ephemeris_parameters_ =
+        SelectEphemerisParameters(solar_system,
+                                  ephemeris_parameters_candidates_,
+                                  default_ephemeris_fitting_tolerance,
+                                  ephemeris_parameters_probe_duration);
+  }
   ephemeris_ = solar_system.MakeEphemeris(
       default_ephemeris_fitting_tolerance,
       ephemeris_parameters_.value_or(DefaultEphemerisParameters()));
+  ephemeris_->StartBackgroundProlongation(
+      default_ephemeris_prolongation_horizon);
 
   // Construct the celestials using the bodies from the ephemeris.
   for (std::string const& name : solar_system.names()) {
@@ -265,10 +436,12 @@ void Plugin::EndInitialization() {
               sun_->body()));
 
   // Log the serialized ephemeris.
-  serialization::Ephemeris ephemeris_message;
-  ephemeris_->WriteToMessage(&ephemeris_message);
+  Arena arena;
+  not_null<serialization::Ephemeris*> const ephemeris_message =
+      Arena::CreateMessage<serialization::Ephemeris>(&arena);
+  ephemeris_->WriteToMessage(ephemeris_message);
   auto const hex =
-      base::HexadecimalEncode(SerializeAsBytes(ephemeris_message).get(),
+      base::HexadecimalEncode(SerializeAsBytes(*ephemeris_message).get(),
                               /*null_terminated=*/true);
   // Begin and end markers to make sure the hex did not get clipped (this might
   // happen if the message is very big).
@@ -389,6 +562,7 @@ void Plugin::InsertOrKeepVessel(GUID const& vessel_guid,
   }
   if (loaded) {
     loaded_vessels_.insert(vessel);
+    sleeping_vessels_.erase(vessel);
   }
   LOG_IF(INFO, inserted) << "Inserted " << (loaded ? "loaded" : "unloaded")
                          << " vessel " << vessel->ShortDebugString();
@@ -528,8 +702,11 @@ void Plugin::FreeVesselsAndPartsAndCollectPileUps(Time const& Δt) {
       ++it;
     } else {
       loaded_vessels_.erase(vessel);
+      sleeping_vessels_.erase(vessel);
       LOG(INFO) << "Removing vessel " << vessel->ShortDebugString();
       renderer_->ClearTargetVesselIf(vessel);
+      ReleaseVesselHandle(vessel);
+      next_parent_checks_.erase(vessel);
       it = vessels_.erase(it);
     }
   }
@@ -571,8 +748,11 @@ void Plugin::FreeVesselsAndPartsAndCollectPileUps(Time const& Δt) {
     }
     for (not_null<Vessel*> const vessel : grounded_vessels) {
       loaded_vessels_.erase(vessel);
+      sleeping_vessels_.erase(vessel);
       LOG(INFO) << "Removing grounded vessel " << vessel->ShortDebugString();
       renderer_->ClearTargetVesselIf(vessel);
+      ReleaseVesselHandle(vessel);
+      next_parent_checks_.erase(vessel);
       CHECK_EQ(vessels_.erase(vessel->guid()), 1);
     }
   }
@@ -631,8 +811,7 @@ DegreesOfFreedom<World> Plugin::CelestialWorldDegreesOfFreedom(
     RigidMotion<Barycentric, World> const& barycentric_to_world,
     Instant const& time) const {
   return barycentric_to_world(
-             FindOrDie(celestials_, index)->
-                 trajectory().EvaluateDegreesOfFreedom(time));
+             FindOrDie(celestials_, index)->current_degrees_of_freedom(time));
 }
 
 RigidMotion<Barycentric, World> Plugin::BarycentricToWorld(
@@ -687,6 +866,7 @@ RigidMotion<Barycentric, World> Plugin::BarycentricToWorld(
 }
 
 void Plugin::AdvanceTime(Instant const& t, Angle const& planetarium_rotation) {
+  PRINCIPIA_PROFILE_SCOPE(PluginAdvanceTime);
   CHECK(!initializing_);
   CHECK_GT(t, current_time_);
 
@@ -694,44 +874,125 @@ void Plugin::AdvanceTime(Instant const& t, Angle const& planetarium_rotation) {
     vessel->ClearAllIntrinsicForces();
   }
 
+  expected_next_time_ = t + (t - current_time_);
   current_time_ = t;
   planetarium_rotation_ = planetarium_rotation;
+  // Prolong the ephemeris in the background towards the next frame, so that
+  // at high warp the next call doesn't have to wait for it.  This only blocks
+  // if the background prolongation is behind.
+  ephemeris_->RequestProlongation(expected_next_time_);
   ephemeris_->Prolong(current_time_);
+  CacheCelestialDegreesOfFreedom();
   UpdatePlanetariumRotation();
   loaded_vessels_.clear();
+
+  prediction_weight_in_previous_frame_ = prediction_weight_in_frame_;
+  prediction_weight_in_frame_ = 0;
+  if (prediction_frame_budget_.has_value()) {
+    prediction_budget_left_ = *prediction_frame_budget_;
+  }
 }
 
 void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
+  PRINCIPIA_PROFILE_SCOPE(PluginCatchUpLaggingVessels);
   CHECK(!initializing_);
 
-  // Start all the integrations in parallel.
-  std::vector<PileUpFuture> pile_up_futures;
-  for (auto* const pile_up : pile_ups_) {
-    pile_up_futures.emplace_back(
-        pile_up,
-        vessel_thread_pool_.Add([this, pile_up]() {
-          // Note that there cannot be contention in the following method as
-          // no two pile-ups are advanced at the same time.
-          return pile_up->DeformAndAdvanceTime(current_time_);
+  // The vessels that are asleep are unloaded, so they are alone in their
+  // pile-ups, which are not advanced.
+  std::set<PileUp const*> sleeping_pile_ups;
+  for (not_null<Vessel*> const vessel : sleeping_vessels_) {
+    if (is_asleep(vessel)) {
+      vessel->ForSomePart([&sleeping_pile_ups](Part& part) {
+        sleeping_pile_ups.insert(part.containing_pile_up());
+      });
+    }
+  }
+  std::vector<PileUp*> pile_ups;
+  pile_ups.reserve(pile_ups_.size());
+  for (PileUp* const pile_up : pile_ups_) {
+    if (!Contains(sleeping_pile_ups, pile_up)) {
+      pile_ups.push_back(pile_up);
+    }
+  }
+
+  // Start all the integrations in parallel.  The pile-ups are split in chunks
+  // of consecutive pile-ups, each of which is advanced by a single task, so
+  // that a large debris field doesn't result in one task per piece.
+  std::vector<Status> statuses(pile_ups.size());
+  std::int64_t const number_of_chunks =
+      std::min<std::int64_t>(pile_ups.size(),
+                             chunks_per_thread * scheduler_.pool_size());
+  std::vector<Future<void>> futures;
+  futures.reserve(number_of_chunks);
+  for (std::int64_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+    std::int64_t const begin = chunk * pile_ups.size() / number_of_chunks;
+    std::int64_t const end = (chunk + 1) * pile_ups.size() / number_of_chunks;
+    futures.push_back(
+        scheduler_.Add([this, begin, end, &pile_ups, &statuses]() {
+          for (std::int64_t i = begin; i < end; ++i) {
+            // Note that there cannot be contention in the following method as
+            // no two pile-ups are advanced at the same time.
+            statuses[i] = pile_ups[i]->DeformAndAdvanceTime(current_time_);
+          }
         }));
   }
 
   // Wait for the integrations to finish and figure out which vessels collided
   // with a celestial.
-  for (auto& pile_up_future : pile_up_futures) {
-    WaitForVesselToCatchUp(pile_up_future, collided_vessels);
+  for (auto const& future : futures) {
+    future.wait();
+  }
+  for (std::int64_t i = 0; i < pile_ups.size(); ++i) {
+    InsertCollidedVessels(*pile_ups[i], statuses[i], collided_vessels);
   }
 
-  // Update the vessels.
+  // While the game runs the rest of the frame, integrate the coasting pile-ups
+  // towards the time of the next frame, so that the next call to
+  // |CatchUpVessel| or |CatchUpLaggingVessels| only has to integrate a short
+  // correction to the actual time.
+  for (PileUp* const pile_up : pile_ups) {
+    pile_up->SpeculateAsynchronously(expected_next_time_, vessel_thread_pool_);
+  }
+
+  // Update the vessels.  Appending to the histories may downsample them, and
+  // their old parts are compacted according to the retention tiers, which is
+  // costly, so the vessels are advanced in parallel, in chunks like the
+  // pile-ups.  This is safe because a vessel only touches its own trajectories
+  // and those of its parts.
+  std::vector<Vessel*> lagging_vessels;
+  lagging_vessels.reserve(vessels_.size());
   for (auto const& pair : vessels_) {
     Vessel& vessel = *pair.second;
-    if (vessel.psychohistory().last().time() < current_time_) {
+    if (!is_asleep(&vessel) &&
+        vessel.psychohistory().last().time() < current_time_) {
       if (Contains(collided_vessels, &vessel)) {
         vessel.DisableDownsampling();
       }
-      vessel.AdvanceTime();
+      lagging_vessels.push_back(&vessel);
     }
   }
+  std::int64_t const number_of_vessel_chunks =
+      std::min<std::int64_t>(lagging_vessels.size(),
+                             chunks_per_thread * scheduler_.pool_size());
+  futures.clear();
+  futures.reserve(number_of_vessel_chunks);
+  for (std::int64_t chunk = 0; chunk < number_of_vessel_chunks; ++chunk) {
+    std::int64_t const begin =
+        chunk * lagging_vessels.size() / number_of_vessel_chunks;
+    std::int64_t const end =
+        (chunk + 1) * lagging_vessels.size() / number_of_vessel_chunks;
+    futures.push_back(scheduler_.Add([this, begin, end, &lagging_vessels]() {
+      for (std::int64_t i = begin; i < end; ++i) {
+        lagging_vessels[i]->AdvanceTime();
+        lagging_vessels[i]->CompactHistory(current_time_);
+      }
+    }));
+  }
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  UpdateVesselParents();
 }
 
 not_null<std::unique_ptr<PileUpFuture>> Plugin::CatchUpVessel(
@@ -740,50 +1001,154 @@ not_null<std::unique_ptr<PileUpFuture>> Plugin::CatchUpVessel(
 
   // Find the vessel and the pile-up that contains it.
   Vessel& vessel = *FindOrDie(vessels_, vessel_guid);
+  sleeping_vessels_.erase(&vessel);
   PileUp* pile_up = nullptr;
   vessel.ForSomePart([&pile_up](Part& part) {
     pile_up = part.containing_pile_up();
   });
 
+  // If several vessels of the same pile-up are caught up, the pile-up is only
+  // integrated once and they all share the result.
   return make_not_null_unique<PileUpFuture>(
       pile_up,
-      vessel_thread_pool_.Add([this, pile_up, &vessel]() {
-        // Note that there can be contention in the following method if the
-        // caller is catching-up two vessels belonging to the same pile-up in
-        // parallel.
-        Status const status = pile_up->DeformAndAdvanceTime(current_time_);
-        if (status.error() == Error::OUT_OF_RANGE) {
-          vessel.DisableDownsampling();
-        }
-        vessel.AdvanceTime();
-        return status;
-      }));
+      &vessel,
+      pile_up->DeformAndAdvanceTimeOnce(current_time_, vessel_thread_pool_));
 }
 
 void Plugin::WaitForVesselToCatchUp(PileUpFuture& pile_up_future,
                                     VesselSet& collided_vessels) {
   PileUp const* const pile_up = pile_up_future.pile_up;
+  Vessel& vessel = *pile_up_future.vessel;
   auto& future = pile_up_future.future;
   future.wait();
-  if (future.get().error() == Error::OUT_OF_RANGE) {
-    for (not_null<Part*> const part : pile_up->parts()) {
-      not_null<Vessel*> const vessel =
-          FindOrDie(part_id_to_vessel_, part->part_id());
-      if (collided_vessels.insert(vessel).second) {
-        LOG(INFO) << "Vessel " << vessel->ShortDebugString()
-                  << " collided with a celestial";
-      }
+  Status const& status = future.get();
+  // The vessel is advanced here rather than in the pile-up integration, which
+  // is shared with the other vessels of the pile-up.  Waiting for it on a
+  // thread of |vessel_thread_pool_| could deadlock.
+  if (status.error() == Error::OUT_OF_RANGE) {
+    vessel.DisableDownsampling();
+  }
+  vessel.AdvanceTime();
+  InsertCollidedVessels(*pile_up, status, collided_vessels);
+}
+
+not_null<std::unique_ptr<FreefallFuture>> Plugin::FlowFreefalls(
+    Index const central_body_index,
+    std::vector<Freefall> const& freefalls) const {
+  CHECK(!initializing_);
+  auto future = make_not_null_unique<FreefallFuture>(freefalls.size());
+
+  // The frame is shared by the tasks, which must not touch the renderer.  The
+  // map from its axes to those of |World| doesn't depend on time, because the
+  // frame doesn't rotate with respect to |Barycentric|, so it is computed here.
+  auto const body_centred_inertial = std::make_shared<
+      BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation>>(
+      ephemeris_.get(),
+      FindOrDie(celestials_, central_body_index)->body());
+  RigidMotion<Navigation, World> const to_world(
+      RigidTransformation<Navigation, World>(
+          Navigation::origin,
+          World::origin,
+          renderer_->BarycentricToWorld(PlanetariumRotation()) *
+              body_centred_inertial->FromThisFrameAtTime(current_time_)
+                  .orthogonal_map()),
+      AngularVelocity<Navigation>{},
+      Velocity<Navigation>{});
+
+  // The valid freefalls grouped by initial time.  The indices in a group are
+  // sorted by final time.
+  std::map<Instant, std::vector<std::int64_t>> groups;
+  for (std::int64_t i = 0; i < freefalls.size(); ++i) {
+    Freefall const& freefall = freefalls[i];
+    if (freefall.t_final < freefall.t_initial) {
+      future->results[i] = Status(Error::INVALID_ARGUMENT,
+                                  "Freefall backward in time");
+    } else if (freefall.t_initial < ephemeris_->t_min()) {
+      future->results[i] = Status(Error::OUT_OF_RANGE,
+                                  "Freefall before the ephemeris");
+    } else {
+      groups[freefall.t_initial].push_back(i);
     }
   }
+
+  auto const shared_freefalls =
+      std::make_shared<std::vector<Freefall> const>(freefalls);
+  for (auto& pair : groups) {
+    std::vector<std::int64_t>& indices = pair.second;
+    std::stable_sort(indices.begin(),
+                     indices.end(),
+                     [&freefalls](std::int64_t const left,
+                                  std::int64_t const right) {
+                       return freefalls[left].t_final <
+                              freefalls[right].t_final;
+                     });
+    // The results are not moved when |future| is, so the tasks may refer to
+    // them; the destructor of |future| waits for the tasks.
+    future->groups.push_back(scheduler_.Add(
+        [ephemeris = ephemeris_.get(),
+         parameters = prediction_parameters_,
+         body_centred_inertial,
+         to_world,
+         shared_freefalls,
+         indices = std::move(indices),
+         &results = future->results]() {
+          FlowFreefallGroup(ephemeris,
+                            parameters,
+                            *body_centred_inertial,
+                            to_world,
+                            *shared_freefalls,
+                            indices,
+                            results);
+        }));
+  }
+  return future;
+}
+
+void Plugin::PutVesselToSleep(GUID const& vessel_guid) {
+  CHECK(!initializing_);
+  sleeping_vessels_.insert(FindOrDie(vessels_, vessel_guid).get());
 }
 
 void Plugin::ForgetAllHistoriesBefore(Instant const& t) const {
   CHECK(!initializing_);
   CHECK_LT(t, current_time_);
-  ephemeris_->ForgetBefore(t);
+  // Forgetting years of history releases a lot of storage, so the ephemeris
+  // and the vessels forget in parallel, the vessels in chunks like in
+  // |AdvanceTime|.  This is safe because a vessel only touches its own
+  // trajectories.
+  std::vector<Vessel*> vessels;
+  vessels.reserve(vessels_.size());
   for (auto const& pair : vessels_) {
-    not_null<std::unique_ptr<Vessel>> const& vessel = pair.second;
-    vessel->ForgetBefore(t);
+    vessels.push_back(pair.second.get());
+  }
+  // The sleeping vessels are caught up from the end of their psychohistories
+  // when they wake up, so the ephemeris must not forget that part.
+  Instant ephemeris_forget_time = t;
+  for (not_null<Vessel*> const vessel : sleeping_vessels_) {
+    ephemeris_forget_time =
+        std::min(ephemeris_forget_time, vessel->psychohistory().last().time());
+  }
+  std::int64_t const number_of_vessel_chunks =
+      std::min<std::int64_t>(vessels.size(),
+                             chunks_per_thread * scheduler_.pool_size());
+  std::vector<Future<void>> futures;
+  futures.reserve(number_of_vessel_chunks + 1);
+  futures.push_back(scheduler_.Add([this, &ephemeris_forget_time]() {
+    ephemeris_->ForgetBefore(ephemeris_forget_time);
+  }));
+  for (std::int64_t chunk = 0; chunk < number_of_vessel_chunks; ++chunk) {
+    std::int64_t const begin =
+        chunk * vessels.size() / number_of_vessel_chunks;
+    std::int64_t const end =
+        (chunk + 1) * vessels.size() / number_of_vessel_chunks;
+    futures.push_back(scheduler_.Add([begin, end, &t, &vessels]() {
+      for (std::int64_t i = begin; i < end; ++i) {
+        vessels[i]->ForgetBefore(t);
+      }
+    }));
+  }
+  for (auto const& future : futures) {
+    future.wait();
   }
 }
 
@@ -791,16 +1156,21 @@ RelativeDegreesOfFreedom<AliceSun> Plugin::VesselFromParent(
     Index const parent_index,
     GUID const& vessel_guid) const {
   CHECK(!initializing_);
-  not_null<std::unique_ptr<Vessel>> const& vessel =
-      FindOrDie(vessels_, vessel_guid);
+  return VesselFromParent(parent_index, *FindOrDie(vessels_, vessel_guid));
+}
+
+RelativeDegreesOfFreedom<AliceSun> Plugin::VesselFromParent(
+    Index const parent_index,
+    Vessel& vessel) const {
+  CHECK(!initializing_);
   not_null<Celestial const*> parent =
       FindOrDie(celestials_, parent_index).get();
-  if (vessel->parent() != parent) {
-    vessel->set_parent(parent);
+  if (vessel.parent() != parent) {
+    vessel.set_parent(parent);
   }
   RelativeDegreesOfFreedom<Barycentric> const barycentric_result =
-      vessel->psychohistory().last().degrees_of_freedom() -
-      vessel->parent()->current_degrees_of_freedom(current_time_);
+      vessel.psychohistory().last().degrees_of_freedom() -
+      vessel.parent()->current_degrees_of_freedom(current_time_);
   RelativeDegreesOfFreedom<AliceSun> const result =
       PlanetariumRotation()(barycentric_result);
   return result;
@@ -821,25 +1191,113 @@ RelativeDegreesOfFreedom<AliceSun> Plugin::CelestialFromParent(
   return result;
 }
 
+std::vector<Plugin::CelestialState> Plugin::CelestialStates(
+    std::vector<Index> const& indices) const {
+  CHECK(!initializing_);
+  std::vector<CelestialState> states;
+  states.reserve(indices.size());
+  for (Index const index : indices) {
+    Celestial const& celestial = *FindOrDie(celestials_, index);
+    states.push_back(
+        {CelestialRotation(index),
+         celestial.has_parent()
+             ? std::make_optional(CelestialFromParent(index))
+             : std::nullopt});
+  }
+  return states;
+}
+
+std::vector<Plugin::VesselState> Plugin::VesselStates(
+    std::vector<GUID> const& vessel_guids) const {
+  CHECK(!initializing_);
+  std::vector<VesselState> states;
+  states.reserve(vessel_guids.size());
+  for (GUID const& vessel_guid : vessel_guids) {
+    Vessel const& vessel = *FindOrDie(vessels_, vessel_guid);
+    RelativeDegreesOfFreedom<Barycentric> const barycentric_from_parent =
+        vessel.psychohistory().last().degrees_of_freedom() -
+        vessel.parent()->current_degrees_of_freedom(current_time_);
+    states.push_back({CelestialIndexOfBody(*vessel.parent()->body()),
+                      PlanetariumRotation()(barycentric_from_parent)});
+  }
+  return states;
+}
+
 void Plugin::SetPredictionAdaptiveStepParameters(
     GUID const& vessel_guid,
     Ephemeris<Barycentric>::AdaptiveStepParameters const&
         prediction_adaptive_step_parameters) const {
-  // If there is a target vessel, it is integrated with the same parameters as
-  // the given (current) vessel.  This makes it possible to plot the prediction
-  // of the current vessel.
-  if (renderer_->HasTargetVessel()) {
-    renderer_->GetTargetVessel().set_prediction_adaptive_step_parameters(
-        prediction_adaptive_step_parameters);
-  }
+  // The parameters of the target vessel, if any, are not changed: they are
+  // those of its level of detail, see |UpdatePrediction|.
   FindOrDie(vessels_, vessel_guid)
       ->set_prediction_adaptive_step_parameters(
           prediction_adaptive_step_parameters);
 }
 
-void Plugin::UpdatePrediction(GUID const& vessel_guid) const {
+void Plugin::UpdatePrediction(
+    GUID const& vessel_guid,
+    PredictionLevelOfDetail const level_of_detail) const {
   CHECK(!initializing_);
-  FindOrDie(vessels_, vessel_guid)->FlowPrediction(InfiniteFuture);
+  Vessel& vessel = *FindOrDie(vessels_, vessel_guid);
+  int weight;
+  switch (level_of_detail) {
+    case PredictionLevelOfDetail::Full:
+      weight = full_prediction_weight;
+      break;
+    case PredictionLevelOfDetail::Medium: {
+      weight = 1;
+      auto parameters = prediction_parameters_;
+      parameters.set_max_steps(std::max<std::int64_t>(
+          parameters.max_steps() / medium_prediction_steps_divisor, 1));
+      parameters.set_length_integration_tolerance(
+          parameters.length_integration_tolerance() *
+          medium_prediction_tolerance_factor);
+      parameters.set_speed_integration_tolerance(
+          parameters.speed_integration_tolerance() *
+          medium_prediction_tolerance_factor);
+      // Setting the parameters invalidates the prediction, so only do it if the
+      // level of detail of the vessel changed.
+      auto const& vessel_parameters =
+          vessel.prediction_adaptive_step_parameters();
+      if (&vessel_parameters.integrator() != &parameters.integrator() ||
+          vessel_parameters.max_steps() != parameters.max_steps() ||
+          vessel_parameters.length_integration_tolerance() !=
+              parameters.length_integration_tolerance() ||
+          vessel_parameters.speed_integration_tolerance() !=
+              parameters.speed_integration_tolerance()) {
+        vessel.set_prediction_adaptive_step_parameters(parameters);
+      }
+      break;
+    }
+  }
+  if (!prediction_frame_budget_.has_value()) {
+    vessel.RefreshPrediction(&scheduler_);
+    return;
+  }
+  int const remaining_weight =
+      std::max(prediction_weight_in_previous_frame_ -
+                   prediction_weight_in_frame_,
+               weight);
+  auto const start = std::chrono::steady_clock::now();
+  vessel.RefreshPrediction(
+      &scheduler_,
+      start + prediction_budget_left_ * weight / remaining_weight);
+  prediction_budget_left_ =
+      std::max(prediction_budget_left_ - (std::chrono::steady_clock::now() -
+                                          start),
+               std::chrono::steady_clock::duration::zero());
+  prediction_weight_in_frame_ += weight;
+}
+
+void Plugin::SetPredictionFrameBudget(
+    std::optional<std::chrono::steady_clock::duration> const& budget) {
+  prediction_frame_budget_ = budget;
+  prediction_budget_left_ = budget.value_or(
+      std::chrono::steady_clock::duration::zero());
+}
+
+void Plugin::SetPersistFlightPlanSegments(bool const persist) {
+  persist_flight_plan_segments_ = persist;
 }
 
 void Plugin::CreateFlightPlan(GUID const& vessel_guid,
@@ -852,6 +1310,31 @@ void Plugin::CreateFlightPlan(GUID const& vessel_guid,
       prediction_parameters_);
 }
 
+std::vector<std::optional<FlightPlan::Alternative>>
+Plugin::IntegrateFlightPlanAlternativesToLast(GUID const& vessel_guid,
+                                              std::vector<Burn> burns) const {
+  CHECK(!initializing_);
+  return FindOrDie(vessels_, vessel_guid)->flight_plan().
+      IntegrateAlternativesToLast(std::move(burns), &scheduler_);
+}
+
+Status Plugin::OptimizeFlightPlanClosestApproach(
+    GUID const& vessel_guid,
+    Index const celestial_index,
+    Length const& distance,
+    Length const& tolerance) const {
+  CHECK(!initializing_);
+  FlightPlanOptimizer optimizer(
+      &FindOrDie(vessels_, vessel_guid)->flight_plan(),
+      ephemeris_.get(),
+      &scheduler_);
+  return optimizer.Optimize(
+      FlightPlanOptimizer::DistanceOfClosestApproach(
+          FindOrDie(celestials_, celestial_index)->trajectory(),
+          distance),
+      tolerance);
+}
+
 void Plugin::ComputeAndRenderApsides(
     Index const celestial_index,
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
@@ -864,6 +1347,7 @@ void Plugin::ComputeAndRenderApsides(
   ComputeApsides(FindOrDie(celestials_, celestial_index)->trajectory(),
                  begin,
                  end,
+                 &scheduler_,
                  apoapsides_trajectory,
                  periapsides_trajectory);
   apoapsides = renderer_->RenderBarycentricTrajectoryInWorld(
@@ -892,6 +1376,7 @@ void Plugin::ComputeAndRenderClosestApproaches(
   ComputeApsides(renderer_->GetTargetVesselPrediction(current_time_),
                  begin,
                  end,
+                 &scheduler_,
                  apoapsides_trajectory,
                  periapsides_trajectory);
   closest_approaches =
@@ -917,6 +1402,7 @@ void Plugin::ComputeAndRenderNodes(
   ComputeNodes(trajectory_in_plotting->Begin(),
                trajectory_in_plotting->End(),
                Vector<double, Navigation>({0, 0, 1}),
+               &scheduler_,
                ascending_trajectory,
                descending_trajectory);
   ascending = renderer_->RenderPlottingTrajectoryInWorld(
@@ -960,67 +1446,83 @@ not_null<Vessel*> Plugin::GetVessel(GUID const& vessel_guid) const {
   return FindOrDie(vessels_, vessel_guid).get();
 }
 
+VesselHandle Plugin::GetVesselHandle(GUID const& vessel_guid) {
+  CHECK(!initializing_);
+  not_null<Vessel*> const vessel = FindOrDie(vessels_, vessel_guid).get();
+  auto const [it, inserted] =
+      vessel_handles_.emplace(vessel, vessels_by_handle_.size());
+  if (inserted) {
+    vessels_by_handle_.push_back(vessel);
+  }
+  return it->second;
+}
+
+bool Plugin::HasVesselWithHandle(VesselHandle const vessel_handle) const {
+  return vessel_handle >= 0 &&
+         vessel_handle < vessels_by_handle_.size() &&
+         vessels_by_handle_[vessel_handle] != nullptr;
+}
+
+not_null<Vessel*> Plugin::GetVesselWithHandle(
+    VesselHandle const vessel_handle) const {
+  CHECK(!initializing_);
+  CHECK(HasVesselWithHandle(vessel_handle)) << vessel_handle;
+  return vessels_by_handle_[vessel_handle];
+}
+
 not_null<std::unique_ptr<Planetarium>> Plugin::NewPlanetarium(
     Planetarium::Parameters const& parameters,
     Perspective<Navigation, Camera> const& perspective)
     const {
+  PublishRenderSnapshot();
   return make_not_null_unique<Planetarium>(parameters,
                                            perspective,
                                            ephemeris_.get(),
                                            renderer_->GetPlottingFrame());
 }
 
+void Plugin::UpdatePlanetarium(
+    Planetarium::Parameters const& parameters,
+    Perspective<Navigation, Camera> const& perspective,
+    not_null<Planetarium*> const planetarium) const {
+  PublishRenderSnapshot();
+  planetarium->UpdatePerspective(parameters,
+                                 perspective,
+                                 renderer_->GetPlottingFrame());
+}
+
+std::shared_ptr<RenderSnapshot const> Plugin::render_snapshot() const {
+  return std::atomic_load(&render_snapshot_);
+}
+
 not_null<std::unique_ptr<NavigationFrame>>
 Plugin::NewBarycentricRotatingNavigationFrame(
     Index const primary_index,
     Index const secondary_index) const {
-  CHECK(!initializing_);
-  // TODO(egg): these should be const, use a custom comparator in the map.
-  Celestial const& primary = *FindOrDie(celestials_, primary_index);
-  Celestial const& secondary = *FindOrDie(celestials_, secondary_index);
-  return make_not_null_unique<
-      BarycentricRotatingDynamicFrame<Barycentric, Navigation>>(
-          ephemeris_.get(),
-          primary.body(),
-          secondary.body());
+  return NewSharedNavigationFrame<BarycentricRotatingDynamicFrame>(
+      primary_index, secondary_index);
 }
 
 not_null<std::unique_ptr<NavigationFrame>>
 Plugin::NewBodyCentredBodyDirectionNavigationFrame(
     Index const primary_index,
     Index const secondary_index) const {
-  CHECK(!initializing_);
-  // TODO(egg): these should be const, use a custom comparator in the map.
-  Celestial const& primary = *FindOrDie(celestials_, primary_index);
-  Celestial const& secondary = *FindOrDie(celestials_, secondary_index);
-  return make_not_null_unique<
-      BodyCentredBodyDirectionDynamicFrame<Barycentric, Navigation>>(
-          ephemeris_.get(),
-          primary.body(),
-          secondary.body());
+  return NewSharedNavigationFrame<BodyCentredBodyDirectionDynamicFrame>(
+      primary_index, secondary_index);
 }
 
 not_null<std::unique_ptr<NavigationFrame>>
 Plugin::NewBodyCentredNonRotatingNavigationFrame(
     Index const reference_body_index) const {
-  CHECK(!initializing_);
-  Celestial const& reference_body =
-      *FindOrDie(celestials_, reference_body_index);
-  return make_not_null_unique<
-      BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation>>(
-          ephemeris_.get(),
-          reference_body.body());
+  return NewSharedNavigationFrame<BodyCentredNonRotatingDynamicFrame>(
+      reference_body_index);
 }
 
 not_null<std::unique_ptr<NavigationFrame>>
 Plugin::NewBodySurfaceNavigationFrame(
     Index const reference_body_index) const {
-  CHECK(!initializing_);
-  Celestial const& reference_body =
-      *FindOrDie(celestials_, reference_body_index);
-  return make_not_null_unique<BodySurfaceDynamicFrame<Barycentric, Navigation>>(
-      ephemeris_.get(),
-      reference_body.body());
+  return NewSharedNavigationFrame<BodySurfaceDynamicFrame>(
+      reference_body_index);
 }
 
 void Plugin::SetTargetVessel(GUID const& vessel_guid,
@@ -1107,9 +1609,15 @@ std::unique_ptr<FrameField<World, Navball>> Plugin::NavballFrameField(
   };
 
   std::unique_ptr<FrameField<Navigation, RightHandedNavball>> frame_field;
+  NavigationFrame const* plotting_frame = renderer_->GetPlottingFrame();
+  if (auto* const shared_plotting_frame =
+          dynamic_cast<SharedDynamicFrame<Barycentric, Navigation> const*>(
+              plotting_frame)) {
+    plotting_frame = &shared_plotting_frame->frame();
+  }
   auto* const plotting_frame_as_body_surface_dynamic_frame =
       dynamic_cast<BodySurfaceDynamicFrame<Barycentric, Navigation> const*>(
-          &*renderer_->GetPlottingFrame());
+          plotting_frame);
   if (plotting_frame_as_body_surface_dynamic_frame == nullptr) {
     return std::make_unique<NavballFrameField>(
         this,
@@ -1129,20 +1637,32 @@ std::unique_ptr<FrameField<World, Navball>> Plugin::NavballFrameField(
 }
 
 Vector<double, World> Plugin::VesselTangent(GUID const& vessel_guid) const {
+  return VesselTangent(*FindOrDie(vessels_, vessel_guid));
+}
+
+Vector<double, World> Plugin::VesselTangent(Vessel const& vessel) const {
   return renderer_->FrenetToWorld(
-      *FindOrDie(vessels_, vessel_guid),
+      vessel,
       PlanetariumRotation())(Vector<double, Frenet<Navigation>>({1, 0, 0}));
 }
 
 Vector<double, World> Plugin::VesselNormal(GUID const& vessel_guid) const {
+  return VesselNormal(*FindOrDie(vessels_, vessel_guid));
+}
+
+Vector<double, World> Plugin::VesselNormal(Vessel const& vessel) const {
   return renderer_->FrenetToWorld(
-      *FindOrDie(vessels_, vessel_guid),
+      vessel,
       PlanetariumRotation())(Vector<double, Frenet<Navigation>>({0, 1, 0}));
 }
 
 Vector<double, World> Plugin::VesselBinormal(GUID const& vessel_guid) const {
+  return VesselBinormal(*FindOrDie(vessels_, vessel_guid));
+}
+
+Vector<double, World> Plugin::VesselBinormal(Vessel const& vessel) const {
   return renderer_->FrenetToWorld(
-      *FindOrDie(vessels_, vessel_guid),
+      vessel,
       PlanetariumRotation())(Vector<double, Frenet<Navigation>>({0, 0, 1}));
 }
 
@@ -1159,7 +1679,10 @@ Velocity<World> Plugin::UnmanageableVesselVelocity(
 }
 
 Velocity<World> Plugin::VesselVelocity(GUID const& vessel_guid) const {
-  Vessel const& vessel = *FindOrDie(vessels_, vessel_guid);
+  return VesselVelocity(*FindOrDie(vessels_, vessel_guid));
+}
+
+Velocity<World> Plugin::VesselVelocity(Vessel const& vessel) const {
   auto const& last = vessel.psychohistory().last();
   return VesselVelocity(last.time(), last.degrees_of_freedom());
 }
@@ -1180,6 +1703,33 @@ Renderer& Plugin::renderer() {
   return *renderer_;
 }
 
+Plugin::MemoryReport Plugin::MemoryUsage() const {
+  CHECK(!initializing_);
+  MemoryReport report;
+  for (auto const& pair : celestials_) {
+    Index const index = pair.first;
+    auto const& trajectory = pair.second->trajectory();
+    report.celestials[index] = {trajectory.number_of_polynomials(),
+                                trajectory.polynomials_memory_footprint()};
+  }
+  for (auto const& pair : vessels_) {
+    GUID const& guid = pair.first;
+    Vessel const& vessel = *pair.second;
+    report.vessel_histories[guid] = {vessel.trajectories_size(),
+                                     vessel.trajectories_memory_footprint()};
+    if (vessel.has_flight_plan()) {
+      FlightPlan const& flight_plan = vessel.flight_plan();
+      report.flight_plans[guid] = {flight_plan.number_of_points(),
+                                   flight_plan.memory_footprint()};
+    }
+  }
+  return report;
+}
+
+WorkStealingScheduler const& Plugin::scheduler() const {
+  return scheduler_;
+}
+
 Renderer const& Plugin::renderer() const {
   return *renderer_;
 }
@@ -1220,6 +1770,11 @@ void Plugin::WriteToMessage(
         return serialization_index_to_pile_up.at(pile_up);
       };
 
+  // The vessels, the ephemeris and the renderer are written in parallel.  The
+  // submessages are all created on this thread, each writer then fills its
+  // own submessage.
+  std::vector<std::function<void()>> writers;
+
   std::map<not_null<Vessel const*>, GUID const> vessel_to_guid;
   for (auto const& pair : vessels_) {
     std::string const& guid = pair.first;
@@ -1227,8 +1782,16 @@ void Plugin::WriteToMessage(
     vessel_to_guid.emplace(vessel, guid);
     auto* const vessel_message = message->add_vessel();
     vessel_message->set_guid(guid);
-    vessel->WriteToMessage(vessel_message->mutable_vessel(),
-                           serialization_index_for_pile_up);
+    writers.push_back([this,
+                       vessel,
+                       message = vessel_message->mutable_vessel(),
+                       &serialization_index_for_pile_up]() {
+      vessel->WriteToMessage(message, serialization_index_for_pile_up);
+      if (persist_flight_plan_segments_ && vessel->has_flight_plan()) {
+        vessel->flight_plan().WriteSegmentsToMessage(
+            message->mutable_flight_plan());
+      }
+    });
     Index const parent_index = FindOrDie(celestial_to_index, vessel->parent());
     vessel_message->set_parent_index(parent_index);
     vessel_message->set_loaded(Contains(loaded_vessels_, vessel));
@@ -1240,7 +1803,9 @@ void Plugin::WriteToMessage(
     (*message->mutable_part_id_to_vessel())[part_id] = vessel_to_guid[vessel];
   }
 
-  ephemeris_->WriteToMessage(message->mutable_ephemeris());
+  writers.push_back([this, message = message->mutable_ephemeris()]() {
+    ephemeris_->WriteToMessage(message);
+  });
 
   history_parameters_.WriteToMessage(message->mutable_history_parameters());
   psychohistory_parameters_.WriteToMessage(
@@ -1253,11 +1818,24 @@ void Plugin::WriteToMessage(
   current_time_.WriteToMessage(message->mutable_current_time());
   Index const sun_index = FindOrDie(celestial_to_index, sun_);
   message->set_sun_index(sun_index);
-  renderer_->WriteToMessage(message->mutable_renderer());
+  writers.push_back([this, message = message->mutable_renderer()]() {
+    renderer_->WriteToMessage(message);
+  });
 
   for (auto* const pile_up : pile_ups_) {
     pile_up->WriteToMessage(message->add_pile_up());
   }
+
+  // Run the first writer on this thread and the others on the scheduler.
+  std::vector<Future<void>> futures;
+  futures.reserve(writers.size() - 1);
+  for (std::size_t i = 1; i < writers.size(); ++i) {
+    futures.push_back(scheduler_.Add(writers[i]));
+  }
+  writers[0]();
+  for (auto const& future : futures) {
+    future.wait();
+  }
 }
 
 not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
@@ -1280,15 +1858,22 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
 
   plugin->ephemeris_ =
       Ephemeris<Barycentric>::ReadFromMessage(message.ephemeris());
+  plugin->ephemeris_->StartBackgroundProlongation(
+      default_ephemeris_prolongation_horizon);
   ReadCelestialsFromMessages(*plugin->ephemeris_,
                              message.celestial(),
                              plugin->celestials_,
                              plugin->name_to_index_);
 
-  for (auto const& vessel_message : message.vessel()) {
+  // The vessels are independent of each other, and their histories are the
+  // bulk of the message, so they are read in parallel.  The calling thread
+  // reads the first one.
+  std::vector<std::unique_ptr<Vessel>> vessels(message.vessel_size());
+  auto const read_vessel = [&message, &plugin, &vessels](int const i) {
+    auto const& vessel_message = message.vessel(i);
     not_null<Celestial const*> const parent =
         FindOrDie(plugin->celestials_, vessel_message.parent_index()).get();
-    not_null<std::unique_ptr<Vessel>> vessel = Vessel::ReadFromMessage(
+    vessels[i] = Vessel::ReadFromMessage(
         vessel_message.vessel(),
         parent,
         plugin->ephemeris_.get(),
@@ -1296,6 +1881,24 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
             PartId const part_id) {
           CHECK_NE(part_id_to_vessel.erase(part_id), 0) << part_id;
         });
+  };
+  {
+    std::vector<Future<void>> futures;
+    for (int i = 1; i < message.vessel_size(); ++i) {
+      futures.push_back(
+          plugin->scheduler_.Add([&read_vessel, i]() { read_vessel(i); }));
+    }
+    if (message.vessel_size() > 0) {
+      read_vessel(0);
+    }
+    for (auto const& future : futures) {
+      future.wait();
+    }
+  }
+
+  for (int i = 0; i < message.vessel_size(); ++i) {
+    auto const& vessel_message = message.vessel(i);
+    not_null<std::unique_ptr<Vessel>> vessel = std::move(vessels[i]);
 
     if (vessel_message.loaded()) {
       plugin->loaded_vessels_.insert(vessel.get());
@@ -1382,6 +1985,11 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
                                              pile_up_for_serialization_index);
   }
 
+  // The ephemeris may still be recomputing its trajectories in the background,
+  // which overlapped with the reading of the vessels.  The clients evaluate it
+  // at the current time without prolonging it, so wait for it here.
+  plugin->ephemeris_->Prolong(plugin->current_time_);
+
   plugin->initializing_.Flop();
   return plugin;
 }
@@ -1394,8 +2002,9 @@ Plugin::Plugin(
     : history_parameters_(history_parameters),
       psychohistory_parameters_(psychohistory_parameters),
       prediction_parameters_(prediction_parameters),
-      vessel_thread_pool_(
-          /*pool_size=*/2 * std::thread::hardware_concurrency()) {}
+      scheduler_(/*pool_size=*/ConfiguredPoolSize(std::max(
+          2 * static_cast<int>(std::thread::hardware_concurrency()), 1))),
+      vessel_thread_pool_(&scheduler_) {}
 
 void Plugin::InitializeIndices(
     std::string const& name,
@@ -1413,6 +2022,42 @@ void Plugin::InitializeIndices(
   CHECK(inserted) << celestial_index;
 }
 
+void Plugin::CacheCelestialDegreesOfFreedom() {
+  std::vector<Future<void>> futures;
+  futures.reserve(celestials_.size());
+  for (auto const& pair : celestials_) {
+    not_null<Celestial*> const celestial = pair.second.get();
+    futures.push_back(
+        scheduler_.Add([this, celestial]() {
+          // Note that there cannot be contention here as each task touches a
+          // single celestial.
+          celestial->CacheDegreesOfFreedom(current_time_);
+        }));
+  }
+  for (auto const& future : futures) {
+    future.wait();
+  }
+}
+
+void Plugin::PublishRenderSnapshot() const {
+  // Only the vessels that were plotted using the previous snapshot are put in
+  // the new one.  A vessel that starts being plotted is therefore missing from
+  // the plots of one frame.
+  std::vector<not_null<Vessel const*>> vessels;
+  auto const previous_render_snapshot = std::atomic_load(&render_snapshot_);
+  if (previous_render_snapshot != nullptr) {
+    for (GUID const& guid : previous_render_snapshot->plotted_vessels()) {
+      auto const it = vessels_.find(guid);
+      if (it != vessels_.end()) {
+        vessels.push_back(it->second.get());
+      }
+    }
+  }
+  std::atomic_store(
+      &render_snapshot_,
+      std::make_shared<RenderSnapshot const>(current_time_, vessels));
+}
+
 void Plugin::UpdatePlanetariumRotation() {
   // The z axis of |PlanetariumFrame| is the pole of |main_body_|, and its x
   // axis is the origin of body rotation (the intersection between the
@@ -1484,6 +2129,27 @@ void Plugin::ReadCelestialsFromMessages(
   }
 }
 
+template<template<typename, typename> class ConcreteFrame,
+         typename... Indices>
+not_null<std::unique_ptr<NavigationFrame>> Plugin::NewSharedNavigationFrame(
+    Indices const... indices) const {
+  CHECK(!initializing_);
+  std::pair<std::type_index, std::vector<Index>> key(
+      typeid(ConcreteFrame<Barycentric, Navigation>), {indices...});
+  std::lock_guard<std::mutex> l(navigation_frames_lock_);
+  auto it = navigation_frames_.find(key);
+  if (it == navigation_frames_.end()) {
+    std::shared_ptr<NavigationFrame const> const frame =
+        std::make_shared<ConcreteFrame<Barycentric, Navigation>>(
+            ephemeris_.get(),
+            FindOrDie(celestials_, indices)->body()...);
+    it = navigation_frames_.emplace(std::move(key), check_not_null(frame))
+             .first;
+  }
+  return make_not_null_unique<SharedDynamicFrame<Barycentric, Navigation>>(
+      it->second);
+}
+
 void Plugin::AddPart(not_null<Vessel*> const vessel,
                      PartId const part_id,
                      std::string const& name,
@@ -1504,10 +2170,136 @@ void Plugin::AddPart(not_null<Vessel*> const vessel,
   vessel->AddPart(std::move(part));
 }
 
+void Plugin::InsertCollidedVessels(PileUp const& pile_up,
+                                   Status const& status,
+                                   VesselSet& collided_vessels) const {
+  if (status.error() == Error::OUT_OF_RANGE) {
+    for (not_null<Part*> const part : pile_up.parts()) {
+      not_null<Vessel*> const vessel =
+          FindOrDie(part_id_to_vessel_, part->part_id());
+      if (collided_vessels.insert(vessel).second) {
+        LOG(INFO) << "Vessel " << vessel->ShortDebugString()
+                  << " collided with a celestial";
+      }
+    }
+  }
+}
+
+void Plugin::UpdateVesselParents() {
+  // The radii of the spheres of influence of the celestials other than the
+  // sun, r = a (m / M)^(2/5), where a is the osculating semimajor axis around
+  // the parent, and the children of each celestial.
+  std::map<not_null<Celestial const*>, Length> radii;
+  std::map<not_null<Celestial const*>, std::vector<not_null<Celestial const*>>>
+      children;
+  for (auto const& pair : celestials_) {
+    Celestial const& celestial = *pair.second;
+    if (!celestial.has_parent()) {
+      continue;
+    }
+    Celestial const& parent = *celestial.parent();
+    children[&parent].push_back(&celestial);
+    GravitationalParameter const μ =
+        parent.body()->gravitational_parameter() +
+        celestial.body()->gravitational_parameter();
+    RelativeDegreesOfFreedom<Barycentric> const from_parent =
+        celestial.current_degrees_of_freedom(current_time_) -
+        parent.current_degrees_of_freedom(current_time_);
+    SpecificEnergy const ε = from_parent.velocity().Norm²() / 2 -
+                             μ / from_parent.displacement().Norm();
+    // A celestial on an escape trajectory, which doesn't happen in the stock
+    // game, keeps all the vessels that enter its sphere of influence.
+    Length const a = ε < SpecificEnergy() ? -μ / (2 * ε) : Infinity<Length>();
+    radii.emplace(&celestial,
+                  a * std::pow(celestial.body()->mass() / parent.body()->mass(),
+                               0.4));
+  }
+
+  for (auto const& pair : vessels_) {
+    not_null<Vessel*> const vessel = pair.second.get();
+    auto const& last = vessel->psychohistory().last();
+    if (last.time() != current_time_) {
+      // Asleep, or not caught up yet.
+      continue;
+    }
+    auto const it = next_parent_checks_.find(vessel);
+    if (it != next_parent_checks_.end() && it->second > current_time_) {
+      continue;
+    }
+    DegreesOfFreedom<Barycentric> const degrees_of_freedom =
+        last.degrees_of_freedom();
+    auto const distance = [this, &degrees_of_freedom](
+                              not_null<Celestial const*> const celestial) {
+      return (degrees_of_freedom.position() -
+              celestial->current_position(current_time_)).Norm();
+    };
+
+    // Go up the hierarchy while the vessel is outside the sphere of influence
+    // of its parent, and then down while it is inside that of a child.
+    not_null<Celestial const*> parent = vessel->parent();
+    while (parent->has_parent() && distance(parent) > radii.at(parent)) {
+      parent = parent->parent();
+    }
+    for (bool descended = true; descended;) {
+      descended = false;
+      for (not_null<Celestial const*> const child : children[parent]) {
+        if (distance(child) < radii.at(child)) {
+          parent = child;
+          descended = true;
+          break;
+        }
+      }
+    }
+    if (vessel->parent() != parent) {
+      vessel->set_parent(parent);
+    }
+
+    // The distance to the nearest boundary changes at most at the speed of the
+    // vessel relative to the parent plus that of the fastest child; the
+    // factor 2 leaves room for the accelerations.
+    Velocity<Barycentric> const parent_velocity =
+        parent->current_velocity(current_time_);
+    Length margin = parent->has_parent()
+                        ? radii.at(parent) - distance(parent)
+                        : Infinity<Length>();
+    Speed closing_speed =
+        (degrees_of_freedom.velocity() - parent_velocity).Norm();
+    Speed fastest_child_speed;
+    for (not_null<Celestial const*> const child : children[parent]) {
+      margin = std::min(margin, distance(child) - radii.at(child));
+      fastest_child_speed = std::max(
+          fastest_child_speed,
+          (child->current_velocity(current_time_) - parent_velocity).Norm());
+    }
+    closing_speed += fastest_child_speed;
+    // Written so that a NaN, e.g., for a vessel at rest on a boundary, results
+    // in the maximal interval.
+    Time const time_to_boundary = margin / (2 * closing_speed);
+    next_parent_checks_[vessel] =
+        current_time_ + (time_to_boundary < max_time_between_parent_checks
+                             ? time_to_boundary
+                             : max_time_between_parent_checks);
+  }
+}
+
+void Plugin::ReleaseVesselHandle(not_null<Vessel const*> const vessel) {
+  auto const it = vessel_handles_.find(vessel);
+  if (it != vessel_handles_.end()) {
+    vessels_by_handle_[it->second] = nullptr;
+    vessel_handles_.erase(it);
+  }
+}
+
 bool Plugin::is_loaded(not_null<Vessel*> vessel) const {
   return Contains(loaded_vessels_, vessel);
 }
 
+bool Plugin::is_asleep(not_null<Vessel*> vessel) const {
+  return Contains(sleeping_vessels_, vessel) && !is_loaded(vessel) &&
+         !(renderer_->HasTargetVessel() &&
+           vessel == &renderer_->GetTargetVessel());
+}
+
 }  // namespace internal_plugin
 }  // namespace ksp_plugin
 }  // namespace principia
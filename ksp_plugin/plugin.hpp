@@ -1,20 +1,25 @@
 ﻿
 #pragma once
 
-#include <future>
+#include <chrono>
 #include <limits>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
+#include <typeindex>
 #include <utility>
 #include <vector>
 
+#include "base/macros.hpp"
 #include "base/monostable.hpp"
 #include "base/status.hpp"
+#include "base/status_or.hpp"
 #include "base/thread_pool.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "geometry/affine_map.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/perspective.hpp"
@@ -23,6 +28,7 @@
 #include "ksp_plugin/frames.hpp"
 #include "ksp_plugin/manœuvre.hpp"
 #include "ksp_plugin/planetarium.hpp"
+#include "ksp_plugin/render_snapshot.hpp"
 #include "ksp_plugin/renderer.hpp"
 #include "ksp_plugin/vessel.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
@@ -46,10 +52,13 @@ namespace principia {
 namespace ksp_plugin {
 namespace internal_plugin {
 
+using base::Future;
 using base::not_null;
 using base::Status;
+using base::StatusOr;
 using base::Subset;
 using base::ThreadPool;
+using base::WorkStealingScheduler;
 using geometry::AffineMap;
 using geometry::AngularVelocity;
 using geometry::Displacement;
@@ -89,6 +98,48 @@ using quantities::si::Second;
 // |b.flightGlobalsIndex| in C#. We use this as a key in an |std::map|.
 using Index = int;
 
+// A dense integer designating a vessel at the interface boundary.  It may be
+// used instead of the GUID of the vessel on the hot paths to avoid marshalling
+// and comparing strings.  Handles are never reused.
+using VesselHandle = int;
+
+// A massless body in freefall, whose degrees of freedom, in |World|
+// coordinates centred on some celestial and non-rotating, are
+// |initial_degrees_of_freedom| at |t_initial|, and are requested at |t_final|.
+struct Freefall {
+  DegreesOfFreedom<World> initial_degrees_of_freedom;
+  Instant t_initial;
+  Instant t_final;
+};
+
+// The result of |Plugin::FlowFreefalls|.  The |results| are indexed like the
+// freefalls and are filled asynchronously by the tasks that compute the
+// |groups|: they must not be accessed before |is_ready| returns true or |wait|
+// returns.  The destructor waits for the tasks.
+struct FreefallFuture {
+  explicit FreefallFuture(std::int64_t size);
+  ~FreefallFuture();
+
+  bool is_ready() const;
+  void wait() const;
+
+  std::vector<Future<void>> groups;
+  std::vector<StatusOr<DegreesOfFreedom<World>>> results;
+};
+
+// The level of detail of the prediction of a vessel, which reflects its
+// relevance to the player.  The more detailed predictions also get a larger
+// share of the frame budget.
+enum class PredictionLevelOfDetail {
+  // The prediction that the player is looking at, computed with the parameters
+  // of the vessel.
+  Full,
+  // A prediction that is merely displayed or used for secondary computations,
+  // e.g., that of the target vessel.  It is computed with the parameters of the
+  // plugin, shortened and with looser tolerances.
+  Medium,
+};
+
 class Plugin {
  public:
   Plugin() = delete;
@@ -125,6 +176,11 @@ class Plugin {
 
   virtual void InitializeEphemerisParameters(
       Ephemeris<Barycentric>::FixedStepParameters const& parameters);
+  // The ephemeris parameters are selected among the |candidates| by
+  // |EndInitialization| based on their accuracy and speed on this machine.
+  virtual void InitializeEphemerisParametersCandidates(
+      std::vector<Ephemeris<Barycentric>::FixedStepParameters> const&
+          candidates);
   virtual void InitializeHistoryParameters(
       Ephemeris<Barycentric>::FixedStepParameters const& parameters);
   virtual void InitializePsychohistoryParameters(
@@ -272,26 +328,52 @@ class Plugin {
 
   // Advances time to |current_time_| for all pile ups that are not already
   // there, filling the tails of all their parts up to that instant; then
-  // advances time on all vessels that are not yet at |current_time_|.  Inserts
+  // advances time on all vessels that are not yet at |current_time_|.  The
+  // vessels that are asleep, and their pile ups, are left behind.  Inserts
   // the set of vessels that have collided with a celestial into
   // |collided_vessels|.
   virtual void CatchUpLaggingVessels(VesselSet& collided_vessels);
 
+  // Puts the given vessel to sleep: its trajectories are not advanced by
+  // |CatchUpLaggingVessels| until it is woken up by |CatchUpVessel| or by
+  // being loaded by |InsertOrKeepVessel|.  The trajectories of a sleeping
+  // vessel end at the last time it was advanced, so the caller must not use
+  // its current state.  A vessel is never asleep while it is loaded or while
+  // it is the target vessel.
+  virtual void PutVesselToSleep(GUID const& vessel_guid);
+
   // Advances time to |current_time_| on the pile up containing the given
-  // vessel if the pile up is not there already, and advances time to
-  // |current_time_| on that vessel.  This operation is asynchronous: the caller
-  // must wait on the returned future before using the trajectories of the
+  // vessel if the pile up is not there already.  This operation is
+  // asynchronous, and is only performed once if this method is called for
+  // several vessels of the same pile up.  The caller must pass the returned
+  // future to |WaitForVesselToCatchUp| before using the trajectories of the
   // vessel.  The caller must ensure that the vessels don't change while this
   // method is running.
   virtual not_null<std::unique_ptr<PileUpFuture>> CatchUpVessel(
       GUID const& vessel_guid);
 
-  // Waits for the |future| to return and inserts the set of vessels that have
-  // collided with a celestial into |collided_vessels|.
+  // Waits for the |future| to return, advances time to |current_time_| on its
+  // vessel, and inserts the set of vessels that have collided with a celestial
+  // into |collided_vessels|.
   virtual void WaitForVesselToCatchUp(PileUpFuture& pile_up_future,
                                       VesselSet& collided_vessels);
 
+  // Integrates the |freefalls|, whose degrees of freedom are centred on the
+  // celestial with index |central_body_index|, in the gravitational potential
+  // of the ephemeris, using the prediction parameters.  This operation is
+  // asynchronous and executes on the scheduler of the plugin: it returns
+  // immediately, and the caller must not destroy the plugin before the result
+  // is ready.  The freefalls that start at the same time are integrated
+  // together, so that the positions of the celestials are evaluated once for
+  // all of them at each stage; a freefall that cannot be integrated, e.g.,
+  // because it collides with a celestial, doesn't affect the others.
+  virtual not_null<std::unique_ptr<FreefallFuture>> FlowFreefalls(
+      Index central_body_index,
+      std::vector<Freefall> const& freefalls) const;
+
   // Forgets the histories of the |celestials_| and of the vessels before |t|.
+  // The celestials keep their histories after the end of the psychohistory of
+  // any sleeping vessel, so that it may be caught up.
   virtual void ForgetAllHistoriesBefore(Instant const& t) const;
 
   // Returns the displacement and velocity of the vessel with GUID |vessel_guid|
@@ -303,6 +385,10 @@ class Plugin {
   virtual RelativeDegreesOfFreedom<AliceSun> VesselFromParent(
       Index parent_index,
       GUID const& vessel_guid) const;
+  // Same as above for the given |vessel|, which must be in the plugin.
+  RelativeDegreesOfFreedom<AliceSun> VesselFromParent(
+      Index parent_index,
+      Vessel& vessel) const;
 
   // Returns the displacement and velocity of the celestial at index
   // |celestial_index| relative to its parent at current time. For a KSP
@@ -313,18 +399,84 @@ class Plugin {
   virtual RelativeDegreesOfFreedom<AliceSun> CelestialFromParent(
       Index celestial_index) const;
 
+  // The state of a celestial at current time, see |CelestialStates|.
+  struct CelestialState final {
+    Rotation<BodyWorld, World> rotation;
+    // Empty for the sun.
+    std::optional<RelativeDegreesOfFreedom<AliceSun>> from_parent;
+  };
+
+  // Returns the |CelestialRotation| and the |CelestialFromParent| of each of
+  // the celestials with the given |indices|.  The trajectories of the
+  // celestials are evaluated once per frame, in parallel, by |AdvanceTime|, so
+  // this function doesn't evaluate them.  Must be called after initialization.
+  virtual std::vector<CelestialState> CelestialStates(
+      std::vector<Index> const& indices) const;
+
+  // The state of a vessel at current time, see |VesselStates|.
+  struct VesselState final {
+    Index parent_index;
+    RelativeDegreesOfFreedom<AliceSun> from_parent;
+  };
+
+  // Returns the index of the parent and the degrees of freedom relative to it
+  // of each of the vessels with the given |vessel_guids|, which must have been
+  // inserted and kept.  The parents of the vessels are maintained by
+  // |CatchUpLaggingVessels|, so unlike |VesselFromParent| this function doesn't
+  // change them.  Must be called after initialization.
+  virtual std::vector<VesselState> VesselStates(
+      std::vector<GUID> const& vessel_guids) const;
+
   virtual void SetPredictionAdaptiveStepParameters(
       GUID const& vessel_guid,
       Ephemeris<Barycentric>::AdaptiveStepParameters const&
           prediction_adaptive_step_parameters) const;
 
-  // Updates the prediction for the vessel with guid |vessel_guid|.
-  void UpdatePrediction(GUID const& vessel_guid) const;
+  // Updates the prediction for the vessel with guid |vessel_guid| at the given
+  // |level_of_detail|, which may change from frame to frame.  The prediction is
+  // computed asynchronously, see |Vessel::RefreshPrediction|.
+  void UpdatePrediction(
+      GUID const& vessel_guid,
+      PredictionLevelOfDetail level_of_detail =
+          PredictionLevelOfDetail::Full) const;
+
+  // Limits the wall-clock time spent flowing the predictions synchronously in
+  // |UpdatePrediction| between two calls to |AdvanceTime|.  Each call to
+  // |UpdatePrediction| gets a share of the remainder of the budget
+  // proportional to the weight of its level of detail, assuming that the same
+  // predictions are updated as in the previous frame; the time that a
+  // prediction doesn't use is available to the next ones.  If
+  // |budget| is null, which is the default, the predictions are only limited by
+  // |FlightPlan::max_ephemeris_steps_per_frame|.
+  virtual void SetPredictionFrameBudget(
+      std::optional<std::chrono::steady_clock::duration> const& budget);
+
+  // If |persist| is true, |WriteToMessage| henceforth saves the segments of
+  // the flight plans, so that they are not recomputed when the plugin is
+  // deserialized.  The default is false, as this makes saves larger.
+  virtual void SetPersistFlightPlanSegments(bool persist);
 
   virtual void CreateFlightPlan(GUID const& vessel_guid,
                                 Instant const& final_time,
                                 Mass const& initial_mass) const;
 
+  // Integrates the alternatives to the last manœuvre of the flight plan of the
+  // given vessel on the scheduler of the plugin, see
+  // |FlightPlan::IntegrateAlternativesToLast|.
+  virtual std::vector<std::optional<FlightPlan::Alternative>>
+  IntegrateFlightPlanAlternativesToLast(GUID const& vessel_guid,
+                                        std::vector<Burn> burns) const;
+
+  // Adjusts the Δv of the last manœuvre of the flight plan of the given vessel
+  // so that, after the manœuvre, the vessel passes within |tolerance| of
+  // |distance| from the celestial with the given index; see
+  // |FlightPlanOptimizer|.  The flight plan is not modified if this fails.
+  virtual Status OptimizeFlightPlanClosestApproach(
+      GUID const& vessel_guid,
+      Index celestial_index,
+      Length const& distance,
+      Length const& tolerance) const;
+
   // Computes the apsides of the trajectory defined by |begin| and |end| with
   // respect to the celestial with index |celestial_index|.
   virtual void ComputeAndRenderApsides(
@@ -362,10 +514,38 @@ class Plugin {
   virtual bool HasVessel(GUID const& vessel_guid) const;
   virtual not_null<Vessel*> GetVessel(GUID const& vessel_guid) const;
 
+  // Returns the handle of the vessel with the given GUID, which must be in the
+  // plugin.  The handle remains the same as long as the vessel is in the
+  // plugin.  Handles are not serialized.
+  virtual VesselHandle GetVesselHandle(GUID const& vessel_guid);
+  // Returns true if the vessel designated by |vessel_handle| is still in the
+  // plugin.  Runs in constant time.
+  virtual bool HasVesselWithHandle(VesselHandle vessel_handle) const;
+  // Returns the vessel designated by |vessel_handle|, which must be in the
+  // plugin.  Runs in constant time.
+  virtual not_null<Vessel*> GetVesselWithHandle(
+      VesselHandle vessel_handle) const;
+
+  // Also publishes a new |render_snapshot()|: a planetarium is created on the
+  // game thread once per frame, after the physics and the edits of the flight
+  // plans, so the snapshot reflects the state that the frame displays.
   virtual not_null<std::unique_ptr<Planetarium>> NewPlanetarium(
       Planetarium::Parameters const& parameters,
       Perspective<Navigation, Camera> const& perspective) const;
 
+  // Same as |NewPlanetarium|, but updates an existing |planetarium| created by
+  // that function, which is kept from frame to frame.  The |planetarium| now
+  // uses the current plotting frame.
+  virtual void UpdatePlanetarium(
+      Planetarium::Parameters const& parameters,
+      Perspective<Navigation, Camera> const& perspective,
+      not_null<Planetarium*> planetarium) const;
+
+  // The trajectories to plot in the current frame.  May be called from any
+  // thread; the result remains valid after a new snapshot is published.  Null
+  // before the first call to |NewPlanetarium| or |UpdatePlanetarium|.
+  virtual std::shared_ptr<RenderSnapshot const> render_snapshot() const;
+
   virtual not_null<std::unique_ptr<NavigationFrame>>
   NewBarycentricRotatingNavigationFrame(Index primary_index,
                                         Index secondary_index) const;
@@ -392,6 +572,9 @@ class Plugin {
   virtual Vector<double, World> VesselTangent(GUID const& vessel_guid) const;
   virtual Vector<double, World> VesselNormal(GUID const& vessel_guid) const;
   virtual Vector<double, World> VesselBinormal(GUID const& vessel_guid) const;
+  Vector<double, World> VesselTangent(Vessel const& vessel) const;
+  Vector<double, World> VesselNormal(Vessel const& vessel) const;
+  Vector<double, World> VesselBinormal(Vessel const& vessel) const;
 
   // TODO(egg): UnmanageableVesselTangent, Normal, Binormal.
 
@@ -405,6 +588,7 @@ class Plugin {
   // Same as |UnmanageableVesselVelocity|, but uses the known degrees of freedom
   // of a vessel in |vessels_|.
   virtual Velocity<World> VesselVelocity(GUID const& vessel_guid) const;
+  Velocity<World> VesselVelocity(Vessel const& vessel) const;
 
   virtual Instant GameEpoch() const;
 
@@ -419,6 +603,33 @@ class Plugin {
   virtual Renderer& renderer();
   virtual Renderer const& renderer() const;
 
+  // The memory used by the trajectories of the plugin.  For each item, the
+  // number of elements (polynomials or points) and the number of bytes
+  // allocated for them.
+  struct MemoryReport final {
+    struct Item final {
+      std::int64_t elements = 0;
+      std::int64_t bytes = 0;
+    };
+    // The continuous trajectories of the celestials.
+    std::map<Index, Item> celestials;
+    // The histories of the vessels, including their psychohistories and
+    // predictions.
+    std::map<GUID, Item> vessel_histories;
+    // Only for the vessels that have a flight plan.
+    std::map<GUID, Item> flight_plans;
+  };
+
+  // Walks the trajectories of the plugin to measure their memory usage, which
+  // is useful for choosing the retention and downsampling settings and for
+  // finding leaks.  This is linear in the number of chunks and forks, not in
+  // the number of points.  Must be called after initialization.
+  virtual MemoryReport MemoryUsage() const;
+
+  // The scheduler on which the asynchronous computations of the plugin are
+  // executed, exposed so that benchmarks may observe its statistics.
+  WorkStealingScheduler const& scheduler() const;
+
   // Must be called after initialization.
   virtual void WriteToMessage(not_null<serialization::Plugin*> message) const;
   static not_null<std::unique_ptr<Plugin>> ReadFromMessage(
@@ -447,6 +658,15 @@ class Plugin {
   // whenever |main_body_| or |planetarium_rotation_| changes.
   void UpdatePlanetariumRotation();
 
+  // Evaluates the trajectories of all the celestials at |current_time_|, in
+  // parallel, and caches the results in the celestials.  Must be called
+  // whenever |current_time_| changes.
+  void CacheCelestialDegreesOfFreedom();
+
+  // Publishes a new |render_snapshot_| at |current_time_| for the vessels that
+  // were plotted using the previous one.
+  void PublishRenderSnapshot() const;
+
   Velocity<World> VesselVelocity(
       Instant const& time,
       DegreesOfFreedom<Barycentric> const& degrees_of_freedom) const;
@@ -468,9 +688,41 @@ class Plugin {
                Mass mass,
                DegreesOfFreedom<Barycentric> const& degrees_of_freedom);
 
+  // Inserts the vessels of |pile_up| into |collided_vessels| if |status|, the
+  // result of advancing |pile_up|, indicates a collision with a celestial.
+  void InsertCollidedVessels(PileUp const& pile_up,
+                             Status const& status,
+                             VesselSet& collided_vessels) const;
+
+  // Updates the parents of the vessels that are at |current_time_| so that
+  // each of them is in the sphere of influence of its parent and not in that
+  // of a child of its parent, using the cached degrees of freedom of the
+  // celestials.  The spheres of influence follow the hierarchy of the
+  // celestials, so a vessel only moves up or down the tree from its current
+  // parent.  A vessel is not checked again until it could have reached the
+  // nearest boundary, so most vessels are skipped in most frames.  For the
+  // loaded vessels, the parent passed by the game to |InsertOrKeepVessel|
+  // takes precedence.
+  void UpdateVesselParents();
+
+  // Invalidates the handle of |vessel|, if any.  Must be called before
+  // |vessel| is removed from |vessels_|.
+  void ReleaseVesselHandle(not_null<Vessel const*> vessel);
+
   // Whether |loaded_vessels_| contains |vessel|.
   bool is_loaded(not_null<Vessel*> vessel) const;
 
+  // Whether |vessel| was put to sleep and may not be advanced.
+  bool is_asleep(not_null<Vessel*> vessel) const;
+
+  // Returns a frame that shares the |ConcreteFrame| built on the bodies of the
+  // celestials with the given |indices| with all the other frames returned for
+  // the same arguments, constructing it on the first call.
+  template<template<typename, typename> class ConcreteFrame,
+           typename... Indices>
+  not_null<std::unique_ptr<NavigationFrame>> NewSharedNavigationFrame(
+      Indices... indices) const EXCLUDES(navigation_frames_lock_);
+
   // Initialization objects.
   base::Monostable initializing_;
   serialization::GravityModel gravity_model_;
@@ -484,8 +736,15 @@ class Plugin {
   // in a deserialized object.
   std::optional<Ephemeris<Barycentric>::FixedStepParameters>
       ephemeris_parameters_;
+  // If not empty, |ephemeris_parameters_| is selected among these.
+  std::vector<Ephemeris<Barycentric>::FixedStepParameters>
+      ephemeris_parameters_candidates_;
 
   GUIDToOwnedVessel vessels_;
+  // The vessel designated by each handle, or null if that vessel has been
+  // removed from the plugin.  The handles index this vector.
+  std::vector<Vessel*> vessels_by_handle_;
+  std::map<not_null<Vessel const*>, VesselHandle> vessel_handles_;
   // For each part, the vessel that this part belongs to. The part is guaranteed
   // to be in the parts() map of the vessel, and owned by it.
   std::map<PartId, not_null<Vessel*>> part_id_to_vessel_;
@@ -499,6 +758,24 @@ class Plugin {
   Ephemeris<Barycentric>::AdaptiveStepParameters psychohistory_parameters_;
   Ephemeris<Barycentric>::AdaptiveStepParameters prediction_parameters_;
 
+  // Not serialized, the client sets it at each startup.
+  std::optional<std::chrono::steady_clock::duration> prediction_frame_budget_;
+  // The part of |prediction_frame_budget_| not yet used in the current frame.
+  mutable std::chrono::steady_clock::duration prediction_budget_left_{};
+  // The total weight of the levels of detail of the calls to
+  // |UpdatePrediction| in the current and the previous frames.
+  mutable int prediction_weight_in_frame_ = 0;
+  int prediction_weight_in_previous_frame_ = 0;
+
+  // Not serialized, the client sets it at each startup.
+  bool persist_flight_plan_segments_ = false;
+
+  // The scheduler on which the asynchronous computations of the plugin are
+  // executed.  The destructor of the plugin waits until it is idle before
+  // destroying anything, since many members, some of them declared after this
+  // one, are referenced by these computations.  It is thread-safe, so it may be
+  // used by const member functions.
+  mutable WorkStealingScheduler scheduler_;
   // The thread pool for advancing vessels.
   ThreadPool<Status> vessel_thread_pool_;
 
@@ -508,12 +785,39 @@ class Plugin {
   Instant game_epoch_;
   // The current in-game universal time.
   Instant current_time_;
+  // The time of the next call to |AdvanceTime|, extrapolated from the last
+  // step: the frames are evenly spaced in game time, except when the warp rate
+  // changes.  Not serialized.
+  Instant expected_next_time_;
+
+  // The time after which |UpdateVesselParents| must check the parent of each
+  // vessel again.  Vessels that are not in this map are checked at the next
+  // opportunity.  Not serialized.
+  std::map<not_null<Vessel const*>, Instant> next_parent_checks_;
 
   Celestial* sun_ = nullptr;  // Not owning, not null after initialization.
 
   // Not null after initialization.
   std::unique_ptr<Renderer> renderer_;
 
+  // The frames returned by the |New...NavigationFrame| functions, keyed by
+  // their type and the indices of their celestials.  They are shared by the
+  // renderer, the flight plans and the navball, so that their caches are
+  // shared too.  The frames defined by two celestials are keyed by ordered
+  // pairs, so there may be quadratically many frames in the number of
+  // celestials; in practice only the handful of frames that the player selects
+  // are ever constructed, and they are kept for the lifetime of the plugin.
+  // This map is modified by const member functions, which may be called from
+  // any thread, hence the lock.  Not serialized.
+  mutable std::mutex navigation_frames_lock_;
+  mutable std::map<std::pair<std::type_index, std::vector<Index>>,
+                   not_null<std::shared_ptr<NavigationFrame const>>>
+      navigation_frames_ GUARDED_BY(navigation_frames_lock_);
+
+  // Accessed with |std::atomic_load| and |std::atomic_store| since the
+  // plotting functions may run concurrently with |NewPlanetarium|.
+  mutable std::shared_ptr<RenderSnapshot const> render_snapshot_;
+
   RotatingBody<Barycentric> const* main_body_ = nullptr;
   AngularVelocity<Barycentric> angular_velocity_of_world_;
 
@@ -526,6 +830,9 @@ class Plugin {
   VesselSet loaded_vessels_;
   // The vessels that will be kept during the next call to |AdvanceTime|.
   VesselConstSet kept_vessels_;
+  // The vessels that were put to sleep and have not been woken up since.  Not
+  // serialized: all the vessels are awake after deserialization.
+  VesselSet sleeping_vessels_;
 
   friend class NavballFrameField;
   friend class TestablePlugin;
@@ -533,8 +840,12 @@ class Plugin {
 
 }  // namespace internal_plugin
 
+using internal_plugin::Freefall;
+using internal_plugin::FreefallFuture;
 using internal_plugin::Index;
 using internal_plugin::Plugin;
+using internal_plugin::PredictionLevelOfDetail;
+using internal_plugin::VesselHandle;
 
 }  // namespace ksp_plugin
 }  // namespace principia
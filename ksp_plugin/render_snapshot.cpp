@@ -0,0 +1,84 @@
+﻿#include "ksp_plugin/render_snapshot.hpp"
+
+#include "base/map_util.hpp"
+#include "ksp_plugin/flight_plan.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_render_snapshot {
+
+RenderSnapshot::RenderSnapshot(
+    Instant const& time,
+    std::vector<not_null<Vessel const*>> const& vessels)
+    : time_(time) {
+  for (not_null<Vessel const*> const vessel : vessels) {
+    vessels_.emplace(std::piecewise_construct,
+                     std::forward_as_tuple(vessel->guid()),
+                     std::forward_as_tuple(*vessel));
+  }
+}
+
+Instant const& RenderSnapshot::time() const {
+  return time_;
+}
+
+bool RenderSnapshot::has_vessel(GUID const& vessel_guid) const {
+  {
+    std::lock_guard<std::mutex> l(plotted_vessels_lock_);
+    plotted_vessels_.insert(vessel_guid);
+  }
+  return vessels_.find(vessel_guid) != vessels_.end();
+}
+
+std::set<GUID> RenderSnapshot::plotted_vessels() const {
+  std::lock_guard<std::mutex> l(plotted_vessels_lock_);
+  return plotted_vessels_;
+}
+
+DiscreteTrajectory<Barycentric> const& RenderSnapshot::prediction(
+    GUID const& vessel_guid) const {
+  return *FindOrDie(vessel_guid).prediction;
+}
+
+int RenderSnapshot::number_of_flight_plan_segments(
+    GUID const& vessel_guid) const {
+  return FindOrDie(vessel_guid).flight_plan_segments.size();
+}
+
+void RenderSnapshot::GetFlightPlanSegment(
+    GUID const& vessel_guid,
+    int const index,
+    DiscreteTrajectory<Barycentric>::Iterator& begin,
+    DiscreteTrajectory<Barycentric>::Iterator& end) const {
+  auto const& segments = FindOrDie(vessel_guid).flight_plan_segments;
+  CHECK_LE(0, index);
+  CHECK_LT(index, segments.size());
+  begin = segments[index]->Begin();
+  end = segments[index]->End();
+}
+
+RenderSnapshot::VesselTrajectories::VesselTrajectories(Vessel const& vessel)
+    : prediction(vessel.prediction().NewRootWithCopy(
+          vessel.prediction().Fork().time())) {
+  if (vessel.has_flight_plan()) {
+    FlightPlan const& flight_plan = vessel.flight_plan();
+    for (int i = 0; i < flight_plan.number_of_segments(); ++i) {
+      DiscreteTrajectory<Barycentric>::Iterator begin;
+      DiscreteTrajectory<Barycentric>::Iterator end;
+      flight_plan.GetSegment(i, begin, end);
+      // The segment is the most forked trajectory of its iterators, and
+      // extends from its fork point to its end.
+      flight_plan_segments.push_back(
+          begin.trajectory()->NewRootWithCopy(begin.time()));
+    }
+  }
+}
+
+RenderSnapshot::VesselTrajectories const& RenderSnapshot::FindOrDie(
+    GUID const& vessel_guid) const {
+  return base::FindOrDie(vessels_, vessel_guid);
+}
+
+}  // namespace internal_render_snapshot
+}  // namespace ksp_plugin
+}  // namespace principia
@@ -0,0 +1,94 @@
+﻿
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "base/macros.hpp"
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "ksp_plugin/identification.hpp"
+#include "ksp_plugin/vessel.hpp"
+#include "physics/discrete_trajectory.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_render_snapshot {
+
+using base::not_null;
+using geometry::Instant;
+using physics::DiscreteTrajectory;
+
+// An immutable copy of the trajectories that are plotted in a frame, taken on
+// the game thread.  The plotting functions read the snapshot instead of the
+// vessels, so that they don't race with the game thread if they run
+// concurrently with the next |AdvanceTime|, and so that all the trajectories of
+// a frame are plotted at the same |time|.  A snapshot is shared by
+// |std::shared_ptr|: it is destroyed when the last plotting function using it
+// returns, even if a newer one has been published in the meantime.
+// The points of the trajectories are shared with those of the vessels (see
+// |DiscreteTrajectory::NewRootWithCopy|), so taking a snapshot doesn't copy
+// them, and the vessels only copy the chunks that they modify afterwards.
+class RenderSnapshot final {
+ public:
+  // Shares the predictions and flight plans of the given |vessels|.  Must be
+  // called on the game thread.
+  RenderSnapshot(Instant const& time,
+                 std::vector<not_null<Vessel const*>> const& vessels);
+
+  // The time at which the snapshot was taken.
+  Instant const& time() const;
+
+  // False if the vessel with GUID |vessel_guid| was created after the snapshot
+  // was taken or was not plotted when the previous snapshot was taken.  Records
+  // that the vessel is plotted, see |plotted_vessels()|.  Thread-safe.
+  bool has_vessel(GUID const& vessel_guid) const;
+
+  // The GUIDs passed to |has_vessel| so far.  The next snapshot only needs to
+  // contain these vessels.  Thread-safe.
+  std::set<GUID> plotted_vessels() const;
+
+  // The vessel with GUID |vessel_guid| must be in this snapshot.
+  DiscreteTrajectory<Barycentric> const& prediction(
+      GUID const& vessel_guid) const;
+
+  // The number of segments of the flight plan of the vessel with GUID
+  // |vessel_guid|, which must be in this snapshot; 0 if it had no flight plan.
+  int number_of_flight_plan_segments(GUID const& vessel_guid) const;
+
+  // |index| must be in [0, number_of_flight_plan_segments(vessel_guid)[.  Sets
+  // the iterators to denote the given segment.
+  void GetFlightPlanSegment(
+      GUID const& vessel_guid,
+      int index,
+      DiscreteTrajectory<Barycentric>::Iterator& begin,
+      DiscreteTrajectory<Barycentric>::Iterator& end) const;
+
+ private:
+  struct VesselTrajectories final {
+    explicit VesselTrajectories(Vessel const& vessel);
+
+    not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> prediction;
+    std::vector<not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>>>
+        flight_plan_segments;
+  };
+
+  VesselTrajectories const& FindOrDie(GUID const& vessel_guid) const;
+
+  Instant const time_;
+  std::map<GUID, VesselTrajectories> vessels_;
+
+  mutable std::mutex plotted_vessels_lock_;
+  mutable std::set<GUID> plotted_vessels_ GUARDED_BY(plotted_vessels_lock_);
+};
+
+}  // namespace internal_render_snapshot
+
+using internal_render_snapshot::RenderSnapshot;
+
+}  // namespace ksp_plugin
+}  // namespace principia
@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <optional>
+#include <vector>
 
+#include "base/profiling.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
 #include "physics/apsides.hpp"
@@ -32,6 +34,7 @@ Renderer::Renderer(not_null<Celestial const*> const sun,
 void Renderer::SetPlottingFrame(
     not_null<std::unique_ptr<NavigationFrame>> plotting_frame) {
   plotting_frame_ = std::move(plotting_frame);
+  ClearPlottingCache();
 }
 
 not_null<NavigationFrame const*> Renderer::GetPlottingFrame() const {
@@ -47,16 +50,19 @@ void Renderer::SetTargetVessel(
       target_->vessel != vessel ||
       target_->celestial != celestial) {
     target_.emplace(vessel, celestial, ephemeris);
+    ClearPlottingCache();
   }
 }
 
 void Renderer::ClearTargetVessel() {
   target_ = std::nullopt;
+  ClearPlottingCache();
 }
 
 void Renderer::ClearTargetVesselIf(not_null<Vessel*> const vessel) {
   if (target_ && target_->vessel == vessel) {
     target_ = std::nullopt;
+    ClearPlottingCache();
   }
 }
 
@@ -91,38 +97,62 @@ Renderer::RenderBarycentricTrajectoryInWorld(
     DiscreteTrajectory<Barycentric>::Iterator const& end,
     Position<World> const& sun_world_position,
     Rotation<Barycentric, AliceSun> const& planetarium_rotation) const {
-  auto const trajectory_in_plotting_frame =
-      RenderBarycentricTrajectoryInPlotting(begin, end);
-  auto trajectory_in_world =
-      RenderPlottingTrajectoryInWorld(time,
-                                      trajectory_in_plotting_frame->Begin(),
-                                      trajectory_in_plotting_frame->End(),
-                                      sun_world_position,
-                                      planetarium_rotation);
+  RenderedTrajectory<World> rendered_trajectory;
+  RenderBarycentricTrajectoryInWorld(time,
+                                     begin,
+                                     end,
+                                     sun_world_position,
+                                     planetarium_rotation,
+                                     rendered_trajectory);
+  auto trajectory_in_world = make_not_null_unique<DiscreteTrajectory<World>>();
+  for (auto const& [t, degrees_of_freedom] : rendered_trajectory) {
+    trajectory_in_world->Append(t, degrees_of_freedom);
+  }
   return trajectory_in_world;
 }
 
+void Renderer::RenderBarycentricTrajectoryInWorld(
+    Instant const& time,
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    Position<World> const& sun_world_position,
+    Rotation<Barycentric, AliceSun> const& planetarium_rotation,
+    RenderedTrajectory<World>& rendered_trajectory) const {
+  rendered_trajectory.clear();
+  // See |RenderPlottingTrajectoryInWorld| for the unnatural things that this
+  // transformation does.
+  RigidTransformation<Navigation, World> const
+      from_plotting_frame_to_world_at_current_time =
+          PlottingToWorld(time, sun_world_position, planetarium_rotation);
+  ForEachBarycentricPointInPlotting(
+      begin,
+      end,
+      [&from_plotting_frame_to_world_at_current_time, &rendered_trajectory](
+          Instant const& t,
+          DegreesOfFreedom<Navigation> const& degrees_of_freedom) {
+        rendered_trajectory.emplace_back(
+            t,
+            DegreesOfFreedom<World>(
+                from_plotting_frame_to_world_at_current_time(
+                    degrees_of_freedom.position()),
+                geometry::Identity<Navigation, World>{}(
+                    degrees_of_freedom.velocity())));
+      });
+}
+
 not_null<std::unique_ptr<DiscreteTrajectory<Navigation>>>
 Renderer::RenderBarycentricTrajectoryInPlotting(
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
     DiscreteTrajectory<Barycentric>::Iterator const& end) const {
+  PRINCIPIA_PROFILE_SCOPE(RendererRenderBarycentricTrajectoryInPlotting);
   auto trajectory = make_not_null_unique<DiscreteTrajectory<Navigation>>();
-  if (target_ && begin != end) {
-    auto last = end;
-    --last;
-    target_->vessel->FlowPrediction(last.time());
-  }
-  for (auto it = begin; it != end; ++it) {
-    Instant const& t = it.time();
-    if (target_) {
-      if (t < target_->vessel->prediction().t_min()) {
-        continue;
-      } else if (t > target_->vessel->prediction().t_max()) {
-        break;
-      }
-    }
-    trajectory->Append(t, BarycentricToPlotting(t)(it.degrees_of_freedom()));
-  }
+  ForEachBarycentricPointInPlotting(
+      begin,
+      end,
+      [&trajectory](Instant const& t,
+                    DegreesOfFreedom<Navigation> const& degrees_of_freedom) {
+        trajectory->Append(t, degrees_of_freedom);
+      });
   return trajectory;
 }
 
@@ -133,6 +163,7 @@ Renderer::RenderPlottingTrajectoryInWorld(
     DiscreteTrajectory<Navigation>::Iterator const& end,
     Position<World> const& sun_world_position,
     Rotation<Barycentric, AliceSun> const& planetarium_rotation) const {
+  PRINCIPIA_PROFILE_SCOPE(RendererRenderPlottingTrajectoryInWorld);
   auto trajectory = make_not_null_unique<DiscreteTrajectory<World>>();
   // This function does unnatural things.
   // - It identifies positions in the plotting frame with those of world using
@@ -157,21 +188,55 @@ Renderer::RenderPlottingTrajectoryInWorld(
   RigidTransformation<Navigation, World> const
       from_plotting_frame_to_world_at_current_time =
           PlottingToWorld(time, sun_world_position, planetarium_rotation);
+  // The transformation is the same for all the points, so the positions are
+  // transformed in a batch.
+  std::vector<Position<Navigation>> navigation_positions;
   for (auto it = begin; it != end; ++it) {
-    DegreesOfFreedom<Navigation> const& navigation_degrees_of_freedom =
-        it.degrees_of_freedom();
+    navigation_positions.push_back(it.degrees_of_freedom().position());
+  }
+  std::vector<Position<World>> const world_positions =
+      from_plotting_frame_to_world_at_current_time(navigation_positions);
+  int i = 0;
+  for (auto it = begin; it != end; ++it, ++i) {
     DegreesOfFreedom<World> const world_degrees_of_freedom = {
-        from_plotting_frame_to_world_at_current_time(
-            navigation_degrees_of_freedom.position()),
+        world_positions[i],
         geometry::Identity<Navigation, World>{}(
-            navigation_degrees_of_freedom.velocity())};
+            it.degrees_of_freedom().velocity())};
     trajectory->Append(it.time(), world_degrees_of_freedom);
   }
   return trajectory;
 }
 
+void Renderer::RenderPlottingTrajectoryInWorld(
+    Instant const& time,
+    DiscreteTrajectory<Navigation>::Iterator const& begin,
+    DiscreteTrajectory<Navigation>::Iterator const& end,
+    Position<World> const& sun_world_position,
+    Rotation<Barycentric, AliceSun> const& planetarium_rotation,
+    RenderedTrajectory<World>& rendered_trajectory) const {
+  PRINCIPIA_PROFILE_SCOPE(RendererRenderPlottingTrajectoryInWorld);
+  rendered_trajectory.clear();
+  // The points are transformed one at a time, unlike above, because the batch
+  // transformation allocates.
+  RigidTransformation<Navigation, World> const
+      from_plotting_frame_to_world_at_current_time =
+          PlottingToWorld(time, sun_world_position, planetarium_rotation);
+  for (auto it = begin; it != end; ++it) {
+    rendered_trajectory.emplace_back(
+        it.time(),
+        DegreesOfFreedom<World>(
+            from_plotting_frame_to_world_at_current_time(
+                it.degrees_of_freedom().position()),
+            geometry::Identity<Navigation, World>{}(
+                it.degrees_of_freedom().velocity())));
+  }
+}
+
 RigidMotion<Barycentric, Navigation> Renderer::BarycentricToPlotting(
     Instant const& time) const {
+  if (target_) {
+    return CachedBarycentricToTarget(time);
+  }
   return GetPlottingFrame(time)->ToThisFrameAtTime(time);
 }
 
@@ -209,20 +274,9 @@ OrthogonalMap<Frenet<Navigation>, World> Renderer::FrenetToWorld(
 OrthogonalMap<Frenet<Navigation>, World> Renderer::FrenetToWorld(
     Vessel const& vessel,
     Rotation<Barycentric, AliceSun> const& planetarium_rotation) const {
-  auto const last = vessel.psychohistory().last();
-  Instant const& time = last.time();
-  DegreesOfFreedom<Barycentric> const& barycentric_degrees_of_freedom =
-      last.degrees_of_freedom();
-  DegreesOfFreedom<Navigation> const plotting_frame_degrees_of_freedom =
-      BarycentricToPlotting(time)(barycentric_degrees_of_freedom);
-  Rotation<Frenet<Navigation>, Navigation> const
-      frenet_frame_to_plotting_frame =
-          GetPlottingFrame(time)->FrenetFrame(
-              time,
-              plotting_frame_degrees_of_freedom);
-
+  Instant const& time = vessel.psychohistory().last().time();
   return PlottingToWorld(time, planetarium_rotation) *
-         frenet_frame_to_plotting_frame.Forget();
+         CachedFrenetFrame(vessel).Forget();
 }
 
 OrthogonalMap<Frenet<Navigation>, World> Renderer::FrenetToWorld(
@@ -244,7 +298,7 @@ OrthogonalMap<Frenet<Navigation>, World> Renderer::FrenetToWorld(
 
 OrthogonalMap<Navigation, Barycentric> Renderer::PlottingToBarycentric(
     Instant const& time) const {
-  return GetPlottingFrame(time)->FromThisFrameAtTime(time).orthogonal_map();
+  return CachedBarycentricToPlotting(time).orthogonal_map().Inverse();
 }
 
 RigidTransformation<Navigation, World> Renderer::PlottingToWorld(
@@ -252,8 +306,7 @@ RigidTransformation<Navigation, World> Renderer::PlottingToWorld(
     Position<World> const& sun_world_position,
     Rotation<Barycentric, AliceSun> const& planetarium_rotation) const {
   return BarycentricToWorld(time, sun_world_position, planetarium_rotation) *
-         GetPlottingFrame(time)->
-             FromThisFrameAtTime(time).rigid_transformation();
+         CachedBarycentricToPlotting(time).rigid_transformation().Inverse();
 }
 
 OrthogonalMap<Navigation, World> Renderer::PlottingToWorld(
@@ -280,7 +333,7 @@ RigidTransformation<World, Navigation> Renderer::WorldToPlotting(
     Instant const& time,
     Position<World> const& sun_world_position,
     Rotation<Barycentric, AliceSun> const& planetarium_rotation) const {
-  return BarycentricToPlotting(time).rigid_transformation() *
+  return CachedBarycentricToPlotting(time).rigid_transformation() *
          WorldToBarycentric(time, sun_world_position, planetarium_rotation);
 }
 
@@ -312,6 +365,29 @@ Renderer::Target::Target(
               [this]() -> auto& { return this->vessel->prediction(); },
               celestial->body())) {}
 
+template<typename Append>
+void Renderer::ForEachBarycentricPointInPlotting(
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    Append const& append) const {
+  if (target_ && begin != end) {
+    auto last = end;
+    --last;
+    target_->vessel->FlowPrediction(last.time());
+  }
+  for (auto it = begin; it != end; ++it) {
+    Instant const& t = it.time();
+    if (target_) {
+      if (t < target_->vessel->prediction().t_min()) {
+        continue;
+      } else if (t > target_->vessel->prediction().t_max()) {
+        break;
+      }
+    }
+    append(t, BarycentricToPlotting(t)(it.degrees_of_freedom()));
+  }
+}
+
 not_null<NavigationFrame const*> Renderer::GetPlottingFrame(
     Instant const& time) const {
   if (target_) {
@@ -320,6 +396,93 @@ not_null<NavigationFrame const*> Renderer::GetPlottingFrame(
   return GetPlottingFrame();
 }
 
+RigidMotion<Barycentric, Navigation> Renderer::CachedBarycentricToTarget(
+    Instant const& time) const {
+  auto const& prediction = GetTargetVesselPrediction(time);
+  std::int64_t const prediction_version = target_->vessel->prediction_version();
+
+  // The points of the prediction up to the first one after the fork change
+  // each time the vessel advances, so the motions are not cached there.
+  auto stable = prediction.is_root() ? prediction.Begin() : prediction.Fork();
+  if (stable != prediction.End()) {
+    ++stable;
+  }
+  bool const cacheable = stable != prediction.End() && time > stable.time();
+
+  if (cacheable) {
+    std::lock_guard<std::mutex> l(target_->motions_lock);
+    auto& motions = target_->motions;
+    if (target_->prediction_version != prediction_version) {
+      motions.clear();
+      target_->prediction_version = prediction_version;
+    }
+    motions.erase(motions.begin(), motions.upper_bound(stable.time()));
+    auto const it = motions.find(time);
+    if (it != motions.end()) {
+      return it->second;
+    }
+  }
+
+  // Evaluate outside of the lock, the target frame may be slow.
+  auto const barycentric_to_target =
+      target_->target_frame->ToThisFrameAtTime(time);
+  if (cacheable) {
+    std::lock_guard<std::mutex> l(target_->motions_lock);
+    if (target_->prediction_version == prediction_version) {
+      target_->motions.emplace(time, barycentric_to_target);
+    }
+  }
+  return barycentric_to_target;
+}
+
+RigidMotion<Barycentric, Navigation> Renderer::CachedBarycentricToPlotting(
+    Instant const& time) const {
+  {
+    std::lock_guard<std::mutex> l(plotting_cache_lock_);
+    if (plotting_cache_ && plotting_cache_->time == time) {
+      return plotting_cache_->barycentric_to_plotting;
+    }
+  }
+  // Evaluate outside of the lock, the plotting frame may be slow.
+  auto const barycentric_to_plotting = BarycentricToPlotting(time);
+  std::lock_guard<std::mutex> l(plotting_cache_lock_);
+  plotting_cache_.emplace(PlottingCache{time,
+                                        barycentric_to_plotting,
+                                        /*frenet_vessel_guid=*/std::nullopt,
+                                        /*frenet_frame=*/std::nullopt});
+  return barycentric_to_plotting;
+}
+
+Rotation<Frenet<Navigation>, Navigation> Renderer::CachedFrenetFrame(
+    Vessel const& vessel) const {
+  auto const last = vessel.psychohistory().last();
+  Instant const& time = last.time();
+  {
+    std::lock_guard<std::mutex> l(plotting_cache_lock_);
+    if (plotting_cache_ &&
+        plotting_cache_->time == time &&
+        plotting_cache_->frenet_vessel_guid == vessel.guid()) {
+      return *plotting_cache_->frenet_frame;
+    }
+  }
+  auto const barycentric_to_plotting = CachedBarycentricToPlotting(time);
+  Rotation<Frenet<Navigation>, Navigation> const frenet_frame =
+      GetPlottingFrame(time)->FrenetFrame(
+          time,
+          barycentric_to_plotting(last.degrees_of_freedom()));
+  std::lock_guard<std::mutex> l(plotting_cache_lock_);
+  if (plotting_cache_ && plotting_cache_->time == time) {
+    plotting_cache_->frenet_vessel_guid = vessel.guid();
+    plotting_cache_->frenet_frame = frenet_frame;
+  }
+  return frenet_frame;
+}
+
+void Renderer::ClearPlottingCache() {
+  std::lock_guard<std::mutex> l(plotting_cache_lock_);
+  plotting_cache_.reset();
+}
+
 }  // namespace internal_renderer
 }  // namespace ksp_plugin
 }  // namespace principia
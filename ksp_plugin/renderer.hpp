@@ -1,8 +1,12 @@
 ﻿#pragma once
 
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "base/not_null.hpp"
 #include "geometry/affine_map.hpp"
@@ -12,6 +16,7 @@
 #include "ksp_plugin/celestial.hpp"
 #include "ksp_plugin/frames.hpp"
 #include "ksp_plugin/vessel.hpp"
+#include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/dynamic_frame.hpp"
 #include "physics/ephemeris.hpp"
@@ -29,12 +34,20 @@ using geometry::OrthogonalMap;
 using geometry::Position;
 using geometry::RigidTransformation;
 using geometry::Rotation;
+using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
 using physics::Frenet;
 using physics::RigidMotion;
 using quantities::Length;
 
+// A rendered trajectory stored contiguously.  The rendering functions that
+// take one clear it but keep its capacity, so a buffer that is reused from one
+// frame to the next doesn't allocate in steady state.
+template<typename Frame>
+using RenderedTrajectory =
+    std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>>;
+
 class Renderer {
  public:
   Renderer(not_null<Celestial const*> sun,
@@ -85,6 +98,16 @@ class Renderer {
       Position<World> const& sun_world_position,
       Rotation<Barycentric, AliceSun> const& planetarium_rotation) const;
 
+  // Same as above, but the points are written to |rendered_trajectory|.  No
+  // intermediate trajectory is built in the plotting frame.
+  virtual void RenderBarycentricTrajectoryInWorld(
+      Instant const& time,
+      DiscreteTrajectory<Barycentric>::Iterator const& begin,
+      DiscreteTrajectory<Barycentric>::Iterator const& end,
+      Position<World> const& sun_world_position,
+      Rotation<Barycentric, AliceSun> const& planetarium_rotation,
+      RenderedTrajectory<World>& rendered_trajectory) const;
+
   // Returns a trajectory in the current plotting frame corresponding to the
   // trajectory defined by |begin| and |end|.  If there is a target vessel, its
   // prediction must not be empty.
@@ -103,6 +126,15 @@ class Renderer {
       Position<World> const& sun_world_position,
       Rotation<Barycentric, AliceSun> const& planetarium_rotation) const;
 
+  // Same as above, but the points are written to |rendered_trajectory|.
+  virtual void RenderPlottingTrajectoryInWorld(
+      Instant const& time,
+      DiscreteTrajectory<Navigation>::Iterator const& begin,
+      DiscreteTrajectory<Navigation>::Iterator const& end,
+      Position<World> const& sun_world_position,
+      Rotation<Barycentric, AliceSun> const& planetarium_rotation,
+      RenderedTrajectory<World>& rendered_trajectory) const;
+
   // Coordinate transforms.
 
   virtual RigidMotion<Barycentric, Navigation> BarycentricToPlotting(
@@ -179,21 +211,78 @@ class Renderer {
     not_null<Vessel*> const vessel;
     not_null<Celestial const*> const celestial;
     not_null<std::unique_ptr<NavigationFrame>> const target_frame;
+
+    // The motions of the |target_frame| at the times where it was evaluated
+    // after the first point of the prediction of the |vessel| that follows the
+    // fork.  They remain valid as long as the |prediction_version| of the
+    // |vessel| doesn't change, so that a prediction that is extended from frame
+    // to frame only requires evaluating the frame at the new times.  Not
+    // serialized.
+    mutable std::mutex motions_lock;
+    mutable std::int64_t prediction_version = -1;
+    mutable std::map<Instant, RigidMotion<Barycentric, Navigation>> motions;
   };
 
+  // The plotting frame evaluated at some time, typically the current time, and
+  // the Frenet trihedron of the last vessel for which it was requested at that
+  // time.
+  struct PlottingCache {
+    Instant time;
+    RigidMotion<Barycentric, Navigation> barycentric_to_plotting;
+    std::optional<GUID> frenet_vessel_guid;
+    std::optional<Rotation<Frenet<Navigation>, Navigation>> frenet_frame;
+  };
+
+  // Calls |append| with the time and the degrees of freedom in the plotting
+  // frame of each point of the trajectory defined by |begin| and |end|,
+  // skipping the points outside of the prediction of the target vessel, if
+  // any.
+  template<typename Append>
+  void ForEachBarycentricPointInPlotting(
+      DiscreteTrajectory<Barycentric>::Iterator const& begin,
+      DiscreteTrajectory<Barycentric>::Iterator const& end,
+      Append const& append) const;
+
   // Returns a plotting frame suitable for evaluation at |time|, possibly by
   // extending the prediction if there is a target vessel.
   not_null<NavigationFrame const*> GetPlottingFrame(Instant const& time) const;
 
+  // Same as |BarycentricToPlotting| when there is a target vessel, but takes
+  // the motion from the |motions| of the |target_| if possible, and records
+  // it there otherwise.
+  RigidMotion<Barycentric, Navigation> CachedBarycentricToTarget(
+      Instant const& time) const;
+
+  // Same as |BarycentricToPlotting|, but only evaluates the plotting frame if
+  // |time| is not that of the cache.  This is used by the transforms that are
+  // queried repeatedly at the current time (navball, Frenet vectors) so that
+  // they share one evaluation per frame.
+  RigidMotion<Barycentric, Navigation> CachedBarycentricToPlotting(
+      Instant const& time) const;
+
+  // Returns the Frenet trihedron of the |vessel| at the last point of its
+  // psychohistory, using and filling the cache.
+  Rotation<Frenet<Navigation>, Navigation> CachedFrenetFrame(
+      Vessel const& vessel) const;
+
+  // Must be called whenever the plotting frame changes.
+  void ClearPlottingCache();
+
   not_null<Celestial const*> const sun_;
 
   not_null<std::unique_ptr<NavigationFrame>> plotting_frame_;
 
   std::optional<Target> target_;
+
+  // Not serialized.  The renderer may be queried from the threads of a
+  // |FrameField|, hence the lock.
+  mutable std::mutex plotting_cache_lock_;
+  mutable std::optional<PlottingCache> plotting_cache_;
 };
 
 }  // namespace internal_renderer
 
+using internal_renderer::RenderedTrajectory;
 using internal_renderer::Renderer;
 
 }  // namespace ksp_plugin
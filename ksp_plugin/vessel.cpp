@@ -2,6 +2,7 @@
 #include "ksp_plugin/vessel.hpp"
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
 #include <list>
 #include <string>
@@ -19,19 +20,39 @@ namespace ksp_plugin {
 namespace internal_vessel {
 
 using astronomy::InfiniteFuture;
+using astronomy::InfinitePast;
 using base::Contains;
 using base::FindOrDie;
 using base::make_not_null_unique;
 using geometry::BarycentreCalculator;
 using geometry::Position;
+using geometry::Velocity;
+using physics::RelativeDegreesOfFreedom;
 using quantities::IsFinite;
 using quantities::Length;
 using quantities::Time;
+using quantities::si::Day;
+using quantities::si::Kilo;
 using quantities::si::Metre;
 
 constexpr std::int64_t max_dense_intervals = 10'000;
 constexpr Length downsampling_tolerance = 10 * Metre;
 
+// The points of the history older than |age| are retained with the given
+// |tolerance|, which must be coarser than |downsampling_tolerance|.  The tiers
+// are sorted by increasing age.  A tier is only compacted once its interval
+// not yet compacted spans |age / compaction_ratio|, so that each compaction
+// processes enough points to be worthwhile.
+struct HistoryRetentionTier {
+  Time age;
+  Length tolerance;
+};
+constexpr HistoryRetentionTier history_retention_tiers[] = {
+    {10 * Day, 100 * Metre},
+    {100 * Day, 1 * Kilo(Metre)},
+    {1000 * Day, 10 * Kilo(Metre)}};
+constexpr double compaction_ratio = 10;
+
 Vessel::Vessel(GUID const& guid,
                std::string const& name,
                not_null<Celestial const*> const parent,
@@ -51,6 +72,10 @@ Vessel::Vessel(GUID const& guid,
 
 Vessel::~Vessel() {
   LOG(INFO) << "Destroying vessel " << ShortDebugString();
+  // Abandon the prognostication in flight, if any, and wait for its task to
+  // return before its state goes away.
+  InvalidatePrediction();
+  WaitForPrognostication();
 }
 
 GUID const& Vessel::guid() const {
@@ -145,6 +170,7 @@ void Vessel::PrepareHistory(Instant const& t) {
     history_->Append(t, calculator.Get());
     psychohistory_ = history_->NewForkAtLast();
     prediction_ = psychohistory_->NewForkAtLast();
+    ++prediction_version_;
   }
 }
 
@@ -171,10 +197,15 @@ DiscreteTrajectory<Barycentric> const& Vessel::prediction() const {
   return *prediction_;
 }
 
+std::int64_t Vessel::prediction_version() const {
+  return prediction_version_;
+}
+
 void Vessel::set_prediction_adaptive_step_parameters(
     Ephemeris<Barycentric>::AdaptiveStepParameters const&
         prediction_adaptive_step_parameters) {
   prediction_adaptive_step_parameters_ = prediction_adaptive_step_parameters;
+  InvalidatePrediction();
 }
 
 Ephemeris<Barycentric>::AdaptiveStepParameters const&
@@ -182,6 +213,10 @@ Vessel::prediction_adaptive_step_parameters() const {
   return prediction_adaptive_step_parameters_;
 }
 
+AdaptiveStepStatistics const& Vessel::prediction_statistics() const {
+  return prediction_statistics_;
+}
+
 FlightPlan& Vessel::flight_plan() const {
   CHECK(has_flight_plan());
   return *flight_plan_;
@@ -192,20 +227,42 @@ bool Vessel::has_flight_plan() const {
 }
 
 void Vessel::AdvanceTime() {
+  // Detach the prediction before deleting the psychohistory, of which it is a
+  // fork, so that it may be reused below.
+  not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> const
+      previous_prediction = prediction_->DetachFork();
+  bool const prediction_is_current =
+      prediction_generation_ == prediction_generation_at_last_advance_;
+
   history_->DeleteFork(psychohistory_);
-  AppendToVesselTrajectory(&Part::history_begin,
-                           &Part::history_end,
-                           *history_);
-  psychohistory_ = history_->NewForkAtLast();
-  AppendToVesselTrajectory(&Part::psychohistory_begin,
-                           &Part::psychohistory_end,
-                           *psychohistory_);
+  if (!AppendPileUpTailToVesselTrajectories()) {
+    AppendToVesselTrajectory(&Part::history_begin,
+                             &Part::history_end,
+                             *history_);
+    psychohistory_ = history_->NewForkAtLast();
+    AppendToVesselTrajectory(&Part::psychohistory_begin,
+                             &Part::psychohistory_end,
+                             *psychohistory_);
+  }
   prediction_ = psychohistory_->NewForkAtLast();
 
+  bool is_thrusting = false;
   for (auto const& pair : parts_) {
     Part& part = *pair.second;
     part.ClearHistory();
+    is_thrusting |= part.intrinsic_force() != Vector<Force, Barycentric>();
+  }
+  // A prognostication computed before a burn doesn't describe the state of the
+  // vessel after it.
+  if (is_thrusting) {
+    InvalidatePrediction();
   }
+  if (is_thrusting ||
+      !prediction_is_current ||
+      !ReusePrediction(*previous_prediction)) {
+    ++prediction_version_;
+  }
+  prediction_generation_at_last_advance_ = prediction_generation_;
 }
 
 void Vessel::ForgetBefore(Instant const& time) {
@@ -218,6 +275,31 @@ void Vessel::ForgetBefore(Instant const& time) {
   }
 }
 
+void Vessel::CompactHistory(Instant const& current_time) {
+  constexpr int number_of_tiers = std::size(history_retention_tiers);
+  if (history_compacted_until_.empty()) {
+    history_compacted_until_.resize(number_of_tiers, InfinitePast);
+  }
+  std::int64_t removed = 0;
+  for (int i = 0; i < number_of_tiers; ++i) {
+    auto const& tier = history_retention_tiers[i];
+    Instant& compacted_until = history_compacted_until_[i];
+    // Don't touch the last point of the history, the psychohistory is forked
+    // there.
+    Instant const t2 =
+        std::min(current_time - tier.age, history_->last().time());
+    Instant const t1 = std::max(compacted_until, history_->Begin().time());
+    if (t2 - t1 < tier.age / compaction_ratio) {
+      continue;
+    }
+    removed += history_->Compact(t1, t2, tier.tolerance);
+    compacted_until = t2;
+  }
+  if (removed > 0) {
+    ++history_version_;
+  }
+}
+
 void Vessel::CreateFlightPlan(
     Instant const& final_time,
     Mass const& initial_mass,
@@ -238,28 +320,23 @@ void Vessel::DeleteFlightPlan() {
 }
 
 void Vessel::FlowPrediction(Instant const& time) {
-  if (time > prediction_->last().time()) {
-    bool const finite_time = IsFinite(time - prediction_->last().time());
-    Instant const t = finite_time ? time : ephemeris_->t_max();
-    // This will not prolong the ephemeris if |time| is infinite (but it may do
-    // so if it is finite).
-    bool const reached_t = ephemeris_->FlowWithAdaptiveStep(
-        prediction_,
-        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-        t,
-        prediction_adaptive_step_parameters_,
-        FlightPlan::max_ephemeris_steps_per_frame,
-        /*last_point_only=*/false).ok();
-    if (!finite_time && reached_t) {
-      // This will prolong the ephemeris by |max_ephemeris_steps_per_frame|.
-      ephemeris_->FlowWithAdaptiveStep(
-        prediction_,
-        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-        time,
-        prediction_adaptive_step_parameters_,
-        FlightPlan::max_ephemeris_steps_per_frame,
-        /*last_point_only=*/false);
-    }
+  FlowPredictionBefore(time, /*deadline=*/std::nullopt);
+}
+
+void Vessel::RefreshPrediction(
+    not_null<WorkStealingScheduler*> const scheduler) {
+  RefreshPredictionBefore(scheduler, /*deadline=*/std::nullopt);
+}
+
+void Vessel::RefreshPrediction(
+    not_null<WorkStealingScheduler*> const scheduler,
+    std::chrono::steady_clock::time_point const& deadline) {
+  RefreshPredictionBefore(scheduler, deadline);
+}
+
+void Vessel::WaitForPrognostication() {
+  if (prognosticator_.valid()) {
+    prognosticator_.get();
   }
 }
 
@@ -267,6 +344,28 @@ DiscreteTrajectory<Barycentric> const& Vessel::psychohistory() const {
   return *psychohistory_;
 }
 
+std::int64_t Vessel::trajectories_size() const {
+  return history_->subtree_size();
+}
+
+std::int64_t Vessel::trajectories_memory_footprint() const {
+  return history_->subtree_memory_footprint();
+}
+
+Planetarium::PlottingCache& Vessel::psychohistory_plotting_cache() const {
+  return psychohistory_plotting_cache_;
+}
+
+Instant Vessel::psychohistory_stable_time() const {
+  // The points of the psychohistory that are not in the history are not
+  // authoritative.
+  return history_->last_downsampled_time();
+}
+
+std::int64_t Vessel::history_version() const {
+  return history_version_;
+}
+
 void Vessel::WriteToMessage(not_null<serialization::Vessel*> const message,
                             PileUp::SerializationIndexForPileUp const&
                                 serialization_index_for_pile_up) const {
@@ -285,6 +384,9 @@ void Vessel::WriteToMessage(not_null<serialization::Vessel*> const message,
   }
   history_->WriteToMessage(message->mutable_history(),
                            /*forks=*/{psychohistory_, prediction_});
+  // The histories are the bulk of a save, so store them compactly.
+  DiscreteTrajectory<Barycentric>::PackTimelines(message->mutable_history());
+  message->set_ephemeris_fingerprint(ephemeris_->Fingerprint());
   if (flight_plan_ != nullptr) {
     flight_plan_->WriteToMessage(message->mutable_flight_plan());
   }
@@ -353,6 +455,18 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
     vessel->history_ = DiscreteTrajectory<Barycentric>::ReadFromMessage(
         message.history(),
         /*forks=*/{&vessel->psychohistory_, &vessel->prediction_});
+    // The persisted prediction is reused if it was computed with the same
+    // ephemeris and starts at the tip of the psychohistory.  Otherwise it is
+    // discarded, and the prognosticator recomputes it in the background.
+    bool const prediction_is_valid =
+        (!message.has_ephemeris_fingerprint() ||
+         message.ephemeris_fingerprint() == ephemeris->Fingerprint()) &&
+        vessel->prediction_->Fork().time() ==
+            vessel->psychohistory_->last().time();
+    if (!prediction_is_valid) {
+      vessel->psychohistory_->DeleteFork(vessel->prediction_);
+      vessel->prediction_ = vessel->psychohistory_->NewForkAtLast();
+    }
   }
 
   if (is_pre_陈景润) {
@@ -389,6 +503,207 @@ Vessel::Vessel()
       ephemeris_(testing_utilities::make_not_null<Ephemeris<Barycentric>*>()),
       history_(make_not_null_unique<DiscreteTrajectory<Barycentric>>()) {}
 
+void Vessel::FlowPredictionBefore(
+    Instant const& time,
+    std::optional<std::chrono::steady_clock::time_point> const& deadline) {
+  if (time > prediction_->last().time()) {
+    // The prediction may have been reused from previous frames, so we limit
+    // the total number of its steps, not just that of this flow.
+    std::int64_t prediction_steps = 0;
+    for (auto it = prediction_->Fork(); it != prediction_->End(); ++it) {
+      ++prediction_steps;
+    }
+    // Don't count the fork point, which is in the psychohistory.
+    --prediction_steps;
+    auto parameters = prediction_adaptive_step_parameters_;
+    if (prediction_steps >= parameters.max_steps()) {
+      return;
+    }
+    parameters.set_max_steps(parameters.max_steps() - prediction_steps);
+    parameters.set_statistics(&prediction_statistics_);
+
+    if (deadline.has_value()) {
+      // This will prolong the ephemeris by |max_ephemeris_steps_per_frame| at a
+      // time until |time| is reached or the deadline passes.
+      ephemeris_->FlowWithAdaptiveStepBefore(
+          prediction_,
+          Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+          time,
+          parameters,
+          FlightPlan::max_ephemeris_steps_per_frame,
+          *deadline);
+      return;
+    }
+
+    bool const finite_time = IsFinite(time - prediction_->last().time());
+    Instant const t = finite_time ? time : ephemeris_->t_max();
+    // This will not prolong the ephemeris if |time| is infinite (but it may do
+    // so if it is finite).
+    bool const reached_t = ephemeris_->FlowWithAdaptiveStep(
+        prediction_,
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        t,
+        parameters,
+        FlightPlan::max_ephemeris_steps_per_frame,
+        /*last_point_only=*/false).ok();
+    if (!finite_time && reached_t) {
+      // This will prolong the ephemeris by |max_ephemeris_steps_per_frame|.
+      ephemeris_->FlowWithAdaptiveStep(
+        prediction_,
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        time,
+        parameters,
+        FlightPlan::max_ephemeris_steps_per_frame,
+        /*last_point_only=*/false);
+    }
+  }
+}
+
+void Vessel::RefreshPredictionBefore(
+    not_null<WorkStealingScheduler*> const scheduler,
+    std::optional<std::chrono::steady_clock::time_point> const& deadline) {
+  std::int64_t const generation = prediction_generation_;
+  bool attached = false;
+  {
+    std::lock_guard<std::mutex> l(prognosticator_lock_);
+    if (prognostication_ != nullptr &&
+        prognostication_generation_ == generation) {
+      AttachPrognostication();
+      attached = true;
+    }
+  }
+  if (!attached) {
+    FlowPredictionBefore(InfiniteFuture, deadline);
+  }
+  // At most one prognostication is in flight: if the one in flight is stale,
+  // it returns early and the next call requests a current one.
+  if (prognosticator_.valid()) {
+    if (!prognosticator_.is_ready()) {
+      return;
+    }
+    prognosticator_.get();
+  }
+  auto const psychohistory_last = psychohistory_->last();
+  PrognosticatorParameters const parameters{
+      psychohistory_last.time(),
+      psychohistory_last.degrees_of_freedom(),
+      prediction_adaptive_step_parameters_,
+      generation};
+  prognosticator_ = scheduler->Add([this, parameters]() {
+    FlowAndPublishPrognostication(parameters);
+  });
+}
+
+void Vessel::InvalidatePrediction() {
+  ++prediction_generation_;
+}
+
+void Vessel::FlowAndPublishPrognostication(
+    PrognosticatorParameters const& parameters) {
+  // The request may have become stale while it was queued.
+  if (parameters.generation != prediction_generation_) {
+    return;
+  }
+  AdaptiveStepStatistics statistics;
+  auto prognostication = FlowPrognostication(parameters, &statistics);
+  std::lock_guard<std::mutex> l(prognosticator_lock_);
+  prognostication_statistics_ += statistics;
+  if (prognostication != nullptr) {
+    prognostication_ = std::move(prognostication);
+    prognostication_generation_ = parameters.generation;
+    prognostication_is_attached_ = false;
+  }
+}
+
+std::unique_ptr<DiscreteTrajectory<Barycentric>> Vessel::FlowPrognostication(
+    PrognosticatorParameters const& parameters,
+    not_null<AdaptiveStepStatistics*> const statistics) {
+  auto adaptive_step_parameters = parameters.adaptive_step_parameters;
+  adaptive_step_parameters.set_statistics(statistics);
+  auto prognostication = std::make_unique<DiscreteTrajectory<Barycentric>>();
+  prognostication->Append(parameters.first_time,
+                          parameters.first_degrees_of_freedom);
+  // Same as |FlowPrediction(InfiniteFuture)|, except that staleness is checked
+  // between the two flows: first up to the end of the ephemeris, then beyond
+  // it, prolonging the ephemeris by |max_ephemeris_steps_per_frame|.
+  bool const reached_t_max = ephemeris_->FlowWithAdaptiveStep(
+      prognostication.get(),
+      Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+      ephemeris_->t_max(),
+      adaptive_step_parameters,
+      FlightPlan::max_ephemeris_steps_per_frame,
+      /*last_point_only=*/false).ok();
+  if (parameters.generation != prediction_generation_) {
+    return nullptr;
+  }
+  if (reached_t_max) {
+    ephemeris_->FlowWithAdaptiveStep(
+        prognostication.get(),
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        InfiniteFuture,
+        adaptive_step_parameters,
+        FlightPlan::max_ephemeris_steps_per_frame,
+        /*last_point_only=*/false);
+    if (parameters.generation != prediction_generation_) {
+      return nullptr;
+    }
+  }
+  return prognostication;
+}
+
+void Vessel::AttachPrognostication() {
+  Instant const previous_prediction_last_time = prediction_->last().time();
+  psychohistory_->DeleteFork(prediction_);
+  prediction_ = psychohistory_->NewForkAtLast();
+  prediction_statistics_ += prognostication_statistics_;
+  prognostication_statistics_ = AdaptiveStepStatistics();
+  Instant const prediction_first_time = prediction_->last().time();
+  for (auto it = prognostication_->LowerBound(prediction_first_time);
+       it != prognostication_->End();
+       ++it) {
+    if (it.time() > prediction_first_time) {
+      prediction_->Append(it.time(), it.degrees_of_freedom());
+    }
+  }
+  // Attaching the same prognostication again yields the same points, unless
+  // the prediction had been extended beyond it.
+  if (!prognostication_is_attached_ ||
+      prediction_->last().time() != previous_prediction_last_time) {
+    ++prediction_version_;
+  }
+  prognostication_is_attached_ = true;
+}
+
+bool Vessel::ReusePrediction(
+    DiscreteTrajectory<Barycentric> const& previous_prediction) {
+  auto const psychohistory_last = psychohistory_->last();
+  Instant const& t = psychohistory_last.time();
+  if (previous_prediction.Begin().time() > t ||
+      previous_prediction.last().time() <= t) {
+    return false;
+  }
+  DegreesOfFreedom<Barycentric> const predicted_degrees_of_freedom =
+      previous_prediction.EvaluateDegreesOfFreedom(t);
+  DegreesOfFreedom<Barycentric> const& degrees_of_freedom =
+      psychohistory_last.degrees_of_freedom();
+  if ((predicted_degrees_of_freedom.position() -
+       degrees_of_freedom.position()).Norm() >
+          prediction_adaptive_step_parameters_.length_integration_tolerance() ||
+      (predicted_degrees_of_freedom.velocity() -
+       degrees_of_freedom.velocity()).Norm() >
+          prediction_adaptive_step_parameters_.speed_integration_tolerance()) {
+    return false;
+  }
+  for (auto it = previous_prediction.LowerBound(t);
+       it != previous_prediction.End();
+       ++it) {
+    if (it.time() > t) {
+      prediction_->Append(it.time(), it.degrees_of_freedom());
+    }
+  }
+  return true;
+}
+
 void Vessel::AppendToVesselTrajectory(
     TrajectoryIterator const part_trajectory_begin,
     TrajectoryIterator const part_trajectory_end,
@@ -437,6 +752,39 @@ void Vessel::AppendToVesselTrajectory(
   }
 }
 
+bool Vessel::AppendPileUpTailToVesselTrajectories() {
+  CHECK(!parts_.empty());
+  PileUpTail const* const tail = parts_.begin()->second->pile_up_tail();
+  if (tail == nullptr) {
+    return false;
+  }
+
+  // The degrees of freedom of each part are those of the tail offset by a
+  // constant, and so are those of their barycentre.  The offsets are turned
+  // into degrees of freedom to compute that barycentre.
+  DegreesOfFreedom<Barycentric> const origin(Barycentric::origin,
+                                             Velocity<Barycentric>());
+  BarycentreCalculator<DegreesOfFreedom<Barycentric>, Mass> calculator;
+  for (auto const& pair : parts_) {
+    Part const& part = *pair.second;
+    if (part.pile_up_tail() != tail) {
+      return false;
+    }
+    calculator.Add(origin + part.pile_up_tail_offset(), part.mass());
+  }
+  RelativeDegreesOfFreedom<Barycentric> const offset =
+      calculator.Get() - origin;
+
+  for (auto const& [time, degrees_of_freedom] : tail->history) {
+    history_->Append(time, degrees_of_freedom + offset);
+  }
+  psychohistory_ = history_->NewForkAtLast();
+  for (auto const& [time, degrees_of_freedom] : tail->psychohistory) {
+    psychohistory_->Append(time, degrees_of_freedom + offset);
+  }
+  return true;
+}
+
 }  // namespace internal_vessel
 }  // namespace ksp_plugin
 }  // namespace principia
@@ -1,17 +1,25 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "base/macros.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "ksp_plugin/celestial.hpp"
 #include "ksp_plugin/flight_plan.hpp"
 #include "ksp_plugin/part.hpp"
 #include "ksp_plugin/pile_up.hpp"
+#include "ksp_plugin/planetarium.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
 #include "physics/massless_body.hpp"
@@ -22,9 +30,12 @@ namespace principia {
 namespace ksp_plugin {
 namespace internal_vessel {
 
+using base::Future;
 using base::not_null;
+using base::WorkStealingScheduler;
 using geometry::Instant;
 using geometry::Vector;
+using integrators::AdaptiveStepStatistics;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
@@ -113,24 +124,47 @@ class Vessel {
 
   virtual DiscreteTrajectory<Barycentric> const& prediction() const;
 
+  // Changes whenever the points of the prediction are replaced by different
+  // ones.  It doesn't change when the prediction is extended, or when it is
+  // forked again at the end of the psychohistory with the points of the
+  // previous prediction that follow.  Therefore, as long as it doesn't change,
+  // the prediction is unchanged after its first point following the fork.
+  virtual std::int64_t prediction_version() const;
+
   virtual void set_prediction_adaptive_step_parameters(
       Ephemeris<Barycentric>::AdaptiveStepParameters const&
           prediction_adaptive_step_parameters);
   virtual Ephemeris<Barycentric>::AdaptiveStepParameters const&
   prediction_adaptive_step_parameters() const;
 
+  // The work done so far by the integrator to compute the predictions of this
+  // vessel.  The work done in the background is included once a
+  // prognostication has been attached.  Not serialized.
+  virtual AdaptiveStepStatistics const& prediction_statistics() const;
+
   // Requires |has_flight_plan()|.
   virtual FlightPlan& flight_plan() const;
   virtual bool has_flight_plan() const;
 
   // Extends the psychohistory of this vessel by computing the centre of mass of
-  // its parts at every point in their tail.  Clears the tails.
+  // its parts at every point in their tail.  Clears the tails.  If the vessel
+  // is coasting and the end of the new psychohistory lies on the previous
+  // prediction within the integration tolerances, the part of that prediction
+  // after the end of the psychohistory is kept, so that only its tail needs to
+  // be flowed again.
   virtual void AdvanceTime();
 
   // Forgets the trajectories and flight plan before |time|.  This may delete
   // the flight plan.
   virtual void ForgetBefore(Instant const& time);
 
+  // Retains the old parts of the history with a precision that decreases with
+  // their age: the points older than the age of a retention tier at
+  // |current_time| are downsampled with the tolerance of that tier.  Only the
+  // points that became old enough for a tier since the last call are
+  // processed, so this is cheap when called every frame.
+  virtual void CompactHistory(Instant const& current_time);
+
   // Creates a |flight_plan_| at the end of history using the given parameters.
   // Deletes any pre-existing predictions.
   virtual void CreateFlightPlan(
@@ -143,11 +177,53 @@ class Vessel {
   virtual void DeleteFlightPlan();
 
   // Tries to extend the prediction up to and including |last_time|.  May not be
-  // able to do it next to a singularity.
+  // able to do it next to a singularity.  The prediction, which may be reused
+  // from frame to frame, never has more than the |max_steps| of
+  // |prediction_adaptive_step_parameters()| points after the psychohistory.
   virtual void FlowPrediction(Instant const& last_time);
 
+  // Replaces the prediction with the most recent prognostication that was
+  // computed in the background for the current state of the vessel, and,
+  // unless a prognostication is already in flight, adds to |scheduler| a task
+  // that computes a new one starting at the end of the psychohistory.  If no
+  // current prognostication is available, e.g., because the vessel is under
+  // thrust or because the parameters changed, the prediction is flowed on the
+  // calling thread as by |FlowPrediction(InfiniteFuture)|, which bounds the
+  // work by |max_steps| and |FlightPlan::max_ephemeris_steps_per_frame|.  Must
+  // be called on the thread that owns this object.
+  virtual void RefreshPrediction(not_null<WorkStealingScheduler*> scheduler);
+  // Same as above, but if the prediction must be flowed on the calling thread,
+  // the flow stops at |deadline|, prolonging the ephemeris as needed; it will
+  // be resumed by the next call if the prediction is reused.
+  virtual void RefreshPrediction(
+      not_null<WorkStealingScheduler*> scheduler,
+      std::chrono::steady_clock::time_point const& deadline);
+
+  // Blocks until the prognostication in flight, if any, has completed.  The
+  // next call to |RefreshPrediction| attaches it if it is still current.  Must
+  // be called on the thread that owns this object.
+  virtual void WaitForPrognostication();
+
   virtual DiscreteTrajectory<Barycentric> const& psychohistory() const;
 
+  // The number of points of the history and of its forks, the psychohistory
+  // and the prediction, and the number of bytes allocated for them.  Only
+  // useful for analyzing memory usage.
+  virtual std::int64_t trajectories_size() const;
+  virtual std::int64_t trajectories_memory_footprint() const;
+
+  // The cache used to plot the psychohistory incrementally from frame to
+  // frame.  Must only be used on the thread that owns this object.
+  virtual Planetarium::PlottingCache& psychohistory_plotting_cache() const;
+
+  // The psychohistory doesn't change up to |psychohistory_stable_time()| as
+  // long as |history_version()| doesn't change: the points of the
+  // psychohistory up to that time are authoritative and are not removed by the
+  // downsampling of the history.  The version changes whenever other points of
+  // the history are removed, e.g., by compaction.
+  virtual Instant psychohistory_stable_time() const;
+  virtual std::int64_t history_version() const;
+
   // The vessel must satisfy |is_initialized()|.
   virtual void WriteToMessage(not_null<serialization::Vessel*> message,
                               PileUp::SerializationIndexForPileUp const&
@@ -177,12 +253,67 @@ class Vessel {
                                 TrajectoryIterator part_trajectory_end,
                                 DiscreteTrajectory<Barycentric>& trajectory);
 
+  // If all the parts of this vessel have the same |pile_up_tail|, appends its
+  // points, offset by the barycentre of the parts, to the |history_| and to a
+  // new |psychohistory_| forked at its end, and returns true.  Otherwise does
+  // nothing and returns false.  The cost is independent of the number of parts
+  // for each point of the tail.
+  bool AppendPileUpTailToVesselTrajectories();
+
+  // A request for a prognostication, i.e., a prediction computed in the
+  // background.
+  struct PrognosticatorParameters final {
+    Instant first_time;
+    DegreesOfFreedom<Barycentric> first_degrees_of_freedom;
+    Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters;
+    // The value of |prediction_generation_| when the request was made.
+    std::int64_t generation;
+  };
+
+  // The implementations of |FlowPrediction| and |RefreshPrediction|, with an
+  // optional deadline.
+  void FlowPredictionBefore(
+      Instant const& last_time,
+      std::optional<std::chrono::steady_clock::time_point> const& deadline);
+  void RefreshPredictionBefore(
+      not_null<WorkStealingScheduler*> scheduler,
+      std::optional<std::chrono::steady_clock::time_point> const& deadline);
+
+  // Makes the current prediction stale: the prognostications in flight are
+  // abandoned and the completed ones are not used anymore.  Thread-safe.
+  void InvalidatePrediction();
+
+  // The task run by |prognosticator_|: computes the prognostication requested
+  // by |parameters| and publishes it, unless it became stale.
+  void FlowAndPublishPrognostication(PrognosticatorParameters const& parameters)
+      EXCLUDES(prognosticator_lock_);
+
+  // Returns null if the request became stale during the computation.  The
+  // work done by the integrator is added to |*statistics|.
+  std::unique_ptr<DiscreteTrajectory<Barycentric>> FlowPrognostication(
+      PrognosticatorParameters const& parameters,
+      not_null<AdaptiveStepStatistics*> statistics);
+
+  // Replaces |prediction_| with a fork of |psychohistory_| made of the points
+  // of |prognostication_| after the end of the psychohistory.
+  void AttachPrognostication() REQUIRES(prognosticator_lock_);
+
+  // Appends to |prediction_|, which must be a fork at the end of
+  // |psychohistory_| with no other points, the points of |previous_prediction|
+  // after the end of the psychohistory, if |previous_prediction| goes through
+  // the last point of the psychohistory within the tolerances of
+  // |prediction_adaptive_step_parameters_|.  Returns true if the points were
+  // appended.
+  bool ReusePrediction(
+      DiscreteTrajectory<Barycentric> const& previous_prediction);
+
   GUID const guid_;
   std::string name_;
 
   MasslessBody const body_;
   Ephemeris<Barycentric>::AdaptiveStepParameters
       prediction_adaptive_step_parameters_;
+  AdaptiveStepStatistics prediction_statistics_;
   // The parent body for the 2-body approximation. Not owning.
   not_null<Celestial const*> parent_;
   not_null<Ephemeris<Barycentric>*> const ephemeris_;
@@ -198,6 +329,45 @@ class Vessel {
   DiscreteTrajectory<Barycentric>* prediction_ = nullptr;
 
   std::unique_ptr<FlightPlan> flight_plan_;
+
+  // Not serialized, the psychohistory is replotted after deserialization.
+  mutable Planetarium::PlottingCache psychohistory_plotting_cache_;
+  // See |history_version()|.
+  std::int64_t history_version_ = 0;
+
+  // For each retention tier, the time up to which the history has been
+  // compacted.  Not serialized: after deserialization the history is compacted
+  // again, which only removes the points that became superfluous.
+  std::vector<Instant> history_compacted_until_;
+
+  // Incremented when the state of the vessel changes in a way that makes the
+  // prognostications computed so far useless.
+  std::atomic<std::int64_t> prediction_generation_ = 0;
+  // The value of |prediction_generation_| at the end of the last call to
+  // |AdvanceTime|.  If it changed since, the prediction may not be reused.
+  // Only used on the thread that owns this object.
+  std::int64_t prediction_generation_at_last_advance_ = 0;
+  // See |prediction_version()|.  Only used on the thread that owns this
+  // object.  Not serialized.
+  std::int64_t prediction_version_ = 0;
+
+  // The task that computes the prognostication in flight, if any.  Invalid if
+  // no prognostication was ever requested or if the last one was waited for.
+  // Only used on the thread that owns this object.
+  Future<void> prognosticator_;
+  std::mutex prognosticator_lock_;
+  // The most recent completed prognostication, a root trajectory, and the
+  // generation of the request that produced it.
+  std::unique_ptr<DiscreteTrajectory<Barycentric>> prognostication_
+      GUARDED_BY(prognosticator_lock_);
+  std::int64_t prognostication_generation_ GUARDED_BY(prognosticator_lock_) =
+      -1;
+  // Whether |prognostication_| has been attached since it was completed.
+  bool prognostication_is_attached_ GUARDED_BY(prognosticator_lock_) = false;
+  // The work done by the |prognosticator_| since the last call to
+  // |AttachPrognostication|.
+  AdaptiveStepStatistics prognostication_statistics_
+      GUARDED_BY(prognosticator_lock_);
 };
 
 }  // namespace internal_vessel
@@ -43,18 +43,117 @@ public enum Style {
 
   public static DisposablePlanetarium NewPlanetarium(IntPtr plugin,
                                                      XYZ sun_world_position) {
+    XYZ opengl_camera_x_in_world;
+    XYZ opengl_camera_y_in_world;
+    XYZ opengl_camera_z_in_world;
+    XYZ camera_position_in_world;
+    double field_of_view;
+    GetCamera(out opengl_camera_x_in_world,
+              out opengl_camera_y_in_world,
+              out opengl_camera_z_in_world,
+              out camera_position_in_world,
+              out field_of_view);
+    return plugin.PlanetariumCreate(sun_world_position,
+                                    opengl_camera_x_in_world,
+                                    opengl_camera_y_in_world,
+                                    opengl_camera_z_in_world,
+                                    camera_position_in_world,
+                                    /*focal=*/1,
+                                    field_of_view);
+  }
+
+  // Updates a |planetarium| returned by |NewPlanetarium| for the current
+  // camera.
+  public static void UpdatePlanetarium(DisposablePlanetarium planetarium,
+                                       IntPtr plugin,
+                                       XYZ sun_world_position) {
+    XYZ opengl_camera_x_in_world;
+    XYZ opengl_camera_y_in_world;
+    XYZ opengl_camera_z_in_world;
+    XYZ camera_position_in_world;
+    double field_of_view;
+    GetCamera(out opengl_camera_x_in_world,
+              out opengl_camera_y_in_world,
+              out opengl_camera_z_in_world,
+              out camera_position_in_world,
+              out field_of_view);
+    planetarium.PlanetariumUpdate(plugin,
+                                  sun_world_position,
+                                  opengl_camera_x_in_world,
+                                  opengl_camera_y_in_world,
+                                  opengl_camera_z_in_world,
+                                  camera_position_in_world,
+                                  /*focal=*/1,
+                                  field_of_view);
+  }
+
+  public static void PlotRP2Lines(DisposableIterator rp2_lines_iterator,
+                                  UnityEngine.Color colour,
+                                  Style style) {
+    UnityEngine.GL.Color(colour);
+
+    // Fetch all the points in a single call, growing the buffers if needed.
+    int line_count;
+    int size = rp2_lines_iterator.IteratorGetRP2LinesXY(rp2_xy_,
+                                                        rp2_xy_.Length,
+                                                        rp2_line_ends_,
+                                                        rp2_line_ends_.Length,
+                                                        out line_count);
+    if (size > rp2_xy_.Length || line_count > rp2_line_ends_.Length) {
+      rp2_xy_ = new XY[Math.Max(size, 2 * rp2_xy_.Length)];
+      rp2_line_ends_ =
+          new int[Math.Max(line_count, 2 * rp2_line_ends_.Length)];
+      rp2_lines_iterator.IteratorGetRP2LinesXY(rp2_xy_,
+                                               rp2_xy_.Length,
+                                               rp2_line_ends_,
+                                               rp2_line_ends_.Length,
+                                               out line_count);
+    }
+
+    int index = 0;
+    for (int i = 0; i < line_count; ++i) {
+      XY? previous_rp2_point = null;
+      for (; index < rp2_line_ends_[i]; ++index) {
+        XY current_rp2_point = ToScreen(rp2_xy_[index]);
+        if (previous_rp2_point.HasValue) {
+          if (style == Style.FADED) {
+            colour.a = 1 - (float)(4 * index) / (float)(5 * size);
+            UnityEngine.GL.Color(colour);
+          }
+          if (style != Style.DASHED || index % 2 == 1) {
+            UnityEngine.GL.Vertex3((float)previous_rp2_point.Value.x,
+                                    (float)previous_rp2_point.Value.y,
+                                    0);
+            UnityEngine.GL.Vertex3((float)current_rp2_point.x,
+                                    (float)current_rp2_point.y,
+                                    0);
+          }
+        }
+        previous_rp2_point = current_rp2_point;
+      }
+    }
+  }
+
+  // Returns the axes and position of the camera in |World| and its field of
+  // view, as expected by |PlanetariumCreate| and |PlanetariumUpdate|.
+  private static void GetCamera(out XYZ opengl_camera_x_in_world,
+                                out XYZ opengl_camera_y_in_world,
+                                out XYZ opengl_camera_z_in_world,
+                                out XYZ camera_position_in_world,
+                                out double field_of_view) {
     UnityEngine.Camera camera = PlanetariumCamera.Camera;
-    UnityEngine.Vector3 opengl_camera_x_in_world =
-        camera.cameraToWorldMatrix.MultiplyVector(
+    opengl_camera_x_in_world =
+        (XYZ)(Vector3d)camera.cameraToWorldMatrix.MultiplyVector(
             new UnityEngine.Vector3(1, 0, 0));
-    UnityEngine.Vector3 opengl_camera_y_in_world =
-        camera.cameraToWorldMatrix.MultiplyVector(
+    opengl_camera_y_in_world =
+        (XYZ)(Vector3d)camera.cameraToWorldMatrix.MultiplyVector(
             new UnityEngine.Vector3(0, 1, 0));
-    UnityEngine.Vector3 opengl_camera_z_in_world =
-        camera.cameraToWorldMatrix.MultiplyVector(
+    opengl_camera_z_in_world =
+        (XYZ)(Vector3d)camera.cameraToWorldMatrix.MultiplyVector(
             new UnityEngine.Vector3(0, 0, 1));
-    UnityEngine.Vector3 camera_position_in_world =
-        ScaledSpace.ScaledToLocalSpace(camera.transform.position);
+    camera_position_in_world =
+        (XYZ)(Vector3d)ScaledSpace.ScaledToLocalSpace(
+            camera.transform.position);
 
     // For explanations regarding the OpenGL projection matrix, see
     // http://www.songho.ca/opengl/gl_projectionmatrix.html.  The on-centre
@@ -70,67 +169,7 @@ public enum Style {
     // the clipping distance, and in space, no one can hear you clip.
     double m00 = camera.projectionMatrix[0, 0];
     double m11 = camera.projectionMatrix[1, 1];
-    double field_of_view = Math.Atan2(Math.Sqrt(m00 * m00 + m11 * m11),
-                                      m00 * m11);
-    return plugin.PlanetariumCreate(
-               sun_world_position,
-               (XYZ)(Vector3d)opengl_camera_x_in_world,
-               (XYZ)(Vector3d)opengl_camera_y_in_world,
-               (XYZ)(Vector3d)opengl_camera_z_in_world,
-               (XYZ)(Vector3d)camera_position_in_world,
-               /*focal=*/1,
-               field_of_view);
-  }
-
-  public static void PlotRP2Lines(DisposableIterator rp2_lines_iterator,
-                                  UnityEngine.Color colour,
-                                  Style style) {
-    UnityEngine.GL.Color(colour);
-
-    // First evaluate the total size of the lines.
-    int size = 0;
-    for (;
-         !rp2_lines_iterator.IteratorAtEnd();
-         rp2_lines_iterator.IteratorIncrement()) {
-      using (DisposableIterator rp2_line_iterator =
-                rp2_lines_iterator.IteratorGetRP2LinesIterator()) {
-        size += rp2_line_iterator.IteratorSize();
-      }
-    }
-
-    // Reset the iterator and do the actual plotting.
-    rp2_lines_iterator.IteratorReset();
-    int index = 0;
-    for (;
-         !rp2_lines_iterator.IteratorAtEnd();
-         rp2_lines_iterator.IteratorIncrement()) {
-      using (DisposableIterator rp2_line_iterator =
-                rp2_lines_iterator.IteratorGetRP2LinesIterator()) {
-        XY? previous_rp2_point = null;
-        for (;
-             !rp2_line_iterator.IteratorAtEnd();
-             rp2_line_iterator.IteratorIncrement()) {
-          XY current_rp2_point = ToScreen(
-              rp2_line_iterator.IteratorGetRP2LineXY());
-          if (previous_rp2_point.HasValue) {
-            if (style == Style.FADED) {
-              colour.a = 1 - (float)(4 * index) / (float)(5 * size);
-              UnityEngine.GL.Color(colour);
-            }
-            if (style != Style.DASHED || index % 2 == 1) {
-              UnityEngine.GL.Vertex3((float)previous_rp2_point.Value.x,
-                                      (float)previous_rp2_point.Value.y,
-                                      0);
-              UnityEngine.GL.Vertex3((float)current_rp2_point.x,
-                                      (float)current_rp2_point.y,
-                                      0);
-            }
-          }
-          previous_rp2_point = current_rp2_point;
-          ++index;
-        }
-      }
-    }
+    field_of_view = Math.Atan2(Math.Sqrt(m00 * m00 + m11 * m11), m00 * m11);
   }
 
   private static UnityEngine.Vector3 WorldToMapScreen(Vector3d world) {
@@ -146,6 +185,10 @@ public enum Style {
                       0.5 * camera.pixelHeight};
    }
 
+  // Buffers reused across calls to |PlotRP2Lines|.
+  private static XY[] rp2_xy_ = new XY[1024];
+  private static int[] rp2_line_ends_ = new int[64];
+
   private static UnityEngine.Material line_material_;
   private static UnityEngine.Material line_material {
     get {
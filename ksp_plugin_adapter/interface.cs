@@ -44,10 +44,124 @@ internal static partial class Interface {
              CallingConvention = CallingConvention.Cdecl)]
   internal static extern void ActivateRecorder(bool activate);
 
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__ActivateRecorderWithOptions",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void ActivateRecorderWithOptions(
+      bool activate,
+      bool replayable_only,
+      int rolling_window_in_minutes);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__ActivateTracer",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void ActivateTracer(bool activate);
+
   [DllImport(dllName           : dll_path,
              EntryPoint        = "principia__InitGoogleLogging",
              CallingConvention = CallingConvention.Cdecl)]
   internal static extern void InitGoogleLogging();
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__GetCelestialStates",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void GetCelestialStates(
+      this IntPtr plugin,
+      int[] celestial_indices,
+      int celestial_indices_size,
+      [Out] CelestialState[] states);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__GetVesselStates",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void GetVesselStates(
+      this IntPtr plugin,
+      string[] vessel_guids,
+      int vessel_guids_size,
+      [Out] VesselState[] states);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__GetPartsActualDegreesOfFreedom",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void GetPartsActualDegreesOfFreedom(
+      this IntPtr plugin,
+      uint[] part_ids,
+      int part_ids_size,
+      Origin origin,
+      [Out] QP[] degrees_of_freedom);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__IteratorGetRP2LinesXY",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern int IteratorGetRP2LinesXY(
+      [MarshalAs(UnmanagedType.CustomMarshaler,
+                 MarshalTypeRef = typeof(DisposableIteratorMarshaller))]
+      this DisposableIterator iterator,
+      [Out] XY[] xy,
+      int xy_size,
+      [Out] int[] line_ends,
+      int line_ends_size,
+      out int line_count);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__IteratorGetDiscreteTrajectoryFloatXYZs",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern int IteratorGetDiscreteTrajectoryFloatXYZs(
+      [MarshalAs(UnmanagedType.CustomMarshaler,
+                 MarshalTypeRef = typeof(DisposableIteratorMarshaller))]
+      this DisposableIterator iterator,
+      XYZ floating_origin,
+      int stride,
+      [Out] FloatXYZ[] xyz,
+      int xyz_size);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__ProfilerSetEnabled",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void ProfilerSetEnabled(bool enabled);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__ProfilerReset",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void ProfilerReset();
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__ProfilerGetReport",
+             CallingConvention = CallingConvention.Cdecl)]
+  [return: MarshalAs(UnmanagedType.CustomMarshaler,
+                     MarshalTypeRef = typeof(OutOwnedUTF8Marshaler))]
+  internal static extern string ProfilerGetReport();
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__ProfilerLogReport",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void ProfilerLogReport();
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__ProfilerGetSnapshot",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern int ProfilerGetSnapshot(
+      [Out] TimingStatistics[] statistics,
+      int statistics_size);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__ProfilerGetPhaseName",
+             CallingConvention = CallingConvention.Cdecl)]
+  [return: MarshalAs(UnmanagedType.CustomMarshaler,
+                     MarshalTypeRef = typeof(OutUTF8Marshaler))]
+  internal static extern string ProfilerGetPhaseName(int phase);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__GetMemoryReport",
+             CallingConvention = CallingConvention.Cdecl)]
+  [return: MarshalAs(UnmanagedType.CustomMarshaler,
+                     MarshalTypeRef = typeof(OutOwnedUTF8Marshaler))]
+  internal static extern string GetMemoryReport(this IntPtr plugin);
+
+  [DllImport(dllName           : dll_path,
+             EntryPoint        = "principia__LogMemoryReport",
+             CallingConvention = CallingConvention.Cdecl)]
+  internal static extern void LogMemoryReport(this IntPtr plugin);
 }
 
 }  // namespace ksp_plugin_adapter
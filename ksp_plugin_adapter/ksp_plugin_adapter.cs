@@ -62,6 +62,8 @@ private enum UnityLayers {
       "principia_gravity_model";
   private const String principia_numerics_blueprint_config_name_ =
       "principia_numerics_blueprint";
+  private const String principia_thread_configuration_config_name_ =
+      "principia_thread_configuration";
 
   private KSP.UI.Screens.ApplicationLauncherButton toolbar_button_;
   private bool hide_all_gui_ = false;
@@ -89,6 +91,9 @@ private enum UnityLayers {
   private bool selecting_target_celestial_ = false;
 
   private IntPtr plugin_ = IntPtr.Zero;
+  // Refers to the plugin, so it must be disposed of before the plugin is
+  // deleted.
+  private DisposablePlanetarium planetarium_;
 
   private bool display_patched_conics_ = false;
 
@@ -132,12 +137,19 @@ private enum UnityLayers {
   [KSPField(isPersistant = true)]
   private string serialization_compression_ = "";
 
+  // How to encode the serialized plugin in the save: "hexadecimal" or
+  // "base32768".
+  [KSPField(isPersistant = true)]
+  private string serialization_encoding_ = "hexadecimal";
+
   // Whether the plotting frame must be set to something convenient at the next
   // opportunity.
   private bool must_set_plotting_frame_ = false;
 
   // Whether a journal is currently being recorded.
   private static bool journaling_;
+  // Whether the durations of the interface calls are currently being traced.
+  private static bool tracing_;
 #if CRASH_BUTTON
   [KSPField(isPersistant = true)]
   private bool show_crash_options_ = false;
@@ -164,6 +176,20 @@ private enum UnityLayers {
 
   List<IntPtr> vessel_futures_ = new List<IntPtr>();
 
+  // An unloaded vessel that nobody is watching is put to sleep in the plugin
+  // and left to the stock on-rails propagation, but it is caught up at least
+  // once every |max_sleep_duration_| seconds of game time.
+  private const double max_sleep_duration_ = 3600;
+  // The wall-clock time, in seconds, that may be spent in each frame flowing
+  // the predictions that could not be computed in the background.
+  private const double prediction_frame_budget_ = 0.005;
+  // Whether the saves contain the segments of the flight plans, so that they
+  // need not be recomputed when the save is loaded.
+  private const bool persist_flight_plan_segments_ = true;
+  private Dictionary<Guid, double> vessel_catch_up_times_ =
+      new Dictionary<Guid, double>();
+  private HashSet<Guid> sleeping_vessels_ = new HashSet<Guid>();
+
   // The RSAS is the component of the stock KSP autopilot that deals with
   // orienting the vessel towards a specific direction (e.g. prograde).
   // It is, as usual for KSP, an ineffable acronym; it is however likely derived
@@ -302,11 +328,25 @@ private enum UnityLayers {
     }
   }
 
-  private void UpdateBody(CelestialBody body, double universal_time) {
-    plugin_.UpdateCelestialHierarchy(
-        body.flightGlobalsIndex,
-        body.orbit.referenceBody.flightGlobalsIndex);
-    QP from_parent = plugin_.CelestialFromParent(body.flightGlobalsIndex);
+  // Returns the states of all the celestials, keyed by |flightGlobalsIndex|,
+  // obtained with a single call to the plugin.
+  private Dictionary<int, CelestialState> GetCelestialStates() {
+    int[] celestial_indices =
+        FlightGlobals.Bodies.Select(body => body.flightGlobalsIndex).ToArray();
+    var states = new CelestialState[celestial_indices.Length];
+    plugin_.GetCelestialStates(celestial_indices,
+                               celestial_indices.Length,
+                               states);
+    var result = new Dictionary<int, CelestialState>();
+    for (int i = 0; i < celestial_indices.Length; ++i) {
+      result.Add(celestial_indices[i], states[i]);
+    }
+    return result;
+  }
+
+  private void UpdateBody(CelestialBody body,
+                          QP from_parent,
+                          double universal_time) {
     // TODO(egg): Some of this might be be superfluous and redundant.
     Orbit original = body.orbit;
     Orbit copy = new Orbit(original.inclination, original.eccentricity,
@@ -366,23 +406,41 @@ private enum UnityLayers {
           FlightGlobals.fetch.VesselTarget?.GetVessel()?.id.ToString();
       if (!plotting_frame_selector_.get().target_override &&
           target_id != null && plugin_.HasVessel(target_id)) {
-        plugin_.VesselSetPredictionAdaptiveStepParameters(
-            target_id, adaptive_step_parameters);
-        plugin_.UpdatePrediction(target_id);
+        // The target is secondary to the active vessel, so its prediction is
+        // computed at a lower level of detail.
+        plugin_.UpdateSecondaryPrediction(target_id);
       }
     }
   }
 
-  private void UpdateVessel(Vessel vessel, double universal_time) {
-     if (plugin_.HasVessel(vessel.id.ToString())) {
-       QP from_parent = plugin_.VesselFromParent(
-           vessel.mainBody.flightGlobalsIndex,
-           vessel.id.ToString());
-       vessel.orbit.UpdateFromStateVectors(pos : (Vector3d)from_parent.q,
-                                           vel : (Vector3d)from_parent.p,
-                                           refBody : vessel.orbit.referenceBody,
-                                           UT : universal_time);
-     }
+  // Whether |vessel|, which must be packed, may be left asleep at
+  // |universal_time|.
+  private bool may_sleep(Vessel vessel, double universal_time) {
+    double catch_up_time;
+    return vessel != FlightGlobals.ActiveVessel &&
+           vessel != FlightGlobals.fetch.VesselTarget?.GetVessel() &&
+           vessel != space_tracking?.SelectedVessel &&
+           vessel != PlanetariumCamera.fetch?.target?.vessel &&
+           vessel_catch_up_times_.TryGetValue(vessel.id,
+                                              out catch_up_time) &&
+           universal_time - catch_up_time < max_sleep_duration_;
+  }
+
+  // Updates the orbits of the given |vessels|, which must be known to the
+  // plugin, using their parents and states obtained with a single call to the
+  // plugin.  The plugin decides when the vessels change spheres of influence.
+  private void UpdateVessels(List<Vessel> vessels, double universal_time) {
+    string[] vessel_guids =
+        vessels.Select(vessel => vessel.id.ToString()).ToArray();
+    var states = new VesselState[vessel_guids.Length];
+    plugin_.GetVesselStates(vessel_guids, vessel_guids.Length, states);
+    for (int i = 0; i < vessels.Count; ++i) {
+      vessels[i].orbit.UpdateFromStateVectors(
+          pos     : (Vector3d)states[i].from_parent.q,
+          vel     : (Vector3d)states[i].from_parent.p,
+          refBody : FlightGlobals.Bodies[states[i].parent_index],
+          UT      : universal_time);
+    }
   }
 
   private bool time_is_advancing(double universal_time) {
@@ -595,9 +653,15 @@ private enum UnityLayers {
       String serialization;
       IntPtr serializer = IntPtr.Zero;
       for (;;) {
-        serialization = plugin_.SerializePluginHexadecimal(
-                            ref serializer,
-                            serialization_compression_);
+        if (serialization_encoding_ == "base32768") {
+          serialization = plugin_.SerializePluginBase32768(
+                              ref serializer,
+                              serialization_compression_);
+        } else {
+          serialization = plugin_.SerializePluginHexadecimal(
+                              ref serializer,
+                              serialization_compression_);
+        }
         if (serialization == null) {
           break;
         }
@@ -615,6 +679,7 @@ private enum UnityLayers {
     if (node.HasValue(principia_serialized_plugin_)) {
       Cleanup();
       RemoveBuggyTidalLocking();
+      ConfigureThreads();
       Log.SetBufferedLogging(buffered_logging_);
       Log.SetSuppressedLogging(suppressed_logging_);
       Log.SetStderrLogging(stderr_logging_);
@@ -623,21 +688,35 @@ private enum UnityLayers {
       IntPtr deserializer = IntPtr.Zero;
       String[] serializations = node.GetValues(principia_serialized_plugin_);
       Log.Info("Serialization has " + serializations.Length + " chunks");
-      foreach (String serialization in serializations) {
-        Interface.DeserializePluginHexadecimal(serialization,
-                                               serialization.Length,
+      if (serialization_encoding_ == "base32768") {
+        foreach (String serialization in serializations) {
+          Interface.DeserializePluginBase32768(serialization,
                                                ref deserializer,
                                                ref plugin_,
                                                serialization_compression_);
-      }
-      Interface.DeserializePluginHexadecimal("",
-                                             0,
+        }
+        Interface.DeserializePluginBase32768("",
                                              ref deserializer,
                                              ref plugin_,
                                              serialization_compression_);
+      } else {
+        foreach (String serialization in serializations) {
+          Interface.DeserializePluginHexadecimal(serialization,
+                                                 serialization.Length,
+                                                 ref deserializer,
+                                                 ref plugin_,
+                                                 serialization_compression_);
+        }
+        Interface.DeserializePluginHexadecimal("",
+                                               0,
+                                               ref deserializer,
+                                               ref plugin_,
+                                               serialization_compression_);
+      }
       if (serialization_compression_ == "") {
         serialization_compression_ = "gipfeli";
       }
+      serialization_encoding_ = "base32768";
 
       plotting_frame_selector_.reset(
           new ReferenceFrameSelector(this, 
@@ -647,6 +726,8 @@ private enum UnityLayers {
       previous_display_mode_ = null;
       must_set_plotting_frame_ = true;
       flight_planner_.reset(new FlightPlanner(this, plugin_));
+      plugin_.SetPredictionFrameBudget(prediction_frame_budget_);
+      plugin_.SetPersistFlightPlanSegments(persist_flight_plan_segments_);
 
       plugin_construction_ = DateTime.Now;
     } else {
@@ -766,10 +847,11 @@ private enum UnityLayers {
 
     // Orient the celestial bodies.
     if (PluginRunning()) {
+      var celestial_states = GetCelestialStates();
       foreach (var body in FlightGlobals.Bodies) {
         body.scaledBody.transform.rotation =
-            (UnityEngine.QuaternionD)plugin_.CelestialRotation(
-                body.flightGlobalsIndex);
+            (UnityEngine.QuaternionD)celestial_states[
+                body.flightGlobalsIndex].rotation;
       }
     }
 
@@ -1084,6 +1166,10 @@ private enum UnityLayers {
                              FlightGlobals.GetHomeBody()).position,
                p = (XYZ)(-krakensbane.FrameVel)};
 
+    // The intrinsic forces of all the loaded parts, passed to the plugin in a
+    // single call once all the parts have been inserted.
+    var intrinsic_forces = new List<PartForce>();
+
     // NOTE(egg): Inserting vessels and parts has to occur in
     // |WaitForFixedUpdate|, since some may be destroyed (by collisions) during
     // the physics step.  See also #1281.
@@ -1142,16 +1228,18 @@ private enum UnityLayers {
             // effects where doing an EVA accelerates the vessel, see #1415.
             // Just say no to stupidity.
             if (!(vessel.isEVA && vessel.evaController.OnALadder)) {
-              plugin_.IncrementPartIntrinsicForce(
-                  part.flightID,
-                  (XYZ)part_id_to_intrinsic_force_[part.flightID]);
+              intrinsic_forces.Add(new PartForce{
+                  part_id = part.flightID,
+                  force_in_kilonewtons =
+                      (XYZ)part_id_to_intrinsic_force_[part.flightID]});
             }
           }
           if (part_id_to_intrinsic_forces_.ContainsKey(part.flightID)) {
             foreach (
                 var force in part_id_to_intrinsic_forces_[part.flightID]) {
-              plugin_.IncrementPartIntrinsicForce(part.flightID,
-                                                  (XYZ)force.force);
+              intrinsic_forces.Add(new PartForce{
+                  part_id = part.flightID,
+                  force_in_kilonewtons = (XYZ)force.force});
             }
           }
         }
@@ -1181,6 +1269,9 @@ private enum UnityLayers {
       }
     }
 
+    plugin_.IncrementPartsIntrinsicForces(intrinsic_forces.ToArray(),
+                                          intrinsic_forces.Count);
+
     plugin_.PrepareToReportCollisions();
 
     // The collisions are reported and stored into |currentCollisions| in
@@ -1257,21 +1348,28 @@ private enum UnityLayers {
 
     plugin_.FreeVesselsAndPartsAndCollectPileUps(Δt);
 
-    foreach (Vessel vessel in FlightGlobals.Vessels.Where(v => !v.packed)) {
-      if (!plugin_.HasVessel(vessel.id.ToString())) {
-        continue;
-      }
-      foreach (Part part in vessel.parts) {
-        if (part.rb == null) {
+    {
+      var apparent_degrees_of_freedom = new List<PartDegreesOfFreedom>();
+      foreach (Vessel vessel in FlightGlobals.Vessels.Where(v => !v.packed)) {
+        if (!plugin_.HasVessel(vessel.id.ToString())) {
           continue;
         }
-        plugin_.SetPartApparentDegreesOfFreedom(
-            part.flightID,
-            // TODO(egg): use the centre of mass.
-            new QP{q = (XYZ)(Vector3d)part.rb.position,
-                   p = (XYZ)(Vector3d)part.rb.velocity},
-            main_body_degrees_of_freedom);
+        foreach (Part part in vessel.parts) {
+          if (part.rb == null) {
+            continue;
+          }
+          apparent_degrees_of_freedom.Add(new PartDegreesOfFreedom{
+              part_id = part.flightID,
+              // TODO(egg): use the centre of mass.
+              degrees_of_freedom =
+                  new QP{q = (XYZ)(Vector3d)part.rb.position,
+                         p = (XYZ)(Vector3d)part.rb.velocity}});
+        }
       }
+      plugin_.SetPartsApparentDegreesOfFreedom(
+          apparent_degrees_of_freedom.ToArray(),
+          apparent_degrees_of_freedom.Count,
+          main_body_degrees_of_freedom);
     }
 
     // Advance the lagging vessels and kill those which collided with a
@@ -1296,6 +1394,7 @@ private enum UnityLayers {
         plugin_.HasVessel(FlightGlobals.ActiveVessel.id.ToString())) {
       Vector3d q_correction_at_root_part = Vector3d.zero;
       Vector3d v_correction_at_root_part = Vector3d.zero;
+      var loaded_parts = new List<Part>();
       foreach (Vessel vessel in FlightGlobals.Vessels.Where(v => !v.packed)) {
         // TODO(egg): if I understand anything, there should probably be a
         // special treatment for loaded packed vessels.  I don't understand
@@ -1303,13 +1402,12 @@ private enum UnityLayers {
         if (!plugin_.HasVessel(vessel.id.ToString())) {
           continue;
         }
-        foreach (Part part in vessel.parts) {
-          if (part.rb == null) {
-            continue;
-          }
-          QP part_actual_degrees_of_freedom =
-              plugin_.GetPartActualDegreesOfFreedom(
-                  part.flightID,
+        loaded_parts.AddRange(vessel.parts.Where(part => part.rb != null));
+      }
+      var part_actual_degrees_of_freedom = new QP[loaded_parts.Count];
+      plugin_.GetPartsActualDegreesOfFreedom(
+          loaded_parts.Select(part => part.flightID).ToArray(),
+          loaded_parts.Count,
           new Origin{reference_part_is_at_origin  =
                          FloatingOrigin.fetch.continuous,
                      reference_part_is_unmoving =
@@ -1317,21 +1415,23 @@ private enum UnityLayers {
                      main_body_centre_in_world =
                          (XYZ)FlightGlobals.ActiveVessel.mainBody.position,
                      reference_part_id =
-                         FlightGlobals.ActiveVessel.rootPart.flightID});
-          if (part == FlightGlobals.ActiveVessel.rootPart) {
-            q_correction_at_root_part =
-                (Vector3d)part_actual_degrees_of_freedom.q - part.rb.position;
-            v_correction_at_root_part =
-                (Vector3d)part_actual_degrees_of_freedom.p - part.rb.velocity;
-          }
-
-          // TODO(egg): use the centre of mass.  Here it's a bit tedious, some
-          // transform nonsense must probably be done.
-          part.rb.position = (Vector3d)part_actual_degrees_of_freedom.q;
-          part.rb.transform.position =
-              (Vector3d)part_actual_degrees_of_freedom.q;
-          part.rb.velocity = (Vector3d)part_actual_degrees_of_freedom.p;
+                         FlightGlobals.ActiveVessel.rootPart.flightID},
+          part_actual_degrees_of_freedom);
+      for (int i = 0; i < loaded_parts.Count; ++i) {
+        Part part = loaded_parts[i];
+        QP degrees_of_freedom = part_actual_degrees_of_freedom[i];
+        if (part == FlightGlobals.ActiveVessel.rootPart) {
+          q_correction_at_root_part =
+              (Vector3d)degrees_of_freedom.q - part.rb.position;
+          v_correction_at_root_part =
+              (Vector3d)degrees_of_freedom.p - part.rb.velocity;
         }
+
+        // TODO(egg): use the centre of mass.  Here it's a bit tedious, some
+        // transform nonsense must probably be done.
+        part.rb.position = (Vector3d)degrees_of_freedom.q;
+        part.rb.transform.position = (Vector3d)degrees_of_freedom.q;
+        part.rb.velocity = (Vector3d)degrees_of_freedom.p;
       }
       foreach (
           physicalObject physical_object in FlightGlobals.physicalObjects.Where(
@@ -1398,8 +1498,17 @@ private enum UnityLayers {
         }
         foreach (var vessel in FlightGlobals.Vessels) {
           if (vessel.packed && plugin_.HasVessel(vessel.id.ToString())) {
-            vessel_futures_.Add(
-                plugin_.FutureCatchUpVessel(vessel.id.ToString()));
+            if (may_sleep(vessel, universal_time)) {
+              plugin_.PutVesselToSleep(vessel.id.ToString());
+              sleeping_vessels_.Add(vessel.id);
+            } else {
+              sleeping_vessels_.Remove(vessel.id);
+              vessel_catch_up_times_[vessel.id] = universal_time;
+              vessel_futures_.Add(
+                  plugin_.FutureCatchUpVessel(vessel.id.ToString()));
+            }
+          } else {
+            sleeping_vessels_.Remove(vessel.id);
           }
         }
       }
@@ -1449,8 +1558,16 @@ private enum UnityLayers {
       foreach (var vessel in all_collided_vessels) {
         vessel?.Die();
       }
-      ApplyToVesselsOnRails(
-          vessel => UpdateVessel(vessel, Planetarium.GetUniversalTime()));
+      // The sleeping vessels keep their stock orbits, since the plugin has not
+      // computed their current state.
+      var vessels_to_update = new List<Vessel>();
+      ApplyToVesselsOnRails(vessel => {
+        if (!sleeping_vessels_.Contains(vessel.id) &&
+            plugin_.HasVessel(vessel.id.ToString())) {
+          vessels_to_update.Add(vessel);
+        }
+      });
+      UpdateVessels(vessels_to_update, Planetarium.GetUniversalTime());
     }
   }
 
@@ -1573,15 +1690,24 @@ private enum UnityLayers {
             plugin_.CelestialInitialRotationInDegrees(
                 FlightGlobals.currentMainBody.flightGlobalsIndex);
       }
-      ApplyToBodyTree(body => UpdateBody(body, Planetarium.GetUniversalTime()));
+      // The hierarchy must be up to date before the states are obtained.
+      ApplyToBodyTree(body => plugin_.UpdateCelestialHierarchy(
+                                  body.flightGlobalsIndex,
+                                  body.orbit.referenceBody.flightGlobalsIndex));
+      var celestial_states = GetCelestialStates();
+      ApplyToBodyTree(body => UpdateBody(
+                                  body,
+                                  celestial_states[
+                                      body.flightGlobalsIndex].from_parent,
+                                  Planetarium.GetUniversalTime()));
 
       foreach (var body in FlightGlobals.Bodies) {
         // TODO(egg): I have no idea why this |swizzle| thing makes things work.
         // This probably really means something in terms of frames that should
         // be done in the C++ instead---once I figure out what it is.
         var swizzly_body_world_to_world =
-            ((UnityEngine.QuaternionD)plugin_.CelestialRotation(
-                 body.flightGlobalsIndex)).swizzle;
+            ((UnityEngine.QuaternionD)celestial_states[
+                 body.flightGlobalsIndex].rotation).swizzle;
         body.BodyFrame = new Planetarium.CelestialFrame{
             X = swizzly_body_world_to_world * new Vector3d{x = 1, y = 0, z = 0},
             Y = swizzly_body_world_to_world * new Vector3d{x = 0, y = 1, z = 0},
@@ -1748,108 +1874,112 @@ private enum UnityLayers {
         plugin_.HasVessel(main_vessel_guid);
     if (ready_to_draw_active_vessel_trajectory) {
       XYZ sun_world_position = (XYZ)Planetarium.fetch.Sun.position;
-      using (DisposablePlanetarium planetarium =
-                GLLines.NewPlanetarium(plugin_, sun_world_position)) {
-        GLLines.Draw(() => {
+      // The planetarium is kept from frame to frame so that it may reuse its
+      // buffers.
+      if (planetarium_ == null) {
+        planetarium_ = GLLines.NewPlanetarium(plugin_, sun_world_position);
+      } else {
+        GLLines.UpdatePlanetarium(planetarium_, plugin_, sun_world_position);
+      }
+      GLLines.Draw(() => {
+        using (DisposableIterator rp2_lines_iterator =
+                  planetarium_.PlanetariumPlotPsychohistory(
+                      plugin_,
+                      чебышёв_plotting_method_,
+                      main_vessel_guid)) {
+          GLLines.PlotRP2Lines(rp2_lines_iterator,
+                               XKCDColors.Lime,
+                               GLLines.Style.FADED);
+        }
+        RenderPredictionMarkers(main_vessel_guid, sun_world_position);
+        using (DisposableIterator rp2_lines_iterator =
+                  planetarium_.PlanetariumPlotPrediction(
+                      plugin_,
+                      чебышёв_plotting_method_,
+                      main_vessel_guid)) {
+          GLLines.PlotRP2Lines(rp2_lines_iterator,
+                               XKCDColors.Fuchsia,
+                               GLLines.Style.SOLID);
+        }
+        string target_id =
+            FlightGlobals.fetch.VesselTarget?.GetVessel()?.id.ToString();
+        if (FlightGlobals.ActiveVessel != null &&
+            !plotting_frame_selector_.get().target_override &&
+            target_id != null && plugin_.HasVessel(target_id)) {
           using (DisposableIterator rp2_lines_iterator =
-                    planetarium.PlanetariumPlotPsychohistory(
+                    planetarium_.PlanetariumPlotPsychohistory(
                         plugin_,
                         чебышёв_plotting_method_,
-                        main_vessel_guid)) {
+                        target_id)) {
             GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                 XKCDColors.Lime,
+                                 XKCDColors.Goldenrod,
                                  GLLines.Style.FADED);
           }
-          RenderPredictionMarkers(main_vessel_guid, sun_world_position);
+          RenderPredictionMarkers(target_id, sun_world_position);
           using (DisposableIterator rp2_lines_iterator =
-                    planetarium.PlanetariumPlotPrediction(
+                    planetarium_.PlanetariumPlotPrediction(
                         plugin_,
                         чебышёв_plotting_method_,
-                        main_vessel_guid)) {
+                        target_id)) {
             GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                 XKCDColors.Fuchsia,
+                                 XKCDColors.LightMauve,
                                  GLLines.Style.SOLID);
           }
-          string target_id =
-              FlightGlobals.fetch.VesselTarget?.GetVessel()?.id.ToString();
-          if (FlightGlobals.ActiveVessel != null &&
-              !plotting_frame_selector_.get().target_override &&
-              target_id != null && plugin_.HasVessel(target_id)) {
-            using (DisposableIterator rp2_lines_iterator =
-                      planetarium.PlanetariumPlotPsychohistory(
-                          plugin_,
-                          чебышёв_plotting_method_,
-                          target_id)) {
-              GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                   XKCDColors.Goldenrod,
-                                   GLLines.Style.FADED);
-            }
-            RenderPredictionMarkers(target_id, sun_world_position);
-            using (DisposableIterator rp2_lines_iterator =
-                      planetarium.PlanetariumPlotPrediction(
-                          plugin_,
-                          чебышёв_plotting_method_,
-                          target_id)) {
-              GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                   XKCDColors.LightMauve,
-                                   GLLines.Style.SOLID);
-            }
-          }
-          if (plugin_.FlightPlanExists(main_vessel_guid)) {
-            RenderFlightPlanMarkers(main_vessel_guid, sun_world_position);
-
-            int number_of_segments =
-                plugin_.FlightPlanNumberOfSegments(main_vessel_guid);
-            for (int i = 0; i < number_of_segments; ++i) {
-              bool is_burn = i % 2 == 1;
-              using (DisposableIterator rendered_segments =
-                        plugin_.FlightPlanRenderedSegment(main_vessel_guid,
-                                                          sun_world_position,
-                                                          i)) {
-                if (rendered_segments.IteratorAtEnd()) {
-                  Log.Info("Skipping segment " + i);
-                  continue;
-                }
-                Vector3d position_at_start =
-                    (Vector3d)rendered_segments.
-                        IteratorGetDiscreteTrajectoryXYZ();
-                using (DisposableIterator rp2_lines_iterator =
-                          planetarium.PlanetariumPlotFlightPlanSegment(
-                              plugin_,
-                              чебышёв_plotting_method_,
-                              main_vessel_guid,
-                              i)) {
-                  GLLines.PlotRP2Lines(
-                      rp2_lines_iterator,
-                      is_burn ? XKCDColors.Pink : XKCDColors.PeriwinkleBlue,
-                      is_burn ? GLLines.Style.SOLID : GLLines.Style.DASHED);
-                }
-                if (is_burn) {
-                  int manoeuvre_index = i / 2;
-                  NavigationManoeuvreFrenetTrihedron manoeuvre =
-                      plugin_.FlightPlanGetManoeuvreFrenetTrihedron(
-                          main_vessel_guid,
-                          manoeuvre_index);
-                  double scale = (ScaledSpace.ScaledToLocalSpace(
-                                      MapView.MapCamera.transform.position) -
-                                  position_at_start).magnitude * 0.015;
-                  Action<XYZ, UnityEngine.Color> add_vector =
-                      (world_direction, colour) => {
-                        UnityEngine.GL.Color(colour);
-                        GLLines.AddSegment(
-                            position_at_start,
-                            position_at_start +
-                                scale * (Vector3d)world_direction);
-                      };
-                  add_vector(manoeuvre.tangent, XKCDColors.NeonYellow);
-                  add_vector(manoeuvre.normal, XKCDColors.AquaBlue);
-                  add_vector(manoeuvre.binormal, XKCDColors.PurplePink);
-                }
+        }
+        if (plugin_.FlightPlanExists(main_vessel_guid)) {
+          RenderFlightPlanMarkers(main_vessel_guid, sun_world_position);
+
+          int number_of_segments =
+              plugin_.FlightPlanNumberOfSegments(main_vessel_guid);
+          for (int i = 0; i < number_of_segments; ++i) {
+            bool is_burn = i % 2 == 1;
+            using (DisposableIterator rendered_segments =
+                      plugin_.FlightPlanRenderedSegment(main_vessel_guid,
+                                                        sun_world_position,
+                                                        i)) {
+              if (rendered_segments.IteratorAtEnd()) {
+                Log.Info("Skipping segment " + i);
+                continue;
+              }
+              Vector3d position_at_start =
+                  (Vector3d)rendered_segments.
+                      IteratorGetDiscreteTrajectoryXYZ();
+              using (DisposableIterator rp2_lines_iterator =
+                        planetarium_.PlanetariumPlotFlightPlanSegment(
+                            plugin_,
+                            чебышёв_plotting_method_,
+                            main_vessel_guid,
+                            i)) {
+                GLLines.PlotRP2Lines(
+                    rp2_lines_iterator,
+                    is_burn ? XKCDColors.Pink : XKCDColors.PeriwinkleBlue,
+                    is_burn ? GLLines.Style.SOLID : GLLines.Style.DASHED);
+              }
+              if (is_burn) {
+                int manoeuvre_index = i / 2;
+                NavigationManoeuvreFrenetTrihedron manoeuvre =
+                    plugin_.FlightPlanGetManoeuvreFrenetTrihedron(
+                        main_vessel_guid,
+                        manoeuvre_index);
+                double scale = (ScaledSpace.ScaledToLocalSpace(
+                                    MapView.MapCamera.transform.position) -
+                                position_at_start).magnitude * 0.015;
+                Action<XYZ, UnityEngine.Color> add_vector =
+                    (world_direction, colour) => {
+                      UnityEngine.GL.Color(colour);
+                      GLLines.AddSegment(
+                          position_at_start,
+                          position_at_start +
+                              scale * (Vector3d)world_direction);
+                    };
+                add_vector(manoeuvre.tangent, XKCDColors.NeonYellow);
+                add_vector(manoeuvre.normal, XKCDColors.AquaBlue);
+                add_vector(manoeuvre.binormal, XKCDColors.PurplePink);
               }
             }
           }
-        });
-      }
+        }
+      });
       map_node_pool_.Update();
     } else {
       map_node_pool_.Clear();
@@ -2028,7 +2158,11 @@ private enum UnityLayers {
     UnityEngine.Object.Destroy(map_renderer_);
     map_node_pool_.Clear();
     map_renderer_ = null;
+    planetarium_?.Dispose();
+    planetarium_ = null;
     Interface.DeletePlugin(ref plugin_);
+    vessel_catch_up_times_.Clear();
+    sleeping_vessels_.Clear();
     plotting_frame_selector_.reset();
     previous_display_mode_ = null;
     flight_planner_.reset();
@@ -2364,6 +2498,13 @@ private enum UnityLayers {
       journaling_ = false;
       Interface.ActivateRecorder(false);
     }
+    bool must_trace = UnityEngine.GUILayout.Toggle(
+        value   : tracing_,
+        text    : "Trace interface calls (written when stopped)");
+    if (must_trace != tracing_) {
+      tracing_ = must_trace;
+      Interface.ActivateTracer(tracing_);
+    }
   }
 
   private void ShrinkMainWindow() {
@@ -2431,6 +2572,7 @@ private enum UnityLayers {
   try {
     Cleanup();
     RemoveBuggyTidalLocking();
+    ConfigureThreads();
     plugin_construction_ = DateTime.Now;
     Dictionary<String, ConfigNode> name_to_gravity_model = null;
     ConfigNode gravity_model = GameDatabase.Instance.GetAtMostOneNode(
@@ -2578,6 +2720,8 @@ private enum UnityLayers {
                                    "Plotting frame"));
     must_set_plotting_frame_ = true;
     flight_planner_.reset(new FlightPlanner(this, plugin_));
+    plugin_.SetPredictionFrameBudget(prediction_frame_budget_);
+    plugin_.SetPersistFlightPlanSegments(persist_flight_plan_segments_);
   } catch (Exception e) {
     Log.Fatal("Exception while resetting plugin: " + e.ToString());
   }
@@ -2586,6 +2730,39 @@ private enum UnityLayers {
   private void RemoveBuggyTidalLocking() {
     ApplyToBodyTree(body => body.tidallyLocked = false);
   }
+
+  // Must be called before the plugin is constructed, since its threads are
+  // configured when they start.  The configuration node is optional, e.g.:
+  //   principia_thread_configuration {
+  //     max_pool_size = 4
+  //     low_priority = true
+  //     reserved_cores = 0 1
+  //   }
+  private static void ConfigureThreads() {
+    ConfigNode thread_configuration = GameDatabase.Instance.GetAtMostOneNode(
+        principia_thread_configuration_config_name_);
+    if (thread_configuration == null) {
+      return;
+    }
+    String max_pool_size =
+        thread_configuration.GetAtMostOneValue("max_pool_size");
+    String low_priority =
+        thread_configuration.GetAtMostOneValue("low_priority");
+    String reserved_cores =
+        thread_configuration.GetAtMostOneValue("reserved_cores");
+    long reserved_cores_mask = 0;
+    if (reserved_cores != null) {
+      foreach (String core in reserved_cores.Split(
+                   new char[]{' ', ','},
+                   StringSplitOptions.RemoveEmptyEntries)) {
+        reserved_cores_mask |= 1L << int.Parse(core);
+      }
+    }
+    Interface.SetThreadConfiguration(
+        max_pool_size == null ? 0 : int.Parse(max_pool_size),
+        low_priority != null && bool.Parse(low_priority),
+        reserved_cores_mask);
+  }
 }
 
 }  // namespace ksp_plugin_adapter
@@ -1,35 +1,108 @@
 
 #include "ksp_plugin/plugin.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "base/macros.hpp"
+
+#if OS_WIN
+#define NOGDI
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "base/array.hpp"
+#include "base/hexadecimal.hpp"
+#include "base/pull_serializer.hpp"
 #include "base/push_deserializer.hpp"
 #include "base/serialization.hpp"
+#include "base/thread_configuration.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "benchmark/benchmark.h"
 #include "geometry/named_quantities.hpp"
+#include "gipfeli/gipfeli.h"
 #include "gtest/gtest.h"
+#include "journal/recorder.hpp"
 #include "ksp_plugin/interface.hpp"
+#include "physics/solar_system.hpp"
 #include "quantities/quantities.hpp"
 #include "serialization/ksp_plugin.pb.h"
 #include "testing_utilities/serialization.hpp"
 
 namespace principia {
 
+using base::Array;
+using base::GetThreadConfiguration;
+using base::HexadecimalDecode;
+using base::HexadecimalEncode;
+using base::make_not_null_unique;
+using base::not_null;
 using base::ParseFromBytes;
 using base::PullSerializer;
 using base::PushDeserializer;
+using base::SetThreadConfiguration;
+using base::ThreadConfiguration;
+using base::UniqueArray;
+using base::WorkStealingScheduler;
+using geometry::Bivector;
+using geometry::Displacement;
 using geometry::Instant;
+using geometry::Perspective;
+using geometry::Position;
+using geometry::RigidTransformation;
+using geometry::Rotation;
+using geometry::Vector;
+using geometry::Velocity;
+using interface::FromQP;
 using interface::principia__AdvanceTime;
+using interface::principia__CurrentTime;
 using interface::principia__DeletePlugin;
 using interface::principia__DeserializePluginHexadecimal;
 using interface::principia__FutureCatchUpVessel;
 using interface::principia__FutureWaitForVesselToCatchUp;
 using interface::principia__IteratorDelete;
 using interface::principia__SerializePluginHexadecimal;
+using interface::principia__VesselGetHandle;
+using interface::principia__VesselVelocity;
+using interface::principia__VesselVelocityWithHandle;
+using interface::QP;
+using interface::ToQP;
+using interface::ToXYZ;
+using interface::XYZ;
+using journal::Recorder;
+using physics::DegreesOfFreedom;
+using physics::RelativeDegreesOfFreedom;
+using physics::SolarSystem;
+using quantities::Angle;
+using quantities::Cos;
 using quantities::Frequency;
+using quantities::GravitationalParameter;
+using quantities::Length;
+using quantities::Sin;
+using quantities::Speed;
+using quantities::Sqrt;
 using quantities::Time;
+using quantities::si::ArcMinute;
+using quantities::si::Degree;
 using quantities::si::Hertz;
+using quantities::si::Hour;
+using quantities::si::Kilo;
+using quantities::si::Kilogram;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Newton;
+using quantities::si::Radian;
 using quantities::si::Second;
 using testing_utilities::ReadFromBinaryFile;
 using testing_utilities::ReadLinesFromHexadecimalFile;
@@ -141,9 +214,670 @@ void BM_PluginDeserializationBenchmark(benchmark::State& state) {
   state.SetBytesProcessed(bytes_processed);
 }
 
+namespace {
+
+// The peak resident memory of the process since it started, in bytes.
+std::int64_t PeakMemoryUsage() {
+#if OS_WIN
+  PROCESS_MEMORY_COUNTERS counters;
+  CHECK(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)));
+  return counters.PeakWorkingSetSize;
+#else
+  rusage usage;
+  CHECK_EQ(0, getrusage(RUSAGE_SELF, &usage));
+  // Kibibytes on Linux.
+  return static_cast<std::int64_t>(usage.ru_maxrss) << 10;
+#endif
+}
+
+// The wall-clock time and the number of bytes processed by one stage of the
+// serialization or of the deserialization, accumulated over the iterations.
+struct Stage {
+  std::chrono::steady_clock::duration time{};
+  std::int64_t bytes = 0;
+};
+
+void ReportStage(std::string const& name,
+                 Stage const& stage,
+                 benchmark::State& state) {
+  double const seconds = std::chrono::duration<double>(stage.time).count();
+  state.counters[name + "_MiB/s"] =
+      seconds == 0 ? 0 : stage.bytes / seconds / (1 << 20);
+}
+
+}  // namespace
+
+namespace {
+
+// Records a journal in a temporary file for the duration of a benchmark if
+// |mode| is nonzero: in binary form for 1, in hexadecimal form for 2.
+class ScopedJournal {
+ public:
+  explicit ScopedJournal(std::int64_t const mode)
+      : path_(std::filesystem::temp_directory_path() /
+              "interface_benchmark.journal") {
+    if (mode != 0) {
+      Recorder::Activate(
+          new Recorder(path_,
+                       mode == 1 ? Recorder::Format::BINARY
+                                 : Recorder::Format::HEXADECIMAL));
+    }
+  }
+
+  ~ScopedJournal() {
+    if (Recorder::IsActivated()) {
+      Recorder::Deactivate();
+      std::filesystem::remove(path_);
+      std::filesystem::remove(journal::JournalIndexPath(path_));
+    }
+  }
+
+ private:
+  std::filesystem::path const path_;
+};
+
+std::string JournalLabel(std::int64_t const mode) {
+  switch (mode) {
+    case 0: return "no journal";
+    case 1: return "binary journal";
+    default: return "hexadecimal journal";
+  }
+}
+
+not_null<std::unique_ptr<Plugin>> ReadThreeVesselsPlugin() {
+  return Plugin::ReadFromMessage(
+      ParseFromBytes<serialization::Plugin>(ReadFromBinaryFile(
+          SOLUTION_DIR / "ksp_plugin_test" / "3 vessels.proto.bin")));
+}
+
+constexpr char three_vessels_guid[] = "70ff8dc0-a4dd-4b8c-868b-35ddb01e32bc";
+
+}  // namespace
+
+// The fixed cost of an interface call: |principia__CurrentTime| does almost
+// nothing besides the journalling and the conversion of its result.
+void BM_InterfaceCurrentTime(benchmark::State& state) {
+  auto const plugin = ReadThreeVesselsPlugin();
+  ScopedJournal const journal(state.range_x());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(principia__CurrentTime(plugin.get()));
+  }
+  state.SetLabel(JournalLabel(state.range_x()));
+}
+
+// A call that identifies a vessel by its GUID and returns an |XYZ|.
+void BM_InterfaceVesselVelocity(benchmark::State& state) {
+  auto const plugin = ReadThreeVesselsPlugin();
+  ScopedJournal const journal(state.range_x());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        principia__VesselVelocity(plugin.get(), three_vessels_guid));
+  }
+  state.SetLabel(JournalLabel(state.range_x()));
+}
+
+// Same as above, but the vessel is identified by its handle.
+void BM_InterfaceVesselVelocityWithHandle(benchmark::State& state) {
+  auto const plugin = ReadThreeVesselsPlugin();
+  int const handle =
+      principia__VesselGetHandle(plugin.get(), three_vessels_guid);
+  ScopedJournal const journal(state.range_x());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        principia__VesselVelocityWithHandle(plugin.get(), handle));
+  }
+  state.SetLabel(JournalLabel(state.range_x()));
+}
+
+// The interchange conversions, without any call.
+void BM_InterfaceQPRoundTrip(benchmark::State& state) {
+  QP qp{{1, 2, 3}, {4, 5, 6}};
+  for (auto _ : state) {
+    qp = ToQP(FromQP<DegreesOfFreedom<World>>(qp));
+    benchmark::DoNotOptimize(qp);
+  }
+}
+
+void BM_InterfaceToXYZ(benchmark::State& state) {
+  Position<World> const position =
+      World::origin +
+      Displacement<World>({1 * Metre, 2 * Metre, 3 * Metre});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ToXYZ(position));
+  }
+}
+
+// Serializes and deserializes the large plugin through the same steps as
+// |principia__SerializePluginHexadecimal| and
+// |principia__DeserializePluginHexadecimal|, but with chunks of |range_x| KiB
+// and queues of |range_y| chunks, and reports the throughput of each step.
+// The throughputs are measured on the uncompressed bytes for the steps that
+// see them, and on the compressed bytes otherwise.  Note that the serializer
+// and the deserializer work on threads that overlap with the client, so the
+// timings of the compression and of the parsing include the time spent
+// waiting for the client.
+void BM_PluginSerializationRoundTrip(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+  int const chunk_size = state.range_x() << 10;
+  int const number_of_chunks = state.range_y();
+  char const compressor[] = "gipfeli";
+
+  int bytes_processed = 0;
+  auto const plugin = DeserializePluginFromLines(
+      ReadLinesFromHexadecimalFile(
+          SOLUTION_DIR / "ksp_plugin_test" / "large_plugin.proto.gipfeli.hex"),
+      compressor,
+      bytes_processed);
+
+  Stage build_proto;
+  Stage serialize_and_compress;
+  Stage hexadecimal_encode;
+  Stage hexadecimal_decode;
+  Stage decompress_and_parse;
+  Stage read_plugin;
+  std::int64_t compressed_size = 0;
+  std::int64_t uncompressed_size = 0;
+  for (auto _ : state) {
+    // Serialization.
+    std::vector<UniqueArray<char>> hexadecimal;
+    {
+      serialization::Plugin message;
+      auto start = Clock::now();
+      plugin->WriteToMessage(&message);
+      build_proto.time += Clock::now() - start;
+      uncompressed_size = message.ByteSizeLong();
+      build_proto.bytes += uncompressed_size;
+
+      PullSerializer serializer(chunk_size,
+                                number_of_chunks,
+                                google::compression::NewGipfeliCompressor());
+      serializer.Start(&message);
+      compressed_size = 0;
+      for (;;) {
+        start = Clock::now();
+        Array<std::uint8_t> const bytes = serializer.Pull();
+        serialize_and_compress.time += Clock::now() - start;
+        if (bytes.size == 0) {
+          break;
+        }
+        compressed_size += bytes.size;
+        start = Clock::now();
+        hexadecimal.push_back(
+            HexadecimalEncode(bytes, /*null_terminated=*/false));
+        hexadecimal_encode.time += Clock::now() - start;
+      }
+      serialize_and_compress.bytes += uncompressed_size;
+      hexadecimal_encode.bytes += compressed_size;
+    }
+
+    // Deserialization.
+    {
+      std::unique_ptr<Plugin const> deserialized_plugin;
+      Clock::time_point parsed;
+      Clock::time_point read;
+      auto start = Clock::now();
+      {
+        PushDeserializer deserializer(
+            chunk_size,
+            number_of_chunks,
+            google::compression::NewGipfeliCompressor());
+        serialization::Plugin message;
+        deserializer.Start(
+            &message,
+            [&deserialized_plugin, &parsed, &read](
+                google::protobuf::Message const& parsed_message) {
+              parsed = Clock::now();
+              deserialized_plugin.reset(
+                  Plugin::ReadFromMessage(
+                      static_cast<serialization::Plugin const&>(
+                          parsed_message)).release());
+              read = Clock::now();
+            });
+        for (auto const& chunk : hexadecimal) {
+          auto const decode_start = Clock::now();
+          auto bytes = HexadecimalDecode(chunk.get());
+          auto const decode_end = Clock::now();
+          hexadecimal_decode.time += decode_end - decode_start;
+          // The decoding is not part of the deserialization proper.
+          start += decode_end - decode_start;
+          deserializer.Push(std::move(bytes));
+        }
+        deserializer.Push(UniqueArray<std::uint8_t>());
+      }
+      decompress_and_parse.time += parsed - start;
+      read_plugin.time += read - parsed;
+      hexadecimal_decode.bytes += compressed_size;
+      decompress_and_parse.bytes += uncompressed_size;
+      read_plugin.bytes += uncompressed_size;
+      benchmark::DoNotOptimize(deserialized_plugin);
+    }
+  }
+
+  ReportStage("build_proto", build_proto, state);
+  ReportStage("serialize_and_compress", serialize_and_compress, state);
+  ReportStage("hexadecimal_encode", hexadecimal_encode, state);
+  ReportStage("hexadecimal_decode", hexadecimal_decode, state);
+  ReportStage("decompress_and_parse", decompress_and_parse, state);
+  ReportStage("read_plugin", read_plugin, state);
+  state.counters["compressed_MiB"] =
+      static_cast<double>(compressed_size) / (1 << 20);
+  state.counters["uncompressed_MiB"] =
+      static_cast<double>(uncompressed_size) / (1 << 20);
+  state.counters["peak_memory_MiB"] =
+      static_cast<double>(PeakMemoryUsage()) / (1 << 20);
+}
+
+namespace {
+
+// The steps performed by the adapter in a simulated frame, in order.
+enum class FrameStep {
+  KeepVessels,
+  AdvanceTime,
+  CatchUpLaggingVessels,
+  UpdatePredictions,
+  Plot,
+  Serialize,
+};
+
+// A plugin for the stock Kerbol system, with a fleet of vessels on distinct
+// circular orbits around Kerbin.  Each vessel has a flight plan and a
+// prediction.  The first |thrusting_vessels| vessels are loaded after the first
+// frame and thrust prograde; the others are unloaded and coast.
+class SyntheticFleet {
+ public:
+  SyntheticFleet(int vessels, int parts_per_vessel, int thrusting_vessels);
+
+  // Runs all the steps of one frame, in order.  |Serialize| is only run if it
+  // is the |timed_step|.  If |timed_step| is not null, the timing of |state|
+  // is paused during the other steps.
+  void RunFrame(benchmark::State& state,
+                std::optional<FrameStep> const& timed_step);
+
+  // Runs a single step of a frame.
+  void RunStep(FrameStep step);
+
+  Plugin const& plugin() const;
+
+ private:
+  // Inserts the celestial |name| in |plugin_|, after its ancestors if they are
+  // not yet in |inserted|.
+  void InsertCelestial(std::string const& name,
+                       std::set<std::string>& inserted);
+
+  void KeepVessels();
+
+  static constexpr int warp_factor = 1000;
+  static constexpr Frequency refresh_frequency = 50 * Hertz;
+  static constexpr Time step = warp_factor / refresh_frequency;
+  static constexpr Time Δt = 1 / refresh_frequency;
+
+  SolarSystem<Barycentric> const solar_system_;
+  not_null<std::unique_ptr<Plugin>> const plugin_;
+  Index const kerbin_;
+  int const parts_per_vessel_;
+  int const thrusting_vessels_;
+  std::vector<GUID> vessel_guids_;
+};
+
+SyntheticFleet::SyntheticFleet(int const vessels,
+                               int const parts_per_vessel,
+                               int const thrusting_vessels)
+    : solar_system_(
+          SOLUTION_DIR / "astronomy" / "kerbol_gravity_model.proto.txt",
+          SOLUTION_DIR / "astronomy" / "kerbol_initial_state_0_0.proto.txt",
+          /*ignore_frame=*/true),
+      plugin_(make_not_null_unique<Plugin>(
+          /*game_epoch=*/solar_system_.epoch_literal(),
+          /*solar_system_epoch=*/solar_system_.epoch_literal(),
+          /*planetarium_rotation=*/0 * Radian)),
+      kerbin_(solar_system_.index("Kerbin")),
+      parts_per_vessel_(parts_per_vessel),
+      thrusting_vessels_(thrusting_vessels) {
+  CHECK_LE(thrusting_vessels, vessels);
+  std::set<std::string> inserted;
+  for (std::string const& name : solar_system_.names()) {
+    InsertCelestial(name, inserted);
+  }
+  plugin_->EndInitialization();
+
+  GravitationalParameter const μ =
+      solar_system_.gravitational_parameter("Kerbin");
+  for (int k = 0; k < vessels; ++k) {
+    GUID const vessel_guid = "fleet-" + std::to_string(k);
+    vessel_guids_.push_back(vessel_guid);
+    bool inserted_vessel;
+    plugin_->InsertOrKeepVessel(vessel_guid,
+                                vessel_guid,
+                                kerbin_,
+                                /*loaded=*/false,
+                                inserted_vessel);
+    // The orbits differ in radius, phase and inclination so that the vessels
+    // don't all end up in the same places in the trajectories.
+    Length const r = 700 * Kilo(Metre) + k * 5 * Kilo(Metre);
+    Speed const v = Sqrt(μ / r);
+    Angle const θ = k * Radian;
+    Angle const i = k * 0.1 * Radian;
+    Vector<double, AliceSun> const radial(
+        {Cos(θ), Sin(θ) * Cos(i), Sin(θ) * Sin(i)});
+    Vector<double, AliceSun> const tangential(
+        {-Sin(θ), Cos(θ) * Cos(i), Cos(θ) * Sin(i)});
+    for (int j = 0; j < parts_per_vessel; ++j) {
+      plugin_->InsertUnloadedPart(
+          k * parts_per_vessel + j,
+          "part-" + std::to_string(j),
+          vessel_guid,
+          RelativeDegreesOfFreedom<AliceSun>(
+              (r + j * Metre) * radial,
+              v * tangential));
+    }
+  }
+  plugin_->PrepareToReportCollisions();
+  plugin_->FreeVesselsAndPartsAndCollectPileUps(Δt);
+  RunStep(FrameStep::AdvanceTime);
+  for (GUID const& vessel_guid : vessel_guids_) {
+    plugin_->CreateFlightPlan(vessel_guid,
+                              plugin_->CurrentTime() + 3 * Hour,
+                              parts_per_vessel * Kilogram);
+  }
+  plugin_->renderer().SetPlottingFrame(
+      plugin_->NewBodyCentredNonRotatingNavigationFrame(kerbin_));
+}
+
+void SyntheticFleet::RunFrame(benchmark::State& state,
+                              std::optional<FrameStep> const& timed_step) {
+  for (FrameStep const frame_step : {FrameStep::KeepVessels,
+                                     FrameStep::AdvanceTime,
+                                     FrameStep::CatchUpLaggingVessels,
+                                     FrameStep::UpdatePredictions,
+                                     FrameStep::Plot,
+                                     FrameStep::Serialize}) {
+    if (frame_step == FrameStep::Serialize && timed_step != frame_step) {
+      continue;
+    }
+    if (!timed_step.has_value() || timed_step == frame_step) {
+      RunStep(frame_step);
+    } else {
+      state.PauseTiming();
+      RunStep(frame_step);
+      state.ResumeTiming();
+    }
+  }
+}
+
+Plugin const& SyntheticFleet::plugin() const {
+  return *plugin_;
+}
+
+void SyntheticFleet::InsertCelestial(std::string const& name,
+                                     std::set<std::string>& inserted) {
+  if (inserted.count(name) > 0) {
+    return;
+  }
+  auto const& initial_state =
+      solar_system_.keplerian_initial_state_message(name);
+  std::optional<Index> parent_index;
+  if (initial_state.has_parent()) {
+    InsertCelestial(initial_state.parent(), inserted);
+    parent_index = solar_system_.index(initial_state.parent());
+  }
+  plugin_->InsertCelestialJacobiKeplerian(
+      solar_system_.index(name),
+      parent_index,
+      solar_system_.gravity_model_message(name),
+      initial_state);
+  inserted.insert(name);
+}
+
+void SyntheticFleet::RunStep(FrameStep const frame_step) {
+  switch (frame_step) {
+    case FrameStep::KeepVessels: {
+      for (int k = 0; k < vessel_guids_.size(); ++k) {
+        GUID const& vessel_guid = vessel_guids_[k];
+        bool const thrusting = k < thrusting_vessels_;
+        Velocity<World> const velocity = plugin_->VesselVelocity(vessel_guid);
+        bool inserted;
+        plugin_->InsertOrKeepVessel(vessel_guid,
+                                    vessel_guid,
+                                    kerbin_,
+                                    /*loaded=*/thrusting,
+                                    inserted);
+        if (!thrusting) {
+          continue;
+        }
+        for (int j = 0; j < parts_per_vessel_; ++j) {
+          PartId const part_id = k * parts_per_vessel_ + j;
+          // The parts already exist, so their degrees of freedom are ignored.
+          plugin_->InsertOrKeepLoadedPart(
+              part_id,
+              "part-" + std::to_string(j),
+              1 * Kilogram,
+              vessel_guid,
+              kerbin_,
+              DegreesOfFreedom<World>(World::origin, Velocity<World>()),
+              DegreesOfFreedom<World>(World::origin, Velocity<World>()),
+              Δt);
+          plugin_->IncrementPartIntrinsicForce(
+              part_id, 1 * Newton * velocity / velocity.Norm());
+        }
+      }
+      plugin_->PrepareToReportCollisions();
+      plugin_->FreeVesselsAndPartsAndCollectPileUps(Δt);
+      break;
+    }
+    case FrameStep::AdvanceTime: {
+      plugin_->AdvanceTime(plugin_->CurrentTime() + step,
+                           /*planetarium_rotation=*/0 * Radian);
+      break;
+    }
+    case FrameStep::CatchUpLaggingVessels: {
+      VesselSet collided_vessels;
+      plugin_->CatchUpLaggingVessels(collided_vessels);
+      break;
+    }
+    case FrameStep::UpdatePredictions: {
+      for (GUID const& vessel_guid : vessel_guids_) {
+        plugin_->UpdatePrediction(vessel_guid);
+      }
+      break;
+    }
+    case FrameStep::Plot: {
+      // A camera 40 000 km above the pole of Kerbin, looking down.
+      Perspective<Navigation, Camera> const perspective(
+          RigidTransformation<Navigation, Camera>(
+              Navigation::origin +
+                  Displacement<Navigation>(
+                      {0 * Metre, 0 * Metre, 40'000 * Kilo(Metre)}),
+              Camera::origin,
+              Rotation<Navigation, Camera>(
+                  Vector<double, Navigation>({1, 0, 0}),
+                  Vector<double, Navigation>({0, -1, 0}),
+                  Bivector<double, Navigation>({0, 0, -1})).Forget()),
+          /*focal=*/1 * Metre);
+      auto const planetarium = plugin_->NewPlanetarium(
+          Planetarium::Parameters(/*sphere_radius_multiplier=*/1,
+                                  /*angular_resolution=*/0.4 * ArcMinute,
+                                  /*field_of_view=*/90 * Degree),
+          perspective);
+      for (GUID const& vessel_guid : vessel_guids_) {
+        Vessel const& vessel = *plugin_->GetVessel(vessel_guid);
+        auto const& psychohistory = vessel.psychohistory();
+        auto const& prediction = vessel.prediction();
+        benchmark::DoNotOptimize(
+            planetarium->PlotMethod2(psychohistory.Begin(),
+                                     psychohistory.End(),
+                                     vessel.psychohistory_stable_time(),
+                                     vessel.history_version(),
+                                     plugin_->CurrentTime(),
+                                     /*reverse=*/true,
+                                     vessel.psychohistory_plotting_cache()));
+        benchmark::DoNotOptimize(
+            planetarium->PlotMethod2(prediction.Begin(),
+                                     prediction.End(),
+                                     plugin_->CurrentTime(),
+                                     /*reverse=*/false));
+      }
+      break;
+    }
+    case FrameStep::Serialize: {
+      serialization::Plugin message;
+      plugin_->WriteToMessage(&message);
+      benchmark::DoNotOptimize(message);
+      break;
+    }
+  }
+}
+
+// The number of vessels and the number of parts per vessel.
+void FleetSizes(benchmark::internal::Benchmark* const benchmark) {
+  for (int const vessels : {1, 10, 100}) {
+    for (int const parts_per_vessel : {1, 10, 100}) {
+      benchmark->Args({vessels, parts_per_vessel});
+    }
+  }
+}
+
+void RunFleetBenchmark(benchmark::State& state,
+                       std::optional<FrameStep> const& timed_step) {
+  SyntheticFleet fleet(/*vessels=*/state.range_x(),
+                       /*parts_per_vessel=*/state.range_y(),
+                       /*thrusting_vessels=*/0);
+  for (auto _ : state) {
+    fleet.RunFrame(state, timed_step);
+  }
+}
+
+// The number of vessels, half of which thrust, and the maximum number of
+// threads of the scheduler of the plugin.
+void ScalingSizes(benchmark::internal::Benchmark* const benchmark) {
+  for (int const vessels : {10, 100}) {
+    for (int const threads : {1, 2, 4, 8, 16, 32, 64}) {
+      benchmark->Args({vessels, threads});
+    }
+  }
+}
+
+}  // namespace
+
+void BM_PluginFleetFrame(benchmark::State& state) {
+  RunFleetBenchmark(state, /*timed_step=*/std::nullopt);
+}
+
+void BM_PluginFleetAdvanceTime(benchmark::State& state) {
+  RunFleetBenchmark(state, FrameStep::AdvanceTime);
+}
+
+void BM_PluginFleetCatchUpLaggingVessels(benchmark::State& state) {
+  RunFleetBenchmark(state, FrameStep::CatchUpLaggingVessels);
+}
+
+void BM_PluginFleetPlot(benchmark::State& state) {
+  RunFleetBenchmark(state, FrameStep::Plot);
+}
+
+void BM_PluginFleetSerialize(benchmark::State& state) {
+  RunFleetBenchmark(state, FrameStep::Serialize);
+}
+
+// Times |CatchUpLaggingVessels| for a fleet with a mix of thrusting and
+// coasting pile-ups, with a scheduler of varying size.  This is the benchmark
+// to use to evaluate changes to the scheduler.  Besides the time, it reports:
+// - the speedup with respect to the single-threaded run for the same fleet,
+//   if that run has already happened;
+// - the mean time that a task spends in a deque before it starts executing;
+// - the number of times a thread blocked on a lock of the scheduler, per
+//   iteration;
+// - the fraction of the threads that was busy executing tasks.
+// The number of threads is capped by |ConfiguredPoolSize|, so the requested
+// maximum may not be reached on small machines; the actual number is reported.
+void BM_PluginCatchUpLaggingVesselsScaling(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+  // The time per iteration of the single-threaded run, indexed by the number
+  // of vessels.
+  static std::map<std::int64_t, double> single_threaded_seconds;
+
+  int const vessels = state.range_x();
+  ThreadConfiguration const previous_configuration = GetThreadConfiguration();
+  ThreadConfiguration configuration = previous_configuration;
+  configuration.max_pool_size = state.range_y();
+  SetThreadConfiguration(configuration);
+  SyntheticFleet fleet(vessels,
+                       /*parts_per_vessel=*/10,
+                       /*thrusting_vessels=*/vessels / 2);
+  SetThreadConfiguration(previous_configuration);
+  WorkStealingScheduler const& scheduler = fleet.plugin().scheduler();
+
+  Clock::duration elapsed{};
+  WorkStealingScheduler::Statistics statistics;
+  std::int64_t executed_tasks = 0;
+  std::int64_t contended_locks = 0;
+  Clock::duration queue_wait{};
+  Clock::duration busy{};
+  for (auto _ : state) {
+    state.PauseTiming();
+    fleet.RunStep(FrameStep::KeepVessels);
+    fleet.RunStep(FrameStep::AdvanceTime);
+    statistics = scheduler.statistics();
+    state.ResumeTiming();
+    Clock::time_point const start = Clock::now();
+    fleet.RunStep(FrameStep::CatchUpLaggingVessels);
+    elapsed += Clock::now() - start;
+    state.PauseTiming();
+    // The tasks are all complete, but the statistics of the last ones may not
+    // have been recorded yet.  This is negligible over many iterations.
+    WorkStealingScheduler::Statistics const after = scheduler.statistics();
+    executed_tasks += after.executed_tasks - statistics.executed_tasks;
+    contended_locks += after.contended_locks - statistics.contended_locks;
+    queue_wait += after.queue_wait - statistics.queue_wait;
+    busy += after.busy - statistics.busy;
+    state.ResumeTiming();
+  }
+
+  double const seconds_per_iteration =
+      std::chrono::duration<double>(elapsed).count() / state.iterations();
+  if (scheduler.pool_size() == 1) {
+    single_threaded_seconds[vessels] = seconds_per_iteration;
+  }
+  auto const it = single_threaded_seconds.find(vessels);
+  if (it != single_threaded_seconds.end()) {
+    state.counters["speedup"] = it->second / seconds_per_iteration;
+  }
+  state.counters["threads"] = scheduler.pool_size();
+  state.counters["queue_wait_us"] =
+      executed_tasks == 0
+          ? 0
+          : std::chrono::duration<double, std::micro>(queue_wait).count() /
+                executed_tasks;
+  state.counters["contended_locks"] =
+      static_cast<double>(contended_locks) / state.iterations();
+  state.counters["utilization"] =
+      std::chrono::duration<double>(busy).count() /
+      (std::chrono::duration<double>(elapsed).count() * scheduler.pool_size());
+}
+
 BENCHMARK(BM_PluginSerializationBenchmark);
 BENCHMARK(BM_PluginDeserializationBenchmark);
+// The first pair is the one used by the interface.
+BENCHMARK(BM_PluginSerializationRoundTrip)
+    ->Args({64, 8})
+    ->Args({16, 8})
+    ->Args({256, 8})
+    ->Args({64, 2})
+    ->Args({64, 32})
+    ->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_PluginIntegrationBenchmark);
+BENCHMARK(BM_InterfaceCurrentTime)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_InterfaceVesselVelocity)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_InterfaceVesselVelocityWithHandle)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_InterfaceQPRoundTrip);
+BENCHMARK(BM_InterfaceToXYZ);
+BENCHMARK(BM_PluginFleetFrame)->Apply(FleetSizes);
+BENCHMARK(BM_PluginFleetAdvanceTime)->Apply(FleetSizes);
+BENCHMARK(BM_PluginFleetCatchUpLaggingVessels)->Apply(FleetSizes);
+BENCHMARK(BM_PluginFleetPlot)->Apply(FleetSizes);
+BENCHMARK(BM_PluginFleetSerialize)->Apply(FleetSizes);
+BENCHMARK(BM_PluginCatchUpLaggingVesselsScaling)
+    ->Apply(ScalingSizes)
+    ->Unit(benchmark::kMillisecond);
 
 // .\Release\x64\ksp_plugin_test_tests.exe --gtest_filter=PluginBenchmark.DISABLED_All --gtest_also_run_disabled_tests  // NOLINT
 TEST(PluginBenchmark, DISABLED_All) {
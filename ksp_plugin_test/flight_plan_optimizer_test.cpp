@@ -0,0 +1,182 @@
+﻿
+#include "ksp_plugin/flight_plan_optimizer.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/status.hpp"
+#include "base/work_stealing_scheduler.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/apsides.hpp"
+#include "physics/body_centred_non_rotating_dynamic_frame.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "physics/massive_body.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/matchers.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_flight_plan_optimizer {
+
+using base::Error;
+using base::make_not_null_unique;
+using geometry::Displacement;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
+using integrators::methods::QuinlanTremaine1990Order12;
+using physics::BodyCentredNonRotatingDynamicFrame;
+using physics::ComputeApsides;
+using physics::DegreesOfFreedom;
+using physics::DiscreteTrajectory;
+using physics::MassiveBody;
+using quantities::Abs;
+using quantities::Infinity;
+using quantities::Pow;
+using quantities::Speed;
+using quantities::si::Kilogram;
+using quantities::si::Metre;
+using quantities::si::Micro;
+using quantities::si::Milli;
+using quantities::si::Minute;
+using quantities::si::Newton;
+using quantities::si::Second;
+using testing_utilities::StatusIs;
+using ::testing::Gt;
+using ::testing::Lt;
+
+class FlightPlanOptimizerTest : public testing::Test {
+ protected:
+  using TestNavigationFrame =
+      BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation>;
+
+  // A vessel on a circular orbit of radius 1 m with a period of 2π s around a
+  // body at the origin.
+  FlightPlanOptimizerTest() : scheduler_(/*pool_size=*/3) {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    bodies.emplace_back(
+        make_not_null_unique<MassiveBody>(1 * Pow<3>(Metre) / Pow<2>(Second)));
+    std::vector<DegreesOfFreedom<Barycentric>> initial_state{
+        {Barycentric::origin, Velocity<Barycentric>()}};
+    ephemeris_ = std::make_unique<Ephemeris<Barycentric>>(
+        std::move(bodies),
+        initial_state,
+        /*initial_time=*/t0_,
+        /*fitting_tolerance=*/1 * Milli(Metre),
+        Ephemeris<Barycentric>::FixedStepParameters(
+            SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                               Position<Barycentric>>(),
+            /*step=*/10 * Minute));
+    navigation_frame_ = std::make_unique<TestNavigationFrame>(
+        ephemeris_.get(),
+        ephemeris_->bodies().back());
+    flight_plan_ = std::make_unique<FlightPlan>(
+        /*initial_mass=*/1 * Kilogram,
+        /*initial_time=*/t0_,
+        DegreesOfFreedom<Barycentric>(
+            Barycentric::origin + Displacement<Barycentric>(
+                                      {1 * Metre, 0 * Metre, 0 * Metre}),
+            Velocity<Barycentric>({0 * Metre / Second,
+                                   1 * Metre / Second,
+                                   0 * Metre / Second})),
+        /*final_time=*/t0_ + 20 * Second,
+        ephemeris_.get(),
+        Ephemeris<Barycentric>::AdaptiveStepParameters(
+            EmbeddedExplicitRungeKuttaNyströmIntegrator<
+                DormandالمكاوىPrince1986RKN434FM,
+                Position<Barycentric>>(),
+            /*max_steps=*/10'000,
+            /*length_integration_tolerance=*/1 * Micro(Metre),
+            /*speed_integration_tolerance=*/1 * Micro(Metre) / Second));
+  }
+
+  Burn MakeRetrogradeBurn(Speed const& Δv) {
+    return {/*thrust=*/1 * Newton,
+            /*specific_impulse=*/1 * Newton * Second / Kilogram,
+            make_not_null_unique<TestNavigationFrame>(*navigation_frame_),
+            /*initial_time=*/t0_ + 1 * Second,
+            Velocity<Frenet<Navigation>>(
+                {-Δv, 0 * Metre / Second, 0 * Metre / Second}),
+            /*is_inertially_fixed=*/true};
+  }
+
+  // The lowest periapsis of the last coast of the flight plan.
+  Length LowestPeriapsis() {
+    DiscreteTrajectory<Barycentric>::Iterator begin;
+    DiscreteTrajectory<Barycentric>::Iterator end;
+    flight_plan_->GetSegment(flight_plan_->number_of_segments() - 1,
+                             begin,
+                             end);
+    DiscreteTrajectory<Barycentric> apoapsides;
+    DiscreteTrajectory<Barycentric> periapsides;
+    ComputeApsides(reference(), begin, end, apoapsides, periapsides);
+    Length lowest_periapsis = Infinity<Length>();
+    for (auto it = periapsides.Begin(); it != periapsides.End(); ++it) {
+      lowest_periapsis =
+          std::min(lowest_periapsis,
+                   (it.degrees_of_freedom().position() -
+                    Barycentric::origin).Norm());
+    }
+    return lowest_periapsis;
+  }
+
+  Trajectory<Barycentric> const& reference() const {
+    return *ephemeris_->trajectory(ephemeris_->bodies().back());
+  }
+
+  Instant const t0_;
+  std::unique_ptr<Ephemeris<Barycentric>> ephemeris_;
+  std::unique_ptr<TestNavigationFrame> navigation_frame_;
+  std::unique_ptr<FlightPlan> flight_plan_;
+  WorkStealingScheduler scheduler_;
+};
+
+TEST_F(FlightPlanOptimizerTest, Periapsis) {
+  EXPECT_TRUE(
+      flight_plan_->Append(MakeRetrogradeBurn(30 * Milli(Metre) / Second)));
+  EXPECT_THAT(LowestPeriapsis(), Gt(0.85 * Metre));
+
+  FlightPlanOptimizer optimizer(
+      flight_plan_.get(), ephemeris_.get(), &scheduler_);
+  EXPECT_OK(optimizer.Optimize(
+      FlightPlanOptimizer::DistanceOfClosestApproach(reference(),
+                                                     0.8 * Metre),
+      /*tolerance=*/1 * Milli(Metre)));
+  EXPECT_EQ(1, flight_plan_->number_of_manœuvres());
+  EXPECT_THAT(Abs(LowestPeriapsis() - 0.8 * Metre), Lt(1 * Milli(Metre)));
+  // The vis-viva equation gives a Δv of about 57 mm/s for an impulsive burn.
+  EXPECT_THAT(Abs(flight_plan_->GetManœuvre(0).Δv() -
+                  57 * Milli(Metre) / Second),
+              Lt(5 * Milli(Metre) / Second));
+}
+
+TEST_F(FlightPlanOptimizerTest, UndefinedResidual) {
+  // The final coast is too short to have a periapsis.
+  EXPECT_TRUE(flight_plan_->SetDesiredFinalTime(t0_ + 1.5 * Second));
+  EXPECT_TRUE(
+      flight_plan_->Append(MakeRetrogradeBurn(30 * Milli(Metre) / Second)));
+  Speed const Δv = flight_plan_->GetManœuvre(0).Δv();
+
+  FlightPlanOptimizer optimizer(
+      flight_plan_.get(), ephemeris_.get(), &scheduler_);
+  EXPECT_THAT(optimizer.Optimize(
+                  FlightPlanOptimizer::DistanceOfClosestApproach(reference(),
+                                                                 0.8 * Metre),
+                  /*tolerance=*/1 * Milli(Metre)),
+              StatusIs(Error::OUT_OF_RANGE));
+  EXPECT_EQ(Δv, flight_plan_->GetManœuvre(0).Δv());
+}
+
+}  // namespace internal_flight_plan_optimizer
+}  // namespace ksp_plugin
+}  // namespace principia
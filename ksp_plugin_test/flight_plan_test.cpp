@@ -22,6 +22,7 @@ namespace ksp_plugin {
 namespace internal_flight_plan {
 
 using base::make_not_null_unique;
+using base::WorkStealingScheduler;
 using geometry::Barycentre;
 using geometry::Displacement;
 using geometry::Position;
@@ -39,6 +40,7 @@ using quantities::Force;
 using quantities::Pow;
 using quantities::SpecificImpulse;
 using quantities::Sqrt;
+using quantities::si::Degree;
 using quantities::si::Kilogram;
 using quantities::si::Metre;
 using quantities::si::Milli;
@@ -360,6 +362,139 @@ TEST_F(FlightPlanTest, ReplaceLast) {
   EXPECT_EQ(1, flight_plan_->number_of_manœuvres());
 }
 
+TEST_F(FlightPlanTest, ReplaceLastAtSameTime) {
+  flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
+  EXPECT_TRUE(flight_plan_->Append(MakeFirstBurn()));
+  EXPECT_TRUE(flight_plan_->Append(MakeSecondBurn()));
+  // The replacement starts at the same time as the last burn, so the earlier
+  // segments are kept.
+  auto third_burn = MakeSecondBurn();
+  third_burn.Δv *= 10;
+  EXPECT_TRUE(flight_plan_->ReplaceLast(std::move(third_burn)));
+  EXPECT_EQ(2, flight_plan_->number_of_manœuvres());
+  EXPECT_EQ(5, flight_plan_->number_of_segments());
+
+  std::vector<DegreesOfFreedom<Barycentric>> replaced;
+  DiscreteTrajectory<Barycentric>::Iterator begin;
+  DiscreteTrajectory<Barycentric>::Iterator end;
+  flight_plan_->GetAllSegments(begin, end);
+  for (auto it = begin; it != end; ++it) {
+    replaced.push_back(it.degrees_of_freedom());
+  }
+
+  // The result is the same as if the flight plan had been computed from
+  // scratch.
+  flight_plan_->RemoveLast();
+  third_burn = MakeSecondBurn();
+  third_burn.Δv *= 10;
+  EXPECT_TRUE(flight_plan_->Append(std::move(third_burn)));
+  std::vector<DegreesOfFreedom<Barycentric>> appended;
+  flight_plan_->GetAllSegments(begin, end);
+  for (auto it = begin; it != end; ++it) {
+    appended.push_back(it.degrees_of_freedom());
+  }
+  EXPECT_EQ(appended, replaced);
+}
+
+TEST_F(FlightPlanTest, IntegrateAlternativesToLast) {
+  flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
+  EXPECT_TRUE(flight_plan_->Append(MakeFirstBurn()));
+  auto too_early_burn = MakeFirstBurn();
+  too_early_burn.initial_time = t0_ - 10 * Second;
+  std::vector<Burn> burns;
+  burns.push_back(MakeThirdBurn());
+  burns.push_back(std::move(too_early_burn));
+  burns.push_back(MakeSecondBurn());
+
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+  auto const alternatives =
+      flight_plan_->IntegrateAlternativesToLast(std::move(burns), &scheduler);
+  ASSERT_EQ(3, alternatives.size());
+  ASSERT_TRUE(alternatives[0].has_value());
+  EXPECT_FALSE(alternatives[1].has_value());
+  ASSERT_TRUE(alternatives[2].has_value());
+  // The flight plan is not modified.
+  EXPECT_EQ(1, flight_plan_->number_of_manœuvres());
+  EXPECT_EQ(3, flight_plan_->number_of_segments());
+
+  // The alternatives are the same as the result of |ReplaceLast|.
+  DiscreteTrajectory<Barycentric>::Iterator begin;
+  DiscreteTrajectory<Barycentric>::Iterator end;
+  EXPECT_TRUE(flight_plan_->ReplaceLast(MakeThirdBurn()));
+  flight_plan_->GetSegment(2, begin, end);
+  EXPECT_EQ(0, alternatives[0]->anomalous_segments);
+  ASSERT_EQ(3, alternatives[0]->segments.size());
+  EXPECT_EQ(alternatives[0]->manœuvre.final_mass(),
+            flight_plan_->GetManœuvre(0).final_mass());
+  EXPECT_EQ(alternatives[0]->segments.back()->last().time(),
+            (--end).time());
+  EXPECT_EQ(alternatives[0]->segments.back()->last().degrees_of_freedom(),
+            end.degrees_of_freedom());
+
+  EXPECT_TRUE(flight_plan_->ReplaceLast(MakeSecondBurn()));
+  flight_plan_->GetSegment(2, begin, end);
+  EXPECT_EQ(0, alternatives[2]->anomalous_segments);
+  ASSERT_EQ(3, alternatives[2]->segments.size());
+  EXPECT_EQ(alternatives[2]->segments.back()->last().time(),
+            (--end).time());
+  EXPECT_EQ(alternatives[2]->segments.back()->last().degrees_of_freedom(),
+            end.degrees_of_freedom());
+}
+
+TEST_F(FlightPlanTest, ComputeDispersion) {
+  flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
+  EXPECT_TRUE(flight_plan_->Append(MakeFirstBurn()));
+  EXPECT_TRUE(flight_plan_->Append(MakeSecondBurn()));
+  MassiveBody const* const centre = ephemeris_->bodies().back();
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+
+  // Without errors, all the samples follow the flight plan.
+  FlightPlan::DispersionParameters parameters;
+  parameters.samples = 5;
+  auto const exact = flight_plan_->ComputeDispersion(parameters,
+                                                     centre,
+                                                     &scheduler);
+  DiscreteTrajectory<Barycentric>::Iterator begin;
+  DiscreteTrajectory<Barycentric>::Iterator end;
+  flight_plan_->GetAllSegments(begin, end);
+  --end;
+  EXPECT_EQ(0, exact.anomalous_samples);
+  ASSERT_EQ(5, exact.samples.size());
+  for (auto const& sample : exact.samples) {
+    EXPECT_EQ(end.time(), sample.final_time);
+    EXPECT_EQ(end.degrees_of_freedom(), sample.final_degrees_of_freedom);
+  }
+  EXPECT_THAT(exact.final_position_dispersion, Lt(1e-12 * Metre));
+  EXPECT_THAT(exact.closest_approach_distance_standard_deviation,
+              Lt(1e-12 * Metre));
+
+  // With errors, the samples are spread, reproducibly.
+  parameters.samples = 20;
+  parameters.relative_Δv_error = 0.01;
+  parameters.pointing_error = 1 * Degree;
+  parameters.timing_error = 10 * Milli(Second);
+  parameters.position_error = 1 * Milli(Metre);
+  parameters.velocity_error = 1 * Milli(Metre) / Second;
+  parameters.seed = 42;
+  auto const dispersion1 = flight_plan_->ComputeDispersion(parameters,
+                                                           centre,
+                                                           &scheduler);
+  auto const dispersion2 = flight_plan_->ComputeDispersion(parameters,
+                                                           centre,
+                                                           &scheduler);
+  EXPECT_EQ(0, dispersion1.anomalous_samples);
+  ASSERT_EQ(20, dispersion1.samples.size());
+  EXPECT_THAT(dispersion1.final_position_dispersion,
+              AllOf(Gt(1 * Milli(Metre)), Lt(1 * Metre)));
+  EXPECT_THAT(dispersion1.closest_approach_distance_standard_deviation,
+              Gt(0 * Metre));
+  ASSERT_EQ(dispersion1.samples.size(), dispersion2.samples.size());
+  for (int i = 0; i < dispersion1.samples.size(); ++i) {
+    EXPECT_EQ(dispersion1.samples[i].final_degrees_of_freedom,
+              dispersion2.samples[i].final_degrees_of_freedom);
+  }
+}
+
 TEST_F(FlightPlanTest, Segments) {
   flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
   EXPECT_TRUE(flight_plan_->Append(MakeFirstBurn()));
@@ -386,6 +521,34 @@ TEST_F(FlightPlanTest, Segments) {
   }
 }
 
+TEST_F(FlightPlanTest, SegmentSplineIndex) {
+  flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
+  EXPECT_TRUE(flight_plan_->Append(MakeFirstBurn()));
+  auto const centre = ephemeris_->bodies().back();
+
+  // The nearest point to the end of the last coast is that end.
+  auto const check_last_coast = [this, centre]() {
+    DiscreteTrajectory<Barycentric>::Iterator begin;
+    DiscreteTrajectory<Barycentric>::Iterator end;
+    flight_plan_->GetSegment(2, begin, end);
+    --end;
+    DegreesOfFreedom<Navigation> const last =
+        navigation_frame_->ToThisFrameAtTime(end.time())(
+            end.degrees_of_freedom());
+    auto const& index = flight_plan_->GetSegmentSplineIndex(2, centre);
+    EXPECT_EQ(begin.time(), index.t_min());
+    EXPECT_EQ(end.time(), index.t_max());
+    Instant time;
+    EXPECT_THAT(index.Nearest(last.position(), &time).position(),
+                AlmostEquals(last.position(), 1, 2));
+    EXPECT_EQ(end.time(), time);
+  };
+  check_last_coast();
+  // The index is rebuilt when the segment changes.
+  EXPECT_TRUE(flight_plan_->ReplaceLast(MakeThirdBurn()));
+  check_last_coast();
+}
+
 TEST_F(FlightPlanTest, SetAdaptiveStepParameter) {
   DiscreteTrajectory<Barycentric>::Iterator begin;
   DiscreteTrajectory<Barycentric>::Iterator end;
@@ -479,6 +642,47 @@ TEST_F(FlightPlanTest, Serialization) {
   EXPECT_EQ(5, flight_plan_read->number_of_segments());
 }
 
+TEST_F(FlightPlanTest, SerializationWithSegments) {
+  flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
+  EXPECT_TRUE(flight_plan_->Append(MakeFirstBurn()));
+  EXPECT_TRUE(flight_plan_->Append(MakeSecondBurn()));
+
+  serialization::FlightPlan message;
+  flight_plan_->WriteToMessage(&message);
+  flight_plan_->WriteSegmentsToMessage(&message);
+  EXPECT_TRUE(message.has_segments());
+  EXPECT_EQ(0, message.anomalous_segments());
+  EXPECT_EQ(ephemeris_->Fingerprint(), message.ephemeris_fingerprint());
+
+  // The persisted segments are reused as is.
+  std::unique_ptr<FlightPlan> flight_plan_read =
+      FlightPlan::ReadFromMessage(message, ephemeris_.get());
+  EXPECT_EQ(2, flight_plan_read->number_of_manœuvres());
+  ASSERT_EQ(5, flight_plan_read->number_of_segments());
+  for (int i = 0; i < 5; ++i) {
+    DiscreteTrajectory<Barycentric>::Iterator begin;
+    DiscreteTrajectory<Barycentric>::Iterator end;
+    DiscreteTrajectory<Barycentric>::Iterator begin_read;
+    DiscreteTrajectory<Barycentric>::Iterator end_read;
+    flight_plan_->GetSegment(i, begin, end);
+    flight_plan_read->GetSegment(i, begin_read, end_read);
+    auto it_read = begin_read;
+    for (auto it = begin; it != end; ++it, ++it_read) {
+      ASSERT_NE(end_read, it_read);
+      EXPECT_EQ(it.time(), it_read.time());
+      EXPECT_EQ(it.degrees_of_freedom(), it_read.degrees_of_freedom());
+    }
+    EXPECT_EQ(end_read, it_read);
+  }
+
+  // The segments of a different ephemeris are recomputed.
+  message.set_ephemeris_fingerprint(message.ephemeris_fingerprint() + 1);
+  flight_plan_read = FlightPlan::ReadFromMessage(message, ephemeris_.get());
+  EXPECT_EQ(5, flight_plan_read->number_of_segments());
+  EXPECT_EQ(flight_plan_->actual_final_time(),
+            flight_plan_read->actual_final_time());
+}
+
 }  // namespace internal_flight_plan
 }  // namespace ksp_plugin
 }  // namespace principia
@@ -1,6 +1,8 @@
 
 #include "ksp_plugin/interface.hpp"
 
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ksp_plugin_test/fake_plugin.hpp"
@@ -32,6 +34,8 @@ using testing_utilities::IsOk;
 using testing_utilities::IsNear;
 using testing_utilities::SolarSystemFactory;
 using ::testing::Eq;
+using ::testing::IsNull;
+using ::testing::Lt;
 
 namespace {
 
@@ -103,5 +107,57 @@ TEST_F(InterfaceExternalTest, GetNearestPlannedCoastDegreesOfFreedom) {
                                           IsNear(54 * Micro(Metre) / Second))));
 }
 
+TEST_F(InterfaceExternalTest, FlowFreefalls) {
+  // A low circular orbit, whatever the orientation of |World|.
+  QP const initial_degrees_of_freedom = {/*q=*/{6783e3, 0, 0},
+                                         /*p=*/{0, 7666, 0}};
+  double const t0 = ToGameTime(plugin_, plugin_.CurrentTime());
+  std::vector<ExternalFreefall> const freefalls = {
+      {initial_degrees_of_freedom, t0, t0 + 600},
+      {initial_degrees_of_freedom, t0, t0 + 60},
+      {initial_degrees_of_freedom, t0 + 60, t0 + 120},
+      {initial_degrees_of_freedom, t0, t0},
+      {initial_degrees_of_freedom, t0, t0 - 60}};
+  FreefallFuture* future =
+      principia__ExternalFlowFreefalls(&plugin_,
+                                       SolarSystemFactory::Earth,
+                                       freefalls.data(),
+                                       freefalls.size());
+
+  // The freefalls that are integrated together agree with those that are
+  // integrated separately.
+  for (int i = 0; i < 4; ++i) {
+    QP batch_result;
+    auto status = principia__ExternalGetFreefallResult(
+        &plugin_, future, i, &batch_result);
+    EXPECT_THAT(status.error, Eq(0)) << i;
+    QP single_result;
+    status = principia__ExternalFlowFreefall(
+        &plugin_,
+        SolarSystemFactory::Earth,
+        freefalls[i].world_body_centred_initial_degrees_of_freedom,
+        freefalls[i].t_initial,
+        freefalls[i].t_final,
+        &single_result);
+    EXPECT_THAT(status.error, Eq(0)) << i;
+    auto const batch = FromQP<DegreesOfFreedom<World>>(batch_result);
+    auto const single = FromQP<DegreesOfFreedom<World>>(single_result);
+    EXPECT_THAT((batch.position() - single.position()).Norm(), Lt(1 * Metre))
+        << i;
+  }
+  EXPECT_TRUE(principia__ExternalFreefallFutureIsReady(&plugin_, future));
+
+  QP result;
+  EXPECT_THAT(
+      principia__ExternalGetFreefallResult(&plugin_, future, 4, &result).error,
+      Eq(static_cast<int>(base::Error::INVALID_ARGUMENT)));
+  EXPECT_THAT(
+      principia__ExternalGetFreefallResult(&plugin_, future, 5, &result).error,
+      Eq(static_cast<int>(base::Error::OUT_OF_RANGE)));
+
+  principia__ExternalDeleteFreefallFuture(&plugin_, &future);
+  EXPECT_THAT(future, IsNull());
+}
+
 }  // namespace interface
 }  // namespace principia
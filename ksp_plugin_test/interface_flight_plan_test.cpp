@@ -281,8 +281,8 @@ TEST_F(InterfaceFlightPlanTest, FlightPlan) {
       .WillRepeatedly(Return(plotting_frame.get()));
   EXPECT_CALL(*plotting_frame, ToThisFrameAtTime(Instant()))
       .WillOnce(Return(barycentric_to_plotting));
-  EXPECT_CALL(*plotting_frame, FromThisFrameAtTime(Instant() - 4 * Second))
-      .WillOnce(Return(barycentric_to_plotting.Inverse()));
+  EXPECT_CALL(*plotting_frame, ToThisFrameAtTime(Instant() - 4 * Second))
+      .WillOnce(Return(barycentric_to_plotting));
   principia__FlightPlanGetManoeuvreFrenetTrihedron(plugin_.get(),
                                                    vessel_guid,
                                                    3);
@@ -333,6 +333,46 @@ TEST_F(InterfaceFlightPlanTest, FlightPlan) {
   EXPECT_EQ(XYZ({0, 2, 4}),
             principia__IteratorGetDiscreteTrajectoryXYZ(iterator));
 
+  FloatXYZ xyz[3];
+  EXPECT_EQ(3,
+            principia__IteratorGetDiscreteTrajectoryFloatXYZs(
+                iterator,
+                /*floating_origin=*/{0, 0, 0},
+                /*stride=*/1,
+                xyz,
+                /*xyz_size=*/2));
+  EXPECT_EQ(3,
+            principia__IteratorGetDiscreteTrajectoryFloatXYZs(
+                iterator,
+                /*floating_origin=*/{0, 0, 0},
+                /*stride=*/1,
+                xyz,
+                /*xyz_size=*/3));
+  EXPECT_EQ(FloatXYZ({0, 0, 0}), xyz[0]);
+  EXPECT_EQ(FloatXYZ({0, 1, 2}), xyz[1]);
+  EXPECT_EQ(FloatXYZ({0, 2, 4}), xyz[2]);
+  EXPECT_EQ(2,
+            principia__IteratorGetDiscreteTrajectoryFloatXYZs(
+                iterator,
+                /*floating_origin=*/{0, 0, 0},
+                /*stride=*/2,
+                xyz,
+                /*xyz_size=*/3));
+  EXPECT_EQ(FloatXYZ({0, 0, 0}), xyz[0]);
+  EXPECT_EQ(FloatXYZ({0, 2, 4}), xyz[1]);
+
+  // Relative to an origin far away, the small coordinates are exact.
+  EXPECT_EQ(3,
+            principia__IteratorGetDiscreteTrajectoryFloatXYZs(
+                iterator,
+                /*floating_origin=*/{1e12, 1, 2},
+                /*stride=*/1,
+                xyz,
+                /*xyz_size=*/3));
+  EXPECT_EQ(FloatXYZ({-1e12f, -1, -2}), xyz[0]);
+  EXPECT_EQ(FloatXYZ({-1e12f, 0, 0}), xyz[1]);
+  EXPECT_EQ(FloatXYZ({-1e12f, 1, 2}), xyz[2]);
+
   burn.thrust_in_kilonewtons = 10;
   EXPECT_CALL(*plugin_,
               FillBodyCentredNonRotatingNavigationFrame(celestial_index, _))
@@ -1,17 +1,22 @@
 
 #include "ksp_plugin/interface.hpp"
 
+#include <vector>
+
 #include "geometry/affine_map.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/rotation.hpp"
+#include "geometry/rp2_point.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ksp_plugin/frames.hpp"
+#include "ksp_plugin/iterators.hpp"
 #include "ksp_plugin_test/mock_planetarium.hpp"
 #include "ksp_plugin_test/mock_plugin.hpp"
 #include "ksp_plugin_test/mock_renderer.hpp"
 #include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
 #include "testing_utilities/actions.hpp"
 
 namespace principia {
@@ -23,13 +28,18 @@ using geometry::Instant;
 using geometry::OrthogonalMap;
 using geometry::RigidTransformation;
 using geometry::Rotation;
+using geometry::RP2Lines;
+using geometry::RP2Point;
 using ksp_plugin::Camera;
 using ksp_plugin::Navigation;
 using ksp_plugin::MockPlanetarium;
 using ksp_plugin::MockPlugin;
 using ksp_plugin::MockRenderer;
+using ksp_plugin::TypedIterator;
 using quantities::Length;
+using quantities::si::Metre;
 using testing_utilities::FillUniquePtr;
+using ::testing::ElementsAre;
 using ::testing::IsNull;
 using ::testing::Return;
 using ::testing::ReturnRef;
@@ -71,5 +81,65 @@ TEST_F(InterfacePlanetariumTest, ConstructionDestruction) {
   EXPECT_THAT(planetarium, IsNull());
 }
 
+TEST_F(InterfacePlanetariumTest, Update) {
+  auto const identity = Rotation<Barycentric, AliceSun>::Identity();
+  MockRenderer renderer;
+  MockPlanetarium planetarium;
+  EXPECT_CALL(*const_plugin_, renderer()).WillRepeatedly(ReturnRef(renderer));
+  EXPECT_CALL(*plugin_, CurrentTime()).WillRepeatedly(Return(t0_));
+  EXPECT_CALL(*plugin_, PlanetariumRotation())
+      .WillRepeatedly(ReturnRef(identity));
+  EXPECT_CALL(renderer, WorldToPlotting(_, _, _))
+      .WillOnce(Return(RigidTransformation<World, Navigation>::Identity()));
+  EXPECT_CALL(*plugin_, UpdatePlanetarium(_, _, _));
+
+  principia__PlanetariumUpdate(&planetarium,
+                               plugin_.get(),
+                               {100, 200, 300},
+                               {1, 0, 0},
+                               {0, 1, 0},
+                               {0, 0, 1},
+                               {1, 2, 3},
+                               10,
+                               90);
+}
+
+TEST_F(InterfacePlanetariumTest, RP2LinesXY) {
+  RP2Lines<Length, Camera> const rp2_lines = {
+      {RP2Point<Length, Camera>(1 * Metre, 2 * Metre, 1),
+       RP2Point<Length, Camera>(3 * Metre, 4 * Metre, 1)},
+      {},
+      {RP2Point<Length, Camera>(5 * Metre, 6 * Metre, 2)}};
+  Iterator* iterator = new TypedIterator<RP2Lines<Length, Camera>>(rp2_lines);
+
+  // Too small a buffer: nothing is written but the sizes are returned.
+  std::vector<XY> xy(2, XY{-1, -1});
+  std::vector<int> line_ends(3, -1);
+  int line_count;
+  EXPECT_EQ(3,
+            principia__IteratorGetRP2LinesXY(iterator,
+                                             xy.data(), xy.size(),
+                                             line_ends.data(), line_ends.size(),
+                                             &line_count));
+  EXPECT_EQ(3, line_count);
+  EXPECT_THAT(xy, ElementsAre(XY{-1, -1}, XY{-1, -1}));
+  EXPECT_THAT(line_ends, ElementsAre(-1, -1, -1));
+
+  // The position of the iterator does not matter.
+  principia__IteratorIncrement(iterator);
+  xy.resize(3);
+  EXPECT_EQ(3,
+            principia__IteratorGetRP2LinesXY(iterator,
+                                             xy.data(), xy.size(),
+                                             line_ends.data(), line_ends.size(),
+                                             &line_count));
+  EXPECT_EQ(3, line_count);
+  EXPECT_THAT(xy, ElementsAre(XY{1, 2}, XY{3, 4}, XY{2.5, 3}));
+  EXPECT_THAT(line_ends, ElementsAre(2, 2, 3));
+
+  principia__IteratorDelete(&iterator);
+  EXPECT_THAT(iterator, IsNull());
+}
+
 }  // namespace interface
 }  // namespace principia
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "astronomy/epoch.hpp"
+#include "base/base32768.hpp"
 #include "base/not_null.hpp"
 #include "base/pull_serializer.hpp"
 #include "base/push_deserializer.hpp"
@@ -34,6 +35,8 @@ namespace principia {
 namespace interface {
 
 using astronomy::ModifiedJulianDate;
+using base::Base32768Decode;
+using base::Base32768Encode;
 using base::check_not_null;
 using base::make_not_null_unique;
 using base::ParseFromBytes;
@@ -49,6 +52,7 @@ using geometry::Vector;
 using geometry::Velocity;
 using ksp_plugin::AliceSun;
 using ksp_plugin::Barycentric;
+using ksp_plugin::BodyWorld;
 using ksp_plugin::Index;
 using ksp_plugin::MakeNavigationManœuvre;
 using ksp_plugin::MockManœuvre;
@@ -60,6 +64,7 @@ using ksp_plugin::Navigation;
 using ksp_plugin::NavigationManœuvre;
 using ksp_plugin::Part;
 using ksp_plugin::PartId;
+using ksp_plugin::VesselHandle;
 using ksp_plugin::World;
 using ksp_plugin::WorldSun;
 using physics::CoordinateFrameField;
@@ -70,6 +75,7 @@ using physics::MassiveBody;
 using physics::MockDynamicFrame;
 using physics::RelativeDegreesOfFreedom;
 using physics::RigidMotion;
+using quantities::Force;
 using quantities::GravitationalParameter;
 using quantities::Length;
 using quantities::Pow;
@@ -96,6 +102,7 @@ using ::testing::DoAll;
 using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::ExitedWithCode;
+using ::testing::InSequence;
 using ::testing::Invoke;
 using ::testing::IsNull;
 using ::testing::NotNull;
@@ -385,6 +392,17 @@ TEST_F(InterfaceTest, InsertOrKeepVessel) {
   EXPECT_TRUE(plugin_->HasVessel(vessel_guid));
 }
 
+TEST_F(InterfaceTest, VesselHandle) {
+  VesselHandle const vessel_handle = 3;
+  EXPECT_CALL(*plugin_, GetVesselHandle(vessel_guid))
+      .WillOnce(Return(vessel_handle));
+  EXPECT_CALL(*plugin_, HasVesselWithHandle(vessel_handle))
+      .WillOnce(Return(true));
+  EXPECT_EQ(vessel_handle,
+            principia__VesselGetHandle(plugin_.get(), vessel_guid));
+  EXPECT_TRUE(principia__VesselHandleIsValid(plugin_.get(), vessel_handle));
+}
+
 TEST_F(InterfaceTest, InsertUnloadedPart) {
   EXPECT_CALL(*plugin_,
               InsertUnloadedPart(
@@ -407,6 +425,36 @@ TEST_F(InterfaceTest, InsertUnloadedPart) {
                                 parent_relative_degrees_of_freedom);
 }
 
+TEST_F(InterfaceTest, IncrementPartsIntrinsicForces) {
+  PartForce const forces[] = {{part_id, {1, 2, 3}},
+                              {part_id + 1, {4, 5, 6}},
+                              {part_id, {7, 8, 9}}};
+  {
+    InSequence s;
+    EXPECT_CALL(*plugin_,
+                IncrementPartIntrinsicForce(
+                    part_id,
+                    Vector<Force, World>({1 * Kilo(Newton),
+                                          2 * Kilo(Newton),
+                                          3 * Kilo(Newton)})));
+    EXPECT_CALL(*plugin_,
+                IncrementPartIntrinsicForce(
+                    part_id + 1,
+                    Vector<Force, World>({4 * Kilo(Newton),
+                                          5 * Kilo(Newton),
+                                          6 * Kilo(Newton)})));
+    EXPECT_CALL(*plugin_,
+                IncrementPartIntrinsicForce(
+                    part_id,
+                    Vector<Force, World>({7 * Kilo(Newton),
+                                          8 * Kilo(Newton),
+                                          9 * Kilo(Newton)})));
+  }
+  principia__IncrementPartsIntrinsicForces(plugin_.get(),
+                                           forces,
+                                           /*forces_size=*/3);
+}
+
 TEST_F(InterfaceTest, AdvanceTime) {
   EXPECT_CALL(*plugin_,
               AdvanceTime(t0_ + time * SIUnit<Time>(),
@@ -455,6 +503,65 @@ TEST_F(InterfaceTest, CelestialFromParent) {
   EXPECT_THAT(result, Eq(parent_relative_degrees_of_freedom));
 }
 
+TEST_F(InterfaceTest, GetCelestialStates) {
+  Index const sun_index = 0;
+  RelativeDegreesOfFreedom<AliceSun> const from_parent(
+      Displacement<AliceSun>({parent_position.x * SIUnit<Length>(),
+                              parent_position.y * SIUnit<Length>(),
+                              parent_position.z * SIUnit<Length>()}),
+      Velocity<AliceSun>({parent_velocity.x * SIUnit<Speed>(),
+                          parent_velocity.y * SIUnit<Speed>(),
+                          parent_velocity.z * SIUnit<Speed>()}));
+  auto const identity = Rotation<BodyWorld, World>::Identity();
+  EXPECT_CALL(*plugin_,
+              CelestialStates(ElementsAre(sun_index, celestial_index)))
+      .WillOnce(Return(std::vector<MockPlugin::CelestialState>{
+          {identity, std::nullopt}, {identity, from_parent}}));
+  int const indices[] = {sun_index, celestial_index};
+  CelestialState states[2];
+  principia__GetCelestialStates(plugin_.get(), indices, 2, states);
+  WXYZ const unit = {1, 0, 0, 0};
+  EXPECT_THAT(states[0].rotation, Eq(unit));
+  EXPECT_THAT(states[0].from_parent, Eq(QP{{0, 0, 0}, {0, 0, 0}}));
+  EXPECT_THAT(states[1].rotation, Eq(unit));
+  EXPECT_THAT(states[1].from_parent, Eq(parent_relative_degrees_of_freedom));
+}
+
+TEST_F(InterfaceTest, GetVesselStates) {
+  RelativeDegreesOfFreedom<AliceSun> const from_parent(
+      Displacement<AliceSun>({parent_position.x * SIUnit<Length>(),
+                              parent_position.y * SIUnit<Length>(),
+                              parent_position.z * SIUnit<Length>()}),
+      Velocity<AliceSun>({parent_velocity.x * SIUnit<Speed>(),
+                          parent_velocity.y * SIUnit<Speed>(),
+                          parent_velocity.z * SIUnit<Speed>()}));
+  EXPECT_CALL(*plugin_, VesselStates(ElementsAre(vessel_guid)))
+      .WillOnce(Return(std::vector<MockPlugin::VesselState>{
+          {celestial_index, from_parent}}));
+  char const* const guids[] = {vessel_guid};
+  VesselState states[1];
+  principia__GetVesselStates(plugin_.get(), guids, 1, states);
+  EXPECT_THAT(states[0].parent_index, Eq(celestial_index));
+  EXPECT_THAT(states[0].from_parent, Eq(parent_relative_degrees_of_freedom));
+}
+
+TEST_F(InterfaceTest, GetMemoryReport) {
+  MockPlugin::MemoryReport report;
+  report.celestials[0] = {/*elements=*/3, /*bytes=*/300};
+  report.celestials[1] = {/*elements=*/4, /*bytes=*/400};
+  report.vessel_histories["v"] = {/*elements=*/10, /*bytes=*/1000};
+  EXPECT_CALL(*plugin_, MemoryUsage()).WillOnce(Return(report));
+  char const* result = principia__GetMemoryReport(plugin_.get());
+  EXPECT_STREQ("Celestial 0: 3 polynomials, 300 bytes\n"
+               "Celestial 1: 4 polynomials, 400 bytes\n"
+               "Celestial total: 7 polynomials, 700 bytes\n"
+               "Vessel history v: 10 points, 1000 bytes\n"
+               "Vessel history total: 10 points, 1000 bytes\n"
+               "Flight plan total: 0 points, 0 bytes\n",
+               result);
+  principia__DeleteString(&result);
+}
+
 TEST_F(InterfaceTest, NewNavigationFrame) {
   StrictMock<MockDynamicFrame<Barycentric, Navigation>>* const
       mock_navigation_frame =
@@ -586,6 +693,50 @@ TEST_F(InterfaceTest, DeserializePluginHexadecimal) {
   principia__DeletePlugin(&plugin);
 }
 
+TEST_F(InterfaceTest, SerializePluginBase32768) {
+  PullSerializer* serializer = nullptr;
+  auto const message = ParseFromBytes<principia::serialization::Plugin>(
+      serialized_simple_plugin_);
+
+  EXPECT_CALL(*plugin_, WriteToMessage(_)).WillOnce(SetArgPointee<0>(message));
+  char16_t const* serialization =
+      principia__SerializePluginBase32768(plugin_.get(),
+                                          &serializer,
+                                          /*compressor=*/nullptr);
+  auto const bytes = Base32768Decode(
+      {serialization,
+       static_cast<std::int64_t>(
+           std::char_traits<char16_t>::length(serialization))});
+  EXPECT_EQ(serialized_simple_plugin_,
+            std::vector<std::uint8_t>(bytes.data.get(),
+                                      bytes.data.get() + bytes.size));
+  EXPECT_EQ(nullptr,
+            principia__SerializePluginBase32768(plugin_.get(),
+                                                &serializer,
+                                                /*compressor=*/nullptr));
+  principia__DeleteU16String(&serialization);
+  EXPECT_THAT(serialization, IsNull());
+}
+
+TEST_F(InterfaceTest, DeserializePluginBase32768) {
+  PushDeserializer* deserializer = nullptr;
+  Plugin const* plugin = nullptr;
+  auto const base32768 = Base32768Encode(
+      {serialized_simple_plugin_.data(),
+       static_cast<std::int64_t>(serialized_simple_plugin_.size())},
+      /*null_terminated=*/true);
+  principia__DeserializePluginBase32768(base32768.data.get(),
+                                        &deserializer,
+                                        &plugin,
+                                        /*compressor=*/nullptr);
+  principia__DeserializePluginBase32768(u"",
+                                        &deserializer,
+                                        &plugin,
+                                        /*compressor=*/nullptr);
+  EXPECT_THAT(plugin, NotNull());
+  principia__DeletePlugin(&plugin);
+}
+
 // Use for debugging saves given by users.
 TEST_F(InterfaceTest, DISABLED_DeserializePluginDebug) {
   PushDeserializer* deserializer = nullptr;
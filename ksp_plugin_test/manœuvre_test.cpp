@@ -144,6 +144,41 @@ TEST_F(ManœuvreTest, TimedBurn) {
             acceleration(manœuvre.final_time() + 1 * Second).Norm());
 }
 
+TEST_F(ManœuvreTest, IntrinsicAccelerationFixedAt) {
+  Vector<double, Frenet<Rendering>> e_y({0, 1, 0});
+
+  Manœuvre<World, Rendering> manœuvre(
+      /*thrust=*/1 * Newton,
+      /*initial_mass=*/2 * Kilogram,
+      /*specific_impulse=*/1 * Newton * Second / Kilogram,
+      /*direction=*/e_y,
+      MakeMockDynamicFrame(),
+      /*is_inertially_fixed=*/false);
+  manœuvre.set_duration(1 * Second);
+  manœuvre.set_initial_time(t0_);
+
+  // The Frenet frame is evaluated at the given time and degrees of freedom,
+  // and the coasting trajectory is not needed.
+  Instant const time = t0_ + 0.5 * Second;
+  EXPECT_CALL(*mock_dynamic_frame_, ToThisFrameAtTime(time))
+      .WillOnce(Return(rigid_motion_));
+  EXPECT_CALL(*mock_dynamic_frame_, FrenetFrame(time, rendering_dof_))
+      .WillOnce(
+          Return(Rotation<Frenet<Rendering>, Rendering>::Identity()));
+  auto const acceleration = manœuvre.IntrinsicAccelerationFixedAt(time, dof_);
+  EXPECT_EQ(0 * Metre / Pow<2>(Second),
+            acceleration(manœuvre.initial_time() - 1 * Second).Norm());
+  EXPECT_THAT(
+      acceleration(time),
+      Componentwise(0 * Metre / Pow<2>(Second),
+                    AlmostEquals(1 / 1.5 * Metre / Pow<2>(Second), 0),
+                    0 * Metre / Pow<2>(Second)));
+  EXPECT_EQ(1 * Metre / Pow<2>(Second),
+            acceleration(manœuvre.final_time()).Norm());
+  EXPECT_EQ(0 * Metre / Pow<2>(Second),
+            acceleration(manœuvre.final_time() + 1 * Second).Norm());
+}
+
 TEST_F(ManœuvreTest, TargetΔv) {
   Vector<double, Frenet<Rendering>> e_y({0, 1, 0});
   Manœuvre<World, Rendering> manœuvre(
@@ -51,6 +51,9 @@ class MockPlugin : public Plugin {
                     GUID const& vessel_guid,
                     RelativeDegreesOfFreedom<AliceSun> const& from_parent));
 
+  MOCK_METHOD2(IncrementPartIntrinsicForce,
+               void(PartId part_id, Vector<Force, World> const& force));
+
   MOCK_METHOD2(AdvanceTime,
                void(Instant const& t, Angle const& planetarium_rotation));
 
@@ -64,6 +67,15 @@ class MockPlugin : public Plugin {
   MOCK_CONST_METHOD1(CelestialFromParent,
                      RelativeDegreesOfFreedom<AliceSun>(Index celestial_index));
 
+  MOCK_CONST_METHOD1(CelestialStates,
+                     std::vector<CelestialState>(
+                         std::vector<Index> const& indices));
+  MOCK_CONST_METHOD1(VesselStates,
+                     std::vector<VesselState>(
+                         std::vector<GUID> const& vessel_guids));
+
+  MOCK_CONST_METHOD0(MemoryUsage, MemoryReport());
+
   MOCK_CONST_METHOD3(CreateFlightPlan,
                      void(GUID const& vessel_guid,
                           Instant const& final_time,
@@ -75,10 +87,18 @@ class MockPlugin : public Plugin {
 
   MOCK_CONST_METHOD1(HasVessel, bool(GUID const& vessel_guid));
   MOCK_CONST_METHOD1(GetVessel, not_null<Vessel*>(GUID const& vessel_guid));
+  MOCK_METHOD1(GetVesselHandle, VesselHandle(GUID const& vessel_guid));
+  MOCK_CONST_METHOD1(HasVesselWithHandle, bool(VesselHandle vessel_handle));
+  MOCK_CONST_METHOD1(GetVesselWithHandle,
+                     not_null<Vessel*>(VesselHandle vessel_handle));
 
   not_null<std::unique_ptr<Planetarium>> NewPlanetarium(
       Planetarium::Parameters const& parameters,
       Perspective<Navigation, Camera> const& perspective) const override;
+  MOCK_CONST_METHOD3(UpdatePlanetarium,
+                     void(Planetarium::Parameters const& parameters,
+                          Perspective<Navigation, Camera> const& perspective,
+                          not_null<Planetarium*> planetarium));
   not_null<std::unique_ptr<NavigationFrame>>
   NewBodyCentredNonRotatingNavigationFrame(
       Index reference_body_index) const override;
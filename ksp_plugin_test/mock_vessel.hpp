@@ -1,6 +1,7 @@
 ﻿
 #pragma once
 
+#include <chrono>
 #include <list>
 
 #include "gmock/gmock.h"
@@ -20,11 +21,13 @@ class MockVessel : public Vessel {
   MOCK_METHOD1(set_parent, void(not_null<Celestial const*> parent));
 
   MOCK_CONST_METHOD0(prediction, DiscreteTrajectory<Barycentric> const&());
+  MOCK_CONST_METHOD0(prediction_version, std::int64_t());
 
   MOCK_CONST_METHOD0(flight_plan, FlightPlan&());
   MOCK_CONST_METHOD0(has_flight_plan, bool());
 
   MOCK_METHOD1(ForgetBefore, void(Instant const& time));
+  MOCK_METHOD1(CompactHistory, void(Instant const& current_time));
 
   MOCK_METHOD3(CreateFlightPlan,
                void(Instant const& final_time,
@@ -35,9 +38,19 @@ class MockVessel : public Vessel {
   MOCK_METHOD0(DeleteFlightPlan, void());
 
   MOCK_METHOD1(FlowPrediction, void(Instant const& last_time));
+  MOCK_METHOD1(RefreshPrediction,
+               void(not_null<WorkStealingScheduler*> scheduler));
+  MOCK_METHOD2(RefreshPrediction,
+               void(not_null<WorkStealingScheduler*> scheduler,
+                    std::chrono::steady_clock::time_point const& deadline));
+  MOCK_METHOD0(WaitForPrognostication, void());
 
   MOCK_CONST_METHOD0(psychohistory, DiscreteTrajectory<Barycentric> const&());
+  MOCK_CONST_METHOD0(psychohistory_plotting_cache,
+                     Planetarium::PlottingCache&());
   MOCK_CONST_METHOD0(psychohistory_is_authoritative, bool());
+  MOCK_CONST_METHOD0(psychohistory_stable_time, Instant());
+  MOCK_CONST_METHOD0(history_version, std::int64_t());
 
   MOCK_CONST_METHOD1(WriteToMessage,
                      void(not_null<serialization::Vessel*> message));
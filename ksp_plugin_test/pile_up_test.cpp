@@ -29,6 +29,7 @@ namespace internal_pile_up {
 using base::check_not_null;
 using base::make_not_null_unique;
 using base::Status;
+using base::ThreadPool;
 using geometry::Displacement;
 using geometry::Position;
 using geometry::R3Element;
@@ -87,9 +88,15 @@ class TestablePileUp : public PileUp {
     return psychohistory_;
   }
 
-  PartTo<DegreesOfFreedom<RigidPileUp>> const&
+  PartTo<DegreesOfFreedom<RigidPileUp>>
   actual_part_degrees_of_freedom() const {
-    return actual_part_degrees_of_freedom_;
+    PartTo<DegreesOfFreedom<RigidPileUp>> result;
+    auto actual_it = actual_part_degrees_of_freedom_.cbegin();
+    for (not_null<Part*> const part : parts_) {
+      result.emplace(part, *actual_it);
+      ++actual_it;
+    }
+    return result;
   }
 
   PartTo<DegreesOfFreedom<ApparentBubble>> const&
@@ -527,6 +534,57 @@ TEST_F(PileUpTest, LifecycleWithoutIntrinsicForce) {
                                       890.0 / 9.0 * Metre / Second}), 0)));
 }
 
+// Checks that the pile-up is only integrated once when several vessels request
+// it to catch up.
+TEST_F(PileUpTest, DeformAndAdvanceTimeOnce) {
+  MockEphemeris<Barycentric> ephemeris;
+  EXPECT_CALL(deletion_callback_, Call()).Times(1);
+  TestablePileUp pile_up({&p1_, &p2_},
+                         astronomy::J2000,
+                         DefaultPsychohistoryParameters(),
+                         DefaultHistoryParameters(),
+                         &ephemeris,
+                         deletion_callback_.AsStdFunction());
+
+  auto history = pile_up.psychohistory()->parent();
+  auto instance = make_not_null_unique<MockFixedStepSizeIntegrator<
+      Ephemeris<Barycentric>::NewtonianMotionEquation>::MockInstance>();
+  EXPECT_CALL(ephemeris, NewInstance(ElementsAre(history), _, _))
+      .WillOnce(Return(ByMove(std::move(instance))));
+  EXPECT_CALL(ephemeris, FlowWithFixedStep(_, _))
+      .WillOnce(DoAll(
+          AppendToDiscreteTrajectory(
+              &history,
+              astronomy::J2000 + 0.8 * Second,
+              DegreesOfFreedom<Barycentric>(
+                  Barycentric::origin +
+                      Displacement<Barycentric>(
+                          {1.2 * Metre, 14.2 * Metre, 31.2 / 3.0 * Metre}),
+                  Velocity<Barycentric>({10.2 * Metre / Second,
+                                         140.2 * Metre / Second,
+                                         310.2 / 3.0 * Metre / Second}))),
+          Return(Status::OK)));
+  EXPECT_CALL(ephemeris, FlowWithAdaptiveStep(_, _, _, _, _, _))
+      .WillOnce(DoAll(
+          AppendToDiscreteTrajectory(DegreesOfFreedom<Barycentric>(
+              Barycentric::origin +
+                  Displacement<Barycentric>({1.0 * Metre,
+                                             14.0 * Metre,
+                                             31.0 / 3.0 * Metre}),
+              Velocity<Barycentric>({10.0 * Metre / Second,
+                                     140.0 * Metre / Second,
+                                     310.0 / 3.0 * Metre / Second}))),
+          Return(Status::OK)));
+
+  ThreadPool<Status> thread_pool(/*pool_size=*/2);
+  Instant const t = astronomy::J2000 + 1 * Second;
+  auto const future1 = pile_up.DeformAndAdvanceTimeOnce(t, thread_pool);
+  auto const future2 = pile_up.DeformAndAdvanceTimeOnce(t, thread_pool);
+  EXPECT_OK(future1.get());
+  EXPECT_OK(future2.get());
+  EXPECT_EQ(t, pile_up.psychohistory()->last().time());
+}
+
 TEST_F(PileUpTest, MidStepIntrinsicForce) {
   // An empty ephemeris; the parameters don't matter, since there are no bodies
   // to integrate.
@@ -586,6 +644,136 @@ TEST_F(PileUpTest, MidStepIntrinsicForce) {
               AlmostEquals(old_velocity + 0.5 * fixed_step * a, 1));
 }
 
+// Checks that after an intrinsic force the fixed-step integration resumes on
+// the grid that starts at the end of the burn.
+TEST_F(PileUpTest, FixedStepRestartAfterIntrinsicForce) {
+  // As above, a tiny body very far.
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  bodies.emplace_back(make_not_null_unique<MassiveBody>(1 * Kilogram));
+  std::vector<DegreesOfFreedom<Barycentric>> initial_state{
+      DegreesOfFreedom<Barycentric>{
+          Barycentric::origin +
+              Displacement<Barycentric>(
+                  {std::pow(2, 100) * Metre, 0 * Metre, 0 * Metre}),
+          Velocity<Barycentric>{}}};
+  Ephemeris<Barycentric> ephemeris{
+      std::move(bodies),
+      initial_state,
+      /*initial_time=*/astronomy::J2000,
+      /*fitting_tolerance=*/1 * Metre,
+      Ephemeris<Barycentric>::FixedStepParameters{
+          SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN6B,
+                                                Position<Barycentric>>(),
+          1 * Second}};
+
+  // A multistep integrator, which would need a startup.
+  auto const fixed_parameters = DefaultHistoryParameters();
+  Time const fixed_step = fixed_parameters.step();
+  int const history_size = fixed_parameters.history_size();
+  Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_parameters{
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          DormandالمكاوىPrince1986RKN434FM,
+          Position<Barycentric>>(),
+      /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+      /*length_integration_tolerance*/ 1 * Micro(Metre),
+      /*speed_integration_tolerance=*/1 * Micro(Metre) / Second};
+
+  EXPECT_CALL(deletion_callback_, Call()).Times(1);
+  TestablePileUp pile_up({&p1_}, astronomy::J2000,
+                         adaptive_parameters,
+                         fixed_parameters,
+                         &ephemeris,
+                         deletion_callback_.AsStdFunction());
+  Velocity<Barycentric> const old_velocity =
+      p1_.degrees_of_freedom().velocity();
+
+  Vector<Acceleration, Barycentric> const a{{1729 * Metre / Pow<2>(Second),
+                                             -168 * Metre / Pow<2>(Second),
+                                             504 * Metre / Pow<2>(Second)}};
+  pile_up.set_intrinsic_force(p1_.mass() * a);
+  Instant const end_of_burn = astronomy::J2000 + 1.5 * fixed_step;
+  pile_up.AdvanceTime(end_of_burn);
+  pile_up.set_intrinsic_force(Vector<Force, Barycentric>{});
+
+  // Coast in increments that are not always aligned on the grid.
+  for (int i = 1; i <= 2 * (history_size + 3) + 1; ++i) {
+    pile_up.AdvanceTime(end_of_burn + i * 0.5 * fixed_step);
+    pile_up.NudgeParts();
+  }
+  EXPECT_THAT(p1_.degrees_of_freedom().velocity(),
+              AlmostEquals(old_velocity + 1.5 * fixed_step * a, 0, 4));
+
+  // The points of the history are on the grid that starts at the end of the
+  // burn, both before and after the restart of the fixed-step integrator.
+  int grid_points = 0;
+  for (auto it = p1_.history_begin(); it != p1_.history_end(); ++it) {
+    if (it.time() > end_of_burn) {
+      ++grid_points;
+      EXPECT_THAT(it.time() - end_of_burn,
+                  AlmostEquals(grid_points * fixed_step, 0, 2));
+    }
+  }
+  EXPECT_EQ(history_size + 3, grid_points);
+}
+
+// Checks that the points integrated ahead by |Speculate| only reach the parts
+// when the time reaches them, and that they are discarded by an intrinsic
+// force.
+TEST_F(PileUpTest, Speculation) {
+  // As above, a tiny body very far.
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  bodies.emplace_back(make_not_null_unique<MassiveBody>(1 * Kilogram));
+  std::vector<DegreesOfFreedom<Barycentric>> initial_state{
+      DegreesOfFreedom<Barycentric>{
+          Barycentric::origin +
+              Displacement<Barycentric>(
+                  {std::pow(2, 100) * Metre, 0 * Metre, 0 * Metre}),
+          Velocity<Barycentric>{}}};
+  Ephemeris<Barycentric> ephemeris{
+      std::move(bodies),
+      initial_state,
+      /*initial_time=*/astronomy::J2000,
+      /*fitting_tolerance=*/1 * Metre,
+      Ephemeris<Barycentric>::FixedStepParameters{
+          SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN6B,
+                                                Position<Barycentric>>(),
+          1 * Second}};
+
+  Time const fixed_step = 10 * Second;
+  Ephemeris<Barycentric>::FixedStepParameters fixed_parameters{
+      SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN6B,
+                                            Position<Barycentric>>(),
+      fixed_step};
+
+  EXPECT_CALL(deletion_callback_, Call()).Times(1);
+  TestablePileUp pile_up({&p1_}, astronomy::J2000,
+                         DefaultPsychohistoryParameters(),
+                         fixed_parameters,
+                         &ephemeris,
+                         deletion_callback_.AsStdFunction());
+
+  pile_up.AdvanceTime(astronomy::J2000 + 0.5 * fixed_step);
+  pile_up.Speculate(astronomy::J2000 + 10.5 * fixed_step);
+  Instant const t = astronomy::J2000 + 3.5 * fixed_step;
+  pile_up.AdvanceTime(t);
+  pile_up.NudgeParts();
+  EXPECT_EQ(t, pile_up.psychohistory()->last().time());
+  EXPECT_EQ(astronomy::J2000 + 3 * fixed_step,
+            pile_up.psychohistory()->Fork().time());
+  for (auto it = p1_.history_begin(); it != p1_.history_end(); ++it) {
+    EXPECT_LE(it.time(), astronomy::J2000 + 3 * fixed_step);
+  }
+
+  Vector<Acceleration, Barycentric> const a{{1729 * Metre / Pow<2>(Second),
+                                             -168 * Metre / Pow<2>(Second),
+                                             504 * Metre / Pow<2>(Second)}};
+  pile_up.set_intrinsic_force(p1_.mass() * a);
+  pile_up.AdvanceTime(t + fixed_step);
+  pile_up.NudgeParts();
+  EXPECT_EQ(t + fixed_step, pile_up.psychohistory()->last().time());
+  EXPECT_EQ(t + fixed_step, pile_up.psychohistory()->Fork().time());
+}
+
 TEST_F(PileUpTest, Serialization) {
   MockEphemeris<Barycentric> ephemeris;
   p1_.increment_intrinsic_force(
@@ -630,6 +818,78 @@ TEST_F(PileUpTest, Serialization) {
   EXPECT_THAT(message, EqualsProto(second_message));
 }
 
+// Checks that the points integrated ahead by |Speculate| are not serialized.
+TEST_F(PileUpTest, SerializationWithSpeculation) {
+  // As above, a tiny body very far.
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  bodies.emplace_back(make_not_null_unique<MassiveBody>(1 * Kilogram));
+  std::vector<DegreesOfFreedom<Barycentric>> initial_state{
+      DegreesOfFreedom<Barycentric>{
+          Barycentric::origin +
+              Displacement<Barycentric>(
+                  {std::pow(2, 100) * Metre, 0 * Metre, 0 * Metre}),
+          Velocity<Barycentric>{}}};
+  Ephemeris<Barycentric> ephemeris{
+      std::move(bodies),
+      initial_state,
+      /*initial_time=*/astronomy::J2000,
+      /*fitting_tolerance=*/1 * Metre,
+      Ephemeris<Barycentric>::FixedStepParameters{
+          SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN6B,
+                                                Position<Barycentric>>(),
+          1 * Second}};
+
+  Time const fixed_step = 10 * Second;
+  Ephemeris<Barycentric>::FixedStepParameters fixed_parameters{
+      SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN6B,
+                                            Position<Barycentric>>(),
+      fixed_step};
+
+  EXPECT_CALL(deletion_callback_, Call()).Times(2);
+  TestablePileUp pile_up({&p1_}, astronomy::J2000,
+                         DefaultPsychohistoryParameters(),
+                         fixed_parameters,
+                         &ephemeris,
+                         deletion_callback_.AsStdFunction());
+
+  pile_up.AdvanceTime(astronomy::J2000 + 2.5 * fixed_step);
+  pile_up.NudgeParts();
+  pile_up.Speculate(astronomy::J2000 + 10.5 * fixed_step);
+  Instant const psychohistory_fork_time =
+      pile_up.psychohistory()->Fork().time();
+  EXPECT_EQ(astronomy::J2000 + 2 * fixed_step, psychohistory_fork_time);
+
+  serialization::PileUp message;
+  pile_up.WriteToMessage(&message);
+  for (auto const& point : message.history().timeline()) {
+    EXPECT_LE(Instant::ReadFromMessage(point.instant()),
+              psychohistory_fork_time);
+  }
+  ASSERT_EQ(1, message.history().children_size());
+  EXPECT_EQ(psychohistory_fork_time,
+            Instant::ReadFromMessage(
+                message.history().children(0).fork_time()));
+  ASSERT_EQ(1, message.history().children(0).trajectories_size());
+  EXPECT_EQ(1,
+            message.history().children(0).trajectories(0).timeline_size());
+
+  auto const part_id_to_part = [this](PartId const part_id) {
+    if (part_id == part_id1_) {
+      return &p1_;
+    }
+    LOG(FATAL) << "Unexpected part id " << part_id;
+    base::noreturn();
+  };
+  auto const p = PileUp::ReadFromMessage(message,
+                                         part_id_to_part,
+                                         &ephemeris,
+                                         deletion_callback_.AsStdFunction());
+
+  serialization::PileUp second_message;
+  p->WriteToMessage(&second_message);
+  EXPECT_THAT(message, EqualsProto(second_message));
+}
+
 TEST_F(PileUpTest, SerializationCompatibility) {
   MockEphemeris<Barycentric> ephemeris;
   p1_.increment_intrinsic_force(
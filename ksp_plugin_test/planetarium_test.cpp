@@ -6,6 +6,7 @@
 
 #include "base/not_null.hpp"
 #include "base/serialization.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "geometry/affine_map.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/linear_map.hpp"
@@ -13,8 +14,8 @@
 #include "geometry/perspective.hpp"
 #include "geometry/rotation.hpp"
 #include "gtest/gtest.h"
+#include "physics/continuous_trajectory.hpp"
 #include "physics/massive_body.hpp"
-#include "physics/mock_continuous_trajectory.hpp"
 #include "physics/mock_dynamic_frame.hpp"
 #include "physics/mock_ephemeris.hpp"
 #include "physics/rigid_motion.hpp"
@@ -34,17 +35,19 @@ using astronomy::InfinitePast;
 using astronomy::InfiniteFuture;
 using base::make_not_null_unique;
 using base::ParseFromBytes;
+using base::WorkStealingScheduler;
 using geometry::AngularVelocity;
 using geometry::Bivector;
 using geometry::Displacement;
 using geometry::LinearMap;
 using geometry::Perspective;
+using geometry::Position;
 using geometry::RigidTransformation;
 using geometry::Rotation;
 using geometry::Vector;
 using geometry::Velocity;
+using physics::ContinuousTrajectory;
 using physics::MassiveBody;
-using physics::MockContinuousTrajectory;
 using physics::MockDynamicFrame;
 using physics::MockEphemeris;
 using physics::RigidMotion;
@@ -52,11 +55,13 @@ using physics::RotatingBody;
 using quantities::Cos;
 using quantities::Sin;
 using quantities::Sqrt;
+using quantities::Tan;
 using quantities::Time;
 using quantities::si::ArcMinute;
 using quantities::si::Degree;
 using quantities::si::Kilogram;
 using quantities::si::Metre;
+using quantities::si::Milli;
 using quantities::si::Radian;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
@@ -64,10 +69,14 @@ using testing_utilities::ReadFromBinaryFile;
 using testing_utilities::VanishesBefore;
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::DoAll;
 using ::testing::Ge;
+using ::testing::InvokeWithoutArgs;
 using ::testing::Le;
+using ::testing::Lt;
 using ::testing::Return;
 using ::testing::ReturnRef;
+using ::testing::SetArgReferee;
 using ::testing::SizeIs;
 
 class PlanetariumTest : public ::testing::Test {
@@ -103,10 +112,9 @@ class PlanetariumTest : public ::testing::Test {
             AngularVelocity<Barycentric>(),
             Velocity<Barycentric>())));
     EXPECT_CALL(ephemeris_, bodies()).WillRepeatedly(ReturnRef(bodies_));
-    EXPECT_CALL(ephemeris_, trajectory(_))
-        .WillRepeatedly(Return(&continuous_trajectory_));
-    EXPECT_CALL(continuous_trajectory_, EvaluatePosition(_))
-        .WillRepeatedly(Return(Barycentric::origin));
+    EXPECT_CALL(ephemeris_, EvaluateAllPositions(_, _))
+        .WillRepeatedly(SetArgReferee<1>(
+            std::vector<Position<Barycentric>>{Barycentric::origin}));
   }
 
   not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>>
@@ -135,7 +143,6 @@ class PlanetariumTest : public ::testing::Test {
   MockDynamicFrame<Barycentric, Navigation> plotting_frame_;
   RotatingBody<Barycentric> const body_;
   std::vector<not_null<MassiveBody const*>> const bodies_;
-  MockContinuousTrajectory<Barycentric> continuous_trajectory_;
   MockEphemeris<Barycentric> ephemeris_;
 };
 
@@ -239,6 +246,277 @@ TEST_F(PlanetariumTest, PlotMethod2) {
   }
 }
 
+TEST_F(PlanetariumTest, PlotContinuousTrajectory) {
+  // The same quarter of a circular trajectory as above, as a continuous
+  // trajectory.
+  Time const period = 100'000 * Second;
+  auto const discrete_trajectory =
+      NewCircularTrajectory(period,
+                            /*step=*/100 * Second,
+                            /*last=*/period / 2);
+  ContinuousTrajectory<Barycentric> continuous_trajectory(
+      /*step=*/100 * Second,
+      /*tolerance=*/1 * Milli(Metre));
+  for (auto it = discrete_trajectory->Begin();
+       it != discrete_trajectory->End();
+       ++it) {
+    EXPECT_OK(continuous_trajectory.Append(it.time(),
+                                           it.degrees_of_freedom()));
+  }
+
+  // No dark area, human visual acuity, wide field of view.
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  Planetarium planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_);
+  auto const rp2_lines =
+      planetarium.PlotContinuousTrajectory(continuous_trajectory,
+                                           /*first_time=*/t0_,
+                                           /*last_time=*/t0_ + period / 4,
+                                           t0_ + 10 * Second,
+                                           /*reverse=*/false);
+
+  EXPECT_THAT(rp2_lines, SizeIs(1));
+  EXPECT_THAT(rp2_lines[0], SizeIs(Ge(2)));
+  for (auto const& rp2_point : rp2_lines[0]) {
+    EXPECT_THAT(rp2_point.x(),
+                AllOf(Ge(0 * Metre),
+                      Le((5.0 / Sqrt(3.0)) * Metre)));
+    EXPECT_THAT(rp2_point.y(), VanishesBefore(1 * Metre, 0, 14));
+  }
+}
+
+TEST_F(PlanetariumTest, PlotMethod2Simplification) {
+  // The same quarter of a circular trajectory as above, which is seen edge-on,
+  // so its points are nearly aligned in the focal plane.
+  auto const discrete_trajectory =
+      NewCircularTrajectory(/*period=*/100'000 * Second,
+                            /*step=*/1 * Second,
+                            /*last=*/25'000 * Second);
+
+  Planetarium::Parameters unsimplified_parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  Planetarium unsimplified_planetarium(
+      unsimplified_parameters, perspective_, &ephemeris_, &plotting_frame_);
+  auto const unsimplified_rp2_lines =
+      unsimplified_planetarium.PlotMethod2(discrete_trajectory->Begin(),
+                                           discrete_trajectory->End(),
+                                           t0_ + 10 * Second,
+                                           /*reverse=*/false);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree,
+      /*simplification_tolerance=*/0.4 * ArcMinute);
+  Planetarium planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_);
+  auto const rp2_lines =
+      planetarium.PlotMethod2(discrete_trajectory->Begin(),
+                              discrete_trajectory->End(),
+                              t0_ + 10 * Second,
+                              /*reverse=*/false);
+
+  ASSERT_THAT(unsimplified_rp2_lines, SizeIs(1));
+  ASSERT_THAT(rp2_lines, SizeIs(1));
+  EXPECT_THAT(rp2_lines[0], SizeIs(Lt(unsimplified_rp2_lines[0].size())));
+  EXPECT_EQ(unsimplified_rp2_lines[0].front(), rp2_lines[0].front());
+  EXPECT_EQ(unsimplified_rp2_lines[0].back(), rp2_lines[0].back());
+  for (auto const& rp2_point : rp2_lines[0]) {
+    EXPECT_THAT(rp2_point.x(),
+                AllOf(Ge(0 * Metre),
+                      Le((5.0 / Sqrt(3.0)) * Metre)));
+    EXPECT_THAT(rp2_point.y(), VanishesBefore(1 * Metre, 0, 14));
+  }
+}
+
+TEST_F(PlanetariumTest, PlotMethod2FieldOfView) {
+  // The same quarter of a circular trajectory as above.  Seen from the camera,
+  // it spans about 26.6°, but only 10° of it are in the field of view.
+  auto const discrete_trajectory =
+      NewCircularTrajectory(/*period=*/100'000 * Second,
+                            /*step=*/1 * Second,
+                            /*last=*/25'000 * Second);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/10 * Degree);
+  Planetarium planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_);
+  auto const rp2_lines =
+      planetarium.PlotMethod2(discrete_trajectory->Begin(),
+                              discrete_trajectory->End(),
+                              t0_ + 10 * Second,
+                              /*reverse=*/false);
+
+  EXPECT_THAT(rp2_lines, SizeIs(1));
+  EXPECT_THAT(rp2_lines[0], SizeIs(AllOf(Ge(2), Le(42))));
+  for (auto const& rp2_point : rp2_lines[0]) {
+    EXPECT_THAT(rp2_point.x(),
+                AllOf(Ge(0 * Metre), Le(5 * Tan(12 * Degree) * Metre)));
+  }
+}
+
+TEST_F(PlanetariumTest, PlotMethod2Batch) {
+  auto const discrete_trajectory1 =
+      NewCircularTrajectory(/*period=*/100'000 * Second,
+                            /*step=*/1 * Second,
+                            /*last=*/25'000 * Second);
+  auto const discrete_trajectory2 =
+      NewCircularTrajectory(/*period=*/10 * Second,
+                            /*step=*/1 * Second,
+                            /*last=*/10 * Second);
+
+  // The spheres are only computed once for all the trajectories.
+  EXPECT_CALL(ephemeris_, bodies()).WillOnce(ReturnRef(bodies_));
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  Planetarium planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_);
+  std::vector<Planetarium::TrajectoryToPlot> const trajectories = {
+      {discrete_trajectory1->Begin(),
+       discrete_trajectory1->End(),
+       /*reverse=*/false},
+      {discrete_trajectory2->Begin(),
+       discrete_trajectory2->End(),
+       /*reverse=*/true},
+      {discrete_trajectory1->End(),
+       discrete_trajectory1->End(),
+       /*reverse=*/false}};
+  Instant const now = t0_ + 10 * Second;
+
+  std::vector<RP2Lines<Length, Camera>> expected_rp2_lines;
+  for (auto const& trajectory : trajectories) {
+    expected_rp2_lines.push_back(planetarium.PlotMethod2(
+        trajectory.begin, trajectory.end, now, trajectory.reverse));
+  }
+
+  EXPECT_EQ(expected_rp2_lines,
+            planetarium.PlotMethod2(trajectories, now, /*scheduler=*/nullptr));
+  WorkStealingScheduler scheduler(/*pool_size=*/2);
+  EXPECT_EQ(expected_rp2_lines,
+            planetarium.PlotMethod2(trajectories, now, &scheduler));
+}
+
+TEST_F(PlanetariumTest, PlotMethod2Incremental) {
+  int evaluations = 0;
+  EXPECT_CALL(plotting_frame_, ToThisFrameAtTime(_))
+      .WillRepeatedly(DoAll(InvokeWithoutArgs([&evaluations]() {
+                              ++evaluations;
+                            }),
+                            Return(RigidMotion<Barycentric, Navigation>(
+                                RigidTransformation<Barycentric,
+                                                    Navigation>::Identity(),
+                                AngularVelocity<Barycentric>(),
+                                Velocity<Barycentric>()))));
+
+  // Part of a circular trajectory around the origin, the first 25'000 s of
+  // which are plotted before the rest is appended.
+  auto const full_trajectory =
+      NewCircularTrajectory(/*period=*/100'000 * Second,
+                            /*step=*/10 * Second,
+                            /*last=*/30'000 * Second);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  Planetarium planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_);
+  Instant const now = t0_ + 10 * Second;
+
+  for (bool const reverse : {false, true}) {
+    Planetarium::PlottingCache cache;
+    auto const growing_trajectory =
+        NewCircularTrajectory(/*period=*/100'000 * Second,
+                              /*step=*/10 * Second,
+                              /*last=*/25'000 * Second);
+    auto const rp2_lines_before = planetarium.PlotMethod2(
+        growing_trajectory->Begin(), growing_trajectory->End(),
+        /*stable_time=*/growing_trajectory->t_max(), /*version=*/0,
+        now, reverse, cache);
+    auto const expected_rp2_lines_before = planetarium.PlotMethod2(
+        growing_trajectory->Begin(), growing_trajectory->End(),
+        now, reverse);
+    EXPECT_THAT(rp2_lines_before, SizeIs(1));
+    EXPECT_EQ(expected_rp2_lines_before.front().front(),
+              rp2_lines_before.front().front());
+    EXPECT_EQ(expected_rp2_lines_before.back().back(),
+              rp2_lines_before.back().back());
+
+    Instant const last_time = growing_trajectory->last().time();
+    for (auto it = full_trajectory->LowerBound(last_time);
+         it != full_trajectory->End();
+         ++it) {
+      if (it.time() > last_time) {
+        growing_trajectory->Append(it.time(), it.degrees_of_freedom());
+      }
+    }
+
+    evaluations = 0;
+    auto const expected_rp2_lines_after = planetarium.PlotMethod2(
+        growing_trajectory->Begin(), growing_trajectory->End(),
+        now, reverse);
+    int const uncached_evaluations = evaluations;
+
+    evaluations = 0;
+    auto const rp2_lines_after = planetarium.PlotMethod2(
+        growing_trajectory->Begin(), growing_trajectory->End(),
+        /*stable_time=*/growing_trajectory->t_max(), /*version=*/0,
+        now, reverse, cache);
+    int const cached_evaluations = evaluations;
+
+    // The cached part is not replotted.
+    EXPECT_LT(2 * cached_evaluations, uncached_evaluations);
+    EXPECT_THAT(rp2_lines_after, SizeIs(1));
+    EXPECT_EQ(expected_rp2_lines_after.front().front(),
+              rp2_lines_after.front().front());
+    EXPECT_EQ(expected_rp2_lines_after.back().back(),
+              rp2_lines_after.back().back());
+    for (auto const& rp2_point : rp2_lines_after[0]) {
+      EXPECT_THAT(rp2_point.y(), VanishesBefore(1 * Metre, 0, 14));
+    }
+
+    // A new version of the trajectory is plotted entirely.
+    evaluations = 0;
+    planetarium.PlotMethod2(
+        growing_trajectory->Begin(), growing_trajectory->End(),
+        /*stable_time=*/growing_trajectory->t_max(), /*version=*/1,
+        now, reverse, cache);
+    EXPECT_LE(uncached_evaluations, evaluations);
+
+    // A camera that moved plots the entire trajectory.
+    Planetarium moved_planetarium(
+        parameters,
+        Perspective<Navigation, Camera>(
+            RigidTransformation<Navigation, Camera>(
+                Navigation::origin + Displacement<Navigation>(
+                                         {0 * Metre, 30 * Metre, 0 * Metre}),
+                Camera::origin,
+                Rotation<Navigation, Camera>(
+                    Vector<double, Navigation>({1, 0, 0}),
+                    Vector<double, Navigation>({0, 0, 1}),
+                    Bivector<double, Navigation>({0, -1, 0})).Forget()),
+            /*focal=*/5 * Metre),
+        &ephemeris_,
+        &plotting_frame_);
+    evaluations = 0;
+    moved_planetarium.PlotMethod2(
+        growing_trajectory->Begin(), growing_trajectory->End(),
+        /*stable_time=*/growing_trajectory->t_max(), /*version=*/1,
+        now, reverse, cache);
+    EXPECT_LE(uncached_evaluations, evaluations);
+  }
+}
+
 #if !defined(_DEBUG)
 TEST_F(PlanetariumTest, RealSolarSystem) {
   auto discrete_trajectory = DiscreteTrajectory<Barycentric>::ReadFromMessage(
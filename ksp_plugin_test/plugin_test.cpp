@@ -28,10 +28,12 @@
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 #include "ksp_plugin/integrators.hpp"
 #include "physics/continuous_trajectory.hpp"
+#include "physics/discrete_trajectory.hpp"
 #include "physics/kepler_orbit.hpp"
 #include "physics/massive_body.hpp"
 #include "physics/mock_dynamic_frame.hpp"
 #include "physics/mock_ephemeris.hpp"
+#include "physics/shared_dynamic_frame.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
 #include "testing_utilities/almost_equals.hpp"
@@ -66,6 +68,7 @@ using integrators::MockFixedStepSizeIntegrator;
 using integrators::SymmetricLinearMultistepIntegrator;
 using integrators::methods::QuinlanTremaine1990Order12;
 using physics::ContinuousTrajectory;
+using physics::DiscreteTrajectory;
 using physics::Ephemeris;
 using physics::KeplerianElements;
 using physics::KeplerOrbit;
@@ -73,6 +76,7 @@ using physics::MassiveBody;
 using physics::MockDynamicFrame;
 using physics::MockEphemeris;
 using physics::RigidMotion;
+using physics::SharedDynamicFrame;
 using physics::SolarSystem;
 using quantities::Abs;
 using quantities::Acceleration;
@@ -114,6 +118,7 @@ using ::testing::Eq;
 using ::testing::Ge;
 using ::testing::Gt;
 using ::testing::InSequence;
+using ::testing::IsEmpty;
 using ::testing::Le;
 using ::testing::Lt;
 using ::testing::Ref;
@@ -439,10 +444,14 @@ TEST_F(PluginTest, Serialization) {
   EXPECT_TRUE(message.vessel(0).vessel().has_flight_plan());
   EXPECT_TRUE(message.vessel(0).vessel().has_history());
   auto const& vessel_0_history = message.vessel(0).vessel().history();
-  EXPECT_EQ(4, vessel_0_history.timeline_size());
-  Instant const t0 =
-      Instant() +
-      vessel_0_history.timeline(0).instant().scalar().magnitude() * Second;
+  EXPECT_EQ(0, vessel_0_history.timeline_size());
+  EXPECT_TRUE(vessel_0_history.has_packed_timeline());
+  DiscreteTrajectory<Barycentric>* psychohistory = nullptr;
+  DiscreteTrajectory<Barycentric>* prediction = nullptr;
+  auto const history = DiscreteTrajectory<Barycentric>::ReadFromMessage(
+      vessel_0_history, /*forks=*/{&psychohistory, &prediction});
+  EXPECT_EQ(4, history->Size());
+  Instant const t0 = history->Begin().time();
   EXPECT_THAT(t0,
               AllOf(Gt(HistoryTime(time, 3) - step), Le(HistoryTime(time, 3))));
   EXPECT_TRUE(message.has_renderer());
@@ -909,6 +918,153 @@ TEST_F(PluginTest, ForgetAllHistoriesBeforeAfterPredictionFork) {
           plugin_->PlanetariumRotation());
 }
 
+TEST_F(PluginTest, SleepingVessel) {
+  GUID const guid = "Test Satellite";
+  PartId const part_id = 666;
+  auto const dof = DegreesOfFreedom<Barycentric>(Barycentric::origin,
+                                                 Velocity<Barycentric>());
+
+  InsertAllSolarSystemBodies();
+  plugin_->EndInitialization();
+
+  std::vector<not_null<DiscreteTrajectory<Barycentric>*>> trajectories = {
+      make_not_null<DiscreteTrajectory<Barycentric>*>()};
+  auto instance = make_not_null_unique<MockFixedStepSizeIntegrator<
+      Ephemeris<Barycentric>::NewtonianMotionEquation>::MockInstance>();
+  EXPECT_CALL(plugin_->mock_ephemeris(), NewInstance(_, _, _))
+      .WillOnce(DoAll(SaveArg<0>(&trajectories),
+                      Return(ByMove(std::move(instance)))));
+  EXPECT_CALL(plugin_->mock_ephemeris(), t_max())
+      .WillRepeatedly(Return(Instant() + 12 * Hour));
+  EXPECT_CALL(plugin_->mock_ephemeris(), empty()).WillRepeatedly(Return(false));
+  EXPECT_CALL(plugin_->mock_ephemeris(), Prolong(_)).Times(AnyNumber());
+  EXPECT_CALL(plugin_->mock_ephemeris(), FlowWithAdaptiveStep(_, _, _, _, _, _))
+      .WillRepeatedly(DoAll(AppendToDiscreteTrajectory(dof),
+                            Return(Status(Error::DEADLINE_EXCEEDED, ""))));
+  EXPECT_CALL(plugin_->mock_ephemeris(), FlowWithFixedStep(_, _))
+      .WillRepeatedly(DoAll(AppendToDiscreteTrajectory2(&trajectories[0], dof),
+                            Return(Status::OK)));
+
+  bool inserted;
+  plugin_->InsertOrKeepVessel(guid,
+                              "v" + guid,
+                              SolarSystemFactory::Earth,
+                              /*loaded=*/false,
+                              inserted);
+  plugin_->InsertUnloadedPart(
+      part_id,
+      "part",
+      guid,
+      RelativeDegreesOfFreedom<AliceSun>(satellite_initial_displacement_,
+                                         satellite_initial_velocity_));
+  plugin_->PrepareToReportCollisions();
+  plugin_->FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+
+  Instant const initial_time = ParseTT(initial_time_);
+  Instant const& time = initial_time + 1 * Second;
+  plugin_->AdvanceTime(time, Angle());
+  VesselSet collided_vessels;
+  plugin_->CatchUpLaggingVessels(collided_vessels);
+  EXPECT_EQ(time, plugin_->GetVessel(guid)->psychohistory().last().time());
+
+  // A sleeping vessel is left behind.
+  plugin_->PutVesselToSleep(guid);
+  plugin_->InsertOrKeepVessel(guid,
+                              "v" + guid,
+                              SolarSystemFactory::Earth,
+                              /*loaded=*/false,
+                              inserted);
+  plugin_->AdvanceTime(HistoryTime(time, 3), Angle());
+  plugin_->CatchUpLaggingVessels(collided_vessels);
+  EXPECT_EQ(time, plugin_->GetVessel(guid)->psychohistory().last().time());
+
+  // Catching it up wakes it up.
+  auto future = plugin_->CatchUpVessel(guid);
+  plugin_->WaitForVesselToCatchUp(*future, collided_vessels);
+  EXPECT_EQ(HistoryTime(time, 3),
+            plugin_->GetVessel(guid)->psychohistory().last().time());
+  plugin_->InsertOrKeepVessel(guid,
+                              "v" + guid,
+                              SolarSystemFactory::Earth,
+                              /*loaded=*/false,
+                              inserted);
+  plugin_->AdvanceTime(HistoryTime(time, 6), Angle());
+  plugin_->CatchUpLaggingVessels(collided_vessels);
+  EXPECT_EQ(HistoryTime(time, 6),
+            plugin_->GetVessel(guid)->psychohistory().last().time());
+  EXPECT_THAT(collided_vessels, IsEmpty());
+}
+
+TEST_F(PluginTest, ForgetAllHistoriesBeforeSleepingVessel) {
+  GUID const guid = "Test Satellite";
+  PartId const part_id = 666;
+  auto const dof = DegreesOfFreedom<Barycentric>(Barycentric::origin,
+                                                 Velocity<Barycentric>());
+
+  InsertAllSolarSystemBodies();
+  plugin_->EndInitialization();
+
+  std::vector<not_null<DiscreteTrajectory<Barycentric>*>> trajectories = {
+      make_not_null<DiscreteTrajectory<Barycentric>*>()};
+  auto instance = make_not_null_unique<MockFixedStepSizeIntegrator<
+      Ephemeris<Barycentric>::NewtonianMotionEquation>::MockInstance>();
+  EXPECT_CALL(plugin_->mock_ephemeris(), NewInstance(_, _, _))
+      .WillOnce(DoAll(SaveArg<0>(&trajectories),
+                      Return(ByMove(std::move(instance)))));
+  EXPECT_CALL(plugin_->mock_ephemeris(), t_max())
+      .WillRepeatedly(Return(Instant() + 12 * Hour));
+  EXPECT_CALL(plugin_->mock_ephemeris(), empty()).WillRepeatedly(Return(false));
+  EXPECT_CALL(plugin_->mock_ephemeris(), Prolong(_)).Times(AnyNumber());
+  EXPECT_CALL(plugin_->mock_ephemeris(), FlowWithAdaptiveStep(_, _, _, _, _, _))
+      .WillRepeatedly(DoAll(AppendToDiscreteTrajectory(dof),
+                            Return(Status(Error::DEADLINE_EXCEEDED, ""))));
+  EXPECT_CALL(plugin_->mock_ephemeris(), FlowWithFixedStep(_, _))
+      .WillRepeatedly(DoAll(AppendToDiscreteTrajectory2(&trajectories[0], dof),
+                            Return(Status::OK)));
+
+  bool inserted;
+  plugin_->InsertOrKeepVessel(guid,
+                              "v" + guid,
+                              SolarSystemFactory::Earth,
+                              /*loaded=*/false,
+                              inserted);
+  plugin_->InsertUnloadedPart(
+      part_id,
+      "part",
+      guid,
+      RelativeDegreesOfFreedom<AliceSun>(satellite_initial_displacement_,
+                                         satellite_initial_velocity_));
+  plugin_->PrepareToReportCollisions();
+  plugin_->FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+
+  Instant const initial_time = ParseTT(initial_time_);
+  Instant const& time = initial_time + 1 * Second;
+  plugin_->AdvanceTime(time, Angle());
+  VesselSet collided_vessels;
+  plugin_->CatchUpLaggingVessels(collided_vessels);
+
+  plugin_->PutVesselToSleep(guid);
+  plugin_->InsertOrKeepVessel(guid,
+                              "v" + guid,
+                              SolarSystemFactory::Earth,
+                              /*loaded=*/false,
+                              inserted);
+  plugin_->AdvanceTime(HistoryTime(time, 6), Angle());
+  plugin_->CatchUpLaggingVessels(collided_vessels);
+  EXPECT_EQ(time, plugin_->GetVessel(guid)->psychohistory().last().time());
+
+  // The ephemeris keeps the part of its history that the sleeping vessel needs
+  // to be caught up.
+  EXPECT_CALL(plugin_->mock_ephemeris(), ForgetBefore(time));
+  plugin_->ForgetAllHistoriesBefore(HistoryTime(time, 3));
+
+  auto future = plugin_->CatchUpVessel(guid);
+  plugin_->WaitForVesselToCatchUp(*future, collided_vessels);
+  EXPECT_EQ(HistoryTime(time, 6),
+            plugin_->GetVessel(guid)->psychohistory().last().time());
+  EXPECT_THAT(collided_vessels, IsEmpty());
+}
+
 TEST_F(PluginDeathTest, VesselFromParentError) {
   GUID const guid = "Test Satellite";
   EXPECT_DEATH({
@@ -981,6 +1137,45 @@ TEST_F(PluginTest, VesselInsertionAtInitialization) {
                     AlmostEquals(satellite_initial_velocity_, 6)));
 }
 
+TEST_F(PluginTest, VesselHandles) {
+  GUID const guid = "Test Satellite";
+  PartId const part_id = 666;
+  InsertAllSolarSystemBodies();
+  plugin_->EndInitialization();
+  bool inserted;
+  plugin_->InsertOrKeepVessel(guid,
+                              "v" + guid,
+                              SolarSystemFactory::Earth,
+                              /*loaded=*/false,
+                              inserted);
+  Instant const initial_time = ParseTT(initial_time_);
+  EXPECT_CALL(plugin_->mock_ephemeris(), Prolong(initial_time))
+      .Times(AnyNumber());
+  plugin_->InsertUnloadedPart(
+      part_id,
+      "part",
+      guid,
+      RelativeDegreesOfFreedom<AliceSun>(satellite_initial_displacement_,
+                                         satellite_initial_velocity_));
+  plugin_->PrepareToReportCollisions();
+  plugin_->FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+
+  VesselHandle const handle = plugin_->GetVesselHandle(guid);
+  EXPECT_EQ(handle, plugin_->GetVesselHandle(guid));
+  EXPECT_TRUE(plugin_->HasVesselWithHandle(handle));
+  EXPECT_FALSE(plugin_->HasVesselWithHandle(handle + 1));
+  EXPECT_EQ(plugin_->GetVessel(guid), plugin_->GetVesselWithHandle(handle));
+  EXPECT_EQ(plugin_->VesselFromParent(SolarSystemFactory::Earth, guid),
+            plugin_->VesselFromParent(SolarSystemFactory::Earth,
+                                      *plugin_->GetVesselWithHandle(handle)));
+
+  // The handle is invalidated when the vessel is removed.
+  plugin_->PrepareToReportCollisions();
+  plugin_->FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+  EXPECT_FALSE(plugin_->HasVessel(guid));
+  EXPECT_FALSE(plugin_->HasVesselWithHandle(handle));
+}
+
 TEST_F(PluginTest, UpdateCelestialHierarchy) {
   InsertAllSolarSystemBodies();
   plugin_->EndInitialization();
@@ -1063,6 +1258,46 @@ TEST_F(PluginTest, Navball) {
       VanishesBefore(1, 4));
 }
 
+TEST_F(PluginTest, SharedNavigationFrames) {
+  InsertAllSolarSystemBodies();
+  plugin_->EndInitialization();
+
+  auto const frame_of = [](NavigationFrame const& navigation_frame) {
+    return &dynamic_cast<SharedDynamicFrame<Barycentric, Navigation> const&>(
+                navigation_frame).frame();
+  };
+
+  auto const earth_centred1 = plugin_->NewBodyCentredNonRotatingNavigationFrame(
+      SolarSystemFactory::Earth);
+  auto const earth_centred2 = plugin_->NewBodyCentredNonRotatingNavigationFrame(
+      SolarSystemFactory::Earth);
+  auto const moon_centred = plugin_->NewBodyCentredNonRotatingNavigationFrame(
+      SolarSystemFactory::Moon);
+  auto const earth_surface =
+      plugin_->NewBodySurfaceNavigationFrame(SolarSystemFactory::Earth);
+  auto const earth_moon1 = plugin_->NewBarycentricRotatingNavigationFrame(
+      SolarSystemFactory::Earth, SolarSystemFactory::Moon);
+  auto const earth_moon2 = plugin_->NewBarycentricRotatingNavigationFrame(
+      SolarSystemFactory::Earth, SolarSystemFactory::Moon);
+  auto const moon_earth = plugin_->NewBarycentricRotatingNavigationFrame(
+      SolarSystemFactory::Moon, SolarSystemFactory::Earth);
+
+  // Each call returns a distinct frame, but equal calls share the underlying
+  // frame.
+  EXPECT_NE(earth_centred1.get(), earth_centred2.get());
+  EXPECT_EQ(frame_of(*earth_centred1), frame_of(*earth_centred2));
+  EXPECT_NE(frame_of(*earth_centred1), frame_of(*moon_centred));
+  EXPECT_NE(frame_of(*earth_centred1), frame_of(*earth_surface));
+  EXPECT_EQ(frame_of(*earth_moon1), frame_of(*earth_moon2));
+  EXPECT_NE(frame_of(*earth_moon1), frame_of(*moon_earth));
+
+  // The shared frame serializes as the underlying frame.
+  serialization::DynamicFrame message;
+  earth_centred1->WriteToMessage(&message);
+  EXPECT_TRUE(message.HasExtension(
+      serialization::BodyCentredNonRotatingDynamicFrame::extension));
+}
+
 TEST_F(PluginTest, NavballTargetVessel) {
   GUID const guid = "Target Vessel";
   PartId const part_id = 666;
@@ -1110,6 +1345,57 @@ TEST_F(PluginTest, NavballTargetVessel) {
   plugin.NavballFrameField(World::origin)->FromThisFrame(World::origin);
 }
 
+TEST_F(PluginTest, VesselParents) {
+  Plugin plugin(initial_time_,
+                initial_time_,
+                0 * Radian);
+  for (int const index : {SolarSystemFactory::Sun, SolarSystemFactory::Earth}) {
+    std::string const name = SolarSystemFactory::name(index);
+    plugin.InsertCelestialAbsoluteCartesian(
+        index,
+        index == SolarSystemFactory::Sun
+            ? std::nullopt
+            : std::make_optional<Index>(SolarSystemFactory::Sun),
+        solar_system_->gravity_model_message(name),
+        solar_system_->cartesian_initial_state_message(name));
+  }
+  plugin.EndInitialization();
+
+  // A satellite in low Earth orbit, inserted with the Sun as its parent.
+  RelativeDegreesOfFreedom<AliceSun> const earth_from_sun =
+      plugin.CelestialFromParent(SolarSystemFactory::Earth);
+  GUID const satellite = "satellite";
+  PartId const part_id = 42;
+  bool inserted;
+  plugin.InsertOrKeepVessel(satellite,
+                            "v" + satellite,
+                            SolarSystemFactory::Sun,
+                            /*loaded=*/false,
+                            inserted);
+  plugin.InsertUnloadedPart(
+      part_id,
+      "part",
+      satellite,
+      RelativeDegreesOfFreedom<AliceSun>(
+          earth_from_sun.displacement() + satellite_initial_displacement_,
+          earth_from_sun.velocity() + satellite_initial_velocity_));
+  plugin.PrepareToReportCollisions();
+  plugin.FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+  EXPECT_THAT(plugin.VesselStates({satellite}).front().parent_index,
+              Eq(SolarSystemFactory::Sun));
+
+  // The plugin finds that it is in the sphere of influence of the Earth.
+  plugin.AdvanceTime(ParseTT(initial_time_) + 1 * Second, Angle());
+  VesselSet collided_vessels;
+  plugin.CatchUpLaggingVessels(collided_vessels);
+  EXPECT_THAT(collided_vessels, IsEmpty());
+  std::vector<Plugin::VesselState> const states =
+      plugin.VesselStates({satellite});
+  EXPECT_THAT(states.front().parent_index, Eq(SolarSystemFactory::Earth));
+  EXPECT_THAT(states.front().from_parent.displacement().Norm(),
+              AllOf(Gt(6000 * Kilo(Metre)), Lt(7000 * Kilo(Metre))));
+}
+
 TEST_F(PluginTest, Frenet) {
   // Create a plugin with planetarium rotation 0.
   Plugin plugin(initial_time_,
@@ -0,0 +1,91 @@
+﻿
+#include "ksp_plugin/render_snapshot.hpp"
+
+#include <memory>
+
+#include "astronomy/epoch.hpp"
+#include "base/not_null.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "ksp_plugin/frames.hpp"
+#include "ksp_plugin_test/mock_vessel.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_render_snapshot {
+
+using astronomy::J2000;
+using base::make_not_null_unique;
+using geometry::Displacement;
+using geometry::Velocity;
+using physics::DegreesOfFreedom;
+using quantities::si::Metre;
+using quantities::si::Second;
+using ::testing::ElementsAre;
+using ::testing::Return;
+using ::testing::ReturnRef;
+using ::testing::UnorderedElementsAre;
+
+class RenderSnapshotTest : public testing::Test {
+ protected:
+  RenderSnapshotTest()
+      : psychohistory_(
+            make_not_null_unique<DiscreteTrajectory<Barycentric>>()) {
+    for (int i = 0; i < 3; ++i) {
+      psychohistory_->Append(J2000 + i * Second, DegreesOfFreedomAt(i));
+    }
+    prediction_ = psychohistory_->NewForkAtLast();
+    for (int i = 3; i < 1000; ++i) {
+      prediction_->Append(J2000 + i * Second, DegreesOfFreedomAt(i));
+    }
+    EXPECT_CALL(vessel_, prediction()).WillRepeatedly(ReturnRef(*prediction_));
+    EXPECT_CALL(vessel_, has_flight_plan()).WillRepeatedly(Return(false));
+  }
+
+  static DegreesOfFreedom<Barycentric> DegreesOfFreedomAt(int const i) {
+    return {Barycentric::origin +
+                Displacement<Barycentric>({i * Metre, 0 * Metre, 0 * Metre}),
+            Velocity<Barycentric>()};
+  }
+
+  not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> psychohistory_;
+  DiscreteTrajectory<Barycentric>* prediction_;
+  MockVessel vessel_;
+};
+
+TEST_F(RenderSnapshotTest, SharedPrediction) {
+  RenderSnapshot const snapshot(J2000, {&vessel_});
+  EXPECT_TRUE(snapshot.has_vessel(vessel_.guid()));
+  EXPECT_EQ(0, snapshot.number_of_flight_plan_segments(vessel_.guid()));
+
+  auto const& prediction = snapshot.prediction(vessel_.guid());
+  EXPECT_EQ(998, prediction.Size());
+  EXPECT_EQ(J2000 + 2 * Second, prediction.Begin().time());
+  EXPECT_EQ(J2000 + 999 * Second, prediction.last().time());
+  // The points after the fork are not copied.
+  EXPECT_EQ(&prediction.last().degrees_of_freedom(),
+            &prediction_->last().degrees_of_freedom());
+
+  // Changing the prediction of the vessel doesn't change the snapshot.
+  prediction_->ForgetAfter(J2000 + 500 * Second);
+  prediction_->Append(J2000 + 500.5 * Second, DegreesOfFreedomAt(-1));
+  EXPECT_EQ(998, prediction.Size());
+  EXPECT_EQ(J2000 + 999 * Second, prediction.last().time());
+  EXPECT_EQ(DegreesOfFreedomAt(500),
+            prediction.Find(J2000 + 500 * Second).degrees_of_freedom());
+}
+
+TEST_F(RenderSnapshotTest, PlottedVessels) {
+  RenderSnapshot const snapshot(J2000, {});
+  EXPECT_THAT(snapshot.plotted_vessels(), ElementsAre());
+  EXPECT_FALSE(snapshot.has_vessel(vessel_.guid()));
+  EXPECT_FALSE(snapshot.has_vessel("other"));
+  EXPECT_THAT(snapshot.plotted_vessels(),
+              UnorderedElementsAre(vessel_.guid(), "other"));
+}
+
+}  // namespace internal_render_snapshot
+}  // namespace ksp_plugin
+}  // namespace principia
@@ -4,6 +4,7 @@
 #include "base/not_null.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
+#include "geometry/rotation.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ksp_plugin_test/mock_celestial.hpp"
@@ -29,6 +30,7 @@ using geometry::Bivector;
 using geometry::DefinesFrame;
 using geometry::Displacement;
 using geometry::RigidTransformation;
+using geometry::Rotation;
 using geometry::Velocity;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
@@ -42,8 +44,11 @@ using quantities::si::Radian;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
 using testing_utilities::Componentwise;
+using ::testing::DoAll;
+using ::testing::InvokeWithoutArgs;
 using ::testing::Ref;
 using ::testing::Return;
+using ::testing::ReturnPointee;
 using ::testing::ReturnRef;
 using ::testing::_;
 
@@ -247,6 +252,83 @@ TEST_F(RendererTest, RenderBarycentricTrajectoryInPlottingWithTargetVessel) {
   }
 }
 
+TEST_F(RendererTest, RenderBarycentricTrajectoryInPlottingTargetCache) {
+  MockEphemeris<Barycentric> ephemeris;
+  MockContinuousTrajectory<Barycentric> celestial_trajectory;
+  EXPECT_CALL(ephemeris, trajectory(_))
+      .WillRepeatedly(Return(&celestial_trajectory));
+
+  DiscreteTrajectory<Barycentric> trajectory_to_render;
+  FillTrajectory<Barycentric>(
+      /*time=*/t0_,
+      /*step=*/1 * Second,
+      /*number_of_steps=*/5,
+      /*position_function=*/
+          [this](Instant const& t) {
+            return Barycentric::origin +
+                   (t - t0_) * Velocity<Barycentric>({6 * Metre / Second,
+                                                      5 * Metre / Second,
+                                                      4 * Metre / Second});
+          },
+      /*velocity_function=*/
+          [](Instant const& t) {
+            return Velocity<Barycentric>(
+                {6 * Metre / Second, 5 * Metre / Second, 4 * Metre / Second});
+          },
+      trajectory_to_render);
+
+  MockVessel vessel;
+  DiscreteTrajectory<Barycentric> vessel_trajectory;
+  FillTrajectory<Barycentric>(
+      /*time=*/t0_,
+      /*step=*/1 * Second,
+      /*number_of_steps=*/5,
+      /*position_function=*/
+      [this](Instant const& t) {
+        return Barycentric::origin +
+               (t - t0_) * Velocity<Barycentric>({1 * Metre / Second,
+                                                  2 * Metre / Second,
+                                                  3 * Metre / Second});
+      },
+      /*velocity_function=*/
+      [](Instant const& t) {
+        return Velocity<Barycentric>(
+            {1 * Metre / Second, 2 * Metre / Second, 3 * Metre / Second});
+      },
+      vessel_trajectory);
+  EXPECT_CALL(vessel, prediction())
+      .WillRepeatedly(ReturnRef(vessel_trajectory));
+  std::int64_t prediction_version = 0;
+  EXPECT_CALL(vessel, prediction_version())
+      .WillRepeatedly(ReturnPointee(&prediction_version));
+
+  DegreesOfFreedom<Barycentric> const celestial_degrees_of_freedom(
+      Barycentric::origin +
+          Displacement<Barycentric>({300 * Metre, 200 * Metre, 100 * Metre}),
+      Velocity<Barycentric>());
+  // The target frame is evaluated at every time by the first rendering.  The
+  // second rendering reuses the motions after the second point of the
+  // prediction.  The prediction changes before the third rendering, which
+  // evaluates the target frame at every time again.
+  for (Instant t = t0_; t < t0_ + 5 * Second; t += 1 * Second) {
+    EXPECT_CALL(celestial_trajectory, EvaluateDegreesOfFreedom(t))
+        .Times(t <= t0_ + 1 * Second ? 3 : 2)
+        .WillRepeatedly(Return(celestial_degrees_of_freedom));
+  }
+
+  renderer_.SetTargetVessel(&vessel, &celestial_, &ephemeris);
+  for (int i = 0; i < 3; ++i) {
+    if (i == 2) {
+      ++prediction_version;
+    }
+    auto const rendered_trajectory =
+        renderer_.RenderBarycentricTrajectoryInPlotting(
+            trajectory_to_render.Begin(),
+            trajectory_to_render.End());
+    EXPECT_EQ(5, rendered_trajectory->Size());
+  }
+}
+
 TEST_F(RendererTest, RenderPlottingTrajectoryInWorldWithoutTargetVessel) {
   DiscreteTrajectory<Navigation> trajectory_to_render;
   FillTrajectory<Navigation>(
@@ -275,11 +357,11 @@ TEST_F(RendererTest, RenderPlottingTrajectoryInWorldWithoutTargetVessel) {
       1 * Radian,
       Bivector<double, Barycentric>({1.0, 1.1, 1.2}),
       DefinesFrame<AliceSun>{});
-  RigidMotion<Navigation, Barycentric> rigid_motion(
-      RigidTransformation<Navigation, Barycentric>::Identity(),
-      AngularVelocity<Navigation>(),
-      Velocity<Navigation>());
-  EXPECT_CALL(*dynamic_frame_, FromThisFrameAtTime(rendering_time))
+  RigidMotion<Barycentric, Navigation> rigid_motion(
+      RigidTransformation<Barycentric, Navigation>::Identity(),
+      AngularVelocity<Barycentric>(),
+      Velocity<Barycentric>());
+  EXPECT_CALL(*dynamic_frame_, ToThisFrameAtTime(rendering_time))
       .WillOnce(Return(rigid_motion));
   EXPECT_CALL(celestial_, current_position(rendering_time))
       .WillOnce(Return(Barycentric::origin));
@@ -307,6 +389,112 @@ TEST_F(RendererTest, RenderPlottingTrajectoryInWorldWithoutTargetVessel) {
   }
 }
 
+TEST_F(RendererTest, RenderPlottingTrajectoryInWorldInBuffer) {
+  DiscreteTrajectory<Navigation> trajectory_to_render;
+  FillTrajectory<Navigation>(
+      /*time=*/t0_,
+      /*step=*/1 * Second,
+      /*number_of_steps=*/10,
+      /*position_function=*/
+          [this](Instant const& t) {
+            return Navigation::origin +
+                   (t - t0_) * Velocity<Navigation>({6 * Metre / Second,
+                                                     5 * Metre / Second,
+                                                     4 * Metre / Second});
+          },
+      /*velocity_function=*/
+          [](Instant const& t) {
+            return Velocity<Navigation>(
+                {6 * Metre / Second, 5 * Metre / Second, 4 * Metre / Second});
+          },
+      trajectory_to_render);
+
+  Instant const rendering_time = t0_ + 5 * Second;
+  Position<World> const sun_world_position =
+      World::origin +
+      Displacement<World>({300 * Metre, 200 * Metre, 100 * Metre});
+  Rotation<Barycentric, AliceSun> const planetarium_rotation(
+      1 * Radian,
+      Bivector<double, Barycentric>({1.0, 1.1, 1.2}),
+      DefinesFrame<AliceSun>{});
+  RigidMotion<Barycentric, Navigation> rigid_motion(
+      RigidTransformation<Barycentric, Navigation>::Identity(),
+      AngularVelocity<Barycentric>(),
+      Velocity<Barycentric>());
+  EXPECT_CALL(*dynamic_frame_, ToThisFrameAtTime(rendering_time))
+      .WillOnce(Return(rigid_motion));
+  EXPECT_CALL(celestial_, current_position(rendering_time))
+      .WillRepeatedly(Return(Barycentric::origin));
+
+  auto const rendered_trajectory =
+      renderer_.RenderPlottingTrajectoryInWorld(rendering_time,
+                                                trajectory_to_render.Begin(),
+                                                trajectory_to_render.End(),
+                                                sun_world_position,
+                                                planetarium_rotation);
+
+  // The buffer is cleared, and its capacity is reused when it is rendered into
+  // again.
+  RenderedTrajectory<World> buffer = {
+      {t0_, DegreesOfFreedom<World>(World::origin, Velocity<World>())}};
+  for (int i = 0; i < 2; ++i) {
+    renderer_.RenderPlottingTrajectoryInWorld(rendering_time,
+                                              trajectory_to_render.Begin(),
+                                              trajectory_to_render.End(),
+                                              sun_world_position,
+                                              planetarium_rotation,
+                                              buffer);
+    ASSERT_EQ(10, buffer.size());
+    auto it = rendered_trajectory->Begin();
+    for (auto const& [t, degrees_of_freedom] : buffer) {
+      EXPECT_EQ(it.time(), t);
+      EXPECT_THAT(degrees_of_freedom.position(),
+                  AlmostEquals(it.degrees_of_freedom().position(), 0, 2));
+      EXPECT_THAT(degrees_of_freedom.velocity(),
+                  AlmostEquals(it.degrees_of_freedom().velocity(), 0));
+      ++it;
+    }
+  }
+  auto const* const data = buffer.data();
+  renderer_.RenderPlottingTrajectoryInWorld(rendering_time,
+                                            trajectory_to_render.Begin(),
+                                            trajectory_to_render.End(),
+                                            sun_world_position,
+                                            planetarium_rotation,
+                                            buffer);
+  EXPECT_EQ(data, buffer.data());
+}
+
+TEST_F(RendererTest, PlottingCache) {
+  Instant const rendering_time = t0_ + 5 * Second;
+  Position<World> const sun_world_position = World::origin;
+  Rotation<Barycentric, AliceSun> const planetarium_rotation(
+      1 * Radian,
+      Bivector<double, Barycentric>({1.0, 1.1, 1.2}),
+      DefinesFrame<AliceSun>{});
+  RigidMotion<Barycentric, Navigation> rigid_motion(
+      RigidTransformation<Barycentric, Navigation>::Identity(),
+      AngularVelocity<Barycentric>(),
+      Velocity<Barycentric>());
+  EXPECT_CALL(celestial_, current_position(rendering_time))
+      .WillRepeatedly(Return(Barycentric::origin));
+
+  // The plotting frame is evaluated once for all the transforms at the same
+  // time.
+  EXPECT_CALL(*dynamic_frame_, ToThisFrameAtTime(rendering_time))
+      .WillOnce(Return(rigid_motion));
+  renderer_.PlottingToBarycentric(rendering_time);
+  renderer_.PlottingToWorld(rendering_time, planetarium_rotation);
+  renderer_.WorldToPlotting(rendering_time,
+                            sun_world_position,
+                            planetarium_rotation);
+
+  // A different time evaluates it again.
+  EXPECT_CALL(*dynamic_frame_, ToThisFrameAtTime(rendering_time + 1 * Second))
+      .WillOnce(Return(rigid_motion));
+  renderer_.PlottingToBarycentric(rendering_time + 1 * Second);
+}
+
 TEST_F(RendererTest, Serialization) {
   serialization::Renderer message;
   EXPECT_CALL(*dynamic_frame_, WriteToMessage(_));
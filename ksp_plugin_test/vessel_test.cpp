@@ -1,12 +1,16 @@
 ﻿
 #include "ksp_plugin/vessel.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <limits>
+#include <memory>
 #include <set>
 
 #include "astronomy/epoch.hpp"
 #include "base/not_null.hpp"
 #include "base/status.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ksp_plugin/celestial.hpp"
@@ -25,12 +29,14 @@ namespace internal_vessel {
 
 using base::make_not_null_unique;
 using base::Status;
+using base::WorkStealingScheduler;
 using geometry::Displacement;
 using geometry::Position;
 using geometry::Velocity;
 using physics::MassiveBody;
 using physics::MockEphemeris;
 using physics::RotatingBody;
+using quantities::Time;
 using quantities::si::Degree;
 using quantities::si::Kilogram;
 using quantities::si::Metre;
@@ -41,7 +47,9 @@ using testing_utilities::Componentwise;
 using testing_utilities::EqualsProto;
 using ::testing::DoAll;
 using ::testing::ElementsAre;
+using ::testing::Invoke;
 using ::testing::MockFunction;
+using ::testing::Property;
 using ::testing::Return;
 using ::testing::_;
 
@@ -214,6 +222,133 @@ TEST_F(VesselTest, AdvanceTime) {
                                       110.6 / 3.0 * Metre / Second}), 0)));
 }
 
+TEST_F(VesselTest, AdvanceTimeWithPileUpTail) {
+  vessel_.PrepareHistory(astronomy::J2000);
+
+  // The parts are offset from the pile-up by their initial degrees of freedom.
+  auto const pile_up_dof = [](double const x) {
+    return DegreesOfFreedom<Barycentric>(
+        Barycentric::origin + Displacement<Barycentric>(
+                                  {x * Metre, x * Metre, x * Metre}),
+        Velocity<Barycentric>({x * Metre / Second,
+                               x * Metre / Second,
+                               x * Metre / Second}));
+  };
+  auto const tail = std::make_shared<PileUpTail>();
+  tail->history.emplace_back(astronomy::J2000 + 0.5 * Second,
+                             pile_up_dof(0.1));
+  tail->history.emplace_back(astronomy::J2000 + 1.0 * Second,
+                             pile_up_dof(0.2));
+  tail->psychohistory.emplace_back(astronomy::J2000 + 1.5 * Second,
+                                   pile_up_dof(0.3));
+  DegreesOfFreedom<Barycentric> const origin(Barycentric::origin,
+                                             Velocity<Barycentric>());
+  p1_->AppendToHistories(tail, p1_dof_ - origin);
+  p2_->AppendToHistories(tail, p2_dof_ - origin);
+  EXPECT_EQ(tail.get(), p1_->pile_up_tail());
+  EXPECT_EQ(tail.get(), p2_->pile_up_tail());
+
+  vessel_.AdvanceTime();
+
+  EXPECT_EQ(nullptr, p1_->pile_up_tail());
+  EXPECT_EQ(nullptr, p2_->pile_up_tail());
+  EXPECT_EQ(4, vessel_.psychohistory().Size());
+  EXPECT_EQ(astronomy::J2000 + 1.0 * Second,
+            vessel_.psychohistory().Fork().time());
+  auto it = vessel_.psychohistory().Begin();
+  ++it;
+  EXPECT_EQ(astronomy::J2000 + 0.5 * Second, it.time());
+  EXPECT_THAT(it.degrees_of_freedom(),
+              Componentwise(AlmostEquals(Barycentric::origin +
+                                      Displacement<Barycentric>(
+                                          {13.3 / 3.0 * Metre,
+                                          4.1 * Metre,
+                                          11.3 / 3.0 * Metre}), 0, 4),
+                    AlmostEquals(Velocity<Barycentric>(
+                                      {130.3 / 3.0 * Metre / Second,
+                                      40.1 * Metre / Second,
+                                      110.3 / 3.0 * Metre / Second}), 0, 4)));
+  ++it;
+  ++it;
+  EXPECT_EQ(astronomy::J2000 + 1.5 * Second, it.time());
+  EXPECT_THAT(it.degrees_of_freedom(),
+              Componentwise(AlmostEquals(Barycentric::origin +
+                                      Displacement<Barycentric>(
+                                          {13.9 / 3.0 * Metre,
+                                          4.3 * Metre,
+                                          11.9 / 3.0 * Metre}), 0, 4),
+                    AlmostEquals(Velocity<Barycentric>(
+                                      {130.9 / 3.0 * Metre / Second,
+                                      40.3 * Metre / Second,
+                                      110.9 / 3.0 * Metre / Second}), 0, 4)));
+}
+
+TEST_F(VesselTest, ReusePrediction) {
+  vessel_.PrepareHistory(astronomy::J2000);
+
+  // A prediction in uniform motion, on which the centre of mass of the parts
+  // stays below.
+  auto const uniform_motion = [](Time const& t) {
+    return DegreesOfFreedom<Barycentric>(
+        Barycentric::origin + Displacement<Barycentric>(
+                                  {(13.0 + 130.0 * t / Second) / 3.0 * Metre,
+                                   (4.0 + 40.0 * t / Second) * Metre,
+                                   (11.0 + 110.0 * t / Second) / 3.0 * Metre}),
+        Velocity<Barycentric>({130.0 / 3.0 * Metre / Second,
+                               40.0 * Metre / Second,
+                               110.0 / 3.0 * Metre / Second}));
+  };
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _))
+      .WillOnce(DoAll(AppendToDiscreteTrajectory(astronomy::J2000 + 1 * Second,
+                                                 uniform_motion(1 * Second)),
+                      AppendToDiscreteTrajectory(astronomy::J2000 + 2 * Second,
+                                                 uniform_motion(2 * Second)),
+                      Return(Status::OK)));
+  vessel_.FlowPrediction(astronomy::J2000 + 2 * Second);
+  EXPECT_EQ(3, vessel_.prediction().Size());
+
+  // The parts coast along the prediction.
+  p1_->AppendToHistory(
+      astronomy::J2000 + 1 * Second,
+      DegreesOfFreedom<Barycentric>(
+          p1_dof_.position() + p1_dof_.velocity() * (1 * Second),
+          p1_dof_.velocity()));
+  p2_->AppendToHistory(
+      astronomy::J2000 + 1 * Second,
+      DegreesOfFreedom<Barycentric>(
+          p2_dof_.position() + p2_dof_.velocity() * (1 * Second),
+          p2_dof_.velocity()));
+  vessel_.AdvanceTime();
+
+  // The end of the prediction was kept without flowing it again.
+  EXPECT_EQ(astronomy::J2000 + 1 * Second,
+            vessel_.psychohistory().last().time());
+  EXPECT_EQ(3, vessel_.prediction().Size());
+  EXPECT_EQ(astronomy::J2000 + 2 * Second, vessel_.prediction().last().time());
+  EXPECT_THAT(vessel_.prediction().last().degrees_of_freedom(),
+              Componentwise(AlmostEquals(uniform_motion(2 * Second).position(),
+                                         0),
+                            AlmostEquals(uniform_motion(2 * Second).velocity(),
+                                         0)));
+
+  // The parts leave the prediction by more than the tolerance.
+  p1_->AppendToHistory(
+      astronomy::J2000 + 1.5 * Second,
+      DegreesOfFreedom<Barycentric>(
+          p1_dof_.position() + p1_dof_.velocity() * (1.5 * Second) +
+              Displacement<Barycentric>({10 * Metre, 0 * Metre, 0 * Metre}),
+          p1_dof_.velocity()));
+  p2_->AppendToHistory(
+      astronomy::J2000 + 1.5 * Second,
+      DegreesOfFreedom<Barycentric>(
+          p2_dof_.position() + p2_dof_.velocity() * (1.5 * Second),
+          p2_dof_.velocity()));
+  vessel_.AdvanceTime();
+
+  EXPECT_EQ(astronomy::J2000 + 1.5 * Second,
+            vessel_.prediction().last().time());
+}
+
 TEST_F(VesselTest, Prediction) {
   vessel_.PrepareHistory(astronomy::J2000);
 
@@ -317,6 +452,130 @@ TEST_F(VesselTest, PredictBeyondTheInfinite) {
                                        50.0 * Metre / Second}), 0)));
 }
 
+TEST_F(VesselTest, RefreshPrediction) {
+  vessel_.PrepareHistory(astronomy::J2000);
+
+  // Count separately the flows of the prediction, which is a fork, from those
+  // of the prognostications, which are roots.
+  std::atomic<int> prediction_flows = 0;
+  std::atomic<int> prognostication_flows = 0;
+  auto const append = [&prediction_flows, &prognostication_flows](
+      not_null<DiscreteTrajectory<Barycentric>*> const trajectory,
+      Ephemeris<Barycentric>::IntrinsicAcceleration,
+      Instant const&,
+      Ephemeris<Barycentric>::AdaptiveStepParameters const&,
+      std::int64_t,
+      bool) {
+    ++(trajectory->is_root() ? prognostication_flows : prediction_flows);
+    trajectory->Append(
+        trajectory->last().time() + 0.5 * Second,
+        DegreesOfFreedom<Barycentric>(Barycentric::origin,
+                                      Velocity<Barycentric>()));
+    return Status::OK;
+  };
+  EXPECT_CALL(ephemeris_, t_max())
+      .WillRepeatedly(Return(astronomy::J2000 + 0.5 * Second));
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _))
+      .WillRepeatedly(Invoke(append));
+
+  WorkStealingScheduler scheduler(/*pool_size=*/1);
+
+  // No prognostication is available initially, so the prediction is flowed on
+  // the calling thread.
+  vessel_.RefreshPrediction(&scheduler);
+  EXPECT_EQ(2, prediction_flows);
+  EXPECT_EQ(3, vessel_.prediction().Size());
+
+  // Once the prognostication has been computed, the next refresh attaches it
+  // instead of flowing the prediction.
+  vessel_.WaitForPrognostication();
+  EXPECT_EQ(2, prognostication_flows);
+  vessel_.RefreshPrediction(&scheduler);
+  EXPECT_EQ(2, prediction_flows);
+  EXPECT_EQ(3, vessel_.prediction().Size());
+  EXPECT_EQ(astronomy::J2000 + 1.0 * Second, vessel_.prediction().last().time());
+
+  // Changing the parameters makes the prognostications stale.  The prediction
+  // is flowed on the calling thread until a current prognostication has been
+  // computed.
+  vessel_.set_prediction_adaptive_step_parameters(
+      DefaultPredictionParameters());
+  vessel_.WaitForPrognostication();
+  vessel_.RefreshPrediction(&scheduler);
+  EXPECT_EQ(4, prediction_flows);
+  EXPECT_EQ(5, vessel_.prediction().Size());
+  std::int64_t const flowed_version = vessel_.prediction_version();
+  vessel_.WaitForPrognostication();
+  vessel_.RefreshPrediction(&scheduler);
+  EXPECT_EQ(4, prediction_flows);
+  EXPECT_EQ(flowed_version + 1, vessel_.prediction_version());
+  EXPECT_EQ(3, vessel_.prediction().Size());
+}
+
+TEST_F(VesselTest, PredictionStepLimit) {
+  auto parameters = DefaultPredictionParameters();
+  parameters.set_max_steps(3);
+  vessel_.set_prediction_adaptive_step_parameters(parameters);
+  vessel_.PrepareHistory(astronomy::J2000);
+
+  auto const append_at = [](Instant const& time) {
+    return AppendToDiscreteTrajectory(
+        time,
+        DegreesOfFreedom<Barycentric>(Barycentric::origin,
+                                      Velocity<Barycentric>()));
+  };
+  EXPECT_CALL(
+      ephemeris_,
+      FlowWithAdaptiveStep(
+          _, _, _,
+          Property(&Ephemeris<Barycentric>::AdaptiveStepParameters::max_steps,
+                   3),
+          _, _))
+      .WillOnce(DoAll(append_at(astronomy::J2000 + 0.5 * Second),
+                      append_at(astronomy::J2000 + 1.0 * Second),
+                      Return(Status::OK)));
+  vessel_.FlowPrediction(astronomy::J2000 + 1.0 * Second);
+
+  // Only the remaining step is allowed.
+  EXPECT_CALL(
+      ephemeris_,
+      FlowWithAdaptiveStep(
+          _, _, _,
+          Property(&Ephemeris<Barycentric>::AdaptiveStepParameters::max_steps,
+                   1),
+          _, _))
+      .WillOnce(DoAll(append_at(astronomy::J2000 + 1.5 * Second),
+                      Return(Status::OK)));
+  vessel_.FlowPrediction(astronomy::J2000 + 2.0 * Second);
+
+  // The prediction is complete, the ephemeris is not called anymore.
+  vessel_.FlowPrediction(astronomy::J2000 + 3.0 * Second);
+  EXPECT_EQ(4, vessel_.prediction().Size());
+}
+
+TEST_F(VesselTest, RefreshPredictionBeforeDeadline) {
+  vessel_.PrepareHistory(astronomy::J2000);
+
+  auto const deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+  // The prognostication is computed in the background.
+  EXPECT_CALL(ephemeris_, t_max())
+      .WillRepeatedly(Return(astronomy::J2000 + 0.5 * Second));
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _))
+      .WillRepeatedly(Return(Status::OK));
+  EXPECT_CALL(ephemeris_,
+              FlowWithAdaptiveStepBefore(
+                  _, _, astronomy::InfiniteFuture, _, _, deadline))
+      .WillOnce(DoAll(AppendToDiscreteTrajectory(
+                          astronomy::J2000 + 1.0 * Second,
+                          DegreesOfFreedom<Barycentric>(
+                              Barycentric::origin, Velocity<Barycentric>())),
+                      Return(Status(base::Error::DEADLINE_EXCEEDED, ""))));
+  WorkStealingScheduler scheduler(/*pool_size=*/1);
+  vessel_.RefreshPrediction(&scheduler, deadline);
+  EXPECT_EQ(2, vessel_.prediction().Size());
+}
+
 TEST_F(VesselTest, FlightPlan) {
   vessel_.PrepareHistory(astronomy::J2000);
 
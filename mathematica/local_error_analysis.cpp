@@ -1,21 +1,26 @@
 
 #include "mathematica/local_error_analysis.hpp"
 
+#include <cstring>
 #include <filesystem>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "astronomy/stabilize_ksp.hpp"
+#include "base/ensemble.hpp"
 #include "base/file.hpp"
+#include "base/status_or.hpp"
 #include "mathematica/mathematica.hpp"
+#include "mathematica/wxf_writer.hpp"
 
 namespace principia {
 namespace mathematica {
 
+using base::Ensemble;
 using base::OFStream;
-using base::make_not_null_unique;
+using base::StatusOr;
 using geometry::Position;
-using physics::DegreesOfFreedom;
-using physics::MassiveBody;
 using quantities::Length;
 using quantities::si::Day;
 using quantities::si::Metre;
@@ -26,6 +31,26 @@ namespace {
 
 constexpr Length fitting_tolerance = 1 * Milli(Metre);
 
+// The errors are checkpointed as the bytes of their values in metres.
+std::string EncodeErrors(std::vector<Length> const& errors) {
+  std::string bytes(errors.size() * sizeof(double), '\0');
+  for (int i = 0; i < errors.size(); ++i) {
+    double const error = errors[i] / Metre;
+    std::memcpy(&bytes[i * sizeof(double)], &error, sizeof(double));
+  }
+  return bytes;
+}
+
+std::vector<Length> DecodeErrors(std::string const& bytes) {
+  std::vector<Length> errors(bytes.size() / sizeof(double));
+  for (int i = 0; i < errors.size(); ++i) {
+    double error;
+    std::memcpy(&error, &bytes[i * sizeof(double)], sizeof(double));
+    errors[i] = error * Metre;
+  }
+  return errors;
+}
+
 }  // namespace
 
 LocalErrorAnalyser::LocalErrorAnalyser(
@@ -53,57 +78,68 @@ void LocalErrorAnalyser::WriteLocalErrors(
     Time const& fine_step,
     Time const& granularity,
     Time const& duration) const {
-  auto const reference_ephemeris = solar_system_->MakeEphemeris(
-      fitting_tolerance,
-      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator_, step_));
-  reference_ephemeris->Prolong(solar_system_->epoch());
-  std::vector<std::vector<Length>> errors;
+  // The forks are independent once the reference ephemeris has been computed,
+  // so they are integrated in parallel.  The results are checkpointed next to
+  // |path| so that an interrupted analysis may be resumed.
+  std::vector<Instant> fork_times;
+  std::vector<Instant> comparison_times;
   for (Instant t0 = solar_system_->epoch(),
                t = t0 + granularity;
        t < solar_system_->epoch() + duration;
        t0 = t, t += granularity) {
-    std::unique_ptr<Ephemeris<ICRFJ2000Equator>> refined_ephemeris =
-        ForkEphemeris(*reference_ephemeris, t0, fine_integrator, fine_step);
-    reference_ephemeris->Prolong(t);
-    refined_ephemeris->Prolong(t);
-    LOG_EVERY_N(INFO, 10) << "Prolonged to "
-                          << (t - solar_system_->epoch()) / Day << " days.";
-
-    errors.emplace_back();
-    for (auto const& body_name : solar_system_->names()) {
-      int const body_index = solar_system_->index(body_name);
-      errors.back().push_back(
-          (reference_ephemeris
-               ->trajectory(reference_ephemeris->bodies()[body_index])
-               ->EvaluatePosition(t) -
-           refined_ephemeris
-               ->trajectory(refined_ephemeris->bodies()[body_index])
-               ->EvaluatePosition(t)).Norm());
-    }
+    fork_times.push_back(t0);
+    comparison_times.push_back(t);
   }
+  auto const reference_ephemeris = solar_system_->MakeEphemeris(
+      fitting_tolerance,
+      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator_, step_));
+  reference_ephemeris->Prolong(comparison_times.empty()
+                                   ? solar_system_->epoch()
+                                   : comparison_times.back());
+
+  std::filesystem::path const checkpoint = path.string() + ".checkpoint";
+  Ensemble<std::vector<Length>> ensemble(
+      /*concurrent_runs=*/std::thread::hardware_concurrency());
+  ensemble.SetCheckpoint(checkpoint, &EncodeErrors, &DecodeErrors);
+  auto const local_errors = ensemble.Execute(
+      fork_times.size(),
+      [this,
+       &comparison_times,
+       &fine_integrator,
+       fine_step,
+       &fork_times,
+       &reference_ephemeris](int const i) -> StatusOr<std::vector<Length>> {
+        Instant const& t = comparison_times[i];
+        // The fork shares the trajectories of the reference ephemeris before
+        // its fork time.
+        std::unique_ptr<Ephemeris<ICRFJ2000Equator>> refined_ephemeris =
+            reference_ephemeris->Fork(
+                fork_times[i],
+                Ephemeris<ICRFJ2000Equator>::FixedStepParameters(
+                    fine_integrator, fine_step));
+        refined_ephemeris->Prolong(t);
+        LOG_EVERY_N(INFO, 10) << "Prolonged to "
+                              << (t - solar_system_->epoch()) / Day << " days.";
+
+        std::vector<Length> errors;
+        for (auto const& body_name : solar_system_->names()) {
+          int const body_index = solar_system_->index(body_name);
+          errors.push_back(
+              (reference_ephemeris
+                   ->trajectory(reference_ephemeris->bodies()[body_index])
+                   ->EvaluatePosition(t) -
+               refined_ephemeris
+                   ->trajectory(refined_ephemeris->bodies()[body_index])
+                   ->EvaluatePosition(t)).Norm());
+        }
+        return errors;
+      });
+  CHECK_OK(local_errors.status());
   OFStream file(path);
   file << Assign("bodyNames", solar_system_->names());
-  file << Assign("errors", ExpressIn(Metre, errors));
-}
-
-not_null<std::unique_ptr<Ephemeris<ICRFJ2000Equator>>>
-LocalErrorAnalyser::ForkEphemeris(
-    Ephemeris<ICRFJ2000Equator> const& original,
-    Instant const& t,
-    FixedStepSizeIntegrator<
-        Ephemeris<ICRFJ2000Equator>::NewtonianMotionEquation> const& integrator,
-    Time const& step) const {
-  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> degrees_of_freedom;
-  for (not_null<MassiveBody const*> const body : original.bodies()) {
-    degrees_of_freedom.emplace_back(
-        original.trajectory(body)->EvaluateDegreesOfFreedom(t));
-  }
-  return make_not_null_unique<Ephemeris<ICRFJ2000Equator>>(
-      solar_system_->MakeAllMassiveBodies(),
-      degrees_of_freedom,
-      t,
-      fitting_tolerance,
-      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator, step));
+  file << AssignWXF("errors", ExpressIn(Metre, local_errors.ValueOrDie()),
+                    path);
+  std::filesystem::remove(checkpoint);
 }
 
 }  // namespace mathematica
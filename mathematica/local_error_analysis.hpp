@@ -31,7 +31,10 @@ class LocalErrorAnalyser {
 
   // Computes the error over |granularity| between the main integration and a
   // fine integration forked off the main one, for |duration| from the solar
-  // system epoch.  Writes the errors to a file with the given |path|.
+  // system epoch.  Writes the errors to a file with the given |path|.  The
+  // fine integrations are executed in parallel, and their results are
+  // checkpointed to |path| + ".checkpoint" until the file is written, so that
+  // an interrupted analysis resumes where it stopped.
   void WriteLocalErrors(
       std::filesystem::path const& path,
       FixedStepSizeIntegrator<
@@ -42,14 +45,6 @@ class LocalErrorAnalyser {
       Time const& duration) const;
 
  private:
-  not_null<std::unique_ptr<Ephemeris<ICRFJ2000Equator>>> ForkEphemeris(
-      Ephemeris<ICRFJ2000Equator> const& original,
-      Instant const& t,
-      FixedStepSizeIntegrator<
-          Ephemeris<ICRFJ2000Equator>::NewtonianMotionEquation> const&
-          integrator,
-      Time const& step) const;
-
   not_null<std::unique_ptr<SolarSystem<ICRFJ2000Equator>>> const solar_system_;
   FixedStepSizeIntegrator<
       Ephemeris<ICRFJ2000Equator>::NewtonianMotionEquation> const& integrator_;
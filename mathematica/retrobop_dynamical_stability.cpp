@@ -21,6 +21,7 @@
 #include "integrators/methods.hpp"
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 #include "mathematica/mathematica.hpp"
+#include "mathematica/wxf_writer.hpp"
 #include "physics/hierarchical_system.hpp"
 #include "physics/solar_system.hpp"
 #include "quantities/astronomy.hpp"
@@ -349,34 +350,44 @@ void ProduceCenturyPlots(Ephemeris<Barycentric>& ephemeris) {
     }
   }
 
-  OFStream file(TEMP_DIR / "retrobop_century.generated.wl");
-  file << Assign("laytheTimes", ExpressIn(Second, times_from_epoch[Laythe]));
-  file << Assign("vallTimes", ExpressIn(Second, times_from_epoch[Vall]));
-  file << Assign("tyloTimes", ExpressIn(Second, times_from_epoch[Tylo]));
-  file << Assign("polTimes", ExpressIn(Second, times_from_epoch[Pol]));
-  file << Assign("bopTimes", ExpressIn(Second, times_from_epoch[Bop]));
-  file << Assign("laytheSeparations",
-                 ExpressIn(Metre, extremal_separations[Laythe]));
-  file << Assign("vallSeparations",
-                 ExpressIn(Metre, extremal_separations[Vall]));
-  file << Assign("tyloSeparations",
-                 ExpressIn(Metre, extremal_separations[Tylo]));
-  file << Assign("polSeparations", ExpressIn(Metre, extremal_separations[Pol]));
-  file << Assign("bopSeparations", ExpressIn(Metre, extremal_separations[Bop]));
-
-  file << Assign("bopEccentricities", bop_eccentricities);
-  file << Assign("bopInclinations", ExpressIn(Degree, bop_inclinations));
-  file << Assign("bopNodes", ExpressIn(Degree, bop_nodes));
-  file << Assign("bopArguments", ExpressIn(Degree, bop_arguments_of_periapsis));
-  file << Assign("bopJacobiEccentricities", bop_jacobi_eccentricities);
-  file << Assign("bopJacobiInclinations",
-                 ExpressIn(Degree, bop_jacobi_inclinations));
-  file << Assign("bopJacobiNodes", ExpressIn(Degree, bop_jacobi_nodes));
-  file << Assign("bopJacobiArguments",
-                 ExpressIn(Degree, bop_jacobi_arguments_of_periapsis));
-
-  file << Assign("tyloBop", ExpressIn(Metre, tylo_bop_separations));
-  file << Assign("polBop", ExpressIn(Metre, pol_bop_separations));
+  std::filesystem::path const path =
+      TEMP_DIR / "retrobop_century.generated.wl";
+  OFStream file(path);
+  file << AssignWXF("laytheTimes",
+                    ExpressIn(Second, times_from_epoch[Laythe]), path);
+  file << AssignWXF("vallTimes",
+                    ExpressIn(Second, times_from_epoch[Vall]), path);
+  file << AssignWXF("tyloTimes",
+                    ExpressIn(Second, times_from_epoch[Tylo]), path);
+  file << AssignWXF("polTimes", ExpressIn(Second, times_from_epoch[Pol]), path);
+  file << AssignWXF("bopTimes", ExpressIn(Second, times_from_epoch[Bop]), path);
+  file << AssignWXF("laytheSeparations",
+                    ExpressIn(Metre, extremal_separations[Laythe]), path);
+  file << AssignWXF("vallSeparations",
+                    ExpressIn(Metre, extremal_separations[Vall]), path);
+  file << AssignWXF("tyloSeparations",
+                    ExpressIn(Metre, extremal_separations[Tylo]), path);
+  file << AssignWXF("polSeparations",
+                    ExpressIn(Metre, extremal_separations[Pol]), path);
+  file << AssignWXF("bopSeparations",
+                    ExpressIn(Metre, extremal_separations[Bop]), path);
+
+  file << AssignWXF("bopEccentricities", bop_eccentricities, path);
+  file << AssignWXF("bopInclinations",
+                    ExpressIn(Degree, bop_inclinations), path);
+  file << AssignWXF("bopNodes", ExpressIn(Degree, bop_nodes), path);
+  file << AssignWXF("bopArguments",
+                    ExpressIn(Degree, bop_arguments_of_periapsis), path);
+  file << AssignWXF("bopJacobiEccentricities", bop_jacobi_eccentricities, path);
+  file << AssignWXF("bopJacobiInclinations",
+                    ExpressIn(Degree, bop_jacobi_inclinations), path);
+  file << AssignWXF("bopJacobiNodes",
+                    ExpressIn(Degree, bop_jacobi_nodes), path);
+  file << AssignWXF("bopJacobiArguments",
+                    ExpressIn(Degree, bop_jacobi_arguments_of_periapsis), path);
+
+  file << AssignWXF("tyloBop", ExpressIn(Metre, tylo_bop_separations), path);
+  file << AssignWXF("polBop", ExpressIn(Metre, pol_bop_separations), path);
 }
 
 void ComputeHighestMoonError(Ephemeris<Barycentric> const& left,
@@ -425,13 +436,15 @@ void PlotPredictableYears() {
   FillPositions(
       *ephemeris, ksp_epoch, 5 * JulianYear, barycentric_positions_5_year);
 
-  OFStream file(TEMP_DIR / "retrobop_predictable_years.generated.wl");
-  file << Assign("barycentricPositions1",
-                 ExpressIn(Metre, barycentric_positions_1_year));
-  file << Assign("barycentricPositions2",
-                 ExpressIn(Metre, barycentric_positions_2_year));
-  file << Assign("barycentricPositions5",
-                 ExpressIn(Metre, barycentric_positions_5_year));
+  std::filesystem::path const path =
+      TEMP_DIR / "retrobop_predictable_years.generated.wl";
+  OFStream file(path);
+  file << AssignWXF("barycentricPositions1",
+                    ExpressIn(Metre, barycentric_positions_1_year), path);
+  file << AssignWXF("barycentricPositions2",
+                    ExpressIn(Metre, barycentric_positions_2_year), path);
+  file << AssignWXF("barycentricPositions5",
+                    ExpressIn(Metre, barycentric_positions_5_year), path);
 }
 
 void PlotCentury() {
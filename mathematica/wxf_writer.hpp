@@ -0,0 +1,97 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/point.hpp"
+#include "geometry/r3_element.hpp"
+#include "numerics/fixed_arrays.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace mathematica {
+namespace internal_wxf_writer {
+
+using geometry::Point;
+using geometry::R3Element;
+using geometry::Vector;
+using numerics::FixedVector;
+using quantities::Quantity;
+
+// Writes a Mathematica expression to a file in the Wolfram Exchange Format
+// (WXF), a binary format which is read by |Import[file, "WXF"]|.  The
+// expression is written as it is produced, without building strings, and the
+// vectors of reals, quantities, |R3Element|s, |Vector|s, |Point|s and
+// |FixedVector|s are written as packed arrays, which Mathematica reads without
+// parsing.  The caller must write exactly one expression, typically with one
+// call to |Write|, or with |WriteFunction| followed by its arguments.
+class WXFWriter final {
+ public:
+  explicit WXFWriter(std::filesystem::path const& path);
+
+  // Writes the head of the expression |head[arguments...]|.  Must be followed
+  // by |number_of_arguments| expressions.
+  void WriteFunction(std::string const& head, std::int64_t number_of_arguments);
+  void WriteSymbol(std::string const& name);
+  void WriteString(std::string const& str);
+  void WriteInteger(std::int64_t integer);
+
+  // Same representation as |ToMathematica|, except that the reals are exact
+  // binary values instead of decimal strings.
+  void Write(double real);
+
+  template<typename D>
+  void Write(Quantity<D> const& quantity);
+
+  template<typename T>
+  void Write(R3Element<T> const& r3_element);
+
+  template<typename S, typename F>
+  void Write(Vector<S, F> const& vector);
+
+  template<typename V>
+  void Write(Point<V> const& point);
+
+  template<typename T, int size>
+  void Write(FixedVector<T, size> const& fixed_vector);
+
+  // The vectors whose elements are made of reals or of quantities of a single
+  // dimension are written as packed arrays, wrapped in |Quantity| in the latter
+  // case.  Other vectors are written element by element.
+  template<typename T>
+  void Write(std::vector<T> const& list);
+
+ private:
+  template<typename T>
+  void WriteElementByElement(std::vector<T> const& list);
+
+  void WriteReal64(double real);
+  void WriteVarint(std::uint64_t value);
+  void WriteLittleEndian(std::uint64_t value);
+
+  std::ofstream stream_;
+};
+
+// Writes |value| to a WXF file named after |wl_path| and |name|, and returns a
+// statement that sets |name| to the contents of that file.  The statement must
+// be written to |wl_path|, which must be evaluated with |Get|.  This is a
+// replacement for |Assign| which doesn't build the string for |value|.
+template<typename T>
+std::string AssignWXF(std::string const& name,
+                      T const& value,
+                      std::filesystem::path const& wl_path);
+
+}  // namespace internal_wxf_writer
+
+using internal_wxf_writer::AssignWXF;
+using internal_wxf_writer::WXFWriter;
+
+}  // namespace mathematica
+}  // namespace principia
+
+#include "mathematica/wxf_writer_body.hpp"
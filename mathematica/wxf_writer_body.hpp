@@ -0,0 +1,299 @@
+﻿
+#pragma once
+
+#include "mathematica/wxf_writer.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "base/not_constructible.hpp"
+#include "glog/logging.h"
+#include "mathematica/mathematica.hpp"
+
+namespace principia {
+namespace mathematica {
+namespace internal_wxf_writer {
+
+using base::not_constructible;
+using quantities::DebugString;
+using quantities::SIUnit;
+
+// The tokens of the WXF format, see
+// https://reference.wolfram.com/language/tutorial/WXFFormatDescription.html.
+constexpr char header[] = "8:";
+constexpr char function_token = 'f';
+constexpr char symbol_token = 's';
+constexpr char string_token = 'S';
+constexpr char integer64_token = 'L';
+constexpr char real64_token = 'r';
+constexpr char packed_array_token = '\xC1';
+constexpr char real64_array_type = '\x23';
+
+// Describes how the elements of a vector are flattened into the rows of a
+// packed array.  |components| is the number of reals in a row and |Scalar| is
+// the type of these reals before the removal of their unit.  |ForEach| calls
+// its argument on each of the reals of an element.
+template<typename T>
+struct Packing : not_constructible {
+  static constexpr bool is_packable = false;
+  static constexpr int components = 0;
+  using Scalar = void;
+};
+
+template<>
+struct Packing<double> : not_constructible {
+  static constexpr bool is_packable = true;
+  static constexpr int components = 1;
+  using Scalar = double;
+
+  template<typename F>
+  static void ForEach(double const real, F const& f) {
+    f(real);
+  }
+};
+
+template<typename D>
+struct Packing<Quantity<D>> : not_constructible {
+  static constexpr bool is_packable = true;
+  static constexpr int components = 1;
+  using Scalar = Quantity<D>;
+
+  template<typename F>
+  static void ForEach(Quantity<D> const& quantity, F const& f) {
+    f(quantity / SIUnit<Quantity<D>>());
+  }
+};
+
+template<typename T>
+struct Packing<R3Element<T>> : not_constructible {
+  static constexpr bool is_packable =
+      Packing<T>::is_packable && Packing<T>::components == 1;
+  static constexpr int components = 3;
+  using Scalar = typename Packing<T>::Scalar;
+
+  template<typename F>
+  static void ForEach(R3Element<T> const& r3_element, F const& f) {
+    Packing<T>::ForEach(r3_element.x, f);
+    Packing<T>::ForEach(r3_element.y, f);
+    Packing<T>::ForEach(r3_element.z, f);
+  }
+};
+
+template<typename S, typename F>
+struct Packing<Vector<S, F>> : Packing<R3Element<S>> {
+  template<typename G>
+  static void ForEach(Vector<S, F> const& vector, G const& g) {
+    Packing<R3Element<S>>::ForEach(vector.coordinates(), g);
+  }
+};
+
+template<typename V>
+struct Packing<Point<V>> : Packing<V> {
+  template<typename F>
+  static void ForEach(Point<V> const& point, F const& f) {
+    Packing<V>::ForEach(point - Point<V>(), f);
+  }
+};
+
+template<typename T, int size>
+struct Packing<FixedVector<T, size>> : not_constructible {
+  static constexpr bool is_packable =
+      Packing<T>::is_packable && Packing<T>::components == 1;
+  static constexpr int components = size;
+  using Scalar = typename Packing<T>::Scalar;
+
+  template<typename F>
+  static void ForEach(FixedVector<T, size> const& fixed_vector, F const& f) {
+    for (int i = 0; i < size; ++i) {
+      Packing<T>::ForEach(fixed_vector[i], f);
+    }
+  }
+};
+
+// The units of |Q| as they appear in |ToMathematica|.
+template<typename Q>
+std::string Units() {
+  std::string const s = DebugString(SIUnit<Q>());
+  return s.substr(s.find(" "));
+}
+
+inline WXFWriter::WXFWriter(std::filesystem::path const& path)
+    : stream_(path, std::ios::binary) {
+  CHECK(stream_.good()) << path;
+  stream_.write(header, sizeof(header) - 1);
+}
+
+inline void WXFWriter::WriteFunction(std::string const& head,
+                                     std::int64_t const number_of_arguments) {
+  stream_.put(function_token);
+  WriteVarint(number_of_arguments);
+  WriteSymbol(head);
+}
+
+inline void WXFWriter::WriteSymbol(std::string const& name) {
+  stream_.put(symbol_token);
+  WriteVarint(name.size());
+  stream_.write(name.data(), name.size());
+}
+
+inline void WXFWriter::WriteString(std::string const& str) {
+  stream_.put(string_token);
+  WriteVarint(str.size());
+  stream_.write(str.data(), str.size());
+}
+
+inline void WXFWriter::WriteInteger(std::int64_t const integer) {
+  stream_.put(integer64_token);
+  WriteLittleEndian(static_cast<std::uint64_t>(integer));
+}
+
+inline void WXFWriter::Write(double const real) {
+  if (std::isinf(real)) {
+    if (real > 0.0) {
+      WriteSymbol("Infinity");
+    } else {
+      WriteFunction("Minus", 1);
+      WriteSymbol("Infinity");
+    }
+  } else if (std::isnan(real)) {
+    WriteSymbol("Indeterminate");
+  } else {
+    stream_.put(real64_token);
+    WriteReal64(real);
+  }
+}
+
+template<typename D>
+void WXFWriter::Write(Quantity<D> const& quantity) {
+  WriteFunction("Quantity", 2);
+  Write(quantity / SIUnit<Quantity<D>>());
+  WriteString(Units<Quantity<D>>());
+}
+
+template<typename T>
+void WXFWriter::Write(R3Element<T> const& r3_element) {
+  WriteFunction("List", 3);
+  Write(r3_element.x);
+  Write(r3_element.y);
+  Write(r3_element.z);
+}
+
+template<typename S, typename F>
+void WXFWriter::Write(Vector<S, F> const& vector) {
+  Write(vector.coordinates());
+}
+
+template<typename V>
+void WXFWriter::Write(Point<V> const& point) {
+  Write(point - Point<V>());
+}
+
+template<typename T, int size>
+void WXFWriter::Write(FixedVector<T, size> const& fixed_vector) {
+  WriteFunction("List", size);
+  for (int i = 0; i < size; ++i) {
+    Write(fixed_vector[i]);
+  }
+}
+
+template<typename T>
+void WXFWriter::Write(std::vector<T> const& list) {
+  if constexpr (Packing<T>::is_packable) {
+    using Scalar = typename Packing<T>::Scalar;
+    // Mathematica has neither empty packed arrays nor infinite machine reals.
+    bool all_finite = true;
+    for (auto const& element : list) {
+      Packing<T>::ForEach(element, [&all_finite](double const real) {
+        all_finite &= std::isfinite(real);
+      });
+    }
+    if (list.empty() || !all_finite) {
+      WriteElementByElement(list);
+      return;
+    }
+
+    if constexpr (!std::is_same_v<Scalar, double>) {
+      WriteFunction("Quantity", 2);
+    }
+    stream_.put(packed_array_token);
+    stream_.put(real64_array_type);
+    if constexpr (Packing<T>::components == 1) {
+      WriteVarint(1);
+      WriteVarint(list.size());
+    } else {
+      WriteVarint(2);
+      WriteVarint(list.size());
+      WriteVarint(Packing<T>::components);
+    }
+    for (auto const& element : list) {
+      Packing<T>::ForEach(element, [this](double const real) {
+        WriteReal64(real);
+      });
+    }
+    if constexpr (!std::is_same_v<Scalar, double>) {
+      WriteString(Units<Scalar>());
+    }
+  } else {
+    WriteElementByElement(list);
+  }
+}
+
+template<typename T>
+void WXFWriter::WriteElementByElement(std::vector<T> const& list) {
+  WriteFunction("List", list.size());
+  for (auto const& element : list) {
+    Write(element);
+  }
+}
+
+inline void WXFWriter::WriteReal64(double const real) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &real, sizeof(bits));
+  WriteLittleEndian(bits);
+}
+
+inline void WXFWriter::WriteVarint(std::uint64_t value) {
+  // Groups of 7 bits, least significant first, with the high bit set on all
+  // the bytes but the last.
+  while (value >= 0x80) {
+    stream_.put(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  stream_.put(static_cast<char>(value));
+}
+
+inline void WXFWriter::WriteLittleEndian(std::uint64_t const value) {
+  char bytes[sizeof(value)];
+  for (int i = 0; i < sizeof(value); ++i) {
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+  stream_.write(bytes, sizeof(bytes));
+}
+
+template<typename T>
+std::string AssignWXF(std::string const& name,
+                      T const& value,
+                      std::filesystem::path const& wl_path) {
+  std::filesystem::path wxf_path = wl_path;
+  wxf_path.replace_extension("." + name + ".wxf");
+  {
+    WXFWriter writer(wxf_path);
+    writer.Write(value);
+  }
+  // The WXF file is found relative to the file being evaluated, so that the
+  // files may be moved together.
+  std::string const wxf_file =
+      Apply("FileNameJoin",
+            {Apply("List",
+                   {Apply("DirectoryName", {"$InputFileName"}),
+                    Escape(wxf_path.filename().string())})});
+  return Apply("Set", {name, Apply("Import", {wxf_file, Escape("WXF")})}) +
+         ";\n";
+}
+
+}  // namespace internal_wxf_writer
+}  // namespace mathematica
+}  // namespace principia
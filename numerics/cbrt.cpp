@@ -27,6 +27,12 @@ constexpr double σ₂ = 0x1p154;
 constexpr double σ₂⁻³ = 1 / (σ₂ * σ₂ * σ₂);
 static_assert(σ₁⁻³ * y₁ == y₂, "Incorrect σ₁");
 static_assert(σ₂⁻³ * y₂ == y₁, "Incorrect σ₂");
+
+// Packed versions of the above constants, for the batch version.
+static const __m128d sign_bit_packed = _mm_set1_pd(-0.0);
+static const __m128d sign_exponent_and_sixteen_bits_of_mantissa_packed =
+    _mm_castsi128_pd(_mm_set1_epi64x(0xFFFF'FFF0'0000'0000));
+
 double Cbrt(double const y) {
   __m128d const y_0 = _mm_set_sd(y);
   __m128d const sign = _mm_and_pd(sign_bit, y_0);
@@ -77,5 +83,66 @@ double Cbrt(double const y) {
   return x_sign_y - numerator / denominator;
 }
 
+void Cbrt(double const* const y, double* const x, std::int64_t const size) {
+  std::int64_t i = 0;
+  for (; i + 1 < size; i += 2) {
+    __m128d const y_0 = _mm_loadu_pd(&y[i]);
+    __m128d const sign = _mm_and_pd(sign_bit_packed, y_0);
+    __m128d const abs_y = _mm_andnot_pd(sign_bit_packed, y_0);
+    // The comparisons are false for NaNs, so this also excludes them, as well
+    // as zeros and infinities.
+    alignas(16) double abs_y_lanes[2];
+    _mm_store_pd(abs_y_lanes, abs_y);
+    if (!(abs_y_lanes[0] >= y₁ && abs_y_lanes[0] <= y₂ &&
+          abs_y_lanes[1] >= y₁ && abs_y_lanes[1] <= y₂)) {
+      double const y_i = y[i];
+      double const y_i_plus_1 = y[i + 1];
+      x[i] = Cbrt(y_i);
+      x[i + 1] = Cbrt(y_i_plus_1);
+      continue;
+    }
+    // The operations below are exactly those of the scalar version, performed
+    // on both lanes; there is no packed 64-bit integer division, so the
+    // initial approximation is computed lane by lane.
+    alignas(16) std::uint64_t Q[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(Q), _mm_castpd_si128(abs_y));
+    Q[0] = C + Q[0] / 3;
+    Q[1] = C + Q[1] / 3;
+    __m128d const q =
+        _mm_castsi128_pd(_mm_load_si128(reinterpret_cast<__m128i*>(Q)));
+    __m128d const q³ = _mm_mul_pd(_mm_mul_pd(q, q), q);
+    __m128d const ξ = _mm_sub_pd(
+        q,
+        _mm_div_pd(
+            _mm_mul_pd(_mm_sub_pd(q³, abs_y), q),
+            _mm_add_pd(_mm_mul_pd(_mm_set1_pd(2), q³), abs_y)));
+    __m128d const x_0 =
+        _mm_and_pd(ξ, sign_exponent_and_sixteen_bits_of_mantissa_packed);
+    __m128d const x³ = _mm_mul_pd(_mm_mul_pd(x_0, x_0), x_0);
+    __m128d const x⁶ = _mm_mul_pd(x³, x³);
+    __m128d const y² = _mm_mul_pd(y_0, y_0);
+    __m128d const x_sign_y = _mm_or_pd(x_0, sign);
+    __m128d const numerator = _mm_mul_pd(
+        _mm_mul_pd(x_sign_y, _mm_sub_pd(x³, abs_y)),
+        _mm_add_pd(
+            _mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(5), x³),
+                                  _mm_mul_pd(_mm_set1_pd(17), abs_y)),
+                       x³),
+            _mm_mul_pd(_mm_set1_pd(5), y²)));
+    __m128d const denominator = _mm_add_pd(
+        _mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(7), x³),
+                              _mm_mul_pd(_mm_set1_pd(42), abs_y)),
+                   x⁶),
+        _mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(30), x³),
+                              _mm_mul_pd(_mm_set1_pd(2), abs_y)),
+                   y²));
+    _mm_storeu_pd(&x[i],
+                  _mm_sub_pd(x_sign_y, _mm_div_pd(numerator, denominator)));
+  }
+  if (i < size) {
+    x[i] = Cbrt(y[i]);
+  }
+}
+
 }  // namespace numerics
 }  // namespace principia
@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <cstdint>
+
 namespace principia {
 namespace numerics {
 
@@ -7,5 +9,11 @@ namespace numerics {
 // incorrectly rounded for approximately 5 inputs per million.
 double Cbrt(double y);
 
+// Sets |x[i]| to |Cbrt(y[i])| for 0 ≤ i < |size|, with bitwise identical
+// results.  Pairs of consecutive arguments that need no rescaling are processed
+// together using packed SSE2 operations; the others, as well as the last one if
+// |size| is odd, go through the above function.  |x| may be equal to |y|.
+void Cbrt(double const* y, double* x, std::int64_t size);
+
 }  // namespace numerics
 }  // namespace principia
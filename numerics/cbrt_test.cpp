@@ -4,7 +4,10 @@
 #include <cfenv>
 #include <pmmintrin.h>
 
+#include <cstdint>
 #include <limits>
+#include <random>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -127,5 +130,31 @@ TEST_F(CubeRootTest, ParticularlyBadRounding) {
   EXPECT_THAT(x_ulps, AllOf(Gt(0.5000551), Lt(0.5000552))) << x_ulps - 0.5;
 }
 
+TEST_F(CubeRootTest, Batch) {
+  // Random bit patterns cover all the paths, including NaNs and the rescaling
+  // ranges; the odd size exercises the last element.
+  std::mt19937_64 random(42);
+  std::vector<double> y;
+  for (int i = 0; i < 100'001; ++i) {
+    y.push_back(FromBits(random()));
+  }
+  y[10] = 0;
+  y[11] = -0.0;
+  y[12] = std::numeric_limits<double>::infinity();
+  y[13] = 0x1p237;
+  y[14] = 2;
+  y[15] = -2;
+  std::vector<double> x(y.size());
+  Cbrt(y.data(), x.data(), y.size());
+  for (std::size_t i = 0; i < y.size(); ++i) {
+    EXPECT_THAT(Bits(x[i]), Eq(Bits(Cbrt(y[i])))) << y[i];
+  }
+  // In place.
+  Cbrt(y.data(), y.data(), y.size());
+  for (std::size_t i = 0; i < y.size(); ++i) {
+    EXPECT_THAT(Bits(y[i]), Eq(Bits(x[i])));
+  }
+}
+
 }  // namespace numerics
 }  // namespace principia
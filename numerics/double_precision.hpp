@@ -2,6 +2,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
@@ -51,6 +52,21 @@ template<typename T, typename U>
 DoublePrecision<Product<T, U>> Scale(T const& scale,
                                      DoublePrecision<U> const& right);
 
+// Batch forms of |DoublePrecision::Increment| and |Decrement|, used by the
+// integrators to update the state of all the bodies.  They are equivalent to
+// calling the member function on each element of |values| with the
+// corresponding element of |rights|, and give bitwise identical results.  The
+// compensated sum has no product, so there is nothing to fuse; the loop works
+// on the raw arrays so that it is not obstructed by the bound checks and
+// aliasing of |std::vector|, and the R3 types are summed in their SIMD
+// registers.
+template<typename T>
+void Decrement(std::vector<DoublePrecision<T>>& values,
+               std::vector<Difference<T>> const& rights);
+template<typename T>
+void Increment(std::vector<DoublePrecision<T>>& values,
+               std::vector<Difference<T>> const& rights);
+
 // Returns the exact product of its arguments.
 template<typename T, typename U>
 DoublePrecision<Product<T, U>> TwoProduct(T const& a, U const& b);
@@ -110,7 +126,9 @@ std::ostream& operator<<(std::ostream& os,
 
 }  // namespace internal_double_precision
 
+using internal_double_precision::Decrement;
 using internal_double_precision::DoublePrecision;
+using internal_double_precision::Increment;
 using internal_double_precision::TwoProduct;
 using internal_double_precision::TwoSum;
 
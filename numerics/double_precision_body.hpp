@@ -7,6 +7,7 @@
 #include <cmath>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "geometry/serialization.hpp"
 #include "quantities/elementary_functions.hpp"
@@ -143,6 +144,30 @@ DoublePrecision<Product<T, U>> Scale(T const & scale,
   return result;
 }
 
+template<typename T>
+void Decrement(std::vector<DoublePrecision<T>>& values,
+               std::vector<Difference<T>> const& rights) {
+  DCHECK_EQ(values.size(), rights.size());
+  std::int64_t const size = values.size();
+  DoublePrecision<T>* const v = values.data();
+  Difference<T> const* const r = rights.data();
+  for (std::int64_t i = 0; i < size; ++i) {
+    v[i].Decrement(r[i]);
+  }
+}
+
+template<typename T>
+void Increment(std::vector<DoublePrecision<T>>& values,
+               std::vector<Difference<T>> const& rights) {
+  DCHECK_EQ(values.size(), rights.size());
+  std::int64_t const size = values.size();
+  DoublePrecision<T>* const v = values.data();
+  Difference<T> const* const r = rights.data();
+  for (std::int64_t i = 0; i < size; ++i) {
+    v[i].Increment(r[i]);
+  }
+}
+
 template<typename T, typename U>
 DoublePrecision<Product<T, U>> TwoProduct(T const& a, U const& b) {
   DoublePrecision<Product<T, U>> result(a * b);
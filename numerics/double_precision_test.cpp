@@ -3,6 +3,7 @@
 
 #include <limits>
 #include <random>
+#include <vector>
 
 #include "geometry/frame.hpp"
 #include "geometry/named_quantities.hpp"
@@ -93,6 +94,36 @@ TEST_F(DoublePrecisionTest, CompensatedSummationIncrement) {
   EXPECT_THAT(accumulator.error.coordinates().x, Eq(0 * Metre));
 }
 
+TEST_F(DoublePrecisionTest, BatchCompensatedSummation) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(-1, 1);
+  auto const random_displacement = [&distribution, &random]() {
+    return Displacement<World>({distribution(random) * Metre,
+                                distribution(random) * Metre,
+                                distribution(random) * Metre});
+  };
+  std::vector<DoublePrecision<Position<World>>> batch;
+  std::vector<Displacement<World>> δs;
+  for (int i = 0; i < 10; ++i) {
+    batch.emplace_back(World::origin + 1e6 * random_displacement());
+    δs.push_back(1e-6 * random_displacement());
+  }
+  auto element_by_element = batch;
+  for (int step = 0; step < 100; ++step) {
+    Increment(batch, δs);
+    for (int i = 0; i < batch.size(); ++i) {
+      element_by_element[i].Increment(δs[i]);
+    }
+  }
+  Decrement(batch, δs);
+  for (int i = 0; i < batch.size(); ++i) {
+    element_by_element[i].Decrement(δs[i]);
+  }
+  for (int i = 0; i < batch.size(); ++i) {
+    EXPECT_THAT(batch[i], Eq(element_by_element[i]));
+  }
+}
+
 TEST_F(DoublePrecisionTest, CompensatedSummationDecrement) {
   Position<World> const initial =
       World::origin + Displacement<World>({1 * Metre, 0 * Metre, 0 * Metre});
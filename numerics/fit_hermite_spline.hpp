@@ -1,13 +1,17 @@
 ﻿#pragma once
 
+#include <cstdint>
 #include <list>
+#include <vector>
 
+#include "base/function.hpp"
 #include "numerics/hermite3.hpp"
 
 namespace principia {
 namespace numerics {
 namespace internal_fit_hermite_spline {
 
+using base::function_ref;
 using quantities::Derivative;
 using quantities::Difference;
 using geometry::Normed;
@@ -26,12 +30,24 @@ using geometry::Normed;
 template<typename Argument, typename Value, typename Samples>
 std::list<typename Samples::const_iterator> FitHermiteSpline(
     Samples const& samples,
-    std::function<Argument const&(typename Samples::value_type const&)> const&
+    function_ref<Argument const&(typename Samples::value_type const&)>
         get_argument,
-    std::function<Value const&(typename Samples::value_type const&)> const&
-        get_value,
-    std::function<Derivative<Value, Argument> const&(
-        typename Samples::value_type const&)> const& get_derivative,
+    function_ref<Value const&(typename Samples::value_type const&)> get_value,
+    function_ref<Derivative<Value, Argument> const&(
+        typename Samples::value_type const&)> get_derivative,
+    typename Normed<Difference<Value>>::NormType const& tolerance);
+
+// Same as above, but the arguments, values, and derivatives of the samples are
+// given in contiguous arrays of the same size, and the result contains the
+// indices of the samples instead of iterators.  The result is the same as that
+// of the above function.  The interpolation errors are computed by a loop over
+// the arrays which doesn't go through |function_ref| and which the compiler
+// may vectorize.
+template<typename Argument, typename Value>
+std::vector<std::int64_t> FitHermiteSpline(
+    std::vector<Argument> const& arguments,
+    std::vector<Value> const& values,
+    std::vector<Derivative<Value, Argument>> const& derivatives,
     typename Normed<Difference<Value>>::NormType const& tolerance);
 
 }  // namespace internal_fit_hermite_spline
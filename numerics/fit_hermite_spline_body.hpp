@@ -1,8 +1,11 @@
 ﻿
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <list>
 #include <type_traits>
+#include <vector>
 
 #include "base/ranges.hpp"
 #include "numerics/hermite3.hpp"
@@ -11,39 +14,28 @@ namespace principia {
 namespace numerics {
 namespace internal_fit_hermite_spline {
 
+using base::function_ref;
 using base::Range;
 using geometry::Normed;
 
-template<typename Argument, typename Value, typename Samples>
-std::list<typename Samples::const_iterator> FitHermiteSpline(
-    Samples const& samples,
-    std::function<Argument const&(typename Samples::value_type const&)> const&
-        get_argument,
-    std::function<Value const&(typename Samples::value_type const&)> const&
-        get_value,
-    std::function<Derivative<Value, Argument> const&(
-        typename Samples::value_type const&)> const& get_derivative,
-    typename Normed<Difference<Value>>::NormType const& tolerance) {
-  using Iterator = typename Samples::const_iterator;
-
-  auto interpolation_error = [get_argument, get_derivative, get_value](
-                                 Iterator begin, Iterator last) {
-    return Hermite3<Argument, Value>(
-               {get_argument(*begin), get_argument(*last)},
-               {get_value(*begin), get_value(*last)},
-               {get_derivative(*begin), get_derivative(*last)})
-        .LInfinityError(Range(begin, last + 1), get_argument, get_value);
-  };
-
-  std::list<Iterator> tail;
-  if (samples.size() < 3) {
+// The implementation of |FitHermiteSpline| on the indices of the
+// |samples_size| samples.  |interpolation_error(begin, last)| returns the error
+// of the |Hermite3| interpolation of the samples |begin| and |last| on the
+// samples in [begin, last].
+template<typename NormType, typename InterpolationError>
+std::vector<std::int64_t> FitHermiteSplineIndices(
+    std::int64_t const samples_size,
+    InterpolationError const& interpolation_error,
+    NormType const& tolerance) {
+  std::vector<std::int64_t> tail;
+  if (samples_size < 3) {
     // With 0 or 1 points there is nothing to interpolate, with 2 we cannot
     // estimate the error.
     return tail;
   }
 
-  Iterator begin = samples.begin();
-  Iterator const last = samples.end() - 1;
+  std::int64_t begin = 0;
+  std::int64_t const last = samples_size - 1;
   while (last - begin + 1 >= 3 &&
          interpolation_error(begin, last) >= tolerance) {
     // Look for a cubic that fits the beginning within |tolerance| and
@@ -55,8 +47,8 @@ std::list<typename Samples::const_iterator> FitHermiteSpline(
 
     // Invariant: The Hermite interpolant on [begin, lower] is below the
     // tolerance, the Hermite interpolant on [begin, upper] is above.
-    Iterator lower = begin + 1;
-    Iterator upper = last;
+    std::int64_t lower = begin + 1;
+    std::int64_t upper = last;
     for (;;) {
       auto const middle = lower + (upper - lower) / 2;
       // Note that lower ≤ middle ≤ upper.
@@ -82,10 +74,79 @@ std::list<typename Samples::const_iterator> FitHermiteSpline(
   // If downsampling is not effective we'll output one iterator for each input
   // point, except at the end where we give up because we don't have enough
   // points left.
-  CHECK_LT(tail.size(), samples.size() - 2);
+  CHECK_LT(static_cast<std::int64_t>(tail.size()), samples_size - 2);
   return tail;
 }
 
+template<typename Argument, typename Value, typename Samples>
+std::list<typename Samples::const_iterator> FitHermiteSpline(
+    Samples const& samples,
+    function_ref<Argument const&(typename Samples::value_type const&)>
+        get_argument,
+    function_ref<Value const&(typename Samples::value_type const&)> get_value,
+    function_ref<Derivative<Value, Argument> const&(
+        typename Samples::value_type const&)> get_derivative,
+    typename Normed<Difference<Value>>::NormType const& tolerance) {
+  using Iterator = typename Samples::const_iterator;
+
+  auto interpolation_error = [&samples,
+                              get_argument,
+                              get_derivative,
+                              get_value](std::int64_t const begin_index,
+                                         std::int64_t const last_index) {
+    Iterator const begin = samples.begin() + begin_index;
+    Iterator const last = samples.begin() + last_index;
+    return Hermite3<Argument, Value>(
+               {get_argument(*begin), get_argument(*last)},
+               {get_value(*begin), get_value(*last)},
+               {get_derivative(*begin), get_derivative(*last)})
+        .LInfinityError(Range(begin, last + 1), get_argument, get_value);
+  };
+
+  std::list<Iterator> tail;
+  for (std::int64_t const index : FitHermiteSplineIndices(
+           static_cast<std::int64_t>(samples.size()),
+           interpolation_error,
+           tolerance)) {
+    tail.push_back(samples.begin() + index);
+  }
+  return tail;
+}
+
+template<typename Argument, typename Value>
+std::vector<std::int64_t> FitHermiteSpline(
+    std::vector<Argument> const& arguments,
+    std::vector<Value> const& values,
+    std::vector<Derivative<Value, Argument>> const& derivatives,
+    typename Normed<Difference<Value>>::NormType const& tolerance) {
+  using NormType = typename Normed<Difference<Value>>::NormType;
+  CHECK_EQ(arguments.size(), values.size());
+  CHECK_EQ(arguments.size(), derivatives.size());
+
+  auto interpolation_error = [&arguments, &derivatives, &values](
+                                 std::int64_t const begin,
+                                 std::int64_t const last) {
+    Hermite3<Argument, Value> const hermite3(
+        {arguments[begin], arguments[last]},
+        {values[begin], values[last]},
+        {derivatives[begin], derivatives[last]});
+    Argument const* const a = arguments.data();
+    Value const* const v = values.data();
+    NormType result{};
+    for (std::int64_t i = begin; i <= last; ++i) {
+      result = std::max(
+          result,
+          Normed<Difference<Value>>::Norm(hermite3.Evaluate(a[i]) - v[i]));
+    }
+    return result;
+  };
+
+  return FitHermiteSplineIndices(
+      static_cast<std::int64_t>(arguments.size()),
+      interpolation_error,
+      tolerance);
+}
+
 }  // namespace internal_fit_hermite_spline
 }  // namespace numerics
 }  // namespace principia
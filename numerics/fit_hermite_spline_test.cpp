@@ -1,6 +1,7 @@
 ﻿
 #include "numerics/fit_hermite_spline.hpp"
 
+#include <cstdint>
 #include <list>
 #include <vector>
 
@@ -111,6 +112,47 @@ TEST_F(FitHermiteSplineTest, Sinusoid) {
               IsNear(100 * Nano(Metre), 2.0));
 }
 
+TEST_F(FitHermiteSplineTest, Arrays) {
+  AngularFrequency const ω = 1 * Radian / Second;
+  auto const f = [ω, this](Instant const& t) {
+    return Cos(ω * (t - t0_)) * Metre;
+  };
+  auto const df = [ω, this](Instant const& t) {
+    return -ω * Sin(ω *(t - t0_)) * Metre / Radian;
+  };
+  std::vector<Sample> samples;
+  std::vector<Instant> arguments;
+  std::vector<Length> values;
+  std::vector<Speed> derivatives;
+  {
+    auto t = DoublePrecision<Instant>(t0_);
+    for (; t.value < t0_ + 4 * π * Second; t.Increment(10 * Milli(Second))) {
+      samples.push_back({t.value, f(t.value), df(t.value)});
+      arguments.push_back(t.value);
+      values.push_back(f(t.value));
+      derivatives.push_back(df(t.value));
+    }
+  }
+  std::list<std::vector<Sample>::const_iterator> const interpolation_points =
+      FitHermiteSpline<Instant, Length>(
+          samples,
+          [](auto&& sample) -> auto&& { return sample.t; },
+          [](auto&& sample) -> auto&& { return sample.x; },
+          [](auto&& sample) -> auto&& { return sample.v; },
+          1 * Milli(Metre));
+  std::vector<std::int64_t> const interpolation_indices =
+      FitHermiteSpline<Instant, Length>(
+          arguments, values, derivatives, 1 * Milli(Metre));
+
+  ASSERT_EQ(interpolation_points.size(), interpolation_indices.size());
+  EXPECT_LT(10, interpolation_indices.size());
+  auto it = interpolation_points.begin();
+  for (std::int64_t const index : interpolation_indices) {
+    EXPECT_EQ(*it - samples.cbegin(), index);
+    ++it;
+  }
+}
+
 TEST_F(FitHermiteSplineDeathTest, NoDownsampling) {
   AngularFrequency const ω = 1 * Radian / Second;
   auto const f = [ω, this](Instant const& t) {
@@ -6,12 +6,27 @@
 #include <algorithm>
 #include <vector>
 
+#include "base/macros.hpp"
 #include "glog/logging.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/traits.hpp"
 
 namespace principia {
 namespace numerics {
 namespace internal_fixed_arrays {
 
+using quantities::FusedMultiplyAdd;
+using quantities::is_quantity;
+
+// Whether the products of |ScalarLeft| and |ScalarRight| are fused with the
+// additions of the dot product.  This is done for |double| and |Quantity|
+// scalars when the compiler targets FMA.  The terms are accumulated in the same
+// order either way.
+template<typename ScalarLeft, typename ScalarRight>
+constexpr bool use_fma = PRINCIPIA_USE_FMA_INTRINSICS &&
+                         is_quantity<ScalarLeft>::value &&
+                         is_quantity<ScalarRight>::value;
+
 // A helper class to compute the dot product of two arrays.  |ScalarLeft| and
 // |ScalarRight| are the types of the elements of the arrays.  |Left| and
 // |Right| are the (deduced) types of the arrays.  They must both have an
@@ -35,8 +50,17 @@ template<typename Left, typename Right>
 Product<ScalarLeft, ScalarRight>
 DotProduct<ScalarLeft, ScalarRight, size, i>::Compute(Left const& left,
                                                       Right const& right) {
-  return left[i] * right[i] +
-         DotProduct<ScalarLeft, ScalarRight, size, i - 1>::Compute(left, right);
+  if constexpr (use_fma<ScalarLeft, ScalarRight>) {
+    return FusedMultiplyAdd(
+        left[i],
+        right[i],
+        DotProduct<ScalarLeft, ScalarRight, size, i - 1>::Compute(left,
+                                                                  right));
+  } else {
+    return left[i] * right[i] +
+           DotProduct<ScalarLeft, ScalarRight, size, i - 1>::Compute(left,
+                                                                     right);
+  }
 }
 
 template<typename ScalarLeft, typename ScalarRight, int size>
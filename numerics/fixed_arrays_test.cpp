@@ -1,11 +1,21 @@
 ﻿
 #include "numerics/fixed_arrays.hpp"
 
+#include <limits>
+
+#include "base/macros.hpp"
 #include "gtest/gtest.h"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
 
 namespace principia {
 namespace numerics {
 
+using quantities::Length;
+using quantities::si::Metre;
+
+constexpr double ε = std::numeric_limits<double>::epsilon();
+
 class FixedArraysTest : public ::testing::Test {
  protected:
   FixedArraysTest()
@@ -64,6 +74,23 @@ TEST_F(FixedArraysTest, Multiplication) {
   EXPECT_EQ(v3_, m34_ * v4_);
 }
 
+TEST_F(FixedArraysTest, QuantityMultiplication) {
+  FixedVector<Length, 4> const l4(
+      {-3 * Metre, -3 * Metre, 1 * Metre, 4 * Metre});
+  FixedVector<Length, 3> const l3({10 * Metre, 31 * Metre, -47 * Metre});
+  EXPECT_EQ(l3, m34_ * l4);
+
+  // With FMA the last product is not rounded and the result is exact.
+  FixedMatrix<double, 1, 2> const m({-1, 1 + ε});
+  FixedVector<double, 2> const v({1, 1 - ε});
+  double const exact = -ε * ε;
+  if (PRINCIPIA_USE_FMA_INTRINSICS) {
+    EXPECT_EQ(exact, (m * v)[0]);
+  } else {
+    EXPECT_EQ(0, (m * v)[0]);
+  }
+}
+
 TEST_F(FixedArraysTest, VectorIndexing) {
   EXPECT_EQ(31, v3_[1]);
   v3_[2] = -666;
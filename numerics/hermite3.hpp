@@ -1,11 +1,11 @@
 ﻿
 #pragma once
 
-#include <functional>
 #include <utility>
 #include <vector>
 
 #include "base/array.hpp"
+#include "base/function.hpp"
 #include "geometry/named_quantities.hpp"
 #include "quantities/named_quantities.hpp"
 
@@ -14,6 +14,7 @@ namespace numerics {
 namespace internal_hermite3 {
 
 using base::BoundedArray;
+using base::function_ref;
 using quantities::Derivative;
 using quantities::Difference;
 using geometry::Normed;
@@ -46,9 +47,9 @@ class Hermite3 final {
   template<typename Samples>
   typename Normed<Difference<Value>>::NormType LInfinityError(
       Samples const& samples,
-      std::function<Argument const&(typename Samples::value_type const&)> const&
+      function_ref<Argument const&(typename Samples::value_type const&)>
           get_argument,
-      std::function<Value const&(typename Samples::value_type const&)> const&
+      function_ref<Value const&(typename Samples::value_type const&)>
           get_value) const;
 
  private:
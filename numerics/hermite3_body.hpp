@@ -69,9 +69,9 @@ template<typename Samples>
 typename Normed<Difference<Value>>::NormType
 Hermite3<Argument, Value>::LInfinityError(
     Samples const& samples,
-    std::function<Argument const&(
-        typename Samples::value_type const&)> const& get_argument,
-    std::function<Value const&(typename Samples::value_type const&)> const&
+    function_ref<Argument const&(typename Samples::value_type const&)>
+        get_argument,
+    function_ref<Value const&(typename Samples::value_type const&)>
         get_value) const {
   typename Normed<Difference<Value>>::NormType result{};
   for (const auto& sample : samples) {
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -18,6 +19,10 @@ using base::not_null;
 using geometry::Instant;
 using quantities::Variation;
 
+// The number of intervals into which [t_min, t_max] is divided by the samples
+// passed to the functions below.  There are |newhall_divisions + 1| samples.
+constexpr int newhall_divisions = 8;
+
 // Computes a Newhall approximation of the given |degree| in the Чебышёв basis.
 // |q| and |v| are the positions and velocities over a constant division of
 // [t_min, t_max].  |error_estimate| gives an estimate of the error between the
@@ -45,6 +50,18 @@ NewhallApproximationInMonomialBasis(std::vector<Vector> const& q,
                                     Instant const& t_max,
                                     Vector& error_estimate);
 
+// Same as above but the samples are in fixed-size arrays.  This overload
+// performs no heap allocation.
+template<typename Vector, int degree,
+         template<typename, typename, int> class Evaluator>
+PolynomialInMonomialBasis<Vector, Instant, degree, Evaluator>
+NewhallApproximationInMonomialBasis(
+    std::array<Vector, newhall_divisions + 1> const& q,
+    std::array<Variation<Vector>, newhall_divisions + 1> const& v,
+    Instant const& t_min,
+    Instant const& t_max,
+    Vector& error_estimate);
+
 // Same as above but the |degree| is not a constant expression.
 template<typename Vector,
          template<typename, typename, int> class Evaluator>
@@ -60,6 +77,7 @@ NewhallApproximationInMonomialBasis(int degree,
 
 using internal_newhall::NewhallApproximationInЧебышёвBasis;
 using internal_newhall::NewhallApproximationInMonomialBasis;
+using internal_newhall::newhall_divisions;
 
 }  // namespace numerics
 }  // namespace principia
@@ -2,6 +2,7 @@
 
 #include "numerics/newhall.hpp"
 
+#include <array>
 #include <vector>
 
 #include "geometry/barycentre_calculator.hpp"
@@ -21,7 +22,15 @@ using quantities::Frequency;
 using quantities::Time;
 
 // Only supports 8 divisions for now.
-constexpr int divisions = 8;
+constexpr int divisions = newhall_divisions;
+
+// Returns the samples in the order and with the scaling expected by Newhall's
+// matrices.  |Q| and |V| may be |std::vector| or |std::array|.
+template<typename Vector, typename Q, typename V>
+FixedVector<Vector, 2 * divisions + 2> NewhallSamples(
+    Q const& q,
+    V const& v,
+    Time const& duration_over_two);
 
 template<typename Vector, int degree,
          template<typename, typename, int> class Evaluator>
@@ -101,6 +110,23 @@ struct NewhallAppromixator {
       Vector& error_estimate);
 };
 
+template<typename Vector, typename Q, typename V>
+FixedVector<Vector, 2 * divisions + 2> NewhallSamples(
+    Q const& q,
+    V const& v,
+    Time const& duration_over_two) {
+  // Tricky.  The order in Newhall's matrices is such that the entries for the
+  // largest time occur first.
+  FixedVector<Vector, 2 * divisions + 2> qv;
+  for (int i = 0, j = 2 * divisions;
+       i < divisions + 1 && j >= 0;
+       ++i, j -= 2) {
+    qv[j] = q[i];
+    qv[j + 1] = v[i] * duration_over_two;
+  }
+  return qv;
+}
+
 #define PRINCIPIA_NEWHALL_APPROXIMATOR_SPECIALIZATION(degree)                  \
   template<typename Vector,                                                    \
            template<typename, typename, int> class Evaluator>                  \
@@ -151,16 +177,7 @@ NewhallApproximationInЧебышёвBasis(int degree,
   CHECK_EQ(divisions + 1, v.size());
 
   Time const duration_over_two = 0.5 * (t_max - t_min);
-
-  // Tricky.  The order in Newhall's matrices is such that the entries for the
-  // largest time occur first.
-  FixedVector<Vector, 2 * divisions + 2> qv;
-  for (int i = 0, j = 2 * divisions;
-       i < divisions + 1 && j >= 0;
-       ++i, j -= 2) {
-    qv[j] = q[i];
-    qv[j + 1] = v[i] * duration_over_two;
-  }
+  auto const qv = NewhallSamples<Vector>(q, v, duration_over_two);
 
   std::vector<Vector> coefficients;
   coefficients.reserve(degree);
@@ -203,21 +220,32 @@ NewhallApproximationInMonomialBasis(std::vector<Vector> const& q,
   CHECK_EQ(divisions + 1, v.size());
 
   Time const duration_over_two = 0.5 * (t_max - t_min);
+  Instant const t_mid = Barycentre<Instant, double>({t_min, t_max}, {1, 1});
+  return Dehomogeneize<Vector, degree, Evaluator>(
+             NewhallAppromixator<Vector, degree, Evaluator>::
+                 HomogeneousCoefficients(
+                     NewhallSamples<Vector>(q, v, duration_over_two),
+                     error_estimate),
+             /*scale=*/1.0 / duration_over_two,
+             t_mid);
+}
 
-  // Tricky.  The order in Newhall's matrices is such that the entries for the
-  // largest time occur first.
-  FixedVector<Vector, 2 * divisions + 2> qv;
-  for (int i = 0, j = 2 * divisions;
-       i < divisions + 1 && j >= 0;
-       ++i, j -= 2) {
-    qv[j] = q[i];
-    qv[j + 1] = v[i] * duration_over_two;
-  }
-
+template<typename Vector, int degree,
+         template<typename, typename, int> class Evaluator>
+PolynomialInMonomialBasis<Vector, Instant, degree, Evaluator>
+NewhallApproximationInMonomialBasis(
+    std::array<Vector, newhall_divisions + 1> const& q,
+    std::array<Variation<Vector>, newhall_divisions + 1> const& v,
+    Instant const& t_min,
+    Instant const& t_max,
+    Vector& error_estimate) {
+  Time const duration_over_two = 0.5 * (t_max - t_min);
   Instant const t_mid = Barycentre<Instant, double>({t_min, t_max}, {1, 1});
   return Dehomogeneize<Vector, degree, Evaluator>(
              NewhallAppromixator<Vector, degree, Evaluator>::
-                 HomogeneousCoefficients(qv, error_estimate),
+                 HomogeneousCoefficients(
+                     NewhallSamples<Vector>(q, v, duration_over_two),
+                     error_estimate),
              /*scale=*/1.0 / duration_over_two,
              t_mid);
 }
@@ -2,6 +2,7 @@
 #include "numerics/newhall.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <vector>
 
@@ -768,5 +769,36 @@ TEST_F(NewhallTest, NonConstantDegree) {
                               length_function_1_(t_min_)), IsNear(9e-13));
 }
 
+TEST_F(NewhallTest, FixedSizeSamples) {
+  std::vector<Length> lengths;
+  std::vector<Speed> speeds;
+  std::array<Length, newhall_divisions + 1> length_array;
+  std::array<Speed, newhall_divisions + 1> speed_array;
+  int i = 0;
+  for (Instant t = t_min_; t <= t_max_; t += 0.5 * Second, ++i) {
+    lengths.push_back(length_function_1_(t));
+    speeds.push_back(speed_function_1_(t));
+    length_array[i] = lengths.back();
+    speed_array[i] = speeds.back();
+  }
+  EXPECT_EQ(newhall_divisions + 1, i);
+
+  Length vector_error_estimate;
+  Length array_error_estimate;
+  auto const vector_approximation =
+      NewhallApproximationInMonomialBasis<Length, 10, EstrinEvaluator>(
+          lengths, speeds, t_min_, t_max_, vector_error_estimate);
+  auto const array_approximation =
+      NewhallApproximationInMonomialBasis<Length, 10, EstrinEvaluator>(
+          length_array, speed_array, t_min_, t_max_, array_error_estimate);
+
+  // The two overloads compute the same thing.
+  EXPECT_EQ(vector_error_estimate, array_error_estimate);
+  for (Instant t = t_min_; t <= t_max_; t += 0.05 * Second) {
+    EXPECT_EQ(vector_approximation.Evaluate(t),
+              array_approximation.Evaluate(t));
+  }
+}
+
 }  // namespace numerics
 }  // namespace principia
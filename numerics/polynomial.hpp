@@ -3,6 +3,7 @@
 
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "base/not_null.hpp"
 #include "geometry/point.hpp"
@@ -44,6 +45,15 @@ class Polynomial {
   virtual Value Evaluate(Argument const& argument) const = 0;
   virtual Derivative<Value, Argument> EvaluateDerivative(
       Argument const& argument) const = 0;
+  // Equivalent to |Evaluate| followed by |EvaluateDerivative|, but faster.
+  virtual void EvaluateWithDerivative(
+      Argument const& argument,
+      Value& value,
+      Derivative<Value, Argument>& derivative) const = 0;
+  // Evaluates the polynomial at each of the |arguments|, with a single virtual
+  // call.  |values| is resized to the size of |arguments|.
+  virtual void Evaluate(std::vector<Argument> const& arguments,
+                        std::vector<Value>& values) const = 0;
 
   // Only useful for benchmarking or analyzing performance.  Do not use in real
   // code.
@@ -79,9 +89,17 @@ class PolynomialInMonomialBasis : public Polynomial<Value, Argument> {
   Evaluate(Argument const& argument) const override;
   FORCE_INLINE(inline) Derivative<Value, Argument>
   EvaluateDerivative(Argument const& argument) const override;
+  FORCE_INLINE(inline) void EvaluateWithDerivative(
+      Argument const& argument,
+      Value& value,
+      Derivative<Value, Argument>& derivative) const override;
+  void Evaluate(std::vector<Argument> const& arguments,
+                std::vector<Value>& values) const override;
 
   constexpr int degree() const override;
 
+  Coefficients const& coefficients() const;
+
   void WriteToMessage(
       not_null<serialization::Polynomial*> message) const override;
   static PolynomialInMonomialBasis ReadFromMessage(
@@ -114,9 +132,18 @@ class PolynomialInMonomialBasis<Value, Point<Argument>, degree_, Evaluator>
   Evaluate(Point<Argument> const& argument) const override;
   FORCE_INLINE(inline) Derivative<Value, Argument>
   EvaluateDerivative(Point<Argument> const& argument) const override;
+  FORCE_INLINE(inline) void EvaluateWithDerivative(
+      Point<Argument> const& argument,
+      Value& value,
+      Derivative<Value, Argument>& derivative) const override;
+  void Evaluate(std::vector<Point<Argument>> const& arguments,
+                std::vector<Value>& values) const override;
 
   constexpr int degree() const override;
 
+  Coefficients const& coefficients() const;
+  Point<Argument> const& origin() const;
+
   void WriteToMessage(
       not_null<serialization::Polynomial*> message) const override;
   static PolynomialInMonomialBasis ReadFromMessage(
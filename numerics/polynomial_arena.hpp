@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+#include "base/not_null.hpp"
+#include "base/segmented_vector.hpp"
+#include "base/snapshot.hpp"
+#include "numerics/polynomial.hpp"
+#include "quantities/named_quantities.hpp"
+#include "serialization/numerics.pb.h"
+
+namespace principia {
+namespace numerics {
+namespace internal_polynomial_arena {
+
+using base::not_null;
+using base::SegmentedVector;
+using base::SnapshotReader;
+using base::SnapshotWriter;
+using quantities::Derivative;
+
+// A container for the polynomials of a piecewise approximation.  The
+// polynomials in the monomial basis with the given |Evaluator| and with a
+// degree in [min_degree, max_degree] are stored by value, in one segmented
+// array per degree, so that evaluating them doesn't entail an indirection
+// through the heap nor a virtual call.  Polynomials are added at the back of
+// the arena and removed from its front or its back.
+// The polynomials never move, so |PushBack| and |ReadFromSnapshot| may be
+// called concurrently with the const member functions, for handles obtained
+// before the call.  The other non-const member functions require exclusive
+// access.
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+class PolynomialArena final {
+  static_assert(0 < min_degree && min_degree <= max_degree,
+                "Invalid range of degrees");
+
+ public:
+  // Designates a polynomial stored in the arena.  A handle remains valid until
+  // the polynomial that it designates is removed.
+  struct Handle final {
+    int degree = 0;
+    std::int64_t ordinal = 0;
+  };
+
+  // If |polynomial| can be stored in the arena, stores a copy of it after the
+  // polynomials of the same degree and returns a handle to the copy.
+  // Otherwise, returns |std::nullopt|.
+  std::optional<Handle> PushBack(Polynomial<Value, Argument> const& polynomial);
+
+  // Removes the polynomial designated by |handle|, which must be the last
+  // (resp. first) polynomial of its degree.  Amortized time complexity is O(1).
+  void PopBack(Handle const& handle);
+  void PopFront(Handle const& handle);
+
+  Value Evaluate(Handle const& handle, Argument const& argument) const;
+  Derivative<Value, Argument> EvaluateDerivative(
+      Handle const& handle,
+      Argument const& argument) const;
+  void EvaluateWithDerivative(Handle const& handle,
+                              Argument const& argument,
+                              Value& value,
+                              Derivative<Value, Argument>& derivative) const;
+
+  void WriteToMessage(Handle const& handle,
+                      not_null<serialization::Polynomial*> message) const;
+
+  // Writes the degree, the origin and the coefficients of the polynomial
+  // designated by |handle| to |writer|.  |ReadFromSnapshot| appends a copy of
+  // that polynomial to the arena, without going through a |Polynomial| object.
+  // Only available if |Argument| is a |Point|.
+  void WriteToSnapshot(Handle const& handle, SnapshotWriter& writer) const;
+  Handle ReadFromSnapshot(SnapshotReader& reader);
+
+  // The number of bytes allocated by the arena for storing the polynomials.
+  // Only useful for benchmarking or analyzing performance.
+  std::int64_t memory_footprint() const;
+
+ private:
+  // The class is final so that the calls to |Evaluate| and
+  // |EvaluateDerivative| are devirtualized and inlined.
+  template<int degree>
+  class Element final
+      : public PolynomialInMonomialBasis<Value, Argument, degree, Evaluator> {
+   public:
+    using Base = PolynomialInMonomialBasis<Value, Argument, degree, Evaluator>;
+    explicit Element(Base const& base);
+  };
+
+  template<int degree_>
+  struct Slab final {
+    static constexpr int degree = degree_;
+    // The ordinal of |polynomials[0]|.
+    std::int64_t first_ordinal = 0;
+    SegmentedVector<Element<degree>> polynomials;
+  };
+
+  template<typename Sequence>
+  struct SlabsGenerator;
+  template<int... indices>
+  struct SlabsGenerator<std::integer_sequence<int, indices...>> {
+    using Type = std::tuple<Slab<min_degree + indices>...>;
+  };
+  using Slabs = typename SlabsGenerator<
+      std::make_integer_sequence<int, max_degree - min_degree + 1>>::Type;
+
+  // Calls |function| with the slab for the given |degree|, which must be in
+  // [min_degree, max_degree].  |slabs| may be const or not.
+  template<int slab_degree = min_degree, typename S, typename Function>
+  static auto VisitSlab(S& slabs, int degree, Function const& function);
+
+  // The evaluation functions for the polynomials of the slab for |degree|.
+  template<int degree>
+  static Value EvaluateInSlab(Slabs const& slabs,
+                              Handle const& handle,
+                              Argument const& argument);
+  template<int degree>
+  static Derivative<Value, Argument> EvaluateDerivativeInSlab(
+      Slabs const& slabs,
+      Handle const& handle,
+      Argument const& argument);
+  template<int degree>
+  static void EvaluateWithDerivativeInSlab(
+      Slabs const& slabs,
+      Handle const& handle,
+      Argument const& argument,
+      Value& value,
+      Derivative<Value, Argument>& derivative);
+
+  // Tables of the above functions, indexed by |degree - min_degree|.  The
+  // evaluations, which are on the hot path of the trajectories, use them
+  // instead of |VisitSlab|, so that dispatching on the degree is a single
+  // indirect call instead of a chain of comparisons.
+  template<typename Sequence>
+  struct DispatchTablesGenerator;
+  template<int... indices>
+  struct DispatchTablesGenerator<std::integer_sequence<int, indices...>> {
+    static constexpr std::array<
+        Value (*)(Slabs const&, Handle const&, Argument const&),
+        sizeof...(indices)> evaluate = {
+        &EvaluateInSlab<min_degree + indices>...};
+    static constexpr std::array<
+        Derivative<Value, Argument> (*)(Slabs const&,
+                                        Handle const&,
+                                        Argument const&),
+        sizeof...(indices)> evaluate_derivative = {
+        &EvaluateDerivativeInSlab<min_degree + indices>...};
+    static constexpr std::array<
+        void (*)(Slabs const&,
+                 Handle const&,
+                 Argument const&,
+                 Value&,
+                 Derivative<Value, Argument>&),
+        sizeof...(indices)> evaluate_with_derivative = {
+        &EvaluateWithDerivativeInSlab<min_degree + indices>...};
+  };
+  using DispatchTables = DispatchTablesGenerator<
+      std::make_integer_sequence<int, max_degree - min_degree + 1>>;
+
+  Slabs slabs_;
+};
+
+}  // namespace internal_polynomial_arena
+
+using internal_polynomial_arena::PolynomialArena;
+
+}  // namespace numerics
+}  // namespace principia
+
+#include "numerics/polynomial_arena_body.hpp"
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "numerics/polynomial_arena.hpp"
+
+#include <type_traits>
+
+#include "geometry/serialization.hpp"
+#include "glog/logging.h"
+
+namespace principia {
+namespace numerics {
+namespace internal_polynomial_arena {
+
+using geometry::DoubleOrQuantityOrPointOrMultivectorSnapshotter;
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+template<int degree>
+PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+Element<degree>::Element(Base const& base)
+    : Base(base) {}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+auto PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+PushBack(Polynomial<Value, Argument> const& polynomial)
+    -> std::optional<Handle> {
+  int const degree = polynomial.degree();
+  if (degree < min_degree || degree > max_degree) {
+    return std::nullopt;
+  }
+  return VisitSlab(
+      slabs_,
+      degree,
+      [&polynomial](auto& slab) -> std::optional<Handle> {
+        using Base = typename std::decay_t<
+            decltype(slab.polynomials)>::value_type::Base;
+        auto const* const monomial = dynamic_cast<Base const*>(&polynomial);
+        if (monomial == nullptr) {
+          return std::nullopt;
+        }
+        slab.polynomials.emplace_back(*monomial);
+        return Handle{slab.degree,
+                      slab.first_ordinal +
+                          static_cast<std::int64_t>(slab.polynomials.size()) -
+                          1};
+      });
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+void PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+PopBack(Handle const& handle) {
+  VisitSlab(slabs_, handle.degree, [&handle](auto& slab) {
+    std::int64_t const size = slab.polynomials.size();
+    CHECK_LT(0, size);
+    CHECK_EQ(slab.first_ordinal + size - 1, handle.ordinal);
+    slab.polynomials.pop_back();
+  });
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+void PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+PopFront(Handle const& handle) {
+  VisitSlab(slabs_, handle.degree, [&handle](auto& slab) {
+    CHECK(!slab.polynomials.empty());
+    CHECK_EQ(slab.first_ordinal, handle.ordinal);
+    slab.polynomials.pop_front();
+    ++slab.first_ordinal;
+  });
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+Value PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+Evaluate(Handle const& handle, Argument const& argument) const {
+  DCHECK_LE(min_degree, handle.degree);
+  DCHECK_GE(max_degree, handle.degree);
+  return DispatchTables::evaluate[handle.degree - min_degree](
+      slabs_, handle, argument);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+Derivative<Value, Argument>
+PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+EvaluateDerivative(Handle const& handle, Argument const& argument) const {
+  DCHECK_LE(min_degree, handle.degree);
+  DCHECK_GE(max_degree, handle.degree);
+  return DispatchTables::evaluate_derivative[handle.degree - min_degree](
+      slabs_, handle, argument);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+void PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+EvaluateWithDerivative(Handle const& handle,
+                       Argument const& argument,
+                       Value& value,
+                       Derivative<Value, Argument>& derivative) const {
+  DCHECK_LE(min_degree, handle.degree);
+  DCHECK_GE(max_degree, handle.degree);
+  DispatchTables::evaluate_with_derivative[handle.degree - min_degree](
+      slabs_, handle, argument, value, derivative);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+void PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+WriteToMessage(Handle const& handle,
+               not_null<serialization::Polynomial*> const message) const {
+  VisitSlab(slabs_, handle.degree, [&handle, message](auto& slab) {
+    slab.polynomials[handle.ordinal - slab.first_ordinal].WriteToMessage(
+        message);
+  });
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+void PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+WriteToSnapshot(Handle const& handle, SnapshotWriter& writer) const {
+  writer.Write<std::int32_t>(handle.degree);
+  VisitSlab(slabs_, handle.degree, [&handle, &writer](auto& slab) {
+    auto const& polynomial =
+        slab.polynomials[handle.ordinal - slab.first_ordinal];
+    DoubleOrQuantityOrPointOrMultivectorSnapshotter<
+        Argument>::WriteToSnapshot(polynomial.origin(), writer);
+    std::apply(
+        [&writer](auto const&... coefficients) {
+          (DoubleOrQuantityOrPointOrMultivectorSnapshotter<
+               std::decay_t<decltype(coefficients)>>::
+               WriteToSnapshot(coefficients, writer), ...);
+        },
+        polynomial.coefficients());
+  });
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+auto PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+ReadFromSnapshot(SnapshotReader& reader) -> Handle {
+  int const degree = reader.Read<std::int32_t>();
+  CHECK_LE(min_degree, degree);
+  CHECK_GE(max_degree, degree);
+  return VisitSlab(slabs_, degree, [&reader](auto& slab) {
+    using Base = typename std::decay_t<
+        decltype(slab.polynomials)>::value_type::Base;
+    auto const origin = DoubleOrQuantityOrPointOrMultivectorSnapshotter<
+        Argument>::ReadFromSnapshot(reader);
+    typename Base::Coefficients coefficients;
+    std::apply(
+        [&reader](auto&... coefficient) {
+          ((coefficient = DoubleOrQuantityOrPointOrMultivectorSnapshotter<
+                std::decay_t<decltype(coefficient)>>::
+                ReadFromSnapshot(reader)), ...);
+        },
+        coefficients);
+    slab.polynomials.emplace_back(Base(coefficients, origin));
+    return Handle{slab.degree,
+                  slab.first_ordinal +
+                      static_cast<std::int64_t>(slab.polynomials.size()) - 1};
+  });
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+std::int64_t
+PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+memory_footprint() const {
+  std::int64_t footprint = 0;
+  std::apply(
+      [&footprint](auto const&... slab) {
+        ((footprint += slab.polynomials.memory_footprint()), ...);
+      },
+      slabs_);
+  return footprint;
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+template<int slab_degree, typename S, typename Function>
+auto PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+VisitSlab(S& slabs, int const degree, Function const& function) {
+  if constexpr (slab_degree < max_degree) {
+    if (degree != slab_degree) {
+      return VisitSlab<slab_degree + 1>(slabs, degree, function);
+    }
+  }
+  DCHECK_EQ(slab_degree, degree);
+  return function(std::get<slab_degree - min_degree>(slabs));
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+template<int degree>
+Value PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+EvaluateInSlab(Slabs const& slabs,
+               Handle const& handle,
+               Argument const& argument) {
+  auto const& slab = std::get<degree - min_degree>(slabs);
+  return slab.polynomials[handle.ordinal - slab.first_ordinal].Evaluate(
+      argument);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+template<int degree>
+Derivative<Value, Argument>
+PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+EvaluateDerivativeInSlab(Slabs const& slabs,
+                         Handle const& handle,
+                         Argument const& argument) {
+  auto const& slab = std::get<degree - min_degree>(slabs);
+  return slab.polynomials[handle.ordinal - slab.first_ordinal].
+             EvaluateDerivative(argument);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree,
+         template<typename, typename, int> class Evaluator>
+template<int degree>
+void PolynomialArena<Value, Argument, min_degree, max_degree, Evaluator>::
+EvaluateWithDerivativeInSlab(Slabs const& slabs,
+                             Handle const& handle,
+                             Argument const& argument,
+                             Value& value,
+                             Derivative<Value, Argument>& derivative) {
+  auto const& slab = std::get<degree - min_degree>(slabs);
+  slab.polynomials[handle.ordinal - slab.first_ordinal].
+      EvaluateWithDerivative(argument, value, derivative);
+}
+
+}  // namespace internal_polynomial_arena
+}  // namespace numerics
+}  // namespace principia
@@ -0,0 +1,187 @@
+#include "numerics/polynomial_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/array.hpp"
+#include "base/snapshot.hpp"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gtest/gtest.h"
+#include "numerics/polynomial_evaluators.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+#include "serialization/numerics.pb.h"
+#include "testing_utilities/matchers.hpp"
+
+namespace principia {
+
+using base::SnapshotReader;
+using base::SnapshotWriter;
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Instant;
+using geometry::Vector;
+using geometry::Velocity;
+using quantities::Acceleration;
+using quantities::si::Metre;
+using quantities::si::Second;
+using testing_utilities::EqualsProto;
+
+namespace numerics {
+
+class PolynomialArenaTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      serialization::Frame::TEST1, true>;
+
+  using Arena = PolynomialArena<Displacement<World>, Instant,
+                                /*min_degree=*/1, /*max_degree=*/3,
+                                EstrinEvaluator>;
+  using P1 = PolynomialInMonomialBasis<Displacement<World>, Instant, 1,
+                                       EstrinEvaluator>;
+  using P2 = PolynomialInMonomialBasis<Displacement<World>, Instant, 2,
+                                       EstrinEvaluator>;
+  using P2Horner = PolynomialInMonomialBasis<Displacement<World>, Instant, 2,
+                                             HornerEvaluator>;
+  using P4 = PolynomialInMonomialBasis<Displacement<World>, Instant, 4,
+                                       EstrinEvaluator>;
+
+  // A polynomial of degree 1 whose value at |t0_| is |i| metres.
+  P1 MakeP1(int const i) {
+    return P1({Displacement<World>({i * Metre, 0 * Metre, 0 * Metre}),
+               Velocity<World>({0 * Metre / Second,
+                                1 * Metre / Second,
+                                0 * Metre / Second})},
+              t0_);
+  }
+
+  // A polynomial of degree 2 whose value at |t0_| is |i| metres.
+  P2 MakeP2(int const i) {
+    return P2({Displacement<World>({i * Metre, 0 * Metre, 0 * Metre}),
+               Velocity<World>({0 * Metre / Second,
+                                1 * Metre / Second,
+                                0 * Metre / Second}),
+               Vector<Acceleration, World>({0 * Metre / Second / Second,
+                                            0 * Metre / Second / Second,
+                                            1 * Metre / Second / Second})},
+              t0_);
+  }
+
+  Instant const t0_;
+  Arena arena_;
+};
+
+TEST_F(PolynomialArenaTest, PushAndEvaluate) {
+  Instant const t1 = t0_ + 2 * Second;
+  std::vector<Arena::Handle> handles;
+  for (int i = 0; i < 10; ++i) {
+    if (i % 3 == 0) {
+      auto const handle = arena_.PushBack(MakeP2(i));
+      ASSERT_TRUE(handle.has_value());
+      EXPECT_EQ(2, handle->degree);
+      handles.push_back(*handle);
+    } else {
+      auto const handle = arena_.PushBack(MakeP1(i));
+      ASSERT_TRUE(handle.has_value());
+      EXPECT_EQ(1, handle->degree);
+      handles.push_back(*handle);
+    }
+  }
+  for (int i = 0; i < 10; ++i) {
+    std::unique_ptr<Polynomial<Displacement<World>, Instant>> polynomial;
+    if (i % 3 == 0) {
+      polynomial = std::make_unique<P2>(MakeP2(i));
+    } else {
+      polynomial = std::make_unique<P1>(MakeP1(i));
+    }
+    auto const& expected = *polynomial;
+    EXPECT_EQ(expected.Evaluate(t1), arena_.Evaluate(handles[i], t1));
+    EXPECT_EQ(expected.EvaluateDerivative(t1),
+              arena_.EvaluateDerivative(handles[i], t1));
+    Displacement<World> value;
+    Velocity<World> derivative;
+    arena_.EvaluateWithDerivative(handles[i], t1, value, derivative);
+    EXPECT_EQ(expected.Evaluate(t1), value);
+    EXPECT_EQ(expected.EvaluateDerivative(t1), derivative);
+    serialization::Polynomial expected_message;
+    serialization::Polynomial actual_message;
+    expected.WriteToMessage(&expected_message);
+    arena_.WriteToMessage(handles[i], &actual_message);
+    EXPECT_THAT(actual_message, EqualsProto(expected_message));
+  }
+  EXPECT_LE(4 * sizeof(P2) + 6 * sizeof(P1), arena_.memory_footprint());
+}
+
+TEST_F(PolynomialArenaTest, Unsupported) {
+  P2Horner const horner(P2Horner::Coefficients(), t0_);
+  EXPECT_FALSE(arena_.PushBack(horner).has_value());
+  P4 const p4(P4::Coefficients(), t0_);
+  EXPECT_FALSE(arena_.PushBack(p4).has_value());
+  EXPECT_EQ(0, arena_.memory_footprint());
+}
+
+TEST_F(PolynomialArenaTest, Pop) {
+  std::vector<Arena::Handle> handles;
+  for (int i = 0; i < 100; ++i) {
+    handles.push_back(*arena_.PushBack(MakeP1(i)));
+  }
+  // Pop most of the polynomials from the front, which frees some segments, and
+  // check that the handles are still valid.
+  for (int i = 0; i < 90; ++i) {
+    arena_.PopFront(handles[i]);
+  }
+  for (int i = 90; i < 100; ++i) {
+    EXPECT_EQ(i * Metre, arena_.Evaluate(handles[i], t0_).coordinates().x);
+  }
+
+  // Replace the last polynomial.
+  arena_.PopBack(handles.back());
+  handles.back() = *arena_.PushBack(MakeP1(1000));
+  EXPECT_EQ(1000 * Metre,
+            arena_.Evaluate(handles.back(), t0_).coordinates().x);
+  EXPECT_EQ(95 * Metre, arena_.Evaluate(handles[95], t0_).coordinates().x);
+
+  // Empty the arena and reuse it.
+  for (int i = 90; i < 100; ++i) {
+    arena_.PopFront(handles[i]);
+  }
+  auto const handle = *arena_.PushBack(MakeP1(7));
+  EXPECT_EQ(7 * Metre, arena_.Evaluate(handle, t0_).coordinates().x);
+}
+
+TEST_F(PolynomialArenaTest, Snapshot) {
+  Instant const t1 = t0_ + 3 * Second;
+  std::vector<Arena::Handle> handles;
+  handles.push_back(*arena_.PushBack(MakeP1(1)));
+  handles.push_back(*arena_.PushBack(MakeP2(2)));
+  handles.push_back(*arena_.PushBack(MakeP1(3)));
+  std::vector<std::uint8_t> bytes;
+  SnapshotWriter writer(&bytes);
+  for (auto const& handle : handles) {
+    arena_.WriteToSnapshot(handle, writer);
+  }
+
+  // Read from a misaligned copy of the bytes.
+  std::vector<std::uint8_t> misaligned(bytes.size() + 1);
+  std::copy(bytes.begin(), bytes.end(), misaligned.begin() + 1);
+  SnapshotReader reader(base::Array<std::uint8_t const>(misaligned.data() + 1,
+                                                        bytes.size()));
+  Arena arena;
+  for (auto const& handle : handles) {
+    auto const read_handle = arena.ReadFromSnapshot(reader);
+    EXPECT_EQ(handle.degree, read_handle.degree);
+    EXPECT_EQ(arena_.Evaluate(handle, t1), arena.Evaluate(read_handle, t1));
+    EXPECT_EQ(arena_.EvaluateDerivative(handle, t1),
+              arena.EvaluateDerivative(read_handle, t1));
+  }
+  EXPECT_EQ(0, reader.remaining());
+}
+
+}  // namespace numerics
+}  // namespace principia
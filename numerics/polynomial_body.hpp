@@ -2,7 +2,9 @@
 
 #include "numerics/polynomial.hpp"
 
+#include <cstddef>
 #include <tuple>
+#include <vector>
 
 #include "base/not_constructible.hpp"
 #include "geometry/serialization.hpp"
@@ -136,6 +138,28 @@ EvaluateDerivative(Argument const& argument) const {
       coefficients_, argument);
 }
 
+template<typename Value, typename Argument, int degree_,
+         template<typename, typename, int> class Evaluator>
+void PolynomialInMonomialBasis<Value, Argument, degree_, Evaluator>::
+EvaluateWithDerivative(Argument const& argument,
+                       Value& value,
+                       Derivative<Value, Argument>& derivative) const {
+  Evaluator<Value, Argument, degree_>::EvaluateWithDerivative(
+      coefficients_, argument, value, derivative);
+}
+
+template<typename Value, typename Argument, int degree_,
+         template<typename, typename, int> class Evaluator>
+void PolynomialInMonomialBasis<Value, Argument, degree_, Evaluator>::Evaluate(
+    std::vector<Argument> const& arguments,
+    std::vector<Value>& values) const {
+  values.resize(arguments.size());
+  for (std::size_t i = 0; i < arguments.size(); ++i) {
+    values[i] = Evaluator<Value, Argument, degree_>::Evaluate(coefficients_,
+                                                              arguments[i]);
+  }
+}
+
 template<typename Value, typename Argument, int degree_,
          template<typename, typename, int> class Evaluator>
 constexpr int
@@ -143,6 +167,13 @@ PolynomialInMonomialBasis<Value, Argument, degree_, Evaluator>::degree() const {
   return degree_;
 }
 
+template<typename Value, typename Argument, int degree_,
+         template<typename, typename, int> class Evaluator>
+auto PolynomialInMonomialBasis<Value, Argument, degree_, Evaluator>::
+coefficients() const -> Coefficients const& {
+  return coefficients_;
+}
+
 template<typename Value, typename Argument, int degree_,
          template<typename, typename, int> class Evaluator>
 void PolynomialInMonomialBasis<Value, Argument, degree_, Evaluator>::
@@ -198,6 +229,28 @@ EvaluateDerivative(Point<Argument> const& argument) const {
       coefficients_, argument - origin_);
 }
 
+template<typename Value, typename Argument, int degree_,
+         template<typename, typename, int> class Evaluator>
+void PolynomialInMonomialBasis<Value, Point<Argument>, degree_, Evaluator>::
+EvaluateWithDerivative(Point<Argument> const& argument,
+                       Value& value,
+                       Derivative<Value, Argument>& derivative) const {
+  Evaluator<Value, Argument, degree_>::EvaluateWithDerivative(
+      coefficients_, argument - origin_, value, derivative);
+}
+
+template<typename Value, typename Argument, int degree_,
+         template<typename, typename, int> class Evaluator>
+void PolynomialInMonomialBasis<Value, Point<Argument>, degree_, Evaluator>::
+Evaluate(std::vector<Point<Argument>> const& arguments,
+         std::vector<Value>& values) const {
+  values.resize(arguments.size());
+  for (std::size_t i = 0; i < arguments.size(); ++i) {
+    values[i] = Evaluator<Value, Argument, degree_>::Evaluate(
+        coefficients_, arguments[i] - origin_);
+  }
+}
+
 template<typename Value, typename Argument, int degree_,
          template<typename, typename, int> class Evaluator>
 constexpr int
@@ -206,6 +259,21 @@ degree() const {
   return degree_;
 }
 
+template<typename Value, typename Argument, int degree_,
+         template<typename, typename, int> class Evaluator>
+auto PolynomialInMonomialBasis<Value, Point<Argument>, degree_, Evaluator>::
+coefficients() const -> Coefficients const& {
+  return coefficients_;
+}
+
+template<typename Value, typename Argument, int degree_,
+         template<typename, typename, int> class Evaluator>
+Point<Argument> const&
+PolynomialInMonomialBasis<Value, Point<Argument>, degree_, Evaluator>::
+origin() const {
+  return origin_;
+}
+
 template<typename Value, typename Argument, int degree_,
          template<typename, typename, int> class Evaluator>
 void PolynomialInMonomialBasis<Value, Point<Argument>, degree_, Evaluator>::
@@ -32,6 +32,13 @@ struct EstrinEvaluator {
   FORCE_INLINE(static) Derivative<Value, Argument>
   EvaluateDerivative(Coefficients const& coefficients,
                      Argument const& argument);
+  // Same results as |Evaluate| and |EvaluateDerivative|, but the computations
+  // that are common to both are only done once.
+  FORCE_INLINE(static) void EvaluateWithDerivative(
+      Coefficients const& coefficients,
+      Argument const& argument,
+      Value& value,
+      Derivative<Value, Argument>& derivative);
 };
 
 template<typename Value, typename Argument, int degree>
@@ -49,6 +56,13 @@ struct HornerEvaluator {
   FORCE_INLINE(static) Derivative<Value, Argument>
   EvaluateDerivative(Coefficients const& coefficients,
                      Argument const& argument);
+  // Same results as |Evaluate| and |EvaluateDerivative|, but the computations
+  // that are common to both are only done once.
+  FORCE_INLINE(static) void EvaluateWithDerivative(
+      Coefficients const& coefficients,
+      Argument const& argument,
+      Value& value,
+      Derivative<Value, Argument>& derivative);
 };
 
 }  // namespace internal_polynomial_evaluators
@@ -241,6 +241,35 @@ EstrinEvaluator<Value, Argument, degree>::EvaluateDerivative(
       InternalEvaluator::ArgumentSquaresGenerator::Evaluate(argument));
 }
 
+template<typename Value, typename Argument, int degree>
+void EstrinEvaluator<Value, Argument, degree>::EvaluateWithDerivative(
+    Coefficients const& coefficients,
+    Argument const& argument,
+    Value& value,
+    Derivative<Value, Argument>& derivative) {
+  using InternalValueEvaluator =
+      InternalEstrinEvaluator<Value,
+                              Argument,
+                              degree,
+                              /*low=*/0,
+                              /*subdegree=*/degree>;
+  using InternalDerivativeEvaluator =
+      InternalEstrinEvaluator<Value,
+                              Argument,
+                              degree,
+                              /*low=*/1,
+                              /*subdegree=*/degree - 1>;
+  // The squares of the argument only depend on |degree|, so they are shared by
+  // the two evaluations, which are independent and may be interleaved by the
+  // processor.
+  auto const argument_squares =
+      InternalValueEvaluator::ArgumentSquaresGenerator::Evaluate(argument);
+  value = InternalValueEvaluator::Evaluate(
+      coefficients, argument, argument_squares);
+  derivative = InternalDerivativeEvaluator::EvaluateDerivative(
+      coefficients, argument, argument_squares);
+}
+
 // Internal helper for Horner evaluation.  |degree| is the degree of the overall
 // polynomial, |low| defines the subpolynomial that we currently evaluate, i.e.,
 // the one with a constant term coefficient |std::get<low>(coefficients)|.
@@ -328,6 +357,20 @@ HornerEvaluator<Value, Argument, degree>::EvaluateDerivative(
       EvaluateDerivative(coefficients, argument);
 }
 
+template<typename Value, typename Argument, int degree>
+void HornerEvaluator<Value, Argument, degree>::EvaluateWithDerivative(
+    Coefficients const& coefficients,
+    Argument const& argument,
+    Value& value,
+    Derivative<Value, Argument>& derivative) {
+  // The two Horner chains are independent, so the processor may interleave
+  // them.
+  value = InternalHornerEvaluator<Value, Argument, degree, /*low=*/0>::Evaluate(
+      coefficients, argument);
+  derivative = InternalHornerEvaluator<Value, Argument, degree, /*low=*/1>::
+      EvaluateDerivative(coefficients, argument);
+}
+
 }  // namespace internal_polynomial_evaluators
 }  // namespace numerics
 }  // namespace principia
@@ -36,6 +36,13 @@ class PolynomialEvaluatorTest : public ::testing::Test {
       EXPECT_EQ(E::EvaluateDerivative(binomial_coefficients, argument),
                 degree * std::pow(argument + 1, degree - 1))
           << argument << " " << degree;
+      double value;
+      double derivative;
+      E::EvaluateWithDerivative(
+          binomial_coefficients, argument, value, derivative);
+      EXPECT_EQ(E::Evaluate(binomial_coefficients, argument), value);
+      EXPECT_EQ(E::EvaluateDerivative(binomial_coefficients, argument),
+                derivative);
     }
   }
 };
@@ -2,6 +2,7 @@
 #include "numerics/polynomial.hpp"
 
 #include <tuple>
+#include <vector>
 
 #include "geometry/frame.hpp"
 #include "geometry/grassmann.hpp"
@@ -29,6 +30,8 @@ using geometry::Instant;
 using geometry::Vector;
 using geometry::Velocity;
 using quantities::Acceleration;
+using quantities::Derivative;
+using quantities::SIUnit;
 using quantities::Time;
 using quantities::si::Metre;
 using quantities::si::Second;
@@ -133,6 +136,46 @@ TEST_F(PolynomialTest, Evaluate17) {
                                                    0 * Metre}), 0));
 }
 
+// Check that the joint and batch evaluations give the same results as the
+// individual ones.
+TEST_F(PolynomialTest, EvaluateWithDerivativeAndBatch) {
+  Instant const t0 = Instant() + 0.3 * Second;
+  P2A const p2a(coefficients_, t0);
+  P17::Coefficients coefficients17;
+  std::get<0>(coefficients17) = std::get<0>(coefficients_);
+  std::get<1>(coefficients17) = std::get<1>(coefficients_);
+  std::get<2>(coefficients17) = std::get<2>(coefficients_);
+  using C17 = std::tuple_element_t<17, P17::Coefficients>;
+  auto const c17 = SIUnit<Derivative<quantities::Length, Time, 17>>();
+  std::get<17>(coefficients17) = C17({1 * c17, 0 * c17, 2 * c17});
+  P17 const p17(coefficients17);
+
+  std::vector<Instant> instants;
+  std::vector<Time> times;
+  for (int i = -5; i <= 5; ++i) {
+    instants.push_back(t0 + i * 0.7 * Second);
+    times.push_back(i * 0.7 * Second);
+  }
+  std::vector<Displacement<World>> values2a;
+  std::vector<Displacement<World>> values17;
+  p2a.Evaluate(instants, values2a);
+  p17.Evaluate(times, values17);
+  ASSERT_EQ(instants.size(), values2a.size());
+  ASSERT_EQ(times.size(), values17.size());
+  for (int i = 0; i < instants.size(); ++i) {
+    Displacement<World> d;
+    Velocity<World> v;
+    p2a.EvaluateWithDerivative(instants[i], d, v);
+    EXPECT_EQ(p2a.Evaluate(instants[i]), d);
+    EXPECT_EQ(p2a.EvaluateDerivative(instants[i]), v);
+    EXPECT_EQ(p2a.Evaluate(instants[i]), values2a[i]);
+    p17.EvaluateWithDerivative(times[i], d, v);
+    EXPECT_EQ(p17.Evaluate(times[i]), d);
+    EXPECT_EQ(p17.EvaluateDerivative(times[i]), v);
+    EXPECT_EQ(p17.Evaluate(times[i]), values17[i]);
+  }
+}
+
 // Check that polynomials may be serialized.
 TEST_F(PolynomialTest, Serialization) {
   {
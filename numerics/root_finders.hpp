@@ -23,6 +23,28 @@ Argument Bisect(Function f,
                 Argument const& lower_bound,
                 Argument const& upper_bound);
 
+// Approximates a root of |f| between |lower_bound| and |upper_bound| by the
+// Illinois variant of regula falsi, falling back to bisection if the bracket
+// doesn't shrink fast enough.  The bounds and the result are as for |Bisect|,
+// but for a smooth |f| this takes about 10 evaluations instead of about 50.
+template<typename Argument, typename Function>
+Argument RegulaFalsi(Function f,
+                     Argument const& lower_bound,
+                     Argument const& upper_bound);
+
+// Approximates a root of |f| between |lower_bound| and |upper_bound| by
+// Newton's method, where |derivative| is the derivative of |f|.  The iterates
+// are kept in the bracket by falling back to bisection.  The bounds are as for
+// |Bisect|.  The iteration stops when the bracket is one ULP wide, or when
+// Newton's method reaches a fixed point, in which case the result is within
+// about one ULP of a root if |derivative| is accurate.  For a smooth |f| this
+// takes about 6 evaluations of |f| and |derivative|.
+template<typename Argument, typename Function, typename DerivativeFunction>
+Argument BracketedNewton(Function f,
+                         DerivativeFunction derivative,
+                         Argument const& lower_bound,
+                         Argument const& upper_bound);
+
 // Returns the solutions of the quadratic equation:
 //   a2 * (x - origin)^2 + a1 * (x - origin) + a0 == 0
 // The result may have 0, 1 or 2 values and is sorted.
@@ -36,6 +58,8 @@ BoundedArray<Argument, 2> SolveQuadraticEquation(
 }  // namespace internal_root_finders
 
 using internal_root_finders::Bisect;
+using internal_root_finders::BracketedNewton;
+using internal_root_finders::RegulaFalsi;
 using internal_root_finders::SolveQuadraticEquation;
 
 }  // namespace numerics
@@ -9,6 +9,7 @@
 #include "geometry/sign.hpp"
 #include "glog/logging.h"
 #include "numerics/double_precision.hpp"
+#include "quantities/elementary_functions.hpp"
 
 namespace principia {
 namespace numerics {
@@ -16,9 +17,19 @@ namespace internal_root_finders {
 
 using geometry::Barycentre;
 using geometry::Sign;
+using quantities::Abs;
 using quantities::Square;
 using quantities::Sqrt;
 
+// Returns true if |x| is strictly between |bound1| and |bound2|, which may be
+// in any order.  Returns false if |x| is NaN.
+template<typename Argument>
+bool IsStrictlyBetween(Argument const& x,
+                       Argument const& bound1,
+                       Argument const& bound2) {
+  return (bound1 < x && x < bound2) || (bound2 < x && x < bound1);
+}
+
 template<typename Argument, typename Function>
 Argument Bisect(Function f,
                 Argument const& lower_bound,
@@ -56,6 +67,149 @@ Argument Bisect(Function f,
   }
 }
 
+template<typename Argument, typename Function>
+Argument RegulaFalsi(Function f,
+                     Argument const& lower_bound,
+                     Argument const& upper_bound) {
+  using Value = decltype(f(lower_bound));
+  // The number of iterations without halving the bracket after which we
+  // bisect.
+  constexpr int max_slow_iterations = 3;
+  Value const zero{};
+  Value f_upper = f(upper_bound);
+  Value f_lower = f(lower_bound);
+  if (f_upper == zero) {
+    return upper_bound;
+  }
+  if (f_lower == zero) {
+    return lower_bound;
+  }
+  CHECK(f_lower > zero && zero > f_upper || f_lower < zero && zero < f_upper)
+      << "\nlower: " << lower_bound << " :-> " << f_lower << ", "
+      << "\nupper: " << upper_bound << " :-> " << f_upper;
+  Argument lower = lower_bound;
+  Argument upper = upper_bound;
+  // Whether each bound was retained by the previous iteration.
+  bool lower_retained = false;
+  bool upper_retained = false;
+  auto width_at_last_halving = Abs(upper - lower);
+  int slow_iterations = 0;
+  for (;;) {
+    Argument const middle =
+        Barycentre<Argument, double>({lower, upper}, {1, 1});
+    // The size of the interval has reached one ULP.
+    if (middle == lower || middle == upper) {
+      return middle;
+    }
+    Argument x = middle;
+    if (slow_iterations < max_slow_iterations) {
+      // The zero of the secant through the bounds.  The weights have the same
+      // sign.
+      Argument const secant =
+          Barycentre<Argument, Value>({lower, upper}, {f_upper, -f_lower});
+      if (IsStrictlyBetween(secant, lower, upper)) {
+        x = secant;
+      }
+    }
+    Value const f_x = f(x);
+    if (f_x == zero) {
+      return x;
+    }
+    // When a bound is retained twice in a row, its value is halved so that the
+    // next secant moves towards it.  This is the Illinois modification, which
+    // avoids the one-sided convergence of regula falsi.
+    if (Sign(f_x) == Sign(f_upper)) {
+      upper = x;
+      f_upper = f_x;
+      if (lower_retained) {
+        f_lower /= 2;
+      }
+      lower_retained = true;
+      upper_retained = false;
+    } else {
+      lower = x;
+      f_lower = f_x;
+      if (upper_retained) {
+        f_upper /= 2;
+      }
+      lower_retained = false;
+      upper_retained = true;
+    }
+    auto const width = Abs(upper - lower);
+    if (width <= 0.5 * width_at_last_halving) {
+      width_at_last_halving = width;
+      slow_iterations = 0;
+    } else {
+      ++slow_iterations;
+    }
+  }
+}
+
+template<typename Argument, typename Function, typename DerivativeFunction>
+Argument BracketedNewton(Function f,
+                         DerivativeFunction derivative,
+                         Argument const& lower_bound,
+                         Argument const& upper_bound) {
+  using Value = decltype(f(lower_bound));
+  Value const zero{};
+  Value f_upper = f(upper_bound);
+  Value const f_lower = f(lower_bound);
+  if (f_upper == zero) {
+    return upper_bound;
+  }
+  if (f_lower == zero) {
+    return lower_bound;
+  }
+  CHECK(f_lower > zero && zero > f_upper || f_lower < zero && zero < f_upper)
+      << "\nlower: " << lower_bound << " :-> " << f_lower << ", "
+      << "\nupper: " << upper_bound << " :-> " << f_upper;
+  Argument lower = lower_bound;
+  Argument upper = upper_bound;
+  // Start at the zero of the secant through the bounds, which is free.
+  Argument x = Barycentre<Argument, Value>({lower, upper}, {f_upper, -f_lower});
+  if (!IsStrictlyBetween(x, lower, upper)) {
+    x = Barycentre<Argument, double>({lower, upper}, {1, 1});
+  }
+  // The sizes of the last two steps, to detect slow convergence.
+  auto step = Abs(upper - lower);
+  auto previous_step = step;
+  for (;;) {
+    Value const f_x = f(x);
+    if (f_x == zero) {
+      return x;
+    }
+    if (Sign(f_x) == Sign(f_upper)) {
+      upper = x;
+      f_upper = f_x;
+    } else {
+      lower = x;
+    }
+    Argument const middle =
+        Barycentre<Argument, double>({lower, upper}, {1, 1});
+    // The size of the interval has reached one ULP.
+    if (middle == lower || middle == upper) {
+      return middle;
+    }
+    Argument next = x - f_x / derivative(x);
+    // Newton's method has converged to the precision of |Argument|.
+    if (next == x) {
+      return x;
+    }
+    if (!IsStrictlyBetween(next, lower, upper)) {
+      next = middle;
+    } else if (Abs(next - x) > 0.5 * previous_step) {
+      // The convergence is slow, typically because we are within a few ULPs
+      // of the root and the step is dominated by rounding errors.  Overshoot,
+      // hoping to land on the other side of the root and tighten the bracket.
+      Argument const overshoot = x + 2 * (next - x);
+      next = IsStrictlyBetween(overshoot, lower, upper) ? overshoot : middle;
+    }
+    previous_step = step;
+    step = Abs(next - x);
+    x = next;
+  }
+}
+
 template<typename Argument, typename Value>
 BoundedArray<Argument, 2> SolveQuadraticEquation(
     Argument const& origin,
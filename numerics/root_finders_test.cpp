@@ -53,6 +53,41 @@ TEST_F(RootFindersTest, SquareRoots) {
   }
 }
 
+TEST_F(RootFindersTest, SquareRootsRegulaFalsi) {
+  Instant const t_0;
+  Instant const t_max = t_0 + 10 * Second;
+  Length const n_max = Pow<2>(t_max - t_0) * SIUnit<Acceleration>();
+  for (Length n = 1 * Metre; n < n_max; n += 1 * Metre) {
+    int evaluations = 0;
+    auto const equation = [t_0, n, &evaluations](Instant const& t) {
+      ++evaluations;
+      return Pow<2>(t - t_0) * SIUnit<Acceleration>() - n;
+    };
+    EXPECT_THAT(RegulaFalsi(equation, t_0, t_max) - t_0,
+                AlmostEquals(Sqrt(n / SIUnit<Acceleration>()), 0, 1));
+    EXPECT_THAT(evaluations, AllOf(Ge(9), Le(21)));
+  }
+}
+
+TEST_F(RootFindersTest, SquareRootsBracketedNewton) {
+  Instant const t_0;
+  Instant const t_max = t_0 + 10 * Second;
+  Length const n_max = Pow<2>(t_max - t_0) * SIUnit<Acceleration>();
+  for (Length n = 1 * Metre; n < n_max; n += 1 * Metre) {
+    int evaluations = 0;
+    auto const equation = [t_0, n, &evaluations](Instant const& t) {
+      ++evaluations;
+      return Pow<2>(t - t_0) * SIUnit<Acceleration>() - n;
+    };
+    auto const derivative = [t_0](Instant const& t) {
+      return 2 * (t - t_0) * SIUnit<Acceleration>();
+    };
+    EXPECT_THAT(BracketedNewton(equation, derivative, t_0, t_max) - t_0,
+                AlmostEquals(Sqrt(n / SIUnit<Acceleration>()), 0, 1));
+    EXPECT_THAT(evaluations, AllOf(Ge(6), Le(12)));
+  }
+}
+
 TEST_F(RootFindersTest, QuadraticEquations) {
   // Golden ratio.
   auto const s1 = SolveQuadraticEquation(0.0, -1.0, -1.0, 1.0);
@@ -68,12 +68,30 @@ class ЧебышёвSeries final {
   // Uses the Clenshaw algorithm.  |t| must be in the range [t_min, t_max].
   Vector Evaluate(Instant const& t) const;
   Variation<Vector> EvaluateDerivative(Instant const& t) const;
+  // Equivalent to |Evaluate| followed by |EvaluateDerivative|, but the argument
+  // is only scaled once.
+  void EvaluateWithDerivative(Instant const& t,
+                              Vector& value,
+                              Variation<Vector>& derivative) const;
+
+  // Same as above, at each of the |times|.  |values| and |derivatives| are
+  // resized to the size of |times|.
+  void Evaluate(std::vector<Instant> const& times,
+                std::vector<Vector>& values) const;
+  void EvaluateWithDerivative(
+      std::vector<Instant> const& times,
+      std::vector<Vector>& values,
+      std::vector<Variation<Vector>>& derivatives) const;
 
   void WriteToMessage(not_null<serialization::ЧебышёвSeries*> message) const;
   static ЧебышёвSeries ReadFromMessage(
       serialization::ЧебышёвSeries const& message);
 
  private:
+  // Maps |t| to [-1, 1].
+  double ScaledTime(Instant const& t) const;
+  Variation<Vector> EvaluateDerivativeImplementation(double scaled_t) const;
+
   Instant t_min_;
   Instant t_max_;
   Inverse<Time> one_over_duration_;
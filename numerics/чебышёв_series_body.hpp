@@ -208,6 +208,50 @@ int ЧебышёвSeries<Vector>::degree() const {
 
 template<typename Vector>
 Vector ЧебышёвSeries<Vector>::Evaluate(Instant const& t) const {
+  return helper_.EvaluateImplementation(ScaledTime(t));
+}
+
+template<typename Vector>
+Variation<Vector> ЧебышёвSeries<Vector>::EvaluateDerivative(
+    Instant const& t) const {
+  return EvaluateDerivativeImplementation(ScaledTime(t));
+}
+
+template<typename Vector>
+void ЧебышёвSeries<Vector>::EvaluateWithDerivative(
+    Instant const& t,
+    Vector& value,
+    Variation<Vector>& derivative) const {
+  double const scaled_t = ScaledTime(t);
+  value = helper_.EvaluateImplementation(scaled_t);
+  derivative = EvaluateDerivativeImplementation(scaled_t);
+}
+
+template<typename Vector>
+void ЧебышёвSeries<Vector>::Evaluate(std::vector<Instant> const& times,
+                                     std::vector<Vector>& values) const {
+  values.resize(times.size());
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    values[i] = helper_.EvaluateImplementation(ScaledTime(times[i]));
+  }
+}
+
+template<typename Vector>
+void ЧебышёвSeries<Vector>::EvaluateWithDerivative(
+    std::vector<Instant> const& times,
+    std::vector<Vector>& values,
+    std::vector<Variation<Vector>>& derivatives) const {
+  values.resize(times.size());
+  derivatives.resize(times.size());
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    double const scaled_t = ScaledTime(times[i]);
+    values[i] = helper_.EvaluateImplementation(scaled_t);
+    derivatives[i] = EvaluateDerivativeImplementation(scaled_t);
+  }
+}
+
+template<typename Vector>
+double ЧебышёвSeries<Vector>::ScaledTime(Instant const& t) const {
   // This formula ensures continuity at the edges by producing -1 or +1 within
   // 2 ulps for |t_min_| and |t_max_|.
   double const scaled_t = ((t - t_max_) + (t - t_min_)) * one_over_duration_;
@@ -219,21 +263,13 @@ Vector ЧебышёвSeries<Vector>::Evaluate(Instant const& t) const {
   CHECK_LE(scaled_t, 1.1);
   CHECK_GE(scaled_t, -1.1);
 #endif
-
-  return helper_.EvaluateImplementation(scaled_t);
+  return scaled_t;
 }
 
 template<typename Vector>
-Variation<Vector> ЧебышёвSeries<Vector>::EvaluateDerivative(
-    Instant const& t) const {
-  // See comments above.
-  double const scaled_t = ((t - t_max_) + (t - t_min_)) * one_over_duration_;
+Variation<Vector> ЧебышёвSeries<Vector>::EvaluateDerivativeImplementation(
+    double const scaled_t) const {
   double const two_scaled_t = scaled_t + scaled_t;
-#ifdef _DEBUG
-  CHECK_LE(scaled_t, 1.1);
-  CHECK_GE(scaled_t, -1.1);
-#endif
-
   Vector b_kplus2_vector{};
   Vector b_kplus1_vector{};
   Vector* b_kplus2 = &b_kplus2_vector;
@@ -1,6 +1,8 @@
 ﻿
 #include "numerics/чебышёв_series.hpp"
 
+#include <vector>
+
 #include "astronomy/frames.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -134,6 +136,38 @@ TEST_F(ЧебышёвSeriesTest, X6Vector) {
             x6.Evaluate(t0_ + 3 * Second));
 }
 
+TEST_F(ЧебышёвSeriesTest, BatchEvaluation) {
+  using V = Vector<Length, ICRFJ2000Ecliptic>;
+  V const c0 = V({0.0 * Metre, 0.0 * Metre, 10.0 / 32.0 * Metre});
+  V const c1 = V({0.0 * Metre, 10.0 / 16.0 * Metre, 0.0 * Metre});
+  V const c2 = V({0.0 * Metre, 0.0 * Metre, 15.0 / 32.0 * Metre});
+  V const c3 = V({1.0 * Metre, 5.0 / 16.0 * Metre, 0.0 * Metre});
+  ЧебышёвSeries<V> const series({c0, c1, c2, c3}, t_min_, t_max_);
+
+  std::vector<Instant> times;
+  for (Instant t = t_min_; t <= t_max_; t += 0.25 * Second) {
+    times.push_back(t);
+  }
+  std::vector<V> values;
+  std::vector<V> values_with_derivatives;
+  std::vector<Variation<V>> derivatives;
+  series.Evaluate(times, values);
+  series.EvaluateWithDerivative(times, values_with_derivatives, derivatives);
+  ASSERT_EQ(times.size(), values.size());
+  ASSERT_EQ(times.size(), values_with_derivatives.size());
+  ASSERT_EQ(times.size(), derivatives.size());
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    EXPECT_EQ(series.Evaluate(times[i]), values[i]);
+    EXPECT_EQ(series.Evaluate(times[i]), values_with_derivatives[i]);
+    EXPECT_EQ(series.EvaluateDerivative(times[i]), derivatives[i]);
+    V value;
+    Variation<V> derivative;
+    series.EvaluateWithDerivative(times[i], value, derivative);
+    EXPECT_EQ(values[i], value);
+    EXPECT_EQ(derivatives[i], derivative);
+  }
+}
+
 TEST_F(ЧебышёвSeriesDeathTest, SerializationError) {
   ЧебышёвSeries<Speed> v({1 * Metre / Second,
                           -2 * Metre / Second,
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/trajectory.hpp"
 
@@ -7,6 +14,9 @@ namespace principia {
 namespace physics {
 namespace internal_apsides {
 
+using base::not_null;
+using base::WorkStealingScheduler;
+using geometry::Instant;
 using geometry::Vector;
 
 // Computes the apsides with respect to |reference| for the discrete trajectory
@@ -19,6 +29,17 @@ void ComputeApsides(Trajectory<Frame> const& reference,
                     DiscreteTrajectory<Frame>& apoapsides,
                     DiscreteTrajectory<Frame>& periapsides);
 
+// Same as above, but the trajectory segment is split into chunks which are
+// processed in parallel on |scheduler|.  The results are identical to those of
+// the serial version.  The trajectories must not change during the call.
+template<typename Frame>
+void ComputeApsides(Trajectory<Frame> const& reference,
+                    typename DiscreteTrajectory<Frame>::Iterator begin,
+                    typename DiscreteTrajectory<Frame>::Iterator end,
+                    not_null<WorkStealingScheduler*> scheduler,
+                    DiscreteTrajectory<Frame>& apoapsides,
+                    DiscreteTrajectory<Frame>& periapsides);
+
 // Computes the crossings of the discrete trajectory segment given by |begin|
 // and |end| with the xy plane.  Appends the crossings that go towards the
 // |north| side of the xy plane to |ascending|, and those that go away from the
@@ -30,6 +51,17 @@ void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
                   DiscreteTrajectory<Frame>& ascending,
                   DiscreteTrajectory<Frame>& descending);
 
+// Same as above, but the trajectory segment is split into chunks which are
+// processed in parallel on |scheduler|.  The results are identical to those of
+// the serial version.  The trajectory must not change during the call.
+template<typename Frame>
+void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
+                  typename DiscreteTrajectory<Frame>::Iterator end,
+                  Vector<double, Frame> const& north,
+                  not_null<WorkStealingScheduler*> scheduler,
+                  DiscreteTrajectory<Frame>& ascending,
+                  DiscreteTrajectory<Frame>& descending);
+
 // TODO(egg): when we can usefully iterate over an arbitrary |Trajectory|, move
 // the following from |Ephemeris|.
 #if 0
@@ -42,6 +74,60 @@ void ComputeApsides(Trajectory<Frame> const& trajectory1,
                     DiscreteTrajectory<Frame>& periapsides2);
 #endif
 
+// The smallest number of points of a chunk in the parallel versions of the
+// above functions, so that small trajectories are not split.
+constexpr std::int64_t min_points_per_chunk = 100;
+
+// Evaluates a |Trajectory| at nondecreasing times.  If the trajectory is a
+// |DiscreteTrajectory|, uses its |EvaluationCursor| instead of looking up each
+// time, which is expensive for a fork.  The results are those of
+// |Trajectory::EvaluateDegreesOfFreedom|.
+template<typename Frame>
+class ReferenceCursor final {
+ public:
+  explicit ReferenceCursor(Trajectory<Frame> const& reference);
+
+  // |time| must be in [t_min, t_max] and must not be before the |time| of the
+  // previous call.
+  DegreesOfFreedom<Frame> EvaluateDegreesOfFreedom(Instant const& time);
+
+ private:
+  Trajectory<Frame> const& reference_;
+  // Engaged iff |reference_| is a |DiscreteTrajectory|.
+  std::optional<typename DiscreteTrajectory<Frame>::EvaluationCursor>
+      discrete_cursor_;
+};
+
+// A buffer for the extrema found in a chunk, with the same |Append| as a
+// |DiscreteTrajectory|.
+template<typename Frame>
+struct Extrema final {
+  void Append(Instant const& time,
+              DegreesOfFreedom<Frame> const& degrees_of_freedom);
+  // Appends the |points| to |trajectory|.
+  void AppendTo(DiscreteTrajectory<Frame>& trajectory) const;
+
+  std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> points;
+};
+
+// Returns the iterators that delimit at most |max_chunks| chunks of
+// consecutive points of the range [begin, end[.  The first element is |begin|
+// and the last one is |end|.
+template<typename Iterator>
+std::vector<Iterator> ChunkBoundaries(Iterator const& begin,
+                                      Iterator const& end,
+                                      std::int64_t max_chunks);
+
+// Calls |compute| on each chunk of [begin, end[ in parallel and appends the
+// extrema that it finds to |first| and |second|, in order.
+template<typename Frame, typename Compute>
+void ComputeInChunks(typename DiscreteTrajectory<Frame>::Iterator const& begin,
+                     typename DiscreteTrajectory<Frame>::Iterator const& end,
+                     not_null<WorkStealingScheduler*> scheduler,
+                     Compute const& compute,
+                     DiscreteTrajectory<Frame>& first,
+                     DiscreteTrajectory<Frame>& second);
+
 }  // namespace internal_apsides
 
 using internal_apsides::ComputeApsides;
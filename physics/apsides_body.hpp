@@ -3,6 +3,8 @@
 
 #include "physics/apsides.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -14,11 +16,12 @@ namespace physics {
 namespace internal_apsides {
 
 using base::BoundedArray;
+using base::Future;
 using geometry::Barycentre;
 using geometry::Instant;
 using geometry::Position;
 using geometry::Sign;
-using numerics::Bisect;
+using numerics::BracketedNewton;
 using numerics::Hermite3;
 using quantities::Length;
 using quantities::Speed;
@@ -26,11 +29,110 @@ using quantities::Square;
 using quantities::Variation;
 
 template<typename Frame>
-void ComputeApsides(Trajectory<Frame> const& reference,
-                    typename DiscreteTrajectory<Frame>::Iterator const begin,
-                    typename DiscreteTrajectory<Frame>::Iterator const end,
-                    DiscreteTrajectory<Frame>& apoapsides,
-                    DiscreteTrajectory<Frame>& periapsides) {
+void Extrema<Frame>::Append(Instant const& time,
+                            DegreesOfFreedom<Frame> const& degrees_of_freedom) {
+  points.emplace_back(time, degrees_of_freedom);
+}
+
+template<typename Frame>
+void Extrema<Frame>::AppendTo(DiscreteTrajectory<Frame>& trajectory) const {
+  for (auto const& [time, degrees_of_freedom] : points) {
+    trajectory.Append(time, degrees_of_freedom);
+  }
+}
+
+template<typename Frame>
+ReferenceCursor<Frame>::ReferenceCursor(Trajectory<Frame> const& reference)
+    : reference_(reference) {
+  if (auto const* const discrete_reference =
+          dynamic_cast<DiscreteTrajectory<Frame> const*>(&reference)) {
+    discrete_cursor_.emplace(*discrete_reference);
+  }
+}
+
+template<typename Frame>
+DegreesOfFreedom<Frame> ReferenceCursor<Frame>::EvaluateDegreesOfFreedom(
+    Instant const& time) {
+  if (discrete_cursor_.has_value()) {
+    return discrete_cursor_->EvaluateDegreesOfFreedom(time);
+  }
+  return reference_.EvaluateDegreesOfFreedom(time);
+}
+
+template<typename Iterator>
+std::vector<Iterator> ChunkBoundaries(Iterator const& begin,
+                                      Iterator const& end,
+                                      std::int64_t const max_chunks) {
+  std::int64_t size = 0;
+  for (auto it = begin; it != end; ++it) {
+    ++size;
+  }
+  std::int64_t const points_per_chunk =
+      std::max(min_points_per_chunk, (size + max_chunks - 1) / max_chunks);
+
+  std::vector<Iterator> boundaries = {begin};
+  std::int64_t index = 0;
+  for (auto it = begin; it != end; ++it, ++index) {
+    // Don't create a final chunk with a single point: it has no interval.
+    if (index > 0 && index % points_per_chunk == 0 && index < size - 1) {
+      boundaries.push_back(it);
+    }
+  }
+  boundaries.push_back(end);
+  return boundaries;
+}
+
+template<typename Frame, typename Compute>
+void ComputeInChunks(typename DiscreteTrajectory<Frame>::Iterator const& begin,
+                     typename DiscreteTrajectory<Frame>::Iterator const& end,
+                     not_null<WorkStealingScheduler*> const scheduler,
+                     Compute const& compute,
+                     DiscreteTrajectory<Frame>& first,
+                     DiscreteTrajectory<Frame>& second) {
+  auto const boundaries =
+      ChunkBoundaries(begin, end, /*max_chunks=*/scheduler->pool_size() + 1);
+  std::int64_t const chunks = boundaries.size() - 1;
+  std::vector<Extrema<Frame>> firsts(chunks);
+  std::vector<Extrema<Frame>> seconds(chunks);
+
+  // Consecutive chunks share their boundary point, so that the interval that
+  // straddles a boundary belongs to exactly one chunk.
+  auto compute_chunk = [&boundaries, &compute, &firsts, &seconds, chunks](
+                           std::int64_t const i) {
+    auto chunk_end = boundaries[i + 1];
+    if (i < chunks - 1) {
+      ++chunk_end;
+    }
+    compute(boundaries[i], chunk_end, firsts[i], seconds[i]);
+  };
+
+  // The first chunk is processed on this thread while the scheduler takes care
+  // of the others.
+  std::vector<Future<void>> futures;
+  futures.reserve(chunks - 1);
+  for (std::int64_t i = 1; i < chunks; ++i) {
+    futures.push_back(scheduler->Add([&compute_chunk, i]() {
+      compute_chunk(i);
+    }));
+  }
+  compute_chunk(0);
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  for (std::int64_t i = 0; i < chunks; ++i) {
+    firsts[i].AppendTo(first);
+    seconds[i].AppendTo(second);
+  }
+}
+
+template<typename Frame, typename Output>
+void ComputeApsidesInRange(
+    Trajectory<Frame> const& reference,
+    typename DiscreteTrajectory<Frame>::Iterator const begin,
+    typename DiscreteTrajectory<Frame>::Iterator const end,
+    Output& apoapsides,
+    Output& periapsides) {
   std::optional<Instant> previous_time;
   std::optional<DegreesOfFreedom<Frame>> previous_degrees_of_freedom;
   std::optional<Square<Length>> previous_squared_distance;
@@ -39,6 +141,9 @@ void ComputeApsides(Trajectory<Frame> const& reference,
 
   Instant const t_min = reference.t_min();
   Instant const t_max = reference.t_max();
+  ReferenceCursor<Frame> reference_cursor(reference);
+  typename DiscreteTrajectory<Frame>::EvaluationCursor cursor(
+      *begin.trajectory());
   for (auto it = begin; it != end; ++it) {
     Instant const& time = it.time();
     if (time < t_min) {
@@ -49,7 +154,7 @@ void ComputeApsides(Trajectory<Frame> const& reference,
     }
     DegreesOfFreedom<Frame> const degrees_of_freedom = it.degrees_of_freedom();
     DegreesOfFreedom<Frame> const body_degrees_of_freedom =
-        reference.EvaluateDegreesOfFreedom(time);
+        reference_cursor.EvaluateDegreesOfFreedom(time);
     RelativeDegreesOfFreedom<Frame> const relative =
         degrees_of_freedom - body_degrees_of_freedom;
     Square<Length> const squared_distance = relative.displacement().Norm²();
@@ -104,7 +209,7 @@ void ComputeApsides(Trajectory<Frame> const& reference,
       // 3rd-degree polynomial would yield |squared_distance_approximation|, so
       // we shouldn't be far from the truth.
       DegreesOfFreedom<Frame> const apsis_degrees_of_freedom =
-          begin.trajectory()->EvaluateDegreesOfFreedom(apsis_time);
+          cursor.EvaluateDegreesOfFreedom(apsis_time);
       if (Sign(squared_distance_derivative).Negative()) {
         apoapsides.Append(apsis_time, apsis_degrees_of_freedom);
       } else {
@@ -119,12 +224,12 @@ void ComputeApsides(Trajectory<Frame> const& reference,
   }
 }
 
-template<typename Frame>
-void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
-                  typename DiscreteTrajectory<Frame>::Iterator end,
-                  Vector<double, Frame> const& north,
-                  DiscreteTrajectory<Frame>& ascending,
-                  DiscreteTrajectory<Frame>& descending) {
+template<typename Frame, typename Output>
+void ComputeNodesInRange(typename DiscreteTrajectory<Frame>::Iterator begin,
+                         typename DiscreteTrajectory<Frame>::Iterator end,
+                         Vector<double, Frame> const& north,
+                         Output& ascending,
+                         Output& descending) {
   std::optional<Instant> previous_time;
   std::optional<Length> previous_z;
   std::optional<Speed> previous_z_speed;
@@ -154,13 +259,15 @@ void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
         node_time = Barycentre<Instant, Length>({*previous_time, time},
                                                 {z, -*previous_z});
       } else {
-        // The normal case, find the intersection with z = 0 using bisection.
-        // TODO(egg): Bisection on a polynomial seems daft; we should have
-        // Newton's method.
-        node_time = Bisect(
+        // The normal case, find the intersection with z = 0 using Newton's
+        // method on the polynomial.
+        node_time = BracketedNewton(
             [&z_approximation](Instant const& t) {
               return z_approximation.Evaluate(t);
             },
+            [&z_approximation](Instant const& t) {
+              return z_approximation.EvaluateDerivative(t);
+            },
             *previous_time,
             time);
       }
@@ -183,6 +290,68 @@ void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
   }
 }
 
+template<typename Frame>
+void ComputeApsides(Trajectory<Frame> const& reference,
+                    typename DiscreteTrajectory<Frame>::Iterator const begin,
+                    typename DiscreteTrajectory<Frame>::Iterator const end,
+                    DiscreteTrajectory<Frame>& apoapsides,
+                    DiscreteTrajectory<Frame>& periapsides) {
+  ComputeApsidesInRange<Frame>(
+      reference, begin, end, apoapsides, periapsides);
+}
+
+template<typename Frame>
+void ComputeApsides(Trajectory<Frame> const& reference,
+                    typename DiscreteTrajectory<Frame>::Iterator const begin,
+                    typename DiscreteTrajectory<Frame>::Iterator const end,
+                    not_null<WorkStealingScheduler*> const scheduler,
+                    DiscreteTrajectory<Frame>& apoapsides,
+                    DiscreteTrajectory<Frame>& periapsides) {
+  ComputeInChunks<Frame>(
+      begin,
+      end,
+      scheduler,
+      [&reference](typename DiscreteTrajectory<Frame>::Iterator const begin,
+                   typename DiscreteTrajectory<Frame>::Iterator const end,
+                   Extrema<Frame>& apoapsides,
+                   Extrema<Frame>& periapsides) {
+        ComputeApsidesInRange<Frame>(
+            reference, begin, end, apoapsides, periapsides);
+      },
+      apoapsides,
+      periapsides);
+}
+
+template<typename Frame>
+void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
+                  typename DiscreteTrajectory<Frame>::Iterator end,
+                  Vector<double, Frame> const& north,
+                  DiscreteTrajectory<Frame>& ascending,
+                  DiscreteTrajectory<Frame>& descending) {
+  ComputeNodesInRange<Frame>(begin, end, north, ascending, descending);
+}
+
+template<typename Frame>
+void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
+                  typename DiscreteTrajectory<Frame>::Iterator end,
+                  Vector<double, Frame> const& north,
+                  not_null<WorkStealingScheduler*> const scheduler,
+                  DiscreteTrajectory<Frame>& ascending,
+                  DiscreteTrajectory<Frame>& descending) {
+  ComputeInChunks<Frame>(
+      begin,
+      end,
+      scheduler,
+      [&north](typename DiscreteTrajectory<Frame>::Iterator const begin,
+               typename DiscreteTrajectory<Frame>::Iterator const end,
+               Extrema<Frame>& ascending,
+               Extrema<Frame>& descending) {
+        ComputeNodesInRange<Frame>(begin, end, north, ascending, descending);
+      },
+      ascending,
+      descending);
+}
+
 }  // namespace internal_apsides
 }  // namespace physics
 }  // namespace principia
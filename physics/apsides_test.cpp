@@ -6,6 +6,7 @@
 #include <optional>
 #include <vector>
 
+#include "base/work_stealing_scheduler.hpp"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
@@ -21,6 +22,7 @@ namespace physics {
 namespace internal_apsides {
 
 using base::not_null;
+using base::WorkStealingScheduler;
 using geometry::Displacement;
 using geometry::Frame;
 using geometry::Velocity;
@@ -38,6 +40,7 @@ using quantities::astronomy::JulianYear;
 using quantities::astronomy::SolarMass;
 using quantities::constants::GravitationalConstant;
 using quantities::si::AstronomicalUnit;
+using quantities::si::Day;
 using quantities::si::Degree;
 using quantities::si::Kilo;
 using quantities::si::Milli;
@@ -52,6 +55,45 @@ class ApsidesTest : public ::testing::Test {
  protected:
   using World =
       Frame<serialization::Frame::TestTag, serialization::Frame::TEST1, true>;
+
+  // A trajectory which hides the type of the trajectory that it forwards to.
+  class OpaqueTrajectory : public Trajectory<World> {
+   public:
+    explicit OpaqueTrajectory(Trajectory<World> const& trajectory)
+        : trajectory_(trajectory) {}
+
+    Instant t_min() const override {
+      return trajectory_.t_min();
+    }
+    Instant t_max() const override {
+      return trajectory_.t_max();
+    }
+    Position<World> EvaluatePosition(Instant const& time) const override {
+      return trajectory_.EvaluatePosition(time);
+    }
+    Velocity<World> EvaluateVelocity(Instant const& time) const override {
+      return trajectory_.EvaluateVelocity(time);
+    }
+    DegreesOfFreedom<World> EvaluateDegreesOfFreedom(
+        Instant const& time) const override {
+      return trajectory_.EvaluateDegreesOfFreedom(time);
+    }
+
+   private:
+    Trajectory<World> const& trajectory_;
+  };
+
+  static void ExpectSameTrajectories(DiscreteTrajectory<World> const& expected,
+                                     DiscreteTrajectory<World> const& actual) {
+    ASSERT_EQ(expected.Size(), actual.Size());
+    for (auto expected_it = expected.Begin(), actual_it = actual.Begin();
+         expected_it != expected.End();
+         ++expected_it, ++actual_it) {
+      EXPECT_EQ(expected_it.time(), actual_it.time());
+      EXPECT_EQ(expected_it.degrees_of_freedom(),
+                actual_it.degrees_of_freedom());
+    }
+  }
 };
 
 #if !defined(_DEBUG)
@@ -136,6 +178,50 @@ TEST_F(ApsidesTest, ComputeApsidesDiscreteTrajectory) {
 
   EXPECT_EQ(6, all_apsides.size());
 
+  // The parallel computation finds the same apsides.
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+  DiscreteTrajectory<World> parallel_apoapsides;
+  DiscreteTrajectory<World> parallel_periapsides;
+  ComputeApsides(*ephemeris.trajectory(b),
+                 trajectory.Begin(),
+                 trajectory.End(),
+                 &scheduler,
+                 parallel_apoapsides,
+                 parallel_periapsides);
+  ExpectSameTrajectories(apoapsides, parallel_apoapsides);
+  ExpectSameTrajectories(periapsides, parallel_periapsides);
+
+  // A discrete reference, sampled on another grid, is walked along with the
+  // trajectory.  The apsides are those obtained by looking up each time.
+  DiscreteTrajectory<World> discrete_reference;
+  Velocity<World> const reference_velocity(
+      {1 * Metre / Second, 0 * Metre / Second, 0 * Metre / Second});
+  for (Instant t = t0; t <= t0 + 11 * JulianYear; t += 1 * Day) {
+    discrete_reference.Append(
+        t,
+        DegreesOfFreedom<World>(
+            World::origin + reference_velocity * (t - t0),
+            reference_velocity));
+  }
+  OpaqueTrajectory const opaque_reference(discrete_reference);
+  DiscreteTrajectory<World> discrete_apoapsides;
+  DiscreteTrajectory<World> discrete_periapsides;
+  DiscreteTrajectory<World> opaque_apoapsides;
+  DiscreteTrajectory<World> opaque_periapsides;
+  ComputeApsides(discrete_reference,
+                 trajectory.Begin(),
+                 trajectory.End(),
+                 discrete_apoapsides,
+                 discrete_periapsides);
+  ComputeApsides(opaque_reference,
+                 trajectory.Begin(),
+                 trajectory.End(),
+                 opaque_apoapsides,
+                 opaque_periapsides);
+  EXPECT_EQ(apoapsides.Size(), discrete_apoapsides.Size());
+  ExpectSameTrajectories(opaque_apoapsides, discrete_apoapsides);
+  ExpectSameTrajectories(opaque_periapsides, discrete_periapsides);
+
   previous_time = std::nullopt;
   std::optional<Position<World>> previous_position;
   for (auto const& pair : all_apsides) {
@@ -242,6 +328,19 @@ TEST_F(ApsidesTest, ComputeNodes) {
   EXPECT_THAT(ascending_nodes.Size(), Eq(10));
   EXPECT_THAT(descending_nodes.Size(), Eq(10));
 
+  // The parallel computation finds the same nodes.
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+  DiscreteTrajectory<World> parallel_ascending_nodes;
+  DiscreteTrajectory<World> parallel_descending_nodes;
+  ComputeNodes(trajectory.Begin(),
+               trajectory.End(),
+               north,
+               &scheduler,
+               parallel_ascending_nodes,
+               parallel_descending_nodes);
+  ExpectSameTrajectories(ascending_nodes, parallel_ascending_nodes);
+  ExpectSameTrajectories(descending_nodes, parallel_descending_nodes);
+
   DiscreteTrajectory<World> south_ascending_nodes;
   DiscreteTrajectory<World> south_descending_nodes;
   Vector<double, World> const mostly_south({1, 1, -1});
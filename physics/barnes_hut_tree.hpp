@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_barnes_hut_tree {
+
+using geometry::Position;
+using geometry::Vector;
+using quantities::Acceleration;
+using quantities::GravitationalParameter;
+using quantities::Length;
+
+// An octree that approximates the gravitational accelerations between N
+// spherical bodies in O(N log N) operations, following Barnes and Hut (1986),
+// A hierarchical O(N log N) force-calculation algorithm.  A cell which is far
+// from a body is replaced by a point mass at its centre of mass.  The dipole
+// term then vanishes, and the error of that approximation is at most
+// 3 μ s² / (d - s)⁴, where μ is the gravitational parameter of the cell, s the
+// distance from its centre of mass to its farthest body, and d the distance
+// from the body to that centre of mass.  A cell is only approximated if that
+// bound is below |cell_tolerance|, so the error on the acceleration of a body
+// is at most |cell_tolerance| times the number of cells that were
+// approximated for it.
+// Unlike the pairwise computation, the accelerations don't exactly satisfy the
+// third law, so the momentum is only conserved to within the tolerance.
+template<typename Frame>
+class BarnesHutTree final {
+ public:
+  // The bodies are indexed like |gravitational_parameters|.
+  BarnesHutTree(std::vector<GravitationalParameter> gravitational_parameters,
+                Acceleration const& cell_tolerance);
+
+  // Adds to |accelerations| the accelerations exerted by the bodies on one
+  // another.  The positions and accelerations of the bodies have indices
+  // [begin, begin + number_of_bodies[ in |positions| and |accelerations|.
+  void AddAccelerations(
+      std::vector<Position<Frame>> const& positions,
+      std::size_t begin,
+      std::vector<Vector<Acceleration, Frame>>& accelerations);
+
+ private:
+  struct Cell final {
+    // The bodies of the cell are |bodies_[bodies_begin, bodies_end[|.
+    std::int32_t bodies_begin;
+    std::int32_t bodies_end;
+    // The children of the cell are |cells_[children_begin, children_end[|.
+    // The range is empty for a leaf.
+    std::int32_t children_begin = 0;
+    std::int32_t children_end = 0;
+    Position<Frame> centre_of_mass;
+    GravitationalParameter gravitational_parameter;
+    // The distance from the centre of mass to the farthest body of the cell.
+    Length radius;
+  };
+
+  // Computes the centre of mass of |cells_[cell]| and, unless it is small
+  // enough to be a leaf, splits it in octants around |centre|.
+  void Build(std::int32_t cell,
+             Position<Frame> const& centre,
+             Length const& half_size,
+             int depth,
+             std::vector<Position<Frame>> const& positions,
+             std::size_t begin);
+
+  // Returns the acceleration exerted on |body| by the other bodies.
+  Vector<Acceleration, Frame> ComputeAcceleration(
+      std::int32_t body,
+      std::vector<Position<Frame>> const& positions,
+      std::size_t begin);
+
+  std::vector<GravitationalParameter> const gravitational_parameters_;
+  Acceleration const cell_tolerance_;
+
+  // The state of the last call to |AddAccelerations|, kept to avoid
+  // reallocations.  |cells_.front()| is the root.  |bodies_| is a permutation
+  // of the bodies such that each cell has a contiguous range, and
+  // |slots_[body]| is the index of |body| in |bodies_|.
+  std::vector<Cell> cells_;
+  std::vector<std::int32_t> bodies_;
+  std::vector<std::int32_t> slots_;
+  std::vector<std::int32_t> scratch_;
+  std::vector<std::int32_t> stack_;
+};
+
+}  // namespace internal_barnes_hut_tree
+
+using internal_barnes_hut_tree::BarnesHutTree;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/barnes_hut_tree_body.hpp"
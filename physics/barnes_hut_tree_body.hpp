@@ -0,0 +1,222 @@
+#pragma once
+
+#include "physics/barnes_hut_tree.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <utility>
+
+#include "geometry/r3_element.hpp"
+#include "glog/logging.h"
+#include "quantities/elementary_functions.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_barnes_hut_tree {
+
+using geometry::Displacement;
+using geometry::R3Element;
+using quantities::Product;
+using quantities::Sqrt;
+using quantities::Square;
+
+// A cell with at most this many bodies is not split.
+constexpr std::int32_t max_bodies_per_leaf = 8;
+// Bodies that are (nearly) at the same position would otherwise lead to
+// unbounded recursion.
+constexpr int max_depth = 32;
+
+template<typename Frame>
+BarnesHutTree<Frame>::BarnesHutTree(
+    std::vector<GravitationalParameter> gravitational_parameters,
+    Acceleration const& cell_tolerance)
+    : gravitational_parameters_(std::move(gravitational_parameters)),
+      cell_tolerance_(cell_tolerance) {
+  CHECK(!gravitational_parameters_.empty());
+  CHECK_LE(Acceleration(), cell_tolerance_);
+}
+
+template<typename Frame>
+void BarnesHutTree<Frame>::AddAccelerations(
+    std::vector<Position<Frame>> const& positions,
+    std::size_t const begin,
+    std::vector<Vector<Acceleration, Frame>>& accelerations) {
+  std::int32_t const number_of_bodies = gravitational_parameters_.size();
+  CHECK_LE(begin + number_of_bodies, positions.size());
+  CHECK_LE(begin + number_of_bodies, accelerations.size());
+
+  // The root is the cube bounding all the bodies.
+  R3Element<Length> min = (positions[begin] - Frame::origin).coordinates();
+  R3Element<Length> max = min;
+  for (std::int32_t b = 1; b < number_of_bodies; ++b) {
+    R3Element<Length> const coordinates =
+        (positions[begin + b] - Frame::origin).coordinates();
+    min.x = std::min(min.x, coordinates.x);
+    min.y = std::min(min.y, coordinates.y);
+    min.z = std::min(min.z, coordinates.z);
+    max.x = std::max(max.x, coordinates.x);
+    max.y = std::max(max.y, coordinates.y);
+    max.z = std::max(max.z, coordinates.z);
+  }
+  Position<Frame> const centre =
+      Frame::origin + Displacement<Frame>((min + max) / 2);
+  Length const half_size =
+      std::max({max.x - min.x, max.y - min.y, max.z - min.z}) / 2;
+
+  cells_.clear();
+  bodies_.resize(number_of_bodies);
+  std::iota(bodies_.begin(), bodies_.end(), 0);
+  Cell root;
+  root.bodies_begin = 0;
+  root.bodies_end = number_of_bodies;
+  cells_.push_back(root);
+  Build(/*cell=*/0, centre, half_size, /*depth=*/0, positions, begin);
+
+  slots_.resize(number_of_bodies);
+  for (std::int32_t i = 0; i < number_of_bodies; ++i) {
+    slots_[bodies_[i]] = i;
+  }
+
+  for (std::int32_t b = 0; b < number_of_bodies; ++b) {
+    accelerations[begin + b] += ComputeAcceleration(b, positions, begin);
+  }
+}
+
+template<typename Frame>
+void BarnesHutTree<Frame>::Build(
+    std::int32_t const cell,
+    Position<Frame> const& centre,
+    Length const& half_size,
+    int const depth,
+    std::vector<Position<Frame>> const& positions,
+    std::size_t const begin) {
+  std::int32_t const bodies_begin = cells_[cell].bodies_begin;
+  std::int32_t const bodies_end = cells_[cell].bodies_end;
+
+  GravitationalParameter μ;
+  Vector<Product<GravitationalParameter, Length>, Frame> μq;
+  for (std::int32_t i = bodies_begin; i < bodies_end; ++i) {
+    std::int32_t const body = bodies_[i];
+    GravitationalParameter const& μ_body = gravitational_parameters_[body];
+    μ += μ_body;
+    μq += μ_body * (positions[begin + body] - Frame::origin);
+  }
+  Position<Frame> const centre_of_mass = Frame::origin + μq / μ;
+  Length radius;
+  for (std::int32_t i = bodies_begin; i < bodies_end; ++i) {
+    radius = std::max(
+        radius, (positions[begin + bodies_[i]] - centre_of_mass).Norm());
+  }
+  cells_[cell].centre_of_mass = centre_of_mass;
+  cells_[cell].gravitational_parameter = μ;
+  cells_[cell].radius = radius;
+
+  if (bodies_end - bodies_begin <= max_bodies_per_leaf || depth == max_depth) {
+    return;
+  }
+
+  // Sort the bodies of the cell by octant, keeping their relative order.
+  auto const octant = [begin, &centre, &positions](std::int32_t const body) {
+    R3Element<Length> const r =
+        (positions[begin + body] - centre).coordinates();
+    return (r.x >= Length() ? 1 : 0) |
+           (r.y >= Length() ? 2 : 0) |
+           (r.z >= Length() ? 4 : 0);
+  };
+  std::array<std::int32_t, 8> counts{};
+  for (std::int32_t i = bodies_begin; i < bodies_end; ++i) {
+    ++counts[octant(bodies_[i])];
+  }
+  std::array<std::int32_t, 8> starts;
+  starts[0] = bodies_begin;
+  for (int o = 1; o < 8; ++o) {
+    starts[o] = starts[o - 1] + counts[o - 1];
+  }
+  std::array<std::int32_t, 8> next = starts;
+  scratch_.assign(bodies_.begin() + bodies_begin, bodies_.begin() + bodies_end);
+  for (std::int32_t const body : scratch_) {
+    bodies_[next[octant(body)]++] = body;
+  }
+
+  // The children of a cell are contiguous.
+  std::int32_t const children_begin = cells_.size();
+  for (int o = 0; o < 8; ++o) {
+    if (counts[o] > 0) {
+      Cell child;
+      child.bodies_begin = starts[o];
+      child.bodies_end = starts[o] + counts[o];
+      cells_.push_back(child);
+    }
+  }
+  cells_[cell].children_begin = children_begin;
+  cells_[cell].children_end = cells_.size();
+
+  Length const child_half_size = half_size / 2;
+  std::int32_t child = children_begin;
+  for (int o = 0; o < 8; ++o) {
+    if (counts[o] > 0) {
+      Position<Frame> const child_centre =
+          centre + Displacement<Frame>(
+                       {(o & 1) ? child_half_size : -child_half_size,
+                        (o & 2) ? child_half_size : -child_half_size,
+                        (o & 4) ? child_half_size : -child_half_size});
+      Build(child, child_centre, child_half_size, depth + 1, positions, begin);
+      ++child;
+    }
+  }
+}
+
+template<typename Frame>
+Vector<Acceleration, Frame> BarnesHutTree<Frame>::ComputeAcceleration(
+    std::int32_t const body,
+    std::vector<Position<Frame>> const& positions,
+    std::size_t const begin) {
+  Position<Frame> const& q = positions[begin + body];
+  std::int32_t const slot = slots_[body];
+  Vector<Acceleration, Frame> acceleration;
+
+  stack_.assign(1, /*root=*/0);
+  while (!stack_.empty()) {
+    Cell const& cell = cells_[stack_.back()];
+    stack_.pop_back();
+
+    // A cell that contains |body| is never approximated.
+    if (slot < cell.bodies_begin || cell.bodies_end <= slot) {
+      Displacement<Frame> const Δq = cell.centre_of_mass - q;
+      Square<Length> const Δq² = Δq.Norm²();
+      Length const Δq_norm = Sqrt(Δq²);
+      Length const gap = Δq_norm - cell.radius;
+      if (gap > Length()) {
+        Square<Length> const gap² = gap * gap;
+        if (3 * cell.gravitational_parameter * cell.radius * cell.radius <=
+            cell_tolerance_ * gap² * gap²) {
+          acceleration += Δq * cell.gravitational_parameter / (Δq² * Δq_norm);
+          continue;
+        }
+      }
+    }
+
+    if (cell.children_begin == cell.children_end) {
+      for (std::int32_t i = cell.bodies_begin; i < cell.bodies_end; ++i) {
+        if (i == slot) {
+          continue;
+        }
+        std::int32_t const other = bodies_[i];
+        Displacement<Frame> const Δq = positions[begin + other] - q;
+        Square<Length> const Δq² = Δq.Norm²();
+        acceleration +=
+            Δq * gravitational_parameters_[other] / (Δq² * Sqrt(Δq²));
+      }
+    } else {
+      for (std::int32_t c = cell.children_begin; c < cell.children_end; ++c) {
+        stack_.push_back(c);
+      }
+    }
+  }
+  return acceleration;
+}
+
+}  // namespace internal_barnes_hut_tree
+}  // namespace physics
+}  // namespace principia
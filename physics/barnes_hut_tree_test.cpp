@@ -0,0 +1,134 @@
+﻿
+#include "physics/barnes_hut_tree.hpp"
+
+#include <random>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_barnes_hut_tree {
+
+using geometry::Displacement;
+using geometry::Frame;
+using quantities::Pow;
+using quantities::Sqrt;
+using quantities::Square;
+using quantities::si::Metre;
+using quantities::si::Second;
+using testing_utilities::AbsoluteError;
+using testing_utilities::RelativeError;
+using ::testing::Eq;
+using ::testing::Lt;
+
+class BarnesHutTreeTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      serialization::Frame::TEST, true>;
+
+  // |number_of_clusters| clusters of |bodies_per_cluster| bodies each.  The
+  // clusters are much smaller than the distances between them.
+  BarnesHutTreeTest() {
+    int const number_of_clusters = 10;
+    int const bodies_per_cluster = 50;
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+    std::uniform_real_distribution<> mass_distribution(1.0, 10.0);
+    for (int c = 0; c < number_of_clusters; ++c) {
+      Displacement<World> const cluster_centre(
+          {distribution(random) * 1e12 * Metre,
+           distribution(random) * 1e12 * Metre,
+           distribution(random) * 1e12 * Metre});
+      for (int b = 0; b < bodies_per_cluster; ++b) {
+        gravitational_parameters_.push_back(mass_distribution(random) *
+                                            1e16 * Pow<3>(Metre) /
+                                            Pow<2>(Second));
+        positions_.push_back(World::origin + cluster_centre +
+                             Displacement<World>(
+                                 {distribution(random) * 1e9 * Metre,
+                                  distribution(random) * 1e9 * Metre,
+                                  distribution(random) * 1e9 * Metre}));
+      }
+    }
+  }
+
+  std::vector<Vector<Acceleration, World>> ComputePairwiseAccelerations()
+      const {
+    std::vector<Vector<Acceleration, World>> accelerations(positions_.size());
+    for (std::size_t b1 = 0; b1 < positions_.size(); ++b1) {
+      for (std::size_t b2 = 0; b2 < positions_.size(); ++b2) {
+        if (b1 != b2) {
+          Displacement<World> const Δq = positions_[b2] - positions_[b1];
+          Square<Length> const Δq² = Δq.Norm²();
+          accelerations[b1] +=
+              Δq * gravitational_parameters_[b2] / (Δq² * Sqrt(Δq²));
+        }
+      }
+    }
+    return accelerations;
+  }
+
+  std::vector<GravitationalParameter> gravitational_parameters_;
+  std::vector<Position<World>> positions_;
+};
+
+// With a zero tolerance only the cells that contain a single body are
+// approximated, so the tree is exact up to rounding.
+TEST_F(BarnesHutTreeTest, ZeroTolerance) {
+  auto const expected_accelerations = ComputePairwiseAccelerations();
+  BarnesHutTree<World> tree(gravitational_parameters_, Acceleration());
+  std::vector<Vector<Acceleration, World>> accelerations(positions_.size());
+  tree.AddAccelerations(positions_, /*begin=*/0, accelerations);
+  for (std::size_t b = 0; b < positions_.size(); ++b) {
+    EXPECT_THAT(RelativeError(expected_accelerations[b], accelerations[b]),
+                Lt(1e-13)) << b;
+  }
+}
+
+TEST_F(BarnesHutTreeTest, ErrorBound) {
+  auto const expected_accelerations = ComputePairwiseAccelerations();
+  Acceleration const cell_tolerance = 1e-12 * Metre / Pow<2>(Second);
+  BarnesHutTree<World> tree(gravitational_parameters_, cell_tolerance);
+  std::vector<Vector<Acceleration, World>> accelerations(positions_.size());
+  tree.AddAccelerations(positions_, /*begin=*/0, accelerations);
+  for (std::size_t b = 0; b < positions_.size(); ++b) {
+    EXPECT_THAT(AbsoluteError(expected_accelerations[b], accelerations[b]),
+                Lt(cell_tolerance * positions_.size())) << b;
+  }
+}
+
+// The bodies of the tree may be preceded by other bodies, whose accelerations
+// are left untouched, and the accelerations are added to the existing ones.
+TEST_F(BarnesHutTreeTest, Offset) {
+  auto const expected_accelerations = ComputePairwiseAccelerations();
+  Vector<Acceleration, World> const a({1 * Metre / Pow<2>(Second),
+                                       2 * Metre / Pow<2>(Second),
+                                       3 * Metre / Pow<2>(Second)});
+  std::vector<Position<World>> positions = {World::origin, World::origin};
+  positions.insert(positions.end(), positions_.begin(), positions_.end());
+  std::vector<Vector<Acceleration, World>> accelerations(positions.size(), a);
+
+  BarnesHutTree<World> tree(gravitational_parameters_, Acceleration());
+  tree.AddAccelerations(positions, /*begin=*/2, accelerations);
+  EXPECT_THAT(accelerations[0], Eq(a));
+  EXPECT_THAT(accelerations[1], Eq(a));
+  for (std::size_t b = 0; b < positions_.size(); ++b) {
+    EXPECT_THAT(RelativeError(expected_accelerations[b] + a,
+                              accelerations[b + 2]),
+                Lt(1e-13)) << b;
+  }
+}
+
+}  // namespace internal_barnes_hut_tree
+}  // namespace physics
+}  // namespace principia
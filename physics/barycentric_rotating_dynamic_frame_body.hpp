@@ -4,6 +4,7 @@
 #include "physics/barycentric_rotating_dynamic_frame.hpp"
 
 #include <algorithm>
+#include <vector>
 
 #include "geometry/barycentre_calculator.hpp"
 #include "geometry/named_quantities.hpp"
@@ -69,33 +70,34 @@ template<typename InertialFrame, typename ThisFrame>
 RigidMotion<InertialFrame, ThisFrame>
 BarycentricRotatingDynamicFrame<InertialFrame, ThisFrame>::ToThisFrameAtTime(
     Instant const& t) const {
-  DegreesOfFreedom<InertialFrame> const primary_degrees_of_freedom =
-      primary_trajectory_->EvaluateDegreesOfFreedom(t);
-  DegreesOfFreedom<InertialFrame> const secondary_degrees_of_freedom =
-      secondary_trajectory_->EvaluateDegreesOfFreedom(t);
-  DegreesOfFreedom<InertialFrame> const barycentre_degrees_of_freedom =
-      Barycentre<DegreesOfFreedom<InertialFrame>, GravitationalParameter>(
-          {primary_degrees_of_freedom,
-           secondary_degrees_of_freedom},
-          {primary_->gravitational_parameter(),
-           secondary_->gravitational_parameter()});
-
-  Rotation<InertialFrame, ThisFrame> rotation =
-          Rotation<InertialFrame, ThisFrame>::Identity();
-  AngularVelocity<InertialFrame> angular_velocity;
-  ComputeAngularDegreesOfFreedom(primary_degrees_of_freedom,
-                                 secondary_degrees_of_freedom,
-                                 rotation,
-                                 angular_velocity);
+  if (auto const cached = rigid_motion_cache_.Find(t)) {
+    return *cached;
+  }
+  auto const rigid_motion =
+      ToThisFrame(primary_trajectory_->EvaluateDegreesOfFreedom(t),
+                  secondary_trajectory_->EvaluateDegreesOfFreedom(t));
+  rigid_motion_cache_.Insert(t, rigid_motion);
+  return rigid_motion;
+}
 
-  RigidTransformation<InertialFrame, ThisFrame> const
-      rigid_transformation(barycentre_degrees_of_freedom.position(),
-                           ThisFrame::origin,
-                           rotation.Forget());
-  return RigidMotion<InertialFrame, ThisFrame>(
-             rigid_transformation,
-             angular_velocity,
-             barycentre_degrees_of_freedom.velocity());
+template<typename InertialFrame, typename ThisFrame>
+std::vector<RigidMotion<InertialFrame, ThisFrame>>
+BarycentricRotatingDynamicFrame<InertialFrame, ThisFrame>::ToThisFrameAtTimes(
+    std::vector<Instant> const& times) const {
+  std::vector<DegreesOfFreedom<InertialFrame>> primary_degrees_of_freedom;
+  primary_degrees_of_freedom.reserve(times.size());
+  for (Instant const& t : times) {
+    primary_degrees_of_freedom.push_back(
+        primary_trajectory_->EvaluateDegreesOfFreedom(t));
+  }
+  std::vector<RigidMotion<InertialFrame, ThisFrame>> result;
+  result.reserve(times.size());
+  for (int i = 0; i < times.size(); ++i) {
+    result.push_back(
+        ToThisFrame(primary_degrees_of_freedom[i],
+                    secondary_trajectory_->EvaluateDegreesOfFreedom(times[i])));
+  }
+  return result;
 }
 
 template<typename InertialFrame, typename ThisFrame>
@@ -168,6 +170,37 @@ BarycentricRotatingDynamicFrame<InertialFrame, ThisFrame>::MotionOfThisFrame(
              acceleration_of_to_frame_origin);
 }
 
+template<typename InertialFrame, typename ThisFrame>
+RigidMotion<InertialFrame, ThisFrame>
+BarycentricRotatingDynamicFrame<InertialFrame, ThisFrame>::ToThisFrame(
+    DegreesOfFreedom<InertialFrame> const& primary_degrees_of_freedom,
+    DegreesOfFreedom<InertialFrame> const& secondary_degrees_of_freedom)
+    const {
+  DegreesOfFreedom<InertialFrame> const barycentre_degrees_of_freedom =
+      Barycentre<DegreesOfFreedom<InertialFrame>, GravitationalParameter>(
+          {primary_degrees_of_freedom,
+           secondary_degrees_of_freedom},
+          {primary_->gravitational_parameter(),
+           secondary_->gravitational_parameter()});
+
+  Rotation<InertialFrame, ThisFrame> rotation =
+          Rotation<InertialFrame, ThisFrame>::Identity();
+  AngularVelocity<InertialFrame> angular_velocity;
+  ComputeAngularDegreesOfFreedom(primary_degrees_of_freedom,
+                                 secondary_degrees_of_freedom,
+                                 rotation,
+                                 angular_velocity);
+
+  RigidTransformation<InertialFrame, ThisFrame> const
+      rigid_transformation(barycentre_degrees_of_freedom.position(),
+                           ThisFrame::origin,
+                           rotation.Forget());
+  return RigidMotion<InertialFrame, ThisFrame>(
+             rigid_transformation,
+             angular_velocity,
+             barycentre_degrees_of_freedom.velocity());
+}
+
 template<typename InertialFrame, typename ThisFrame>
 void BarycentricRotatingDynamicFrame<InertialFrame, ThisFrame>::
 ComputeAngularDegreesOfFreedom(
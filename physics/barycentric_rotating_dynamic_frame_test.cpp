@@ -2,6 +2,7 @@
 #include "physics/barycentric_rotating_dynamic_frame.hpp"
 
 #include <memory>
+#include <vector>
 
 #include "astronomy/frames.hpp"
 #include "geometry/barycentre_calculator.hpp"
@@ -208,6 +209,56 @@ TEST_F(BarycentricRotatingDynamicFrameTest, Inverse) {
   }
 }
 
+TEST_F(BarycentricRotatingDynamicFrameTest, ToThisFrameAtTimes) {
+  int const steps = 100;
+  std::vector<Instant> times;
+  for (Instant t = t0_; t < t0_ + 1 * period_; t += period_ / steps) {
+    times.push_back(t);
+  }
+  auto const to_big_small_frame_at_times =
+      big_small_frame_->ToThisFrameAtTimes(times);
+  ASSERT_EQ(times.size(), to_big_small_frame_at_times.size());
+  for (int i = 0; i < times.size(); ++i) {
+    EXPECT_EQ(big_small_frame_->ToThisFrameAtTime(times[i])(
+                  small_initial_state_),
+              to_big_small_frame_at_times[i](small_initial_state_));
+  }
+}
+
+TEST_F(BarycentricRotatingDynamicFrameTest, RigidMotionCache) {
+  Instant const t0 = t0_;
+  Instant const t1 = t0_ + 1 * Second;
+  DegreesOfFreedom<ICRFJ2000Equator> const big_dof =
+      {Displacement<ICRFJ2000Equator>({0.8 * Metre, -0.6 * Metre, 0 * Metre}) +
+           ICRFJ2000Equator::origin,
+       Velocity<ICRFJ2000Equator>({-16 * Metre / Second,
+                                   12 * Metre / Second,
+                                   0 * Metre / Second})};
+  DegreesOfFreedom<ICRFJ2000Equator> const small_dof =
+      {Displacement<ICRFJ2000Equator>({5 * Metre, 5 * Metre, 0 * Metre}) +
+           ICRFJ2000Equator::origin,
+       Velocity<ICRFJ2000Equator>({40 * Metre / Second,
+                                   -30 * Metre / Second,
+                                   0 * Metre / Second})};
+
+  // Repeated evaluations at the same time only evaluate the trajectories once.
+  EXPECT_CALL(mock_big_trajectory_, EvaluateDegreesOfFreedom(t0))
+      .WillOnce(Return(big_dof));
+  EXPECT_CALL(mock_small_trajectory_, EvaluateDegreesOfFreedom(t0))
+      .WillOnce(Return(small_dof));
+  EXPECT_CALL(mock_big_trajectory_, EvaluateDegreesOfFreedom(t1))
+      .WillOnce(Return(small_dof));
+  EXPECT_CALL(mock_small_trajectory_, EvaluateDegreesOfFreedom(t1))
+      .WillOnce(Return(big_dof));
+  auto const to_mock_frame_at_t0 = mock_frame_->ToThisFrameAtTime(t0);
+  auto const to_mock_frame_at_t1 = mock_frame_->ToThisFrameAtTime(t1);
+  EXPECT_EQ(to_mock_frame_at_t0(small_dof),
+            mock_frame_->ToThisFrameAtTime(t0)(small_dof));
+  EXPECT_EQ(to_mock_frame_at_t1(small_dof),
+            mock_frame_->ToThisFrameAtTime(t1)(small_dof));
+  EXPECT_NE(to_mock_frame_at_t0(small_dof), to_mock_frame_at_t1(small_dof));
+}
+
 // Two bodies in rotation with their barycentre at rest.  The test point is at
 // the origin and in motion.  The acceleration is purely due to Coriolis.
 TEST_F(BarycentricRotatingDynamicFrameTest, CoriolisAcceleration) {
@@ -9,6 +9,8 @@
 #ifndef PRINCIPIA_PHYSICS_BODY_CENTRED_BODY_DIRECTION_DYNAMIC_FRAME_HPP_
 #define PRINCIPIA_PHYSICS_BODY_CENTRED_BODY_DIRECTION_DYNAMIC_FRAME_HPP_
 
+#include <vector>
+
 #include "base/not_null.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -61,6 +63,11 @@ class BodyCentredBodyDirectionDynamicFrame
   RigidMotion<InertialFrame, ThisFrame> ToThisFrameAtTime(
       Instant const& t) const override;
 
+  // Evaluates each of the trajectories at all the |times| before combining
+  // their degrees of freedom.  Doesn't use or fill the cache.
+  std::vector<RigidMotion<InertialFrame, ThisFrame>> ToThisFrameAtTimes(
+      std::vector<Instant> const& times) const override;
+
   void WriteToMessage(
       not_null<serialization::DynamicFrame*> message) const override;
 
@@ -76,6 +83,13 @@ class BodyCentredBodyDirectionDynamicFrame
   AcceleratedRigidMotion<InertialFrame, ThisFrame> MotionOfThisFrame(
       Instant const& t) const override;
 
+  // Returns the motion of this frame given the degrees of freedom of the
+  // primary and the secondary at the same time.
+  RigidMotion<InertialFrame, ThisFrame> ToThisFrame(
+      DegreesOfFreedom<InertialFrame> const& primary_degrees_of_freedom,
+      DegreesOfFreedom<InertialFrame> const& secondary_degrees_of_freedom)
+      const;
+
   // Fills |rotation| with the rotation that maps the basis of |InertialFrame|
   // to the basis of |ThisFrame|.  Fills |angular_velocity| with the
   // corresponding angular velocity.
@@ -94,6 +108,9 @@ class BodyCentredBodyDirectionDynamicFrame
   std::function<Trajectory<InertialFrame> const&()> const primary_trajectory_;
   not_null<ContinuousTrajectory<InertialFrame> const*> const
       secondary_trajectory_;
+
+  mutable typename DynamicFrame<InertialFrame, ThisFrame>::RigidMotionCache
+      rigid_motion_cache_;
 };
 
 }  // namespace internal_body_centred_body_direction_dynamic_frame
@@ -4,6 +4,7 @@
 #include "physics/body_centred_body_direction_dynamic_frame.hpp"
 
 #include <algorithm>
+#include <vector>
 
 #include "geometry/named_quantities.hpp"
 #include "geometry/r3x3_matrix.hpp"
@@ -95,27 +96,42 @@ template<typename InertialFrame, typename ThisFrame>
 RigidMotion<InertialFrame, ThisFrame>
 BodyCentredBodyDirectionDynamicFrame<InertialFrame, ThisFrame>::
     ToThisFrameAtTime(Instant const& t) const {
-  DegreesOfFreedom<InertialFrame> const primary_degrees_of_freedom =
-      primary_trajectory_().EvaluateDegreesOfFreedom(t);
-  DegreesOfFreedom<InertialFrame> const secondary_degrees_of_freedom =
-      secondary_trajectory_->EvaluateDegreesOfFreedom(t);
-
-  Rotation<InertialFrame, ThisFrame> rotation =
-      Rotation<InertialFrame, ThisFrame>::Identity();
-  AngularVelocity<InertialFrame> angular_velocity;
-  ComputeAngularDegreesOfFreedom(primary_degrees_of_freedom,
-                                 secondary_degrees_of_freedom,
-                                 rotation,
-                                 angular_velocity);
+  // The trajectory of a primary which is not a massive body may change, so its
+  // motions are not cached.
+  bool const cacheable = primary_ != nullptr;
+  if (cacheable) {
+    if (auto const cached = rigid_motion_cache_.Find(t)) {
+      return *cached;
+    }
+  }
+  auto const rigid_motion =
+      ToThisFrame(primary_trajectory_().EvaluateDegreesOfFreedom(t),
+                  secondary_trajectory_->EvaluateDegreesOfFreedom(t));
+  if (cacheable) {
+    rigid_motion_cache_.Insert(t, rigid_motion);
+  }
+  return rigid_motion;
+}
 
-  RigidTransformation<InertialFrame, ThisFrame> const
-      rigid_transformation(primary_degrees_of_freedom.position(),
-                           ThisFrame::origin,
-                           rotation.Forget());
-  return RigidMotion<InertialFrame, ThisFrame>(
-             rigid_transformation,
-             angular_velocity,
-             primary_degrees_of_freedom.velocity());
+template<typename InertialFrame, typename ThisFrame>
+std::vector<RigidMotion<InertialFrame, ThisFrame>>
+BodyCentredBodyDirectionDynamicFrame<InertialFrame, ThisFrame>::
+    ToThisFrameAtTimes(std::vector<Instant> const& times) const {
+  Trajectory<InertialFrame> const& primary_trajectory = primary_trajectory_();
+  std::vector<DegreesOfFreedom<InertialFrame>> primary_degrees_of_freedom;
+  primary_degrees_of_freedom.reserve(times.size());
+  for (Instant const& t : times) {
+    primary_degrees_of_freedom.push_back(
+        primary_trajectory.EvaluateDegreesOfFreedom(t));
+  }
+  std::vector<RigidMotion<InertialFrame, ThisFrame>> result;
+  result.reserve(times.size());
+  for (int i = 0; i < times.size(); ++i) {
+    result.push_back(
+        ToThisFrame(primary_degrees_of_freedom[i],
+                    secondary_trajectory_->EvaluateDegreesOfFreedom(times[i])));
+  }
+  return result;
 }
 
 template<typename InertialFrame, typename ThisFrame>
@@ -189,6 +205,30 @@ MotionOfThisFrame(Instant const& t) const {
              acceleration_of_to_frame_origin);
 }
 
+template<typename InertialFrame, typename ThisFrame>
+RigidMotion<InertialFrame, ThisFrame>
+BodyCentredBodyDirectionDynamicFrame<InertialFrame, ThisFrame>::ToThisFrame(
+    DegreesOfFreedom<InertialFrame> const& primary_degrees_of_freedom,
+    DegreesOfFreedom<InertialFrame> const& secondary_degrees_of_freedom)
+    const {
+  Rotation<InertialFrame, ThisFrame> rotation =
+      Rotation<InertialFrame, ThisFrame>::Identity();
+  AngularVelocity<InertialFrame> angular_velocity;
+  ComputeAngularDegreesOfFreedom(primary_degrees_of_freedom,
+                                 secondary_degrees_of_freedom,
+                                 rotation,
+                                 angular_velocity);
+
+  RigidTransformation<InertialFrame, ThisFrame> const
+      rigid_transformation(primary_degrees_of_freedom.position(),
+                           ThisFrame::origin,
+                           rotation.Forget());
+  return RigidMotion<InertialFrame, ThisFrame>(
+             rigid_transformation,
+             angular_velocity,
+             primary_degrees_of_freedom.velocity());
+}
+
 template<typename InertialFrame, typename ThisFrame>
 void BodyCentredBodyDirectionDynamicFrame<InertialFrame, ThisFrame>::
 ComputeAngularDegreesOfFreedom(
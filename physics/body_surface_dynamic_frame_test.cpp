@@ -2,6 +2,7 @@
 #include "physics/body_surface_dynamic_frame.hpp"
 
 #include <memory>
+#include <vector>
 
 #include "astronomy/frames.hpp"
 #include "geometry/frame.hpp"
@@ -344,6 +345,28 @@ TEST_F(BodySurfaceDynamicFrameTest, GeometricAcceleration) {
                   -2.86351379198155506e6 * Metre / Pow<2>(Second)}), 0, 2));
 }
 
+TEST_F(BodySurfaceDynamicFrameTest, GeometricAccelerations) {
+  Instant const t = t0_ + period_;
+  std::vector<DegreesOfFreedom<BigSmallFrame>> const points = {
+      {Displacement<BigSmallFrame>({10 * Metre, 20 * Metre, 30 * Metre}) +
+           BigSmallFrame::origin,
+       Velocity<BigSmallFrame>({3 * Metre / Second,
+                                2 * Metre / Second,
+                                1 * Metre / Second})},
+      {Displacement<BigSmallFrame>({-7 * Kilo(Metre), 5 * Metre, 0 * Metre}) +
+           BigSmallFrame::origin,
+       Velocity<BigSmallFrame>({0 * Metre / Second,
+                                -4 * Metre / Second,
+                                9 * Metre / Second})}};
+  auto const accelerations = big_frame_->GeometricAccelerations(t, points);
+  ASSERT_EQ(points.size(), accelerations.size());
+  for (int i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(big_frame_->GeometricAcceleration(t, points[i]),
+              accelerations[i]);
+  }
+  EXPECT_TRUE(big_frame_->GeometricAccelerations(t, {}).empty());
+}
+
 TEST_F(BodySurfaceDynamicFrameTest, Serialization) {
   serialization::DynamicFrame message;
   big_frame_->WriteToMessage(&message);
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "geometry/named_quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_chunked_timeline {
+
+using geometry::Instant;
+
+// A map from |Instant| to |Value| for timelines which are modified only at
+// their ends, e.g., the timelines of |DiscreteTrajectory|.  The points are
+// stored in contiguous chunks, so iteration is sequential and appending is
+// amortized O(1) without a heap allocation per point.  The chunks start small
+// and their capacity doubles up to |max_chunk_capacity|, so that short
+// timelines remain cheap.  The storage of the chunks which are destroyed is
+// recycled through a per-thread pool, so that short-lived timelines, e.g., the
+// forks which are created and deleted at each step, rarely go through the
+// allocator.
+// Contrary to |std::map|, the elements may only be inserted at the beginning
+// or the end of the timeline, and erased from the beginning or the end, except
+// with |erase_if|.  Iterators are only invalidated by erasing the elements that
+// they designate, and by |erase_if|.
+// The end iterator is never invalidated and remains past the end when elements
+// are appended.
+// A timeline may share chunks with other timelines, see |append_shared|.  A
+// shared chunk is copied when an element is inserted in it, so references (but
+// not iterators) to the elements of a shared chunk may be invalidated by
+// insertions at the end of the timeline that holds that chunk.
+template<typename Value>
+class ChunkedTimeline final {
+  class Chunk;
+
+ public:
+  using key_type = Instant;
+  using mapped_type = Value;
+  using value_type = std::pair<Instant const, Value>;
+  using size_type = std::int64_t;
+
+  class const_iterator final {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = ChunkedTimeline::value_type;
+    using difference_type = std::int64_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    const_iterator() = default;
+
+    reference operator*() const;
+    pointer operator->() const;
+
+    const_iterator& operator++();
+    const_iterator& operator--();
+    const_iterator operator++(int);
+    const_iterator operator--(int);
+
+    bool operator==(const_iterator const& right) const;
+    bool operator!=(const_iterator const& right) const;
+
+   private:
+    // The ordinal used for the end iterator.
+    static constexpr std::int64_t end_ordinal =
+        std::numeric_limits<std::int64_t>::max();
+
+    const_iterator(ChunkedTimeline const* timeline,
+                   std::int64_t ordinal,
+                   std::int64_t slot);
+
+    Chunk const& chunk() const;
+
+    ChunkedTimeline const* timeline_ = nullptr;
+    // The ordinal of the chunk, which doesn't change when chunks are added or
+    // removed at either end, and the slot within the chunk.
+    std::int64_t ordinal_ = end_ordinal;
+    std::int64_t slot_ = 0;
+
+    friend class ChunkedTimeline;
+  };
+  using iterator = const_iterator;
+
+  static constexpr std::int64_t min_chunk_capacity = 8;
+  static constexpr std::int64_t max_chunk_capacity = 512;
+  // The maximum number of chunks of each capacity that are kept in the pool of
+  // a thread.
+  static constexpr std::int64_t max_pooled_chunks = 16;
+
+  ChunkedTimeline() = default;
+
+  // The iterators designate a specific timeline, so this class can be neither
+  // copied nor moved.
+  ChunkedTimeline(ChunkedTimeline const&) = delete;
+  ChunkedTimeline(ChunkedTimeline&&) = delete;
+  ChunkedTimeline& operator=(ChunkedTimeline const&) = delete;
+  ChunkedTimeline& operator=(ChunkedTimeline&&) = delete;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+  bool empty() const;
+  size_type size() const;
+
+  // The number of bytes allocated for the elements, including the unused
+  // slots of the chunks.
+  std::int64_t memory_footprint() const;
+
+  // Complexity is O(log size()).
+  const_iterator find(Instant const& time) const;
+  const_iterator lower_bound(Instant const& time) const;
+  const_iterator upper_bound(Instant const& time) const;
+
+  // |time| must be greater than (resp. less than) the time of the last (resp.
+  // first) element.  Return an iterator to the new element.
+  template<typename... Args>
+  const_iterator emplace_back(Instant const& time, Args&&... args);
+  template<typename... Args>
+  const_iterator emplace_front(Instant const& time, Args&&... args);
+
+  // Appends copies of the elements of [first, last[, which must be after the
+  // last element of this timeline.
+  template<typename InputIterator>
+  void append(InputIterator first, InputIterator last);
+
+  // Same as |append|, but [first, last[ must be a range of another timeline
+  // and its elements are not copied: the chunks that hold them are shared
+  // between the two timelines until either one inserts elements in them.
+  // Complexity is linear in the number of chunks, not in the number of
+  // elements.
+  void append_shared(const_iterator first, const_iterator last);
+
+  // Erases the elements of [first, last[, which must either start at |begin()|
+  // or end at |end()|.  Returns an iterator to the element that follows the
+  // erased ones.
+  const_iterator erase(const_iterator first, const_iterator last);
+  // Erases the element designated by |it|, which must be the first or the last
+  // element.
+  const_iterator erase(const_iterator it);
+
+  // Erases the elements of [first, last[ for which |erase(element)| is true.
+  // |erase| is called once for each element of [first, last[, in order, before
+  // any element is erased.  The range may be in the middle of the timeline.
+  // The elements that precede |last| are moved, so the iterators to them are
+  // invalidated; the other iterators remain valid.  Complexity is linear in
+  // the number of elements of the chunks that hold [first, last[ and in the
+  // number of chunks.  Returns |last|.
+  template<typename Predicate>
+  const_iterator erase_if(const_iterator first,
+                          const_iterator last,
+                          Predicate erase);
+
+  void clear();
+
+ private:
+  using Storage =
+      std::aligned_storage_t<sizeof(value_type), alignof(value_type)>;
+
+  // The storage of a chunk, possibly shared by chunks of several timelines.
+  // The slots in [begin, end[ contain constructed elements; the chunks that
+  // share a block only see a subset of these slots.  The elements never move.
+  class Block final {
+   public:
+    // Returns a block with no elements from the pool of the current thread, or
+    // a new one if the pool is empty.  The caller is the only owner.
+    static Block* Acquire(std::int64_t capacity);
+    // Relinquishes the ownership of |block| by the caller.  If it was the last
+    // owner, the elements are destroyed and the block is returned to the pool
+    // of the current thread, or freed if the pool is full.
+    static void Release(Block* block);
+
+    void AddOwner();
+    bool is_shared() const;
+
+    std::int64_t capacity() const;
+
+    value_type const& operator[](std::int64_t slot) const;
+
+    // Destroys the elements outside of [begin, end[.  The block must not be
+    // shared.
+    void Trim(std::int64_t begin, std::int64_t end);
+
+    // Constructs an element at |slot|, which must be just before or just after
+    // the constructed slots, or anywhere if there are none.  The block must
+    // not be shared.
+    template<typename... Args>
+    void Emplace(std::int64_t slot, Args&&... args);
+    // Destroys the element at |slot|, which must be the first or the last
+    // constructed slot.  The block must not be shared.
+    void Destroy(std::int64_t slot);
+
+   private:
+    explicit Block(std::int64_t capacity);
+
+    // The capacities are the powers of 2 between |min_chunk_capacity| and
+    // |max_chunk_capacity|.
+    static constexpr std::int64_t number_of_capacities = 7;
+    static_assert(min_chunk_capacity << (number_of_capacities - 1) ==
+                  max_chunk_capacity);
+    using Pool = std::array<std::vector<std::unique_ptr<Block>>,
+                            number_of_capacities>;
+
+    // Returns the pool of the current thread.
+    static Pool& pool();
+    static std::int64_t PoolIndex(std::int64_t capacity);
+
+    value_type* slot_address(std::int64_t slot);
+
+    // Atomic because the timelines that share a block may be used by
+    // different threads.
+    std::atomic<std::int64_t> owners_;
+    std::unique_ptr<Storage[]> const storage_;
+    std::int64_t const capacity_;
+    std::int64_t begin_ = 0;
+    std::int64_t end_ = 0;
+  };
+
+  // A fixed-capacity array whose slots in [begin, end[ contain the elements of
+  // the timeline.  The elements are held by a |Block| which may be shared with
+  // other timelines; it is copied when an element is inserted in a shared
+  // block, but not when an element is erased.
+  class Chunk final {
+   public:
+    explicit Chunk(std::int64_t capacity);
+    // Shares the slots in [begin, end[ of |other|.
+    Chunk(Chunk const& other, std::int64_t begin, std::int64_t end);
+    Chunk(Chunk&& other);
+    Chunk& operator=(Chunk&& other);
+    ~Chunk();
+
+    std::int64_t capacity() const;
+    std::int64_t begin() const;
+    std::int64_t end() const;
+    std::int64_t size() const;
+
+    value_type const& operator[](std::int64_t slot) const;
+
+    template<typename... Args>
+    void EmplaceFront(Args&&... args);
+    template<typename... Args>
+    void EmplaceBack(Args&&... args);
+    void PopFront();
+    void PopBack();
+
+    // Returns the first slot in [begin, end[ for which |before(element)| is
+    // false, or |end| if there is none.
+    template<typename Predicate>
+    std::int64_t PartitionPoint(Predicate const& before) const;
+
+   private:
+    // Ensures that |block_| is not shared and that its elements are exactly
+    // those of this chunk, copying the block if needed.  The elements keep
+    // their slots.
+    void MakeExclusive();
+
+    Block* block_;
+    std::int64_t begin_;
+    std::int64_t end_;
+  };
+
+  Chunk const& chunk(std::int64_t ordinal) const;
+  Chunk& chunk(std::int64_t ordinal);
+
+  // The ordinal of |chunks_.back()|.
+  std::int64_t back_ordinal() const;
+
+  const_iterator front_iterator() const;
+
+  // Returns an iterator to the first element for which |before(element)| is
+  // false, or |end()| if there is none.  |before| must partition the timeline.
+  template<typename Predicate>
+  const_iterator PartitionPoint(Predicate const& before) const;
+
+  // No chunk is empty.
+  std::deque<Chunk> chunks_;
+  // The ordinal of |chunks_.front()|.
+  std::int64_t front_ordinal_ = 0;
+  size_type size_ = 0;
+};
+
+}  // namespace internal_chunked_timeline
+
+using internal_chunked_timeline::ChunkedTimeline;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/chunked_timeline_body.hpp"
@@ -0,0 +1,704 @@
+#pragma once
+
+#include "physics/chunked_timeline.hpp"
+
+#include <algorithm>
+#include <new>
+#include <tuple>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace physics {
+namespace internal_chunked_timeline {
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator::reference
+ChunkedTimeline<Value>::const_iterator::operator*() const {
+  return chunk()[slot_];
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator::pointer
+ChunkedTimeline<Value>::const_iterator::operator->() const {
+  return &chunk()[slot_];
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator&
+ChunkedTimeline<Value>::const_iterator::operator++() {
+  DCHECK_NE(ordinal_, end_ordinal);
+  if (slot_ + 1 < chunk().end()) {
+    ++slot_;
+  } else if (ordinal_ < timeline_->back_ordinal()) {
+    ++ordinal_;
+    slot_ = chunk().begin();
+  } else {
+    ordinal_ = end_ordinal;
+    slot_ = 0;
+  }
+  return *this;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator&
+ChunkedTimeline<Value>::const_iterator::operator--() {
+  if (ordinal_ == end_ordinal) {
+    CHECK(!timeline_->empty());
+    ordinal_ = timeline_->back_ordinal();
+    slot_ = chunk().end() - 1;
+  } else if (slot_ > chunk().begin()) {
+    --slot_;
+  } else {
+    DCHECK_GT(ordinal_, timeline_->front_ordinal_);
+    --ordinal_;
+    slot_ = chunk().end() - 1;
+  }
+  return *this;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::const_iterator::operator++(int) {
+  const_iterator const result = *this;
+  ++*this;
+  return result;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::const_iterator::operator--(int) {
+  const_iterator const result = *this;
+  --*this;
+  return result;
+}
+
+template<typename Value>
+bool ChunkedTimeline<Value>::const_iterator::operator==(
+    const_iterator const& right) const {
+  DCHECK_EQ(timeline_, right.timeline_);
+  return ordinal_ == right.ordinal_ && slot_ == right.slot_;
+}
+
+template<typename Value>
+bool ChunkedTimeline<Value>::const_iterator::operator!=(
+    const_iterator const& right) const {
+  return !(*this == right);
+}
+
+template<typename Value>
+ChunkedTimeline<Value>::const_iterator::const_iterator(
+    ChunkedTimeline const* const timeline,
+    std::int64_t const ordinal,
+    std::int64_t const slot)
+    : timeline_(timeline),
+      ordinal_(ordinal),
+      slot_(slot) {}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::Chunk const&
+ChunkedTimeline<Value>::const_iterator::chunk() const {
+  DCHECK_NE(ordinal_, end_ordinal);
+  return timeline_->chunk(ordinal_);
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::begin() const {
+  if (empty()) {
+    return end();
+  }
+  return front_iterator();
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::end() const {
+  return const_iterator(this, const_iterator::end_ordinal, /*slot=*/0);
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::cbegin() const {
+  return begin();
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::cend() const {
+  return end();
+}
+
+template<typename Value>
+bool ChunkedTimeline<Value>::empty() const {
+  return size_ == 0;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::size_type
+ChunkedTimeline<Value>::size() const {
+  return size_;
+}
+
+template<typename Value>
+std::int64_t ChunkedTimeline<Value>::memory_footprint() const {
+  std::int64_t footprint = chunks_.size() * sizeof(Chunk);
+  for (auto const& chunk : chunks_) {
+    footprint += chunk.capacity() * sizeof(value_type);
+  }
+  return footprint;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::find(Instant const& time) const {
+  auto const it = lower_bound(time);
+  if (it == end() || it->first != time) {
+    return end();
+  }
+  return it;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::lower_bound(Instant const& time) const {
+  return PartitionPoint(
+      [&time](value_type const& element) { return element.first < time; });
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::upper_bound(Instant const& time) const {
+  return PartitionPoint(
+      [&time](value_type const& element) { return element.first <= time; });
+}
+
+template<typename Value>
+template<typename... Args>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::emplace_back(Instant const& time, Args&&... args) {
+  if (chunks_.empty()) {
+    chunks_.emplace_back(min_chunk_capacity);
+  } else {
+    Chunk const& back = chunks_.back();
+    CHECK_LT(back[back.end() - 1].first, time);
+    if (back.end() == back.capacity()) {
+      chunks_.emplace_back(
+          std::min(2 * back.capacity(), max_chunk_capacity));
+    }
+  }
+  Chunk& back = chunks_.back();
+  back.EmplaceBack(std::piecewise_construct,
+                   std::forward_as_tuple(time),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+  ++size_;
+  return const_iterator(this, back_ordinal(), back.end() - 1);
+}
+
+template<typename Value>
+template<typename... Args>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::emplace_front(Instant const& time, Args&&... args) {
+  if (chunks_.empty()) {
+    return emplace_back(time, std::forward<Args>(args)...);
+  }
+  Chunk const& front = chunks_.front();
+  CHECK_LT(time, front[front.begin()].first);
+  if (front.begin() == 0) {
+    chunks_.emplace_front(min_chunk_capacity);
+    --front_ordinal_;
+  }
+  chunks_.front().EmplaceFront(
+      std::piecewise_construct,
+      std::forward_as_tuple(time),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+  ++size_;
+  return front_iterator();
+}
+
+template<typename Value>
+template<typename InputIterator>
+void ChunkedTimeline<Value>::append(InputIterator first,
+                                    InputIterator const last) {
+  for (; first != last; ++first) {
+    emplace_back(first->first, first->second);
+  }
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::append_shared(const_iterator const first,
+                                           const_iterator const last) {
+  if (first == last) {
+    return;
+  }
+  ChunkedTimeline const& other = *first.timeline_;
+  CHECK_NE(this, &other);
+  if (!empty()) {
+    Chunk const& back = chunks_.back();
+    CHECK_LT(back[back.end() - 1].first, first->first);
+  }
+  std::int64_t const last_ordinal =
+      last == other.end() ? other.back_ordinal() : last.ordinal_;
+  for (std::int64_t ordinal = first.ordinal_;
+       ordinal <= last_ordinal;
+       ++ordinal) {
+    Chunk const& chunk = other.chunk(ordinal);
+    std::int64_t const begin =
+        ordinal == first.ordinal_ ? first.slot_ : chunk.begin();
+    std::int64_t const end =
+        ordinal == last.ordinal_ ? last.slot_ : chunk.end();
+    if (begin < end) {
+      chunks_.emplace_back(chunk, begin, end);
+      size_ += end - begin;
+    }
+  }
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::erase(const_iterator first,
+                              const_iterator const last) {
+  if (first == last) {
+    return last;
+  }
+  if (first == begin()) {
+    // Erase the prefix.  The chunks that become empty are removed.
+    while (!chunks_.empty()) {
+      Chunk& front = chunks_.front();
+      if (last.ordinal_ == front_ordinal_) {
+        while (front.begin() < last.slot_) {
+          front.PopFront();
+          --size_;
+        }
+        break;
+      }
+      size_ -= front.size();
+      chunks_.pop_front();
+      ++front_ordinal_;
+    }
+    return last;
+  } else {
+    CHECK(last == end()) << "Erasing in the middle of the timeline";
+    // Erase the suffix.
+    while (!chunks_.empty()) {
+      Chunk& back = chunks_.back();
+      if (first.ordinal_ == back_ordinal()) {
+        while (back.end() > first.slot_) {
+          back.PopBack();
+          --size_;
+        }
+        if (back.size() == 0) {
+          chunks_.pop_back();
+        }
+        break;
+      }
+      size_ -= back.size();
+      chunks_.pop_back();
+    }
+    return end();
+  }
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::erase(const_iterator const it) {
+  auto next = it;
+  ++next;
+  return erase(it, next);
+}
+
+template<typename Value>
+template<typename Predicate>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::erase_if(const_iterator const first,
+                                 const_iterator const last,
+                                 Predicate erase) {
+  if (first == last) {
+    return last;
+  }
+  // The chunks from that of |first| to the one preceding that of |last| are
+  // replaced by new chunks holding their elements that precede |first| and the
+  // elements of [first, last[ that are not erased.  The elements of the chunk
+  // of |last| that precede it are also moved to the new chunks, so that |last|
+  // and the elements that follow keep their ordinal and slot.
+  std::int64_t const first_index = first.ordinal_ - front_ordinal_;
+  std::int64_t const last_index =
+      last == end() ? static_cast<std::int64_t>(chunks_.size())
+                    : last.ordinal_ - front_ordinal_;
+  std::deque<Chunk> new_chunks;
+  std::int64_t removed = 0;
+  bool in_range = false;
+  for (const_iterator it(this, first.ordinal_, chunk(first.ordinal_).begin());
+       it != last;
+       ++it) {
+    in_range |= it == first;
+    if (in_range && erase(*it)) {
+      ++removed;
+      continue;
+    }
+    if (new_chunks.empty() ||
+        new_chunks.back().end() == new_chunks.back().capacity()) {
+      new_chunks.emplace_back(max_chunk_capacity);
+    }
+    new_chunks.back().EmplaceBack(*it);
+  }
+
+  if (last != end()) {
+    Chunk& last_chunk = chunks_[last_index];
+    while (last_chunk.begin() < last.slot_) {
+      last_chunk.PopFront();
+    }
+  }
+  chunks_.erase(chunks_.begin() + first_index, chunks_.begin() + last_index);
+  chunks_.insert(chunks_.begin() + first_index,
+                 std::make_move_iterator(new_chunks.begin()),
+                 std::make_move_iterator(new_chunks.end()));
+  front_ordinal_ += last_index - first_index -
+                    static_cast<std::int64_t>(new_chunks.size());
+  size_ -= removed;
+  return last;
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::clear() {
+  chunks_.clear();
+  size_ = 0;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::Block*
+ChunkedTimeline<Value>::Block::Acquire(std::int64_t const capacity) {
+  auto& pooled = pool()[PoolIndex(capacity)];
+  Block* block;
+  if (pooled.empty()) {
+    block = new Block(capacity);
+  } else {
+    block = pooled.back().release();
+    pooled.pop_back();
+  }
+  block->owners_.store(1, std::memory_order_relaxed);
+  return block;
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::Block::Release(Block* const block) {
+  if (block->owners_.fetch_sub(1, std::memory_order_acq_rel) > 1) {
+    return;
+  }
+  block->Trim(/*begin=*/0, /*end=*/0);
+  auto& pooled = pool()[PoolIndex(block->capacity_)];
+  if (static_cast<std::int64_t>(pooled.size()) < max_pooled_chunks) {
+    pooled.emplace_back(block);
+  } else {
+    delete block;
+  }
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::Block::AddOwner() {
+  owners_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename Value>
+bool ChunkedTimeline<Value>::Block::is_shared() const {
+  return owners_.load(std::memory_order_acquire) > 1;
+}
+
+template<typename Value>
+std::int64_t ChunkedTimeline<Value>::Block::capacity() const {
+  return capacity_;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::value_type const&
+ChunkedTimeline<Value>::Block::operator[](std::int64_t const slot) const {
+  DCHECK_LE(begin_, slot);
+  DCHECK_LT(slot, end_);
+  return *std::launder(reinterpret_cast<value_type const*>(&storage_[slot]));
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::Block::Trim(std::int64_t const begin,
+                                         std::int64_t const end) {
+  DCHECK(!is_shared());
+  if (begin >= end) {
+    while (begin_ < end_) {
+      Destroy(begin_);
+    }
+    begin_ = 0;
+    end_ = 0;
+    return;
+  }
+  DCHECK_LE(begin_, begin);
+  DCHECK_LE(end, end_);
+  while (begin_ < begin) {
+    Destroy(begin_);
+  }
+  while (end_ > end) {
+    Destroy(end_ - 1);
+  }
+}
+
+template<typename Value>
+template<typename... Args>
+void ChunkedTimeline<Value>::Block::Emplace(std::int64_t const slot,
+                                            Args&&... args) {
+  DCHECK(!is_shared());
+  CHECK_LE(0, slot);
+  CHECK_LT(slot, capacity_);
+  if (begin_ == end_) {
+    begin_ = slot;
+    end_ = slot;
+  }
+  CHECK(slot == begin_ - 1 || slot == end_) << slot;
+  new (slot_address(slot)) value_type(std::forward<Args>(args)...);
+  if (slot == end_) {
+    ++end_;
+  } else {
+    --begin_;
+  }
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::Block::Destroy(std::int64_t const slot) {
+  DCHECK(!is_shared());
+  CHECK(slot == begin_ || slot == end_ - 1) << slot;
+  slot_address(slot)->~value_type();
+  if (slot == begin_) {
+    ++begin_;
+  } else {
+    --end_;
+  }
+}
+
+template<typename Value>
+ChunkedTimeline<Value>::Block::Block(std::int64_t const capacity)
+    : owners_(0),
+      storage_(new Storage[capacity]),
+      capacity_(capacity) {}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::Block::Pool&
+ChunkedTimeline<Value>::Block::pool() {
+  static thread_local Pool pool;
+  return pool;
+}
+
+template<typename Value>
+std::int64_t ChunkedTimeline<Value>::Block::PoolIndex(
+    std::int64_t const capacity) {
+  std::int64_t index = 0;
+  while ((min_chunk_capacity << index) < capacity) {
+    ++index;
+  }
+  DCHECK_EQ(min_chunk_capacity << index, capacity);
+  return index;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::value_type*
+ChunkedTimeline<Value>::Block::slot_address(std::int64_t const slot) {
+  return std::launder(reinterpret_cast<value_type*>(&storage_[slot]));
+}
+
+template<typename Value>
+ChunkedTimeline<Value>::Chunk::Chunk(std::int64_t const capacity)
+    : block_(Block::Acquire(capacity)),
+      begin_(0),
+      end_(0) {}
+
+template<typename Value>
+ChunkedTimeline<Value>::Chunk::Chunk(Chunk const& other,
+                                     std::int64_t const begin,
+                                     std::int64_t const end)
+    : block_(other.block_),
+      begin_(begin),
+      end_(end) {
+  DCHECK_LE(other.begin_, begin_);
+  DCHECK_LE(end_, other.end_);
+  block_->AddOwner();
+}
+
+template<typename Value>
+ChunkedTimeline<Value>::Chunk::Chunk(Chunk&& other)
+    : block_(other.block_),
+      begin_(other.begin_),
+      end_(other.end_) {
+  other.block_ = nullptr;
+  other.begin_ = 0;
+  other.end_ = 0;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::Chunk&
+ChunkedTimeline<Value>::Chunk::operator=(Chunk&& other) {
+  if (this != &other) {
+    if (block_ != nullptr) {
+      Block::Release(block_);
+    }
+    block_ = other.block_;
+    begin_ = other.begin_;
+    end_ = other.end_;
+    other.block_ = nullptr;
+    other.begin_ = 0;
+    other.end_ = 0;
+  }
+  return *this;
+}
+
+template<typename Value>
+ChunkedTimeline<Value>::Chunk::~Chunk() {
+  if (block_ != nullptr) {
+    Block::Release(block_);
+  }
+}
+
+template<typename Value>
+std::int64_t ChunkedTimeline<Value>::Chunk::capacity() const {
+  return block_->capacity();
+}
+
+template<typename Value>
+std::int64_t ChunkedTimeline<Value>::Chunk::begin() const {
+  return begin_;
+}
+
+template<typename Value>
+std::int64_t ChunkedTimeline<Value>::Chunk::end() const {
+  return end_;
+}
+
+template<typename Value>
+std::int64_t ChunkedTimeline<Value>::Chunk::size() const {
+  return end_ - begin_;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::value_type const&
+ChunkedTimeline<Value>::Chunk::operator[](std::int64_t const slot) const {
+  DCHECK_LE(begin_, slot);
+  DCHECK_LT(slot, end_);
+  return (*block_)[slot];
+}
+
+template<typename Value>
+template<typename... Args>
+void ChunkedTimeline<Value>::Chunk::EmplaceFront(Args&&... args) {
+  MakeExclusive();
+  if (begin_ == end_) {
+    // An empty chunk is filled from its end, as more elements are expected to
+    // be prepended.
+    begin_ = capacity();
+    end_ = capacity();
+  }
+  CHECK_LT(0, begin_);
+  block_->Emplace(begin_ - 1, std::forward<Args>(args)...);
+  --begin_;
+}
+
+template<typename Value>
+template<typename... Args>
+void ChunkedTimeline<Value>::Chunk::EmplaceBack(Args&&... args) {
+  CHECK_LT(end_, capacity());
+  MakeExclusive();
+  block_->Emplace(end_, std::forward<Args>(args)...);
+  ++end_;
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::Chunk::PopFront() {
+  CHECK_LT(begin_, end_);
+  // The elements of a shared block are destroyed when it is released or made
+  // exclusive.
+  if (!block_->is_shared()) {
+    block_->Destroy(begin_);
+  }
+  ++begin_;
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::Chunk::PopBack() {
+  CHECK_LT(begin_, end_);
+  if (!block_->is_shared()) {
+    block_->Destroy(end_ - 1);
+  }
+  --end_;
+}
+
+template<typename Value>
+template<typename Predicate>
+std::int64_t ChunkedTimeline<Value>::Chunk::PartitionPoint(
+    Predicate const& before) const {
+  std::int64_t low = begin_;
+  std::int64_t high = end_;
+  while (low < high) {
+    std::int64_t const middle = low + (high - low) / 2;
+    if (before((*this)[middle])) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+template<typename Value>
+void ChunkedTimeline<Value>::Chunk::MakeExclusive() {
+  if (!block_->is_shared()) {
+    // The block may have been shared when elements were erased from this
+    // chunk, in which case they are still constructed.
+    block_->Trim(begin_, end_);
+    return;
+  }
+  Block* const copy = Block::Acquire(capacity());
+  for (std::int64_t slot = begin_; slot < end_; ++slot) {
+    copy->Emplace(slot, (*block_)[slot]);
+  }
+  Block::Release(block_);
+  block_ = copy;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::Chunk const&
+ChunkedTimeline<Value>::chunk(std::int64_t const ordinal) const {
+  return chunks_[ordinal - front_ordinal_];
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::Chunk&
+ChunkedTimeline<Value>::chunk(std::int64_t const ordinal) {
+  return chunks_[ordinal - front_ordinal_];
+}
+
+template<typename Value>
+std::int64_t ChunkedTimeline<Value>::back_ordinal() const {
+  return front_ordinal_ + static_cast<std::int64_t>(chunks_.size()) - 1;
+}
+
+template<typename Value>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::front_iterator() const {
+  return const_iterator(this, front_ordinal_, chunks_.front().begin());
+}
+
+template<typename Value>
+template<typename Predicate>
+typename ChunkedTimeline<Value>::const_iterator
+ChunkedTimeline<Value>::PartitionPoint(Predicate const& before) const {
+  // Find the first chunk whose last element is not |before|, then search
+  // within that chunk.
+  auto const it = std::partition_point(
+      chunks_.begin(), chunks_.end(), [&before](Chunk const& chunk) {
+        return before(chunk[chunk.end() - 1]);
+      });
+  if (it == chunks_.end()) {
+    return end();
+  }
+  return const_iterator(this,
+                        front_ordinal_ + (it - chunks_.begin()),
+                        it->PartitionPoint(before));
+}
+
+}  // namespace internal_chunked_timeline
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,282 @@
+#include "physics/chunked_timeline.hpp"
+
+#include <iterator>
+#include <vector>
+
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_chunked_timeline {
+
+using quantities::si::Second;
+using ::testing::ElementsAre;
+
+class ChunkedTimelineTest : public ::testing::Test {
+ protected:
+  using Timeline = ChunkedTimeline<int>;
+
+  static Instant Time(int const i) {
+    return Instant() + i * Second;
+  }
+
+  // Returns the values of |timeline|, checking that they are in increasing
+  // order of time, both forwards and backwards.
+  static std::vector<int> Values(Timeline const& timeline) {
+    std::vector<int> values;
+    for (auto const& [time, value] : timeline) {
+      EXPECT_EQ(Time(value), time);
+      values.push_back(value);
+    }
+    std::vector<int> reversed_values;
+    for (auto it = timeline.end(); it != timeline.begin();) {
+      --it;
+      reversed_values.insert(reversed_values.begin(), it->second);
+    }
+    EXPECT_EQ(values, reversed_values);
+    EXPECT_EQ(values.size(), timeline.size());
+    return values;
+  }
+
+  Timeline timeline_;
+};
+
+TEST_F(ChunkedTimelineTest, Empty) {
+  EXPECT_TRUE(timeline_.empty());
+  EXPECT_EQ(0, timeline_.size());
+  EXPECT_TRUE(timeline_.begin() == timeline_.end());
+  EXPECT_TRUE(timeline_.find(Time(0)) == timeline_.end());
+  EXPECT_TRUE(timeline_.lower_bound(Time(0)) == timeline_.end());
+  EXPECT_TRUE(timeline_.upper_bound(Time(0)) == timeline_.end());
+}
+
+TEST_F(ChunkedTimelineTest, AppendAndIterate) {
+  int const n = 3 * Timeline::max_chunk_capacity + 17;
+  for (int i = 0; i < n; ++i) {
+    auto const it = timeline_.emplace_back(Time(i), i);
+    EXPECT_EQ(i, it->second);
+  }
+  std::vector<int> const values = Values(timeline_);
+  ASSERT_EQ(n, values.size());
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(i, values[i]);
+  }
+}
+
+TEST_F(ChunkedTimelineTest, Lookup) {
+  int const n = 1000;
+  for (int i = 0; i < n; ++i) {
+    timeline_.emplace_back(Time(2 * i), 2 * i);
+  }
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(2 * i, timeline_.find(Time(2 * i))->second);
+    EXPECT_TRUE(timeline_.find(Time(2 * i + 1)) == timeline_.end());
+    EXPECT_EQ(2 * i, timeline_.lower_bound(Time(2 * i))->second);
+    EXPECT_EQ(2 * i, timeline_.lower_bound(Time(2 * i - 1))->second);
+    if (i < n - 1) {
+      EXPECT_EQ(2 * i + 2, timeline_.upper_bound(Time(2 * i))->second);
+    }
+  }
+  EXPECT_TRUE(timeline_.lower_bound(Time(2 * n)) == timeline_.end());
+  EXPECT_TRUE(timeline_.upper_bound(Time(2 * n - 2)) == timeline_.end());
+}
+
+TEST_F(ChunkedTimelineTest, Stability) {
+  timeline_.emplace_back(Time(0), 0);
+  auto const first = timeline_.begin();
+  int const* const first_value = &first->second;
+  auto const end = timeline_.end();
+  for (int i = 1; i < 1000; ++i) {
+    timeline_.emplace_back(Time(i), i);
+  }
+  // Appending doesn't move the elements, and the end iterator stays at the
+  // end.
+  EXPECT_EQ(first_value, &first->second);
+  EXPECT_TRUE(first == timeline_.begin());
+  EXPECT_TRUE(end == timeline_.end());
+  auto last = timeline_.end();
+  --last;
+  EXPECT_EQ(999, last->second);
+
+  // Erasing at one end doesn't invalidate the iterators at the other.
+  auto const middle = timeline_.find(Time(500));
+  timeline_.erase(timeline_.begin(), timeline_.find(Time(300)));
+  timeline_.erase(timeline_.find(Time(700)), timeline_.end());
+  EXPECT_EQ(500, middle->second);
+  EXPECT_EQ(300, timeline_.begin()->second);
+  EXPECT_EQ(400, timeline_.size());
+}
+
+TEST_F(ChunkedTimelineTest, Erase) {
+  for (int i = 0; i < 100; ++i) {
+    timeline_.emplace_back(Time(i), i);
+  }
+  auto it = timeline_.erase(timeline_.begin(), timeline_.find(Time(95)));
+  EXPECT_EQ(95, it->second);
+  it = timeline_.erase(timeline_.find(Time(98)), timeline_.end());
+  EXPECT_TRUE(it == timeline_.end());
+  EXPECT_THAT(Values(timeline_), ElementsAre(95, 96, 97));
+  timeline_.erase(timeline_.begin());
+  EXPECT_THAT(Values(timeline_), ElementsAre(96, 97));
+  auto last = timeline_.end();
+  timeline_.erase(--last);
+  EXPECT_THAT(Values(timeline_), ElementsAre(96));
+  timeline_.erase(timeline_.begin(), timeline_.end());
+  EXPECT_TRUE(timeline_.empty());
+  EXPECT_THAT(Values(timeline_), ElementsAre());
+
+  timeline_.emplace_back(Time(3), 3);
+  EXPECT_THAT(Values(timeline_), ElementsAre(3));
+}
+
+TEST_F(ChunkedTimelineTest, EraseIf) {
+  int const n = 3 * Timeline::max_chunk_capacity;
+  for (int i = 0; i < n; ++i) {
+    timeline_.emplace_back(Time(i), i);
+  }
+  auto const last = timeline_.find(Time(n - 100));
+  auto const* const last_address = &last->second;
+  auto const odd = [](auto const& element) { return element.second % 2 == 1; };
+
+  // Erase in the middle of the timeline, across chunks.
+  auto it = timeline_.erase_if(timeline_.find(Time(10)), last, odd);
+  EXPECT_TRUE(it == last);
+  EXPECT_EQ(n - 100, it->second);
+  EXPECT_EQ(last_address, &it->second);
+  std::vector<int> values = Values(timeline_);
+  ASSERT_EQ(10 + (n - 110) / 2 + 100, values.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, values[i]);
+  }
+  for (int i = 10; i < n - 100; i += 2) {
+    EXPECT_EQ(i, values[10 + (i - 10) / 2]);
+  }
+  EXPECT_EQ(n - 1, values.back());
+  EXPECT_EQ(Time(12), timeline_.lower_bound(Time(11))->first);
+
+  // Erase within a chunk.
+  auto const first = timeline_.find(Time(n - 50));
+  it = timeline_.erase_if(first, timeline_.find(Time(n - 40)), odd);
+  EXPECT_EQ(n - 40, it->second);
+  EXPECT_TRUE(timeline_.find(Time(n - 49)) == timeline_.end());
+  EXPECT_EQ(n - 48, timeline_.find(Time(n - 48))->second);
+
+  // Erase a suffix.
+  it = timeline_.erase_if(timeline_.find(Time(n - 10)),
+                          timeline_.end(),
+                          [](auto const&) { return true; });
+  EXPECT_TRUE(it == timeline_.end());
+  EXPECT_EQ(n - 11, (--timeline_.end())->second);
+
+  // Appending and prepending still work.
+  timeline_.emplace_back(Time(n), n);
+  timeline_.emplace_front(Time(-1), -1);
+  values = Values(timeline_);
+  EXPECT_EQ(-1, values.front());
+  EXPECT_EQ(n, values.back());
+}
+
+TEST_F(ChunkedTimelineTest, Prepend) {
+  for (int i = 10; i < 20; ++i) {
+    timeline_.emplace_back(Time(i), i);
+  }
+  for (int i = 9; i >= 0; --i) {
+    auto const it = timeline_.emplace_front(Time(i), i);
+    EXPECT_TRUE(it == timeline_.begin());
+  }
+  std::vector<int> const values = Values(timeline_);
+  ASSERT_EQ(20, values.size());
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(i, values[i]);
+    EXPECT_EQ(i, timeline_.find(Time(i))->second);
+  }
+}
+
+TEST_F(ChunkedTimelineTest, Append) {
+  Timeline other;
+  for (int i = 0; i < 10; ++i) {
+    other.emplace_back(Time(i), i);
+  }
+  timeline_.emplace_back(Time(-1), -1);
+  timeline_.append(other.find(Time(7)), other.end());
+  EXPECT_THAT(Values(timeline_), ElementsAre(-1, 7, 8, 9));
+}
+
+TEST_F(ChunkedTimelineTest, AppendShared) {
+  int const n = Timeline::max_chunk_capacity + 100;
+  for (int i = 0; i < n; ++i) {
+    timeline_.emplace_back(Time(i), i);
+  }
+  Timeline fork;
+  fork.append_shared(timeline_.find(Time(5)), timeline_.end());
+  EXPECT_EQ(n - 5, fork.size());
+  // The elements are shared.
+  EXPECT_EQ(&timeline_.find(Time(5))->second, &fork.begin()->second);
+  EXPECT_EQ(&timeline_.find(Time(n - 1))->second, &(--fork.end())->second);
+
+  // Erasing from either timeline doesn't affect the other one.
+  timeline_.erase(timeline_.find(Time(n - 10)), timeline_.end());
+  EXPECT_EQ(n - 10, timeline_.size());
+  EXPECT_EQ(n - 1, (--fork.end())->second);
+  fork.erase(fork.begin(), fork.find(Time(7)));
+  EXPECT_EQ(5, timeline_.find(Time(5))->second);
+
+  // Appending to either timeline copies the shared chunk.
+  timeline_.emplace_back(Time(n), n);
+  fork.emplace_back(Time(n + 1), n + 1);
+  auto last = timeline_.end();
+  --last;
+  EXPECT_EQ(n, last->second);
+  EXPECT_EQ(n - 11, (--last)->second);
+  last = fork.end();
+  --last;
+  EXPECT_EQ(n + 1, last->second);
+  EXPECT_EQ(n - 1, (--last)->second);
+  EXPECT_NE(&timeline_.find(Time(n - 11))->second,
+            &fork.find(Time(n - 11))->second);
+
+  std::vector<int> const values = Values(fork);
+  ASSERT_EQ(n - 6, values.size());
+  for (int i = 0; i < n - 7; ++i) {
+    EXPECT_EQ(i + 7, values[i]);
+  }
+  EXPECT_EQ(n + 1, values.back());
+  EXPECT_EQ(n - 9, Values(timeline_).size());
+}
+
+TEST_F(ChunkedTimelineTest, RecycledStorage) {
+  int const* address;
+  {
+    Timeline timeline;
+    address = &timeline.emplace_back(Time(1), 1)->second;
+  }
+  {
+    Timeline timeline;
+    EXPECT_EQ(address, &timeline.emplace_back(Time(2), 2)->second);
+    EXPECT_THAT(Values(timeline), ElementsAre(2));
+  }
+}
+
+using ChunkedTimelineDeathTest = ChunkedTimelineTest;
+
+TEST_F(ChunkedTimelineDeathTest, Errors) {
+  timeline_.emplace_back(Time(1), 1);
+  timeline_.emplace_back(Time(2), 2);
+  timeline_.emplace_back(Time(3), 3);
+  EXPECT_DEATH({
+    timeline_.emplace_back(Time(0), 0);
+  }, "Check failed");
+  EXPECT_DEATH({
+    timeline_.emplace_front(Time(2), 2);
+  }, "Check failed");
+  EXPECT_DEATH({
+    timeline_.erase(timeline_.find(Time(2)));
+  }, "middle");
+}
+
+}  // namespace internal_chunked_timeline
+}  // namespace physics
+}  // namespace principia
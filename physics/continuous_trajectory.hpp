@@ -1,15 +1,21 @@
 ﻿
 #pragma once
 
-#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
 
 #include "base/not_null.hpp"
+#include "base/segmented_vector.hpp"
+#include "base/snapshot.hpp"
 #include "base/status.hpp"
 #include "geometry/named_quantities.hpp"
 #include "numerics/polynomial.hpp"
+#include "numerics/polynomial_arena.hpp"
+#include "numerics/polynomial_evaluators.hpp"
+#include "numerics/чебышёв_series.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/trajectory.hpp"
 #include "quantities/quantities.hpp"
@@ -20,6 +26,9 @@ namespace physics {
 namespace internal_continuous_trajectory {
 
 using base::not_null;
+using base::SegmentedVector;
+using base::SnapshotReader;
+using base::SnapshotWriter;
 using base::Status;
 using geometry::Displacement;
 using geometry::Instant;
@@ -27,7 +36,10 @@ using geometry::Position;
 using geometry::Velocity;
 using quantities::Length;
 using quantities::Time;
+using numerics::EstrinEvaluator;
 using numerics::Polynomial;
+using numerics::PolynomialArena;
+using numerics::ЧебышёвSeries;
 
 template<typename Frame>
 class TestableContinuousTrajectory;
@@ -47,8 +59,12 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   // multiple of the coefficient of highest degree (assuming that the series
   // converges reasonably well).  Thus, we pick the degree of the series so that
   // the coefficient of highest degree is less than |tolerance|.
+  // If |max_stride| is greater than 1, the polynomials of a trajectory that is
+  // smooth at the scale of |step| are fitted on samples further apart, see
+  // |stride_|, which yields fewer, longer polynomials.
   ContinuousTrajectory(Time const& step,
-                       Length const& tolerance);
+                       Length const& tolerance,
+                       int max_stride = 1);
   virtual ~ContinuousTrajectory() = default;
 
   ContinuousTrajectory(ContinuousTrajectory const&) = delete;
@@ -63,14 +79,54 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   // benchmarking or analyzing performance.  Do not use in real code.
   double average_degree() const;
 
+  // The number of polynomials of the trajectory, and the number of bytes
+  // allocated for them.  Only useful for benchmarking or analyzing performance
+  // or memory usage.
+  std::int64_t number_of_polynomials() const;
+  std::int64_t polynomials_memory_footprint() const;
+
   // Appends one point to the trajectory.  |time| must be after the last time
   // passed to |Append| if the trajectory is not empty.  The |time|s passed to
   // successive calls to |Append| must be equally spaced with the |step| given
   // at construction.
+  // A new polynomial is only published once it is complete, so this function
+  // may be called concurrently with |t_min|, |t_max| and the evaluation
+  // functions, but not with the other functions of this class.  The readers
+  // only see the polynomials published before they called |t_max|, and the
+  // polynomials never move, so they need not synchronize with the writer.
   Status Append(Instant const& time,
                 DegreesOfFreedom<Frame> const& degrees_of_freedom);
 
-  // Removes all data for times strictly less than |time|.
+  // Returns true if the next call to |Append| will fit a polynomial, which is
+  // much more expensive than merely recording the point.
+  bool NextAppendFits() const;
+
+  // Appends the polynomials of |continuation|, which must start at |t_max()|,
+  // and takes over its impermanent state, so that this object is as if the
+  // points passed to |continuation| had been appended to it.  |continuation| is
+  // typically read from a message written by |WriteCheckpointToMessage|.  May
+  // be called concurrently with the same functions as |Append|.
+  void AppendContinuation(ContinuousTrajectory const& continuation);
+
+  // Makes this trajectory coincide with |*prefix| up to its first time, which
+  // must be within [|prefix->t_min()|, |prefix->t_max()|].  This trajectory
+  // must have been appended to, but must not have any polynomial yet.  The
+  // polynomials of |*prefix| are shared, not copied, so |*prefix| must outlive
+  // this object and must not forget the times before its first time.  A
+  // trajectory with a prefix cannot be serialized, and cannot forget the times
+  // before its first time.
+  void SetPrefix(not_null<ContinuousTrajectory const*> prefix);
+
+  // The |step| given at construction.
+  Time const& step() const;
+
+  // The time of the last point passed to |Append|, which may be after
+  // |t_max|.  For a trajectory that was never appended to, an infinity is
+  // returned.
+  Instant last_point_time() const;
+
+  // Removes all data for times strictly less than |time|.  Requires exclusive
+  // access.
   void ForgetBefore(Instant const& time);
 
   // Implementation of the interface |Trajectory|.
@@ -87,6 +143,19 @@ class ContinuousTrajectory : public Trajectory<Frame> {
 
   // End of the implementation of the interface.
 
+  // Re-fits the trajectory over [t_min, t_max] with Чебышёв series of the given
+  // |degree| on consecutive intervals of duration |interval|, the last one
+  // possibly shorter, in the style of the JPL ephemerides.  The series give the
+  // displacement from |Frame::origin| and are fitted on the positions and
+  // velocities of the trajectory at |newhall_divisions + 1| points of each
+  // interval.  The result may be evaluated without access to this object.
+  // [t_min, t_max] must be within [|this->t_min()|, |this->t_max()|].
+  std::vector<ЧебышёвSeries<Displacement<Frame>>> ToЧебышёвSeries(
+      Instant const& t_min,
+      Instant const& t_max,
+      Time const& interval,
+      int degree) const;
+
   // Returns a checkpoint for the current state of this object.
   Checkpoint GetCheckpoint() const;
 
@@ -97,9 +166,27 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   // taken.
   void WriteToMessage(not_null<serialization::ContinuousTrajectory*> message,
                       Checkpoint const& checkpoint) const;
+  // Serializes the state of this object when the checkpoint was taken, but
+  // none of its polynomials: the result is read as a trajectory that starts at
+  // the checkpoint and may be appended to independently of this object.  The
+  // checkpoint must have been taken after the first polynomial was fitted.
+  void WriteCheckpointToMessage(
+      not_null<serialization::ContinuousTrajectory*> message,
+      Checkpoint const& checkpoint) const;
   static not_null<std::unique_ptr<ContinuousTrajectory>> ReadFromMessage(
       serialization::ContinuousTrajectory const& message);
 
+  // Writes a snapshot of the current state of this object (resp. of its state
+  // when the checkpoint was taken).  A snapshot is a flat, versioned image of
+  // the trajectory that is read without parsing, e.g., from a memory-mapped
+  // file: the polynomials are copied in bulk into the arena.  All the
+  // polynomials must be stored in the arena.
+  void WriteToSnapshot(SnapshotWriter& writer) const;
+  void WriteToSnapshot(SnapshotWriter& writer,
+                       Checkpoint const& checkpoint) const;
+  static not_null<std::unique_ptr<ContinuousTrajectory>> ReadFromSnapshot(
+      SnapshotReader& reader);
+
   // A |Checkpoint| contains the impermanent state of a trajectory, i.e., the
   // state that gets incrementally updated as the polynomials are constructed.
   // The client may get a |Checkpoint| at any time and use it to serialize the
@@ -120,6 +207,7 @@ class ContinuousTrajectory : public Trajectory<Frame> {
                bool is_unstable,
                int degree,
                int degree_age,
+               int stride,
                std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> const&
                    last_points);
     Instant t_max_;
@@ -127,6 +215,7 @@ class ContinuousTrajectory : public Trajectory<Frame> {
     bool is_unstable_;
     int degree_;
     int degree_age_;
+    int stride_;
     std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> last_points_;
     friend class ContinuousTrajectory<Frame>;
   };
@@ -141,16 +230,24 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   // never need to extract their |t_min|.  Logically, the |t_min| for a
   // polynomial is the |t_max| of the previous one.  The first polynomial has a
   // |t_min| which is |*first_time_|.
+  // The polynomials in the monomial basis produced by the Newhall
+  // approximation are stored by value in |arena_|, so that evaluating them
+  // involves neither a heap indirection nor a virtual call.  The lower degrees
+  // may arise for trajectories read from pre-Cohen messages.
+  using Arena = PolynomialArena<Displacement<Frame>, Instant,
+                                /*min_degree=*/1, /*max_degree=*/17,
+                                EstrinEvaluator>;
+
+  // If |polynomial| is null, the polynomial is stored in |arena_| and
+  // designated by |handle|.  Otherwise, |handle| is meaningless.  The latter
+  // case only occurs for polynomials that cannot be stored in the arena, e.g.,
+  // when the factory is overridden for testing.
   struct InstantPolynomialPair {
-    InstantPolynomialPair(
-        Instant t_max,
-        not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
-            polynomial);
     Instant t_max;
-    not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
-        polynomial;
+    typename Arena::Handle handle;
+    std::unique_ptr<Polynomial<Displacement<Frame>, Instant>> polynomial;
   };
-  using InstantPolynomialPairs = std::vector<InstantPolynomialPair>;
+  using InstantPolynomialPairs = SegmentedVector<InstantPolynomialPair>;
 
   // May be overridden for testing.
   virtual not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
@@ -171,15 +268,49 @@ class ContinuousTrajectory : public Trajectory<Frame> {
       std::vector<Displacement<Frame>> const& q,
       std::vector<Velocity<Frame>> const& v);
 
+  // Adjusts |stride_| for the next polynomial based on the degree that was
+  // needed to fit the last one.
+  void AdaptStride();
+
+  // Appends |polynomial| for the interval ending at |t_max|, storing it in the
+  // arena if possible, and publishes it to the readers.
+  void PushBackPolynomial(
+      Instant const& t_max,
+      not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
+          polynomial);
+
+  // Evaluation and serialization of the polynomial of |pair|, wherever it is
+  // stored.
+  Displacement<Frame> EvaluatePolynomial(InstantPolynomialPair const& pair,
+                                         Instant const& time) const;
+  Velocity<Frame> EvaluatePolynomialDerivative(
+      InstantPolynomialPair const& pair,
+      Instant const& time) const;
+  void EvaluatePolynomialWithDerivative(
+      InstantPolynomialPair const& pair,
+      Instant const& time,
+      Displacement<Frame>& displacement,
+      Velocity<Frame>& velocity) const;
+  int PolynomialDegree(InstantPolynomialPair const& pair) const;
+  void WritePolynomialToMessage(
+      InstantPolynomialPair const& pair,
+      not_null<serialization::Polynomial*> message) const;
+
   // Returns an iterator to the polynomial applicable for the given |time|, or
   // |begin()| if |time| is before the first polynomial or |end()| if |time| is
-  // after the last polynomial.  Time complexity is O(N Log N).
+  // after the last polynomial.  Since the polynomials usually have the length
+  // of the last one (except for the first one), the index of the polynomial is
+  // computed from |time|, so the time complexity is O(1).  It is O(Log N) for
+  // trajectories whose polynomials have irregular lengths, e.g., because their
+  // stride changed.  This function has no side effects, so it may be called
+  // concurrently from multiple threads.
   typename InstantPolynomialPairs::const_iterator
   FindPolynomialForInstant(Instant const& time) const;
 
   // Construction parameters;
   Time const step_;
   Length const tolerance_;
+  int const max_stride_;
 
   // Initially set to the construction parameters, and then adjusted when we
   // choose the degree.
@@ -191,30 +322,26 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   int degree_;
   int degree_age_;
 
-  // The polynomials are in increasing time order.
-  InstantPolynomialPairs polynomials_;
+  // The polynomials are fitted on |divisions + 1| points taken every |stride_|
+  // steps, so they span |divisions * stride_| steps.  The stride is a power of
+  // 2 no greater than |max_stride_|, doubled while the fits have a low degree
+  // and halved when they need a high degree.
+  int stride_;
 
-  // Lookups into |polynomials_| are expensive because they entail a binary
-  // search into a vector that grows over time.  In benchmarks, this can be as
-  // costly as the polynomial evaluation itself.  The accesses are not random,
-  // though, they are clustered in time and (slowly) increasing.  To take
-  // advantage of this, we keep track of the index of the last accessed
-  // polynomial and first try to see if the new lookup is for the same
-  // polynomial.  This makes us O(1) instead of O(Log N) most of the time and it
-  // speeds up the lookup by a factor of 7.  This member is atomic because of
-  // multithreading in the ephemeris, and is mutable to maintain the fiction
-  // that evaluation has no side effects.  In the presence of multithreading it
-  // may be that different threads would want to access polynomials at different
-  // indices, but by and large the threads progress in parallel, and benchmarks
-  // show that there is no adverse performance effects.  Any value in the range
-  // of |polynomials_| or 0 is correct.
-  mutable std::atomic_int last_accessed_polynomial_ = 0;
+  // The polynomials are in increasing time order.  They are appended while
+  // readers evaluate the trajectory, hence the segmented storage.
+  InstantPolynomialPairs polynomials_;
+  Arena arena_;
 
   // The time at which this trajectory starts.  Set for a nonempty trajectory.
   std::optional<Instant> first_time_;
 
-  // The points that have not yet been incorporated in a polynomial.  Nonempty
-  // for a nonempty trajectory.
+  // If not null, the trajectory up to |*first_time_| is that of |*prefix_|,
+  // see |SetPrefix|.
+  ContinuousTrajectory const* prefix_ = nullptr;
+
+  // The points that have not yet been incorporated in a polynomial, at most
+  // |divisions * stride_| of them.  Nonempty for a nonempty trajectory.
   // |last_points_.begin()->first == polynomials_.back().t_max|
   std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> last_points_;
 
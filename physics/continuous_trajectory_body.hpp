@@ -4,6 +4,8 @@
 #include "physics/continuous_trajectory.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <limits>
 #include <optional>
 #include <sstream>
@@ -11,6 +13,8 @@
 #include <vector>
 
 #include "astronomy/epoch.hpp"
+#include "base/profiling.hpp"
+#include "geometry/serialization.hpp"
 #include "glog/stl_logging.h"
 #include "numerics/newhall.hpp"
 #include "numerics/polynomial_evaluators.hpp"
@@ -22,9 +26,12 @@ namespace principia {
 namespace physics {
 namespace internal_continuous_trajectory {
 
+using base::Array;
 using base::Error;
 using base::make_not_null_unique;
-using numerics::EstrinEvaluator;
+using geometry::DoubleOrQuantityOrPointOrMultivectorSnapshotter;
+using numerics::NewhallApproximationInЧебышёвBasis;
+using numerics::newhall_divisions;
 using numerics::ULPDistance;
 using numerics::ЧебышёвSeries;
 using quantities::DebugString;
@@ -39,21 +46,38 @@ int const max_degree_age = 100;
 // Only supports 8 divisions for now.
 int const divisions = 8;
 
+// The stride is doubled after a fit of degree at most
+// |max_degree_to_lengthen|, and halved after a fit of degree at least
+// |min_degree_to_shorten|.  Doubling the span of a polynomial increases the
+// degree needed to meet the tolerance by a few units, so these thresholds
+// leave a margin against oscillations.
+int const max_degree_to_lengthen = 6;
+int const min_degree_to_shorten = 12;
+
+// Identifies the snapshots of a |ContinuousTrajectory|.  The version must be
+// incremented whenever the layout of the snapshots changes.
+std::uint32_t const snapshot_magic = 0x50435453;  // "PCTS".
+std::uint32_t const snapshot_version = 2;
+
 template<typename Frame>
 ContinuousTrajectory<Frame>::ContinuousTrajectory(Time const& step,
-                                                  Length const& tolerance)
+                                                  Length const& tolerance,
+                                                  int const max_stride)
     : step_(step),
       tolerance_(tolerance),
+      max_stride_(max_stride),
       adjusted_tolerance_(tolerance_),
       is_unstable_(false),
       degree_(min_degree),
-      degree_age_(0) {
+      degree_age_(0),
+      stride_(1) {
   CHECK_LT(0 * Metre, tolerance_);
+  CHECK_LE(1, max_stride_);
 }
 
 template<typename Frame>
 bool ContinuousTrajectory<Frame>::empty() const {
-  return polynomials_.empty();
+  return polynomials_.empty() && prefix_ == nullptr;
 }
 
 template<typename Frame>
@@ -63,12 +87,98 @@ double ContinuousTrajectory<Frame>::average_degree() const {
   } else {
     double total = 0;
     for (auto const& pair : polynomials_) {
-      total += pair.polynomial->degree();
+      total += PolynomialDegree(pair);
     }
     return total / polynomials_.size();
   }
 }
 
+template<typename Frame>
+std::int64_t ContinuousTrajectory<Frame>::number_of_polynomials() const {
+  return polynomials_.size();
+}
+
+template<typename Frame>
+std::int64_t ContinuousTrajectory<Frame>::polynomials_memory_footprint() const {
+  std::int64_t footprint =
+      polynomials_.memory_footprint() + arena_.memory_footprint();
+  // For the polynomials that are not in the arena, we don't know the dynamic
+  // type, so this is an underestimate.
+  for (auto const& pair : polynomials_) {
+    if (pair.polynomial != nullptr) {
+      footprint += sizeof(*pair.polynomial);
+    }
+  }
+  return footprint;
+}
+
+template<typename Frame>
+bool ContinuousTrajectory<Frame>::NextAppendFits() const {
+  return last_points_.size() == divisions * stride_;
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::AppendContinuation(
+    ContinuousTrajectory const& continuation) {
+  CHECK(continuation.first_time_.has_value());
+  CHECK_EQ(t_max(), *continuation.first_time_);
+  CHECK_EQ(step_, continuation.step_);
+
+  // The polynomials of the arena are copied without going through a
+  // |Polynomial| object, the others through their serialization.
+  std::vector<std::uint8_t> bytes;
+  for (auto const& continuation_pair : continuation.polynomials_) {
+    if (continuation_pair.polynomial == nullptr) {
+      bytes.clear();
+      SnapshotWriter writer(&bytes);
+      continuation.arena_.WriteToSnapshot(continuation_pair.handle, writer);
+      SnapshotReader reader(
+          Array<std::uint8_t const>(bytes.data(), bytes.size()));
+      InstantPolynomialPair pair;
+      pair.t_max = continuation_pair.t_max;
+      pair.handle = arena_.ReadFromSnapshot(reader);
+      polynomials_.emplace_back(std::move(pair));
+    } else {
+      serialization::Polynomial message;
+      continuation.WritePolynomialToMessage(continuation_pair, &message);
+      PushBackPolynomial(
+          continuation_pair.t_max,
+          Polynomial<Displacement<Frame>, Instant>::template ReadFromMessage<
+              EstrinEvaluator>(message));
+    }
+  }
+
+  adjusted_tolerance_ = continuation.adjusted_tolerance_;
+  is_unstable_ = continuation.is_unstable_;
+  degree_ = continuation.degree_;
+  degree_age_ = continuation.degree_age_;
+  stride_ = continuation.stride_;
+  last_points_ = continuation.last_points_;
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::SetPrefix(
+    not_null<ContinuousTrajectory const*> const prefix) {
+  CHECK(first_time_.has_value());
+  CHECK(polynomials_.empty());
+  CHECK_LE(prefix->t_min(), *first_time_);
+  CHECK_GE(prefix->t_max(), *first_time_);
+  prefix_ = prefix;
+}
+
+template<typename Frame>
+Time const& ContinuousTrajectory<Frame>::step() const {
+  return step_;
+}
+
+template<typename Frame>
+Instant ContinuousTrajectory<Frame>::last_point_time() const {
+  if (last_points_.empty()) {
+    return astronomy::InfinitePast;
+  }
+  return last_points_.back().first;
+}
+
 template<typename Frame>
 Status ContinuousTrajectory<Frame>::Append(
     Instant const& time,
@@ -87,7 +197,8 @@ Status ContinuousTrajectory<Frame>::Append(
   }
 
   Status status;
-  if (last_points_.size() == divisions) {
+  if (last_points_.size() == divisions * stride_) {
+    PRINCIPIA_PROFILE_SCOPE(ContinuousTrajectoryFit);
     // These vectors are thread-local to avoid deallocation/reallocation each
     // time we go through this code path.
     thread_local std::vector<Displacement<Frame>> q(divisions + 1);
@@ -95,8 +206,9 @@ Status ContinuousTrajectory<Frame>::Append(
     q.clear();
     v.clear();
 
-    for (auto const& pair : last_points_) {
-      DegreesOfFreedom<Frame> const& degrees_of_freedom = pair.second;
+    for (int i = 0; i < last_points_.size(); i += stride_) {
+      DegreesOfFreedom<Frame> const& degrees_of_freedom =
+          last_points_[i].second;
       q.push_back(degrees_of_freedom.position() - Frame::origin);
       v.push_back(degrees_of_freedom.velocity());
     }
@@ -104,6 +216,7 @@ Status ContinuousTrajectory<Frame>::Append(
     v.push_back(degrees_of_freedom.velocity());
 
     status = ComputeBestNewhallApproximation(time, q, v);
+    AdaptStride();
 
     // Wipe-out the points that have just been incorporated in a polynomial.
     last_points_.clear();
@@ -119,27 +232,40 @@ Status ContinuousTrajectory<Frame>::Append(
 
 template<typename Frame>
 void ContinuousTrajectory<Frame>::ForgetBefore(Instant const& time) {
+  if (prefix_ != nullptr) {
+    CHECK_LE(*first_time_, time) << "Cannot forget the prefix";
+    prefix_ = nullptr;
+  }
   if (time < t_min()) {
     // TODO(phl): test for this case, it yielded a check failure in
     // |FindPolynomialForInstant|.
     return;
   }
-  polynomials_.erase(polynomials_.begin(), FindPolynomialForInstant(time));
+  auto const first_kept = FindPolynomialForInstant(time);
+  for (auto it = polynomials_.cbegin(); it != first_kept; ++it) {
+    if (it->polynomial == nullptr) {
+      arena_.PopFront(it->handle);
+    }
+  }
+  for (std::int64_t i = first_kept - polynomials_.cbegin(); i > 0; --i) {
+    polynomials_.pop_front();
+  }
 
   // If there are no |polynomials_| left, clear everything.  Otherwise, update
   // the first time.
   if (polynomials_.empty()) {
     first_time_ = std::nullopt;
     last_points_.clear();
-    last_accessed_polynomial_ = 0;
   } else {
     first_time_ = time;
-    last_accessed_polynomial_ = polynomials_.size() - 1;
   }
 }
 
 template<typename Frame>
 Instant ContinuousTrajectory<Frame>::t_min() const {
+  if (prefix_ != nullptr) {
+    return prefix_->t_min();
+  }
   if (polynomials_.empty()) {
     return astronomy::InfiniteFuture;
   }
@@ -149,43 +275,88 @@ Instant ContinuousTrajectory<Frame>::t_min() const {
 template<typename Frame>
 Instant ContinuousTrajectory<Frame>::t_max() const {
   if (polynomials_.empty()) {
-    return astronomy::InfinitePast;
+    return prefix_ == nullptr ? astronomy::InfinitePast : *first_time_;
   }
-  return polynomials_.crbegin()->t_max;
+  return polynomials_.back().t_max;
 }
 
 template<typename Frame>
 Position<Frame> ContinuousTrajectory<Frame>::EvaluatePosition(
     Instant const& time) const {
+  PRINCIPIA_PROFILE_SCOPE(ContinuousTrajectoryEvaluate);
+  if (prefix_ != nullptr && time <= *first_time_) {
+    return prefix_->EvaluatePosition(time);
+  }
   CHECK_LE(t_min(), time);
   CHECK_GE(t_max(), time);
   auto const it = FindPolynomialForInstant(time);
   CHECK(it != polynomials_.end());
-  auto const& polynomial = it->polynomial;
-  return polynomial->Evaluate(time) + Frame::origin;
+  return EvaluatePolynomial(*it, time) + Frame::origin;
 }
 
 template<typename Frame>
 Velocity<Frame> ContinuousTrajectory<Frame>::EvaluateVelocity(
     Instant const& time) const {
+  PRINCIPIA_PROFILE_SCOPE(ContinuousTrajectoryEvaluate);
+  if (prefix_ != nullptr && time <= *first_time_) {
+    return prefix_->EvaluateVelocity(time);
+  }
   CHECK_LE(t_min(), time);
   CHECK_GE(t_max(), time);
   auto const it = FindPolynomialForInstant(time);
   CHECK(it != polynomials_.end());
-  auto const& polynomial = it->polynomial;
-  return polynomial->EvaluateDerivative(time);
+  return EvaluatePolynomialDerivative(*it, time);
 }
 
 template<typename Frame>
 DegreesOfFreedom<Frame> ContinuousTrajectory<Frame>::EvaluateDegreesOfFreedom(
     Instant const& time) const {
+  PRINCIPIA_PROFILE_SCOPE(ContinuousTrajectoryEvaluate);
+  if (prefix_ != nullptr && time <= *first_time_) {
+    return prefix_->EvaluateDegreesOfFreedom(time);
+  }
   CHECK_LE(t_min(), time);
   CHECK_GE(t_max(), time);
   auto const it = FindPolynomialForInstant(time);
   CHECK(it != polynomials_.end());
-  auto const& polynomial = it->polynomial;
-  return DegreesOfFreedom<Frame>(polynomial->Evaluate(time) + Frame::origin,
-                                 polynomial->EvaluateDerivative(time));
+  Displacement<Frame> displacement;
+  Velocity<Frame> velocity;
+  EvaluatePolynomialWithDerivative(*it, time, displacement, velocity);
+  return DegreesOfFreedom<Frame>(displacement + Frame::origin, velocity);
+}
+
+template<typename Frame>
+std::vector<ЧебышёвSeries<Displacement<Frame>>>
+ContinuousTrajectory<Frame>::ToЧебышёвSeries(Instant const& t_min,
+                                            Instant const& t_max,
+                                            Time const& interval,
+                                            int const degree) const {
+  CHECK_LE(this->t_min(), t_min);
+  CHECK_GE(this->t_max(), t_max);
+  CHECK_LT(t_min, t_max);
+  CHECK_LT(Time(), interval);
+
+  std::vector<ЧебышёвSeries<Displacement<Frame>>> series;
+  std::vector<Displacement<Frame>> q(newhall_divisions + 1);
+  std::vector<Velocity<Frame>> v(newhall_divisions + 1);
+  for (Instant lower = t_min; lower < t_max;) {
+    Instant const upper = std::min(lower + interval, t_max);
+    for (int i = 0; i <= newhall_divisions; ++i) {
+      Instant const t =
+          i == newhall_divisions
+              ? upper
+              : lower + i * (upper - lower) / newhall_divisions;
+      DegreesOfFreedom<Frame> const degrees_of_freedom =
+          EvaluateDegreesOfFreedom(t);
+      q[i] = degrees_of_freedom.position() - Frame::origin;
+      v[i] = degrees_of_freedom.velocity();
+    }
+    Displacement<Frame> error_estimate;
+    series.push_back(NewhallApproximationInЧебышёвBasis(
+        degree, q, v, lower, upper, error_estimate));
+    lower = upper;
+  }
+  return series;
 }
 
 template<typename Frame>
@@ -196,6 +367,7 @@ ContinuousTrajectory<Frame>::GetCheckpoint() const {
           is_unstable_,
           degree_,
           degree_age_,
+          stride_,
           last_points_};
 }
 
@@ -209,6 +381,7 @@ template<typename Frame>
 void ContinuousTrajectory<Frame>::WriteToMessage(
       not_null<serialization::ContinuousTrajectory*> const message,
       Checkpoint const& checkpoint) const {
+  CHECK(prefix_ == nullptr) << "Cannot serialize a trajectory with a prefix";
   step_.WriteToMessage(message->mutable_step());
   tolerance_.WriteToMessage(message->mutable_tolerance());
   checkpoint.adjusted_tolerance_.WriteToMessage(
@@ -216,13 +389,16 @@ void ContinuousTrajectory<Frame>::WriteToMessage(
   message->set_is_unstable(checkpoint.is_unstable_);
   message->set_degree(checkpoint.degree_);
   message->set_degree_age(checkpoint.degree_age_);
+  if (max_stride_ > 1) {
+    message->set_max_stride(max_stride_);
+    message->set_stride(checkpoint.stride_);
+  }
   for (auto const& pair : polynomials_) {
     Instant const& t_max = pair.t_max;
-    auto const& polynomial = pair.polynomial;
     if (t_max <= checkpoint.t_max_) {
-      auto* const pair = message->add_instant_polynomial_pair();
-      t_max.WriteToMessage(pair->mutable_t_max());
-      polynomial->WriteToMessage(pair->mutable_polynomial());
+      auto* const pair_message = message->add_instant_polynomial_pair();
+      t_max.WriteToMessage(pair_message->mutable_t_max());
+      WritePolynomialToMessage(pair, pair_message->mutable_polynomial());
     }
     if (t_max == checkpoint.t_max_) {
       break;
@@ -244,6 +420,36 @@ void ContinuousTrajectory<Frame>::WriteToMessage(
   }
 }
 
+template<typename Frame>
+void ContinuousTrajectory<Frame>::WriteCheckpointToMessage(
+    not_null<serialization::ContinuousTrajectory*> const message,
+    Checkpoint const& checkpoint) const {
+  CHECK(checkpoint.IsAfter(astronomy::InfinitePast))
+      << "Checkpoint taken before the first polynomial";
+  step_.WriteToMessage(message->mutable_step());
+  tolerance_.WriteToMessage(message->mutable_tolerance());
+  checkpoint.adjusted_tolerance_.WriteToMessage(
+      message->mutable_adjusted_tolerance());
+  message->set_is_unstable(checkpoint.is_unstable_);
+  message->set_degree(checkpoint.degree_);
+  message->set_degree_age(checkpoint.degree_age_);
+  if (max_stride_ > 1) {
+    message->set_max_stride(max_stride_);
+    message->set_stride(checkpoint.stride_);
+  }
+  checkpoint.t_max_.WriteToMessage(message->mutable_first_time());
+  for (auto const& pair : checkpoint.last_points_) {
+    Instant const& instant = pair.first;
+    DegreesOfFreedom<Frame> const& degrees_of_freedom = pair.second;
+    not_null<
+        serialization::ContinuousTrajectory::InstantaneousDegreesOfFreedom*>
+        const instantaneous_degrees_of_freedom = message->add_last_point();
+    instant.WriteToMessage(instantaneous_degrees_of_freedom->mutable_instant());
+    degrees_of_freedom.WriteToMessage(
+        instantaneous_degrees_of_freedom->mutable_degrees_of_freedom());
+  }
+}
+
 template<typename Frame>
 not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>
 ContinuousTrajectory<Frame>::ReadFromMessage(
@@ -252,12 +458,15 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
   not_null<std::unique_ptr<ContinuousTrajectory<Frame>>> continuous_trajectory =
       std::make_unique<ContinuousTrajectory<Frame>>(
           Time::ReadFromMessage(message.step()),
-          Length::ReadFromMessage(message.tolerance()));
+          Length::ReadFromMessage(message.tolerance()),
+          message.has_max_stride() ? message.max_stride() : 1);
   continuous_trajectory->adjusted_tolerance_ =
       Length::ReadFromMessage(message.adjusted_tolerance());
   continuous_trajectory->is_unstable_ = message.is_unstable();
   continuous_trajectory->degree_ = message.degree();
   continuous_trajectory->degree_age_ = message.degree_age();
+  continuous_trajectory->stride_ =
+      message.has_stride() ? message.stride() : 1;
   if (is_pre_cohen) {
     for (auto const& s : message.series()) {
       // Read the series, evaluate it and use the resulting values to build a
@@ -273,7 +482,7 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
         v.push_back(series.EvaluateDerivative(t));
       }
       Displacement<Frame> error_estimate;  // Should we do something with this?
-      continuous_trajectory->polynomials_.emplace_back(
+      continuous_trajectory->PushBackPolynomial(
           series.t_max(),
           continuous_trajectory->NewhallApproximationInMonomialBasis(
               series.degree(),
@@ -283,7 +492,7 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
     }
   } else {
     for (auto const& pair : message.instant_polynomial_pair()) {
-      continuous_trajectory->polynomials_.emplace_back(
+      continuous_trajectory->PushBackPolynomial(
           Instant::ReadFromMessage(pair.t_max()),
           Polynomial<Displacement<Frame>, Instant>::template ReadFromMessage<
               EstrinEvaluator>(pair.polynomial()));
@@ -301,6 +510,115 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
   return continuous_trajectory;
 }
 
+template<typename Frame>
+void ContinuousTrajectory<Frame>::WriteToSnapshot(
+    SnapshotWriter& writer) const {
+  WriteToSnapshot(writer, GetCheckpoint());
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::WriteToSnapshot(
+    SnapshotWriter& writer,
+    Checkpoint const& checkpoint) const {
+  using InstantSnapshotter =
+      DoubleOrQuantityOrPointOrMultivectorSnapshotter<Instant>;
+  using PositionSnapshotter =
+      DoubleOrQuantityOrPointOrMultivectorSnapshotter<Position<Frame>>;
+  using VelocitySnapshotter =
+      DoubleOrQuantityOrPointOrMultivectorSnapshotter<Velocity<Frame>>;
+  CHECK(prefix_ == nullptr) << "Cannot serialize a trajectory with a prefix";
+  writer.Write(snapshot_magic);
+  writer.Write(snapshot_version);
+  writer.Write(step_ / Second);
+  writer.Write(tolerance_ / Metre);
+  writer.Write<std::int32_t>(max_stride_);
+  writer.Write(checkpoint.adjusted_tolerance_ / Metre);
+  writer.Write<std::uint8_t>(checkpoint.is_unstable_);
+  writer.Write<std::int32_t>(checkpoint.degree_);
+  writer.Write<std::int32_t>(checkpoint.degree_age_);
+  writer.Write<std::int32_t>(checkpoint.stride_);
+
+  std::int64_t polynomials_size = 0;
+  for (auto const& pair : polynomials_) {
+    if (pair.t_max > checkpoint.t_max_) {
+      break;
+    }
+    ++polynomials_size;
+  }
+  writer.Write(polynomials_size);
+  for (std::int64_t i = 0; i < polynomials_size; ++i) {
+    auto const& pair = polynomials_[i];
+    CHECK(pair.polynomial == nullptr)
+        << "Cannot snapshot a polynomial stored outside of the arena";
+    InstantSnapshotter::WriteToSnapshot(pair.t_max, writer);
+    arena_.WriteToSnapshot(pair.handle, writer);
+  }
+
+  writer.Write<std::uint8_t>(first_time_.has_value());
+  if (first_time_) {
+    InstantSnapshotter::WriteToSnapshot(*first_time_, writer);
+  }
+  writer.Write<std::int64_t>(checkpoint.last_points_.size());
+  for (auto const& [instant, degrees_of_freedom] : checkpoint.last_points_) {
+    InstantSnapshotter::WriteToSnapshot(instant, writer);
+    PositionSnapshotter::WriteToSnapshot(degrees_of_freedom.position(), writer);
+    VelocitySnapshotter::WriteToSnapshot(degrees_of_freedom.velocity(), writer);
+  }
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>
+ContinuousTrajectory<Frame>::ReadFromSnapshot(SnapshotReader& reader) {
+  using InstantSnapshotter =
+      DoubleOrQuantityOrPointOrMultivectorSnapshotter<Instant>;
+  using PositionSnapshotter =
+      DoubleOrQuantityOrPointOrMultivectorSnapshotter<Position<Frame>>;
+  using VelocitySnapshotter =
+      DoubleOrQuantityOrPointOrMultivectorSnapshotter<Velocity<Frame>>;
+  CHECK_EQ(snapshot_magic, reader.Read<std::uint32_t>())
+      << "Not a trajectory snapshot";
+  CHECK_EQ(snapshot_version, reader.Read<std::uint32_t>())
+      << "Unsupported trajectory snapshot version";
+  Time const step = reader.Read<double>() * Second;
+  Length const tolerance = reader.Read<double>() * Metre;
+  int const max_stride = reader.Read<std::int32_t>();
+  not_null<std::unique_ptr<ContinuousTrajectory<Frame>>> continuous_trajectory =
+      std::make_unique<ContinuousTrajectory<Frame>>(step,
+                                                    tolerance,
+                                                    max_stride);
+  continuous_trajectory->adjusted_tolerance_ = reader.Read<double>() * Metre;
+  continuous_trajectory->is_unstable_ = reader.Read<std::uint8_t>();
+  continuous_trajectory->degree_ = reader.Read<std::int32_t>();
+  continuous_trajectory->degree_age_ = reader.Read<std::int32_t>();
+  continuous_trajectory->stride_ = reader.Read<std::int32_t>();
+
+  auto const polynomials_size = reader.Read<std::int64_t>();
+  CHECK_LE(0, polynomials_size);
+  for (std::int64_t i = 0; i < polynomials_size; ++i) {
+    InstantPolynomialPair pair;
+    pair.t_max = InstantSnapshotter::ReadFromSnapshot(reader);
+    pair.handle = continuous_trajectory->arena_.ReadFromSnapshot(reader);
+    continuous_trajectory->polynomials_.emplace_back(std::move(pair));
+  }
+
+  if (reader.Read<std::uint8_t>()) {
+    continuous_trajectory->first_time_ =
+        InstantSnapshotter::ReadFromSnapshot(reader);
+  }
+  auto const last_points_size = reader.Read<std::int64_t>();
+  CHECK_LE(0, last_points_size);
+  for (std::int64_t i = 0; i < last_points_size; ++i) {
+    Instant const instant = InstantSnapshotter::ReadFromSnapshot(reader);
+    Position<Frame> const position =
+        PositionSnapshotter::ReadFromSnapshot(reader);
+    Velocity<Frame> const velocity =
+        VelocitySnapshotter::ReadFromSnapshot(reader);
+    continuous_trajectory->last_points_.push_back(
+        {instant, DegreesOfFreedom<Frame>(position, velocity)});
+  }
+  return continuous_trajectory;
+}
+
 template<typename Frame>
 bool ContinuousTrajectory<Frame>::Checkpoint::IsAfter(
     Instant const& time) const {
@@ -314,24 +632,91 @@ ContinuousTrajectory<Frame>::Checkpoint::Checkpoint(
     bool const is_unstable,
     int const degree,
     int const degree_age,
+    int const stride,
     std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> const& last_points)
     : t_max_(t_max),
       adjusted_tolerance_(adjusted_tolerance),
       is_unstable_(is_unstable),
       degree_(degree),
       degree_age_(degree_age),
+      stride_(stride),
       last_points_(last_points) {}
 
 template<typename Frame>
-ContinuousTrajectory<Frame>::ContinuousTrajectory() {}
+ContinuousTrajectory<Frame>::ContinuousTrajectory() : max_stride_(1) {}
 
 template<typename Frame>
-ContinuousTrajectory<Frame>::InstantPolynomialPair::InstantPolynomialPair(
-    Instant const t_max,
+void ContinuousTrajectory<Frame>::PushBackPolynomial(
+    Instant const& t_max,
     not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
-        polynomial)
-    : t_max(t_max),
-      polynomial(std::move(polynomial)) {}
+        polynomial) {
+  // The pair is complete before it is published, since readers may access it
+  // as soon as it is in |polynomials_|.
+  InstantPolynomialPair pair;
+  pair.t_max = t_max;
+  if (auto const handle = arena_.PushBack(*polynomial)) {
+    pair.handle = *handle;
+  } else {
+    pair.polynomial = std::move(polynomial);
+  }
+  polynomials_.emplace_back(std::move(pair));
+}
+
+template<typename Frame>
+Displacement<Frame> ContinuousTrajectory<Frame>::EvaluatePolynomial(
+    InstantPolynomialPair const& pair,
+    Instant const& time) const {
+  if (pair.polynomial == nullptr) {
+    return arena_.Evaluate(pair.handle, time);
+  } else {
+    return pair.polynomial->Evaluate(time);
+  }
+}
+
+template<typename Frame>
+Velocity<Frame> ContinuousTrajectory<Frame>::EvaluatePolynomialDerivative(
+    InstantPolynomialPair const& pair,
+    Instant const& time) const {
+  if (pair.polynomial == nullptr) {
+    return arena_.EvaluateDerivative(pair.handle, time);
+  } else {
+    return pair.polynomial->EvaluateDerivative(time);
+  }
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::EvaluatePolynomialWithDerivative(
+    InstantPolynomialPair const& pair,
+    Instant const& time,
+    Displacement<Frame>& displacement,
+    Velocity<Frame>& velocity) const {
+  if (pair.polynomial == nullptr) {
+    arena_.EvaluateWithDerivative(pair.handle, time, displacement, velocity);
+  } else {
+    pair.polynomial->EvaluateWithDerivative(time, displacement, velocity);
+  }
+}
+
+template<typename Frame>
+int ContinuousTrajectory<Frame>::PolynomialDegree(
+    InstantPolynomialPair const& pair) const {
+  if (pair.polynomial == nullptr) {
+    return pair.handle.degree;
+  } else {
+    return pair.polynomial->degree();
+  }
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::WritePolynomialToMessage(
+    InstantPolynomialPair const& pair,
+    not_null<serialization::Polynomial*> const message) const {
+  if (pair.polynomial == nullptr) {
+    arena_.WriteToMessage(pair.handle, message);
+  } else {
+    pair.polynomial->WriteToMessage(message);
+  }
+}
 
 template<typename Frame>
 not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
@@ -367,14 +752,16 @@ Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
     degree_age_ = 0;
   }
 
-  // Compute the approximation with the current degree.
+  // Compute the approximation with the current degree.  The approximations
+  // are only published once we have settled on a degree, since the readers of
+  // |polynomials_| may not see a polynomial that gets replaced.
   Displacement<Frame> displacement_error_estimate;
-  polynomials_.emplace_back(time,
-                            NewhallApproximationInMonomialBasis(
-                                degree_,
-                                q, v,
-                                last_points_.cbegin()->first, time,
-                                displacement_error_estimate));
+  not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
+      polynomial = NewhallApproximationInMonomialBasis(
+          degree_,
+          q, v,
+          last_points_.cbegin()->first, time,
+          displacement_error_estimate);
 
   // Estimate the error.  For initializing |previous_error_estimate|, any value
   // greater than |error_estimate| will do.
@@ -406,11 +793,11 @@ Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
     ++degree_;
     VLOG(1) << "Increasing degree for " << this << " to " <<degree_
             << " because error estimate was " << error_estimate;
-    polynomials_.back().polynomial = NewhallApproximationInMonomialBasis(
-                                         degree_,
-                                         q, v,
-                                         last_points_.cbegin()->first, time,
-                                         displacement_error_estimate);
+    polynomial = NewhallApproximationInMonomialBasis(
+        degree_,
+        q, v,
+        last_points_.cbegin()->first, time,
+        displacement_error_estimate);
     previous_error_estimate = error_estimate;
     error_estimate = displacement_error_estimate.Norm();
   }
@@ -434,6 +821,7 @@ Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
   }
 
   ++degree_age_;
+  PushBackPolynomial(time, std::move(polynomial));
 
   // Check that the tolerance did not explode.
   if (adjusted_tolerance_ < 1e6 * previous_adjusted_tolerance) {
@@ -451,31 +839,66 @@ Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
   }
 }
 
+template<typename Frame>
+void ContinuousTrajectory<Frame>::AdaptStride() {
+  if (is_unstable_ || degree_ >= min_degree_to_shorten) {
+    if (stride_ > 1) {
+      stride_ /= 2;
+      VLOG(1) << "Decreasing stride for " << this << " to " << stride_
+              << " after a fit of degree " << degree_;
+    }
+  } else if (degree_ <= max_degree_to_lengthen && 2 * stride_ <= max_stride_) {
+    stride_ *= 2;
+    VLOG(1) << "Increasing stride for " << this << " to " << stride_
+            << " after a fit of degree " << degree_;
+  }
+}
+
 template<typename Frame>
 typename ContinuousTrajectory<Frame>::InstantPolynomialPairs::const_iterator
 ContinuousTrajectory<Frame>::FindPolynomialForInstant(
     Instant const& time) const {
   // This returns the first polynomial |p| such that |time <= p.t_max|.
-  {
-    auto const begin = polynomials_.begin();
-    auto const it = begin + last_accessed_polynomial_;
-    if (it != polynomials_.end() && time <= it->t_max &&
-        (it == begin || std::prev(it)->t_max < time)) {
-      return it;
-    }
+  if (polynomials_.empty()) {
+    return polynomials_.end();
+  }
+  auto const begin = polynomials_.begin();
+  auto const end = polynomials_.end();
+
+  // Usually all the polynomials but the first one have the length of the last
+  // one, so we compute an index by dividing the time elapsed since the end of
+  // the first polynomial.  Rounding may put us off by one at the boundaries,
+  // hence the adjustment below.
+  auto it = end;
+  Time const length = end - begin < 2
+                          ? divisions * step_
+                          : std::prev(end)->t_max - std::prev(end, 2)->t_max;
+  double const index = std::ceil((time - begin->t_max) / length);
+  if (index <= 0) {
+    it = begin;
+  } else if (index < static_cast<double>(end - begin)) {
+    it = begin + static_cast<std::int64_t>(index);
   }
-  {
-    auto const it =
-        std::lower_bound(polynomials_.begin(),
-                         polynomials_.end(),
-                         time,
-                         [](InstantPolynomialPair const& left,
-                            Instant const& right) {
-                           return left.t_max < right;
-                         });
-    last_accessed_polynomial_ = it - polynomials_.begin();
+  if (it != end && it->t_max < time) {
+    ++it;
+  } else if (it != begin && time <= std::prev(it)->t_max) {
+    --it;
+  }
+  if ((it == end || time <= it->t_max) &&
+      (it == begin || std::prev(it)->t_max < time)) {
     return it;
   }
+
+  // The polynomials don't have the expected lengths, e.g., because their
+  // stride changed or because they were read from a pre-Cohen message.  Fall
+  // back to a binary search.
+  return std::lower_bound(begin,
+                          end,
+                          time,
+                          [](InstantPolynomialPair const& left,
+                             Instant const& right) {
+                            return left.t_max < right;
+                          });
 }
 
 }  // namespace internal_continuous_trajectory
@@ -2,11 +2,14 @@
 #include "physics/continuous_trajectory.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <limits>
 #include <vector>
 
+#include "base/array.hpp"
+#include "base/snapshot.hpp"
 #include "geometry/frame.hpp"
 #include "geometry/named_quantities.hpp"
 #include "gtest/gtest.h"
@@ -29,6 +32,9 @@ namespace principia {
 namespace physics {
 namespace internal_continuous_trajectory {
 
+using base::Array;
+using base::SnapshotReader;
+using base::SnapshotWriter;
 using geometry::Displacement;
 using geometry::Frame;
 using geometry::Velocity;
@@ -45,6 +51,7 @@ using quantities::Time;
 using quantities::astronomy::JulianYear;
 using quantities::si::Kilo;
 using quantities::si::Metre;
+using quantities::si::Micro;
 using quantities::si::Milli;
 using quantities::si::Radian;
 using quantities::si::Second;
@@ -90,6 +97,11 @@ class TestableContinuousTrajectory : public ContinuousTrajectory<Frame> {
   Length adjusted_tolerance() const;
   bool is_unstable() const;
   void ResetBestNewhallApproximation();
+
+  // The index of the polynomial returned by |FindPolynomialForInstant|, and
+  // the one obtained by a binary search on the |t_max|.
+  std::int64_t FindPolynomialIndex(Instant const& time) const;
+  std::int64_t BinarySearchPolynomialIndex(Instant const& time) const;
 };
 
 template<typename Frame>
@@ -135,6 +147,24 @@ void TestableContinuousTrajectory<Frame>::ResetBestNewhallApproximation() {
   this->degree_age_ = std::numeric_limits<int>::max();
 }
 
+template<typename Frame>
+std::int64_t TestableContinuousTrajectory<Frame>::FindPolynomialIndex(
+    Instant const& time) const {
+  return this->FindPolynomialForInstant(time) - this->polynomials_.begin();
+}
+
+template<typename Frame>
+std::int64_t TestableContinuousTrajectory<Frame>::BinarySearchPolynomialIndex(
+    Instant const& time) const {
+  auto const& polynomials = this->polynomials_;
+  return std::partition_point(polynomials.begin(),
+                              polynomials.end(),
+                              [&time](auto const& pair) {
+                                return pair.t_max < time;
+                              }) -
+         polynomials.begin();
+}
+
 class ContinuousTrajectoryTest : public testing::Test {
  protected:
   using World = Frame<serialization::Frame::TestTag,
@@ -420,6 +450,52 @@ TEST_F(ContinuousTrajectoryTest, Polynomial) {
   }
 }
 
+TEST_F(ContinuousTrajectoryTest, PolynomialLookup) {
+  int const number_of_steps = 1000;
+  Time const step = 10 * Second;
+  auto position_function = [this](Instant const t) {
+    return World::origin +
+           Displacement<World>({(t - t0_) * 3 * Metre / Second,
+                                (t - t0_) * 5 * Metre / Second,
+                                (t - t0_) * (-2) * Metre / Second});
+  };
+  auto velocity_function = [](Instant const t) {
+    return Velocity<World>({3 * Metre / Second,
+                            5 * Metre / Second,
+                            -2 * Metre / Second});
+  };
+
+  auto const trajectory = std::make_unique<TestableContinuousTrajectory<World>>(
+                              step,
+                              /*tolerance=*/0.1 * Metre);
+  EXPECT_CALL(*trajectory, FillNewhallApproximationInMonomialBasis(_, _, _, _,
+                                                                   _, _, _))
+      .Times(::testing::AnyNumber());
+  FillTrajectory(number_of_steps,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 *trajectory);
+
+  // Check the lookups at and around the ends of the polynomials, and outside
+  // of the trajectory.
+  auto check_lookups = [&trajectory, step, this]() {
+    for (int i = -10; i <= number_of_steps + 10; ++i) {
+      Instant const ti = t0_ + i * step;
+      for (Instant const t : {ti - step / 3, ti, ti + step / 3}) {
+        EXPECT_EQ(trajectory->BinarySearchPolynomialIndex(t),
+                  trajectory->FindPolynomialIndex(t)) << i;
+      }
+    }
+  };
+  check_lookups();
+
+  // After |ForgetBefore| the first polynomial is shorter than the others.
+  trajectory->ForgetBefore(t0_ + 44.4 * step);
+  check_lookups();
+}
+
 // An approximation to the trajectory of Io.
 TEST_F(ContinuousTrajectoryTest, Io) {
   int const number_of_steps = 200;
@@ -478,6 +554,7 @@ TEST_F(ContinuousTrajectoryTest, Io) {
   EXPECT_EQ(t0_ + step, trajectory->t_min());
   EXPECT_EQ(t0_ + (((number_of_steps - 1) / 8) * 8 + 1) * step,
             trajectory->t_max());
+  EXPECT_LT(0, trajectory->polynomials_memory_footprint());
 
   Length max_position_absolute_error;
   Speed max_velocity_absolute_error;
@@ -578,6 +655,152 @@ TEST_F(ContinuousTrajectoryTest, Continuity) {
   EXPECT_THAT(p1, AlmostEquals(p3, 0, 2));
 }
 
+TEST_F(ContinuousTrajectoryTest, ToЧебышёвSeries) {
+  int const number_of_steps = 1000;
+  Length const distance = 1 * Kilo(Metre);
+  Time const period = 100 * Second;
+  Time const step = 100 * Milli(Second);
+
+  auto position_function = [this, distance, period](Instant const t) {
+    Angle const angle = 2 * π * Radian * (t - t0_) / period;
+    return World::origin +
+        Displacement<World>({
+            distance * Cos(angle),
+            distance * Sin(angle),
+            0 * Metre});
+  };
+  auto velocity_function = [this, distance, period](Instant const t) {
+    AngularFrequency const ω = 2 * π * Radian / period;
+    Angle const angle = ω * (t - t0_);
+    return Velocity<World>({
+        -ω * distance * Sin(angle) / Radian,
+        ω * distance * Cos(angle) / Radian,
+        0 * Metre / Second});
+  };
+
+  auto const trajectory = std::make_unique<ContinuousTrajectory<World>>(
+                              step,
+                              /*tolerance=*/1 * Milli(Metre));
+  FillTrajectory(number_of_steps,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 *trajectory);
+
+  // The last interval is shorter than the others.
+  Instant const t_min = trajectory->t_min();
+  Instant const t_max = t_min + 75 * Second;
+  auto const series = trajectory->ToЧебышёвSeries(t_min,
+                                                  t_max,
+                                                  /*interval=*/10 * Second,
+                                                  /*degree=*/10);
+  ASSERT_EQ(8, series.size());
+  EXPECT_EQ(t_min, series.front().t_min());
+  EXPECT_EQ(t_max, series.back().t_max());
+  for (int i = 1; i < series.size(); ++i) {
+    EXPECT_EQ(series[i - 1].t_max(), series[i].t_min());
+  }
+
+  Length max_error;
+  for (auto const& s : series) {
+    for (int i = 0; i <= 100; ++i) {
+      Instant const t = s.t_min() + i * (s.t_max() - s.t_min()) / 100;
+      max_error = std::max(
+          max_error,
+          AbsoluteError(trajectory->EvaluatePosition(t) - World::origin,
+                        s.Evaluate(t)));
+    }
+  }
+  EXPECT_LT(max_error, 1 * Milli(Metre));
+}
+
+// A trajectory that is smooth at the scale of the step is fitted with longer
+// polynomials when a stride is allowed, without loss of accuracy.
+TEST_F(ContinuousTrajectoryTest, AdaptiveStride) {
+  int const number_of_steps = 20000;
+  Length const distance = 1000 * Kilo(Metre);
+  Time const period = 1e5 * Second;
+  Time const step = 10 * Second;
+  Length const tolerance = 1 * Milli(Metre);
+
+  auto position_function = [this, distance, period](Instant const t) {
+    Angle const angle = 2 * π * Radian * (t - t0_) / period;
+    return World::origin +
+        Displacement<World>({
+            distance * Cos(angle),
+            distance * Sin(angle),
+            0 * Metre});
+  };
+  auto velocity_function = [this, distance, period](Instant const t) {
+    AngularFrequency const ω = 2 * π * Radian / period;
+    Angle const angle = ω * (t - t0_);
+    return Velocity<World>({
+        -ω * distance * Sin(angle) / Radian,
+        ω * distance * Cos(angle) / Radian,
+        0 * Metre / Second});
+  };
+
+  auto const fixed_trajectory = std::make_unique<ContinuousTrajectory<World>>(
+                                    step, tolerance);
+  auto const adaptive_trajectory =
+      std::make_unique<ContinuousTrajectory<World>>(
+          step, tolerance, /*max_stride=*/16);
+  for (auto const& trajectory : {fixed_trajectory.get(),
+                                 adaptive_trajectory.get()}) {
+    FillTrajectory(number_of_steps,
+                   step,
+                   position_function,
+                   velocity_function,
+                   t0_,
+                   *trajectory);
+  }
+  EXPECT_EQ(2499, fixed_trajectory->number_of_polynomials());
+  EXPECT_GT(fixed_trajectory->number_of_polynomials() / 10,
+            adaptive_trajectory->number_of_polynomials());
+  EXPECT_GT(fixed_trajectory->polynomials_memory_footprint() / 5,
+            adaptive_trajectory->polynomials_memory_footprint());
+  EXPECT_LE(adaptive_trajectory->t_max(), fixed_trajectory->t_max());
+  EXPECT_LT(fixed_trajectory->t_max() - 16 * 8 * step,
+            adaptive_trajectory->t_max());
+
+  Length max_error;
+  for (Instant time = adaptive_trajectory->t_min();
+       time <= adaptive_trajectory->t_max();
+       time += step / 3) {
+    max_error = std::max(
+        max_error,
+        (adaptive_trajectory->EvaluatePosition(time) - position_function(time))
+            .Norm());
+  }
+  EXPECT_THAT(max_error, IsNear(7.8 * Micro(Metre)));
+
+  // The stride survives serialization.
+  serialization::ContinuousTrajectory message;
+  adaptive_trajectory->WriteToMessage(&message);
+  EXPECT_EQ(16, message.max_stride());
+  EXPECT_EQ(16, message.stride());
+  auto const trajectory_read =
+      ContinuousTrajectory<World>::ReadFromMessage(message);
+  FillTrajectory(/*number_of_steps=*/1000,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_ + number_of_steps * step,
+                 *trajectory_read);
+  FillTrajectory(/*number_of_steps=*/1000,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_ + number_of_steps * step,
+                 *adaptive_trajectory);
+  serialization::ContinuousTrajectory second_message;
+  trajectory_read->WriteToMessage(&second_message);
+  message.Clear();
+  adaptive_trajectory->WriteToMessage(&message);
+  EXPECT_THAT(second_message, EqualsProto(message));
+}
+
 TEST_F(ContinuousTrajectoryTest, Serialization) {
   int const number_of_steps = 20;
   int const number_of_substeps = 50;
@@ -637,6 +860,74 @@ TEST_F(ContinuousTrajectoryTest, Serialization) {
   EXPECT_THAT(message, EqualsProto(second_message));
 }
 
+TEST_F(ContinuousTrajectoryTest, Snapshot) {
+  Time const step = 0.01 * Second;
+  Length const tolerance = 0.1 * Metre;
+
+  auto position_function =
+      [this](Instant const t) {
+        return World::origin +
+            Displacement<World>({(t - t0_) * 3 * Metre / Second,
+                                 (t - t0_) * 5 * Metre / Second,
+                                 (t - t0_) * (-2) * Metre / Second});
+      };
+  auto velocity_function =
+      [](Instant const t) {
+        return Velocity<World>({3 * Metre / Second,
+                                5 * Metre / Second,
+                                -2 * Metre / Second});
+      };
+
+  auto const trajectory = std::make_unique<ContinuousTrajectory<World>>(
+                              step, tolerance);
+  FillTrajectory(/*number_of_steps=*/20,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 *trajectory);
+  auto const checkpoint = trajectory->GetCheckpoint();
+  FillTrajectory(/*number_of_steps=*/20,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_ + 20 * step,
+                 *trajectory);
+
+  for (bool const use_checkpoint : {false, true}) {
+    std::vector<std::uint8_t> bytes;
+    SnapshotWriter writer(&bytes);
+    serialization::ContinuousTrajectory message;
+    if (use_checkpoint) {
+      trajectory->WriteToSnapshot(writer, checkpoint);
+      trajectory->WriteToMessage(&message, checkpoint);
+    } else {
+      trajectory->WriteToSnapshot(writer);
+      trajectory->WriteToMessage(&message);
+    }
+
+    SnapshotReader reader(Array<std::uint8_t const>(bytes.data(),
+                                                    bytes.size()));
+    auto const trajectory_read =
+        ContinuousTrajectory<World>::ReadFromSnapshot(reader);
+    EXPECT_EQ(0, reader.remaining());
+    auto const trajectory_parsed =
+        ContinuousTrajectory<World>::ReadFromMessage(message);
+    EXPECT_EQ(trajectory_parsed->t_min(), trajectory_read->t_min());
+    EXPECT_EQ(trajectory_parsed->t_max(), trajectory_read->t_max());
+    for (Instant time = trajectory_read->t_min();
+         time <= trajectory_read->t_max();
+         time += step / 7) {
+      EXPECT_EQ(trajectory_parsed->EvaluateDegreesOfFreedom(time),
+                trajectory_read->EvaluateDegreesOfFreedom(time));
+    }
+
+    serialization::ContinuousTrajectory second_message;
+    trajectory_read->WriteToMessage(&second_message);
+    EXPECT_THAT(second_message, EqualsProto(message));
+  }
+}
+
 TEST_F(ContinuousTrajectoryTest, PreCohenCompatibility) {
   Time const step = 0.01 * Second;
   Length const tolerance = 0.1 * Metre;
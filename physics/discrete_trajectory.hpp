@@ -1,11 +1,14 @@
 ﻿
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <list>
-#include <map>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "base/not_constructible.hpp"
@@ -13,6 +16,7 @@
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
 #include "numerics/hermite3.hpp"
+#include "physics/chunked_timeline.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/forkable.hpp"
 #include "physics/trajectory.hpp"
@@ -34,7 +38,7 @@ using base::not_constructible;
 template<typename Frame>
 struct ForkableTraits<DiscreteTrajectory<Frame>> : not_constructible {
   using TimelineConstIterator =
-      typename std::map<Instant, DegreesOfFreedom<Frame>>::const_iterator;
+      typename ChunkedTimeline<DegreesOfFreedom<Frame>>::const_iterator;
   static Instant const& time(TimelineConstIterator it);
 };
 
@@ -70,7 +74,7 @@ template<typename Frame>
 class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
                                            DiscreteTrajectoryIterator<Frame>>,
                            public Trajectory<Frame> {
-  using Timeline = std::map<Instant, DegreesOfFreedom<Frame>>;
+  using Timeline = ChunkedTimeline<DegreesOfFreedom<Frame>>;
   using TimelineConstIterator = typename Forkable<
       DiscreteTrajectory<Frame>,
       DiscreteTrajectoryIterator<Frame>>::TimelineConstIterator;
@@ -79,6 +83,7 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
   using Iterator = DiscreteTrajectoryIterator<Frame>;
 
   DiscreteTrajectory() = default;
+  ~DiscreteTrajectory() override;
   DiscreteTrajectory(DiscreteTrajectory const&) = delete;
   DiscreteTrajectory(DiscreteTrajectory&&) = delete;
   DiscreteTrajectory& operator=(DiscreteTrajectory const&) = delete;
@@ -108,6 +113,14 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
   // trajectory.
   not_null<DiscreteTrajectory<Frame>*> NewForkAtLast();
 
+  // Returns a new root trajectory with the points of this trajectory at or
+  // after |time|, which must be at or after the fork time, if any.  Except for
+  // the fork point, the points are not copied but shared with this trajectory
+  // as in |NewForkWithCopy|, so the complexity is linear in the number of
+  // chunks of the timeline, not in the number of points.
+  not_null<std::unique_ptr<DiscreteTrajectory<Frame>>> NewRootWithCopy(
+      Instant const& time) const;
+
   // The first point of |fork| is removed from |fork| and appended (using
   // Append) to this trajectory.  Then |fork| is made a fork of this trajectory
   // at the newly-inserted point.  |fork| must be a non-empty root.
@@ -136,14 +149,41 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
   // Following this call, this trajectory must not have forks when calling
   // |Append|.  Occasionally removes intermediate points from the trajectory
   // when |Append|ing, ensuring that |EvaluatePosition| returns a result within
-  // |tolerance| of the missing points.  |max_dense_intervals| is the largest
-  // number of points that can be added before removal is considered.
+  // |tolerance| of the missing points.  Removal is considered each time the
+  // number of points added since the last removal is a power of 2, so that the
+  // cost per point is amortized constant, and when it reaches
+  // |max_dense_intervals|, which bounds the cost of a removal.  The removal
+  // moves the remaining points, so it invalidates the iterators past the start
+  // of the dense timeline.
   void SetDownsampling(std::int64_t max_dense_intervals, Length tolerance);
 
   // Clear the downsampling parameters.  From now on, all points appended to the
   // trajectory are going to be retained.
   void ClearDownsampling();
 
+  // The points of this trajectory up to this time are not removed by the
+  // downsampling when |Append|ing: the time of the start of the dense timeline
+  // if this trajectory is downsampling, |t_max()| otherwise.
+  Instant last_downsampled_time() const;
+
+  // The number of points in the timelines of this trajectory and of its
+  // descendants, i.e., the number of points that it owns, and the number of
+  // bytes allocated for them.  Only useful for analyzing memory usage.
+  std::int64_t subtree_size() const;
+  std::int64_t subtree_memory_footprint() const;
+
+  // Removes intermediate points with times in [t1, t2], ensuring that
+  // |EvaluatePosition| returns a result within |tolerance| of the removed
+  // points.  The first and last points of that interval are retained, as are
+  // the points of the dense timeline if this trajectory is downsampling.  This
+  // is used to retain old parts of a trajectory with a coarser |tolerance| than
+  // that of |SetDownsampling|.  This trajectory must be a root and must not
+  // have forks before |t2|.  The points before |t2| are moved, so this
+  // invalidates the iterators to them.  Returns the number of points removed.
+  std::int64_t Compact(Instant const& t1,
+                       Instant const& t2,
+                       Length tolerance);
+
   // Implementation of the interface |Trajectory|.
 
   // The bounds are the times of |Begin()| and |last()| if this trajectory is
@@ -158,6 +198,40 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
 
   // End of the implementation of the interface.
 
+  // Evaluates a trajectory at successive times, typically nondecreasing, e.g.,
+  // when sweeping another trajectory.  The cursor keeps the interval of the
+  // last evaluation and its interpolation, so moving forward to the following
+  // intervals is amortized O(1) instead of a lookup; moving backward or far
+  // forward does a lookup.  The results are those of the |Evaluate...|
+  // functions of the trajectory, which must not change while the cursor is
+  // used.
+  class EvaluationCursor final {
+   public:
+    explicit EvaluationCursor(DiscreteTrajectory const& trajectory);
+
+    // |time| must be in [t_min, t_max].
+    Position<Frame> EvaluatePosition(Instant const& time);
+    Velocity<Frame> EvaluateVelocity(Instant const& time);
+    DegreesOfFreedom<Frame> EvaluateDegreesOfFreedom(Instant const& time);
+
+   private:
+    // The number of points that the cursor walks forward before resorting to
+    // a lookup.
+    static constexpr int max_forward_steps = 16;
+
+    // Makes |interpolation_| the interpolation at |time|.
+    void MoveTo(Instant const& time);
+
+    not_null<DiscreteTrajectory const*> const trajectory_;
+    Instant const t_min_;
+    Instant const t_max_;
+    // The bounds of the interval of |interpolation_|, which is left-open and
+    // right-closed unless it is reduced to |t_min_|.
+    std::optional<Iterator> upper_;
+    Instant lower_time_;
+    std::optional<Hermite3<Instant, Position<Frame>>> interpolation_;
+  };
+
   // This trajectory must be a root.  Only the given |forks| are serialized.
   // They must be descended from this trajectory.  The pointers in |forks| may
   // be null at entry.
@@ -173,6 +247,16 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
       serialization::DiscreteTrajectory const& message,
       std::vector<DiscreteTrajectory<Frame>**> const& forks);
 
+  // Replaces the |timeline| of |message| and of all its descendants with a
+  // compact, lossless encoding in |packed_timeline|, which is understood by
+  // |ReadFromMessage|.  Each coordinate of a point is
+  // predicted by extrapolating the previous points, and only the significant
+  // bytes of the exclusive or of its representation with that of the
+  // prediction are stored.  The output is meant to be further compressed by
+  // the serializer.
+  static void PackTimelines(
+      not_null<serialization::DiscreteTrajectory*> message);
+
  protected:
   // The API inherited from Forkable.
   not_null<DiscreteTrajectory*> that() override;
@@ -213,6 +297,10 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
 
     std::int64_t max_dense_intervals() const;
     bool reached_max_dense_intervals() const;
+    // True if the dense intervals must be fitted, i.e., if there are at least
+    // 2 of them and their number is a power of 2 or has reached
+    // |max_dense_intervals_|.
+    bool reached_fitting_point() const;
 
     Length tolerance() const;
 
@@ -225,7 +313,8 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
 
    private:
     // The maximal value that |dense_intervals| is allowed to reach before
-    // downsampling occurs.
+    // downsampling occurs, even if the dense timeline is fitted by a single
+    // polynomial.
     std::int64_t const max_dense_intervals_;
     // The tolerance for downsampling with |FitHermiteSpline|.
     Length const tolerance_;
@@ -248,17 +337,50 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
       serialization::DiscreteTrajectory const& message,
       std::vector<DiscreteTrajectory<Frame>**> const& forks);
 
+  // The time and the coordinates of the degrees of freedom of a point, in SI
+  // units, in the order in which they are packed.
+  using PackedPoint = std::array<double, 7>;
+
+  // Extrapolations used for packing a timeline.  |count| is the number of
+  // points already processed, of which |previous| is the last one and
+  // |before_previous| the one before it; they are only meaningful if |count|
+  // is large enough.  |PredictDegreesOfFreedom| predicts the coordinates of
+  // the degrees of freedom of |point| based on the time of |point|.
+  static double PredictTime(std::int64_t count,
+                            PackedPoint const& previous,
+                            PackedPoint const& before_previous);
+  static void PredictDegreesOfFreedom(std::int64_t count,
+                                      PackedPoint const& previous,
+                                      PackedPoint const& before_previous,
+                                      PackedPoint& point);
+
+  // Appends to this timeline the points encoded in |packed_timeline|.
+  void AppendPackedTimeline(std::string const& packed_timeline);
+
   // Returns the Hermite interpolation for the left-open, right-closed
   // trajectory segment containing the given |time|, or, if |time| is |t_min()|,
   // returns a first-degree polynomial which should be evaluated only at
-  // |t_min()|.
+  // |t_min()|.  The last interpolation returned on each thread is cached, so
+  // that evaluating a trajectory at increasing times, e.g., when plotting in a
+  // frame defined by a vessel, mostly doesn't look up the timeline.
   Hermite3<Instant, Position<Frame>> GetInterpolation(
       Instant const& time) const;
 
+  // Must be called whenever points are removed from a trajectory, since this
+  // may change the interpolation of the trajectory and of its forks.
+  static void InvalidateInterpolations();
+
   Timeline timeline_;
 
   std::optional<Downsampling> downsampling_;
 
+  // Incremented when points are removed from a trajectory of this |Frame|, or
+  // when such a trajectory is destroyed.  The interpolations cached by
+  // |GetInterpolation| are only valid for the epoch at which they were
+  // computed.  This is coarse, but the cache only needs to survive the
+  // evaluations of a frame.
+  static std::atomic<std::uint64_t> interpolation_epoch_;
+
   template<typename, typename>
   friend class internal_forkable::ForkableIterator;
   template<typename, typename>
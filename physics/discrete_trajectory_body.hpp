@@ -4,14 +4,18 @@
 #include "physics/discrete_trajectory.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <list>
-#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "astronomy/epoch.hpp"
 #include "geometry/named_quantities.hpp"
 #include "glog/logging.h"
 #include "numerics/fit_hermite_spline.hpp"
+#include "quantities/si.hpp"
 
 namespace principia {
 namespace physics {
@@ -55,7 +59,43 @@ namespace internal_discrete_trajectory {
 using astronomy::InfiniteFuture;
 using astronomy::InfinitePast;
 using base::make_not_null_unique;
+using geometry::Displacement;
 using numerics::FitHermiteSpline;
+using quantities::si::Metre;
+using quantities::si::Second;
+
+// The maximal number of intervals fitted at once by |Compact|, which bounds
+// the cost of a call to |FitHermiteSpline|.
+constexpr std::int64_t max_compacted_intervals = 1'000;
+
+// The number of coordinates of a packed point, see |PackTimelines|.
+constexpr int packed_point_size = 7;
+// The number of bytes that hold the significant byte counts of the residuals
+// of a packed point, two per byte.
+constexpr int packed_point_header_size = (packed_point_size + 1) / 2;
+
+inline std::uint64_t DoubleToBits(double const value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline double BitsToDouble(std::uint64_t const bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// The number of bytes needed to represent |residual|, omitting its leading
+// zero bytes.
+inline int SignificantBytes(std::uint64_t residual) {
+  int significant_bytes = 0;
+  while (residual != 0) {
+    residual >>= 8;
+    ++significant_bytes;
+  }
+  return significant_bytes;
+}
 
 template<typename Frame>
 typename DiscreteTrajectory<Frame>::Iterator
@@ -74,9 +114,10 @@ DiscreteTrajectory<Frame>::NewForkWithCopy(Instant const& time) {
 
   auto const fork = this->NewFork(timeline_it);
 
-  // Copy the tail of the trajectory in the child object.
+  // Share the tail of the trajectory with the child object.  The points are
+  // only copied when either trajectory appends to a shared chunk.
   if (timeline_it != timeline_.end()) {
-    fork->timeline_.insert(++timeline_it, timeline_.end());
+    fork->timeline_.append_shared(++timeline_it, timeline_.end());
   }
   return fork;
 }
@@ -104,6 +145,29 @@ DiscreteTrajectory<Frame>::NewForkAtLast() {
   }
 }
 
+template<typename Frame>
+std::atomic<std::uint64_t> DiscreteTrajectory<Frame>::interpolation_epoch_{0};
+
+template<typename Frame>
+DiscreteTrajectory<Frame>::~DiscreteTrajectory() {
+  // The address of this object may be reused by another trajectory.
+  InvalidateInterpolations();
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<DiscreteTrajectory<Frame>>>
+DiscreteTrajectory<Frame>::NewRootWithCopy(Instant const& time) const {
+  CHECK(this->is_root() || time >= this->Fork().time())
+      << "NewRootWithCopy at " << time << " before the fork time";
+  auto root = make_not_null_unique<DiscreteTrajectory<Frame>>();
+  if (!this->is_root() && time == this->Fork().time()) {
+    // The fork point is held by the parent.
+    root->timeline_.emplace_back(time, this->Fork().degrees_of_freedom());
+  }
+  root->timeline_.append_shared(timeline_.lower_bound(time), timeline_.end());
+  return root;
+}
+
 template<typename Frame>
 void DiscreteTrajectory<Frame>::AttachFork(
     not_null<std::unique_ptr<DiscreteTrajectory<Frame>>> fork) {
@@ -121,6 +185,7 @@ void DiscreteTrajectory<Frame>::AttachFork(
   // Remove the first point of |fork| now that it properly attached to its
   // parent.
   fork_timeline.erase(fork_begin);
+  InvalidateInterpolations();
 }
 
 template<typename Frame>
@@ -131,9 +196,10 @@ DiscreteTrajectory<Frame>::DetachFork() {
   // Insert a new point in the timeline for the fork time.  It should go at the
   // beginning of the timeline.
   auto const fork_it = this->Fork();
-  auto const begin_it = timeline_.emplace_hint(
-      timeline_.begin(), fork_it.time(), fork_it.degrees_of_freedom());
+  auto const begin_it = timeline_.emplace_front(fork_it.time(),
+                                                fork_it.degrees_of_freedom());
   CHECK(begin_it == timeline_.begin());
+  InvalidateInterpolations();
 
   // Detach this trajectory and tell the caller that it owns the pieces.
   return this->DetachForkWithCopiedBegin();
@@ -153,43 +219,83 @@ void DiscreteTrajectory<Frame>::Append(
                  << last().time() << "]";
     return;
   }
-  auto it = timeline_.emplace_hint(timeline_.end(),
-                                   time,
-                                   degrees_of_freedom);
-  // Decrementing |end()| is much faster than incrementing |it|.  Don't ask.
-  CHECK(--timeline_.end() == it)
-      << "Append out of order at " << time << ", last time is "
-      << (--timeline_.end())->first;
+  if (!timeline_.empty()) {
+    Instant const& last_time = (--timeline_.end())->first;
+    if (last_time == time) {
+      return;
+    }
+    CHECK_LT(last_time, time)
+        << "Append out of order at " << time << ", last time is "
+        << last_time;
+  }
+  timeline_.emplace_back(time, degrees_of_freedom);
   if (downsampling_.has_value()) {
     if (timeline_.size() == 1) {
       downsampling_->SetStartOfDenseTimeline(timeline_.begin(), timeline_);
     } else {
       this->CheckNoForksBefore(last().time());
       downsampling_->increment_dense_intervals(timeline_);
-      if (downsampling_->reached_max_dense_intervals()) {
+      if (downsampling_->reached_fitting_point()) {
+        // These contain points, hence one more than intervals.  The times,
+        // positions and velocities are copied to contiguous arrays so that the
+        // fit doesn't have to chase the iterators.
+        std::int64_t const dense_points =
+            downsampling_->max_dense_intervals() + 1;
         std::vector<TimelineConstIterator> dense_iterators;
-        // This contains points, hence one more than intervals.
-        dense_iterators.reserve(downsampling_->max_dense_intervals() + 1);
+        std::vector<Instant> dense_times;
+        std::vector<Position<Frame>> dense_positions;
+        std::vector<Velocity<Frame>> dense_velocities;
+        dense_iterators.reserve(dense_points);
+        dense_times.reserve(dense_points);
+        dense_positions.reserve(dense_points);
+        dense_velocities.reserve(dense_points);
         for (TimelineConstIterator it =
                  downsampling_->start_of_dense_timeline();
              it != timeline_.end();
              ++it) {
           dense_iterators.push_back(it);
+          dense_times.push_back(it->first);
+          dense_positions.push_back(it->second.position());
+          dense_velocities.push_back(it->second.velocity());
         }
         auto right_endpoints = FitHermiteSpline<Instant, Position<Frame>>(
-            dense_iterators,
-            [](auto&& it) -> auto&& { return it->first; },
-            [](auto&& it) -> auto&& { return it->second.position(); },
-            [](auto&& it) -> auto&& { return it->second.velocity(); },
+            dense_times,
+            dense_positions,
+            dense_velocities,
             downsampling_->tolerance());
         if (right_endpoints.empty()) {
-          right_endpoints.push_back(dense_iterators.end() - 1);
+          if (!downsampling_->reached_max_dense_intervals()) {
+            // The dense timeline is fitted by a single polynomial, which may
+            // still be extended by the next points.
+            return;
+          }
+          right_endpoints.push_back(dense_iterators.size() - 1);
+        }
+        // The timeline can only be erased at its ends, so we save the points
+        // that we keep (the right endpoints and the points that follow the
+        // last one), truncate the timeline after the start of the dense
+        // timeline, and append the saved points.
+        std::vector<typename Timeline::value_type> kept_points;
+        kept_points.reserve(dense_iterators.size());
+        for (std::int64_t const index : right_endpoints) {
+          kept_points.push_back(*dense_iterators[index]);
+        }
+        std::int64_t const number_of_right_endpoints = kept_points.size();
+        for (TimelineConstIterator it = ++TimelineConstIterator{
+                 dense_iterators[right_endpoints.back()]};
+             it != timeline_.end();
+             ++it) {
+          kept_points.push_back(*it);
         }
         TimelineConstIterator left = downsampling_->start_of_dense_timeline();
-        for (const auto& it_in_dense_iterators : right_endpoints) {
-          TimelineConstIterator const right = *it_in_dense_iterators;
-          timeline_.erase(++left, right);
-          left = right;
+        timeline_.erase(++TimelineConstIterator{left}, timeline_.end());
+        InvalidateInterpolations();
+        for (std::int64_t i = 0; i < kept_points.size(); ++i) {
+          auto const it = timeline_.emplace_back(kept_points[i].first,
+                                                 kept_points[i].second);
+          if (i == number_of_right_endpoints - 1) {
+            left = it;
+          }
         }
         downsampling_->SetStartOfDenseTimeline(left, timeline_);
       }
@@ -227,6 +333,7 @@ void DiscreteTrajectory<Frame>::ForgetAfter(Instant const& time) {
     }
   }
   timeline_.erase(first_removed_in_timeline, timeline_.end());
+  InvalidateInterpolations();
   if (downsampling_.has_value()) {
     downsampling_->RecountDenseIntervals(timeline_);
   }
@@ -247,6 +354,7 @@ void DiscreteTrajectory<Frame>::ForgetBefore(Instant const& time) {
     downsampling_->SetStartOfDenseTimeline(first_kept_in_timeline, timeline_);
   }
   timeline_.erase(timeline_.begin(), first_kept_in_timeline);
+  InvalidateInterpolations();
 }
 
 template<typename Frame>
@@ -263,6 +371,106 @@ void DiscreteTrajectory<Frame>::ClearDownsampling() {
   downsampling_.reset();
 }
 
+template<typename Frame>
+std::int64_t DiscreteTrajectory<Frame>::subtree_size() const {
+  std::int64_t size = 0;
+  this->ForSubTree([&size](DiscreteTrajectory const& trajectory) {
+    size += trajectory.timeline_.size();
+  });
+  return size;
+}
+
+template<typename Frame>
+std::int64_t DiscreteTrajectory<Frame>::subtree_memory_footprint() const {
+  std::int64_t footprint = 0;
+  this->ForSubTree([&footprint](DiscreteTrajectory const& trajectory) {
+    footprint += sizeof(trajectory) + trajectory.timeline_.memory_footprint();
+  });
+  return footprint;
+}
+
+template<typename Frame>
+Instant DiscreteTrajectory<Frame>::last_downsampled_time() const {
+  if (downsampling_.has_value() && !timeline_.empty()) {
+    return downsampling_->first_dense_time();
+  }
+  return t_max();
+}
+
+template<typename Frame>
+std::int64_t DiscreteTrajectory<Frame>::Compact(Instant const& t1,
+                                                Instant const& t2,
+                                                Length const tolerance) {
+  CHECK(this->is_root());
+  CHECK_LE(t1, t2);
+  this->CheckNoForksBefore(t2);
+
+  // The samples are the points in [t1, t2] which are not in the dense
+  // timeline, except for its start which is retained.
+  auto last = timeline_.upper_bound(t2);
+  if (downsampling_.has_value() &&
+      downsampling_->start_of_dense_timeline() != timeline_.end() &&
+      downsampling_->first_dense_time() <= t2) {
+    if (downsampling_->first_dense_time() < t1) {
+      return 0;
+    }
+    last = ++TimelineConstIterator{downsampling_->start_of_dense_timeline()};
+  }
+  std::vector<TimelineConstIterator> samples;
+  for (auto it = timeline_.lower_bound(t1); it != last; ++it) {
+    samples.push_back(it);
+  }
+  if (samples.size() < 3) {
+    return 0;
+  }
+
+  // Fit the samples in windows of bounded size.  Each window starts at the
+  // last point retained in the previous one.  |FitHermiteSpline| guarantees
+  // that the last right endpoint and the end of the window are fitted by a
+  // single polynomial.
+  std::vector<TimelineConstIterator> retained;
+  std::int64_t start = 0;
+  while (start < samples.size() - 1) {
+    std::int64_t const end = std::min<std::int64_t>(
+        start + max_compacted_intervals, samples.size() - 1);
+    std::vector<TimelineConstIterator> const window(
+        samples.begin() + start, samples.begin() + end + 1);
+    auto const right_endpoints = FitHermiteSpline<Instant, Position<Frame>>(
+        window,
+        [](auto&& it) -> auto&& { return it->first; },
+        [](auto&& it) -> auto&& { return it->second.position(); },
+        [](auto&& it) -> auto&& { return it->second.velocity(); },
+        tolerance);
+    for (auto const& it_in_window : right_endpoints) {
+      retained.push_back(*it_in_window);
+    }
+    retained.push_back(window.back());
+    start = end;
+  }
+  std::int64_t const removed = samples.size() - 1 - retained.size();
+  if (removed == 0) {
+    return 0;
+  }
+
+  // Erase the samples between the first and the last that are not retained.
+  // The timeline only moves the points of the chunks that hold the samples.
+  // The last sample, and therefore the start of the dense timeline and the
+  // forks, don't move.
+  auto next_retained = retained.cbegin();
+  timeline_.erase_if(
+      std::next(samples.front()),
+      samples.back(),
+      [&next_retained](typename Timeline::value_type const& point) {
+        if (point.first == (*next_retained)->first) {
+          ++next_retained;
+          return false;
+        }
+        return true;
+      });
+  InvalidateInterpolations();
+  return removed;
+}
+
 template<typename Frame>
 Instant DiscreteTrajectory<Frame>::t_min() const {
   return this->Empty() ? InfiniteFuture : this->Begin().time();
@@ -292,6 +500,68 @@ DegreesOfFreedom<Frame> DiscreteTrajectory<Frame>::EvaluateDegreesOfFreedom(
   return {interpolation.Evaluate(time), interpolation.EvaluateDerivative(time)};
 }
 
+template<typename Frame>
+DiscreteTrajectory<Frame>::EvaluationCursor::EvaluationCursor(
+    DiscreteTrajectory const& trajectory)
+    : trajectory_(&trajectory),
+      t_min_(trajectory.t_min()),
+      t_max_(trajectory.t_max()) {}
+
+template<typename Frame>
+Position<Frame> DiscreteTrajectory<Frame>::EvaluationCursor::EvaluatePosition(
+    Instant const& time) {
+  MoveTo(time);
+  return interpolation_->Evaluate(time);
+}
+
+template<typename Frame>
+Velocity<Frame> DiscreteTrajectory<Frame>::EvaluationCursor::EvaluateVelocity(
+    Instant const& time) {
+  MoveTo(time);
+  return interpolation_->EvaluateDerivative(time);
+}
+
+template<typename Frame>
+DegreesOfFreedom<Frame>
+DiscreteTrajectory<Frame>::EvaluationCursor::EvaluateDegreesOfFreedom(
+    Instant const& time) {
+  MoveTo(time);
+  return {interpolation_->Evaluate(time),
+          interpolation_->EvaluateDerivative(time)};
+}
+
+template<typename Frame>
+void DiscreteTrajectory<Frame>::EvaluationCursor::MoveTo(Instant const& time) {
+  CHECK_LE(t_min_, time);
+  CHECK_GE(t_max_, time);
+  if (upper_.has_value()) {
+    if (lower_time_ < time && time <= upper_->time()) {
+      return;
+    }
+    if (upper_->time() < time) {
+      for (int i = 0; i < max_forward_steps && upper_->time() < time; ++i) {
+        ++*upper_;
+      }
+    }
+  }
+  if (!upper_.has_value() ||
+      upper_->time() < time ||
+      (upper_->time() != t_min_ && time <= (--Iterator{*upper_}).time())) {
+    upper_ = trajectory_->LowerBound(time);
+  }
+
+  // This is the interpolation of |GetInterpolation|.
+  Iterator const& upper = *upper_;
+  Iterator const lower = upper.time() == t_min_ ? upper : --Iterator{upper};
+  lower_time_ = lower.time();
+  interpolation_.emplace(
+      std::pair{lower.time(), upper.time()},
+      std::pair{lower.degrees_of_freedom().position(),
+                upper.degrees_of_freedom().position()},
+      std::pair{lower.degrees_of_freedom().velocity(),
+                upper.degrees_of_freedom().velocity()});
+}
+
 template<typename Frame>
 void DiscreteTrajectory<Frame>::WriteToMessage(
     not_null<serialization::DiscreteTrajectory*> const message,
@@ -323,6 +593,66 @@ DiscreteTrajectory<Frame>::ReadFromMessage(
   return trajectory;
 }
 
+template<typename Frame>
+void DiscreteTrajectory<Frame>::PackTimelines(
+    not_null<serialization::DiscreteTrajectory*> const message) {
+  for (auto& litter : *message->mutable_children()) {
+    for (auto& child : *litter.mutable_trajectories()) {
+      PackTimelines(&child);
+    }
+  }
+  if (message->timeline().empty()) {
+    return;
+  }
+
+  std::string& packed_timeline = *message->mutable_packed_timeline();
+  PackedPoint previous{};
+  PackedPoint before_previous{};
+  std::int64_t count = 0;
+  for (auto const& instantaneous_degrees_of_freedom : message->timeline()) {
+    Instant const time =
+        Instant::ReadFromMessage(instantaneous_degrees_of_freedom.instant());
+    auto const degrees_of_freedom = DegreesOfFreedom<Frame>::ReadFromMessage(
+        instantaneous_degrees_of_freedom.degrees_of_freedom());
+    auto const q = (degrees_of_freedom.position() - Frame::origin).coordinates();
+    auto const v = degrees_of_freedom.velocity().coordinates();
+    PackedPoint const point{(time - Instant()) / Second,
+                            q.x / Metre, q.y / Metre, q.z / Metre,
+                            v.x / (Metre / Second),
+                            v.y / (Metre / Second),
+                            v.z / (Metre / Second)};
+
+    // The time is predicted first, so that the prediction of the degrees of
+    // freedom uses the actual time, which is known to the reader.
+    PackedPoint predicted;
+    predicted[0] = PredictTime(count, previous, before_previous);
+    std::array<std::uint64_t, packed_point_size> residuals;
+    residuals[0] = DoubleToBits(point[0]) ^ DoubleToBits(predicted[0]);
+    predicted[0] = point[0];
+    PredictDegreesOfFreedom(count, previous, before_previous, predicted);
+    for (int i = 1; i < packed_point_size; ++i) {
+      residuals[i] = DoubleToBits(point[i]) ^ DoubleToBits(predicted[i]);
+    }
+
+    std::uint8_t header[packed_point_header_size] = {};
+    for (int i = 0; i < packed_point_size; ++i) {
+      header[i / 2] |= SignificantBytes(residuals[i]) << (4 * (i % 2));
+    }
+    packed_timeline.append(reinterpret_cast<char const*>(header),
+                           packed_point_header_size);
+    for (auto residual : residuals) {
+      for (; residual != 0; residual >>= 8) {
+        packed_timeline.push_back(static_cast<char>(residual & 0xFF));
+      }
+    }
+
+    before_previous = previous;
+    previous = point;
+    ++count;
+  }
+  message->clear_timeline();
+}
+
 template<typename Frame>
 not_null<DiscreteTrajectory<Frame>*> DiscreteTrajectory<Frame>::that() {
   return this;
@@ -427,6 +757,13 @@ bool DiscreteTrajectory<Frame>::Downsampling::reached_max_dense_intervals()
   return dense_intervals_ >= max_dense_intervals_;
 }
 
+template<typename Frame>
+bool DiscreteTrajectory<Frame>::Downsampling::reached_fitting_point() const {
+  return dense_intervals_ >= 2 &&
+         ((dense_intervals_ & (dense_intervals_ - 1)) == 0 ||
+          reached_max_dense_intervals());
+}
+
 template<typename Frame>
 Length DiscreteTrajectory<Frame>::Downsampling::tolerance() const {
   return tolerance_;
@@ -494,6 +831,10 @@ void DiscreteTrajectory<Frame>::FillSubTreeFromMessage(
            DegreesOfFreedom<Frame>::ReadFromMessage(
                timeline_it->degrees_of_freedom()));
   }
+  if (message.has_packed_timeline()) {
+    CHECK_EQ(0, message.timeline_size());
+    AppendPackedTimeline(message.packed_timeline());
+  }
   if (message.has_downsampling()) {
     CHECK(this->is_root());
     downsampling_.emplace(
@@ -503,21 +844,143 @@ void DiscreteTrajectory<Frame>::FillSubTreeFromMessage(
                                                                  forks);
 }
 
+template<typename Frame>
+double DiscreteTrajectory<Frame>::PredictTime(
+    std::int64_t const count,
+    PackedPoint const& previous,
+    PackedPoint const& before_previous) {
+  // The times are typically at regular intervals.
+  if (count == 0) {
+    return 0;
+  } else if (count == 1) {
+    return previous[0];
+  } else {
+    return 2 * previous[0] - before_previous[0];
+  }
+}
+
+template<typename Frame>
+void DiscreteTrajectory<Frame>::PredictDegreesOfFreedom(
+    std::int64_t const count,
+    PackedPoint const& previous,
+    PackedPoint const& before_previous,
+    PackedPoint& point) {
+  // The reader must compute exactly the same predictions as the writer, so
+  // this function must only depend on the packed values.
+  if (count == 0) {
+    for (int i = 1; i < packed_point_size; ++i) {
+      point[i] = 0;
+    }
+    return;
+  }
+  double const Δt = point[0] - previous[0];
+  for (int i = 1; i <= 3; ++i) {
+    double const previous_q = previous[i];
+    double const previous_v = previous[i + 3];
+    if (count == 1) {
+      point[i] = previous_q + previous_v * Δt;
+      point[i + 3] = previous_v;
+    } else {
+      // A quadratic extrapolation of the position, with the acceleration
+      // estimated from the last two velocities.
+      double const a = (previous_v - before_previous[i + 3]) /
+                       (previous[0] - before_previous[0]);
+      point[i] = previous_q + (previous_v + 0.5 * a * Δt) * Δt;
+      point[i + 3] = previous_v + a * Δt;
+    }
+  }
+}
+
+template<typename Frame>
+void DiscreteTrajectory<Frame>::AppendPackedTimeline(
+    std::string const& packed_timeline) {
+  PackedPoint previous{};
+  PackedPoint before_previous{};
+  std::int64_t count = 0;
+  std::size_t offset = 0;
+  while (offset < packed_timeline.size()) {
+    CHECK_LE(offset + packed_point_header_size, packed_timeline.size());
+    auto const* const header = reinterpret_cast<std::uint8_t const*>(
+        &packed_timeline[offset]);
+    offset += packed_point_header_size;
+    std::array<std::uint64_t, packed_point_size> residuals;
+    for (int i = 0; i < packed_point_size; ++i) {
+      int const significant_bytes = (header[i / 2] >> (4 * (i % 2))) & 0xF;
+      CHECK_LE(significant_bytes, 8);
+      CHECK_LE(offset + significant_bytes, packed_timeline.size());
+      residuals[i] = 0;
+      for (int j = 0; j < significant_bytes; ++j) {
+        residuals[i] |= static_cast<std::uint64_t>(
+                            static_cast<std::uint8_t>(packed_timeline[offset++]))
+                        << (8 * j);
+      }
+    }
+
+    PackedPoint point;
+    point[0] = BitsToDouble(
+        DoubleToBits(PredictTime(count, previous, before_previous)) ^
+        residuals[0]);
+    PredictDegreesOfFreedom(count, previous, before_previous, point);
+    for (int i = 1; i < packed_point_size; ++i) {
+      point[i] = BitsToDouble(DoubleToBits(point[i]) ^ residuals[i]);
+    }
+
+    Append(Instant() + point[0] * Second,
+           DegreesOfFreedom<Frame>(
+               Frame::origin + Displacement<Frame>({point[1] * Metre,
+                                                    point[2] * Metre,
+                                                    point[3] * Metre}),
+               Velocity<Frame>({point[4] * (Metre / Second),
+                                point[5] * (Metre / Second),
+                                point[6] * (Metre / Second)})));
+
+    before_previous = previous;
+    previous = point;
+    ++count;
+  }
+}
+
 template<typename Frame>
 Hermite3<Instant, Position<Frame>> DiscreteTrajectory<Frame>::GetInterpolation(
     Instant const& time) const {
   CHECK_LE(t_min(), time);
   CHECK_GE(t_max(), time);
+  struct CachedInterpolation {
+    DiscreteTrajectory const* trajectory;
+    std::uint64_t epoch;
+    Instant lower_time;
+    Instant upper_time;
+    Hermite3<Instant, Position<Frame>> interpolation;
+  };
+  thread_local std::optional<CachedInterpolation> cache;
+
+  std::uint64_t const epoch =
+      interpolation_epoch_.load(std::memory_order_acquire);
+  if (cache.has_value() &&
+      cache->trajectory == this &&
+      cache->epoch == epoch &&
+      cache->lower_time < time && time <= cache->upper_time) {
+    return cache->interpolation;
+  }
+
   // This is the upper bound of the interval upon which we will do the
   // interpolation.
   auto const upper = this->LowerBound(time);
   auto const lower = upper == this->Begin() ? upper : --Iterator{upper};
-  return Hermite3<Instant, Position<Frame>>{
+  Hermite3<Instant, Position<Frame>> const interpolation{
       {lower.time(), upper.time()},
       {lower.degrees_of_freedom().position(),
        upper.degrees_of_freedom().position()},
       {lower.degrees_of_freedom().velocity(),
        upper.degrees_of_freedom().velocity()}};
+  cache.emplace(CachedInterpolation{
+      this, epoch, lower.time(), upper.time(), interpolation});
+  return interpolation;
+}
+
+template<typename Frame>
+void DiscreteTrajectory<Frame>::InvalidateInterpolations() {
+  interpolation_epoch_.fetch_add(1, std::memory_order_acq_rel);
 }
 
 }  // namespace internal_discrete_trajectory
@@ -57,8 +57,11 @@ using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Gt;
 using ::testing::Lt;
+using ::testing::Ne;
+using ::testing::NotNull;
 using ::testing::Pair;
 using ::testing::Ref;
+using ::testing::SizeIs;
 
 class DiscreteTrajectoryTest : public testing::Test {
  protected:
@@ -352,6 +355,33 @@ TEST_F(DiscreteTrajectoryTest, NewForkWithCopyAtLast) {
   EXPECT_THAT(after, ElementsAre(t2_, t3_, t4_));
 }
 
+TEST_F(DiscreteTrajectoryTest, NewRootWithCopy) {
+  massive_trajectory_->Append(t1_, d1_);
+  massive_trajectory_->Append(t2_, d2_);
+  not_null<DiscreteTrajectory<World>*> const fork =
+      massive_trajectory_->NewForkWithoutCopy(t2_);
+  fork->Append(t3_, d3_);
+  fork->Append(t4_, d4_);
+
+  auto const from_fork = fork->NewRootWithCopy(t2_);
+  EXPECT_TRUE(from_fork->is_root());
+  EXPECT_THAT(Positions(*from_fork),
+              ElementsAre(Pair(t2_, q2_), Pair(t3_, q3_), Pair(t4_, q4_)));
+  EXPECT_THAT(Velocities(*from_fork),
+              ElementsAre(Pair(t2_, p2_), Pair(t3_, p3_), Pair(t4_, p4_)));
+
+  auto const from_t3 = fork->NewRootWithCopy(t3_);
+  EXPECT_THAT(Times(*from_t3), ElementsAre(t3_, t4_));
+
+  // The copies are not affected by changes to the original trajectory, even
+  // though they share its points.
+  fork->ForgetAfter(t3_);
+  fork->Append(t4_ + 1 * Second, d4_);
+  EXPECT_THAT(Times(*from_fork), ElementsAre(t2_, t3_, t4_));
+  EXPECT_THAT(Times(*from_t3), ElementsAre(t3_, t4_));
+  EXPECT_THAT(Times(*fork), ElementsAre(t1_, t2_, t3_, t4_ + 1 * Second));
+}
+
 TEST_F(DiscreteTrajectoryTest, NewForkAtLast) {
   massive_trajectory_->Append(t1_, d1_);
   massive_trajectory_->Append(t2_, d2_);
@@ -771,6 +801,48 @@ TEST_F(DiscreteTrajectoryTest, TrajectorySerializationSuccess) {
       Eq(d4_));
 }
 
+TEST_F(DiscreteTrajectoryTest, PackedSerialization) {
+  AngularFrequency const ω = 3 * Radian / Second;
+  Length const r = 2 * Metre;
+  Speed const v = ω * r / Radian;
+  for (Instant t = t0_; t <= t0_ + 5 * Second; t += 10 * Milli(Second)) {
+    massive_trajectory_->Append(
+        t,
+        {World::origin + Displacement<World>{{r * Cos(ω * (t - t0_)),
+                                              r * Sin(ω * (t - t0_)),
+                                              0 * Metre}},
+         Velocity<World>{{-v * Sin(ω * (t - t0_)),
+                          v * Cos(ω * (t - t0_)),
+                          0 * Metre / Second}}});
+  }
+  not_null<DiscreteTrajectory<World>*> const fork =
+      massive_trajectory_->NewForkAtLast();
+  fork->Append(t0_ + 10 * Second, d1_);
+  fork->Append(t0_ + 11 * Second, d2_);
+
+  serialization::DiscreteTrajectory reference_message;
+  massive_trajectory_->WriteToMessage(&reference_message, {fork});
+  serialization::DiscreteTrajectory packed_message = reference_message;
+  DiscreteTrajectory<World>::PackTimelines(&packed_message);
+  EXPECT_THAT(packed_message.timeline_size(), Eq(0));
+  EXPECT_TRUE(packed_message.has_packed_timeline());
+  EXPECT_THAT(packed_message.children(0).trajectories(0).timeline_size(),
+              Eq(0));
+  EXPECT_LT(packed_message.ByteSizeLong(),
+            reference_message.ByteSizeLong() / 2);
+
+  // The packing is lossless.
+  DiscreteTrajectory<World>* deserialized_fork = nullptr;
+  not_null<std::unique_ptr<DiscreteTrajectory<World>>> const
+      deserialized_trajectory =
+          DiscreteTrajectory<World>::ReadFromMessage(packed_message,
+                                                     {&deserialized_fork});
+  ASSERT_THAT(deserialized_fork, NotNull());
+  serialization::DiscreteTrajectory message;
+  deserialized_trajectory->WriteToMessage(&message, {deserialized_fork});
+  EXPECT_THAT(message, EqualsProto(reference_message));
+}
+
 TEST_F(DiscreteTrajectoryDeathTest, LastError) {
   EXPECT_DEATH({
     massive_trajectory_->last();
@@ -868,11 +940,94 @@ TEST_F(DiscreteTrajectoryTest, QuadrilateralCircle) {
   EXPECT_THAT(max_v_error, IsNear(0.012));
 }
 
+TEST_F(DiscreteTrajectoryTest, SubTreeSize) {
+  massive_trajectory_->Append(t1_, d1_);
+  massive_trajectory_->Append(t2_, d2_);
+  not_null<DiscreteTrajectory<World>*> const fork =
+      massive_trajectory_->NewForkWithoutCopy(t1_);
+  fork->Append(t3_, d3_);
+  fork->Append(t4_, d4_);
+  massive_trajectory_->NewForkWithoutCopy(t2_)->Append(t3_, d3_);
+  EXPECT_EQ(5, massive_trajectory_->subtree_size());
+  EXPECT_EQ(2, fork->subtree_size());
+  EXPECT_LT(fork->subtree_memory_footprint(),
+            massive_trajectory_->subtree_memory_footprint());
+}
+
+TEST_F(DiscreteTrajectoryTest, CachedInterpolation) {
+  Instant const t = t1_ + 3 * Second;
+  Position<World> expected_before;
+  Position<World> expected_after;
+  {
+    DiscreteTrajectory<World> trajectory;
+    trajectory.Append(t1_, d1_);
+    trajectory.Append(t3_, d3_);
+    expected_before = trajectory.EvaluatePosition(t);
+  }
+  {
+    DiscreteTrajectory<World> trajectory;
+    trajectory.Append(t1_, d1_);
+    trajectory.Append(t2_, d2_);
+    expected_after = trajectory.EvaluatePosition(t);
+  }
+  EXPECT_THAT(expected_after, Ne(expected_before));
+
+  DiscreteTrajectory<World> trajectory;
+  trajectory.Append(t1_, d1_);
+  trajectory.Append(t3_, d3_);
+  EXPECT_THAT(trajectory.EvaluatePosition(t), Eq(expected_before));
+  EXPECT_THAT(trajectory.EvaluatePosition(t), Eq(expected_before));
+
+  // Removing points invalidates the cached interpolation.
+  trajectory.ForgetAfter(t1_);
+  trajectory.Append(t2_, d2_);
+  trajectory.Append(t3_, d3_);
+  EXPECT_THAT(trajectory.EvaluatePosition(t), Eq(expected_after));
+}
+
+TEST_F(DiscreteTrajectoryTest, EvaluationCursor) {
+  DiscreteTrajectory<World> trajectory;
+  for (int i = 0; i <= 100; ++i) {
+    trajectory.Append(t0_ + i * Second,
+                      DegreesOfFreedom<World>(
+                          World::origin +
+                              Displacement<World>({i * i * Metre,
+                                                   i * Metre,
+                                                   0 * Metre}),
+                          Velocity<World>({2 * i * Metre / Second,
+                                           1 * Metre / Second,
+                                           0 * Metre / Second})));
+  }
+  not_null<DiscreteTrajectory<World>*> const fork =
+      trajectory.NewForkWithCopy(t0_ + 50 * Second);
+
+  DiscreteTrajectory<World>::EvaluationCursor cursor(*fork);
+  // Forward with small and large jumps, then backward.
+  std::vector<Instant> times;
+  for (int i = 0; i <= 80; ++i) {
+    times.push_back(t0_ + i * 0.25 * Second);
+  }
+  times.push_back(t0_ + 99.5 * Second);
+  times.push_back(t0_ + 100 * Second);
+  times.push_back(t0_ + 3.5 * Second);
+  times.push_back(t0_);
+  times.push_back(t0_ + 0.5 * Second);
+  for (Instant const& time : times) {
+    EXPECT_THAT(cursor.EvaluateDegreesOfFreedom(time),
+                Eq(fork->EvaluateDegreesOfFreedom(time))) << time;
+    EXPECT_THAT(cursor.EvaluatePosition(time),
+                Eq(fork->EvaluatePosition(time))) << time;
+    EXPECT_THAT(cursor.EvaluateVelocity(time),
+                Eq(fork->EvaluateVelocity(time))) << time;
+  }
+}
+
 TEST_F(DiscreteTrajectoryTest, Downsampling) {
   DiscreteTrajectory<World> circle;
   DiscreteTrajectory<World> downsampled_circle;
   downsampled_circle.SetDownsampling(/*max_dense_intervals=*/50,
                                      /*tolerance=*/1 * Milli(Metre));
+  std::vector<Instant> downsampled_times;
   AngularFrequency const ω = 3 * Radian / Second;
   Length const r = 2 * Metre;
   Speed const v = ω * r / Radian;
@@ -888,9 +1043,24 @@ TEST_F(DiscreteTrajectoryTest, Downsampling) {
                           0 * Metre / Second}}};
     circle.Append(t.value, dof);
     downsampled_circle.Append(t.value, dof);
+    if (downsampled_times.empty() && t.value >= t0_ + 5 * Second) {
+      for (auto it = downsampled_circle.Begin();
+           it != downsampled_circle.End() &&
+           it.time() <= downsampled_circle.last_downsampled_time();
+           ++it) {
+        downsampled_times.push_back(it.time());
+      }
+    }
   }
   EXPECT_THAT(circle.Size(), Eq(1001));
-  EXPECT_THAT(downsampled_circle.Size(), Eq(77));
+  EXPECT_THAT(downsampled_circle.Size(), Eq(56));
+  EXPECT_EQ(circle.t_max(), circle.last_downsampled_time());
+  EXPECT_THAT(downsampled_times, SizeIs(Gt(1)));
+  // The points that had been downsampled were not removed afterwards.
+  for (Instant const& time : downsampled_times) {
+    EXPECT_TRUE(downsampled_circle.Find(time) != downsampled_circle.End())
+        << time;
+  }
   std::vector<Length> errors;
   for (auto it = circle.Begin(); it != circle.End(); ++it) {
     errors.push_back((downsampled_circle.EvaluatePosition(it.time()) -
@@ -901,6 +1071,52 @@ TEST_F(DiscreteTrajectoryTest, Downsampling) {
       << *std::max_element(errors.begin(), errors.end());
 }
 
+TEST_F(DiscreteTrajectoryTest, Compact) {
+  DiscreteTrajectory<World> circle;
+  DiscreteTrajectory<World> compacted_circle;
+  AngularFrequency const ω = 3 * Radian / Second;
+  Length const r = 2 * Metre;
+  Speed const v = ω * r / Radian;
+  for (auto t = DoublePrecision<Instant>(t0_);
+       t.value <= t0_ + 10 * Second;
+       t.Increment(10 * Milli(Second))) {
+    DegreesOfFreedom<World> const dof =
+        {World::origin + Displacement<World>{{r * Cos(ω * (t.value - t0_)),
+                                              r * Sin(ω * (t.value - t0_)),
+                                              0 * Metre}},
+         Velocity<World>{{-v * Sin(ω * (t.value - t0_)),
+                          v * Cos(ω * (t.value - t0_)),
+                          0 * Metre / Second}}};
+    circle.Append(t.value, dof);
+    compacted_circle.Append(t.value, dof);
+  }
+  Instant const t1 = t0_ + 2 * Second;
+  Instant const t2 = t0_ + 5 * Second;
+  std::int64_t const removed =
+      compacted_circle.Compact(t1, t2, /*tolerance=*/1 * Milli(Metre));
+  EXPECT_THAT(removed, Gt(250));
+  EXPECT_THAT(compacted_circle.Size(), Eq(circle.Size() - removed));
+
+  // The points outside of ]t1, t2[ are unchanged.
+  for (auto it1 = circle.Begin(), it2 = compacted_circle.Begin();
+       it1.time() <= t1;
+       ++it1, ++it2) {
+    EXPECT_EQ(it1.time(), it2.time());
+  }
+  for (auto it1 = circle.LowerBound(t2), it2 = compacted_circle.LowerBound(t2);
+       it1 != circle.End();
+       ++it1, ++it2) {
+    EXPECT_EQ(it1.time(), it2.time());
+  }
+
+  std::vector<Length> errors;
+  for (auto it = circle.Begin(); it != circle.End(); ++it) {
+    errors.push_back((compacted_circle.EvaluatePosition(it.time()) -
+                      it.degrees_of_freedom().position()).Norm());
+  }
+  EXPECT_THAT(errors, Each(Lt(1 * Milli(Metre))));
+}
+
 TEST_F(DiscreteTrajectoryTest, DownsamplingSerialization) {
   DiscreteTrajectory<World> circle;
   auto deserialized_circle = make_not_null_unique<DiscreteTrajectory<World>>();
@@ -938,7 +1154,7 @@ TEST_F(DiscreteTrajectoryTest, DownsamplingSerialization) {
     circle.Append(t.value, dof);
     deserialized_circle->Append(t.value, dof);
   }
-  EXPECT_THAT(circle.Size(), Eq(77));
+  EXPECT_THAT(circle.Size(), Eq(56));
   EXPECT_THAT(deserialized_circle->Size(), Eq(circle.Size()));
   for (auto it1 = circle.Begin(), it2 = deserialized_circle->Begin();
        it1 != circle.End();
@@ -983,7 +1199,7 @@ TEST_F(DiscreteTrajectoryTest, DownsamplingForgetAfter) {
                           0 * Metre / Second}}};
     forgotten_circle.Append(t, dof);
   }
-  EXPECT_THAT(circle.Size(), Eq(77));
+  EXPECT_THAT(circle.Size(), Eq(56));
   EXPECT_THAT(forgotten_circle.Size(), Eq(circle.Size()));
   std::vector<Length> errors;
   for (auto it = forgotten_circle.Begin(); it != forgotten_circle.End(); ++it) {
@@ -2,6 +2,12 @@
 #ifndef PRINCIPIA_PHYSICS_DYNAMIC_FRAME_HPP_
 #define PRINCIPIA_PHYSICS_DYNAMIC_FRAME_HPP_
 
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/macros.hpp"
 #include "geometry/frame.hpp"
 #include "geometry/rotation.hpp"
 #include "physics/ephemeris.hpp"
@@ -11,6 +17,11 @@
 
 namespace principia {
 namespace physics {
+
+FORWARD_DECLARE_FROM(shared_dynamic_frame,
+                     TEMPLATE(typename InertialFrame, typename ThisFrame) class,
+                     SharedDynamicFrame);
+
 namespace internal_dynamic_frame {
 
 using base::not_null;
@@ -49,6 +60,12 @@ class DynamicFrame {
   virtual RigidMotion<ThisFrame, InertialFrame> FromThisFrameAtTime(
       Instant const& t) const;
 
+  // Returns the result of |ToThisFrameAtTime| for each of the |times|, in the
+  // same order.  The default implementation calls |ToThisFrameAtTime| for each
+  // time; derived classes may evaluate their trajectories in a single pass.
+  virtual std::vector<RigidMotion<InertialFrame, ThisFrame>>
+  ToThisFrameAtTimes(std::vector<Instant> const& times) const;
+
   // The acceleration due to the non-inertial motion of |ThisFrame| and gravity.
   // A particle in free fall follows a trajectory whose second derivative
   // is |GeometricAcceleration|.
@@ -56,6 +73,16 @@ class DynamicFrame {
       Instant const& t,
       DegreesOfFreedom<ThisFrame> const& degrees_of_freedom) const;
 
+  // Returns the result of |GeometricAcceleration| for each of the
+  // |degrees_of_freedom| at the same time |t|, in the same order.  The motion
+  // of this frame is only computed once, so this is preferable when
+  // integrating many points in this frame, or the stages of an integrator
+  // that evaluate several points at the same time.
+  std::vector<Vector<Acceleration, ThisFrame>> GeometricAccelerations(
+      Instant const& t,
+      std::vector<DegreesOfFreedom<ThisFrame>> const& degrees_of_freedom)
+      const;
+
   // The definition of the Frenet frame of a free fall trajectory in |ThisFrame|
   // with the given |degrees_of_freedom| at instant |t|.
   virtual Rotation<Frenet<ThisFrame>, ThisFrame> FrenetFrame(
@@ -71,12 +98,58 @@ class DynamicFrame {
       ReadFromMessage(serialization::DynamicFrame const& message,
                       not_null<Ephemeris<InertialFrame> const*> ephemeris);
 
+ protected:
+  // A memo of the most recent results of |ToThisFrameAtTime|, keyed by time.
+  // It holds at most |capacity| entries and evicts the oldest one first.  It is
+  // meant for the derived classes whose |ToThisFrameAtTime| is expensive, and
+  // which must not cache motions that may change for a given time.
+  // Thread-safe.
+  class RigidMotionCache final {
+   public:
+    static constexpr int capacity = 16;
+
+    // Returns the motion inserted for |t|, if it is still in the cache.
+    std::optional<RigidMotion<InertialFrame, ThisFrame>> Find(
+        Instant const& t) const;
+
+    void Insert(Instant const& t,
+                RigidMotion<InertialFrame, ThisFrame> const& rigid_motion);
+
+   private:
+    mutable std::mutex lock_;
+    std::vector<std::pair<Instant, RigidMotion<InertialFrame, ThisFrame>>>
+        entries_ GUARDED_BY(lock_);
+    // The index of the entry to overwrite once the cache is full.
+    int oldest_ GUARDED_BY(lock_) = 0;
+  };
+
  private:
+  // The terms of |GeometricAcceleration| that only depend on the motion of
+  // this frame at some time.
+  struct FrameMotionTerms final {
+    RigidMotion<InertialFrame, ThisFrame> to_this_frame;
+    RigidMotion<ThisFrame, InertialFrame> from_this_frame;
+    geometry::AngularVelocity<ThisFrame> Ω;
+    quantities::Variation<geometry::AngularVelocity<ThisFrame>> dΩ_over_dt;
+    Vector<Acceleration, ThisFrame> linear_acceleration;
+  };
+
+  FrameMotionTerms ComputeFrameMotionTerms(Instant const& t) const;
+
+  Vector<Acceleration, ThisFrame> ComputeGeometricAcceleration(
+      Instant const& t,
+      FrameMotionTerms const& terms,
+      DegreesOfFreedom<ThisFrame> const& degrees_of_freedom) const;
+
   virtual Vector<Acceleration, InertialFrame> GravitationalAcceleration(
       Instant const& t,
       Position<InertialFrame> const& q) const = 0;
   virtual AcceleratedRigidMotion<InertialFrame, ThisFrame> MotionOfThisFrame(
       Instant const& t) const = 0;
+
+  // For forwarding the private functions above.
+  template<typename I, typename T>
+  friend class internal_shared_dynamic_frame::SharedDynamicFrame;
 };
 
 }  // namespace internal_dynamic_frame
@@ -40,43 +40,90 @@ DynamicFrame<InertialFrame, ThisFrame>::FromThisFrameAtTime(
   return ToThisFrameAtTime(t).Inverse();
 }
 
+template<typename InertialFrame, typename ThisFrame>
+std::vector<RigidMotion<InertialFrame, ThisFrame>>
+DynamicFrame<InertialFrame, ThisFrame>::ToThisFrameAtTimes(
+    std::vector<Instant> const& times) const {
+  std::vector<RigidMotion<InertialFrame, ThisFrame>> result;
+  result.reserve(times.size());
+  for (Instant const& t : times) {
+    result.push_back(ToThisFrameAtTime(t));
+  }
+  return result;
+}
+
 template<typename InertialFrame, typename ThisFrame>
 Vector<Acceleration, ThisFrame>
 DynamicFrame<InertialFrame, ThisFrame>::GeometricAcceleration(
     Instant const& t,
     DegreesOfFreedom<ThisFrame> const& degrees_of_freedom) const {
+  return ComputeGeometricAcceleration(
+      t, ComputeFrameMotionTerms(t), degrees_of_freedom);
+}
+
+template<typename InertialFrame, typename ThisFrame>
+std::vector<Vector<Acceleration, ThisFrame>>
+DynamicFrame<InertialFrame, ThisFrame>::GeometricAccelerations(
+    Instant const& t,
+    std::vector<DegreesOfFreedom<ThisFrame>> const& degrees_of_freedom) const {
+  std::vector<Vector<Acceleration, ThisFrame>> result;
+  if (degrees_of_freedom.empty()) {
+    return result;
+  }
+  FrameMotionTerms const terms = ComputeFrameMotionTerms(t);
+  result.reserve(degrees_of_freedom.size());
+  for (auto const& dof : degrees_of_freedom) {
+    result.push_back(ComputeGeometricAcceleration(t, terms, dof));
+  }
+  return result;
+}
+
+template<typename InertialFrame, typename ThisFrame>
+typename DynamicFrame<InertialFrame, ThisFrame>::FrameMotionTerms
+DynamicFrame<InertialFrame, ThisFrame>::ComputeFrameMotionTerms(
+    Instant const& t) const {
   AcceleratedRigidMotion<InertialFrame, ThisFrame> const motion =
       MotionOfThisFrame(t);
   RigidMotion<InertialFrame, ThisFrame> const& to_this_frame =
       motion.rigid_motion();
-  RigidMotion<ThisFrame, InertialFrame> const from_this_frame =
-      to_this_frame.Inverse();
 
   // Beware, we want the angular velocity of ThisFrame as seen in the
   // InertialFrame, but pushed to ThisFrame.  Otherwise the sign is wrong.
-  AngularVelocity<ThisFrame> const Ω = to_this_frame.orthogonal_map()(
-      to_this_frame.angular_velocity_of_to_frame());
-  Variation<AngularVelocity<ThisFrame>> const dΩ_over_dt =
-      to_this_frame.orthogonal_map()(motion.angular_acceleration_of_to_frame());
+  return FrameMotionTerms{
+      /*to_this_frame=*/to_this_frame,
+      /*from_this_frame=*/to_this_frame.Inverse(),
+      /*Ω=*/to_this_frame.orthogonal_map()(
+          to_this_frame.angular_velocity_of_to_frame()),
+      /*dΩ_over_dt=*/to_this_frame.orthogonal_map()(
+          motion.angular_acceleration_of_to_frame()),
+      /*linear_acceleration=*/-to_this_frame.orthogonal_map()(
+          motion.acceleration_of_to_frame_origin())};
+}
+
+template<typename InertialFrame, typename ThisFrame>
+Vector<Acceleration, ThisFrame>
+DynamicFrame<InertialFrame, ThisFrame>::ComputeGeometricAcceleration(
+    Instant const& t,
+    FrameMotionTerms const& terms,
+    DegreesOfFreedom<ThisFrame> const& degrees_of_freedom) const {
+  AngularVelocity<ThisFrame> const& Ω = terms.Ω;
   Displacement<ThisFrame> const r =
       degrees_of_freedom.position() - ThisFrame::origin;
 
   Vector<Acceleration, ThisFrame> const gravitational_acceleration_at_point =
-      to_this_frame.orthogonal_map()(
-          GravitationalAcceleration(t,
-                                    from_this_frame.rigid_transformation()(
-                                        degrees_of_freedom.position())));
-  Vector<Acceleration, ThisFrame> const linear_acceleration =
-      -to_this_frame.orthogonal_map()(motion.acceleration_of_to_frame_origin());
+      terms.to_this_frame.orthogonal_map()(GravitationalAcceleration(
+          t,
+          terms.from_this_frame.rigid_transformation()(
+              degrees_of_freedom.position())));
   Vector<Acceleration, ThisFrame> const coriolis_acceleration_at_point =
       -2 * Ω * degrees_of_freedom.velocity() / Radian;
   Vector<Acceleration, ThisFrame> const centrifugal_acceleration_at_point =
       -Ω * (Ω * r) / Pow<2>(Radian);
   Vector<Acceleration, ThisFrame> const euler_acceleration_at_point =
-      -dΩ_over_dt * r / Radian;
+      -terms.dΩ_over_dt * r / Radian;
 
   Vector<Acceleration, ThisFrame> const fictitious_acceleration =
-      linear_acceleration +
+      terms.linear_acceleration +
       coriolis_acceleration_at_point +
       centrifugal_acceleration_at_point +
       euler_acceleration_at_point;
@@ -156,6 +203,32 @@ DynamicFrame<InertialFrame, ThisFrame>::ReadFromMessage(
   return std::move(result);
 }
 
+template<typename InertialFrame, typename ThisFrame>
+std::optional<RigidMotion<InertialFrame, ThisFrame>>
+DynamicFrame<InertialFrame, ThisFrame>::RigidMotionCache::Find(
+    Instant const& t) const {
+  std::lock_guard<std::mutex> l(lock_);
+  for (auto const& [time, rigid_motion] : entries_) {
+    if (time == t) {
+      return rigid_motion;
+    }
+  }
+  return std::nullopt;
+}
+
+template<typename InertialFrame, typename ThisFrame>
+void DynamicFrame<InertialFrame, ThisFrame>::RigidMotionCache::Insert(
+    Instant const& t,
+    RigidMotion<InertialFrame, ThisFrame> const& rigid_motion) {
+  std::lock_guard<std::mutex> l(lock_);
+  if (entries_.size() < capacity) {
+    entries_.emplace_back(t, rigid_motion);
+  } else {
+    entries_[oldest_] = {t, rigid_motion};
+    oldest_ = (oldest_ + 1) % capacity;
+  }
+}
+
 }  // namespace internal_dynamic_frame
 }  // namespace physics
 }  // namespace principia
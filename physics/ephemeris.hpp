@@ -1,20 +1,33 @@
 ﻿
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 
+#include "base/array.hpp"
 #include "base/not_null.hpp"
+#include "base/sharded_shared_mutex.hpp"
 #include "base/shared_lock_guard.hpp"
 #include "base/status.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
+#include "geometry/quantity_array.hpp"
 #include "google/protobuf/repeated_field.h"
 #include "integrators/integrators.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
+#include "physics/barnes_hut_tree.hpp"
 #include "physics/continuous_trajectory.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/massive_body.hpp"
@@ -26,17 +39,23 @@ namespace principia {
 namespace physics {
 namespace internal_ephemeris {
 
+using base::Array;
 using base::not_null;
+using base::ShardedSharedMutex;
 using base::Status;
+using base::WorkStealingScheduler;
 using geometry::Instant;
 using geometry::Position;
+using geometry::QuantityArray;
 using geometry::Vector;
 using integrators::AdaptiveStepSizeIntegrator;
+using integrators::AdaptiveStepStatistics;
 using integrators::FixedStepSizeIntegrator;
 using integrators::Integrator;
 using integrators::IntegrationProblem;
 using integrators::SpecialSecondOrderDifferentialEquation;
 using quantities::Acceleration;
+using quantities::GravitationalParameter;
 using quantities::Length;
 using quantities::Speed;
 using quantities::Time;
@@ -57,10 +76,14 @@ class Ephemeris {
   static IntrinsicAccelerations const NoIntrinsicAccelerations;
   static std::int64_t constexpr unlimited_max_ephemeris_steps =
       std::numeric_limits<std::int64_t>::max();
+  static std::int64_t constexpr steps_between_deadline_checks = 10;
+  static double constexpr default_encke_rectification_threshold = 1e-2;
 
   // The equation describing the motion of the |bodies_|.
   using NewtonianMotionEquation =
       SpecialSecondOrderDifferentialEquation<Position<Frame>>;
+  using StepSizeController = typename AdaptiveStepSizeIntegrator<
+      NewtonianMotionEquation>::StepSizeController;
 
   class PHYSICS_DLL AdaptiveStepParameters final {
    public:
@@ -85,6 +108,37 @@ class Ephemeris {
     void set_speed_integration_tolerance(
         Speed const& speed_integration_tolerance);
 
+    // If set, the flows of a single trajectory use Encke's method: they
+    // integrate the deviation of the massless body from an osculating Kepler
+    // orbit about the body that dominates its motion, and rectify that orbit
+    // when the deviation exceeds |encke_rectification_threshold| times the
+    // distance to that body.  The tolerances apply to the deviation, and
+    // therefore to the trajectory.  The step size is limited by the
+    // perturbations rather than by the orbital period.
+    std::optional<double> const& encke_rectification_threshold() const;
+    void set_encke_rectification_threshold(
+        std::optional<double> const& encke_rectification_threshold);
+
+    // If true, the flows of a single trajectory switch to Encke's method while
+    // the motion is nearly Keplerian about some body, e.g., during a close
+    // approach, and integrate the absolute motion otherwise.  The singularity
+    // of the central acceleration is then handled by the Kepler orbit, and the
+    // steps are not shortened near the periapsis.  The threshold, if not set,
+    // defaults to |default_encke_rectification_threshold|.
+    bool regularize_close_approaches() const;
+    void set_regularize_close_approaches(bool regularize_close_approaches);
+
+    // The rule used by the integrator to choose the step sizes.  Defaults to
+    // |Elementary|.
+    StepSizeController step_size_controller() const;
+    void set_step_size_controller(StepSizeController step_size_controller);
+
+    // If not null, the work done by the integrators in the flows that use these
+    // parameters is added to |*statistics|, which must outlive the flows.  Not
+    // serialized.
+    AdaptiveStepStatistics* statistics() const;
+    void set_statistics(AdaptiveStepStatistics* statistics);
+
     void WriteToMessage(
         not_null<serialization::Ephemeris::AdaptiveStepParameters*> const
             message) const;
@@ -98,16 +152,42 @@ class Ephemeris {
     std::int64_t max_steps_;
     Length length_integration_tolerance_;
     Speed speed_integration_tolerance_;
+    std::optional<double> encke_rectification_threshold_;
+    bool regularize_close_approaches_ = false;
+    StepSizeController step_size_controller_ = StepSizeController::Elementary;
+    AdaptiveStepStatistics* statistics_ = nullptr;
     friend class Ephemeris<Frame>;
   };
 
   class PHYSICS_DLL FixedStepParameters final {
    public:
+    // All the bodies are integrated together with the given |step|.  If
+    // |max_fitting_step_multiple| is greater than 1, the trajectories of the
+    // bodies that move slowly are fitted with a step that is a multiple of
+    // |step|, by only retaining some of the integrated states.  The multiple
+    // for a body is the largest power of 2 at most
+    // |max_fitting_step_multiple| such that the body is sampled at least as
+    // finely, relative to its dynamical time, as the fastest body is at each
+    // step.  The dynamical time of a body is the smallest of the
+    // √(r³ / (μ₁ + μ₂)) over the pairs that it forms with the other bodies in
+    // the initial state; it is the orbital period divided by 2π for bound
+    // pairs.  The error of the trajectories remains bounded by the fitting
+    // tolerance since the degree of their series is adjusted to meet it, and
+    // the integration error is unaffected; only the fitting work and the
+    // number of series decrease.  Moreover, each trajectory adapts the
+    // spacing of the samples of its series to its smoothness, without
+    // exceeding |max_fitting_step_multiple| steps.
     FixedStepParameters(
         FixedStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
-        Time const& step);
+        Time const& step,
+        int max_fitting_step_multiple = 1);
 
     Time const& step() const;
+    int max_fitting_step_multiple() const;
+
+    // The number of evenly-spaced states preceding the initial state that the
+    // integrator may use to avoid its startup, see |NewInstanceWithHistory|.
+    int history_size() const;
 
     void WriteToMessage(
         not_null<serialization::Ephemeris::FixedStepParameters*> message) const;
@@ -119,6 +199,36 @@ class Ephemeris {
     not_null<FixedStepSizeIntegrator<NewtonianMotionEquation> const*>
         integrator_;
     Time step_;
+    int max_fitting_step_multiple_;
+    friend class Ephemeris<Frame>;
+  };
+
+  class PHYSICS_DLL ParallelProlongationParameters final {
+   public:
+    // The duration of the time slices is |fine_steps_per_slice| steps of the
+    // ephemeris.  The |coarse_integrator| integrates each slice in
+    // |coarse_steps_per_slice| steps.  The iterations stop when they move the
+    // positions and velocities of all the bodies at the beginning of all the
+    // slices by less than the |length_| and |speed_integration_tolerance|s, or
+    // after |max_iterations|.
+    ParallelProlongationParameters(
+        FixedStepSizeIntegrator<NewtonianMotionEquation> const&
+            coarse_integrator,
+        std::int64_t coarse_steps_per_slice,
+        std::int64_t fine_steps_per_slice,
+        int max_iterations,
+        Length const& length_integration_tolerance,
+        Speed const& speed_integration_tolerance);
+
+   private:
+    // This will refer to a static object returned by a factory.
+    not_null<FixedStepSizeIntegrator<NewtonianMotionEquation> const*>
+        coarse_integrator_;
+    std::int64_t coarse_steps_per_slice_;
+    std::int64_t fine_steps_per_slice_;
+    int max_iterations_;
+    Length length_integration_tolerance_;
+    Speed speed_integration_tolerance_;
     friend class Ephemeris<Frame>;
   };
 
@@ -130,20 +240,40 @@ class Ephemeris {
             Length const& fitting_tolerance,
             FixedStepParameters const& parameters);
 
-  virtual ~Ephemeris() = default;
+  // Stops the background prolongation, if any.
+  virtual ~Ephemeris();
 
   // Returns the bodies in the order in which they were given at construction.
   virtual std::vector<not_null<MassiveBody const*>> const& bodies() const;
 
-  // Returns the trajectory for the given |body|.
+  // Returns the trajectory for the given |body|.  This performs a lookup;
+  // clients that access the trajectory repeatedly should either keep the
+  // returned pointer or use the |body_index|.
   virtual not_null<ContinuousTrajectory<Frame> const*> trajectory(
       not_null<MassiveBody const*> body) const;
 
+  // Returns the index of |body| in |bodies()|.  The index is dense and stable
+  // for the lifetime of this object, so it may be resolved once and used with
+  // |trajectory_for_body_index|.
+  virtual int body_index(not_null<MassiveBody const*> body) const;
+
+  // Returns the trajectory of the body at |body_index| in |bodies()| in
+  // constant time.
+  virtual not_null<ContinuousTrajectory<Frame> const*>
+  trajectory_for_body_index(int body_index) const;
+
+  // Sets |positions| to the positions of the bodies at time |t|, in the order
+  // of |bodies()|.  This is cheaper than going through |trajectory| for each
+  // body.  |t| must be in the range of all the trajectories.
+  virtual void EvaluateAllPositions(
+      Instant const& t,
+      std::vector<Position<Frame>>& positions) const EXCLUDES(lock_);
+
   // Returns true if at least one of the trajectories is empty.
   virtual bool empty() const EXCLUDES(lock_);
 
   // The maximum of the |t_min|s of the trajectories.
-  virtual Instant t_min() const EXCLUDES(lock_);
+  virtual Instant t_min() const EXCLUDES(lock_, integration_lock_);
   // The mimimum of the |t_max|s of the trajectories.
   virtual Instant t_max() const EXCLUDES(lock_);
 
@@ -153,10 +283,74 @@ class Ephemeris {
   virtual Status last_severe_integration_status() const;
 
   // Calls |ForgetBefore| on all trajectories.  On return |t_min() == t|.
-  virtual void ForgetBefore(Instant const& t);
+  // Waits for the readers of the trajectories and for the prolongation in
+  // flight, if any.
+  virtual void ForgetBefore(Instant const& t) EXCLUDES(lock_);
 
   // Prolongs the ephemeris up to at least |t|.  After the call, |t_max() >= t|.
-  virtual void Prolong(Instant const& t) EXCLUDES(lock_);
+  // The trajectories may be evaluated concurrently: their new polynomials only
+  // become visible once they are complete.
+  virtual void Prolong(Instant const& t) EXCLUDES(integration_lock_);
+
+  // Same as |Prolong|, but the massive bodies are integrated in parallel in
+  // time on the scheduler given to |SetMassiveBodiesScheduler|, using the
+  // Parareal method with the |planetary_integrator()| as the fine integrator.
+  // This is faster than |Prolong| when |t| is far in the future, but the
+  // results differ from those of |Prolong| by up to the tolerances of the
+  // |parameters|, and the multistep integrator is restarted at |t|.  Falls
+  // back to |Prolong| if there is no scheduler or if the iterations don't
+  // converge.
+  virtual void ProlongInParallel(
+      Instant const& t,
+      ParallelProlongationParameters const& parameters)
+      EXCLUDES(integration_lock_);
+
+  // Starts a thread that prolongs the ephemeris in the background so that
+  // |t_max()| stays |horizon| ahead of the last time passed to
+  // |RequestProlongation|.  The thread integrates a few steps at a time, so
+  // that |integration_lock_| is only held briefly and |ForgetBefore| is not
+  // blocked for long; the readers of the trajectories are never blocked.  A
+  // call to |Prolong| only integrates if the background thread has not yet
+  // reached its argument.  Has no effect if the
+  // thread is already running.
+  virtual void StartBackgroundProlongation(Time const& horizon)
+      EXCLUDES(prolongator_lock_);
+  // Stops the thread started by |StartBackgroundProlongation|, if any.  Returns
+  // when the prolongation in flight, if any, is done.
+  virtual void StopBackgroundProlongation() EXCLUDES(prolongator_lock_);
+  // Asks the background thread, if any, to prolong the ephemeris up to at
+  // least |t| plus its horizon.  Doesn't block.
+  virtual void RequestProlongation(Instant const& t)
+      EXCLUDES(prolongator_lock_);
+
+  // If |scheduler| is not null, the accelerations between the massive bodies
+  // are henceforth computed by tiles executed in parallel on |scheduler|, with
+  // a vectorized kernel for the spherical bodies.  The tiling only depends on
+  // the number of bodies, so the results don't depend on the number of threads
+  // of |scheduler|, but they may differ in the last bits from those of the
+  // serial computation.  The polynomial fits of the trajectories are also
+  // executed in parallel on |scheduler|; their results are unaffected.  If
+  // |scheduler| is null, reverts to the serial computation.
+  virtual void SetMassiveBodiesScheduler(WorkStealingScheduler* scheduler)
+      EXCLUDES(integration_lock_);
+
+  // If |enabled|, the accelerations between the spherical massive bodies are
+  // henceforth approximated using a |BarnesHutTree|, which is faster than the
+  // pairwise computation when there are many bodies.  The tolerance of the
+  // tree is such that the error on the accelerations moves the bodies by less
+  // than the fitting tolerance over a step.  The accelerations involving the
+  // oblate bodies are still computed pairwise.  This takes precedence over the
+  // tiles of |SetMassiveBodiesScheduler|, but doesn't affect the slices of
+  // |ProlongInParallel|.
+  virtual void SetMassiveBodiesTreeEvaluation(bool enabled)
+      EXCLUDES(integration_lock_);
+
+  // If |threshold| is positive, the flows and the instances created henceforth
+  // neglect, when computing the accelerations of their massless bodies, the
+  // massive bodies whose total contribution is bounded by |threshold| times
+  // that of the largest contributor, see |MasslessBodiesCulling|.  If
+  // |threshold| is zero, all the massive bodies are taken into account.
+  virtual void SetMasslessBodiesCullingThreshold(double threshold);
 
   // Creates an instance suitable for integrating the given |trajectories| with
   // their |intrinsic_accelerations| using a fixed-step integrator parameterized
@@ -168,6 +362,20 @@ class Ephemeris {
       IntrinsicAccelerations const& intrinsic_accelerations,
       FixedStepParameters const& parameters);
 
+  // Same as |NewInstance|, but the |parameters.history_size()| points of each
+  // trajectory that precede its last point are used as the history of the
+  // integrator, which doesn't go through its startup.  These points must be
+  // at intervals of |parameters.step()|, and the caller must ensure that they
+  // are solutions of the equation being integrated, i.e., that they were
+  // computed with the same |intrinsic_accelerations|.  If some trajectory has
+  // fewer points, this function is equivalent to |NewInstance|.
+  virtual not_null<
+      std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>>
+  NewInstanceWithHistory(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      FixedStepParameters const& parameters);
+
   // Integrates, until exactly |t| (except for timeouts or singularities), the
   // |trajectory| followed by a massless body in the gravitational potential
   // described by |*this|.  If |t > t_max()|, calls |Prolong(t)| beforehand.
@@ -183,6 +391,55 @@ class Ephemeris {
       std::int64_t max_ephemeris_steps,
       bool last_point_only);
 
+  // Same as above, but instead of stopping after |max_ephemeris_steps|, the
+  // ephemeris is prolonged by |max_ephemeris_steps| at a time until |t| is
+  // reached, |parameters.max_steps()| steps have been taken, or |deadline| has
+  // passed, in which case the result is |DEADLINE_EXCEEDED|.  The clock is
+  // checked every |steps_between_deadline_checks| steps and after each
+  // prolongation, so the deadline may be overrun by that much work.  The
+  // integration may be resumed by a subsequent call.
+  virtual Status FlowWithAdaptiveStepBefore(
+      not_null<DiscreteTrajectory<Frame>*> trajectory,
+      IntrinsicAcceleration intrinsic_acceleration,
+      Instant const& t,
+      AdaptiveStepParameters const& parameters,
+      std::int64_t max_ephemeris_steps,
+      std::chrono::steady_clock::time_point const& deadline);
+
+  // Same as above, but integrates the |trajectories| together, as a single
+  // system, so that the positions of the massive bodies are evaluated once
+  // for all the trajectories at each stage.  The trajectories must all end at
+  // the same time.  The elements of |intrinsic_accelerations| (which may be
+  // empty), |trajectories| and |parameters| correspond to one another.  The
+  // |parameters| may have different tolerances, which are all honoured, but
+  // they must have the same integrator; the number of steps is limited by the
+  // largest of their |max_steps|.  As with |FlowWithFixedStep|, the result
+  // pertains to the entire system.
+  virtual Status FlowManyWithAdaptiveStep(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      Instant const& t,
+      std::vector<AdaptiveStepParameters> const& parameters,
+      std::int64_t max_ephemeris_steps,
+      bool last_point_only);
+
+  // Integrates the |trajectories| independently of one another, as if by
+  // calling |FlowWithAdaptiveStep| for each of them with the corresponding
+  // elements of |intrinsic_accelerations| (which may be empty) and
+  // |parameters|, but in parallel on |scheduler|.  Each trajectory has its own
+  // step sizes, so this is preferable to |FlowManyWithAdaptiveStep| when the
+  // trajectories are many and unrelated, e.g., for a cloud of debris or for
+  // dispersions.  The results are the same as those of the serial calls.
+  // Returns the status of the flow of each trajectory.
+  virtual std::vector<Status> FlowIndependentlyWithAdaptiveStep(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      Instant const& t,
+      std::vector<AdaptiveStepParameters> const& parameters,
+      std::int64_t max_ephemeris_steps,
+      bool last_point_only,
+      not_null<WorkStealingScheduler*> scheduler);
+
   // Integrates, until at most |t|, the trajectories followed by massless
   // bodies in the gravitational potential described by |*this|.  If
   // |t > t_max()|, calls |Prolong(t)| beforehand.  The trajectories and
@@ -224,6 +481,28 @@ class Ephemeris {
                               DiscreteTrajectory<Frame>& apoapsides2,
                               DiscreteTrajectory<Frame>& periapsides2);
 
+  // A pair of bodies for the bulk |ComputeApsides| below, and the trajectories
+  // to which their apsides are appended.
+  struct ApsidesComputation final {
+    not_null<MassiveBody const*> body1;
+    not_null<MassiveBody const*> body2;
+    not_null<DiscreteTrajectory<Frame>*> apoapsides1;
+    not_null<DiscreteTrajectory<Frame>*> periapsides1;
+    not_null<DiscreteTrajectory<Frame>*> apoapsides2;
+    not_null<DiscreteTrajectory<Frame>*> periapsides2;
+  };
+
+  // Computes the apsides of all the |computations|, as if by calling the above
+  // function for each of them.  The positions of all the bodies are evaluated
+  // once per step and shared by all the pairs, and the steps are split in
+  // chunks processed in parallel on |scheduler|.  The apsides are detected by
+  // a change of sign of the differences of squared distances and refined by
+  // regula falsi; they are the same as those of the above function except when
+  // two apsides of a pair are less than two steps apart.
+  virtual void ComputeApsides(
+      std::vector<ApsidesComputation> const& computations,
+      not_null<WorkStealingScheduler*> scheduler);
+
   // Returns the index of the given body in the serialization produced by
   // |WriteToMessage| and read by the |Read...| functions.  This index is not
   // suitable for other uses.
@@ -233,11 +512,47 @@ class Ephemeris {
   virtual not_null<MassiveBody const*> body_for_serialization_index(
       int serialization_index) const;
 
+  // Returns an ephemeris that has copies of the bodies of this object, that
+  // coincides with it up to |t|, and that is integrated independently after
+  // |t|, starting from the state of this object at |t|, with the given
+  // |parameters|.  The trajectories of the fork share their polynomials before
+  // |t| with those of this object, so forking doesn't depend on the length of
+  // the trajectories.  This object must outlive the fork and must not forget
+  // the times before |t| while the fork exists.  The fork cannot be
+  // serialized.  |t| must be in [|t_min()|, |t_max()|].
+  virtual not_null<std::unique_ptr<Ephemeris>> Fork(
+      Instant const& t,
+      FixedStepParameters const& parameters) const;
+
+  // Returns a fingerprint of the bodies and of the parameters of this object.
+  // Two ephemerides that have the same fingerprint and agree at some time
+  // compute the same trajectories; a client may thus store the fingerprint
+  // with the results of a computation to check cheaply, after
+  // deserialization, that they don't need to be recomputed.
+  virtual std::uint64_t Fingerprint() const;
+
+  // The polynomials are only serialized up to the oldest checkpoint.  The
+  // later checkpoints are serialized without polynomials, and
+  // |ReadFromMessage| returns before the trajectories past the oldest one are
+  // recomputed: the stretches between checkpoints are integrated concurrently
+  // on a background thread.  Until it is done, |t_max()| is that of the
+  // oldest checkpoint, and |Prolong| and the other functions that integrate
+  // the massive bodies wait for it.
   virtual void WriteToMessage(
       not_null<serialization::Ephemeris*> message) const;
   static not_null<std::unique_ptr<Ephemeris>> ReadFromMessage(
       serialization::Ephemeris const& message);
 
+  // Writes a snapshot of this object, see
+  // |ContinuousTrajectory::WriteToSnapshot|, at the end of |bytes|.  The state
+  // other than the trajectories is small and is stored as a serialized message.
+  // |ReadFromSnapshot| doesn't require |bytes| to be aligned, so it may be
+  // given a memory-mapped file.
+  virtual void WriteToSnapshot(
+      not_null<std::vector<std::uint8_t>*> bytes) const;
+  static not_null<std::unique_ptr<Ephemeris>> ReadFromSnapshot(
+      Array<std::uint8_t const> bytes);
+
  protected:
   // For mocking purposes, leaves everything uninitialized and uses the given
   // |integrator|.
@@ -253,21 +568,224 @@ class Ephemeris {
     std::vector<typename ContinuousTrajectory<Frame>::Checkpoint> checkpoints;
   };
 
+  // Writes the state other than the trajectories to |message|, and calls
+  // |write_trajectory(trajectory, checkpoint)| for each element of
+  // |trajectories_|, where |checkpoint| is null if the current state of the
+  // trajectory must be written.
+  template<typename WriteTrajectory>
+  void WriteToMessage(not_null<serialization::Ephemeris*> message,
+                      WriteTrajectory const& write_trajectory) const;
+  // Reads the state other than the trajectories from |message|, and calls
+  // |read_trajectory()| to obtain the elements of |trajectories_|, in order.
+  template<typename ReadTrajectory>
+  static not_null<std::unique_ptr<Ephemeris>> ReadFromMessage(
+      serialization::Ephemeris const& message,
+      ReadTrajectory const& read_trajectory);
+
+  // Returns the multiples of |parameters.step()| with which the trajectories
+  // of the |bodies| should be fitted, see |FixedStepParameters|.
+  static std::vector<int> FittingStepMultiples(
+      std::vector<not_null<std::unique_ptr<MassiveBody const>>> const& bodies,
+      std::vector<DegreesOfFreedom<Frame>> const& initial_state,
+      FixedStepParameters const& parameters);
+
   void AppendMassiveBodiesState(
       typename NewtonianMotionEquation::SystemState const& state)
-      REQUIRES(lock_);
+      REQUIRES(integration_lock_);
+  // Same as above, but doesn't record checkpoints.  The state is only appended
+  // to the trajectories whose step has elapsed since their last point.
+  void AppendMassiveBodiesStateToTrajectories(
+      typename NewtonianMotionEquation::SystemState const& state)
+      REQUIRES(integration_lock_);
+  // The implementation of |FlowManyWithAdaptiveStep| and
+  // |FlowWithAdaptiveStepBefore|, the latter corresponding to a non-null
+  // |deadline|.
+  Status FlowManyWithAdaptiveStepBefore(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      Instant const& t,
+      std::vector<AdaptiveStepParameters> const& parameters,
+      std::int64_t max_ephemeris_steps,
+      bool last_point_only,
+      std::optional<std::chrono::steady_clock::time_point> const& deadline);
+
+  // The implementation of |FlowManyWithAdaptiveStepBefore| for a single
+  // |trajectory| when |parameters.encke_rectification_threshold()| is set or
+  // |parameters.regularize_close_approaches()| is true.  Culling doesn't
+  // apply.
+  Status FlowWithAdaptiveStepByEncke(
+      not_null<DiscreteTrajectory<Frame>*> trajectory,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      Instant const& t,
+      AdaptiveStepParameters const& parameters,
+      std::int64_t max_ephemeris_steps,
+      bool last_point_only,
+      std::optional<std::chrono::steady_clock::time_point> const& deadline);
+
+  // Returns the index in |bodies_| of the body about which the motion of a
+  // massless body at |position| at time |t| is the least perturbed, i.e., the
+  // body for which the ratio of the perturbing acceleration, in a frame
+  // centred on the body, to its central acceleration is the smallest.  That
+  // ratio is stored in |perturbation_ratio|.  The bodies are treated as point
+  // masses.
+  std::size_t FindDominantBody(Instant const& t,
+                               Position<Frame> const& position,
+                               double& perturbation_ratio) const
+      EXCLUDES(lock_);
+
   static void AppendMasslessBodiesState(
       typename NewtonianMotionEquation::SystemState const& state,
       std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories);
 
-  Checkpoint GetCheckpoint() REQUIRES_SHARED(lock_);
+  // The implementation of |NewInstance| and |NewInstanceWithHistory|.
+  // |history| is passed to the integrator as is.
+  not_null<
+      std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>>
+  MakeInstance(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      FixedStepParameters const& parameters,
+      std::vector<typename NewtonianMotionEquation::SystemState> const&
+          history);
+
+  // The massive bodies that the accelerations of the massless bodies of a flow
+  // neglect.  It is updated at the end of each step, from the state of the
+  // massless bodies.  A massive body is neglected if the bound on its
+  // acceleration over the validity period, added to those of the other
+  // neglected bodies, stays below |threshold| times the largest acceleration
+  // exerted on each massless body.  The validity period is the time it takes
+  // the neglected bodies to halve their distance to the massless bodies at
+  // their current relative velocity; outside of it, no body is neglected.
+  class MasslessBodiesCulling final {
+   public:
+    explicit MasslessBodiesCulling(double threshold);
+
+    // The bodies, indexed like |bodies_|, that may be neglected at time |t|.
+    // Empty if none may be.
+    std::vector<bool> const& culled_bodies(Instant const& t) const;
+
+   private:
+    double const threshold_;
+    std::vector<bool> culled_bodies_;
+    std::vector<bool> const no_culled_bodies_;
+    Instant time_;
+    Time validity_;
+    friend class Ephemeris<Frame>;
+  };
+
+  // A cache of the positions of all the bodies at recently evaluated times.
+  // It is shared by the threads that integrate massless bodies, e.g., the
+  // predictions of different vessels, which often evaluate the ephemeris at
+  // the same times.  It is direct-mapped on the time, and each slot is a
+  // sequence lock, so that neither the readers nor the writers ever wait: a
+  // reader that races with a writer misses, and a writer that races with
+  // another writer gives up.  The positions at a time never change once they
+  // may be evaluated, so the entries need not be invalidated.
+  class PositionCache final {
+   public:
+    // |number_of_bodies| is the size of the vectors of positions.
+    explicit PositionCache(int number_of_bodies);
+
+    // If the positions at |t| are in the cache, sets |positions| to them and
+    // returns true.  Otherwise returns false and leaves |positions|
+    // unspecified.
+    bool Find(Instant const& t, std::vector<Position<Frame>>& positions) const;
+
+    // Stores |positions|, the positions at |t|, in the cache.
+    void Insert(Instant const& t,
+                std::vector<Position<Frame>> const& positions);
+
+   private:
+    static constexpr int slots = 32;
+
+    struct Slot final {
+      // Zero if the slot was never written, odd while it is being written.
+      std::atomic<std::uint64_t> sequence{0};
+      Instant time;
+      std::vector<Position<Frame>> positions;
+    };
+
+    static int SlotIndex(Instant const& t);
+
+    std::array<Slot, slots> slots_;
+  };
+
+  // Updates |culling| from the degrees of freedom of the massless bodies in
+  // |state|.
+  void UpdateMasslessBodiesCulling(
+      typename NewtonianMotionEquation::SystemState const& state,
+      MasslessBodiesCulling& culling) const EXCLUDES(lock_);
+
+  // Returns the time of the earliest impact of a massless body on a massive
+  // body during the step from |previous_state| to |state|, if any.  Between the
+  // stages of a long step a massless body may graze a massive body without any
+  // stage being inside it, so we look at the Hermite interpolation of the
+  // motion relative to each massive body.  The interpolated arc lies within the
+  // sphere bounding its Bézier control points, and only the bodies that
+  // intersect that sphere are examined further.  If
+  // |bodies_degrees_of_freedom| is not empty, it must contain the degrees of
+  // freedom of the massive bodies at the time of |previous_state|; on return it
+  // contains them at the time of |state|.
+  std::optional<Instant> FindImpact(
+      typename NewtonianMotionEquation::SystemState const& previous_state,
+      typename NewtonianMotionEquation::SystemState const& state,
+      std::vector<DegreesOfFreedom<Frame>>& bodies_degrees_of_freedom) const
+      EXCLUDES(lock_);
+
+  // Returns the state at |time| obtained by Hermite interpolation between
+  // |previous_state| and |state|.
+  static typename NewtonianMotionEquation::SystemState InterpolateState(
+      typename NewtonianMotionEquation::SystemState const& previous_state,
+      typename NewtonianMotionEquation::SystemState const& state,
+      Instant const& time);
+
+  Checkpoint GetCheckpoint() REQUIRES(integration_lock_);
+
+  // The body of the thread started by |StartBackgroundProlongation|.
+  void RepeatedlyProlong() EXCLUDES(prolongator_lock_);
+
+  // The body of |Prolong|.
+  void ProlongLocked(Instant const& t) REQUIRES(integration_lock_);
+
+  // A stretch of the integration of the massive bodies between two consecutive
+  // checkpoints, which |Rebuild| recomputes independently of the others.
+  struct RebuildRange final {
+    std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>
+        instance;
+    Instant t_final;
+    // The trajectories read from the checkpoint at the start of the range and
+    // prolonged by |instance|.  Empty for the first range, which prolongs the
+    // |trajectories_|.
+    std::vector<not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>
+        continuations;
+  };
 
-  // Same as t_max, but |lock_| must be held.
-  Instant t_max_locked() const REQUIRES_SHARED(lock_);
+  // Called by |ReadFromMessage| if |message| has checkpoints after the one at
+  // which its trajectories stop.  Reads a range starting at each checkpoint
+  // but the last, and starts |rebuilder_| to recompute them.  |equation| is
+  // that of |instance_|.  Returns once |rebuilder_| holds |integration_lock_|.
+  void StartRebuild(serialization::Ephemeris const& message,
+                    NewtonianMotionEquation const& equation,
+                    Instant const& t_max) EXCLUDES(integration_lock_);
+
+  // The body of |rebuilder_|.  Integrates the |ranges| concurrently, appends
+  // them in order to the |trajectories_|, recording the checkpoints, and then
+  // prolongs the ephemeris up to |t_max|.  |checkpoint_instances[i]| is the
+  // instance at the end of |ranges[i]|, with the equation of |instance_|.
+  void Rebuild(
+      std::vector<RebuildRange>& ranges,
+      std::vector<std::unique_ptr<
+          typename Integrator<NewtonianMotionEquation>::Instance>>&
+          checkpoint_instances,
+      Instant const& t_max) REQUIRES(integration_lock_);
+
+  // Same as t_max, but |lock_| or |integration_lock_| must be held, so that
+  // the trajectories are not forgotten concurrently.
+  Instant t_max_locked() const;
 
   // Note the return by copy: the returned value is usable even if the
   // |instance_| is being integrated.
-  Instant instance_time() const EXCLUDES(lock_);
+  Instant instance_time() const EXCLUDES(integration_lock_);
 
   // Computes the accelerations between one body, |body1| (with index |b1| in
   // the |positions| and |accelerations| arrays) and the bodies |bodies2| (with
@@ -289,15 +807,15 @@ class Ephemeris {
       std::vector<Vector<Acceleration, Frame>>& accelerations);
 
   // Computes the accelerations due to one body, |body1| (with index |b1| in the
-  // |bodies_| and |trajectories_| arrays) on massless bodies at the given
-  // |positions|.  The template parameter specifies what we know about the
-  // massive body, and therefore what forces apply.  Returns false iff a
-  // collision occurred, i.e., the massless body is inside |body1|.
+  // |bodies_| and |trajectories_| arrays) at |position1|, on massless bodies at
+  // the given |positions|.  The template parameter specifies what we know
+  // about the massive body, and therefore what forces apply.  Returns false
+  // iff a collision occurred, i.e., the massless body is inside |body1|.
   template<bool body1_is_oblate>
   bool ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
-      Instant const& t,
       MassiveBody const& body1,
       std::size_t const b1,
+      Position<Frame> const& position1,
       std::vector<Position<Frame>> const& positions,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const
       REQUIRES_SHARED(lock_);
@@ -308,13 +826,42 @@ class Ephemeris {
       std::vector<Position<Frame>> const& positions,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const;
 
+  // Same as above, but the computation is serial.  Thread-safe.
+  void ComputeMassiveBodiesGravitationalAccelerationsSerially(
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+  // Same as above, but the computation is split in |tiles_| which are executed
+  // on |massive_bodies_scheduler_|.
+  void ComputeMassiveBodiesGravitationalAccelerationsByTiles(
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+  // Same as above, but the accelerations between the spherical bodies are
+  // approximated using |tree_|.
+  void ComputeMassiveBodiesGravitationalAccelerationsByTree(
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+  // Sets |positions| to the positions at time |t| of the bodies of |bodies_|,
+  // in the same order, except that the positions of the bodies for which
+  // |culled_bodies| is true are left unspecified.  |culled_bodies| is either
+  // empty or indexed like |bodies_|.  The trajectories are evaluated in a
+  // tight loop, before the positions are used.
+  void EvaluateTrajectoriesPositions(
+      Instant const& t,
+      std::vector<bool> const& culled_bodies,
+      std::vector<Position<Frame>>& positions) const REQUIRES_SHARED(lock_);
+
   // Computes the acceleration exerted by the massive bodies in |bodies_| on
-  // massless bodies.  The massless bodies are at the given |positions|.
-  // Returns false iff a collision occurred, i.e., the massless body is inside
-  // one of the |bodies_|.
+  // massless bodies.  The massless bodies are at the given |positions|.  The
+  // bodies for which |culled_bodies| is true are ignored; it is either empty
+  // or indexed like |bodies_|.  Returns false iff a collision occurred, i.e.,
+  // the massless body is inside one of the |bodies_|.
   bool ComputeMasslessBodiesGravitationalAccelerations(
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
+      std::vector<bool> const& culled_bodies,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const
       EXCLUDES(lock_);
 
@@ -325,36 +872,57 @@ class Ephemeris {
       std::vector<IntrinsicAcceleration> const& intrinsic_accelerations,
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
+      std::vector<bool> const& culled_bodies,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const;
 
-  // Computes an estimate of the ratio |tolerance / error|.
+  // Returns |intrinsic_accelerations| if at least one of them is set, and an
+  // empty vector otherwise, so that the computation of the accelerations at
+  // each stage of an integration doesn't have to look at them.
+  static IntrinsicAccelerations const& EffectiveIntrinsicAccelerations(
+      IntrinsicAccelerations const& intrinsic_accelerations);
+
+  // Computes an estimate of the ratio |tolerance / error|.  The elements of the
+  // tolerance vectors correspond to the bodies of the system, and the smallest
+  // ratio is returned.
   static double ToleranceToErrorRatio(
-      Length const& length_integration_tolerance,
-      Speed const& speed_integration_tolerance,
+      std::vector<Length> const& length_integration_tolerances,
+      std::vector<Speed> const& speed_integration_tolerances,
       Time const& current_step_size,
       typename NewtonianMotionEquation::SystemStateError const& error);
 
-  // Guards |instance_|, |trajectories_|, and |bodies_to_trajectories_| during
-  // integration.  Note that the thread-safety annotations are incomplete
-  // because we do not attempt to protect all the operations, only integration.
-  mutable base::shared_mutex lock_;
+  // Guards the trajectories against |ForgetBefore| while they are evaluated.
+  // Note that the thread-safety annotations are incomplete because we do not
+  // attempt to protect all the operations, only integration.  It is taken in
+  // shared mode at each stage of each flow of a massless body, often on many
+  // threads, and exclusively by the rare calls to |ForgetBefore|, hence the
+  // sharding.  The prolongations append to the trajectories without taking
+  // it, see |ContinuousTrajectory::Append|.
+  mutable ShardedSharedMutex lock_;
+
+  // Guards |instance_|, |checkpoints_| and the state of the massive bodies
+  // integration, and serializes the writers of the trajectories.  It is held
+  // during the prolongations, so it must never be acquired while holding
+  // |lock_|.
+  mutable std::mutex integration_lock_;
 
   // The bodies in the order in which they were given at construction.
   std::vector<not_null<MassiveBody const*>> unowned_bodies_;
 
-  // The indices of bodies in |unowned_bodies_|.
+  // The indices of bodies in |unowned_bodies_|.  Only used to resolve the
+  // index of a body, the hot paths use the vectors below.
   std::map<not_null<MassiveBody const*>, int> unowned_bodies_indices_;
 
+  // The index in |bodies_| and |trajectories_| of each element of
+  // |unowned_bodies_|.
+  std::vector<int> bodies_indices_;
+
   // The oblate bodies precede the spherical bodies in this vector.  The system
   // state is indexed in the same order.
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies_;
 
   // The indices in |bodies_| correspond to those in |trajectories_|.
-  std::vector<not_null<ContinuousTrajectory<Frame>*>> trajectories_;
-
-  std::map<not_null<MassiveBody const*>,
-           not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>
-      bodies_to_trajectories_;
+  std::vector<not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>
+      trajectories_;
 
   FixedStepParameters const parameters_;
   Length const fitting_tolerance_;
@@ -368,7 +936,53 @@ class Ephemeris {
   int number_of_oblate_bodies_ = 0;
   int number_of_spherical_bodies_ = 0;
 
+  // A range of rows of the (triangular) matrix of interactions between
+  // spherical bodies, and the accelerations that it contributes.
+  struct SphericalBodiesTile final {
+    std::size_t b1_begin;
+    std::size_t b1_end;
+    QuantityArray<Vector<Acceleration, Frame>> accelerations;
+  };
+
+  // The state used by |ComputeMassiveBodiesGravitationalAccelerationsByTiles|.
+  // The mutable members are only used while integrating the massive bodies,
+  // i.e., when holding |integration_lock_|.  The arrays are indexed like
+  // |bodies_|.
+  WorkStealingScheduler* massive_bodies_scheduler_ = nullptr;
+  QuantityArray<GravitationalParameter> μ_;
+  mutable QuantityArray<Position<Frame>> q_;
+  mutable std::vector<Vector<Acceleration, Frame>> oblate_bodies_accelerations_;
+  mutable std::vector<SphericalBodiesTile> tiles_;
+
+  // The state used by |ComputeMassiveBodiesGravitationalAccelerationsByTree|,
+  // under the same conditions as the tiles.  Covers the spherical bodies.
+  mutable std::optional<BarnesHutTree<Frame>> tree_;
+
+  // The positions of the bodies, indexed like |bodies_|, at the times where
+  // the massless bodies were recently integrated.
+  mutable std::optional<PositionCache> position_cache_;
+
+  std::atomic<double> massless_bodies_culling_threshold_{0};
+
   Status last_severe_integration_status_;
+
+  // The thread that prolongs the ephemeris in the background, see
+  // |StartBackgroundProlongation|.
+  std::thread prolongator_;
+  std::mutex prolongator_lock_;
+  std::condition_variable prolongator_has_request_or_shutdown_;
+  Time prolongation_horizon_ GUARDED_BY(prolongator_lock_);
+  // The time up to which the |prolongator_| must prolong the ephemeris, if it
+  // has not yet reached it.
+  std::optional<Instant> prolongation_target_ GUARDED_BY(prolongator_lock_);
+  bool prolongator_shutdown_ GUARDED_BY(prolongator_lock_) = false;
+
+  // The thread that recomputes the trajectories of a deserialized ephemeris
+  // past its first checkpoint, see |StartRebuild|.  It holds
+  // |integration_lock_| until it is done, so the integrations and the
+  // serialization wait for it, but the trajectories may be evaluated up to
+  // their current |t_max()|.
+  std::thread rebuilder_;
 };
 
 }  // namespace internal_ephemeris
@@ -3,24 +3,43 @@
 
 #include "physics/ephemeris.hpp"
 
+#include <pmmintrin.h>
+
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <future>
 #include <functional>
 #include <limits>
+#include <memory>
+#include <numeric>
 #include <optional>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "astronomy/epoch.hpp"
+#include "base/fingerprint2011.hpp"
 #include "base/macros.hpp"
 #include "base/map_util.hpp"
 #include "base/not_null.hpp"
+#include "base/profiling.hpp"
+#include "base/serialization.hpp"
 #include "base/shared_lock_guard.hpp"
+#include "base/snapshot.hpp"
+#include "base/thread_configuration.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/r3_element.hpp"
 #include "integrators/integrators.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
+#include "integrators/parareal.hpp"
 #include "numerics/hermite3.hpp"
 #include "physics/continuous_trajectory.hpp"
+#include "physics/kepler_orbit.hpp"
+#include "physics/massless_body.hpp"
 #include "quantities/elementary_functions.hpp"
 #include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
@@ -31,10 +50,18 @@ namespace physics {
 namespace internal_ephemeris {
 
 using astronomy::J2000;
+using base::ConfigureCurrentThread;
+using base::ConfiguredPoolSize;
 using base::Error;
 using base::FindOrDie;
+using base::Fingerprint2011;
+using base::Future;
 using base::make_not_null_unique;
+using base::ParseFromBytes;
+using base::SerializeAsBytes;
 using base::shared_lock_guard;
+using base::SnapshotReader;
+using base::SnapshotWriter;
 using geometry::Barycentre;
 using geometry::Displacement;
 using geometry::InnerProduct;
@@ -44,13 +71,20 @@ using geometry::Sign;
 using geometry::Velocity;
 using integrators::Integrator;
 using integrators::IntegrationProblem;
-using numerics::Bisect;
+using integrators::Parareal;
+using integrators::termination_condition::ReachedMaximalStepCount;
+using numerics::BracketedNewton;
+using numerics::RegulaFalsi;
 using numerics::DoublePrecision;
 using numerics::Hermite3;
 using quantities::Abs;
 using quantities::Exponentiation;
 using quantities::GravitationalParameter;
+using quantities::Infinity;
+using quantities::Order2ZonalCoefficient;
+using quantities::Pow;
 using quantities::Quotient;
+using quantities::SIUnit;
 using quantities::Sqrt;
 using quantities::Square;
 using quantities::Time;
@@ -61,8 +95,143 @@ using ::std::placeholders::_1;
 using ::std::placeholders::_2;
 using ::std::placeholders::_3;
 
+// The number of pairs of spherical bodies below which it's not worth creating
+// an additional tile.
+constexpr std::int64_t min_pairs_per_tile = 256;
+// The maximum number of tiles, which bounds the memory used by the
+// accumulators.
+constexpr std::int64_t max_tiles = 64;
+
+// Computes the accelerations between the spherical bodies whose indices are in
+// [b1_begin, b1_end[ and those whose indices are in ]b1, n[, in SI units.  The
+// arguments are the coordinates of |QuantityArray|s, and the accelerations are
+// accumulated in |ax|, |ay|, |az|.  This is the same
+// computation as |ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies|
+// for spherical bodies, but on structures of arrays, processing two bodies |b2|
+// at a time.  The SSE3 and scalar code paths give the same results.
+inline void ComputeGravitationalAccelerationsBetweenSphericalBodies(
+    double const* const μ,
+    double const* const x,
+    double const* const y,
+    double const* const z,
+    std::size_t const b1_begin,
+    std::size_t const b1_end,
+    std::size_t const n,
+    double* const ax,
+    double* const ay,
+    double* const az) {
+  for (std::size_t b1 = b1_begin; b1 < b1_end; ++b1) {
+    double const μ1 = μ[b1];
+    std::size_t b2 = b1 + 1;
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+    __m128d const μ1_128d = _mm_set1_pd(μ1);
+    __m128d const x1 = _mm_set1_pd(x[b1]);
+    __m128d const y1 = _mm_set1_pd(y[b1]);
+    __m128d const z1 = _mm_set1_pd(z[b1]);
+    __m128d ax1 = _mm_setzero_pd();
+    __m128d ay1 = _mm_setzero_pd();
+    __m128d az1 = _mm_setzero_pd();
+    for (; b2 + 1 < n; b2 += 2) {
+      __m128d const Δqx = _mm_sub_pd(x1, _mm_loadu_pd(&x[b2]));
+      __m128d const Δqy = _mm_sub_pd(y1, _mm_loadu_pd(&y[b2]));
+      __m128d const Δqz = _mm_sub_pd(z1, _mm_loadu_pd(&z[b2]));
+      __m128d const Δq² = _mm_add_pd(
+          _mm_add_pd(_mm_mul_pd(Δqx, Δqx), _mm_mul_pd(Δqy, Δqy)),
+          _mm_mul_pd(Δqz, Δqz));
+      __m128d const one_over_Δq³ =
+          _mm_div_pd(_mm_sqrt_pd(Δq²), _mm_mul_pd(Δq², Δq²));
+
+      __m128d const μ1_over_Δq³ = _mm_mul_pd(μ1_128d, one_over_Δq³);
+      _mm_storeu_pd(&ax[b2], _mm_add_pd(_mm_loadu_pd(&ax[b2]),
+                                        _mm_mul_pd(Δqx, μ1_over_Δq³)));
+      _mm_storeu_pd(&ay[b2], _mm_add_pd(_mm_loadu_pd(&ay[b2]),
+                                        _mm_mul_pd(Δqy, μ1_over_Δq³)));
+      _mm_storeu_pd(&az[b2], _mm_add_pd(_mm_loadu_pd(&az[b2]),
+                                        _mm_mul_pd(Δqz, μ1_over_Δq³)));
+
+      __m128d const μ2_over_Δq³ =
+          _mm_mul_pd(_mm_loadu_pd(&μ[b2]), one_over_Δq³);
+      ax1 = _mm_sub_pd(ax1, _mm_mul_pd(Δqx, μ2_over_Δq³));
+      ay1 = _mm_sub_pd(ay1, _mm_mul_pd(Δqy, μ2_over_Δq³));
+      az1 = _mm_sub_pd(az1, _mm_mul_pd(Δqz, μ2_over_Δq³));
+    }
+    double acceleration_on_b1_x =
+        _mm_cvtsd_f64(ax1) + _mm_cvtsd_f64(_mm_unpackhi_pd(ax1, ax1));
+    double acceleration_on_b1_y =
+        _mm_cvtsd_f64(ay1) + _mm_cvtsd_f64(_mm_unpackhi_pd(ay1, ay1));
+    double acceleration_on_b1_z =
+        _mm_cvtsd_f64(az1) + _mm_cvtsd_f64(_mm_unpackhi_pd(az1, az1));
+#else
+    // Two accumulators, like the two lanes of the SSE3 code.
+    double ax1[2] = {0, 0};
+    double ay1[2] = {0, 0};
+    double az1[2] = {0, 0};
+    for (; b2 + 1 < n; b2 += 2) {
+      for (std::size_t lane = 0; lane < 2; ++lane) {
+        std::size_t const b = b2 + lane;
+        double const Δqx = x[b1] - x[b];
+        double const Δqy = y[b1] - y[b];
+        double const Δqz = z[b1] - z[b];
+        double const Δq² = (Δqx * Δqx + Δqy * Δqy) + Δqz * Δqz;
+        double const one_over_Δq³ = std::sqrt(Δq²) / (Δq² * Δq²);
+
+        double const μ1_over_Δq³ = μ1 * one_over_Δq³;
+        ax[b] += Δqx * μ1_over_Δq³;
+        ay[b] += Δqy * μ1_over_Δq³;
+        az[b] += Δqz * μ1_over_Δq³;
+
+        double const μ2_over_Δq³ = μ[b] * one_over_Δq³;
+        ax1[lane] -= Δqx * μ2_over_Δq³;
+        ay1[lane] -= Δqy * μ2_over_Δq³;
+        az1[lane] -= Δqz * μ2_over_Δq³;
+      }
+    }
+    double acceleration_on_b1_x = ax1[0] + ax1[1];
+    double acceleration_on_b1_y = ay1[0] + ay1[1];
+    double acceleration_on_b1_z = az1[0] + az1[1];
+#endif
+    if (b2 < n) {
+      double const Δqx = x[b1] - x[b2];
+      double const Δqy = y[b1] - y[b2];
+      double const Δqz = z[b1] - z[b2];
+      double const Δq² = (Δqx * Δqx + Δqy * Δqy) + Δqz * Δqz;
+      double const one_over_Δq³ = std::sqrt(Δq²) / (Δq² * Δq²);
+
+      double const μ1_over_Δq³ = μ1 * one_over_Δq³;
+      ax[b2] += Δqx * μ1_over_Δq³;
+      ay[b2] += Δqy * μ1_over_Δq³;
+      az[b2] += Δqz * μ1_over_Δq³;
+
+      double const μ2_over_Δq³ = μ[b2] * one_over_Δq³;
+      acceleration_on_b1_x -= Δqx * μ2_over_Δq³;
+      acceleration_on_b1_y -= Δqy * μ2_over_Δq³;
+      acceleration_on_b1_z -= Δqz * μ2_over_Δq³;
+    }
+    ax[b1] += acceleration_on_b1_x;
+    ay[b1] += acceleration_on_b1_y;
+    az[b1] += acceleration_on_b1_z;
+  }
+}
+
 Time const max_time_between_checkpoints = 180 * Day;
 
+// The number of steps that the background prolongation integrates each time it
+// acquires |integration_lock_|.
+std::int64_t const steps_per_background_prolongation = 16;
+
+// The number of steps after which a flow using Encke's method checks whether
+// its osculating orbit must be rectified.
+std::int64_t const steps_between_rectification_checks = 10;
+
+// When regularizing the close approaches, Encke's method is used if the
+// perturbation ratio of the dominant body is below this value.
+double const close_approach_perturbation_ratio = 1e-3;
+
+// Identifies the snapshots of an |Ephemeris|.  The version must be incremented
+// whenever the layout of the snapshots changes.
+std::uint32_t const snapshot_magic = 0x50455053;  // "PEPS".
+std::uint32_t const snapshot_version = 1;
+
 // If j is a unit vector along the axis of rotation, and r a vector from the
 // center of |body| to some point in space, the acceleration computed here is:
 //
@@ -96,6 +265,168 @@ Order2ZonalAcceleration(OblateBody<Frame> const& body,
   return axis_effect + radial_effect;
 }
 
+// Computes the accelerations exerted by the oblate |body1|, at |position1|, on
+// massless bodies at the given |positions|, and accumulates them in
+// |accelerations|.  This is the same computation as
+// |ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies| followed by
+// |Order2ZonalAcceleration|, with the same operations in the same order, but in
+// SI units and processing two massless bodies at a time.  The SSE3 and scalar
+// code paths give the same results.  Returns false iff a massless body is
+// inside |body1|.
+template<typename Frame>
+bool ComputeGravitationalAccelerationsByOblateBodyOnMasslessBodies(
+    OblateBody<Frame> const& body1,
+    Position<Frame> const& position1,
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations) {
+  using J2Overμ = Quotient<Order2ZonalCoefficient, GravitationalParameter>;
+  // The body-dependent quantities are converted once for all the massless
+  // bodies.
+  double const μ1 =
+      body1.gravitational_parameter() / SIUnit<GravitationalParameter>();
+  double const j2_over_μ1 = body1.j2_over_μ() / SIUnit<J2Overμ>();
+  double const body1_mean_radius = body1.mean_radius() / SIUnit<Length>();
+  R3Element<double> const& axis = body1.polar_axis().coordinates();
+  R3Element<Length> const q1 = (position1 - Frame::origin).coordinates();
+  double const x1 = q1.x / SIUnit<Length>();
+  double const y1 = q1.y / SIUnit<Length>();
+  double const z1 = q1.z / SIUnit<Length>();
+  bool ok = true;
+
+  auto const compute_one = [&](std::size_t const b2) {
+    R3Element<Length> const q2 = (positions[b2] - Frame::origin).coordinates();
+    R3Element<Acceleration> const& a2 = accelerations[b2].coordinates();
+    double ax = a2.x / SIUnit<Acceleration>();
+    double ay = a2.y / SIUnit<Acceleration>();
+    double az = a2.z / SIUnit<Acceleration>();
+
+    double const Δqx = x1 - q2.x / SIUnit<Length>();
+    double const Δqy = y1 - q2.y / SIUnit<Length>();
+    double const Δqz = z1 - q2.z / SIUnit<Length>();
+    double const Δq² = (Δqx * Δqx + Δqy * Δqy) + Δqz * Δqz;
+    double const Δq_norm = std::sqrt(Δq²);
+    ok &= Δq_norm > body1_mean_radius;
+    double const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+
+    double const μ1_over_Δq³ = μ1 * one_over_Δq³;
+    ax += Δqx * μ1_over_Δq³;
+    ay += Δqy * μ1_over_Δq³;
+    az += Δqz * μ1_over_Δq³;
+
+    double const one_over_Δq² = 1 / Δq²;
+    double const rx = -Δqx;
+    double const ry = -Δqy;
+    double const rz = -Δqz;
+    double const r_axis_projection = (axis.x * rx + axis.y * ry) + axis.z * rz;
+    double const j2_over_r_fifth = (j2_over_μ1 * one_over_Δq³) * one_over_Δq²;
+    double const axis_factor = (-3 * j2_over_r_fifth) * r_axis_projection;
+    double const radial_factor =
+        j2_over_r_fifth *
+        (-1.5 + ((7.5 * r_axis_projection) * r_axis_projection) * one_over_Δq²);
+    ax += μ1 * (axis_factor * axis.x + radial_factor * rx);
+    ay += μ1 * (axis_factor * axis.y + radial_factor * ry);
+    az += μ1 * (axis_factor * axis.z + radial_factor * rz);
+
+    accelerations[b2] =
+        Vector<Acceleration, Frame>({ax * SIUnit<Acceleration>(),
+                                     ay * SIUnit<Acceleration>(),
+                                     az * SIUnit<Acceleration>()});
+  };
+
+  std::size_t b2 = 0;
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+  __m128d const μ1_128d = _mm_set1_pd(μ1);
+  __m128d const j2_over_μ1_128d = _mm_set1_pd(j2_over_μ1);
+  __m128d const body1_mean_radius_128d = _mm_set1_pd(body1_mean_radius);
+  __m128d const axis_x = _mm_set1_pd(axis.x);
+  __m128d const axis_y = _mm_set1_pd(axis.y);
+  __m128d const axis_z = _mm_set1_pd(axis.z);
+  __m128d const x1_128d = _mm_set1_pd(x1);
+  __m128d const y1_128d = _mm_set1_pd(y1);
+  __m128d const z1_128d = _mm_set1_pd(z1);
+  __m128d const sign_bit = _mm_set1_pd(-0.0);
+  for (; b2 + 1 < positions.size(); b2 += 2) {
+    R3Element<Length> const q2_lo =
+        (positions[b2] - Frame::origin).coordinates();
+    R3Element<Length> const q2_hi =
+        (positions[b2 + 1] - Frame::origin).coordinates();
+    R3Element<Acceleration> const& a2_lo = accelerations[b2].coordinates();
+    R3Element<Acceleration> const& a2_hi = accelerations[b2 + 1].coordinates();
+    __m128d ax = _mm_set_pd(a2_hi.x / SIUnit<Acceleration>(),
+                            a2_lo.x / SIUnit<Acceleration>());
+    __m128d ay = _mm_set_pd(a2_hi.y / SIUnit<Acceleration>(),
+                            a2_lo.y / SIUnit<Acceleration>());
+    __m128d az = _mm_set_pd(a2_hi.z / SIUnit<Acceleration>(),
+                            a2_lo.z / SIUnit<Acceleration>());
+
+    __m128d const Δqx = _mm_sub_pd(x1_128d,
+                                   _mm_set_pd(q2_hi.x / SIUnit<Length>(),
+                                              q2_lo.x / SIUnit<Length>()));
+    __m128d const Δqy = _mm_sub_pd(y1_128d,
+                                   _mm_set_pd(q2_hi.y / SIUnit<Length>(),
+                                              q2_lo.y / SIUnit<Length>()));
+    __m128d const Δqz = _mm_sub_pd(z1_128d,
+                                   _mm_set_pd(q2_hi.z / SIUnit<Length>(),
+                                              q2_lo.z / SIUnit<Length>()));
+    __m128d const Δq² = _mm_add_pd(
+        _mm_add_pd(_mm_mul_pd(Δqx, Δqx), _mm_mul_pd(Δqy, Δqy)),
+        _mm_mul_pd(Δqz, Δqz));
+    __m128d const Δq_norm = _mm_sqrt_pd(Δq²);
+    ok &= _mm_movemask_pd(_mm_cmpgt_pd(Δq_norm, body1_mean_radius_128d)) == 3;
+    __m128d const one_over_Δq³ = _mm_div_pd(Δq_norm, _mm_mul_pd(Δq², Δq²));
+
+    __m128d const μ1_over_Δq³ = _mm_mul_pd(μ1_128d, one_over_Δq³);
+    ax = _mm_add_pd(ax, _mm_mul_pd(Δqx, μ1_over_Δq³));
+    ay = _mm_add_pd(ay, _mm_mul_pd(Δqy, μ1_over_Δq³));
+    az = _mm_add_pd(az, _mm_mul_pd(Δqz, μ1_over_Δq³));
+
+    __m128d const one_over_Δq² = _mm_div_pd(_mm_set1_pd(1), Δq²);
+    __m128d const rx = _mm_xor_pd(Δqx, sign_bit);
+    __m128d const ry = _mm_xor_pd(Δqy, sign_bit);
+    __m128d const rz = _mm_xor_pd(Δqz, sign_bit);
+    __m128d const r_axis_projection = _mm_add_pd(
+        _mm_add_pd(_mm_mul_pd(axis_x, rx), _mm_mul_pd(axis_y, ry)),
+        _mm_mul_pd(axis_z, rz));
+    __m128d const j2_over_r_fifth = _mm_mul_pd(
+        _mm_mul_pd(j2_over_μ1_128d, one_over_Δq³), one_over_Δq²);
+    __m128d const axis_factor = _mm_mul_pd(
+        _mm_mul_pd(_mm_set1_pd(-3), j2_over_r_fifth), r_axis_projection);
+    __m128d const radial_factor = _mm_mul_pd(
+        j2_over_r_fifth,
+        _mm_add_pd(_mm_set1_pd(-1.5),
+                   _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(_mm_set1_pd(7.5),
+                                                    r_axis_projection),
+                                         r_axis_projection),
+                              one_over_Δq²)));
+    ax = _mm_add_pd(ax,
+                    _mm_mul_pd(μ1_128d,
+                               _mm_add_pd(_mm_mul_pd(axis_factor, axis_x),
+                                          _mm_mul_pd(radial_factor, rx))));
+    ay = _mm_add_pd(ay,
+                    _mm_mul_pd(μ1_128d,
+                               _mm_add_pd(_mm_mul_pd(axis_factor, axis_y),
+                                          _mm_mul_pd(radial_factor, ry))));
+    az = _mm_add_pd(az,
+                    _mm_mul_pd(μ1_128d,
+                               _mm_add_pd(_mm_mul_pd(axis_factor, axis_z),
+                                          _mm_mul_pd(radial_factor, rz))));
+
+    accelerations[b2] = Vector<Acceleration, Frame>(
+        {_mm_cvtsd_f64(ax) * SIUnit<Acceleration>(),
+         _mm_cvtsd_f64(ay) * SIUnit<Acceleration>(),
+         _mm_cvtsd_f64(az) * SIUnit<Acceleration>()});
+    accelerations[b2 + 1] = Vector<Acceleration, Frame>(
+        {_mm_cvtsd_f64(_mm_unpackhi_pd(ax, ax)) * SIUnit<Acceleration>(),
+         _mm_cvtsd_f64(_mm_unpackhi_pd(ay, ay)) * SIUnit<Acceleration>(),
+         _mm_cvtsd_f64(_mm_unpackhi_pd(az, az)) * SIUnit<Acceleration>()});
+  }
+#endif
+  for (; b2 < positions.size(); ++b2) {
+    compute_one(b2);
+  }
+  return ok;
+}
+
 template<typename Frame>
 Ephemeris<Frame>::AdaptiveStepParameters::AdaptiveStepParameters(
     AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
@@ -154,6 +485,59 @@ void Ephemeris<Frame>::AdaptiveStepParameters::set_speed_integration_tolerance(
   speed_integration_tolerance_ = speed_integration_tolerance;
 }
 
+template<typename Frame>
+std::optional<double> const&
+Ephemeris<Frame>::AdaptiveStepParameters::encke_rectification_threshold()
+    const {
+  return encke_rectification_threshold_;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::AdaptiveStepParameters::
+set_encke_rectification_threshold(
+    std::optional<double> const& encke_rectification_threshold) {
+  if (encke_rectification_threshold.has_value()) {
+    CHECK_LT(0, *encke_rectification_threshold);
+  }
+  encke_rectification_threshold_ = encke_rectification_threshold;
+}
+
+template<typename Frame>
+bool Ephemeris<Frame>::AdaptiveStepParameters::regularize_close_approaches()
+    const {
+  return regularize_close_approaches_;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::AdaptiveStepParameters::set_regularize_close_approaches(
+    bool const regularize_close_approaches) {
+  regularize_close_approaches_ = regularize_close_approaches;
+}
+
+template<typename Frame>
+typename Ephemeris<Frame>::StepSizeController
+Ephemeris<Frame>::AdaptiveStepParameters::step_size_controller() const {
+  return step_size_controller_;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::AdaptiveStepParameters::set_step_size_controller(
+    StepSizeController const step_size_controller) {
+  step_size_controller_ = step_size_controller;
+}
+
+template<typename Frame>
+AdaptiveStepStatistics*
+Ephemeris<Frame>::AdaptiveStepParameters::statistics() const {
+  return statistics_;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::AdaptiveStepParameters::set_statistics(
+    AdaptiveStepStatistics* const statistics) {
+  statistics_ = statistics;
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::AdaptiveStepParameters::WriteToMessage(
     not_null<serialization::Ephemeris::AdaptiveStepParameters*> const message)
@@ -164,27 +548,50 @@ void Ephemeris<Frame>::AdaptiveStepParameters::WriteToMessage(
       message->mutable_length_integration_tolerance());
   speed_integration_tolerance_.WriteToMessage(
       message->mutable_speed_integration_tolerance());
+  if (encke_rectification_threshold_.has_value()) {
+    message->set_encke_rectification_threshold(
+        *encke_rectification_threshold_);
+  }
+  if (regularize_close_approaches_) {
+    message->set_regularize_close_approaches(true);
+  }
+  if (step_size_controller_ == StepSizeController::PI) {
+    message->set_pi_step_size_controller(true);
+  }
 }
 
 template<typename Frame>
 typename Ephemeris<Frame>::AdaptiveStepParameters
 Ephemeris<Frame>::AdaptiveStepParameters::ReadFromMessage(
     serialization::Ephemeris::AdaptiveStepParameters const& message) {
-  return AdaptiveStepParameters(
+  AdaptiveStepParameters parameters(
       AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::ReadFromMessage(
           message.integrator()),
       message.max_steps(),
       Length::ReadFromMessage(message.length_integration_tolerance()),
       Speed::ReadFromMessage(message.speed_integration_tolerance()));
+  if (message.has_encke_rectification_threshold()) {
+    parameters.set_encke_rectification_threshold(
+        message.encke_rectification_threshold());
+  }
+  parameters.set_regularize_close_approaches(
+      message.regularize_close_approaches());
+  parameters.set_step_size_controller(message.pi_step_size_controller()
+                                          ? StepSizeController::PI
+                                          : StepSizeController::Elementary);
+  return parameters;
 }
 
 template<typename Frame>
 Ephemeris<Frame>::FixedStepParameters::FixedStepParameters(
     FixedStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
-    Time const& step)
+    Time const& step,
+    int const max_fitting_step_multiple)
     : integrator_(&integrator),
-      step_(step) {
+      step_(step),
+      max_fitting_step_multiple_(max_fitting_step_multiple) {
   CHECK_LT(Time(), step);
+  CHECK_LE(1, max_fitting_step_multiple);
 }
 
 template<typename Frame>
@@ -192,12 +599,26 @@ inline Time const& Ephemeris<Frame>::FixedStepParameters::step() const {
   return step_;
 }
 
+template<typename Frame>
+inline int
+Ephemeris<Frame>::FixedStepParameters::max_fitting_step_multiple() const {
+  return max_fitting_step_multiple_;
+}
+
+template<typename Frame>
+int Ephemeris<Frame>::FixedStepParameters::history_size() const {
+  return integrator_->history_size();
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::FixedStepParameters::WriteToMessage(
     not_null<serialization::Ephemeris::FixedStepParameters*> const message)
     const {
   integrator_->WriteToMessage(message->mutable_integrator());
   step_.WriteToMessage(message->mutable_step());
+  if (max_fitting_step_multiple_ > 1) {
+    message->set_max_fitting_step_multiple(max_fitting_step_multiple_);
+  }
 }
 
 template<typename Frame>
@@ -207,7 +628,97 @@ Ephemeris<Frame>::FixedStepParameters::ReadFromMessage(
   return FixedStepParameters(
       FixedStepSizeIntegrator<NewtonianMotionEquation>::ReadFromMessage(
           message.integrator()),
-      Time::ReadFromMessage(message.step()));
+      Time::ReadFromMessage(message.step()),
+      message.has_max_fitting_step_multiple()
+          ? message.max_fitting_step_multiple()
+          : 1);
+}
+
+template<typename Frame>
+Ephemeris<Frame>::ParallelProlongationParameters::
+ParallelProlongationParameters(
+    FixedStepSizeIntegrator<NewtonianMotionEquation> const& coarse_integrator,
+    std::int64_t const coarse_steps_per_slice,
+    std::int64_t const fine_steps_per_slice,
+    int const max_iterations,
+    Length const& length_integration_tolerance,
+    Speed const& speed_integration_tolerance)
+    : coarse_integrator_(&coarse_integrator),
+      coarse_steps_per_slice_(coarse_steps_per_slice),
+      fine_steps_per_slice_(fine_steps_per_slice),
+      max_iterations_(max_iterations),
+      length_integration_tolerance_(length_integration_tolerance),
+      speed_integration_tolerance_(speed_integration_tolerance) {
+  CHECK_LT(0, coarse_steps_per_slice_);
+  CHECK_LT(0, fine_steps_per_slice_);
+  CHECK_LT(0, max_iterations_);
+  CHECK_LT(Length(), length_integration_tolerance_);
+  CHECK_LT(Speed(), speed_integration_tolerance_);
+}
+
+template<typename Frame>
+Ephemeris<Frame>::MasslessBodiesCulling::MasslessBodiesCulling(
+    double const threshold)
+    : threshold_(threshold) {
+  CHECK_LE(0, threshold_);
+}
+
+template<typename Frame>
+std::vector<bool> const&
+Ephemeris<Frame>::MasslessBodiesCulling::culled_bodies(Instant const& t) const {
+  if (Abs(t - time_) <= validity_) {
+    return culled_bodies_;
+  } else {
+    return no_culled_bodies_;
+  }
+}
+
+template<typename Frame>
+Ephemeris<Frame>::PositionCache::PositionCache(int const number_of_bodies) {
+  for (auto& slot : slots_) {
+    slot.positions.resize(number_of_bodies);
+  }
+}
+
+template<typename Frame>
+bool Ephemeris<Frame>::PositionCache::Find(
+    Instant const& t,
+    std::vector<Position<Frame>>& positions) const {
+  Slot const& slot = slots_[SlotIndex(t)];
+  std::uint64_t const sequence =
+      slot.sequence.load(std::memory_order_acquire);
+  if (sequence == 0 || sequence % 2 == 1 || slot.time != t) {
+    return false;
+  }
+  positions.assign(slot.positions.begin(), slot.positions.end());
+  // The copy is only valid if no writer started in the meantime.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::PositionCache::Insert(
+    Instant const& t,
+    std::vector<Position<Frame>> const& positions) {
+  Slot& slot = slots_[SlotIndex(t)];
+  CHECK_EQ(slot.positions.size(), positions.size());
+  std::uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  if (sequence % 2 == 1 ||
+      !slot.sequence.compare_exchange_strong(sequence,
+                                             sequence + 1,
+                                             std::memory_order_acquire)) {
+    // Another thread is writing this slot, let it win.
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.time = t;
+  std::copy(positions.begin(), positions.end(), slot.positions.begin());
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+template<typename Frame>
+int Ephemeris<Frame>::PositionCache::SlotIndex(Instant const& t) {
+  return std::hash<double>()((t - J2000) / SIUnit<Time>()) % slots;
 }
 
 template<typename Frame>
@@ -236,6 +747,8 @@ Ephemeris<Frame>::Ephemeris(
   typename NewtonianMotionEquation::SystemState& state = problem.initial_state;
   state.time = DoublePrecision<Instant>(initial_time);
 
+  std::vector<int> const fitting_step_multiples =
+      FittingStepMultiples(bodies, initial_state, parameters_);
   for (int i = 0; i < bodies.size(); ++i) {
     auto& body = bodies[i];
     DegreesOfFreedom<Frame> const& degrees_of_freedom = initial_state[i];
@@ -243,19 +756,17 @@ Ephemeris<Frame>::Ephemeris(
     unowned_bodies_.emplace_back(body.get());
     unowned_bodies_indices_.emplace(body.get(), i);
 
-    auto const inserted = bodies_to_trajectories_.emplace(
-                              body.get(),
-                              std::make_unique<ContinuousTrajectory<Frame>>(
-                                  parameters_.step_, fitting_tolerance_));
-    CHECK(inserted.second);
-    ContinuousTrajectory<Frame>* const trajectory =
-        inserted.first->second.get();
+    auto trajectory = make_not_null_unique<ContinuousTrajectory<Frame>>(
+        fitting_step_multiples[i] * parameters_.step_,
+        fitting_tolerance_,
+        /*max_stride=*/
+        parameters_.max_fitting_step_multiple_ / fitting_step_multiples[i]);
     CHECK_OK(trajectory->Append(initial_time, degrees_of_freedom));
 
     if (body->is_oblate()) {
       // Inserting at the beginning of the vectors is O(N).
       bodies_.insert(bodies_.begin(), std::move(body));
-      trajectories_.insert(trajectories_.begin(), trajectory);
+      trajectories_.insert(trajectories_.begin(), std::move(trajectory));
       state.positions.emplace(state.positions.begin(),
                               degrees_of_freedom.position());
       state.velocities.emplace(state.velocities.begin(),
@@ -264,12 +775,22 @@ Ephemeris<Frame>::Ephemeris(
     } else {
       // Inserting at the end of the vectors is O(1).
       bodies_.push_back(std::move(body));
-      trajectories_.push_back(trajectory);
+      trajectories_.push_back(std::move(trajectory));
       state.positions.emplace_back(degrees_of_freedom.position());
       state.velocities.emplace_back(degrees_of_freedom.velocity());
       ++number_of_spherical_bodies_;
     }
   }
+  for (auto const unowned_body : unowned_bodies_) {
+    bodies_indices_.push_back(
+        std::find_if(bodies_.begin(),
+                     bodies_.end(),
+                     [unowned_body](auto const& body) {
+                       return body.get() == unowned_body;
+                     }) -
+        bodies_.begin());
+  }
+  position_cache_.emplace(bodies_.size());
 
   instance_ = parameters.integrator_->NewInstance(
       problem,
@@ -278,6 +799,14 @@ Ephemeris<Frame>::Ephemeris(
       parameters.step_);
 }
 
+template<typename Frame>
+Ephemeris<Frame>::~Ephemeris() {
+  if (rebuilder_.joinable()) {
+    rebuilder_.join();
+  }
+  StopBackgroundProlongation();
+}
+
 template<typename Frame>
 std::vector<not_null<MassiveBody const*>> const&
 Ephemeris<Frame>::bodies() const {
@@ -287,14 +816,43 @@ Ephemeris<Frame>::bodies() const {
 template<typename Frame>
 not_null<ContinuousTrajectory<Frame> const*> Ephemeris<Frame>::trajectory(
     not_null<MassiveBody const*> body) const {
-  return FindOrDie(bodies_to_trajectories_, body).get();
+  return trajectory_for_body_index(body_index(body));
+}
+
+template<typename Frame>
+int Ephemeris<Frame>::body_index(not_null<MassiveBody const*> body) const {
+  return FindOrDie(unowned_bodies_indices_, body);
+}
+
+template<typename Frame>
+not_null<ContinuousTrajectory<Frame> const*>
+Ephemeris<Frame>::trajectory_for_body_index(int const body_index) const {
+  return trajectories_[bodies_indices_[body_index]].get();
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::EvaluateAllPositions(
+    Instant const& t,
+    std::vector<Position<Frame>>& positions) const {
+  // This vector is thread-local to avoid allocating at each call.
+  thread_local std::vector<Position<Frame>> trajectories_positions;
+  if (!position_cache_->Find(t, trajectories_positions)) {
+    shared_lock_guard<ShardedSharedMutex> l(lock_);
+    EvaluateTrajectoriesPositions(t,
+                                  /*culled_bodies=*/{},
+                                  trajectories_positions);
+    position_cache_->Insert(t, trajectories_positions);
+  }
+  positions.resize(unowned_bodies_.size());
+  for (int i = 0; i < unowned_bodies_.size(); ++i) {
+    positions[i] = trajectories_positions[bodies_indices_[i]];
+  }
 }
 
 template<typename Frame>
 bool Ephemeris<Frame>::empty() const {
-  shared_lock_guard<base::shared_mutex> l(lock_);
-  for (auto const& pair : bodies_to_trajectories_) {
-    auto const& trajectory = pair.second;
+  shared_lock_guard<ShardedSharedMutex> l(lock_);
+  for (auto const& trajectory : trajectories_) {
     if (trajectory->empty()) {
       return true;
     }
@@ -304,10 +862,12 @@ bool Ephemeris<Frame>::empty() const {
 
 template<typename Frame>
 Instant Ephemeris<Frame>::t_min() const {
-  shared_lock_guard<base::shared_mutex> l(lock_);
-  Instant t_min = bodies_to_trajectories_.begin()->second->t_min();
-  for (auto const& pair : bodies_to_trajectories_) {
-    auto const& trajectory = pair.second;
+  // The checkpoints are only consistent with the trajectories under
+  // |integration_lock_|.
+  std::lock_guard<std::mutex> integration_lock(integration_lock_);
+  shared_lock_guard<ShardedSharedMutex> l(lock_);
+  Instant t_min = trajectories_.front()->t_min();
+  for (auto const& trajectory : trajectories_) {
     t_min = std::max(t_min, trajectory->t_min());
   }
   CHECK(checkpoints_.empty() ||
@@ -317,7 +877,7 @@ Instant Ephemeris<Frame>::t_min() const {
 
 template<typename Frame>
 Instant Ephemeris<Frame>::t_max() const {
-  shared_lock_guard<base::shared_mutex> l(lock_);
+  shared_lock_guard<ShardedSharedMutex> l(lock_);
   return t_max_locked();
 }
 
@@ -335,6 +895,11 @@ Status Ephemeris<Frame>::last_severe_integration_status() const {
 
 template<typename Frame>
 void Ephemeris<Frame>::ForgetBefore(Instant const& t) {
+  // The trajectories may be evaluated concurrently, e.g., by the vessels
+  // computing their predictions in the background, and prolonged, e.g., by the
+  // background prolongation.
+  std::lock_guard<std::mutex> integration_lock(integration_lock_);
+  std::lock_guard<ShardedSharedMutex> l(lock_);
   auto it = std::upper_bound(
                 checkpoints_.begin(), checkpoints_.end(), t,
                 [](Instant const& left, Checkpoint const& right) {
@@ -354,20 +919,29 @@ void Ephemeris<Frame>::ForgetBefore(Instant const& t) {
     CHECK_LT(t, it->instance->time().value);
   }
 
-  for (auto& pair : bodies_to_trajectories_) {
-    ContinuousTrajectory<Frame>& trajectory = *pair.second;
-    trajectory.ForgetBefore(t);
+  for (auto const& trajectory : trajectories_) {
+    trajectory->ForgetBefore(t);
   }
   checkpoints_.erase(checkpoints_.begin(), it);
 }
 
 template<typename Frame>
 void Ephemeris<Frame>::Prolong(Instant const& t) {
+  PRINCIPIA_PROFILE_SCOPE(EphemerisProlong);
+  // The instance time is read while holding the lock since the ephemeris may
+  // be prolonged concurrently, e.g., by the background prolongation.  The
+  // readers of the trajectories are not blocked.
+  std::lock_guard<std::mutex> l(integration_lock_);
+  ProlongLocked(t);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ProlongLocked(Instant const& t) {
   // Note that |t| may be before the last time that we integrated and still
   // after |t_max()|.  In this case we want to make sure that the integrator
   // makes progress.
   Instant t_final;
-  Instant const instance_time = this->instance_time();
+  Instant const instance_time = instance_->time().value;
   if (t <= instance_time) {
     t_final = instance_time + parameters_.step_;
   } else {
@@ -377,13 +951,220 @@ void Ephemeris<Frame>::Prolong(Instant const& t) {
   // Perform the integration.  Note that we may have to iterate until |t_max()|
   // actually reaches |t| because the last series may not be fully determined
   // after the first integration.
-  std::lock_guard<base::shared_mutex> l(lock_);
   while (t_max_locked() < t) {
     instance_->Solve(t_final);
     t_final += parameters_.step_;
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::ProlongInParallel(
+    Instant const& t,
+    ParallelProlongationParameters const& parameters) {
+  {
+    std::lock_guard<std::mutex> l(integration_lock_);
+    // Parallelism is only useful if there are several slices.
+    if (massive_bodies_scheduler_ != nullptr &&
+        t - instance_->time().value >
+            2 * parameters.fine_steps_per_slice_ * parameters_.step_) {
+      // The slices are integrated concurrently, so they must not use the tiles.
+      IntegrationProblem<NewtonianMotionEquation> problem;
+      problem.equation.compute_acceleration = [this](
+          Instant const& time,
+          std::vector<Position<Frame>> const& positions,
+          std::vector<Vector<Acceleration, Frame>>& accelerations) {
+        ComputeMassiveBodiesGravitationalAccelerationsSerially(positions,
+                                                               accelerations);
+        return Status::OK;
+      };
+      problem.initial_state = instance_->state();
+
+      std::vector<Length> const length_integration_tolerances(
+          bodies_.size(), parameters.length_integration_tolerance_);
+      std::vector<Speed> const speed_integration_tolerances(
+          bodies_.size(), parameters.speed_integration_tolerance_);
+      Parareal<NewtonianMotionEquation> const parareal(
+          typename Parareal<NewtonianMotionEquation>::Parameters(
+              *parameters.coarse_integrator_,
+              parameters.coarse_steps_per_slice_,
+              *parameters_.integrator_,
+              parameters_.step_,
+              parameters.fine_steps_per_slice_,
+              parameters.max_iterations_),
+          std::bind(&Ephemeris::ToleranceToErrorRatio,
+                    std::cref(length_integration_tolerances),
+                    std::cref(speed_integration_tolerances),
+                    parameters_.step_,
+                    _1));
+
+      // The states that precede the final one, which are given to the
+      // sequential integrator so that it doesn't have to go through its
+      // startup again.
+      int const history_size = parameters_.integrator_->history_size();
+      std::deque<typename NewtonianMotionEquation::SystemState> history;
+      typename NewtonianMotionEquation::SystemState final_state;
+      Status const status = parareal.Solve(
+          problem,
+          t,
+          /*append_state=*/[this, &history, history_size](
+              typename NewtonianMotionEquation::SystemState const& state) {
+            AppendMassiveBodiesStateToTrajectories(state);
+            history.push_back(state);
+            if (static_cast<int>(history.size()) > history_size + 1) {
+              history.pop_front();
+            }
+          },
+          final_state,
+          massive_bodies_scheduler_);
+      if (status.ok()) {
+        // Restart the integration from the end of the parallel one.
+        problem.equation.compute_acceleration = [this](
+            Instant const& time,
+            std::vector<Position<Frame>> const& positions,
+            std::vector<Vector<Acceleration, Frame>>& accelerations) {
+          ComputeMassiveBodiesGravitationalAccelerations(time,
+                                                         positions,
+                                                         accelerations);
+          return Status::OK;
+        };
+        problem.initial_state = final_state;
+        CHECK(!history.empty());
+        history.pop_back();
+        instance_ = parameters_.integrator_->NewInstanceWithHistory(
+            problem,
+            std::vector<typename NewtonianMotionEquation::SystemState>(
+                history.begin(), history.end()),
+            /*append_state=*/std::bind(
+                &Ephemeris::AppendMassiveBodiesState, this, _1),
+            parameters_.step_);
+        checkpoints_.push_back(GetCheckpoint());
+      } else {
+        LOG(WARNING) << "Parallel prolongation to " << t
+                     << " failed, prolonging sequentially: " << status;
+      }
+    }
+  }
+  // Complete the last series, or do the entire integration if the parallel
+  // one failed.
+  Prolong(t);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::StartBackgroundProlongation(Time const& horizon) {
+  CHECK_LE(Time(), horizon);
+  {
+    std::lock_guard<std::mutex> l(prolongator_lock_);
+    prolongation_horizon_ = horizon;
+  }
+  if (!prolongator_.joinable()) {
+    prolongator_ = std::thread(&Ephemeris::RepeatedlyProlong, this);
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::StopBackgroundProlongation() {
+  if (prolongator_.joinable()) {
+    {
+      std::lock_guard<std::mutex> l(prolongator_lock_);
+      prolongator_shutdown_ = true;
+    }
+    prolongator_has_request_or_shutdown_.notify_one();
+    prolongator_.join();
+    std::lock_guard<std::mutex> l(prolongator_lock_);
+    prolongator_shutdown_ = false;
+    prolongation_target_.reset();
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::RequestProlongation(Instant const& t) {
+  if (!prolongator_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(prolongator_lock_);
+    Instant const target = t + prolongation_horizon_;
+    if (prolongation_target_.has_value() && *prolongation_target_ >= target) {
+      return;
+    }
+    prolongation_target_ = target;
+  }
+  prolongator_has_request_or_shutdown_.notify_one();
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::SetMassiveBodiesScheduler(
+    WorkStealingScheduler* const scheduler) {
+  std::lock_guard<std::mutex> l(integration_lock_);
+  massive_bodies_scheduler_ = scheduler;
+  if (scheduler == nullptr || !tiles_.empty()) {
+    return;
+  }
+
+  std::size_t const number_of_bodies = bodies_.size();
+  μ_.clear();
+  for (auto const& body : bodies_) {
+    μ_.push_back(body->gravitational_parameter());
+  }
+  q_.resize(number_of_bodies);
+
+  // Split the rows of the spherical bodies so that the tiles have roughly the
+  // same number of pairs.  The tiling only depends on the number of bodies, so
+  // that the order of the operations, and therefore the result, doesn't depend
+  // on the scheduler.
+  std::int64_t const s = number_of_spherical_bodies_;
+  std::int64_t const number_of_pairs = s * (s - 1) / 2;
+  std::int64_t const number_of_tiles =
+      std::min(max_tiles,
+               std::max<std::int64_t>(1, number_of_pairs / min_pairs_per_tile));
+  std::size_t b1 = number_of_oblate_bodies_;
+  std::int64_t pairs_so_far = 0;
+  for (std::int64_t i = 0; i < number_of_tiles; ++i) {
+    SphericalBodiesTile tile;
+    tile.b1_begin = b1;
+    std::int64_t const pairs_at_end_of_tile =
+        number_of_pairs * (i + 1) / number_of_tiles;
+    while (b1 < number_of_bodies &&
+           (pairs_so_far < pairs_at_end_of_tile || i == number_of_tiles - 1)) {
+      pairs_so_far += number_of_bodies - 1 - b1;
+      ++b1;
+    }
+    tile.b1_end = b1;
+    tiles_.push_back(std::move(tile));
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::SetMassiveBodiesTreeEvaluation(bool const enabled) {
+  std::lock_guard<std::mutex> l(integration_lock_);
+  if (!enabled || number_of_spherical_bodies_ == 0) {
+    tree_.reset();
+    return;
+  }
+  if (tree_.has_value()) {
+    return;
+  }
+
+  std::vector<GravitationalParameter> gravitational_parameters;
+  for (std::size_t b = number_of_oblate_bodies_; b < bodies_.size(); ++b) {
+    gravitational_parameters.push_back(bodies_[b]->gravitational_parameter());
+  }
+  // An error δa on the acceleration moves a body by about δa h² over a step of
+  // length h.  Each of the other bodies may be in a distinct approximated
+  // cell, hence the division of the budget.
+  Acceleration const cell_tolerance =
+      fitting_tolerance_ /
+      (parameters_.step_ * parameters_.step_ * number_of_spherical_bodies_);
+  tree_.emplace(std::move(gravitational_parameters), cell_tolerance);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::SetMasslessBodiesCullingThreshold(
+    double const threshold) {
+  CHECK_LE(0, threshold);
+  massless_bodies_culling_threshold_ = threshold;
+}
+
 template<typename Frame>
 not_null<std::unique_ptr<typename Integrator<
     typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>
@@ -391,15 +1172,76 @@ Ephemeris<Frame>::NewInstance(
     std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
     IntrinsicAccelerations const& intrinsic_accelerations,
     FixedStepParameters const& parameters) {
+  return MakeInstance(trajectories,
+                      intrinsic_accelerations,
+                      parameters,
+                      /*history=*/{});
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<typename Integrator<
+    typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>
+Ephemeris<Frame>::NewInstanceWithHistory(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    FixedStepParameters const& parameters) {
+  CHECK(!trajectories.empty());
+  int const history_size = parameters.history_size();
+  std::vector<typename NewtonianMotionEquation::SystemState> history(
+      history_size);
+  for (auto const& trajectory : trajectories) {
+    // Walk backwards from the point preceding the last one.
+    auto it = trajectory->last();
+    for (int i = history_size - 1; i >= 0; --i) {
+      if (it == trajectory->Begin()) {
+        // Not enough points, go through the startup.
+        history.clear();
+        break;
+      }
+      --it;
+      auto& state = history[i];
+      if (trajectory == trajectories.front()) {
+        state.time = DoublePrecision<Instant>(it.time());
+      } else {
+        CHECK_EQ(state.time.value, it.time());
+      }
+      state.positions.emplace_back(it.degrees_of_freedom().position());
+      state.velocities.emplace_back(it.degrees_of_freedom().velocity());
+    }
+    if (history.empty()) {
+      break;
+    }
+  }
+  return MakeInstance(
+      trajectories, intrinsic_accelerations, parameters, history);
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<typename Integrator<
+    typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>
+Ephemeris<Frame>::MakeInstance(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    FixedStepParameters const& parameters,
+    std::vector<typename NewtonianMotionEquation::SystemState> const&
+        history) {
   IntegrationProblem<NewtonianMotionEquation> problem;
 
-  problem.equation.compute_acceleration = [this, intrinsic_accelerations](
+  // Shared by the equation and |append_state|, which outlive this function.
+  auto const culling = std::make_shared<MasslessBodiesCulling>(
+      massless_bodies_culling_threshold_);
+  problem.equation.compute_acceleration = [
+      this,
+      culling,
+      intrinsic_accelerations =
+          EffectiveIntrinsicAccelerations(intrinsic_accelerations)](
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
       std::vector<Vector<Acceleration, Frame>>& accelerations) {
     if (ComputeMasslessBodiesTotalAccelerations(intrinsic_accelerations,
                                                 t,
                                                 positions,
+                                                culling->culled_bodies(t),
                                                 accelerations)) {
       return Status::OK;
     } else {
@@ -420,15 +1262,19 @@ Ephemeris<Frame>::NewInstance(
         last_degrees_of_freedom.velocity());
   }
 
-  auto const append_state =
-      std::bind(&Ephemeris::AppendMasslessBodiesState, _1, trajectories);
+  auto const append_state = [this, culling, trajectories](
+      typename NewtonianMotionEquation::SystemState const& state) {
+    AppendMasslessBodiesState(state, trajectories);
+    UpdateMasslessBodiesCulling(state, *culling);
+  };
 
   // The construction of the instance may evaluate the degrees of freedom of the
   // bodies.
   Prolong(trajectory_last_time + parameters.step_);
+  UpdateMasslessBodiesCulling(problem.initial_state, *culling);
 
-  return parameters.integrator_->NewInstance(
-      problem, append_state, parameters.step_);
+  return parameters.integrator_->NewInstanceWithHistory(
+      problem, history, append_state, parameters.step_);
 }
 
 template<typename Frame>
@@ -439,113 +1285,112 @@ Status Ephemeris<Frame>::FlowWithAdaptiveStep(
     AdaptiveStepParameters const& parameters,
     std::int64_t const max_ephemeris_steps,
     bool const last_point_only) {
-  Instant const& trajectory_last_time = trajectory->last().time();
-  if (trajectory_last_time == t) {
-    return Status::OK;
-  }
+  return FlowManyWithAdaptiveStep({trajectory},
+                                  {std::move(intrinsic_acceleration)},
+                                  t,
+                                  {parameters},
+                                  max_ephemeris_steps,
+                                  last_point_only);
+}
 
-  std::vector<not_null<DiscreteTrajectory<Frame>*>> const trajectories =
-      {trajectory};
-  std::vector<IntrinsicAcceleration> const intrinsic_accelerations =
-      {std::move(intrinsic_acceleration)};
-  // The |min| is here to prevent us from spending too much time computing the
-  // ephemeris.  The |max| is here to ensure that we always try to integrate
-  // forward.  We use |last_state_.time.value| because this is always finite,
-  // contrary to |t_max()|, which is -∞ when |empty()|.
-  Instant const t_final =
-      std::min(std::max(instance_time() +
-                            max_ephemeris_steps * parameters_.step(),
-                        trajectory_last_time + parameters_.step()),
-               t);
-  Prolong(t_final);
+template<typename Frame>
+Status Ephemeris<Frame>::FlowWithAdaptiveStepBefore(
+    not_null<DiscreteTrajectory<Frame>*> const trajectory,
+    IntrinsicAcceleration intrinsic_acceleration,
+    Instant const& t,
+    AdaptiveStepParameters const& parameters,
+    std::int64_t const max_ephemeris_steps,
+    std::chrono::steady_clock::time_point const& deadline) {
+  return FlowManyWithAdaptiveStepBefore({trajectory},
+                                        {std::move(intrinsic_acceleration)},
+                                        t,
+                                        {parameters},
+                                        max_ephemeris_steps,
+                                        /*last_point_only=*/false,
+                                        deadline);
+}
 
-  IntegrationProblem<NewtonianMotionEquation> problem;
-  problem.equation.compute_acceleration = [this, &intrinsic_accelerations](
-      Instant const& t,
-      std::vector<Position<Frame>> const& positions,
-      std::vector<Vector<Acceleration, Frame>>& accelerations) {
-    if (ComputeMasslessBodiesTotalAccelerations(intrinsic_accelerations,
-                                                t,
-                                                positions,
-                                                accelerations)) {
-      return Status::OK;
-    } else {
-      return Status(Error::OUT_OF_RANGE, "Collision detected");
-    }
-  };
+template<typename Frame>
+Status Ephemeris<Frame>::FlowManyWithAdaptiveStep(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    Instant const& t,
+    std::vector<AdaptiveStepParameters> const& parameters,
+    std::int64_t const max_ephemeris_steps,
+    bool const last_point_only) {
+  return FlowManyWithAdaptiveStepBefore(trajectories,
+                                        intrinsic_accelerations,
+                                        t,
+                                        parameters,
+                                        max_ephemeris_steps,
+                                        last_point_only,
+                                        /*deadline=*/std::nullopt);
+}
 
-  auto const trajectory_last = trajectory->last();
-  auto const last_degrees_of_freedom = trajectory_last.degrees_of_freedom();
-  problem.initial_state = {{last_degrees_of_freedom.position()},
-                           {last_degrees_of_freedom.velocity()},
-                           trajectory_last.time()};
-
-  typename AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::Parameters const
-      integrator_parameters(
-          /*first_time_step=*/t_final - problem.initial_state.time.value,
-          /*safety_factor=*/0.9,
-          parameters.max_steps_,
-          /*last_step_is_exact=*/true);
-  CHECK_GT(integrator_parameters.first_time_step, 0 * Second)
-      << "Flow back to the future: " << t_final
-      << " <= " << problem.initial_state.time.value;
-  auto const tolerance_to_error_ratio =
-      std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
-                std::cref(parameters.length_integration_tolerance_),
-                std::cref(parameters.speed_integration_tolerance_),
-                _1, _2);
+template<typename Frame>
+std::vector<Status> Ephemeris<Frame>::FlowIndependentlyWithAdaptiveStep(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    Instant const& t,
+    std::vector<AdaptiveStepParameters> const& parameters,
+    std::int64_t const max_ephemeris_steps,
+    bool const last_point_only,
+    not_null<WorkStealingScheduler*> const scheduler) {
+  CHECK(intrinsic_accelerations.empty() ||
+        intrinsic_accelerations.size() == trajectories.size());
+  CHECK_EQ(trajectories.size(), parameters.size());
+  std::vector<Status> statuses(trajectories.size());
+  if (trajectories.empty()) {
+    return statuses;
+  }
 
-  typename AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::AppendState
-      append_state;
-  typename NewtonianMotionEquation::SystemState last_state;
-  if (last_point_only) {
-    append_state = [&last_state](
-        typename NewtonianMotionEquation::SystemState const& state) {
-      last_state = state;
-    };
-  } else {
-    append_state = std::bind(
-        &Ephemeris::AppendMasslessBodiesState, _1, std::cref(trajectories));
+  // Prolong the ephemeris once on this thread, rather than have the flows
+  // wait for one another on |integration_lock_|.
+  if (max_ephemeris_steps == unlimited_max_ephemeris_steps &&
+      t < astronomy::InfiniteFuture &&
+      (empty() || t > t_max())) {
+    Prolong(t);
   }
 
-  auto const instance =
-      parameters.integrator_->NewInstance(problem,
-                                          append_state,
-                                          tolerance_to_error_ratio,
-                                          integrator_parameters);
-  auto status = instance->Solve(t_final);
+  auto const flow = [this,
+                     &intrinsic_accelerations,
+                     last_point_only,
+                     max_ephemeris_steps,
+                     &parameters,
+                     &statuses,
+                     &t,
+                     &trajectories](std::size_t const i) {
+    statuses[i] = FlowWithAdaptiveStep(
+        trajectories[i],
+        intrinsic_accelerations.empty() ? NoIntrinsicAcceleration
+                                        : intrinsic_accelerations[i],
+        t,
+        parameters[i],
+        max_ephemeris_steps,
+        last_point_only);
+  };
 
-  // We probably don't care if the vessel gets too close to the singularity, as
-  // we only use this integrator for the future.  So we swallow the error.
-  // TODO(phl): Is this the right thing to do long term?
-  if (status.error() == Error::OUT_OF_RANGE) {
-    status = Status::OK;
+  // The first trajectory is integrated on this thread while the scheduler
+  // takes care of the others.
+  std::vector<Future<void>> futures;
+  futures.reserve(trajectories.size() - 1);
+  for (std::size_t i = 1; i < trajectories.size(); ++i) {
+    futures.push_back(scheduler->Add([&flow, i]() { flow(i); }));
   }
+  flow(0);
+  for (auto const& future : futures) {
+    future.wait();
+  }
+  return statuses;
+}
 
-  if (last_point_only) {
-    AppendMasslessBodiesState(last_state, trajectories);
-  }
-
-  // TODO(egg): when we have events in trajectories, we should add a singularity
-  // event at the end if the outcome indicates a singularity
-  // (|VanishingStepSize|).  We should not have an event on the trajectory if
-  // |ReachedMaximalStepCount|, since that is not a physical property, but
-  // rather a self-imposed constraint.
-  if (!status.ok() || t_final == t) {
-    return status;
-  } else {
-    return Status(Error::DEADLINE_EXCEEDED,
-                  "Couldn't reach " + DebugString(t_final) + ", stopping at " +
-                      DebugString(t));
-  }
-}
-
-template<typename Frame>
-Status Ephemeris<Frame>::FlowWithFixedStep(
-    Instant const& t,
-    typename Integrator<NewtonianMotionEquation>::Instance& instance) {
-  if (empty() || t > t_max()) {
-    Prolong(t);
+template<typename Frame>
+Status Ephemeris<Frame>::FlowWithFixedStep(
+    Instant const& t,
+    typename Integrator<NewtonianMotionEquation>::Instance& instance) {
+  PRINCIPIA_PROFILE_SCOPE(EphemerisFlowWithFixedStep);
+  if (empty() || t > t_max()) {
+    Prolong(t);
   }
 
   return instance.Solve(t);
@@ -557,7 +1402,10 @@ ComputeGravitationalAccelerationOnMasslessBody(
     Position<Frame> const& position,
     Instant const& t) const {
   std::vector<Vector<Acceleration, Frame>> accelerations(1);
-  ComputeMasslessBodiesGravitationalAccelerations(t, {position}, accelerations);
+  ComputeMasslessBodiesGravitationalAccelerations(t,
+                                                  {position},
+                                                  /*culled_bodies=*/{},
+                                                  accelerations);
 
   return accelerations[0];
 }
@@ -677,12 +1525,13 @@ void Ephemeris<Frame>::ComputeApsides(not_null<MassiveBody const*> const body1,
             Sign(*previous_squared_distance_derivative)) {
       CHECK(previous_time);
 
-      // The derivative of |squared_distance| changed sign.  Find its zero by
-      // bisection, this is the time of the apsis.  Then compute the apsis and
-      // append it to one of the output trajectories.
-      Instant const apsis_time = Bisect(evaluate_square_distance_derivative,
-                                        *previous_time,
-                                        time);
+      // The derivative of |squared_distance| changed sign.  Find its zero,
+      // this is the time of the apsis.  Then compute the apsis and append it
+      // to one of the output trajectories.
+      Instant const apsis_time =
+          RegulaFalsi(evaluate_square_distance_derivative,
+                      *previous_time,
+                      time);
       DegreesOfFreedom<Frame> const apsis1_degrees_of_freedom =
           body1_trajectory->EvaluateDegreesOfFreedom(apsis_time);
       DegreesOfFreedom<Frame> const apsis2_degrees_of_freedom =
@@ -701,10 +1550,226 @@ void Ephemeris<Frame>::ComputeApsides(not_null<MassiveBody const*> const body1,
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::ComputeApsides(
+    std::vector<ApsidesComputation> const& computations,
+    not_null<WorkStealingScheduler*> const scheduler) {
+  // An apsis found in the interval between the samples |interval| and
+  // |interval + 1|.
+  struct Apsis {
+    std::int64_t interval;
+    bool is_apoapsis;
+    Instant time;
+    DegreesOfFreedom<Frame> degrees_of_freedom1;
+    DegreesOfFreedom<Frame> degrees_of_freedom2;
+  };
+  constexpr std::int64_t min_samples_per_chunk = 100;
+
+  std::int64_t const number_of_pairs = computations.size();
+  Instant const t_min = this->t_min();
+  Instant const t_max = this->t_max();
+  Time const step = parameters_.step();
+  if (number_of_pairs == 0 || t_max < t_min) {
+    return;
+  }
+  std::int64_t const number_of_samples =
+      static_cast<std::int64_t>(std::floor((t_max - t_min) / step)) + 1;
+  auto const sample_time = [step, t_min](std::int64_t const k) {
+    return t_min + k * step;
+  };
+
+  std::vector<int> indices1;
+  std::vector<int> indices2;
+  std::vector<not_null<ContinuousTrajectory<Frame> const*>> trajectories1;
+  std::vector<not_null<ContinuousTrajectory<Frame> const*>> trajectories2;
+  for (auto const& computation : computations) {
+    indices1.push_back(body_index(computation.body1));
+    indices2.push_back(body_index(computation.body2));
+    trajectories1.push_back(trajectory_for_body_index(indices1.back()));
+    trajectories2.push_back(trajectory_for_body_index(indices2.back()));
+  }
+
+  // The derivative of the squared distance between the bodies of the pair
+  // |p| at time |t|.
+  auto const squared_distance_derivative =
+      [&trajectories1, &trajectories2](
+          std::int64_t const p,
+          Instant const& t) -> Variation<Square<Length>> {
+    RelativeDegreesOfFreedom<Frame> const relative =
+        trajectories1[p]->EvaluateDegreesOfFreedom(t) -
+        trajectories2[p]->EvaluateDegreesOfFreedom(t);
+    return 2.0 * InnerProduct(relative.displacement(), relative.velocity());
+  };
+
+  // The chunk |[k_begin, k_end[| looks for extrema of the squared distances at
+  // these samples, which requires the squared distances at the samples on
+  // either side.  At the ends of the sampling, the signs of the differences of
+  // squared distances are extended by those of the derivatives, so that an
+  // apsis in the first or last interval is not missed.
+  auto const compute_chunk = [&indices1,
+                              &indices2,
+                              &trajectories1,
+                              &trajectories2,
+                              &sample_time,
+                              &squared_distance_derivative,
+                              number_of_pairs,
+                              number_of_samples,
+                              this](std::int64_t const k_begin,
+                                    std::int64_t const k_end,
+                                    std::vector<std::vector<Apsis>>& apsides) {
+    std::int64_t const sample_begin = std::max<std::int64_t>(k_begin - 1, 0);
+    std::int64_t const sample_end =
+        std::min<std::int64_t>(k_end + 1, number_of_samples);
+    std::int64_t const samples = sample_end - sample_begin;
+
+    // The squared distances, sample-major, so that the loop over the pairs
+    // reads and writes contiguous memory.
+    std::vector<Square<Length>> squared_distances(samples * number_of_pairs);
+    std::vector<Position<Frame>> positions;
+    for (std::int64_t s = 0; s < samples; ++s) {
+      EvaluateAllPositions(sample_time(sample_begin + s), positions);
+      Square<Length>* const row = &squared_distances[s * number_of_pairs];
+      for (std::int64_t p = 0; p < number_of_pairs; ++p) {
+        row[p] = (positions[indices1[p]] - positions[indices2[p]]).Norm²();
+      }
+    }
+    auto const squared_distance = [&squared_distances,
+                                   number_of_pairs,
+                                   sample_begin](std::int64_t const k,
+                                                 std::int64_t const p) {
+      return squared_distances[(k - sample_begin) * number_of_pairs + p];
+    };
+
+    apsides.resize(number_of_pairs);
+    for (std::int64_t p = 0; p < number_of_pairs; ++p) {
+      // The sign of the variation of the squared distance over the interval
+      // |j|, or of its derivative at the ends of the sampling.
+      auto const variation_sign = [&squared_distance,
+                                   &squared_distance_derivative,
+                                   &sample_time,
+                                   number_of_samples,
+                                   p](std::int64_t const j) {
+        if (j < 0) {
+          return Sign(squared_distance_derivative(p, sample_time(0)));
+        } else if (j >= number_of_samples - 1) {
+          return Sign(squared_distance_derivative(
+              p, sample_time(number_of_samples - 1)));
+        } else {
+          return Sign(squared_distance(j + 1, p) - squared_distance(j, p));
+        }
+      };
+
+      std::int64_t last_interval = -1;
+      // Looks for a change of sign of the derivative in the interval |i| and,
+      // if there is one, appends the apsis that it contains.
+      auto const refine = [&apsides,
+                           &last_interval,
+                           &sample_time,
+                           &squared_distance_derivative,
+                           &trajectories1,
+                           &trajectories2,
+                           number_of_samples,
+                           p](std::int64_t const i) {
+        if (i < 0 || i >= number_of_samples - 1 || i <= last_interval) {
+          return;
+        }
+        last_interval = i;
+        Instant const lower_time = sample_time(i);
+        Instant const upper_time = sample_time(i + 1);
+        auto const upper_derivative =
+            squared_distance_derivative(p, upper_time);
+        if (Sign(upper_derivative) ==
+            Sign(squared_distance_derivative(p, lower_time))) {
+          return;
+        }
+        Instant const apsis_time = RegulaFalsi(
+            [&squared_distance_derivative, p](Instant const& t) {
+              return squared_distance_derivative(p, t);
+            },
+            lower_time,
+            upper_time);
+        apsides[p].push_back(
+            {i,
+             /*is_apoapsis=*/Sign(upper_derivative).Negative(),
+             apsis_time,
+             trajectories1[p]->EvaluateDegreesOfFreedom(apsis_time),
+             trajectories2[p]->EvaluateDegreesOfFreedom(apsis_time)});
+      };
+
+      auto previous_sign = variation_sign(k_begin - 1);
+      for (std::int64_t k = k_begin; k < k_end; ++k) {
+        auto const sign = variation_sign(k);
+        if (sign != previous_sign) {
+          // The squared distance has an extremum near sample |k|.
+          refine(k - 1);
+          refine(k);
+        }
+        previous_sign = sign;
+      }
+    }
+  };
+
+  std::int64_t const max_chunks = scheduler->pool_size() + 1;
+  std::int64_t const samples_per_chunk =
+      std::max(min_samples_per_chunk,
+               (number_of_samples + max_chunks - 1) / max_chunks);
+  std::int64_t const chunks =
+      (number_of_samples + samples_per_chunk - 1) / samples_per_chunk;
+  std::vector<std::vector<std::vector<Apsis>>> apsides(chunks);
+  auto const compute_chunk_at = [&apsides,
+                                 &compute_chunk,
+                                 number_of_samples,
+                                 samples_per_chunk](std::int64_t const c) {
+    compute_chunk(
+        c * samples_per_chunk,
+        std::min(number_of_samples, (c + 1) * samples_per_chunk),
+        apsides[c]);
+  };
+
+  // The first chunk is processed on this thread while the scheduler takes care
+  // of the others.
+  std::vector<Future<void>> futures;
+  futures.reserve(chunks - 1);
+  for (std::int64_t c = 1; c < chunks; ++c) {
+    futures.push_back(
+        scheduler->Add([&compute_chunk_at, c]() { compute_chunk_at(c); }));
+  }
+  compute_chunk_at(0);
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  // Consecutive chunks may find the apsis of the interval at their boundary;
+  // it is only appended once.
+  for (std::int64_t p = 0; p < number_of_pairs; ++p) {
+    auto const& computation = computations[p];
+    std::int64_t last_interval = -1;
+    for (auto const& chunk_apsides : apsides) {
+      for (Apsis const& apsis : chunk_apsides[p]) {
+        if (apsis.interval <= last_interval) {
+          continue;
+        }
+        last_interval = apsis.interval;
+        if (apsis.is_apoapsis) {
+          computation.apoapsides1->Append(apsis.time,
+                                          apsis.degrees_of_freedom1);
+          computation.apoapsides2->Append(apsis.time,
+                                          apsis.degrees_of_freedom2);
+        } else {
+          computation.periapsides1->Append(apsis.time,
+                                           apsis.degrees_of_freedom1);
+          computation.periapsides2->Append(apsis.time,
+                                           apsis.degrees_of_freedom2);
+        }
+      }
+    }
+  }
+}
+
 template<typename Frame>
 int Ephemeris<Frame>::serialization_index_for_body(
     not_null<MassiveBody const*> const body) const {
-  return FindOrDie(unowned_bodies_indices_, body);
+  return body_index(body);
 }
 
 template<typename Frame>
@@ -713,10 +1778,140 @@ not_null<MassiveBody const*> Ephemeris<Frame>::body_for_serialization_index(
   return unowned_bodies_[serialization_index];
 }
 
+template<typename Frame>
+not_null<std::unique_ptr<Ephemeris<Frame>>> Ephemeris<Frame>::Fork(
+    Instant const& t,
+    FixedStepParameters const& parameters) const {
+  CHECK_LE(t_min(), t);
+  CHECK_GE(t_max(), t);
+  // The bodies are copied through their serialization, and given in the order
+  // of construction, so that the fork orders its trajectories like ours.
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<Frame>> initial_state;
+  for (int i = 0; i < unowned_bodies_.size(); ++i) {
+    serialization::MassiveBody message;
+    unowned_bodies_[i]->WriteToMessage(&message);
+    bodies.push_back(MassiveBody::ReadFromMessage(message));
+    initial_state.push_back(
+        trajectory_for_body_index(i)->EvaluateDegreesOfFreedom(t));
+  }
+  auto fork = make_not_null_unique<Ephemeris<Frame>>(std::move(bodies),
+                                                     initial_state,
+                                                     t,
+                                                     fitting_tolerance_,
+                                                     parameters);
+  for (int i = 0; i < trajectories_.size(); ++i) {
+    fork->trajectories_[i]->SetPrefix(trajectories_[i].get());
+  }
+  return fork;
+}
+
+template<typename Frame>
+std::uint64_t Ephemeris<Frame>::Fingerprint() const {
+  // The bodies and the parameters don't change after construction, so there
+  // is no need to lock.  The message lacks the required fields that describe
+  // the state, hence the partial serialization.
+  serialization::Ephemeris message;
+  for (auto const& unowned_body : unowned_bodies_) {
+    unowned_body->WriteToMessage(message.add_body());
+  }
+  parameters_.WriteToMessage(message.mutable_fixed_step_parameters());
+  fitting_tolerance_.WriteToMessage(message.mutable_fitting_tolerance());
+  std::string const serialized = message.SerializePartialAsString();
+  return Fingerprint2011(serialized.data(), serialized.size());
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::WriteToMessage(
     not_null<serialization::Ephemeris*> const message) const {
   LOG(INFO) << __FUNCTION__;
+  WriteToMessage(
+      message,
+      [message](
+          ContinuousTrajectory<Frame> const& trajectory,
+          typename ContinuousTrajectory<Frame>::Checkpoint const* const
+              checkpoint) {
+        if (checkpoint == nullptr) {
+          trajectory.WriteToMessage(message->add_trajectory());
+        } else {
+          trajectory.WriteToMessage(message->add_trajectory(), *checkpoint);
+        }
+      });
+  LOG(INFO) << NAMED(message->SpaceUsed());
+  LOG(INFO) << NAMED(message->ByteSize());
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<Ephemeris<Frame>>> Ephemeris<Frame>::ReadFromMessage(
+    serialization::Ephemeris const& message) {
+  int index = 0;
+  return ReadFromMessage(message, [&message, &index]() {
+    return ContinuousTrajectory<Frame>::ReadFromMessage(
+        message.trajectory(index++));
+  });
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::WriteToSnapshot(
+    not_null<std::vector<std::uint8_t>*> const bytes) const {
+  LOG(INFO) << __FUNCTION__;
+  std::vector<std::uint8_t> trajectories_bytes;
+  SnapshotWriter trajectories_writer(&trajectories_bytes);
+  // The bodies and the checkpointed instance are allocated on an arena, which
+  // is dropped in one go once the message has been serialized.
+  google::protobuf::Arena arena;
+  not_null<serialization::Ephemeris*> const message =
+      google::protobuf::Arena::CreateMessage<serialization::Ephemeris>(&arena);
+  WriteToMessage(
+      message,
+      [&trajectories_writer](
+          ContinuousTrajectory<Frame> const& trajectory,
+          typename ContinuousTrajectory<Frame>::Checkpoint const* const
+              checkpoint) {
+        if (checkpoint == nullptr) {
+          trajectory.WriteToSnapshot(trajectories_writer);
+        } else {
+          trajectory.WriteToSnapshot(trajectories_writer, *checkpoint);
+        }
+      });
+  auto const serialized_message = SerializeAsBytes(*message);
+
+  SnapshotWriter writer(bytes);
+  writer.Write(snapshot_magic);
+  writer.Write(snapshot_version);
+  writer.Write<std::int64_t>(serialized_message.size);
+  writer.WriteBytes(serialized_message.get());
+  writer.WriteBytes(Array<std::uint8_t const>(trajectories_bytes.data(),
+                                              trajectories_bytes.size()));
+  LOG(INFO) << NAMED(bytes->size());
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<Ephemeris<Frame>>> Ephemeris<Frame>::ReadFromSnapshot(
+    Array<std::uint8_t const> const bytes) {
+  SnapshotReader reader(bytes);
+  CHECK_EQ(snapshot_magic, reader.Read<std::uint32_t>())
+      << "Not an ephemeris snapshot";
+  CHECK_EQ(snapshot_version, reader.Read<std::uint32_t>())
+      << "Unsupported ephemeris snapshot version";
+  auto const message_size = reader.Read<std::int64_t>();
+  google::protobuf::Arena arena;
+  auto const message = ParseFromBytes<serialization::Ephemeris>(
+      reader.ReadBytes(message_size), &arena);
+  auto ephemeris = ReadFromMessage(*message, [&reader]() {
+    return ContinuousTrajectory<Frame>::ReadFromSnapshot(reader);
+  });
+  CHECK_EQ(0, reader.remaining()) << "Trailing bytes in ephemeris snapshot";
+  return ephemeris;
+}
+
+template<typename Frame>
+template<typename WriteTrajectory>
+void Ephemeris<Frame>::WriteToMessage(
+    not_null<serialization::Ephemeris*> const message,
+    WriteTrajectory const& write_trajectory) const {
+  // The checkpoints and the trajectories must not change under our feet.
+  std::lock_guard<std::mutex> l(integration_lock_);
   // The bodies are serialized in the order in which they were given at
   // construction.
   for (auto const& unowned_body : unowned_bodies_) {
@@ -726,29 +1921,51 @@ void Ephemeris<Frame>::WriteToMessage(
   // between oblate and spherical bodies.
   if (checkpoints_.empty()) {
     for (auto const& trajectory : trajectories_) {
-      trajectory->WriteToMessage(message->add_trajectory());
+      write_trajectory(*trajectory, /*checkpoint=*/nullptr);
     }
     instance_->WriteToMessage(message->mutable_instance());
   } else {
     auto const& checkpoints = checkpoints_.front().checkpoints;
     CHECK_EQ(trajectories_.size(), checkpoints.size());
     for (int i = 0; i < trajectories_.size(); ++i) {
-      trajectories_[i]->WriteToMessage(message->add_trajectory(),
-                                       checkpoints[i]);
+      write_trajectory(*trajectories_[i], &checkpoints[i]);
     }
     checkpoints_.front().instance->WriteToMessage(
         message->mutable_instance());
     t_max().WriteToMessage(message->mutable_t_max());
+    // The later checkpoints are written without their polynomials, so that the
+    // stretches between them may be recomputed concurrently when reading.  A
+    // checkpoint taken before some trajectory had a polynomial is skipped, the
+    // stretches around it are merged.
+    for (int c = 1; c < checkpoints_.size(); ++c) {
+      auto const& checkpoint = checkpoints_[c];
+      if (!std::all_of(checkpoint.checkpoints.begin(),
+                       checkpoint.checkpoints.end(),
+                       [](auto const& trajectory_checkpoint) {
+                         return trajectory_checkpoint.IsAfter(
+                             astronomy::InfinitePast);
+                       })) {
+        continue;
+      }
+      auto* const checkpoint_message = message->add_checkpoint();
+      checkpoint.instance->WriteToMessage(
+          checkpoint_message->mutable_instance());
+      for (int i = 0; i < trajectories_.size(); ++i) {
+        trajectories_[i]->WriteCheckpointToMessage(
+            checkpoint_message->add_trajectory(),
+            checkpoint.checkpoints[i]);
+      }
+    }
   }
   parameters_.WriteToMessage(message->mutable_fixed_step_parameters());
   fitting_tolerance_.WriteToMessage(message->mutable_fitting_tolerance());
-  LOG(INFO) << NAMED(message->SpaceUsed());
-  LOG(INFO) << NAMED(message->ByteSize());
 }
 
 template<typename Frame>
+template<typename ReadTrajectory>
 not_null<std::unique_ptr<Ephemeris<Frame>>> Ephemeris<Frame>::ReadFromMessage(
-    serialization::Ephemeris const& message) {
+    serialization::Ephemeris const& message,
+    ReadTrajectory const& read_trajectory) {
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
   for (auto const& body : message.body()) {
     bodies.push_back(MassiveBody::ReadFromMessage(body));
@@ -790,22 +2007,19 @@ not_null<std::unique_ptr<Ephemeris<Frame>>> Ephemeris<Frame>::ReadFromMessage(
           /*append_state=*/std::bind(
               &Ephemeris::AppendMassiveBodiesState, ephemeris.get(), _1));
 
-  int index = 0;
-  ephemeris->bodies_to_trajectories_.clear();
+  int const number_of_trajectories = ephemeris->trajectories_.size();
   ephemeris->trajectories_.clear();
-  for (auto const& trajectory : message.trajectory()) {
-    not_null<MassiveBody const*> const body = ephemeris->bodies_[index].get();
-    not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>
-        deserialized_trajectory =
-            ContinuousTrajectory<Frame>::ReadFromMessage(trajectory);
-    ephemeris->trajectories_.push_back(deserialized_trajectory.get());
-    ephemeris->bodies_to_trajectories_.emplace(
-        body, std::move(deserialized_trajectory));
-    ++index;
+  for (int index = 0; index < number_of_trajectories; ++index) {
+    ephemeris->trajectories_.push_back(read_trajectory());
   }
   if (message.has_t_max()) {
     ephemeris->checkpoints_.push_back(ephemeris->GetCheckpoint());
-    ephemeris->Prolong(Instant::ReadFromMessage(message.t_max()));
+    Instant const t_max = Instant::ReadFromMessage(message.t_max());
+    if (message.checkpoint().empty()) {
+      ephemeris->Prolong(t_max);
+    } else {
+      ephemeris->StartRebuild(message, equation, t_max);
+    }
   }
   return ephemeris;
 }
@@ -816,17 +2030,106 @@ Ephemeris<Frame>::Ephemeris(
         typename Ephemeris<Frame>::NewtonianMotionEquation> const& integrator)
     : parameters_(integrator, 1 * Second) {}
 
+template<typename Frame>
+std::vector<int> Ephemeris<Frame>::FittingStepMultiples(
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> const& bodies,
+    std::vector<DegreesOfFreedom<Frame>> const& initial_state,
+    FixedStepParameters const& parameters) {
+  int const number_of_bodies = bodies.size();
+  std::vector<int> multiples(number_of_bodies, 1);
+  if (parameters.max_fitting_step_multiple_ == 1) {
+    return multiples;
+  }
+
+  // The dynamical time of each body, see |FixedStepParameters|.
+  std::vector<Time> dynamical_times(number_of_bodies, Infinity<Time>());
+  for (int b1 = 0; b1 < number_of_bodies; ++b1) {
+    for (int b2 = b1 + 1; b2 < number_of_bodies; ++b2) {
+      Length const r = (initial_state[b1].position() -
+                        initial_state[b2].position()).Norm();
+      GravitationalParameter const μ = bodies[b1]->gravitational_parameter() +
+                                       bodies[b2]->gravitational_parameter();
+      Time const dynamical_time = μ == GravitationalParameter()
+                                      ? Infinity<Time>()
+                                      : Sqrt(Pow<3>(r) / μ);
+      dynamical_times[b1] = std::min(dynamical_times[b1], dynamical_time);
+      dynamical_times[b2] = std::min(dynamical_times[b2], dynamical_time);
+    }
+  }
+  Time const shortest_dynamical_time =
+      *std::min_element(dynamical_times.begin(), dynamical_times.end());
+  // Coincident bodies, e.g., the dummy state used for deserialization, or a
+  // single body: all the trajectories use the integration step.
+  if (shortest_dynamical_time == Time() ||
+      shortest_dynamical_time == Infinity<Time>()) {
+    return multiples;
+  }
+  for (int b = 0; b < number_of_bodies; ++b) {
+    double const ratio = dynamical_times[b] / shortest_dynamical_time;
+    while (2 * multiples[b] <= parameters.max_fitting_step_multiple_ &&
+           2 * multiples[b] <= ratio) {
+      multiples[b] *= 2;
+    }
+  }
+  return multiples;
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::AppendMassiveBodiesState(
     typename NewtonianMotionEquation::SystemState const& state) {
-  int index = 0;
-  for (int i = 0; i < trajectories_.size(); ++i) {
-    auto const& trajectory = trajectories_[i];
-    auto const status = trajectory->Append(
+  AppendMassiveBodiesStateToTrajectories(state);
+
+  // Record an intermediate state if we haven't done so for too long.
+  CHECK(!trajectories_.empty());
+  Instant const t_last_intermediate_state =
+      checkpoints_.empty()
+          ? astronomy::InfinitePast
+          : checkpoints_.back().instance->time().value;
+  if (t_max_locked() - t_last_intermediate_state >
+      max_time_between_checkpoints) {
+    checkpoints_.push_back(GetCheckpoint());
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::AppendMassiveBodiesStateToTrajectories(
+    typename NewtonianMotionEquation::SystemState const& state) {
+  int const number_of_trajectories = trajectories_.size();
+  std::vector<Status> statuses(number_of_trajectories);
+  auto const append = [this, &state, &statuses](int const i) {
+    statuses[i] = trajectories_[i]->Append(
         state.time.value,
-        DegreesOfFreedom<Frame>(state.positions[index].value,
-                                state.velocities[index].value));
+        DegreesOfFreedom<Frame>(state.positions[i].value,
+                                state.velocities[i].value));
+  };
 
+  // A trajectory fitted with a multiple of the integration step only receives
+  // one state every so many steps.  Fitting is expensive, so the fits are
+  // spread over the scheduler, if any.  The other appends merely record a point
+  // and are done serially.  The results don't depend on the parallelism.
+  Time const half_step = parameters_.step_ / 2;
+  std::vector<Future<void>> futures;
+  for (int i = 0; i < number_of_trajectories; ++i) {
+    ContinuousTrajectory<Frame> const& trajectory = *trajectories_[i];
+    if (state.time.value - trajectory.last_point_time() <=
+            trajectory.step() - half_step) {
+      continue;
+    }
+    if (massive_bodies_scheduler_ != nullptr &&
+        number_of_trajectories > 1 &&
+        trajectory.NextAppendFits()) {
+      futures.push_back(
+          massive_bodies_scheduler_->Add([&append, i]() { append(i); }));
+    } else {
+      append(i);
+    }
+  }
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  for (int i = 0; i < number_of_trajectories; ++i) {
+    Status const& status = statuses[i];
     // Handle the apocalypse.
     if (!status.ok()) {
       last_severe_integration_status_ =
@@ -835,22 +2138,657 @@ void Ephemeris<Frame>::AppendMassiveBodiesState(
                      status.message());
       LOG(ERROR) << "New Apocalypse: " << last_severe_integration_status_;
     }
+  }
+}
 
-    ++index;
+template<typename Frame>
+Status Ephemeris<Frame>::FlowManyWithAdaptiveStepBefore(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    Instant const& t,
+    std::vector<AdaptiveStepParameters> const& parameters,
+    std::int64_t const max_ephemeris_steps,
+    bool const last_point_only,
+    std::optional<std::chrono::steady_clock::time_point> const& deadline) {
+  PRINCIPIA_PROFILE_SCOPE(EphemerisFlowWithAdaptiveStep);
+  CHECK(!trajectories.empty());
+  CHECK_EQ(trajectories.size(), parameters.size());
+  CHECK(intrinsic_accelerations.empty() ||
+        intrinsic_accelerations.size() == trajectories.size());
+  CHECK(!last_point_only || !deadline.has_value());
+
+  if (parameters.front().encke_rectification_threshold_.has_value() ||
+      parameters.front().regularize_close_approaches_) {
+    CHECK_EQ(1, trajectories.size())
+        << "Encke's method is only supported for a single trajectory";
+    return FlowWithAdaptiveStepByEncke(trajectories.front(),
+                                       intrinsic_accelerations,
+                                       t,
+                                       parameters.front(),
+                                       max_ephemeris_steps,
+                                       last_point_only,
+                                       deadline);
   }
 
-  // Record an intermediate state if we haven't done so for too long.
-  CHECK(!trajectories_.empty());
-  Instant const t_last_intermediate_state =
-      checkpoints_.empty()
-          ? astronomy::InfinitePast
-          : checkpoints_.back().instance->time().value;
-  if (t_max_locked() - t_last_intermediate_state >
-      max_time_between_checkpoints) {
-    checkpoints_.push_back(GetCheckpoint());
+  Instant trajectory_last_time = trajectories.front()->last().time();
+  if (trajectory_last_time == t) {
+    return Status::OK;
+  }
+
+  // Set when an impact is found between the stages of a step, see
+  // |FindImpact|.  The integration stops at the next stage.
+  bool impact = false;
+
+  MasslessBodiesCulling culling(massless_bodies_culling_threshold_);
+
+  IntegrationProblem<NewtonianMotionEquation> problem;
+  problem.equation.compute_acceleration = [
+      this,
+      &culling,
+      &impact,
+      &intrinsic_accelerations =
+          EffectiveIntrinsicAccelerations(intrinsic_accelerations)](
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) {
+    if (!impact &&
+        ComputeMasslessBodiesTotalAccelerations(intrinsic_accelerations,
+                                                t,
+                                                positions,
+                                                culling.culled_bodies(t),
+                                                accelerations)) {
+      return Status::OK;
+    } else {
+      return Status(Error::OUT_OF_RANGE, "Collision detected");
+    }
+  };
+
+  AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator =
+      *parameters.front().integrator_;
+  std::int64_t max_steps = 0;
+  std::vector<Length> length_integration_tolerances;
+  std::vector<Speed> speed_integration_tolerances;
+  for (int i = 0; i < trajectories.size(); ++i) {
+    CHECK_EQ(&integrator, parameters[i].integrator_);
+    max_steps = std::max(max_steps, parameters[i].max_steps_);
+    length_integration_tolerances.push_back(
+        parameters[i].length_integration_tolerance_);
+    speed_integration_tolerances.push_back(
+        parameters[i].speed_integration_tolerance_);
+  }
+  auto const tolerance_to_error_ratio =
+      std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
+                std::cref(length_integration_tolerances),
+                std::cref(speed_integration_tolerances),
+                _1, _2);
+
+  // The number of steps taken so far, used to honour |max_steps| across the
+  // calls to |Solve| when there is a deadline.
+  std::int64_t steps = 0;
+  typename AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::AppendState
+      append_state;
+  typename NewtonianMotionEquation::SystemState last_state;
+  if (last_point_only) {
+    append_state = [&last_state](
+        typename NewtonianMotionEquation::SystemState const& state) {
+      last_state = state;
+    };
+  } else {
+    append_state = [&steps, &trajectories](
+        typename NewtonianMotionEquation::SystemState const& state) {
+      ++steps;
+      AppendMasslessBodiesState(state, trajectories);
+    };
+  }
+  // If a massless body hits a massive body during a step, the state at the
+  // time of the impact is appended instead of the state at the end of the
+  // step.
+  typename NewtonianMotionEquation::SystemState previous_state;
+  std::vector<DegreesOfFreedom<Frame>> bodies_degrees_of_freedom;
+  append_state = [this,
+                  append = std::move(append_state),
+                  &bodies_degrees_of_freedom,
+                  &culling,
+                  &impact,
+                  &previous_state](
+      typename NewtonianMotionEquation::SystemState const& state) {
+    std::optional<Instant> const impact_time =
+        FindImpact(previous_state, state, bodies_degrees_of_freedom);
+    if (impact_time.has_value()) {
+      impact = true;
+      append(InterpolateState(previous_state, state, *impact_time));
+    } else {
+      append(state);
+      UpdateMasslessBodiesCulling(state, culling);
+    }
+    previous_state = state;
+  };
+  auto const deadline_passed = [&deadline]() {
+    return std::chrono::steady_clock::now() >= *deadline;
+  };
+
+  // Without a deadline, this loop is executed exactly once.
+  Status status;
+  Instant t_final = trajectory_last_time;
+  for (;;) {
+    if (trajectory_last_time == t_final) {
+      // The |min| is here to prevent us from spending too much time computing
+      // the ephemeris.  The |max| is here to ensure that we always try to
+      // integrate forward.  We use |last_state_.time.value| because this is
+      // always finite, contrary to |t_max()|, which is -∞ when |empty()|.
+      t_final = std::min(std::max(instance_time() +
+                                      max_ephemeris_steps * parameters_.step(),
+                                  trajectory_last_time + parameters_.step()),
+                         t);
+      Prolong(t_final);
+    }
+
+    problem.initial_state.positions.clear();
+    problem.initial_state.velocities.clear();
+    for (auto const trajectory : trajectories) {
+      auto const trajectory_last = trajectory->last();
+      auto const last_degrees_of_freedom = trajectory_last.degrees_of_freedom();
+      CHECK_EQ(trajectory_last.time(), trajectory_last_time);
+      problem.initial_state.positions.emplace_back(
+          last_degrees_of_freedom.position());
+      problem.initial_state.velocities.emplace_back(
+          last_degrees_of_freedom.velocity());
+    }
+    problem.initial_state.time = DoublePrecision<Instant>(trajectory_last_time);
+    previous_state = problem.initial_state;
+    bodies_degrees_of_freedom.clear();
+    UpdateMasslessBodiesCulling(problem.initial_state, culling);
+
+    // With a deadline, |Solve| returns every few steps so that we may look at
+    // the clock.
+    std::int64_t const max_steps_per_solve =
+        deadline.has_value()
+            ? std::min(steps_between_deadline_checks, max_steps - steps)
+            : max_steps;
+    typename AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::
+        Parameters const integrator_parameters(
+            /*first_time_step=*/t_final - problem.initial_state.time.value,
+            /*safety_factor=*/0.9,
+            max_steps_per_solve,
+            /*last_step_is_exact=*/true,
+            parameters.front().step_size_controller_);
+    CHECK_GT(integrator_parameters.first_time_step, 0 * Second)
+        << "Flow back to the future: " << t_final
+        << " <= " << problem.initial_state.time.value;
+
+    auto const instance = integrator.NewInstance(problem,
+                                                 append_state,
+                                                 tolerance_to_error_ratio,
+                                                 integrator_parameters);
+    status = instance->Solve(t_final);
+    // The instance is restartable after reaching its maximal step count.
+    while (deadline.has_value() &&
+           status.error() == ReachedMaximalStepCount &&
+           steps + max_steps_per_solve <= max_steps &&
+           !deadline_passed()) {
+      status = instance->Solve(t_final);
+    }
+    for (auto const& p : parameters) {
+      if (p.statistics_ != nullptr) {
+        *p.statistics_ += static_cast<typename AdaptiveStepSizeIntegrator<
+            NewtonianMotionEquation>::Instance const&>(*instance).statistics();
+      }
+    }
+    if (!deadline.has_value()) {
+      break;
+    }
+    trajectory_last_time = trajectories.front()->last().time();
+
+    if (impact) {
+      // Don't restart the integration from the point of impact.
+      status = Status(Error::OUT_OF_RANGE, "Collision detected");
+      break;
+    } else if (status.ok() || status.error() == ReachedMaximalStepCount) {
+      if (status.ok() && t_final == t) {
+        break;
+      } else if (steps >= max_steps) {
+        break;
+      } else if (deadline_passed()) {
+        status = Status(Error::DEADLINE_EXCEEDED,
+                        "Deadline passed at " + DebugString(t_final) +
+                            ", stopping at " +
+                            DebugString(trajectory_last_time));
+        break;
+      }
+      // Either we reached |t_final|, or fewer than |max_steps_per_solve|
+      // steps remain: loop around to prolong or to start a new instance.
+    } else {
+      break;
+    }
+  }
+
+  // We probably don't care if the vessel gets too close to the singularity, as
+  // we only use this integrator for the future.  So we swallow the error.
+  // TODO(phl): Is this the right thing to do long term?
+  if (status.error() == Error::OUT_OF_RANGE) {
+    status = Status::OK;
+  }
+
+  if (last_point_only) {
+    AppendMasslessBodiesState(last_state, trajectories);
+  }
+
+  // TODO(egg): when we have events in trajectories, we should add a singularity
+  // event at the end if the outcome indicates a singularity
+  // (|VanishingStepSize|).  We should not have an event on the trajectory if
+  // |ReachedMaximalStepCount|, since that is not a physical property, but
+  // rather a self-imposed constraint.
+  if (!status.ok() || t_final == t) {
+    return status;
+  } else {
+    return Status(Error::DEADLINE_EXCEEDED,
+                  "Couldn't reach " + DebugString(t_final) + ", stopping at " +
+                      DebugString(t));
   }
 }
 
+template<typename Frame>
+Status Ephemeris<Frame>::FlowWithAdaptiveStepByEncke(
+    not_null<DiscreteTrajectory<Frame>*> const trajectory,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    Instant const& t,
+    AdaptiveStepParameters const& parameters,
+    std::int64_t const max_ephemeris_steps,
+    bool const last_point_only,
+    std::optional<std::chrono::steady_clock::time_point> const& deadline) {
+  double const rectification_threshold =
+      parameters.encke_rectification_threshold_.value_or(
+          default_encke_rectification_threshold);
+  // If false, Encke's method is only used during close approaches.
+  bool const always_encke =
+      parameters.encke_rectification_threshold_.has_value();
+
+  // The absolute state of the massless body at the end of the last step, from
+  // which the osculating orbit is rectified.
+  typename NewtonianMotionEquation::SystemState previous_state;
+  {
+    auto const trajectory_last = trajectory->last();
+    previous_state.time = DoublePrecision<Instant>(trajectory_last.time());
+    previous_state.positions.emplace_back(
+        trajectory_last.degrees_of_freedom().position());
+    previous_state.velocities.emplace_back(
+        trajectory_last.degrees_of_freedom().velocity());
+  }
+  Instant trajectory_last_time = previous_state.time.value;
+  if (trajectory_last_time == t) {
+    return Status::OK;
+  }
+
+  // The body that dominates the motion, which is neglected by the computation
+  // of the perturbations, and the osculating orbit about it.  The integrated
+  // state is the deviation from that orbit, as a position relative to the
+  // origin.  If there is no osculating orbit, the integrated state is the
+  // absolute state, and no body is neglected.
+  std::size_t primary;
+  std::vector<bool> culled_bodies;
+  std::optional<KeplerOrbit<Frame>> osculating_orbit;
+  auto const primary_degrees_of_freedom = [this, &primary](Instant const& t) {
+    shared_lock_guard<ShardedSharedMutex> l(lock_);
+    return trajectories_[primary]->EvaluateDegreesOfFreedom(t);
+  };
+  auto const rectify = [this,
+                        always_encke,
+                        &culled_bodies,
+                        &osculating_orbit,
+                        &primary,
+                        &primary_degrees_of_freedom](
+      typename NewtonianMotionEquation::SystemState const& state) {
+    Instant const& t = state.time.value;
+    DegreesOfFreedom<Frame> const degrees_of_freedom(
+        state.positions[0].value, state.velocities[0].value);
+    double perturbation_ratio;
+    primary = FindDominantBody(t,
+                               degrees_of_freedom.position(),
+                               perturbation_ratio);
+    if (!always_encke &&
+        perturbation_ratio >= close_approach_perturbation_ratio) {
+      culled_bodies.clear();
+      osculating_orbit.reset();
+      return;
+    }
+    culled_bodies.assign(bodies_.size(), false);
+    culled_bodies[primary] = true;
+    osculating_orbit.emplace(*bodies_[primary],
+                             MasslessBody{},
+                             degrees_of_freedom - primary_degrees_of_freedom(t),
+                             t);
+  };
+
+  // Set when an impact is found between the stages of a step, see
+  // |FindImpact|.  The integration stops at the end of the step.
+  bool impact = false;
+
+  IntegrationProblem<NewtonianMotionEquation> problem;
+  std::vector<Position<Frame>> perturbed_positions(2);
+  std::vector<Vector<Acceleration, Frame>> perturbations(2);
+  problem.equation.compute_acceleration = [
+      this,
+      &culled_bodies,
+      &impact,
+      &intrinsic_accelerations =
+          EffectiveIntrinsicAccelerations(intrinsic_accelerations),
+      &osculating_orbit,
+      &perturbations,
+      &perturbed_positions,
+      &primary](
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) {
+    if (!osculating_orbit.has_value()) {
+      if (!impact &&
+          ComputeMasslessBodiesTotalAccelerations(intrinsic_accelerations,
+                                                  t,
+                                                  positions,
+                                                  /*culled_bodies=*/{},
+                                                  accelerations)) {
+        return Status::OK;
+      } else {
+        return Status(Error::OUT_OF_RANGE, "Collision detected");
+      }
+    }
+
+    MassiveBody const& body = *bodies_[primary];
+    GravitationalParameter const& μ = body.gravitational_parameter();
+    Displacement<Frame> const δ = positions[0] - Frame::origin;
+    Displacement<Frame> const ρ_osculating =
+        osculating_orbit->StateVectors(t).displacement();
+    Displacement<Frame> const ρ = ρ_osculating + δ;
+    Position<Frame> primary_position;
+    {
+      shared_lock_guard<ShardedSharedMutex> l(lock_);
+      primary_position = trajectories_[primary]->EvaluatePosition(t);
+    }
+
+    // The accelerations due to the other bodies, on the massless body and on
+    // the primary, the latter being treated as a massless body.  The intrinsic
+    // acceleration only applies to the former.
+    perturbed_positions[0] = primary_position + ρ;
+    perturbed_positions[1] = primary_position;
+    bool ok = ComputeMasslessBodiesTotalAccelerations(intrinsic_accelerations,
+                                                      t,
+                                                      perturbed_positions,
+                                                      culled_bodies,
+                                                      perturbations);
+
+    // The difference between the central accelerations at |ρ| and at
+    // |ρ_osculating|, following Battin, An Introduction to the Mathematics and
+    // Methods of Astrodynamics, section 9.3, to avoid cancellations:
+    //   μ ρ_osculating / ρ_osculating³ - μ ρ / ρ³ =
+    //       μ / ρ_osculating³ (f(q) ρ - δ),
+    // where q = δ·(ρ_osculating + ρ) / ρ_osculating² and
+    //   f(q) = 1 - (1 + q)^-3/2
+    //        = q (3 + 3 q + q²) / ((1 + (1 + q)^3/2) (1 + q)^3/2).
+    Square<Length> const ρ_osculating² = ρ_osculating.Norm²();
+    double const q = InnerProduct(δ, ρ_osculating + ρ) / ρ_osculating²;
+    double const one_plus_q_to_the_3_halves = (1 + q) * std::sqrt(1 + q);
+    double const f = q * (3 + q * (3 + q)) /
+                     ((1 + one_plus_q_to_the_3_halves) *
+                      one_plus_q_to_the_3_halves);
+    Exponentiation<Length, -3> const one_over_ρ_osculating³ =
+        Sqrt(ρ_osculating²) / (ρ_osculating² * ρ_osculating²);
+    accelerations[0] = μ * one_over_ρ_osculating³ * (f * ρ - δ) +
+                       perturbations[0] - perturbations[1];
+
+    Square<Length> const ρ² = ρ.Norm²();
+    ok &= ρ² > Pow<2>(body.mean_radius());
+    if (primary < number_of_oblate_bodies_) {
+      Exponentiation<Length, -2> const one_over_ρ² = 1 / ρ²;
+      Exponentiation<Length, -3> const one_over_ρ³ = Sqrt(ρ²) / (ρ² * ρ²);
+      accelerations[0] +=
+          μ * Order2ZonalAcceleration<Frame>(
+                  static_cast<OblateBody<Frame> const&>(body),
+                  ρ,
+                  one_over_ρ²,
+                  one_over_ρ³);
+    }
+
+    if (!impact && ok) {
+      return Status::OK;
+    } else {
+      return Status(Error::OUT_OF_RANGE, "Collision detected");
+    }
+  };
+
+  auto const& integrator = *parameters.integrator_;
+  std::int64_t const max_steps = parameters.max_steps_;
+  std::vector<Length> const length_integration_tolerances{
+      parameters.length_integration_tolerance_};
+  std::vector<Speed> const speed_integration_tolerances{
+      parameters.speed_integration_tolerance_};
+  auto const tolerance_to_error_ratio =
+      std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
+                std::cref(length_integration_tolerances),
+                std::cref(speed_integration_tolerances),
+                _1, _2);
+
+  // The append function converts the deviation to an absolute state, appends
+  // it (or the state at the time of the impact) and decides whether the
+  // osculating orbit must be rectified.  Without an osculating orbit, the
+  // dominant body is checked at each rectification check.
+  std::int64_t steps = 0;
+  Time last_step = t - trajectory_last_time;
+  bool must_rectify = false;
+  typename NewtonianMotionEquation::SystemState last_state;
+  std::vector<DegreesOfFreedom<Frame>> bodies_degrees_of_freedom;
+  auto const append_state = [this,
+                             &bodies_degrees_of_freedom,
+                             &impact,
+                             &last_state,
+                             last_point_only,
+                             &last_step,
+                             &must_rectify,
+                             &osculating_orbit,
+                             &previous_state,
+                             &primary_degrees_of_freedom,
+                             rectification_threshold,
+                             &steps,
+                             trajectory](
+      typename NewtonianMotionEquation::SystemState const& state) {
+    if (impact) {
+      return;
+    }
+    ++steps;
+    Instant const& t = state.time.value;
+    typename NewtonianMotionEquation::SystemState absolute_state;
+    if (osculating_orbit.has_value()) {
+      RelativeDegreesOfFreedom<Frame> const osculating =
+          osculating_orbit->StateVectors(t);
+      Displacement<Frame> const δ = state.positions[0].value - Frame::origin;
+      DegreesOfFreedom<Frame> const primary_state =
+          primary_degrees_of_freedom(t);
+      absolute_state.time = state.time;
+      absolute_state.positions.emplace_back(
+          primary_state.position() + (osculating.displacement() + δ));
+      absolute_state.velocities.emplace_back(
+          primary_state.velocity() +
+          (osculating.velocity() + state.velocities[0].value));
+      must_rectify =
+          δ.Norm() >
+          rectification_threshold * osculating.displacement().Norm();
+    } else {
+      absolute_state = state;
+      must_rectify = true;
+    }
+
+    std::optional<Instant> const impact_time =
+        FindImpact(previous_state, absolute_state, bodies_degrees_of_freedom);
+    if (impact_time.has_value()) {
+      impact = true;
+      absolute_state =
+          InterpolateState(previous_state, absolute_state, *impact_time);
+    }
+    if (last_point_only) {
+      last_state = absolute_state;
+    } else {
+      AppendMasslessBodiesState(absolute_state, {trajectory});
+    }
+    last_step = t - previous_state.time.value;
+    previous_state = std::move(absolute_state);
+  };
+  auto const deadline_passed = [&deadline]() {
+    return deadline.has_value() &&
+           std::chrono::steady_clock::now() >= *deadline;
+  };
+
+  // Each iteration of this loop integrates from a rectified osculating orbit
+  // (or from the absolute state), until the orbit must be rectified again or
+  // |t_final| is reached.
+  Status status;
+  Instant t_final = trajectory_last_time;
+  for (;;) {
+    if (trajectory_last_time == t_final) {
+      // See |FlowManyWithAdaptiveStepBefore| for the choice of |t_final|.
+      t_final = std::min(std::max(instance_time() +
+                                      max_ephemeris_steps * parameters_.step(),
+                                  trajectory_last_time + parameters_.step()),
+                         t);
+      Prolong(t_final);
+    }
+
+    rectify(previous_state);
+    must_rectify = false;
+    bodies_degrees_of_freedom.clear();
+    if (osculating_orbit.has_value()) {
+      problem.initial_state.time = previous_state.time;
+      problem.initial_state.positions.clear();
+      problem.initial_state.velocities.clear();
+      problem.initial_state.positions.emplace_back(Frame::origin);
+      problem.initial_state.velocities.emplace_back(Velocity<Frame>());
+    } else {
+      problem.initial_state = previous_state;
+    }
+
+    std::int64_t const max_steps_per_solve =
+        std::min(steps_between_rectification_checks, max_steps - steps);
+    typename AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::
+        Parameters const integrator_parameters(
+            /*first_time_step=*/std::min(
+                last_step, t_final - problem.initial_state.time.value),
+            /*safety_factor=*/0.9,
+            max_steps_per_solve,
+            /*last_step_is_exact=*/true,
+            parameters.step_size_controller_);
+    CHECK_GT(integrator_parameters.first_time_step, 0 * Second)
+        << "Flow back to the future: " << t_final
+        << " <= " << problem.initial_state.time.value;
+
+    auto const instance = integrator.NewInstance(problem,
+                                                 append_state,
+                                                 tolerance_to_error_ratio,
+                                                 integrator_parameters);
+    // The instance is restartable after reaching its maximal step count.
+    do {
+      status = instance->Solve(t_final);
+    } while (status.error() == ReachedMaximalStepCount &&
+             !must_rectify &&
+             !impact &&
+             steps + max_steps_per_solve <= max_steps &&
+             !deadline_passed());
+    if (parameters.statistics_ != nullptr) {
+      *parameters.statistics_ +=
+          static_cast<typename AdaptiveStepSizeIntegrator<
+              NewtonianMotionEquation>::Instance const&>(*instance)
+              .statistics();
+    }
+    trajectory_last_time = previous_state.time.value;
+
+    if (impact) {
+      status = Status(Error::OUT_OF_RANGE, "Collision detected");
+      break;
+    } else if (status.ok() || status.error() == ReachedMaximalStepCount) {
+      if (status.ok() && (t_final == t || !deadline.has_value())) {
+        break;
+      } else if (steps >= max_steps) {
+        break;
+      } else if (deadline_passed()) {
+        status = Status(Error::DEADLINE_EXCEEDED,
+                        "Deadline passed at " + DebugString(t_final) +
+                            ", stopping at " +
+                            DebugString(trajectory_last_time));
+        break;
+      }
+      // Either the orbit must be rectified, we reached |t_final|, or fewer
+      // than |max_steps_per_solve| steps remain: loop around to start a new
+      // instance.
+    } else {
+      break;
+    }
+  }
+
+  // See |FlowManyWithAdaptiveStepBefore| for the handling of the collisions.
+  if (status.error() == Error::OUT_OF_RANGE) {
+    status = Status::OK;
+  }
+
+  if (last_point_only && steps > 0) {
+    AppendMasslessBodiesState(last_state, {trajectory});
+  }
+
+  if (!status.ok() || t_final == t) {
+    return status;
+  } else {
+    return Status(Error::DEADLINE_EXCEEDED,
+                  "Couldn't reach " + DebugString(t_final) + ", stopping at " +
+                      DebugString(t));
+  }
+}
+
+template<typename Frame>
+std::size_t Ephemeris<Frame>::FindDominantBody(
+    Instant const& t,
+    Position<Frame> const& position,
+    double& perturbation_ratio) const {
+  std::vector<Position<Frame>> positions;
+  {
+    shared_lock_guard<ShardedSharedMutex> l(lock_);
+    EvaluateTrajectoriesPositions(t, /*culled_bodies=*/{}, positions);
+  }
+
+  // The accelerations exerted by each body on the massless body, and their
+  // sum.
+  std::vector<Vector<Acceleration, Frame>> central_accelerations;
+  Vector<Acceleration, Frame> total_acceleration;
+  for (std::size_t b = 0; b < bodies_.size(); ++b) {
+    Displacement<Frame> const Δq = positions[b] - position;
+    Square<Length> const Δq² = Δq.Norm²();
+    central_accelerations.push_back(
+        Δq * (bodies_[b]->gravitational_parameter() * Sqrt(Δq²) /
+              (Δq² * Δq²)));
+    total_acceleration += central_accelerations.back();
+  }
+
+  std::size_t dominant_body = 0;
+  double smallest_ratio = std::numeric_limits<double>::infinity();
+  for (std::size_t b1 = 0; b1 < bodies_.size(); ++b1) {
+    // The perturbing acceleration is the difference between the accelerations
+    // of the massless body and of |b1| due to the other bodies.
+    Vector<Acceleration, Frame> perturbation =
+        total_acceleration - central_accelerations[b1];
+    for (std::size_t b2 = 0; b2 < bodies_.size(); ++b2) {
+      if (b2 != b1) {
+        Displacement<Frame> const Δq = positions[b2] - positions[b1];
+        Square<Length> const Δq² = Δq.Norm²();
+        perturbation -=
+            Δq * (bodies_[b2]->gravitational_parameter() * Sqrt(Δq²) /
+                  (Δq² * Δq²));
+      }
+    }
+    double const ratio =
+        perturbation.Norm() / central_accelerations[b1].Norm();
+    if (ratio < smallest_ratio) {
+      smallest_ratio = ratio;
+      dominant_body = b1;
+    }
+  }
+  perturbation_ratio = smallest_ratio;
+  return dominant_body;
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::AppendMasslessBodiesState(
     typename NewtonianMotionEquation::SystemState const& state,
@@ -865,6 +2803,424 @@ void Ephemeris<Frame>::AppendMasslessBodiesState(
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::UpdateMasslessBodiesCulling(
+    typename NewtonianMotionEquation::SystemState const& state,
+    MasslessBodiesCulling& culling) const {
+  culling.culled_bodies_.clear();
+  if (culling.threshold_ == 0) {
+    return;
+  }
+
+  Instant const& t = state.time.value;
+  std::size_t const number_of_massless_bodies = state.positions.size();
+
+  // For each pair, a bound on the acceleration exerted by the massive body on
+  // the massless body as long as their distance is more than half its current
+  // value, and the time it takes to halve that distance at the current
+  // relative velocity.  Indexed by |b1 * number_of_massless_bodies + b2|.
+  std::vector<Acceleration> bounds;
+  std::vector<Time> validities;
+  // For each massless body, the largest acceleration exerted by a massive body.
+  std::vector<Acceleration> largest_accelerations(number_of_massless_bodies);
+  {
+    shared_lock_guard<ShardedSharedMutex> l(lock_);
+    for (std::size_t b1 = 0; b1 < bodies_.size(); ++b1) {
+      MassiveBody const& body1 = *bodies_[b1];
+      DegreesOfFreedom<Frame> const body1_degrees_of_freedom =
+          trajectories_[b1]->EvaluateDegreesOfFreedom(t);
+      for (std::size_t b2 = 0; b2 < number_of_massless_bodies; ++b2) {
+        RelativeDegreesOfFreedom<Frame> const relative =
+            DegreesOfFreedom<Frame>(state.positions[b2].value,
+                                    state.velocities[b2].value) -
+            body1_degrees_of_freedom;
+        Length const distance = relative.displacement().Norm();
+        Acceleration const acceleration =
+            body1.gravitational_parameter() / (distance * distance);
+        largest_accelerations[b2] =
+            std::max(largest_accelerations[b2], acceleration);
+        if (distance <= 2 * body1.mean_radius()) {
+          // The massless body could hit |body1| within the validity period.
+          bounds.push_back(Infinity<Acceleration>());
+        } else {
+          // Halving the distance quadruples the acceleration.  The oblateness
+          // term is smaller than the central one by a factor of the order of
+          // J₂ (R / r)², so doubling the bound is plenty.
+          bounds.push_back((body1.is_oblate() ? 8 : 4) * acceleration);
+        }
+        validities.push_back(distance / (2 * relative.velocity().Norm()));
+      }
+    }
+  }
+
+  // Neglect the bodies in increasing order of their largest relative
+  // contribution, as long as the neglected total is below the threshold for
+  // all the massless bodies.
+  std::vector<double> relative_bounds(bodies_.size());
+  for (std::size_t b1 = 0; b1 < bodies_.size(); ++b1) {
+    for (std::size_t b2 = 0; b2 < number_of_massless_bodies; ++b2) {
+      relative_bounds[b1] =
+          std::max(relative_bounds[b1],
+                   bounds[b1 * number_of_massless_bodies + b2] /
+                       largest_accelerations[b2]);
+    }
+  }
+  std::vector<std::size_t> order(bodies_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(),
+                   order.end(),
+                   [&relative_bounds](std::size_t const left,
+                                      std::size_t const right) {
+                     return relative_bounds[left] < relative_bounds[right];
+                   });
+
+  std::vector<Acceleration> neglected_accelerations(number_of_massless_bodies);
+  Time validity = Infinity<Time>();
+  for (std::size_t const b1 : order) {
+    bool negligible = true;
+    for (std::size_t b2 = 0; b2 < number_of_massless_bodies; ++b2) {
+      negligible &= neglected_accelerations[b2] +
+                        bounds[b1 * number_of_massless_bodies + b2] <=
+                    culling.threshold_ * largest_accelerations[b2];
+    }
+    if (!negligible) {
+      break;
+    }
+    if (culling.culled_bodies_.empty()) {
+      culling.culled_bodies_.resize(bodies_.size(), false);
+    }
+    culling.culled_bodies_[b1] = true;
+    for (std::size_t b2 = 0; b2 < number_of_massless_bodies; ++b2) {
+      neglected_accelerations[b2] +=
+          bounds[b1 * number_of_massless_bodies + b2];
+      validity =
+          std::min(validity, validities[b1 * number_of_massless_bodies + b2]);
+    }
+  }
+  culling.time_ = t;
+  culling.validity_ = validity;
+}
+
+template<typename Frame>
+std::optional<Instant> Ephemeris<Frame>::FindImpact(
+    typename NewtonianMotionEquation::SystemState const& previous_state,
+    typename NewtonianMotionEquation::SystemState const& state,
+    std::vector<DegreesOfFreedom<Frame>>& bodies_degrees_of_freedom) const {
+  Instant const& t0 = previous_state.time.value;
+  Instant const& t1 = state.time.value;
+  Time const Δt = t1 - t0;
+
+  shared_lock_guard<ShardedSharedMutex> l(lock_);
+  if (bodies_degrees_of_freedom.empty()) {
+    for (auto const& trajectory : trajectories_) {
+      bodies_degrees_of_freedom.push_back(
+          trajectory->EvaluateDegreesOfFreedom(t0));
+    }
+  }
+
+  std::optional<Instant> impact_time;
+  for (std::size_t b1 = 0; b1 < bodies_.size(); ++b1) {
+    Length const radius = bodies_[b1]->mean_radius();
+    Square<Length> const radius² = radius * radius;
+    DegreesOfFreedom<Frame> const body_degrees_of_freedom0 =
+        bodies_degrees_of_freedom[b1];
+    DegreesOfFreedom<Frame> const body_degrees_of_freedom1 =
+        trajectories_[b1]->EvaluateDegreesOfFreedom(t1);
+    bodies_degrees_of_freedom[b1] = body_degrees_of_freedom1;
+
+    for (std::size_t b2 = 0; b2 < state.positions.size(); ++b2) {
+      RelativeDegreesOfFreedom<Frame> const relative0 =
+          DegreesOfFreedom<Frame>(previous_state.positions[b2].value,
+                                  previous_state.velocities[b2].value) -
+          body_degrees_of_freedom0;
+      RelativeDegreesOfFreedom<Frame> const relative1 =
+          DegreesOfFreedom<Frame>(state.positions[b2].value,
+                                  state.velocities[b2].value) -
+          body_degrees_of_freedom1;
+
+      // The Hermite interpolation of the relative motion is a cubic arc which
+      // lies in the convex hull of its Bézier control points, and therefore in
+      // the sphere centred at their barycentre that contains them.  If that
+      // sphere doesn't intersect |body1|, there is no impact.
+      std::array<Displacement<Frame>, 4> const control_points{
+          relative0.displacement(),
+          relative0.displacement() + relative0.velocity() * Δt / 3,
+          relative1.displacement() - relative1.velocity() * Δt / 3,
+          relative1.displacement()};
+      Displacement<Frame> const centre =
+          (control_points[0] + control_points[1] +
+           control_points[2] + control_points[3]) / 4;
+      Length bounding_radius;
+      for (auto const& control_point : control_points) {
+        bounding_radius =
+            std::max(bounding_radius, (control_point - centre).Norm());
+      }
+      if (centre.Norm() - bounding_radius > radius) {
+        continue;
+      }
+
+      // A massless body that starts inside |body1| is caught when computing
+      // the accelerations.
+      Square<Length> const squared_distance0 =
+          relative0.displacement().Norm²();
+      if (squared_distance0 <= radius²) {
+        continue;
+      }
+      Hermite3<Instant, Square<Length>> const squared_distance(
+          {t0, t1},
+          {squared_distance0, relative1.displacement().Norm²()},
+          {2.0 * InnerProduct(relative0.displacement(), relative0.velocity()),
+           2.0 * InnerProduct(relative1.displacement(), relative1.velocity())});
+
+      // Find a time at which the massless body is inside |body1|: either an
+      // extremum of the squared distance or the end of the step.  The surface
+      // is crossed between |t0| and that time.
+      std::optional<Instant> inside_time;
+      for (Instant const& extremum : squared_distance.FindExtrema()) {
+        if (t0 < extremum && extremum < t1 &&
+            squared_distance.Evaluate(extremum) < radius²) {
+          inside_time = extremum;
+          break;
+        }
+      }
+      if (!inside_time.has_value() &&
+          squared_distance.Evaluate(t1) < radius²) {
+        inside_time = t1;
+      }
+      if (!inside_time.has_value()) {
+        continue;
+      }
+      Instant const time = BracketedNewton(
+          [&radius², &squared_distance](Instant const& t) {
+            return squared_distance.Evaluate(t) - radius²;
+          },
+          [&squared_distance](Instant const& t) {
+            return squared_distance.EvaluateDerivative(t);
+          },
+          t0,
+          *inside_time);
+      // The root finder may only return |t0| if the step is a few ULPs long, in
+      // which case we would append the same time twice.
+      if (time > t0 && (!impact_time.has_value() || time < *impact_time)) {
+        impact_time = time;
+      }
+    }
+  }
+  return impact_time;
+}
+
+template<typename Frame>
+typename Ephemeris<Frame>::NewtonianMotionEquation::SystemState
+Ephemeris<Frame>::InterpolateState(
+    typename NewtonianMotionEquation::SystemState const& previous_state,
+    typename NewtonianMotionEquation::SystemState const& state,
+    Instant const& time) {
+  typename NewtonianMotionEquation::SystemState interpolated_state;
+  interpolated_state.time = DoublePrecision<Instant>(time);
+  for (std::size_t i = 0; i < state.positions.size(); ++i) {
+    Hermite3<Instant, Position<Frame>> const position(
+        {previous_state.time.value, state.time.value},
+        {previous_state.positions[i].value, state.positions[i].value},
+        {previous_state.velocities[i].value, state.velocities[i].value});
+    interpolated_state.positions.emplace_back(position.Evaluate(time));
+    interpolated_state.velocities.emplace_back(
+        position.EvaluateDerivative(time));
+  }
+  return interpolated_state;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::RepeatedlyProlong() {
+  for (;;) {
+    Instant target;
+    {
+      std::unique_lock<std::mutex> l(prolongator_lock_);
+      prolongator_has_request_or_shutdown_.wait(l, [this]() {
+        return prolongator_shutdown_ || prolongation_target_.has_value();
+      });
+      if (prolongator_shutdown_) {
+        return;
+      }
+      target = *prolongation_target_;
+    }
+
+    // Integrate a few steps and go back to check for shutdown and new
+    // requests.  The explicit qualification prevents virtual calls, which
+    // would not be safe during destruction.
+    Instant const t_max = Ephemeris::t_max();
+    if (t_max < target) {
+      Ephemeris::Prolong(
+          std::min(target,
+                   t_max + steps_per_background_prolongation *
+                               parameters_.step_));
+    } else {
+      std::lock_guard<std::mutex> l(prolongator_lock_);
+      if (prolongation_target_ == target) {
+        prolongation_target_.reset();
+      }
+    }
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::StartRebuild(serialization::Ephemeris const& message,
+                                    NewtonianMotionEquation const& equation,
+                                    Instant const& t_max) {
+  using Instance = typename Integrator<NewtonianMotionEquation>::Instance;
+
+  // The ranges are integrated concurrently, so they use the serial computation
+  // of the accelerations, which has no mutable state.
+  NewtonianMotionEquation range_equation;
+  range_equation.compute_acceleration = [this](
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) {
+    ComputeMassiveBodiesGravitationalAccelerationsSerially(positions,
+                                                           accelerations);
+    return Status::OK;
+  };
+
+  // Everything is read here, since |message| doesn't outlive this function.
+  std::vector<RebuildRange> ranges(message.checkpoint_size());
+  std::vector<std::unique_ptr<Instance>> checkpoint_instances;
+  for (int r = 0; r < ranges.size(); ++r) {
+    RebuildRange& range = ranges[r];
+    std::vector<not_null<ContinuousTrajectory<Frame>*>> trajectories;
+    if (r == 0) {
+      for (auto const& trajectory : trajectories_) {
+        trajectories.push_back(trajectory.get());
+      }
+    } else {
+      auto const& checkpoint = message.checkpoint(r - 1);
+      CHECK_EQ(trajectories_.size(), checkpoint.trajectory_size());
+      for (auto const& trajectory : checkpoint.trajectory()) {
+        range.continuations.push_back(
+            ContinuousTrajectory<Frame>::ReadFromMessage(trajectory));
+        trajectories.push_back(range.continuations.back().get());
+      }
+    }
+
+    // Same as |AppendMassiveBodiesStateToTrajectories|, but for the
+    // |trajectories| of the range, and without scheduler.
+    auto const append_state =
+        [this, half_step = parameters_.step_ / 2, trajectories](
+            typename NewtonianMotionEquation::SystemState const& state) {
+          for (int i = 0; i < trajectories.size(); ++i) {
+            ContinuousTrajectory<Frame>& trajectory = *trajectories[i];
+            if (state.time.value - trajectory.last_point_time() <=
+                    trajectory.step() - half_step) {
+              continue;
+            }
+            Status const status = trajectory.Append(
+                state.time.value,
+                DegreesOfFreedom<Frame>(state.positions[i].value,
+                                        state.velocities[i].value));
+            if (!status.ok()) {
+              LOG(ERROR) << "Error extending trajectory for "
+                         << bodies_[i]->name() << " during rebuild: "
+                         << status;
+            }
+          }
+        };
+    range.instance = FixedStepSizeIntegrator<NewtonianMotionEquation>::
+        Instance::ReadFromMessage(r == 0 ? message.instance()
+                                         : message.checkpoint(r - 1).instance(),
+                                  range_equation,
+                                  append_state);
+
+    checkpoint_instances.push_back(
+        FixedStepSizeIntegrator<NewtonianMotionEquation>::Instance::
+        ReadFromMessage(
+            message.checkpoint(r).instance(),
+            equation,
+            /*append_state=*/std::bind(
+                &Ephemeris::AppendMassiveBodiesState, this, _1)));
+    range.t_final = checkpoint_instances.back()->time().value;
+  }
+
+  // The promise is owned by the thread, which may still be in |set_value|
+  // when we return.
+  std::promise<void> locked;
+  std::future<void> const is_locked = locked.get_future();
+  rebuilder_ = std::thread(
+      [this,
+       locked = std::move(locked),
+       ranges = std::move(ranges),
+       checkpoint_instances = std::move(checkpoint_instances),
+       t_max]() mutable {
+        std::lock_guard<std::mutex> l(integration_lock_);
+        locked.set_value();
+        Rebuild(ranges, checkpoint_instances, t_max);
+      });
+  is_locked.wait();
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::Rebuild(
+    std::vector<RebuildRange>& ranges,
+    std::vector<std::unique_ptr<
+        typename Integrator<NewtonianMotionEquation>::Instance>>&
+        checkpoint_instances,
+    Instant const& t_max) {
+  std::atomic<int> next_range = 0;
+  auto const integrate_ranges = [&ranges, &next_range]() {
+    ConfigureCurrentThread();
+    for (int r = next_range++; r < ranges.size(); r = next_range++) {
+      auto& range = ranges[r];
+      Status const status = range.instance->Solve(range.t_final);
+      LOG_IF(ERROR, !status.ok())
+          << "Error rebuilding the ephemeris: " << status;
+    }
+  };
+  int const number_of_threads = std::min<std::int64_t>(
+      ranges.size(),
+      ConfiguredPoolSize(std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+  for (int i = 1; i < number_of_threads; ++i) {
+    threads.emplace_back(integrate_ranges);
+  }
+  integrate_ranges();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // The |trajectories_| are now at the end of |ranges[r]|, where a checkpoint
+  // was taken.  The accelerations may have been computed differently when
+  // the ephemeris was written, e.g., by tiles, so the last bits of the states
+  // may differ, and in rare cases the polynomials of the next range don't start
+  // where those of the |trajectories_| end.  In that case, we stop appending
+  // the ranges and integrate sequentially from the checkpoint.
+  for (int r = 0;; ++r) {
+    std::vector<typename ContinuousTrajectory<Frame>::Checkpoint>
+        trajectory_checkpoints;
+    for (auto const& trajectory : trajectories_) {
+      trajectory_checkpoints.push_back(trajectory->GetCheckpoint());
+    }
+    checkpoints_.push_back(Checkpoint({std::move(checkpoint_instances[r]),
+                                       std::move(trajectory_checkpoints)}));
+    if (r + 1 == ranges.size()) {
+      break;
+    }
+    auto const& continuations = ranges[r + 1].continuations;
+    bool contiguous = true;
+    for (int i = 0; i < trajectories_.size(); ++i) {
+      contiguous &= trajectories_[i]->t_max() == continuations[i]->t_min();
+    }
+    if (!contiguous) {
+      LOG(WARNING) << "Ephemeris rebuild diverged at "
+                   << checkpoints_.back().instance->time().value
+                   << ", integrating sequentially";
+      break;
+    }
+    for (int i = 0; i < trajectories_.size(); ++i) {
+      trajectories_[i]->AppendContinuation(*continuations[i]);
+    }
+  }
+
+  instance_ = checkpoints_.back().instance->Clone();
+  ProlongLocked(t_max);
+}
+
 template<typename Frame>
 typename Ephemeris<Frame>::Checkpoint Ephemeris<Frame>::GetCheckpoint() {
   std::vector<typename ContinuousTrajectory<Frame>::Checkpoint> checkpoints;
@@ -876,9 +3232,8 @@ typename Ephemeris<Frame>::Checkpoint Ephemeris<Frame>::GetCheckpoint() {
 
 template<typename Frame>
 Instant Ephemeris<Frame>::t_max_locked() const {
-  Instant t_max = bodies_to_trajectories_.begin()->second->t_max();
-  for (auto const& pair : bodies_to_trajectories_) {
-    auto const& trajectory = pair.second;
+  Instant t_max = trajectories_.front()->t_max();
+  for (auto const& trajectory : trajectories_) {
     t_max = std::min(t_max, trajectory->t_max());
   }
   // Here we may have a checkpoint after |t_max| if the checkpointed state was
@@ -888,7 +3243,7 @@ Instant Ephemeris<Frame>::t_max_locked() const {
 
 template<typename Frame>
 Instant Ephemeris<Frame>::instance_time() const {
-  shared_lock_guard<base::shared_mutex> l(lock_);
+  std::lock_guard<std::mutex> l(integration_lock_);
   return instance_->time().value;
 }
 
@@ -964,13 +3319,20 @@ template<typename Frame>
 template<bool body1_is_oblate>
 bool Ephemeris<Frame>::
 ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
-    Instant const& t,
     MassiveBody const& body1,
     std::size_t const b1,
+    Position<Frame> const& position1,
     std::vector<Position<Frame>> const& positions,
     std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  if constexpr (body1_is_oblate) {
+    return ComputeGravitationalAccelerationsByOblateBodyOnMasslessBodies(
+        static_cast<OblateBody<Frame> const&>(body1),
+        position1,
+        positions,
+        accelerations);
+  }
+
   GravitationalParameter const& μ1 = body1.gravitational_parameter();
-  Position<Frame> const position1 = trajectories_[b1]->EvaluatePosition(t);
   Length const body1_mean_radius = body1.mean_radius();
   bool ok = true;
 
@@ -988,19 +3350,6 @@ ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
 
     auto const μ1_over_Δq³ = μ1 * one_over_Δq³;
     accelerations[b2] += Δq * μ1_over_Δq³;
-
-    if (body1_is_oblate) {
-      Exponentiation<Length, -2> const one_over_Δq² = 1 / Δq²;
-      Vector<Quotient<Acceleration,
-                      GravitationalParameter>, Frame> const
-          order_2_zonal_effect1 =
-              Order2ZonalAcceleration<Frame>(
-                  static_cast<OblateBody<Frame> const &>(body1),
-                  -Δq,
-                  one_over_Δq²,
-                  one_over_Δq³);
-      accelerations[b2] += μ1 * order_2_zonal_effect1;
-    }
   }
   return ok;
 }
@@ -1010,6 +3359,23 @@ void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerations(
     Instant const& t,
     std::vector<Position<Frame>> const& positions,
     std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  PRINCIPIA_PROFILE_SCOPE(EphemerisGravitationalAcceleration);
+  if (tree_.has_value()) {
+    ComputeMassiveBodiesGravitationalAccelerationsByTree(positions,
+                                                         accelerations);
+  } else if (massive_bodies_scheduler_ != nullptr) {
+    ComputeMassiveBodiesGravitationalAccelerationsByTiles(positions,
+                                                          accelerations);
+  } else {
+    ComputeMassiveBodiesGravitationalAccelerationsSerially(positions,
+                                                           accelerations);
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerationsSerially(
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations) const {
   accelerations.assign(accelerations.size(), Vector<Acceleration, Frame>());
 
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
@@ -1050,22 +3416,164 @@ void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerations(
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerationsByTiles(
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  std::size_t const number_of_bodies = bodies_.size();
+  CHECK_EQ(number_of_bodies, positions.size());
+  CHECK_EQ(number_of_bodies, accelerations.size());
+
+  for (std::size_t b = number_of_oblate_bodies_; b < number_of_bodies; ++b) {
+    q_.Set(b, positions[b]);
+  }
+
+  auto compute_tile = [this, number_of_bodies](SphericalBodiesTile& tile) {
+    auto& accelerations = tile.accelerations;
+    accelerations.resize(number_of_bodies);
+    accelerations.assign_zero();
+    ComputeGravitationalAccelerationsBetweenSphericalBodies(
+        μ_.data(0),
+        q_.data(0), q_.data(1), q_.data(2),
+        tile.b1_begin,
+        tile.b1_end,
+        number_of_bodies,
+        accelerations.data(0),
+        accelerations.data(1),
+        accelerations.data(2));
+  };
+
+  // The first tile is computed on this thread, after the oblate bodies, while
+  // the scheduler takes care of the others.
+  std::vector<Future<void>> futures;
+  futures.reserve(tiles_.size());
+  for (std::size_t i = 1; i < tiles_.size(); ++i) {
+    SphericalBodiesTile* const tile = &tiles_[i];
+    futures.push_back(massive_bodies_scheduler_->Add(
+        [&compute_tile, tile]() { compute_tile(*tile); }));
+  }
+
+  oblate_bodies_accelerations_.assign(number_of_bodies,
+                                      Vector<Acceleration, Frame>());
+  for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
+    MassiveBody const& body1 = *bodies_[b1];
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        /*body1_is_oblate=*/true,
+        /*body2_is_oblate=*/true>(
+        body1, b1,
+        /*bodies2=*/bodies_,
+        /*b2_begin=*/b1 + 1,
+        /*b2_end=*/number_of_oblate_bodies_,
+        positions,
+        oblate_bodies_accelerations_);
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        /*body1_is_oblate=*/true,
+        /*body2_is_oblate=*/false>(
+        body1, b1,
+        /*bodies2=*/bodies_,
+        /*b2_begin=*/number_of_oblate_bodies_,
+        /*b2_end=*/number_of_bodies,
+        positions,
+        oblate_bodies_accelerations_);
+  }
+  compute_tile(tiles_.front());
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  // Sum the contributions in a fixed order.
+  for (std::size_t b = 0; b < number_of_bodies; ++b) {
+    if (b < number_of_oblate_bodies_) {
+      accelerations[b] = oblate_bodies_accelerations_[b];
+      continue;
+    }
+    Vector<Acceleration, Frame> spherical_bodies_acceleration;
+    for (auto const& tile : tiles_) {
+      spherical_bodies_acceleration += tile.accelerations[b];
+    }
+    accelerations[b] =
+        oblate_bodies_accelerations_[b] + spherical_bodies_acceleration;
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerationsByTree(
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  accelerations.assign(accelerations.size(), Vector<Acceleration, Frame>());
+
+  // The oblate bodies interact pairwise with all the bodies.
+  for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
+    MassiveBody const& body1 = *bodies_[b1];
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        /*body1_is_oblate=*/true,
+        /*body2_is_oblate=*/true>(
+        body1, b1,
+        /*bodies2=*/bodies_,
+        /*b2_begin=*/b1 + 1,
+        /*b2_end=*/number_of_oblate_bodies_,
+        positions,
+        accelerations);
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        /*body1_is_oblate=*/true,
+        /*body2_is_oblate=*/false>(
+        body1, b1,
+        /*bodies2=*/bodies_,
+        /*b2_begin=*/number_of_oblate_bodies_,
+        /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
+        positions,
+        accelerations);
+  }
+  tree_->AddAccelerations(positions,
+                          /*begin=*/number_of_oblate_bodies_,
+                          accelerations);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::EvaluateTrajectoriesPositions(
+    Instant const& t,
+    std::vector<bool> const& culled_bodies,
+    std::vector<Position<Frame>>& positions) const {
+  positions.resize(trajectories_.size());
+  for (std::size_t b = 0; b < trajectories_.size(); ++b) {
+    if (culled_bodies.empty() || !culled_bodies[b]) {
+      positions[b] = trajectories_[b]->EvaluatePosition(t);
+    }
+  }
+}
+
 template<typename Frame>
 bool Ephemeris<Frame>::ComputeMasslessBodiesGravitationalAccelerations(
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
+      std::vector<bool> const& culled_bodies,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  PRINCIPIA_PROFILE_SCOPE(EphemerisGravitationalAcceleration);
   CHECK_EQ(positions.size(), accelerations.size());
   accelerations.assign(accelerations.size(), Vector<Acceleration, Frame>());
   bool ok = true;
 
-  shared_lock_guard<base::shared_mutex> l(lock_);
+  shared_lock_guard<ShardedSharedMutex> l(lock_);
+
+  // This vector is thread-local to avoid allocating at each call.
+  thread_local std::vector<Position<Frame>> massive_positions;
+  if (!position_cache_->Find(t, massive_positions)) {
+    EvaluateTrajectoriesPositions(t, culled_bodies, massive_positions);
+    // Only the complete evaluations may be shared.
+    if (culled_bodies.empty()) {
+      position_cache_->Insert(t, massive_positions);
+    }
+  }
+
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
+    if (!culled_bodies.empty() && culled_bodies[b1]) {
+      continue;
+    }
     MassiveBody const& body1 = *bodies_[b1];
     ok &= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
         /*body1_is_oblate=*/true>(
-        t,
         body1, b1,
+        massive_positions[b1],
         positions,
         accelerations);
   }
@@ -1073,11 +3581,14 @@ bool Ephemeris<Frame>::ComputeMasslessBodiesGravitationalAccelerations(
        b1 < number_of_oblate_bodies_ +
             number_of_spherical_bodies_;
        ++b1) {
+    if (!culled_bodies.empty() && culled_bodies[b1]) {
+      continue;
+    }
     MassiveBody const& body1 = *bodies_[b1];
     ok &= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
         /*body1_is_oblate=*/false>(
-        t,
         body1, b1,
+        massive_positions[b1],
         positions,
         accelerations);
   }
@@ -1089,16 +3600,18 @@ bool Ephemeris<Frame>::ComputeMasslessBodiesTotalAccelerations(
     IntrinsicAccelerations const& intrinsic_accelerations,
     Instant const& t,
     std::vector<Position<Frame>> const& positions,
+    std::vector<bool> const& culled_bodies,
     std::vector<Vector<Acceleration, Frame>>& accelerations) const {
   // First, the acceleration due to the gravitational field of the
   // massive bodies.
   bool const ok = ComputeMasslessBodiesGravitationalAccelerations(
-      t, positions, accelerations);
+      t, positions, culled_bodies, accelerations);
 
-  // Then, the intrinsic accelerations, if any.
+  // Then, the intrinsic accelerations, if any.  Note that copying the
+  // |IntrinsicAcceleration| here would allocate at every stage.
   if (!intrinsic_accelerations.empty()) {
     for (int i = 0; i < intrinsic_accelerations.size(); ++i) {
-      auto const intrinsic_acceleration = intrinsic_accelerations[i];
+      auto const& intrinsic_acceleration = intrinsic_accelerations[i];
       if (intrinsic_acceleration != nullptr) {
         accelerations[i] += intrinsic_acceleration(t);
       }
@@ -1107,24 +3620,36 @@ bool Ephemeris<Frame>::ComputeMasslessBodiesTotalAccelerations(
   return ok;
 }
 
+template<typename Frame>
+typename Ephemeris<Frame>::IntrinsicAccelerations const&
+Ephemeris<Frame>::EffectiveIntrinsicAccelerations(
+    IntrinsicAccelerations const& intrinsic_accelerations) {
+  for (auto const& intrinsic_acceleration : intrinsic_accelerations) {
+    if (intrinsic_acceleration != nullptr) {
+      return intrinsic_accelerations;
+    }
+  }
+  return NoIntrinsicAccelerations;
+}
+
 template<typename Frame>
 double Ephemeris<Frame>::ToleranceToErrorRatio(
-    Length const& length_integration_tolerance,
-    Speed const& speed_integration_tolerance,
+    std::vector<Length> const& length_integration_tolerances,
+    std::vector<Speed> const& speed_integration_tolerances,
     Time const& current_step_size,
     typename NewtonianMotionEquation::SystemStateError const& error) {
-  Length max_length_error;
-  Speed max_speed_error;
-  for (auto const& position_error : error.position_error) {
-    max_length_error = std::max(max_length_error,
-                                position_error.Norm());
-  }
-  for (auto const& velocity_error : error.velocity_error) {
-    max_speed_error = std::max(max_speed_error,
-                               velocity_error.Norm());
-  }
-  return std::min(length_integration_tolerance / max_length_error,
-                  speed_integration_tolerance / max_speed_error);
+  CHECK_EQ(length_integration_tolerances.size(), error.position_error.size());
+  CHECK_EQ(speed_integration_tolerances.size(), error.velocity_error.size());
+  double tolerance_to_error_ratio = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < error.position_error.size(); ++i) {
+    tolerance_to_error_ratio =
+        std::min({tolerance_to_error_ratio,
+                  length_integration_tolerances[i] /
+                      error.position_error[i].Norm(),
+                  speed_integration_tolerances[i] /
+                      error.velocity_error[i].Norm()});
+  }
+  return tolerance_to_error_ratio;
 }
 
 template<typename Frame>
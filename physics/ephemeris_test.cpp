@@ -1,14 +1,21 @@
 ﻿
 #include "physics/ephemeris.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <optional>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include "astronomy/frames.hpp"
+#include "base/array.hpp"
 #include "base/macros.hpp"
+#include "base/work_stealing_scheduler.hpp"
 #include "geometry/barycentre_calculator.hpp"
 #include "geometry/frame.hpp"
 #include "gmock/gmock.h"
@@ -40,7 +47,9 @@ namespace internal_ephemeris {
 
 using astronomy::ICRFJ2000Equator;
 using astronomy::SolarSystemBarycentreEquator;
+using base::Array;
 using base::not_null;
+using base::WorkStealingScheduler;
 using geometry::Barycentre;
 using geometry::AngularVelocity;
 using geometry::Displacement;
@@ -57,15 +66,20 @@ using integrators::methods::Quinlan1999Order8A;
 using quantities::Abs;
 using quantities::ArcTan;
 using quantities::Area;
+using quantities::Cos;
+using quantities::GravitationalParameter;
 using quantities::Mass;
 using quantities::Pow;
 using quantities::SIUnit;
+using quantities::Sin;
+using quantities::Speed;
 using quantities::Sqrt;
 using quantities::astronomy::JulianYear;
 using quantities::astronomy::LunarDistance;
 using quantities::astronomy::SolarMass;
 using quantities::constants::GravitationalConstant;
 using quantities::si::AstronomicalUnit;
+using quantities::si::Day;
 using quantities::si::Hour;
 using quantities::si::Kilo;
 using quantities::si::Kilogram;
@@ -81,6 +95,7 @@ using testing_utilities::RelativeError;
 using testing_utilities::SolarSystemFactory;
 using testing_utilities::StatusIs;
 using testing_utilities::VanishesBefore;
+using ::testing::AllOf;
 using ::testing::AnyOf;
 using ::testing::Eq;
 using ::testing::Gt;
@@ -265,6 +280,82 @@ TEST_P(EphemerisTest, FlowWithAdaptiveStepSpecialCase) {
       /*last_point_only=*/false));
 }
 
+TEST_P(EphemerisTest, FlowWithAdaptiveStepBefore) {
+  Length const distance = 1e9 * Metre;
+  Speed const velocity = 1e3 * Metre / Second;
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  Position<ICRFJ2000Equator> const earth_position =
+      initial_state[0].position();
+
+  Ephemeris<ICRFJ2000Equator>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          5 * Milli(Metre),
+          Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                           period / 100));
+
+  DegreesOfFreedom<ICRFJ2000Equator> const probe_degrees_of_freedom(
+      earth_position +
+          Displacement<ICRFJ2000Equator>({0 * Metre, distance, 0 * Metre}),
+      Velocity<ICRFJ2000Equator>({velocity, velocity, velocity}));
+  auto const parameters = [](std::int64_t const max_steps) {
+    return Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters(
+        EmbeddedExplicitRungeKuttaNyströmIntegrator<
+            DormandالمكاوىPrince1986RKN434FM,
+            Position<ICRFJ2000Equator>>(),
+        max_steps,
+        1e-9 * Metre,
+        2.6e-15 * Metre / Second);
+  };
+
+  // A deadline in the past stops the flow at the first check of the clock.
+  DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+  trajectory.Append(t0_, probe_degrees_of_freedom);
+  EXPECT_THAT(ephemeris.FlowWithAdaptiveStepBefore(
+                  &trajectory,
+                  Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+                  t0_ + period,
+                  parameters(max_steps),
+                  /*max_ephemeris_steps=*/1,
+                  std::chrono::steady_clock::now()),
+              StatusIs(Error::DEADLINE_EXCEEDED));
+  EXPECT_THAT(trajectory.Size(), Gt(1));
+  EXPECT_THAT(
+      trajectory.Size(),
+      Lt(2 + Ephemeris<ICRFJ2000Equator>::steps_between_deadline_checks));
+  EXPECT_THAT(trajectory.last().time(), Lt(t0_ + period));
+
+  // The flow resumes where it stopped, prolonging the ephemeris as needed.
+  EXPECT_OK(ephemeris.FlowWithAdaptiveStepBefore(
+      &trajectory,
+      Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+      t0_ + period,
+      parameters(max_steps),
+      /*max_ephemeris_steps=*/1,
+      std::chrono::steady_clock::now() + std::chrono::hours(1)));
+  EXPECT_EQ(t0_ + period, trajectory.last().time());
+
+  // The maximal number of steps is honoured across the checks of the clock.
+  DiscreteTrajectory<ICRFJ2000Equator> limited_trajectory;
+  limited_trajectory.Append(t0_, probe_degrees_of_freedom);
+  EXPECT_THAT(ephemeris.FlowWithAdaptiveStepBefore(
+                  &limited_trajectory,
+                  Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+                  t0_ + period,
+                  parameters(/*max_steps=*/25),
+                  /*max_ephemeris_steps=*/1,
+                  std::chrono::steady_clock::now() + std::chrono::hours(1)),
+              StatusIs(Error::ABORTED));
+  EXPECT_EQ(26, limited_trajectory.Size());
+}
+
 // The canonical Earth-Moon system, tuned to produce circular orbits.
 TEST_P(EphemerisTest, EarthMoon) {
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
@@ -724,6 +815,168 @@ TEST_P(EphemerisTest, Serialization) {
   EXPECT_THAT(message, EqualsProto(second_message));
 }
 
+TEST_P(EphemerisTest, SerializationWithCheckpoints) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  MassiveBody const* const earth = bodies[0].get();
+  MassiveBody const* const moon = bodies[1].get();
+
+  Ephemeris<ICRFJ2000Equator>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          5 * Milli(Metre),
+          Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                           period / 100));
+  ephemeris.Prolong(t0_ + 2 * JulianYear);
+
+  serialization::Ephemeris message;
+  ephemeris.WriteToMessage(&message);
+  EXPECT_LE(3, message.checkpoint_size());
+  for (auto const& checkpoint : message.checkpoint()) {
+    for (auto const& trajectory : checkpoint.trajectory()) {
+      EXPECT_EQ(0, trajectory.instant_polynomial_pair_size());
+    }
+  }
+
+  auto const ephemeris_read =
+      Ephemeris<ICRFJ2000Equator>::ReadFromMessage(message);
+  MassiveBody const* const earth_read = ephemeris_read->bodies()[0];
+  MassiveBody const* const moon_read = ephemeris_read->bodies()[1];
+
+  // Waits for the trajectories to be recomputed.
+  ephemeris_read->Prolong(ephemeris.t_max());
+  EXPECT_EQ(ephemeris.t_min(), ephemeris_read->t_min());
+  EXPECT_EQ(ephemeris.t_max(), ephemeris_read->t_max());
+  for (Instant time = ephemeris.t_min();
+       time <= ephemeris.t_max();
+       time += (ephemeris.t_max() - ephemeris.t_min()) / 1000) {
+    EXPECT_EQ(
+        ephemeris.trajectory(earth)->EvaluateDegreesOfFreedom(time),
+        ephemeris_read->trajectory(earth_read)->EvaluateDegreesOfFreedom(time));
+    EXPECT_EQ(
+        ephemeris.trajectory(moon)->EvaluateDegreesOfFreedom(time),
+        ephemeris_read->trajectory(moon_read)->EvaluateDegreesOfFreedom(time));
+  }
+
+  serialization::Ephemeris second_message;
+  ephemeris_read->WriteToMessage(&second_message);
+  EXPECT_THAT(message, EqualsProto(second_message));
+}
+
+TEST_P(EphemerisTest, Fork) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  MassiveBody const* const earth = bodies[0].get();
+  MassiveBody const* const moon = bodies[1].get();
+
+  Ephemeris<ICRFJ2000Equator>::FixedStepParameters const parameters(
+      integrator(), period / 100);
+  Ephemeris<ICRFJ2000Equator>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          5 * Milli(Metre),
+          parameters);
+  ephemeris.Prolong(t0_ + period);
+
+  Instant const fork_time = t0_ + period / 2;
+  auto const fork = ephemeris.Fork(fork_time, parameters);
+  MassiveBody const* const earth_fork = fork->bodies()[0];
+  MassiveBody const* const moon_fork = fork->bodies()[1];
+  EXPECT_EQ(earth->name(), earth_fork->name());
+  EXPECT_EQ(moon->name(), moon_fork->name());
+  EXPECT_EQ(ephemeris.t_min(), fork->t_min());
+  EXPECT_EQ(fork_time, fork->t_max());
+
+  fork->Prolong(t0_ + period);
+  EXPECT_EQ(ephemeris.t_min(), fork->t_min());
+  EXPECT_LE(t0_ + period, fork->t_max());
+  for (Instant time = t0_; time <= t0_ + period; time += period / 100) {
+    if (time <= fork_time) {
+      EXPECT_EQ(
+          ephemeris.trajectory(earth)->EvaluateDegreesOfFreedom(time),
+          fork->trajectory(earth_fork)->EvaluateDegreesOfFreedom(time));
+      EXPECT_EQ(
+          ephemeris.trajectory(moon)->EvaluateDegreesOfFreedom(time),
+          fork->trajectory(moon_fork)->EvaluateDegreesOfFreedom(time));
+    } else {
+      EXPECT_THAT(
+          AbsoluteError(
+              ephemeris.trajectory(earth)->EvaluatePosition(time),
+              fork->trajectory(earth_fork)->EvaluatePosition(time)),
+          Lt(1 * Kilo(Metre)));
+      EXPECT_THAT(
+          AbsoluteError(
+              ephemeris.trajectory(moon)->EvaluatePosition(time),
+              fork->trajectory(moon_fork)->EvaluatePosition(time)),
+          Lt(1 * Kilo(Metre)));
+    }
+  }
+}
+
+TEST_P(EphemerisTest, Snapshot) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  MassiveBody const* const earth = bodies[0].get();
+  MassiveBody const* const moon = bodies[1].get();
+
+  Ephemeris<ICRFJ2000Equator>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          5 * Milli(Metre),
+          Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                           period / 100));
+  ephemeris.Prolong(t0_ + period);
+
+  std::vector<std::uint8_t> bytes;
+  ephemeris.WriteToSnapshot(&bytes);
+
+  // Read from a misaligned copy, as might happen with a memory-mapped file.
+  std::vector<std::uint8_t> misaligned(bytes.size() + 1);
+  std::copy(bytes.begin(), bytes.end(), misaligned.begin() + 1);
+  auto const ephemeris_read = Ephemeris<ICRFJ2000Equator>::ReadFromSnapshot(
+      Array<std::uint8_t const>(misaligned.data() + 1, bytes.size()));
+  MassiveBody const* const earth_read = ephemeris_read->bodies()[0];
+  MassiveBody const* const moon_read = ephemeris_read->bodies()[1];
+
+  EXPECT_EQ(ephemeris.t_min(), ephemeris_read->t_min());
+  EXPECT_EQ(ephemeris.t_max(), ephemeris_read->t_max());
+  for (Instant time = ephemeris.t_min();
+       time <= ephemeris.t_max();
+       time += (ephemeris.t_max() - ephemeris.t_min()) / 100) {
+    EXPECT_EQ(
+        ephemeris.trajectory(earth)->EvaluateDegreesOfFreedom(time),
+        ephemeris_read->trajectory(earth_read)->EvaluateDegreesOfFreedom(time));
+    EXPECT_EQ(
+        ephemeris.trajectory(moon)->EvaluateDegreesOfFreedom(time),
+        ephemeris_read->trajectory(moon_read)->EvaluateDegreesOfFreedom(time));
+  }
+
+  // The snapshot describes the same state as the message.
+  serialization::Ephemeris message;
+  ephemeris.WriteToMessage(&message);
+  serialization::Ephemeris second_message;
+  ephemeris_read->WriteToMessage(&second_message);
+  EXPECT_THAT(message, EqualsProto(second_message));
+}
+
 // The gravitational acceleration on an elephant located at the pole.
 TEST_P(EphemerisTest, ComputeGravitationalAccelerationMasslessBody) {
   Time const duration = 1 * Second;
@@ -861,6 +1114,207 @@ TEST_P(EphemerisTest, CollisionDetection) {
               StatusIs(Error::OUT_OF_RANGE));
 }
 
+// Checks that an impact is detected when a probe grazes the Earth between the
+// stages of a long adaptive step.
+TEST_P(EphemerisTest, GrazingImpact) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+
+  auto earth = SolarSystem<ICRFJ2000Equator>::MakeMassiveBody(
+      solar_system_.gravity_model_message("Earth"));
+  Length const earth_mean_radius = earth->mean_radius();
+  Position<ICRFJ2000Equator> const earth_position = ICRFJ2000Equator::origin;
+
+  bodies.push_back(std::move(earth));
+  initial_state.emplace_back(earth_position, Velocity<ICRFJ2000Equator>());
+
+  Ephemeris<ICRFJ2000Equator> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                       10 * Second));
+
+  // The probe crosses the surface of the Earth after about 97.2 s and stays
+  // inside for about 5.5 s.
+  DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+  trajectory.Append(
+      t0_,
+      DegreesOfFreedom<ICRFJ2000Equator>(
+          earth_position +
+              Displacement<ICRFJ2000Equator>(
+                  {-1e8 * Metre, 0.9 * earth_mean_radius, 0 * Metre}),
+          Velocity<ICRFJ2000Equator>(
+              {1e6 * Metre / Second, 0 * Metre / Second, 0 * Metre / Second})));
+
+  // The collision is not reported as an error, the flow just stops.
+  EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+      &trajectory,
+      Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+      t0_ + 200 * Second,
+      Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Position<ICRFJ2000Equator>>(),
+          max_steps,
+          1 * Kilo(Metre),
+          1 * Metre / Second),
+      Ephemeris<ICRFJ2000Equator>::unlimited_max_ephemeris_steps,
+      /*last_point_only=*/false));
+  EXPECT_THAT(
+      (trajectory.last().degrees_of_freedom().position() - earth_position)
+          .Norm(),
+      AllOf(Gt(earth_mean_radius - 10 * Kilo(Metre)),
+            Lt(earth_mean_radius + 10 * Kilo(Metre))));
+  EXPECT_THAT(trajectory.last().time() - t0_,
+              AllOf(Gt(96 * Second), Lt(98.5 * Second)));
+}
+
+// Checks that the accelerations exerted by an oblate body on massless bodies
+// that are integrated together, and thus processed in pairs, are the same as
+// those on massless bodies that are integrated separately.
+TEST_P(EphemerisTest, OblateBodyOnManyMasslessBodies) {
+  Time const duration = 1000 * Second;
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+
+  auto earth = SolarSystem<ICRFJ2000Equator>::MakeMassiveBody(
+      solar_system_.gravity_model_message("Earth"));
+  Speed const v = Sqrt(earth->gravitational_parameter() / (1e7 * Metre));
+  bodies.push_back(std::move(earth));
+  initial_state.emplace_back(ICRFJ2000Equator::origin,
+                             Velocity<ICRFJ2000Equator>());
+
+  Ephemeris<ICRFJ2000Equator> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                       duration / 100));
+
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> const probes = {
+      {ICRFJ2000Equator::origin + Displacement<ICRFJ2000Equator>(
+                                      {1e7 * Metre, 0 * Metre, 0 * Metre}),
+       Velocity<ICRFJ2000Equator>(
+           {0 * Metre / Second, v, 0 * Metre / Second})},
+      {ICRFJ2000Equator::origin + Displacement<ICRFJ2000Equator>(
+                                      {0 * Metre, 6e6 * Metre, 8e6 * Metre}),
+       Velocity<ICRFJ2000Equator>(
+           {v, 0 * Metre / Second, 0 * Metre / Second})},
+      {ICRFJ2000Equator::origin + Displacement<ICRFJ2000Equator>(
+                                      {-6e6 * Metre, 0 * Metre, -8e6 * Metre}),
+       Velocity<ICRFJ2000Equator>(
+           {0 * Metre / Second, 0 * Metre / Second, v})}};
+
+  auto const parameters = Ephemeris<ICRFJ2000Equator>::FixedStepParameters(
+      SymmetricLinearMultistepIntegrator<Quinlan1999Order8A,
+                                         Position<ICRFJ2000Equator>>(),
+      1 * Second);
+
+  std::vector<DiscreteTrajectory<ICRFJ2000Equator>> batched_trajectories(
+      probes.size());
+  std::vector<not_null<DiscreteTrajectory<ICRFJ2000Equator>*>> batch;
+  for (int i = 0; i < probes.size(); ++i) {
+    batched_trajectories[i].Append(t0_, probes[i]);
+    batch.push_back(&batched_trajectories[i]);
+  }
+  auto const batched_instance = ephemeris.NewInstance(
+      batch,
+      Ephemeris<ICRFJ2000Equator>::NoIntrinsicAccelerations,
+      parameters);
+  EXPECT_OK(ephemeris.FlowWithFixedStep(t0_ + duration, *batched_instance));
+
+  for (int i = 0; i < probes.size(); ++i) {
+    DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+    trajectory.Append(t0_, probes[i]);
+    auto const instance = ephemeris.NewInstance(
+        {&trajectory},
+        Ephemeris<ICRFJ2000Equator>::NoIntrinsicAccelerations,
+        parameters);
+    EXPECT_OK(ephemeris.FlowWithFixedStep(t0_ + duration, *instance));
+
+    ASSERT_EQ(trajectory.Size(), batched_trajectories[i].Size());
+    EXPECT_EQ(trajectory.last().time(), batched_trajectories[i].last().time());
+    EXPECT_EQ(trajectory.last().degrees_of_freedom(),
+              batched_trajectories[i].last().degrees_of_freedom());
+  }
+}
+
+TEST_P(EphemerisTest, EvaluateAllPositions) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+
+  // A spherical body followed by an oblate one, which the ephemeris stores in
+  // the opposite order.
+  auto earth = SolarSystem<ICRFJ2000Equator>::MakeMassiveBody(
+      solar_system_.gravity_model_message("Earth"));
+  ASSERT_TRUE(earth->is_oblate());
+  Length const moon_r = 4e8 * Metre;
+  Speed const moon_v = Sqrt(earth->gravitational_parameter() / moon_r);
+  bodies.push_back(std::make_unique<MassiveBody>(7e22 * Kilogram));
+  initial_state.emplace_back(
+      ICRFJ2000Equator::origin + Displacement<ICRFJ2000Equator>(
+                                     {moon_r, 0 * Metre, 0 * Metre}),
+      Velocity<ICRFJ2000Equator>(
+          {0 * Metre / Second, moon_v, 0 * Metre / Second}));
+  bodies.push_back(std::move(earth));
+  initial_state.emplace_back(ICRFJ2000Equator::origin,
+                             Velocity<ICRFJ2000Equator>());
+
+  Ephemeris<ICRFJ2000Equator> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                       10 * Minute));
+  ephemeris.Prolong(t0_ + 1 * Day);
+
+  // The body indices follow the order of |bodies()|, not the internal order.
+  for (int i = 0; i < ephemeris.bodies().size(); ++i) {
+    auto const body = ephemeris.bodies()[i];
+    EXPECT_EQ(i, ephemeris.body_index(body));
+    EXPECT_EQ(ephemeris.trajectory(body),
+              ephemeris.trajectory_for_body_index(i));
+  }
+  EXPECT_NE(ephemeris.trajectory_for_body_index(0),
+            ephemeris.trajectory_for_body_index(1));
+
+  std::vector<Position<ICRFJ2000Equator>> positions;
+  for (Instant t = t0_; t < t0_ + 1 * Day; t += 0.37 * Hour) {
+    ephemeris.EvaluateAllPositions(t, positions);
+    ASSERT_EQ(2, positions.size());
+    for (int i = 0; i < positions.size(); ++i) {
+      EXPECT_EQ(
+          ephemeris.trajectory(ephemeris.bodies()[i])->EvaluatePosition(t),
+          positions[i]) << i << " " << t;
+    }
+  }
+
+  // Threads evaluating at the same times share the positions through the
+  // cache, and get the same results as the trajectories.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([this, &ephemeris]() {
+      std::vector<Position<ICRFJ2000Equator>> positions;
+      for (int j = 0; j < 1000; ++j) {
+        Instant const t = t0_ + (j % 100) * 0.24 * Hour;
+        ephemeris.EvaluateAllPositions(t, positions);
+        for (int b = 0; b < positions.size(); ++b) {
+          EXPECT_EQ(
+              ephemeris.trajectory(ephemeris.bodies()[b])->EvaluatePosition(t),
+              positions[b]) << b << " " << t;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TEST_P(EphemerisTest, ComputeGravitationalAccelerationMassiveBody) {
   Time const duration = 1 * Second;
   double const j2 = 1e6;
@@ -1076,6 +1530,781 @@ TEST_P(EphemerisTest, ComputeApsidesContinuousTrajectory) {
   }
 }
 
+TEST_P(EphemerisTest, ComputeApsidesBulk) {
+  SolarSystem<ICRFJ2000Equator> solar_system(
+      SOLUTION_DIR / "astronomy" / "test_gravity_model_two_bodies.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "test_initial_state_two_bodies_elliptical.proto.txt");
+  Instant const t0 = solar_system.epoch();
+  Time const T =
+      16000 * π / (Sqrt(7) * std::pow(73 - 8 * Sqrt(35), 1.5)) * Second;
+
+  auto ephemeris = solar_system.MakeEphemeris(
+      /*fitting_tolerance=*/1 * Milli(Metre),
+      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(
+          SymplecticRungeKuttaNyströmIntegrator<McLachlanAtela1992Order4Optimal,
+                                                Position<ICRFJ2000Equator>>(),
+          /*step=*/10 * Milli(Second)));
+  ephemeris->Prolong(t0 + 10 * T);
+
+  MassiveBody const* const big =
+      solar_system.massive_body(*ephemeris, big_name);
+  MassiveBody const* const small =
+      solar_system.massive_body(*ephemeris, small_name);
+
+  DiscreteTrajectory<ICRFJ2000Equator> expected_apoapsides1;
+  DiscreteTrajectory<ICRFJ2000Equator> expected_periapsides1;
+  DiscreteTrajectory<ICRFJ2000Equator> expected_apoapsides2;
+  DiscreteTrajectory<ICRFJ2000Equator> expected_periapsides2;
+  ephemeris->ComputeApsides(big,
+                            small,
+                            expected_apoapsides1,
+                            expected_periapsides1,
+                            expected_apoapsides2,
+                            expected_periapsides2);
+
+  // The same pair twice, in both orders.
+  std::array<DiscreteTrajectory<ICRFJ2000Equator>, 8> apsides;
+  std::vector<Ephemeris<ICRFJ2000Equator>::ApsidesComputation> const
+      computations = {{big, small,
+                       &apsides[0], &apsides[1], &apsides[2], &apsides[3]},
+                      {small, big,
+                       &apsides[4], &apsides[5], &apsides[6], &apsides[7]}};
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+  ephemeris->ComputeApsides(computations, &scheduler);
+
+  auto const expect_same_apsides =
+      [](DiscreteTrajectory<ICRFJ2000Equator> const& expected,
+         DiscreteTrajectory<ICRFJ2000Equator> const& actual) {
+        ASSERT_EQ(expected.Size(), actual.Size());
+        for (auto it1 = expected.Begin(), it2 = actual.Begin();
+             it1 != expected.End();
+             ++it1, ++it2) {
+          EXPECT_LT(AbsoluteError(it1.time(), it2.time()), 1 * Milli(Second));
+          EXPECT_LT(AbsoluteError(it1.degrees_of_freedom().position(),
+                                  it2.degrees_of_freedom().position()),
+                    1 * Milli(Metre));
+        }
+      };
+  EXPECT_EQ(10, expected_apoapsides1.Size());
+  EXPECT_EQ(10, expected_periapsides1.Size());
+  expect_same_apsides(expected_apoapsides1, apsides[0]);
+  expect_same_apsides(expected_periapsides1, apsides[1]);
+  expect_same_apsides(expected_apoapsides2, apsides[2]);
+  expect_same_apsides(expected_periapsides2, apsides[3]);
+  expect_same_apsides(expected_apoapsides2, apsides[4]);
+  expect_same_apsides(expected_periapsides2, apsides[5]);
+  expect_same_apsides(expected_apoapsides1, apsides[6]);
+  expect_same_apsides(expected_periapsides1, apsides[7]);
+}
+
+// Two probes around the Earth, integrated together with different tolerances
+// and separately.  The batched integration must honour the tightest tolerance.
+TEST_P(EphemerisTest, FlowManyWithAdaptiveStep) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  bodies.erase(bodies.begin() + 1);
+  initial_state.erase(initial_state.begin() + 1);
+
+  MassiveBody const* const earth = bodies[0].get();
+  Position<ICRFJ2000Equator> const earth_position =
+      initial_state[0].position();
+  Velocity<ICRFJ2000Equator> const earth_velocity =
+      initial_state[0].velocity();
+
+  Ephemeris<ICRFJ2000Equator>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          5 * Milli(Metre),
+          Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                           period / 100));
+
+  Length const distance = 1e8 * Metre;
+  Speed const v = Sqrt(earth->gravitational_parameter() / distance);
+  DegreesOfFreedom<ICRFJ2000Equator> const degrees_of_freedom1(
+      earth_position + Displacement<ICRFJ2000Equator>(
+                           {0 * Metre, distance, 0 * Metre}),
+      earth_velocity + Velocity<ICRFJ2000Equator>(
+                           {v, 0 * Metre / Second, 0 * Metre / Second}));
+  DegreesOfFreedom<ICRFJ2000Equator> const degrees_of_freedom2(
+      earth_position + Displacement<ICRFJ2000Equator>(
+                           {0 * Metre, 0 * Metre, 2 * distance}),
+      earth_velocity + Velocity<ICRFJ2000Equator>(
+                           {0 * Metre / Second, v, 0 * Metre / Second}));
+
+  auto const loose_parameters =
+      Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Position<ICRFJ2000Equator>>(),
+          max_steps,
+          1 * Metre,
+          1 * Metre / Second);
+  auto const tight_parameters =
+      Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Position<ICRFJ2000Equator>>(),
+          max_steps,
+          1e-3 * Metre,
+          1e-6 * Metre / Second);
+
+  DiscreteTrajectory<ICRFJ2000Equator> batched_trajectory1;
+  DiscreteTrajectory<ICRFJ2000Equator> batched_trajectory2;
+  DiscreteTrajectory<ICRFJ2000Equator> trajectory2;
+  batched_trajectory1.Append(t0_, degrees_of_freedom1);
+  batched_trajectory2.Append(t0_, degrees_of_freedom2);
+  trajectory2.Append(t0_, degrees_of_freedom2);
+
+  EXPECT_OK(ephemeris.FlowManyWithAdaptiveStep(
+      {&batched_trajectory1, &batched_trajectory2},
+      Ephemeris<ICRFJ2000Equator>::NoIntrinsicAccelerations,
+      t0_ + period,
+      {loose_parameters, tight_parameters},
+      Ephemeris<ICRFJ2000Equator>::unlimited_max_ephemeris_steps,
+      /*last_point_only=*/false));
+  EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+      &trajectory2,
+      Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+      t0_ + period,
+      tight_parameters,
+      Ephemeris<ICRFJ2000Equator>::unlimited_max_ephemeris_steps,
+      /*last_point_only=*/false));
+
+  // The two batched trajectories have the same times, and the step size was
+  // controlled by the tighter tolerance.
+  EXPECT_EQ(batched_trajectory1.Size(), batched_trajectory2.Size());
+  EXPECT_EQ(t0_ + period, batched_trajectory1.last().time());
+  EXPECT_EQ(t0_ + period, batched_trajectory2.last().time());
+  EXPECT_LE(trajectory2.Size(), batched_trajectory2.Size());
+  EXPECT_THAT((batched_trajectory2.last().degrees_of_freedom().position() -
+               trajectory2.last().degrees_of_freedom().position()).Norm(),
+              Lt(1 * Metre));
+}
+
+TEST_P(EphemerisTest, FlowIndependentlyWithAdaptiveStep) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  Position<ICRFJ2000Equator> const earth_position =
+      initial_state[0].position();
+  Velocity<ICRFJ2000Equator> const earth_velocity =
+      initial_state[0].velocity();
+  GravitationalParameter const earth_μ = bodies[0]->gravitational_parameter();
+
+  Ephemeris<ICRFJ2000Equator>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          5 * Milli(Metre),
+          Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                           period / 100));
+
+  auto const parameters =
+      Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Position<ICRFJ2000Equator>>(),
+          max_steps,
+          1e-3 * Metre,
+          1e-6 * Metre / Second);
+
+  // Probes on circular orbits of increasing radii around the Earth.
+  int const number_of_probes = 10;
+  std::vector<DiscreteTrajectory<ICRFJ2000Equator>> serial_trajectories(
+      number_of_probes);
+  std::vector<DiscreteTrajectory<ICRFJ2000Equator>> parallel_trajectories(
+      number_of_probes);
+  std::vector<not_null<DiscreteTrajectory<ICRFJ2000Equator>*>> trajectories;
+  for (int i = 0; i < number_of_probes; ++i) {
+    Length const distance = (1 + i) * 1e7 * Metre;
+    Speed const v = Sqrt(earth_μ / distance);
+    DegreesOfFreedom<ICRFJ2000Equator> const degrees_of_freedom(
+        earth_position + Displacement<ICRFJ2000Equator>(
+                             {0 * Metre, distance, 0 * Metre}),
+        earth_velocity + Velocity<ICRFJ2000Equator>(
+                             {v, 0 * Metre / Second, 0 * Metre / Second}));
+    serial_trajectories[i].Append(t0_, degrees_of_freedom);
+    parallel_trajectories[i].Append(t0_, degrees_of_freedom);
+    trajectories.push_back(&parallel_trajectories[i]);
+  }
+
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+  auto const statuses = ephemeris.FlowIndependentlyWithAdaptiveStep(
+      trajectories,
+      Ephemeris<ICRFJ2000Equator>::NoIntrinsicAccelerations,
+      t0_ + period / 10,
+      std::vector<Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters>(
+          number_of_probes, parameters),
+      Ephemeris<ICRFJ2000Equator>::unlimited_max_ephemeris_steps,
+      /*last_point_only=*/false,
+      &scheduler);
+  ASSERT_EQ(number_of_probes, statuses.size());
+
+  for (int i = 0; i < number_of_probes; ++i) {
+    EXPECT_OK(statuses[i]);
+    EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+        &serial_trajectories[i],
+        Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+        t0_ + period / 10,
+        parameters,
+        Ephemeris<ICRFJ2000Equator>::unlimited_max_ephemeris_steps,
+        /*last_point_only=*/false));
+    EXPECT_EQ(serial_trajectories[i].Size(), parallel_trajectories[i].Size());
+    EXPECT_EQ(serial_trajectories[i].last().time(),
+              parallel_trajectories[i].last().time());
+    EXPECT_EQ(serial_trajectories[i].last().degrees_of_freedom(),
+              parallel_trajectories[i].last().degrees_of_freedom());
+  }
+  // The probes far from the Earth take longer steps.
+  EXPECT_LT(parallel_trajectories.back().Size(),
+            parallel_trajectories.front().Size());
+}
+
+// Checks that the tiled computation of the accelerations between massive
+// bodies doesn't depend on the number of threads and is close to the serial
+// one.
+TEST_P(EphemerisTest, MassiveBodiesScheduler) {
+  int const number_of_small_bodies = 200;
+  Time const step = 1 * Day;
+  Instant const t_final = t0_ + 30 * Day;
+
+  auto make_ephemeris = [this, number_of_small_bodies, step]() {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+    bodies.emplace_back(std::make_unique<OblateBody<ICRFJ2000Equator>>(
+        1 * SolarMass,
+        RotatingBody<ICRFJ2000Equator>::Parameters(1 * Metre,
+                                                   1 * Radian,
+                                                   t0_,
+                                                   4 * Radian / Second,
+                                                   0 * Radian,
+                                                   π / 2 * Radian),
+        OblateBody<ICRFJ2000Equator>::Parameters(1e-3, 1 * LunarDistance)));
+    initial_state.emplace_back(ICRFJ2000Equator::origin,
+                               Velocity<ICRFJ2000Equator>());
+    GravitationalParameter const μ = bodies.front()->gravitational_parameter();
+    for (int i = 0; i < number_of_small_bodies; ++i) {
+      bodies.emplace_back(std::make_unique<MassiveBody>(1e20 * Kilogram));
+      Length const r = (1 + 0.01 * i) * AstronomicalUnit;
+      double const cos_i = Cos(i * Radian);
+      double const sin_i = Sin(i * Radian);
+      Speed const v = Sqrt(μ / r);
+      initial_state.emplace_back(
+          ICRFJ2000Equator::origin +
+              Displacement<ICRFJ2000Equator>(
+                  {r * cos_i, r * sin_i, 1e-3 * r * sin_i}),
+          Velocity<ICRFJ2000Equator>({-v * sin_i, v * cos_i, 0 * v}));
+    }
+    return std::make_unique<Ephemeris<ICRFJ2000Equator>>(
+        std::move(bodies),
+        initial_state,
+        t0_,
+        5 * Milli(Metre),
+        Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(), step));
+  };
+
+  auto const serial_ephemeris = make_ephemeris();
+  auto const sequential_ephemeris = make_ephemeris();
+  auto const parallel_ephemeris = make_ephemeris();
+  WorkStealingScheduler sequential_scheduler(/*pool_size=*/1);
+  WorkStealingScheduler parallel_scheduler(/*pool_size=*/3);
+  sequential_ephemeris->SetMassiveBodiesScheduler(&sequential_scheduler);
+  parallel_ephemeris->SetMassiveBodiesScheduler(&parallel_scheduler);
+
+  serial_ephemeris->Prolong(t_final);
+  sequential_ephemeris->Prolong(t_final);
+  parallel_ephemeris->Prolong(t_final);
+
+  for (int i = 0; i <= number_of_small_bodies; ++i) {
+    Position<ICRFJ2000Equator> const serial_position =
+        serial_ephemeris->trajectory(serial_ephemeris->bodies()[i])
+            ->EvaluatePosition(t_final);
+    Position<ICRFJ2000Equator> const sequential_position =
+        sequential_ephemeris->trajectory(sequential_ephemeris->bodies()[i])
+            ->EvaluatePosition(t_final);
+    Position<ICRFJ2000Equator> const parallel_position =
+        parallel_ephemeris->trajectory(parallel_ephemeris->bodies()[i])
+            ->EvaluatePosition(t_final);
+    EXPECT_EQ(sequential_position, parallel_position) << i;
+    EXPECT_THAT((serial_position - parallel_position).Norm(),
+                Lt(1 * Milli(Metre))) << i;
+  }
+}
+
+// Checks that the approximation of the accelerations between the massive
+// bodies by a tree stays close to the pairwise computation.
+TEST_P(EphemerisTest, MassiveBodiesTree) {
+  int const number_of_small_bodies = 200;
+  Time const step = 1 * Day;
+  Instant const t_final = t0_ + 30 * Day;
+
+  auto make_ephemeris = [this, number_of_small_bodies, step]() {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+    bodies.emplace_back(std::make_unique<OblateBody<ICRFJ2000Equator>>(
+        1 * SolarMass,
+        RotatingBody<ICRFJ2000Equator>::Parameters(1 * Metre,
+                                                   1 * Radian,
+                                                   t0_,
+                                                   4 * Radian / Second,
+                                                   0 * Radian,
+                                                   π / 2 * Radian),
+        OblateBody<ICRFJ2000Equator>::Parameters(1e-3, 1 * LunarDistance)));
+    initial_state.emplace_back(ICRFJ2000Equator::origin,
+                               Velocity<ICRFJ2000Equator>());
+    GravitationalParameter const μ = bodies.front()->gravitational_parameter();
+    for (int i = 0; i < number_of_small_bodies; ++i) {
+      bodies.emplace_back(std::make_unique<MassiveBody>(1e20 * Kilogram));
+      Length const r = (1 + 0.01 * i) * AstronomicalUnit;
+      double const cos_i = Cos(i * Radian);
+      double const sin_i = Sin(i * Radian);
+      Speed const v = Sqrt(μ / r);
+      initial_state.emplace_back(
+          ICRFJ2000Equator::origin +
+              Displacement<ICRFJ2000Equator>(
+                  {r * cos_i, r * sin_i, 1e-3 * r * sin_i}),
+          Velocity<ICRFJ2000Equator>({-v * sin_i, v * cos_i, 0 * v}));
+    }
+    return std::make_unique<Ephemeris<ICRFJ2000Equator>>(
+        std::move(bodies),
+        initial_state,
+        t0_,
+        5 * Milli(Metre),
+        Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(), step));
+  };
+
+  auto const serial_ephemeris = make_ephemeris();
+  auto const tree_ephemeris = make_ephemeris();
+  tree_ephemeris->SetMassiveBodiesTreeEvaluation(true);
+
+  serial_ephemeris->Prolong(t_final);
+  tree_ephemeris->Prolong(t_final);
+
+  for (int i = 0; i <= number_of_small_bodies; ++i) {
+    Position<ICRFJ2000Equator> const serial_position =
+        serial_ephemeris->trajectory(serial_ephemeris->bodies()[i])
+            ->EvaluatePosition(t_final);
+    Position<ICRFJ2000Equator> const tree_position =
+        tree_ephemeris->trajectory(tree_ephemeris->bodies()[i])
+            ->EvaluatePosition(t_final);
+    EXPECT_THAT((serial_position - tree_position).Norm(),
+                Lt(1 * Metre)) << i;
+  }
+}
+
+// Checks that neglecting the Moon for a probe in low Earth orbit stays within
+// the bound given by the culling threshold.
+TEST_P(EphemerisTest, MasslessBodiesCulling) {
+  double const threshold = 1e-4;
+  Length const radius = 7000 * Kilo(Metre);
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  GravitationalParameter const μ = bodies[0]->gravitational_parameter();
+  Position<ICRFJ2000Equator> const earth_position =
+      initial_state[0].position();
+  Velocity<ICRFJ2000Equator> const earth_velocity =
+      initial_state[0].velocity();
+  Time const duration = 2 * π * Sqrt(Pow<3>(radius) / μ);
+
+  Ephemeris<ICRFJ2000Equator> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                       period / 100));
+
+  auto flow = [&ephemeris,
+               &duration,
+               &earth_position,
+               &earth_velocity,
+               &radius,
+               &μ,
+               this]() {
+    DiscreteTrajectory<ICRFJ2000Equator> trajectory;
+    trajectory.Append(
+        t0_,
+        DegreesOfFreedom<ICRFJ2000Equator>(
+            earth_position + Displacement<ICRFJ2000Equator>(
+                                 {radius, 0 * Metre, 0 * Metre}),
+            earth_velocity + Velocity<ICRFJ2000Equator>(
+                                 {0 * Metre / Second,
+                                  Sqrt(μ / radius),
+                                  0 * Metre / Second})));
+    EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+        &trajectory,
+        Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+        t0_ + duration,
+        Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters(
+            EmbeddedExplicitRungeKuttaNyströmIntegrator<
+                DormandالمكاوىPrince1986RKN434FM,
+                Position<ICRFJ2000Equator>>(),
+            max_steps,
+            1e-3 * Metre,
+            1e-6 * Metre / Second),
+        Ephemeris<ICRFJ2000Equator>::unlimited_max_ephemeris_steps,
+        /*last_point_only=*/true));
+    return trajectory.last().degrees_of_freedom().position();
+  };
+
+  Position<ICRFJ2000Equator> const exact_position = flow();
+  ephemeris.SetMasslessBodiesCullingThreshold(threshold);
+  Position<ICRFJ2000Equator> const culled_position = flow();
+
+  // The Moon was neglected, and the error is what a constant acceleration of
+  // |threshold| times that of the Earth would produce.
+  Length const error = (exact_position - culled_position).Norm();
+  EXPECT_THAT(error, Gt(0 * Metre));
+  EXPECT_THAT(error, Lt(0.5 * threshold * μ / Pow<2>(radius) *
+                        Pow<2>(duration)));
+}
+
+TEST_P(EphemerisTest, Encke) {
+  Length const radius = 7000 * Kilo(Metre);
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  GravitationalParameter const μ = bodies[0]->gravitational_parameter();
+  Position<ICRFJ2000Equator> const earth_position =
+      initial_state[0].position();
+  Velocity<ICRFJ2000Equator> const earth_velocity =
+      initial_state[0].velocity();
+  Time const duration = 20 * π * Sqrt(Pow<3>(radius) / μ);
+
+  Ephemeris<ICRFJ2000Equator> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                       period / 100));
+
+  auto flow = [&ephemeris,
+               &duration,
+               &earth_position,
+               &earth_velocity,
+               &radius,
+               &μ,
+               this](std::optional<double> const& rectification_threshold,
+                     DiscreteTrajectory<ICRFJ2000Equator>& trajectory) {
+    trajectory.Append(
+        t0_,
+        DegreesOfFreedom<ICRFJ2000Equator>(
+            earth_position + Displacement<ICRFJ2000Equator>(
+                                 {radius, 0 * Metre, 0 * Metre}),
+            earth_velocity + Velocity<ICRFJ2000Equator>(
+                                 {0 * Metre / Second,
+                                  1.1 * Sqrt(μ / radius),
+                                  0 * Metre / Second})));
+    Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters parameters(
+        EmbeddedExplicitRungeKuttaNyströmIntegrator<
+            DormandالمكاوىPrince1986RKN434FM,
+            Position<ICRFJ2000Equator>>(),
+        max_steps,
+        1e-3 * Metre,
+        1e-6 * Metre / Second);
+    parameters.set_encke_rectification_threshold(rectification_threshold);
+    EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+        &trajectory,
+        Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+        t0_ + duration,
+        parameters,
+        Ephemeris<ICRFJ2000Equator>::unlimited_max_ephemeris_steps,
+        /*last_point_only=*/false));
+    EXPECT_EQ(t0_ + duration, trajectory.last().time());
+  };
+
+  DiscreteTrajectory<ICRFJ2000Equator> cowell_trajectory;
+  DiscreteTrajectory<ICRFJ2000Equator> encke_trajectory;
+  flow(/*rectification_threshold=*/std::nullopt, cowell_trajectory);
+  flow(/*rectification_threshold=*/1e-2, encke_trajectory);
+
+  // The Moon barely perturbs the orbit, so the deviation from the osculating
+  // orbit is smooth and the steps are much longer.
+  EXPECT_THAT(encke_trajectory.Size(), Lt(cowell_trajectory.Size() / 2));
+  EXPECT_THAT((encke_trajectory.last().degrees_of_freedom().position() -
+               cowell_trajectory.last().degrees_of_freedom().position())
+                  .Norm(),
+              Lt(1 * Metre));
+}
+
+TEST_P(EphemerisTest, RegularizedCloseApproach) {
+  Length const periapsis = 7000 * Kilo(Metre);
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+  Position<ICRFJ2000Equator> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  GravitationalParameter const μ = bodies[0]->gravitational_parameter();
+  Position<ICRFJ2000Equator> const earth_position =
+      initial_state[0].position();
+  Velocity<ICRFJ2000Equator> const earth_velocity =
+      initial_state[0].velocity();
+
+  Ephemeris<ICRFJ2000Equator> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(),
+                                                       period / 100));
+
+  // A hyperbolic flyby of the Earth, starting at the periapsis.
+  auto flow = [&ephemeris,
+               &earth_position,
+               &earth_velocity,
+               &periapsis,
+               &μ,
+               this](bool const regularize_close_approaches,
+                     DiscreteTrajectory<ICRFJ2000Equator>& trajectory) {
+    trajectory.Append(
+        t0_,
+        DegreesOfFreedom<ICRFJ2000Equator>(
+            earth_position + Displacement<ICRFJ2000Equator>(
+                                 {periapsis, 0 * Metre, 0 * Metre}),
+            earth_velocity + Velocity<ICRFJ2000Equator>(
+                                 {0 * Metre / Second,
+                                  1.5 * Sqrt(2 * μ / periapsis),
+                                  0 * Metre / Second})));
+    Ephemeris<ICRFJ2000Equator>::AdaptiveStepParameters parameters(
+        EmbeddedExplicitRungeKuttaNyströmIntegrator<
+            DormandالمكاوىPrince1986RKN434FM,
+            Position<ICRFJ2000Equator>>(),
+        max_steps,
+        1e-3 * Metre,
+        1e-6 * Metre / Second);
+    parameters.set_regularize_close_approaches(regularize_close_approaches);
+    EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+        &trajectory,
+        Ephemeris<ICRFJ2000Equator>::NoIntrinsicAcceleration,
+        t0_ + 1 * Day,
+        parameters,
+        Ephemeris<ICRFJ2000Equator>::unlimited_max_ephemeris_steps,
+        /*last_point_only=*/false));
+    EXPECT_EQ(t0_ + 1 * Day, trajectory.last().time());
+  };
+
+  DiscreteTrajectory<ICRFJ2000Equator> cowell_trajectory;
+  DiscreteTrajectory<ICRFJ2000Equator> regularized_trajectory;
+  flow(/*regularize_close_approaches=*/false, cowell_trajectory);
+  flow(/*regularize_close_approaches=*/true, regularized_trajectory);
+
+  EXPECT_THAT(regularized_trajectory.Size(),
+              Lt(cowell_trajectory.Size() / 2));
+  EXPECT_THAT((regularized_trajectory.last().degrees_of_freedom().position() -
+               cowell_trajectory.last().degrees_of_freedom().position())
+                  .Norm(),
+              Lt(10 * Metre));
+}
+
+TEST_P(EphemerisTest, ProlongInParallel) {
+  int const number_of_small_bodies = 10;
+  Time const step = 1 * Day;
+  Instant const t_final = t0_ + 400 * Day;
+
+  auto make_ephemeris = [this, number_of_small_bodies, step]() {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+    bodies.emplace_back(std::make_unique<MassiveBody>(1 * SolarMass));
+    initial_state.emplace_back(ICRFJ2000Equator::origin,
+                               Velocity<ICRFJ2000Equator>());
+    GravitationalParameter const μ = bodies.front()->gravitational_parameter();
+    for (int i = 0; i < number_of_small_bodies; ++i) {
+      bodies.emplace_back(std::make_unique<MassiveBody>(1e20 * Kilogram));
+      Length const r = (1 + 0.1 * i) * AstronomicalUnit;
+      double const cos_i = Cos(i * Radian);
+      double const sin_i = Sin(i * Radian);
+      Speed const v = Sqrt(μ / r);
+      initial_state.emplace_back(
+          ICRFJ2000Equator::origin +
+              Displacement<ICRFJ2000Equator>(
+                  {r * cos_i, r * sin_i, 1e-3 * r * sin_i}),
+          Velocity<ICRFJ2000Equator>({-v * sin_i, v * cos_i, 0 * v}));
+    }
+    return std::make_unique<Ephemeris<ICRFJ2000Equator>>(
+        std::move(bodies),
+        initial_state,
+        t0_,
+        5 * Milli(Metre),
+        Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(), step));
+  };
+
+  auto const sequential_ephemeris = make_ephemeris();
+  auto const parallel_ephemeris = make_ephemeris();
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+  parallel_ephemeris->SetMassiveBodiesScheduler(&scheduler);
+
+  sequential_ephemeris->Prolong(t_final);
+  parallel_ephemeris->ProlongInParallel(
+      t_final,
+      Ephemeris<ICRFJ2000Equator>::ParallelProlongationParameters(
+          SymplecticRungeKuttaNyströmIntegrator<
+              McLachlanAtela1992Order4Optimal,
+              Position<ICRFJ2000Equator>>(),
+          /*coarse_steps_per_slice=*/5,
+          /*fine_steps_per_slice=*/50,
+          /*max_iterations=*/8,
+          /*length_integration_tolerance=*/1 * Metre,
+          /*speed_integration_tolerance=*/1 * Milli(Metre) / Second));
+  EXPECT_LE(t_final, parallel_ephemeris->t_max());
+
+  for (int i = 0; i <= number_of_small_bodies; ++i) {
+    Position<ICRFJ2000Equator> const sequential_position =
+        sequential_ephemeris->trajectory(sequential_ephemeris->bodies()[i])
+            ->EvaluatePosition(t_final);
+    Position<ICRFJ2000Equator> const parallel_position =
+        parallel_ephemeris->trajectory(parallel_ephemeris->bodies()[i])
+            ->EvaluatePosition(t_final);
+    EXPECT_THAT((sequential_position - parallel_position).Norm(),
+                Lt(1 * Kilo(Metre))) << i;
+  }
+}
+
+TEST_P(EphemerisTest, MultirateFitting) {
+  Time const step = 1 * Hour;
+  Instant const t_final = t0_ + 400 * Day;
+
+  // A star with a planet and its moon, and a distant dwarf planet.
+  auto make_ephemeris = [this, step](int const max_fitting_step_multiple) {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+    auto const add_body = [&bodies, &initial_state](
+                              Mass const& mass,
+                              Length const& r,
+                              Speed const& v) {
+      bodies.emplace_back(std::make_unique<MassiveBody>(mass));
+      initial_state.emplace_back(
+          ICRFJ2000Equator::origin +
+              Displacement<ICRFJ2000Equator>({r, 0 * Metre, 0 * Metre}),
+          Velocity<ICRFJ2000Equator>({0 * v, v, 0 * v}));
+    };
+    Mass const planet_mass = 6e24 * Kilogram;
+    Length const planet_r = 1 * AstronomicalUnit;
+    Speed const planet_v =
+        Sqrt(GravitationalConstant * SolarMass / planet_r);
+    Length const moon_r = 1 * LunarDistance;
+    Speed const moon_v = Sqrt(GravitationalConstant * planet_mass / moon_r);
+    Length const dwarf_r = 40 * AstronomicalUnit;
+    add_body(1 * SolarMass, 0 * Metre, 0 * Metre / Second);
+    add_body(planet_mass, planet_r, planet_v);
+    add_body(7e22 * Kilogram, planet_r + moon_r, planet_v + moon_v);
+    add_body(1e22 * Kilogram,
+             dwarf_r,
+             Sqrt(GravitationalConstant * SolarMass / dwarf_r));
+    return std::make_unique<Ephemeris<ICRFJ2000Equator>>(
+        std::move(bodies),
+        initial_state,
+        t0_,
+        5 * Milli(Metre),
+        Ephemeris<ICRFJ2000Equator>::FixedStepParameters(
+            integrator(), step, max_fitting_step_multiple));
+  };
+
+  auto const single_rate_ephemeris = make_ephemeris(1);
+  auto const multirate_ephemeris = make_ephemeris(64);
+  single_rate_ephemeris->Prolong(t_final);
+  multirate_ephemeris->Prolong(t_final);
+
+  // The planet and its moon have the shortest dynamical time.  The star is
+  // only perturbed on the time scale of the orbit of the planet, and the dwarf
+  // planet is slow.
+  std::vector<Time> const expected_steps = {8 * step, step, step, 64 * step};
+  for (int i = 0; i < expected_steps.size(); ++i) {
+    auto const single_rate_trajectory =
+        single_rate_ephemeris->trajectory(single_rate_ephemeris->bodies()[i]);
+    auto const multirate_trajectory =
+        multirate_ephemeris->trajectory(multirate_ephemeris->bodies()[i]);
+    EXPECT_EQ(step, single_rate_trajectory->step()) << i;
+    EXPECT_EQ(expected_steps[i], multirate_trajectory->step()) << i;
+    if (expected_steps[i] > step) {
+      EXPECT_THAT(multirate_trajectory->number_of_polynomials(),
+                  Lt(single_rate_trajectory->number_of_polynomials() / 4))
+          << i;
+    }
+    // The trajectories agree to about the fitting tolerance.
+    for (Instant t = t0_; t < t_final; t += 0.37 * Hour) {
+      EXPECT_THAT((multirate_trajectory->EvaluatePosition(t) -
+                   single_rate_trajectory->EvaluatePosition(t)).Norm(),
+                  Lt(10 * Milli(Metre))) << i << " " << t;
+    }
+  }
+
+  // The steps of the trajectories survive serialization.
+  serialization::Ephemeris message;
+  multirate_ephemeris->WriteToMessage(&message);
+  EXPECT_EQ(64, message.fixed_step_parameters().max_fitting_step_multiple());
+  auto const deserialized_ephemeris =
+      Ephemeris<ICRFJ2000Equator>::ReadFromMessage(message);
+  deserialized_ephemeris->Prolong(t_final + 100 * Day);
+  for (int i = 0; i < expected_steps.size(); ++i) {
+    EXPECT_EQ(expected_steps[i],
+              deserialized_ephemeris
+                  ->trajectory(deserialized_ephemeris->bodies()[i])
+                  ->step()) << i;
+  }
+}
+
+TEST_P(EphemerisTest, BackgroundProlongation) {
+  Time const step = 1 * Hour;
+  Time const horizon = 10 * Day;
+  Instant const t_request = t0_ + 30 * Day;
+
+  auto make_ephemeris = [this, step]() {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    std::vector<DegreesOfFreedom<ICRFJ2000Equator>> initial_state;
+    Position<ICRFJ2000Equator> centre_of_mass;
+    Time period;
+    SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+    return std::make_unique<Ephemeris<ICRFJ2000Equator>>(
+        std::move(bodies),
+        initial_state,
+        t0_,
+        5 * Milli(Metre),
+        Ephemeris<ICRFJ2000Equator>::FixedStepParameters(integrator(), step));
+  };
+
+  auto const foreground_ephemeris = make_ephemeris();
+  auto const background_ephemeris = make_ephemeris();
+
+  background_ephemeris->StartBackgroundProlongation(horizon);
+  background_ephemeris->RequestProlongation(t_request);
+  while (background_ephemeris->t_max() < t_request + horizon) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  background_ephemeris->StopBackgroundProlongation();
+  Instant const t_max = background_ephemeris->t_max();
+  foreground_ephemeris->Prolong(t_max);
+
+  // The background prolongation integrates a few steps at a time, which
+  // doesn't change the results.
+  for (int i = 0; i < foreground_ephemeris->bodies().size(); ++i) {
+    EXPECT_EQ(foreground_ephemeris->trajectory(
+                  foreground_ephemeris->bodies()[i])->EvaluatePosition(t_max),
+              background_ephemeris->trajectory(
+                  background_ephemeris->bodies()[i])->EvaluatePosition(t_max))
+        << i;
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(
     AllEphemerisTests,
     EphemerisTest,
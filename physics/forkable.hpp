@@ -1,12 +1,13 @@
 ﻿
 #pragma once
 
-#include <deque>
+#include <functional>
 #include <optional>
 #include <map>
 #include <memory>
 #include <vector>
 
+#include "base/function.hpp"
 #include "base/not_null.hpp"
 #include "geometry/named_quantities.hpp"
 #include "serialization/physics.pb.h"
@@ -15,6 +16,7 @@ namespace principia {
 namespace physics {
 namespace internal_forkable {
 
+using base::function_ref;
 using base::not_null;
 using geometry::Instant;
 
@@ -77,21 +79,31 @@ class ForkableIterator {
   TimelineConstIterator current() const;
 
  private:
+  // Returns the child of |ancestor| through which the ancestry goes, or null if
+  // |ancestor| is the most forked trajectory.  |ancestor| must be in the
+  // ancestry.  Complexity is O(|depth|).
+  Tr4jectory const* ChildInAncestry(Tr4jectory const* ancestor) const;
+
   // We want a single representation for an end iterator.  In various places
   // we may end up with |current_| at the end of its timeline, but that
   // timeline is not the "most forked" one.  This function normalizes this
-  // object so that there is only one entry in the |ancestry_| (the "most
-  // forked" one) and |current_| is at its end.
+  // object so that |ancestor_| is the "most forked" trajectory and |current_|
+  // is at its end.
   void NormalizeIfEnd();
 
   // Checks that this object verifies the invariants enforced by
   // NormalizeIfEnd and dies if it doesn't.
   void CheckNormalizedIfEnd();
 
-  // |ancestry_| is never empty.  |current_| is an iterator in the timeline
-  // for |ancestry_.front()|.  |current_| may be at end.
+  // The ancestry is made of |trajectory_| (the "most forked" trajectory) and
+  // its ancestors up to and including |ancestor_|.  It is not stored
+  // explicitly, but walked using the parent pointers, so that iterators are
+  // cheap to copy and never allocate.  |current_| is an iterator in the
+  // timeline for |ancestor_|.  |current_| may be at end.  The pointers are null
+  // for a default-constructed iterator, and are not owned.
   TimelineConstIterator current_;
-  std::deque<not_null<Tr4jectory const*>> ancestry_;  // Pointers not owned.
+  Tr4jectory const* ancestor_ = nullptr;
+  Tr4jectory const* trajectory_ = nullptr;
 
   template<typename, typename>
   friend class Forkable;
@@ -199,6 +211,9 @@ class Forkable {
   // This trajectory must be a root.
   void CheckNoForksBefore(Instant const& time);
 
+  // Calls |action| on this object and on all its descendants.
+  void ForSubTree(function_ref<void(Tr4jectory const&)> action) const;
+
   // This trajectory need not be a root.  As forks are encountered during tree
   // traversal their pointer is nulled-out in |forks|.
   void WriteSubTreeToMessage(
@@ -1,7 +1,6 @@
 ﻿
 #pragma once
 
-#include <deque>
 #include <optional>
 #include <vector>
 
@@ -14,15 +13,14 @@ namespace internal_forkable {
 template<typename Tr4jectory, typename It3rator>
 not_null<Tr4jectory const*>
 ForkableIterator<Tr4jectory, It3rator>::trajectory() const {
-  CHECK(!ancestry_.empty());
-  return ancestry_.back();
+  return CHECK_NOTNULL(trajectory_);
 }
 
 template<typename Tr4jectory, typename It3rator>
 bool ForkableIterator<Tr4jectory, It3rator>::operator==(
     It3rator const& right) const {
   DCHECK_EQ(trajectory(), right.trajectory());
-  return ancestry_ == right.ancestry_ && current_ == right.current_;
+  return ancestor_ == right.ancestor_ && current_ == right.current_;
 }
 
 template<typename Tr4jectory, typename It3rator>
@@ -33,15 +31,14 @@ bool ForkableIterator<Tr4jectory, It3rator>::operator!=(
 
 template<typename Tr4jectory, typename It3rator>
 It3rator& ForkableIterator<Tr4jectory, It3rator>::operator++() {
-  CHECK(!ancestry_.empty());
-  CHECK(current_ != ancestry_.front()->timeline_end());
+  CHECK_NOTNULL(ancestor_);
+  CHECK(current_ != ancestor_->timeline_end());
 
   // Check if there is a next child in the ancestry.
-  auto ancestry_it = ancestry_.begin();
-  if (++ancestry_it != ancestry_.end()) {
+  Tr4jectory const* child = ChildInAncestry(ancestor_);
+  if (child != nullptr) {
     // There is a next child.  See if we reached its fork time.
     Instant const& current_time = ForkableTraits<Tr4jectory>::time(current_);
-    not_null<Tr4jectory const*> child = *ancestry_it;
     Instant child_fork_time = (*child->position_in_parent_children_)->first;
     if (current_time == child_fork_time) {
       // We have reached the fork time of the next child.  There may be several
@@ -49,11 +46,11 @@ It3rator& ForkableIterator<Tr4jectory, It3rator>::operator++() {
       // a different time or the end of the children.
       do {
         current_ = child->timeline_begin();  // May be at end.
-        ancestry_.pop_front();
-        if (++ancestry_it == ancestry_.end()) {
+        ancestor_ = child;
+        child = ChildInAncestry(ancestor_);
+        if (child == nullptr) {
           break;
         }
-        child = *ancestry_it;
         child_fork_time = (*child->position_in_parent_children_)->first;
       } while (current_time == child_fork_time);
 
@@ -70,18 +67,18 @@ It3rator& ForkableIterator<Tr4jectory, It3rator>::operator++() {
 
 template<typename Tr4jectory, typename It3rator>
 It3rator& ForkableIterator<Tr4jectory, It3rator>::operator--() {
-  CHECK(!ancestry_.empty());
+  CHECK_NOTNULL(ancestor_);
 
-  not_null<Tr4jectory const*> ancestor = ancestry_.front();
+  not_null<Tr4jectory const*> ancestor = ancestor_;
   if (current_ == ancestor->timeline_begin()) {
     CHECK_NOTNULL(ancestor->parent_);
-    // At the beginning of the first timeline.  Push the parent in front of the
-    // ancestry and set |current_| to the fork point.  If the timeline is empty,
+    // At the beginning of the first timeline.  Extend the ancestry to the
+    // parent and set |current_| to the fork point.  If the timeline is empty,
     // keep going until we find a non-empty one or the root.
     do {
       current_ = *ancestor->position_in_parent_timeline_;
       ancestor = ancestor->parent_;
-      ancestry_.push_front(ancestor);
+      ancestor_ = ancestor;
     } while (current_ == ancestor->timeline_end() &&
              ancestor->parent_ != nullptr);
     return *that();
@@ -97,20 +94,32 @@ ForkableIterator<Tr4jectory, It3rator>::current() const {
   return current_;
 }
 
+template<typename Tr4jectory, typename It3rator>
+Tr4jectory const* ForkableIterator<Tr4jectory, It3rator>::ChildInAncestry(
+    Tr4jectory const* const ancestor) const {
+  if (ancestor == trajectory_) {
+    return nullptr;
+  }
+  Tr4jectory const* child = trajectory_;
+  while (child->parent_ != ancestor) {
+    child = child->parent_;
+    DCHECK_NOTNULL(child);
+  }
+  return child;
+}
+
 template<typename Tr4jectory, typename It3rator>
 void ForkableIterator<Tr4jectory, It3rator>::NormalizeIfEnd() {
-  CHECK(!ancestry_.empty());
-  if (current_ == ancestry_.front()->timeline_end() &&
-      ancestry_.size() > 1) {
-    ancestry_.erase(ancestry_.begin(), --ancestry_.end());
-    current_ = ancestry_.front()->timeline_end();
+  CHECK_NOTNULL(ancestor_);
+  if (current_ == ancestor_->timeline_end() && ancestor_ != trajectory_) {
+    ancestor_ = trajectory_;
+    current_ = ancestor_->timeline_end();
   }
 }
 
 template<typename Tr4jectory, typename It3rator>
 void ForkableIterator<Tr4jectory, It3rator>::CheckNormalizedIfEnd() {
-  CHECK(current_ != ancestry_.front()->timeline_end() ||
-        ancestry_.size() == 1);
+  CHECK(current_ != ancestor_->timeline_end() || ancestor_ == trajectory_);
 }
 
 template<typename Tr4jectory, typename It3rator>
@@ -173,7 +182,8 @@ template<typename Tr4jectory, typename It3rator>
 It3rator Forkable<Tr4jectory, It3rator>::End() const {
   not_null<Tr4jectory const*> const ancestor = that();
   It3rator iterator;
-  iterator.ancestry_.push_front(ancestor);
+  iterator.trajectory_ = ancestor;
+  iterator.ancestor_ = ancestor;
   iterator.current_ = ancestor->timeline_end();
   iterator.CheckNormalizedIfEnd();
   return iterator;
@@ -185,11 +195,12 @@ It3rator Forkable<Tr4jectory, It3rator>::Find(Instant const& time) const {
 
   // Go up the ancestry chain until we find a timeline that covers |time| (that
   // is, |time| is after the first time of the timeline).  Set |current_| to
-  // the location of |time|, which may be |end()|.  The ancestry has |forkable|
-  // at the back, and the object containing |current_| at the front.
+  // the location of |time|, which may be |end()|.  The ancestry goes from this
+  // object to the object containing |current_|.
   Tr4jectory const* ancestor = that();
+  iterator.trajectory_ = ancestor;
   do {
-    iterator.ancestry_.push_front(ancestor);
+    iterator.ancestor_ = ancestor;
     if (!ancestor->timeline_empty() &&
         ForkableTraits<Tr4jectory>::time(ancestor->timeline_begin()) <= time) {
       iterator.current_ = ancestor->timeline_find(time);  // May be at end.
@@ -207,17 +218,16 @@ template<typename Tr4jectory, typename It3rator>
 It3rator Forkable<Tr4jectory, It3rator>::LowerBound(Instant const& time) const {
   It3rator iterator;
   Tr4jectory const* ancestor = that();
+  iterator.trajectory_ = ancestor;
 
-  // This queue is parallel to |iterator.ancestry_|, and each entry is an
-  // iterator in the corresponding ancestry timeline.  Note that we use a
-  // |nullopt| sentinel for the innermost timeline.
-  std::deque<std::optional<TimelineConstIterator>> fork_points;
-  fork_points.push_front(std::nullopt);
+  // The fork point of the previous ancestor in the timeline of |ancestor|.
+  // Note that we use a |nullopt| sentinel for the innermost timeline.
+  std::optional<TimelineConstIterator> fork_point;
 
   // Go up the ancestry chain until we find a (nonempty) timeline that covers
   // |time| (that is, |time| is on or after the first time of the timeline).
   do {
-    iterator.ancestry_.push_front(ancestor);
+    iterator.ancestor_ = ancestor;
     if (!ancestor->timeline_empty() &&
         ForkableTraits<Tr4jectory>::time(ancestor->timeline_begin()) <= time) {
       // We have found a timeline that covers |time|.  Find where |time| falls
@@ -225,7 +235,6 @@ It3rator Forkable<Tr4jectory, It3rator>::LowerBound(Instant const& time) const {
       iterator.current_ = ancestor->timeline_lower_bound(time);
 
       // Check if the returned iterator is directly usable.
-      auto const& fork_point = fork_points.front();
       if (iterator.current_ == ancestor->timeline_end() ||
           (fork_point &&
            *fork_point != ancestor->timeline_end() &&
@@ -239,32 +248,32 @@ It3rator Forkable<Tr4jectory, It3rator>::LowerBound(Instant const& time) const {
         // Check if we have a more nested fork with a point before |time|.  Go
         // down the ancestry looking for a timeline that is nonempty and not
         // forked at the same point as its parent.
-        auto ancestry_it = iterator.ancestry_.begin();
-        auto fork_points_it = fork_points.begin();
+        Tr4jectory const* descendant = ancestor;
         for (;;) {
-          ++ancestry_it;
-          ++fork_points_it;
-          if (ancestry_it == iterator.ancestry_.end()) {
+          descendant = iterator.ChildInAncestry(descendant);
+          if (descendant == nullptr) {
             // We didn't find an interesting fork in the ancestry, so we stop
             // here and |NormalizeIfEnd| will return a proper |End|.
-            CHECK(fork_points_it == fork_points.end());
             break;
           }
-          if (!(*ancestry_it)->timeline_empty() &&
-                (!*fork_points_it ||
-                 **fork_points_it != (*ancestry_it)->timeline_end())) {
+          Tr4jectory const* const grandchild =
+              iterator.ChildInAncestry(descendant);
+          if (!descendant->timeline_empty() &&
+                (grandchild == nullptr ||
+                 *grandchild->position_in_parent_timeline_ !=
+                     descendant->timeline_end())) {
             // We found an interesting timeline, i.e. one that is nonempty and
             // not forked at the fork point of its parent.  Cut the ancestry and
             // return the beginning of that timeline.
-            iterator.ancestry_.erase(iterator.ancestry_.begin(), ancestry_it);
-            iterator.current_ = (*ancestry_it)->timeline_begin();
+            iterator.ancestor_ = descendant;
+            iterator.current_ = descendant->timeline_begin();
             break;
           }
         }
       }
       break;
     }
-    fork_points.push_front(ancestor->position_in_parent_timeline_);
+    fork_point = ancestor->position_in_parent_timeline_;
     iterator.current_ = ancestor->timeline_begin();
     ancestor = ancestor->parent_;
   } while (ancestor != nullptr);
@@ -407,6 +416,15 @@ void Forkable<Tr4jectory, It3rator>::DeleteAllForksAfter(Instant const& time) {
   children_.erase(it, children_.end());
 }
 
+template<typename Tr4jectory, typename It3rator>
+void Forkable<Tr4jectory, It3rator>::ForSubTree(
+    function_ref<void(Tr4jectory const&)> action) const {
+  action(*that());
+  for (auto const& pair : children_) {
+    pair.second->ForSubTree(action);
+  }
+}
+
 template<typename Tr4jectory, typename It3rator>
 void Forkable<Tr4jectory, It3rator>::CheckNoForksBefore(Instant const& time) {
   CHECK(is_root()) << "CheckNoForksBefore on a nonroot trajectory";
@@ -478,11 +496,12 @@ It3rator Forkable<Tr4jectory, It3rator>::Wrap(
   It3rator iterator;
 
   // Go up the ancestry chain until we find |ancestor| and set |current_| to
-  // |position_in_ancestor_timeline|.  The ancestry has |forkable|
-  // at the back, and the object containing |current_| at the front.
+  // |position_in_ancestor_timeline|.  The ancestry goes from this object to the
+  // object containing |current_|.
   not_null<Tr4jectory const*> ancest0r = that();
+  iterator.trajectory_ = ancest0r;
   do {
-    iterator.ancestry_.push_front(ancest0r);
+    iterator.ancestor_ = ancest0r;
     if (ancestor == ancest0r) {
       iterator.current_ = position_in_ancestor_timeline;  // May be at end.
       iterator.CheckNormalizedIfEnd();
@@ -69,20 +69,29 @@ class HierarchicalSystem final {
     KeplerianElements<Frame> jacobi_osculating_elements;
   };
 
-  // Data about a |Subsystem|.
-  struct BarycentricSubsystem final {
-    // A |MassiveBody| with the mass of the whole subsystem.
-    std::unique_ptr<MassiveBody> equivalent_body;
-    // The bodies composing the subsystem, in preorder, where the satellites
-    // are ordered by increasing semimajor axis.
+  // The systems in preorder, where the satellites are ordered by increasing
+  // semimajor axis.  Each body is the primary of exactly one |System|, so the
+  // |i|th body is the primary of the |i|th system.  The degrees of freedom are
+  // relative to the barycentre of the parent system, so that each body is only
+  // visited once when they are made barycentric.
+  struct FlattenedSystem final {
     std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
-    // Their |DegreesOfFreedom| relative to the barycentre of the subsystem, in
-    // the same order.
-    std::vector<RelativeDegreesOfFreedom<Frame>> barycentric_degrees_of_freedom;
+    // The index of the parent of the |i|th system, or -1 for the root.
+    std::vector<int> parents;
+    // The degrees of freedom of the barycentre of the |i|th system relative to
+    // the barycentre of its parent.
+    std::vector<RelativeDegreesOfFreedom<Frame>> barycentres;
+    // The degrees of freedom of the |i|th body relative to the barycentre of
+    // the |i|th system.
+    std::vector<RelativeDegreesOfFreedom<Frame>> primaries;
   };
 
-  // Invalidates its argument.
-  static BarycentricSubsystem ToBarycentric(System& system);
+  // Appends |system| and its satellites to |flattened|, with the given
+  // |parent| index.  Returns a body with the mass of the whole system.
+  // Invalidates |system|.
+  static MassiveBody Flatten(System& system,
+                             int parent,
+                             FlattenedSystem& flattened);
 
   static void WriteToMessage(
       std::vector<not_null<std::unique_ptr<Subsystem>>> const& subsystems,
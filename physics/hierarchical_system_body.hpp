@@ -4,7 +4,6 @@
 #include "physics/hierarchical_system.hpp"
 
 #include <algorithm>
-#include <iterator>
 #include <vector>
 
 #include "google/protobuf/repeated_field.h"
@@ -14,7 +13,6 @@ namespace physics {
 namespace internal_hierarchical_system {
 
 using base::make_not_null_unique;
-using geometry::Identity;
 using geometry::Velocity;
 
 template<typename Frame>
@@ -45,16 +43,31 @@ void HierarchicalSystem<Frame>::Add(
 template<typename Frame>
 typename HierarchicalSystem<Frame>::BarycentricSystem
 HierarchicalSystem<Frame>::ConsumeBarycentricSystem() {
-  BarycentricSystem result;
-  auto barycentric_result = ToBarycentric(system_);
-  result.bodies = std::move(barycentric_result.bodies);
+  FlattenedSystem flattened;
+  flattened.bodies.reserve(systems_.size());
+  flattened.parents.reserve(systems_.size());
+  flattened.barycentres.reserve(systems_.size());
+  flattened.primaries.reserve(systems_.size());
+  Flatten(system_, /*parent=*/-1, flattened);
+
   static DegreesOfFreedom<Frame> const system_barycentre = {Frame::origin,
                                                             Velocity<Frame>()};
-  for (auto const& barycentric_dof :
-       barycentric_result.barycentric_degrees_of_freedom) {
-    result.degrees_of_freedom.emplace_back(system_barycentre + barycentric_dof);
+  // Since a parent precedes its satellites in preorder, a single pass computes
+  // the barycentres of all the systems.
+  std::vector<DegreesOfFreedom<Frame>> barycentres;
+  barycentres.reserve(flattened.bodies.size());
+  BarycentricSystem result;
+  result.degrees_of_freedom.reserve(flattened.bodies.size());
+  for (int i = 0; i < flattened.bodies.size(); ++i) {
+    int const parent = flattened.parents[i];
+    barycentres.push_back(
+        (parent < 0 ? system_barycentre : barycentres[parent]) +
+        flattened.barycentres[i]);
+    result.degrees_of_freedom.push_back(barycentres.back() +
+                                        flattened.primaries[i]);
   }
-  return std::move(result);
+  result.bodies = std::move(flattened.bodies);
+  return result;
 }
 
 template<typename Frame>
@@ -66,8 +79,9 @@ void HierarchicalSystem<Frame>::WriteToMessage(
 }
 
 template<typename Frame>
-typename HierarchicalSystem<Frame>::BarycentricSubsystem
-HierarchicalSystem<Frame>::ToBarycentric(System& system) {
+MassiveBody HierarchicalSystem<Frame>::Flatten(System& system,
+                                               int const parent,
+                                               FlattenedSystem& flattened) {
   auto const semimajor_axis_less_than = [](
       not_null<std::unique_ptr<Subsystem>> const& left,
       not_null<std::unique_ptr<Subsystem>> const& right) -> bool {
@@ -100,79 +114,36 @@ HierarchicalSystem<Frame>::ToBarycentric(System& system) {
             system.satellites.end(),
             semimajor_axis_less_than);
 
-  BarycentricSubsystem result;
-
-  // A reference frame wherein the barycentre of |system| is motionless at the
-  // origin.
-  // TODO(egg): declaring these frame tags to make sure that local frames
-  // don't go out of scope is a bit cumbersome.
-  enum class LocalFrameTag { frame_tag };
-  using SystemBarycentre = geometry::Frame<LocalFrameTag,
-                                           LocalFrameTag::frame_tag,
-                                           /*frame_is_inertial=*/false>;
-  static DegreesOfFreedom<SystemBarycentre> const system_barycentre = {
-      SystemBarycentre::origin, Velocity<SystemBarycentre>()};
-  static Identity<SystemBarycentre, Frame> const id_bf;
-  static Identity<Frame, SystemBarycentre> const id_fb;
+  int const index = flattened.bodies.size();
 
   // Jacobi coordinates for |system|, with satellite subsystems treated as point
   // masses at their barycentres.
   JacobiCoordinates<Frame> jacobi_coordinates(*system.primary);
-  // Add the primary first (preorder).
-  result.bodies.emplace_back(std::move(system.primary));
-
-  // The |n|th element of |satellite_degrees_of_freedom| contains the list of
-  // degrees of freedom of the bodies in the |n|th satellite subsystem with
-  // respect to their barycentre.
-  std::vector<std::vector<RelativeDegreesOfFreedom<Frame>>>
-      satellite_degrees_of_freedom;
-
-  // Fill |satellite_degrees_of_freedom|, |jacobi_coordinates|, and
-  // |result.bodies|.
+  // Add the primary first (preorder).  Its degrees of freedom, and those of the
+  // barycentre of |system|, are filled below and by our caller, respectively.
+  flattened.bodies.emplace_back(std::move(system.primary));
+  flattened.parents.push_back(parent);
+  flattened.barycentres.emplace_back();
+  flattened.primaries.emplace_back();
+
+  std::vector<int> satellite_indices;
+  satellite_indices.reserve(system.satellites.size());
   for (auto const& subsystem : system.satellites) {
-    BarycentricSubsystem barycentric_satellite_subsystem =
-        ToBarycentric(*subsystem);
-    satellite_degrees_of_freedom.emplace_back(std::move(
-        barycentric_satellite_subsystem.barycentric_degrees_of_freedom));
-    jacobi_coordinates.Add(*barycentric_satellite_subsystem.equivalent_body,
+    satellite_indices.push_back(flattened.bodies.size());
+    MassiveBody const equivalent_body =
+        Flatten(*subsystem, /*parent=*/index, flattened);
+    jacobi_coordinates.Add(equivalent_body,
                            subsystem->jacobi_osculating_elements);
-    std::move(barycentric_satellite_subsystem.bodies.begin(),
-              barycentric_satellite_subsystem.bodies.end(),
-              std::back_inserter(result.bodies));
   }
 
-  std::vector<DegreesOfFreedom<SystemBarycentre>> barycentres_of_subsystems;
-  {
-    // TODO(egg): should BarycentricDegreesOfFreedom return DegreesOfFreedom
-    // instead of RelativeDegreesOfFreedom?  In what frame?
-    auto const barycentric_dof =
-        jacobi_coordinates.BarycentricDegreesOfFreedom();
-    for (auto const& dof : barycentric_dof) {
-      barycentres_of_subsystems.push_back(system_barycentre + id_fb(dof));
-    }
-  }
-
-  // Fill |result.barycentric_degrees_of_freedom|.
-  // The primary.
-  result.barycentric_degrees_of_freedom.emplace_back(
-      id_bf(barycentres_of_subsystems.front() - system_barycentre));
-  // The bodies in satellite subsystems.
-  for (int n = 0; n < satellite_degrees_of_freedom.size(); ++n) {
-    // |n + 1| because the primary is at |barycentres_of_subsystems[0]|.
-    DegreesOfFreedom<SystemBarycentre> const subsystem_barycentre =
-        barycentres_of_subsystems[n + 1];
-    for (auto const& body_dof_wrt_subsystem_barycentre :
-         satellite_degrees_of_freedom[n]) {
-      DegreesOfFreedom<SystemBarycentre> const body_dof =
-          subsystem_barycentre + id_fb(body_dof_wrt_subsystem_barycentre);
-      result.barycentric_degrees_of_freedom.emplace_back(
-          id_bf(body_dof - system_barycentre));
-    }
+  auto const barycentric_dof = jacobi_coordinates.BarycentricDegreesOfFreedom();
+  // The primary is at |barycentric_dof[0]|, the satellite subsystems follow.
+  flattened.primaries[index] = barycentric_dof.front();
+  for (int n = 0; n < satellite_indices.size(); ++n) {
+    flattened.barycentres[satellite_indices[n]] = barycentric_dof[n + 1];
   }
 
-  result.equivalent_body =
-      std::make_unique<MassiveBody>(jacobi_coordinates.System());
-  return std::move(result);
+  return jacobi_coordinates.System();
 }
 
 template<typename Frame>
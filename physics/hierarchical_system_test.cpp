@@ -92,6 +92,60 @@ TEST_F(HierarchicalSystemTest, HierarchicalSystem) {
                           0.5 * Metre));
 }
 
+// Same as above, with a satellite of the satellite of the furthest secondary,
+// so that the barycentres are accumulated over three levels.
+TEST_F(HierarchicalSystemTest, NestedSubsystems) {
+  // i, and Ω are 0 by default.
+  KeplerianElements<Frame> elements;
+  elements.eccentricity = 0;
+  elements.argument_of_periapsis = 0 * Radian;
+  elements.mean_anomaly = 0 * Radian;
+
+  std::vector<not_null<MassiveBody const*>> bodies;
+  auto const new_body = [&bodies](Mass const& mass) {
+    auto body = make_not_null_unique<MassiveBody>(mass);
+    bodies.emplace_back(body.get());
+    return body;
+  };
+
+  // Bodies 3 and 4 have a barycentre 1 m from body 1 and are 0.5 m apart.  The
+  // subsystem of body 1 has a mass of 4 kg and its barycentre is 7/3 m from
+  // the barycentre of bodies 0 and 2, so the barycentre of the whole system is
+  // 5/3 m from body 0.
+  bodies.reserve(5);
+  HierarchicalSystem<Frame> system(new_body(2 * Kilogram));
+  elements.semimajor_axis = 7.0 / 3.0 * Metre;
+  system.Add(new_body(2 * Kilogram), /*parent=*/bodies[0], elements);
+  elements.semimajor_axis = 1 * Metre;
+  system.Add(new_body(1 * Kilogram), /*parent=*/bodies[0], elements);
+  elements.mean_anomaly = π * Radian;
+  system.Add(new_body(1 * Kilogram), /*parent=*/bodies[1], elements);
+  elements.semimajor_axis = 0.5 * Metre;
+  elements.mean_anomaly = 0 * Radian;
+  system.Add(new_body(1 * Kilogram), /*parent=*/bodies[3], elements);
+
+  auto const barycentric_system = system.ConsumeBarycentricSystem();
+  std::vector<int> expected_order = {0, 2, 1, 3, 4};
+  ASSERT_EQ(expected_order.size(), barycentric_system.bodies.size());
+  for (int i = 0; i < barycentric_system.bodies.size(); ++i) {
+    EXPECT_TRUE(bodies[expected_order[i]] == barycentric_system.bodies[i].get())
+        << i;
+  }
+  std::vector<Length> x_positions;
+  std::transform(barycentric_system.degrees_of_freedom.begin(),
+                 barycentric_system.degrees_of_freedom.end(),
+                 std::back_inserter(x_positions),
+                 [](DegreesOfFreedom<Frame> const& dof) {
+                   return (dof.position() - Frame::origin).coordinates().x;
+                 });
+  EXPECT_THAT(x_positions,
+              ElementsAre(AlmostEquals(-5.0 / 3.0 * Metre, 0, 16),
+                          AlmostEquals(-2.0 / 3.0 * Metre, 0, 16),
+                          AlmostEquals(1.5 * Metre, 0, 16),
+                          AlmostEquals(0.25 * Metre, 0, 16),
+                          AlmostEquals(0.75 * Metre, 0, 16)));
+}
+
 TEST_F(HierarchicalSystemTest, FromMeanMotions) {
   // i, and Ω are 0 by default.
   KeplerianElements<Frame> elements;
@@ -4,7 +4,9 @@
 #include <optional>
 #include <ostream>
 #include <string>
+#include <vector>
 
+#include "geometry/rotation.hpp"
 #include "physics/body.hpp"
 #include "physics/degrees_of_freedom.hpp"
 
@@ -14,6 +16,7 @@ namespace internal_kepler_orbit {
 
 using base::not_null;
 using geometry::Instant;
+using geometry::Rotation;
 using quantities::Angle;
 using quantities::AngularFrequency;
 using quantities::GravitationalParameter;
@@ -106,6 +109,15 @@ class KeplerOrbit final {
   // The |DegreesOfFreedom| of the secondary minus those of the primary.
   RelativeDegreesOfFreedom<Frame> StateVectors(Instant const& t) const;
 
+  // The result of the above function for each of the |times|.  The
+  // orientation of the orbit is computed once, and Kepler's equation is solved
+  // by Halley's method instead of bisection, so this is much faster than
+  // calling the above function for each time.  The eccentric anomalies agree
+  // with those found by bisection to within rounding errors amplified by the
+  // conditioning of Kepler's equation.
+  std::vector<RelativeDegreesOfFreedom<Frame>> StateVectors(
+      std::vector<Instant> const& times) const;
+
   // All |optional|s are filled in the result.
   KeplerianElements<Frame> const& elements_at_epoch() const;
 
@@ -129,6 +141,32 @@ class KeplerOrbit final {
   // minimally specified.  Fills section III.
   static void CompleteAnomalies(KeplerianElements<Frame>& elements);
 
+  // The frame of the orbit plane, whose x axis points to the periapsis.
+  struct OrbitPlane;
+
+  // The orientation of the orbit plane given by |elements_at_epoch_|.
+  Rotation<OrbitPlane, Frame> FromOrbitPlane() const;
+
+  // The state vectors at the true anomaly |ν|.
+  RelativeDegreesOfFreedom<Frame> StateVectorsAtTrueAnomaly(
+      Angle const& ν,
+      Rotation<OrbitPlane, Frame> const& from_orbit_plane) const;
+  // Same as above, given the distance |r| to the primary and the speed |v| at
+  // the true anomaly |ν|.
+  RelativeDegreesOfFreedom<Frame> StateVectorsAtTrueAnomaly(
+      Angle const& ν,
+      Length const& r,
+      Speed const& v,
+      Rotation<OrbitPlane, Frame> const& from_orbit_plane) const;
+
+  // The solutions of Kepler's equation E - e sin E = M, for 0 ≤ e < 1, and of
+  // its hyperbolic counterpart e sinh H - H = M, for e > 1, by Halley's
+  // method.
+  static Angle EllipticEccentricAnomaly(Angle const& mean_anomaly,
+                                        double e);
+  static Angle HyperbolicEccentricAnomaly(Angle const& hyperbolic_mean_anomaly,
+                                          double e);
+
   GravitationalParameter const gravitational_parameter_;
   KeplerianElements<Frame> elements_at_epoch_;
   Instant const epoch_;
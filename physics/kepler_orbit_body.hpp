@@ -3,7 +3,11 @@
 
 #include "physics/kepler_orbit.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "base/optional_serialization.hpp"
 #include "geometry/rotation.hpp"
@@ -28,7 +32,7 @@ using geometry::Sign;
 using geometry::Vector;
 using geometry::Velocity;
 using geometry::Wedge;
-using numerics::Bisect;
+using numerics::BracketedNewton;
 using quantities::Abs;
 using quantities::ArcCos;
 using quantities::ArcCosh;
@@ -49,6 +53,10 @@ using quantities::Sqrt;
 using quantities::Time;
 using quantities::si::Radian;
 
+// Halley's method converges in at most 10 iterations from the starting values
+// below.
+constexpr int max_halley_iterations = 16;
+
 template<typename Frame>
 void KeplerianElements<Frame>::WriteToMessage(
     not_null<serialization::KeplerianElements*> const message) const {
@@ -234,13 +242,7 @@ KeplerOrbit<Frame>::KeplerOrbit(
 template<typename Frame>
 RelativeDegreesOfFreedom<Frame>
 KeplerOrbit<Frame>::StateVectors(Instant const& t) const {
-  GravitationalParameter const& μ = gravitational_parameter_;
   double const& e = *elements_at_epoch_.eccentricity;
-  Angle const& i = elements_at_epoch_.inclination;
-  Angle const& Ω = elements_at_epoch_.longitude_of_ascending_node;
-  Angle const& ω = *elements_at_epoch_.argument_of_periapsis;
-  Length const& ℓ = *elements_at_epoch_.semilatus_rectum;
-  SpecificEnergy const& ε = *elements_at_epoch_.specific_energy;
   KeplerianElements<Frame> elements = elements_at_epoch_;
   elements.true_anomaly.reset();
   elements.mean_anomaly.reset();
@@ -259,28 +261,165 @@ KeplerOrbit<Frame>::StateVectors(Instant const& t) const {
         *elements_at_epoch_.hyperbolic_mean_motion * (t - epoch_);
   }
   CompleteAnomalies(elements);
-  Angle const& ν = *elements.true_anomaly;
-  struct OrbitPlane;
-  Rotation<OrbitPlane, Frame> const from_orbit_plane(
-      Ω, i, ω,
+  return StateVectorsAtTrueAnomaly(*elements.true_anomaly, FromOrbitPlane());
+}
+
+template<typename Frame>
+std::vector<RelativeDegreesOfFreedom<Frame>> KeplerOrbit<Frame>::StateVectors(
+    std::vector<Instant> const& times) const {
+  double const& e = *elements_at_epoch_.eccentricity;
+  Rotation<OrbitPlane, Frame> const from_orbit_plane = FromOrbitPlane();
+  std::vector<Angle> true_anomalies;
+  true_anomalies.reserve(times.size());
+  for (Instant const& t : times) {
+    Angle ν;
+    if (e < 1) {
+      // Elliptic case.
+      Angle const eccentric_anomaly = EllipticEccentricAnomaly(
+          *elements_at_epoch_.mean_anomaly +
+              *elements_at_epoch_.mean_motion * (t - epoch_),
+          e);
+      ν = 2 * ArcTan(Sqrt(1 + e) * Sin(eccentric_anomaly / 2),
+                     Sqrt(1 - e) * Cos(eccentric_anomaly / 2));
+    } else if (e == 1) {
+      // Parabolic case.
+      LOG(FATAL) << "not yet implemented";
+    } else {
+      // Hyperbolic case.
+      Angle const hyperbolic_eccentric_anomaly = HyperbolicEccentricAnomaly(
+          *elements_at_epoch_.hyperbolic_mean_anomaly +
+              *elements_at_epoch_.hyperbolic_mean_motion * (t - epoch_),
+          e);
+      ν = 2 * ArcTan(Sqrt(e + 1) * Sinh(hyperbolic_eccentric_anomaly / 2),
+                     Sqrt(e - 1) * Cosh(hyperbolic_eccentric_anomaly / 2));
+    }
+    true_anomalies.push_back(ν);
+  }
+
+  // The norms of the velocities come from the vis-viva equation; their square
+  // roots are taken in a batch.
+  GravitationalParameter const& μ = gravitational_parameter_;
+  Length const& ℓ = *elements_at_epoch_.semilatus_rectum;
+  SpecificEnergy const& ε = *elements_at_epoch_.specific_energy;
+  std::vector<Length> radii;
+  std::vector<SpecificEnergy> squared_speeds;
+  radii.reserve(true_anomalies.size());
+  squared_speeds.reserve(true_anomalies.size());
+  for (Angle const& ν : true_anomalies) {
+    Length const r = ℓ / (1 + e * Cos(ν));
+    radii.push_back(r);
+    squared_speeds.push_back(2 * (ε + μ / r));
+  }
+  std::vector<Speed> const speeds = Sqrt(squared_speeds);
+
+  std::vector<RelativeDegreesOfFreedom<Frame>> result;
+  result.reserve(true_anomalies.size());
+  for (std::size_t i = 0; i < true_anomalies.size(); ++i) {
+    result.push_back(StateVectorsAtTrueAnomaly(
+        true_anomalies[i], radii[i], speeds[i], from_orbit_plane));
+  }
+  return result;
+}
+
+template<typename Frame>
+KeplerianElements<Frame> const& KeplerOrbit<Frame>::elements_at_epoch() const {
+  return elements_at_epoch_;
+}
+
+template<typename Frame>
+Rotation<typename KeplerOrbit<Frame>::OrbitPlane, Frame>
+KeplerOrbit<Frame>::FromOrbitPlane() const {
+  return Rotation<OrbitPlane, Frame>(
+      elements_at_epoch_.longitude_of_ascending_node,
+      elements_at_epoch_.inclination,
+      *elements_at_epoch_.argument_of_periapsis,
       EulerAngles::ZXZ,
       DefinesFrame<OrbitPlane>{});
+}
+
+template<typename Frame>
+RelativeDegreesOfFreedom<Frame> KeplerOrbit<Frame>::StateVectorsAtTrueAnomaly(
+    Angle const& ν,
+    Rotation<OrbitPlane, Frame> const& from_orbit_plane) const {
+  GravitationalParameter const& μ = gravitational_parameter_;
+  double const& e = *elements_at_epoch_.eccentricity;
+  Length const& ℓ = *elements_at_epoch_.semilatus_rectum;
+  SpecificEnergy const& ε = *elements_at_epoch_.specific_energy;
   Length const r = ℓ / (1 + e * Cos(ν));
+  // The norm comes from the vis-viva equation.
+  return StateVectorsAtTrueAnomaly(ν, r, Sqrt(2 * (ε + μ / r)),
+                                   from_orbit_plane);
+}
+
+template<typename Frame>
+RelativeDegreesOfFreedom<Frame> KeplerOrbit<Frame>::StateVectorsAtTrueAnomaly(
+    Angle const& ν,
+    Length const& r,
+    Speed const& v,
+    Rotation<OrbitPlane, Frame> const& from_orbit_plane) const {
+  double const& e = *elements_at_epoch_.eccentricity;
   Displacement<Frame> const displacement =
       r * from_orbit_plane(Vector<double, OrbitPlane>({Cos(ν), Sin(ν), 0}));
   // Flight path angle.
   Angle const φ = ArcTan(e * Sin(ν), 1 + e * Cos(ν));
-  // The norm comes from the vis-viva equation.
   Velocity<Frame> const velocity =
-      Sqrt(2 * (ε + μ / r)) *
-      from_orbit_plane(Vector<double, OrbitPlane>(
-          {-Sin(ν - φ), Cos(ν - φ), 0}));
+      v * from_orbit_plane(Vector<double, OrbitPlane>(
+              {-Sin(ν - φ), Cos(ν - φ), 0}));
   return {displacement, velocity};
 }
 
 template<typename Frame>
-KeplerianElements<Frame> const& KeplerOrbit<Frame>::elements_at_epoch() const {
-  return elements_at_epoch_;
+Angle KeplerOrbit<Frame>::EllipticEccentricAnomaly(Angle const& mean_anomaly,
+                                                    double const e) {
+  if (e == 0) {
+    return mean_anomaly;
+  }
+  // The starting value of Danby (1987), The solution of Kepler's equation
+  // III, converges for all eccentricities when the mean anomaly is reduced
+  // to [-π, π].
+  double const revolutions = std::nearbyint(mean_anomaly / (2 * π * Radian));
+  double const M = mean_anomaly / Radian - revolutions * 2 * π;
+  double E = M >= 0 ? M + 0.85 * e : M - 0.85 * e;
+  // The iterations stop when the correction reaches the rounding errors in
+  // the evaluation of the equation, or oscillates at that level.
+  for (int i = 0; i < max_halley_iterations; ++i) {
+    double const e_sin_E = e * std::sin(E);
+    double const f = E - e_sin_E - M;
+    double const fʹ = 1 - e * std::cos(E);
+    double const fʺ = e_sin_E;
+    double const ΔE = -f / (fʹ - f * fʺ / (2 * fʹ));
+    E += ΔE;
+    if (std::abs(ΔE) <= 4 * std::numeric_limits<double>::epsilon() *
+                            std::max(1.0, std::abs(E))) {
+      break;
+    }
+  }
+  return (E + revolutions * 2 * π) * Radian;
+}
+
+template<typename Frame>
+Angle KeplerOrbit<Frame>::HyperbolicEccentricAnomaly(
+    Angle const& hyperbolic_mean_anomaly,
+    double const e) {
+  double const M = hyperbolic_mean_anomaly / Radian;
+  // The logarithmic starting value of Danby (1987) is too large near the
+  // periapsis, where the cubic term of the series dominates.
+  double const abs_H₀ = std::min(std::log(2 * std::abs(M) / e + 1.8),
+                                 std::cbrt(6 * std::abs(M) / e));
+  double H = M >= 0 ? abs_H₀ : -abs_H₀;
+  for (int i = 0; i < max_halley_iterations; ++i) {
+    double const e_sinh_H = e * std::sinh(H);
+    double const f = e_sinh_H - H - M;
+    double const fʹ = e * std::cosh(H) - 1;
+    double const fʺ = e_sinh_H;
+    double const ΔH = -f / (fʹ - f * fʺ / (2 * fʹ));
+    H += ΔH;
+    if (std::abs(ΔH) <= 4 * std::numeric_limits<double>::epsilon() *
+                            std::max(1.0, std::abs(H))) {
+      break;
+    }
+  }
+  return H * Radian;
 }
 
 template<typename Frame>
@@ -649,10 +788,16 @@ void KeplerOrbit<Frame>::CompleteAnomalies(KeplerianElements<Frame>& elements) {
       return *mean_anomaly -
              (eccentric_anomaly - e * Sin(eccentric_anomaly) * Radian);
     };
-    Angle const eccentric_anomaly = e == 0 ? *mean_anomaly
-                                           : Bisect(kepler_equation,
-                                                    *mean_anomaly - e * Radian,
-                                                    *mean_anomaly + e * Radian);
+    auto const kepler_equation_derivative =
+        [e](Angle const& eccentric_anomaly) -> double {
+      return e * Cos(eccentric_anomaly) - 1;
+    };
+    Angle const eccentric_anomaly =
+        e == 0 ? *mean_anomaly
+               : BracketedNewton(kepler_equation,
+                                 kepler_equation_derivative,
+                                 *mean_anomaly - e * Radian,
+                                 *mean_anomaly + e * Radian);
     true_anomaly = 2 * ArcTan(Sqrt(1 + e) * Sin(eccentric_anomaly / 2),
                               Sqrt(1 - e) * Cos(eccentric_anomaly / 2));
     hyperbolic_mean_anomaly = NaN<Angle>();
@@ -664,10 +809,15 @@ void KeplerOrbit<Frame>::CompleteAnomalies(KeplerianElements<Frame>& elements) {
              (e * Sinh(hyperbolic_eccentric_anomaly) * Radian -
               hyperbolic_eccentric_anomaly);
     };
+    auto const hyperbolic_kepler_equation_derivative =
+        [e](Angle const& hyperbolic_eccentric_anomaly) -> double {
+      return 1 - e * Cosh(hyperbolic_eccentric_anomaly);
+    };
     Angle const hyperbolic_eccentric_anomaly =
-        Bisect(hyperbolic_kepler_equation,
-               0 * Radian,
-               *hyperbolic_mean_anomaly / (e - 1));
+        BracketedNewton(hyperbolic_kepler_equation,
+                        hyperbolic_kepler_equation_derivative,
+                        0 * Radian,
+                        *hyperbolic_mean_anomaly / (e - 1));
     true_anomaly =
         2 * ArcTan(Sqrt(e + 1) * Sinh(hyperbolic_eccentric_anomaly / 2),
                    Sqrt(e - 1) * Cosh(hyperbolic_eccentric_anomaly / 2));
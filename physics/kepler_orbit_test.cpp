@@ -1,6 +1,8 @@
 ﻿
 #include "physics/kepler_orbit.hpp"
 
+#include <vector>
+
 #include "astronomy/epoch.hpp"
 #include "astronomy/frames.hpp"
 #include "astronomy/time_scales.hpp"
@@ -10,6 +12,7 @@
 #include "physics/solar_system.hpp"
 #include "quantities/astronomy.hpp"
 #include "testing_utilities/almost_equals.hpp"
+#include "testing_utilities/numerics.hpp"
 
 namespace principia {
 namespace physics {
@@ -26,6 +29,7 @@ using quantities::si::Metre;
 using quantities::si::Milli;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
+using testing_utilities::RelativeError;
 using ::testing::AllOf;
 using ::testing::Eq;
 using ::testing::Gt;
@@ -425,6 +429,35 @@ TEST_F(KeplerOrbitTest, Voyager1) {
               AlmostEquals(*VoyagerElements().true_anomaly, 3));
 }
 
+TEST_F(KeplerOrbitTest, BatchStateVectors) {
+  for (auto const& conic : {SimpleEllipse(), SimpleHyperbola()}) {
+    KeplerianElements<ICRFJ2000Equator> elements;
+    elements.semilatus_rectum = conic.semilatus_rectum;
+    elements.periapsis_distance = conic.periapsis_distance;
+    elements.inclination = 10 * Degree;
+    elements.longitude_of_ascending_node = 70 * Degree;
+    elements.argument_of_periapsis = 30 * Degree;
+    elements.true_anomaly = conic.true_anomaly;
+    KeplerOrbit<ICRFJ2000Equator> const orbit(
+        body_, MasslessBody{}, elements, J2000);
+    std::vector<Instant> times;
+    for (int i = -50; i <= 50; ++i) {
+      times.push_back(J2000 + i * 0.1 * JulianYear);
+    }
+    auto const state_vectors = orbit.StateVectors(times);
+    ASSERT_EQ(times.size(), state_vectors.size());
+    for (int i = 0; i < times.size(); ++i) {
+      auto const expected = orbit.StateVectors(times[i]);
+      EXPECT_THAT(RelativeError(expected.displacement(),
+                                state_vectors[i].displacement()),
+                  Lt(1e-13)) << times[i];
+      EXPECT_THAT(RelativeError(expected.velocity(),
+                                state_vectors[i].velocity()),
+                  Lt(1e-13)) << times[i];
+    }
+  }
+}
+
 TEST_F(KeplerOrbitTest, TrueAnomalyToEllipticMeanAnomaly) {
   KeplerianElements<ICRFJ2000Equator> elements;
   elements.semilatus_rectum = SimpleEllipse().semilatus_rectum;
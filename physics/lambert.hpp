@@ -0,0 +1,55 @@
+﻿
+#pragma once
+
+#include <optional>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_lambert {
+
+using geometry::Displacement;
+using geometry::Velocity;
+using quantities::GravitationalParameter;
+using quantities::Time;
+
+template<typename Frame>
+struct LambertSolution final {
+  // The velocity at the initial position.
+  Velocity<Frame> initial_velocity;
+  // The velocity at the final position.
+  Velocity<Frame> final_velocity;
+};
+
+// Solves Lambert's problem: finds the Keplerian arc about a primary of
+// gravitational parameter |μ| that goes from |initial_position| to
+// |final_position|, both relative to the primary, in time |time_of_flight|,
+// with less than one revolution.  If |short_way| is true the transfer angle is
+// less than π, otherwise it is greater than π.  The problem is solved with
+// universal variables by bisection on ψ, the square of the change of
+// eccentric anomaly, see Bate, Mueller and White (1971), Fundamentals of
+// Astrodynamics, section 5.3, and Vallado (2013), Fundamentals of
+// Astrodynamics and Applications, algorithm 58.  Returns |std::nullopt| if the
+// positions are opposite, in which case the plane of the transfer is
+// undefined, or if |time_of_flight| is not positive.
+template<typename Frame>
+std::optional<LambertSolution<Frame>> SolveLambertProblem(
+    GravitationalParameter const& μ,
+    Displacement<Frame> const& initial_position,
+    Displacement<Frame> const& final_position,
+    Time const& time_of_flight,
+    bool short_way);
+
+}  // namespace internal_lambert
+
+using internal_lambert::LambertSolution;
+using internal_lambert::SolveLambertProblem;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/lambert_body.hpp"
@@ -0,0 +1,121 @@
+﻿
+#pragma once
+
+#include "physics/lambert.hpp"
+
+#include <cmath>
+
+#include "numerics/root_finders.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_lambert {
+
+using geometry::InnerProduct;
+using numerics::Bisect;
+using quantities::Length;
+using quantities::Pow;
+using quantities::Sqrt;
+
+// The Stumpff functions c₂ and c₃.  Near 0 their series are used to avoid
+// cancellations.  c₂ is written with half-angles so that it remains accurate
+// near its zero at (2π)².
+inline double StumpffC2(double const ψ) {
+  if (ψ > 1e-6) {
+    double const sin_half = std::sin(std::sqrt(ψ) / 2);
+    return 2 * sin_half * sin_half / ψ;
+  } else if (ψ < -1e-6) {
+    double const sinh_half = std::sinh(std::sqrt(-ψ) / 2);
+    return -2 * sinh_half * sinh_half / ψ;
+  } else {
+    return 1.0 / 2.0 - ψ / 24.0 + ψ * ψ / 720.0;
+  }
+}
+
+inline double StumpffC3(double const ψ) {
+  if (ψ > 1e-6) {
+    double const sqrt_ψ = std::sqrt(ψ);
+    return (sqrt_ψ - std::sin(sqrt_ψ)) / (ψ * sqrt_ψ);
+  } else if (ψ < -1e-6) {
+    double const sqrt_minus_ψ = std::sqrt(-ψ);
+    return (std::sinh(sqrt_minus_ψ) - sqrt_minus_ψ) /
+           (-ψ * sqrt_minus_ψ);
+  } else {
+    return 1.0 / 6.0 - ψ / 120.0 + ψ * ψ / 5040.0;
+  }
+}
+
+template<typename Frame>
+std::optional<LambertSolution<Frame>> SolveLambertProblem(
+    GravitationalParameter const& μ,
+    Displacement<Frame> const& initial_position,
+    Displacement<Frame> const& final_position,
+    Time const& time_of_flight,
+    bool const short_way) {
+  if (time_of_flight <= Time()) {
+    return std::nullopt;
+  }
+  Length const r1 = initial_position.Norm();
+  Length const r2 = final_position.Norm();
+
+  // The computation is done in units where |r1| and μ are 1, because the
+  // universal variables have fractional dimensions.
+  Time const time_unit = Sqrt(Pow<3>(r1) / μ);
+  double const r̂2 = r2 / r1;
+  double const τ = time_of_flight / time_unit;
+  double const cos_Δν = InnerProduct(initial_position, final_position) /
+                        (r1 * r2);
+  double const A = (short_way ? 1 : -1) * std::sqrt(r̂2 * (1 + cos_Δν));
+  if (A == 0) {
+    return std::nullopt;
+  }
+
+  auto const y = [A, r̂2](double const ψ) {
+    return 1 + r̂2 + A * (ψ * StumpffC3(ψ) - 1) / std::sqrt(StumpffC2(ψ));
+  };
+  // The time of flight as a function of ψ, minus |τ|.  It is increasing.  The
+  // values of ψ for which y is negative are not physical, the time of flight
+  // tends to 0 as y tends to 0, so we extend it by 0 there.
+  auto const Δτ = [A, τ, &y](double const ψ) {
+    double const y_ψ = y(ψ);
+    if (y_ψ <= 0) {
+      return -τ;
+    }
+    double const c2 = StumpffC2(ψ);
+    double const χ = std::sqrt(y_ψ / c2);
+    return χ * χ * χ * StumpffC3(ψ) + A * std::sqrt(y_ψ) - τ;
+  };
+
+  // The time of flight tends to infinity as ψ tends to (2π)², which
+  // corresponds to one revolution.  For short times of flight the orbit is
+  // hyperbolic and ψ is negative.
+  double const upper_ψ = 4 * π * π * (1 - 1e-9);
+  double lower_ψ = -4 * π * π;
+  while (Δτ(lower_ψ) > 0) {
+    lower_ψ *= 2;
+    if (!std::isfinite(Δτ(lower_ψ))) {
+      return std::nullopt;
+    }
+  }
+  if (Δτ(upper_ψ) < 0) {
+    return std::nullopt;
+  }
+  double const ψ = Bisect(Δτ, lower_ψ, upper_ψ);
+  double const y_ψ = y(ψ);
+  if (y_ψ <= 0) {
+    return std::nullopt;
+  }
+
+  // The Lagrange coefficients.
+  double const f = 1 - y_ψ;
+  Time const g = A * std::sqrt(y_ψ) * time_unit;
+  double const ġ = 1 - y_ψ / r̂2;
+  return LambertSolution<Frame>{(final_position - f * initial_position) / g,
+                                (ġ * final_position - initial_position) / g};
+}
+
+}  // namespace internal_lambert
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,119 @@
+﻿
+#include "physics/lambert.hpp"
+
+#include "astronomy/frames.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/sign.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/kepler_orbit.hpp"
+#include "physics/massive_body.hpp"
+#include "physics/massless_body.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_lambert {
+
+using astronomy::ICRFJ2000Equator;
+using geometry::Instant;
+using geometry::Sign;
+using geometry::Wedge;
+using quantities::Pow;
+using quantities::si::Degree;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Minute;
+using quantities::si::Second;
+using testing_utilities::RelativeError;
+using ::testing::Lt;
+
+class LambertTest : public ::testing::Test {
+ protected:
+  LambertTest()
+      : earth_(3.986004418e14 * Pow<3>(Metre) / Pow<2>(Second)) {}
+
+  // Checks that the solution of Lambert's problem between the states of
+  // |orbit| at |t1| and |t2| matches the velocities of |orbit|.
+  void CheckSolution(KeplerOrbit<ICRFJ2000Equator> const& orbit,
+                     Instant const& t1,
+                     Instant const& t2) {
+    auto const state1 = orbit.StateVectors(t1);
+    auto const state2 = orbit.StateVectors(t2);
+    Displacement<ICRFJ2000Equator> const r1 = state1.displacement();
+    Displacement<ICRFJ2000Equator> const r2 = state2.displacement();
+    // The transfer is short-way if it goes in the direction of the angular
+    // momentum.
+    bool const short_way =
+        Sign(InnerProduct(Wedge(r1, r2), Wedge(r1, state1.velocity())))
+            .is_positive();
+    auto const solution = SolveLambertProblem(
+        earth_.gravitational_parameter(), r1, r2, t2 - t1, short_way);
+    ASSERT_TRUE(solution.has_value());
+    EXPECT_THAT(RelativeError(state1.velocity(), solution->initial_velocity),
+                Lt(1e-8));
+    EXPECT_THAT(RelativeError(state2.velocity(), solution->final_velocity),
+                Lt(1e-8));
+  }
+
+  MassiveBody const earth_;
+  MasslessBody const satellite_;
+  Instant const t0_;
+};
+
+TEST_F(LambertTest, Elliptic) {
+  KeplerianElements<ICRFJ2000Equator> elements;
+  elements.eccentricity = 0.3;
+  elements.semimajor_axis = 20'000 * Kilo(Metre);
+  elements.inclination = 30 * Degree;
+  elements.longitude_of_ascending_node = 40 * Degree;
+  elements.argument_of_periapsis = 50 * Degree;
+  elements.mean_anomaly = 10 * Degree;
+  KeplerOrbit<ICRFJ2000Equator> const orbit(earth_, satellite_, elements, t0_);
+  Time const period = *orbit.elements_at_epoch().period;
+
+  // Short way, through the periapsis and the apoapsis.
+  CheckSolution(orbit, t0_, t0_ + 0.2 * period);
+  CheckSolution(orbit, t0_ + 0.4 * period, t0_ + 0.7 * period);
+  // Long way.
+  CheckSolution(orbit, t0_, t0_ + 0.8 * period);
+  CheckSolution(orbit, t0_ + 0.1 * period, t0_ + 0.95 * period);
+}
+
+TEST_F(LambertTest, Hyperbolic) {
+  KeplerOrbit<ICRFJ2000Equator> const orbit(
+      earth_,
+      satellite_,
+      RelativeDegreesOfFreedom<ICRFJ2000Equator>(
+          Displacement<ICRFJ2000Equator>(
+              {7'000 * Kilo(Metre), 0 * Metre, 0 * Metre}),
+          Velocity<ICRFJ2000Equator>({1 * Kilo(Metre) / Second,
+                                      12 * Kilo(Metre) / Second,
+                                      2 * Kilo(Metre) / Second})),
+      t0_);
+  ASSERT_THAT(*orbit.elements_at_epoch().eccentricity, testing::Gt(1));
+  CheckSolution(orbit, t0_, t0_ + 10 * Minute);
+  CheckSolution(orbit, t0_ - 30 * Minute, t0_ + 30 * Minute);
+}
+
+TEST_F(LambertTest, Degenerate) {
+  Displacement<ICRFJ2000Equator> const r1(
+      {7'000 * Kilo(Metre), 0 * Metre, 0 * Metre});
+  EXPECT_FALSE(SolveLambertProblem(earth_.gravitational_parameter(),
+                                   r1,
+                                   -2 * r1,
+                                   30 * Minute,
+                                   /*short_way=*/true).has_value());
+  EXPECT_FALSE(SolveLambertProblem(earth_.gravitational_parameter(),
+                                   r1,
+                                   Displacement<ICRFJ2000Equator>(
+                                       {0 * Metre, 7'000 * Kilo(Metre),
+                                        0 * Metre}),
+                                   -30 * Minute,
+                                   /*short_way=*/true).has_value());
+}
+
+}  // namespace internal_lambert
+}  // namespace physics
+}  // namespace principia
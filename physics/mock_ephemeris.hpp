@@ -1,6 +1,8 @@
 ﻿
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -21,6 +23,7 @@ class MockEphemeris : public Ephemeris<Frame> {
   using typename Ephemeris<Frame>::IntrinsicAcceleration;
   using typename Ephemeris<Frame>::IntrinsicAccelerations;
   using typename Ephemeris<Frame>::NewtonianMotionEquation;
+  using typename Ephemeris<Frame>::ParallelProlongationParameters;
 
   MockEphemeris()
       : Ephemeris<Frame>(
@@ -31,6 +34,13 @@ class MockEphemeris : public Ephemeris<Frame> {
   MOCK_CONST_METHOD1_T(trajectory,
                        not_null<ContinuousTrajectory<Frame> const*>(
                            not_null<MassiveBody const*> body));
+  MOCK_CONST_METHOD1_T(body_index, int(not_null<MassiveBody const*> body));
+  MOCK_CONST_METHOD1_T(trajectory_for_body_index,
+                       not_null<ContinuousTrajectory<Frame> const*>(
+                           int body_index));
+  MOCK_CONST_METHOD2_T(EvaluateAllPositions,
+                       void(Instant const& t,
+                            std::vector<Position<Frame>>& positions));
   MOCK_CONST_METHOD0_T(empty, bool());
   MOCK_CONST_METHOD0_T(t_min, Instant());
   MOCK_CONST_METHOD0_T(t_max, Instant());
@@ -40,6 +50,13 @@ class MockEphemeris : public Ephemeris<Frame> {
 
   MOCK_METHOD1_T(ForgetBefore, void(Instant const& t));
   MOCK_METHOD1_T(Prolong, void(Instant const& t));
+  MOCK_METHOD2_T(ProlongInParallel,
+                 void(Instant const& t,
+                      ParallelProlongationParameters const& parameters));
+  MOCK_METHOD1_T(SetMassiveBodiesScheduler,
+                 void(WorkStealingScheduler* scheduler));
+  MOCK_METHOD1_T(SetMassiveBodiesTreeEvaluation, void(bool enabled));
+  MOCK_METHOD1_T(SetMasslessBodiesCullingThreshold, void(double threshold));
   MOCK_METHOD3_T(
       NewInstance,
       not_null<std::unique_ptr<
@@ -47,6 +64,13 @@ class MockEphemeris : public Ephemeris<Frame> {
           std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
           IntrinsicAccelerations const& intrinsic_accelerations,
           FixedStepParameters const& parameters));
+  MOCK_METHOD3_T(
+      NewInstanceWithHistory,
+      not_null<std::unique_ptr<
+          typename Integrator<NewtonianMotionEquation>::Instance>>(
+          std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+          IntrinsicAccelerations const& intrinsic_accelerations,
+          FixedStepParameters const& parameters));
   MOCK_METHOD6_T(
       FlowWithAdaptiveStep,
       Status(not_null<DiscreteTrajectory<Frame>*> trajectory,
@@ -55,6 +79,23 @@ class MockEphemeris : public Ephemeris<Frame> {
              AdaptiveStepParameters const& parameters,
              std::int64_t max_ephemeris_steps,
              bool last_point_only));
+  MOCK_METHOD6_T(
+      FlowWithAdaptiveStepBefore,
+      Status(not_null<DiscreteTrajectory<Frame>*> trajectory,
+             IntrinsicAcceleration intrinsic_acceleration,
+             Instant const& t,
+             AdaptiveStepParameters const& parameters,
+             std::int64_t max_ephemeris_steps,
+             std::chrono::steady_clock::time_point const& deadline));
+  MOCK_METHOD6_T(
+      FlowManyWithAdaptiveStep,
+      Status(std::vector<not_null<DiscreteTrajectory<Frame>*>> const&
+                 trajectories,
+             IntrinsicAccelerations const& intrinsic_accelerations,
+             Instant const& t,
+             std::vector<AdaptiveStepParameters> const& parameters,
+             std::int64_t max_ephemeris_steps,
+             bool last_point_only));
   MOCK_METHOD2_T(
       FlowWithFixedStep,
       Status(Instant const& t,
@@ -85,9 +126,12 @@ class MockEphemeris : public Ephemeris<Frame> {
   MOCK_CONST_METHOD1_T(
       body_for_serialization_index,
       not_null<MassiveBody const*>(int serialization_index));
+  MOCK_CONST_METHOD0_T(Fingerprint, std::uint64_t());
 
   MOCK_CONST_METHOD1_T(WriteToMessage,
                        void(not_null<serialization::Ephemeris*> message));
+  MOCK_CONST_METHOD1_T(WriteToSnapshot,
+                       void(not_null<std::vector<std::uint8_t>*> bytes));
 };
 
 }  // namespace internal_ephemeris
@@ -0,0 +1,97 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "base/work_stealing_scheduler.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/massive_body.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_porkchop {
+
+using base::not_null;
+using base::WorkStealingScheduler;
+using geometry::Instant;
+using geometry::Velocity;
+using quantities::Length;
+using quantities::Speed;
+
+template<typename Frame>
+struct PorkchopParameters final {
+  // The departure times are |departure_samples| equally spaced times from
+  // |departure_begin| to |departure_end|, both included; similarly for the
+  // arrival times.  The sample counts must be at least 2.
+  Instant departure_begin;
+  Instant departure_end;
+  std::int64_t departure_samples;
+  Instant arrival_begin;
+  Instant arrival_end;
+  std::int64_t arrival_samples;
+
+  // The number of cells, in increasing order of total excess speed, whose
+  // Keplerian transfer is checked against an n-body integration.
+  std::int64_t refined_cells;
+  typename Ephemeris<Frame>::AdaptiveStepParameters refinement_parameters;
+};
+
+template<typename Frame>
+struct PorkchopCell final {
+  Instant departure_time;
+  Instant arrival_time;
+  // False if the arrival is not after the departure or if Lambert's problem
+  // has no solution.  The other members are meaningless in that case.
+  bool has_solution = false;
+  // The velocity of the transfer minus that of the departure body at
+  // departure, and the velocity of the arrival body minus that of the
+  // transfer at arrival.
+  Velocity<Frame> departure_excess_velocity;
+  Velocity<Frame> arrival_excess_velocity;
+  // The distance between the n-body integration and the Keplerian transfer
+  // at the end of the refinement, for the refined cells.
+  std::optional<Length> n_body_deviation;
+
+  Speed total_excess_speed() const;
+};
+
+// The cells of a porkchop plot, in row-major order: the cell for departure
+// sample i and arrival sample j is at index |i * arrival_samples + j|.
+template<typename Frame>
+using Porkchop = std::vector<PorkchopCell<Frame>>;
+
+// Computes a porkchop plot for transfers from |departure_body| to
+// |arrival_body|.  The transfers are Keplerian arcs about |primary|, obtained
+// by solving Lambert's problem for the positions of the bodies taken from
+// |ephemeris|; they are short-way if they turn in the direction of the orbit
+// of |departure_body|.  The rows of the grid are computed in parallel on
+// |scheduler|.  The best cells are then refined: the transfer is integrated
+// in the full n-body field, away from the singularities at the ends, from 5%
+// to 95% of the time of flight, and compared with the Keplerian arc.  The
+// ephemeris is prolonged to the end of the arrival window.
+template<typename Frame>
+Porkchop<Frame> ComputePorkchop(
+    PorkchopParameters<Frame> const& parameters,
+    not_null<MassiveBody const*> primary,
+    not_null<MassiveBody const*> departure_body,
+    not_null<MassiveBody const*> arrival_body,
+    Ephemeris<Frame>& ephemeris,
+    not_null<WorkStealingScheduler*> scheduler);
+
+}  // namespace internal_porkchop
+
+using internal_porkchop::ComputePorkchop;
+using internal_porkchop::Porkchop;
+using internal_porkchop::PorkchopCell;
+using internal_porkchop::PorkchopParameters;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/porkchop_body.hpp"
@@ -0,0 +1,201 @@
+﻿
+#pragma once
+
+#include "physics/porkchop.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "geometry/sign.hpp"
+#include "glog/logging.h"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "physics/kepler_orbit.hpp"
+#include "physics/lambert.hpp"
+#include "physics/massless_body.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_porkchop {
+
+using base::Future;
+using base::Status;
+using geometry::InnerProduct;
+using geometry::Position;
+using geometry::Sign;
+using geometry::Wedge;
+using quantities::Time;
+
+template<typename Frame>
+Speed PorkchopCell<Frame>::total_excess_speed() const {
+  return departure_excess_velocity.Norm() + arrival_excess_velocity.Norm();
+}
+
+template<typename Frame>
+Porkchop<Frame> ComputePorkchop(
+    PorkchopParameters<Frame> const& parameters,
+    not_null<MassiveBody const*> const primary,
+    not_null<MassiveBody const*> const departure_body,
+    not_null<MassiveBody const*> const arrival_body,
+    Ephemeris<Frame>& ephemeris,
+    not_null<WorkStealingScheduler*> const scheduler) {
+  CHECK_GE(parameters.departure_samples, 2);
+  CHECK_GE(parameters.arrival_samples, 2);
+  CHECK_LE(parameters.departure_begin, parameters.departure_end);
+  CHECK_LE(parameters.arrival_begin, parameters.arrival_end);
+
+  // Prolong the ephemeris once on this thread, the trajectories of the bodies
+  // may then be evaluated concurrently.
+  ephemeris.Prolong(
+      std::max(parameters.departure_end, parameters.arrival_end));
+  auto const primary_trajectory = ephemeris.trajectory(primary);
+  auto const departure_trajectory = ephemeris.trajectory(departure_body);
+  auto const arrival_trajectory = ephemeris.trajectory(arrival_body);
+
+  auto const sample = [](Instant const& begin,
+                         Instant const& end,
+                         std::int64_t const samples,
+                         std::int64_t const i) {
+    return begin + (end - begin) * (static_cast<double>(i) / (samples - 1));
+  };
+  auto const state_relative_to_primary =
+      [&primary_trajectory](ContinuousTrajectory<Frame> const& trajectory,
+                            Instant const& t) {
+    return RelativeDegreesOfFreedom<Frame>(
+        trajectory.EvaluateDegreesOfFreedom(t) -
+        primary_trajectory->EvaluateDegreesOfFreedom(t));
+  };
+
+  Porkchop<Frame> porkchop(parameters.departure_samples *
+                           parameters.arrival_samples);
+
+  auto const compute_row = [&](std::int64_t const i) {
+    Instant const departure_time = sample(parameters.departure_begin,
+                                          parameters.departure_end,
+                                          parameters.departure_samples,
+                                          i);
+    RelativeDegreesOfFreedom<Frame> const departure_state =
+        state_relative_to_primary(*departure_trajectory, departure_time);
+    auto const& r1 = departure_state.displacement();
+    for (std::int64_t j = 0; j < parameters.arrival_samples; ++j) {
+      PorkchopCell<Frame>& cell = porkchop[i * parameters.arrival_samples + j];
+      cell.departure_time = departure_time;
+      cell.arrival_time = sample(parameters.arrival_begin,
+                                 parameters.arrival_end,
+                                 parameters.arrival_samples,
+                                 j);
+      if (cell.arrival_time <= departure_time) {
+        continue;
+      }
+      RelativeDegreesOfFreedom<Frame> const arrival_state =
+          state_relative_to_primary(*arrival_trajectory, cell.arrival_time);
+      auto const& r2 = arrival_state.displacement();
+      bool const short_way =
+          Sign(InnerProduct(Wedge(r1, r2),
+                            Wedge(r1, departure_state.velocity())))
+              .is_positive();
+      auto const solution =
+          SolveLambertProblem(primary->gravitational_parameter(),
+                              r1,
+                              r2,
+                              cell.arrival_time - departure_time,
+                              short_way);
+      if (!solution.has_value()) {
+        continue;
+      }
+      cell.has_solution = true;
+      cell.departure_excess_velocity =
+          solution->initial_velocity - departure_state.velocity();
+      cell.arrival_excess_velocity =
+          arrival_state.velocity() - solution->final_velocity;
+    }
+  };
+
+  // The first row is computed on this thread while the scheduler takes care
+  // of the others.
+  std::vector<Future<void>> futures;
+  futures.reserve(parameters.departure_samples - 1);
+  for (std::int64_t i = 1; i < parameters.departure_samples; ++i) {
+    futures.push_back(scheduler->Add([&compute_row, i]() { compute_row(i); }));
+  }
+  compute_row(0);
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  // Select the best cells.
+  std::vector<std::size_t> best_cells;
+  for (std::size_t k = 0; k < porkchop.size(); ++k) {
+    if (porkchop[k].has_solution) {
+      best_cells.push_back(k);
+    }
+  }
+  std::size_t const refined_cells =
+      std::min<std::size_t>(parameters.refined_cells, best_cells.size());
+  std::partial_sort(best_cells.begin(),
+                    best_cells.begin() + refined_cells,
+                    best_cells.end(),
+                    [&porkchop](std::size_t const left,
+                                std::size_t const right) {
+                      return porkchop[left].total_excess_speed() <
+                             porkchop[right].total_excess_speed();
+                    });
+  best_cells.resize(refined_cells);
+
+  // Integrate their transfers.  The integrations have distinct end times, so
+  // they are run as separate tasks rather than with
+  // |FlowIndependentlyWithAdaptiveStep|.
+  auto const refine = [&](PorkchopCell<Frame>& cell) {
+    Time const time_of_flight = cell.arrival_time - cell.departure_time;
+    Instant const t_begin = cell.departure_time + 0.05 * time_of_flight;
+    Instant const t_end = cell.departure_time + 0.95 * time_of_flight;
+    RelativeDegreesOfFreedom<Frame> const departure_state =
+        state_relative_to_primary(*departure_trajectory, cell.departure_time);
+    KeplerOrbit<Frame> const transfer(
+        *primary,
+        MasslessBody(),
+        RelativeDegreesOfFreedom<Frame>(
+            departure_state.displacement(),
+            departure_state.velocity() + cell.departure_excess_velocity),
+        cell.departure_time);
+
+    DiscreteTrajectory<Frame> trajectory;
+    trajectory.Append(t_begin,
+                      primary_trajectory->EvaluateDegreesOfFreedom(t_begin) +
+                          transfer.StateVectors(t_begin));
+    Status const status = ephemeris.FlowWithAdaptiveStep(
+        &trajectory,
+        Ephemeris<Frame>::NoIntrinsicAcceleration,
+        t_end,
+        parameters.refinement_parameters,
+        Ephemeris<Frame>::unlimited_max_ephemeris_steps,
+        /*last_point_only=*/true);
+    if (!status.ok()) {
+      return;
+    }
+    Position<Frame> const keplerian_position =
+        primary_trajectory->EvaluatePosition(t_end) +
+        transfer.StateVectors(t_end).displacement();
+    cell.n_body_deviation =
+        (trajectory.last().degrees_of_freedom().position() -
+         keplerian_position).Norm();
+  };
+
+  futures.clear();
+  for (std::size_t k = 1; k < best_cells.size(); ++k) {
+    PorkchopCell<Frame>& cell = porkchop[best_cells[k]];
+    futures.push_back(scheduler->Add([&refine, &cell]() { refine(cell); }));
+  }
+  if (!best_cells.empty()) {
+    refine(porkchop[best_cells[0]]);
+  }
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  return porkchop;
+}
+
+}  // namespace internal_porkchop
+}  // namespace physics
+}  // namespace principia
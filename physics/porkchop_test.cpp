@@ -0,0 +1,147 @@
+﻿
+#include "physics/porkchop.hpp"
+
+#include <limits>
+#include <vector>
+
+#include "base/work_stealing_scheduler.hpp"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/ephemeris.hpp"
+#include "quantities/astronomy.hpp"
+#include "quantities/elementary_functions.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_porkchop {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Position;
+using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
+using integrators::methods::QuinlanTremaine1990Order12;
+using quantities::Cos;
+using quantities::GravitationalParameter;
+using quantities::Length;
+using quantities::Sin;
+using quantities::Sqrt;
+using quantities::astronomy::SolarMass;
+using quantities::constants::GravitationalConstant;
+using quantities::si::AstronomicalUnit;
+using quantities::si::Day;
+using quantities::si::Degree;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Minute;
+using quantities::si::Second;
+using ::testing::AllOf;
+using ::testing::Gt;
+using ::testing::Lt;
+
+class PorkchopTest : public ::testing::Test {
+ protected:
+  using World =
+      Frame<serialization::Frame::TestTag, serialization::Frame::TEST1, true>;
+};
+
+#if !defined(_DEBUG)
+
+// A transfer between two planets on coplanar circular orbits at the distances
+// of the Earth and Mars, with the outer planet placed for a Hohmann transfer
+// at t0.
+TEST_F(PorkchopTest, HohmannTransfer) {
+  Instant const t0;
+  GravitationalParameter const μ = GravitationalConstant * SolarMass;
+  auto const sun = new MassiveBody(μ);
+  auto const inner = new MassiveBody(3e-6 * SolarMass);
+  auto const outer = new MassiveBody(3.2e-7 * SolarMass);
+  Length const r_inner = 1 * AstronomicalUnit;
+  Length const r_outer = 1.524 * AstronomicalUnit;
+
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<World>> initial_state;
+  bodies.emplace_back(std::unique_ptr<MassiveBody const>(sun));
+  initial_state.emplace_back(World::origin, Velocity<World>());
+  bodies.emplace_back(std::unique_ptr<MassiveBody const>(inner));
+  initial_state.emplace_back(
+      World::origin + Displacement<World>({r_inner, 0 * Metre, 0 * Metre}),
+      Velocity<World>({0 * Metre / Second,
+                       Sqrt(μ / r_inner),
+                       0 * Metre / Second}));
+  bodies.emplace_back(std::unique_ptr<MassiveBody const>(outer));
+  double const cos_phase = Cos(44 * Degree);
+  double const sin_phase = Sin(44 * Degree);
+  initial_state.emplace_back(
+      World::origin + Displacement<World>({r_outer * cos_phase,
+                                           r_outer * sin_phase,
+                                           0 * Metre}),
+      Velocity<World>({-Sqrt(μ / r_outer) * sin_phase,
+                       Sqrt(μ / r_outer) * cos_phase,
+                       0 * Metre / Second}));
+
+  Ephemeris<World> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0,
+      5 * Milli(Metre),
+      Ephemeris<World>::FixedStepParameters(
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<World>>(),
+          10 * Minute));
+
+  PorkchopParameters<World> parameters{
+      /*departure_begin=*/t0,
+      /*departure_end=*/t0 + 40 * Day,
+      /*departure_samples=*/5,
+      /*arrival_begin=*/t0 + 220 * Day,
+      /*arrival_end=*/t0 + 300 * Day,
+      /*arrival_samples=*/9,
+      /*refined_cells=*/3,
+      Ephemeris<World>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Position<World>>(),
+          std::numeric_limits<std::int64_t>::max(),
+          1e-3 * Metre,
+          1e-3 * Metre / Second)};
+
+  WorkStealingScheduler scheduler(/*pool_size=*/3);
+  Porkchop<World> const porkchop = ComputePorkchop(
+      parameters, sun, inner, outer, ephemeris, &scheduler);
+  ASSERT_EQ(45, porkchop.size());
+  EXPECT_EQ(t0 + 10 * Day, porkchop[9].departure_time);
+  EXPECT_EQ(t0 + 230 * Day, porkchop[10].arrival_time);
+
+  // The Hohmann transfer has excess speeds of about 2.94 and 2.65 km/s.
+  Speed const hohmann = (2.94 + 2.65) * Kilo(Metre) / Second;
+  PorkchopCell<World> const* best = nullptr;
+  int refined_cells = 0;
+  for (auto const& cell : porkchop) {
+    ASSERT_TRUE(cell.has_solution);
+    if (best == nullptr ||
+        cell.total_excess_speed() < best->total_excess_speed()) {
+      best = &cell;
+    }
+    if (cell.n_body_deviation.has_value()) {
+      ++refined_cells;
+      // The planets perturb the transfer only slightly.
+      EXPECT_THAT(*cell.n_body_deviation, Lt(0.01 * AstronomicalUnit));
+    }
+  }
+  EXPECT_EQ(3, refined_cells);
+  EXPECT_TRUE(best->n_body_deviation.has_value());
+  EXPECT_THAT(best->total_excess_speed(),
+              AllOf(Gt(0.95 * hohmann), Lt(1.1 * hohmann)));
+}
+
+#endif
+
+}  // namespace internal_porkchop
+}  // namespace physics
+}  // namespace principia
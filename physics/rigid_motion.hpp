@@ -2,6 +2,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include "geometry/affine_map.hpp"
 #include "geometry/named_quantities.hpp"
@@ -49,6 +50,12 @@ class RigidMotion final {
   DegreesOfFreedom<ToFrame> operator()(
       DegreesOfFreedom<FromFrame> const& degrees_of_freedom) const;
 
+  // Applies this motion to each of the |degrees_of_freedom|.  The parts of the
+  // computation that don't depend on the degrees of freedom are done once, see
+  // the batch operator of |OrthogonalMap|.
+  std::vector<DegreesOfFreedom<ToFrame>> operator()(
+      std::vector<DegreesOfFreedom<FromFrame>> const& degrees_of_freedom) const;
+
   RigidMotion<ToFrame, FromFrame> Inverse() const;
 
  private:
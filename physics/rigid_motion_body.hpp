@@ -56,6 +56,35 @@ DegreesOfFreedom<ToFrame> RigidMotion<FromFrame, ToFrame>::operator()(
                   Radian)};
 }
 
+template<typename FromFrame, typename ToFrame>
+std::vector<DegreesOfFreedom<ToFrame>> RigidMotion<FromFrame, ToFrame>::
+operator()(
+    std::vector<DegreesOfFreedom<FromFrame>> const& degrees_of_freedom) const {
+  Position<FromFrame> const to_frame_origin =
+      rigid_transformation_.Inverse()(ToFrame::origin);
+  std::vector<Position<FromFrame>> positions;
+  std::vector<Velocity<FromFrame>> velocities;
+  positions.reserve(degrees_of_freedom.size());
+  velocities.reserve(degrees_of_freedom.size());
+  for (auto const& dof : degrees_of_freedom) {
+    positions.push_back(dof.position());
+    velocities.push_back(
+        dof.velocity() - velocity_of_to_frame_origin_ -
+        angular_velocity_of_to_frame_ * (dof.position() - to_frame_origin) /
+            Radian);
+  }
+  std::vector<Position<ToFrame>> const to_positions =
+      rigid_transformation_(positions);
+  std::vector<Velocity<ToFrame>> const to_velocities =
+      orthogonal_map()(velocities);
+  std::vector<DegreesOfFreedom<ToFrame>> result;
+  result.reserve(degrees_of_freedom.size());
+  for (int i = 0; i < degrees_of_freedom.size(); ++i) {
+    result.emplace_back(to_positions[i], to_velocities[i]);
+  }
+  return result;
+}
+
 template<typename FromFrame, typename ToFrame>
 RigidMotion<ToFrame, FromFrame>
 RigidMotion<FromFrame, ToFrame>::Inverse() const {
@@ -10,6 +10,7 @@
 #include "quantities/si.hpp"
 #include "testing_utilities/almost_equals.hpp"
 #include "testing_utilities/componentwise.hpp"
+#include "testing_utilities/numerics.hpp"
 #include "testing_utilities/vanishes_before.hpp"
 
 namespace principia {
@@ -30,7 +31,9 @@ using quantities::si::Metre;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
 using testing_utilities::Componentwise;
+using testing_utilities::RelativeError;
 using testing_utilities::VanishesBefore;
+using ::testing::Lt;
 
 class RigidMotionTest : public testing::Test {
  protected:
@@ -156,6 +159,29 @@ TEST_F(RigidMotionTest, GroupoidAssociativity) {
   EXPECT_THAT(d1.velocity(), AlmostEquals(d2.velocity(), 4));
 }
 
+TEST_F(RigidMotionTest, Batch) {
+  auto const terrestrial_to_lunar = selenocentric_to_lunar_ *
+                                    geocentric_to_selenocentric_ *
+                                    geocentric_to_terrestrial_.Inverse();
+  std::vector<DegreesOfFreedom<Terrestrial>> const degrees_of_freedom = {
+      degrees_of_freedom_,
+      {Terrestrial::origin, Velocity<Terrestrial>()}};
+  std::vector<DegreesOfFreedom<Lunar>> const lunar_degrees_of_freedom =
+      terrestrial_to_lunar(degrees_of_freedom);
+  ASSERT_EQ(2, lunar_degrees_of_freedom.size());
+  for (int i = 0; i < degrees_of_freedom.size(); ++i) {
+    DegreesOfFreedom<Lunar> const expected =
+        terrestrial_to_lunar(degrees_of_freedom[i]);
+    EXPECT_THAT(RelativeError(expected.position() - Lunar::origin,
+                              lunar_degrees_of_freedom[i].position() -
+                                  Lunar::origin),
+                Lt(1e-14));
+    EXPECT_THAT(RelativeError(expected.velocity(),
+                              lunar_degrees_of_freedom[i].velocity()),
+                Lt(1e-14));
+  }
+}
+
 TEST_F(RigidMotionTest, GroupoidAction) {
   auto const terrestrial_to_geocentric = geocentric_to_terrestrial_.Inverse();
   auto const geocentric_to_lunar =
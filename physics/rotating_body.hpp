@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "geometry/grassmann.hpp"
+#include "geometry/quaternion.hpp"
 #include "geometry/rotation.hpp"
 #include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
@@ -20,9 +21,11 @@ namespace internal_rotating_body {
 
 using base::not_null;
 using geometry::AngularVelocity;
+using geometry::Bivector;
 using geometry::DefinesFrame;
 using geometry::EulerAngles;
 using geometry::Instant;
+using geometry::Quaternion;
 using geometry::Rotation;
 using geometry::Vector;
 using quantities::Angle;
@@ -129,6 +132,10 @@ class RotatingBody : public MassiveBody {
   Parameters const parameters_;
   Vector<double, Frame> const polar_axis_;
   AngularVelocity<Frame> const angular_velocity_;
+  // The product of the first two rotations of the Euler angles of
+  // |FromSurfaceFrame|, which only depend on the pole.  Precomputing it leaves
+  // a single rotation, about the z axis, to compute at each evaluation.
+  Quaternion const pole_orientation_;
 };
 
 // Define template member functions even when importing: these are not
@@ -138,12 +145,14 @@ template<typename Frame>
 template<typename SurfaceFrame>
 Rotation<SurfaceFrame, Frame> RotatingBody<Frame>::FromSurfaceFrame(
     Instant const& t) const {
+  // Equivalent to the ZXZ Euler angles (π / 2 + right_ascension_of_pole,
+  // π / 2 - declination_of_pole, AngleAt(t)), where the first two rotations
+  // are in |pole_orientation_|.  The frame of the
+  // bivector is irrelevant, only its coordinates define the axis.
   return Rotation<SurfaceFrame, Frame>(
-      π / 2 * Radian + right_ascension_of_pole(),
-      π / 2 * Radian - declination_of_pole(),
-      AngleAt(t),
-      EulerAngles::ZXZ,
-      DefinesFrame<SurfaceFrame>{});
+      pole_orientation_ *
+      Rotation<Frame, Frame>(AngleAt(t), Bivector<double, Frame>({0, 0, 1}))
+          .quaternion());
 }
 
 template<typename Frame>
@@ -53,7 +53,14 @@ RotatingBody<Frame>::RotatingBody(
                       parameters.declination_of_pole_,
                       parameters.right_ascension_of_pole_).ToCartesian()),
       angular_velocity_(polar_axis_.coordinates() *
-                        parameters.angular_frequency_) {}
+                        parameters.angular_frequency_),
+      pole_orientation_(
+          (Rotation<Frame, Frame>(
+               π / 2 * Radian + parameters.right_ascension_of_pole_,
+               Bivector<double, Frame>({0, 0, 1})) *
+           Rotation<Frame, Frame>(
+               π / 2 * Radian - parameters.declination_of_pole_,
+               Bivector<double, Frame>({1, 0, 0}))).quaternion()) {}
 
 template<typename Frame>
 Length RotatingBody<Frame>::mean_radius() const {
@@ -0,0 +1,82 @@
+﻿
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "geometry/rotation.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/dynamic_frame.hpp"
+#include "physics/rigid_motion.hpp"
+#include "quantities/named_quantities.hpp"
+#include "serialization/physics.pb.h"
+
+namespace principia {
+namespace physics {
+namespace internal_shared_dynamic_frame {
+
+using base::not_null;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Rotation;
+using geometry::Vector;
+using quantities::Acceleration;
+
+// A frame that forwards all its operations to a |frame| whose ownership it
+// shares.  This makes it possible to give unique ownership of a frame, e.g., to
+// a renderer or a manœuvre, while the underlying frame, and in particular its
+// cache of motions, is shared with other owners.  Serializes as the underlying
+// frame.
+template<typename InertialFrame, typename ThisFrame>
+class SharedDynamicFrame : public DynamicFrame<InertialFrame, ThisFrame> {
+ public:
+  explicit SharedDynamicFrame(
+      not_null<std::shared_ptr<DynamicFrame<InertialFrame, ThisFrame> const>>
+          frame);
+
+  // The underlying frame.
+  DynamicFrame<InertialFrame, ThisFrame> const& frame() const;
+
+  Instant t_min() const override;
+  Instant t_max() const override;
+
+  RigidMotion<InertialFrame, ThisFrame> ToThisFrameAtTime(
+      Instant const& t) const override;
+  RigidMotion<ThisFrame, InertialFrame> FromThisFrameAtTime(
+      Instant const& t) const override;
+  std::vector<RigidMotion<InertialFrame, ThisFrame>> ToThisFrameAtTimes(
+      std::vector<Instant> const& times) const override;
+
+  Vector<Acceleration, ThisFrame> GeometricAcceleration(
+      Instant const& t,
+      DegreesOfFreedom<ThisFrame> const& degrees_of_freedom) const override;
+
+  Rotation<Frenet<ThisFrame>, ThisFrame> FrenetFrame(
+      Instant const& t,
+      DegreesOfFreedom<ThisFrame> const& degrees_of_freedom) const override;
+
+  void WriteToMessage(
+      not_null<serialization::DynamicFrame*> message) const override;
+
+ private:
+  Vector<Acceleration, InertialFrame> GravitationalAcceleration(
+      Instant const& t,
+      Position<InertialFrame> const& q) const override;
+  AcceleratedRigidMotion<InertialFrame, ThisFrame> MotionOfThisFrame(
+      Instant const& t) const override;
+
+  not_null<std::shared_ptr<DynamicFrame<InertialFrame, ThisFrame> const>> const
+      frame_;
+};
+
+}  // namespace internal_shared_dynamic_frame
+
+using internal_shared_dynamic_frame::SharedDynamicFrame;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/shared_dynamic_frame_body.hpp"
@@ -0,0 +1,94 @@
+﻿
+#pragma once
+
+#include "physics/shared_dynamic_frame.hpp"
+
+#include <vector>
+
+namespace principia {
+namespace physics {
+namespace internal_shared_dynamic_frame {
+
+template<typename InertialFrame, typename ThisFrame>
+SharedDynamicFrame<InertialFrame, ThisFrame>::SharedDynamicFrame(
+    not_null<std::shared_ptr<DynamicFrame<InertialFrame, ThisFrame> const>>
+        frame)
+    : frame_(std::move(frame)) {}
+
+template<typename InertialFrame, typename ThisFrame>
+DynamicFrame<InertialFrame, ThisFrame> const&
+SharedDynamicFrame<InertialFrame, ThisFrame>::frame() const {
+  return *frame_;
+}
+
+template<typename InertialFrame, typename ThisFrame>
+Instant SharedDynamicFrame<InertialFrame, ThisFrame>::t_min() const {
+  return frame_->t_min();
+}
+
+template<typename InertialFrame, typename ThisFrame>
+Instant SharedDynamicFrame<InertialFrame, ThisFrame>::t_max() const {
+  return frame_->t_max();
+}
+
+template<typename InertialFrame, typename ThisFrame>
+RigidMotion<InertialFrame, ThisFrame>
+SharedDynamicFrame<InertialFrame, ThisFrame>::ToThisFrameAtTime(
+    Instant const& t) const {
+  return frame_->ToThisFrameAtTime(t);
+}
+
+template<typename InertialFrame, typename ThisFrame>
+RigidMotion<ThisFrame, InertialFrame>
+SharedDynamicFrame<InertialFrame, ThisFrame>::FromThisFrameAtTime(
+    Instant const& t) const {
+  return frame_->FromThisFrameAtTime(t);
+}
+
+template<typename InertialFrame, typename ThisFrame>
+std::vector<RigidMotion<InertialFrame, ThisFrame>>
+SharedDynamicFrame<InertialFrame, ThisFrame>::ToThisFrameAtTimes(
+    std::vector<Instant> const& times) const {
+  return frame_->ToThisFrameAtTimes(times);
+}
+
+template<typename InertialFrame, typename ThisFrame>
+Vector<Acceleration, ThisFrame>
+SharedDynamicFrame<InertialFrame, ThisFrame>::GeometricAcceleration(
+    Instant const& t,
+    DegreesOfFreedom<ThisFrame> const& degrees_of_freedom) const {
+  return frame_->GeometricAcceleration(t, degrees_of_freedom);
+}
+
+template<typename InertialFrame, typename ThisFrame>
+Rotation<Frenet<ThisFrame>, ThisFrame>
+SharedDynamicFrame<InertialFrame, ThisFrame>::FrenetFrame(
+    Instant const& t,
+    DegreesOfFreedom<ThisFrame> const& degrees_of_freedom) const {
+  return frame_->FrenetFrame(t, degrees_of_freedom);
+}
+
+template<typename InertialFrame, typename ThisFrame>
+void SharedDynamicFrame<InertialFrame, ThisFrame>::WriteToMessage(
+    not_null<serialization::DynamicFrame*> const message) const {
+  frame_->WriteToMessage(message);
+}
+
+template<typename InertialFrame, typename ThisFrame>
+Vector<Acceleration, InertialFrame>
+SharedDynamicFrame<InertialFrame, ThisFrame>::GravitationalAcceleration(
+    Instant const& t,
+    Position<InertialFrame> const& q) const {
+  return frame_->GravitationalAcceleration(t, q);
+}
+
+template<typename InertialFrame, typename ThisFrame>
+AcceleratedRigidMotion<InertialFrame, ThisFrame>
+SharedDynamicFrame<InertialFrame, ThisFrame>::MotionOfThisFrame(
+    Instant const& t) const {
+  return frame_->MotionOfThisFrame(t);
+}
+
+}  // namespace internal_shared_dynamic_frame
+}  // namespace physics
+}  // namespace principia
@@ -32,7 +32,9 @@ template<typename Frame>
 class SolarSystem final {
  public:
   // Constructs a solar system from the given files, which must contain text
-  // format for SolarSystemFile protocol buffers.
+  // format for SolarSystemFile protocol buffers.  Binary versions of these
+  // files are used if they are up to date, and the files are only read once
+  // per process.
   SolarSystem(std::filesystem::path const& gravity_model_filename,
               std::filesystem::path const& initial_state_filename,
               bool ignore_frame = false);
@@ -52,6 +54,19 @@ class SolarSystem final {
       Length const& fitting_tolerance,
       typename Ephemeris<Frame>::FixedStepParameters const& parameters) const;
 
+  // Same as above, but also prolongs the ephemeris up to |t|.  The result is
+  // cached in |cache_directory| as a snapshot keyed by a fingerprint of this
+  // system, of the parameters and of |t|: if the snapshot exists it is read
+  // instead of integrating from the epoch, otherwise it is written after the
+  // integration.  Processes sharing |cache_directory| coordinate through a lock
+  // file, so that only one of them integrates a given ephemeris while the
+  // others wait for its snapshot.
+  not_null<std::unique_ptr<Ephemeris<Frame>>> MakeProlongedEphemeris(
+      Length const& fitting_tolerance,
+      typename Ephemeris<Frame>::FixedStepParameters const& parameters,
+      Instant const& t,
+      std::filesystem::path const& cache_directory) const;
+
   std::vector<not_null<std::unique_ptr<MassiveBody const>>>
   MakeAllMassiveBodies() const;
 
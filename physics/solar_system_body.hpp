@@ -3,16 +3,26 @@
 
 #include "physics/solar_system.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
+#include <iterator>
 #include <map>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "astronomy/epoch.hpp"
 #include "astronomy/frames.hpp"
 #include "astronomy/time_scales.hpp"
+#include "base/array.hpp"
+#include "base/fingerprint2011.hpp"
 #include "base/map_util.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -35,9 +45,11 @@ namespace internal_solar_system {
 
 using astronomy::J2000;
 using astronomy::ParseTT;
+using base::Array;
 using base::Contains;
 using base::dynamic_cast_not_null;
 using base::FindOrDie;
+using base::Fingerprint2011;
 using base::make_not_null_unique;
 using geometry::Bivector;
 using geometry::Frame;
@@ -57,28 +69,57 @@ using quantities::Time;
 using quantities::si::Radian;
 using quantities::si::Second;
 
+// Returns the |SolarSystemFile| in text format at |filename|.  If there is a
+// binary version of that file (with the extension |proto.bin| instead of
+// |proto.txt|, see |tools::CompileSolarSystemFile|) that is not older than it,
+// it is read instead, which is much faster.  The result is cached, so each file
+// is read at most once per process.  Thread-safe.
+inline serialization::SolarSystemFile const& ReadSolarSystemFile(
+    std::filesystem::path const& filename) {
+  static std::mutex lock;
+  static auto* const files =
+      new std::map<std::filesystem::path, serialization::SolarSystemFile>;
+
+  std::lock_guard<std::mutex> l(lock);
+  auto const it = files->find(filename);
+  if (it != files->end()) {
+    return it->second;
+  }
+  serialization::SolarSystemFile& file = (*files)[filename];
+
+  std::filesystem::path binary_filename = filename;
+  binary_filename.replace_extension("bin");
+  std::error_code binary_error;
+  std::error_code text_error;
+  auto const binary_time =
+      std::filesystem::last_write_time(binary_filename, binary_error);
+  auto const text_time = std::filesystem::last_write_time(filename, text_error);
+  if (!binary_error && (text_error || text_time <= binary_time)) {
+    std::ifstream binary_ifstream(binary_filename, std::ios::binary);
+    CHECK(binary_ifstream.good()) << binary_filename;
+    CHECK(file.ParseFromIstream(&binary_ifstream)) << binary_filename;
+    return file;
+  }
+
+  std::ifstream text_ifstream(filename);
+  CHECK(text_ifstream.good()) << filename;
+  google::protobuf::io::IstreamInputStream text_zcs(&text_ifstream);
+  CHECK(google::protobuf::TextFormat::Parse(&text_zcs, &file)) << filename;
+  return file;
+}
+
 inline serialization::GravityModel ParseGravityModel(
     std::filesystem::path const& gravity_model_filename) {
-  serialization::SolarSystemFile gravity_model;
-  std::ifstream gravity_model_ifstream(gravity_model_filename);
-  CHECK(gravity_model_ifstream.good());
-  google::protobuf::io::IstreamInputStream gravity_model_zcs(
-                                               &gravity_model_ifstream);
-  CHECK(google::protobuf::TextFormat::Parse(&gravity_model_zcs,
-                                            &gravity_model));
+  serialization::SolarSystemFile const& gravity_model =
+      ReadSolarSystemFile(gravity_model_filename);
   CHECK(gravity_model.has_gravity_model());
   return gravity_model.gravity_model();
 }
 
 inline serialization::InitialState ParseInitialState(
     std::filesystem::path const& initial_state_filename) {
-  serialization::SolarSystemFile initial_state;
-  std::ifstream initial_state_ifstream(initial_state_filename);
-  CHECK(initial_state_ifstream.good());
-  google::protobuf::io::IstreamInputStream initial_state_zcs(
-                                               &initial_state_ifstream);
-  CHECK(google::protobuf::TextFormat::Parse(&initial_state_zcs,
-                                            &initial_state));
+  serialization::SolarSystemFile const& initial_state =
+      ReadSolarSystemFile(initial_state_filename);
   CHECK(initial_state.has_initial_state());
   return initial_state.initial_state();
 }
@@ -194,6 +235,108 @@ not_null<std::unique_ptr<Ephemeris<Frame>>> SolarSystem<Frame>::MakeEphemeris(
                                                 parameters);
 }
 
+template<typename Frame>
+not_null<std::unique_ptr<Ephemeris<Frame>>>
+SolarSystem<Frame>::MakeProlongedEphemeris(
+    Length const& fitting_tolerance,
+    typename Ephemeris<Frame>::FixedStepParameters const& parameters,
+    Instant const& t,
+    std::filesystem::path const& cache_directory) const {
+  // The key covers everything that determines the integration.
+  serialization::Ephemeris::FixedStepParameters parameters_message;
+  parameters.WriteToMessage(&parameters_message);
+  serialization::Quantity fitting_tolerance_message;
+  fitting_tolerance.WriteToMessage(&fitting_tolerance_message);
+  serialization::Point t_message;
+  t.WriteToMessage(&t_message);
+  std::string const key = gravity_model_.SerializeAsString() +
+                          initial_state_.SerializeAsString() +
+                          parameters_message.SerializeAsString() +
+                          fitting_tolerance_message.SerializeAsString() +
+                          t_message.SerializeAsString();
+  std::ostringstream filename;
+  filename << std::hex << std::uppercase << std::setfill('0') << std::setw(16)
+           << Fingerprint2011(key.data(), key.size()) << ".ephemeris";
+  std::filesystem::path const path = cache_directory / filename.str();
+  std::filesystem::path lock_path = path;
+  lock_path += ".lock";
+
+  // A lock older than this is assumed to have been left behind by a process
+  // that died while integrating.
+  constexpr std::chrono::hours stale_lock_age(1);
+  constexpr std::chrono::milliseconds lock_polling_period(100);
+
+  std::error_code error;
+  std::filesystem::create_directories(cache_directory, error);
+  for (;;) {
+    std::ifstream snapshot_ifstream(path, std::ios::binary);
+    if (snapshot_ifstream.good()) {
+      std::vector<std::uint8_t> const bytes(
+          (std::istreambuf_iterator<char>(snapshot_ifstream)),
+          std::istreambuf_iterator<char>());
+      auto ephemeris = Ephemeris<Frame>::ReadFromSnapshot(
+          Array<std::uint8_t const>(bytes.data(), bytes.size()));
+      // The snapshot is taken at the last checkpoint, which may be slightly
+      // before |t|.
+      ephemeris->Prolong(t);
+      return ephemeris;
+    }
+
+    // Try to become the process that integrates this ephemeris.  The lock is
+    // created exclusively, so only one process succeeds.
+    if (std::FILE* const lock = std::fopen(lock_path.string().c_str(), "wx");
+        lock != nullptr) {
+      std::fclose(lock);
+      break;
+    }
+    auto const lock_time = std::filesystem::last_write_time(lock_path, error);
+    if (error) {
+      // The lock cannot be created, yet doesn't exist (it may have been removed
+      // since our attempt, in which case we try again).  The cache is probably
+      // not writable, so we integrate without coordination.
+      if (std::filesystem::exists(path)) {
+        continue;
+      }
+      LOG(WARNING) << "Cannot lock ephemeris snapshot " << lock_path;
+      break;
+    }
+    if (std::filesystem::file_time_type::clock::now() - lock_time >
+        stale_lock_age) {
+      LOG(WARNING) << "Removing stale ephemeris lock " << lock_path;
+      std::filesystem::remove(lock_path, error);
+      continue;
+    }
+    // Another process is integrating this ephemeris, wait for its snapshot.
+    std::this_thread::sleep_for(lock_polling_period);
+  }
+
+  auto ephemeris = MakeEphemeris(fitting_tolerance, parameters);
+  ephemeris->Prolong(t);
+  std::vector<std::uint8_t> bytes;
+  ephemeris->WriteToSnapshot(&bytes);
+  // Write to a temporary file and rename it, so that concurrent processes
+  // never read a partial snapshot.
+  std::filesystem::path temporary_path = path;
+  temporary_path += ".tmp";
+  std::ofstream snapshot_ofstream(temporary_path, std::ios::binary);
+  snapshot_ofstream.write(reinterpret_cast<char const*>(bytes.data()),
+                          bytes.size());
+  snapshot_ofstream.close();
+  if (snapshot_ofstream.good()) {
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+      LOG(WARNING) << "Cannot rename ephemeris snapshot " << temporary_path
+                   << ": " << error.message();
+    }
+  } else {
+    LOG(WARNING) << "Cannot write ephemeris snapshot " << temporary_path;
+  }
+  // Release the lock even if we failed, the waiting processes will then try to
+  // integrate themselves.
+  std::filesystem::remove(lock_path, error);
+  return ephemeris;
+}
+
 template<typename Frame>
 std::vector<not_null<std::unique_ptr<MassiveBody const>>>
 SolarSystem<Frame>::MakeAllMassiveBodies() const {
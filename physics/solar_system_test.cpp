@@ -1,6 +1,9 @@
 ﻿
 #include "physics/solar_system.hpp"
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <ios>
 
 #include "astronomy/frames.hpp"
@@ -25,6 +28,7 @@ using quantities::si::Degree;
 using quantities::si::Kilo;
 using quantities::si::Kilogram;
 using quantities::si::Metre;
+using quantities::si::Milli;
 using quantities::si::Second;
 using quantities::si::Yotta;
 using quantities::si::Zetta;
@@ -33,6 +37,76 @@ using ::testing::ElementsAreArray;
 
 class SolarSystemTest : public ::testing::Test {};
 
+TEST_F(SolarSystemTest, ProlongedEphemerisCache) {
+  SolarSystem<ICRFJ2000Equator> solar_system(
+      SOLUTION_DIR / "astronomy" / "test_gravity_model_two_bodies.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "test_initial_state_two_bodies_circular.proto.txt");
+  std::filesystem::path const cache_directory =
+      std::filesystem::temp_directory_path() / "principia_solar_system_test";
+  std::filesystem::remove_all(cache_directory);
+
+  Ephemeris<ICRFJ2000Equator>::FixedStepParameters const parameters(
+      SymplecticRungeKuttaNyströmIntegrator<McLachlanAtela1992Order4Optimal,
+                                            Position<ICRFJ2000Equator>>(),
+      /*step=*/10 * Milli(Second));
+  Instant const t = solar_system.epoch() + 1000 * Second;
+
+  // The first call integrates and writes the cache, the second one reads it.
+  auto const integrated_ephemeris = solar_system.MakeProlongedEphemeris(
+      /*fitting_tolerance=*/1 * Milli(Metre), parameters, t, cache_directory);
+  EXPECT_FALSE(std::filesystem::is_empty(cache_directory));
+  auto const cached_ephemeris = solar_system.MakeProlongedEphemeris(
+      /*fitting_tolerance=*/1 * Milli(Metre), parameters, t, cache_directory);
+  EXPECT_LE(t, cached_ephemeris->t_max());
+  for (std::string const name : {"Big", "Small"}) {
+    for (Instant time = solar_system.epoch(); time <= t; time += 10 * Second) {
+      EXPECT_EQ(
+          solar_system.trajectory(*integrated_ephemeris, name)
+              .EvaluateDegreesOfFreedom(time),
+          solar_system.trajectory(*cached_ephemeris, name)
+              .EvaluateDegreesOfFreedom(time)) << name << " " << time;
+    }
+  }
+  std::filesystem::remove_all(cache_directory);
+}
+
+TEST_F(SolarSystemTest, ProlongedEphemerisStaleLock) {
+  SolarSystem<ICRFJ2000Equator> solar_system(
+      SOLUTION_DIR / "astronomy" / "test_gravity_model_two_bodies.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "test_initial_state_two_bodies_circular.proto.txt");
+  std::filesystem::path const cache_directory =
+      std::filesystem::temp_directory_path() / "principia_solar_system_test";
+  std::filesystem::remove_all(cache_directory);
+
+  Ephemeris<ICRFJ2000Equator>::FixedStepParameters const parameters(
+      SymplecticRungeKuttaNyströmIntegrator<McLachlanAtela1992Order4Optimal,
+                                            Position<ICRFJ2000Equator>>(),
+      /*step=*/10 * Milli(Second));
+  Instant const t = solar_system.epoch() + 10 * Second;
+  solar_system.MakeProlongedEphemeris(
+      /*fitting_tolerance=*/1 * Milli(Metre), parameters, t, cache_directory);
+  std::filesystem::path const snapshot =
+      std::filesystem::directory_iterator(cache_directory)->path();
+
+  // Simulate a process that died while integrating, leaving its lock behind.
+  std::filesystem::remove(snapshot);
+  std::filesystem::path lock = snapshot;
+  lock += ".lock";
+  std::ofstream(lock).close();
+  std::filesystem::last_write_time(
+      lock,
+      std::filesystem::file_time_type::clock::now() - std::chrono::hours(2));
+
+  auto const ephemeris = solar_system.MakeProlongedEphemeris(
+      /*fitting_tolerance=*/1 * Milli(Metre), parameters, t, cache_directory);
+  EXPECT_LE(t, ephemeris->t_max());
+  EXPECT_TRUE(std::filesystem::exists(snapshot));
+  EXPECT_FALSE(std::filesystem::exists(lock));
+  std::filesystem::remove_all(cache_directory);
+}
+
 TEST_F(SolarSystemTest, RealSolarSystem) {
   SolarSystem<ICRFJ2000Equator> solar_system(
       SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
@@ -0,0 +1,159 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "geometry/r3_element.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_trajectory_range_index {
+
+using geometry::Instant;
+using geometry::Position;
+using geometry::R3Element;
+using quantities::Length;
+using quantities::Square;
+
+// An index over the points of a trajectory which answers queries about their
+// positions over a time interval in O(log n) operations instead of scanning
+// the points.  It is a segment tree whose nodes hold the axis-aligned bounding
+// box of the positions of the points that they cover.  The index only knows
+// about the points, not about the interpolation between them, so the results
+// of the queries are exact for the points but only approximate for the
+// trajectory; a caller that needs a precise extremum should refine the result
+// around the point found.
+// The index is not part of the trajectory: its owner must |Append| to it the
+// points appended to the trajectory, and |ForgetAfter| the points forgotten
+// from it.
+template<typename Frame>
+class TrajectoryRangeIndex final {
+ public:
+  TrajectoryRangeIndex() = default;
+
+  // Indexes the points of the trajectory segment given by |begin| and |end|.
+  // Complexity is O(n).
+  TrajectoryRangeIndex(typename DiscreteTrajectory<Frame>::Iterator begin,
+                       typename DiscreteTrajectory<Frame>::Iterator end);
+
+  // Adds a point to the index.  |time| must be after the times of all the
+  // points of the index.  Amortized complexity is O(log n).
+  void Append(Instant const& time, Position<Frame> const& position);
+
+  // Removes the points with times (strictly) greater than |time|.  Complexity
+  // is O(k + log n) where k is the number of points removed.
+  void ForgetAfter(Instant const& time);
+
+  std::int64_t size() const;
+  bool empty() const;
+
+  // Returns the smallest (respectively, largest) distance between |reference|
+  // and a point with a time in [t1, t2], or nothing if there is no such point.
+  // If |time| is not null, it is set to the time of that point.  Complexity is
+  // O(log n) for well-behaved trajectories.
+  std::optional<Length> MinDistance(Position<Frame> const& reference,
+                                    Instant const& t1,
+                                    Instant const& t2,
+                                    Instant* time = nullptr) const;
+  std::optional<Length> MaxDistance(Position<Frame> const& reference,
+                                    Instant const& t1,
+                                    Instant const& t2,
+                                    Instant* time = nullptr) const;
+
+  // Returns the times in [t1, t2] of the points at a distance at most |radius|
+  // of |reference|, in increasing order.  Complexity is O((k + 1) log n) where
+  // k is the number of points returned.
+  std::vector<Instant> TimesWithin(Position<Frame> const& reference,
+                                   Length const& radius,
+                                   Instant const& t1,
+                                   Instant const& t2) const;
+
+ private:
+  // An axis-aligned bounding box.  It is empty if |min| is greater than |max|
+  // on some axis.
+  struct Box final {
+    // The empty box.
+    Box();
+    explicit Box(R3Element<Length> const& point);
+
+    // The smallest box containing |left| and |right|.
+    static Box Union(Box const& left, Box const& right);
+
+    bool empty() const;
+
+    // The square of the distance between |point| and the closest (respectively,
+    // farthest) point of this box, which must not be empty.
+    Square<Length> MinDistance²(R3Element<Length> const& point) const;
+    Square<Length> MaxDistance²(R3Element<Length> const& point) const;
+
+    R3Element<Length> min;
+    R3Element<Length> max;
+  };
+
+  // The state of a search for the extremal distance to |reference|.
+  struct Search final {
+    R3Element<Length> reference;
+    std::int64_t begin;
+    std::int64_t end;
+    // Whether the search is for the largest distance.
+    bool farthest;
+    std::optional<Square<Length>> best_distance²;
+    std::int64_t best_point;
+  };
+
+  // The range of the points with times in [t1, t2].
+  std::int64_t RangeBegin(Instant const& t1) const;
+  std::int64_t RangeEnd(Instant const& t2) const;
+
+  // Explores the subtree rooted at |node|, which covers the points
+  // [node_begin, node_end[, skipping the subtrees that cannot improve on the
+  // best distance found so far.
+  void Explore(std::int64_t node,
+               std::int64_t node_begin,
+               std::int64_t node_end,
+               Search& search) const;
+  std::optional<Length> ExtremalDistance(Position<Frame> const& reference,
+                                         Instant const& t1,
+                                         Instant const& t2,
+                                         bool farthest,
+                                         Instant* time) const;
+
+  void CollectWithin(std::int64_t node,
+                     std::int64_t node_begin,
+                     std::int64_t node_end,
+                     R3Element<Length> const& reference,
+                     Square<Length> const& radius²,
+                     std::int64_t begin,
+                     std::int64_t end,
+                     std::vector<Instant>& times) const;
+
+  // Recomputes the boxes of the ancestors of the leaves [begin, end[.
+  void UpdateAncestors(std::int64_t begin, std::int64_t end);
+
+  // Doubles the number of leaves of the tree, which must be full.
+  void Grow();
+
+  std::vector<Instant> times_;
+  // The tree is implicit: the root is |nodes_[1]|, the children of
+  // |nodes_[i]| are |nodes_[2 * i]| and |nodes_[2 * i + 1]|, and the leaf of
+  // point |p| is |nodes_[capacity_ + p]|.  The leaves past the last point are
+  // empty.
+  std::int64_t capacity_ = 0;
+  std::vector<Box> nodes_;
+};
+
+}  // namespace internal_trajectory_range_index
+
+using internal_trajectory_range_index::TrajectoryRangeIndex;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/trajectory_range_index_body.hpp"
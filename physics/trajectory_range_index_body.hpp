@@ -0,0 +1,317 @@
+﻿
+#pragma once
+
+#include "physics/trajectory_range_index.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "glog/logging.h"
+#include "quantities/elementary_functions.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_trajectory_range_index {
+
+using quantities::Abs;
+using quantities::Infinity;
+using quantities::Sqrt;
+
+template<typename Frame>
+TrajectoryRangeIndex<Frame>::TrajectoryRangeIndex(
+    typename DiscreteTrajectory<Frame>::Iterator const begin,
+    typename DiscreteTrajectory<Frame>::Iterator const end) {
+  std::vector<Box> leaves;
+  for (auto it = begin; it != end; ++it) {
+    times_.push_back(it.time());
+    leaves.emplace_back(
+        (it.degrees_of_freedom().position() - Frame::origin).coordinates());
+  }
+  if (times_.empty()) {
+    return;
+  }
+  capacity_ = 1;
+  while (capacity_ < size()) {
+    capacity_ *= 2;
+  }
+  nodes_.resize(2 * capacity_);
+  std::copy(leaves.begin(), leaves.end(), nodes_.begin() + capacity_);
+  UpdateAncestors(0, size());
+}
+
+template<typename Frame>
+void TrajectoryRangeIndex<Frame>::Append(Instant const& time,
+                                         Position<Frame> const& position) {
+  CHECK(times_.empty() || times_.back() < time)
+      << "Append out of order at " << time << ", last time is "
+      << times_.back();
+  std::int64_t const point = size();
+  if (point == capacity_) {
+    Grow();
+  }
+  times_.push_back(time);
+  nodes_[capacity_ + point] = Box((position - Frame::origin).coordinates());
+  UpdateAncestors(point, point + 1);
+}
+
+template<typename Frame>
+void TrajectoryRangeIndex<Frame>::ForgetAfter(Instant const& time) {
+  std::int64_t const first_removed = RangeEnd(time);
+  std::int64_t const end = size();
+  if (first_removed == end) {
+    return;
+  }
+  for (std::int64_t point = first_removed; point < end; ++point) {
+    nodes_[capacity_ + point] = Box();
+  }
+  UpdateAncestors(first_removed, end);
+  times_.resize(first_removed);
+}
+
+template<typename Frame>
+std::int64_t TrajectoryRangeIndex<Frame>::size() const {
+  return times_.size();
+}
+
+template<typename Frame>
+bool TrajectoryRangeIndex<Frame>::empty() const {
+  return times_.empty();
+}
+
+template<typename Frame>
+std::optional<Length> TrajectoryRangeIndex<Frame>::MinDistance(
+    Position<Frame> const& reference,
+    Instant const& t1,
+    Instant const& t2,
+    Instant* const time) const {
+  return ExtremalDistance(reference, t1, t2, /*farthest=*/false, time);
+}
+
+template<typename Frame>
+std::optional<Length> TrajectoryRangeIndex<Frame>::MaxDistance(
+    Position<Frame> const& reference,
+    Instant const& t1,
+    Instant const& t2,
+    Instant* const time) const {
+  return ExtremalDistance(reference, t1, t2, /*farthest=*/true, time);
+}
+
+template<typename Frame>
+std::vector<Instant> TrajectoryRangeIndex<Frame>::TimesWithin(
+    Position<Frame> const& reference,
+    Length const& radius,
+    Instant const& t1,
+    Instant const& t2) const {
+  std::vector<Instant> times;
+  std::int64_t const begin = RangeBegin(t1);
+  std::int64_t const end = RangeEnd(t2);
+  if (begin < end) {
+    CollectWithin(/*node=*/1,
+                  /*node_begin=*/0,
+                  /*node_end=*/capacity_,
+                  (reference - Frame::origin).coordinates(),
+                  radius * radius,
+                  begin,
+                  end,
+                  times);
+  }
+  return times;
+}
+
+template<typename Frame>
+TrajectoryRangeIndex<Frame>::Box::Box()
+    : min({Infinity<Length>(), Infinity<Length>(), Infinity<Length>()}),
+      max({-Infinity<Length>(), -Infinity<Length>(), -Infinity<Length>()}) {}
+
+template<typename Frame>
+TrajectoryRangeIndex<Frame>::Box::Box(R3Element<Length> const& point)
+    : min(point),
+      max(point) {}
+
+template<typename Frame>
+typename TrajectoryRangeIndex<Frame>::Box
+TrajectoryRangeIndex<Frame>::Box::Union(Box const& left, Box const& right) {
+  Box result;
+  for (int i = 0; i < 3; ++i) {
+    result.min[i] = std::min(left.min[i], right.min[i]);
+    result.max[i] = std::max(left.max[i], right.max[i]);
+  }
+  return result;
+}
+
+template<typename Frame>
+bool TrajectoryRangeIndex<Frame>::Box::empty() const {
+  return min.x > max.x;
+}
+
+template<typename Frame>
+Square<Length> TrajectoryRangeIndex<Frame>::Box::MinDistance²(
+    R3Element<Length> const& point) const {
+  Square<Length> result;
+  for (int i = 0; i < 3; ++i) {
+    Length const distance =
+        std::max({Length{}, min[i] - point[i], point[i] - max[i]});
+    result += distance * distance;
+  }
+  return result;
+}
+
+template<typename Frame>
+Square<Length> TrajectoryRangeIndex<Frame>::Box::MaxDistance²(
+    R3Element<Length> const& point) const {
+  Square<Length> result;
+  for (int i = 0; i < 3; ++i) {
+    Length const distance =
+        std::max(Abs(point[i] - min[i]), Abs(max[i] - point[i]));
+    result += distance * distance;
+  }
+  return result;
+}
+
+template<typename Frame>
+std::int64_t TrajectoryRangeIndex<Frame>::RangeBegin(Instant const& t1) const {
+  return std::lower_bound(times_.begin(), times_.end(), t1) - times_.begin();
+}
+
+template<typename Frame>
+std::int64_t TrajectoryRangeIndex<Frame>::RangeEnd(Instant const& t2) const {
+  return std::upper_bound(times_.begin(), times_.end(), t2) - times_.begin();
+}
+
+template<typename Frame>
+void TrajectoryRangeIndex<Frame>::Explore(std::int64_t const node,
+                                          std::int64_t const node_begin,
+                                          std::int64_t const node_end,
+                                          Search& search) const {
+  Box const& box = nodes_[node];
+  if (box.empty() || node_end <= search.begin || search.end <= node_begin) {
+    return;
+  }
+  // For a leaf, the bound is the distance to its point.
+  Square<Length> const bound = search.farthest
+                                   ? box.MaxDistance²(search.reference)
+                                   : box.MinDistance²(search.reference);
+  if (search.best_distance².has_value() &&
+      (search.farthest ? bound < *search.best_distance²
+                       : bound > *search.best_distance²)) {
+    return;
+  }
+  if (node >= capacity_) {
+    std::int64_t const point = node - capacity_;
+    // Ties are resolved in favour of the earliest point, irrespective of the
+    // order of exploration.
+    if (!search.best_distance².has_value() ||
+        bound != *search.best_distance² ||
+        point < search.best_point) {
+      search.best_distance² = bound;
+      search.best_point = point;
+    }
+    return;
+  }
+
+  // Explore first the child that looks most promising, so as to prune more of
+  // the other one.
+  std::int64_t const middle = (node_begin + node_end) / 2;
+  std::int64_t const left = 2 * node;
+  std::int64_t const right = 2 * node + 1;
+  bool right_first = false;
+  if (!nodes_[left].empty() && !nodes_[right].empty()) {
+    right_first =
+        search.farthest
+            ? nodes_[right].MaxDistance²(search.reference) >
+                  nodes_[left].MaxDistance²(search.reference)
+            : nodes_[right].MinDistance²(search.reference) <
+                  nodes_[left].MinDistance²(search.reference);
+  }
+  if (right_first) {
+    Explore(right, middle, node_end, search);
+    Explore(left, node_begin, middle, search);
+  } else {
+    Explore(left, node_begin, middle, search);
+    Explore(right, middle, node_end, search);
+  }
+}
+
+template<typename Frame>
+std::optional<Length> TrajectoryRangeIndex<Frame>::ExtremalDistance(
+    Position<Frame> const& reference,
+    Instant const& t1,
+    Instant const& t2,
+    bool const farthest,
+    Instant* const time) const {
+  Search search{/*reference=*/(reference - Frame::origin).coordinates(),
+                /*begin=*/RangeBegin(t1),
+                /*end=*/RangeEnd(t2),
+                farthest,
+                /*best_distance²=*/std::nullopt,
+                /*best_point=*/0};
+  if (search.begin >= search.end) {
+    return std::nullopt;
+  }
+  Explore(/*node=*/1, /*node_begin=*/0, /*node_end=*/capacity_, search);
+  CHECK(search.best_distance².has_value());
+  if (time != nullptr) {
+    *time = times_[search.best_point];
+  }
+  return Sqrt(*search.best_distance²);
+}
+
+template<typename Frame>
+void TrajectoryRangeIndex<Frame>::CollectWithin(
+    std::int64_t const node,
+    std::int64_t const node_begin,
+    std::int64_t const node_end,
+    R3Element<Length> const& reference,
+    Square<Length> const& radius²,
+    std::int64_t const begin,
+    std::int64_t const end,
+    std::vector<Instant>& times) const {
+  Box const& box = nodes_[node];
+  if (box.empty() || node_end <= begin || end <= node_begin ||
+      box.MinDistance²(reference) > radius²) {
+    return;
+  }
+  if (node >= capacity_) {
+    times.push_back(times_[node - capacity_]);
+    return;
+  }
+  std::int64_t const middle = (node_begin + node_end) / 2;
+  CollectWithin(
+      2 * node, node_begin, middle, reference, radius², begin, end, times);
+  CollectWithin(
+      2 * node + 1, middle, node_end, reference, radius², begin, end, times);
+}
+
+template<typename Frame>
+void TrajectoryRangeIndex<Frame>::UpdateAncestors(std::int64_t const begin,
+                                                  std::int64_t const end) {
+  if (begin >= end) {
+    return;
+  }
+  std::int64_t first = capacity_ + begin;
+  std::int64_t last = capacity_ + end - 1;
+  while (first > 1) {
+    first /= 2;
+    last /= 2;
+    for (std::int64_t node = first; node <= last; ++node) {
+      nodes_[node] = Box::Union(nodes_[2 * node], nodes_[2 * node + 1]);
+    }
+  }
+}
+
+template<typename Frame>
+void TrajectoryRangeIndex<Frame>::Grow() {
+  CHECK_EQ(size(), capacity_);
+  std::int64_t const new_capacity = capacity_ == 0 ? 1 : 2 * capacity_;
+  std::vector<Box> nodes(2 * new_capacity);
+  std::copy(nodes_.begin() + capacity_,
+            nodes_.end(),
+            nodes.begin() + new_capacity);
+  nodes_ = std::move(nodes);
+  capacity_ = new_capacity;
+  UpdateAncestors(0, size());
+}
+
+}  // namespace internal_trajectory_range_index
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,191 @@
+﻿
+#include "physics/trajectory_range_index.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using quantities::Length;
+using quantities::si::Metre;
+using quantities::si::Second;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::IsEmpty;
+
+class TrajectoryRangeIndexTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      serialization::Frame::TEST, true>;
+
+  // A random walk, so that the positions are correlated in time like those of
+  // a trajectory.
+  TrajectoryRangeIndexTest() {
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+    Position<World> position = World::origin;
+    for (int i = 0; i < 1000; ++i) {
+      position += Displacement<World>({distribution(random) * Metre,
+                                       distribution(random) * Metre,
+                                       distribution(random) * Metre});
+      trajectory_.Append(t0_ + i * Second,
+                         {position, Velocity<World>()});
+    }
+  }
+
+  // The brute-force versions of the queries.
+  std::optional<Length> MinDistance(Position<World> const& reference,
+                                    Instant const& t1,
+                                    Instant const& t2,
+                                    Instant& time) const {
+    std::optional<Length> result;
+    for (auto it = trajectory_.Begin(); it != trajectory_.End(); ++it) {
+      Length const distance =
+          (it.degrees_of_freedom().position() - reference).Norm();
+      if (t1 <= it.time() && it.time() <= t2 &&
+          (!result.has_value() || distance < *result)) {
+        result = distance;
+        time = it.time();
+      }
+    }
+    return result;
+  }
+
+  std::optional<Length> MaxDistance(Position<World> const& reference,
+                                    Instant const& t1,
+                                    Instant const& t2,
+                                    Instant& time) const {
+    std::optional<Length> result;
+    for (auto it = trajectory_.Begin(); it != trajectory_.End(); ++it) {
+      Length const distance =
+          (it.degrees_of_freedom().position() - reference).Norm();
+      if (t1 <= it.time() && it.time() <= t2 &&
+          (!result.has_value() || distance > *result)) {
+        result = distance;
+        time = it.time();
+      }
+    }
+    return result;
+  }
+
+  std::vector<Instant> TimesWithin(Position<World> const& reference,
+                                   Length const& radius,
+                                   Instant const& t1,
+                                   Instant const& t2) const {
+    std::vector<Instant> result;
+    for (auto it = trajectory_.Begin(); it != trajectory_.End(); ++it) {
+      if (t1 <= it.time() && it.time() <= t2 &&
+          (it.degrees_of_freedom().position() - reference).Norm() <= radius) {
+        result.push_back(it.time());
+      }
+    }
+    return result;
+  }
+
+  // Checks the queries of |index| against the brute-force ones for a few
+  // references and intervals.
+  void CheckQueries(TrajectoryRangeIndex<World> const& index) const {
+    std::mt19937_64 random(1729);
+    std::uniform_real_distribution<> position_distribution(-20.0, 20.0);
+    std::uniform_int_distribution<> time_distribution(-10, 1010);
+    for (int i = 0; i < 100; ++i) {
+      Position<World> const reference =
+          World::origin +
+          Displacement<World>({position_distribution(random) * Metre,
+                               position_distribution(random) * Metre,
+                               position_distribution(random) * Metre});
+      int const s1 = time_distribution(random);
+      int const s2 = time_distribution(random);
+      Instant const t1 = t0_ + std::min(s1, s2) * Second;
+      Instant const t2 = t0_ + std::max(s1, s2) * Second;
+
+      Instant expected_time;
+      Instant actual_time;
+      auto const expected_min = MinDistance(reference, t1, t2, expected_time);
+      EXPECT_THAT(index.MinDistance(reference, t1, t2, &actual_time),
+                  Eq(expected_min));
+      if (expected_min.has_value()) {
+        EXPECT_THAT(actual_time, Eq(expected_time));
+      }
+      auto const expected_max = MaxDistance(reference, t1, t2, expected_time);
+      EXPECT_THAT(index.MaxDistance(reference, t1, t2, &actual_time),
+                  Eq(expected_max));
+      if (expected_max.has_value()) {
+        EXPECT_THAT(actual_time, Eq(expected_time));
+      }
+      EXPECT_THAT(index.TimesWithin(reference, 5 * Metre, t1, t2),
+                  ElementsAreArray(TimesWithin(reference, 5 * Metre, t1, t2)));
+    }
+  }
+
+  Instant const t0_;
+  DiscreteTrajectory<World> trajectory_;
+};
+
+TEST_F(TrajectoryRangeIndexTest, Empty) {
+  TrajectoryRangeIndex<World> const index;
+  EXPECT_TRUE(index.empty());
+  EXPECT_THAT(index.MinDistance(World::origin, t0_, t0_ + 1 * Second),
+              Eq(std::nullopt));
+  EXPECT_THAT(index.MaxDistance(World::origin, t0_, t0_ + 1 * Second),
+              Eq(std::nullopt));
+  EXPECT_THAT(
+      index.TimesWithin(World::origin, 1 * Metre, t0_, t0_ + 1 * Second),
+      IsEmpty());
+}
+
+TEST_F(TrajectoryRangeIndexTest, Construction) {
+  TrajectoryRangeIndex<World> const index(trajectory_.Begin(),
+                                          trajectory_.End());
+  EXPECT_THAT(index.size(), Eq(1000));
+  CheckQueries(index);
+}
+
+TEST_F(TrajectoryRangeIndexTest, Append) {
+  TrajectoryRangeIndex<World> index;
+  for (auto it = trajectory_.Begin(); it != trajectory_.End(); ++it) {
+    index.Append(it.time(), it.degrees_of_freedom().position());
+  }
+  EXPECT_THAT(index.size(), Eq(1000));
+  CheckQueries(index);
+}
+
+TEST_F(TrajectoryRangeIndexTest, ForgetAfter) {
+  TrajectoryRangeIndex<World> index(trajectory_.Begin(), trajectory_.End());
+  index.ForgetAfter(t0_ + 599 * Second);
+  trajectory_.ForgetAfter(t0_ + 599 * Second);
+  EXPECT_THAT(index.size(), Eq(600));
+  CheckQueries(index);
+
+  // The forgotten points must not affect the points appended afterwards.
+  Position<World> const far_away =
+      World::origin +
+      Displacement<World>({1000 * Metre, 1000 * Metre, 1000 * Metre});
+  index.Append(t0_ + 700 * Second, far_away);
+  trajectory_.Append(t0_ + 700 * Second, {far_away, Velocity<World>()});
+  CheckQueries(index);
+  EXPECT_THAT(index.TimesWithin(far_away, 1 * Metre, t0_, t0_ + 1000 * Second),
+              ElementsAre(t0_ + 700 * Second));
+}
+
+}  // namespace physics
+}  // namespace principia
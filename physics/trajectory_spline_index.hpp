@@ -0,0 +1,117 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "geometry/r3_element.hpp"
+#include "numerics/hermite3.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_trajectory_spline_index {
+
+using geometry::Instant;
+using geometry::Position;
+using geometry::R3Element;
+using numerics::Hermite3;
+using quantities::Length;
+using quantities::Square;
+
+// An index over the cubic Hermite pieces that interpolate a trajectory between
+// its points, which finds the point of the interpolated trajectory nearest to a
+// given position in O(log n) operations for well-behaved trajectories instead
+// of scanning the points.  It is a bounding volume hierarchy: the leaves hold
+// the axis-aligned bounding box of the Bézier control points of a piece, which
+// contains the piece, and the other nodes hold the union of the boxes of their
+// children.  Only the pieces whose box may contain a point nearer than the best
+// one found so far are refined exactly.
+// Unlike |TrajectoryRangeIndex|, the index is immutable: it copies the points
+// that it is given and must be rebuilt if the trajectory changes.
+template<typename Frame>
+class TrajectorySplineIndex final {
+ public:
+  // Indexes the trajectory segment given by |begin| and |end|, which must not
+  // be empty.  Complexity is O(n).
+  TrajectorySplineIndex(typename DiscreteTrajectory<Frame>::Iterator begin,
+                        typename DiscreteTrajectory<Frame>::Iterator end);
+
+  // Returns the degrees of freedom of the point of the interpolated trajectory
+  // nearest to |reference|.  Ties are resolved in favour of the earliest point.
+  // If |time| is not null, it is set to the time of that point.
+  DegreesOfFreedom<Frame> Nearest(Position<Frame> const& reference,
+                                  Instant* time = nullptr) const;
+
+  Instant const& t_min() const;
+  Instant const& t_max() const;
+
+ private:
+  // An axis-aligned bounding box.  It is empty if |min| is greater than |max|
+  // on some axis.
+  struct Box final {
+    // The empty box.
+    Box();
+    explicit Box(R3Element<Length> const& point);
+
+    // The smallest box containing |left| and |right|.
+    static Box Union(Box const& left, Box const& right);
+
+    bool empty() const;
+
+    // The square of the distance between |point| and the closest point of this
+    // box, which must not be empty.
+    Square<Length> MinDistance²(R3Element<Length> const& point) const;
+
+    R3Element<Length> min;
+    R3Element<Length> max;
+  };
+
+  // The state of a search for the point nearest to |reference|.
+  struct Search final {
+    Position<Frame> reference;
+    Square<Length> best_distance²;
+    Instant best_time;
+    DegreesOfFreedom<Frame> best_degrees_of_freedom;
+  };
+
+  // The interpolation between the points |piece| and |piece + 1|.
+  Hermite3<Instant, Position<Frame>> Interpolation(std::int64_t piece) const;
+
+  // Explores the subtree rooted at |node|, skipping the subtrees that cannot
+  // improve on the best distance found so far.
+  void Explore(std::int64_t node, Search& search) const;
+
+  // Finds the minima of the distance to the reference of |search| on |piece|
+  // and updates |search| if one of them improves on it.
+  void Refine(std::int64_t piece, Search& search) const;
+
+  // Updates |search| if the point of |interpolation| at |time| is nearer than
+  // the best one found so far.
+  static void Consider(Hermite3<Instant, Position<Frame>> const& interpolation,
+                       Instant const& time,
+                       Search& search);
+
+  std::vector<Instant> times_;
+  std::vector<DegreesOfFreedom<Frame>> degrees_of_freedom_;
+  // The tree is implicit: the root is |nodes_[1]|, the children of
+  // |nodes_[i]| are |nodes_[2 * i]| and |nodes_[2 * i + 1]|, and the leaf of
+  // piece |p| is |nodes_[capacity_ + p]|.  The leaves past the last piece are
+  // empty.
+  std::int64_t capacity_ = 1;
+  std::vector<Box> nodes_;
+};
+
+}  // namespace internal_trajectory_spline_index
+
+using internal_trajectory_spline_index::TrajectorySplineIndex;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/trajectory_spline_index_body.hpp"
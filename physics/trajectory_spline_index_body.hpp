@@ -0,0 +1,234 @@
+﻿
+#pragma once
+
+#include "physics/trajectory_spline_index.hpp"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+#include "numerics/root_finders.hpp"
+#include "quantities/elementary_functions.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_trajectory_spline_index {
+
+using geometry::InnerProduct;
+using numerics::RegulaFalsi;
+using quantities::Infinity;
+using quantities::Time;
+using quantities::Variation;
+
+template<typename Frame>
+TrajectorySplineIndex<Frame>::TrajectorySplineIndex(
+    typename DiscreteTrajectory<Frame>::Iterator const begin,
+    typename DiscreteTrajectory<Frame>::Iterator const end) {
+  for (auto it = begin; it != end; ++it) {
+    times_.push_back(it.time());
+    degrees_of_freedom_.push_back(it.degrees_of_freedom());
+  }
+  CHECK(!times_.empty()) << "Cannot index an empty trajectory";
+  std::int64_t const pieces = times_.size() - 1;
+  while (capacity_ < pieces) {
+    capacity_ *= 2;
+  }
+  nodes_.resize(2 * capacity_);
+
+  // A cubic Hermite piece is a cubic Bézier curve, which lies in the convex
+  // hull of its control points.
+  for (std::int64_t piece = 0; piece < pieces; ++piece) {
+    Time const Δt = times_[piece + 1] - times_[piece];
+    DegreesOfFreedom<Frame> const& start = degrees_of_freedom_[piece];
+    DegreesOfFreedom<Frame> const& end = degrees_of_freedom_[piece + 1];
+    Box box;
+    for (Position<Frame> const& control_point :
+             {start.position(),
+              start.position() + start.velocity() * Δt / 3.0,
+              end.position() - end.velocity() * Δt / 3.0,
+              end.position()}) {
+      box = Box::Union(box, Box((control_point - Frame::origin).coordinates()));
+    }
+    nodes_[capacity_ + piece] = box;
+  }
+  for (std::int64_t node = capacity_ - 1; node >= 1; --node) {
+    nodes_[node] = Box::Union(nodes_[2 * node], nodes_[2 * node + 1]);
+  }
+}
+
+template<typename Frame>
+DegreesOfFreedom<Frame> TrajectorySplineIndex<Frame>::Nearest(
+    Position<Frame> const& reference,
+    Instant* const time) const {
+  // The first point is a candidate even if there are no pieces.
+  Search search{reference,
+                /*best_distance²=*/
+                (degrees_of_freedom_.front().position() - reference).Norm²(),
+                /*best_time=*/times_.front(),
+                /*best_degrees_of_freedom=*/degrees_of_freedom_.front()};
+  Explore(/*node=*/1, search);
+  if (time != nullptr) {
+    *time = search.best_time;
+  }
+  return search.best_degrees_of_freedom;
+}
+
+template<typename Frame>
+Instant const& TrajectorySplineIndex<Frame>::t_min() const {
+  return times_.front();
+}
+
+template<typename Frame>
+Instant const& TrajectorySplineIndex<Frame>::t_max() const {
+  return times_.back();
+}
+
+template<typename Frame>
+TrajectorySplineIndex<Frame>::Box::Box()
+    : min({Infinity<Length>(), Infinity<Length>(), Infinity<Length>()}),
+      max({-Infinity<Length>(), -Infinity<Length>(), -Infinity<Length>()}) {}
+
+template<typename Frame>
+TrajectorySplineIndex<Frame>::Box::Box(R3Element<Length> const& point)
+    : min(point),
+      max(point) {}
+
+template<typename Frame>
+typename TrajectorySplineIndex<Frame>::Box
+TrajectorySplineIndex<Frame>::Box::Union(Box const& left, Box const& right) {
+  Box result;
+  for (int i = 0; i < 3; ++i) {
+    result.min[i] = std::min(left.min[i], right.min[i]);
+    result.max[i] = std::max(left.max[i], right.max[i]);
+  }
+  return result;
+}
+
+template<typename Frame>
+bool TrajectorySplineIndex<Frame>::Box::empty() const {
+  return min.x > max.x;
+}
+
+template<typename Frame>
+Square<Length> TrajectorySplineIndex<Frame>::Box::MinDistance²(
+    R3Element<Length> const& point) const {
+  Square<Length> result;
+  for (int i = 0; i < 3; ++i) {
+    Length const distance =
+        std::max({Length{}, min[i] - point[i], point[i] - max[i]});
+    result += distance * distance;
+  }
+  return result;
+}
+
+template<typename Frame>
+Hermite3<Instant, Position<Frame>> TrajectorySplineIndex<Frame>::Interpolation(
+    std::int64_t const piece) const {
+  DegreesOfFreedom<Frame> const& start = degrees_of_freedom_[piece];
+  DegreesOfFreedom<Frame> const& end = degrees_of_freedom_[piece + 1];
+  return Hermite3<Instant, Position<Frame>>(
+      {times_[piece], times_[piece + 1]},
+      {start.position(), end.position()},
+      {start.velocity(), end.velocity()});
+}
+
+template<typename Frame>
+void TrajectorySplineIndex<Frame>::Explore(std::int64_t const node,
+                                           Search& search) const {
+  Box const& box = nodes_[node];
+  // Boxes at the same distance as the best point are explored, because they
+  // may contain an earlier point.
+  if (box.empty() ||
+      box.MinDistance²((search.reference - Frame::origin).coordinates()) >
+          search.best_distance²) {
+    return;
+  }
+  if (node >= capacity_) {
+    Refine(node - capacity_, search);
+    return;
+  }
+
+  // Explore first the child that looks most promising, so as to prune more of
+  // the other one.
+  std::int64_t const left = 2 * node;
+  std::int64_t const right = 2 * node + 1;
+  bool right_first = false;
+  if (!nodes_[left].empty() && !nodes_[right].empty()) {
+    auto const reference = (search.reference - Frame::origin).coordinates();
+    right_first = nodes_[right].MinDistance²(reference) <
+                  nodes_[left].MinDistance²(reference);
+  }
+  if (right_first) {
+    Explore(right, search);
+    Explore(left, search);
+  } else {
+    Explore(left, search);
+    Explore(right, search);
+  }
+}
+
+template<typename Frame>
+void TrajectorySplineIndex<Frame>::Refine(std::int64_t const piece,
+                                          Search& search) const {
+  Instant const& t1 = times_[piece];
+  Instant const& t2 = times_[piece + 1];
+  auto const interpolation = Interpolation(piece);
+  auto const squared_distance = [&interpolation, &search](Instant const& t) {
+    return (interpolation.Evaluate(t) - search.reference).Norm²();
+  };
+  // This is the derivative of |squared_distance|.
+  auto const squared_distance_derivative =
+      [&interpolation, &search](Instant const& t) -> Variation<Square<Length>> {
+    return 2.0 * InnerProduct(interpolation.Evaluate(t) - search.reference,
+                              interpolation.EvaluateDerivative(t));
+  };
+
+  // The squared distance is a polynomial of degree 6 which may have several
+  // minima on the piece.  Use the extrema of its Hermite approximation, like
+  // |ComputeApsides|, to split the piece into intervals on which it is
+  // hopefully monotonic or has a single minimum, and find the minima exactly
+  // as the zeros of its derivative.
+  Hermite3<Instant, Square<Length>> const squared_distance_approximation(
+      {t1, t2},
+      {squared_distance(t1), squared_distance(t2)},
+      {squared_distance_derivative(t1), squared_distance_derivative(t2)});
+  std::vector<Instant> bounds = {t1};
+  for (Instant const& extremum : squared_distance_approximation.FindExtrema()) {
+    if (t1 < extremum && extremum < t2) {
+      bounds.push_back(extremum);
+    }
+  }
+  bounds.push_back(t2);
+
+  Variation<Square<Length>> const zero;
+  for (int i = 0; i < bounds.size(); ++i) {
+    Consider(interpolation, bounds[i], search);
+    if (i + 1 < bounds.size() &&
+        squared_distance_derivative(bounds[i]) < zero &&
+        squared_distance_derivative(bounds[i + 1]) > zero) {
+      Consider(interpolation,
+               RegulaFalsi(
+                   squared_distance_derivative, bounds[i], bounds[i + 1]),
+               search);
+    }
+  }
+}
+
+template<typename Frame>
+void TrajectorySplineIndex<Frame>::Consider(
+    Hermite3<Instant, Position<Frame>> const& interpolation,
+    Instant const& time,
+    Search& search) {
+  Position<Frame> const position = interpolation.Evaluate(time);
+  Square<Length> const distance² = (position - search.reference).Norm²();
+  if (distance² < search.best_distance² ||
+      (distance² == search.best_distance² && time < search.best_time)) {
+    search.best_distance² = distance²;
+    search.best_time = time;
+    search.best_degrees_of_freedom = {
+        position, interpolation.EvaluateDerivative(time)};
+  }
+}
+
+}  // namespace internal_trajectory_spline_index
+}  // namespace physics
+}  // namespace principia
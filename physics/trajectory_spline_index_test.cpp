@@ -0,0 +1,130 @@
+﻿
+#include "physics/trajectory_spline_index.hpp"
+
+#include <algorithm>
+#include <random>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/almost_equals.hpp"
+
+namespace principia {
+namespace physics {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Sin;
+using quantities::Speed;
+using quantities::Time;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Radian;
+using quantities::si::Second;
+using testing_utilities::AlmostEquals;
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Le;
+
+class TrajectorySplineIndexTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      serialization::Frame::TEST, true>;
+
+  // A spiral whose radius grows from 1000 m to 2000 m over three turns, so
+  // that the nearest point to most positions is unique.
+  TrajectorySplineIndexTest() {
+    Time const duration = 3000 * Second;
+    AngularFrequency const ω = 3 * 2 * π * Radian / duration;
+    Length const r0 = 1000 * Metre;
+    Speed const ṙ = r0 / duration;
+    for (int i = 0; i <= 100; ++i) {
+      Time const t = i * duration / 100;
+      Length const r = r0 + ṙ * t;
+      trajectory_.Append(
+          t0_ + t,
+          {World::origin +
+               Displacement<World>(
+                   {r * Cos(ω * t), r * Sin(ω * t), 0.01 * r}),
+           Velocity<World>(
+               {ṙ * Cos(ω * t) - r * ω * Sin(ω * t) / Radian,
+                ṙ * Sin(ω * t) + r * ω * Cos(ω * t) / Radian,
+                0.01 * ṙ})});
+    }
+  }
+
+  // The smallest distance between |reference| and the interpolated trajectory
+  // sampled much more finely than its points.
+  Length SampledMinDistance(Position<World> const& reference) const {
+    Length result = (trajectory_.Begin().degrees_of_freedom().position() -
+                     reference).Norm();
+    Time const duration = trajectory_.last().time() - t0_;
+    for (int i = 0; i <= 100'000; ++i) {
+      Instant const t = t0_ + i * duration / 100'000;
+      result = std::min(
+          result, (trajectory_.EvaluatePosition(t) - reference).Norm());
+    }
+    return result;
+  }
+
+  Instant const t0_;
+  DiscreteTrajectory<World> trajectory_;
+};
+
+TEST_F(TrajectorySplineIndexTest, SinglePoint) {
+  DiscreteTrajectory<World> trajectory;
+  DegreesOfFreedom<World> const degrees_of_freedom(
+      World::origin + Displacement<World>({1 * Metre, 2 * Metre, 3 * Metre}),
+      Velocity<World>());
+  trajectory.Append(t0_, degrees_of_freedom);
+  TrajectorySplineIndex<World> const index(trajectory.Begin(),
+                                           trajectory.End());
+  Instant time;
+  EXPECT_THAT(index.Nearest(World::origin, &time), Eq(degrees_of_freedom));
+  EXPECT_THAT(time, Eq(t0_));
+}
+
+TEST_F(TrajectorySplineIndexTest, Nearest) {
+  TrajectorySplineIndex<World> const index(trajectory_.Begin(),
+                                           trajectory_.End());
+  EXPECT_THAT(index.t_min(), Eq(t0_));
+  EXPECT_THAT(index.t_max(), Eq(t0_ + 3000 * Second));
+
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(-3000.0, 3000.0);
+  for (int i = 0; i < 20; ++i) {
+    Position<World> const reference =
+        World::origin + Displacement<World>({distribution(random) * Metre,
+                                             distribution(random) * Metre,
+                                             distribution(random) * Metre});
+    Instant time;
+    DegreesOfFreedom<World> const nearest = index.Nearest(reference, &time);
+    // The result is on the interpolated trajectory, and no sample of the
+    // trajectory is nearer.
+    DegreesOfFreedom<World> const expected =
+        trajectory_.EvaluateDegreesOfFreedom(time);
+    EXPECT_THAT(nearest.position(), AlmostEquals(expected.position(), 0, 4));
+    EXPECT_THAT(nearest.velocity(), AlmostEquals(expected.velocity(), 0, 4));
+    Length const distance = (nearest.position() - reference).Norm();
+    Length const sampled_distance = SampledMinDistance(reference);
+    EXPECT_THAT(distance, Le(sampled_distance));
+    EXPECT_THAT(distance, Ge(sampled_distance - 0.1 * Milli(Metre)));
+  }
+}
+
+}  // namespace physics
+}  // namespace principia
@@ -1,6 +1,8 @@
 ﻿
 #pragma once
 
+#include <vector>
+
 #include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
 
@@ -30,6 +32,21 @@ SquareRoot<Q> Sqrt(Q const& x);
 template<typename Q>
 CubeRoot<Q> Cbrt(Q const& x);
 
+// Equivalent to applying |Sqrt|, resp. |Cbrt|, to each element of |x|, with
+// bitwise identical results.  Faster for long vectors since pairs of elements
+// are processed together using packed operations.
+template<typename Q>
+std::vector<SquareRoot<Q>> Sqrt(std::vector<Q> const& x);
+template<typename Q>
+std::vector<CubeRoot<Q>> Cbrt(std::vector<Q> const& x);
+
+// An approximation of |Sqrt(Sqrt(x))| with a relative error below 2e-9, for
+// heuristics such as the step size control of the plotting code, where speed
+// matters more than accuracy.  About 1.7 times faster than the two square
+// roots.  Must not be used in physics code.  Exact for zero and infinity.
+template<typename Q>
+NthRoot<Q, 4> FastFourthRoot(Q const& x);
+
 // Equivalent to |std::pow(x, exponent)| unless -3 ≤ x ≤ 3, in which case
 // explicit specialization yields multiplications statically.
 template<int exponent, typename Q>
@@ -69,6 +86,7 @@ using internal_elementary_functions::ArcTanh;
 using internal_elementary_functions::Cbrt;
 using internal_elementary_functions::Cos;
 using internal_elementary_functions::Cosh;
+using internal_elementary_functions::FastFourthRoot;
 using internal_elementary_functions::FusedMultiplyAdd;
 using internal_elementary_functions::Mod;
 using internal_elementary_functions::Pow;
@@ -6,7 +6,11 @@
 #include <pmmintrin.h>
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <type_traits>
+#include <vector>
 
 #include "quantities/si.hpp"
 #include "numerics/cbrt.hpp"
@@ -55,6 +59,66 @@ CubeRoot<Q> Cbrt(Q const& x) {
   return SIUnit<CubeRoot<Q>>() * numerics::Cbrt(x / SIUnit<Q>());
 }
 
+template<typename Q>
+std::vector<SquareRoot<Q>> Sqrt(std::vector<Q> const& x) {
+  std::vector<SquareRoot<Q>> result;
+  result.reserve(x.size());
+  std::size_t i = 0;
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+  for (; i + 1 < x.size(); i += 2) {
+    auto const x_128d = _mm_set_pd(x[i + 1] / SIUnit<Q>(), x[i] / SIUnit<Q>());
+    alignas(16) double roots[2];
+    _mm_store_pd(roots, _mm_sqrt_pd(x_128d));
+    result.push_back(SIUnit<SquareRoot<Q>>() * roots[0]);
+    result.push_back(SIUnit<SquareRoot<Q>>() * roots[1]);
+  }
+#endif
+  for (; i < x.size(); ++i) {
+    result.push_back(Sqrt(x[i]));
+  }
+  return result;
+}
+
+template<typename Q>
+std::vector<CubeRoot<Q>> Cbrt(std::vector<Q> const& x) {
+  std::vector<double> values;
+  values.reserve(x.size());
+  for (Q const& x_i : x) {
+    values.push_back(x_i / SIUnit<Q>());
+  }
+  numerics::Cbrt(values.data(), values.data(), values.size());
+  std::vector<CubeRoot<Q>> result;
+  result.reserve(values.size());
+  for (double const value : values) {
+    result.push_back(SIUnit<CubeRoot<Q>>() * value);
+  }
+  return result;
+}
+
+template<typename Q>
+NthRoot<Q, 4> FastFourthRoot(Q const& x) {
+  double const x_double = x / SIUnit<Q>();
+  // The bit manipulation below is only valid for positive normal numbers.
+  if (!(x_double >= std::numeric_limits<double>::min() &&
+        x_double <= std::numeric_limits<double>::max())) {
+    return SIUnit<NthRoot<Q, 4>>() * std::sqrt(std::sqrt(x_double));
+  }
+  // Dividing the exponent by -4 yields an approximation of x^(-1/4) with a
+  // relative error below 0.1.  The constant minimizes that error.
+  std::uint64_t bits;
+  std::memcpy(&bits, &x_double, sizeof(bits));
+  bits = 0x4FEB'0800'0000'0000 - (bits >> 2);
+  double r;
+  std::memcpy(&r, &bits, sizeof(r));
+  // Three Newton iterations for r⁻⁴ - x, which don't need a division, bring
+  // the error below 2e-9.
+  for (int i = 0; i < 3; ++i) {
+    double const r² = r * r;
+    r *= 1.25 - 0.25 * x_double * (r² * r²);
+  }
+  return SIUnit<NthRoot<Q, 4>>() * (x_double * r * (r * r));
+}
+
 template<int exponent>
 constexpr double Pow(double x) {
   return std::pow(x, exponent);
@@ -1,6 +1,8 @@
 ﻿
 #include <functional>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "google/protobuf/stubs/common.h"
 #include "glog/logging.h"
@@ -194,5 +196,43 @@ TEST_F(ElementaryFunctionsTest, ExpLogAndRoots) {
       AlmostEquals(std::exp(std::log(Gallon / Pow<3>(Foot)) / 3) * Foot, 0, 1));
 }
 
+TEST_F(ElementaryFunctionsTest, BatchRoots) {
+  std::vector<Volume> volumes;
+  for (double x = -1e300; x < -1e-300; x /= 1.1) {
+    volumes.push_back(x * Gallon);
+  }
+  volumes.push_back(0 * Gallon);
+  for (double x = 1e-300; x < 1e300; x *= 1.1) {
+    volumes.push_back(x * Gallon);
+  }
+  std::vector<Length> const cube_roots = Cbrt(volumes);
+  ASSERT_EQ(volumes.size(), cube_roots.size());
+  for (std::size_t i = 0; i < volumes.size(); ++i) {
+    EXPECT_EQ(Cbrt(volumes[i]), cube_roots[i]) << volumes[i];
+  }
+
+  std::vector<Area> areas;
+  for (double x = 1e-300; x < 1e300; x *= 1.1) {
+    areas.push_back(x * Rood);
+  }
+  std::vector<Length> const square_roots = Sqrt(areas);
+  ASSERT_EQ(areas.size(), square_roots.size());
+  for (std::size_t i = 0; i < areas.size(); ++i) {
+    EXPECT_EQ(Sqrt(areas[i]), square_roots[i]) << areas[i];
+  }
+}
+
+TEST_F(ElementaryFunctionsTest, FastFourthRoot) {
+  for (double x = 1e-300; x < 1e300; x *= 1.1) {
+    EXPECT_THAT(RelativeError(Sqrt(Sqrt(x)), FastFourthRoot(x)), Lt(2e-9))
+        << x;
+  }
+  EXPECT_THAT(RelativeError(Sqrt(Rood), FastFourthRoot(Rood * Rood)),
+              Lt(2e-9));
+  EXPECT_EQ(0, FastFourthRoot(0.0));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(),
+            FastFourthRoot(std::numeric_limits<double>::infinity()));
+}
+
 }  // namespace quantities
 }  // namespace principia
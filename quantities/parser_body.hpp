@@ -3,8 +3,14 @@
 
 #include "quantities/parser.hpp"
 
+#include <algorithm>
 #include <array>
+#include <charconv>
+#include <map>
+#include <mutex>
 #include <string>
+#include <system_error>
+
 #include "quantities/astronomy.hpp"
 #include "quantities/dimensions.hpp"
 #include "quantities/named_quantities.hpp"
@@ -99,69 +105,57 @@ inline Unit operator^(Unit const& left, int const exponent) {
   return {std::move(dimensions), std::pow(left.scale, exponent)};
 }
 
+// The table of the supported unit symbols, built on first use.
+inline std::map<std::string, Unit> const& UnitSymbols() {
+  static std::map<std::string, Unit> const symbols = {
+      // Unitless quantities.
+      {"", Unit(1.0)},
+      // Units of length.
+      {u8"μm", Unit(si::Micro(si::Metre))},
+      {"mm", Unit(si::Milli(si::Metre))},
+      {"cm", Unit(si::Centi(si::Metre))},
+      {"m", Unit(si::Metre)},
+      {"km", Unit(si::Kilo(si::Metre))},
+      {u8"R🜨", Unit(astronomy::EarthEquatorialRadius)},
+      {u8"R☉", Unit(astronomy::SolarEquatorialRadius)},
+      {"au", Unit(si::AstronomicalUnit)},
+      // Units of mass.
+      {"kg", Unit(si::Kilogram)},
+      {u8"M🜨", Unit(astronomy::EarthMass)},
+      {u8"M☉", Unit(astronomy::SolarMass)},
+      // Units of time.
+      {"ms", Unit(si::Milli(si::Second))},
+      {"s", Unit(si::Second)},
+      {"min", Unit(si::Minute)},
+      {"h", Unit(si::Hour)},
+      {"d", Unit(si::Day)},
+      // Units of power.
+      {"W", Unit(si::Watt)},
+      // Units of angle.
+      {"deg", Unit(si::Degree)},
+      {u8"°", Unit(si::Degree)},
+      {"rad", Unit(si::Radian)},
+      // Units of solid angle.
+      {"sr", Unit(si::Steradian)},
+  };
+  return symbols;
+}
+
 inline Unit ParseUnit(std::string const& s) {
-  // Unitless quantities.
-  if (s == "") {
-    return Unit(1.0);
-  // Units of length.
-  } else if (s == u8"μm") {
-    return Unit(si::Micro(si::Metre));
-  } else if (s == "mm") {
-    return Unit(si::Milli(si::Metre));
-  } else if (s == "cm") {
-    return Unit(si::Centi(si::Metre));
-  } else if (s == "m") {
-    return Unit(si::Metre);
-  } else if (s == "km") {
-    return Unit(si::Kilo(si::Metre));
-  } else if (s == u8"R🜨") {
-    return Unit(astronomy::EarthEquatorialRadius);
-  } else if (s == u8"R☉") {
-    return Unit(astronomy::SolarEquatorialRadius);
-  } else if (s == "au") {
-    return Unit(si::AstronomicalUnit);
-  // Units of mass.
-  } else if (s == "kg") {
-    return Unit(si::Kilogram);
-  } else if (s == u8"M🜨") {
-    return Unit(astronomy::EarthMass);
-  } else if (s == u8"M☉") {
-    return Unit(astronomy::SolarMass);
-  // Units of time.
-  } else if (s == "ms") {
-    return Unit(si::Milli(si::Second));
-  } else if (s == "s") {
-    return Unit(si::Second);
-  } else if (s == "min") {
-    return Unit(si::Minute);
-  } else if (s == "h") {
-    return Unit(si::Hour);
-  } else if (s == "d") {
-    return Unit(si::Day);
-  // Units of power.
-  } else if (s == "W") {
-    return Unit(si::Watt);
-  // Units of angle.
-  } else if (s == "deg" || s == u8"°") {
-    return Unit(si::Degree);
-  } else if (s == "rad") {
-    return Unit(si::Radian);
-  // Units of solid angle.
-  } else if (s == "sr") {
-    return Unit(si::Steradian);
-  } else {
+  auto const it = UnitSymbols().find(s);
+  if (it == UnitSymbols().end()) {
     LOG(FATAL) << "Unsupported unit " << s;
     base::noreturn();
   }
+  return it->second;
 }
 
 inline int ParseExponent(std::string const& s) {
   // Parse an int.
-  char* interpreted_end;
-  char const* const c_string = s.c_str();
-  int const exponent = std::strtol(c_string, &interpreted_end, /*base=*/10);
-  int const interpreted = interpreted_end - c_string;
-  CHECK_LT(0, interpreted) << "invalid integer number " << s;
+  int exponent;
+  auto const [interpreted_end, error] =
+      std::from_chars(s.data(), s.data() + s.size(), exponent, /*base=*/10);
+  CHECK(error == std::errc()) << "invalid integer number " << s;
   return exponent;
 }
 
@@ -222,13 +216,51 @@ inline Unit ParseQuotientUnit(std::string const& s) {
   }
 }
 
+// Parsing a unit is much more expensive than looking it up, and the
+// configurations that we read use a handful of distinct units for many
+// quantities, so the results of |ParseQuotientUnit| are cached.
+inline Unit ParseCachedUnit(std::string const& s) {
+  static std::mutex lock;
+  static std::map<std::string, Unit> cache;
+  {
+    std::lock_guard<std::mutex> l(lock);
+    auto const it = cache.find(s);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+  Unit const unit = ParseQuotientUnit(s);
+  std::lock_guard<std::mutex> l(lock);
+  cache.emplace(s, unit);
+  return unit;
+}
+
+// Returns the number of characters of |s| that were interpreted as
+// |magnitude|, or 0 if none.  Leading blanks are skipped.
+inline int ParseMagnitude(std::string const& s, double& magnitude) {
+#if defined(__cpp_lib_to_chars)
+  // |from_chars| is faster than |strtod| and doesn't depend on the locale, but
+  // it accepts neither leading blanks nor a plus sign.
+  char const* begin = s.data() + std::min(s.find_first_not_of(' '), s.size());
+  char const* const end = s.data() + s.size();
+  if (begin != end && *begin == '+') {
+    ++begin;
+  }
+  auto const [interpreted_end, error] = std::from_chars(begin, end, magnitude);
+  return error == std::errc() ? interpreted_end - s.data() : 0;
+#else
+  char* interpreted_end;
+  char const* const c_string = s.c_str();
+  magnitude = std::strtod(c_string, &interpreted_end);
+  return interpreted_end - c_string;
+#endif
+}
+
 template<typename Q>
 Q ParseQuantity(std::string const& s) {
   // Parse a double.
-  char* interpreted_end;
-  char const* const c_string = s.c_str();
-  double const magnitude = std::strtod(c_string, &interpreted_end);
-  int const interpreted = interpreted_end - c_string;
+  double magnitude;
+  int const interpreted = ParseMagnitude(s, magnitude);
   CHECK_LT(0, interpreted) << "invalid floating-point number " << s;
 
   // Locate the unit.  It may be empty for a double.
@@ -239,7 +271,7 @@ Q ParseQuantity(std::string const& s) {
     unit_string = s.substr(first_nonblank, last_nonblank - first_nonblank + 1);
   }
 
-  Unit const unit = ParseQuotientUnit(unit_string);
+  Unit const unit = ParseCachedUnit(unit_string);
   CHECK(ExtractDimensions<Q>::dimensions() == unit.dimensions);
   return magnitude * unit.scale * SIUnit<Q>();
 }
@@ -2,6 +2,7 @@
 #include "quantities/parser.hpp"
 
 #include <array>
+#include <string>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -89,6 +90,18 @@ TEST_F(ParserDeathTest, UnitError) {
 TEST_F(ParserTest, ParseDouble) {
   EXPECT_EQ(1.23, ParseQuantity<double>("1.23"));
   EXPECT_EQ(-3.45, ParseQuantity<double>("-3.45"));
+  EXPECT_EQ(4.56, ParseQuantity<double>("+4.56"));
+  EXPECT_EQ(7.89e-10, ParseQuantity<double>(" 7.89e-10"));
+}
+
+TEST_F(ParserTest, CachedUnit) {
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i * Kilo(Metre) / Second,
+              ParseQuantity<Speed>(std::to_string(i) + " km/s"));
+    EXPECT_EQ(i * Pow<3>(Kilo(Metre)) / Pow<2>(Second),
+              ParseQuantity<GravitationalParameter>(std::to_string(i) +
+                                                    " km^3/s^2"));
+  }
 }
 
 TEST_F(ParserTest, ParseLength) {
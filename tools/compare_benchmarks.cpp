@@ -0,0 +1,363 @@
+#include "tools/compare_benchmarks.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace tools {
+
+namespace {
+
+// Just enough JSON to read the files written by the |BaselineReporter|.
+struct JSONValue final {
+  enum class Type { Null, Boolean, Number, String, Array, Object };
+
+  // Fails if |this| is not an object with the given |key|.
+  JSONValue const& operator[](std::string const& key) const;
+  bool Has(std::string const& key) const;
+
+  Type type = Type::Null;
+  bool boolean = false;
+  double number = 0;
+  std::string string;
+  std::vector<JSONValue> elements;
+  // For objects, the members are |keys[i]: elements[i]|.
+  std::vector<std::string> keys;
+};
+
+JSONValue const& JSONValue::operator[](std::string const& key) const {
+  CHECK(type == Type::Object);
+  auto const it = std::find(keys.begin(), keys.end(), key);
+  CHECK(it != keys.end()) << "No member " << key;
+  return elements[it - keys.begin()];
+}
+
+bool JSONValue::Has(std::string const& key) const {
+  return type == Type::Object &&
+         std::find(keys.begin(), keys.end(), key) != keys.end();
+}
+
+class JSONParser final {
+ public:
+  explicit JSONParser(std::string const& text);
+
+  JSONValue Parse();
+
+ private:
+  JSONValue ParseValue();
+  std::string ParseString();
+  void SkipWhitespace();
+  void Expect(char c);
+  bool Consume(std::string const& token);
+
+  std::string const& text_;
+  std::int64_t position_ = 0;
+};
+
+JSONParser::JSONParser(std::string const& text) : text_(text) {}
+
+JSONValue JSONParser::Parse() {
+  JSONValue value = ParseValue();
+  SkipWhitespace();
+  CHECK_EQ(position_, text_.size()) << "Trailing characters";
+  return value;
+}
+
+JSONValue JSONParser::ParseValue() {
+  SkipWhitespace();
+  CHECK_LT(position_, text_.size()) << "Unexpected end of input";
+  JSONValue value;
+  char const c = text_[position_];
+  if (c == '{') {
+    value.type = JSONValue::Type::Object;
+    ++position_;
+    SkipWhitespace();
+    if (!Consume("}")) {
+      do {
+        SkipWhitespace();
+        value.keys.push_back(ParseString());
+        SkipWhitespace();
+        Expect(':');
+        value.elements.push_back(ParseValue());
+        SkipWhitespace();
+      } while (Consume(","));
+      Expect('}');
+    }
+  } else if (c == '[') {
+    value.type = JSONValue::Type::Array;
+    ++position_;
+    SkipWhitespace();
+    if (!Consume("]")) {
+      do {
+        value.elements.push_back(ParseValue());
+        SkipWhitespace();
+      } while (Consume(","));
+      Expect(']');
+    }
+  } else if (c == '"') {
+    value.type = JSONValue::Type::String;
+    value.string = ParseString();
+  } else if (Consume("true")) {
+    value.type = JSONValue::Type::Boolean;
+    value.boolean = true;
+  } else if (Consume("false")) {
+    value.type = JSONValue::Type::Boolean;
+  } else if (Consume("null")) {
+    value.type = JSONValue::Type::Null;
+  } else {
+    value.type = JSONValue::Type::Number;
+    std::size_t length;
+    value.number = std::stod(text_.substr(position_), &length);
+    position_ += length;
+  }
+  return value;
+}
+
+std::string JSONParser::ParseString() {
+  Expect('"');
+  std::string result;
+  for (;;) {
+    CHECK_LT(position_, text_.size()) << "Unterminated string";
+    char const c = text_[position_++];
+    if (c == '"') {
+      return result;
+    } else if (c == '\\') {
+      CHECK_LT(position_, text_.size()) << "Unterminated string";
+      char const escaped = text_[position_++];
+      switch (escaped) {
+        case 'n':
+          result += '\n';
+          break;
+        case 't':
+          result += '\t';
+          break;
+        case '"':
+        case '\\':
+        case '/':
+          result += escaped;
+          break;
+        default:
+          LOG(FATAL) << "Unsupported escape \\" << escaped;
+      }
+    } else {
+      result += c;
+    }
+  }
+}
+
+void JSONParser::SkipWhitespace() {
+  while (position_ < text_.size() &&
+         (text_[position_] == ' ' || text_[position_] == '\n' ||
+          text_[position_] == '\r' || text_[position_] == '\t')) {
+    ++position_;
+  }
+}
+
+void JSONParser::Expect(char const c) {
+  CHECK(position_ < text_.size() && text_[position_] == c)
+      << "Expected " << c << " at " << position_;
+  ++position_;
+}
+
+bool JSONParser::Consume(std::string const& token) {
+  if (text_.compare(position_, token.size(), token) == 0) {
+    position_ += token.size();
+    return true;
+  }
+  return false;
+}
+
+JSONValue ReadJSON(std::filesystem::path const& path) {
+  std::ifstream file(path);
+  CHECK(file.good()) << path;
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return JSONParser(contents.str()).Parse();
+}
+
+struct Statistics final {
+  int count = 0;
+  double mean = 0;
+  // The unbiased estimator of the variance.
+  double variance = 0;
+};
+
+Statistics Summarize(JSONValue const& samples) {
+  Statistics statistics;
+  statistics.count = samples.elements.size();
+  for (auto const& sample : samples.elements) {
+    statistics.mean += sample.number;
+  }
+  statistics.mean /= statistics.count;
+  if (statistics.count > 1) {
+    for (auto const& sample : samples.elements) {
+      double const deviation = sample.number - statistics.mean;
+      statistics.variance += deviation * deviation;
+    }
+    statistics.variance /= statistics.count - 1;
+  }
+  return statistics;
+}
+
+// The one-sided 99% critical value of Student's t-distribution with
+// |degrees_of_freedom|, rounded down to the nearest tabulated number of
+// degrees of freedom, which makes the test conservative.
+double StudentT99(double const degrees_of_freedom) {
+  constexpr std::array<std::pair<double, double>, 15> table{{
+      {1, 31.821},
+      {2, 6.965},
+      {3, 4.541},
+      {4, 3.747},
+      {5, 3.365},
+      {6, 3.143},
+      {7, 2.998},
+      {8, 2.896},
+      {9, 2.821},
+      {10, 2.764},
+      {12, 2.681},
+      {15, 2.602},
+      {20, 2.528},
+      {30, 2.457},
+      {120, 2.358},
+  }};
+  double critical_value = table.front().second;
+  for (auto const& [ν, t] : table) {
+    if (degrees_of_freedom >= ν) {
+      critical_value = t;
+    }
+  }
+  return critical_value;
+}
+
+// Logs a warning if the value at |key| of |object| differs between the runs.
+void WarnIfDifferent(JSONValue const& baseline,
+                     JSONValue const& current,
+                     std::string const& object,
+                     std::string const& key) {
+  auto const describe = [](JSONValue const& value) {
+    std::stringstream s;
+    switch (value.type) {
+      case JSONValue::Type::String:
+        s << value.string;
+        break;
+      case JSONValue::Type::Boolean:
+        s << std::boolalpha << value.boolean;
+        break;
+      case JSONValue::Type::Array:
+        for (auto const& element : value.elements) {
+          s << element.string << " ";
+        }
+        break;
+      default:
+        s << value.number;
+    }
+    return s.str();
+  };
+  std::string const baseline_value = describe(baseline[object][key]);
+  std::string const current_value = describe(current[object][key]);
+  if (baseline_value != current_value) {
+    LOG(WARNING) << "The runs differ in " << object << "." << key << ": "
+                 << baseline_value << " vs. " << current_value
+                 << "; the comparison may not be meaningful";
+  }
+}
+
+}  // namespace
+
+bool CompareBenchmarks(std::filesystem::path const& baseline,
+                       std::filesystem::path const& current,
+                       std::string const& filter,
+                       double const threshold) {
+  JSONValue const baseline_run = ReadJSON(baseline);
+  JSONValue const current_run = ReadJSON(current);
+  for (std::string const key : {"compiler",
+                                "compiler_version",
+                                "sse3_intrinsics",
+                                "avx2_intrinsics"}) {
+    WarnIfDifferent(baseline_run, current_run, "build", key);
+  }
+  for (std::string const key : {"count", "features"}) {
+    WarnIfDifferent(baseline_run, current_run, "cpu", key);
+  }
+
+  std::regex const filter_regex(filter);
+  std::map<std::string, JSONValue const*> baseline_benchmarks;
+  for (auto const& benchmark : baseline_run["benchmarks"].elements) {
+    baseline_benchmarks.emplace(benchmark["name"].string, &benchmark);
+  }
+
+  int regressions = 0;
+  std::cout << std::fixed << std::setprecision(1);
+  for (auto const& benchmark : current_run["benchmarks"].elements) {
+    std::string const& name = benchmark["name"].string;
+    if (!std::regex_search(name, filter_regex)) {
+      continue;
+    }
+    auto const it = baseline_benchmarks.find(name);
+    if (it == baseline_benchmarks.end()) {
+      std::cout << name << ": not in the baseline\n";
+      continue;
+    }
+    Statistics const b = Summarize((*it->second)["real_time"]);
+    Statistics const c = Summarize(benchmark["real_time"]);
+    double const change = (c.mean - b.mean) / b.mean;
+    std::cout << name << ": " << b.mean << " ns -> " << c.mean << " ns ("
+              << std::showpos << 100 * change << std::noshowpos << "%)";
+    if (b.count < 2 || c.count < 2) {
+      std::cout << ", too few repetitions to test significance\n";
+      continue;
+    }
+    // Welch's t-test, with the Welch–Satterthwaite degrees of freedom.
+    double const b_variance_of_mean = b.variance / b.count;
+    double const c_variance_of_mean = c.variance / c.count;
+    double const standard_error =
+        std::sqrt(b_variance_of_mean + c_variance_of_mean);
+    bool significant;
+    if (standard_error == 0) {
+      significant = c.mean > b.mean;
+      std::cout << ", no variance";
+    } else {
+      double const t = (c.mean - b.mean) / standard_error;
+      double const degrees_of_freedom =
+          std::pow(b_variance_of_mean + c_variance_of_mean, 2) /
+          (b_variance_of_mean * b_variance_of_mean / (b.count - 1) +
+           c_variance_of_mean * c_variance_of_mean / (c.count - 1));
+      significant = t > StudentT99(degrees_of_freedom);
+      std::cout << ", t = " << std::setprecision(2) << t
+                << std::setprecision(1);
+    }
+    if (significant && change > threshold) {
+      ++regressions;
+      std::cout << "  REGRESSION";
+    }
+    std::cout << "\n";
+  }
+  for (auto const& [name, benchmark] : baseline_benchmarks) {
+    if (std::regex_search(name, filter_regex) &&
+        std::none_of(current_run["benchmarks"].elements.begin(),
+                     current_run["benchmarks"].elements.end(),
+                     [&name = name](JSONValue const& b) {
+                       return b["name"].string == name;
+                     })) {
+      std::cout << name << ": not in the current run\n";
+    }
+  }
+  std::cout << regressions << " significant regression(s)\n";
+  return regressions == 0;
+}
+
+}  // namespace tools
+}  // namespace principia
@@ -0,0 +1,23 @@
+﻿
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace principia {
+namespace tools {
+
+// Compares two files written by the benchmarks with
+// --principia_baseline_out, for the benchmarks whose name matches the regular
+// expression |filter|.  Prints the change in mean real time of each benchmark
+// and flags those that are significantly slower in |current| than in
+// |baseline|: the slowdown must exceed |threshold| (a relative value) and
+// Welch's t-test must reject equality at the 1% level, which requires at least
+// two repetitions in each run.  Returns true iff there is no such regression.
+bool CompareBenchmarks(std::filesystem::path const& baseline,
+                       std::filesystem::path const& current,
+                       std::string const& filter,
+                       double threshold);
+
+}  // namespace tools
+}  // namespace principia
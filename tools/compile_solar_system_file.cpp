@@ -0,0 +1,41 @@
+﻿
+#include "tools/compile_solar_system_file.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "glog/logging.h"
+#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/text_format.h"
+#include "serialization/astronomy.pb.h"
+
+namespace principia {
+namespace tools {
+
+namespace {
+constexpr char proto_bin[] = "proto.bin";
+constexpr char proto_txt[] = "proto.txt";
+}  // namespace
+
+void CompileSolarSystemFile(std::string const& stem) {
+  std::filesystem::path const directory = SOLUTION_DIR / "astronomy";
+  std::filesystem::path const text_filename =
+      (directory / stem).replace_extension(proto_txt);
+  std::filesystem::path const binary_filename =
+      (directory / stem).replace_extension(proto_bin);
+
+  serialization::SolarSystemFile file;
+  std::ifstream text_ifstream(text_filename);
+  CHECK(text_ifstream.good()) << text_filename;
+  google::protobuf::io::IstreamInputStream text_zcs(&text_ifstream);
+  CHECK(google::protobuf::TextFormat::Parse(&text_zcs, &file))
+      << text_filename;
+
+  std::ofstream binary_ofstream(binary_filename, std::ios::binary);
+  CHECK(binary_ofstream.good()) << binary_filename;
+  CHECK(file.SerializeToOstream(&binary_ofstream)) << binary_filename;
+}
+
+}  // namespace tools
+}  // namespace principia
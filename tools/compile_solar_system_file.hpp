@@ -0,0 +1,14 @@
+﻿
+#pragma once
+
+#include <string>
+
+namespace principia {
+namespace tools {
+
+// Writes the SolarSystemFile of astronomy/|stem|.proto.txt in binary format to
+// astronomy/|stem|.proto.bin, where it is picked up by |SolarSystem|.
+void CompileSolarSystemFile(std::string const& stem);
+
+}  // namespace tools
+}  // namespace principia
@@ -0,0 +1,61 @@
+﻿
+#include "tools/export_ephemeris.hpp"
+
+#include <fstream>
+#include <memory>
+
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "glog/logging.h"
+#include "ksp_plugin/celestial.hpp"
+#include "ksp_plugin/plugin.hpp"
+#include "quantities/si.hpp"
+#include "serialization/ksp_plugin.pb.h"
+#include "serialization/physics.pb.h"
+#include "tools/simulate.hpp"
+
+namespace principia {
+
+using base::not_null;
+using geometry::Instant;
+using ksp_plugin::Celestial;
+using ksp_plugin::Plugin;
+using quantities::Time;
+using quantities::si::Radian;
+
+namespace tools {
+
+void ExportEphemeris(std::filesystem::path const& save_filename,
+                     Time const& duration,
+                     Time const& interval,
+                     int const degree,
+                     std::filesystem::path const& output_filename) {
+  serialization::Plugin const message =
+      ReadPluginFromHexadecimalFile(save_filename);
+  not_null<std::unique_ptr<Plugin>> const plugin =
+      Plugin::ReadFromMessage(message);
+  Instant const t_min = plugin->CurrentTime();
+  Instant const t_max = t_min + duration;
+  // The planetarium rotation only affects the rendering.
+  plugin->AdvanceTime(t_max, /*planetarium_rotation=*/0 * Radian);
+
+  serialization::ChebyshevEphemeris ephemeris;
+  for (auto const& celestial_message : message.celestial()) {
+    Celestial const& celestial =
+        plugin->GetCelestial(celestial_message.index());
+    auto* const body = ephemeris.add_body();
+    body->set_name(celestial.body()->name());
+    for (auto const& series :
+         celestial.trajectory().ToЧебышёвSeries(
+             t_min, t_max, interval, degree)) {
+      series.WriteToMessage(body->add_series());
+    }
+  }
+
+  std::ofstream binary_ofstream(output_filename, std::ios::binary);
+  CHECK(binary_ofstream.good()) << output_filename;
+  CHECK(ephemeris.SerializeToOstream(&binary_ofstream)) << output_filename;
+}
+
+}  // namespace tools
+}  // namespace principia
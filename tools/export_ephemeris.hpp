@@ -0,0 +1,23 @@
+﻿
+#pragma once
+
+#include <filesystem>
+
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace tools {
+
+// Reads the plugin serialized in hexadecimal in |save_filename|, prolongs its
+// ephemeris by |duration| after its current time, and writes to
+// |output_filename| the trajectories of the celestials over that range,
+// re-fitted with Чебышёв series of the given |degree| on intervals of duration
+// |interval|, as a binary |serialization::ChebyshevEphemeris|.
+void ExportEphemeris(std::filesystem::path const& save_filename,
+                     quantities::Time const& duration,
+                     quantities::Time const& interval,
+                     int degree,
+                     std::filesystem::path const& output_filename);
+
+}  // namespace tools
+}  // namespace principia
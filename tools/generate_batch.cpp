@@ -0,0 +1,59 @@
+﻿
+#include "tools/generate_batch.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/work_stealing_scheduler.hpp"
+#include "glog/logging.h"
+#include "tools/generate_configuration.hpp"
+#include "tools/generate_kopernicus.hpp"
+#include "tools/parallel_output.hpp"
+
+namespace principia {
+namespace tools {
+
+void GenerateBatch(std::filesystem::path const& jobs_filename) {
+  std::ifstream jobs_ifstream(jobs_filename);
+  CHECK(jobs_ifstream.good()) << jobs_filename;
+
+  std::vector<base::Future<void>> jobs;
+  std::string line;
+  while (std::getline(jobs_ifstream, line)) {
+    std::istringstream line_stream(line);
+    std::vector<std::string> const arguments(
+        (std::istream_iterator<std::string>(line_stream)),
+        std::istream_iterator<std::string>());
+    if (arguments.empty() || arguments.front().front() == '#') {
+      continue;
+    }
+    std::string const& command = arguments.front();
+    if (command == "generate_configuration") {
+      CHECK_EQ(6, arguments.size()) << line;
+      jobs.push_back(GeneratorScheduler().Add([arguments]() {
+        GenerateConfiguration(/*game_epoch=*/arguments[1],
+                              /*gravity_model_stem=*/arguments[2],
+                              /*initial_state_stem=*/arguments[3],
+                              /*numerics_blueprint_stem=*/arguments[4],
+                              /*needs=*/arguments[5]);
+      }));
+    } else if (command == "generate_kopernicus") {
+      CHECK_EQ(3, arguments.size()) << line;
+      jobs.push_back(GeneratorScheduler().Add([arguments]() {
+        GenerateKopernicusForSlippist1(/*gravity_model_stem=*/arguments[1],
+                                       /*initial_state_stem=*/arguments[2]);
+      }));
+    } else {
+      LOG(FATAL) << "Unsupported command " << command;
+    }
+  }
+  for (auto& job : jobs) {
+    job.wait();
+  }
+}
+
+}  // namespace tools
+}  // namespace principia
@@ -0,0 +1,17 @@
+
+#pragma once
+
+#include <filesystem>
+
+namespace principia {
+namespace tools {
+
+// Executes the generations listed in |jobs_filename| in parallel.  Each
+// nonblank line of that file that doesn't start with # has the arguments of a
+// generate_configuration or generate_kopernicus command, beginning with the
+// name of the command.  The solar system files are only parsed once, even if
+// they are used by several generations.
+void GenerateBatch(std::filesystem::path const& jobs_filename);
+
+}  // namespace tools
+}  // namespace principia
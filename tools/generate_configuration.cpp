@@ -4,7 +4,9 @@
 #include <filesystem>
 #include <iomanip>
 #include <limits>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "astronomy/epoch.hpp"
 #include "astronomy/frames.hpp"
@@ -18,6 +20,7 @@
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
 #include "serialization/astronomy.pb.h"
+#include "tools/parallel_output.hpp"
 
 namespace principia {
 
@@ -59,25 +62,19 @@ std::string NormalizeLength(std::string const& s) {
   }
 }
 
-void GenerateConfiguration(std::string const& game_epoch,
-                           std::string const& gravity_model_stem,
-                           std::string const& initial_state_stem,
-                           std::string const& numerics_blueprint_stem,
-                           std::string const& needs) {
-  std::filesystem::path const directory =
-      SOLUTION_DIR / "astronomy";
-  SolarSystem<ICRFJ2000Equator> solar_system(
-      (directory / gravity_model_stem).replace_extension(proto_txt),
-      (directory / initial_state_stem).replace_extension(proto_txt),
-      /*ignore_frame=*/true);
+namespace {
 
-  std::ofstream gravity_model_cfg(
-      (directory / gravity_model_stem).replace_extension(cfg));
+void WriteGravityModel(SolarSystem<ICRFJ2000Equator> const& solar_system,
+                       std::string const& needs,
+                       std::filesystem::path const& filename) {
+  std::ofstream gravity_model_cfg(filename);
   CHECK(gravity_model_cfg.good());
   gravity_model_cfg << "principia_gravity_model:NEEDS[" << needs << "] {\n";
-  for (std::string const& name : solar_system.names()) {
+  auto const write_body = [&solar_system](std::int64_t const i) {
+    std::string const& name = solar_system.names()[i];
     serialization::GravityModel::Body const& body =
         solar_system.gravity_model_message(name);
+    std::ostringstream gravity_model_cfg;
     gravity_model_cfg << "  body {\n";
     gravity_model_cfg << "    name                    = " << name << "\n";
     if (body.has_gravitational_parameter()) {
@@ -132,11 +129,17 @@ void GenerateConfiguration(std::string const& game_epoch,
                         << NormalizeLength(body.reference_radius()) << "\n";
     }
     gravity_model_cfg << "  }\n";
-  }
+    return gravity_model_cfg.str();
+  };
+  WriteInParallel(solar_system.names().size(), write_body, gravity_model_cfg);
   gravity_model_cfg << "}\n";
+}
 
-  std::ofstream initial_state_cfg(
-      (directory / initial_state_stem).replace_extension(cfg));
+void WriteInitialState(SolarSystem<ICRFJ2000Equator> const& solar_system,
+                       std::string const& game_epoch,
+                       std::string const& needs,
+                       std::filesystem::path const& filename) {
+  std::ofstream initial_state_cfg(filename);
   CHECK(initial_state_cfg.good());
   initial_state_cfg << "principia_initial_state:NEEDS[" << needs << "] {\n";
   initial_state_cfg << "  game_epoch = " << game_epoch << "\n";
@@ -159,9 +162,11 @@ void GenerateConfiguration(std::string const& game_epoch,
       return dof.velocity().coordinates();
     };
 
-    for (int i = 0; i < barycentric_system.bodies.size(); ++i) {
+    auto const write_body = [&barycentric_system, &displacement, &velocity](
+                                std::int64_t const i) {
       auto const& body = barycentric_system.bodies[i];
       auto const& dof = barycentric_system.degrees_of_freedom[i];
+      std::ostringstream initial_state_cfg;
       initial_state_cfg << "  body {\n";
       initial_state_cfg << "    name = " << body->name() << "\n";
       initial_state_cfg << "    x    = " << displacement(dof).x << "\n";
@@ -171,11 +176,16 @@ void GenerateConfiguration(std::string const& game_epoch,
       initial_state_cfg << "    vy   = " << velocity(dof).y << "\n";
       initial_state_cfg << "    vz   = " << velocity(dof).z << "\n";
       initial_state_cfg << "  }\n";
-    }
+      return initial_state_cfg.str();
+    };
+    WriteInParallel(
+        barycentric_system.bodies.size(), write_body, initial_state_cfg);
   } else {
-    for (std::string const& name : solar_system.names()) {
+    auto const write_body = [&solar_system](std::int64_t const i) {
+      std::string const& name = solar_system.names()[i];
       serialization::InitialState::Cartesian::Body const& body =
           solar_system.cartesian_initial_state_message(name);
+      std::ostringstream initial_state_cfg;
       initial_state_cfg << "  body {\n";
       initial_state_cfg << "    name = " << name << "\n";
       initial_state_cfg << "    x    = " << body.x() << "\n";
@@ -185,14 +195,20 @@ void GenerateConfiguration(std::string const& game_epoch,
       initial_state_cfg << "    vy   = " << body.vy() << "\n";
       initial_state_cfg << "    vz   = " << body.vz() << "\n";
       initial_state_cfg << "  }\n";
-    }
+      return initial_state_cfg.str();
+    };
+    WriteInParallel(
+        solar_system.names().size(), write_body, initial_state_cfg);
   }
   initial_state_cfg << "}\n";
+}
 
+void WriteNumericsBlueprint(
+    std::filesystem::path const& numerics_blueprint_filename,
+    std::string const& needs,
+    std::filesystem::path const& filename) {
   // Parse the numerics blueprint file here, it doesn't belong in class
   // SolarSystem.
-  std::filesystem::path numerics_blueprint_filename =
-      (directory / numerics_blueprint_stem).replace_extension(proto_txt);
   serialization::SolarSystemFile numerics_blueprint;
   std::ifstream numerics_blueprint_ifstream(numerics_blueprint_filename);
   CHECK(numerics_blueprint_ifstream.good());
@@ -206,8 +222,7 @@ void GenerateConfiguration(std::string const& game_epoch,
   auto const& psychohistory =
       numerics_blueprint.numerics_blueprint().psychohistory();
 
-  std::ofstream numerics_blueprint_cfg(
-      (directory / numerics_blueprint_stem).replace_extension(cfg));
+  std::ofstream numerics_blueprint_cfg(filename);
   CHECK(numerics_blueprint_cfg.good());
   numerics_blueprint_cfg <<
       "principia_numerics_blueprint:NEEDS[" << needs << "] {\n";
@@ -246,5 +261,47 @@ void GenerateConfiguration(std::string const& game_epoch,
   numerics_blueprint_cfg << "}\n";
 }
 
+}  // namespace
+
+void GenerateConfiguration(std::string const& game_epoch,
+                           std::string const& gravity_model_stem,
+                           std::string const& initial_state_stem,
+                           std::string const& numerics_blueprint_stem,
+                           std::string const& needs) {
+  std::filesystem::path const directory =
+      SOLUTION_DIR / "astronomy";
+  // The files are only parsed once per process, so this is cheap if the same
+  // system was used by another generator.
+  SolarSystem<ICRFJ2000Equator> solar_system(
+      (directory / gravity_model_stem).replace_extension(proto_txt),
+      (directory / initial_state_stem).replace_extension(proto_txt),
+      /*ignore_frame=*/true);
+
+  // The three files are independent, write them in parallel.
+  std::vector<base::Future<void>> files;
+  files.push_back(GeneratorScheduler().Add([&]() {
+    WriteGravityModel(
+        solar_system,
+        needs,
+        (directory / gravity_model_stem).replace_extension(cfg));
+  }));
+  files.push_back(GeneratorScheduler().Add([&]() {
+    WriteInitialState(
+        solar_system,
+        game_epoch,
+        needs,
+        (directory / initial_state_stem).replace_extension(cfg));
+  }));
+  files.push_back(GeneratorScheduler().Add([&]() {
+    WriteNumericsBlueprint(
+        (directory / numerics_blueprint_stem).replace_extension(proto_txt),
+        needs,
+        (directory / numerics_blueprint_stem).replace_extension(cfg));
+  }));
+  for (auto& file : files) {
+    file.wait();
+  }
+}
+
 }  // namespace tools
 }  // namespace principia
@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include <map>
+#include <sstream>
 #include <string>
 
 #include "astronomy/frames.hpp"
@@ -15,6 +16,7 @@
 #include "quantities/parser.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
+#include "tools/parallel_output.hpp"
 
 namespace principia {
 
@@ -87,6 +89,8 @@ void GenerateKopernicusForSlippist1(
     std::string const& initial_state_stem) {
   std::filesystem::path const directory =
       SOLUTION_DIR / "astronomy";
+  // The files are only parsed once per process, so this is cheap if the same
+  // system was used by another generator.
   SolarSystem<Sky> solar_system(
       (directory / gravity_model_stem).replace_extension(proto_txt),
       (directory / initial_state_stem).replace_extension(proto_txt),
@@ -109,7 +113,10 @@ void GenerateKopernicusForSlippist1(
   }
 
   kopernicus_cfg << "@Kopernicus:AFTER[aSLIPPIST-1] {\n";
-  for (std::string const& name : solar_system.names()) {
+  auto const write_kopernicus_body = [&solar_system,
+                                      &star](std::int64_t const i) {
+    std::string const& name = solar_system.names()[i];
+    std::ostringstream kopernicus_cfg;
     serialization::GravityModel::Body const& body =
         solar_system.gravity_model_message(name);
     serialization::InitialState::Keplerian::Body::Elements const& elements =
@@ -182,13 +189,16 @@ void GenerateKopernicusForSlippist1(
       kopernicus_cfg << "    }\n";
     }
     kopernicus_cfg << "  }\n";
-  }
+    return kopernicus_cfg.str();
+  };
+  WriteInParallel(
+      solar_system.names().size(), write_kopernicus_body, kopernicus_cfg);
   kopernicus_cfg << "}\n";
 
   kopernicus_cfg << "@principia_gravity_model:FOR[Principia] {\n";
-  for (std::string const& name : solar_system.names()) {
-    serialization::GravityModel::Body const& body =
-        solar_system.gravity_model_message(name);
+  auto const write_gravity_model_body = [&solar_system](std::int64_t const i) {
+    std::string const& name = solar_system.names()[i];
+    std::ostringstream kopernicus_cfg;
     serialization::InitialState::Keplerian::Body::Elements const& elements =
         solar_system.keplerian_initial_state_message(name).elements();
     bool const is_star =
@@ -204,7 +214,10 @@ void GenerateKopernicusForSlippist1(
                      << "\n";
     }
     kopernicus_cfg << "  }\n";
-  }
+    return kopernicus_cfg.str();
+  };
+  WriteInParallel(
+      solar_system.names().size(), write_gravity_model_body, kopernicus_cfg);
   kopernicus_cfg << "}\n";
 }
 
@@ -58,6 +58,48 @@ std::string ToLower(std::string const& s) {
   return lower;
 }
 
+// Returns true if the method described by |descriptor| is a query: it takes at
+// least one pointer, all its pointers designate const objects, and it neither
+// produces nor consumes pointers.  Such a method may be omitted from a journal
+// without preventing the replay of the other methods.  Note that a method that
+// takes no pointers is never considered a query, since it may change some
+// global state.
+bool IsQuery(Descriptor const* descriptor) {
+  int pointers = 0;
+  for (int i = 0; i < descriptor->nested_type_count(); ++i) {
+    Descriptor const* nested_descriptor = descriptor->nested_type(i);
+    const std::string& nested_name = nested_descriptor->name();
+    if (nested_name == out_message_name) {
+      return false;
+    }
+    for (int j = 0; j < nested_descriptor->field_count(); ++j) {
+      FieldDescriptor const* field_descriptor = nested_descriptor->field(j);
+      if (field_descriptor->type() != FieldDescriptor::TYPE_FIXED64) {
+        continue;
+      }
+      FieldOptions const& options = field_descriptor->options();
+      if (nested_name == return_message_name ||
+          options.HasExtension(journal::serialization::is_consumed) ||
+          options.HasExtension(journal::serialization::is_consumed_if) ||
+          options.HasExtension(journal::serialization::is_produced) ||
+          options.HasExtension(journal::serialization::is_produced_if)) {
+        return false;
+      }
+      std::string const& pointer_to =
+          options.GetExtension(journal::serialization::pointer_to);
+      static std::string const const_suffix = " const";
+      if (pointer_to.size() < const_suffix.size() ||
+          pointer_to.compare(pointer_to.size() - const_suffix.size(),
+                             const_suffix.size(),
+                             const_suffix) != 0) {
+        return false;
+      }
+      ++pointers;
+    }
+  }
+  return pointers > 0;
+}
+
 }  // namespace
 
 void JournalProtoProcessor::ProcessMessages() {
@@ -506,6 +548,12 @@ void JournalProtoProcessor::ProcessRequiredDoubleField(
   field_cxx_type_[descriptor] = descriptor->cpp_type_name();
 }
 
+void JournalProtoProcessor::ProcessRequiredFloatField(
+    FieldDescriptor const* descriptor) {
+  field_cs_type_[descriptor] = "float";
+  field_cxx_type_[descriptor] = descriptor->cpp_type_name();
+}
+
 void JournalProtoProcessor::ProcessRequiredInt32Field(
     FieldDescriptor const* descriptor) {
   field_cs_type_[descriptor] = "int";
@@ -631,6 +679,9 @@ void JournalProtoProcessor::ProcessRequiredField(
     case FieldDescriptor::TYPE_FIXED64:
       ProcessRequiredFixed64Field(descriptor);
       break;
+    case FieldDescriptor::TYPE_FLOAT:
+      ProcessRequiredFloatField(descriptor);
+      break;
     case FieldDescriptor::TYPE_INT32:
       ProcessRequiredInt32Field(descriptor);
       break;
@@ -1091,6 +1142,9 @@ void JournalProtoProcessor::ProcessMethodExtension(
   }
   cxx_toplevel_type_declaration_[descriptor] +=
       "  using Message = serialization::" + name + ";\n";
+  cxx_toplevel_type_declaration_[descriptor] +=
+      std::string("  static constexpr bool is_query = ") +
+      (IsQuery(descriptor) ? "true" : "false") + ";\n";
   if (has_in) {
     cxx_toplevel_type_declaration_[descriptor] +=
         "  static void Fill(In const& in, "
@@ -55,6 +55,7 @@ class JournalProtoProcessor final {
   void ProcessRequiredBoolField(FieldDescriptor const* descriptor);
   void ProcessRequiredBytesField(FieldDescriptor const* descriptor);
   void ProcessRequiredDoubleField(FieldDescriptor const* descriptor);
+  void ProcessRequiredFloatField(FieldDescriptor const* descriptor);
   void ProcessRequiredInt32Field(FieldDescriptor const* descriptor);
   void ProcessRequiredInt64Field(FieldDescriptor const* descriptor);
   void ProcessRequiredUint32Field(FieldDescriptor const* descriptor);
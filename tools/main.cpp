@@ -1,14 +1,20 @@
 ﻿
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "astronomy/epoch.hpp"
 #include "geometry/named_quantities.hpp"
 #include "glog/logging.h"
 #include "quantities/parser.hpp"
+#include "tools/compare_benchmarks.hpp"
+#include "tools/compile_solar_system_file.hpp"
+#include "tools/export_ephemeris.hpp"
+#include "tools/generate_batch.hpp"
 #include "tools/generate_configuration.hpp"
 #include "tools/generate_kopernicus.hpp"
 #include "tools/generate_profiles.hpp"
+#include "tools/simulate.hpp"
 
 int main(int argc, char const* argv[]) {
   google::InitGoogleLogging(argv[0]);
@@ -18,7 +24,84 @@ int main(int argc, char const* argv[]) {
     return 1;
   }
   std::string command = argv[1];
-  if (command == "generate_configuration") {
+  if (command == "compare_benchmarks") {
+    if (argc < 4 || argc > 6) {
+      // tools.exe compare_benchmarks \
+      //     baseline.json \
+      //     current.json \
+      //     "Ephemeris|Integrator|Polynomial" \
+      //     0.05
+      std::cerr << "Usage: " << argv[0] << " " << argv[1] << " "
+                << "baseline_json "
+                << "current_json "
+                << "[filter_regex] "
+                << "[relative_threshold]\n";
+      return 7;
+    }
+    std::string const baseline = argv[2];
+    std::string const current = argv[3];
+    // By default, compare the benchmarks of the ephemeris, the integrators,
+    // and the polynomials and series.
+    std::string const filter =
+        argc > 4 ? argv[4]
+                 : "Ephemeris|Integrator|Polynomial|Newhall|BM_Evaluate";
+    double const threshold = argc > 5 ? std::stod(argv[5]) : 0.05;
+    return principia::tools::CompareBenchmarks(
+               baseline, current, filter, threshold) ? 0 : 8;
+  } else if (command == "compile_solar_system_file") {
+    if (argc != 3) {
+      // tools.exe compile_solar_system_file \
+      //     sol_initial_state_jd_2451545_000000000
+      std::cerr << "Usage: " << argv[0] << " " << argv[1] << " "
+                << "stem\n";
+      return 6;
+    }
+    std::string const stem = argv[2];
+    principia::tools::CompileSolarSystemFile(stem);
+    return 0;
+  } else if (command == "export_ephemeris") {
+    if (argc != 7) {
+      // tools.exe export_ephemeris \
+      //     persistent.proto.hex \
+      //     "365 d" \
+      //     "8 d" \
+      //     12 \
+      //     ephemeris.proto.bin
+      std::cerr << "Usage: " << argv[0] << " " << argv[1] << " "
+                << "save_filename "
+                << "duration "
+                << "interval "
+                << "degree "
+                << "output_filename\n";
+      return 11;
+    }
+    std::string const save_filename = argv[2];
+    auto const duration =
+        principia::quantities::ParseQuantity<principia::quantities::Time>(
+            argv[3]);
+    auto const interval =
+        principia::quantities::ParseQuantity<principia::quantities::Time>(
+            argv[4]);
+    int const degree = std::stoi(argv[5]);
+    std::string const output_filename = argv[6];
+    principia::tools::ExportEphemeris(
+        save_filename, duration, interval, degree, output_filename);
+    return 0;
+  } else if (command == "generate_batch") {
+    if (argc != 3) {
+      // tools.exe generate_batch \
+      //     jobs.txt
+      // where each line of jobs.txt has the arguments of a
+      // generate_configuration or generate_kopernicus command, e.g.:
+      //   generate_configuration JD2433647.5 sol_gravity_model ...
+      std::cerr << "Usage: " << argv[0] << " " << argv[1] << " "
+                << "jobs_filename\n";
+      return 9;
+    }
+    std::string const jobs_filename = argv[2];
+    principia::tools::GenerateBatch(jobs_filename);
+    return 0;
+  } else if (command == "generate_configuration") {
     if (argc != 7) {
       // tools.exe generate_configuration \
       //     JD2433647.5 \
@@ -75,9 +158,33 @@ int main(int argc, char const* argv[]) {
     }
     principia::tools::GenerateProfiles();
     return 0;
+  } else if (command == "simulate") {
+    if (argc < 5) {
+      // tools.exe simulate \
+      //     persistent.proto.hex \
+      //     simulation.generated.wl \
+      //     "1 d" "30 d" "365 d"
+      std::cerr << "Usage: " << argv[0] << " " << argv[1] << " "
+                << "save_filename "
+                << "output_filename "
+                << "duration [duration...]\n";
+      return 10;
+    }
+    std::string const save_filename = argv[2];
+    std::string const output_filename = argv[3];
+    std::vector<principia::quantities::Time> durations;
+    for (int i = 4; i < argc; ++i) {
+      durations.push_back(
+          principia::quantities::ParseQuantity<principia::quantities::Time>(
+              argv[i]));
+    }
+    principia::tools::Simulate(save_filename, durations, output_filename);
+    return 0;
   } else {
     std::cerr << "Usage: " << argv[0]
-              << " generate_configuration|generate_profiles\n";
+              << " compare_benchmarks|compile_solar_system_file|"
+              << "export_ephemeris|generate_batch|generate_configuration|"
+              << "generate_profiles|simulate\n";
     return 4;
   }
 }
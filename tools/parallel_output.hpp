@@ -0,0 +1,46 @@
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/work_stealing_scheduler.hpp"
+
+namespace principia {
+namespace tools {
+
+// The scheduler on which the generators execute their files and their bodies.
+// It is shared by all the generators of a process, so that a batch of
+// generations doesn't oversubscribe the cores.  Its tasks may wait on each
+// other.
+inline base::WorkStealingScheduler& GeneratorScheduler() {
+  static base::WorkStealingScheduler scheduler(
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 1));
+  return scheduler;
+}
+
+// Calls |format(i)| for i in [0, count[ on the |GeneratorScheduler| and writes
+// the resulting strings to |out| in the order of i.  Each string is written as
+// soon as it and its predecessors are available, so the output is streamed
+// instead of being accumulated.  |format| must be thread-safe.
+template<typename Format>
+void WriteInParallel(std::int64_t const count,
+                     Format const& format,
+                     std::ostream& out) {
+  std::vector<base::Future<std::string>> chunks;
+  chunks.reserve(count);
+  for (std::int64_t i = 0; i < count; ++i) {
+    chunks.push_back(
+        GeneratorScheduler().Add([&format, i]() { return format(i); }));
+  }
+  for (auto& chunk : chunks) {
+    out << chunk.get();
+  }
+}
+
+}  // namespace tools
+}  // namespace principia
@@ -0,0 +1,138 @@
+﻿
+#include "tools/simulate.hpp"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/array.hpp"
+#include "base/file.hpp"
+#include "base/hexadecimal.hpp"
+#include "base/not_null.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "glog/logging.h"
+#include "ksp_plugin/frames.hpp"
+#include "ksp_plugin/identification.hpp"
+#include "ksp_plugin/plugin.hpp"
+#include "ksp_plugin/vessel.hpp"
+#include "mathematica/mathematica.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/si.hpp"
+#include "serialization/ksp_plugin.pb.h"
+
+namespace principia {
+
+using base::Array;
+using base::HexadecimalDecode;
+using base::not_null;
+using base::OFStream;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using ksp_plugin::Barycentric;
+using ksp_plugin::Celestial;
+using ksp_plugin::Plugin;
+using ksp_plugin::Vessel;
+using ksp_plugin::VesselSet;
+using physics::DegreesOfFreedom;
+using quantities::Time;
+using quantities::si::Radian;
+
+namespace tools {
+
+serialization::Plugin ReadPluginFromHexadecimalFile(
+    std::filesystem::path const& filename) {
+  std::ifstream file(filename);
+  CHECK(file.good()) << filename;
+  std::string hexadecimal;
+  std::string line;
+  while (std::getline(file, line)) {
+    for (char const c : line) {
+      if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'F')) {
+        hexadecimal.push_back(c);
+      }
+    }
+  }
+  auto const binary = HexadecimalDecode(
+      Array<char const>(hexadecimal.data(), hexadecimal.size()));
+  serialization::Plugin message;
+  CHECK(message.ParseFromArray(binary.data.get(),
+                               static_cast<int>(binary.size)))
+      << filename;
+  return message;
+}
+
+void Simulate(std::filesystem::path const& save_filename,
+              std::vector<Time> const& durations,
+              std::filesystem::path const& output_filename) {
+  serialization::Plugin const message =
+      ReadPluginFromHexadecimalFile(save_filename);
+  not_null<std::unique_ptr<Plugin>> const plugin =
+      Plugin::ReadFromMessage(message);
+  Instant const initial_time = plugin->CurrentTime();
+
+  std::vector<not_null<Celestial const*>> celestials;
+  for (auto const& celestial_message : message.celestial()) {
+    celestials.push_back(&plugin->GetCelestial(celestial_message.index()));
+  }
+  std::vector<not_null<Vessel const*>> vessels;
+  for (auto const& vessel_message : message.vessel()) {
+    vessels.push_back(plugin->GetVessel(vessel_message.guid()));
+  }
+
+  std::vector<std::string> names;
+  for (not_null<Celestial const*> const celestial : celestials) {
+    names.push_back(celestial->body()->name());
+  }
+  for (not_null<Vessel const*> const vessel : vessels) {
+    names.push_back(vessel->name());
+  }
+
+  // For each time, the positions and velocities of the celestials followed by
+  // those of the vessels, in the order of |names|.
+  std::vector<Instant> times;
+  std::vector<std::vector<Position<Barycentric>>> positions;
+  std::vector<std::vector<Velocity<Barycentric>>> velocities;
+  for (Time const& duration : durations) {
+    Instant const t = initial_time + duration;
+    // The planetarium rotation only affects the rendering.
+    plugin->AdvanceTime(t, /*planetarium_rotation=*/0 * Radian);
+    VesselSet collided_vessels;
+    plugin->CatchUpLaggingVessels(collided_vessels);
+    for (not_null<Vessel*> const vessel : collided_vessels) {
+      LOG(WARNING) << vessel->ShortDebugString()
+                   << " collided with a celestial before " << t;
+    }
+
+    times.push_back(t);
+    positions.emplace_back();
+    velocities.emplace_back();
+    for (not_null<Celestial const*> const celestial : celestials) {
+      DegreesOfFreedom<Barycentric> const degrees_of_freedom =
+          celestial->trajectory().EvaluateDegreesOfFreedom(t);
+      positions.back().push_back(degrees_of_freedom.position());
+      velocities.back().push_back(degrees_of_freedom.velocity());
+    }
+    for (not_null<Vessel const*> const vessel : vessels) {
+      DegreesOfFreedom<Barycentric> const degrees_of_freedom =
+          vessel->psychohistory().last().degrees_of_freedom();
+      positions.back().push_back(degrees_of_freedom.position());
+      velocities.back().push_back(degrees_of_freedom.velocity());
+    }
+  }
+
+  std::vector<std::string> escaped_names;
+  for (std::string const& name : names) {
+    escaped_names.push_back(mathematica::Escape(name));
+  }
+  OFStream file(output_filename);
+  file << mathematica::Assign("ppaSimulationNames", escaped_names);
+  file << mathematica::Assign("ppaSimulationTimes", times);
+  file << mathematica::Assign("ppaSimulationPositions", positions);
+  file << mathematica::Assign("ppaSimulationVelocities", velocities);
+}
+
+}  // namespace tools
+}  // namespace principia
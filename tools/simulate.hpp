@@ -0,0 +1,30 @@
+﻿
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "quantities/quantities.hpp"
+#include "serialization/ksp_plugin.pb.h"
+
+namespace principia {
+namespace tools {
+
+// Reads a plugin in the format of the saves: all the hexadecimal digits of the
+// file are concatenated, the other characters are ignored.
+serialization::Plugin ReadPluginFromHexadecimalFile(
+    std::filesystem::path const& filename);
+
+// Reads the plugin serialized in hexadecimal in |save_filename| and advances it
+// to each of the times |durations| after its current time, which must be
+// increasing, without going through the interface and without rendering
+// anything.  Writes the barycentric degrees of freedom of the celestials and of
+// the vessels at these times to |output_filename| as Mathematica assignments.
+// The vessels that collide with a celestial keep their last degrees of
+// freedom.
+void Simulate(std::filesystem::path const& save_filename,
+              std::vector<quantities::Time> const& durations,
+              std::filesystem::path const& output_filename);
+
+}  // namespace tools
+}  // namespace principia